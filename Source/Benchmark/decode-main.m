@@ -0,0 +1,328 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "PLCrashReport.h"
+#import "PLCrashReportTextFormatter.h"
+
+#import <stdlib.h>
+#import <stdio.h>
+#import <string.h>
+#import <getopt.h>
+#import <inttypes.h>
+
+#import <dispatch/dispatch.h>
+#import <malloc/malloc.h>
+#import <mach/mach_time.h>
+
+/*
+ * Host-side report decoding and formatting benchmark.
+ *
+ * Loads a corpus of encoded reports (eg, Resources/fuzz_report.plcrash, or reports written by plcrashbench with
+ * varying thread and image counts), and measures the throughput of report decoding, image look-ups, and text
+ * formatting, both single-threaded and with concurrent decoding.
+ */
+
+/*
+ * Print command line usage.
+ */
+static void print_usage () {
+    fprintf(stderr, "Usage: plcrashdecodebench [--iterations=<count>] [--concurrency=<threads>] [--options=<options>] <report> ...\n"
+                    "  --iterations   Number of passes over the corpus (default 100).\n"
+                    "  --concurrency  Number of concurrent decoders used for the concurrent pass (default: active CPU count).\n"
+                    "  --options      Decoding options; one of none, lazy, compact, or lazy,compact (default none).\n");
+}
+
+/*
+ * Benchmark stages.
+ */
+enum bench_stage {
+    /** -[PLCrashReport initWithData:options:error:] */
+    BENCH_STAGE_DECODE = 0,
+
+    /** -[PLCrashReport imageForAddress:], for every stack frame of every thread. */
+    BENCH_STAGE_IMAGE_LOOKUP = 1,
+
+    /** +[PLCrashReportTextFormatter stringValueForCrashReport:withTextFormat:] */
+    BENCH_STAGE_FORMAT = 2,
+
+    /** Number of stages. */
+    BENCH_STAGE_COUNT = 3
+};
+
+/*
+ * Stage names, indexed by enum bench_stage.
+ */
+static const char *bench_stage_names[BENCH_STAGE_COUNT] = { "decode", "images", "format" };
+
+/*
+ * Per-stage results.
+ */
+struct bench_result {
+    /** Total elapsed time, in nanoseconds. */
+    uint64_t elapsed;
+
+    /** Number of operations performed. */
+    uint64_t operations;
+
+    /** Total bytes in use by the malloc zones on completion of each operation, relative to its start. */
+    uint64_t bytes;
+};
+
+/*
+ * Return the total number of bytes in use across all malloc zones.
+ */
+static uint64_t bench_malloc_in_use () {
+    malloc_statistics_t stats;
+    malloc_zone_statistics(NULL, &stats);
+    return stats.size_in_use;
+}
+
+/* Return @a delta, in nanoseconds. */
+static uint64_t bench_nanoseconds (uint64_t delta) {
+    static mach_timebase_info_data_t timebase;
+    if (timebase.denom == 0)
+        mach_timebase_info(&timebase);
+
+    return delta * timebase.numer / timebase.denom;
+}
+
+/*
+ * Decode, look up images within, and format @a data, accumulating the per-stage results in @a results. If
+ * @a measure_bytes is true, the bytes allocated by each stage are recorded; this is only meaningful when a single
+ * thread is performing allocations.
+ */
+static BOOL bench_run_report (NSData *data, PLCrashReportDecodingOptions options, BOOL measure_bytes, struct bench_result results[BENCH_STAGE_COUNT]) {
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    NSError *error;
+    uint64_t in_use = measure_bytes ? bench_malloc_in_use() : 0;
+
+    /* Decode */
+    uint64_t start = mach_absolute_time();
+    PLCrashReport *report = [[PLCrashReport alloc] initWithData: data options: options error: &error];
+    results[BENCH_STAGE_DECODE].elapsed += bench_nanoseconds(mach_absolute_time() - start);
+    results[BENCH_STAGE_DECODE].operations++;
+
+    if (report == nil) {
+        fprintf(stderr, "Could not decode report: %s\n", [[error localizedDescription] UTF8String]);
+        [pool release];
+        return NO;
+    }
+
+    if (measure_bytes) {
+        uint64_t now = bench_malloc_in_use();
+        results[BENCH_STAGE_DECODE].bytes += now > in_use ? now - in_use : 0;
+        in_use = now;
+    }
+
+    /* Image look-ups */
+    start = mach_absolute_time();
+    for (PLCrashReportThreadInfo *thread in report.threads) {
+        for (PLCrashReportStackFrameInfo *frame in thread.stackFrames) {
+            [report imageForAddress: frame.instructionPointer];
+            results[BENCH_STAGE_IMAGE_LOOKUP].operations++;
+        }
+    }
+    results[BENCH_STAGE_IMAGE_LOOKUP].elapsed += bench_nanoseconds(mach_absolute_time() - start);
+
+    if (measure_bytes) {
+        uint64_t now = bench_malloc_in_use();
+        results[BENCH_STAGE_IMAGE_LOOKUP].bytes += now > in_use ? now - in_use : 0;
+        in_use = now;
+    }
+
+    /* Formatting */
+    start = mach_absolute_time();
+    NSString *text = [PLCrashReportTextFormatter stringValueForCrashReport: report withTextFormat: PLCrashReportTextFormatiOS];
+    results[BENCH_STAGE_FORMAT].elapsed += bench_nanoseconds(mach_absolute_time() - start);
+    results[BENCH_STAGE_FORMAT].operations++;
+
+    if (measure_bytes) {
+        uint64_t now = bench_malloc_in_use();
+        results[BENCH_STAGE_FORMAT].bytes += now > in_use ? now - in_use : 0;
+    }
+
+    if (text == nil) {
+        fprintf(stderr, "Could not format report\n");
+        [report release];
+        [pool release];
+        return NO;
+    }
+
+    [report release];
+    [pool release];
+    return YES;
+}
+
+/*
+ * Print the results for a single pass.
+ */
+static void bench_print_results (const char *pass, uint64_t reports, const struct bench_result results[BENCH_STAGE_COUNT], BOOL print_bytes) {
+    for (int i = 0; i < BENCH_STAGE_COUNT; i++) {
+        double seconds = (double) results[i].elapsed / NSEC_PER_SEC;
+        double ops = seconds > 0 ? results[i].operations / seconds : 0;
+
+        if (print_bytes) {
+            printf("%-10s %-6s %12.0f ops/sec %10" PRIu64 " bytes/report\n", pass, bench_stage_names[i], ops, results[i].bytes / reports);
+        } else {
+            printf("%-10s %-6s %12.0f ops/sec\n", pass, bench_stage_names[i], ops);
+        }
+    }
+}
+
+int main (int argc, char *argv[]) {
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    uint32_t iterations = 100;
+    uint32_t concurrency = (uint32_t) [[NSProcessInfo processInfo] activeProcessorCount];
+    PLCrashReportDecodingOptions options = PLCrashReportDecodingOptionNone;
+    int ch;
+
+    static struct option longopts[] = {
+        { "iterations",     required_argument,  NULL,   'n' },
+        { "concurrency",    required_argument,  NULL,   'c' },
+        { "options",        required_argument,  NULL,   'o' },
+        { NULL,             0,                  NULL,   0 }
+    };
+
+    while ((ch = getopt_long(argc, argv, "n:c:o:", longopts, NULL)) != -1) {
+        switch (ch) {
+            case 'n':
+                iterations = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+            case 'c':
+                concurrency = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+            case 'o':
+                if (strcmp(optarg, "none") == 0) {
+                    options = PLCrashReportDecodingOptionNone;
+                } else if (strcmp(optarg, "lazy") == 0) {
+                    options = PLCrashReportDecodingOptionLazy;
+                } else if (strcmp(optarg, "compact") == 0) {
+                    options = PLCrashReportDecodingOptionCompact;
+                } else if (strcmp(optarg, "lazy,compact") == 0) {
+                    options = PLCrashReportDecodingOptionLazy | PLCrashReportDecodingOptionCompact;
+                } else {
+                    print_usage();
+                    return 1;
+                }
+                break;
+            default:
+                print_usage();
+                return 1;
+        }
+    }
+    argc -= optind;
+    argv += optind;
+
+    if (argc < 1 || iterations == 0 || concurrency == 0) {
+        print_usage();
+        return 1;
+    }
+
+    /* Load the corpus */
+    NSMutableArray *corpus = [NSMutableArray array];
+    uint64_t corpus_bytes = 0;
+    for (int i = 0; i < argc; i++) {
+        NSData *data = [NSData dataWithContentsOfFile: [NSString stringWithUTF8String: argv[i]]];
+        if (data == nil) {
+            fprintf(stderr, "Could not load report from %s\n", argv[i]);
+            return 1;
+        }
+
+        [corpus addObject: data];
+        corpus_bytes += [data length];
+    }
+
+    printf("corpus: %lu reports, %" PRIu64 " bytes; %" PRIu32 " iterations\n", (unsigned long) [corpus count], corpus_bytes, iterations);
+
+    /* Warm up, and verify that the full corpus can be processed */
+    {
+        struct bench_result warmup[BENCH_STAGE_COUNT];
+        memset(warmup, 0, sizeof(warmup));
+        for (NSData *data in corpus) {
+            if (!bench_run_report(data, options, NO, warmup))
+                return 1;
+        }
+    }
+
+    /* Single-threaded */
+    {
+        struct bench_result results[BENCH_STAGE_COUNT];
+        memset(results, 0, sizeof(results));
+
+        for (uint32_t i = 0; i < iterations; i++) {
+            for (NSData *data in corpus)
+                bench_run_report(data, options, YES, results);
+        }
+
+        bench_print_results("serial", (uint64_t) iterations * [corpus count], results, YES);
+    }
+
+    /* Concurrent; the reported throughput is the aggregate across all decoders, measured by wall time */
+    {
+        struct bench_result *results = (struct bench_result *) calloc(concurrency, sizeof(struct bench_result) * BENCH_STAGE_COUNT);
+        struct bench_result totals[BENCH_STAGE_COUNT];
+        dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+
+        uint64_t start = mach_absolute_time();
+        dispatch_apply(concurrency, queue, ^(size_t worker) {
+            for (uint32_t i = 0; i < iterations; i++) {
+                for (NSData *data in corpus)
+                    bench_run_report(data, options, NO, &results[worker * BENCH_STAGE_COUNT]);
+            }
+        });
+        uint64_t elapsed = bench_nanoseconds(mach_absolute_time() - start);
+
+        /* Scale each stage's share of the per-worker time to the wall time */
+        memset(totals, 0, sizeof(totals));
+        uint64_t busy = 0;
+        for (uint32_t w = 0; w < concurrency; w++) {
+            for (int i = 0; i < BENCH_STAGE_COUNT; i++) {
+                totals[i].operations += results[w * BENCH_STAGE_COUNT + i].operations;
+                totals[i].elapsed += results[w * BENCH_STAGE_COUNT + i].elapsed;
+                busy += results[w * BENCH_STAGE_COUNT + i].elapsed;
+            }
+        }
+
+        for (int i = 0; i < BENCH_STAGE_COUNT; i++) {
+            if (busy > 0)
+                totals[i].elapsed = (uint64_t) ((double) elapsed * totals[i].elapsed / busy);
+        }
+
+        char pass[32];
+        snprintf(pass, sizeof(pass), "concurrent/%" PRIu32, concurrency);
+        bench_print_results(pass, (uint64_t) iterations * [corpus count] * concurrency, totals, NO);
+        printf("%-10s total  %12.0f reports/sec\n", pass, (double) iterations * [corpus count] * concurrency / ((double) elapsed / NSEC_PER_SEC));
+
+        free(results);
+    }
+
+    [pool release];
+    return 0;
+}
@@ -0,0 +1,449 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "PLCrashLogWriter.h"
+#import "PLCrashAsyncImageList.h"
+#import "PLCrashAsyncThread.h"
+
+#import <stdlib.h>
+#import <stdio.h>
+#import <getopt.h>
+#import <fcntl.h>
+#import <unistd.h>
+#import <errno.h>
+#import <inttypes.h>
+#import <pthread.h>
+
+#import <mach/mach.h>
+#import <mach/mach_time.h>
+#import <mach-o/dyld.h>
+
+/*
+ * End-to-end crash log writer benchmark.
+ *
+ * Spawns a configurable set of blocked worker threads with deep stacks of interleaved Objective-C and C++ frames,
+ * and repeatedly writes a complete crash report for the resulting process state to each of the supported output
+ * sinks, reporting per-write latency, output size, and system call counts.
+ */
+
+/*
+ * Print command line usage.
+ */
+static void print_usage () {
+    fprintf(stderr, "Usage: plcrashbench [--threads=<count>] [--depth=<frames>] [--images=<count>] [--iterations=<count>]\n"
+                    "                    [--sink=<sink>] [--output=<path>]\n"
+                    "  --threads     Number of worker threads to spawn (default 8).\n"
+                    "  --depth       Stack depth of each worker thread, alternating Objective-C and C++ frames (default 32).\n"
+                    "  --images      Number of binary images to report. Loaded images are reused if more images are\n"
+                    "                requested than are loaded (default: all loaded images).\n"
+                    "  --iterations  Number of reports to write to each sink (default 100).\n"
+                    "  --sink        One of null, memory, file, or all (default all).\n"
+                    "  --output      Output path used by the file sink (default /tmp/plcrashbench.plcrash).\n");
+}
+
+/*
+ * Output sinks.
+ */
+enum bench_sink {
+    /** Write to /dev/null. */
+    BENCH_SINK_NULL = 0,
+
+    /** Write to a growable in-memory region. */
+    BENCH_SINK_MEMORY = 1,
+
+    /** Write to a regular file. */
+    BENCH_SINK_FILE = 2,
+
+    /** Number of sinks. */
+    BENCH_SINK_COUNT = 3
+};
+
+/*
+ * Sink names, indexed by enum bench_sink.
+ */
+static const char *bench_sink_names[BENCH_SINK_COUNT] = { "null", "memory", "file" };
+
+/*
+ * Worker thread state, shared by all workers.
+ */
+struct bench_workers {
+    /** Guards all fields. */
+    pthread_mutex_t lock;
+
+    /** Signaled when a worker becomes ready, or when the workers should stop. */
+    pthread_cond_t cond;
+
+    /** Number of workers that have reached their maximum depth. */
+    uint32_t ready;
+
+    /** If true, the workers should unwind and exit. */
+    bool stop;
+
+    /** Stack depth of each worker. */
+    uint32_t depth;
+};
+
+static int bench_cxx_frame (struct bench_workers *workers, uint32_t depth);
+
+/*
+ * Objective-C frames interleaved with the C++ frames of each worker's stack.
+ */
+@interface PLCrashBenchFrame : NSObject
++ (int) recurse: (struct bench_workers *) workers depth: (uint32_t) depth;
+@end
+
+@implementation PLCrashBenchFrame
+
++ (int) recurse: (struct bench_workers *) workers depth: (uint32_t) depth {
+    /* Use the result to prevent the recursion from being converted into a tail call */
+    return bench_cxx_frame(workers, depth + 1) + 1;
+}
+
+@end
+
+namespace {
+
+/*
+ * Block the calling worker until the workers are stopped.
+ */
+__attribute__((noinline)) int bench_wait (struct bench_workers *workers) {
+    pthread_mutex_lock(&workers->lock);
+    workers->ready++;
+    pthread_cond_broadcast(&workers->cond);
+
+    while (!workers->stop)
+        pthread_cond_wait(&workers->cond, &workers->lock);
+    pthread_mutex_unlock(&workers->lock);
+
+    return 0;
+}
+
+}
+
+/*
+ * C++ frames interleaved with the Objective-C frames of each worker's stack.
+ */
+__attribute__((noinline)) static int bench_cxx_frame (struct bench_workers *workers, uint32_t depth) {
+    if (depth >= workers->depth)
+        return bench_wait(workers);
+
+    return [PLCrashBenchFrame recurse: workers depth: depth + 1] + 1;
+}
+
+/*
+ * Worker thread entry point.
+ */
+static void *bench_worker (void *arg) {
+    bench_cxx_frame((struct bench_workers *) arg, 0);
+    return NULL;
+}
+
+/*
+ * Compare two uint64_t values for qsort().
+ */
+static int bench_compare_u64 (const void *a, const void *b) {
+    uint64_t lhs = *(const uint64_t *) a;
+    uint64_t rhs = *(const uint64_t *) b;
+
+    if (lhs < rhs)
+        return -1;
+    else if (lhs > rhs)
+        return 1;
+    return 0;
+}
+
+/*
+ * Fetch the total number of Mach and BSD system calls made by the current task.
+ */
+static uint64_t bench_syscall_count () {
+    task_events_info_data_t info;
+    mach_msg_type_number_t count = TASK_EVENTS_INFO_COUNT;
+
+    if (task_info(mach_task_self(), TASK_EVENTS_INFO, (task_info_t) &info, &count) != KERN_SUCCESS)
+        return 0;
+
+    return (uint64_t) info.syscalls_mach + (uint64_t) info.syscalls_unix;
+}
+
+/*
+ * Open the output file for @a sink. Returns false on error.
+ */
+static bool bench_open_sink (enum bench_sink sink, const char *output_path, plcrash_async_file_t *file) {
+    int fd;
+
+    switch (sink) {
+        case BENCH_SINK_NULL:
+            if ((fd = open("/dev/null", O_WRONLY)) < 0)
+                return false;
+            plcrash_async_file_init(file, fd, 0);
+            return true;
+
+        case BENCH_SINK_MEMORY:
+            return plcrash_async_file_init_vm(file, 64 * 1024 * 1024) == PLCRASH_ESUCCESS;
+
+        case BENCH_SINK_FILE:
+            if ((fd = open(output_path, O_RDWR|O_CREAT|O_TRUNC, 0644)) < 0)
+                return false;
+            plcrash_async_file_init(file, fd, 0);
+            return true;
+
+        case BENCH_SINK_COUNT:
+            break;
+    }
+
+    return false;
+}
+
+/*
+ * Write @a iterations reports to @a sink, and print the results. Returns false on error.
+ */
+static bool bench_run_sink (plcrash_log_writer_t *writer, enum bench_sink sink, const char *output_path, uint32_t iterations,
+                            thread_t crashed_thread, plcrash_async_image_list_t *image_list)
+{
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGSEGV, .code = SEGV_MAPERR, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t siginfo = { .bsd_info = &bsd_info, .mach_info = NULL };
+    mach_timebase_info_data_t timebase;
+    uint64_t *latencies;
+    uint64_t total_bytes = 0;
+    uint64_t total_syscalls = 0;
+
+    if (mach_timebase_info(&timebase) != KERN_SUCCESS || timebase.denom == 0) {
+        timebase.numer = 1;
+        timebase.denom = 1;
+    }
+
+    if ((latencies = (uint64_t *) calloc(iterations, sizeof(uint64_t))) == NULL) {
+        fprintf(stderr, "Could not allocate latency samples\n");
+        return false;
+    }
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        plcrash_async_thread_state_t thread_state;
+        plcrash_async_file_t file;
+
+        if (plcrash_log_writer_reset(writer) != PLCRASH_ESUCCESS) {
+            fprintf(stderr, "Could not reset the log writer\n");
+            free(latencies);
+            return false;
+        }
+
+        if (!bench_open_sink(sink, output_path, &file)) {
+            fprintf(stderr, "Could not open the %s sink: %s\n", bench_sink_names[sink], strerror(errno));
+            free(latencies);
+            return false;
+        }
+
+        /* The workers are blocked, and their thread state will not change while the report is written */
+        plcrash_async_thread_state_mach_thread_init(&thread_state, crashed_thread);
+
+        /* Time the complete write, including the final flush */
+        uint64_t syscalls_start = bench_syscall_count();
+        uint64_t start = mach_absolute_time();
+
+        plcrash_error_t err = plcrash_log_writer_write(writer, crashed_thread, image_list, &file, &siginfo, &thread_state);
+        bool closed = plcrash_async_file_close(&file);
+
+        uint64_t elapsed = mach_absolute_time() - start;
+        total_syscalls += bench_syscall_count() - syscalls_start;
+
+        total_bytes += file.total_bytes;
+        latencies[i] = elapsed * timebase.numer / timebase.denom;
+
+        if (sink == BENCH_SINK_MEMORY && file.mem_buffer != NULL)
+            vm_deallocate(mach_task_self(), (vm_address_t) file.mem_buffer, file.mem_capacity);
+
+        if (err != PLCRASH_ESUCCESS || !closed) {
+            fprintf(stderr, "Writing to the %s sink failed: %s\n", bench_sink_names[sink], plcrash_async_strerror(err));
+            free(latencies);
+            return false;
+        }
+    }
+
+    qsort(latencies, iterations, sizeof(uint64_t), bench_compare_u64);
+
+    uint64_t p50 = latencies[(iterations - 1) / 2];
+    uint64_t p99 = latencies[((uint64_t) iterations * 99 - 1) / 100];
+
+    printf("%-8s p50=%" PRIu64 "us p99=%" PRIu64 "us bytes=%" PRIu64 " syscalls=%" PRIu64 "\n",
+           bench_sink_names[sink], p50 / NSEC_PER_USEC, p99 / NSEC_PER_USEC, total_bytes / iterations, total_syscalls / iterations);
+
+    free(latencies);
+    return true;
+}
+
+int main (int argc, char *argv[]) {
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    struct bench_workers workers;
+    uint32_t thread_count = 8;
+    uint32_t image_count = _dyld_image_count();
+    uint32_t iterations = 100;
+    const char *output_path = "/tmp/plcrashbench.plcrash";
+    int sink = -1;
+    int ch;
+    int ret = 0;
+
+    workers.depth = 32;
+
+    static struct option longopts[] = {
+        { "threads",    required_argument,  NULL,   't' },
+        { "depth",      required_argument,  NULL,   'd' },
+        { "images",     required_argument,  NULL,   'i' },
+        { "iterations", required_argument,  NULL,   'n' },
+        { "sink",       required_argument,  NULL,   's' },
+        { "output",     required_argument,  NULL,   'o' },
+        { NULL,         0,                  NULL,   0 }
+    };
+
+    while ((ch = getopt_long(argc, argv, "t:d:i:n:s:o:", longopts, NULL)) != -1) {
+        switch (ch) {
+            case 't':
+                thread_count = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+            case 'd':
+                workers.depth = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+            case 'i':
+                image_count = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+            case 'n':
+                iterations = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+            case 's':
+                if (strcmp(optarg, "all") == 0) {
+                    sink = -1;
+                    break;
+                }
+
+                sink = -2;
+                for (int i = 0; i < BENCH_SINK_COUNT; i++) {
+                    if (strcmp(optarg, bench_sink_names[i]) == 0)
+                        sink = i;
+                }
+                break;
+            case 'o':
+                output_path = optarg;
+                break;
+            default:
+                print_usage();
+                return 1;
+        }
+    }
+
+    if (sink == -2 || iterations == 0 || thread_count == 0) {
+        print_usage();
+        return 1;
+    }
+
+    /* Spawn the workers, and wait for all of them to reach their maximum depth */
+    pthread_t *threads = (pthread_t *) calloc(thread_count, sizeof(pthread_t));
+    pthread_mutex_init(&workers.lock, NULL);
+    pthread_cond_init(&workers.cond, NULL);
+    workers.ready = 0;
+    workers.stop = false;
+
+    for (uint32_t i = 0; i < thread_count; i++) {
+        pthread_attr_t attr;
+
+        /* Allow for deep stacks */
+        pthread_attr_init(&attr);
+        pthread_attr_setstacksize(&attr, 8 * 1024 * 1024);
+        if (pthread_create(&threads[i], &attr, bench_worker, &workers) != 0) {
+            fprintf(stderr, "Could not spawn worker thread: %s\n", strerror(errno));
+            exit(1);
+        }
+        pthread_attr_destroy(&attr);
+    }
+
+    pthread_mutex_lock(&workers.lock);
+    while (workers.ready < thread_count)
+        pthread_cond_wait(&workers.cond, &workers.lock);
+    pthread_mutex_unlock(&workers.lock);
+
+    /* Populate the image list. If more images are requested than are loaded, the loaded images are reused under
+     * synthetic names. */
+    plcrash_async_image_list_t image_list;
+    uint32_t loaded_count = _dyld_image_count();
+    char **synthetic_names = (char **) calloc(image_count, sizeof(char *));
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < image_count && loaded_count > 0; i++) {
+        uint32_t index = i % loaded_count;
+        const char *name = _dyld_get_image_name(index);
+
+        if (i >= loaded_count) {
+            asprintf(&synthetic_names[i], "%s.%" PRIu32, name, i / loaded_count);
+            name = synthetic_names[i];
+        }
+
+        plcrash_nasync_image_list_append(&image_list, (pl_vm_address_t) _dyld_get_image_header(index), name);
+    }
+
+    printf("threads=%" PRIu32 " depth=%" PRIu32 " images=%" PRIu32 " iterations=%" PRIu32 "\n",
+           thread_count, workers.depth, image_count, iterations);
+
+    /* Run the benchmark, reporting the first worker as the crashed thread */
+    plcrash_log_writer_t writer;
+    if (plcrash_log_writer_init(&writer, @"coop.plausible.plcrashbench", @"1.0", @"1.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, false) != PLCRASH_ESUCCESS) {
+        fprintf(stderr, "Could not initialize the log writer\n");
+        exit(1);
+    }
+
+    thread_t crashed_thread = pthread_mach_thread_np(threads[0]);
+    for (int i = 0; i < BENCH_SINK_COUNT; i++) {
+        if (sink >= 0 && sink != i)
+            continue;
+
+        if (!bench_run_sink(&writer, (enum bench_sink) i, output_path, iterations, crashed_thread, &image_list)) {
+            ret = 1;
+            break;
+        }
+    }
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    for (uint32_t i = 0; i < image_count; i++)
+        free(synthetic_names[i]);
+    free(synthetic_names);
+
+    /* Stop the workers */
+    pthread_mutex_lock(&workers.lock);
+    workers.stop = true;
+    pthread_cond_broadcast(&workers.cond);
+    pthread_mutex_unlock(&workers.lock);
+
+    for (uint32_t i = 0; i < thread_count; i++)
+        pthread_join(threads[i], NULL);
+    free(threads);
+
+    [pool release];
+    return ret;
+}
@@ -39,6 +39,9 @@
 #import "PLCrashReporter.h"
 #import "PLCrashReport.h"
 #import "PLCrashReportTextFormatter.h"
+#import "PLCrashReportJSONFormatter.h"
+#import "PLCrashReportSymbolDemangler.h"
+#import "PLCrashTaskReporter.h"
 
 /**
  * @defgroup functions Crash Reporter Functions Reference
@@ -103,6 +106,9 @@ typedef enum {
 #import "PLCrashReporter.h"
 #import "PLCrashReport.h"
 #import "PLCrashReportTextFormatter.h"
+#import "PLCrashReportJSONFormatter.h"
+#import "PLCrashReportSymbolDemangler.h"
+#import "PLCrashTaskReporter.h"
 
 /**
  * @mainpage Plausible Crash Reporter
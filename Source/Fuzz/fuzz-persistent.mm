@@ -0,0 +1,409 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "PLCrashReport.h"
+#import "PLCrashAsyncMachOImage.h"
+#import "PLCrashAsyncCompactUnwindEncoding.h"
+#import "PLCrashFeatureConfig.h"
+
+#if PLCRASH_FEATURE_UNWIND_DWARF
+#import "PLCrashAsyncDwarfEncoding.hpp"
+#import "PLCrashAsyncDwarfCFAState.hpp"
+#endif
+
+#import <stdlib.h>
+#import <stdio.h>
+#import <string.h>
+#import <getopt.h>
+#import <inttypes.h>
+#import <sys/mman.h>
+
+#import <mach/mach.h>
+#import <mach/mach_time.h>
+
+/*
+ * In-process, persistent fuzzing target.
+ *
+ * Unlike the zzuf-driven "Fuzz Testing" tool, which decodes a single report per process launch, this target exercises
+ * the report decoder and the async Mach-O, compact unwind, and DWARF parsers repeatedly within a single process. The
+ * entry point follows the libFuzzer convention; when built with PLCRASH_FUZZ_LIBFUZZER (and -fsanitize=fuzzer),
+ * libFuzzer supplies main() and drives the target directly. Otherwise, a standalone driver mutates the supplied
+ * corpus in-process and reports throughput.
+ *
+ * Each input begins with a fuzz_header selecting the target parser; the remainder is the payload handed to that parser.
+ */
+
+/*
+ * Fuzzing targets.
+ */
+enum fuzz_target {
+    /** Decode the payload via -[PLCrashReport initWithData:error:]. */
+    FUZZ_TARGET_REPORT = 0,
+
+    /** Parse the payload as an in-memory Mach-O image. */
+    FUZZ_TARGET_MACHO = 1,
+
+    /** Parse the payload as an __unwind_info section. */
+    FUZZ_TARGET_CFE = 2,
+
+    /** Parse the payload as an eh_frame/debug_frame section. */
+    FUZZ_TARGET_DWARF = 3,
+
+    /** The number of defined targets. */
+    FUZZ_TARGET_COUNT = 4
+};
+
+/*
+ * Header flags.
+ */
+enum {
+    /** Parse the payload as 64-bit data. */
+    FUZZ_FLAG_M64 = 1 << 0,
+
+    /** Parse the payload as a debug_frame section, rather than eh_frame. */
+    FUZZ_FLAG_DEBUG_FRAME = 1 << 1,
+
+    /** Parse the payload as big-endian data. */
+    FUZZ_FLAG_BIG_ENDIAN = 1 << 2,
+};
+
+/*
+ * Fuzz input header.
+ */
+struct fuzz_header {
+    /** The fuzz_target, modulo FUZZ_TARGET_COUNT. */
+    uint8_t target;
+
+    /** Target flags. */
+    uint8_t flags;
+
+    /** Reserved. */
+    uint8_t reserved[6];
+
+    /** The pc to be looked up by the symbol and unwind parsers, relative to the payload's address. */
+    uint64_t pc_offset;
+};
+
+/** Maximum supported payload size; larger inputs are truncated. */
+#define FUZZ_MAX_PAYLOAD (1024 * 1024)
+
+/** Page-aligned payload buffer, followed by an inaccessible guard page. */
+static uint8_t *fuzz_buffer;
+
+/*
+ * Copy @a data to the end of the guarded payload buffer, such that any read past the end of the input
+ * fails deterministically, rather than returning adjacent heap data. Returns the address of the copy.
+ */
+static uint8_t *fuzz_stage_payload (const uint8_t *data, size_t size) {
+    if (fuzz_buffer == NULL) {
+        fuzz_buffer = (uint8_t *) mmap(NULL, FUZZ_MAX_PAYLOAD + PAGE_SIZE, PROT_READ|PROT_WRITE, MAP_ANON|MAP_PRIVATE, -1, 0);
+        if (fuzz_buffer == MAP_FAILED) {
+            perror("mmap");
+            abort();
+        }
+
+        if (mprotect(fuzz_buffer + FUZZ_MAX_PAYLOAD, PAGE_SIZE, PROT_NONE) != 0) {
+            perror("mprotect");
+            abort();
+        }
+    }
+
+    uint8_t *payload = fuzz_buffer + FUZZ_MAX_PAYLOAD - size;
+    memcpy(payload, data, size);
+    return payload;
+}
+
+/* Symbol lookup callback; discards the result. */
+static void fuzz_found_symbol (pl_vm_address_t address, const char *name, void *ctx) {
+    (*(size_t *) ctx) += strlen(name);
+}
+
+/*
+ * Exercise the Mach-O parser.
+ */
+static void fuzz_macho (const struct fuzz_header *header, pl_vm_address_t payload) {
+    plcrash_async_macho_t image;
+    if (plcrash_nasync_macho_init(&image, mach_task_self(), "fuzz", payload) != PLCRASH_ESUCCESS)
+        return;
+
+    void *cmd = NULL;
+    while ((cmd = plcrash_async_macho_next_command(&image, cmd)) != NULL)
+        ;
+
+    plcrash_async_mobject_t mobj;
+    if (plcrash_async_macho_map_section(&image, SEG_TEXT, "__unwind_info", &mobj) == PLCRASH_ESUCCESS)
+        plcrash_async_mobject_free(&mobj);
+
+    size_t name_bytes = 0;
+    plcrash_async_macho_find_symbol_by_pc(&image, NULL, image.header_addr + header->pc_offset, fuzz_found_symbol, &name_bytes);
+
+    plcrash_nasync_macho_free(&image);
+}
+
+/*
+ * Exercise the compact unwind reader.
+ */
+static void fuzz_cfe (const struct fuzz_header *header, pl_vm_address_t payload, size_t size) {
+    static const cpu_type_t cpu_types[] = { CPU_TYPE_X86, CPU_TYPE_X86_64, CPU_TYPE_ARM64 };
+    cpu_type_t cpu_type = cpu_types[header->flags % (sizeof(cpu_types) / sizeof(cpu_types[0]))];
+
+    plcrash_async_mobject_t mobj;
+    if (plcrash_async_mobject_init(&mobj, mach_task_self(), payload, size, true) != PLCRASH_ESUCCESS)
+        return;
+
+    plcrash_async_cfe_reader_t reader;
+    if (plcrash_async_cfe_reader_init(&reader, &mobj, cpu_type) == PLCRASH_ESUCCESS) {
+        pl_vm_address_t function_base;
+        uint32_t encoding;
+
+        if (plcrash_async_cfe_reader_find_pc(&reader, header->pc_offset, &function_base, &encoding) == PLCRASH_ESUCCESS) {
+            plcrash_async_cfe_entry_t entry;
+            if (plcrash_async_cfe_entry_init(&entry, cpu_type, encoding) == PLCRASH_ESUCCESS)
+                plcrash_async_cfe_entry_free(&entry);
+        }
+
+        plcrash_async_cfe_reader_free(&reader);
+    }
+
+    plcrash_async_mobject_free(&mobj);
+}
+
+#if PLCRASH_FEATURE_UNWIND_DWARF
+/*
+ * Exercise the DWARF frame reader, CIE parser, and CFA program evaluator.
+ */
+template <typename machine_ptr, typename machine_ptr_s>
+static void fuzz_dwarf (const struct fuzz_header *header, pl_vm_address_t payload, size_t size) {
+    using namespace plcrash::async;
+
+    const plcrash_async_byteorder_t *byteorder = (header->flags & FUZZ_FLAG_BIG_ENDIAN) ? plcrash_async_byteorder_big_endian() : plcrash_async_byteorder_little_endian();
+    bool debug_frame = (header->flags & FUZZ_FLAG_DEBUG_FRAME) != 0;
+    machine_ptr pc = (machine_ptr) (payload + header->pc_offset);
+
+    plcrash_async_mobject_t mobj;
+    if (plcrash_async_mobject_init(&mobj, mach_task_self(), payload, size, true) != PLCRASH_ESUCCESS)
+        return;
+
+    dwarf_frame_reader reader;
+    plcrash_async_dwarf_fde_info_t fde_info;
+    if (reader.init(&mobj, byteorder, sizeof(machine_ptr) == sizeof(uint64_t), debug_frame) != PLCRASH_ESUCCESS ||
+        reader.find_fde(0, pc, &fde_info) != PLCRASH_ESUCCESS)
+    {
+        plcrash_async_mobject_free(&mobj);
+        return;
+    }
+
+    gnu_ehptr_reader<machine_ptr> ptr_state(byteorder);
+    ptr_state.set_frame_section_base((machine_ptr) payload, (machine_ptr) payload);
+
+    plcrash_async_dwarf_cie_info_t cie_info;
+    if (plcrash_async_dwarf_cie_info_init(&cie_info, &mobj, byteorder, &ptr_state, payload + fde_info.cie_offset) == PLCRASH_ESUCCESS) {
+        dwarf_cfa_state<machine_ptr, machine_ptr_s> cfa_state;
+        if (cfa_state.eval_program(&mobj, pc, (machine_ptr) fde_info.pc_start, &cie_info, &ptr_state, byteorder, payload, cie_info.initial_instructions_offset, cie_info.initial_instructions_length) == PLCRASH_ESUCCESS)
+            cfa_state.eval_program(&mobj, pc, (machine_ptr) fde_info.pc_start, &cie_info, &ptr_state, byteorder, payload, fde_info.instructions_offset, fde_info.instructions_length);
+
+        plcrash_async_dwarf_cie_info_free(&cie_info);
+    }
+
+    plcrash_async_dwarf_fde_info_free(&fde_info);
+    plcrash_async_mobject_free(&mobj);
+}
+#endif /* PLCRASH_FEATURE_UNWIND_DWARF */
+
+/*
+ * libFuzzer entry point.
+ */
+extern "C" int LLVMFuzzerTestOneInput (const uint8_t *data, size_t size) {
+    struct fuzz_header header;
+    if (size < sizeof(header))
+        return 0;
+
+    memcpy(&header, data, sizeof(header));
+    data += sizeof(header);
+    size -= sizeof(header);
+
+    if (size > FUZZ_MAX_PAYLOAD)
+        size = FUZZ_MAX_PAYLOAD;
+
+    switch (header.target % FUZZ_TARGET_COUNT) {
+        case FUZZ_TARGET_REPORT: {
+            NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+            NSData *report_data = [NSData dataWithBytesNoCopy: (void *) data length: size freeWhenDone: NO];
+            [[[PLCrashReport alloc] initWithData: report_data error: NULL] release];
+            [pool release];
+            break;
+        }
+
+        case FUZZ_TARGET_MACHO:
+            fuzz_macho(&header, (pl_vm_address_t) fuzz_stage_payload(data, size));
+            break;
+
+        case FUZZ_TARGET_CFE:
+            fuzz_cfe(&header, (pl_vm_address_t) fuzz_stage_payload(data, size), size);
+            break;
+
+        case FUZZ_TARGET_DWARF:
+#if PLCRASH_FEATURE_UNWIND_DWARF
+            if (header.flags & FUZZ_FLAG_M64)
+                fuzz_dwarf<uint64_t, int64_t>(&header, (pl_vm_address_t) fuzz_stage_payload(data, size), size);
+            else
+                fuzz_dwarf<uint32_t, int32_t>(&header, (pl_vm_address_t) fuzz_stage_payload(data, size), size);
+#endif
+            break;
+    }
+
+    return 0;
+}
+
+#ifndef PLCRASH_FUZZ_LIBFUZZER
+
+/*
+ * Print command line usage.
+ */
+static void print_usage () {
+    fprintf(stderr, "Usage: plcrashfuzz [--runs=<count>] [--seed=<seed>] <corpus file> ...\n"
+                    "  --runs  Number of mutated inputs to execute (default 1000000).\n"
+                    "  --seed  Mutation random seed (default 1).\n"
+                    "Each corpus file must begin with a 16-byte fuzz header selecting the target parser.\n");
+}
+
+/*
+ * Return a pseudo-random value; a fixed xorshift generator is used so that runs are reproducible for a given seed.
+ */
+static uint64_t fuzz_random (uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+/* Return the elapsed time between two mach_absolute_time() values, in seconds. */
+static double fuzz_elapsed (uint64_t start, uint64_t end) {
+    static mach_timebase_info_data_t timebase;
+    if (timebase.denom == 0)
+        mach_timebase_info(&timebase);
+
+    return (double) ((end - start) * timebase.numer / timebase.denom) / NSEC_PER_SEC;
+}
+
+/*
+ * Standalone persistent-mode driver. Each corpus file is executed as-is, followed by the requested number of
+ * in-process mutations of randomly selected corpus entries.
+ */
+int main (int argc, char *argv[]) {
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    uint64_t runs = 1000000;
+    uint64_t seed = 1;
+
+    static struct option longopts[] = {
+        { "runs",   required_argument,  NULL,   'r' },
+        { "seed",   required_argument,  NULL,   's' },
+        { "help",   no_argument,        NULL,   'h' },
+        { NULL,     0,                  NULL,   0 }
+    };
+
+    int ch;
+    while ((ch = getopt_long(argc, argv, "r:s:h", longopts, NULL)) != -1) {
+        switch (ch) {
+            case 'r':
+                runs = strtoull(optarg, NULL, 10);
+                break;
+            case 's':
+                seed = strtoull(optarg, NULL, 10);
+                break;
+            default:
+                print_usage();
+                return 1;
+        }
+    }
+    argc -= optind;
+    argv += optind;
+
+    if (argc < 1 || seed == 0) {
+        print_usage();
+        return 1;
+    }
+
+    /* Load the corpus */
+    NSMutableArray *corpus = [NSMutableArray array];
+    for (int i = 0; i < argc; i++) {
+        NSData *data = [NSData dataWithContentsOfFile: [NSString stringWithUTF8String: argv[i]]];
+        if (data == nil) {
+            fprintf(stderr, "Could not load fuzz input from %s\n", argv[i]);
+            return 1;
+        }
+
+        LLVMFuzzerTestOneInput((const uint8_t *) [data bytes], [data length]);
+        [corpus addObject: data];
+    }
+
+    /* Execute mutated inputs */
+    NSMutableData *input = [NSMutableData data];
+    uint64_t rng = seed;
+    uint64_t start = mach_absolute_time();
+    uint64_t last_report = start;
+    uint64_t last_runs = 0;
+
+    for (uint64_t i = 0; i < runs; i++) {
+        NSData *base = [corpus objectAtIndex: fuzz_random(&rng) % [corpus count]];
+        [input setData: base];
+
+        /* Flip a handful of bytes; the fuzz_header is left intact so that the target selection is stable */
+        uint8_t *bytes = (uint8_t *) [input mutableBytes];
+        size_t length = [input length];
+        if (length > sizeof(struct fuzz_header)) {
+            uint64_t count = 1 + fuzz_random(&rng) % 8;
+            for (uint64_t j = 0; j < count; j++) {
+                size_t offset = sizeof(struct fuzz_header) + fuzz_random(&rng) % (length - sizeof(struct fuzz_header));
+                bytes[offset] ^= (uint8_t) (1 + fuzz_random(&rng) % 255);
+            }
+        }
+
+        LLVMFuzzerTestOneInput(bytes, length);
+
+        /* Report throughput roughly once per second */
+        uint64_t now = mach_absolute_time();
+        if (fuzz_elapsed(last_report, now) >= 1.0) {
+            fprintf(stderr, "#%" PRIu64 "\texec/s: %.0f\n", i + 1, (i + 1 - last_runs) / fuzz_elapsed(last_report, now));
+            last_report = now;
+            last_runs = i + 1;
+        }
+    }
+
+    double total = fuzz_elapsed(start, mach_absolute_time());
+    fprintf(stderr, "Done %" PRIu64 " runs in %.2f seconds (%.0f exec/s)\n", runs, total, total > 0 ? runs / total : 0.0);
+
+    [pool release];
+    return 0;
+}
+
+#endif /* !PLCRASH_FUZZ_LIBFUZZER */
@@ -28,6 +28,8 @@
 
 #include <dlfcn.h>
 #include <mach-o/dyld.h>
+#include <mach/mach.h>
+#include <mach/mach_time.h>
 
 #include "PLCrashFrameWalker.h"
 
@@ -191,6 +193,56 @@ static struct unwind_test_case unwind_test_cases[] = {
 };
 
 
+/* Human readable fixture names, used to label benchmark results */
+static const struct {
+    void *test_list;
+    const char *name;
+} unwind_fixture_names[] = {
+#ifdef __x86_64__
+    { unwind_tester_list_x86_64_disable_compact_frame,  "disable_compact_frame" },
+    { unwind_tester_list_x86_64_frame,                  "frame" },
+    { unwind_tester_list_x86_64_frameless,              "frameless" },
+    { unwind_tester_list_x86_64_frameless_big,          "frameless_big" },
+    { unwind_tester_list_x86_64_unusual,                "unusual" },
+#elif defined(__i386__)
+    { unwind_tester_list_x86_disable_compact_frame,     "disable_compact_frame" },
+    { unwind_tester_list_x86_frame,                     "frame" },
+    { unwind_tester_list_x86_frameless,                 "frameless" },
+    { unwind_tester_list_x86_frameless_big,             "frameless_big" },
+    { unwind_tester_list_x86_unusual,                   "unusual" },
+#elif defined(__arm64__)
+    { unwind_tester_list_arm64_frame,                   "frame" },
+    { unwind_tester_list_arm64_frameless,               "frameless" },
+#endif
+    { NULL, NULL }
+};
+
+#ifdef __x86_64__
+#define UNWIND_BENCHMARK_ARCH "x86_64"
+#elif defined(__i386__)
+#define UNWIND_BENCHMARK_ARCH "i386"
+#elif defined(__arm64__)
+#define UNWIND_BENCHMARK_ARCH "arm64"
+#elif defined(__arm__)
+#define UNWIND_BENCHMARK_ARCH "arm"
+#else
+#define UNWIND_BENCHMARK_ARCH "unknown"
+#endif
+
+/*
+ * Benchmark results for a single test case, accumulated across all of the test case's test functions.
+ */
+struct unwind_benchmark_result {
+    /** The total number of frames read via the test case's frame readers. */
+    uint64_t frames;
+
+    /** The total time spent reading those frames, in mach_absolute_time() units. */
+    uint64_t elapsed;
+
+    /** The total number of Mach and BSD system calls issued while reading those frames. */
+    uint64_t syscalls;
+};
+
 /*
  * We abuse global state to pass configuration down to the test result handling
  * without having to modify all of Apple's test cases. This means the tests
@@ -199,6 +251,15 @@ static struct unwind_test_case unwind_test_cases[] = {
 struct  {
     /** The current test case */
     struct unwind_test_case *test_case;
+
+    /** The number of times each frame read should be repeated when benchmarking, or 0 if not benchmarking. */
+    uint32_t benchmark_iterations;
+
+    /** If true, benchmark iterations share an unwind cache. */
+    bool benchmark_cached;
+
+    /** The current test case's benchmark results. */
+    struct unwind_benchmark_result benchmark_result;
 } global_harness_state;
 
 /*
@@ -221,6 +282,152 @@ bool unwind_test_harness (void) {
 	return true;
 }
 
+/* Return the name of @a test_list's fixture */
+static const char *unwind_fixture_name (void *test_list) {
+    for (size_t i = 0; unwind_fixture_names[i].test_list != NULL; i++) {
+        if (unwind_fixture_names[i].test_list == test_list)
+            return unwind_fixture_names[i].name;
+    }
+
+    return "unknown";
+}
+
+/* Return the name of @a readers */
+static const char *unwind_readers_name (plframe_cursor_frame_reader_t **readers) {
+    if (readers == NULL)
+        return "default";
+    else if (readers == frame_readers_frame)
+        return "frame_ptr";
+    else if (readers == frame_readers_compact)
+        return "compact";
+    else if (readers == frame_readers_dwarf)
+        return "dwarf";
+
+    return "unknown";
+}
+
+/* Return the total number of Mach and BSD system calls issued by the current task */
+static uint64_t unwind_benchmark_syscall_count (void) {
+    task_events_info_data_t info;
+    mach_msg_type_number_t count = TASK_EVENTS_INFO_COUNT;
+
+    if (task_info(mach_task_self(), TASK_EVENTS_INFO, (task_info_t) &info, &count) != KERN_SUCCESS)
+        return 0;
+
+    return (uint64_t) info.syscalls_mach + (uint64_t) info.syscalls_unix;
+}
+
+/**
+ * Run each test case's test functions, repeating every frame read @a iterations times, and write the per-reader
+ * timings to stdout. Each test case is run twice; once without an unwind cache, and once with an unwind cache shared
+ * across all iterations.
+ *
+ * Results are written as one JSON object per line, with the following keys:
+ * - arch: The architecture of the test fixtures.
+ * - fixture: The test fixture (eg, frame, frameless, frameless_big, unusual, disable_compact_frame).
+ * - reader: The frame reader(s) used to unwind the test function (frame_ptr, compact, dwarf, or default).
+ * - cached: True if the frame reads were performed with an unwind cache.
+ * - frames: The total number of frames read.
+ * - ns_per_frame: The mean time required to read a frame, in nanoseconds.
+ * - syscalls_per_frame: The mean number of Mach and BSD system calls issued to read a frame.
+ *
+ * @param iterations The number of times each frame read should be repeated.
+ */
+bool unwind_benchmark_harness (uint32_t iterations) {
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+
+    for (int cached = 0; cached < 2; cached++) {
+        for (struct unwind_test_case *tc = unwind_test_cases; tc->test_list != NULL; tc++) {
+            global_harness_state.test_case = tc;
+            global_harness_state.benchmark_iterations = iterations;
+            global_harness_state.benchmark_cached = cached;
+            global_harness_state.benchmark_result.frames = 0;
+            global_harness_state.benchmark_result.elapsed = 0;
+            global_harness_state.benchmark_result.syscalls = 0;
+
+            for (void **tests = tc->test_list; *tests != NULL; tests++) {
+                int ret;
+                if ((ret = unwind_tester(*tests, &tc->expected_sp)) != 0) {
+                    PLCF_DEBUG("Tester returned error %d for %p", ret, *tests);
+                    __builtin_trap();
+                }
+            }
+
+            struct unwind_benchmark_result *result = &global_harness_state.benchmark_result;
+            if (result->frames == 0)
+                continue;
+
+            double ns = (double) result->elapsed * timebase.numer / timebase.denom;
+            printf("{\"arch\": \"%s\", \"fixture\": \"%s\", \"reader\": \"%s\", \"cached\": %s, \"frames\": %" PRIu64 ", "
+                   "\"ns_per_frame\": %.1f, \"syscalls_per_frame\": %.2f}\n",
+                   UNWIND_BENCHMARK_ARCH, unwind_fixture_name(tc->test_list), unwind_readers_name(tc->frame_readers_dwarf),
+                   cached ? "true" : "false", result->frames, ns / result->frames, (double) result->syscalls / result->frames);
+        }
+    }
+    fflush(stdout);
+
+    global_harness_state.benchmark_iterations = 0;
+    return true;
+}
+
+/*
+ * Repeat the frame read from the test function global_harness_state.benchmark_iterations times, accumulating the
+ * results in global_harness_state.benchmark_result.
+ */
+static void unwind_benchmark_state (plcrash_async_thread_state_t *state, plcrash_async_image_list_t *image_list, size_t reader_count) {
+    plframe_cursor_frame_reader_t **readers = global_harness_state.test_case->frame_readers_dwarf;
+    struct unwind_benchmark_result *result = &global_harness_state.benchmark_result;
+    plframe_unwind_cache_t unwind_cache;
+
+    /* Determine the number of system calls issued by the syscall counting itself */
+    uint64_t syscall_overhead = unwind_benchmark_syscall_count();
+    syscall_overhead = unwind_benchmark_syscall_count() - syscall_overhead;
+
+    plframe_unwind_cache_init(&unwind_cache);
+
+    for (uint32_t i = 0; i < global_harness_state.benchmark_iterations; i++) {
+        plframe_cursor_t cursor;
+        plframe_error_t err;
+
+        plframe_cursor_init(&cursor, mach_task_self(), state, image_list);
+        if (global_harness_state.benchmark_cached)
+            plframe_cursor_set_unwind_cache(&cursor, &unwind_cache);
+
+        /* Walk the frames until we hit the test function; these reads are not included in the results */
+        for (uint32_t j = 0; j < global_harness_state.test_case->intermediate_frames; j++) {
+            if ((err = plframe_cursor_next(&cursor)) != PLFRAME_ESUCCESS) {
+                PLCF_DEBUG("Step failed: %d", err);
+                __builtin_trap();
+            }
+        }
+
+        /* Time the read from within the test function */
+        uint64_t syscalls = unwind_benchmark_syscall_count();
+        uint64_t start = mach_absolute_time();
+        if (readers != NULL) {
+            err = plframe_cursor_next_with_readers(&cursor, readers, reader_count);
+        } else {
+            err = plframe_cursor_next(&cursor);
+        }
+        result->elapsed += mach_absolute_time() - start;
+
+        syscalls = unwind_benchmark_syscall_count() - syscalls;
+        if (syscalls > syscall_overhead)
+            result->syscalls += syscalls - syscall_overhead;
+        result->frames++;
+
+        if (err != PLFRAME_ESUCCESS) {
+            PLCF_DEBUG("Step within test function failed: %d (%s)", err, plframe_strerror(err));
+            __builtin_trap();
+        }
+
+        plframe_cursor_free(&cursor);
+    }
+
+    plframe_unwind_cache_free(&unwind_cache);
+}
+
 #define VERIFY_NV_REG(cursor, rnum, value) do { \
     plcrash_greg_t reg; \
     if (plframe_cursor_get_reg(cursor, rnum, &reg) != PLFRAME_ESUCCESS) { \
@@ -252,6 +459,10 @@ static plcrash_error_t unwind_current_state (plcrash_async_thread_state_t *state
     for (uint32_t i = 0; i < _dyld_image_count(); i++)
         plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
 
+    /* Benchmark the frame readers, if requested */
+    if (global_harness_state.benchmark_iterations > 0)
+        unwind_benchmark_state(state, &image_list, reader_count);
+
     /* Initialie our cursor */
     plframe_cursor_init(&cursor, mach_task_self(), state, &image_list);
 
@@ -27,11 +27,16 @@
  */
 
 #include "PLCrashAsync.h"
+#include "PLCrashAsyncLZ.h"
 
 #include <stdint.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <string.h>
 #include <inttypes.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 
 /**
  * @internal
@@ -75,7 +80,8 @@ static uint64_t plcr_nswap64 (uint64_t input) {
 const plcrash_async_byteorder_t plcrash_async_byteorder_swapped = {
     .swap16 = plcr_swap16,
     .swap32 = plcr_swap32,
-    .swap64 = plcr_swap64
+    .swap64 = plcr_swap64,
+    .native = false
 };
 
 /**
@@ -84,7 +90,8 @@ const plcrash_async_byteorder_t plcrash_async_byteorder_swapped = {
 const plcrash_async_byteorder_t plcrash_async_byteorder_direct = {
     .swap16 = plcr_nswap16,
     .swap32 = plcr_nswap32,
-    .swap64 = plcr_nswap64
+    .swap64 = plcr_nswap64,
+    .native = true
 };
 
 /**
@@ -227,6 +234,68 @@ plcrash_error_t plcrash_async_task_memcpy (mach_port_t task, pl_vm_address_t add
     }
 }
 
+/**
+ * Perform the reads described by @a reads from @a task. Requests that fall within a span of
+ * PLCRASH_ASYNC_TASK_READ_COALESCE_MAX bytes of their neighbours are coalesced into a
+ * single covering read, requiring one trap per span rather than one per request.
+ *
+ * If a covering read fails (the gap between two requests may not be readable), the coalesced
+ * requests are retried individually.
+ *
+ * @param task The task from which data will be read.
+ * @param reads The read requests to be performed.
+ * @param count The number of requests in @a reads.
+ *
+ * @return On success, returns PLCRASH_ESUCCESS. If any request fails, the remaining requests will still
+ * be performed, and the error of the first failed request will be returned; the destination buffers of
+ * failed requests are undefined. The errors are those of plcrash_async_task_memcpy().
+ */
+plcrash_error_t plcrash_async_task_memcpy_batch (mach_port_t task, const plcrash_async_task_read_t *reads, size_t count) {
+    uint8_t buffer[PLCRASH_ASYNC_TASK_READ_COALESCE_MAX];
+    plcrash_error_t result = PLCRASH_ESUCCESS;
+    size_t i = 0;
+
+    while (i < count) {
+        pl_vm_address_t lo = reads[i].address;
+        pl_vm_address_t hi = reads[i].address + reads[i].len;
+        size_t n = 1;
+
+        /* Extend the run while the covering span remains within our buffer */
+        if (reads[i].len <= sizeof(buffer) && reads[i].address <= PL_VM_ADDRESS_MAX - reads[i].len) {
+            while (i + n < count) {
+                const plcrash_async_task_read_t *r = &reads[i + n];
+                if (r->len > sizeof(buffer) || r->address > PL_VM_ADDRESS_MAX - r->len)
+                    break;
+
+                pl_vm_address_t r_lo = r->address < lo ? r->address : lo;
+                pl_vm_address_t r_hi = r->address + r->len > hi ? r->address + r->len : hi;
+                if (r_hi - r_lo > sizeof(buffer))
+                    break;
+
+                lo = r_lo;
+                hi = r_hi;
+                n++;
+            }
+        }
+
+        /* Perform the covering read, falling back on individual reads */
+        if (n > 1 && plcrash_async_task_memcpy(task, lo, 0, buffer, hi - lo) == PLCRASH_ESUCCESS) {
+            for (size_t j = i; j < i + n; j++)
+                plcrash_async_memcpy(reads[j].dest, buffer + (reads[j].address - lo), reads[j].len);
+        } else {
+            for (size_t j = i; j < i + n; j++) {
+                plcrash_error_t err = plcrash_async_task_memcpy(task, reads[j].address, 0, reads[j].dest, reads[j].len);
+                if (err != PLCRASH_ESUCCESS && result == PLCRASH_ESUCCESS)
+                    result = err;
+            }
+        }
+
+        i += n;
+    }
+
+    return result;
+}
+
 /**
  * Read an 8-bit value from @a task, at @a address + @a offset, storing in @a dest. If the page(s) at the
  * given @a address + @a offset are unmapped or unreadable, no copy will be performed and an error will
@@ -264,7 +333,7 @@ plcrash_error_t plcrash_async_task_read_uint16 (task_t task, const plcrash_async
                                                 pl_vm_address_t address, pl_vm_off_t offset, uint16_t *result)
 {
     plcrash_error_t err = plcrash_async_task_memcpy(task, address, offset, result, sizeof(*result));
-    *result = byteorder->swap16(*result);
+    *result = plcrash_async_swap16(byteorder, *result);
     return err;
 }
 
@@ -288,7 +357,7 @@ plcrash_error_t plcrash_async_task_read_uint32 (task_t task, const plcrash_async
                                                 pl_vm_address_t address, pl_vm_off_t offset, uint32_t *result)
 {
     plcrash_error_t err = plcrash_async_task_memcpy(task, address, offset, result, sizeof(*result));
-    *result = byteorder->swap32(*result);
+    *result = plcrash_async_swap32(byteorder, *result);
     return err;
 }
 
@@ -312,32 +381,70 @@ plcrash_error_t plcrash_async_task_read_uint64 (task_t task, const plcrash_async
                                                 pl_vm_address_t address, pl_vm_off_t offset, uint64_t *result)
 {
     plcrash_error_t err = plcrash_async_task_memcpy(task, address, offset, result, sizeof(*result));
-    *result = byteorder->swap64(*result);
+    *result = plcrash_async_swap64(byteorder, *result);
     return err;
 }
 
+/* Word type used by the word-at-a-time string and memory routines below. */
+typedef uintptr_t __attribute__((__may_alias__)) plcr_word_t;
+
+/* Word alignment mask */
+#define PLCR_WORD_MASK (sizeof(plcr_word_t) - 1)
+
+/* A word with every byte set to 0x01, and to 0x80, respectively. */
+#define PLCR_WORD_ONES ((plcr_word_t) -1 / 0xFF)
+#define PLCR_WORD_HIGHS (PLCR_WORD_ONES * 0x80)
+
+/* Evaluates to non-zero if any byte of @a w is zero. */
+#define PLCR_WORD_HAS_ZERO(w) (((w) - PLCR_WORD_ONES) & ~(w) & PLCR_WORD_HIGHS)
+
 /**
- * An intentionally naive async-safe implementation of strcmp(). strcmp() itself is not declared to be async-safe,
+ * An async-safe implementation of strcmp(). strcmp() itself is not declared to be async-safe,
  * though in reality, it is.
  *
+ * If both strings share the same word alignment, they are compared a word at a time. Aligned word reads
+ * never cross a page boundary, and so may safely read past the terminating NUL.
+ *
  * @param s1 First string.
  * @param s2 Second string.
  * @return Return an integer greater than, equal to, or less than 0, according as the string @a s1 is greater than,
  * equal to, or less than the string @a s2.
  */
 int plcrash_async_strcmp(const char *s1, const char *s2) {
-    while (*s1 == *s2++) {
-        if (*s1++ == 0)
+    if ((((uintptr_t) s1 ^ (uintptr_t) s2) & PLCR_WORD_MASK) == 0) {
+        /* Compare the unaligned head */
+        for (; ((uintptr_t) s1 & PLCR_WORD_MASK) != 0; s1++, s2++) {
+            if (*s1 != *s2 || *s1 == 0)
+                return (*(const unsigned char *)s1 - *(const unsigned char *)s2);
+        }
+
+        /* Compare whole words until a difference or a NUL is found */
+        const plcr_word_t *w1 = (const plcr_word_t *) s1;
+        const plcr_word_t *w2 = (const plcr_word_t *) s2;
+        while (*w1 == *w2 && !PLCR_WORD_HAS_ZERO(*w1)) {
+            w1++;
+            w2++;
+        }
+
+        s1 = (const char *) w1;
+        s2 = (const char *) w2;
+    }
+
+    /* Compare the remainder */
+    for (; *s1 == *s2; s1++, s2++) {
+        if (*s1 == 0)
             return (0);
     }
-    
-    return (*(const unsigned char *)s1 - *(const unsigned char *)(s2 - 1));
+
+    return (*(const unsigned char *)s1 - *(const unsigned char *)s2);
 }
 
 /**
- * An intentionally naive async-safe implementation of strncmp(). strncmp() itself is not declared to be async-safe,
+ * An async-safe implementation of strncmp(). strncmp() itself is not declared to be async-safe,
  * though in reality, it is.
  *
+ * As with plcrash_async_strcmp(), strings that share the same word alignment are compared a word at a time.
+ *
  * @param s1 First string.
  * @param s2 Second string.
  * @param n No more than n characters will be compared.
@@ -345,37 +452,182 @@ int plcrash_async_strcmp(const char *s1, const char *s2) {
  * equal to, or less than the string @a s2.
  */
 int plcrash_async_strncmp(const char *s1, const char *s2, size_t n) {
-    while (*s1 == *s2++ && n-- > 0) {
-        if (*s1++ == 0)
+    if ((((uintptr_t) s1 ^ (uintptr_t) s2) & PLCR_WORD_MASK) == 0) {
+        /* Compare the unaligned head */
+        for (; n > 0 && ((uintptr_t) s1 & PLCR_WORD_MASK) != 0; s1++, s2++, n--) {
+            if (*s1 != *s2 || *s1 == 0)
+                return (*(const unsigned char *)s1 - *(const unsigned char *)s2);
+        }
+
+        /* Compare whole words until a difference or a NUL is found */
+        const plcr_word_t *w1 = (const plcr_word_t *) s1;
+        const plcr_word_t *w2 = (const plcr_word_t *) s2;
+        while (n >= sizeof(plcr_word_t) && *w1 == *w2 && !PLCR_WORD_HAS_ZERO(*w1)) {
+            w1++;
+            w2++;
+            n -= sizeof(plcr_word_t);
+        }
+
+        s1 = (const char *) w1;
+        s2 = (const char *) w2;
+    }
+
+    /* Compare the remainder */
+    for (; n > 0; s1++, s2++, n--) {
+        if (*s1 != *s2)
+            return (*(const unsigned char *)s1 - *(const unsigned char *)s2);
+
+        if (*s1 == 0)
             return (0);
     }
-    
-    if (n == 0)
-        return 0;
 
-    return (*(const unsigned char *)s1 - *(const unsigned char *)(s2 - 1));
+    return 0;
+}
+
+/**
+ * An async-safe implementation of strnlen(). strnlen() itself is not declared to be async-safe,
+ * though in reality, it is.
+ *
+ * Once @a s is word aligned, the string is scanned a word at a time. No bytes beyond @a maxlen are read.
+ *
+ * @param s The string to scan.
+ * @param maxlen The maximum number of bytes to scan.
+ * @return Returns the number of bytes preceding the terminating NUL, or @a maxlen if no NUL is found
+ * within the first @a maxlen bytes.
+ */
+size_t plcrash_async_strnlen(const char *s, size_t maxlen) {
+    const char *p = s;
+    size_t n = maxlen;
+
+    /* Scan the unaligned head */
+    for (; n > 0 && ((uintptr_t) p & PLCR_WORD_MASK) != 0; p++, n--) {
+        if (*p == 0)
+            return p - s;
+    }
+
+    /* Scan whole words until a NUL is found */
+    const plcr_word_t *w = (const plcr_word_t *) p;
+    while (n >= sizeof(plcr_word_t) && !PLCR_WORD_HAS_ZERO(*w)) {
+        w++;
+        n -= sizeof(plcr_word_t);
+    }
+
+    /* Locate the NUL within the remainder */
+    for (p = (const char *) w; n > 0; p++, n--) {
+        if (*p == 0)
+            return p - s;
+    }
+
+    return maxlen;
 }
 
 /**
- * An intentionally naive async-safe implementation of memcpy(). memcpy() itself is not declared to be async-safe,
+ * Return the length of the longest well-formed UTF-8 prefix of the NUL-terminated string @a s, as defined by
+ * Table 3-7 of the Unicode Standard; overlong encodings, surrogates, and code points above U+10FFFF are rejected.
+ *
+ * Once @a s is word aligned, runs of ASCII are skipped a word at a time. As with plcrash_async_strnlen(), aligned
+ * word reads never cross a page boundary, and no bytes are read beyond the first invalid sequence.
+ *
+ * @param s The string to validate.
+ * @return Returns the number of bytes preceding the terminating NUL or the first ill-formed sequence, whichever
+ * occurs first.
+ */
+size_t plcrash_async_utf8_strlen (const char *s) {
+    const uint8_t *p = (const uint8_t *) s;
+
+    for (;;) {
+        /* Skip whole words of non-NUL ASCII */
+        if (((uintptr_t) p & PLCR_WORD_MASK) == 0) {
+            const plcr_word_t *w = (const plcr_word_t *) p;
+            while (((*w & PLCR_WORD_HIGHS) | PLCR_WORD_HAS_ZERO(*w)) == 0)
+                w++;
+            p = (const uint8_t *) w;
+        }
+
+        uint8_t c = *p;
+        if (c == 0)
+            break;
+
+        if (c < 0x80) {
+            p++;
+            continue;
+        }
+
+        /* Determine the sequence length, and the permitted range of the second byte */
+        size_t len;
+        uint8_t lo = 0x80;
+        uint8_t hi = 0xBF;
+        if (c >= 0xC2 && c <= 0xDF) {
+            len = 2;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            len = 3;
+            if (c == 0xE0)
+                lo = 0xA0;
+            else if (c == 0xED)
+                hi = 0x9F;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            len = 4;
+            if (c == 0xF0)
+                lo = 0x90;
+            else if (c == 0xF4)
+                hi = 0x8F;
+        } else {
+            break;
+        }
+
+        /* A NUL fails either check, terminating the scan before any further bytes are read */
+        if (p[1] < lo || p[1] > hi)
+            break;
+
+        size_t i;
+        for (i = 2; i < len && (p[i] & 0xC0) == 0x80; i++);
+        if (i != len)
+            break;
+
+        p += len;
+    }
+
+    return (size_t) ((const char *) p - s);
+}
+
+/**
+ * An async-safe implementation of memcpy(). memcpy() itself is not declared to be async-safe,
  * though in reality, it is.
  *
+ * If @a dest and @a source share the same word alignment, the data is copied a word at a time.
+ *
  * @param dest Destination.
  * @param source Source.
  * @param n Number of bytes to copy.
  */
 void *plcrash_async_memcpy (void *dest, const void *source, size_t n) {
-    uint8_t *s = (uint8_t *) source;
+    const uint8_t *s = (const uint8_t *) source;
     uint8_t *d = (uint8_t *) dest;
 
-    for (size_t count = 0; count < n; count++)
+    if ((((uintptr_t) s ^ (uintptr_t) d) & PLCR_WORD_MASK) == 0) {
+        /* Copy the unaligned head */
+        for (; n > 0 && ((uintptr_t) d & PLCR_WORD_MASK) != 0; n--)
+            *d++ = *s++;
+
+        /* Copy whole words */
+        plcr_word_t *dw = (plcr_word_t *) d;
+        const plcr_word_t *sw = (const plcr_word_t *) s;
+        for (; n >= sizeof(plcr_word_t); n -= sizeof(plcr_word_t))
+            *dw++ = *sw++;
+
+        d = (uint8_t *) dw;
+        s = (const uint8_t *) sw;
+    }
+
+    /* Copy the remainder */
+    for (; n > 0; n--)
         *d++ = *s++;
 
     return (void *) source;
 }
 
 /**
- * An intentionally naive async-safe implementation of memset(). memset() itself is not declared to be async-safe,
+ * An async-safe implementation of memset(). memset() itself is not declared to be async-safe,
  * though in reality, it is.
  *
  * @param dest Destination.
@@ -384,13 +636,234 @@ void *plcrash_async_memcpy (void *dest, const void *source, size_t n) {
  */
 void *plcrash_async_memset(void *dest, uint8_t value, size_t n) {
     uint8_t *d = (uint8_t *) dest;
-    
-    for (size_t count = 0; count < n; count++)
+
+    /* Write the unaligned head */
+    for (; n > 0 && ((uintptr_t) d & PLCR_WORD_MASK) != 0; n--)
+        *d++ = value;
+
+    /* Write whole words */
+    plcr_word_t pattern = PLCR_WORD_ONES * value;
+    plcr_word_t *dw = (plcr_word_t *) d;
+    for (; n >= sizeof(plcr_word_t); n -= sizeof(plcr_word_t))
+        *dw++ = pattern;
+
+    /* Write the remainder */
+    d = (uint8_t *) dw;
+    for (; n > 0; n--)
         *d++ = value;
 
     return (void *) dest;
 }
 
+/**
+ * @internal
+ * @ingroup plcrash_async
+ * @defgroup plcrash_async_arena Async-safe Scratch Arena
+ *
+ * Crash-time scratch memory (caches, tables, and similar report-scoped allocations) is allocated via
+ * plcrash_async_scratch_allocate(). While a registered arena is active, allocations are served from
+ * the arena's prefaulted pages; otherwise, or once the arena is exhausted, they fall back on vm_allocate().
+ * @{
+ */
+
+/* Alignment of arena allocations, in bytes */
+#define PLCR_ARENA_ALIGNMENT 16
+
+/**
+ * Initialize a new arena of @a size bytes. The arena's pages are allocated and faulted in immediately.
+ *
+ * @param arena The arena to initialize.
+ * @param size The arena size, in bytes. This will be rounded up to a whole page.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_ENOMEM if the arena could not be allocated.
+ *
+ * @warning This method is not async safe.
+ */
+plcrash_error_t plcrash_nasync_arena_init (plcrash_async_arena_t *arena, size_t size) {
+    vm_address_t addr;
+
+    size = round_page(size);
+    kern_return_t kt = vm_allocate(mach_task_self(), &addr, size, VM_FLAGS_ANYWHERE);
+    if (kt != KERN_SUCCESS) {
+        PLCF_DEBUG("vm_allocate() failure: %d", kt);
+        return PLCRASH_ENOMEM;
+    }
+
+    /* Fault in every page now, rather than at crash time */
+    for (size_t offset = 0; offset < size; offset += vm_page_size)
+        ((volatile uint8_t *) addr)[offset] = 0;
+
+    arena->base = (uint8_t *) addr;
+    arena->size = size;
+    arena->used = 0;
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Allocate @a size bytes of zero-filled memory from @a arena. Allocation is lock-free, and may be performed
+ * concurrently.
+ *
+ * @param arena The arena from which memory will be allocated.
+ * @param size The number of bytes to allocate.
+ *
+ * @return Returns a pointer to the allocated memory, or NULL if the arena has insufficient space. The memory remains
+ * valid until the arena is reset.
+ */
+void *plcrash_async_arena_alloc (plcrash_async_arena_t *arena, size_t size) {
+    size_t aligned = (size + (PLCR_ARENA_ALIGNMENT - 1)) & ~((size_t) PLCR_ARENA_ALIGNMENT - 1);
+    size_t used;
+
+    if (aligned < size)
+        return NULL;
+
+    do {
+        used = arena->used;
+        if (aligned > arena->size - used)
+            return NULL;
+    } while (!__sync_bool_compare_and_swap(&arena->used, used, used + aligned));
+
+    void *ptr = arena->base + used;
+    plcrash_async_memset(ptr, 0, size);
+    return ptr;
+}
+
+/**
+ * Return true if @a ptr was allocated from @a arena.
+ *
+ * @param arena The arena to check.
+ * @param ptr The pointer to check.
+ */
+bool plcrash_async_arena_contains (plcrash_async_arena_t *arena, const void *ptr) {
+    return (const uint8_t *) ptr >= arena->base && (const uint8_t *) ptr < arena->base + arena->size;
+}
+
+/**
+ * Release all allocations made from @a arena. All previously returned pointers are invalidated.
+ *
+ * @param arena The arena to reset.
+ */
+void plcrash_async_arena_reset (plcrash_async_arena_t *arena) {
+    arena->used = 0;
+}
+
+/**
+ * Free all resources associated with @a arena.
+ *
+ * @param arena The arena to free.
+ *
+ * @warning This method is not async safe.
+ */
+void plcrash_nasync_arena_free (plcrash_async_arena_t *arena) {
+    vm_deallocate(mach_task_self(), (vm_address_t) arena->base, arena->size);
+}
+
+/**
+ * Fault in every page of the readable range [@a address, @a address + @a size), restoring any pages that have been
+ * compressed or paged out, such that a later access at crash time does not incur a page fault. Pages are read, but
+ * never written; the range may be concurrently in use.
+ *
+ * @param address The start of the range.
+ * @param size The size of the range, in bytes.
+ * @param lock If true, the range is additionally wired via mlock(), preventing it from being paged out. Failure to
+ * wire the range (eg, due to resource limits) is not an error.
+ *
+ * @warning This method is not async safe.
+ */
+void plcrash_nasync_prefault (const void *address, size_t size, bool lock) {
+    if (address == NULL || size == 0)
+        return;
+
+    uintptr_t start = trunc_page((uintptr_t) address);
+    uintptr_t end = (uintptr_t) address + size;
+    for (uintptr_t page = start; page < end; page += vm_page_size)
+        (void) *(volatile const uint8_t *) page;
+
+    if (lock && mlock(address, size) != 0)
+        PLCF_DEBUG("mlock() failure: %s", strerror(errno));
+}
+
+/** The registered scratch arena, or NULL. */
+static plcrash_async_arena_t *scratch_arena = NULL;
+
+/** If true, scratch allocations are served from @a scratch_arena. */
+static volatile bool scratch_arena_active = false;
+
+/**
+ * Register @a arena as the scratch arena. The arena must remain valid for the lifetime of the process.
+ *
+ * @param arena The arena to register.
+ *
+ * @warning This method is not async safe, and must be called prior to any use of plcrash_async_scratch_begin().
+ */
+void plcrash_nasync_scratch_set_arena (plcrash_async_arena_t *arena) {
+    scratch_arena = arena;
+}
+
+/**
+ * Reset the registered scratch arena, and begin serving scratch allocations from it. This should be called
+ * at the start of writing a crash report.
+ */
+void plcrash_async_scratch_begin (void) {
+    if (scratch_arena == NULL)
+        return;
+
+    plcrash_async_arena_reset(scratch_arena);
+    scratch_arena_active = true;
+}
+
+/**
+ * Stop serving scratch allocations from the registered scratch arena. Existing allocations remain valid
+ * until the next call to plcrash_async_scratch_begin().
+ */
+void plcrash_async_scratch_end (void) {
+    scratch_arena_active = false;
+}
+
+/**
+ * Allocate @a size bytes of zero-filled scratch memory. The memory must be released via
+ * plcrash_async_scratch_deallocate().
+ *
+ * Allocations served from the scratch arena are only guaranteed to be aligned to PLCR_ARENA_ALIGNMENT (16) bytes;
+ * allocations that fall back on vm_allocate() are page-aligned. Callers must not rely on page alignment.
+ *
+ * @param[out] addr On success, the address of the allocated memory.
+ * @param size The number of bytes to allocate.
+ *
+ * @return Returns KERN_SUCCESS on success, or the vm_allocate() error on failure.
+ */
+kern_return_t plcrash_async_scratch_allocate (vm_address_t *addr, vm_size_t size) {
+    if (scratch_arena_active) {
+        void *ptr = plcrash_async_arena_alloc(scratch_arena, size);
+        if (ptr != NULL) {
+            *addr = (vm_address_t) ptr;
+            return KERN_SUCCESS;
+        }
+    }
+
+    return vm_allocate(mach_task_self(), addr, size, VM_FLAGS_ANYWHERE);
+}
+
+/**
+ * Release scratch memory allocated via plcrash_async_scratch_allocate(). Arena allocations are released
+ * when the arena is reset.
+ *
+ * @param addr The address of the allocation.
+ * @param size The size of the allocation.
+ *
+ * @return Returns KERN_SUCCESS on success, or the vm_deallocate() error on failure.
+ */
+kern_return_t plcrash_async_scratch_deallocate (vm_address_t addr, vm_size_t size) {
+    if (scratch_arena != NULL && plcrash_async_arena_contains(scratch_arena, (const void *) addr))
+        return KERN_SUCCESS;
+
+    return vm_deallocate(mach_task_self(), addr, size);
+}
+
+/**
+ * @} plcrash_async_arena
+ */
+
 /**
  * @internal
  * @ingroup plcrash_async
@@ -429,6 +902,75 @@ ssize_t plcrash_async_writen (int fd, const void *data, size_t len) {
     return written;
 }
 
+/**
+ * Write all bytes described by @a iov to @a fd, looping until all bytes are written or an error occurs. For the
+ * local file system, only one call to writev() should be necessary.
+ *
+ * @param fd The destination file descriptor.
+ * @param iov The I/O vectors to be written. The contents of this array will be modified to track partial writes.
+ * @param iovcnt The number of elements in @a iov.
+ *
+ * @return Returns the total number of bytes written, or -1 on error.
+ */
+ssize_t plcrash_async_writevn (int fd, struct iovec *iov, int iovcnt) {
+    ssize_t total = 0;
+
+    /* Skip any leading empty vectors */
+    while (iovcnt > 0 && iov->iov_len == 0) {
+        iov++;
+        iovcnt--;
+    }
+
+    /* Loop until all bytes are written */
+    while (iovcnt > 0) {
+        ssize_t written;
+        if ((written = writev(fd, iov, iovcnt)) <= 0) {
+            if (errno == EINTR) {
+                // Try again
+                continue;
+            } else {
+                return -1;
+            }
+        }
+
+        total += written;
+
+        /* Advance past all fully written vectors, and adjust any partially written vector */
+        while (iovcnt > 0 && (size_t) written >= iov->iov_len) {
+            written -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+
+        if (iovcnt > 0) {
+            iov->iov_base = (uint8_t *) iov->iov_base + written;
+            iov->iov_len -= written;
+        }
+    }
+
+    return total;
+}
+
+/**
+ * Return the file's active output buffer.
+ */
+static inline char *plcrash_async_file_buffer (plcrash_async_file_t *file) {
+    if (file->ext_buffer != NULL)
+        return file->ext_buffer;
+
+    return file->buffer;
+}
+
+/**
+ * Return the size of the file's active output buffer.
+ */
+static inline size_t plcrash_async_file_buffer_size (plcrash_async_file_t *file) {
+    if (file->ext_buffer != NULL)
+        return file->ext_buffer_size;
+    
+    return sizeof(file->buffer);
+}
+
 
 /**
  * Initialize the plcrash_async_file_t instance.
@@ -441,17 +983,279 @@ ssize_t plcrash_async_writen (int fd, const void *data, size_t len) {
  */
 void plcrash_async_file_init (plcrash_async_file_t *file, int fd, off_t output_limit) {
     file->fd = fd;
+    file->mem_buffer = NULL;
+    file->mem_capacity = 0;
+    file->mem_mapped = false;
+    file->mem_growable = false;
     file->buflen = 0;
+    file->ext_buffer = NULL;
+    file->ext_buffer_size = 0;
     file->total_bytes = 0;
+    file->presized_end = 0;
+    file->compressor = NULL;
     file->limit_bytes = output_limit;
 }
 
+/**
+ * Replace the default output buffer of a descriptor-backed plcrash_async_file_t instance with
+ * caller-supplied storage. This must be called prior to writing any data to @a file.
+ *
+ * @param file A file structure initialized via plcrash_async_file_init().
+ * @param buffer The buffer to use for output buffering. This buffer must remain valid until the file is closed.
+ * @param size The size of @a buffer, in bytes. If smaller than the default buffer, the default buffer will be used.
+ */
+void plcrash_async_file_set_buffer (plcrash_async_file_t *file, void *buffer, size_t size) {
+    PLCF_ASSERT(file->buflen == 0);
+
+    if (buffer == NULL || size <= sizeof(file->buffer)) {
+        file->ext_buffer = NULL;
+        file->ext_buffer_size = 0;
+        return;
+    }
+
+    file->ext_buffer = buffer;
+    file->ext_buffer_size = size;
+}
 
 /**
- * Write all bytes from @a data to the file buffer. Returns true on success,
- * or false if an error occurs.
+ * Initialize the plcrash_async_file_t instance to write directly to a fixed-size memory region.
+ *
+ * @param file File structure to initialize.
+ * @param buffer The destination buffer.
+ * @param size The size of @a buffer, in bytes. Once the buffer is full, all further data will be dropped.
  */
-bool plcrash_async_file_write (plcrash_async_file_t *file, const void *data, size_t len) {
+void plcrash_async_file_init_buffer (plcrash_async_file_t *file, void *buffer, size_t size) {
+    PLCF_ASSERT(size > 0);
+
+    file->fd = -1;
+    file->mem_buffer = buffer;
+    file->mem_capacity = size;
+    file->mem_mapped = false;
+    file->mem_growable = false;
+    file->buflen = 0;
+    file->ext_buffer = NULL;
+    file->ext_buffer_size = 0;
+    file->total_bytes = 0;
+    file->presized_end = 0;
+    file->compressor = NULL;
+    file->limit_bytes = size;
+}
+
+/**
+ * Reserve storage for the first @a size bytes of @a fd, ensuring that later writes within that range do not need to
+ * allocate filesystem blocks. This avoids block allocation (and journal work) at crash time, and ensures that writes
+ * to a memory-mapped file can not fail with SIGBUS should the volume fill after the file was prepared.
+ *
+ * @param fd Open file descriptor, opened for writing.
+ * @param size The number of bytes to reserve.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTSUP if the platform or filesystem does not support
+ * preallocation, or PLCRASH_OUTPUT_ERR if the storage could not be reserved.
+ *
+ * @warning This function is not async-safe, and must be called prior to entering the crash handler.
+ */
+plcrash_error_t plcrash_async_file_nasync_preallocate (int fd, off_t size) {
+#ifdef F_PREALLOCATE
+    /* Prefer a contiguous allocation, falling back on any allocation */
+    fstore_t store = {
+        .fst_flags = F_ALLOCATECONTIG | F_ALLOCATEALL,
+        .fst_posmode = F_PEOFPOSMODE,
+        .fst_offset = 0,
+        .fst_length = size
+    };
+
+    if (fcntl(fd, F_PREALLOCATE, &store) == 0)
+        return PLCRASH_ESUCCESS;
+
+    store.fst_flags = F_ALLOCATEALL;
+    if (fcntl(fd, F_PREALLOCATE, &store) == 0)
+        return PLCRASH_ESUCCESS;
+
+    /* Not all filesystems support preallocation */
+    if (errno == ENOTSUP || errno == EINVAL)
+        return PLCRASH_ENOTSUP;
+
+    PLCF_DEBUG("Could not reserve storage for the output file: %s", strerror(errno));
+    return PLCRASH_OUTPUT_ERR;
+#else
+    return PLCRASH_ENOTSUP;
+#endif
+}
+
+/**
+ * @internal
+ *
+ * Allocate the first @a size bytes of @a fd by explicitly writing zeros, for use where the filesystem does not
+ * support preallocation. The file must already be at least @a size bytes in length.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_OUTPUT_ERR if the zeros could not be written.
+ */
+static plcrash_error_t plcrash_async_file_nasync_zero_fill (int fd, off_t size) {
+    static const char zeros[4096] = { 0 };
+
+    for (off_t offset = 0; offset < size;) {
+        size_t len = sizeof(zeros);
+        if ((off_t) len > size - offset)
+            len = (size_t) (size - offset);
+
+        ssize_t written = pwrite(fd, zeros, len, offset);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+
+            PLCF_DEBUG("Could not allocate storage for the output file: %s", strerror(errno));
+            return PLCRASH_OUTPUT_ERR;
+        }
+        offset += written;
+    }
+
+    if (fsync(fd) != 0) {
+        PLCF_DEBUG("Could not synchronize the output file: %s", strerror(errno));
+        return PLCRASH_OUTPUT_ERR;
+    }
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Initialize the plcrash_async_file_t instance to write to a preallocated, memory-mapped file. The file's storage
+ * will be reserved via plcrash_async_file_nasync_preallocate() (or, where preallocation is unsupported, by writing
+ * zeros), and the file extended to @a size bytes and mapped; all writes are performed by copying directly into the
+ * mapping. Upon
+ * plcrash_async_file_close(), the mapping will be synchronized to disk, the file truncated to the number of bytes
+ * actually written, and @a fd closed.
+ *
+ * @param file File structure to initialize.
+ * @param fd Open file descriptor, opened for both reading and writing. Any existing file contents will be replaced.
+ * @param size The maximum number of bytes that may be written. Once the limit is reached, all data will be dropped.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or an appropriate error value if the file could not be
+ * preallocated or mapped. On failure, the caller retains ownership of @a fd.
+ *
+ * @warning This function is not async-safe, and must be called prior to entering the crash handler.
+ */
+plcrash_error_t plcrash_async_file_nasync_init_mmap (plcrash_async_file_t *file, int fd, size_t size) {
+    PLCF_ASSERT(size > 0);
+
+    /* Reserve the file's storage; a sparse mapping could fault at crash time if the volume has since filled */
+    plcrash_error_t err = plcrash_async_file_nasync_preallocate(fd, size);
+    if (err != PLCRASH_ESUCCESS && err != PLCRASH_ENOTSUP)
+        return PLCRASH_OUTPUT_ERR;
+
+    /* Preallocate the file */
+    if (ftruncate(fd, size) != 0) {
+        PLCF_DEBUG("Could not preallocate the output file: %s", strerror(errno));
+        return PLCRASH_OUTPUT_ERR;
+    }
+
+    /* If the reservation was unsupported or did not back the extended file, write out its contents */
+    struct stat st;
+    if (err == PLCRASH_ENOTSUP || fstat(fd, &st) != 0 || (off_t) st.st_blocks * 512 < (off_t) size) {
+        if (plcrash_async_file_nasync_zero_fill(fd, size) != PLCRASH_ESUCCESS)
+            return PLCRASH_OUTPUT_ERR;
+    }
+
+    /* Map the file */
+    void *addr = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        PLCF_DEBUG("Could not map the output file: %s", strerror(errno));
+        return PLCRASH_OUTPUT_ERR;
+    }
+
+    file->fd = fd;
+    file->mem_buffer = addr;
+    file->mem_capacity = size;
+    file->mem_mapped = true;
+    file->mem_growable = false;
+    file->buflen = 0;
+    file->ext_buffer = NULL;
+    file->ext_buffer_size = 0;
+    file->total_bytes = 0;
+    file->presized_end = 0;
+    file->compressor = NULL;
+    file->limit_bytes = size;
+
+    return PLCRASH_ESUCCESS;
+}
+
+
+/**
+ * Initialize the plcrash_async_file_t instance to write to a growable, vm_allocate()-backed memory region. The
+ * region is grown (using only async-safe Mach VM calls) as required.
+ *
+ * Upon plcrash_async_file_close(), the written data remains available via @a file's mem_buffer and
+ * total_bytes fields; the caller is responsible for releasing the region via
+ * vm_deallocate(mach_task_self(), mem_buffer, mem_capacity).
+ *
+ * @param file File structure to initialize.
+ * @param output_limit Maximum number of bytes that will be written. Must be non-zero. Once the limit is reached,
+ * all data will be dropped.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_ENOMEM if the initial region could not be allocated.
+ */
+plcrash_error_t plcrash_async_file_init_vm (plcrash_async_file_t *file, size_t output_limit) {
+    PLCF_ASSERT(output_limit > 0);
+
+    vm_address_t addr;
+    size_t capacity = vm_page_size;
+    kern_return_t kt = vm_allocate(mach_task_self(), &addr, capacity, VM_FLAGS_ANYWHERE);
+    if (kt != KERN_SUCCESS) {
+        PLCF_DEBUG("vm_allocate() failure: %d", kt);
+        return PLCRASH_ENOMEM;
+    }
+
+    file->fd = -1;
+    file->mem_buffer = (void *) addr;
+    file->mem_capacity = capacity;
+    file->mem_mapped = false;
+    file->mem_growable = true;
+    file->buflen = 0;
+    file->ext_buffer = NULL;
+    file->ext_buffer_size = 0;
+    file->total_bytes = 0;
+    file->presized_end = 0;
+    file->compressor = NULL;
+    file->limit_bytes = output_limit;
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Grow the vm_allocate()-backed memory region of @a file to hold at least @a required bytes.
+ *
+ * @return Returns true on success, or false if the region could not be grown.
+ */
+static bool plcrash_async_file_grow (plcrash_async_file_t *file, size_t required) {
+    size_t capacity = file->mem_capacity;
+    while (capacity < required)
+        capacity *= 2;
+
+    vm_address_t addr;
+    kern_return_t kt = vm_allocate(mach_task_self(), &addr, capacity, VM_FLAGS_ANYWHERE);
+    if (kt != KERN_SUCCESS) {
+        PLCF_DEBUG("vm_allocate() failure: %d", kt);
+        return false;
+    }
+
+    /* Copy the existing contents; vm_copy() operates on whole pages, which our capacities always are. */
+    kt = vm_copy(mach_task_self(), (vm_address_t) file->mem_buffer, file->mem_capacity, addr);
+    if (kt != KERN_SUCCESS) {
+        PLCF_DEBUG("vm_copy() failure: %d", kt);
+        vm_deallocate(mach_task_self(), addr, capacity);
+        return false;
+    }
+
+    vm_deallocate(mach_task_self(), (vm_address_t) file->mem_buffer, file->mem_capacity);
+    file->mem_buffer = (void *) addr;
+    file->mem_capacity = capacity;
+
+    return true;
+}
+
+/**
+ * Write @a len bytes to @a file, bypassing any configured compressor.
+ */
+static bool plcrash_async_file_write_raw (plcrash_async_file_t *file, const void *data, size_t len) {
     /* Check and update output limit */
     if (file->limit_bytes != 0 && len + file->total_bytes > file->limit_bytes) {
         return false;
@@ -459,46 +1263,128 @@ bool plcrash_async_file_write (plcrash_async_file_t *file, const void *data, siz
         file->total_bytes += len;
     }
 
-    /* Check if the buffer will fill */
-    if (file->buflen + len > sizeof(file->buffer)) {
-        /* Flush the buffer */
-        if (plcrash_async_writen(file->fd, file->buffer, file->buflen) < 0) {
-            PLCF_DEBUG("Error occured writing to crash log: %s", strerror(errno));
-            return false;
+    /* Memory-backed output is written directly to the target buffer */
+    if (file->mem_buffer != NULL) {
+        if (file->total_bytes > file->mem_capacity) {
+            PLCF_ASSERT(file->mem_growable);
+            if (!plcrash_async_file_grow(file, file->total_bytes)) {
+                file->total_bytes -= len;
+                return false;
+            }
         }
-        
-        file->buflen = 0;
+
+        plcrash_async_memcpy((uint8_t *) file->mem_buffer + (file->total_bytes - len), data, len);
+        return true;
     }
-    
+
+    char *buffer = plcrash_async_file_buffer(file);
+    size_t bufsize = plcrash_async_file_buffer_size(file);
+
     /* Check if the new data fits within the buffer, if so, buffer it */
-    if (len + file->buflen <= sizeof(file->buffer)) {
-        plcrash_async_memcpy(file->buffer + file->buflen, data, len);
+    if (len + file->buflen <= bufsize) {
+        plcrash_async_memcpy(buffer + file->buflen, data, len);
         file->buflen += len;
         
         return true;
-        
-    } else {
-        /* Won't fit in the buffer, just write it */
-        if (plcrash_async_writen(file->fd, data, len) < 0) {
-            PLCF_DEBUG("Error occured writing to crash log: %s", strerror(errno));
-            return false;
-        }
-        
-        return true;
-    } 
+    }
+
+    /* Otherwise, write the buffered bytes and the new data with a single writev() */
+    struct iovec iov[2];
+    iov[0].iov_base = buffer;
+    iov[0].iov_len = file->buflen;
+    iov[1].iov_base = (void *) data;
+    iov[1].iov_len = len;
+
+    if (plcrash_async_writevn(file->fd, iov, 2) < 0) {
+        PLCF_DEBUG("Error occured writing to crash log: %s", strerror(errno));
+        return false;
+    }
+
+    file->buflen = 0;
+    return true;
 }
 
+/**
+ * plcrash_async_lz_output_fn() adapter for plcrash_async_file_write_raw().
+ */
+static bool plcrash_async_file_lz_output (void *ctx, const void *data, size_t len) {
+    return plcrash_async_file_write_raw(ctx, data, len);
+}
+
+/**
+ * Compress all further output written to @a file using @a compressor. Data previously written is unaffected.
+ * Once enabled, compression remains enabled until the file is closed; pending compressed data is emitted by
+ * plcrash_async_file_flush().
+ *
+ * Compressed output can not be patched; plcrash_async_file_is_patchable() will return false.
+ *
+ * @param file The file for which compression will be enabled.
+ * @param compressor The compressor state to be used. This will be (re)initialized, and must remain valid until the
+ * file is closed.
+ */
+void plcrash_async_file_set_compressor (plcrash_async_file_t *file, plcrash_async_lz_t *compressor) {
+    plcrash_async_lz_init(compressor, plcrash_async_file_lz_output, file);
+    file->compressor = compressor;
+}
+
+/**
+ * Write all bytes from @a data to the file buffer. Returns true on success,
+ * or false if an error occurs.
+ */
+bool plcrash_async_file_write (plcrash_async_file_t *file, const void *data, size_t len) {
+    if (file->compressor != NULL)
+        return plcrash_async_lz_write(file->compressor, data, len);
+
+    return plcrash_async_file_write_raw(file, data, len);
+}
+
+
+/**
+ * Return true if previously written data in @a file may be overwritten via plcrash_async_file_patch().
+ * Only memory-backed outputs (including memory-mapped files) support patching.
+ *
+ * @param file The file to query.
+ */
+bool plcrash_async_file_is_patchable (plcrash_async_file_t *file) {
+    return file->mem_buffer != NULL && file->compressor == NULL;
+}
+
+/**
+ * Overwrite @a len bytes of previously written data at @a offset.
+ *
+ * @param file A file for which plcrash_async_file_is_patchable() returns true.
+ * @param offset The output offset at which @a data will be written.
+ * @param data The replacement data.
+ * @param len The length of @a data. The range must fall within the data already written.
+ *
+ * @return Returns true on success, or false if @a file does not support patching, or the range
+ * falls outside of the data already written.
+ */
+bool plcrash_async_file_patch (plcrash_async_file_t *file, off_t offset, const void *data, size_t len) {
+    if (!plcrash_async_file_is_patchable(file))
+        return false;
+
+    if (offset < 0 || offset + (off_t) len > file->total_bytes)
+        return false;
+
+    plcrash_async_memcpy((uint8_t *) file->mem_buffer + offset, data, len);
+    return true;
+}
 
 /**
  * Flush all buffered bytes from the file buffer.
  */
 bool plcrash_async_file_flush (plcrash_async_file_t *file) {
+    /* Emit any pending compressed data */
+    if (file->compressor != NULL && !plcrash_async_lz_flush(file->compressor))
+        return false;
+
     /* Anything to do? */
     if (file->buflen == 0)
         return true;
     
     /* Write remaining */
-    if (plcrash_async_writen(file->fd, file->buffer, file->buflen) < 0) {
+    if (plcrash_async_writen(file->fd, plcrash_async_file_buffer(file), file->buflen) < 0) {
         PLCF_DEBUG("Error occured writing to crash log: %s", strerror(errno));
         return false;
     }
@@ -517,6 +1403,38 @@ bool plcrash_async_file_close (plcrash_async_file_t *file) {
     if (!plcrash_async_file_flush(file))
         return false;
 
+    /* Synchronize, truncate, and unmap memory-mapped output */
+    if (file->mem_mapped) {
+        bool result = true;
+
+        if (msync(file->mem_buffer, file->mem_capacity, MS_SYNC) != 0) {
+            PLCF_DEBUG("Error synchronizing mapped file: %s", strerror(errno));
+            result = false;
+        }
+
+        if (munmap(file->mem_buffer, file->mem_capacity) != 0) {
+            PLCF_DEBUG("Error unmapping file: %s", strerror(errno));
+            result = false;
+        }
+        file->mem_buffer = NULL;
+
+        if (ftruncate(file->fd, file->total_bytes) != 0) {
+            PLCF_DEBUG("Error truncating mapped file: %s", strerror(errno));
+            result = false;
+        }
+
+        if (close(file->fd) != 0) {
+            PLCF_DEBUG("Error closing file: %s", strerror(errno));
+            result = false;
+        }
+
+        return result;
+    }
+
+    /* Nothing else to do for memory-backed output */
+    if (file->mem_buffer != NULL)
+        return true;
+
     /* Close the file descriptor */
     if (close(file->fd) != 0) {
         PLCF_DEBUG("Error closing file: %s", strerror(errno));
@@ -37,11 +37,14 @@ extern "C" {
 #include <unistd.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <sys/uio.h>
 #include <assert.h>
 
 #include <TargetConditionals.h>
 #include <mach/mach.h>
 
+#include "PLCrashFeatureConfig.h"
+
 #if TARGET_OS_IPHONE
 
 /*
@@ -216,28 +219,122 @@ typedef struct plcrash_async_byteorder {
     
     /** The byte-swap function to use for 64-bit values. */
     uint64_t (*swap64)(uint64_t);
+
+    /** If true, the target byte order is the host byte order, and the swap functions are the identity. This allows
+     * readers to bypass the indirect swap function calls for native images. */
+    bool native;
     
 #ifdef __cplusplus
 public:
+#if PLCRASH_FEATURE_HOST_ONLY_CRASH_PATH
     /** Byte swap a 16-bit value */
-    uint16_t swap (uint16_t v) const { return swap16(v); }
+    uint16_t swap (uint16_t v) const { return native ? v : __builtin_bswap16(v); }
     
     /** Byte swap a 32-bit value */
-    uint32_t swap (uint32_t v) const { return swap32(v); }
+    uint32_t swap (uint32_t v) const { return native ? v : __builtin_bswap32(v); }
     
     /** Byte swap a 64-bit value */
-    uint64_t swap (uint64_t v) const { return swap64(v); }
+    uint64_t swap (uint64_t v) const { return native ? v : __builtin_bswap64(v); }
+#else
+    /** Byte swap a 16-bit value */
+    uint16_t swap (uint16_t v) const { return native ? v : swap16(v); }
+    
+    /** Byte swap a 32-bit value */
+    uint32_t swap (uint32_t v) const { return native ? v : swap32(v); }
+    
+    /** Byte swap a 64-bit value */
+    uint64_t swap (uint64_t v) const { return native ? v : swap64(v); }
+#endif
 #endif
 } plcrash_async_byteorder_t;
 
 extern const plcrash_async_byteorder_t plcrash_async_byteorder_swapped;
 extern const plcrash_async_byteorder_t plcrash_async_byteorder_direct;
 
+/**
+ * @internal
+ * @ingroup plcrash_async
+ *
+ * Swap a 16-bit value from the target byte order described by @a byteorder to the host byte order. Native
+ * byte orders are handled inline, without an indirect call; if #PLCRASH_FEATURE_HOST_ONLY_CRASH_PATH is enabled,
+ * swapped byte orders are also handled inline.
+ *
+ * @param byteorder The target byte order.
+ * @param v The value to be swapped.
+ */
+static inline uint16_t plcrash_async_swap16 (const plcrash_async_byteorder_t *byteorder, uint16_t v) {
+#if PLCRASH_FEATURE_HOST_ONLY_CRASH_PATH
+    return byteorder->native ? v : __builtin_bswap16(v);
+#else
+    return byteorder->native ? v : byteorder->swap16(v);
+#endif
+}
+
+/**
+ * @internal
+ * @ingroup plcrash_async
+ *
+ * Swap a 32-bit value from the target byte order described by @a byteorder to the host byte order. Native
+ * byte orders are handled inline, without an indirect call; if #PLCRASH_FEATURE_HOST_ONLY_CRASH_PATH is enabled,
+ * swapped byte orders are also handled inline.
+ *
+ * @param byteorder The target byte order.
+ * @param v The value to be swapped.
+ */
+static inline uint32_t plcrash_async_swap32 (const plcrash_async_byteorder_t *byteorder, uint32_t v) {
+#if PLCRASH_FEATURE_HOST_ONLY_CRASH_PATH
+    return byteorder->native ? v : __builtin_bswap32(v);
+#else
+    return byteorder->native ? v : byteorder->swap32(v);
+#endif
+}
+
+/**
+ * @internal
+ * @ingroup plcrash_async
+ *
+ * Swap a 64-bit value from the target byte order described by @a byteorder to the host byte order. Native
+ * byte orders are handled inline, without an indirect call; if #PLCRASH_FEATURE_HOST_ONLY_CRASH_PATH is enabled,
+ * swapped byte orders are also handled inline.
+ *
+ * @param byteorder The target byte order.
+ * @param v The value to be swapped.
+ */
+static inline uint64_t plcrash_async_swap64 (const plcrash_async_byteorder_t *byteorder, uint64_t v) {
+#if PLCRASH_FEATURE_HOST_ONLY_CRASH_PATH
+    return byteorder->native ? v : __builtin_bswap64(v);
+#else
+    return byteorder->native ? v : byteorder->swap64(v);
+#endif
+}
+
 extern const plcrash_async_byteorder_t *plcrash_async_byteorder_little_endian (void);
 extern const plcrash_async_byteorder_t *plcrash_async_byteorder_big_endian (void);
 
 
+/**
+ * @internal
+ *
+ * A single read request, as performed by plcrash_async_task_memcpy_batch().
+ */
+typedef struct plcrash_async_task_read {
+    /** The target-relative address to be read. */
+    pl_vm_address_t address;
+
+    /** The number of bytes to be read. */
+    pl_vm_size_t len;
+
+    /** The destination to which the data will be written. */
+    void *dest;
+} plcrash_async_task_read_t;
+
+/**
+ * The maximum span, in bytes, of requests that plcrash_async_task_memcpy_batch() will coalesce into a single read.
+ */
+#define PLCRASH_ASYNC_TASK_READ_COALESCE_MAX 256
+
 plcrash_error_t plcrash_async_task_memcpy (mach_port_t task, pl_vm_address_t address, pl_vm_off_t offset, void *dest, pl_vm_size_t len);
+plcrash_error_t plcrash_async_task_memcpy_batch (mach_port_t task, const plcrash_async_task_read_t *reads, size_t count);
 
 plcrash_error_t plcrash_async_task_read_uint8 (task_t task, pl_vm_address_t address, pl_vm_off_t offset, uint8_t *result);
 
@@ -252,10 +349,45 @@ plcrash_error_t plcrash_async_task_read_uint64 (task_t task, const plcrash_async
 
 int plcrash_async_strcmp(const char *s1, const char *s2);
 int plcrash_async_strncmp(const char *s1, const char *s2, size_t n);
+size_t plcrash_async_strnlen(const char *s, size_t maxlen);
+size_t plcrash_async_utf8_strlen(const char *s);
 void *plcrash_async_memcpy(void *dest, const void *source, size_t n);
 void *plcrash_async_memset(void *dest, uint8_t value, size_t n);
 
+/**
+ * @internal
+ * @ingroup plcrash_async_arena
+ *
+ * A preallocated bump allocator, from which crash-time scratch memory may be allocated without
+ * issuing VM calls or incurring page faults.
+ */
+typedef struct plcrash_async_arena {
+    /** The base address of the arena's pages. */
+    uint8_t *base;
+
+    /** The total size of the arena, in bytes. */
+    size_t size;
+
+    /** The number of bytes allocated. Updated atomically. */
+    volatile size_t used;
+} plcrash_async_arena_t;
+
+plcrash_error_t plcrash_nasync_arena_init (plcrash_async_arena_t *arena, size_t size);
+void *plcrash_async_arena_alloc (plcrash_async_arena_t *arena, size_t size);
+bool plcrash_async_arena_contains (plcrash_async_arena_t *arena, const void *ptr);
+void plcrash_async_arena_reset (plcrash_async_arena_t *arena);
+void plcrash_nasync_arena_free (plcrash_async_arena_t *arena);
+
+void plcrash_nasync_prefault (const void *address, size_t size, bool lock);
+
+void plcrash_nasync_scratch_set_arena (plcrash_async_arena_t *arena);
+void plcrash_async_scratch_begin (void);
+void plcrash_async_scratch_end (void);
+kern_return_t plcrash_async_scratch_allocate (vm_address_t *addr, vm_size_t size);
+kern_return_t plcrash_async_scratch_deallocate (vm_address_t addr, vm_size_t size);
+
 ssize_t plcrash_async_writen (int fd, const void *data, size_t len);
+ssize_t plcrash_async_writevn (int fd, struct iovec *iov, int iovcnt);
 
 /**
  * @internal
@@ -265,25 +397,60 @@ ssize_t plcrash_async_writen (int fd, const void *data, size_t len);
  * within signal handler execution of crash log output.
  */
 typedef struct plcrash_async_file {
-    /** Output file descriptor */
+    /** Output file descriptor, or -1 if writing to @a mem_buffer. */
     int fd;
 
+    /** If non-NULL, all output is written directly to this memory region, bounded by @a limit_bytes. */
+    void *mem_buffer;
+
+    /** The allocated size of @a mem_buffer, in bytes. */
+    size_t mem_capacity;
+
+    /** If true, @a mem_buffer is a shared mapping of @a fd, which will be synchronized, truncated to the written
+     * length, and unmapped upon close. */
+    bool mem_mapped;
+
+    /** If true, @a mem_buffer is a vm_allocate()'d region that will be grown as required, up to @a limit_bytes. */
+    bool mem_growable;
+
     /** Output limit */
     off_t limit_bytes;
 
     /** Total bytes written */
     off_t total_bytes;
 
+    /** The output offset at which the outermost pre-sized message currently being written ends, or 0. Length
+     * prefixes may not be reserved (see plcrash_writer_pack_reserve()) before this offset, as the enclosing message
+     * was sized using minimal-width length prefixes. */
+    off_t presized_end;
+
     /** Current length of data in buffer */
     size_t buflen;
 
-    /** Buffered output */
+    /** Caller-supplied output buffer, or NULL if @a buffer should be used. */
+    char *ext_buffer;
+
+    /** Size of @a ext_buffer, in bytes. */
+    size_t ext_buffer_size;
+
+    /** If non-NULL, all output is compressed via this compressor prior to being written. */
+    struct plcrash_async_lz *compressor;
+
+    /** Default buffered output */
     char buffer[256];
 } plcrash_async_file_t;
 
 
 void plcrash_async_file_init (plcrash_async_file_t *file, int fd, off_t output_limit);
+void plcrash_async_file_init_buffer (plcrash_async_file_t *file, void *buffer, size_t size);
+plcrash_error_t plcrash_async_file_nasync_preallocate (int fd, off_t size);
+plcrash_error_t plcrash_async_file_nasync_init_mmap (plcrash_async_file_t *file, int fd, size_t size);
+plcrash_error_t plcrash_async_file_init_vm (plcrash_async_file_t *file, size_t output_limit);
+void plcrash_async_file_set_buffer (plcrash_async_file_t *file, void *buffer, size_t size);
+void plcrash_async_file_set_compressor (plcrash_async_file_t *file, struct plcrash_async_lz *compressor);
 bool plcrash_async_file_write (plcrash_async_file_t *file, const void *data, size_t len);
+bool plcrash_async_file_is_patchable (plcrash_async_file_t *file);
+bool plcrash_async_file_patch (plcrash_async_file_t *file, off_t offset, const void *data, size_t len);
 bool plcrash_async_file_flush (plcrash_async_file_t *file);
 bool plcrash_async_file_close (plcrash_async_file_t *file);
     
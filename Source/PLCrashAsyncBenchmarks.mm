@@ -0,0 +1,453 @@
+/*
+ * Author: Landon Fuller <landonf@plausible.coop>
+ *
+ * Copyright (c) 2012-2013 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashBenchmarkCase.h"
+
+#import "PLCrashAsync.h"
+#import "PLCrashAsyncMObject.h"
+#import "PLCrashAsyncMachOImage.h"
+#import "PLCrashAsyncObjCSection.h"
+#import "PLCrashAsyncCompactUnwindEncoding.h"
+#import "PLCrashLogWriterEncoding.h"
+#import "PLCrashFeatureConfig.h"
+
+#if PLCRASH_FEATURE_UNWIND_DWARF
+#import "PLCrashAsyncDwarfCFAState.hpp"
+#import "PLCrashAsyncDwarfEncoding.hpp"
+#import "PLCrashAsyncDwarfExpression.hpp"
+#endif
+
+#import <dlfcn.h>
+#import <mach-o/dyld.h>
+
+#if PLCRASH_FEATURE_UNWIND_DWARF
+using namespace plcrash::async;
+#endif
+
+/** Size of the output buffer used by the plcrash_writer_pack() benchmarks. */
+#define PACK_BUFFER_SIZE (8 * 1024 * 1024)
+
+/**
+ * Microbenchmarks of the async primitives used when writing a report; see PLCrashBenchmarkCase.
+ */
+@interface PLCrashAsyncBenchmarks : PLCrashBenchmarkCase {
+@private
+    /** The image containing this class. */
+    plcrash_async_macho_t _image;
+
+    /** Output buffer for the plcrash_writer_pack() benchmarks. */
+    void *_packBuffer;
+}
+@end
+
+/* A symbol within the test image, used as the target of look-ups. */
+__attribute__((noinline)) static int benchmark_target_function (int value) {
+    return value + 1;
+}
+
+/* Symbol look-up callback. */
+static void found_symbol_cb (pl_vm_address_t address, const char *name, void *ctx) {
+    *((pl_vm_address_t *) ctx) = address;
+}
+
+/* ObjC method look-up callback. */
+static void found_method_cb (bool isClassMethod, plcrash_async_macho_string_t *className, plcrash_async_macho_string_t *methodName, pl_vm_address_t imp, void *ctx) {
+    *((pl_vm_address_t *) ctx) = imp;
+}
+
+@implementation PLCrashAsyncBenchmarks
+
+- (void) setUp {
+    Dl_info info;
+    STAssertTrue(dladdr((void *) benchmark_target_function, &info) > 0, @"Could not fetch dyld info for the test image");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_macho_init(&_image, mach_task_self(), info.dli_fname, (pl_vm_address_t) info.dli_fbase), @"Failed to initialize Mach-O parser");
+
+    _packBuffer = malloc(PACK_BUFFER_SIZE);
+}
+
+- (void) tearDown {
+    plcrash_nasync_macho_free(&_image);
+    free(_packBuffer);
+}
+
+- (void) testMObjectInit {
+    size_t length = 64 * 1024;
+    void *buffer = malloc(length);
+    memset(buffer, 0xA, length);
+    __block NSUInteger failures = 0;
+
+    [self measureBenchmark: @"mobject_init" iterations: 1000 block: ^(NSUInteger iterations) {
+        for (NSUInteger i = 0; i < iterations; i++) {
+            plcrash_async_mobject_t mobj;
+            if (plcrash_async_mobject_init(&mobj, mach_task_self(), (pl_vm_address_t) buffer, length, true) != PLCRASH_ESUCCESS) {
+                failures++;
+                continue;
+            }
+            plcrash_async_mobject_free(&mobj);
+        }
+    }];
+    STAssertEquals((NSUInteger) 0, failures, @"Failed to initialize mobj");
+
+    free(buffer);
+}
+
+- (void) testMObjectRemapAddress {
+    size_t length = 64 * 1024;
+    uint8_t *buffer = (uint8_t *) malloc(length);
+    memset(buffer, 0xA, length);
+
+    plcrash_async_mobject_t mobj;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_init(&mobj, mach_task_self(), (pl_vm_address_t) buffer, length, true), @"Failed to initialize mobj");
+    plcrash_async_mobject_t *mobjPtr = &mobj;
+    __block NSUInteger failures = 0;
+
+    [self measureBenchmark: @"mobject_remap_address" iterations: 1000000 block: ^(NSUInteger iterations) {
+        for (NSUInteger i = 0; i < iterations; i++) {
+            pl_vm_off_t offset = (pl_vm_off_t) ((i * 64) % (length - sizeof(uint64_t)));
+            if (plcrash_async_mobject_remap_address(mobjPtr, (pl_vm_address_t) buffer, offset, sizeof(uint64_t)) == NULL)
+                failures++;
+        }
+    }];
+    STAssertEquals((NSUInteger) 0, failures, @"Failed to remap address");
+
+    plcrash_async_mobject_free(&mobj);
+    free(buffer);
+}
+
+- (void) testTaskMemcpy {
+    size_t length = 256;
+    uint8_t *src = (uint8_t *) malloc(length);
+    uint8_t *dest = (uint8_t *) malloc(length);
+    memset(src, 0xA, length);
+    __block NSUInteger failures = 0;
+
+    [self measureBenchmark: @"task_memcpy" iterations: 10000 block: ^(NSUInteger iterations) {
+        for (NSUInteger i = 0; i < iterations; i++) {
+            if (plcrash_async_task_memcpy(mach_task_self(), (pl_vm_address_t) src, 0, dest, length) != PLCRASH_ESUCCESS)
+                failures++;
+        }
+    }];
+    STAssertEquals((NSUInteger) 0, failures, @"Failed to read memory");
+
+    free(src);
+    free(dest);
+}
+
+- (void) testStringCompare {
+    const char *s1 = "_OBJC_CLASS_$_PLCrashReporterBenchmarkSymbolName";
+    const char *s2 = "_OBJC_CLASS_$_PLCrashReporterBenchmarkSymbolNamf";
+    __block NSUInteger failures = 0;
+
+    [self measureBenchmark: @"async_strcmp" iterations: 100000 block: ^(NSUInteger iterations) {
+        for (NSUInteger i = 0; i < iterations; i++) {
+            if (plcrash_async_strcmp(s1, s2) >= 0)
+                failures++;
+        }
+    }];
+    [self measureBenchmark: @"async_strncmp" iterations: 100000 block: ^(NSUInteger iterations) {
+        for (NSUInteger i = 0; i < iterations; i++) {
+            if (plcrash_async_strncmp(s1, s2, 64) >= 0)
+                failures++;
+        }
+    }];
+    STAssertEquals((NSUInteger) 0, failures, @"Incorrect comparison result");
+}
+
+- (void) testMemcpy {
+    size_t length = 4096;
+    uint8_t *src = (uint8_t *) malloc(length);
+    uint8_t *dest = (uint8_t *) malloc(length);
+    for (size_t i = 0; i < length; i++)
+        src[i] = (uint8_t) i;
+
+    [self measureBenchmark: @"async_memcpy" iterations: 100000 block: ^(NSUInteger iterations) {
+        for (NSUInteger i = 0; i < iterations; i++)
+            plcrash_async_memcpy(dest, src, length);
+    }];
+    STAssertTrue(memcmp(src, dest, length) == 0, @"Incorrect copy");
+
+    free(src);
+    free(dest);
+}
+
+- (void) testMemset {
+    size_t length = 4096;
+    uint8_t *dest = (uint8_t *) malloc(length);
+    __block NSUInteger failures = 0;
+
+    [self measureBenchmark: @"async_memset" iterations: 100000 block: ^(NSUInteger iterations) {
+        for (NSUInteger i = 0; i < iterations; i++) {
+            plcrash_async_memset(dest, (uint8_t) i, length);
+            if (dest[length - 1] != (uint8_t) i)
+                failures++;
+        }
+    }];
+    STAssertEquals((NSUInteger) 0, failures, @"Incorrect fill");
+
+    free(dest);
+}
+
+/**
+ * Measure plcrash_writer_pack() for a single field type.
+ */
+- (void) measurePack: (NSString *) name type: (PLProtobufCType) type value: (const void *) value {
+    void *buffer = _packBuffer;
+
+    [self measureBenchmark: [NSString stringWithFormat: @"writer_pack.%@", name] iterations: 100000 block: ^(NSUInteger iterations) {
+        plcrash_async_file_t file;
+        plcrash_async_file_init_buffer(&file, buffer, PACK_BUFFER_SIZE);
+
+        for (NSUInteger i = 0; i < iterations; i++)
+            plcrash_writer_pack(&file, 1, type, value);
+    }];
+}
+
+/**
+ * Measure the plcrash_writer_pack() sizing pass for a single field type, verifying that the computed size matches
+ * the number of bytes written by the encoding pass.
+ */
+- (void) measurePackSize: (NSString *) name type: (PLProtobufCType) type value: (const void *) value {
+    plcrash_async_file_t file;
+    plcrash_async_file_init_buffer(&file, _packBuffer, PACK_BUFFER_SIZE);
+    size_t expected = plcrash_writer_pack(&file, 1, type, value);
+    __block NSUInteger failures = 0;
+
+    [self measureBenchmark: [NSString stringWithFormat: @"writer_pack_size.%@", name] iterations: 100000 block: ^(NSUInteger iterations) {
+        for (NSUInteger i = 0; i < iterations; i++) {
+            if (plcrash_writer_pack(NULL, 1, type, value) != expected)
+                failures++;
+        }
+    }];
+    STAssertEquals((NSUInteger) 0, failures, @"Sizing pass disagrees with written size for %@", name);
+}
+
+- (void) testWriterPack {
+    uint32_t u32 = 0xCAFE;
+    uint64_t u64 = 0xCAFEF00DCAFEF00DULL;
+    int64_t s64 = -0xCAFEF00DLL;
+    double dbl = 42.5;
+    bool b = true;
+    const char *str = "benchmark_target_function";
+    uint8_t bytes[16];
+    PLProtobufCBinaryData binary = { .len = sizeof(bytes), .data = bytes };
+    memset(bytes, 0xA, sizeof(bytes));
+
+    [self measurePack: @"uint32" type: PLPROTOBUF_C_TYPE_UINT32 value: &u32];
+    [self measurePack: @"uint64" type: PLPROTOBUF_C_TYPE_UINT64 value: &u64];
+    [self measurePack: @"sint64" type: PLPROTOBUF_C_TYPE_SINT64 value: &s64];
+    [self measurePack: @"fixed64" type: PLPROTOBUF_C_TYPE_FIXED64 value: &u64];
+    [self measurePack: @"double" type: PLPROTOBUF_C_TYPE_DOUBLE value: &dbl];
+    [self measurePack: @"bool" type: PLPROTOBUF_C_TYPE_BOOL value: &b];
+    [self measurePack: @"string" type: PLPROTOBUF_C_TYPE_STRING value: str];
+    [self measurePack: @"bytes" type: PLPROTOBUF_C_TYPE_BYTES value: &binary];
+}
+
+- (void) testWriterPackSize {
+    uint32_t u32 = 0xCAFE;
+    uint64_t u64 = 0xCAFEF00DCAFEF00DULL;
+    int64_t s64 = -0xCAFEF00DLL;
+    const char *str = "benchmark_target_function";
+
+    [self measurePackSize: @"uint32" type: PLPROTOBUF_C_TYPE_UINT32 value: &u32];
+    [self measurePackSize: @"uint64" type: PLPROTOBUF_C_TYPE_UINT64 value: &u64];
+    [self measurePackSize: @"sint64" type: PLPROTOBUF_C_TYPE_SINT64 value: &s64];
+    [self measurePackSize: @"string" type: PLPROTOBUF_C_TYPE_STRING value: str];
+}
+
+- (void) testFindSymbolByPC {
+    plcrash_async_macho_t *image = &_image;
+    pl_vm_address_t pc = (pl_vm_address_t) benchmark_target_function + 1;
+    __block NSUInteger failures = 0;
+
+    [self measureBenchmark: @"macho_find_symbol_by_pc" iterations: 1000 block: ^(NSUInteger iterations) {
+        for (NSUInteger i = 0; i < iterations; i++) {
+            pl_vm_address_t address = 0;
+            if (plcrash_async_macho_find_symbol_by_pc(image, NULL, pc, found_symbol_cb, &address) != PLCRASH_ESUCCESS)
+                failures++;
+        }
+    }];
+    STAssertEquals((NSUInteger) 0, failures, @"Failed to find symbol");
+}
+
+- (void) testObjCFindMethod {
+    plcrash_async_macho_t *image = &_image;
+    pl_vm_address_t pc = (pl_vm_address_t) [self methodForSelector: _cmd] + 1;
+
+    plcrash_async_objc_cache_t cache;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_objc_cache_init(&cache), @"Failed to initialize ObjC cache");
+    plcrash_async_objc_cache_t *cachePtr = &cache;
+    __block NSUInteger failures = 0;
+
+    [self measureBenchmark: @"objc_find_method" iterations: 1000 block: ^(NSUInteger iterations) {
+        for (NSUInteger i = 0; i < iterations; i++) {
+            pl_vm_address_t imp = 0;
+            if (plcrash_async_objc_find_method(image, cachePtr, pc, found_method_cb, &imp) != PLCRASH_ESUCCESS)
+                failures++;
+        }
+    }];
+    STAssertEquals((NSUInteger) 0, failures, @"Failed to find method");
+
+    plcrash_async_objc_cache_free(&cache);
+}
+
+- (void) testCFEFindPC {
+    plcrash_async_mobject_t mobj;
+    if (plcrash_async_macho_map_section(&_image, SEG_TEXT, "__unwind_info", &mobj) != PLCRASH_ESUCCESS) {
+        NSLog(@"Skipping compact unwind benchmark; the test image has no __unwind_info section");
+        return;
+    }
+
+    plcrash_async_cfe_reader_t reader;
+    cpu_type_t cputype = plcrash_async_swap32(_image.byteorder, _image.header.cputype);
+    if (plcrash_async_cfe_reader_init(&reader, &mobj, cputype) != PLCRASH_ESUCCESS) {
+        NSLog(@"Skipping compact unwind benchmark; compact unwind is not supported for the test image's architecture");
+        plcrash_async_mobject_free(&mobj);
+        return;
+    }
+    plcrash_async_cfe_reader_t *readerPtr = &reader;
+
+    pl_vm_address_t pc = (pl_vm_address_t) benchmark_target_function + 1 - _image.header_addr;
+    [self measureBenchmark: @"cfe_reader_find_pc" iterations: 10000 block: ^(NSUInteger iterations) {
+        for (NSUInteger i = 0; i < iterations; i++) {
+            pl_vm_address_t function_base;
+            uint32_t encoding;
+            plcrash_async_cfe_reader_find_pc(readerPtr, pc, &function_base, &encoding);
+        }
+    }];
+
+    plcrash_async_cfe_reader_free(&reader);
+    plcrash_async_mobject_free(&mobj);
+}
+
+#if PLCRASH_FEATURE_UNWIND_DWARF
+
+- (void) testDWARFFindFDE {
+    plcrash_async_mobject_t mobj;
+    if (plcrash_async_macho_map_section(&_image, SEG_TEXT, "__eh_frame", &mobj) != PLCRASH_ESUCCESS) {
+        NSLog(@"Skipping DWARF benchmark; the test image has no __eh_frame section");
+        return;
+    }
+
+    /* Use the index to select an FDE from the middle of the section */
+    dwarf_frame_reader reader;
+    plcrash_async_dwarf_fde_index_t *index;
+    STAssertEquals(PLCRASH_ESUCCESS, reader.init(&mobj, _image.byteorder, plcrash_async_macho_m64(&_image), false), @"Failed to initialize reader");
+    STAssertEquals(PLCRASH_ESUCCESS, reader.build_fde_index(SIZE_MAX, &index), @"Failed to build FDE index");
+    if (index->count == 0) {
+        NSLog(@"Skipping DWARF benchmark; the test image's __eh_frame section contains no FDEs");
+        free(index);
+        plcrash_async_mobject_free(&mobj);
+        return;
+    }
+    pl_vm_address_t pc = (pl_vm_address_t) index->entries[index->count / 2].pc_start;
+
+    dwarf_frame_reader indexed;
+    STAssertEquals(PLCRASH_ESUCCESS, indexed.init(&mobj, _image.byteorder, plcrash_async_macho_m64(&_image), false, index), @"Failed to initialize reader");
+
+    dwarf_frame_reader *readerPtr = &reader;
+    dwarf_frame_reader *indexedPtr = &indexed;
+    __block NSUInteger failures = 0;
+
+    [self measureBenchmark: @"dwarf_find_fde.linear" iterations: 1000 block: ^(NSUInteger iterations) {
+        for (NSUInteger i = 0; i < iterations; i++) {
+            plcrash_async_dwarf_fde_info_t fde_info;
+            if (readerPtr->find_fde(0, pc, &fde_info) != PLCRASH_ESUCCESS) {
+                failures++;
+                continue;
+            }
+            plcrash_async_dwarf_fde_info_free(&fde_info);
+        }
+    }];
+
+    [self measureBenchmark: @"dwarf_find_fde.indexed" iterations: 100000 block: ^(NSUInteger iterations) {
+        for (NSUInteger i = 0; i < iterations; i++) {
+            plcrash_async_dwarf_fde_info_t fde_info;
+            if (indexedPtr->find_fde(0, pc, &fde_info) != PLCRASH_ESUCCESS) {
+                failures++;
+                continue;
+            }
+            plcrash_async_dwarf_fde_info_free(&fde_info);
+        }
+    }];
+    STAssertEquals((NSUInteger) 0, failures, @"Failed to find FDE");
+
+    free(index);
+    plcrash_async_mobject_free(&mobj);
+}
+
+- (void) testDWARFExpressionEval {
+    /* ((4 + 5) * (4 + 5)) */
+    static const uint8_t opcodes[] = { DW_OP_const1u, 4, DW_OP_const1u, 5, DW_OP_plus, DW_OP_dup, DW_OP_mul };
+
+    plcrash_async_thread_state_t ts;
+    cpu_type_t cputype = plcrash_async_swap32(_image.byteorder, _image.header.cputype);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_thread_state_init(&ts, cputype), @"Failed to initialize thread state");
+    plcrash_async_thread_state_t *tsPtr = &ts;
+
+    plcrash_async_mobject_t mobj;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_init(&mobj, mach_task_self(), (pl_vm_address_t) opcodes, sizeof(opcodes), true), @"Failed to initialize mobj");
+    plcrash_async_mobject_t *mobjPtr = &mobj;
+    __block NSUInteger failures = 0;
+
+    [self measureBenchmark: @"dwarf_expression_eval" iterations: 100000 block: ^(NSUInteger iterations) {
+        for (NSUInteger i = 0; i < iterations; i++) {
+            uint64_t result;
+            if ((plcrash_async_dwarf_expression_eval<uint64_t, int64_t>(mobjPtr, mach_task_self(), tsPtr, plcrash_async_byteorder_big_endian(), (pl_vm_address_t) opcodes, 0, sizeof(opcodes), NULL, 0, &result)) != PLCRASH_ESUCCESS)
+                failures++;
+        }
+    }];
+    STAssertEquals((NSUInteger) 0, failures, @"Evaluation failed");
+
+    plcrash_async_mobject_free(&mobj);
+}
+
+/* Register rule updates and look-ups, modeled on a typical x86-64/arm64 prologue. */
+- (void) testDWARFCFAStateRegisters {
+    __block NSUInteger failures = 0;
+
+    [self measureBenchmark: @"dwarf_cfa_state_registers" iterations: 100000 block: ^(NSUInteger iterations) {
+        for (NSUInteger i = 0; i < iterations; i++) {
+            dwarf_cfa_state<uint64_t, int64_t> stack;
+            plcrash_dwarf_cfa_reg_rule_t rule;
+            uint64_t value;
+
+            for (dwarf_cfa_state_regnum_t reg = 0; reg < 30; reg++)
+                stack.set_register(reg, PLCRASH_DWARF_CFA_REG_RULE_OFFSET, reg * 8);
+
+            for (dwarf_cfa_state_regnum_t reg = 0; reg < 30; reg++) {
+                if (!stack.get_register_rule(reg, &rule, &value) || value != (uint64_t) reg * 8)
+                    failures++;
+            }
+        }
+    }];
+    STAssertEquals((NSUInteger) 0, failures, @"Incorrect register rule");
+}
+
+#endif /* PLCRASH_FEATURE_UNWIND_DWARF */
+
+@end
@@ -87,13 +87,20 @@ plcrash_error_t plcrash_async_cfe_reader_init (plcrash_async_cfe_reader_t *reade
     }
 
     /* Verify the format version */
-    uint32_t version = reader->byteorder->swap32(header->version);
+    uint32_t version = plcrash_async_swap32(reader->byteorder, header->version);
     if (version != 1) {
         PLCF_DEBUG("Unsupported CFE version: %" PRIu32, version);
         return PLCRASH_ENOTSUP;
     }
 
     reader->header = *header;
+
+    /* Tables and pages are mapped lazily on first look-up */
+    reader->common_enc = NULL;
+    reader->common_enc_count = 0;
+    plcrash_async_memset(reader->pages, 0, sizeof(reader->pages));
+    reader->next_page = 0;
+
     return PLCRASH_ESUCCESS;
 }
 
@@ -148,46 +155,72 @@ plcrash_error_t plcrash_async_cfe_reader_init (plcrash_async_cfe_reader_t *reade
 #define VERIFY_SIZE_T(_etype, _ecount) (SIZE_MAX / sizeof(_etype) < (size_t) _ecount)
 
 /**
- * Return the compact frame encoding entry for @a pc via @a encoding, if available.
+ * @internal
  *
- * @param reader The initialized CFE reader which will be searched for the entry.
- * @param pc The PC value to search for within the CFE data. Note that this value must be relative to
- * the target Mach-O image's __TEXT vmaddr.
- * @param function_base On success, will be populated with the base address of the function. This value is relative to
- * the image's load address, rather than the in-memory address of the loaded image.
- * @param encoding On success, will be populated with the compact frame encoding entry.
+ * Return the cached second-level page containing @a pc, or NULL if not cached.
+ */
+static plcrash_async_cfe_page_t *plcrash_async_cfe_reader_cached_page (plcrash_async_cfe_reader_t *reader, pl_vm_address_t pc) {
+    for (uint32_t i = 0; i < PLCRASH_ASYNC_CFE_PAGE_CACHE_SIZE; i++) {
+        plcrash_async_cfe_page_t *page = &reader->pages[i];
+        if (page->valid && pc >= page->start_foffset && pc < page->end_foffset)
+            return page;
+    }
+
+    return NULL;
+}
+
+/**
+ * @internal
  *
- * @return Returns PLFRAME_ESUCCCESS on success, or one of the remaining error codes if a CFE parsing error occurs. If
- * the entry can not be found, PLFRAME_ENOTFOUND will be returned.
+ * Map the common encodings table, if it has not already been mapped.
  */
-plcrash_error_t plcrash_async_cfe_reader_find_pc (plcrash_async_cfe_reader_t *reader, pl_vm_address_t pc, pl_vm_address_t *function_base, uint32_t *encoding) {
+static plcrash_error_t plcrash_async_cfe_reader_map_common (plcrash_async_cfe_reader_t *reader) {
+    if (reader->common_enc != NULL)
+        return PLCRASH_ESUCCESS;
+
     const plcrash_async_byteorder_t *byteorder = reader->byteorder;
     const pl_vm_address_t base_addr = plcrash_async_mobject_base_address(reader->mobj);
 
-    /* Find and map the common encodings table */
-    uint32_t common_enc_count = byteorder->swap32(reader->header.commonEncodingsArrayCount);
-    uint32_t *common_enc;
-    {
-        if (VERIFY_SIZE_T(uint32_t, common_enc_count)) {
-            PLCF_DEBUG("CFE common encoding count extends beyond the range of size_t");
-            return PLCRASH_EINVAL;
-        }
+    uint32_t common_enc_count = plcrash_async_swap32(byteorder, reader->header.commonEncodingsArrayCount);
+    if (VERIFY_SIZE_T(uint32_t, common_enc_count)) {
+        PLCF_DEBUG("CFE common encoding count extends beyond the range of size_t");
+        return PLCRASH_EINVAL;
+    }
 
-        size_t common_enc_len = common_enc_count * sizeof(uint32_t);
-        uint32_t common_enc_off = byteorder->swap32(reader->header.commonEncodingsArraySectionOffset);
-        common_enc = plcrash_async_mobject_remap_address(reader->mobj, base_addr, common_enc_off, common_enc_len);
-        if (common_enc == NULL) {
-            PLCF_DEBUG("The declared common table lies outside the mapped CFE range");
-            return PLCRASH_EINVAL;
-        }
+    size_t common_enc_len = common_enc_count * sizeof(uint32_t);
+    uint32_t common_enc_off = plcrash_async_swap32(byteorder, reader->header.commonEncodingsArraySectionOffset);
+    uint32_t *common_enc = plcrash_async_mobject_remap_address(reader->mobj, base_addr, common_enc_off, common_enc_len);
+    if (common_enc == NULL) {
+        PLCF_DEBUG("The declared common table lies outside the mapped CFE range");
+        return PLCRASH_EINVAL;
     }
 
+    reader->common_enc = common_enc;
+    reader->common_enc_count = common_enc_count;
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * @internal
+ *
+ * Locate and decode the second-level page containing @a pc, recording the result in the reader's page cache.
+ *
+ * @param reader The reader to search.
+ * @param pc The PC value to search for, relative to the target Mach-O image's __TEXT vmaddr.
+ * @param result On success, the decoded page. This pointer will remain valid until the page is evicted by a later
+ * look-up.
+ */
+static plcrash_error_t plcrash_async_cfe_reader_load_page (plcrash_async_cfe_reader_t *reader, pl_vm_address_t pc, plcrash_async_cfe_page_t **result) {
+    const plcrash_async_byteorder_t *byteorder = reader->byteorder;
+    const pl_vm_address_t base_addr = plcrash_async_mobject_base_address(reader->mobj);
+
     /* Find and load the first level entry */
     struct unwind_info_section_header_index_entry *first_level_entry = NULL;
+    uint32_t end_foffset = UINT32_MAX;
     {
         /* Find and map the index */
-        uint32_t index_off = byteorder->swap32(reader->header.indexSectionOffset);
-        uint32_t index_count = byteorder->swap32(reader->header.indexCount);
+        uint32_t index_off = plcrash_async_swap32(byteorder, reader->header.indexSectionOffset);
+        uint32_t index_count = plcrash_async_swap32(byteorder, reader->header.indexCount);
         
         if (VERIFY_SIZE_T(sizeof(struct unwind_info_section_header_index_entry), index_count)) {
             PLCF_DEBUG("CFE index count extends beyond the range of size_t");
@@ -218,7 +251,7 @@ plcrash_error_t plcrash_async_cfe_reader_find_pc (plcrash_async_cfe_reader_t *re
         }
         
         /* Binary search for the first-level entry */
-#define CFE_FUN_BINARY_SEARCH_ENTVAL(_tval) (byteorder->swap32(_tval.functionOffset))
+#define CFE_FUN_BINARY_SEARCH_ENTVAL(_tval) (plcrash_async_swap32(byteorder, _tval.functionOffset))
         CFE_FUN_BINARY_SEARCH(pc, index_entries, index_count, first_level_entry);
 #undef CFE_FUN_BINARY_SEARCH_ENTVAL
         
@@ -226,12 +259,27 @@ plcrash_error_t plcrash_async_cfe_reader_find_pc (plcrash_async_cfe_reader_t *re
             PLCF_DEBUG("Could not find a first level CFE entry for pc=%" PRIx64, (uint64_t) pc);
             return PLCRASH_ENOTFOUND;
         }
+
+        /* The page covers all PCs up to the next first-level entry; the final entry covers all remaining PCs */
+        if (first_level_entry + 1 < index_entries + index_count)
+            end_foffset = plcrash_async_swap32(byteorder, first_level_entry[1].functionOffset);
     }
 
-    /* Locate and decode the second-level entry */
-    uint32_t second_level_offset = byteorder->swap32(first_level_entry->secondLevelPagesSectionOffset);
+    /* Locate and decode the second-level page header */
+    plcrash_async_cfe_page_t page;
+    page.valid = true;
+    page.start_foffset = plcrash_async_swap32(byteorder, first_level_entry->functionOffset);
+    page.end_foffset = end_foffset;
+
+    uint32_t second_level_offset = plcrash_async_swap32(byteorder, first_level_entry->secondLevelPagesSectionOffset);
     uint32_t *second_level_kind = plcrash_async_mobject_remap_address(reader->mobj, base_addr, second_level_offset, sizeof(uint32_t));
-    switch (byteorder->swap32(*second_level_kind)) {
+    if (second_level_kind == NULL) {
+        PLCF_DEBUG("The second-level page lies outside the mapped CFE range");
+        return PLCRASH_EINVAL;
+    }
+
+    page.kind = plcrash_async_swap32(byteorder, *second_level_kind);
+    switch (page.kind) {
         case UNWIND_SECOND_LEVEL_REGULAR: {
             struct unwind_info_regular_second_level_page_header *header;
             header = plcrash_async_mobject_remap_address(reader->mobj, base_addr, second_level_offset, sizeof(*header));
@@ -241,8 +289,8 @@ plcrash_error_t plcrash_async_cfe_reader_find_pc (plcrash_async_cfe_reader_t *re
             }
 
             /* Find the entries array */
-            uint32_t entries_offset = byteorder->swap16(header->entryPageOffset);
-            uint32_t entries_count = byteorder->swap16(header->entryCount);
+            uint32_t entries_offset = plcrash_async_swap16(byteorder, header->entryPageOffset);
+            uint32_t entries_count = plcrash_async_swap16(byteorder, header->entryCount);
             
             if (VERIFY_SIZE_T(sizeof(struct unwind_info_regular_second_level_entry), entries_count)) {
                 PLCF_DEBUG("CFE second level entry count extends beyond the range of size_t");
@@ -253,23 +301,12 @@ plcrash_error_t plcrash_async_cfe_reader_find_pc (plcrash_async_cfe_reader_t *re
                 PLCF_DEBUG("CFE entries table lies outside the mapped CFE range");
                 return PLCRASH_EINVAL;
             }
-            
-            /* Binary search for the target entry */
-            struct unwind_info_regular_second_level_entry *entries = (struct unwind_info_regular_second_level_entry *) (((uintptr_t)header) + entries_offset);
-            struct unwind_info_regular_second_level_entry *entry = NULL;
-            
-#define CFE_FUN_BINARY_SEARCH_ENTVAL(_tval) (byteorder->swap32(_tval.functionOffset))
-            CFE_FUN_BINARY_SEARCH(pc, entries, entries_count, entry);
-#undef CFE_FUN_BINARY_SEARCH_ENTVAL
-            
-            if (entry == NULL) {
-                PLCF_DEBUG("Could not find a second level regular CFE entry for pc=%" PRIx64, (uint64_t) pc);
-                return PLCRASH_ENOTFOUND;
-            }
 
-            *encoding = byteorder->swap32(entry->encoding);
-            *function_base = byteorder->swap32(entry->functionOffset);
-            return PLCRASH_ESUCCESS;
+            page.entries = (void *) (((uintptr_t)header) + entries_offset);
+            page.entries_count = entries_count;
+            page.encodings = NULL;
+            page.encodings_count = 0;
+            break;
         }
 
         case UNWIND_SECOND_LEVEL_COMPRESSED: {
@@ -279,13 +316,10 @@ plcrash_error_t plcrash_async_cfe_reader_find_pc (plcrash_async_cfe_reader_t *re
                 PLCF_DEBUG("The second-level page header lies outside the mapped CFE range");
                 return PLCRASH_EINVAL;
             }
-            
-            /* Record the base offset */
-            uint32_t base_foffset = byteorder->swap32(first_level_entry->functionOffset);
 
             /* Find the entries array */
-            uint32_t entries_offset = byteorder->swap16(header->entryPageOffset);
-            uint32_t entries_count = byteorder->swap16(header->entryCount);
+            uint32_t entries_offset = plcrash_async_swap16(byteorder, header->entryPageOffset);
+            uint32_t entries_count = plcrash_async_swap16(byteorder, header->entryCount);
 
             if (VERIFY_SIZE_T(sizeof(uint32_t), entries_count)) {
                 PLCF_DEBUG("CFE second level entry count extends beyond the range of size_t");
@@ -297,12 +331,98 @@ plcrash_error_t plcrash_async_cfe_reader_find_pc (plcrash_async_cfe_reader_t *re
                 return PLCRASH_EINVAL;
             }
 
+            /* Map in the encodings table */
+            uint32_t encodings_offset = plcrash_async_swap16(byteorder, header->encodingsPageOffset);
+            uint32_t encodings_count = plcrash_async_swap16(byteorder, header->encodingsCount);
+            
+            if (VERIFY_SIZE_T(sizeof(uint32_t), encodings_count)) {
+                PLCF_DEBUG("CFE second level entry count extends beyond the range of size_t");
+                return PLCRASH_EINVAL;
+            }
+
+            if (!plcrash_async_mobject_verify_local_pointer(reader->mobj, header, encodings_offset, encodings_count * sizeof(uint32_t))) {
+                PLCF_DEBUG("CFE compressed encodings table lies outside the mapped CFE range");
+                return PLCRASH_EINVAL;
+            }
+
+            page.entries = (void *) (((uintptr_t)header) + entries_offset);
+            page.entries_count = entries_count;
+            page.encodings = (uint32_t *) (((uintptr_t)header) + encodings_offset);
+            page.encodings_count = encodings_count;
+            break;
+        }
+
+        default:
+            PLCF_DEBUG("Unsupported second-level CFE table kind: 0x%" PRIx32 " at 0x%" PRIx32, page.kind, second_level_offset);
+            return PLCRASH_EINVAL;
+    }
+
+    /* Record the page, replacing the oldest cached entry */
+    plcrash_async_cfe_page_t *slot = &reader->pages[reader->next_page];
+    reader->next_page = (reader->next_page + 1) % PLCRASH_ASYNC_CFE_PAGE_CACHE_SIZE;
+
+    *slot = page;
+    *result = slot;
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Return the compact frame encoding entry for @a pc via @a encoding, if available.
+ *
+ * @param reader The initialized CFE reader which will be searched for the entry.
+ * @param pc The PC value to search for within the CFE data. Note that this value must be relative to
+ * the target Mach-O image's __TEXT vmaddr.
+ * @param function_base On success, will be populated with the base address of the function. This value is relative to
+ * the image's load address, rather than the in-memory address of the loaded image.
+ * @param encoding On success, will be populated with the compact frame encoding entry.
+ *
+ * @return Returns PLFRAME_ESUCCCESS on success, or one of the remaining error codes if a CFE parsing error occurs. If
+ * the entry can not be found, PLFRAME_ENOTFOUND will be returned.
+ */
+plcrash_error_t plcrash_async_cfe_reader_find_pc (plcrash_async_cfe_reader_t *reader, pl_vm_address_t pc, pl_vm_address_t *function_base, uint32_t *encoding) {
+    const plcrash_async_byteorder_t *byteorder = reader->byteorder;
+    plcrash_error_t err;
+
+    /* Find and map the common encodings table */
+    if ((err = plcrash_async_cfe_reader_map_common(reader)) != PLCRASH_ESUCCESS)
+        return err;
+
+    /* Find the second-level page, decoding it if it has not been recently used */
+    plcrash_async_cfe_page_t *page = plcrash_async_cfe_reader_cached_page(reader, pc);
+    if (page == NULL && (err = plcrash_async_cfe_reader_load_page(reader, pc, &page)) != PLCRASH_ESUCCESS)
+        return err;
+
+    /* Locate and decode the second-level entry */
+    switch (page->kind) {
+        case UNWIND_SECOND_LEVEL_REGULAR: {
+            /* Binary search for the target entry */
+            struct unwind_info_regular_second_level_entry *entries = (struct unwind_info_regular_second_level_entry *) page->entries;
+            struct unwind_info_regular_second_level_entry *entry = NULL;
+            
+#define CFE_FUN_BINARY_SEARCH_ENTVAL(_tval) (plcrash_async_swap32(byteorder, _tval.functionOffset))
+            CFE_FUN_BINARY_SEARCH(pc, entries, page->entries_count, entry);
+#undef CFE_FUN_BINARY_SEARCH_ENTVAL
+            
+            if (entry == NULL) {
+                PLCF_DEBUG("Could not find a second level regular CFE entry for pc=%" PRIx64, (uint64_t) pc);
+                return PLCRASH_ENOTFOUND;
+            }
+
+            *encoding = plcrash_async_swap32(byteorder, entry->encoding);
+            *function_base = plcrash_async_swap32(byteorder, entry->functionOffset);
+            return PLCRASH_ESUCCESS;
+        }
+
+        case UNWIND_SECOND_LEVEL_COMPRESSED: {
+            /* Record the base offset */
+            uint32_t base_foffset = page->start_foffset;
+
             /* Binary search for the target entry */
-            uint32_t *compressed_entries = (uint32_t *) (((uintptr_t)header) + entries_offset);
+            uint32_t *compressed_entries = (uint32_t *) page->entries;
             uint32_t *c_entry_ptr = NULL;
 
-#define CFE_FUN_BINARY_SEARCH_ENTVAL(_tval) (base_foffset + UNWIND_INFO_COMPRESSED_ENTRY_FUNC_OFFSET(byteorder->swap32(_tval)))
-            CFE_FUN_BINARY_SEARCH(pc, compressed_entries, entries_count, c_entry_ptr);
+#define CFE_FUN_BINARY_SEARCH_ENTVAL(_tval) (base_foffset + UNWIND_INFO_COMPRESSED_ENTRY_FUNC_OFFSET(plcrash_async_swap32(byteorder, _tval)))
+            CFE_FUN_BINARY_SEARCH(pc, compressed_entries, page->entries_count, c_entry_ptr);
 #undef CFE_FUN_BINARY_SEARCH_ENTVAL
             
             if (c_entry_ptr == NULL) {
@@ -311,51 +431,31 @@ plcrash_error_t plcrash_async_cfe_reader_find_pc (plcrash_async_cfe_reader_t *re
             }
 
             /* Find the actual encoding */
-            uint32_t c_entry = byteorder->swap32(*c_entry_ptr);
+            uint32_t c_entry = plcrash_async_swap32(byteorder, *c_entry_ptr);
             uint8_t c_encoding_idx = UNWIND_INFO_COMPRESSED_ENTRY_ENCODING_INDEX(c_entry);
             
             /* Save the function base */
-            *function_base = base_foffset + UNWIND_INFO_COMPRESSED_ENTRY_FUNC_OFFSET(byteorder->swap32(c_entry));
+            *function_base = base_foffset + UNWIND_INFO_COMPRESSED_ENTRY_FUNC_OFFSET(plcrash_async_swap32(byteorder, c_entry));
             
             /* Handle common table entries */
-            if (c_encoding_idx < common_enc_count) {
+            if (c_encoding_idx < reader->common_enc_count) {
                 /* Found in the common table. The offset is verified as being within the mapped memory range by
                  * the < common_enc_count check above. */
-                *encoding = byteorder->swap32(common_enc[c_encoding_idx]);
+                *encoding = plcrash_async_swap32(byteorder, reader->common_enc[c_encoding_idx]);
                 return PLCRASH_ESUCCESS;
             }
 
-            /* Map in the encodings table */
-            uint32_t encodings_offset = byteorder->swap16(header->encodingsPageOffset);
-            uint32_t encodings_count = byteorder->swap16(header->encodingsCount);
-            
-            if (VERIFY_SIZE_T(sizeof(uint32_t), encodings_count)) {
-                PLCF_DEBUG("CFE second level entry count extends beyond the range of size_t");
-                return PLCRASH_EINVAL;
-            }
-
-            if (!plcrash_async_mobject_verify_local_pointer(reader->mobj, header, encodings_offset, encodings_count * sizeof(uint32_t))) {
-                PLCF_DEBUG("CFE compressed encodings table lies outside the mapped CFE range");
-                return PLCRASH_EINVAL;
-            }
-
-            uint32_t *encodings = (uint32_t *) (((uintptr_t)header) + encodings_offset);
-
             /* Verify that the entry is within range */
-            c_encoding_idx -= common_enc_count;
-            if (c_encoding_idx >= encodings_count) {
+            c_encoding_idx -= reader->common_enc_count;
+            if (c_encoding_idx >= page->encodings_count) {
                 PLCF_DEBUG("Encoding index lies outside the second level encoding table");
                 return PLCRASH_EINVAL;
             }
 
             /* Save the results */
-            *encoding = byteorder->swap32(encodings[c_encoding_idx]);
+            *encoding = plcrash_async_swap32(byteorder, page->encodings[c_encoding_idx]);
             return PLCRASH_ESUCCESS;
         }
-
-        default:
-            PLCF_DEBUG("Unsupported second-level CFE table kind: 0x%" PRIx32 " at 0x%" PRIx32, byteorder->swap32(*second_level_kind), second_level_offset);
-            return PLCRASH_EINVAL;
     }
 
     // Unreachable
@@ -481,6 +581,87 @@ uint32_t plcrash_async_cfe_register_encode (const uint32_t registers[], uint32_t
     return permutation;
 }
 
+/**
+ * @internal
+ * Decoded register lists for all 720 six-register permutations, indexed by the 10-bit permutation value. Each entry
+ * packs the first five CFE register values (1-6) as 3-bit fields, with the first register in the low-order bits; the
+ * sixth register is whichever value remains.
+ *
+ * Since shorter lists use the same positional renumbering with proportionally smaller factors, a @a count register
+ * permutation may be mapped onto this table by scaling it by (6 - @a count)!. The first @a count registers of the
+ * resulting entry are the decoded list. See plcrash_async_cfe_register_encode() for the encoding details.
+ */
+static const uint16_t plcrash_async_cfe_permutation_table[720] = {
+    0x58d1, 0x68d1, 0x4ad1, 0x6ad1, 0x4cd1, 0x5cd1, 0x5711, 0x6711, 0x3b11, 0x6b11, 0x3d11, 0x5d11,
+    0x4751, 0x6751, 0x3951, 0x6951, 0x3d51, 0x4d51, 0x4791, 0x5791, 0x3991, 0x5991, 0x3b91, 0x4b91,
+    0x5899, 0x6899, 0x4a99, 0x6a99, 0x4c99, 0x5c99, 0x5519, 0x6519, 0x2b19, 0x6b19, 0x2d19, 0x5d19,
+    0x4559, 0x6559, 0x2959, 0x6959, 0x2d59, 0x4d59, 0x4599, 0x5599, 0x2999, 0x5999, 0x2b99, 0x4b99,
+    0x56a1, 0x66a1, 0x3aa1, 0x6aa1, 0x3ca1, 0x5ca1, 0x54e1, 0x64e1, 0x2ae1, 0x6ae1, 0x2ce1, 0x5ce1,
+    0x3561, 0x6561, 0x2761, 0x6761, 0x2d61, 0x3d61, 0x35a1, 0x55a1, 0x27a1, 0x57a1, 0x2ba1, 0x3ba1,
+    0x46a9, 0x66a9, 0x38a9, 0x68a9, 0x3ca9, 0x4ca9, 0x44e9, 0x64e9, 0x28e9, 0x68e9, 0x2ce9, 0x4ce9,
+    0x3529, 0x6529, 0x2729, 0x6729, 0x2d29, 0x3d29, 0x35a9, 0x45a9, 0x27a9, 0x47a9, 0x29a9, 0x39a9,
+    0x46b1, 0x56b1, 0x38b1, 0x58b1, 0x3ab1, 0x4ab1, 0x44f1, 0x54f1, 0x28f1, 0x58f1, 0x2af1, 0x4af1,
+    0x3531, 0x5531, 0x2731, 0x5731, 0x2b31, 0x3b31, 0x3571, 0x4571, 0x2771, 0x4771, 0x2971, 0x3971,
+    0x58ca, 0x68ca, 0x4aca, 0x6aca, 0x4cca, 0x5cca, 0x570a, 0x670a, 0x3b0a, 0x6b0a, 0x3d0a, 0x5d0a,
+    0x474a, 0x674a, 0x394a, 0x694a, 0x3d4a, 0x4d4a, 0x478a, 0x578a, 0x398a, 0x598a, 0x3b8a, 0x4b8a,
+    0x585a, 0x685a, 0x4a5a, 0x6a5a, 0x4c5a, 0x5c5a, 0x531a, 0x631a, 0x1b1a, 0x6b1a, 0x1d1a, 0x5d1a,
+    0x435a, 0x635a, 0x195a, 0x695a, 0x1d5a, 0x4d5a, 0x439a, 0x539a, 0x199a, 0x599a, 0x1b9a, 0x4b9a,
+    0x5662, 0x6662, 0x3a62, 0x6a62, 0x3c62, 0x5c62, 0x52e2, 0x62e2, 0x1ae2, 0x6ae2, 0x1ce2, 0x5ce2,
+    0x3362, 0x6362, 0x1762, 0x6762, 0x1d62, 0x3d62, 0x33a2, 0x53a2, 0x17a2, 0x57a2, 0x1ba2, 0x3ba2,
+    0x466a, 0x666a, 0x386a, 0x686a, 0x3c6a, 0x4c6a, 0x42ea, 0x62ea, 0x18ea, 0x68ea, 0x1cea, 0x4cea,
+    0x332a, 0x632a, 0x172a, 0x672a, 0x1d2a, 0x3d2a, 0x33aa, 0x43aa, 0x17aa, 0x47aa, 0x19aa, 0x39aa,
+    0x4672, 0x5672, 0x3872, 0x5872, 0x3a72, 0x4a72, 0x42f2, 0x52f2, 0x18f2, 0x58f2, 0x1af2, 0x4af2,
+    0x3332, 0x5332, 0x1732, 0x5732, 0x1b32, 0x3b32, 0x3372, 0x4372, 0x1772, 0x4772, 0x1972, 0x3972,
+    0x588b, 0x688b, 0x4a8b, 0x6a8b, 0x4c8b, 0x5c8b, 0x550b, 0x650b, 0x2b0b, 0x6b0b, 0x2d0b, 0x5d0b,
+    0x454b, 0x654b, 0x294b, 0x694b, 0x2d4b, 0x4d4b, 0x458b, 0x558b, 0x298b, 0x598b, 0x2b8b, 0x4b8b,
+    0x5853, 0x6853, 0x4a53, 0x6a53, 0x4c53, 0x5c53, 0x5313, 0x6313, 0x1b13, 0x6b13, 0x1d13, 0x5d13,
+    0x4353, 0x6353, 0x1953, 0x6953, 0x1d53, 0x4d53, 0x4393, 0x5393, 0x1993, 0x5993, 0x1b93, 0x4b93,
+    0x5463, 0x6463, 0x2a63, 0x6a63, 0x2c63, 0x5c63, 0x52a3, 0x62a3, 0x1aa3, 0x6aa3, 0x1ca3, 0x5ca3,
+    0x2363, 0x6363, 0x1563, 0x6563, 0x1d63, 0x2d63, 0x23a3, 0x53a3, 0x15a3, 0x55a3, 0x1ba3, 0x2ba3,
+    0x446b, 0x646b, 0x286b, 0x686b, 0x2c6b, 0x4c6b, 0x42ab, 0x62ab, 0x18ab, 0x68ab, 0x1cab, 0x4cab,
+    0x232b, 0x632b, 0x152b, 0x652b, 0x1d2b, 0x2d2b, 0x23ab, 0x43ab, 0x15ab, 0x45ab, 0x19ab, 0x29ab,
+    0x4473, 0x5473, 0x2873, 0x5873, 0x2a73, 0x4a73, 0x42b3, 0x52b3, 0x18b3, 0x58b3, 0x1ab3, 0x4ab3,
+    0x2333, 0x5333, 0x1533, 0x5533, 0x1b33, 0x2b33, 0x2373, 0x4373, 0x1573, 0x4573, 0x1973, 0x2973,
+    0x568c, 0x668c, 0x3a8c, 0x6a8c, 0x3c8c, 0x5c8c, 0x54cc, 0x64cc, 0x2acc, 0x6acc, 0x2ccc, 0x5ccc,
+    0x354c, 0x654c, 0x274c, 0x674c, 0x2d4c, 0x3d4c, 0x358c, 0x558c, 0x278c, 0x578c, 0x2b8c, 0x3b8c,
+    0x5654, 0x6654, 0x3a54, 0x6a54, 0x3c54, 0x5c54, 0x52d4, 0x62d4, 0x1ad4, 0x6ad4, 0x1cd4, 0x5cd4,
+    0x3354, 0x6354, 0x1754, 0x6754, 0x1d54, 0x3d54, 0x3394, 0x5394, 0x1794, 0x5794, 0x1b94, 0x3b94,
+    0x545c, 0x645c, 0x2a5c, 0x6a5c, 0x2c5c, 0x5c5c, 0x529c, 0x629c, 0x1a9c, 0x6a9c, 0x1c9c, 0x5c9c,
+    0x235c, 0x635c, 0x155c, 0x655c, 0x1d5c, 0x2d5c, 0x239c, 0x539c, 0x159c, 0x559c, 0x1b9c, 0x2b9c,
+    0x346c, 0x646c, 0x266c, 0x666c, 0x2c6c, 0x3c6c, 0x32ac, 0x62ac, 0x16ac, 0x66ac, 0x1cac, 0x3cac,
+    0x22ec, 0x62ec, 0x14ec, 0x64ec, 0x1cec, 0x2cec, 0x23ac, 0x33ac, 0x15ac, 0x35ac, 0x17ac, 0x27ac,
+    0x3474, 0x5474, 0x2674, 0x5674, 0x2a74, 0x3a74, 0x32b4, 0x52b4, 0x16b4, 0x56b4, 0x1ab4, 0x3ab4,
+    0x22f4, 0x52f4, 0x14f4, 0x54f4, 0x1af4, 0x2af4, 0x2374, 0x3374, 0x1574, 0x3574, 0x1774, 0x2774,
+    0x468d, 0x668d, 0x388d, 0x688d, 0x3c8d, 0x4c8d, 0x44cd, 0x64cd, 0x28cd, 0x68cd, 0x2ccd, 0x4ccd,
+    0x350d, 0x650d, 0x270d, 0x670d, 0x2d0d, 0x3d0d, 0x358d, 0x458d, 0x278d, 0x478d, 0x298d, 0x398d,
+    0x4655, 0x6655, 0x3855, 0x6855, 0x3c55, 0x4c55, 0x42d5, 0x62d5, 0x18d5, 0x68d5, 0x1cd5, 0x4cd5,
+    0x3315, 0x6315, 0x1715, 0x6715, 0x1d15, 0x3d15, 0x3395, 0x4395, 0x1795, 0x4795, 0x1995, 0x3995,
+    0x445d, 0x645d, 0x285d, 0x685d, 0x2c5d, 0x4c5d, 0x429d, 0x629d, 0x189d, 0x689d, 0x1c9d, 0x4c9d,
+    0x231d, 0x631d, 0x151d, 0x651d, 0x1d1d, 0x2d1d, 0x239d, 0x439d, 0x159d, 0x459d, 0x199d, 0x299d,
+    0x3465, 0x6465, 0x2665, 0x6665, 0x2c65, 0x3c65, 0x32a5, 0x62a5, 0x16a5, 0x66a5, 0x1ca5, 0x3ca5,
+    0x22e5, 0x62e5, 0x14e5, 0x64e5, 0x1ce5, 0x2ce5, 0x23a5, 0x33a5, 0x15a5, 0x35a5, 0x17a5, 0x27a5,
+    0x3475, 0x4475, 0x2675, 0x4675, 0x2875, 0x3875, 0x32b5, 0x42b5, 0x16b5, 0x46b5, 0x18b5, 0x38b5,
+    0x22f5, 0x42f5, 0x14f5, 0x44f5, 0x18f5, 0x28f5, 0x2335, 0x3335, 0x1535, 0x3535, 0x1735, 0x2735,
+    0x468e, 0x568e, 0x388e, 0x588e, 0x3a8e, 0x4a8e, 0x44ce, 0x54ce, 0x28ce, 0x58ce, 0x2ace, 0x4ace,
+    0x350e, 0x550e, 0x270e, 0x570e, 0x2b0e, 0x3b0e, 0x354e, 0x454e, 0x274e, 0x474e, 0x294e, 0x394e,
+    0x4656, 0x5656, 0x3856, 0x5856, 0x3a56, 0x4a56, 0x42d6, 0x52d6, 0x18d6, 0x58d6, 0x1ad6, 0x4ad6,
+    0x3316, 0x5316, 0x1716, 0x5716, 0x1b16, 0x3b16, 0x3356, 0x4356, 0x1756, 0x4756, 0x1956, 0x3956,
+    0x445e, 0x545e, 0x285e, 0x585e, 0x2a5e, 0x4a5e, 0x429e, 0x529e, 0x189e, 0x589e, 0x1a9e, 0x4a9e,
+    0x231e, 0x531e, 0x151e, 0x551e, 0x1b1e, 0x2b1e, 0x235e, 0x435e, 0x155e, 0x455e, 0x195e, 0x295e,
+    0x3466, 0x5466, 0x2666, 0x5666, 0x2a66, 0x3a66, 0x32a6, 0x52a6, 0x16a6, 0x56a6, 0x1aa6, 0x3aa6,
+    0x22e6, 0x52e6, 0x14e6, 0x54e6, 0x1ae6, 0x2ae6, 0x2366, 0x3366, 0x1566, 0x3566, 0x1766, 0x2766,
+    0x346e, 0x446e, 0x266e, 0x466e, 0x286e, 0x386e, 0x32ae, 0x42ae, 0x16ae, 0x46ae, 0x18ae, 0x38ae,
+    0x22ee, 0x42ee, 0x14ee, 0x44ee, 0x18ee, 0x28ee, 0x232e, 0x332e, 0x152e, 0x352e, 0x172e, 0x272e,
+};
+
+/**
+ * @internal
+ * Scale factors mapping a @a count register permutation onto plcrash_async_cfe_permutation_table, indexed by count.
+ */
+static const uint32_t plcrash_async_cfe_permutation_scale[PLCRASH_ASYNC_CFE_PERMUTATION_REGISTER_MAX+1] = {
+    0, 120, 24, 6, 2, 1, 1
+};
+
 /**
  * @internal
  * Decode a ordered register list from the 10 bit register encoding as defined by the CFE format.
@@ -504,78 +685,30 @@ plcrash_error_t plcrash_async_cfe_register_decode (uint32_t permutation, uint32_
         return PLCRASH_EINVAL;
     }
 
+    /* Assert that the maximum register count matches our lookup tables. */
+    PLCR_ASSERT_STATIC(expected_max_register_count, PLCRASH_ASYNC_CFE_PERMUTATION_REGISTER_MAX == 6);
+
     /*
-     * Each register is encoded by mapping the values to a 10-bit range, and then further sub-ranges within that range,
-     * with a subrange allocated to each position. See the encoding function for full documentation.
+     * Map the permutation onto the six-register table; the permutation is a 10-bit value, and the scale factor is at
+     * most 120, so this can not overflow.
      */
-    int permunreg[PLCRASH_ASYNC_CFE_PERMUTATION_REGISTER_MAX];
-#define PERMUTE(pos, factor) do { \
-permunreg[pos] = permutation/factor; \
-permutation -= (permunreg[pos]*factor); \
-} while (0)
+    uint32_t index = (permutation & 0x3FF) * plcrash_async_cfe_permutation_scale[count];
+    if (index >= sizeof(plcrash_async_cfe_permutation_table) / sizeof(plcrash_async_cfe_permutation_table[0])) {
+        PLCF_DEBUG("Register permutation 0x%" PRIx32 " is invalid for a count of %" PRIu32, permutation, count);
+        return PLCRASH_EINVAL;
+    }
+
+    uint32_t entry = plcrash_async_cfe_permutation_table[index];
+    uint32_t remaining = 1 + 2 + 3 + 4 + 5 + 6;
+    for (uint32_t i = 0; i < count && i < 5; i++) {
+        registers[i] = (entry >> (3 * i)) & 0x7;
+        remaining -= registers[i];
+    }
+
+    /* The final register of a six-register list is implied by the five preceding it */
+    if (count == PLCRASH_ASYNC_CFE_PERMUTATION_REGISTER_MAX)
+        registers[5] = remaining;
 
-    /* Assert that the maximum register count matches our switch() statement. */
-    PLCR_ASSERT_STATIC(expected_max_register_count, PLCRASH_ASYNC_CFE_PERMUTATION_REGISTER_MAX == 6);
-	switch (count) {
-		case 6:
-            PERMUTE(0, 120);
-            PERMUTE(1, 24);
-            PERMUTE(2, 6);
-            PERMUTE(3, 2);
-            PERMUTE(4, 1);
-            
-            /*
-             * There are 6 elements in the list, 6 possible values for each element, and values may not repeat. The
-             * value of the last element can be derived from the values previously seen (and due to the positional
-             * renumbering performed, the value of the last element will *always* be 0).
-             */
-            permunreg[5] = 0;
-			break;
-		case 5:
-            PERMUTE(0, 120);
-            PERMUTE(1, 24);
-            PERMUTE(2, 6);
-            PERMUTE(3, 2);
-            PERMUTE(4, 1);
-			break;
-		case 4:
-            PERMUTE(0, 60);
-            PERMUTE(1, 12);
-            PERMUTE(2, 3);
-            PERMUTE(3, 1);
-			break;
-		case 3:
-            PERMUTE(0, 20);
-            PERMUTE(1, 4);
-            PERMUTE(2, 1);
-			break;
-		case 2:
-            PERMUTE(0, 5);
-            PERMUTE(1, 1);
-			break;
-		case 1:
-            PERMUTE(0, 1);
-			break;
-	}
-#undef PERMUTE
-    
-	/* Recompute the actual register values based on the position-relative values. */
-	bool position_used[PLCRASH_ASYNC_CFE_SAVED_REGISTER_MAX+1] = { 0 };
-    
-	for (uint32_t i = 0; i < count; ++i) {
-		int renumbered = 0;
-		for (int u = 1; u < 7; u++) {
-			if (!position_used[u]) {
-				if (renumbered == permunreg[i]) {
-					registers[i] = u;
-					position_used[u] = true;
-					break;
-				}
-				renumbered++;
-			}
-		}
-	}
-    
     return PLCRASH_ESUCCESS;
 }
 
@@ -1027,6 +1160,7 @@ void plcrash_async_cfe_entry_register_list (plcrash_async_cfe_entry_t *entry, pl
  * @param thread_state The current thread state corresponding to @a entry.
  * @param entry A CFE unwind entry.
  * @param new_thread_state The new thread state to be initialized.
+ * @param stack A mapping of @a task's stack from which saved register values will be read if available, or NULL.
  *
  * @return Returns PLCRASH_ESUCCESS on success, or a standard plcrash_error_t code if an error occurs.
  *
@@ -1036,7 +1170,8 @@ plcrash_error_t plcrash_async_cfe_entry_apply (task_t task,
                                                pl_vm_address_t function_address,
                                                const plcrash_async_thread_state_t *thread_state,
                                                plcrash_async_cfe_entry_t *entry,
-                                               plcrash_async_thread_state_t *new_thread_state)
+                                               plcrash_async_thread_state_t *new_thread_state,
+                                               plcrash_async_mobject_t *stack)
 {
     /* Set up register load target */
     size_t greg_size = plcrash_async_thread_state_get_greg_size(thread_state);
@@ -1088,7 +1223,7 @@ plcrash_error_t plcrash_async_cfe_entry_apply (task_t task,
             plcrash_async_thread_state_set_reg(new_thread_state, PLCRASH_REG_SP, new_sp);
 
             /* Read the saved fp and retaddr */
-            err = plcrash_async_task_memcpy(task, (pl_vm_address_t) fp, 0, dest, greg_size * 2);
+            err = plcrash_async_mobject_task_memcpy(stack, task, (pl_vm_address_t) fp, 0, dest, greg_size * 2);
             if (err != PLCRASH_ESUCCESS) {
                 PLCF_DEBUG("Failed to read frame data at address 0x%" PRIx64 ": %d", (uint64_t) fp, err);
                 return err;
@@ -1148,7 +1283,7 @@ plcrash_error_t plcrash_async_cfe_entry_apply (task_t task,
                 plcrash_async_thread_state_set_reg(new_thread_state, PLCRASH_REG_SP, retaddr + greg_size);
 
                 /* Read the saved return address */
-                err = plcrash_async_task_memcpy(task, (pl_vm_address_t) retaddr, 0, dest, greg_size);
+                err = plcrash_async_mobject_task_memcpy(stack, task, (pl_vm_address_t) retaddr, 0, dest, greg_size);
                 if (err != PLCRASH_ESUCCESS) {
                     PLCF_DEBUG("Failed to read return address from 0x%" PRIx64 ": %d", (uint64_t) retaddr, err);
                     return err;
@@ -1195,7 +1330,7 @@ plcrash_error_t plcrash_async_cfe_entry_apply (task_t task,
 
         /* Fetch and save register data */
         plcrash_error_t err;
-        err = plcrash_async_task_memcpy(task, (pl_vm_address_t) saved_reg_addr, i*greg_size, dest, greg_size);
+        err = plcrash_async_mobject_task_memcpy(stack, task, (pl_vm_address_t) saved_reg_addr, i*greg_size, dest, greg_size);
         if (err != PLCRASH_ESUCCESS) {
             PLCF_DEBUG("Failed to read register data for index %s: %d", plcrash_async_thread_state_get_reg_name(thread_state, register_list[i]), err);
             return err;
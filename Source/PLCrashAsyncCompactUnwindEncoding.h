@@ -43,9 +43,47 @@
  * @{
  */
 
+/** The number of decoded second-level pages retained by a plcrash_async_cfe_reader_t. */
+#define PLCRASH_ASYNC_CFE_PAGE_CACHE_SIZE 4
+
+/**
+ * @internal
+ * A decoded second-level CFE page, as cached by a plcrash_async_cfe_reader_t.
+ */
+typedef struct plcrash_async_cfe_page {
+    /** True if this page entry has been populated. */
+    bool valid;
+
+    /** The first function offset covered by this page (inclusive). */
+    uint32_t start_foffset;
+
+    /** The end of the function offset range covered by this page (exclusive), or UINT32_MAX if this is the final
+     * page in the index. */
+    uint32_t end_foffset;
+
+    /** The page kind; one of UNWIND_SECOND_LEVEL_REGULAR or UNWIND_SECOND_LEVEL_COMPRESSED. */
+    uint32_t kind;
+
+    /** The locally mapped entries array, verified to lie within the reader's memory object. For regular pages, this
+     * is an array of struct unwind_info_regular_second_level_entry; for compressed pages, an array of uint32_t. */
+    void *entries;
+
+    /** The number of elements in @a entries. */
+    uint32_t entries_count;
+
+    /** The locally mapped page-local encodings table of a compressed page, or NULL for regular pages. */
+    uint32_t *encodings;
+
+    /** The number of elements in @a encodings. */
+    uint32_t encodings_count;
+} plcrash_async_cfe_page_t;
+
 /**
  * @internal
  * A CFE reader instance. Performs CFE data parsing from a backing memory object.
+ *
+ * Decoded second-level pages are cached by the reader; a reader may be retained across multiple look-ups within
+ * the same image (eg, for all frames in a report) to avoid re-parsing page headers for each look-up.
  */
 typedef struct plcrash_async_cfe_reader {
     /** A memory object containing the CFE data at the starting address. */
@@ -59,6 +97,18 @@ typedef struct plcrash_async_cfe_reader {
 
     /** The byte order of the encoded data (including the header). */
     const plcrash_async_byteorder_t *byteorder;
+
+    /** The locally mapped common encodings table, or NULL if not yet mapped. */
+    uint32_t *common_enc;
+
+    /** The number of elements in @a common_enc. */
+    uint32_t common_enc_count;
+
+    /** Recently decoded second-level pages. */
+    plcrash_async_cfe_page_t pages[PLCRASH_ASYNC_CFE_PAGE_CACHE_SIZE];
+
+    /** The @a pages slot to be replaced by the next decoded page. */
+    uint32_t next_page;
 } plcrash_async_cfe_reader_t;
 
 /**
@@ -209,7 +259,8 @@ plcrash_error_t plcrash_async_cfe_entry_apply (task_t task,
                                                pl_vm_address_t function_address,
                                                const plcrash_async_thread_state_t *thread_state,
                                                plcrash_async_cfe_entry_t *entry,
-                                               plcrash_async_thread_state_t *new_thread_state);
+                                               plcrash_async_thread_state_t *new_thread_state,
+                                               plcrash_async_mobject_t *stack);
 
 void plcrash_async_cfe_entry_free (plcrash_async_cfe_entry_t *entry);
 
@@ -690,6 +690,20 @@
     STAssertNotEquals(PLCRASH_ESUCCESS, plcrash_async_cfe_register_decode(0, PLCRASH_ASYNC_CFE_PERMUTATION_REGISTER_MAX+1, registers), @"Decoding of a too-large count did not return an error");
 }
 
+/**
+ * Test passing a permutation that is out of range for the given count to plcrash_async_cfe_register_decode()
+ */
+- (void) testPermutedRegisterDecodeInvalidPermutation {
+    uint32_t registers[PLCRASH_ASYNC_CFE_PERMUTATION_REGISTER_MAX];
+
+    /* A single register may only be encoded as 0-5 */
+    STAssertNotEquals(PLCRASH_ESUCCESS, plcrash_async_cfe_register_decode(6, 1, registers), @"Decoding of an out-of-range permutation did not return an error");
+
+    /* There are only 720 permutations of six registers */
+    STAssertNotEquals(PLCRASH_ESUCCESS, plcrash_async_cfe_register_decode(720, 6, registers), @"Decoding of an out-of-range permutation did not return an error");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_cfe_register_decode(719, 6, registers), @"Decoding of the final permutation returned an error");
+}
+
 /**
  * Verify encoding+decoding of permuted frameless registers, verifying all supported lengths. The test cases were
  * all extracted from code generated by clang.
@@ -801,6 +815,29 @@
     STAssertEquals(encoding, (uint32_t)PC_REGULAR_ENCODING, @"Incorrect encoding returned");
 }
 
+/**
+ * Test repeated reads across regular and compressed pages, verifying that results served from the reader's page
+ * cache match those of the initial decode.
+ */
+- (void) testReadCachedPages {
+    pl_vm_address_t function_base;
+    uint32_t encoding;
+
+    for (int i = 0; i < 2; i++) {
+        STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_cfe_reader_find_pc(&_reader, PC_REGULAR, &function_base, &encoding), @"Failed to locate CFE entry");
+        STAssertEquals(function_base, (pl_vm_address_t)PC_REGULAR, @"Incorrect function base returned");
+        STAssertEquals(encoding, (uint32_t)PC_REGULAR_ENCODING, @"Incorrect encoding returned");
+
+        STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_cfe_reader_find_pc(&_reader, PC_COMPACT_PRIVATE, &function_base, &encoding), @"Failed to locate CFE entry");
+        STAssertEquals(function_base, (pl_vm_address_t)PC_COMPACT_PRIVATE, @"Incorrect function base returned");
+        STAssertEquals(encoding, (uint32_t)PC_COMPACT_PRIVATE_ENCODING, @"Incorrect encoding returned");
+
+        STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_cfe_reader_find_pc(&_reader, PC_COMPACT_COMMON, &function_base, &encoding), @"Failed to locate CFE entry");
+        STAssertEquals(function_base, (pl_vm_address_t)PC_COMPACT_COMMON, @"Incorrect function base returned");
+        STAssertEquals(encoding, (uint32_t)PC_COMPACT_COMMON_ENCODING, @"Incorrect encoding returned");
+    }
+}
+
 /*
  * The following tests can only be run with ARM64 thread state support.
  */
@@ -835,7 +872,7 @@
     
     /* Apply! */
     plcrash_async_thread_state_t nts;
-    plcrash_error_t err = plcrash_async_cfe_entry_apply(mach_task_self(), 0x0, &ts, &entry, &nts);
+    plcrash_error_t err = plcrash_async_cfe_entry_apply(mach_task_self(), 0x0, &ts, &entry, &nts, NULL);
     STAssertEquals(err, PLCRASH_ESUCCESS, @"Failed to apply state to thread");
     
     /* Verify! */
@@ -897,7 +934,7 @@
 
     /* Apply */
     plcrash_async_thread_state_t nts;
-    plcrash_error_t err = plcrash_async_cfe_entry_apply(mach_task_self(), 0x0, &ts, &entry, &nts);
+    plcrash_error_t err = plcrash_async_cfe_entry_apply(mach_task_self(), 0x0, &ts, &entry, &nts, NULL);
     STAssertEquals(err, PLCRASH_ESUCCESS, @"Failed to apply state to thread");
     
     /* Verify */
@@ -963,7 +1000,7 @@
 
     /* Apply! */
     plcrash_async_thread_state_t nts;
-    plcrash_error_t err = plcrash_async_cfe_entry_apply(mach_task_self(), 0x0, &ts, &entry, &nts);
+    plcrash_error_t err = plcrash_async_cfe_entry_apply(mach_task_self(), 0x0, &ts, &entry, &nts, NULL);
     STAssertEquals(err, PLCRASH_ESUCCESS, @"Failed to apply state to thread");
     
     /* Verify! */
@@ -1025,7 +1062,7 @@
     
     /* Apply! */
     plcrash_async_thread_state_t nts;
-    plcrash_error_t err = plcrash_async_cfe_entry_apply(mach_task_self(), 0x0, &ts, &entry, &nts);
+    plcrash_error_t err = plcrash_async_cfe_entry_apply(mach_task_self(), 0x0, &ts, &entry, &nts, NULL);
     STAssertEquals(err, PLCRASH_ESUCCESS, @"Failed to apply state to thread");
     
     /* Verify! */
@@ -1085,7 +1122,7 @@
 
     /* Apply */
     plcrash_async_thread_state_t nts;
-    plcrash_error_t err = plcrash_async_cfe_entry_apply(mach_task_self(), 0x0, &ts, &entry, &nts);
+    plcrash_error_t err = plcrash_async_cfe_entry_apply(mach_task_self(), 0x0, &ts, &entry, &nts, NULL);
     STAssertEquals(err, PLCRASH_ESUCCESS, @"Failed to apply state to thread");
     
     /* Verify */
@@ -1152,7 +1189,7 @@
     
     /* Apply */
     plcrash_async_thread_state_t nts;
-    plcrash_error_t err = plcrash_async_cfe_entry_apply(mach_task_self(), function_address, &ts, &entry, &nts);
+    plcrash_error_t err = plcrash_async_cfe_entry_apply(mach_task_self(), function_address, &ts, &entry, &nts, NULL);
     STAssertEquals(err, PLCRASH_ESUCCESS, @"Failed to apply state to thread");
     
     /* Verify */
@@ -59,6 +59,7 @@ bool dwarf_cfa_state<machine_ptr, machine_ptr_s>::push_state (void) {
     _cfa_value[_table_depth].set_undefined_rule();
 
     plcrash_async_memset(_table_stack[_table_depth], DWARF_CFA_STATE_INVALID_ENTRY_IDX, sizeof(_table_stack[0]));
+    plcrash_async_memset(_dense_table[_table_depth], DWARF_CFA_STATE_INVALID_ENTRY_IDX, sizeof(_dense_table[0]));
     
     return true;
 }
@@ -102,6 +103,7 @@ dwarf_cfa_state<machine_ptr, machine_ptr_s>::dwarf_cfa_state (void) {
     /* Set up the table */
     _table_depth = 0;
     plcrash_async_memset(_table_stack[0], DWARF_CFA_STATE_INVALID_ENTRY_IDX, sizeof(_table_stack[0]));
+    plcrash_async_memset(_dense_table[0], DWARF_CFA_STATE_INVALID_ENTRY_IDX, sizeof(_dense_table[0]));
     
     /* Default CFA */
     _cfa_value[0].set_undefined_rule();
@@ -116,6 +118,14 @@ dwarf_cfa_state<machine_ptr, machine_ptr_s>::dwarf_cfa_state (void) {
  */
 template <typename machine_ptr, typename machine_ptr_s>
 bool dwarf_cfa_state<machine_ptr, machine_ptr_s>::set_register (dwarf_cfa_state_regnum_t regnum, plcrash_dwarf_cfa_reg_rule_t rule, machine_ptr value) {
+    /* Check the direct-mapped table for an existing entry */
+    if (regnum < DWARF_CFA_STATE_DENSE_REGNUM_COUNT && _dense_table[_table_depth][regnum] != DWARF_CFA_STATE_INVALID_ENTRY_IDX) {
+        dwarf_cfa_reg_entry_t *existing = &_entries[_dense_table[_table_depth][regnum]];
+        existing->value = value;
+        existing->rule = rule;
+        return true;
+    }
+
     /* Check for an existing entry, or find the target entry off which we'll chain our entry */
     unsigned int bucket = regnum % (sizeof(_table_stack[0]) / sizeof(_table_stack[0][0]));
     
@@ -161,6 +171,9 @@ bool dwarf_cfa_state<machine_ptr, machine_ptr_s>::set_register (dwarf_cfa_state_
     } else {
         parent->next = entry - _entries;
     }
+
+    if (regnum < DWARF_CFA_STATE_DENSE_REGNUM_COUNT)
+        _dense_table[_table_depth][regnum] = entry_idx;
     
     _register_count[_table_depth]++;
     return true;
@@ -176,6 +189,17 @@ bool dwarf_cfa_state<machine_ptr, machine_ptr_s>::set_register (dwarf_cfa_state_
  */
 template <typename machine_ptr, typename machine_ptr_s>
 bool dwarf_cfa_state<machine_ptr, machine_ptr_s>::get_register_rule (dwarf_cfa_state_regnum_t regnum, plcrash_dwarf_cfa_reg_rule_t *rule, machine_ptr *value) {
+    /* Use the direct-mapped table, if possible */
+    if (regnum < DWARF_CFA_STATE_DENSE_REGNUM_COUNT) {
+        uint8_t entry_idx = _dense_table[_table_depth][regnum];
+        if (entry_idx == DWARF_CFA_STATE_INVALID_ENTRY_IDX)
+            return false;
+
+        *value = _entries[entry_idx].value;
+        *rule = (plcrash_dwarf_cfa_reg_rule_t) _entries[entry_idx].rule;
+        return true;
+    }
+
     /* Search for the entry */
     unsigned int bucket = regnum % (sizeof(_table_stack[0]) / sizeof(_table_stack[0][0]));
     
@@ -210,28 +234,29 @@ void dwarf_cfa_state<machine_ptr, machine_ptr_s>::remove_register (dwarf_cfa_sta
     /* Search for the entry */
     unsigned int bucket = regnum % (sizeof(_table_stack[0]) / sizeof(_table_stack[0][0]));
     
-    dwarf_cfa_reg_entry *prev = NULL;
-    dwarf_cfa_reg_entry_t *entry = NULL;
-    for (uint8_t entry_idx = _table_stack[_table_depth][bucket]; entry_idx != DWARF_CFA_STATE_INVALID_ENTRY_IDX; entry_idx = entry->next) {
-        prev = entry;
-        entry = &_entries[entry_idx];
+    uint8_t *link = &_table_stack[_table_depth][bucket];
+    while (*link != DWARF_CFA_STATE_INVALID_ENTRY_IDX) {
+        uint8_t entry_idx = *link;
+        dwarf_cfa_reg_entry_t *entry = &_entries[entry_idx];
         
-        if (entry->regnum != regnum)
+        if (entry->regnum != regnum) {
+            link = &entry->next;
             continue;
-        
-        /* Remove from the bucket chain */
-        if (prev != NULL) {
-            prev->next = entry->next;
-        } else {
-            _table_stack[_table_depth][bucket] = entry->next;
         }
         
-        /* Re-insert in the free list */
+        /* Remove from the bucket chain and the direct-mapped table */
+        *link = entry->next;
+        if (regnum < DWARF_CFA_STATE_DENSE_REGNUM_COUNT)
+            _dense_table[_table_depth][regnum] = DWARF_CFA_STATE_INVALID_ENTRY_IDX;
+        
+        /* Re-insert in the free list. The entry's next pointer now references the free list, and
+         * iteration must not continue. */
         entry->next = _free_list;
         _free_list = entry_idx;
         
         /* Decrement the register count */
         _register_count[_table_depth]--;
+        return;
     }
 }
 
@@ -33,6 +33,7 @@
 #include "PLCrashAsync.h"
 #include "PLCrashAsyncDwarfFDE.hpp"
 #include "PLCrashAsyncDwarfCIE.hpp"
+#include "PLCrashAsyncDwarfExpression.hpp"
 #include "PLCrashAsyncDwarfPrimitives.hpp"
 
 #include "PLCrashFeatureConfig.h"
@@ -52,7 +53,7 @@ namespace async {
 /* Maximum DWARF register number supported by dwarf_cfa_state and dwarf_cfa_state_regnum_t. */
 #define DWARF_CFA_STATE_REGNUM_MAX UINT32_MAX
 
-/* Consumes around 1.65k (on 32-bit and 64-bit systems). */
+/* Consumes around 1.85k (on 32-bit and 64-bit systems). */
 #define DWARF_CFA_STATE_MAX_REGISTERS 100
 
 template <typename machine_ptr, typename machine_ptr_s> class dwarf_cfa_state_iterator;
@@ -248,6 +249,11 @@ public:
  * The actual total number of supported, active registers is much smaller. This class is built to decrease the
  * total amount of fixed stack space to be allocated.
  *
+ * The registers used by the supported architectures' unwind data are almost exclusively assigned small register
+ * numbers (x86-64's general purpose registers are numbered 0-16, and arm64's 0-31). Entries for register numbers
+ * below DWARF_CFA_STATE_DENSE_REGNUM_COUNT are additionally indexed by a direct-mapped table, allowing them to be
+ * found without walking the bucket chains.
+ *
  * @todo If we introduce our own async-safe heap allocator, it may be preferrable to use the heap for entries.
  */
 template <typename machine_ptr, typename machine_ptr_s>
@@ -257,6 +263,7 @@ private:
 #define DWARF_CFA_STATE_MAX_STATES 6
 #define DWARF_CFA_STATE_BUCKET_COUNT 14
 #define DWARF_CFA_STATE_INVALID_ENTRY_IDX UINT8_MAX
+#define DWARF_CFA_STATE_DENSE_REGNUM_COUNT 32
 
     /** A single register entry */
     typedef struct dwarf_cfa_reg_entry {
@@ -295,6 +302,13 @@ private:
      */
     uint8_t _table_stack[DWARF_CFA_STATE_MAX_STATES][DWARF_CFA_STATE_BUCKET_COUNT];
 
+    /**
+     * Direct-mapped lookup table for register numbers below DWARF_CFA_STATE_DENSE_REGNUM_COUNT. Maps from regnum
+     * to a table index, or DWARF_CFA_STATE_INVALID_ENTRY_IDX if no entry exists. The entries are also linked
+     * into the bucket chains of @a _table_stack, which remain authoritative for iteration.
+     */
+    uint8_t _dense_table[DWARF_CFA_STATE_MAX_STATES][DWARF_CFA_STATE_DENSE_REGNUM_COUNT];
+
     /** Current position in the table stack */
     uint8_t _table_depth;
 
@@ -325,7 +339,9 @@ public:
                                  plcrash_async_dwarf_cie_info_t *cie_info,
                                  const plcrash_async_thread_state_t *thread_state,
                                  const plcrash_async_byteorder_t *byteorder,
-                                 plcrash_async_thread_state_t *new_thread_state);
+                                 plcrash_async_thread_state_t *new_thread_state,
+                                 plcrash_async_dwarf_expression_cache_t *expr_cache = NULL,
+                                 plcrash_async_mobject_t *stack = NULL);
     
     bool set_register (dwarf_cfa_state_regnum_t regnum, plcrash_dwarf_cfa_reg_rule_t rule, machine_ptr value);
     bool get_register_rule (dwarf_cfa_state_regnum_t regnum, plcrash_dwarf_cfa_reg_rule_t *rule, machine_ptr *value);
@@ -466,6 +466,9 @@ plcrash_error_t dwarf_cfa_state<machine_ptr, machine_ptr_s>::eval_program (plcra
  * @param thread_state The current thread state corresponding to @a entry.
  * @param byteorder The target's byte order.
  * @param new_thread_state The new thread state to be initialized.
+ * @param expr_cache If non-NULL, a cache of decoded DWARF expressions that will be used to evaluate any CFA or
+ * register expression rules, and populated with any newly decoded expressions.
+ * @param stack A mapping of @a task's stack from which saved register values will be read if available, or NULL.
  *
  * @return Returns PLCRASH_ESUCCESS on success, or a standard pclrash_error_t code if an error occurs.
  */
@@ -474,7 +477,9 @@ plcrash_error_t dwarf_cfa_state<machine_ptr, machine_ptr_s>::apply_state (task_t
                                                                           plcrash_async_dwarf_cie_info_t *cie_info,
                                                                           const plcrash_async_thread_state_t *thread_state,
                                                                           const plcrash_async_byteorder_t *byteorder,
-                                                                          plcrash_async_thread_state_t *new_thread_state)
+                                                                          plcrash_async_thread_state_t *new_thread_state,
+                                                                          plcrash_async_dwarf_expression_cache_t *expr_cache,
+                                                                          plcrash_async_mobject_t *stack)
 {
     plcrash_error_t err;
 
@@ -520,13 +525,7 @@ plcrash_error_t dwarf_cfa_state<machine_ptr, machine_ptr_s>::apply_state (task_t
         }
 
         case DWARF_CFA_STATE_CFA_TYPE_EXPRESSION: {
-            plcrash_async_mobject_t mobj;
-            if ((err = plcrash_async_mobject_init(&mobj, task, cfa_rule.expression_address(), cfa_rule.expression_length(), true)) != PLCRASH_ESUCCESS) {
-                PLCF_DEBUG("Could not map CFA expression range");
-                return err;
-            }
-            
-            if ((err = plcrash_async_dwarf_expression_eval<machine_ptr, machine_ptr_s>(&mobj, task, thread_state, byteorder, cfa_rule.expression_address(), 0x0, cfa_rule.expression_length(), NULL, 0, &cfa_val)) != PLCRASH_ESUCCESS) {
+            if ((err = plcrash_async_dwarf_expression_eval_cached<machine_ptr, machine_ptr_s>(expr_cache, task, thread_state, byteorder, cfa_rule.expression_address(), cfa_rule.expression_length(), NULL, 0, &cfa_val)) != PLCRASH_ESUCCESS) {
                 PLCF_DEBUG("CFA eval_64 failed");
                 return err;
             }
@@ -634,7 +633,7 @@ static plcrash_error_t plcrash_async_dwarf_cfa_state_apply_register (task_t task
     /* Apply the rule */
     switch (dw_rule) {
         case PLCRASH_DWARF_CFA_REG_RULE_OFFSET: {
-            if ((err = plcrash_async_task_memcpy(task, cfa_val, (machine_ptr_s)dw_value, vptr, greg_size)) != PLCRASH_ESUCCESS) {
+            if ((err = plcrash_async_mobject_task_memcpy(stack, task, cfa_val, (machine_ptr_s)dw_value, vptr, greg_size)) != PLCRASH_ESUCCESS) {
                 PLCF_DEBUG("Failed to read offset(N) register value: %d", err);
                 return err;
             }
@@ -686,19 +685,11 @@ static plcrash_error_t plcrash_async_dwarf_cfa_state_apply_register (task_t task
                 return PLCRASH_EINVAL;
             }
             
-            /* Map the expression data  */
-            plcrash_async_mobject_t mobj;
-            if ((err = plcrash_async_mobject_init(&mobj, task, expr_addr, expr_len, true)) != PLCRASH_ESUCCESS) {
-                PLCF_DEBUG("Could not map CFA expression range");
-                return err;
-            }
-            
             /* Perform the evaluation */
             plcrash_greg_t regval;
             if (m64) {
                 uint64_t initial_state[] = { cfa_val };
-                if ((err = plcrash_async_dwarf_expression_eval<uint64_t, int64_t>(&mobj, task, thread_state, byteorder, expr_addr, 0, expr_len, initial_state, 1, &rvalue.v64)) != PLCRASH_ESUCCESS) {
-                    plcrash_async_mobject_free(&mobj);
+                if ((err = plcrash_async_dwarf_expression_eval_cached<uint64_t, int64_t>(expr_cache, task, thread_state, byteorder, expr_addr, expr_len, initial_state, 1, &rvalue.v64)) != PLCRASH_ESUCCESS) {
                     PLCF_DEBUG("CFA eval_64 failed");
                     return err;
                 }
@@ -706,8 +697,7 @@ static plcrash_error_t plcrash_async_dwarf_cfa_state_apply_register (task_t task
                 regval = rvalue.v64;
             } else {
                 uint32_t initial_state[] = { static_cast<uint32_t>(cfa_val) };
-                if ((err = plcrash_async_dwarf_expression_eval<uint32_t, int32_t>(&mobj, task, thread_state, byteorder, expr_addr, 0, expr_len, initial_state, 1, &rvalue.v32)) != PLCRASH_ESUCCESS) {
-                    plcrash_async_mobject_free(&mobj);
+                if ((err = plcrash_async_dwarf_expression_eval_cached<uint32_t, int32_t>(expr_cache, task, thread_state, byteorder, expr_addr, expr_len, initial_state, 1, &rvalue.v32)) != PLCRASH_ESUCCESS) {
                     PLCF_DEBUG("CFA eval_32 failed");
                     return err;
                 }
@@ -715,12 +705,9 @@ static plcrash_error_t plcrash_async_dwarf_cfa_state_apply_register (task_t task
                 regval = rvalue.v32;
             }
             
-            /* Clean up the memory mapping */
-            plcrash_async_mobject_free(&mobj);
-            
             /* Dereference the target address, if using the non-value EXPRESSION rule */
             if (dw_rule == PLCRASH_DWARF_CFA_REG_RULE_EXPRESSION) {
-                if ((err = plcrash_async_task_memcpy(task, regval, 0, vptr, greg_size)) != PLCRASH_ESUCCESS) {
+                if ((err = plcrash_async_mobject_task_memcpy(stack, task, regval, 0, vptr, greg_size)) != PLCRASH_ESUCCESS) {
                     PLCF_DEBUG("Failed to read register value from expression result: %d", err);
                     return err;
                 }
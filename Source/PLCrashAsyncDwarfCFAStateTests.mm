@@ -261,6 +261,44 @@ using namespace plcrash::async;
     STAssertFalse(stack.push_state(), @"Pushing succeeded on a full state stack");
 }
 
+/**
+ * Test that registers in the direct-mapped range and registers sharing their buckets are handled independently.
+ */
+- (void) testDenseAndSparseRegisters {
+    dwarf_cfa_state<uint64_t, int64_t> stack;
+    plcrash_dwarf_cfa_reg_rule_t rule;
+    uint64_t value;
+
+    /* 3 and 3+DWARF_CFA_STATE_BUCKET_COUNT*5 share a bucket; only the former is direct-mapped */
+    const dwarf_cfa_state_regnum_t dense_reg = 3;
+    const dwarf_cfa_state_regnum_t sparse_reg = dense_reg + DWARF_CFA_STATE_BUCKET_COUNT * 5;
+    STAssertTrue(sparse_reg >= DWARF_CFA_STATE_DENSE_REGNUM_COUNT, @"Test register should not be direct-mapped");
+
+    STAssertTrue(stack.set_register(sparse_reg, PLCRASH_DWARF_CFA_REG_RULE_OFFSET, 1), @"Failed to add register");
+    STAssertTrue(stack.set_register(dense_reg, PLCRASH_DWARF_CFA_REG_RULE_OFFSET, 2), @"Failed to add register");
+    STAssertTrue(stack.set_register(dense_reg, PLCRASH_DWARF_CFA_REG_RULE_VAL_OFFSET, 3), @"Failed to modify register");
+    STAssertEquals((uint8_t)2, stack.get_register_count(), @"Incorrect number of registers");
+
+    STAssertTrue(stack.get_register_rule(dense_reg, &rule, &value), @"Failed to fetch info for entry");
+    STAssertEquals((uint64_t)3, value, @"Incorrect value");
+    STAssertEquals(rule, PLCRASH_DWARF_CFA_REG_RULE_VAL_OFFSET, @"Incorrect rule");
+
+    /* Removing the direct-mapped register must leave the other bucket entry intact */
+    stack.remove_register(dense_reg);
+    STAssertFalse(stack.get_register_rule(dense_reg, &rule, &value), @"Register info was returned for a removed register");
+    STAssertTrue(stack.get_register_rule(sparse_reg, &rule, &value), @"Failed to fetch info for entry");
+    STAssertEquals((uint64_t)1, value, @"Incorrect value");
+    STAssertEquals((uint8_t)1, stack.get_register_count(), @"Incorrect number of registers");
+
+    /* A pushed state must not see the saved state's direct-mapped entries */
+    STAssertTrue(stack.set_register(dense_reg, PLCRASH_DWARF_CFA_REG_RULE_OFFSET, 4), @"Failed to add register");
+    STAssertTrue(stack.push_state(), @"Failed to push a new state");
+    STAssertFalse(stack.get_register_rule(dense_reg, &rule, &value), @"Register info was returned from a saved state");
+    STAssertTrue(stack.pop_state(), @"Failed to pop current state");
+    STAssertTrue(stack.get_register_rule(dense_reg, &rule, &value), @"Failed to fetch info for entry");
+    STAssertEquals((uint64_t)4, value, @"Incorrect value");
+}
+
 @end
 
 #endif /* PLCRASH_FEATURE_UNWIND_DWARF */
@@ -28,6 +28,7 @@
 #include "PLCrashFeatureConfig.h"
 
 #include <inttypes.h>
+#include <stdlib.h>
 
 #if PLCRASH_FEATURE_UNWIND_DWARF
 
@@ -51,25 +52,200 @@ using namespace plcrash::async;
  * @param m64 True if the target system uses 64-bit pointers, false if it uses 32-bit pointers.
  * @param debug_frame If true, interpret the DWARF data as a debug_frame section. Otherwise, the
  * frame reader will assume eh_frame data.
+ * @param fde_index An optional FDE look-up table previously built from the same section via build_fde_index(), or NULL.
+ * If provided, the table must survive for the lifetime of the reader.
  *
  * @return Returns PLCRASH_ESUCCESS on success, or an appropriate plcrash_error_t value on error.
  */
 plcrash_error_t dwarf_frame_reader::init (plcrash_async_mobject_t *mobj,
                                           const plcrash_async_byteorder_t *byteorder,
                                           bool m64,
-                                          bool debug_frame)
+                                          bool debug_frame,
+                                          const plcrash_async_dwarf_fde_index_t *fde_index)
 {
     _mobj = mobj;
     _byteorder = byteorder;
     _debug_frame = debug_frame;
     _m64 = m64;
+    _fde_index = fde_index;
     
     return PLCRASH_ESUCCESS;
 }
 
+/**
+ * Read the CIE/FDE entry header at @a cfi_entry.
+ *
+ * @param cfi_entry The address of the entry's initial length field.
+ * @param next_cfi_entry On success, will be set to the address of the following entry.
+ * @param is_fde On success, will be set to true if the entry is a FDE, or false if it is a CIE.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if the entry is a terminating entry, or PLCRASH_EINVAL
+ * if the entry can not be read.
+ */
+plcrash_error_t dwarf_frame_reader::read_entry (pl_vm_address_t cfi_entry, pl_vm_address_t *next_cfi_entry, bool *is_fde) {
+    const plcrash_async_byteorder_t *byteorder = _byteorder;
+    plcrash_error_t err;
+
+    /* Fetch the entry length (and determine wether it's 64-bit or 32-bit) */
+    uint64_t length;
+    pl_vm_size_t length_size;
+    uint8_t dwarf_word_size;
+    
+    {
+        uint32_t *length32 = (uint32_t *) plcrash_async_mobject_remap_address(_mobj, cfi_entry, 0x0, sizeof(uint32_t));
+        if (length32 == NULL) {
+            PLCF_DEBUG("The current CFI entry 0x%" PRIx64 " header lies outside the mapped range", (uint64_t) cfi_entry);
+            return PLCRASH_EINVAL;
+        }
+        
+        if (plcrash_async_swap32(byteorder, *length32) == UINT32_MAX) {
+            uint64_t *length64 = (uint64_t *) plcrash_async_mobject_remap_address(_mobj, cfi_entry, sizeof(uint32_t), sizeof(uint64_t));
+            if (length64 == NULL) {
+                PLCF_DEBUG("The current CFI entry 0x%" PRIx64 " header lies outside the mapped range", (uint64_t) cfi_entry);
+                return PLCRASH_EINVAL;
+            }
+            
+            length = plcrash_async_swap64(byteorder, *length64);
+            length_size = sizeof(uint64_t) + sizeof(uint32_t);
+            dwarf_word_size = 8; // 64-bit DWARF
+        } else {
+            length = plcrash_async_swap32(byteorder, *length32);
+            length_size = sizeof(uint32_t);
+            dwarf_word_size = 4; // 32-bit DWARF
+        }
+    }
+    
+    /*
+     * APPLE EXTENSION
+     * Check for end marker, as per Apple's libunwind-35.1. It's unclear if this is defined by the DWARF 3 or 4 specifications; I could not
+     * find a reference to it.
+     
+     * Section 7.2.2 defines 0xfffffff0 - 0xffffffff as being reserved for extensions to the length
+     * field relative to the DWARF 2 standard. There is no explicit reference to the use of an 0 value.
+     *
+     * In section 7.2.1, the value of 0 is defined as being reserved as an error value in the encodings for
+     * "attribute names, attribute forms, base type encodings, location operations, languages, line number program
+     * opcodes, macro information entries and tag names to represent an error condition or unknown value."
+     *
+     * Section 7.2.2 doesn't justify the usage of 0x0 as a termination marker, but given that Apple's code relies on it,
+     * we will also do so here.
+     */
+    if (length == 0x0)
+        return PLCRASH_ENOTFOUND;
+    
+    /* Calculate the next entry address; the length_size addition is known-safe, as we were able to successfully read the length from *cfi_entry */
+    if (!plcrash_async_address_apply_offset(cfi_entry+length_size, length, next_cfi_entry)) {
+        PLCF_DEBUG("Entry length size overflows the CFI address");
+        return PLCRASH_EINVAL;
+    }
+    
+    /* Fetch the entry id */
+    uint64_t cie_id;
+    
+    if ((err = plcrash_async_dwarf_read_uintmax64(_mobj, byteorder, cfi_entry, length_size, dwarf_word_size, &cie_id)) != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("The current CFI entry 0x%" PRIx64 " cie_id lies outside the mapped range", (uint64_t) cfi_entry);
+        return PLCRASH_EINVAL;
+    }
+    
+    /* Check for CIE entries. */
+    *is_fde = true;
+
+    /* debug_frame uses UINT?_MAX to denote CIE entries. */
+    if (_debug_frame && ((dwarf_word_size == 8 && cie_id == UINT64_MAX) || (dwarf_word_size == 4 && cie_id == UINT32_MAX)))
+        *is_fde = false;
+    
+    /* eh_frame uses a type of 0x0 to denote CIE entries. */
+    if (!_debug_frame && cie_id == 0x0)
+        *is_fde = false;
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Decode the FDE at @a cfi_entry.
+ *
+ * @param cfi_entry The address of the FDE's initial length field.
+ * @param fde_info On success, will be initialized with the FDE data. The caller is responsible for freeing the
+ * returned FDE record via plcrash_async_dwarf_fde_info_free().
+ */
+plcrash_error_t dwarf_frame_reader::read_fde (pl_vm_address_t cfi_entry, plcrash_async_dwarf_fde_info_t *fde_info) {
+    if (_m64)
+        return plcrash_async_dwarf_fde_info_init<uint64_t>(fde_info, _mobj, _byteorder, cfi_entry, _debug_frame);
+    else
+        return plcrash_async_dwarf_fde_info_init<uint32_t>(fde_info, _mobj, _byteorder, cfi_entry, _debug_frame);
+}
+
+/**
+ * Locate the entry for @a pc within @a fde_index. If multiple FDEs cover @a pc, the entry that appears first in
+ * the section is returned, matching the result of a linear scan of the section.
+ *
+ * @param fde_index The FDE look-up table to search.
+ * @param pc The PC value to search for.
+ *
+ * @return Returns the matching entry, or NULL if no entry covers @a pc.
+ */
+const plcrash_async_dwarf_fde_index_entry_t *dwarf_frame_reader::find_fde_index_entry (const plcrash_async_dwarf_fde_index_t *fde_index, pl_vm_address_t pc) {
+    const plcrash_async_dwarf_fde_index_entry_t *entries = fde_index->entries;
+    const plcrash_async_dwarf_fde_index_entry_t *found = NULL;
+    uint32_t lower = 0;
+    uint32_t upper = fde_index->count;
+
+    /* Find the first entry starting after pc */
+    while (lower < upper) {
+        uint32_t mid = lower + (upper - lower) / 2;
+        if (entries[mid].pc_start <= pc)
+            lower = mid + 1;
+        else
+            upper = mid;
+    }
+
+    /* Every preceding entry starts at or before pc; walk back until no earlier entry can extend past pc. Without
+     * overlapping FDEs, only the closest preceding entry is examined. */
+    for (uint32_t i = lower; i > 0 && pc < entries[i - 1].pc_end_max; i--) {
+        const plcrash_async_dwarf_fde_index_entry_t *entry = &entries[i - 1];
+        if (pc < entry->pc_end && (found == NULL || entry->offset < found->offset))
+            found = entry;
+    }
+
+    return found;
+}
+
+/**
+ * Locate the frame descriptor entry for @a pc using the reader's FDE look-up table.
+ *
+ * @param pc The PC value to search for.
+ * @param fde_info If the FDE is found, will be initialized with the FDE data.
+ */
+plcrash_error_t dwarf_frame_reader::find_indexed_fde (pl_vm_address_t pc, plcrash_async_dwarf_fde_info_t *fde_info) {
+    plcrash_error_t err;
+
+    const plcrash_async_dwarf_fde_index_entry_t *entry = find_fde_index_entry(_fde_index, pc);
+    if (entry == NULL)
+        return PLCRASH_ENOTFOUND;
+
+    pl_vm_address_t cfi_entry;
+    if (!plcrash_async_address_apply_offset(plcrash_async_mobject_base_address(_mobj), entry->offset, &cfi_entry)) {
+        PLCF_DEBUG("FDE index offset overflows the mobject's base address");
+        return PLCRASH_EINVAL;
+    }
+
+    /* Re-validate the entry against the section data */
+    if ((err = read_fde(cfi_entry, fde_info)) != PLCRASH_ESUCCESS)
+        return err;
+
+    if (pc >= fde_info->pc_start && pc < fde_info->pc_end)
+        return PLCRASH_ESUCCESS;
+
+    plcrash_async_dwarf_fde_info_free(fde_info);
+    return PLCRASH_ENOTFOUND;
+}
+
 /**
  * Locate the frame descriptor entry for @a pc, if available.
  *
+ * If the reader was initialized with a FDE look-up table and no @a offset hint is supplied, the table is binary
+ * searched. Otherwise, the section's entries are scanned linearly from @a offset.
+ *
  * @param offset A section-relative offset at which the FDE search will be initiated. This is primarily useful in combination with the compact unwind
  * encoding, in cases where the unwind instructions can not be expressed, and instead a FDE offset is provided by the encoding. Pass an offset of 0
  * to begin searching at the beginning of the unwind data.
@@ -86,11 +262,14 @@ plcrash_error_t dwarf_frame_reader::find_fde (pl_vm_off_t offset,
                                               pl_vm_address_t pc,
                                               plcrash_async_dwarf_fde_info_t *fde_info)
 {
-    const plcrash_async_byteorder_t *byteorder = _byteorder;
     const pl_vm_address_t base_addr = plcrash_async_mobject_base_address(_mobj);
     const pl_vm_address_t end_addr = base_addr + plcrash_async_mobject_length(_mobj);
     
     plcrash_error_t err;
+
+    /* Use the look-up table, if available */
+    if (offset == 0 && _fde_index != NULL)
+        return find_indexed_fde(pc, fde_info);
     
     /* Apply the FDE offset */
     pl_vm_address_t cfi_entry = base_addr;
@@ -106,94 +285,20 @@ plcrash_error_t dwarf_frame_reader::find_fde (pl_vm_off_t offset,
     
     /* Iterate over table entries */
     while (cfi_entry < end_addr) {
-        /* Fetch the entry length (and determine wether it's 64-bit or 32-bit) */
-        uint64_t length;
-        pl_vm_size_t length_size;
-        uint8_t dwarf_word_size;
-        
-        {
-            uint32_t *length32 = (uint32_t *) plcrash_async_mobject_remap_address(_mobj, cfi_entry, 0x0, sizeof(uint32_t));
-            if (length32 == NULL) {
-                PLCF_DEBUG("The current CFI entry 0x%" PRIx64 " header lies outside the mapped range", (uint64_t) cfi_entry);
-                return PLCRASH_EINVAL;
-            }
-            
-            if (byteorder->swap32(*length32) == UINT32_MAX) {
-                uint64_t *length64 = (uint64_t *) plcrash_async_mobject_remap_address(_mobj, cfi_entry, sizeof(uint32_t), sizeof(uint64_t));
-                if (length64 == NULL) {
-                    PLCF_DEBUG("The current CFI entry 0x%" PRIx64 " header lies outside the mapped range", (uint64_t) cfi_entry);
-                    return PLCRASH_EINVAL;
-                }
-                
-                length = byteorder->swap64(*length64);
-                length_size = sizeof(uint64_t) + sizeof(uint32_t);
-                dwarf_word_size = 8; // 64-bit DWARF
-            } else {
-                length = byteorder->swap32(*length32);
-                length_size = sizeof(uint32_t);
-                dwarf_word_size = 4; // 32-bit DWARF
-            }
-        }
-        
-        /*
-         * APPLE EXTENSION
-         * Check for end marker, as per Apple's libunwind-35.1. It's unclear if this is defined by the DWARF 3 or 4 specifications; I could not
-         * find a reference to it.
-         
-         * Section 7.2.2 defines 0xfffffff0 - 0xffffffff as being reserved for extensions to the length
-         * field relative to the DWARF 2 standard. There is no explicit reference to the use of an 0 value.
-         *
-         * In section 7.2.1, the value of 0 is defined as being reserved as an error value in the encodings for
-         * "attribute names, attribute forms, base type encodings, location operations, languages, line number program
-         * opcodes, macro information entries and tag names to represent an error condition or unknown value."
-         *
-         * Section 7.2.2 doesn't justify the usage of 0x0 as a termination marker, but given that Apple's code relies on it,
-         * we will also do so here.
-         */
-        if (length == 0x0)
-            return PLCRASH_ENOTFOUND;
-        
-        /* Calculate the next entry address; the length_size addition is known-safe, as we were able to successfully read the length from *cfi_entry */
         pl_vm_address_t next_cfi_entry;
-        if (!plcrash_async_address_apply_offset(cfi_entry+length_size, length, &next_cfi_entry)) {
-            PLCF_DEBUG("Entry length size overflows the CFI address");
-            return PLCRASH_EINVAL;
-        }
-        
-        /* Fetch the entry id */
-        uint64_t cie_id;
+        bool is_fde;
+
+        if ((err = read_entry(cfi_entry, &next_cfi_entry, &is_fde)) != PLCRASH_ESUCCESS)
+            return err;
         
-        if ((err = plcrash_async_dwarf_read_uintmax64(_mobj, byteorder, cfi_entry, length_size, dwarf_word_size, &cie_id)) != PLCRASH_ESUCCESS) {
-            PLCF_DEBUG("The current CFI entry 0x%" PRIx64 " cie_id lies outside the mapped range", (uint64_t) cfi_entry);
-            return PLCRASH_EINVAL;
-        }
-        
-        /* Check for (and skip) CIE entries. */
-        {
-            bool is_cie = false;
-            
-            /* debug_frame uses UINT?_MAX to denote CIE entries. */
-            if (_debug_frame && ((dwarf_word_size == 8 && cie_id == UINT64_MAX) || (dwarf_word_size == 4 && cie_id == UINT32_MAX)))
-                is_cie = true;
-            
-            /* eh_frame uses a type of 0x0 to denote CIE entries. */
-            if (!_debug_frame && cie_id == 0x0)
-                is_cie = true;
-            
-            /* If not a FDE, skip */
-            if (is_cie) {
-                /* Not a FDE -- skip */
-                cfi_entry = next_cfi_entry;
-                continue;
-            }
+        /* Skip CIE entries */
+        if (!is_fde) {
+            cfi_entry = next_cfi_entry;
+            continue;
         }
         
         /* Decode the FDE */
-        if (_m64)
-            err = plcrash_async_dwarf_fde_info_init<uint64_t>(fde_info, _mobj, byteorder, cfi_entry, _debug_frame);
-        else
-            err = plcrash_async_dwarf_fde_info_init<uint32_t>(fde_info, _mobj, byteorder, cfi_entry, _debug_frame);
-        if (err != PLCRASH_ESUCCESS)
+        if ((err = read_fde(cfi_entry, fde_info)) != PLCRASH_ESUCCESS)
             return err;
         
         /* Check if our PC is within range */
@@ -201,12 +306,111 @@ plcrash_error_t dwarf_frame_reader::find_fde (pl_vm_off_t offset,
             return PLCRASH_ESUCCESS;
         
         /* Skip to the next entry */
+        plcrash_async_dwarf_fde_info_free(fde_info);
         cfi_entry = next_cfi_entry;
     }
     
     return PLCRASH_ENOTFOUND;
 }
 
+/* FDE index sort comparator */
+static int fde_index_compare (const void *a, const void *b) {
+    const plcrash_async_dwarf_fde_index_entry_t *lhs = (const plcrash_async_dwarf_fde_index_entry_t *) a;
+    const plcrash_async_dwarf_fde_index_entry_t *rhs = (const plcrash_async_dwarf_fde_index_entry_t *) b;
+
+    if (lhs->pc_start < rhs->pc_start)
+        return -1;
+    else if (lhs->pc_start > rhs->pc_start)
+        return 1;
+
+    /* Preserve section order for equal start addresses, matching the linear scan */
+    if (lhs->offset < rhs->offset)
+        return -1;
+    else if (lhs->offset > rhs->offset)
+        return 1;
+
+    return 0;
+}
+
+/**
+ * Build a look-up table of all FDEs within the reader's section, sorted by pc_start, for use with subsequent
+ * readers of the same section (see init()).
+ *
+ * @param max_bytes The maximum number of bytes that may be allocated for the table, or 0 for no limit.
+ * @param fde_index On success, will be set to the newly allocated table. The caller is responsible for releasing
+ * the table via free().
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOMEM if the table would exceed @a max_bytes or could not be
+ * allocated, or an appropriate error value if the section could not be parsed.
+ *
+ * @warning This method is not async safe.
+ */
+plcrash_error_t dwarf_frame_reader::build_fde_index (size_t max_bytes, plcrash_async_dwarf_fde_index_t **fde_index) {
+    const pl_vm_address_t base_addr = plcrash_async_mobject_base_address(_mobj);
+    const pl_vm_address_t end_addr = base_addr + plcrash_async_mobject_length(_mobj);
+    pl_vm_address_t cfi_entry;
+    pl_vm_address_t next_cfi_entry;
+    plcrash_error_t err;
+    uint32_t count = 0;
+    bool is_fde;
+
+    /* Count the entries */
+    for (cfi_entry = base_addr; cfi_entry < end_addr; cfi_entry = next_cfi_entry) {
+        if ((err = read_entry(cfi_entry, &next_cfi_entry, &is_fde)) == PLCRASH_ENOTFOUND)
+            break;
+        else if (err != PLCRASH_ESUCCESS)
+            return err;
+
+        if (is_fde)
+            count++;
+    }
+
+    size_t alloc_size = sizeof(plcrash_async_dwarf_fde_index_t) + sizeof(plcrash_async_dwarf_fde_index_entry_t) * count;
+    if (max_bytes != 0 && alloc_size > max_bytes) {
+        PLCF_DEBUG("FDE index requires %zu bytes, exceeding the limit of %zu bytes", alloc_size, max_bytes);
+        return PLCRASH_ENOMEM;
+    }
+
+    plcrash_async_dwarf_fde_index_t *idx = (plcrash_async_dwarf_fde_index_t *) malloc(alloc_size);
+    if (idx == NULL)
+        return PLCRASH_ENOMEM;
+
+    /* Decode the FDEs; entries that can not be decoded are left to the linear scan's error handling, and omitted. */
+    uint32_t used = 0;
+    for (cfi_entry = base_addr; cfi_entry < end_addr && used < count; cfi_entry = next_cfi_entry) {
+        if (read_entry(cfi_entry, &next_cfi_entry, &is_fde) != PLCRASH_ESUCCESS)
+            break;
+
+        if (!is_fde)
+            continue;
+
+        plcrash_async_dwarf_fde_info_t fde_info;
+        if (read_fde(cfi_entry, &fde_info) != PLCRASH_ESUCCESS)
+            continue;
+
+        idx->entries[used].pc_start = fde_info.pc_start;
+        idx->entries[used].pc_end = fde_info.pc_end;
+        idx->entries[used].offset = (pl_vm_off_t) (cfi_entry - base_addr);
+        used++;
+
+        plcrash_async_dwarf_fde_info_free(&fde_info);
+    }
+
+    idx->count = used;
+    qsort(idx->entries, used, sizeof(idx->entries[0]), fde_index_compare);
+
+    /* Record the running maximum end address, bounding the search for overlapping FDEs */
+    uint64_t pc_end_max = 0;
+    for (uint32_t i = 0; i < used; i++) {
+        if (idx->entries[i].pc_end > pc_end_max)
+            pc_end_max = idx->entries[i].pc_end;
+        idx->entries[i].pc_end_max = pc_end_max;
+    }
+
+    *fde_index = idx;
+    return PLCRASH_ESUCCESS;
+}
+
 /**
  * @}
  */
@@ -48,6 +48,40 @@ namespace async {
  * @{
  */
 
+/**
+ * @internal
+ *
+ * An entry in a sorted FDE look-up table.
+ */
+typedef struct plcrash_async_dwarf_fde_index_entry {
+    /** The start of the IP range covered by the FDE, as the in-memory load address. */
+    uint64_t pc_start;
+
+    /** The end of the IP range covered by the FDE (exclusive). */
+    uint64_t pc_end;
+
+    /** The offset of the FDE's initial length field, relative to the eh_frame/debug_frame section base. */
+    pl_vm_off_t offset;
+
+    /** The maximum pc_end of this entry and all preceding entries, bounding the search for overlapping FDEs. */
+    uint64_t pc_end_max;
+} plcrash_async_dwarf_fde_index_entry_t;
+
+/**
+ * @internal
+ *
+ * A look-up table of the FDEs within an eh_frame/debug_frame section, sorted by pc_start. As with the Mach-O
+ * symbol index, the entry count and entries are allocated together, allowing the table to be published to async-safe
+ * readers via a single atomic pointer swap.
+ */
+typedef struct plcrash_async_dwarf_fde_index {
+    /** The number of entries. */
+    uint32_t count;
+
+    /** The table entries, sorted by pc_start. */
+    plcrash_async_dwarf_fde_index_entry_t entries[];
+} plcrash_async_dwarf_fde_index_t;
+
 /**
  * @internal
  *
@@ -58,13 +92,24 @@ public:
     plcrash_error_t init (plcrash_async_mobject_t *mobj,
                           const plcrash_async_byteorder_t *byteorder,
                           bool m64,
-                          bool debug_frame);
+                          bool debug_frame,
+                          const plcrash_async_dwarf_fde_index_t *fde_index = NULL);
     
     plcrash_error_t find_fde (pl_vm_off_t offset,
                               pl_vm_address_t pc,
                               plcrash_async_dwarf_fde_info_t *fde_info);
 
+    plcrash_error_t build_fde_index (size_t max_bytes, plcrash_async_dwarf_fde_index_t **fde_index);
+
+    static const plcrash_async_dwarf_fde_index_entry_t *find_fde_index_entry (const plcrash_async_dwarf_fde_index_t *fde_index, pl_vm_address_t pc);
+
 private:
+    plcrash_error_t read_entry (pl_vm_address_t cfi_entry, pl_vm_address_t *next_cfi_entry, bool *is_fde);
+
+    plcrash_error_t read_fde (pl_vm_address_t cfi_entry, plcrash_async_dwarf_fde_info_t *fde_info);
+
+    plcrash_error_t find_indexed_fde (pl_vm_address_t pc, plcrash_async_dwarf_fde_info_t *fde_info);
+
     /** A memory object containing the DWARF data at the starting address. */
     plcrash_async_mobject_t *_mobj;
     
@@ -76,6 +121,9 @@ private:
     
     /** True if this is a debug_frame section */
     bool _debug_frame;
+
+    /** An optional sorted FDE look-up table for the section, or NULL. */
+    const plcrash_async_dwarf_fde_index_t *_fde_index;
 };
     
 PLCR_CPP_END_NS
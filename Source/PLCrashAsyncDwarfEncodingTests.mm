@@ -179,6 +179,94 @@ using namespace plcrash::async;
     STAssertEquals(PLCRASH_ENOTFOUND, err, @"FDE should not have been found");
 }
 
+/* Verify that FDE lookups via a FDE look-up table match the linear scan results */
+- (void) testFindIndexedFrameDescriptorEntry {
+    const plcrash_async_byteorder_t *byteorder = plcrash_async_macho_byteorder(&_image);
+    plcrash_async_dwarf_fde_index_t *eh_index;
+    plcrash_async_dwarf_fde_index_t *debug_index;
+    plcrash_async_dwarf_fde_info_t fde_info;
+    dwarf_frame_reader eh_reader;
+    dwarf_frame_reader debug_reader;
+    plcrash_error_t err;
+
+    STAssertEquals(PLCRASH_ESUCCESS, _eh_reader.build_fde_index(0, &eh_index), @"Failed to build eh_frame index");
+    STAssertEquals(PLCRASH_ESUCCESS, _debug_reader.build_fde_index(0, &debug_index), @"Failed to build debug_frame index");
+    STAssertTrue(eh_index->count > 0, @"No eh_frame FDEs were indexed");
+    STAssertTrue(debug_index->count > 0, @"No debug_frame FDEs were indexed");
+
+    /* Verify that the memory limit is respected */
+    plcrash_async_dwarf_fde_index_t *limited;
+    STAssertEquals(PLCRASH_ENOMEM, _eh_reader.build_fde_index(1, &limited), @"Memory limit was ignored");
+
+    STAssertEquals(PLCRASH_ESUCCESS, eh_reader.init(&_eh_frame, byteorder, _m64, false, eh_index), @"Failed to initialize reader");
+    STAssertEquals(PLCRASH_ESUCCESS, debug_reader.init(&_debug_frame, byteorder, _m64, true, debug_index), @"Failed to initialize reader");
+
+    /* eh_frame */
+    err = eh_reader.find_fde(0x0, PL_CFI_EH_FRAME_PC+PL_CFI_EH_FRAME_PC_RANGE-1, &fde_info);
+    STAssertEquals(PLCRASH_ESUCCESS, err, @"FDE search failed");
+    if (_m64) {
+        STAssertEquals(fde_info.fde_offset, (pl_vm_address_t) ((sizeof(pl_cfi_entry)) + PL_CFI_LEN_SIZE_64), @"Incorrect offset");
+    } else {
+        STAssertEquals(fde_info.fde_offset, (pl_vm_address_t) ((sizeof(pl_cfi_entry)) + PL_CFI_LEN_SIZE_32), @"Incorrect offset");
+    }
+    plcrash_async_dwarf_fde_info_free(&fde_info);
+
+    err = eh_reader.find_fde(0x0, PL_CFI_EH_FRAME_PC+PL_CFI_EH_FRAME_PC_RANGE, &fde_info);
+    STAssertEquals(PLCRASH_ENOTFOUND, err, @"FDE should not have been found");
+
+    /* debug_frame */
+    err = debug_reader.find_fde(0x0, PL_CFI_DEBUG_FRAME_PC+PL_CFI_DEBUG_FRAME_PC_RANGE-1, &fde_info);
+    STAssertEquals(PLCRASH_ESUCCESS, err, @"FDE search failed");
+    if (_m64) {
+        STAssertEquals(fde_info.fde_offset, (pl_vm_address_t) ((sizeof(pl_cfi_entry)) + PL_CFI_LEN_SIZE_64), @"Incorrect offset");
+    } else {
+        STAssertEquals(fde_info.fde_offset, (pl_vm_address_t) ((sizeof(pl_cfi_entry)) + PL_CFI_LEN_SIZE_32), @"Incorrect offset");
+    }
+    plcrash_async_dwarf_fde_info_free(&fde_info);
+
+    err = debug_reader.find_fde(0x0, PL_CFI_DEBUG_FRAME_PC+PL_CFI_DEBUG_FRAME_PC_RANGE, &fde_info);
+    STAssertEquals(PLCRASH_ENOTFOUND, err, @"FDE should not have been found");
+
+    free(eh_index);
+    free(debug_index);
+}
+
+/* Populate a hand-built FDE look-up table entry */
+static void set_fde_index_entry (plcrash_async_dwarf_fde_index_entry_t *entry, uint64_t pc_start, uint64_t pc_end, pl_vm_off_t offset, uint64_t pc_end_max) {
+    entry->pc_start = pc_start;
+    entry->pc_end = pc_end;
+    entry->offset = offset;
+    entry->pc_end_max = pc_end_max;
+}
+
+/* Verify that overlapping FDEs are resolved to the first covering FDE in section order, matching the linear scan */
+- (void) testFindOverlappingIndexedFrameDescriptorEntry {
+    const size_t count = 3;
+    plcrash_async_dwarf_fde_index_t *idx = (plcrash_async_dwarf_fde_index_t *) malloc(sizeof(*idx) + sizeof(idx->entries[0]) * count);
+    idx->count = count;
+
+    /* An FDE nested within an earlier, larger FDE that follows it in the section, and a disjoint FDE */
+    set_fde_index_entry(&idx->entries[0], 0x100, 0x200, 0x40, 0x200);
+    set_fde_index_entry(&idx->entries[1], 0x150, 0x160, 0x10, 0x200);
+    set_fde_index_entry(&idx->entries[2], 0x300, 0x310, 0x80, 0x310);
+
+    /* Covered by both; the nested FDE appears first in the section */
+    const plcrash_async_dwarf_fde_index_entry_t *entry = dwarf_frame_reader::find_fde_index_entry(idx, 0x155);
+    STAssertTrue(entry == &idx->entries[1], @"Incorrect FDE for overlapping ranges");
+
+    /* Past the nested FDE, but within the enclosing FDE */
+    entry = dwarf_frame_reader::find_fde_index_entry(idx, 0x180);
+    STAssertTrue(entry == &idx->entries[0], @"Enclosing FDE was not found");
+
+    entry = dwarf_frame_reader::find_fde_index_entry(idx, 0x305);
+    STAssertTrue(entry == &idx->entries[2], @"Disjoint FDE was not found");
+
+    STAssertNULL(dwarf_frame_reader::find_fde_index_entry(idx, 0x50), @"FDE should not have been found");
+    STAssertNULL(dwarf_frame_reader::find_fde_index_entry(idx, 0x250), @"FDE should not have been found");
+
+    free(idx);
+}
+
 @end
 
 #endif /* PLCRASH_FEATURE_UNWIND_DWARF */
@@ -704,6 +704,676 @@ plcrash_error_t plcrash_async_dwarf_expression_eval (plcrash_async_mobject_t *mo
     return PLCRASH_ESUCCESS;
 }
 
+/**
+ * @internal
+ *
+ * Internal operation codes used by decoded expression programs. Opcodes that differ only in their operand encoding
+ * (eg, DW_OP_lit*, DW_OP_const*) are decoded to a single operation.
+ */
+typedef enum {
+    DW_EXPR_OP_END = 0,
+    DW_EXPR_OP_PUSH,
+    DW_EXPR_OP_BREG,
+    DW_EXPR_OP_DUP,
+    DW_EXPR_OP_DROP,
+    DW_EXPR_OP_PICK,
+    DW_EXPR_OP_SWAP,
+    DW_EXPR_OP_ROT,
+    DW_EXPR_OP_XDEREF,
+    DW_EXPR_OP_DEREF,
+    DW_EXPR_OP_XDEREF_SIZE,
+    DW_EXPR_OP_DEREF_SIZE,
+    DW_EXPR_OP_ABS,
+    DW_EXPR_OP_AND,
+    DW_EXPR_OP_DIV,
+    DW_EXPR_OP_MINUS,
+    DW_EXPR_OP_MOD,
+    DW_EXPR_OP_MUL,
+    DW_EXPR_OP_NEG,
+    DW_EXPR_OP_NOT,
+    DW_EXPR_OP_OR,
+    DW_EXPR_OP_PLUS,
+    DW_EXPR_OP_PLUS_UCONST,
+    DW_EXPR_OP_SHL,
+    DW_EXPR_OP_SHR,
+    DW_EXPR_OP_SHRA,
+    DW_EXPR_OP_XOR,
+    DW_EXPR_OP_LE,
+    DW_EXPR_OP_GE,
+    DW_EXPR_OP_EQ,
+    DW_EXPR_OP_LT,
+    DW_EXPR_OP_GT,
+    DW_EXPR_OP_NE,
+    DW_EXPR_OP_SKIP,
+    DW_EXPR_OP_BRA,
+    DW_EXPR_OP_NOP,
+
+    /** The number of defined operations. */
+    DW_EXPR_OP_COUNT
+} dwarf_expression_op_t;
+
+/**
+ * Decode a DWARF expression into a program that may be executed via plcrash_async_dwarf_expression_exec().
+ *
+ * All operands are read and validated, and all branch targets are resolved to instruction indices. Decoding
+ * fails for any expression that plcrash_async_dwarf_expression_eval() could not evaluate in full, including
+ * expressions containing unsupported opcodes, or branches into the middle of an instruction; such expressions
+ * must be evaluated via plcrash_async_dwarf_expression_eval(), which will only report an error if the offending
+ * instruction is actually reached.
+ *
+ * @param mobj The memory object from which the expression opcodes will be read.
+ * @param byteorder The byte order of the data referenced by @a mobj.
+ * @param address The task-relative address within @a mobj at which the opcodes will be fetched.
+ * @param length The total length of the opcodes readable at @a address.
+ * @param[out] program On success, the decoded program.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTSUP if the expression contains an unsupported opcode or
+ * exceeds PLCRASH_ASYNC_DWARF_EXPRESSION_MAX_INSNS instructions, or PLCRASH_EINVAL if the expression is malformed.
+ */
+template <typename machine_ptr, typename machine_ptr_s>
+plcrash_error_t plcrash_async_dwarf_expression_decode (plcrash_async_mobject_t *mobj,
+                                                       const plcrash_async_byteorder_t *byteorder,
+                                                       pl_vm_address_t address,
+                                                       pl_vm_size_t length,
+                                                       plcrash_async_dwarf_expression_program_t *program)
+{
+    /* The opstream position at which each instruction begins, and the unresolved branch target position of
+     * each instruction */
+    uintptr_t starts[PLCRASH_ASYNC_DWARF_EXPRESSION_MAX_INSNS];
+    uintptr_t branch_positions[PLCRASH_ASYNC_DWARF_EXPRESSION_MAX_INSNS];
+    dwarf_opstream opstream;
+    plcrash_error_t err;
+    uint8_t count = 0;
+
+    program->valid = false;
+
+    if ((err = opstream.init(mobj, byteorder, address, 0, length)) != PLCRASH_ESUCCESS)
+        return err;
+
+    /* Decode all instructions, leaving room for the terminating instruction */
+    uint8_t opcode;
+    uintptr_t start = opstream.get_position();
+    while (opstream.read_intU(&opcode)) {
+        if (count == PLCRASH_ASYNC_DWARF_EXPRESSION_MAX_INSNS - 1) {
+            PLCF_DEBUG("Expression exceeds the maximum of %d decoded instructions", PLCRASH_ASYNC_DWARF_EXPRESSION_MAX_INSNS);
+            return PLCRASH_ENOTSUP;
+        }
+
+        plcrash_async_dwarf_expression_insn_t *insn = &program->insns[count];
+        insn->size = 0;
+        insn->target = 0;
+        insn->regnum = 0;
+        insn->operand = 0;
+
+        if (opcode >= DW_OP_lit0 && opcode <= DW_OP_lit31) {
+            insn->op = DW_EXPR_OP_PUSH;
+            insn->operand = opcode - DW_OP_lit0;
+        } else if (opcode >= DW_OP_breg0 && opcode <= DW_OP_breg31) {
+            insn->op = DW_EXPR_OP_BREG;
+            insn->regnum = opcode - DW_OP_breg0;
+            insn->operand = (uint64_t) (int64_t) dw_expr_read_sleb128();
+        } else {
+            switch (opcode) {
+                case DW_OP_const1u:
+                    insn->op = DW_EXPR_OP_PUSH;
+                    insn->operand = dw_expr_read_int(uint8_t);
+                    break;
+                case DW_OP_const1s:
+                    insn->op = DW_EXPR_OP_PUSH;
+                    insn->operand = (uint64_t) (int64_t) dw_expr_read_int(int8_t);
+                    break;
+                case DW_OP_const2u:
+                    insn->op = DW_EXPR_OP_PUSH;
+                    insn->operand = dw_expr_read_int(uint16_t);
+                    break;
+                case DW_OP_const2s:
+                    insn->op = DW_EXPR_OP_PUSH;
+                    insn->operand = (uint64_t) (int64_t) dw_expr_read_int(int16_t);
+                    break;
+                case DW_OP_const4u:
+                    insn->op = DW_EXPR_OP_PUSH;
+                    insn->operand = dw_expr_read_int(uint32_t);
+                    break;
+                case DW_OP_const4s:
+                    insn->op = DW_EXPR_OP_PUSH;
+                    insn->operand = (uint64_t) (int64_t) dw_expr_read_int(int32_t);
+                    break;
+                case DW_OP_const8u:
+                    insn->op = DW_EXPR_OP_PUSH;
+                    insn->operand = dw_expr_read_int(uint64_t);
+                    break;
+                case DW_OP_const8s:
+                    insn->op = DW_EXPR_OP_PUSH;
+                    insn->operand = (uint64_t) dw_expr_read_int(int64_t);
+                    break;
+                case DW_OP_constu:
+                    insn->op = DW_EXPR_OP_PUSH;
+                    insn->operand = dw_expr_read_uleb128();
+                    break;
+                case DW_OP_consts:
+                    insn->op = DW_EXPR_OP_PUSH;
+                    insn->operand = (uint64_t) (int64_t) dw_expr_read_sleb128();
+                    break;
+                case DW_OP_bregx: {
+                    uint64_t regnum = dw_expr_read_uleb128();
+                    if (regnum > UINT32_MAX) {
+                        PLCF_DEBUG("Unsupported DWARF register value of 0x%" PRIx64, regnum);
+                        return PLCRASH_ENOTSUP;
+                    }
+                    insn->op = DW_EXPR_OP_BREG;
+                    insn->regnum = (uint32_t) regnum;
+                    insn->operand = (uint64_t) (int64_t) dw_expr_read_sleb128();
+                    break;
+                }
+                case DW_OP_pick:
+                    insn->op = DW_EXPR_OP_PICK;
+                    insn->size = dw_expr_read_int(uint8_t);
+                    break;
+                case DW_OP_over:
+                    insn->op = DW_EXPR_OP_PICK;
+                    insn->size = 1;
+                    break;
+                case DW_OP_xderef_size:
+                case DW_OP_deref_size:
+                    insn->op = (opcode == DW_OP_deref_size) ? DW_EXPR_OP_DEREF_SIZE : DW_EXPR_OP_XDEREF_SIZE;
+                    insn->size = dw_expr_read_int(uint8_t);
+                    if (insn->size != 1 && insn->size != 2 && insn->size != 4 && insn->size != 8) {
+                        PLCF_DEBUG("DW_OP_deref_size specified an unsupported size of %" PRIu8, insn->size);
+                        return PLCRASH_EINVAL;
+                    } else if (insn->size > sizeof(machine_ptr)) {
+                        PLCF_DEBUG("DW_OP_deref_size specified a size larger than the native machine word");
+                        return PLCRASH_EINVAL;
+                    }
+                    break;
+                case DW_OP_plus_uconst:
+                    insn->op = DW_EXPR_OP_PLUS_UCONST;
+                    insn->operand = dw_expr_read_uleb128();
+                    break;
+                case DW_OP_skip:
+                case DW_OP_bra: {
+                    int16_t skipOffset = dw_expr_read_int(int16_t);
+                    insn->op = (opcode == DW_OP_skip) ? DW_EXPR_OP_SKIP : DW_EXPR_OP_BRA;
+
+                    /* Validate the target position; it will be resolved to an instruction index once all instructions have been decoded */
+                    if (!opstream.skip(skipOffset)) {
+                        PLCF_DEBUG("DW_OP_skip/bra offset %" PRId16 " falls outside of opcode range", skipOffset);
+                        return PLCRASH_EINVAL;
+                    }
+                    branch_positions[count] = opstream.get_position();
+                    opstream.skip(-skipOffset);
+                    break;
+                }
+
+                /* Opcodes without operands */
+                case DW_OP_dup:     insn->op = DW_EXPR_OP_DUP; break;
+                case DW_OP_drop:    insn->op = DW_EXPR_OP_DROP; break;
+                case DW_OP_swap:    insn->op = DW_EXPR_OP_SWAP; break;
+                case DW_OP_rot:     insn->op = DW_EXPR_OP_ROT; break;
+                case DW_OP_xderef:  insn->op = DW_EXPR_OP_XDEREF; break;
+                case DW_OP_deref:   insn->op = DW_EXPR_OP_DEREF; break;
+                case DW_OP_abs:     insn->op = DW_EXPR_OP_ABS; break;
+                case DW_OP_and:     insn->op = DW_EXPR_OP_AND; break;
+                case DW_OP_div:     insn->op = DW_EXPR_OP_DIV; break;
+                case DW_OP_minus:   insn->op = DW_EXPR_OP_MINUS; break;
+                case DW_OP_mod:     insn->op = DW_EXPR_OP_MOD; break;
+                case DW_OP_mul:     insn->op = DW_EXPR_OP_MUL; break;
+                case DW_OP_neg:     insn->op = DW_EXPR_OP_NEG; break;
+                case DW_OP_not:     insn->op = DW_EXPR_OP_NOT; break;
+                case DW_OP_or:      insn->op = DW_EXPR_OP_OR; break;
+                case DW_OP_plus:    insn->op = DW_EXPR_OP_PLUS; break;
+                case DW_OP_shl:     insn->op = DW_EXPR_OP_SHL; break;
+                case DW_OP_shr:     insn->op = DW_EXPR_OP_SHR; break;
+                case DW_OP_shra:    insn->op = DW_EXPR_OP_SHRA; break;
+                case DW_OP_xor:     insn->op = DW_EXPR_OP_XOR; break;
+                case DW_OP_le:      insn->op = DW_EXPR_OP_LE; break;
+                case DW_OP_ge:      insn->op = DW_EXPR_OP_GE; break;
+                case DW_OP_eq:      insn->op = DW_EXPR_OP_EQ; break;
+                case DW_OP_lt:      insn->op = DW_EXPR_OP_LT; break;
+                case DW_OP_gt:      insn->op = DW_EXPR_OP_GT; break;
+                case DW_OP_ne:      insn->op = DW_EXPR_OP_NE; break;
+                case DW_OP_nop:     insn->op = DW_EXPR_OP_NOP; break;
+
+                default:
+                    PLCF_DEBUG("Unsupported opcode 0x%" PRIx8, opcode);
+                    return PLCRASH_ENOTSUP;
+            }
+        }
+
+        starts[count++] = start;
+        start = opstream.get_position();
+    }
+
+    /* Append the terminating instruction; it begins at the end of the opcode stream */
+    program->insns[count].op = DW_EXPR_OP_END;
+    starts[count++] = start;
+
+    /* Resolve branch targets */
+    for (uint8_t i = 0; i < count; i++) {
+        plcrash_async_dwarf_expression_insn_t *insn = &program->insns[i];
+        if (insn->op != DW_EXPR_OP_SKIP && insn->op != DW_EXPR_OP_BRA)
+            continue;
+
+        bool found = false;
+        for (uint8_t j = 0; j < count; j++) {
+            if (starts[j] == branch_positions[i]) {
+                insn->target = j;
+                found = true;
+                break;
+            }
+        }
+
+        if (!found) {
+            PLCF_DEBUG("DW_OP_skip/bra target does not fall on an instruction boundary");
+            return PLCRASH_EINVAL;
+        }
+    }
+
+    program->count = count;
+    program->address = address;
+    program->length = length;
+    program->valid = true;
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Execute a DWARF expression program decoded by plcrash_async_dwarf_expression_decode(). The result is identical
+ * to that of evaluating the original expression via plcrash_async_dwarf_expression_eval().
+ *
+ * @param program The decoded program.
+ * @param task The task from which any DWARF expression memory loads will be performed.
+ * @param thread_state The thread state against which the expression will be evaluated.
+ * @param initial_state Initial set of values to be pushed onto the evaluation stack, as per
+ * plcrash_async_dwarf_expression_eval().
+ * @param initial_count Number of values in the @a initial_state array.
+ * @param[out] result On success, the evaluation result.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or an appropriate plcrash_error_t values on failure.
+ */
+template <typename machine_ptr, typename machine_ptr_s>
+plcrash_error_t plcrash_async_dwarf_expression_exec (const plcrash_async_dwarf_expression_program_t *program,
+                                                     task_t task,
+                                                     const plcrash_async_thread_state_t *thread_state,
+                                                     machine_ptr initial_state[],
+                                                     size_t initial_count,
+                                                     machine_ptr *result)
+{
+    dwarf_stack<machine_ptr, 100> stack;
+    plcrash_error_t err;
+
+    PLCF_ASSERT(program->valid);
+
+#define dw_expr_push(v) if (!stack.push(v)) { \
+    PLCF_DEBUG("Hit stack limit; cannot push further values"); \
+    return PLCRASH_EINTERNAL; \
+}
+
+    /* Populate the initial state */
+    for (size_t i = 0; i < initial_count; i++)
+        dw_expr_push(initial_state[i]);
+
+    /*
+     * Dispatch directly from each instruction to the next via the operation's label address; all operands and branch
+     * targets were validated when the program was decoded, and the program is always terminated by DW_EXPR_OP_END.
+     *
+     * The table must be maintained in dwarf_expression_op_t order.
+     */
+    static const void *dispatch[] = {
+        &&op_end,
+        &&op_push,
+        &&op_breg,
+        &&op_dup,
+        &&op_drop,
+        &&op_pick,
+        &&op_swap,
+        &&op_rot,
+        &&op_xderef,
+        &&op_deref,
+        &&op_xderef_size,
+        &&op_deref_size,
+        &&op_abs,
+        &&op_and,
+        &&op_div,
+        &&op_minus,
+        &&op_mod,
+        &&op_mul,
+        &&op_neg,
+        &&op_not,
+        &&op_or,
+        &&op_plus,
+        &&op_plus_uconst,
+        &&op_shl,
+        &&op_shr,
+        &&op_shra,
+        &&op_xor,
+        &&op_le,
+        &&op_ge,
+        &&op_eq,
+        &&op_lt,
+        &&op_gt,
+        &&op_ne,
+        &&op_skip,
+        &&op_bra,
+        &&op_nop,
+    };
+    PLCR_ASSERT_STATIC(dispatch_table_size, sizeof(dispatch) / sizeof(dispatch[0]) == DW_EXPR_OP_COUNT);
+
+    const plcrash_async_dwarf_expression_insn_t *insn = &program->insns[0];
+    machine_ptr v1, v2;
+
+    /* Advance to and dispatch the next instruction */
+#define dw_expr_next() do { insn++; goto *dispatch[insn->op]; } while (0)
+
+    /* Pop two values, and push the result of applying @a expr to them; v1 is the top-most value */
+#define dw_expr_binary_op(expr) do { \
+    dw_expr_pop(&v1); \
+    dw_expr_pop(&v2); \
+    dw_expr_push(expr); \
+    dw_expr_next(); \
+} while (0)
+
+    goto *dispatch[insn->op];
+
+op_push:
+    dw_expr_push((machine_ptr) insn->operand);
+    dw_expr_next();
+
+op_breg:
+    dw_expr_push(dw_thread_regval(insn->regnum) + (machine_ptr) insn->operand);
+    dw_expr_next();
+
+op_dup:
+    if (!stack.dup()) {
+        PLCF_DEBUG("DW_OP_dup on an empty stack");
+        return PLCRASH_EINVAL;
+    }
+    dw_expr_next();
+
+op_drop:
+    if (!stack.drop()) {
+        PLCF_DEBUG("DW_OP_drop on an empty stack");
+        return PLCRASH_EINVAL;
+    }
+    dw_expr_next();
+
+op_pick:
+    if (!stack.pick(insn->size)) {
+        PLCF_DEBUG("DW_OP_pick on invalid index");
+        return PLCRASH_EINVAL;
+    }
+    dw_expr_next();
+
+op_swap:
+    if (!stack.swap()) {
+        PLCF_DEBUG("DW_OP_swap on stack with < 2 elements");
+        return PLCRASH_EINVAL;
+    }
+    dw_expr_next();
+
+op_rot:
+    if (!stack.rotate()) {
+        PLCF_DEBUG("DW_OP_rot on stack with < 3 elements");
+        return PLCRASH_EINVAL;
+    }
+    dw_expr_next();
+
+op_xderef:
+    /* Excise the address space value; see plcrash_async_dwarf_expression_eval() */
+    if (!stack.swap()) {
+        PLCF_DEBUG("DW_OP_xderef on stack with < 2 elements");
+        return PLCRASH_EINVAL;
+    }
+    stack.drop();
+    PLCR_FALLTHROUGH;
+
+op_deref:
+    dw_expr_pop(&v1);
+    if ((err = plcrash_async_task_memcpy(task, v1, 0, &v2, sizeof(v2))) != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("DW_OP_deref referenced an invalid target address 0x%" PRIx64, (uint64_t) v1);
+        return err;
+    }
+    dw_expr_push(v2);
+    dw_expr_next();
+
+op_xderef_size:
+    /* Excise the address space value; see plcrash_async_dwarf_expression_eval() */
+    if (!stack.swap()) {
+        PLCF_DEBUG("DW_OP_xderef_size on stack with < 2 elements");
+        return PLCRASH_EINVAL;
+    }
+    stack.drop();
+    PLCR_FALLTHROUGH;
+
+op_deref_size: {
+    dw_expr_pop(&v1);
+
+    /* The size was validated when decoded */
+    uint64_t value = 0;
+    union {
+        uint8_t v8;
+        uint16_t v16;
+        uint32_t v32;
+        uint64_t v64;
+    } r;
+    if ((err = plcrash_async_task_memcpy(task, (pl_vm_address_t) v1, 0, &r, insn->size)) != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("DW_OP_deref_size referenced an invalid target address 0x%" PRIx64, (uint64_t) v1);
+        return err;
+    }
+
+    switch (insn->size) {
+        case 1: value = r.v8; break;
+        case 2: value = r.v16; break;
+        case 4: value = r.v32; break;
+        case 8: value = r.v64; break;
+    }
+
+    dw_expr_push((machine_ptr) value);
+    dw_expr_next();
+}
+
+op_abs: {
+    machine_ptr_s v;
+    dw_expr_pop((machine_ptr *) &v);
+    if (v < 0) {
+        dw_expr_push(-v);
+    } else {
+        dw_expr_push(v);
+    }
+    dw_expr_next();
+}
+
+op_and:
+    dw_expr_binary_op(v1 & v2);
+
+op_div:
+    dw_expr_pop(&v1);
+    dw_expr_pop(&v2);
+    if ((machine_ptr_s) v1 == 0) {
+        PLCF_DEBUG("DW_OP_div attempted divide by zero");
+        return PLCRASH_EINVAL;
+    }
+    /* Matches the mixed signed/unsigned arithmetic of plcrash_async_dwarf_expression_eval() */
+    dw_expr_push((machine_ptr) (v2 / (machine_ptr_s) v1));
+    dw_expr_next();
+
+op_minus:
+    dw_expr_binary_op(v2 - v1);
+
+op_mod:
+    dw_expr_pop(&v1);
+    dw_expr_pop(&v2);
+    if (v1 == 0) {
+        PLCF_DEBUG("DW_OP_mod attempted divide by zero");
+        return PLCRASH_EINVAL;
+    }
+    dw_expr_push(v2 % v1);
+    dw_expr_next();
+
+op_mul:
+    dw_expr_binary_op(v1 * v2);
+
+op_neg: {
+    machine_ptr_s svalue;
+    dw_expr_pop((machine_ptr *) &svalue);
+    dw_expr_push(0 - svalue);
+    dw_expr_next();
+}
+
+op_not:
+    dw_expr_pop(&v1);
+    dw_expr_push(~v1);
+    dw_expr_next();
+
+op_or:
+    dw_expr_binary_op(v1 | v2);
+
+op_plus:
+    dw_expr_binary_op(v1 + v2);
+
+op_plus_uconst:
+    dw_expr_pop(&v2);
+    dw_expr_push(((machine_ptr) insn->operand) + v2);
+    dw_expr_next();
+
+op_shl:
+    dw_expr_binary_op(v2 << v1);
+
+op_shr:
+    dw_expr_binary_op(v2 >> v1);
+
+op_shra:
+    dw_expr_binary_op(((machine_ptr_s) v2) >> v1);
+
+op_xor:
+    dw_expr_binary_op(v1 ^ v2);
+
+op_le:
+    dw_expr_binary_op((v2 <= v1));
+
+op_ge:
+    dw_expr_binary_op((v2 >= v1));
+
+op_eq:
+    dw_expr_binary_op((v2 == v1));
+
+op_lt:
+    dw_expr_binary_op((v2 < v1));
+
+op_gt:
+    dw_expr_binary_op((v2 > v1));
+
+op_ne:
+    dw_expr_binary_op((v2 != v1));
+
+op_skip:
+    insn = &program->insns[insn->target];
+    goto *dispatch[insn->op];
+
+op_bra:
+    dw_expr_pop(&v1);
+    if (v1 != 0) {
+        insn = &program->insns[insn->target];
+        goto *dispatch[insn->op];
+    }
+    dw_expr_next();
+
+op_nop:
+    dw_expr_next();
+
+op_end:
+    /* Provide the result */
+    if (!stack.pop(result)) {
+        PLCF_DEBUG("Expression did not provide a result value.");
+        return PLCRASH_EINVAL;
+    }
+
+#undef dw_expr_binary_op
+#undef dw_expr_next
+#undef dw_expr_push
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Initialize an empty expression program cache.
+ *
+ * @param cache The cache to be initialized.
+ */
+void plcrash_async_dwarf_expression_cache_init (plcrash_async_dwarf_expression_cache_t *cache) {
+    cache->next = 0;
+    for (size_t i = 0; i < PLCRASH_ASYNC_DWARF_EXPRESSION_CACHE_SIZE; i++)
+        cache->programs[i].valid = false;
+}
+
+/**
+ * Evaluate the DWARF expression at @a address, using a decoded program from @a cache if available. If the expression
+ * has not been decoded, it will be decoded and inserted into the cache, replacing the least recently inserted
+ * program if the cache is full. Expressions that can not be decoded are evaluated via
+ * plcrash_async_dwarf_expression_eval(), and leave the cache unmodified.
+ *
+ * @param cache The program cache, or NULL to evaluate the expression without caching.
+ * @param task The task from which the expression opcodes will be mapped, and from which any DWARF expression memory
+ * loads will be performed.
+ * @param thread_state The thread state against which the expression will be evaluated.
+ * @param byteorder The byte order of the expression opcodes and @a thread_state.
+ * @param address The task-relative address of the expression opcodes.
+ * @param length The total length of the expression opcodes.
+ * @param initial_state Initial set of values to be pushed onto the evaluation stack, as per
+ * plcrash_async_dwarf_expression_eval().
+ * @param initial_count Number of values in the @a initial_state array.
+ * @param[out] result On success, the evaluation result.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or an appropriate plcrash_error_t values on failure.
+ */
+template <typename machine_ptr, typename machine_ptr_s>
+plcrash_error_t plcrash_async_dwarf_expression_eval_cached (plcrash_async_dwarf_expression_cache_t *cache,
+                                                            task_t task,
+                                                            const plcrash_async_thread_state_t *thread_state,
+                                                            const plcrash_async_byteorder_t *byteorder,
+                                                            pl_vm_address_t address,
+                                                            pl_vm_size_t length,
+                                                            machine_ptr initial_state[],
+                                                            size_t initial_count,
+                                                            machine_ptr *result)
+{
+    plcrash_async_mobject_t mobj;
+    plcrash_error_t err;
+
+    /* Try the cache */
+    if (cache != NULL) {
+        for (size_t i = 0; i < PLCRASH_ASYNC_DWARF_EXPRESSION_CACHE_SIZE; i++) {
+            const plcrash_async_dwarf_expression_program_t *program = &cache->programs[i];
+            if (program->valid && program->address == address && program->length == length)
+                return plcrash_async_dwarf_expression_exec<machine_ptr, machine_ptr_s>(program, task, thread_state, initial_state, initial_count, result);
+        }
+    }
+
+    /* Map the expression data */
+    if ((err = plcrash_async_mobject_init(&mobj, task, address, length, true)) != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("Could not map DWARF expression range");
+        return err;
+    }
+
+    /* Decode and cache the expression, falling back on direct evaluation if it can't be decoded. The program is
+     * decoded into a temporary so that a failed decode does not evict the cached program occupying the next slot. */
+    if (cache != NULL) {
+        plcrash_async_dwarf_expression_program_t decoded;
+        if (plcrash_async_dwarf_expression_decode<machine_ptr, machine_ptr_s>(&mobj, byteorder, address, length, &decoded) == PLCRASH_ESUCCESS) {
+            plcrash_async_dwarf_expression_program_t *program = &cache->programs[cache->next];
+            plcrash_async_memcpy(program, &decoded, sizeof(*program));
+            cache->next = (cache->next + 1) % PLCRASH_ASYNC_DWARF_EXPRESSION_CACHE_SIZE;
+            plcrash_async_mobject_free(&mobj);
+
+            return plcrash_async_dwarf_expression_exec<machine_ptr, machine_ptr_s>(program, task, thread_state, initial_state, initial_count, result);
+        }
+    }
+
+    err = plcrash_async_dwarf_expression_eval<machine_ptr, machine_ptr_s>(&mobj, task, thread_state, byteorder, address, 0x0, length, initial_state, initial_count, result);
+    plcrash_async_mobject_free(&mobj);
+
+    return err;
+}
+
 /* Provide explicit 32/64-bit instantiations */
 template plcrash_error_t plcrash_async_dwarf_expression_eval<uint32_t, int32_t> (plcrash_async_mobject_t *mobj,
                                                                                  task_t task,
@@ -726,6 +1396,47 @@ template plcrash_error_t plcrash_async_dwarf_expression_eval<uint64_t, int64_t>
                                                                                  uint64_t initial_state[],
                                                                                  size_t initial_count,
                                                                                  uint64_t *result);
+
+template plcrash_error_t plcrash_async_dwarf_expression_decode<uint32_t, int32_t> (plcrash_async_mobject_t *mobj,
+                                                                                   const plcrash_async_byteorder_t *byteorder,
+                                                                                   pl_vm_address_t address,
+                                                                                   pl_vm_size_t length,
+                                                                                   plcrash_async_dwarf_expression_program_t *program);
+template plcrash_error_t plcrash_async_dwarf_expression_decode<uint64_t, int64_t> (plcrash_async_mobject_t *mobj,
+                                                                                   const plcrash_async_byteorder_t *byteorder,
+                                                                                   pl_vm_address_t address,
+                                                                                   pl_vm_size_t length,
+                                                                                   plcrash_async_dwarf_expression_program_t *program);
+template plcrash_error_t plcrash_async_dwarf_expression_exec<uint32_t, int32_t> (const plcrash_async_dwarf_expression_program_t *program,
+                                                                                 task_t task,
+                                                                                 const plcrash_async_thread_state_t *thread_state,
+                                                                                 uint32_t initial_state[],
+                                                                                 size_t initial_count,
+                                                                                 uint32_t *result);
+template plcrash_error_t plcrash_async_dwarf_expression_exec<uint64_t, int64_t> (const plcrash_async_dwarf_expression_program_t *program,
+                                                                                 task_t task,
+                                                                                 const plcrash_async_thread_state_t *thread_state,
+                                                                                 uint64_t initial_state[],
+                                                                                 size_t initial_count,
+                                                                                 uint64_t *result);
+template plcrash_error_t plcrash_async_dwarf_expression_eval_cached<uint32_t, int32_t> (plcrash_async_dwarf_expression_cache_t *cache,
+                                                                                        task_t task,
+                                                                                        const plcrash_async_thread_state_t *thread_state,
+                                                                                        const plcrash_async_byteorder_t *byteorder,
+                                                                                        pl_vm_address_t address,
+                                                                                        pl_vm_size_t length,
+                                                                                        uint32_t initial_state[],
+                                                                                        size_t initial_count,
+                                                                                        uint32_t *result);
+template plcrash_error_t plcrash_async_dwarf_expression_eval_cached<uint64_t, int64_t> (plcrash_async_dwarf_expression_cache_t *cache,
+                                                                                        task_t task,
+                                                                                        const plcrash_async_thread_state_t *thread_state,
+                                                                                        const plcrash_async_byteorder_t *byteorder,
+                                                                                        pl_vm_address_t address,
+                                                                                        pl_vm_size_t length,
+                                                                                        uint64_t initial_state[],
+                                                                                        size_t initial_count,
+                                                                                        uint64_t *result);
 /**
  * @}
  */
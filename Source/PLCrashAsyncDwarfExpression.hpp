@@ -561,6 +561,71 @@ typedef enum DW_OP {
     DW_OP_hi_user = 0xff,
 } DW_OP_t;
 
+/** The maximum number of instructions in a decoded DWARF expression program. */
+#define PLCRASH_ASYNC_DWARF_EXPRESSION_MAX_INSNS 32
+
+/** The number of decoded programs held by a plcrash_async_dwarf_expression_cache_t. */
+#define PLCRASH_ASYNC_DWARF_EXPRESSION_CACHE_SIZE 8
+
+/**
+ * @internal
+ *
+ * A single decoded DWARF expression instruction. All operands have been read and validated.
+ */
+typedef struct plcrash_async_dwarf_expression_insn {
+    /** The internal operation code. */
+    uint8_t op;
+
+    /** The DW_OP_pick index, or the DW_OP_deref_size read size. */
+    uint8_t size;
+
+    /** The index of the branch target instruction for DW_OP_skip and DW_OP_bra. */
+    uint16_t target;
+
+    /** The DWARF register number for DW_OP_breg* and DW_OP_bregx. */
+    uint32_t regnum;
+
+    /** The constant value or offset operand, sign-extended to 64 bits if signed. */
+    uint64_t operand;
+} plcrash_async_dwarf_expression_insn_t;
+
+/**
+ * @internal
+ *
+ * A DWARF expression, decoded once into a compact instruction array that may be repeatedly executed
+ * without re-reading or re-validating the expression opcodes.
+ */
+typedef struct plcrash_async_dwarf_expression_program {
+    /** True if this program has been successfully decoded. */
+    bool valid;
+
+    /** The number of instructions, including the terminating instruction. */
+    uint8_t count;
+
+    /** The task-relative address of the expression opcodes. */
+    pl_vm_address_t address;
+
+    /** The length of the expression opcodes, in bytes. */
+    pl_vm_size_t length;
+
+    /** The decoded instructions. */
+    plcrash_async_dwarf_expression_insn_t insns[PLCRASH_ASYNC_DWARF_EXPRESSION_MAX_INSNS];
+} plcrash_async_dwarf_expression_program_t;
+
+/**
+ * @internal
+ *
+ * A fixed-size cache of decoded DWARF expression programs, keyed by expression address and length. The cache is
+ * not thread-safe, and its storage must be provided by the caller.
+ */
+typedef struct plcrash_async_dwarf_expression_cache {
+    /** The next slot to be replaced. */
+    uint32_t next;
+
+    /** The cached programs. */
+    plcrash_async_dwarf_expression_program_t programs[PLCRASH_ASYNC_DWARF_EXPRESSION_CACHE_SIZE];
+} plcrash_async_dwarf_expression_cache_t;
+
 template <typename machine_ptr, typename machine_ptr_s>
 plcrash_error_t plcrash_async_dwarf_expression_eval (plcrash_async_mobject_t *mobj,
                                                      task_t task,
@@ -573,6 +638,34 @@ plcrash_error_t plcrash_async_dwarf_expression_eval (plcrash_async_mobject_t *mo
                                                      size_t initial_count,
                                                      machine_ptr *result);
 
+template <typename machine_ptr, typename machine_ptr_s>
+plcrash_error_t plcrash_async_dwarf_expression_decode (plcrash_async_mobject_t *mobj,
+                                                       const plcrash_async_byteorder_t *byteorder,
+                                                       pl_vm_address_t address,
+                                                       pl_vm_size_t length,
+                                                       plcrash_async_dwarf_expression_program_t *program);
+
+template <typename machine_ptr, typename machine_ptr_s>
+plcrash_error_t plcrash_async_dwarf_expression_exec (const plcrash_async_dwarf_expression_program_t *program,
+                                                     task_t task,
+                                                     const plcrash_async_thread_state_t *thread_state,
+                                                     machine_ptr initial_state[],
+                                                     size_t initial_count,
+                                                     machine_ptr *result);
+
+template <typename machine_ptr, typename machine_ptr_s>
+plcrash_error_t plcrash_async_dwarf_expression_eval_cached (plcrash_async_dwarf_expression_cache_t *cache,
+                                                            task_t task,
+                                                            const plcrash_async_thread_state_t *thread_state,
+                                                            const plcrash_async_byteorder_t *byteorder,
+                                                            pl_vm_address_t address,
+                                                            pl_vm_size_t length,
+                                                            machine_ptr initial_state[],
+                                                            size_t initial_count,
+                                                            machine_ptr *result);
+
+void plcrash_async_dwarf_expression_cache_init (plcrash_async_dwarf_expression_cache_t *cache);
+
 /**
  * @}
  */
@@ -820,6 +820,83 @@ using namespace plcrash::async;
 }
 
 
+/**
+ * Test evaluation of decoded expressions via the expression cache.
+ */
+- (void) testCachedEvaluation {
+    /* Computes 3 + 9, branching over the DW_OP_lit5. The branch offset is big endian. */
+    uint8_t opcodes[] = { DW_OP_lit3, DW_OP_lit1, DW_OP_bra, 0x00, 0x01, DW_OP_lit5, DW_OP_lit9, DW_OP_plus };
+    plcrash_async_dwarf_expression_cache_t cache;
+    plcrash_error_t err;
+
+    plcrash_async_dwarf_expression_cache_init(&cache);
+
+    /* Evaluate twice; the first evaluation decodes and caches the expression, the second executes the cached program */
+    for (int i = 0; i < 2; i++) {
+        if (![self is32]) {
+            uint64_t result;
+            err = plcrash_async_dwarf_expression_eval_cached<uint64_t, int64_t>(&cache, mach_task_self(), &_ts, plcrash_async_byteorder_big_endian(), (pl_vm_address_t) &opcodes, sizeof(opcodes), NULL, 0, &result);
+            STAssertEquals(err, PLCRASH_ESUCCESS, @"64-bit evaluation failed");
+            STAssertEquals(result, (uint64_t) 12, @"Incorrect 64-bit result");
+        } else {
+            uint32_t result;
+            err = plcrash_async_dwarf_expression_eval_cached<uint32_t, int32_t>(&cache, mach_task_self(), &_ts, plcrash_async_byteorder_big_endian(), (pl_vm_address_t) &opcodes, sizeof(opcodes), NULL, 0, &result);
+            STAssertEquals(err, PLCRASH_ESUCCESS, @"32-bit evaluation failed");
+            STAssertEquals(result, (uint32_t) 12, @"Incorrect 32-bit result");
+        }
+
+        STAssertTrue(cache.programs[0].valid, @"Expression was not cached");
+        STAssertEquals(cache.programs[0].address, (pl_vm_address_t) &opcodes, @"Incorrect cached expression address");
+        STAssertFalse(cache.programs[1].valid, @"Expression was cached more than once");
+    }
+}
+
+/**
+ * Verify that an expression which can not be decoded is evaluated directly, without evicting a cached program.
+ */
+- (void) testCachedEvaluationUndecodable {
+    /* Computes 3 + 9 */
+    uint8_t opcodes[] = { DW_OP_lit3, DW_OP_lit9, DW_OP_plus };
+
+    /* Exceeds PLCRASH_ASYNC_DWARF_EXPRESSION_MAX_INSNS, and must be evaluated directly; computes 7 */
+    uint8_t long_opcodes[PLCRASH_ASYNC_DWARF_EXPRESSION_MAX_INSNS + 1];
+    memset(long_opcodes, DW_OP_nop, sizeof(long_opcodes));
+    long_opcodes[0] = DW_OP_lit7;
+
+    plcrash_async_dwarf_expression_cache_t cache;
+    plcrash_error_t err;
+
+    plcrash_async_dwarf_expression_cache_init(&cache);
+
+    if (![self is32]) {
+        uint64_t result;
+        err = plcrash_async_dwarf_expression_eval_cached<uint64_t, int64_t>(&cache, mach_task_self(), &_ts, plcrash_async_byteorder_big_endian(), (pl_vm_address_t) &opcodes, sizeof(opcodes), NULL, 0, &result);
+        STAssertEquals(err, PLCRASH_ESUCCESS, @"64-bit evaluation failed");
+
+        /* Rewind the replacement slot, so that the next insertion would replace the cached program */
+        cache.next = 0;
+        err = plcrash_async_dwarf_expression_eval_cached<uint64_t, int64_t>(&cache, mach_task_self(), &_ts, plcrash_async_byteorder_big_endian(), (pl_vm_address_t) &long_opcodes, sizeof(long_opcodes), NULL, 0, &result);
+        STAssertEquals(err, PLCRASH_ESUCCESS, @"64-bit evaluation of undecodable expression failed");
+        STAssertEquals(result, (uint64_t) 7, @"Incorrect 64-bit result");
+    } else {
+        uint32_t result;
+        err = plcrash_async_dwarf_expression_eval_cached<uint32_t, int32_t>(&cache, mach_task_self(), &_ts, plcrash_async_byteorder_big_endian(), (pl_vm_address_t) &opcodes, sizeof(opcodes), NULL, 0, &result);
+        STAssertEquals(err, PLCRASH_ESUCCESS, @"32-bit evaluation failed");
+
+        /* Rewind the replacement slot, so that the next insertion would replace the cached program */
+        cache.next = 0;
+        err = plcrash_async_dwarf_expression_eval_cached<uint32_t, int32_t>(&cache, mach_task_self(), &_ts, plcrash_async_byteorder_big_endian(), (pl_vm_address_t) &long_opcodes, sizeof(long_opcodes), NULL, 0, &result);
+        STAssertEquals(err, PLCRASH_ESUCCESS, @"32-bit evaluation of undecodable expression failed");
+        STAssertEquals(result, (uint32_t) 7, @"Incorrect 32-bit result");
+    }
+
+    /* The cached program must survive the failed decode, and the replacement slot must not have advanced */
+    STAssertTrue(cache.programs[0].valid, @"Cached program was evicted by a failed decode");
+    STAssertEquals(cache.programs[0].address, (pl_vm_address_t) &opcodes, @"Incorrect cached expression address");
+    STAssertFalse(cache.programs[1].valid, @"Undecodable expression was cached");
+    STAssertEquals(cache.next, (uint32_t) 0, @"Cache replacement slot advanced on a failed decode");
+}
+
 @end
 
 #endif /* PLCRASH_FEATURE_UNWIND_DWARF */
@@ -55,6 +55,23 @@ template <typename machine_ptr> gnu_ehptr_reader<machine_ptr>::gnu_ehptr_reader
     _func_base.valid = false;
 }
 
+/**
+ * Construct a reader using an image's precomputed base addresses.
+ *
+ * @param byteorder The pointer encoding byte order. This value must remain valid throughout the lifetime of the new
+ * reader instance.
+ * @param bases The DW_EH_PE_textrel and DW_EH_PE_datarel base addresses of the image from which pointers will be read.
+ */
+template <typename machine_ptr> gnu_ehptr_reader<machine_ptr>::gnu_ehptr_reader (const plcrash_async_byteorder_t *byteorder, const plcrash_async_dwarf_ehptr_bases_t *bases) {
+    _byteorder = byteorder;
+    _has_frame_section_base = false;
+    _text_base.valid = bases->has_text_base;
+    _text_base.address = (machine_ptr) bases->text_base;
+    _data_base.valid = bases->has_data_base;
+    _data_base.address = (machine_ptr) bases->data_base;
+    _func_base.valid = false;
+}
+
 /**
  * Set the DW_EH_PE_aligned base addresses.
  *
@@ -277,6 +277,26 @@ typedef enum {
 } plcrash_dwarf_cfa_reg_rule_t;
 
 
+/**
+ * @internal
+ *
+ * The DW_EH_PE_textrel and DW_EH_PE_datarel base addresses of a single image. These are constant for the lifetime
+ * of the image, and may be computed once and used to construct any number of gnu_ehptr_reader instances.
+ */
+typedef struct plcrash_async_dwarf_ehptr_bases {
+    /** If true, @a text_base is valid. */
+    bool has_text_base;
+
+    /** The in-memory base address of the image's text segment. */
+    pl_vm_address_t text_base;
+
+    /** If true, @a data_base is valid. */
+    bool has_data_base;
+
+    /** The in-memory base address of the image's data segment. */
+    pl_vm_address_t data_base;
+} plcrash_async_dwarf_ehptr_bases_t;
+
 /**
  * @internal
  *
@@ -287,6 +307,7 @@ typedef enum {
 template <typename machine_ptr> class gnu_ehptr_reader {
 public:
     gnu_ehptr_reader (const plcrash_async_byteorder_t *byteorder);
+    gnu_ehptr_reader (const plcrash_async_byteorder_t *byteorder, const plcrash_async_dwarf_ehptr_bases_t *bases);
     void set_frame_section_base (machine_ptr frame_section_base, machine_ptr frame_section_vm_addr);
     void set_text_base (machine_ptr text_base);
     void set_data_base (machine_ptr data_base);
@@ -345,6 +366,110 @@ plcrash_error_t plcrash_async_dwarf_read_sleb128 (plcrash_async_mobject_t *mobj,
 plcrash_error_t plcrash_async_dwarf_read_task_sleb128 (task_t task, pl_vm_address_t location, pl_vm_off_t offset, int64_t *result, pl_vm_size_t *size);
 plcrash_error_t plcrash_async_dwarf_read_task_uleb128 (task_t task, pl_vm_address_t location, pl_vm_off_t offset, uint64_t *result, pl_vm_size_t *size);
 
+/**
+ * @internal
+ *
+ * The maximum encoded size of a LEB128 value that fits within 64 bits, in bytes.
+ */
+#define PLCRASH_ASYNC_DWARF_LEB128_MAX_SIZE 10
+
+/**
+ * @internal
+ *
+ * Decode a LEB128 value from the locally mapped range [@a p, @a end). Unlike plcrash_async_dwarf_read_uleb128(),
+ * the memory range is not revalidated per byte; the caller is responsible for ensuring that the entire range has
+ * already been mapped.
+ *
+ * @param p The local address of the LEB128 value.
+ * @param end The end of the locally mapped range.
+ * @param result On success, the decoded value, without sign extension.
+ * @param size On success, will be set to the total size of the decoded LEB128 value, in bytes.
+ * @param shift On success, will be set to the total number of value bits decoded.
+ */
+inline plcrash_error_t plcrash_async_dwarf_decode_leb128 (const uint8_t *p, const uint8_t *end, uint64_t *result, pl_vm_size_t *size, unsigned int *shift) {
+    pl_vm_size_t avail = (p < end) ? (pl_vm_size_t) (end - p) : 0;
+
+    /* Single-byte values are by far the most common encoding for DWARF operands */
+    if (avail > 0 && (p[0] & 0x80) == 0) {
+        *result = p[0];
+        *size = 1;
+        *shift = 7;
+        return PLCRASH_ESUCCESS;
+    }
+
+    /* Perform our bounds check once, up front */
+    pl_vm_size_t limit = avail < PLCRASH_ASYNC_DWARF_LEB128_MAX_SIZE ? avail : PLCRASH_ASYNC_DWARF_LEB128_MAX_SIZE;
+    uint64_t value = 0;
+    unsigned int bits = 0;
+
+    for (pl_vm_size_t i = 0; i < limit; i++) {
+        /* LEB128 uses 7 bits for the number, the final bit to signal completion */
+        uint8_t byte = p[i];
+        value |= ((uint64_t) (byte & 0x7f)) << bits;
+        bits += 7;
+
+        if ((byte & 0x80) == 0) {
+            *result = value;
+            *size = i + 1;
+            *shift = bits;
+            return PLCRASH_ESUCCESS;
+        }
+    }
+
+    if (limit == PLCRASH_ASYNC_DWARF_LEB128_MAX_SIZE) {
+        PLCF_DEBUG("LEB128 is larger than the maximum supported size of 64 bits");
+        return PLCRASH_ENOTSUP;
+    }
+
+    PLCF_DEBUG("LEB128 value did not terminate within mapped memory range");
+    return PLCRASH_EINVAL;
+}
+
+/**
+ * @internal
+ *
+ * Decode a ULEB128 value from the locally mapped range [@a p, @a end).
+ *
+ * @param p The local address of the ULEB128 value.
+ * @param end The end of the locally mapped range.
+ * @param result On success, the ULEB128 value.
+ * @param size On success, will be set to the total size of the decoded ULEB128 value, in bytes.
+ *
+ * @sa plcrash_async_dwarf_decode_leb128()
+ */
+inline plcrash_error_t plcrash_async_dwarf_decode_uleb128 (const uint8_t *p, const uint8_t *end, uint64_t *result, pl_vm_size_t *size) {
+    unsigned int shift;
+    return plcrash_async_dwarf_decode_leb128(p, end, result, size, &shift);
+}
+
+/**
+ * @internal
+ *
+ * Decode a SLEB128 value from the locally mapped range [@a p, @a end).
+ *
+ * @param p The local address of the SLEB128 value.
+ * @param end The end of the locally mapped range.
+ * @param result On success, the SLEB128 value.
+ * @param size On success, will be set to the total size of the decoded SLEB128 value, in bytes.
+ *
+ * @sa plcrash_async_dwarf_decode_leb128()
+ */
+inline plcrash_error_t plcrash_async_dwarf_decode_sleb128 (const uint8_t *p, const uint8_t *end, int64_t *result, pl_vm_size_t *size) {
+    plcrash_error_t err;
+    unsigned int shift;
+    uint64_t value;
+
+    if ((err = plcrash_async_dwarf_decode_leb128(p, end, &value, size, &shift)) != PLCRASH_ESUCCESS)
+        return err;
+
+    /* Sign bit is 2nd high order bit */
+    if (shift < 64 && (p[*size - 1] & 0x40))
+        value |= -(1ULL << shift);
+
+    *result = (int64_t) value;
+    return PLCRASH_ESUCCESS;
+}
+
 /**
  * @internal
  *
@@ -385,15 +510,15 @@ plcrash_error_t plcrash_async_dwarf_read_uintmax64 (plcrash_async_mobject_t *mob
             break;
             
         case 2:
-            *dest = byteorder->swap16(data->u16);
+            *dest = plcrash_async_swap16(byteorder, data->u16);
             break;
             
         case 4:
-            *dest = byteorder->swap32(data->u32);
+            *dest = plcrash_async_swap32(byteorder, data->u32);
             break;
             
         case 8:
-            *dest = byteorder->swap64(data->u64);
+            *dest = plcrash_async_swap64(byteorder, data->u64);
             break;
             
         default:
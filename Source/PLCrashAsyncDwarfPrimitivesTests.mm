@@ -180,6 +180,31 @@ using namespace plcrash::async;
     plcrash_async_mobject_free(&mobj);
 }
 
+/**
+ * Test construction of a pointer reader from precomputed image base addresses.
+ */
+- (void) testReadEncodedPointerWithBases {
+    plcrash_async_mobject_t mobj;
+    plcrash_async_dwarf_ehptr_bases_t bases = { true, T_TEXT_BASE, false, 0x0 };
+    gnu_ehptr_reader<uint64_t> reader(&plcrash_async_byteorder_direct, &bases);
+    plcrash_error_t err;
+    uint64_t result;
+    size_t size;
+
+    uint64_t test_data = 5;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_init(&mobj, mach_task_self(), (pl_vm_address_t) &test_data, sizeof(test_data), true), @"Failed to initialize mobj mapping");
+
+    err = reader.read(&mobj, (pl_vm_address_t) &test_data, 0, DW_EH_PE_textrel, &result, &size);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"Failed to decode textrel value");
+    STAssertEquals(result, (uint64_t)test_data+T_TEXT_BASE, @"Incorrect value decoded");
+
+    /* No data base was supplied */
+    err = reader.read(&mobj, (pl_vm_address_t) &test_data, 0, DW_EH_PE_datarel, &result, &size);
+    STAssertEquals(err, PLCRASH_ENOTSUP, @"Decoded a datarel value without a data base");
+
+    plcrash_async_mobject_free(&mobj);
+}
+
 /**
  * Test pointer value type decoding.
  */
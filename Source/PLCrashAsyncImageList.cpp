@@ -31,122 +31,1594 @@
 #include "PLCrashAsyncLinkedList.hpp"
 
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdio.h>
 #include <string.h>
+#include <limits.h>
 #include <assert.h>
+#include <dlfcn.h>
+#include <sched.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <mach-o/dyld_images.h>
 
 using namespace plcrash::async;
 
 /**
- * @internal
- * @ingroup plcrash_async
- * @defgroup plcrash_async_image Binary Image Handling
+ * @internal
+ * @ingroup plcrash_async
+ * @defgroup plcrash_async_image Binary Image Handling
+ *
+ * Maintains a linked list of binary images with support for async-safe iteration. Writing may occur concurrently with
+ * async-safe reading, but is not async-safe.
+ *
+ * Atomic compare and swap is used to ensure a consistent view of the list for readers. To simplify implementation, a
+ * write mutex is held for all updates; the implementation is not designed for efficiency in the face of contention
+ * between readers and writers, and it's assumed that no contention should realistically occur.
+ *
+ * In addition to the backing linked list, writers maintain an immutable snapshot of the list's images in contiguous
+ * arrays. Each update copies the current snapshot, and publishes the copy with a single atomic pointer store;
+ * replaced snapshots are reclaimed once no readers remain. Readers iterate the snapshot via plcrash_async_image_cursor_t,
+ * and search it via plcrash_async_image_containing_address().
+ * @{
+ */
+
+
+/**
+ * @internal
+ *
+ * An entry in an address-sorted image snapshot.
+ */
+typedef struct plcrash_async_image_index_entry {
+    /** The start address of the image's __TEXT segment. */
+    pl_vm_address_t start;
+
+    /** The end address (exclusive) of the image's __TEXT segment. */
+    pl_vm_address_t end;
+
+    /** The image. Images are never deallocated prior to the list itself, and may be safely borrowed here. */
+    plcrash_async_image_t *image;
+} plcrash_async_image_index_entry_t;
+
+/**
+ * @internal
+ *
+ * An immutable snapshot of an image list's images. A new snapshot is published atomically on each update, allowing
+ * async-safe readers to iterate the list's images in append order, or binary search them by address.
+ */
+struct plcrash_async_image_index {
+    /** The next retired snapshot, or NULL. */
+    struct plcrash_async_image_index *retired_next;
+
+    /** The number of entries in both @a images and @a entries. */
+    size_t count;
+
+    /** The images, in the order they were appended to the list. Allocated immediately following @a entries. */
+    plcrash_async_image_t **images;
+
+    /** The address-sorted entries. */
+    plcrash_async_image_index_entry_t entries[];
+};
+
+/* Compare two index entries by start address */
+static int image_index_entry_compare (const void *a, const void *b) {
+    const plcrash_async_image_index_entry_t *lhs = (const plcrash_async_image_index_entry_t *) a;
+    const plcrash_async_image_index_entry_t *rhs = (const plcrash_async_image_index_entry_t *) b;
+
+    if (lhs->start < rhs->start)
+        return -1;
+    else if (lhs->start > rhs->start)
+        return 1;
+    return 0;
+}
+
+/* Initialize @a entry for @a image. The extent of unparsed images is unknown, and is verified on lookup. */
+static void image_index_entry_init (plcrash_async_image_index_entry_t *entry, plcrash_async_image_t *image) {
+    entry->start = image->header_addr;
+    if (image->state == PLCRASH_ASYNC_IMAGE_PARSED)
+        entry->end = image->header_addr + image->macho_image.text_size;
+    else
+        entry->end = PL_VM_ADDRESS_MAX;
+    entry->image = image;
+}
+
+/**
+ * @internal
+ *
+ * The maximum number of times a reader will yield while waiting for another thread to finish parsing an image.
+ * At crash time, the parsing thread may have been suspended, and the image is then treated as unavailable.
+ */
+#define IMAGE_PARSE_WAIT_LIMIT 1000
+
+/**
+ * @internal
+ *
+ * Parse @a image's Mach-O data, if it has not already been parsed. This method is async-safe, and may be called
+ * concurrently; exactly one caller will parse the image.
+ *
+ * @return Returns true if the image has been parsed, or false if it could not be parsed.
+ */
+static bool image_parse (plcrash_async_image_list_t *list, plcrash_async_image_t *image) {
+    if (image->state == PLCRASH_ASYNC_IMAGE_PARSED) {
+        OSMemoryBarrier();
+        return true;
+    }
+
+    if (OSAtomicCompareAndSwap32Barrier(PLCRASH_ASYNC_IMAGE_UNPARSED, PLCRASH_ASYNC_IMAGE_PARSING, &image->state)) {
+        plcrash_error_t ret = plcrash_async_macho_init_borrowed_name(&image->macho_image, list->task, image->name, image->header_addr);
+        if (ret != PLCRASH_ESUCCESS)
+            PLCF_DEBUG("Unexpected failure initializing Mach-O structure for %s: %d", image->name, ret);
+        else if (plcrash_async_shared_cache_contains_address(&list->shared_cache, image->header_addr))
+            image->macho_image.in_shared_cache = true;
+
+        OSAtomicCompareAndSwap32Barrier(PLCRASH_ASYNC_IMAGE_PARSING, ret == PLCRASH_ESUCCESS ? PLCRASH_ASYNC_IMAGE_PARSED : PLCRASH_ASYNC_IMAGE_PARSE_FAILED, &image->state);
+        return ret == PLCRASH_ESUCCESS;
+    }
+
+    /* Another thread is parsing the image */
+    for (int i = 0; i < IMAGE_PARSE_WAIT_LIMIT && image->state == PLCRASH_ASYNC_IMAGE_PARSING; i++)
+        sched_yield();
+
+    OSMemoryBarrier();
+    return image->state == PLCRASH_ASYNC_IMAGE_PARSED;
+}
+
+/**
+ * @internal
+ *
+ * Pre-encode @a image's record and build its symbol index, as configured for @a list. The image must have
+ * been parsed.
+ *
+ * @warning This method is not async safe.
+ */
+static void image_prepare (plcrash_async_image_list_t *list, plcrash_async_image_t *image) {
+    plcrash_error_t ret;
+
+    /* Pre-encode the image's record; on failure, the record will be encoded at crash time. The record may be
+     * read concurrently, and is published only once complete. */
+    if (list->encoder != NULL && image->encoded_record == NULL) {
+        void *record;
+        size_t length;
+        if ((ret = list->encoder(&image->macho_image, &record, &length)) == PLCRASH_ESUCCESS) {
+            image->encoded_record_length = length;
+            OSMemoryBarrier();
+            image->encoded_record = record;
+        } else {
+            PLCF_DEBUG("Failed to pre-encode image record for %s: %d", image->name, ret);
+        }
+    }
+
+    /* Build the symbol index; on failure, symbol lookups will fall back on scanning the symbol table. */
+    if (list->index_symbols && image->macho_image.symbol_index == NULL) {
+        if ((ret = plcrash_nasync_macho_build_symbol_index(&image->macho_image, 0)) != PLCRASH_ESUCCESS)
+            PLCF_DEBUG("Failed to build symbol index for %s: %d", image->name, ret);
+    }
+}
+
+/**
+ * @internal
+ *
+ * Free @a image and all associated resources.
+ *
+ * @warning This method is not async safe.
+ */
+static void image_free (plcrash_async_image_t *image) {
+    /* Deallocate the Mach-O reference. */
+    if (image->state == PLCRASH_ASYNC_IMAGE_PARSED)
+        plcrash_nasync_macho_free(&image->macho_image);
+
+    /* Deallocate the pre-encoded record */
+    if (image->encoded_record != NULL)
+        free(image->encoded_record);
+
+    free(image->name);
+
+    /* Deallocate the actual image value */
+    free(image);
+}
+
+/* Allocate an index with room for @a count entries, or return NULL on failure */
+static struct plcrash_async_image_index *image_index_alloc (size_t count) {
+    struct plcrash_async_image_index *index = (struct plcrash_async_image_index *) malloc(sizeof(*index) + count * (sizeof(index->entries[0]) + sizeof(index->images[0])));
+    if (index == NULL)
+        return NULL;
+
+    index->retired_next = NULL;
+    index->count = count;
+    index->images = (plcrash_async_image_t **) &index->entries[count];
+    return index;
+}
+
+/* Free @a index, and all snapshots retired after it */
+static void image_index_free_chain (struct plcrash_async_image_index *index) {
+    while (index != NULL) {
+        struct plcrash_async_image_index *next = index->retired_next;
+        free(index);
+        index = next;
+    }
+}
+
+/**
+ * @internal
+ *
+ * Build a new snapshot from the current contents of @a list. Returns NULL if the snapshot can not be allocated.
+ *
+ * @warning This method is not async safe, and must be called with the index lock held.
+ */
+static struct plcrash_async_image_index *image_index_build (plcrash_async_image_list_t *list) {
+    struct plcrash_async_image_index *index = NULL;
+
+    list->_list->set_reading(true); {
+        size_t count = 0;
+        async_list<plcrash_async_image_t *>::node *next = NULL;
+        while ((next = list->_list->next(next)) != NULL)
+            count++;
+
+        if ((index = image_index_alloc(count)) != NULL) {
+            size_t i = 0;
+            while ((next = list->_list->next(next)) != NULL && i < count) {
+                index->images[i] = next->value();
+                image_index_entry_init(&index->entries[i++], next->value());
+            }
+            index->count = i;
+
+            qsort(index->entries, index->count, sizeof(index->entries[0]), image_index_entry_compare);
+        }
+    } list->_list->set_reading(false);
+
+    return index;
+}
+
+/**
+ * @internal
+ *
+ * Atomically replace @a list's snapshot with @a index. The previous snapshot is deallocated once no readers
+ * may hold a reference to it.
+ *
+ * @warning This method is not async safe, and must be called with the index lock held.
+ */
+static void image_index_publish (plcrash_async_image_list_t *list, struct plcrash_async_image_index *index) {
+    struct plcrash_async_image_index *old = list->_index;
+    if (!OSAtomicCompareAndSwapPtrBarrier(old, index, (void * volatile *) &list->_index)) {
+        /* Should never occur */
+        PLCF_DEBUG("Failed to publish image index despite holding lock");
+    }
+
+    if (old != NULL) {
+        old->retired_next = list->_retired_indexes;
+        list->_retired_indexes = old;
+    }
+
+    /* The retired snapshots are unreachable; if no readers are active, none may hold a reference to them. */
+    if (list->_index_refcount == 0) {
+        image_index_free_chain(list->_retired_indexes);
+        list->_retired_indexes = NULL;
+    }
+}
+
+
+/**
+ * Initialize a new binary image list and issue a memory barrier
+ *
+ * @param list The list structure to be initialized.
+ * @param task The mach task from which all images will be mapped.
+ *
+ * @warning This method is not async safe.
+ */
+void plcrash_nasync_image_list_init (plcrash_async_image_list_t *list, mach_port_t task) {
+    memset(list, 0, sizeof(*list));
+
+    list->_list = new async_list<plcrash_async_image_t *>();
+    list->_index_lock = OS_SPINLOCK_INIT;
+    pthread_mutex_init(&list->_pending_lock, NULL);
+    list->task = task;
+    mach_port_mod_refs(mach_task_self(), list->task, MACH_PORT_RIGHT_SEND, 1);
+}
+
+/**
+ * Free any binary image list resources.
+ *
+ * @warning This method is not async safe.
+ */
+void plcrash_nasync_image_list_free (plcrash_async_image_list_t *list) {
+    /* Clean up the image structures */
+    list->_list->set_reading(true);
+    async_list<plcrash_async_image_t *>::node *next = NULL;
+    while ((next = list->_list->next(next)) != NULL)
+        image_free(next->value());
+    list->_list->set_reading(false);
+
+    /* Free the backing list and its snapshots */
+    delete list->_list;
+
+    image_index_free_chain(list->_index);
+    image_index_free_chain(list->_retired_indexes);
+
+    /* Free the header table */
+    if (list->_header_slots != NULL)
+        free(list->_header_slots);
+
+    /* Free any deferred registrations */
+    if (list->_pending != NULL)
+        free(list->_pending);
+    pthread_mutex_destroy(&list->_pending_lock);
+    
+    mach_port_mod_refs(mach_task_self(), list->task, MACH_PORT_RIGHT_SEND, -1);
+}
+
+/**
+ * Set the encoder to be used to pre-encode the crash report records of all images subsequently appended
+ * to @a list.
+ *
+ * @param list The list to be configured.
+ * @param encoder The encoder to use, or NULL to disable pre-encoding.
+ *
+ * @warning This method is not async safe.
+ */
+void plcrash_nasync_image_list_set_encoder (plcrash_async_image_list_t *list, plcrash_async_image_encoder_fn encoder) {
+    list->encoder = encoder;
+}
+
+/**
+ * Enable or disable building of address-sorted symbol indexes (see plcrash_nasync_macho_build_symbol_index())
+ * for the images in @a list. When enabled, indexes are built for all images already in the list, as well as for
+ * all images subsequently appended.
+ *
+ * Indexes reduce the cost of symbol lookups at crash time, at the cost of additional memory and time spent
+ * when images are added.
+ *
+ * @param list The list to be configured.
+ * @param enabled If true, symbol indexes will be built.
+ *
+ * @warning This method is not async safe.
+ */
+void plcrash_nasync_image_list_set_symbol_indexing (plcrash_async_image_list_t *list, bool enabled) {
+    list->index_symbols = enabled;
+    if (!enabled)
+        return;
+
+    /* Index any existing images. The index is published atomically, and may safely be built while the
+     * list is being read. */
+    list->_list->set_reading(true);
+    async_list<plcrash_async_image_t *>::node *next = NULL;
+    while ((next = list->_list->next(next)) != NULL) {
+        plcrash_async_image_t *image = next->value();
+        plcrash_error_t ret;
+
+        if (!image_parse(list, image))
+            continue;
+
+        if ((ret = plcrash_nasync_macho_build_symbol_index(&image->macho_image, 0)) != PLCRASH_ESUCCESS)
+            PLCF_DEBUG("Failed to build symbol index for %s: %d", image->macho_image.name, ret);
+    }
+    list->_list->set_reading(false);
+}
+
+/**
+ * Enable or disable lazy parsing of images subsequently appended to @a list. When enabled, registration only
+ * records the image's header address and name; the image is parsed on first access via the list's accessors, or
+ * by plcrash_nasync_image_list_parse_images(), and parsing may occur at crash time.
+ *
+ * Lazily parsed images are pre-encoded and symbol-indexed only by plcrash_nasync_image_list_parse_images().
+ *
+ * @param list The list to be configured.
+ * @param enabled If true, images will be parsed lazily.
+ *
+ * @warning This method is not async safe.
+ */
+void plcrash_nasync_image_list_set_lazy_parsing (plcrash_async_image_list_t *list, bool enabled) {
+    list->lazy_parsing = enabled;
+}
+
+/**
+ * Configure the dyld shared cache of @a list's task, allowing shared cache images to be identified on releases
+ * that do not flag them in their Mach-O headers. Images that have already been parsed are updated.
+ *
+ * @param list The list to be configured.
+ * @param cache The task's shared cache, as determined by plcrash_async_shared_cache_init().
+ *
+ * @warning This method is not async safe, and must not be called concurrently with list mutation or parsing.
+ */
+void plcrash_nasync_image_list_set_shared_cache (plcrash_async_image_list_t *list, const plcrash_async_shared_cache_t *cache) {
+    list->shared_cache = *cache;
+
+    list->_list->set_reading(true);
+    async_list<plcrash_async_image_t *>::node *next = NULL;
+    while ((next = list->_list->next(next)) != NULL) {
+        plcrash_async_image_t *image = next->value();
+        if (image->state == PLCRASH_ASYNC_IMAGE_PARSED && plcrash_async_shared_cache_contains_address(cache, image->header_addr))
+            image->macho_image.in_shared_cache = true;
+    }
+    list->_list->set_reading(false);
+}
+
+/**
+ * Parse any images in @a list that have not yet been parsed, pre-encoding their records and building their
+ * symbol indexes as configured via plcrash_nasync_image_list_set_encoder() and
+ * plcrash_nasync_image_list_set_symbol_indexing().
+ *
+ * This function may be called from a background thread concurrently with both async-safe readers and
+ * list mutation.
+ *
+ * @param list The list to be parsed.
+ *
+ * @warning This method is not async safe.
+ */
+void plcrash_nasync_image_list_parse_images (plcrash_async_image_list_t *list) {
+    list->_list->set_reading(true);
+    async_list<plcrash_async_image_t *>::node *next = NULL;
+    while ((next = list->_list->next(next)) != NULL) {
+        plcrash_async_image_t *image = next->value();
+        if (image->state == PLCRASH_ASYNC_IMAGE_UNPARSED && image_parse(list, image))
+            image_prepare(list, image);
+    }
+    list->_list->set_reading(false);
+}
+
+/**
+ * Return the number of images in @a list, without parsing any unparsed images.
+ *
+ * @param list The list to be counted.
+ * @param parsed If non-NULL, will be set to the number of images in @a list that have been parsed.
+ *
+ * @warning This method is not async safe.
+ */
+size_t plcrash_nasync_image_list_count (plcrash_async_image_list_t *list, size_t *parsed) {
+    size_t count = 0;
+    size_t parsed_count = 0;
+
+    list->_list->set_reading(true);
+    async_list<plcrash_async_image_t *>::node *next = NULL;
+    while ((next = list->_list->next(next)) != NULL) {
+        count++;
+        if (next->value()->state == PLCRASH_ASYNC_IMAGE_PARSED)
+            parsed_count++;
+    }
+    list->_list->set_reading(false);
+
+    if (parsed != NULL)
+        *parsed = parsed_count;
+
+    return count;
+}
+
+/**
+ * Format the path of @a image's persisted symbol index within @a cache_dir. The file is named for the image's
+ * LC_UUID; images without a UUID are not persisted.
+ *
+ * @return Returns true on success, or false if the image has no UUID or the path does not fit within @a buflen.
+ */
+static bool symbol_index_cache_path (plcrash_async_macho_t *image, const char *cache_dir, char *buf, size_t buflen) {
+    uint8_t uuid[16];
+    if (plcrash_async_macho_uuid(image, uuid) != PLCRASH_ESUCCESS)
+        return false;
+
+    int len = snprintf(buf, buflen, "%s/%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X.symidx", cache_dir,
+                       uuid[0], uuid[1], uuid[2], uuid[3], uuid[4], uuid[5], uuid[6], uuid[7],
+                       uuid[8], uuid[9], uuid[10], uuid[11], uuid[12], uuid[13], uuid[14], uuid[15]);
+    return len > 0 && (size_t) len < buflen;
+}
+
+/** File name suffix of persisted symbol indexes. */
+#define SYMBOL_INDEX_CACHE_SUFFIX ".symidx"
+
+/**
+ * @internal
+ *
+ * A persisted symbol index file considered for pruning.
+ */
+struct symbol_index_cache_entry {
+    /** The file name, relative to the cache directory. */
+    char name[NAME_MAX + 1];
+
+    /** The file's modification time, updated each time the index is loaded. */
+    time_t mtime;
+
+    /** The file's size, in bytes. */
+    off_t size;
+};
+
+/* qsort() comparison function; orders entries from least to most recently used. */
+static int symbol_index_cache_entry_compare (const void *a, const void *b) {
+    const struct symbol_index_cache_entry *lhs = (const struct symbol_index_cache_entry *) a;
+    const struct symbol_index_cache_entry *rhs = (const struct symbol_index_cache_entry *) b;
+
+    if (lhs->mtime < rhs->mtime)
+        return -1;
+    else if (lhs->mtime > rhs->mtime)
+        return 1;
+    return 0;
+}
+
+/**
+ * Determine whether @a name is the persisted symbol index file of an image in @a list. The caller must hold a read
+ * reference on @a list.
+ */
+static bool symbol_index_cache_in_use (plcrash_async_image_list_t *list, const char *cache_dir, const char *name) {
+    async_list<plcrash_async_image_t *>::node *next = NULL;
+    size_t dir_len = strlen(cache_dir);
+    char path[PATH_MAX];
+
+    while ((next = list->_list->next(next)) != NULL) {
+        if (next->value()->state != PLCRASH_ASYNC_IMAGE_PARSED)
+            continue;
+
+        if (symbol_index_cache_path(&next->value()->macho_image, cache_dir, path, sizeof(path)) && strcmp(path + dir_len + 1, name) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Prune the persisted symbol index files within @a cache_dir, removing the least recently used indexes of images
+ * that are not in @a list until the directory's indexes total no more than
+ * PLCRASH_ASYNC_IMAGE_LIST_SYMBOL_INDEX_CACHE_LIMIT bytes. Indexes of images in @a list are always retained. The
+ * caller must hold a read reference on @a list.
+ */
+static void symbol_index_cache_prune (plcrash_async_image_list_t *list, const char *cache_dir) {
+    const size_t suffix_len = strlen(SYMBOL_INDEX_CACHE_SUFFIX);
+    struct symbol_index_cache_entry *entries = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    off_t total = 0;
+
+    DIR *dir = opendir(cache_dir);
+    if (dir == NULL)
+        return;
+
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL) {
+        size_t len = strlen(ent->d_name);
+        if (len <= suffix_len || strcmp(ent->d_name + len - suffix_len, SYMBOL_INDEX_CACHE_SUFFIX) != 0)
+            continue;
+
+        struct stat sb;
+        if (fstatat(dirfd(dir), ent->d_name, &sb, 0) != 0 || !S_ISREG(sb.st_mode))
+            continue;
+
+        total += sb.st_size;
+        if (symbol_index_cache_in_use(list, cache_dir, ent->d_name))
+            continue;
+
+        if (count == capacity) {
+            size_t new_capacity = capacity == 0 ? 16 : capacity * 2;
+            struct symbol_index_cache_entry *new_entries = (struct symbol_index_cache_entry *) realloc(entries, new_capacity * sizeof(*entries));
+            if (new_entries == NULL)
+                break;
+
+            entries = new_entries;
+            capacity = new_capacity;
+        }
+
+        strlcpy(entries[count].name, ent->d_name, sizeof(entries[count].name));
+        entries[count].mtime = sb.st_mtime;
+        entries[count].size = sb.st_size;
+        count++;
+    }
+
+    if (count > 0)
+        qsort(entries, count, sizeof(entries[0]), symbol_index_cache_entry_compare);
+
+    for (size_t i = 0; i < count && total > PLCRASH_ASYNC_IMAGE_LIST_SYMBOL_INDEX_CACHE_LIMIT; i++) {
+        if (unlinkat(dirfd(dir), entries[i].name, 0) == 0) {
+            PLCF_DEBUG("Pruned symbol index %s", entries[i].name);
+            total -= entries[i].size;
+        }
+    }
+
+    closedir(dir);
+    free(entries);
+}
+
+/**
+ * Build address-sorted symbol indexes (see plcrash_nasync_macho_build_symbol_index()) for any images in @a list
+ * that do not yet have an index, stopping once the total memory allocated for indexes would exceed @a memory_limit.
+ *
+ * Indexes are published atomically, and this function may be called from a background thread concurrently with
+ * both async-safe readers and list mutation; images removed from the list during iteration will not be freed
+ * until iteration completes.
+ *
+ * If @a cache_dir is non-NULL, indexes are first loaded from files within @a cache_dir named for each image's
+ * LC_UUID (see plcrash_nasync_macho_load_symbol_index()); indexes that must be built are then written to the
+ * directory, allowing them to be reused by subsequent launches of the same binaries. Mapped indexes are counted
+ * against @a memory_limit. After new indexes are written, the least recently used indexes of images no longer in
+ * @a list are pruned from the directory (see PLCRASH_ASYNC_IMAGE_LIST_SYMBOL_INDEX_CACHE_LIMIT).
+ *
+ * @param list The list to be indexed.
+ * @param memory_limit The maximum number of bytes to be allocated for all symbol indexes in @a list, including
+ * any indexes that have already been built, or 0 for no limit.
+ * @param cache_dir The path of an existing directory in which symbol indexes are persisted, or NULL.
+ *
+ * @return Returns the total number of bytes allocated for symbol indexes in @a list.
+ *
+ * @warning This method is not async safe.
+ */
+size_t plcrash_nasync_image_list_build_symbol_indexes (plcrash_async_image_list_t *list, size_t memory_limit, const char *cache_dir) {
+    size_t used = 0;
+    bool persisted = false;
+
+    list->_list->set_reading(true);
+    async_list<plcrash_async_image_t *>::node *next = NULL;
+
+    /* Account for existing indexes first, so that the limit applies to the list as a whole */
+    while ((next = list->_list->next(next)) != NULL) {
+        if (next->value()->state == PLCRASH_ASYNC_IMAGE_PARSED)
+            used += plcrash_async_macho_symbol_index_size(&next->value()->macho_image);
+    }
+
+    while ((next = list->_list->next(next)) != NULL) {
+        plcrash_async_image_t *image = next->value();
+        plcrash_error_t ret;
+
+        if (!image_parse(list, image) || image->macho_image.symbol_index != NULL)
+            continue;
+
+        size_t remaining = 0;
+        if (memory_limit != 0) {
+            if (used >= memory_limit)
+                break;
+            remaining = memory_limit - used;
+        }
+
+        /* Try the persisted index first */
+        char path[PATH_MAX];
+        bool have_path = (cache_dir != NULL && symbol_index_cache_path(&image->macho_image, cache_dir, path, sizeof(path)));
+        if (have_path && plcrash_nasync_macho_load_symbol_index(&image->macho_image, path, remaining) == PLCRASH_ESUCCESS) {
+            /* Mapped indexes are backed by clean, evictable file pages, but are still counted against the limit */
+            used += plcrash_async_macho_symbol_index_size(&image->macho_image);
+            continue;
+        }
+
+        /* Images whose index would exceed the remaining budget are skipped; smaller images may still fit. */
+        if ((ret = plcrash_nasync_macho_build_symbol_index(&image->macho_image, remaining)) != PLCRASH_ESUCCESS) {
+            PLCF_DEBUG("Failed to build symbol index for %s: %d", image->macho_image.name, ret);
+            continue;
+        }
+
+        if (have_path) {
+            if ((ret = plcrash_nasync_macho_write_symbol_index(&image->macho_image, path)) == PLCRASH_ESUCCESS)
+                persisted = true;
+            else
+                PLCF_DEBUG("Failed to persist symbol index for %s: %d", image->macho_image.name, ret);
+        }
+
+        used += plcrash_async_macho_symbol_index_size(&image->macho_image);
+    }
+
+    /* Bound the cache directory as it grows; indexes are only added when written above */
+    if (persisted)
+        symbol_index_cache_prune(list, cache_dir);
+    list->_list->set_reading(false);
+
+    return used;
+}
+
+/**
+ * Decode the LC_FUNCTION_STARTS tables (see plcrash_nasync_macho_build_function_starts()) of any images in @a list
+ * that do not yet have a decoded table, stopping once the total memory allocated for decoded tables would exceed
+ * @a memory_limit.
+ *
+ * As with plcrash_nasync_image_list_build_symbol_indexes(), the tables are published atomically, and this function
+ * may be called from a background thread concurrently with both async-safe readers and list mutation.
+ *
+ * @param list The list to be indexed.
+ * @param memory_limit The maximum number of bytes to be allocated for all decoded tables in @a list, including
+ * any tables that have already been built, or 0 for no limit.
+ *
+ * @return Returns the total number of bytes allocated for decoded function starts in @a list.
+ *
+ * @warning This method is not async safe.
+ */
+size_t plcrash_nasync_image_list_build_function_starts (plcrash_async_image_list_t *list, size_t memory_limit) {
+    size_t used = 0;
+
+    list->_list->set_reading(true);
+    async_list<plcrash_async_image_t *>::node *next = NULL;
+
+    /* Account for existing tables first, so that the limit applies to the list as a whole */
+    while ((next = list->_list->next(next)) != NULL) {
+        if (next->value()->state == PLCRASH_ASYNC_IMAGE_PARSED)
+            used += plcrash_async_macho_function_starts_size(&next->value()->macho_image);
+    }
+
+    while ((next = list->_list->next(next)) != NULL) {
+        plcrash_async_image_t *image = next->value();
+        plcrash_error_t ret;
+
+        if (!image_parse(list, image) || image->macho_image.function_starts != NULL)
+            continue;
+
+        size_t remaining = 0;
+        if (memory_limit != 0) {
+            if (used >= memory_limit)
+                break;
+            remaining = memory_limit - used;
+        }
+
+        if ((ret = plcrash_nasync_macho_build_function_starts(&image->macho_image, remaining)) != PLCRASH_ESUCCESS) {
+            if (ret != PLCRASH_ENOTFOUND)
+                PLCF_DEBUG("Failed to decode function starts for %s: %d", image->macho_image.name, ret);
+            continue;
+        }
+
+        used += plcrash_async_macho_function_starts_size(&image->macho_image);
+    }
+    list->_list->set_reading(false);
+
+    return used;
+}
+
+static void image_list_append (plcrash_async_image_list_t *list, const pl_vm_address_t *headers, const char * const *names, size_t count);
+
+/**
+ * Append a new binary image record to @a list. If an encoder has been configured via
+ * plcrash_nasync_image_list_set_encoder(), the image's crash report record will be pre-encoded.
+ *
+ * @param list The list to which the image record should be appended.
+ * @param header The image's header address.
+ * @param name The image's name.
+ *
+ * @warning This method is not async safe.
+ */
+void plcrash_nasync_image_list_append (plcrash_async_image_list_t *list, pl_vm_address_t header, const char *name) {
+    image_list_append(list, &header, &name, 1);
+}
+
+/**
+ * Append a batch of binary image records to @a list, with a single acquisition of the list's write lock and a
+ * single snapshot publication. Images are appended in the order given; any image that can not be parsed is skipped.
+ *
+ * @param list The list to which the image records should be appended.
+ * @param headers The images' header addresses.
+ * @param names The images' names.
+ * @param count The number of entries in @a headers and @a names.
+ *
+ * @warning This method is not async safe.
+ */
+void plcrash_nasync_image_list_append_batch (plcrash_async_image_list_t *list, const pl_vm_address_t *headers, const char * const *names, size_t count) {
+    image_list_append(list, headers, names, count);
+}
+
+/**
+ * @internal
+ *
+ * An entry in an image list's header table, mapping an image's header address to its list node.
+ */
+struct plcrash_async_image_header_slot {
+    /** The image's header address. */
+    pl_vm_address_t header;
+
+    /** The image's list node, or NULL if the slot is empty. */
+    async_list<plcrash_async_image_t *>::node *node;
+};
+
+/* Return the home slot of @a header in a table of @a slot_count slots. */
+static size_t header_slot_hash (pl_vm_address_t header, size_t slot_count) {
+    /* Image headers are page-aligned; discard the low bits before mixing */
+    uint64_t hash = ((uint64_t) header >> 12) * 0x9E3779B97F4A7C15ULL;
+    return (size_t) (hash >> 32) & (slot_count - 1);
+}
+
+/**
+ * @internal
+ *
+ * Insert @a node into @a slots. Only the first node registered for a header is indexed; duplicates are found by
+ * scanning the list.
+ *
+ * @return Returns true if a slot was occupied, or false if @a header was already present.
+ */
+static bool header_slots_put (struct plcrash_async_image_header_slot *slots, size_t slot_count, pl_vm_address_t header, async_list<plcrash_async_image_t *>::node *node) {
+    size_t i = header_slot_hash(header, slot_count);
+    while (slots[i].node != NULL) {
+        if (slots[i].header == header)
+            return false;
+        i = (i + 1) & (slot_count - 1);
+    }
+
+    slots[i].header = header;
+    slots[i].node = node;
+    return true;
+}
+
+/**
+ * @internal
+ *
+ * Ensure that @a list's header table has room for @a additional entries, maintaining a load factor of at most 1/2.
+ *
+ * @return Returns false if the table could not be grown.
+ *
+ * @warning This method is not async safe, and must be called with the index lock held.
+ */
+static bool header_table_reserve (plcrash_async_image_list_t *list, size_t additional) {
+    size_t needed = list->_header_count + additional;
+    if (needed * 2 <= list->_header_slot_count)
+        return true;
+
+    size_t slot_count = list->_header_slot_count > 0 ? list->_header_slot_count : 64;
+    while (needed * 2 > slot_count)
+        slot_count *= 2;
+
+    struct plcrash_async_image_header_slot *slots = (struct plcrash_async_image_header_slot *) calloc(slot_count, sizeof(*slots));
+    if (slots == NULL)
+        return false;
+
+    for (size_t i = 0; i < list->_header_slot_count; i++) {
+        if (list->_header_slots[i].node != NULL)
+            header_slots_put(slots, slot_count, list->_header_slots[i].header, list->_header_slots[i].node);
+    }
+
+    if (list->_header_slots != NULL)
+        free(list->_header_slots);
+
+    list->_header_slots = slots;
+    list->_header_slot_count = slot_count;
+    return true;
+}
+
+/**
+ * @internal
+ *
+ * Remove and return the node registered for @a header in @a list's header table, or NULL if none is registered.
+ *
+ * @warning This method is not async safe, and must be called with the index lock held.
+ */
+static async_list<plcrash_async_image_t *>::node *header_table_remove (plcrash_async_image_list_t *list, pl_vm_address_t header) {
+    if (list->_header_slot_count == 0)
+        return NULL;
+
+    struct plcrash_async_image_header_slot *slots = list->_header_slots;
+    size_t mask = list->_header_slot_count - 1;
+
+    size_t i = header_slot_hash(header, list->_header_slot_count);
+    while (slots[i].node != NULL && slots[i].header != header)
+        i = (i + 1) & mask;
+
+    async_list<plcrash_async_image_t *>::node *node = slots[i].node;
+    if (node == NULL)
+        return NULL;
+
+    /* Backward-shift the following run into the vacated slot, so that no tombstones are required */
+    for (size_t j = (i + 1) & mask; slots[j].node != NULL; j = (j + 1) & mask) {
+        size_t home = header_slot_hash(slots[j].header, list->_header_slot_count);
+
+        /* Entries whose home lies cyclically within (i, j] must remain in place */
+        bool in_place = (i <= j) ? (home > i && home <= j) : (home > i || home <= j);
+        if (!in_place) {
+            slots[i] = slots[j];
+            i = j;
+        }
+    }
+
+    slots[i].node = NULL;
+    list->_header_count--;
+    return node;
+}
+
+/**
+ * @internal
+ *
+ * Allocate and initialize a new image record, parsing and preparing it unless lazy parsing has been enabled.
+ * The record holds its own copy of @a name.
+ *
+ * @return Returns the new record, or NULL on failure.
+ */
+static plcrash_async_image_t *image_create (plcrash_async_image_list_t *list, pl_vm_address_t header, const char *name) {
+    plcrash_async_image_t *new_entry = (plcrash_async_image_t *) calloc(1, sizeof(plcrash_async_image_t));
+    if (new_entry == NULL)
+        return NULL;
+
+    new_entry->header_addr = header;
+    new_entry->state = PLCRASH_ASYNC_IMAGE_UNPARSED;
+    if ((new_entry->name = strdup(name)) == NULL) {
+        free(new_entry);
+        return NULL;
+    }
+
+    /* Parse and prepare the image now, unless deferred until first use */
+    if (!list->lazy_parsing) {
+        if (!image_parse(list, new_entry)) {
+            image_free(new_entry);
+            return NULL;
+        }
+
+        image_prepare(list, new_entry);
+
+        /* The image has not yet been published; release its load command mapping until required at crash time */
+        plcrash_nasync_macho_release_load_commands(&new_entry->macho_image);
+    }
+
+    return new_entry;
+}
+
+/**
+ * @internal
+ *
+ * Append @a count initialized image records to @a list, and publish a single updated snapshot.
+ *
+ * @warning This method is not async safe.
+ */
+static void image_list_insert (plcrash_async_image_list_t *list, plcrash_async_image_t **images, size_t count) {
+    /* Sort the new images' snapshot entries; these are merged with the existing address-sorted entries */
+    plcrash_async_image_index_entry_t single;
+    plcrash_async_image_index_entry_t *added = (count == 1) ? &single : (plcrash_async_image_index_entry_t *) malloc(count * sizeof(*added));
+    if (added != NULL) {
+        for (size_t i = 0; i < count; i++)
+            image_index_entry_init(&added[i], images[i]);
+        qsort(added, count, sizeof(*added), image_index_entry_compare);
+    }
+
+    OSSpinLockLock(&list->_index_lock); {
+        struct plcrash_async_image_index *old = list->_index;
+        struct plcrash_async_image_index *index;
+
+        /* Append, indexing the images by header. If the table can't be grown, removal falls back on scanning the list. */
+        bool indexed = header_table_reserve(list, count);
+        for (size_t i = 0; i < count; i++) {
+            async_list<plcrash_async_image_t *>::node *node = list->_list->nasync_append(images[i]);
+            OSAtomicCompareAndSwapPtrBarrier(NULL, (void *) node, (void * volatile *) &images[i]->_node);
+
+            if (indexed && header_slots_put(list->_header_slots, list->_header_slot_count, images[i]->header_addr, node))
+                list->_header_count++;
+        }
+
+        /* Merge the new images into a copy of the current snapshot. If no snapshot is available (the list was empty,
+         * or a prior allocation failed), rebuild it from the list. */
+        if (old != NULL && added != NULL && (index = image_index_alloc(old->count + count)) != NULL) {
+            size_t o = 0;
+            size_t a = 0;
+            for (size_t i = 0; i < index->count; i++) {
+                if (a == count || (o < old->count && old->entries[o].start <= added[a].start))
+                    index->entries[i] = old->entries[o++];
+                else
+                    index->entries[i] = added[a++];
+            }
+
+            memcpy(&index->images[0], &old->images[0], old->count * sizeof(old->images[0]));
+            memcpy(&index->images[old->count], images, count * sizeof(images[0]));
+        } else {
+            index = image_index_build(list);
+        }
+
+        image_index_publish(list, index);
+    } OSSpinLockUnlock(&list->_index_lock);
+
+    if (added != &single && added != NULL)
+        free(added);
+}
+
+/**
+ * Shared implementation of plcrash_nasync_image_list_append(), plcrash_nasync_image_list_append_batch(), and
+ * the local image registration functions. The names are copied, and need only remain valid for the duration of
+ * the call.
+ */
+static void image_list_append (plcrash_async_image_list_t *list, const pl_vm_address_t *headers, const char * const *names, size_t count) {
+    plcrash_async_image_t *single;
+    plcrash_async_image_t **images = (count == 1) ? &single : (plcrash_async_image_t **) malloc(count * sizeof(*images));
+    if (images == NULL) {
+        /* Fall back on appending individually */
+        for (size_t i = 0; i < count; i++)
+            image_list_append(list, &headers[i], &names[i], 1);
+        return;
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++) {
+        if ((images[n] = image_create(list, headers[i], names[i])) != NULL)
+            n++;
+    }
+
+    if (n > 0)
+        image_list_insert(list, images, n);
+
+    if (images != &single)
+        free(images);
+}
+
+/* Compare two image pointers */
+static int image_pointer_compare (const void *a, const void *b) {
+    uintptr_t lhs = (uintptr_t) *(plcrash_async_image_t * const *) a;
+    uintptr_t rhs = (uintptr_t) *(plcrash_async_image_t * const *) b;
+
+    if (lhs < rhs)
+        return -1;
+    else if (lhs > rhs)
+        return 1;
+    return 0;
+}
+
+/**
+ * Remove a binary image record from @a list.
+ *
+ * @param header The header address of the record to be removed. The first record matching this address will be removed. If no matching
+ * header is found, the request will be ignored.
+ *
+ * @warning This method is not async safe.
+ */
+void plcrash_nasync_image_list_remove (plcrash_async_image_list_t *list, pl_vm_address_t header) {
+    plcrash_nasync_image_list_remove_batch(list, &header, 1);
+}
+
+/**
+ * Remove a batch of binary image records from @a list, with a single acquisition of the list's write lock and a
+ * single snapshot publication.
  *
- * Maintains a linked list of binary images with support for async-safe iteration. Writing may occur concurrently with
- * async-safe reading, but is not async-safe.
+ * @param headers The header addresses of the records to be removed. For each address, the first matching record will be removed;
+ * addresses for which no matching record is found are ignored.
+ * @param count The number of entries in @a headers.
  *
- * Atomic compare and swap is used to ensure a consistent view of the list for readers. To simplify implementation, a
- * write mutex is held for all updates; the implementation is not designed for efficiency in the face of contention
- * between readers and writers, and it's assumed that no contention should realistically occur.
- * @{
+ * @warning This method is not async safe.
  */
+void plcrash_nasync_image_list_remove_batch (plcrash_async_image_list_t *list, const pl_vm_address_t *headers, size_t count) {
+    /* The images may not yet have been registered */
+    plcrash_nasync_image_list_flush_deferred(list);
+
+    plcrash_async_image_t *single;
+    plcrash_async_image_t **removed = (count == 1) ? &single : (plcrash_async_image_t **) malloc(count * sizeof(*removed));
+    if (removed == NULL) {
+        /* Fall back on removing individually */
+        for (size_t i = 0; i < count; i++)
+            plcrash_nasync_image_list_remove(list, headers[i]);
+        return;
+    }
+
+    OSSpinLockLock(&list->_index_lock);
+    list->_list->set_reading(true); {
+        size_t n = 0;
+        for (size_t i = 0; i < count; i++) {
+            /* Find a matching entry. Duplicate headers, and images that could not be indexed, require a scan. */
+            async_list<plcrash_async_image_t *>::node *found = header_table_remove(list, headers[i]);
+            if (found == NULL) {
+                async_list<plcrash_async_image_t *>::node *next = NULL;
+                while ((next = list->_list->next(next)) != NULL) {
+                    if (next->value()->header_addr == headers[i]) {
+                        found = next;
+                        break;
+                    }
+                }
+            }
+
+            /* If not found, nothing to do */
+            if (found == NULL) {
+                PLCF_DEBUG("Can't find header addr=%llu in Mach-O image list.", (uint64_t) headers[i]);
+                continue;
+            }
+
+            /* Delete the entry */
+            removed[n++] = found->value();
+            list->_list->nasync_remove_node(found);
+        }
+
+        if (n > 0) {
+            qsort(removed, n, sizeof(removed[0]), image_pointer_compare);
+
+            /* Drop the images from a copy of the current snapshot, or rebuild the snapshot if none is available. */
+            struct plcrash_async_image_index *old = list->_index;
+            struct plcrash_async_image_index *index;
+            if (old != NULL && old->count >= n && (index = image_index_alloc(old->count - n)) != NULL) {
+                size_t e = 0;
+                size_t m = 0;
+                for (size_t i = 0; i < old->count; i++) {
+                    if (e < index->count && bsearch(&old->entries[i].image, removed, n, sizeof(removed[0]), image_pointer_compare) == NULL)
+                        index->entries[e++] = old->entries[i];
+
+                    if (m < index->count && bsearch(&old->images[i], removed, n, sizeof(removed[0]), image_pointer_compare) == NULL)
+                        index->images[m++] = old->images[i];
+                }
+                index->count = e < m ? e : m;
+            } else {
+                index = image_index_build(list);
+            }
+
+            image_index_publish(list, index);
+            OSAtomicIncrement32Barrier((volatile int32_t *) &list->removal_generation);
+        }
+    } list->_list->set_reading(false);
+    OSSpinLockUnlock(&list->_index_lock);
 
+    if (removed != &single)
+        free(removed);
+}
 
 /**
- * Initialize a new binary image list and issue a memory barrier
+ * Enable deferred registration of images appended via plcrash_nasync_image_list_defer_append(). Deferred
+ * registrations are recorded in a fixed-size buffer of @a capacity entries; once the buffer has been exhausted,
+ * images will be registered immediately.
  *
- * @param list The list structure to be initialized.
- * @param task The mach task from which all images will be mapped.
+ * Image names are resolved via dladdr(), and deferral may only be enabled for a list targeting the current task.
  *
- * @warning This method is not async safe.
+ * @param list The list to be configured.
+ * @param capacity The maximum number of registrations that may be deferred.
+ *
+ * @warning This method is not async safe, and must be called prior to any calls to
+ * plcrash_nasync_image_list_defer_append().
  */
-void plcrash_nasync_image_list_init (plcrash_async_image_list_t *list, mach_port_t task) {
-    memset(list, 0, sizeof(*list));
+void plcrash_nasync_image_list_set_deferred (plcrash_async_image_list_t *list, size_t capacity) {
+    PLCF_ASSERT(list->task == mach_task_self());
+    PLCF_ASSERT(list->_pending == NULL);
+    PLCF_ASSERT(capacity <= INT32_MAX);
 
-    list->_list = new async_list<plcrash_async_image_t *>();
-    list->task = task;
-    mach_port_mod_refs(mach_task_self(), list->task, MACH_PORT_RIGHT_SEND, 1);
+    list->_pending = (plcrash_async_image_pending_t *) calloc(capacity, sizeof(plcrash_async_image_pending_t));
+    if (list->_pending == NULL) {
+        PLCF_DEBUG("Failed to allocate deferred image buffer of %zu entries", capacity);
+        return;
+    }
+
+    list->_pending_capacity = (int32_t) capacity;
+    OSMemoryBarrier();
 }
 
 /**
- * Free any binary image list resources.
+ * @internal
+ * A dyld image path, as recorded in the dyld_all_image_infos image array.
+ */
+typedef struct image_path {
+    /** The image's header address. */
+    pl_vm_address_t header;
+
+    /** The dyld-owned image path. */
+    const char *path;
+} image_path_t;
+
+/* qsort/bsearch comparison for image_path_t, by header address. */
+static int image_path_compare (const void *a, const void *b) {
+    pl_vm_address_t lhs = ((const image_path_t *) a)->header;
+    pl_vm_address_t rhs = ((const image_path_t *) b)->header;
+
+    if (lhs < rhs)
+        return -1;
+    else if (lhs > rhs)
+        return 1;
+    return 0;
+}
+
+/**
+ * @internal
  *
- * @warning This method is not async safe.
+ * Resolve the dyld-owned paths of the @a count images in the current task at @a headers, with a single read of
+ * dyld's image info array. Images that are not (yet) present in the array are resolved via dladdr().
+ *
+ * @param headers The header addresses of the images to be resolved.
+ * @param paths On return, the image paths, or NULL for any image that could not be resolved. These strings are
+ * owned by dyld, and remain valid until the corresponding image is unloaded.
+ * @param count The number of entries in @a headers and @a paths.
  */
-void plcrash_nasync_image_list_free (plcrash_async_image_list_t *list) {
-    /* Clean up the image structures */
-    list->_list->set_reading(true);
-    async_list<plcrash_async_image_t *>::node *next = NULL;
-    while ((next = list->_list->next(next)) != NULL) {
-        plcrash_async_image_t *image = next->value();
-        
-        /* Deallocate the Mach-O reference. */
-        plcrash_nasync_macho_free(&image->macho_image);
-        
-        /* Deallocate the actual image value */
-        free(image);
+static void image_list_resolve_paths (const pl_vm_address_t *headers, const char **paths, size_t count) {
+    image_path_t *table = NULL;
+    size_t table_count = 0;
+
+    /* Fetch a copy of dyld's image array. dyld clears infoArray while it is being modified, in which case we
+     * fall back on dladdr() */
+    struct task_dyld_info dyld_info;
+    mach_msg_type_number_t info_count = TASK_DYLD_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_DYLD_INFO, (task_info_t) &dyld_info, &info_count) == KERN_SUCCESS) {
+        const struct dyld_all_image_infos *infos = (const struct dyld_all_image_infos *) (uintptr_t) dyld_info.all_image_info_addr;
+        const struct dyld_image_info *array = infos->infoArray;
+        uint32_t array_count = infos->infoArrayCount;
+
+        struct dyld_image_info *copy = NULL;
+        if (array != NULL && array_count > 0 && (copy = (struct dyld_image_info *) malloc(array_count * sizeof(*copy))) != NULL) {
+            if (plcrash_async_task_memcpy(mach_task_self(), (pl_vm_address_t) array, 0, copy, array_count * sizeof(*copy)) == PLCRASH_ESUCCESS &&
+                (table = (image_path_t *) malloc(array_count * sizeof(*table))) != NULL)
+            {
+                for (uint32_t i = 0; i < array_count; i++) {
+                    table[i].header = (pl_vm_address_t) copy[i].imageLoadAddress;
+                    table[i].path = copy[i].imageFilePath;
+                }
+                table_count = array_count;
+                qsort(table, table_count, sizeof(*table), image_path_compare);
+            }
+            free(copy);
+        }
     }
-    list->_list->set_reading(false);
 
-    /* Free the backing list */
-    delete list->_list;
-    
-    mach_port_mod_refs(mach_task_self(), list->task, MACH_PORT_RIGHT_SEND, -1);
+    for (size_t i = 0; i < count; i++) {
+        paths[i] = NULL;
+
+        image_path_t key = { headers[i], NULL };
+        const image_path_t *found;
+        if (table != NULL && (found = (const image_path_t *) bsearch(&key, table, table_count, sizeof(*table), image_path_compare)) != NULL)
+            paths[i] = found->path;
+
+        if (paths[i] == NULL) {
+            Dl_info info;
+            if (dladdr((const void *) headers[i], &info) != 0) {
+                paths[i] = info.dli_fname;
+            } else {
+                PLCF_DEBUG("dladdr(%p, ...) failed", (const void *) headers[i]);
+            }
+        }
+    }
+
+    if (table != NULL)
+        free(table);
 }
 
 /**
- * Append a new binary image record to @a list.
+ * Append the image at @a header in the current task to @a list. The image's path is sourced from dyld's image
+ * info, and copied; dyld's string may be freed once the image is unloaded, while the record may remain referenced
+ * by a reader (for example, a live report being symbolicated after its threads were resumed).
  *
- * @param list The list to which the image record should be appended.
+ * @param list The list to which the image record should be appended. The list must target the current task.
  * @param header The image's header address.
- * @param name The image's name.
  *
  * @warning This method is not async safe.
  */
-void plcrash_nasync_image_list_append (plcrash_async_image_list_t *list, pl_vm_address_t header, const char *name) {
-    plcrash_error_t ret;
+void plcrash_nasync_image_list_append_local (plcrash_async_image_list_t *list, pl_vm_address_t header) {
+    PLCF_ASSERT(list->task == mach_task_self());
 
-    /* Initialize the new entry. */
-    plcrash_async_image_t *new_entry = (plcrash_async_image_t *) calloc(1, sizeof(plcrash_async_image_t));
-    if ((ret = plcrash_nasync_macho_init(&new_entry->macho_image, list->task, name, header)) != PLCRASH_ESUCCESS) {
-        PLCF_DEBUG("Unexpected failure initializing Mach-O structure for %s: %d", name, ret);
-        free(new_entry);
+    const char *path;
+    image_list_resolve_paths(&header, &path, 1);
+    if (path == NULL)
         return;
+
+    image_list_append(list, &header, &path, 1);
+}
+
+/**
+ * @internal
+ *
+ * Copy the NUL-terminated string at @a address in @a task to @a buffer. Reads are split at page boundaries, and do
+ * not extend beyond the page containing the string's terminator. Strings longer than @a size are truncated.
+ */
+static plcrash_error_t image_list_read_task_string (mach_port_t task, pl_vm_address_t address, char *buffer, size_t size) {
+    /* The smallest supported VM page size */
+    const pl_vm_size_t page_size = 4096;
+
+    size_t copied = 0;
+    while (copied < size) {
+        pl_vm_address_t pos = address + copied;
+        size_t chunk = (size_t) (page_size - (pos & (page_size - 1)));
+        if (chunk > size - copied)
+            chunk = size - copied;
+
+        plcrash_error_t err = plcrash_async_task_memcpy(task, pos, 0, buffer + copied, chunk);
+        if (err != PLCRASH_ESUCCESS)
+            return err;
+
+        if (memchr(buffer + copied, '\0', chunk) != NULL)
+            return PLCRASH_ESUCCESS;
+
+        copied += chunk;
     }
 
-    /* Append */
-    list->_list->nasync_append(new_entry);
+    buffer[size - 1] = '\0';
+    return PLCRASH_ESUCCESS;
 }
 
 /**
- * Remove a binary image record from @a list.
+ * @internal
  *
- * @param header The header address of the record to be removed. The first record matching this address will be removed. If no matching
- * header is found, the request will be ignored.
+ * Read the dyld image array of @a task.
+ *
+ * @param task The target task. The task must share the current task's pointer width.
+ * @param[out] array On success, a malloc()'d copy of the task's image array. The caller is responsible for freeing
+ * the array.
+ * @param[out] count On success, the number of entries in @a array.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or an appropriate error if the task's image infos could not be read.
+ * If dyld is modifying its image array, PLCRASH_EINTERNAL is returned, and the caller may retry.
+ */
+static plcrash_error_t image_list_read_task_infos (mach_port_t task, struct dyld_image_info **array, uint32_t *count) {
+    struct task_dyld_info dyld_info;
+    mach_msg_type_number_t info_count = TASK_DYLD_INFO_COUNT;
+    plcrash_error_t err;
+    kern_return_t kr;
+
+    if ((kr = task_info(task, TASK_DYLD_INFO, (task_info_t) &dyld_info, &info_count)) != KERN_SUCCESS) {
+        PLCF_DEBUG("Could not fetch the target's dyld info: %d", kr);
+        return PLCRASH_EINTERNAL;
+    }
+
+#ifdef __LP64__
+    if (dyld_info.all_image_info_format != TASK_DYLD_ALL_IMAGE_INFO_64) {
+#else
+    if (dyld_info.all_image_info_format != TASK_DYLD_ALL_IMAGE_INFO_32) {
+#endif
+        PLCF_DEBUG("Unsupported dyld image info format %d", dyld_info.all_image_info_format);
+        return PLCRASH_ENOTSUP;
+    }
+
+    /* Only the leading version, infoArrayCount and infoArray fields are required */
+    struct dyld_all_image_infos infos;
+    size_t infos_length = offsetof(struct dyld_all_image_infos, infoArray) + sizeof(infos.infoArray);
+    if ((err = plcrash_async_task_memcpy(task, (pl_vm_address_t) dyld_info.all_image_info_addr, 0, &infos, infos_length)) != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("Could not read the target's dyld image infos: %d", err);
+        return err;
+    }
+
+    /* dyld clears infoArray while it is being modified */
+    if (infos.infoArray == NULL) {
+        PLCF_DEBUG("The target's dyld image array is being modified");
+        return PLCRASH_EINTERNAL;
+    }
+
+    *count = infos.infoArrayCount;
+    *array = (struct dyld_image_info *) malloc((infos.infoArrayCount > 0 ? infos.infoArrayCount : 1) * sizeof(**array));
+    if (*array == NULL)
+        return PLCRASH_ENOMEM;
+
+    if ((err = plcrash_async_task_memcpy(task, (pl_vm_address_t) infos.infoArray, 0, *array, infos.infoArrayCount * sizeof(**array))) != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("Could not read the target's dyld image array: %d", err);
+        free(*array);
+        return err;
+    }
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * @internal
+ *
+ * Append the @a count images of @a array, as read from @a list's target task, copying each image's path from the task.
+ * Images with unreadable paths are recorded without a name.
+ */
+static plcrash_error_t image_list_append_task_infos (plcrash_async_image_list_t *list, const struct dyld_image_info *array, uint32_t count) {
+    plcrash_error_t err = PLCRASH_ESUCCESS;
+
+    if (count == 0)
+        return PLCRASH_ESUCCESS;
+
+    pl_vm_address_t *headers = (pl_vm_address_t *) malloc(count * sizeof(*headers));
+    const char **names = (const char **) malloc(count * sizeof(*names));
+    char *paths = (char *) malloc(count * PATH_MAX);
+    if (headers == NULL || names == NULL || paths == NULL) {
+        err = PLCRASH_ENOMEM;
+        goto cleanup;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        char *path = paths + ((size_t) i * PATH_MAX);
+        if (array[i].imageFilePath == NULL || image_list_read_task_string(list->task, (pl_vm_address_t) array[i].imageFilePath, path, PATH_MAX) != PLCRASH_ESUCCESS)
+            path[0] = '\0';
+
+        headers[i] = (pl_vm_address_t) array[i].imageLoadAddress;
+        names[i] = path;
+    }
+
+    image_list_append(list, headers, names, count);
+
+cleanup:
+    free(headers);
+    free(names);
+    free(paths);
+    return err;
+}
+
+/**
+ * Append all images registered with dyld in @a list's target task. The images are read from the task's
+ * dyld_all_image_infos, and their paths are copied; this may be used to populate a list for a task other than the
+ * current task, such as from an out-of-process crash reporting helper.
+ *
+ * @param list The list to which the image records should be appended. The target task must share the current
+ * task's pointer width.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or an appropriate error if the task's image infos could not be read.
+ * If dyld is modifying its image array, PLCRASH_EINTERNAL is returned, and the caller may retry.
  *
  * @warning This method is not async safe.
  */
-void plcrash_nasync_image_list_remove (plcrash_async_image_list_t *list, pl_vm_address_t header) {
+plcrash_error_t plcrash_nasync_image_list_append_task_images (plcrash_async_image_list_t *list) {
+    struct dyld_image_info *array;
+    uint32_t count;
+    plcrash_error_t err;
+
+    if ((err = image_list_read_task_infos(list->task, &array, &count)) != PLCRASH_ESUCCESS)
+        return err;
+
+    err = image_list_append_task_infos(list, array, count);
+    free(array);
+    return err;
+}
+
+/* Compare two pl_vm_address_t values */
+static int image_header_compare (const void *a, const void *b) {
+    pl_vm_address_t lhs = *(const pl_vm_address_t *) a;
+    pl_vm_address_t rhs = *(const pl_vm_address_t *) b;
+
+    if (lhs < rhs)
+        return -1;
+    else if (lhs > rhs)
+        return 1;
+    return 0;
+}
+
+/**
+ * Synchronize @a list with the images currently registered with dyld in @a list's target task. Images that have been
+ * loaded since the list was last synchronized are appended, and images that have since been unloaded are removed;
+ * all other images -- and any symbol indexes built for them -- are retained. This allows a list to be maintained
+ * cheaply across repeated snapshots of a long-lived task.
+ *
+ * @param list The list to be synchronized. The target task must share the current task's pointer width.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or an appropriate error if the task's image infos could not be read.
+ * If dyld is modifying its image array, PLCRASH_EINTERNAL is returned, the list is left unmodified, and the caller
+ * may retry.
+ *
+ * @warning This method is not async safe.
+ */
+plcrash_error_t plcrash_nasync_image_list_sync_task_images (plcrash_async_image_list_t *list) {
+    struct dyld_image_info *array;
+    uint32_t count;
+    plcrash_error_t err;
+
+    if ((err = image_list_read_task_infos(list->task, &array, &count)) != PLCRASH_ESUCCESS)
+        return err;
+
+    /* Fetch the headers of the currently registered images */
+    size_t existing_count = plcrash_nasync_image_list_count(list, NULL);
+    size_t alloc_count = existing_count > 0 ? existing_count : 1;
+    pl_vm_address_t *existing = (pl_vm_address_t *) malloc(alloc_count * sizeof(*existing));
+    pl_vm_address_t *stale = (pl_vm_address_t *) malloc(alloc_count * sizeof(*stale));
+    pl_vm_address_t *current = (pl_vm_address_t *) malloc((count > 0 ? count : 1) * sizeof(*current));
+    size_t retained = 0;
+    size_t stale_count = 0;
+    uint32_t added = 0;
+    if (existing == NULL || stale == NULL || current == NULL) {
+        err = PLCRASH_ENOMEM;
+        goto cleanup;
+    }
+
+    /* Unparsed images are included; only the header address is required */
     list->_list->set_reading(true); {
-        /* Find a matching entry */
-        async_list<plcrash_async_image_t *>::node *found = NULL;
+        size_t n = 0;
         async_list<plcrash_async_image_t *>::node *next = NULL;
-        while ((next = list->_list->next(next)) != NULL) {
-            if (next->value()->macho_image.header_addr == header) {
-                found = next;
-                break;
-            }
+        while ((next = list->_list->next(next)) != NULL && n < existing_count)
+            existing[n++] = next->value()->header_addr;
+        existing_count = n;
+    } list->_list->set_reading(false);
+
+    for (uint32_t i = 0; i < count; i++)
+        current[i] = (pl_vm_address_t) array[i].imageLoadAddress;
+    qsort(current, count, sizeof(current[0]), image_header_compare);
+
+    /* Remove unloaded images */
+    for (size_t i = 0; i < existing_count; i++) {
+        if (bsearch(&existing[i], current, count, sizeof(current[0]), image_header_compare) != NULL)
+            existing[retained++] = existing[i];
+        else
+            stale[stale_count++] = existing[i];
+    }
+
+    if (stale_count > 0)
+        plcrash_nasync_image_list_remove_batch(list, stale, stale_count);
+
+    /* Append newly loaded images in dyld order, compacting them to the front of the image array */
+    qsort(existing, retained, sizeof(existing[0]), image_header_compare);
+    for (uint32_t i = 0; i < count; i++) {
+        pl_vm_address_t header = (pl_vm_address_t) array[i].imageLoadAddress;
+        if (bsearch(&header, existing, retained, sizeof(existing[0]), image_header_compare) == NULL)
+            array[added++] = array[i];
+    }
+
+    err = image_list_append_task_infos(list, array, added);
+
+cleanup:
+    free(array);
+    free(existing);
+    free(stale);
+    free(current);
+    return err;
+}
+
+/**
+ * Record a deferred registration for the image at @a header. The registration only claims a slot in the
+ * deferred buffer; the image will be parsed and appended to @a list by the next call to
+ * plcrash_nasync_image_list_flush_deferred().
+ *
+ * If deferral has not been enabled, or the deferred buffer has been exhausted, the image will be registered
+ * immediately (after first registering any outstanding deferred images, preserving append order).
+ *
+ * @param list The list to which the image should be appended.
+ * @param header The image's header address.
+ *
+ * @return Returns true if the registration was deferred, in which case the caller is responsible for
+ * (eventually) calling plcrash_nasync_image_list_flush_deferred(), or false if the image was registered immediately.
+ *
+ * @warning This method is not async safe.
+ */
+bool plcrash_nasync_image_list_defer_append (plcrash_async_image_list_t *list, pl_vm_address_t header) {
+    if (list->_pending != NULL) {
+        int32_t slot = OSAtomicIncrement32Barrier(&list->_pending_tail) - 1;
+        if (slot < list->_pending_capacity) {
+            list->_pending[slot].header = header;
+            OSMemoryBarrier();
+            list->_pending[slot].ready = 1;
+            return true;
         }
 
-        /* If not found, nothing to do */
-        if (found == NULL) {
-            PLCF_DEBUG("Can't find header addr=%llu in Mach-O image list.", (uint64_t)header);
-            list->_list->set_reading(false);
-            return;
+        plcrash_nasync_image_list_flush_deferred(list);
+    }
+
+    plcrash_nasync_image_list_append_local(list, header);
+    return false;
+}
+
+/**
+ * Register all images recorded via plcrash_nasync_image_list_defer_append(), in the order in which they were
+ * recorded. Concurrent callers are serialized; once this function returns, every registration deferred prior to
+ * the call will have been appended to @a list.
+ *
+ * @param list The list to be flushed.
+ *
+ * @warning This method is not async safe.
+ */
+void plcrash_nasync_image_list_flush_deferred (plcrash_async_image_list_t *list) {
+    if (list->_pending == NULL)
+        return;
+
+    pthread_mutex_lock(&list->_pending_lock); {
+        int32_t head = list->_pending_head;
+        int32_t tail = list->_pending_tail;
+        if (tail > list->_pending_capacity)
+            tail = list->_pending_capacity;
+
+        if (head < tail) {
+            size_t count = tail - head;
+            pl_vm_address_t *headers = (pl_vm_address_t *) malloc(count * sizeof(*headers));
+            const char **paths = (const char **) malloc(count * sizeof(*paths));
+
+            /* The writers may have claimed their slots, but not yet published their headers */
+            for (size_t i = 0; i < count; i++) {
+                plcrash_async_image_pending_t *pending = &list->_pending[head + i];
+                while (!pending->ready)
+                    sched_yield();
+                OSMemoryBarrier();
+
+                if (headers != NULL)
+                    headers[i] = pending->header;
+            }
+
+            /* Resolve all paths in a single pass over dyld's image info, falling back on per-image resolution
+             * if the batch could not be allocated. */
+            if (headers != NULL && paths != NULL) {
+                image_list_resolve_paths(headers, paths, count);
+
+                /* Drop unresolved images, and append the remainder as a single batch */
+                size_t resolved = 0;
+                for (size_t i = 0; i < count; i++) {
+                    if (paths[i] != NULL) {
+                        headers[resolved] = headers[i];
+                        paths[resolved] = paths[i];
+                        resolved++;
+                    }
+                }
+                image_list_append(list, headers, paths, resolved);
+            } else {
+                for (size_t i = 0; i < count; i++)
+                    plcrash_nasync_image_list_append_local(list, list->_pending[head + i].header);
+            }
+
+            if (headers != NULL)
+                free(headers);
+            if (paths != NULL)
+                free(paths);
+
+            list->_pending_head = tail;
         }
+    } pthread_mutex_unlock(&list->_pending_lock);
+}
 
-        /* Delete the entry */
-        list->_list->nasync_remove_node(found);
-    } list->_list->set_reading(false);
+/**
+ * Return true if @a list has deferred image registrations that have not yet been flushed via
+ * plcrash_nasync_image_list_flush_deferred(). Images with outstanding registrations will not be visible
+ * to readers of the list.
+ *
+ * @param list The list to be queried.
+ */
+bool plcrash_async_image_list_has_deferred (plcrash_async_image_list_t *list) {
+    if (list->_pending == NULL)
+        return false;
+
+    int32_t tail = list->_pending_tail;
+    if (tail > list->_pending_capacity)
+        tail = list->_pending_capacity;
+
+    OSMemoryBarrier();
+    return list->_pending_head < tail;
 }
 
 /**
@@ -158,6 +1630,13 @@ void plcrash_nasync_image_list_remove (plcrash_async_image_list_t *list, pl_vm_a
  * @param enable If true, the list will be retained. If false, released.
  */
 void plcrash_async_image_list_set_reading (plcrash_async_image_list_t *list, bool enable) {
+    if (enable) {
+        /* Once issued, the current snapshot will not be deallocated while a reference is held. */
+        OSAtomicIncrement32Barrier(&list->_index_refcount);
+    } else {
+        OSAtomicDecrement32Barrier(&list->_index_refcount);
+    }
+
     list->_list->set_reading(enable);
 }
 
@@ -165,12 +1644,39 @@ void plcrash_async_image_list_set_reading (plcrash_async_image_list_t *list, boo
  * Return the image containing the given @a address within its TEXT segment. This method is async-safe.
  * If image is found, NULL will be returned.
  *
+ * The lookup is performed via binary search of the list's address-sorted snapshot; if no snapshot is available,
+ * the list is searched linearly.
+ *
  * @param list The list to be iterated.
  * @param address The address to be searched for.
  *
  * @warning The list must be retained for reading via plcrash_async_image_list_set_reading() before calling this function.
  */
 plcrash_async_image_t *plcrash_async_image_containing_address (plcrash_async_image_list_t *list, pl_vm_address_t address) {
+    const struct plcrash_async_image_index *index = list->_index;
+    if (index != NULL) {
+        /* Find the last entry with a start address <= address */
+        size_t lower = 0;
+        size_t upper = index->count;
+        while (lower < upper) {
+            size_t mid = lower + (upper - lower) / 2;
+            if (index->entries[mid].start <= address)
+                lower = mid + 1;
+            else
+                upper = mid;
+        }
+
+        if (lower == 0 || address >= index->entries[lower - 1].end)
+            return NULL;
+
+        /* Images that were unparsed when the snapshot was built have an unknown extent */
+        plcrash_async_image_t *image = index->entries[lower - 1].image;
+        if (!image_parse(list, image) || !plcrash_async_macho_contains_address(&image->macho_image, address))
+            return NULL;
+
+        return image;
+    }
+
     plcrash_async_image_t *image = NULL;
     while ((image = plcrash_async_image_list_next(list, image)) != NULL) {
         if (plcrash_async_macho_contains_address(&image->macho_image, address))
@@ -183,6 +1689,7 @@ plcrash_async_image_t *plcrash_async_image_containing_address (plcrash_async_ima
 
 /**
  * Return the next image record. This method is async-safe. If no additional images are available, will return NULL;
+ * images that have not yet been parsed are parsed on demand, and images that can not be parsed are skipped.
  *
  * @param list The list to be iterated.
  * @param current The current image record, or NULL to start iteration.
@@ -200,15 +1707,100 @@ plcrash_async_image_t *plcrash_async_image_list_next (plcrash_async_image_list_t
         node = list->_list->next(NULL);
     }
 
+    for (; node != NULL; node = list->_list->next(node)) {
+        /* Lazily swap in the cyclic node reference. This is pessimestic, but there's really not a better time to do it. */
+        plcrash_async_image_t *image = node->value();
+        OSAtomicCompareAndSwapPtrBarrier(NULL, (void *) node, (void * volatile *) &image->_node);
+
+        if (image_parse(list, image))
+            return image;
+    }
+
     /* Handle end of list */
-    if (node == NULL)
+    return NULL;
+}
+
+/**
+ * Return the first image record registered with @a name, or NULL if no such image is found, or the image can not be
+ * parsed. This method is async-safe. Only the matching image is parsed; other images are left unparsed.
+ *
+ * @param list The list to be searched.
+ * @param name The image path to search for.
+ *
+ * @warning The list must be retained for reading via plcrash_async_image_list_set_reading() before calling this function.
+ */
+plcrash_async_image_t *plcrash_async_image_list_find_named (plcrash_async_image_list_t *list, const char *name) {
+    for (async_list<plcrash_async_image_t *>::node *node = list->_list->next(NULL); node != NULL; node = list->_list->next(node)) {
+        plcrash_async_image_t *image = node->value();
+        if (image->name == NULL || plcrash_async_strcmp(image->name, name) != 0)
+            continue;
+
+        OSAtomicCompareAndSwapPtrBarrier(NULL, (void *) node, (void * volatile *) &image->_node);
+        return image_parse(list, image) ? image : NULL;
+    }
+
+    return NULL;
+}
+
+/**
+ * Initialize @a cursor for iteration of @a list's images, in the order in which they were appended. This
+ * method is async-safe.
+ *
+ * The cursor iterates the list's current snapshot, which is unaffected by concurrent updates. If no snapshot is
+ * available, the backing list is iterated via plcrash_async_image_list_next().
+ *
+ * @param cursor The cursor to initialize.
+ * @param list The list to be iterated.
+ *
+ * @warning The list must be retained for reading via plcrash_async_image_list_set_reading() before calling this function,
+ * and for as long as the cursor is in use.
+ */
+void plcrash_async_image_cursor_init (plcrash_async_image_cursor_t *cursor, plcrash_async_image_list_t *list) {
+    cursor->list = list;
+    cursor->snapshot = list->_index;
+    cursor->position = 0;
+    cursor->current = NULL;
+}
+
+/**
+ * Return the next image record from @a cursor, or NULL if no additional images are available. This method is async-safe.
+ * Images that have not yet been parsed are parsed on demand, and images that can not be parsed are skipped.
+ *
+ * @param cursor The cursor to be advanced.
+ */
+plcrash_async_image_t *plcrash_async_image_cursor_next (plcrash_async_image_cursor_t *cursor) {
+    if (cursor->snapshot != NULL) {
+        while (cursor->position < cursor->snapshot->count) {
+            plcrash_async_image_t *image = cursor->snapshot->images[cursor->position++];
+            if (image_parse(cursor->list, image))
+                return image;
+        }
+
         return NULL;
-    
-    /* Lazily swap in the cyclic node reference. This is pessimestic, but there's really not a better time to do it. */
-    plcrash_async_image_t *image = node->value();
-    OSAtomicCompareAndSwapPtrBarrier(NULL, (void *) node, (void * volatile *) &image->_node);
+    }
+
+    cursor->current = plcrash_async_image_list_next(cursor->list, cursor->current);
+    return cursor->current;
+}
 
-    return node->value();
+/**
+ * Atomically set @a flags on @a image. This method is async-safe.
+ *
+ * @param image The image to be updated.
+ * @param flags The plcrash_async_image_flags_t values to be set.
+ */
+void plcrash_async_image_set_flags (plcrash_async_image_t *image, uint32_t flags) {
+    OSAtomicOr32Barrier(flags, &image->flags);
+}
+
+/**
+ * Return true if all of @a flags are set on @a image. This method is async-safe.
+ *
+ * @param image The image to be queried.
+ * @param flags The plcrash_async_image_flags_t values to be tested.
+ */
+bool plcrash_async_image_has_flags (plcrash_async_image_t *image, uint32_t flags) {
+    return (image->flags & flags) == flags;
 }
 
 /**
@@ -32,8 +32,10 @@
 #include <stdint.h>
 #include <libkern/OSAtomic.h>
 #include <stdbool.h>
+#include <pthread.h>
 
 #include "PLCrashAsyncMachOImage.h"
+#include "PLCrashAsyncSharedCache.h"
 
 /*
  * NOTE: We keep this code C-compatible for backwards-compatibility purposes. If the entirity
@@ -48,7 +50,70 @@
 extern "C" {
 #endif
 
+/**
+ * @internal
+ * @ingroup plcrash_async_image
+ *
+ * The maximum total size, in bytes, of the persisted symbol index files retained within a symbol index cache
+ * directory (see plcrash_nasync_image_list_build_symbol_indexes()). Indexes of images that are no longer loaded
+ * are pruned, least recently used first, once the directory exceeds this size.
+ */
+#define PLCRASH_ASYNC_IMAGE_LIST_SYMBOL_INDEX_CACHE_LIMIT (32 * 1024 * 1024)
+
 typedef struct plcrash_async_image plcrash_async_image_t;
+struct plcrash_async_image_index;
+struct plcrash_async_image_header_slot;
+
+/**
+ * @internal
+ * @ingroup plcrash_async_image
+ *
+ * Prototype of a function used to pre-encode an image's crash report record at the time the image is added to
+ * an image list. This function is not required to be async-safe.
+ *
+ * @param image The newly initialized Mach-O image.
+ * @param data On success, must be set to a malloc()-allocated buffer containing the encoded record. Ownership
+ * of the buffer is transfered to the image list.
+ * @param length On success, must be set to the length of @a data, in bytes.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or an appropriate error value if the record could not be encoded.
+ */
+typedef plcrash_error_t (*plcrash_async_image_encoder_fn)(plcrash_async_macho_t *image, void **data, size_t *length);
+
+/**
+ * @internal
+ * @ingroup plcrash_async_image
+ *
+ * Unwind hints recorded for a binary image by the frame readers, allowing readers to skip images for which
+ * the required unwind data is known to be unavailable.
+ */
+typedef enum {
+    /** The image does not contain an __unwind_info section. */
+    PLCRASH_ASYNC_IMAGE_NO_COMPACT_UNWIND = 1 << 0,
+
+    /** The image contains neither an __eh_frame nor a __debug_frame section. */
+    PLCRASH_ASYNC_IMAGE_NO_DWARF_UNWIND = 1 << 1,
+} plcrash_async_image_flags_t;
+
+/**
+ * @internal
+ * @ingroup plcrash_async_image
+ *
+ * Parse state of an image's Mach-O data.
+ */
+typedef enum {
+    /** The image has been registered, but not yet parsed. */
+    PLCRASH_ASYNC_IMAGE_UNPARSED = 0,
+
+    /** The image is being parsed. */
+    PLCRASH_ASYNC_IMAGE_PARSING = 1,
+
+    /** The image has been parsed, and its Mach-O data may be used. */
+    PLCRASH_ASYNC_IMAGE_PARSED = 2,
+
+    /** The image could not be parsed. */
+    PLCRASH_ASYNC_IMAGE_PARSE_FAILED = 3,
+} plcrash_async_image_state_t;
 
 /**
  * @internal
@@ -57,9 +122,28 @@ typedef struct plcrash_async_image plcrash_async_image_t;
  * Async-safe binary image list element.
  */
 struct plcrash_async_image {
-    /** The binary image. */
+    /** The binary image. Only valid once @a state is PLCRASH_ASYNC_IMAGE_PARSED; images returned by the list's
+     * accessors have been parsed. */
     plcrash_async_macho_t macho_image;
 
+    /** The image's header address. */
+    pl_vm_address_t header_addr;
+
+    /** The image's name, owned by the list. Borrowed by @a macho_image. */
+    char *name;
+
+    /** The image's plcrash_async_image_state_t parse state. Updated atomically. */
+    volatile int32_t state;
+
+    /** The pre-encoded crash report record for this image, or NULL if unavailable. */
+    void *encoded_record;
+
+    /** The length of @a encoded_record, in bytes. */
+    size_t encoded_record_length;
+
+    /** The image's plcrash_async_image_flags_t unwind hints. Must only be updated via plcrash_async_image_set_flags(). */
+    volatile uint32_t flags;
+
     /** A borrowed, circular reference to the backing list node. */
 #ifdef __cplusplus
     plcrash::async::async_list<plcrash_async_image_t *>::node *_node;
@@ -68,6 +152,20 @@ struct plcrash_async_image {
 #endif
 };
 
+/**
+ * @internal
+ * @ingroup plcrash_async_image
+ *
+ * A deferred image registration, recorded by plcrash_nasync_image_list_defer_append().
+ */
+typedef struct plcrash_async_image_pending {
+    /** The image's header address. */
+    pl_vm_address_t header;
+
+    /** Set once @a header has been written and the registration may be consumed. */
+    volatile int32_t ready;
+} plcrash_async_image_pending_t;
+
 /**
  * @internal
  * @ingroup plcrash_async_image
@@ -79,23 +177,128 @@ typedef struct plcrash_async_image_list {
     /** The Mach task in which all Mach-O images can be found */
     mach_port_t task;
 
+    /** The encoder used to pre-encode newly appended images, or NULL if images should not be pre-encoded. */
+    plcrash_async_image_encoder_fn encoder;
+
+    /** If true, an address-sorted symbol index will be built for newly appended images. */
+    bool index_symbols;
+
+    /** If true, newly appended images are not parsed until first accessed, or until
+     * plcrash_nasync_image_list_parse_images() is called. */
+    bool lazy_parsing;
+
+    /** The task's dyld shared cache, as configured via plcrash_nasync_image_list_set_shared_cache(). If the cache's
+     * size is 0, shared cache images are identified solely by their Mach-O header flags. */
+    plcrash_async_shared_cache_t shared_cache;
+
+    /** Incremented each time images are removed from the list. State derived from the list's images that is retained
+     * across uses of the list (such as a persistent symbol cache) must be discarded when this value changes. */
+    volatile uint32_t removal_generation;
+
     /** The backing list */
 #ifdef __cplusplus
     plcrash::async::async_list<plcrash_async_image_t *> *_list;
 #else
     void *_list;
 #endif
+
+    /** An immutable snapshot of the list's images, in both append and address order, or NULL if the list must be
+     * iterated and searched via the backing list. Replaced atomically on each update. */
+    struct plcrash_async_image_index * volatile _index;
+
+    /** Replaced snapshots that may still be referenced by readers. Guarded by @a _index_lock. */
+    struct plcrash_async_image_index *_retired_indexes;
+
+    /** The number of readers that may hold a reference to @a _index. No snapshots will be deallocated while the
+     * count is greater than 0. */
+    volatile int32_t _index_refcount;
+
+    /** The lock used by writers updating the list and its snapshot. */
+    OSSpinLock _index_lock;
+
+    /** Open-addressed hash table mapping image header addresses to list nodes, used to find images for removal.
+     * Guarded by @a _index_lock. */
+    struct plcrash_async_image_header_slot *_header_slots;
+
+    /** The number of slots in @a _header_slots; always zero or a power of two. */
+    size_t _header_slot_count;
+
+    /** The number of occupied slots in @a _header_slots. */
+    size_t _header_count;
+
+    /** Deferred image registrations, or NULL if deferral has not been enabled via
+     * plcrash_nasync_image_list_set_deferred(). */
+    plcrash_async_image_pending_t *_pending;
+
+    /** The number of slots available in @a _pending. */
+    int32_t _pending_capacity;
+
+    /** The number of @a _pending slots that have been claimed by writers. Updated atomically; may exceed
+     * @a _pending_capacity once the buffer has been exhausted. */
+    volatile int32_t _pending_tail;
+
+    /** The number of @a _pending slots that have been registered. Guarded by @a _pending_lock. */
+    int32_t _pending_head;
+
+    /** The lock serializing registration of deferred images. */
+    pthread_mutex_t _pending_lock;
 } plcrash_async_image_list_t;
 
+/**
+ * @internal
+ * @ingroup plcrash_async_image
+ *
+ * Async-safe binary image list cursor. Iterates the images of an immutable list snapshot, in the order in which
+ * they were appended.
+ */
+typedef struct plcrash_async_image_cursor {
+    /** The list being iterated. */
+    plcrash_async_image_list_t *list;
+
+    /** The snapshot being iterated, or NULL if the backing list must be iterated. */
+    const struct plcrash_async_image_index *snapshot;
+
+    /** The index of the next image within @a snapshot. */
+    size_t position;
+
+    /** The current image, if iterating the backing list. */
+    plcrash_async_image_t *current;
+} plcrash_async_image_cursor_t;
+
 void plcrash_nasync_image_list_init (plcrash_async_image_list_t *list, mach_port_t task);
 void plcrash_nasync_image_list_free (plcrash_async_image_list_t *list);
+void plcrash_nasync_image_list_set_encoder (plcrash_async_image_list_t *list, plcrash_async_image_encoder_fn encoder);
+void plcrash_nasync_image_list_set_symbol_indexing (plcrash_async_image_list_t *list, bool enabled);
+void plcrash_nasync_image_list_set_lazy_parsing (plcrash_async_image_list_t *list, bool enabled);
+void plcrash_nasync_image_list_set_shared_cache (plcrash_async_image_list_t *list, const plcrash_async_shared_cache_t *cache);
+void plcrash_nasync_image_list_parse_images (plcrash_async_image_list_t *list);
+size_t plcrash_nasync_image_list_count (plcrash_async_image_list_t *list, size_t *parsed);
+size_t plcrash_nasync_image_list_build_symbol_indexes (plcrash_async_image_list_t *list, size_t memory_limit, const char *cache_dir);
+size_t plcrash_nasync_image_list_build_function_starts (plcrash_async_image_list_t *list, size_t memory_limit);
 void plcrash_nasync_image_list_append (plcrash_async_image_list_t *list, pl_vm_address_t header, const char *name);
+void plcrash_nasync_image_list_append_local (plcrash_async_image_list_t *list, pl_vm_address_t header);
+plcrash_error_t plcrash_nasync_image_list_append_task_images (plcrash_async_image_list_t *list);
+plcrash_error_t plcrash_nasync_image_list_sync_task_images (plcrash_async_image_list_t *list);
 void plcrash_nasync_image_list_remove (plcrash_async_image_list_t *list, pl_vm_address_t header);
+void plcrash_nasync_image_list_append_batch (plcrash_async_image_list_t *list, const pl_vm_address_t *headers, const char * const *names, size_t count);
+void plcrash_nasync_image_list_remove_batch (plcrash_async_image_list_t *list, const pl_vm_address_t *headers, size_t count);
+
+void plcrash_nasync_image_list_set_deferred (plcrash_async_image_list_t *list, size_t capacity);
+bool plcrash_nasync_image_list_defer_append (plcrash_async_image_list_t *list, pl_vm_address_t header);
+void plcrash_nasync_image_list_flush_deferred (plcrash_async_image_list_t *list);
+bool plcrash_async_image_list_has_deferred (plcrash_async_image_list_t *list);
 
 void plcrash_async_image_list_set_reading (plcrash_async_image_list_t *list, bool enable);
 
 plcrash_async_image_t *plcrash_async_image_containing_address (plcrash_async_image_list_t *list, pl_vm_address_t address);
 plcrash_async_image_t *plcrash_async_image_list_next (plcrash_async_image_list_t *list, plcrash_async_image_t *current);
+plcrash_async_image_t *plcrash_async_image_list_find_named (plcrash_async_image_list_t *list, const char *name);
+
+void plcrash_async_image_cursor_init (plcrash_async_image_cursor_t *cursor, plcrash_async_image_list_t *list);
+plcrash_async_image_t *plcrash_async_image_cursor_next (plcrash_async_image_cursor_t *cursor);
+
+void plcrash_async_image_set_flags (plcrash_async_image_t *image, uint32_t flags);
+bool plcrash_async_image_has_flags (plcrash_async_image_t *image, uint32_t flags);
     
 #ifdef __cplusplus
 }
@@ -34,6 +34,8 @@
 
 #import <dlfcn.h>
 #import <execinfo.h>
+#import <fcntl.h>
+#import <unistd.h>
 
 #import <objc/runtime.h>
 
@@ -92,6 +94,243 @@
 }
 
 
+/* testPreEncodeImage encoder */
+static const char testPreEncodeImage_record[] = "record";
+static plcrash_error_t testPreEncodeImage_encoder (plcrash_async_macho_t *image, void **data, size_t *length) {
+    *data = strdup(testPreEncodeImage_record);
+    *length = sizeof(testPreEncodeImage_record);
+    return PLCRASH_ESUCCESS;
+}
+
+/* Verify that the configured encoder is used to pre-encode appended images */
+- (void) testPreEncodeImage {
+    plcrash_nasync_image_list_set_encoder(&_list, testPreEncodeImage_encoder);
+    plcrash_nasync_image_list_append(&_list, (pl_vm_address_t) _dyld_get_image_header(0), _dyld_get_image_name(0));
+
+    plcrash_async_image_list_set_reading(&_list, true); {
+        plcrash_async_image_t *item = plcrash_async_image_list_next(&_list, NULL);
+        STAssertNotNULL(item, @"Item should not be NULL");
+        STAssertNotNULL(item->encoded_record, @"Image was not pre-encoded");
+        STAssertEquals(item->encoded_record_length, sizeof(testPreEncodeImage_record), @"Incorrect record length");
+        STAssertEqualCStrings((const char *) item->encoded_record, testPreEncodeImage_record, @"Incorrect record value");
+    } plcrash_async_image_list_set_reading(&_list, false);
+}
+
+/* Verify that symbol indexes are built for listed images, and that the reported size matches the indexes built */
+- (void) testBuildSymbolIndexes {
+    plcrash_nasync_image_list_append(&_list, (pl_vm_address_t) _dyld_get_image_header(0), _dyld_get_image_name(0));
+    plcrash_nasync_image_list_append(&_list, (pl_vm_address_t) _dyld_get_image_header(1), _dyld_get_image_name(1));
+
+    size_t used = plcrash_nasync_image_list_build_symbol_indexes(&_list, 0, NULL);
+    size_t expected = 0;
+
+    plcrash_async_image_list_set_reading(&_list, true); {
+        plcrash_async_image_t *item = NULL;
+        while ((item = plcrash_async_image_list_next(&_list, item)) != NULL) {
+            STAssertNotNULL(item->macho_image.symbol_index, @"Image was not indexed");
+            expected += plcrash_async_macho_symbol_index_size(&item->macho_image);
+        }
+    } plcrash_async_image_list_set_reading(&_list, false);
+
+    STAssertEquals(expected, used, @"Incorrect index size");
+
+    /* A second pass must not build new indexes */
+    STAssertEquals(used, plcrash_nasync_image_list_build_symbol_indexes(&_list, 0, NULL), @"Indexes were rebuilt");
+}
+
+/* Verify that persisted indexes of images that are not loaded are pruned once the cache exceeds its limit */
+- (void) testPruneSymbolIndexCache {
+    NSString *cacheDir = [NSTemporaryDirectory() stringByAppendingPathComponent: [[NSProcessInfo processInfo] globallyUniqueString]];
+    STAssertTrue([[NSFileManager defaultManager] createDirectoryAtPath: cacheDir withIntermediateDirectories: YES attributes: nil error: NULL], @"Failed to create cache directory");
+
+    /* A stale index exceeding the cache limit on its own */
+    NSString *stalePath = [cacheDir stringByAppendingPathComponent: @"00000000-0000-0000-0000-000000000000.symidx"];
+    int fd = open([stalePath fileSystemRepresentation], O_WRONLY|O_CREAT|O_TRUNC, 0644);
+    STAssertTrue(fd >= 0, @"Failed to create stale index");
+    STAssertEquals(0, ftruncate(fd, PLCRASH_ASYNC_IMAGE_LIST_SYMBOL_INDEX_CACHE_LIMIT + 1), @"Failed to size stale index");
+    close(fd);
+
+    plcrash_nasync_image_list_append(&_list, (pl_vm_address_t) _dyld_get_image_header(0), _dyld_get_image_name(0));
+    STAssertTrue(plcrash_nasync_image_list_build_symbol_indexes(&_list, 0, [cacheDir fileSystemRepresentation]) > 0, @"No indexes were built");
+
+    /* The stale index must be removed, and the loaded image's index retained */
+    NSArray *files = [[NSFileManager defaultManager] contentsOfDirectoryAtPath: cacheDir error: NULL];
+    STAssertFalse([files containsObject: [stalePath lastPathComponent]], @"Stale index was not pruned");
+    STAssertEquals((NSUInteger) 1, [files count], @"Loaded image's index was not retained: %@", files);
+
+    [[NSFileManager defaultManager] removeItemAtPath: cacheDir error: NULL];
+}
+
+/* Verify that unwind hints may be set and queried */
+- (void) testImageFlags {
+    plcrash_nasync_image_list_append(&_list, (pl_vm_address_t) _dyld_get_image_header(0), _dyld_get_image_name(0));
+
+    plcrash_async_image_list_set_reading(&_list, true); {
+        plcrash_async_image_t *item = plcrash_async_image_list_next(&_list, NULL);
+        STAssertNotNULL(item, @"Item should not be NULL");
+        STAssertFalse(plcrash_async_image_has_flags(item, PLCRASH_ASYNC_IMAGE_NO_COMPACT_UNWIND), @"Flags should not be set on a new image");
+
+        plcrash_async_image_set_flags(item, PLCRASH_ASYNC_IMAGE_NO_COMPACT_UNWIND);
+        STAssertTrue(plcrash_async_image_has_flags(item, PLCRASH_ASYNC_IMAGE_NO_COMPACT_UNWIND), @"Flag was not set");
+        STAssertFalse(plcrash_async_image_has_flags(item, PLCRASH_ASYNC_IMAGE_NO_COMPACT_UNWIND | PLCRASH_ASYNC_IMAGE_NO_DWARF_UNWIND), @"Unset flag reported as set");
+    } plcrash_async_image_list_set_reading(&_list, false);
+}
+
+/* Verify that the cursor iterates images in append order, and that the snapshot is unaffected by later updates */
+- (void) testCursor {
+    for (uint32_t i = 0; i < 4; i++)
+        plcrash_nasync_image_list_append(&_list, (pl_vm_address_t) _dyld_get_image_header(i), _dyld_get_image_name(i));
+    plcrash_nasync_image_list_remove(&_list, (pl_vm_address_t) _dyld_get_image_header(1));
+
+    plcrash_async_image_list_set_reading(&_list, true); {
+        plcrash_async_image_cursor_t cursor;
+        plcrash_async_image_cursor_init(&cursor, &_list);
+        STAssertNotNULL(cursor.snapshot, @"No snapshot available");
+
+        /* Mutations after initialization must not be visible to the cursor */
+        plcrash_nasync_image_list_remove(&_list, (pl_vm_address_t) _dyld_get_image_header(3));
+
+        const uint32_t expected[] = { 0, 2, 3 };
+        for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+            plcrash_async_image_t *item = plcrash_async_image_cursor_next(&cursor);
+            STAssertNotNULL(item, @"Item should not be NULL");
+            STAssertEquals((pl_vm_address_t) _dyld_get_image_header(expected[i]), item->macho_image.header_addr, @"Incorrect image order");
+        }
+        STAssertNULL(plcrash_async_image_cursor_next(&cursor), @"Item should be NULL");
+    } plcrash_async_image_list_set_reading(&_list, false);
+}
+
+/* Test lazy parsing of registered images. */
+- (void) testLazyParsing {
+    plcrash_nasync_image_list_set_lazy_parsing(&_list, true);
+    plcrash_nasync_image_list_append(&_list, (pl_vm_address_t) _dyld_get_image_header(0), _dyld_get_image_name(0));
+    plcrash_nasync_image_list_append(&_list, (pl_vm_address_t) _dyld_get_image_header(1), _dyld_get_image_name(1));
+
+    plcrash_async_image_list_set_reading(&_list, true); {
+        plcrash_async_image_t *item = plcrash_async_image_containing_address(&_list, (pl_vm_address_t) _dyld_get_image_header(1) + 1);
+        STAssertNotNULL(item, @"Failed to find image");
+        STAssertEquals(item->state, (int32_t) PLCRASH_ASYNC_IMAGE_PARSED, @"Image should have been parsed on lookup");
+        STAssertEquals(item->macho_image.header_addr, (pl_vm_address_t) _dyld_get_image_header(1), @"Incorrect image");
+    } plcrash_async_image_list_set_reading(&_list, false);
+
+    plcrash_nasync_image_list_set_encoder(&_list, testPreEncodeImage_encoder);
+    plcrash_nasync_image_list_parse_images(&_list);
+
+    plcrash_async_image_list_set_reading(&_list, true); {
+        plcrash_async_image_t *item = plcrash_async_image_list_next(&_list, NULL);
+        STAssertNotNULL(item, @"Item should not be NULL");
+        STAssertEquals(item->state, (int32_t) PLCRASH_ASYNC_IMAGE_PARSED, @"Image should have been parsed");
+        STAssertNotNULL(item->encoded_record, @"Image should have been pre-encoded");
+    } plcrash_async_image_list_set_reading(&_list, false);
+}
+
+/* Test registration of local images, with paths sourced from dyld and copied into the list. */
+- (void) testAppendLocalImage {
+    plcrash_nasync_image_list_append_local(&_list, (pl_vm_address_t) _dyld_get_image_header(0));
+
+    plcrash_async_image_list_set_reading(&_list, true);
+    plcrash_async_image_t *item = plcrash_async_image_list_next(&_list, NULL);
+    STAssertNotNULL(item, @"Item should not be NULL");
+    STAssertTrue(item->macho_image.name != _dyld_get_image_name(0), @"The image path should not reference dyld's storage");
+    STAssertTrue(item->macho_image.name == item->name, @"The Mach-O image should borrow the list's copy of the path");
+    STAssertTrue(strcmp(item->macho_image.name, _dyld_get_image_name(0)) == 0, @"Incorrect image path: %s", item->macho_image.name);
+    plcrash_async_image_list_set_reading(&_list, false);
+}
+
+/* Test registration of a task's images, as read from the task's dyld image infos. */
+- (void) testAppendTaskImages {
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_image_list_append_task_images(&_list), @"Failed to read the task's images");
+
+    plcrash_async_image_list_set_reading(&_list, true);
+    plcrash_async_image_t *item = plcrash_async_image_list_next(&_list, NULL);
+    STAssertNotNULL(item, @"Item should not be NULL");
+    STAssertTrue(strcmp(item->macho_image.name, _dyld_get_image_name(0)) == 0, @"Incorrect image path: %s", item->macho_image.name);
+    plcrash_async_image_list_set_reading(&_list, false);
+}
+
+/* Test synchronization of a task's images, retaining images that remain loaded. */
+- (void) testSyncTaskImages {
+    /* The already registered image is retained; the remaining images are appended */
+    plcrash_nasync_image_list_append(&_list, (pl_vm_address_t) _dyld_get_image_header(1), _dyld_get_image_name(1));
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_image_list_sync_task_images(&_list), @"Failed to synchronize the task's images");
+    size_t count = plcrash_nasync_image_list_count(&_list, NULL);
+    STAssertTrue(count >= _dyld_image_count(), @"Images were not appended");
+
+    plcrash_async_image_list_set_reading(&_list, true); {
+        /* The previously registered image is retained in place */
+        plcrash_async_image_t *item = plcrash_async_image_list_next(&_list, NULL);
+        STAssertNotNULL(item, @"Item should not be NULL");
+        STAssertEquals((pl_vm_address_t) _dyld_get_image_header(1), item->header_addr, @"The existing image was not retained");
+    } plcrash_async_image_list_set_reading(&_list, false);
+
+    /* A second synchronization is a no-op */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_image_list_sync_task_images(&_list), @"Failed to synchronize the task's images");
+    STAssertEquals(count, plcrash_nasync_image_list_count(&_list, NULL), @"Images were appended twice");
+}
+
+/* Test deferred registration, including exhaustion of the deferred buffer. */
+- (void) testDeferredAppend {
+    plcrash_nasync_image_list_set_deferred(&_list, 2);
+
+    STAssertTrue(plcrash_nasync_image_list_defer_append(&_list, (pl_vm_address_t) _dyld_get_image_header(0)), @"Registration should be deferred");
+    STAssertTrue(plcrash_nasync_image_list_defer_append(&_list, (pl_vm_address_t) _dyld_get_image_header(1)), @"Registration should be deferred");
+    STAssertTrue(plcrash_async_image_list_has_deferred(&_list), @"Registrations should be outstanding");
+
+    plcrash_async_image_list_set_reading(&_list, true);
+    STAssertNULL(plcrash_async_image_list_next(&_list, NULL), @"Deferred images should not be visible");
+    plcrash_async_image_list_set_reading(&_list, false);
+
+    /* Once the buffer is exhausted, outstanding registrations are flushed before registering the image */
+    STAssertFalse(plcrash_nasync_image_list_defer_append(&_list, (pl_vm_address_t) _dyld_get_image_header(2)), @"Registration should not be deferred");
+    STAssertFalse(plcrash_async_image_list_has_deferred(&_list), @"Registrations should have been flushed");
+
+    plcrash_async_image_list_set_reading(&_list, true); {
+        plcrash_async_image_cursor_t cursor;
+        plcrash_async_image_cursor_init(&cursor, &_list);
+        for (uint32_t i = 0; i < 3; i++) {
+            plcrash_async_image_t *item = plcrash_async_image_cursor_next(&cursor);
+            STAssertNotNULL(item, @"Item should not be NULL");
+            STAssertEquals((pl_vm_address_t) _dyld_get_image_header(i), item->macho_image.header_addr, @"Incorrect image order");
+        }
+        STAssertNULL(plcrash_async_image_cursor_next(&cursor), @"Item should be NULL");
+    } plcrash_async_image_list_set_reading(&_list, false);
+}
+
+/* Test batched appending and removal of images. */
+- (void) testBatchAppendRemove {
+    pl_vm_address_t headers[5];
+    const char *names[5];
+    for (uint32_t i = 0; i < 5; i++) {
+        headers[i] = (pl_vm_address_t) _dyld_get_image_header(i);
+        names[i] = _dyld_get_image_name(i);
+    }
+
+    plcrash_nasync_image_list_append_batch(&_list, headers, names, 5);
+
+    /* Remove a batch, including an address that is not in the list */
+    pl_vm_address_t removed[] = { headers[3], 0x1, headers[1] };
+    plcrash_nasync_image_list_remove_batch(&_list, removed, sizeof(removed) / sizeof(removed[0]));
+
+    plcrash_async_image_list_set_reading(&_list, true); {
+        plcrash_async_image_cursor_t cursor;
+        plcrash_async_image_cursor_init(&cursor, &_list);
+
+        const uint32_t expected[] = { 0, 2, 4 };
+        for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+            plcrash_async_image_t *item = plcrash_async_image_cursor_next(&cursor);
+            STAssertNotNULL(item, @"Item should not be NULL");
+            STAssertEquals(headers[expected[i]], item->macho_image.header_addr, @"Incorrect image order");
+
+            /* The address-sorted snapshot must also include the image */
+            STAssertEquals(item, plcrash_async_image_containing_address(&_list, headers[expected[i]]), @"Failed to find image by address");
+        }
+        STAssertNULL(plcrash_async_image_cursor_next(&cursor), @"Item should be NULL");
+
+        STAssertNULL(plcrash_async_image_containing_address(&_list, headers[1]), @"Removed image should not be found");
+    } plcrash_async_image_list_set_reading(&_list, false);
+}
+
 /* Test removing the last image in the list. */
 - (void) testRemoveLastImage {
     plcrash_nasync_image_list_append(&_list, 0x0, "image_name");
@@ -143,6 +382,33 @@
     plcrash_async_image_list_set_reading(&_list, false);
 }
 
+/* Verify that address lookups remain correct as images are appended and removed */
+- (void) testFindImageForAddressAfterUpdates {
+    uint32_t count = _dyld_image_count();
+    STAssertTrue(count >= 5, @"We need at least five Mach-O images for this test. This should not be a problem on a modern system.");
+
+    /* Append in reverse order, so that the snapshot must be re-sorted */
+    for (int i = 4; i >= 0; i--)
+        plcrash_nasync_image_list_append(&_list, (pl_vm_address_t) _dyld_get_image_header(i), _dyld_get_image_name(i));
+    plcrash_nasync_image_list_remove(&_list, (pl_vm_address_t) _dyld_get_image_header(2));
+
+    plcrash_async_image_list_set_reading(&_list, true); {
+        for (uint32_t i = 0; i <= 4; i++) {
+            pl_vm_address_t header = (pl_vm_address_t) _dyld_get_image_header(i);
+            plcrash_async_image_t *image = plcrash_async_image_containing_address(&_list, header);
+
+            if (i == 2) {
+                STAssertNULL(image, @"Removed image %u should not be returned", i);
+                continue;
+            }
+
+            STAssertNotNULL(image, @"Failed to find image %u", i);
+            STAssertEquals(image->macho_image.header_addr, header, @"Incorrect image returned for %u", i);
+            STAssertEquals(image, plcrash_async_image_containing_address(&_list, header + image->macho_image.text_size - 1), @"Incorrect image returned for the end of %u", i);
+        }
+    } plcrash_async_image_list_set_reading(&_list, false);
+}
+
 - (void) testFindImageForAddress {    
     /* Fetch the our IMP address and symbolicate it using dladdr(). */
     IMP localIMP = class_getMethodImplementation([self class], _cmd);
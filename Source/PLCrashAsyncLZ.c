@@ -0,0 +1,375 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "PLCrashAsyncLZ.h"
+
+#include <string.h>
+
+/**
+ * @internal
+ * @ingroup plcrash_async
+ * @defgroup plcrash_async_lz Async-safe LZ Compression
+ *
+ * Implements an async-safe streaming LZ compressor, used to compress crash reports at the time they are
+ * written, along with the corresponding (non-async-safe) decoder.
+ * @{
+ */
+
+/** Minimum match length. */
+#define LZ_MIN_MATCH 4
+
+/** Maximum match offset. */
+#define LZ_MAX_OFFSET UINT16_MAX
+
+static inline uint32_t lz_read32 (const uint8_t *p) {
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static inline void lz_write32 (uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t) v;
+    p[1] = (uint8_t) (v >> 8);
+    p[2] = (uint8_t) (v >> 16);
+    p[3] = (uint8_t) (v >> 24);
+}
+
+static inline uint32_t lz_hash (uint32_t seq) {
+    return (seq * 2654435761U) >> (32 - PLCRASH_ASYNC_LZ_HASH_BITS);
+}
+
+/* Write a length nibble extension, returning the new output position. */
+static inline uint8_t *lz_write_length (uint8_t *op, size_t length) {
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = (uint8_t) length;
+    return op;
+}
+
+/* Emit a single sequence. If match_length is 0, only the literals are written. */
+static uint8_t *lz_write_sequence (uint8_t *op, const uint8_t *literals, size_t literal_count, uint16_t offset, size_t match_length) {
+    uint8_t *token = op++;
+    size_t match_code = match_length == 0 ? 0 : match_length - LZ_MIN_MATCH;
+
+    *token = (uint8_t) (((literal_count < 15 ? literal_count : 15) << 4) | (match_code < 15 ? match_code : 15));
+    if (literal_count >= 15)
+        op = lz_write_length(op, literal_count - 15);
+
+    plcrash_async_memcpy(op, literals, literal_count);
+    op += literal_count;
+
+    if (match_length == 0)
+        return op;
+
+    *op++ = (uint8_t) offset;
+    *op++ = (uint8_t) (offset >> 8);
+    if (match_code >= 15)
+        op = lz_write_length(op, match_code - 15);
+
+    return op;
+}
+
+/**
+ * Compress @a length bytes of @a src to @a dest, returning the encoded length. @a dest must provide
+ * at least PLCRASH_ASYNC_LZ_MAX_ENCODED_SIZE(length) bytes.
+ */
+static size_t lz_compress_block (plcrash_async_lz_t *lz, const uint8_t *src, size_t length, uint8_t *dest) {
+    uint8_t *op = dest;
+    size_t anchor = 0;
+    size_t ip = 0;
+
+    plcrash_async_memset(lz->hash_table, 0, sizeof(lz->hash_table));
+
+    while (ip + LZ_MIN_MATCH <= length) {
+        uint32_t seq = lz_read32(src + ip);
+        uint32_t h = lz_hash(seq);
+        size_t candidate = lz->hash_table[h];
+        lz->hash_table[h] = (uint16_t) ip;
+
+        if (candidate >= ip || ip - candidate > LZ_MAX_OFFSET || lz_read32(src + candidate) != seq) {
+            ip++;
+            continue;
+        }
+
+        /* Extend the match */
+        size_t match_length = LZ_MIN_MATCH;
+        while (ip + match_length < length && src[candidate + match_length] == src[ip + match_length])
+            match_length++;
+
+        op = lz_write_sequence(op, src + anchor, ip - anchor, (uint16_t) (ip - candidate), match_length);
+        ip += match_length;
+        anchor = ip;
+    }
+
+    /* Trailing literals */
+    op = lz_write_sequence(op, src + anchor, length - anchor, 0, 0);
+    return op - dest;
+}
+
+/**
+ * Initialize a compressor.
+ *
+ * @param lz The compressor to initialize.
+ * @param output The function to which encoded blocks will be written.
+ * @param output_ctx Context value to be passed to @a output.
+ */
+void plcrash_async_lz_init (plcrash_async_lz_t *lz, plcrash_async_lz_output_fn output, void *output_ctx) {
+    lz->output = output;
+    lz->output_ctx = output_ctx;
+    lz->block_length = 0;
+}
+
+/**
+ * Compress and emit all buffered input as a single block. This is called automatically as the block buffer fills,
+ * and must be called once all input has been written.
+ *
+ * @param lz The compressor.
+ *
+ * @return Returns true on success, or false if the output function failed.
+ */
+bool plcrash_async_lz_flush (plcrash_async_lz_t *lz) {
+    if (lz->block_length == 0)
+        return true;
+
+    uint8_t *payload = lz->encoded + PLCRASH_ASYNC_LZ_BLOCK_HEADER_SIZE;
+    size_t encoded_length = lz_compress_block(lz, lz->block, lz->block_length, payload);
+    uint32_t flags = 0;
+
+    /* Store incompressible blocks as-is */
+    if (encoded_length >= lz->block_length) {
+        plcrash_async_memcpy(payload, lz->block, lz->block_length);
+        encoded_length = lz->block_length;
+        flags = PLCRASH_ASYNC_LZ_BLOCK_STORED;
+    }
+
+    lz_write32(lz->encoded, (uint32_t) encoded_length | flags);
+    lz_write32(lz->encoded + 4, (uint32_t) lz->block_length);
+    lz->block_length = 0;
+
+    return lz->output(lz->output_ctx, lz->encoded, PLCRASH_ASYNC_LZ_BLOCK_HEADER_SIZE + encoded_length);
+}
+
+/**
+ * Write @a len bytes of input to the compressor.
+ *
+ * @param lz The compressor.
+ * @param data The data to be compressed.
+ * @param len The length of @a data.
+ *
+ * @return Returns true on success, or false if the output function failed.
+ */
+bool plcrash_async_lz_write (plcrash_async_lz_t *lz, const void *data, size_t len) {
+    const uint8_t *p = data;
+
+    while (len > 0) {
+        size_t avail = sizeof(lz->block) - lz->block_length;
+        size_t count = len < avail ? len : avail;
+
+        plcrash_async_memcpy(lz->block + lz->block_length, p, count);
+        lz->block_length += count;
+        p += count;
+        len -= count;
+
+        if (lz->block_length == sizeof(lz->block) && !plcrash_async_lz_flush(lz))
+            return false;
+    }
+
+    return true;
+}
+
+/* Read a length nibble extension. Returns false if the input is truncated. */
+static bool lz_read_length (const uint8_t **ip, const uint8_t *end, size_t *length) {
+    uint8_t b;
+    do {
+        if (*ip >= end)
+            return false;
+        b = *(*ip)++;
+        *length += b;
+    } while (b == 255);
+
+    return true;
+}
+
+/* Decode a single compressed block, verifying that exactly @a output_length bytes are produced. */
+static plcrash_error_t lz_decode_block (const uint8_t *ip, size_t length, uint8_t *output, size_t output_length) {
+    const uint8_t *end = ip + length;
+    uint8_t *op = output;
+    uint8_t *op_end = output + output_length;
+
+    while (ip < end) {
+        uint8_t token = *ip++;
+
+        /* Literals */
+        size_t literal_count = token >> 4;
+        if (literal_count == 15 && !lz_read_length(&ip, end, &literal_count))
+            return PLCRASH_EINVALID_DATA;
+
+        if (literal_count > (size_t) (end - ip) || literal_count > (size_t) (op_end - op))
+            return PLCRASH_EINVALID_DATA;
+
+        memcpy(op, ip, literal_count);
+        ip += literal_count;
+        op += literal_count;
+
+        /* The final sequence contains only literals */
+        if (ip == end)
+            break;
+
+        /* Match */
+        if (end - ip < 2)
+            return PLCRASH_EINVALID_DATA;
+
+        size_t offset = (size_t) ip[0] | ((size_t) ip[1] << 8);
+        ip += 2;
+
+        size_t match_length = token & 0xF;
+        if (match_length == 15 && !lz_read_length(&ip, end, &match_length))
+            return PLCRASH_EINVALID_DATA;
+        match_length += LZ_MIN_MATCH;
+
+        if (offset == 0 || offset > (size_t) (op - output) || match_length > (size_t) (op_end - op))
+            return PLCRASH_EINVALID_DATA;
+
+        /* Byte-wise copy; the source and destination may overlap */
+        const uint8_t *match = op - offset;
+        for (size_t i = 0; i < match_length; i++)
+            op[i] = match[i];
+        op += match_length;
+    }
+
+    if (op != op_end)
+        return PLCRASH_EINVALID_DATA;
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Determine the decoded length of an LZ-encoded stream.
+ *
+ * @param data The encoded stream.
+ * @param length The length of @a data.
+ * @param decoded_length On success, will be set to the total decoded length.
+ *
+ * The declared block lengths are validated against the limits of the encoder: no block decodes to more than
+ * PLCRASH_ASYNC_LZ_BLOCK_SIZE bytes, stored blocks decode to exactly their encoded length, and compressed blocks
+ * to at most PLCRASH_ASYNC_LZ_MAX_EXPANSION times their encoded length. The returned length is thus bounded by
+ * a fixed multiple of @a length, and may be used to size the output buffer.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_EINVALID_DATA if the block headers are invalid or truncated.
+ *
+ * @warning This function is not async-safe.
+ */
+plcrash_error_t plcrash_nasync_lz_decoded_length (const void *data, size_t length, size_t *decoded_length) {
+    const uint8_t *p = data;
+    const uint8_t *end = p + length;
+    size_t total = 0;
+
+    while (p < end) {
+        if ((size_t) (end - p) < PLCRASH_ASYNC_LZ_BLOCK_HEADER_SIZE)
+            return PLCRASH_EINVALID_DATA;
+
+        uint32_t header = lz_read32(p);
+        uint32_t encoded_length = header & ~PLCRASH_ASYNC_LZ_BLOCK_STORED;
+        uint32_t block_length = lz_read32(p + 4);
+        p += PLCRASH_ASYNC_LZ_BLOCK_HEADER_SIZE;
+
+        if (encoded_length > (size_t) (end - p) || total + block_length < total)
+            return PLCRASH_EINVALID_DATA;
+
+        /* Reject block lengths the encoder could not have produced */
+        if (block_length > PLCRASH_ASYNC_LZ_BLOCK_SIZE)
+            return PLCRASH_EINVALID_DATA;
+
+        if (header & PLCRASH_ASYNC_LZ_BLOCK_STORED) {
+            if (encoded_length != block_length)
+                return PLCRASH_EINVALID_DATA;
+        } else if (block_length > (size_t) encoded_length * PLCRASH_ASYNC_LZ_MAX_EXPANSION) {
+            return PLCRASH_EINVALID_DATA;
+        }
+
+        p += encoded_length;
+        total += block_length;
+    }
+
+    *decoded_length = total;
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Decode an LZ-encoded stream.
+ *
+ * @param data The encoded stream.
+ * @param length The length of @a data.
+ * @param output The output buffer.
+ * @param output_length The size of @a output. This must be equal to the length returned by
+ * plcrash_nasync_lz_decoded_length().
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_EINVALID_DATA if the stream is invalid.
+ *
+ * @warning This function is not async-safe.
+ */
+plcrash_error_t plcrash_nasync_lz_decode (const void *data, size_t length, void *output, size_t output_length) {
+    const uint8_t *p = data;
+    const uint8_t *end = p + length;
+    uint8_t *op = output;
+    uint8_t *op_end = op + output_length;
+    plcrash_error_t err;
+
+    while (p < end) {
+        if ((size_t) (end - p) < PLCRASH_ASYNC_LZ_BLOCK_HEADER_SIZE)
+            return PLCRASH_EINVALID_DATA;
+
+        uint32_t header = lz_read32(p);
+        uint32_t encoded_length = header & ~PLCRASH_ASYNC_LZ_BLOCK_STORED;
+        uint32_t block_length = lz_read32(p + 4);
+        p += PLCRASH_ASYNC_LZ_BLOCK_HEADER_SIZE;
+
+        if (encoded_length > (size_t) (end - p) || block_length > (size_t) (op_end - op))
+            return PLCRASH_EINVALID_DATA;
+
+        if (header & PLCRASH_ASYNC_LZ_BLOCK_STORED) {
+            if (encoded_length != block_length)
+                return PLCRASH_EINVALID_DATA;
+            memcpy(op, p, block_length);
+        } else if ((err = lz_decode_block(p, encoded_length, op, block_length)) != PLCRASH_ESUCCESS) {
+            return err;
+        }
+
+        p += encoded_length;
+        op += block_length;
+    }
+
+    if (op != op_end)
+        return PLCRASH_EINVALID_DATA;
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * @} plcrash_async_lz
+ */
@@ -0,0 +1,148 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PLCRASH_ASYNC_LZ_H
+#define PLCRASH_ASYNC_LZ_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "PLCrashAsync.h"
+
+/**
+ * @internal
+ * @ingroup plcrash_async_lz
+ *
+ * Number of uncompressed bytes buffered and compressed as a single block.
+ */
+#define PLCRASH_ASYNC_LZ_BLOCK_SIZE (32 * 1024)
+
+/**
+ * @internal
+ * @ingroup plcrash_async_lz
+ *
+ * Size of each encoded block header, in bytes.
+ */
+#define PLCRASH_ASYNC_LZ_BLOCK_HEADER_SIZE 8
+
+/**
+ * @internal
+ * @ingroup plcrash_async_lz
+ *
+ * Block header flag marking a block that is stored uncompressed.
+ */
+#define PLCRASH_ASYNC_LZ_BLOCK_STORED (1U << 31)
+
+/**
+ * @internal
+ * @ingroup plcrash_async_lz
+ *
+ * Worst-case encoded size of @a length bytes of input, excluding the block header.
+ */
+#define PLCRASH_ASYNC_LZ_MAX_ENCODED_SIZE(length) ((length) + ((length) / 255) + 16)
+
+/**
+ * @internal
+ * @ingroup plcrash_async_lz
+ *
+ * Maximum ratio of decoded to encoded length of a compressed block. Each encoded byte yields at most
+ * 255 bytes of output (a match length extension byte), so any block claiming a larger ratio is invalid.
+ */
+#define PLCRASH_ASYNC_LZ_MAX_EXPANSION 255
+
+/** Number of bits used to index the match hash table. */
+#define PLCRASH_ASYNC_LZ_HASH_BITS 12
+
+/**
+ * @internal
+ * @ingroup plcrash_async_lz
+ *
+ * Prototype of the output function used to emit encoded blocks. This function must be async-safe.
+ *
+ * @param ctx The context value supplied to plcrash_async_lz_init().
+ * @param data The encoded data.
+ * @param len The length of @a data.
+ *
+ * @return Returns true on success, false if the data could not be written.
+ */
+typedef bool (*plcrash_async_lz_output_fn)(void *ctx, const void *data, size_t len);
+
+/**
+ * @internal
+ * @ingroup plcrash_async_lz
+ *
+ * Async-safe streaming LZ compressor. All state, including the compression window, is contained
+ * within this structure; no memory is allocated. Given its size, instances should be statically allocated.
+ *
+ * Input is buffered and compressed in independent blocks of up to PLCRASH_ASYNC_LZ_BLOCK_SIZE bytes. Each block
+ * is prefixed with a PLCRASH_ASYNC_LZ_BLOCK_HEADER_SIZE byte header, consisting of two little-endian uint32 values:
+ * the encoded length (with PLCRASH_ASYNC_LZ_BLOCK_STORED set if the block is stored uncompressed), followed by the
+ * decoded length.
+ *
+ * Compressed blocks are encoded as a sequence of literal runs and back-references. Each sequence begins with a token
+ * byte; the high nibble contains the literal count, and the low nibble the match length less 4. A nibble value of 15
+ * is followed by extension bytes that are summed until a byte other than 255 is found. The literals follow, and then
+ * (except in the last sequence of a block) a little-endian uint16 match offset and any match length extension bytes.
+ */
+typedef struct plcrash_async_lz {
+    /** Output function. */
+    plcrash_async_lz_output_fn output;
+
+    /** Output function context. */
+    void *output_ctx;
+
+    /** Number of bytes currently buffered in @a block. */
+    size_t block_length;
+
+    /** Buffered uncompressed input; this is also the compression window. */
+    uint8_t block[PLCRASH_ASYNC_LZ_BLOCK_SIZE];
+
+    /** Encoded block output. */
+    uint8_t encoded[PLCRASH_ASYNC_LZ_BLOCK_HEADER_SIZE + PLCRASH_ASYNC_LZ_MAX_ENCODED_SIZE(PLCRASH_ASYNC_LZ_BLOCK_SIZE)];
+
+    /** Most recent block offset of each hashed 4-byte sequence. */
+    uint16_t hash_table[1 << PLCRASH_ASYNC_LZ_HASH_BITS];
+} plcrash_async_lz_t;
+
+void plcrash_async_lz_init (plcrash_async_lz_t *lz, plcrash_async_lz_output_fn output, void *output_ctx);
+bool plcrash_async_lz_write (plcrash_async_lz_t *lz, const void *data, size_t len);
+bool plcrash_async_lz_flush (plcrash_async_lz_t *lz);
+
+plcrash_error_t plcrash_nasync_lz_decoded_length (const void *data, size_t length, size_t *decoded_length);
+plcrash_error_t plcrash_nasync_lz_decode (const void *data, size_t length, void *output, size_t output_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PLCRASH_ASYNC_LZ_H */
@@ -0,0 +1,180 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "SenTestCompat.h"
+
+#import "PLCrashAsyncLZ.h"
+
+@interface PLCrashAsyncLZTests : SenTestCase {
+@private
+    /** Encoded output */
+    NSMutableData *_encoded;
+}
+@end
+
+/* Compressor state; too large to place on the stack. */
+static plcrash_async_lz_t lz;
+
+static bool lz_test_output (void *ctx, const void *data, size_t len) {
+    NSMutableData *output = (NSMutableData *) ctx;
+    [output appendBytes: data length: len];
+    return true;
+}
+
+@implementation PLCrashAsyncLZTests
+
+- (void) setUp {
+    _encoded = [[NSMutableData alloc] init];
+    plcrash_async_lz_init(&lz, lz_test_output, _encoded);
+}
+
+- (void) tearDown {
+    [_encoded release];
+}
+
+/**
+ * Decode the encoded output, returning nil on failure.
+ */
+- (NSData *) decode {
+    size_t length;
+    if (plcrash_nasync_lz_decoded_length([_encoded bytes], [_encoded length], &length) != PLCRASH_ESUCCESS)
+        return nil;
+
+    NSMutableData *decoded = [NSMutableData dataWithLength: length];
+    if (plcrash_nasync_lz_decode([_encoded bytes], [_encoded length], [decoded mutableBytes], length) != PLCRASH_ESUCCESS)
+        return nil;
+
+    return decoded;
+}
+
+/**
+ * Write @a input in chunks of @a chunkSize bytes, flush, and verify that it decodes correctly.
+ */
+- (void) roundTrip: (NSData *) input chunkSize: (size_t) chunkSize {
+    const uint8_t *bytes = [input bytes];
+    size_t remaining = [input length];
+
+    while (remaining > 0) {
+        size_t count = MIN(chunkSize, remaining);
+        STAssertTrue(plcrash_async_lz_write(&lz, bytes, count), @"Write failed");
+        bytes += count;
+        remaining -= count;
+    }
+    STAssertTrue(plcrash_async_lz_flush(&lz), @"Flush failed");
+
+    NSData *decoded = [self decode];
+    STAssertNotNil(decoded, @"Failed to decode");
+    STAssertTrue([decoded isEqualToData: input], @"Decoded data does not match input");
+}
+
+- (void) testEmpty {
+    STAssertTrue(plcrash_async_lz_flush(&lz), @"Flush failed");
+    STAssertEquals((NSUInteger) 0, [_encoded length], @"Empty input should produce no output");
+
+    NSData *decoded = [self decode];
+    STAssertNotNil(decoded, @"Failed to decode");
+    STAssertEquals((NSUInteger) 0, [decoded length], @"Decoded data is not empty");
+}
+
+- (void) testCompressible {
+    NSMutableData *input = [NSMutableData data];
+    for (int i = 0; i < 10000; i++)
+        [input appendBytes: "_dyld_start 0x1000 /usr/lib/dyld\n" length: 33];
+
+    [self roundTrip: input chunkSize: 7];
+    STAssertTrue([_encoded length] < [input length] / 10, @"Repetitive input was not compressed (%lu bytes)", (unsigned long) [_encoded length]);
+}
+
+- (void) testIncompressible {
+    NSMutableData *input = [NSMutableData dataWithLength: PLCRASH_ASYNC_LZ_BLOCK_SIZE * 3 + 17];
+    uint8_t *bytes = [input mutableBytes];
+    for (size_t i = 0; i < [input length]; i++)
+        bytes[i] = (uint8_t) arc4random();
+
+    [self roundTrip: input chunkSize: 4096];
+
+    /* Incompressible blocks are stored, and should only incur the block header overhead */
+    size_t blocks = ([input length] + PLCRASH_ASYNC_LZ_BLOCK_SIZE - 1) / PLCRASH_ASYNC_LZ_BLOCK_SIZE;
+    STAssertEquals([_encoded length], [input length] + blocks * PLCRASH_ASYNC_LZ_BLOCK_HEADER_SIZE, @"Unexpected stored block overhead");
+}
+
+- (void) testLongMatchesAndLiterals {
+    /* Produce literal runs and matches long enough to require length extension bytes */
+    NSMutableData *input = [NSMutableData data];
+    uint8_t literals[1000];
+    for (size_t i = 0; i < sizeof(literals); i++)
+        literals[i] = (uint8_t) arc4random();
+
+    [input appendBytes: literals length: sizeof(literals)];
+    [input appendData: [NSMutableData dataWithLength: 5000]];
+    [input appendBytes: literals length: sizeof(literals)];
+
+    [self roundTrip: input chunkSize: [input length]];
+}
+
+- (void) testRejectInvalidData {
+    NSMutableData *input = [NSMutableData data];
+    for (int i = 0; i < 1000; i++)
+        [input appendBytes: "abcdefgh" length: 8];
+
+    STAssertTrue(plcrash_async_lz_write(&lz, [input bytes], [input length]), @"Write failed");
+    STAssertTrue(plcrash_async_lz_flush(&lz), @"Flush failed");
+
+    /* Truncated input */
+    size_t length;
+    STAssertNotEquals(PLCRASH_ESUCCESS, plcrash_nasync_lz_decoded_length([_encoded bytes], [_encoded length] - 1, &length), @"Accepted truncated data");
+
+    /* Corrupt the declared block length */
+    uint8_t *bytes = [_encoded mutableBytes];
+    bytes[4] ^= 0x1;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_lz_decoded_length([_encoded bytes], [_encoded length], &length), @"Failed to read block headers");
+
+    NSMutableData *decoded = [NSMutableData dataWithLength: length];
+    STAssertNotEquals(PLCRASH_ESUCCESS, plcrash_nasync_lz_decode([_encoded bytes], [_encoded length], [decoded mutableBytes], length), @"Accepted corrupt data");
+}
+
+- (void) testRejectImplausibleLength {
+    uint8_t block[PLCRASH_ASYNC_LZ_BLOCK_HEADER_SIZE + 1] = { 0 };
+    size_t length;
+
+    /* A one byte compressed block claiming a full block of output */
+    block[0] = 1;
+    block[4] = 0x00; block[5] = 0x80;
+    STAssertNotEquals(PLCRASH_ESUCCESS, plcrash_nasync_lz_decoded_length(block, sizeof(block), &length), @"Accepted implausible expansion");
+
+    /* A block claiming more than the maximum block size */
+    block[4] = 0x00; block[5] = 0x00; block[6] = 0x00; block[7] = 0x80;
+    STAssertNotEquals(PLCRASH_ESUCCESS, plcrash_nasync_lz_decoded_length(block, sizeof(block), &length), @"Accepted oversized block");
+
+    /* A stored block whose lengths disagree */
+    block[3] = 0x80;
+    block[4] = 2; block[5] = 0x00; block[6] = 0x00; block[7] = 0x00;
+    STAssertNotEquals(PLCRASH_ESUCCESS, plcrash_nasync_lz_decoded_length(block, sizeof(block), &length), @"Accepted mismatched stored block");
+}
+
+@end
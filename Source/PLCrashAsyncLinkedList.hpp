@@ -116,7 +116,7 @@ public:
     ~async_list (void);
     
     void nasync_prepend (V value);
-    void nasync_append (V value);
+    node *nasync_append (V value);
     void nasync_remove_first_value (V value);
     void nasync_remove_node (node *deleted_node);
     void set_reading (bool enable);
@@ -251,14 +251,16 @@ template <typename V> void async_list<V>::nasync_prepend (V value) {
  *
  * @param value The value to be appended.
  *
+ * @return Returns the new entry's node, which remains valid until removed via nasync_remove_node().
+ *
  * @warning This method is not async safe.
  */
-template <typename V> void async_list<V>::nasync_append (V value) {
+template <typename V> typename async_list<V>::node *async_list<V>::nasync_append (V value) {
+    /* Construct the new entry, or recycle an existing one. */
+    node *new_node;
     
     /* Lock the list from other writers. */
     OSSpinLockLock(&_write_lock); {
-        /* Construct the new entry, or recycle an existing one. */
-        node *new_node;
         if (_free != NULL) {
             /* Fetch a node from the free list */
             new_node = _free;
@@ -299,6 +301,8 @@ template <typename V> void async_list<V>::nasync_append (V value) {
             _tail = new_node;
         }
     } OSSpinLockUnlock(&_write_lock);
+
+    return new_node;
 }
 
 /**
@@ -27,6 +27,7 @@
  */
 
 #include "PLCrashAsyncMObject.h"
+#include "PLCrashProbes.h"
 
 #include <stdint.h>
 #include <inttypes.h>
@@ -40,6 +41,84 @@
  * @{
  */
 
+/**
+ * Look up the readable VM region containing @a addr within @a task, including regions nested within submaps
+ * (such as the dyld shared cache).
+ *
+ * @param task The task to be queried.
+ * @param addr The address to be looked up.
+ * @param[out] region_base On success, the base address of the region.
+ * @param[out] region_size On success, the size of the region.
+ *
+ * @return Returns true if a readable region containing @a addr was found, or false if @a addr is unmapped or not readable.
+ */
+bool plcrash_async_mobject_region_lookup (mach_port_t task, pl_vm_address_t addr, pl_vm_address_t *region_base, pl_vm_size_t *region_size) {
+    natural_t depth = 0;
+
+    while (true) {
+        vm_region_submap_info_data_64_t info;
+        mach_msg_type_number_t info_count = VM_REGION_SUBMAP_INFO_COUNT_64;
+        kern_return_t kt;
+
+#ifdef PL_HAVE_MACH_VM
+        mach_vm_address_t r_addr = addr;
+        mach_vm_size_t r_size;
+        kt = mach_vm_region_recurse(task, &r_addr, &r_size, &depth, (vm_region_recurse_info_t) &info, &info_count);
+#else
+        vm_address_t r_addr = addr;
+        vm_size_t r_size;
+        kt = vm_region_recurse_64(task, &r_addr, &r_size, &depth, (vm_region_recurse_info_t) &info, &info_count);
+#endif
+        if (kt != KERN_SUCCESS)
+            return false;
+
+        /* Descend into submaps to find the actual mapping */
+        if (info.is_submap) {
+            depth++;
+            continue;
+        }
+
+        /* The returned region may begin after our target address if the target is unmapped */
+        if (r_addr > addr || (info.protection & VM_PROT_READ) == 0)
+            return false;
+
+        *region_base = r_addr;
+        *region_size = r_size;
+        return true;
+    }
+}
+
+/**
+ * Determine the readable extent of the pages starting at the page-aligned @a base_addr within @a task.
+ *
+ * @param task The task to be queried.
+ * @param base_addr The page-aligned address at which the walk will begin.
+ * @param total_size The maximum extent to be validated.
+ *
+ * @return Returns the number of contiguous readable bytes at @a base_addr, up to @a total_size.
+ */
+static pl_vm_size_t plcrash_async_mobject_mappable_length (mach_port_t task, pl_vm_address_t base_addr, pl_vm_size_t total_size) {
+    pl_vm_size_t verified_size = 0;
+
+    while (verified_size < total_size) {
+        pl_vm_address_t addr = base_addr + verified_size;
+        pl_vm_address_t region_base;
+        pl_vm_size_t region_size;
+
+        /* Once we hit an unmapped or unreadable page, stop */
+        if (!plcrash_async_mobject_region_lookup(task, addr, &region_base, &region_size))
+            break;
+
+        pl_vm_size_t available = region_size - (addr - region_base);
+        if (available > total_size - verified_size)
+            available = total_size - verified_size;
+
+        verified_size += available;
+    }
+
+    return verified_size;
+}
+
 /**
  * Map pages starting at @a task_addr from @a task into the current process. The mapping
  * will be copy-on-write, and will be checked to ensure a minimum protection value of
@@ -122,28 +201,9 @@ static plcrash_error_t plcrash_async_mobject_remap_pages_workaround (mach_port_t
      * smaller, which can trigger out-of-memory conditions on smaller devices.
      */
     if (!require_full) {
-        pl_vm_size_t verified_size = 0;
-        
-        while (verified_size < total_size) {            
-            memory_object_size_t entry_length = total_size - verified_size;
-            mach_port_t mem_handle;
-            
-            /* Fetch an entry reference */
-            kt = mach_make_memory_entry_64(task, &entry_length, base_addr + verified_size, VM_PROT_READ, &mem_handle, MACH_PORT_NULL);
-            if (kt != KERN_SUCCESS) {
-                /* Once we hit an unmappable page, break */
-                break;
-            }
-            
-            /* Drop the reference */
-            kt = mach_port_mod_refs(mach_task_self(), mem_handle, MACH_PORT_RIGHT_SEND, -1);
-            if (kt != KERN_SUCCESS) {
-                PLCF_DEBUG("mach_port_mod_refs(-1) failed: %d", kt);
-            }
-
-            /* Note the size */
-            verified_size += entry_length;
-        }
+        /* Walk the target's VM regions; this requires a single trap per region, rather than a memory entry
+         * allocation and release per entry. */
+        pl_vm_size_t verified_size = plcrash_async_mobject_mappable_length(task, base_addr, total_size);
 
         /* No valid page found at the task_addr */
         if (verified_size == 0) {
@@ -240,52 +300,201 @@ static plcrash_error_t plcrash_async_mobject_remap_pages_workaround (mach_port_t
 
 
 /**
- * Initialize a new memory object reference, mapping @a task_addr from @a task into the current process. The mapping
- * will be copy-on-write, and will be checked to ensure a minimum protection value of VM_PROT_READ.
+ * Determine the length of the readable memory at @a task_addr within the current task, consulting and populating
+ * @a regions.
+ *
+ * @param regions The region cache to be used, or NULL.
+ * @param task_addr The local address to be validated.
+ * @param length The total length to be validated.
+ *
+ * @return Returns the number of readable bytes at @a task_addr, up to @a length.
+ */
+static pl_vm_size_t plcrash_async_mobject_local_readable_length (plcrash_async_mobject_region_cache_t *regions,
+                                                                   pl_vm_address_t task_addr,
+                                                                   pl_vm_size_t length)
+{
+    pl_vm_size_t verified_size = 0;
+
+    while (verified_size < length) {
+        pl_vm_address_t addr = task_addr + verified_size;
+        pl_vm_address_t region_base = 0;
+        pl_vm_size_t region_size = 0;
+        bool found = false;
+
+        /* Check for a previously validated region */
+        for (uint32_t i = 0; regions != NULL && i < regions->count; i++) {
+            if (addr >= regions->base[i] && addr - regions->base[i] < regions->size[i]) {
+                region_base = regions->base[i];
+                region_size = regions->size[i];
+                found = true;
+                break;
+            }
+        }
+
+        /* Otherwise, fetch the region from the kernel */
+        if (!found) {
+            if (!plcrash_async_mobject_region_lookup(mach_task_self(), addr, &region_base, &region_size))
+                break;
+
+            if (regions != NULL) {
+                uint32_t idx;
+                if (regions->count < PLCRASH_ASYNC_MOBJECT_REGION_CACHE_SIZE) {
+                    idx = regions->count++;
+                } else {
+                    idx = regions->next;
+                    regions->next = (regions->next + 1) % PLCRASH_ASYNC_MOBJECT_REGION_CACHE_SIZE;
+                }
+
+                regions->base[idx] = region_base;
+                regions->size[idx] = region_size;
+            }
+        }
+
+        /* Advance to the end of the region */
+        pl_vm_size_t available = region_size - (addr - region_base);
+        if (available > length - verified_size)
+            available = length - verified_size;
+
+        verified_size += available;
+    }
+
+    return verified_size;
+}
+
+/**
+ * Initialize @a mobj, optionally referencing local-task memory directly.
+ *
+ * If @a task is the current task and @a regions is non-NULL, no pages will be mapped; the readability of the target
+ * range will be validated via @a regions, and @a mobj will reference the target memory directly. Otherwise, the
+ * target pages are remapped copy-on-write.
  *
  * @param mobj Memory object to be initialized.
+ * @param regions The region cache to be used for direct local-task validation, or NULL if the target memory must be
+ * remapped. A non-NULL value may only be supplied while all other threads in the task are suspended; a directly
+ * referenced range could otherwise be unmapped while in use.
  * @param task The task from which the memory will be mapped.
- * @param task_addr The task-relative address of the memory to be mapped. This is not required to fall on a page boundry.
+ * @param task_addr The task-relative address of the memory to be mapped.
  * @param length The total size of the mapping to create.
- * @param require_full If false, short mappings will be permitted in the case where a memory object of the requested length
- * does not exist at the target address. It is the caller's responsibility to validate the resulting length of the
- * mapping, eg, using plcrash_async_mobject_remap_address() and similar. If true, and the entire requested page range is
- * not valid, the mapping request will fail.
+ * @param require_full If false, short mappings will be permitted.
  *
  * @return On success, returns PLCRASH_ESUCCESS. On failure, one of the plcrash_error_t error values will be returned, and no
  * mapping will be performed.
  */
-plcrash_error_t plcrash_async_mobject_init (plcrash_async_mobject_t *mobj, mach_port_t task, pl_vm_address_t task_addr, pl_vm_size_t length, bool require_full) {
+static plcrash_error_t plcrash_async_mobject_init_internal (plcrash_async_mobject_t *mobj,
+                                                            plcrash_async_mobject_region_cache_t *regions,
+                                                            mach_port_t task,
+                                                            pl_vm_address_t task_addr,
+                                                            pl_vm_size_t length,
+                                                            bool require_full)
+{
     plcrash_error_t err;
 
-    /* Perform the page mapping */
-    err = plcrash_async_mobject_remap_pages_workaround(task, task_addr, length, require_full, &mobj->vm_address, &mobj->vm_length);
-    if (err != PLCRASH_ESUCCESS)
-        return err;
+    if (task == mach_task_self() && regions != NULL) {
+        /* Reject ranges that wrap the address space */
+        if (length > PL_VM_ADDRESS_MAX - task_addr)
+            return PLCRASH_ENOMEM;
 
-    /* Determine the offset and length of the actual data */
-    mobj->address = mobj->vm_address + (task_addr - mach_vm_trunc_page(task_addr));
-    mobj->length = mobj->vm_length - (mobj->address - mobj->vm_address);
+        /* Validate readability of the target range */
+        pl_vm_size_t verified_size = plcrash_async_mobject_local_readable_length(regions, task_addr, length);
+        if (verified_size == 0 || (require_full && verified_size < length)) {
+            PLCF_DEBUG("No readable pages found at 0x%" PRIx64, (uint64_t) task_addr);
+            return PLCRASH_ENOMEM;
+        }
 
-    /* Ensure that the length is capped to the user's requested length, rather than the total length once rounded up
-     * to a full page. The length might already be smaller than the requested length if require_full is false. */
-    if (mobj->length > length)
-        mobj->length = length;
+        mobj->vm_address = 0;
+        mobj->vm_length = 0;
+        mobj->address = (uintptr_t) task_addr;
+        mobj->length = verified_size;
+        mobj->vm_slide = 0;
+        mobj->direct = true;
+    } else {
+        /* Perform the page mapping */
+        err = plcrash_async_mobject_remap_pages_workaround(task, task_addr, length, require_full, &mobj->vm_address, &mobj->vm_length);
+        if (err != PLCRASH_ESUCCESS)
+            return err;
+
+        /* Determine the offset and length of the actual data */
+        mobj->address = mobj->vm_address + (task_addr - mach_vm_trunc_page(task_addr));
+        mobj->length = mobj->vm_length - (mobj->address - mobj->vm_address);
+
+        /* Ensure that the length is capped to the user's requested length, rather than the total length once rounded up
+         * to a full page. The length might already be smaller than the requested length if require_full is false. */
+        if (mobj->length > length)
+            mobj->length = length;
+
+        /* Determine the difference between the target and local mappings. Note that this needs to be computed on either two page
+         * aligned addresses, or two non-page aligned addresses. Mixing task_addr and vm_address would return an incorrect offset. */
+        mobj->vm_slide = task_addr - mobj->address;
+        mobj->direct = false;
+    }
 
-    /* Determine the difference between the target and local mappings. Note that this needs to be computed on either two page
-     * aligned addresses, or two non-page aligned addresses. Mixing task_addr and vm_address would return an incorrect offset. */
-    mobj->vm_slide = task_addr - mobj->address;
-    
     /* Save the task-relative address */
     mobj->task_address = task_addr;
-    
+
+    /* Reads are unconfined until bounds are supplied via plcrash_async_mobject_set_read_bounds() */
+    mobj->bounds_address = 0;
+    mobj->bounds_length = 0;
+
     /* Save the task reference */
     mobj->task = task;
     mach_port_mod_refs(mach_task_self(), mobj->task, MACH_PORT_RIGHT_SEND, 1);
 
+    /* Owned mappings are not backed by a pool */
+    mobj->pool_entry = NULL;
+
+    PLCR_PROBE_EVENT("mobject_map", "addr=0x%llx length=%llu direct=%d", (unsigned long long) task_addr,
+                     (unsigned long long) mobj->length, (int) mobj->direct);
+
     return PLCRASH_ESUCCESS;
 }
 
+/**
+ * Initialize a new memory object reference, mapping @a task_addr from @a task into the current process. The mapping
+ * will be copy-on-write, and will be checked to ensure a minimum protection value of VM_PROT_READ.
+ *
+ * @param mobj Memory object to be initialized.
+ * @param task The task from which the memory will be mapped.
+ * @param task_addr The task-relative address of the memory to be mapped. This is not required to fall on a page boundry.
+ * @param length The total size of the mapping to create.
+ * @param require_full If false, short mappings will be permitted in the case where a memory object of the requested length
+ * does not exist at the target address. It is the caller's responsibility to validate the resulting length of the
+ * mapping, eg, using plcrash_async_mobject_remap_address() and similar. If true, and the entire requested page range is
+ * not valid, the mapping request will fail.
+ *
+ * @return On success, returns PLCRASH_ESUCCESS. On failure, one of the plcrash_error_t error values will be returned, and no
+ * mapping will be performed.
+ */
+plcrash_error_t plcrash_async_mobject_init (plcrash_async_mobject_t *mobj, mach_port_t task, pl_vm_address_t task_addr, pl_vm_size_t length, bool require_full) {
+    return plcrash_async_mobject_init_internal(mobj, NULL, task, task_addr, length, require_full);
+}
+
+/**
+ * Initialize a memory object referencing a local copy of @a length bytes of target memory, as originally found at
+ * @a task_addr. No task is associated with the resulting object; it may be passed to plcrash_async_mobject_task_memcpy()
+ * with a task of MACH_PORT_NULL, in which case reads outside the copied range will fail.
+ *
+ * This permits the frame readers to be run over memory captured from a process that is no longer running.
+ *
+ * @param mobj Memory object to be initialized.
+ * @param task_addr The target address at which the copied memory originally resided.
+ * @param buffer The local copy of the memory. This is a borrowed reference, and must remain valid for the lifetime of
+ * @a mobj.
+ * @param length The size of @a buffer, in bytes.
+ */
+void plcrash_async_mobject_init_buffer (plcrash_async_mobject_t *mobj, pl_vm_address_t task_addr, const void *buffer, pl_vm_size_t length) {
+    mobj->task = MACH_PORT_NULL;
+    mobj->task_address = task_addr;
+    mobj->address = (uintptr_t) buffer;
+    mobj->length = length;
+    mobj->vm_address = 0;
+    mobj->vm_length = 0;
+    mobj->vm_slide = task_addr - (pl_vm_address_t) (uintptr_t) buffer;
+    mobj->pool_entry = NULL;
+    mobj->direct = true;
+    mobj->bounds_address = 0;
+    mobj->bounds_length = 0;
+}
+
 /**
  * Return the base (target process relative) address for this mapping.
  *
@@ -412,7 +621,7 @@ plcrash_error_t plcrash_async_mobject_read_uint16 (plcrash_async_mobject_t *mobj
     if (input == NULL)
         return PLCRASH_EINVAL;
     
-    *result = byteorder->swap16(*input);
+    *result = plcrash_async_swap16(byteorder, *input);
     return PLCRASH_ESUCCESS;
 }
 
@@ -436,7 +645,7 @@ plcrash_error_t plcrash_async_mobject_read_uint32 (plcrash_async_mobject_t *mobj
     if (input == NULL)
         return PLCRASH_EINVAL;
     
-    *result = byteorder->swap32(*input);
+    *result = plcrash_async_swap32(byteorder, *input);
     return PLCRASH_ESUCCESS;
 }
 
@@ -459,10 +668,67 @@ plcrash_error_t plcrash_async_mobject_read_uint64 (plcrash_async_mobject_t *mobj
     if (input == NULL)
         return PLCRASH_EINVAL;
     
-    *result = byteorder->swap64(*input);
+    *result = plcrash_async_swap64(byteorder, *input);
     return PLCRASH_ESUCCESS;
 }
 
+/**
+ * Copy @a len bytes from the target process' @a address + @a offset to @a dest. If the requested bytes fall within
+ * @a mobj's mapped range, they will be copied from the existing mapping; otherwise, they will be read directly from
+ * @a task via plcrash_async_task_memcpy(), unless they fall outside of any bounds set via
+ * plcrash_async_mobject_set_read_bounds().
+ *
+ * @param mobj A memory object mapped from @a task, or NULL.
+ * @param task The task from which the bytes should be read if they are not available via @a mobj.
+ * @param address The base address to be read. This address should be relative to the target task's address space.
+ * @param offset An offset to be applied to @a address.
+ * @param dest The destination to which the data will be written.
+ * @param len The number of bytes to be read.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or one of the plcrash_error_t constants on failure. If the read falls
+ * outside of @a mobj's read bounds, PLCRASH_ENOTFOUND will be returned.
+ */
+plcrash_error_t plcrash_async_mobject_task_memcpy (plcrash_async_mobject_t *mobj, task_t task, pl_vm_address_t address, pl_vm_off_t offset, void *dest, pl_vm_size_t len) {
+    if (mobj != NULL && mobj->task == task) {
+        void *src = plcrash_async_mobject_remap_address(mobj, address, offset, len);
+        if (src != NULL) {
+            plcrash_async_memcpy(dest, src, len);
+            return PLCRASH_ESUCCESS;
+        }
+
+        /* Reject reads outside of the confining range without issuing a read against the task */
+        if (mobj->bounds_length != 0) {
+            pl_vm_address_t target;
+            if (!plcrash_async_address_apply_offset(address, offset, &target) ||
+                target < mobj->bounds_address ||
+                len > mobj->bounds_length ||
+                target - mobj->bounds_address > mobj->bounds_length - len)
+            {
+                return PLCRASH_ENOTFOUND;
+            }
+        }
+    }
+
+    return plcrash_async_task_memcpy(task, address, offset, dest, len);
+}
+
+/**
+ * Confine reads performed via plcrash_async_mobject_task_memcpy() that fall outside of @a mobj's mapping to the
+ * task-relative range [@a address, @a address + @a length). Reads outside of this range will fail immediately, rather
+ * than being issued against the target task.
+ *
+ * This is intended for mappings of a thread's stack, where the bounds of the stack's VM region are known up front, and
+ * a corrupt frame pointer would otherwise result in a faulting read against the task.
+ *
+ * @param mobj The memory object.
+ * @param address The task-relative base address of the permitted range.
+ * @param length The length of the permitted range, or 0 to remove any existing bounds.
+ */
+void plcrash_async_mobject_set_read_bounds (plcrash_async_mobject_t *mobj, pl_vm_address_t address, pl_vm_size_t length) {
+    mobj->bounds_address = address;
+    mobj->bounds_length = length;
+}
+
 /**
  * Free the memory mapping.
  *
@@ -470,6 +736,21 @@ plcrash_error_t plcrash_async_mobject_read_uint64 (plcrash_async_mobject_t *mobj
  */
 void plcrash_async_mobject_free (plcrash_async_mobject_t *mobj) {
     kern_return_t kt;
+
+    /* Pooled views do not own their pages; the mapping is released when the pool is freed. */
+    if (mobj->pool_entry != NULL) {
+        PLCF_ASSERT(mobj->pool_entry->refcount > 0);
+        mobj->pool_entry->refcount--;
+        mobj->pool_entry = NULL;
+        return;
+    }
+
+    /* Direct local-task and buffer objects have no pages to deallocate */
+    if (mobj->direct) {
+        if (mobj->task != MACH_PORT_NULL)
+            mach_port_mod_refs(mach_task_self(), mobj->task, MACH_PORT_RIGHT_SEND, -1);
+        return;
+    }
     
 #ifdef PL_HAVE_MACH_VM
     kt = mach_vm_deallocate(mach_task_self(), mobj->vm_address, mobj->vm_length);
@@ -484,6 +765,199 @@ void plcrash_async_mobject_free (plcrash_async_mobject_t *mobj) {
     mach_port_mod_refs(mach_task_self(), mobj->task, MACH_PORT_RIGHT_SEND, -1);
 }
 
+
+/**
+ * Initialize a new mapping pool.
+ *
+ * @param pool The pool to initialize. The pool must be released via plcrash_async_mobject_pool_free().
+ */
+void plcrash_async_mobject_pool_init (plcrash_async_mobject_pool_t *pool) {
+    pool->entries = NULL;
+    pool->count = 0;
+    pool->hits = 0;
+    pool->misses = 0;
+    pool->regions.count = 0;
+    pool->regions.next = 0;
+    pool->direct = false;
+}
+
+/**
+ * Configure whether local-task mappings vended by @a pool reference the target memory directly, rather than
+ * remapping the target pages. Direct references avoid a memory entry and remapping per mapping, but are not
+ * fault-safe: if the target memory is unmapped while in use, readers will crash.
+ *
+ * Direct mappings must only be enabled while every other thread in the task is suspended (ie, while writing a crash
+ * report from the crash handler), and must be disabled before any thread is resumed. When disabled, unreferenced
+ * direct mappings are discarded, and outstanding direct mappings will not be used to serve later requests.
+ *
+ * @param pool The mapping pool.
+ * @param enabled If true, local-task mappings will reference the target memory directly.
+ */
+void plcrash_async_mobject_pool_set_direct (plcrash_async_mobject_pool_t *pool, bool enabled) {
+    if (pool->direct == enabled)
+        return;
+
+    pool->direct = enabled;
+
+    /* Validated regions are only meaningful while the task is suspended */
+    pool->regions.count = 0;
+    pool->regions.next = 0;
+
+    if (enabled || pool->entries == NULL)
+        return;
+
+    for (uint32_t i = 0; i < pool->count; i++) {
+        plcrash_async_mobject_pool_entry_t *entry = &pool->entries[i];
+        if (entry->valid && entry->mobj.direct && entry->refcount == 0) {
+            plcrash_async_mobject_free(&entry->mobj);
+            entry->valid = false;
+        }
+    }
+}
+
+/* Return the region cache to be used for new mappings from @a pool, or NULL if the target memory must be remapped */
+static plcrash_async_mobject_region_cache_t *mobject_pool_regions (plcrash_async_mobject_pool_t *pool) {
+    return pool->direct ? &pool->regions : NULL;
+}
+
+/* Return the size of the pool's entry allocation */
+static size_t mobject_pool_allocation_size (void) {
+    return round_page(sizeof(plcrash_async_mobject_pool_entry_t) * PLCRASH_ASYNC_MOBJECT_POOL_SIZE);
+}
+
+/* Initialize @a mobj as a view of @a entry's mapping, starting at @a task_addr */
+static void mobject_pool_view (plcrash_async_mobject_pool_entry_t *entry, plcrash_async_mobject_t *mobj, pl_vm_address_t task_addr, pl_vm_size_t length) {
+    pl_vm_size_t available = entry->mobj.length - (task_addr - entry->mobj.task_address);
+
+    *mobj = entry->mobj;
+    mobj->task_address = task_addr;
+    mobj->address = (uintptr_t) (task_addr - entry->mobj.vm_slide);
+    mobj->length = length < available ? length : available;
+    mobj->pool_entry = entry;
+
+    entry->refcount++;
+}
+
+/**
+ * Map @a length bytes at @a task_addr, returning a view of an existing pooled mapping if one covers the requested
+ * range. The semantics of @a require_full and of the resulting mapping are otherwise identical to those of
+ * plcrash_async_mobject_init().
+ *
+ * The result must be released via plcrash_async_mobject_free(); views remain valid until released, and the
+ * backing mapping remains valid until the pool is freed.
+ *
+ * @param pool The mapping pool, or NULL. If NULL, or if the pool is full, @a mobj will be initialized with
+ * a new mapping that is not backed by the pool.
+ * @param mobj The memory object to be initialized.
+ * @param task The task from which the memory will be mapped.
+ * @param task_addr The task-relative address of the memory to be mapped. This is not required to fall on a page boundry.
+ * @param length The total size of the mapping to create.
+ * @param require_full If false, short mappings will be permitted in the case where a memory object of the requested length
+ * does not exist at the target address.
+ *
+ * @return On success, returns PLCRASH_ESUCCESS. On failure, one of the plcrash_error_t error values will be returned, and no
+ * mapping will be performed.
+ */
+plcrash_error_t plcrash_async_mobject_pool_map (plcrash_async_mobject_pool_t *pool, plcrash_async_mobject_t *mobj, mach_port_t task, pl_vm_address_t task_addr, pl_vm_size_t length, bool require_full) {
+    plcrash_async_mobject_pool_entry_t *entry = NULL;
+    plcrash_error_t err;
+
+    if (pool == NULL)
+        return plcrash_async_mobject_init_internal(mobj, NULL, task, task_addr, length, require_full);
+
+    /* Check for an existing mapping covering the full requested range */
+    for (uint32_t i = 0; i < pool->count; i++) {
+        plcrash_async_mobject_t *pooled = &pool->entries[i].mobj;
+        if (!pool->entries[i].valid || pooled->task != task || task_addr < pooled->task_address)
+            continue;
+
+        /* Direct mappings may only be used while direct mappings are enabled */
+        if (pooled->direct && !pool->direct)
+            continue;
+
+        /* A short mapping of the same range has already determined the mappable extent */
+        pl_vm_size_t offset = task_addr - pooled->task_address;
+        bool short_match = (!require_full && offset == 0 && length <= pool->entries[i].requested_length);
+        if (!short_match && (offset > pooled->length || length > pooled->length - offset))
+            continue;
+
+        pool->hits++;
+        mobject_pool_view(&pool->entries[i], mobj, task_addr, length);
+        return PLCRASH_ESUCCESS;
+    }
+
+    pool->misses++;
+
+    /* Lazily allocate the entries */
+    if (pool->entries == NULL) {
+        vm_address_t addr;
+        kern_return_t kt = plcrash_async_scratch_allocate(&addr, mobject_pool_allocation_size());
+        if (kt != KERN_SUCCESS) {
+            PLCF_DEBUG("plcrash_async_scratch_allocate failed with error %x, the mapping pool could not be initialized", kt);
+            return plcrash_async_mobject_init_internal(mobj, mobject_pool_regions(pool), task, task_addr, length, require_full);
+        }
+
+        pool->entries = (plcrash_async_mobject_pool_entry_t *) addr;
+    }
+
+    /* Find a free entry, evicting an unreferenced mapping if the pool is full. Entries are never moved, as
+     * outstanding views reference their entries directly. */
+    for (uint32_t i = 0; i < pool->count && entry == NULL; i++) {
+        if (!pool->entries[i].valid)
+            entry = &pool->entries[i];
+    }
+
+    if (entry == NULL && pool->count < PLCRASH_ASYNC_MOBJECT_POOL_SIZE)
+        entry = &pool->entries[pool->count++];
+
+    for (uint32_t i = 0; i < pool->count && entry == NULL; i++) {
+        if (pool->entries[i].refcount == 0) {
+            entry = &pool->entries[i];
+            plcrash_async_mobject_free(&entry->mobj);
+            entry->valid = false;
+        }
+    }
+
+    /* All mappings are referenced; fall back on an unpooled mapping */
+    if (entry == NULL)
+        return plcrash_async_mobject_init_internal(mobj, mobject_pool_regions(pool), task, task_addr, length, require_full);
+
+    /* Map and record the new mapping */
+    if ((err = plcrash_async_mobject_init_internal(&entry->mobj, mobject_pool_regions(pool), task, task_addr, length, require_full)) != PLCRASH_ESUCCESS)
+        return err;
+
+    entry->requested_length = length;
+    entry->refcount = 0;
+    entry->valid = true;
+
+    mobject_pool_view(entry, mobj, task_addr, length);
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Free all mappings held by @a pool, and release the pool's resources. All views vended by the pool must have been
+ * released via plcrash_async_mobject_free().
+ *
+ * @param pool The pool to be freed.
+ */
+void plcrash_async_mobject_pool_free (plcrash_async_mobject_pool_t *pool) {
+    if (pool->entries == NULL)
+        return;
+
+    for (uint32_t i = 0; i < pool->count; i++) {
+        plcrash_async_mobject_pool_entry_t *entry = &pool->entries[i];
+        if (!entry->valid)
+            continue;
+
+        PLCF_ASSERT(entry->refcount == 0);
+        plcrash_async_mobject_free(&entry->mobj);
+    }
+
+    plcrash_async_scratch_deallocate((vm_address_t) pool->entries, mobject_pool_allocation_size());
+    pool->entries = NULL;
+    pool->count = 0;
+}
+
 /**
  * @} plcrash_async
  */
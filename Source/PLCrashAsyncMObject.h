@@ -67,9 +67,110 @@ typedef struct plcrash_async_mobject {
     
     /** The actual mapping size. This may differ from the user-requested size, as the base address has been page-aligned */
     pl_vm_size_t vm_length;
+
+    /** If non-NULL, this object is a view of the mapping held by the given pool entry, and does not own its pages. */
+    struct plcrash_async_mobject_pool_entry *pool_entry;
+
+    /** If true, @a address refers directly to the memory; no pages were mapped. This is the case for buffer-backed
+     * objects (see plcrash_async_mobject_init_buffer()), and for local-task objects mapped via a pool for which
+     * plcrash_async_mobject_pool_set_direct() has been enabled, in which case @a vm_slide is zero. */
+    bool direct;
+
+    /** The task-relative base address of the range to which plcrash_async_mobject_task_memcpy() reads are confined. Only
+     * valid if @a bounds_length is non-zero. */
+    pl_vm_address_t bounds_address;
+
+    /** The length of the range to which plcrash_async_mobject_task_memcpy() reads are confined, or 0 if reads are not
+     * confined. See plcrash_async_mobject_set_read_bounds(). */
+    pl_vm_size_t bounds_length;
 } plcrash_async_mobject_t;
 
+/** The maximum number of readable regions that may be cached by a plcrash_async_mobject_region_cache_t. */
+#define PLCRASH_ASYNC_MOBJECT_REGION_CACHE_SIZE 16
+
+/**
+ * @ingroup plcrash_async
+ * @internal
+ *
+ * A cache of readable VM regions within the current task, used to avoid repeated mach_vm_region_recurse() look-ups when
+ * validating local-task memory objects.
+ */
+typedef struct plcrash_async_mobject_region_cache {
+    /** The base addresses of the cached readable regions. */
+    pl_vm_address_t base[PLCRASH_ASYNC_MOBJECT_REGION_CACHE_SIZE];
+
+    /** The sizes of the cached readable regions. */
+    pl_vm_size_t size[PLCRASH_ASYNC_MOBJECT_REGION_CACHE_SIZE];
+
+    /** The number of valid cache entries. */
+    uint32_t count;
+
+    /** The index of the next entry to be replaced once the cache is full. */
+    uint32_t next;
+} plcrash_async_mobject_region_cache_t;
+
+/** The maximum number of mappings that may be held by a plcrash_async_mobject_pool_t. */
+#define PLCRASH_ASYNC_MOBJECT_POOL_SIZE 64
+
+/**
+ * @ingroup plcrash_async
+ * @internal
+ *
+ * A single plcrash_async_mobject_pool_t mapping.
+ */
+typedef struct plcrash_async_mobject_pool_entry {
+    /** The pooled mapping. */
+    plcrash_async_mobject_t mobj;
+
+    /** The length originally requested for @a mobj. If a short mapping was permitted, this may exceed the mapping's
+     * length, and later short mapping requests of the same range will be served by @a mobj. */
+    pl_vm_size_t requested_length;
+
+    /** True if @a mobj holds a valid mapping. */
+    bool valid;
+
+    /** The number of outstanding views of @a mobj. */
+    uint32_t refcount;
+} plcrash_async_mobject_pool_entry_t;
+
+/**
+ * @ingroup plcrash_async
+ * @internal
+ *
+ * A pool of memory mappings, allowing repeated mappings of the same target memory (eg, an image's __LINKEDIT
+ * segment) to share a single mapping. Requests for a range that is covered by an existing mapping are served
+ * as a reference-counted view of that mapping; mappings are only deallocated once the pool is freed, or when a
+ * mapping with no outstanding views must be evicted to make room for a new mapping.
+ *
+ * The pool is intended to be scoped to a single crash report.
+ *
+ * @warning A pool instance may not be used concurrently from multiple threads.
+ */
+typedef struct plcrash_async_mobject_pool {
+    /** Pool entries. Lazily allocated on first use; NULL if unallocated, or if allocation failed. Mappings of ranges shared
+     * by multiple images, such as the shared cache's single __LINKEDIT region, are held once. */
+    plcrash_async_mobject_pool_entry_t *entries;
+
+    /** The number of entries in use. */
+    uint32_t count;
+
+    /** The number of mapping requests served from an existing mapping. */
+    uint32_t hits;
+
+    /** The number of mapping requests that required a new mapping. */
+    uint32_t misses;
+
+    /** Readable regions of the current task, as validated by direct local-task mappings. Only valid while
+     * @a direct is enabled. */
+    plcrash_async_mobject_region_cache_t regions;
+
+    /** If true, local-task mappings reference the target memory directly, rather than remapping it. See
+     * plcrash_async_mobject_pool_set_direct(). */
+    bool direct;
+} plcrash_async_mobject_pool_t;
+
 plcrash_error_t plcrash_async_mobject_init (plcrash_async_mobject_t *mobj, mach_port_t task, pl_vm_address_t task_addr, pl_vm_size_t length, bool require_full);
+void plcrash_async_mobject_init_buffer (plcrash_async_mobject_t *mobj, pl_vm_address_t task_addr, const void *buffer, pl_vm_size_t length);
 
 pl_vm_address_t plcrash_async_mobject_base_address (plcrash_async_mobject_t *mobj);
 pl_vm_address_t plcrash_async_mobject_length (plcrash_async_mobject_t *mobj);
@@ -87,7 +188,17 @@ plcrash_error_t plcrash_async_mobject_read_uint32 (plcrash_async_mobject_t *mobj
 plcrash_error_t plcrash_async_mobject_read_uint64 (plcrash_async_mobject_t *mobj, const plcrash_async_byteorder_t *byteorder,
                                                    pl_vm_address_t address, pl_vm_off_t offset, uint64_t *result);
 
+plcrash_error_t plcrash_async_mobject_task_memcpy (plcrash_async_mobject_t *mobj, task_t task, pl_vm_address_t address, pl_vm_off_t offset, void *dest, pl_vm_size_t len);
+void plcrash_async_mobject_set_read_bounds (plcrash_async_mobject_t *mobj, pl_vm_address_t address, pl_vm_size_t length);
+
+bool plcrash_async_mobject_region_lookup (mach_port_t task, pl_vm_address_t addr, pl_vm_address_t *region_base, pl_vm_size_t *region_size);
+
 void plcrash_async_mobject_free (plcrash_async_mobject_t *mobj);
+
+void plcrash_async_mobject_pool_init (plcrash_async_mobject_pool_t *pool);
+void plcrash_async_mobject_pool_set_direct (plcrash_async_mobject_pool_t *pool, bool enabled);
+plcrash_error_t plcrash_async_mobject_pool_map (plcrash_async_mobject_pool_t *pool, plcrash_async_mobject_t *mobj, mach_port_t task, pl_vm_address_t task_addr, pl_vm_size_t length, bool require_full);
+void plcrash_async_mobject_pool_free (plcrash_async_mobject_pool_t *pool);
     
 #ifdef __cplusplus
 }
@@ -203,4 +203,153 @@
     plcrash_async_mobject_free(&mobj);
 }
 
+/**
+ * Test reads via plcrash_async_mobject_task_memcpy(), both within and outside of the mapped range.
+ */
+- (void) testTaskMemcpy {
+    uint8_t test_bytes[] = { 0x00, 0x01, 0x02, 0x03 , 0x04, 0x05, 0x06, 0x07 };
+    uint8_t unmapped_bytes[] = { 0x08, 0x09 };
+    uint8_t dest[2];
+
+    /* Map the memory */
+    plcrash_async_mobject_t mobj;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_init(&mobj, mach_task_self(), (pl_vm_address_t) test_bytes, sizeof(test_bytes), true), @"Failed to initialize mapping");
+
+    /* Read from within the mapping */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_task_memcpy(&mobj, mach_task_self(), (pl_vm_address_t) test_bytes, 6, dest, sizeof(dest)), @"Failed to read data");
+    STAssertEquals(dest[0], (uint8_t) 0x06, @"Incorrect data");
+    STAssertEquals(dest[1], (uint8_t) 0x07, @"Incorrect data");
+
+    /* Read from outside the mapping; the read should fall back on the task */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_task_memcpy(&mobj, mach_task_self(), (pl_vm_address_t) unmapped_bytes, 0, dest, sizeof(dest)), @"Failed to read data");
+    STAssertEquals(dest[0], (uint8_t) 0x08, @"Incorrect data");
+    STAssertEquals(dest[1], (uint8_t) 0x09, @"Incorrect data");
+
+    /* Read without a mapping */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_task_memcpy(NULL, mach_task_self(), (pl_vm_address_t) test_bytes, 0, dest, sizeof(dest)), @"Failed to read data");
+    STAssertEquals(dest[0], (uint8_t) 0x00, @"Incorrect data");
+    STAssertEquals(dest[1], (uint8_t) 0x01, @"Incorrect data");
+
+    /* Clean up */
+    plcrash_async_mobject_free(&mobj);
+}
+
+/**
+ * Test confinement of plcrash_async_mobject_task_memcpy() reads via plcrash_async_mobject_set_read_bounds().
+ */
+- (void) testTaskMemcpyReadBounds {
+    uint8_t test_bytes[] = { 0x00, 0x01, 0x02, 0x03 , 0x04, 0x05, 0x06, 0x07 };
+    uint8_t bounded_bytes[] = { 0x08, 0x09, 0x0A, 0x0B };
+    uint8_t dest[2];
+
+    /* Map the first half of the test bytes, and confine reads to the bounded bytes */
+    plcrash_async_mobject_t mobj;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_init(&mobj, mach_task_self(), (pl_vm_address_t) test_bytes, 4, true), @"Failed to initialize mapping");
+    plcrash_async_mobject_set_read_bounds(&mobj, (pl_vm_address_t) bounded_bytes, sizeof(bounded_bytes));
+
+    /* Reads from within the mapping are unaffected */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_task_memcpy(&mobj, mach_task_self(), (pl_vm_address_t) test_bytes, 0, dest, sizeof(dest)), @"Failed to read data");
+    STAssertEquals(dest[0], (uint8_t) 0x00, @"Incorrect data");
+
+    /* Reads within the bounds fall back on the task */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_task_memcpy(&mobj, mach_task_self(), (pl_vm_address_t) bounded_bytes, 2, dest, sizeof(dest)), @"Failed to read data");
+    STAssertEquals(dest[0], (uint8_t) 0x0A, @"Incorrect data");
+    STAssertEquals(dest[1], (uint8_t) 0x0B, @"Incorrect data");
+
+    /* Reads outside of the mapping and the bounds are rejected, including reads that straddle the bounds */
+    STAssertEquals(PLCRASH_ENOTFOUND, plcrash_async_mobject_task_memcpy(&mobj, mach_task_self(), (pl_vm_address_t) test_bytes, 6, dest, sizeof(dest)), @"Read outside of bounds");
+    STAssertEquals(PLCRASH_ENOTFOUND, plcrash_async_mobject_task_memcpy(&mobj, mach_task_self(), (pl_vm_address_t) bounded_bytes, 3, dest, sizeof(dest)), @"Read outside of bounds");
+
+    /* Clearing the bounds restores the task fallback */
+    plcrash_async_mobject_set_read_bounds(&mobj, 0, 0);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_task_memcpy(&mobj, mach_task_self(), (pl_vm_address_t) test_bytes, 6, dest, sizeof(dest)), @"Failed to read data");
+    STAssertEquals(dest[0], (uint8_t) 0x06, @"Incorrect data");
+
+    /* Clean up */
+    plcrash_async_mobject_free(&mobj);
+}
+
+/**
+ * Test direct referencing of local task memory.
+ */
+- (void) testLocalTaskDirect {
+    uint8_t test_bytes[] = { 0x00, 0x01, 0x02, 0x03 };
+    plcrash_async_mobject_pool_t pool;
+    plcrash_async_mobject_t mobj;
+
+    /* Unpooled local memory must be remapped */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_init(&mobj, mach_task_self(), (pl_vm_address_t) test_bytes, sizeof(test_bytes), true), @"Failed to initialize mapping");
+    STAssertFalse(mobj.direct, @"Local task memory was referenced directly");
+    STAssertNotEquals(mobj.address, (uintptr_t) test_bytes, @"Local task memory was not remapped");
+    plcrash_async_mobject_free(&mobj);
+
+    /* Pooled local memory is only referenced directly once enabled */
+    plcrash_async_mobject_pool_init(&pool);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_pool_map(&pool, &mobj, mach_task_self(), (pl_vm_address_t) test_bytes, sizeof(test_bytes), true), @"Failed to initialize mapping");
+    STAssertFalse(mobj.direct, @"Local task memory was referenced directly");
+    plcrash_async_mobject_free(&mobj);
+
+    plcrash_async_mobject_pool_set_direct(&pool, true);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_pool_map(&pool, &mobj, mach_task_self(), (pl_vm_address_t) test_bytes + 1, sizeof(test_bytes) - 1, true), @"Failed to initialize mapping");
+    STAssertFalse(mobj.direct, @"The existing remapped mapping should have been reused");
+    plcrash_async_mobject_free(&mobj);
+
+    uint8_t other_bytes[] = { 0x04, 0x05 };
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_pool_map(&pool, &mobj, mach_task_self(), (pl_vm_address_t) other_bytes, sizeof(other_bytes), true), @"Failed to initialize mapping");
+    STAssertTrue(mobj.direct, @"Local task memory was not referenced directly");
+    STAssertEquals(mobj.address, (uintptr_t) other_bytes, @"Incorrect address");
+    STAssertEquals(mobj.vm_slide, (int64_t) 0, @"Incorrect slide value!");
+    STAssertEquals(mobj.length, (pl_vm_size_t) sizeof(other_bytes), @"Incorrect length");
+    plcrash_async_mobject_free(&mobj);
+
+    /* Unreadable memory must be rejected */
+    vm_address_t page;
+    STAssertEquals(KERN_SUCCESS, vm_allocate(mach_task_self(), &page, vm_page_size, VM_FLAGS_ANYWHERE), @"Failed to allocate page");
+    STAssertEquals(KERN_SUCCESS, vm_protect(mach_task_self(), page, vm_page_size, false, VM_PROT_NONE), @"Failed to protect page");
+    STAssertNotEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_pool_map(&pool, &mobj, mach_task_self(), (pl_vm_address_t) page, vm_page_size, false), @"Mapped an unreadable page");
+    vm_deallocate(mach_task_self(), page, vm_page_size);
+
+    /* Once disabled, direct mappings must no longer be vended */
+    plcrash_async_mobject_pool_set_direct(&pool, false);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_pool_map(&pool, &mobj, mach_task_self(), (pl_vm_address_t) other_bytes, sizeof(other_bytes), true), @"Failed to initialize mapping");
+    STAssertFalse(mobj.direct, @"Direct mapping was vended after being disabled");
+    plcrash_async_mobject_free(&mobj);
+
+    plcrash_async_mobject_pool_free(&pool);
+}
+
+/**
+ * Test pooled mappings.
+ */
+- (void) testPoolMap {
+    uint8_t test_bytes[] = { 0x00, 0x01, 0x02, 0x03 , 0x04, 0x05, 0x06, 0x07 };
+    plcrash_async_mobject_pool_t pool;
+    plcrash_async_mobject_t mobj;
+    plcrash_async_mobject_t view;
+
+    plcrash_async_mobject_pool_init(&pool);
+
+    /* Map the full range */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_pool_map(&pool, &mobj, mach_task_self(), (pl_vm_address_t) test_bytes, sizeof(test_bytes), true), @"Failed to initialize mapping");
+    STAssertEquals(pool.misses, (uint32_t) 1, @"Expected a pool miss");
+
+    /* Map a sub-range; this should be served by the existing mapping */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_pool_map(&pool, &view, mach_task_self(), (pl_vm_address_t) test_bytes + 4, 4, true), @"Failed to initialize mapping");
+    STAssertEquals(pool.hits, (uint32_t) 1, @"Expected a pool hit");
+    STAssertEquals(pool.count, (uint32_t) 1, @"Expected a single pooled mapping");
+
+    STAssertEquals(view.length, (pl_vm_size_t) 4, @"Incorrect view length");
+    STAssertEquals(view.address, mobj.address + 4, @"View should share the pooled mapping");
+
+    uint8_t *data = plcrash_async_mobject_remap_address(&view, (pl_vm_address_t) test_bytes + 4, 0, 4);
+    STAssertNotNULL(data, @"Could not get data pointer");
+    STAssertEquals(data[0], (uint8_t) 0x04, @"Incorrect data");
+    STAssertEquals(data[3], (uint8_t) 0x07, @"Incorrect data");
+
+    /* Clean up */
+    plcrash_async_mobject_free(&view);
+    plcrash_async_mobject_free(&mobj);
+    plcrash_async_mobject_pool_free(&pool);
+}
+
 @end
@@ -32,9 +32,24 @@
 #include <string.h>
 #include <inttypes.h>
 #include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <libkern/OSAtomic.h>
 
 #include <mach-o/fat.h>
 
+/* Defined by newer SDKs; set by dyld for images loaded from the shared cache */
+#ifndef MH_DYLIB_IN_CACHE
+#define MH_DYLIB_IN_CACHE 0x80000000
+#endif
+
 /**
  * @internal
  * @ingroup plcrash_async
@@ -45,6 +60,96 @@
  * @{
  */
 
+/**
+ * Populate @a image's load command index, recording the offset of the first load command of each type, and of
+ * each segment command.
+ *
+ * @param image An image with mapped load commands.
+ */
+static void plcrash_async_macho_index_commands (plcrash_async_macho_t *image) {
+    plcrash_async_macho_command_index_t *index = &image->cmd_index;
+    uint32_t segment_type = plcrash_async_macho_m64(image) ? LC_SEGMENT_64 : LC_SEGMENT;
+
+    index->cmd_count = 0;
+    index->cmds_complete = true;
+    index->seg_count = 0;
+    index->segs_complete = true;
+    for (uint32_t i = 0; i < PLCRASH_ASYNC_MACHO_SEGMENT_INDEX_SIZE; i++)
+        index->seg_mapped_sizes[i] = 0;
+
+    struct load_command *cmd = NULL;
+    while ((cmd = plcrash_async_macho_next_command(image, cmd)) != NULL) {
+        uint32_t type = plcrash_async_swap32(image->byteorder, cmd->cmd);
+        uint32_t offset = (uint32_t) ((uintptr_t) cmd - image->load_cmds.address);
+
+        /* Record the first command of each type */
+        bool seen = false;
+        for (uint32_t i = 0; i < index->cmd_count && !seen; i++)
+            seen = (index->cmd_types[i] == type);
+
+        if (!seen) {
+            if (index->cmd_count < PLCRASH_ASYNC_MACHO_COMMAND_INDEX_SIZE) {
+                index->cmd_types[index->cmd_count] = type;
+                index->cmd_offsets[index->cmd_count] = offset;
+                index->cmd_count++;
+            } else {
+                index->cmds_complete = false;
+            }
+        }
+
+        /* Record all segments */
+        if (type == segment_type) {
+            if (index->seg_count < PLCRASH_ASYNC_MACHO_SEGMENT_INDEX_SIZE) {
+                index->seg_offsets[index->seg_count++] = offset;
+            } else {
+                index->segs_complete = false;
+            }
+        }
+    }
+}
+
+/** The maximum number of times a reader will yield while waiting on another thread's mapping of an image's load commands. */
+#define LOAD_CMDS_MAP_WAIT_LIMIT 1000
+
+/**
+ * Ensure that @a image's load commands are mapped, remapping them if previously released by
+ * plcrash_nasync_macho_release_load_commands(). If another thread is concurrently mapping the load commands,
+ * this waits a bounded time for the mapping to complete.
+ *
+ * @param image The image whose load commands are required.
+ *
+ * @return Returns true if the load commands are mapped, or false if they could not be mapped.
+ */
+static bool macho_map_load_commands (plcrash_async_macho_t *image) {
+    if (image->load_cmds_state == PLCRASH_ASYNC_MACHO_LOAD_CMDS_MAPPED) {
+        OSMemoryBarrier();
+        return true;
+    }
+
+    /* Claim the mapping; if another thread holds the claim, wait on its result. */
+    if (!OSAtomicCompareAndSwap32Barrier(PLCRASH_ASYNC_MACHO_LOAD_CMDS_UNMAPPED, PLCRASH_ASYNC_MACHO_LOAD_CMDS_MAPPING, &image->load_cmds_state)) {
+        for (int i = 0; i < LOAD_CMDS_MAP_WAIT_LIMIT && image->load_cmds_state == PLCRASH_ASYNC_MACHO_LOAD_CMDS_MAPPING; i++)
+            sched_yield();
+
+        OSMemoryBarrier();
+        return (image->load_cmds_state == PLCRASH_ASYNC_MACHO_LOAD_CMDS_MAPPED);
+    }
+
+    pl_vm_size_t cmd_len = plcrash_async_swap32(image->byteorder, image->header.sizeofcmds);
+    plcrash_error_t ret = plcrash_async_mobject_init(&image->load_cmds, image->task, image->header_addr + image->header_size, cmd_len, true);
+    if (ret != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("Failed to remap Mach-O load commands in image %s: %d", image->name, ret);
+        OSAtomicCompareAndSwap32Barrier(PLCRASH_ASYNC_MACHO_LOAD_CMDS_MAPPING, PLCRASH_ASYNC_MACHO_LOAD_CMDS_UNMAPPED, &image->load_cmds_state);
+        return false;
+    }
+
+    OSAtomicCompareAndSwap32Barrier(PLCRASH_ASYNC_MACHO_LOAD_CMDS_MAPPING, PLCRASH_ASYNC_MACHO_LOAD_CMDS_MAPPED, &image->load_cmds_state);
+    return true;
+}
+
+static plcrash_error_t macho_init (plcrash_async_macho_t *image, mach_port_t task, const char *name, bool borrow_name, pl_vm_address_t header);
+static plcrash_error_t macho_find_section (plcrash_async_macho_t *image, const char *segname, const char *sectname, pl_vm_address_t *addr, pl_vm_size_t *size);
+
 /**
  * Initialize a new Mach-O binary image parser.
  *
@@ -58,17 +163,48 @@
  * @warning This method is not async safe.
  */
 plcrash_error_t plcrash_nasync_macho_init (plcrash_async_macho_t *image, mach_port_t task, const char *name, pl_vm_address_t header) {
+    return macho_init(image, task, name, false, header);
+}
+
+/**
+ * Initialize a new Mach-O binary image parser, borrowing @a name rather than copying it. As no allocation is
+ * required, this method is async-safe.
+ *
+ * @param image The image structure to be initialized.
+ * @param name The file name or path for the Mach-O image. This string must remain valid for the lifetime of @a image.
+ * Strings owned by dyld do not meet this requirement, as they are freed when the image is unloaded.
+ * @param header The task-local address of the image's Mach-O header.
+ *
+ * @return PLCRASH_ESUCCESS on success. PLCRASH_EINVAL will be returned in the Mach-O file can not be parsed,
+ * or PLCRASH_EINTERNAL if an error occurs reading from the target task.
+ */
+plcrash_error_t plcrash_async_macho_init_borrowed_name (plcrash_async_macho_t *image, mach_port_t task, const char *name, pl_vm_address_t header) {
+    return macho_init(image, task, name, true, header);
+}
+
+/**
+ * Shared implementation of plcrash_nasync_macho_init() and plcrash_async_macho_init_borrowed_name().
+ */
+static plcrash_error_t macho_init (plcrash_async_macho_t *image, mach_port_t task, const char *name, bool borrow_name, pl_vm_address_t header) {
     plcrash_error_t ret;
 
     /* Defaults checked in the  error cleanup handler */
     bool mobj_initialized = false;
     bool task_initialized = false;
     image->name = NULL;
+    image->symbol_index = NULL;
+    image->symbol_index_mapping = NULL;
+    image->symbol_index_mapping_size = 0;
+    image->dwarf_fde_index = NULL;
+    image->function_starts = NULL;
+    image->in_shared_cache = false;
+    image->has_objc = false;
 
     /* Basic initialization */
     image->task = task;
     image->header_addr = header;
-    image->name = strdup(name);
+    image->name_borrowed = borrow_name;
+    image->name = borrow_name ? (char *) name : strdup(name);
 
     mach_port_mod_refs(mach_task_self(), image->task, MACH_PORT_RIGHT_SEND, 1);
     task_initialized = true;
@@ -118,17 +254,30 @@ plcrash_error_t plcrash_nasync_macho_init (plcrash_async_macho_t *image, mach_po
             return PLCRASH_EINVAL;
     }
 
+#if PLCRASH_FEATURE_HOST_ONLY_CRASH_PATH
+    /* Width and byte order dispatch is resolved at compile time; images that do not match the host are unsupported */
+    if (image->m64 != PLCRASH_ASYNC_MACHO_HOST_M64 || !image->byteorder->native) {
+        PLCF_DEBUG("Mach-O image does not match the host architecture: %s", image->name);
+        return PLCRASH_ENOTSUP;
+    }
+#endif
+
+    /* Images loaded from the shared cache are flagged by dyld on newer releases; earlier releases are detected
+     * by the image list (see plcrash_nasync_image_list_set_shared_cache()). */
+    if (plcrash_async_swap32(image->byteorder, image->header.flags) & MH_DYLIB_IN_CACHE)
+        image->in_shared_cache = true;
+
     /* Save the header size */
-    if (image->m64) {
+    if (plcrash_async_macho_m64(image)) {
         image->header_size = sizeof(struct mach_header_64);
     } else {
         image->header_size = sizeof(struct mach_header);
     }
     
     /* Map in header + load commands */
-    pl_vm_size_t cmd_len = image->byteorder->swap32(image->header.sizeofcmds);
+    pl_vm_size_t cmd_len = plcrash_async_swap32(image->byteorder, image->header.sizeofcmds);
     pl_vm_size_t cmd_offset = image->header_addr + image->header_size;
-    image->ncmds = image->byteorder->swap32(image->header.ncmds);
+    image->ncmds = plcrash_async_swap32(image->byteorder, image->header.ncmds);
 
     ret = plcrash_async_mobject_init(&image->load_cmds, image->task, cmd_offset, cmd_len, true);
     if (ret != PLCRASH_ESUCCESS) {
@@ -136,14 +285,21 @@ plcrash_error_t plcrash_nasync_macho_init (plcrash_async_macho_t *image, mach_po
         goto error;
     } else {
         mobj_initialized = true;
+        image->load_cmds_state = PLCRASH_ASYNC_MACHO_LOAD_CMDS_MAPPED;
     }
 
-    /* Now that the image has been sufficiently initialized, determine the __TEXT segment size */
+    /* Index the load commands and segments */
+    plcrash_async_macho_index_commands(image);
+
+    /* Now that the image has been sufficiently initialized, determine the __TEXT segment size and the __DATA segment
+     * address */
     void *cmdptr = NULL;
     image->text_size = 0x0;
+    image->data_vmaddr = 0x0;
+    image->has_data_segment = false;
     bool found_text_seg = false;
-    while ((cmdptr = plcrash_async_macho_next_command_type(image, cmdptr, image->m64 ? LC_SEGMENT_64 : LC_SEGMENT)) != 0) {
-        if (image->m64) {
+    while ((cmdptr = plcrash_async_macho_next_command_type(image, cmdptr, plcrash_async_macho_m64(image) ? LC_SEGMENT_64 : LC_SEGMENT)) != 0) {
+        if (plcrash_async_macho_m64(image)) {
             struct segment_command_64 *segment = cmdptr;
             if (!plcrash_async_mobject_verify_local_pointer(&image->load_cmds, (uintptr_t) segment, 0, sizeof(*segment))) {
                 PLCF_DEBUG("LC_SEGMENT command was too short");
@@ -151,13 +307,14 @@ plcrash_error_t plcrash_nasync_macho_init (plcrash_async_macho_t *image, mach_po
                 goto error;
             }
             
-            if (plcrash_async_strncmp(segment->segname, SEG_TEXT, sizeof(segment->segname)) != 0)
-                continue;
-
-            image->text_size = image->byteorder->swap64(segment->vmsize);
-            image->text_vmaddr = image->byteorder->swap64(segment->vmaddr);
-            found_text_seg = true;
-            break;
+            if (!found_text_seg && plcrash_async_strncmp(segment->segname, SEG_TEXT, sizeof(segment->segname)) == 0) {
+                image->text_size = plcrash_async_swap64(image->byteorder, segment->vmsize);
+                image->text_vmaddr = plcrash_async_swap64(image->byteorder, segment->vmaddr);
+                found_text_seg = true;
+            } else if (!image->has_data_segment && plcrash_async_strncmp(segment->segname, SEG_DATA, sizeof(segment->segname)) == 0) {
+                image->data_vmaddr = plcrash_async_swap64(image->byteorder, segment->vmaddr);
+                image->has_data_segment = true;
+            }
         } else {
             struct segment_command *segment = cmdptr;
             if (!plcrash_async_mobject_verify_local_pointer(&image->load_cmds, (uintptr_t) segment, 0, sizeof(*segment))) {
@@ -166,14 +323,18 @@ plcrash_error_t plcrash_nasync_macho_init (plcrash_async_macho_t *image, mach_po
                 goto error;
             }
             
-            if (plcrash_async_strncmp(segment->segname, SEG_TEXT, sizeof(segment->segname)) != 0)
-                continue;
-            
-            image->text_size = image->byteorder->swap32(segment->vmsize);
-            image->text_vmaddr = image->byteorder->swap32(segment->vmaddr);
-            found_text_seg = true;
-            break;
+            if (!found_text_seg && plcrash_async_strncmp(segment->segname, SEG_TEXT, sizeof(segment->segname)) == 0) {
+                image->text_size = plcrash_async_swap32(image->byteorder, segment->vmsize);
+                image->text_vmaddr = plcrash_async_swap32(image->byteorder, segment->vmaddr);
+                found_text_seg = true;
+            } else if (!image->has_data_segment && plcrash_async_strncmp(segment->segname, SEG_DATA, sizeof(segment->segname)) == 0) {
+                image->data_vmaddr = plcrash_async_swap32(image->byteorder, segment->vmaddr);
+                image->has_data_segment = true;
+            }
         }
+
+        if (found_text_seg && image->has_data_segment)
+            break;
     }
 
     if (!found_text_seg) {
@@ -191,13 +352,25 @@ plcrash_error_t plcrash_nasync_macho_init (plcrash_async_macho_t *image, mach_po
         image->vmaddr_slide = 0;
     }
 
+    /* Record whether the image contains any Objective-C metadata, allowing images without it to be skipped by
+     * the Objective-C symbolicator without mapping any of their sections. */
+    pl_vm_address_t sectaddr;
+    pl_vm_size_t sectsize;
+    if (macho_find_section(image, SEG_DATA, "__objc_classlist", &sectaddr, &sectsize) == PLCRASH_ESUCCESS &&
+        macho_find_section(image, SEG_DATA, "__objc_const", &sectaddr, &sectsize) == PLCRASH_ESUCCESS)
+    {
+        image->has_objc = true;
+    } else if (plcrash_async_macho_find_segment_cmd(image, SEG_OBJC) != NULL) {
+        image->has_objc = true;
+    }
+
     return PLCRASH_ESUCCESS;
     
 error:
     if (mobj_initialized)
         plcrash_async_mobject_free(&image->load_cmds);
     
-    if (image->name != NULL)
+    if (image->name != NULL && !image->name_borrowed)
         free(image->name);
     
     if (task_initialized)
@@ -238,6 +411,26 @@ pl_vm_size_t plcrash_async_macho_header_size (plcrash_async_macho_t *image) {
     return image->header_size;
 }
 
+/**
+ * Return true if @a image is part of the dyld shared cache. The __LINKEDIT segment of all shared cache images
+ * is a single shared region, and will be mapped once when accessed via a common mapping pool.
+ *
+ * @param image The Mach-O image.
+ */
+bool plcrash_async_macho_in_shared_cache (plcrash_async_macho_t *image) {
+    return image->in_shared_cache;
+}
+
+/**
+ * Return true if @a image contains Objective-C metadata; either ObjC2 class lists (__DATA,__objc_classlist and
+ * __DATA,__objc_const), or an ObjC1 __OBJC segment. This is determined once, when the image is initialized.
+ *
+ * @param image The Mach-O image.
+ */
+bool plcrash_async_macho_has_objc (plcrash_async_macho_t *image) {
+    return image->has_objc;
+}
+
 /**
  * Return true if @a address is mapped within @a image's __TEXT segment, false otherwise.
  *
@@ -257,7 +450,7 @@ bool plcrash_async_macho_contains_address (plcrash_async_macho_t *image, pl_vm_a
  * @param image The image from which the CPU type should be returned.
  */
 cpu_type_t plcrash_async_macho_cpu_type (plcrash_async_macho_t *image) {
-    return image->byteorder->swap32(image->header.cputype);
+    return plcrash_async_swap32(image->byteorder, image->header.cputype);
 }
 
 /**
@@ -266,7 +459,7 @@ cpu_type_t plcrash_async_macho_cpu_type (plcrash_async_macho_t *image) {
  * @param image The image from which the CPU subtype should be returned.
  */
 cpu_subtype_t plcrash_async_macho_cpu_subtype (plcrash_async_macho_t *image) {
-    return image->byteorder->swap32(image->header.cpusubtype);
+    return plcrash_async_swap32(image->byteorder, image->header.cpusubtype);
 }
 
 
@@ -287,11 +480,14 @@ void *plcrash_async_macho_next_command (plcrash_async_macho_t *image, void *prev
     /* On the first iteration, determine the LC_CMD offset from the Mach-O header. */
     if (previous == NULL) {
         /* Sanity check */
-        if (image->byteorder->swap32(image->header.sizeofcmds) < sizeof(struct load_command)) {
+        if (plcrash_async_swap32(image->byteorder, image->header.sizeofcmds) < sizeof(struct load_command)) {
             PLCF_DEBUG("Mach-O sizeofcmds is less than sizeof(struct load_command) in %s", image->name);
             return NULL;
         }
 
+        if (!macho_map_load_commands(image))
+            return NULL;
+
         return plcrash_async_mobject_remap_address(&image->load_cmds, image->header_addr, image->header_size, sizeof(struct load_command));
     }
 
@@ -303,7 +499,7 @@ void *plcrash_async_macho_next_command (plcrash_async_macho_t *image, void *prev
     }
 
     /* Advance to the next command */
-    uint32_t cmdsize = image->byteorder->swap32(cmd->cmdsize);
+    uint32_t cmdsize = plcrash_async_swap32(image->byteorder, cmd->cmdsize);
     
     /* Sanity check the cmdsize */
     if (cmdsize < sizeof(struct load_command)) {
@@ -333,7 +529,7 @@ void *plcrash_async_macho_next_command (plcrash_async_macho_t *image, void *prev
 
     /* Verify the actual size. */
     cmd = next;
-    if (!plcrash_async_mobject_verify_local_pointer(&image->load_cmds, (uintptr_t) next, 0, image->byteorder->swap32(cmd->cmdsize))) {
+    if (!plcrash_async_mobject_verify_local_pointer(&image->load_cmds, (uintptr_t) next, 0, plcrash_async_swap32(image->byteorder, cmd->cmdsize))) {
         PLCF_DEBUG("Failed to map LC_CMD at address %p in: %s", cmd, image->name);
         return NULL;
     }
@@ -359,7 +555,7 @@ void *plcrash_async_macho_next_command_type (plcrash_async_macho_t *image, void
     /* Iterate commands until we either find a match, or reach the end */
     while ((cmd = plcrash_async_macho_next_command(image, cmd)) != NULL) {
         /* Return a match */
-        if (image->byteorder->swap32(cmd->cmd) == expectedCommand) {
+        if (plcrash_async_swap32(image->byteorder, cmd->cmd) == expectedCommand) {
             return cmd;
         }
     }
@@ -381,8 +577,21 @@ void *plcrash_async_macho_next_command_type (plcrash_async_macho_t *image, void
  * returned.
  */
 void *plcrash_async_macho_find_command (plcrash_async_macho_t *image, uint32_t expectedCommand) {
+    const plcrash_async_macho_command_index_t *index = &image->cmd_index;
     struct load_command *cmd = NULL;
 
+    if (!macho_map_load_commands(image))
+        return NULL;
+
+    /* Check the index; commands were validated by plcrash_async_macho_next_command() when indexed */
+    for (uint32_t i = 0; i < index->cmd_count; i++) {
+        if (index->cmd_types[i] == expectedCommand)
+            return (void *) (image->load_cmds.address + index->cmd_offsets[i]);
+    }
+
+    if (index->cmds_complete)
+        return NULL;
+
     /* Iterate commands until we either find a match, or reach the end */
     while ((cmd = plcrash_async_macho_next_command(image, cmd)) != NULL) {
         /* Read the load command type */
@@ -392,7 +601,7 @@ void *plcrash_async_macho_find_command (plcrash_async_macho_t *image, uint32_t e
         }
 
         /* Return a match */
-        if (image->byteorder->swap32(cmd->cmd) == expectedCommand) {
+        if (plcrash_async_swap32(image->byteorder, cmd->cmd) == expectedCommand) {
             return cmd;
         }
     }
@@ -410,12 +619,31 @@ void *plcrash_async_macho_find_command (plcrash_async_macho_t *image, uint32_t e
  * @return Returns a mapped pointer to the segment on success, or NULL on failure.
  */
 void *plcrash_async_macho_find_segment_cmd (plcrash_async_macho_t *image, const char *segname) {
+    const plcrash_async_macho_command_index_t *index = &image->cmd_index;
     void *seg = NULL;
 
-    while ((seg = plcrash_async_macho_next_command_type(image, seg, image->m64 ? LC_SEGMENT_64 : LC_SEGMENT)) != 0) {
+    if (!macho_map_load_commands(image))
+        return NULL;
+
+    /* Check the index; segments were validated by plcrash_async_macho_next_command() when indexed */
+    for (uint32_t i = 0; i < index->seg_count; i++) {
+        seg = (void *) (image->load_cmds.address + index->seg_offsets[i]);
+
+        /* Both segment command types place the segment name at the same offset */
+        const char *name = plcrash_async_macho_m64(image) ? ((struct segment_command_64 *) seg)->segname : ((struct segment_command *) seg)->segname;
+        if (plcrash_async_strncmp(segname, name, sizeof(((struct segment_command *) seg)->segname)) == 0)
+            return seg;
+    }
+
+    if (index->segs_complete)
+        return NULL;
+
+    seg = NULL;
+
+    while ((seg = plcrash_async_macho_next_command_type(image, seg, plcrash_async_macho_m64(image) ? LC_SEGMENT_64 : LC_SEGMENT)) != 0) {
 
         /* Read the load command */
-        if (image->m64) {
+        if (plcrash_async_macho_m64(image)) {
             struct segment_command_64 *cmd_64 = seg;
             if (plcrash_async_strncmp(segname, cmd_64->segname, sizeof(cmd_64->segname)) == 0)
                 return seg;
@@ -448,6 +676,42 @@ void *plcrash_async_macho_find_segment_cmd (plcrash_async_macho_t *image, const
  * @return Returns PLCRASH_ESUCCESS on success, or an error result on failure.
  */
 plcrash_error_t plcrash_async_macho_map_segment (plcrash_async_macho_t *image, const char *segname, pl_async_macho_mapped_segment_t *seg) {
+    return plcrash_async_macho_pool_map_segment(NULL, image, segname, seg);
+}
+
+/**
+ * @internal
+ *
+ * Return the index of @a segment within @a image's segment index, or UINT32_MAX if the segment was not indexed.
+ *
+ * @param image The image containing @a segment.
+ * @param segment A segment command, as returned by plcrash_async_macho_find_segment_cmd().
+ */
+static uint32_t macho_segment_index (plcrash_async_macho_t *image, void *segment) {
+    const plcrash_async_macho_command_index_t *index = &image->cmd_index;
+    uintptr_t offset = (uintptr_t) segment - image->load_cmds.address;
+
+    for (uint32_t i = 0; i < index->seg_count; i++) {
+        if (index->seg_offsets[i] == offset)
+            return i;
+    }
+
+    return UINT32_MAX;
+}
+
+/**
+ * Find and map a named segment, as per plcrash_async_macho_map_segment(), returning a view of an existing mapping
+ * from @a pool if the segment has previously been mapped via @a pool.
+ *
+ * @param pool The mapping pool, or NULL.
+ * @param image The image to search for @a segname.
+ * @param segname The name of the segment to be mapped.
+ * @param seg The segment data to be initialized. It is the caller's responsibility to dealloc @a seg after
+ * a successful initialization.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or an error result on failure.
+ */
+plcrash_error_t plcrash_async_macho_pool_map_segment (plcrash_async_mobject_pool_t *pool, plcrash_async_macho_t *image, const char *segname, pl_async_macho_mapped_segment_t *seg) {
     struct segment_command *cmd_32;
     struct segment_command_64 *cmd_64;
     
@@ -461,22 +725,41 @@ plcrash_error_t plcrash_async_macho_map_segment (plcrash_async_macho_t *image, c
     /* Calculate the in-memory address and size */
     pl_vm_address_t segaddr;
     pl_vm_size_t segsize;
-    if (image->m64) {
-        segaddr = image->byteorder->swap64(cmd_64->vmaddr) + image->vmaddr_slide;
-        segsize = image->byteorder->swap64(cmd_64->vmsize);
+    if (plcrash_async_macho_m64(image)) {
+        segaddr = plcrash_async_swap64(image->byteorder, cmd_64->vmaddr) + image->vmaddr_slide;
+        segsize = plcrash_async_swap64(image->byteorder, cmd_64->vmsize);
 
-        seg->fileoff = image->byteorder->swap64(cmd_64->fileoff);
-        seg->filesize = image->byteorder->swap64(cmd_64->filesize);
+        seg->fileoff = plcrash_async_swap64(image->byteorder, cmd_64->fileoff);
+        seg->filesize = plcrash_async_swap64(image->byteorder, cmd_64->filesize);
     } else {
-        segaddr = image->byteorder->swap32(cmd_32->vmaddr) + image->vmaddr_slide;
-        segsize = image->byteorder->swap32(cmd_32->vmsize);
+        segaddr = plcrash_async_swap32(image->byteorder, cmd_32->vmaddr) + image->vmaddr_slide;
+        segsize = plcrash_async_swap32(image->byteorder, cmd_32->vmsize);
         
-        seg->fileoff = image->byteorder->swap32(cmd_32->fileoff);
-        seg->filesize = image->byteorder->swap32(cmd_32->filesize);
+        seg->fileoff = plcrash_async_swap32(image->byteorder, cmd_32->fileoff);
+        seg->filesize = plcrash_async_swap32(image->byteorder, cmd_32->filesize);
+    }
+
+    /* If the segment's mappable extent has already been determined, map exactly that extent. The extent is recorded
+     * per segment, and is read once; a concurrent writer can only have stored the same value. */
+    uint32_t seg_index = macho_segment_index(image, segment);
+    if (seg_index != UINT32_MAX) {
+        vm_size_t mapped_size = image->cmd_index.seg_mapped_sizes[seg_index];
+        if (mapped_size != 0 && mapped_size <= segsize) {
+            if (plcrash_async_mobject_pool_map(pool, &seg->mobj, image->task, segaddr, mapped_size, true) == PLCRASH_ESUCCESS)
+                return PLCRASH_ESUCCESS;
+        }
     }
 
     /* Perform and return the mapping (permitting shorter mappings, as documented above). */
-    return plcrash_async_mobject_init(&seg->mobj, image->task, segaddr, segsize, false);
+    plcrash_error_t err = plcrash_async_mobject_pool_map(pool, &seg->mobj, image->task, segaddr, segsize, false);
+    if (err != PLCRASH_ESUCCESS)
+        return err;
+
+    /* Record the mappable extent for future mappings of this segment */
+    if (seg_index != UINT32_MAX)
+        image->cmd_index.seg_mapped_sizes[seg_index] = (vm_size_t) seg->mobj.length;
+
+    return PLCRASH_ESUCCESS;
 }
 
 /**
@@ -493,6 +776,22 @@ plcrash_error_t plcrash_async_macho_map_segment (plcrash_async_macho_t *image, c
  * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if the section is not found, or an error result on failure.
  */
 plcrash_error_t plcrash_async_macho_map_section (plcrash_async_macho_t *image, const char *segname, const char *sectname, plcrash_async_mobject_t *mobj) {
+    return plcrash_async_macho_pool_map_section(NULL, image, segname, sectname, mobj);
+}
+
+/**
+ * @internal
+ * Find a named section within a named segment, returning the section's in-memory address and size.
+ *
+ * @param image The image to search for @a segname.
+ * @param segname The name of the segment to search.
+ * @param sectname The name of the section to find.
+ * @param[out] addr On success, the section's in-memory address.
+ * @param[out] size On success, the section's size.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if the section is not found, or an error result on failure.
+ */
+static plcrash_error_t macho_find_section (plcrash_async_macho_t *image, const char *segname, const char *sectname, pl_vm_address_t *addr, pl_vm_size_t *size) {
     struct segment_command *cmd_32;
     struct segment_command_64 *cmd_64;
     
@@ -506,11 +805,11 @@ plcrash_error_t plcrash_async_macho_map_section (plcrash_async_macho_t *image, c
     uint32_t nsects;
     uintptr_t cursor = (uintptr_t) segment;
 
-    if (image->m64) {
-        nsects = image->byteorder->swap32(cmd_64->nsects);
+    if (plcrash_async_macho_m64(image)) {
+        nsects = plcrash_async_swap32(image->byteorder, cmd_64->nsects);
         cursor += sizeof(*cmd_64);
     } else {
-        nsects = image->byteorder->swap32(cmd_32->nsects);
+        nsects = plcrash_async_swap32(image->byteorder, cmd_32->nsects);
         cursor += sizeof(*cmd_32);
     }
 
@@ -518,7 +817,7 @@ plcrash_error_t plcrash_async_macho_map_section (plcrash_async_macho_t *image, c
         struct section *sect_32 = NULL;
         struct section_64 *sect_64 = NULL;
        
-        if (image->m64) {
+        if (plcrash_async_macho_m64(image)) {
             if (!plcrash_async_mobject_verify_local_pointer(&image->load_cmds, cursor, 0, sizeof(*sect_64))) {
                 PLCF_DEBUG("Section table entry outside of expected range; searching for (%s,%s)", segname, sectname);
                 return PLCRASH_EINVAL;
@@ -536,28 +835,191 @@ plcrash_error_t plcrash_async_macho_map_section (plcrash_async_macho_t *image, c
             cursor += sizeof(*sect_32);
         }
         
-        const char *image_sectname = image->m64 ? sect_64->sectname : sect_32->sectname;
+        const char *image_sectname = plcrash_async_macho_m64(image) ? sect_64->sectname : sect_32->sectname;
         if (plcrash_async_strncmp(sectname, image_sectname, sizeof(sect_64->sectname)) == 0) {
             /* Calculate the in-memory address and size */
-            pl_vm_address_t sectaddr;
-            pl_vm_size_t sectsize;
-            if (image->m64) {
-                sectaddr = image->byteorder->swap64(sect_64->addr) + image->vmaddr_slide;
-                sectsize = image->byteorder->swap64(sect_64->size);
+            if (plcrash_async_macho_m64(image)) {
+                *addr = plcrash_async_swap64(image->byteorder, sect_64->addr) + image->vmaddr_slide;
+                *size = plcrash_async_swap64(image->byteorder, sect_64->size);
             } else {
-                sectaddr = image->byteorder->swap32(sect_32->addr) + image->vmaddr_slide;
-                sectsize = image->byteorder->swap32(sect_32->size);
+                *addr = plcrash_async_swap32(image->byteorder, sect_32->addr) + image->vmaddr_slide;
+                *size = plcrash_async_swap32(image->byteorder, sect_32->size);
             }
-            
-            
-            /* Perform and return the mapping */
-            return plcrash_async_mobject_init(mobj, image->task, sectaddr, sectsize, true);
+
+            return PLCRASH_ESUCCESS;
         }
     }
     
     return PLCRASH_ENOTFOUND;
 }
 
+/**
+ * Find and map a named section within a named segment, as per plcrash_async_macho_map_section(), returning a view of
+ * an existing mapping from @a pool if the section's data has previously been mapped via @a pool.
+ *
+ * @param pool The mapping pool, or NULL.
+ * @param image The image to search for @a segname.
+ * @param segname The name of the segment to search.
+ * @param sectname The name of the section to map.
+ * @param mobj The mobject to be initialized with a mapping of the section's data. It is the caller's responsibility to dealloc @a mobj after
+ * a successful initialization.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if the section is not found, or an error result on failure.
+ */
+plcrash_error_t plcrash_async_macho_pool_map_section (plcrash_async_mobject_pool_t *pool, plcrash_async_macho_t *image, const char *segname, const char *sectname, plcrash_async_mobject_t *mobj) {
+    pl_vm_address_t sectaddr;
+    pl_vm_size_t sectsize;
+    plcrash_error_t err;
+
+    if ((err = macho_find_section(image, segname, sectname, &sectaddr, &sectsize)) != PLCRASH_ESUCCESS)
+        return err;
+
+    /* Perform and return the mapping */
+    return plcrash_async_mobject_pool_map(pool, mobj, image->task, sectaddr, sectsize, true);
+}
+
+/**
+ * Initialize a new section cache.
+ *
+ * @param cache The cache to initialize. The cache must be released via plcrash_async_macho_section_cache_free().
+ */
+void plcrash_async_macho_section_cache_init (plcrash_async_macho_section_cache_t *cache) {
+    cache->entries = NULL;
+    cache->count = 0;
+}
+
+/* Return the size of the section cache's entry allocation */
+static size_t section_cache_allocation_size (void) {
+    return round_page(sizeof(plcrash_async_macho_section_cache_entry_t) * PLCRASH_ASYNC_MACHO_SECTION_CACHE_SIZE);
+}
+
+/* Copy a segment or section name, truncating to the 16 byte Mach-O name length */
+static void section_cache_copy_name (char dest[16], const char *src) {
+    size_t i;
+    for (i = 0; i < 16 && src[i] != '\0'; i++)
+        dest[i] = src[i];
+
+    for (; i < 16; i++)
+        dest[i] = '\0';
+}
+
+/**
+ * Find and map a named section within a named segment, returning a cached mapping if the section has previously
+ * been mapped via @a cache. The returned mapping must be released via plcrash_async_macho_section_cache_unmap().
+ *
+ * @param cache The section cache, or NULL. If NULL, or if the cache is full, the section will be mapped into
+ * @a storage without caching.
+ * @param image The image to search for @a segname.
+ * @param segname The name of the segment to search.
+ * @param sectname The name of the section to map.
+ * @param storage Caller-provided storage to be used if the mapping can not be cached.
+ * @param mobj On success, will be set to a mapping of the section's data; this will be either a cache entry,
+ * or @a storage.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if the section is not found, or an error result on failure.
+ */
+plcrash_error_t plcrash_async_macho_section_cache_map (plcrash_async_macho_section_cache_t *cache,
+                                                       plcrash_async_macho_t *image,
+                                                       const char *segname,
+                                                       const char *sectname,
+                                                       plcrash_async_mobject_t *storage,
+                                                       plcrash_async_mobject_t **mobj)
+{
+    plcrash_error_t err;
+
+    if (cache == NULL)
+        goto uncached;
+
+    /* Check for an existing entry */
+    for (uint32_t i = 0; i < cache->count; i++) {
+        plcrash_async_macho_section_cache_entry_t *entry = &cache->entries[i];
+        if (entry->header_addr != image->header_addr)
+            continue;
+
+        if (plcrash_async_strncmp(entry->segname, segname, sizeof(entry->segname)) != 0 ||
+            plcrash_async_strncmp(entry->sectname, sectname, sizeof(entry->sectname)) != 0)
+        {
+            continue;
+        }
+
+        if (entry->result == PLCRASH_ESUCCESS)
+            *mobj = &entry->mobj;
+
+        return entry->result;
+    }
+
+    /* Lazily allocate the entries */
+    if (cache->entries == NULL) {
+        vm_address_t addr;
+        kern_return_t kt = plcrash_async_scratch_allocate(&addr, section_cache_allocation_size());
+        if (kt != KERN_SUCCESS) {
+            PLCF_DEBUG("plcrash_async_scratch_allocate failed with error %x, the section cache could not be initialized", kt);
+            goto uncached;
+        }
+
+        cache->entries = (plcrash_async_macho_section_cache_entry_t *) addr;
+    }
+
+    if (cache->count == PLCRASH_ASYNC_MACHO_SECTION_CACHE_SIZE)
+        goto uncached;
+
+    /* Map and record the section */
+    plcrash_async_macho_section_cache_entry_t *entry = &cache->entries[cache->count++];
+    entry->header_addr = image->header_addr;
+    section_cache_copy_name(entry->segname, segname);
+    section_cache_copy_name(entry->sectname, sectname);
+    entry->result = plcrash_async_macho_map_section(image, segname, sectname, &entry->mobj);
+
+    if (entry->result == PLCRASH_ESUCCESS)
+        *mobj = &entry->mobj;
+
+    return entry->result;
+
+uncached:
+    if ((err = plcrash_async_macho_map_section(image, segname, sectname, storage)) != PLCRASH_ESUCCESS)
+        return err;
+
+    *mobj = storage;
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Release a mapping returned by plcrash_async_macho_section_cache_map(). Cached mappings remain valid until
+ * the cache is freed.
+ *
+ * @param cache The section cache passed to plcrash_async_macho_section_cache_map(), or NULL.
+ * @param mobj The mapping to be released.
+ */
+void plcrash_async_macho_section_cache_unmap (plcrash_async_macho_section_cache_t *cache, plcrash_async_mobject_t *mobj) {
+    if (cache != NULL && cache->entries != NULL) {
+        uintptr_t start = (uintptr_t) cache->entries;
+        uintptr_t end = (uintptr_t) (cache->entries + cache->count);
+        if ((uintptr_t) mobj >= start && (uintptr_t) mobj < end)
+            return;
+    }
+
+    plcrash_async_mobject_free(mobj);
+}
+
+/**
+ * Free all mappings held by @a cache, and release the cache's resources.
+ *
+ * @param cache The cache to be freed.
+ */
+void plcrash_async_macho_section_cache_free (plcrash_async_macho_section_cache_t *cache) {
+    if (cache->entries == NULL)
+        return;
+
+    for (uint32_t i = 0; i < cache->count; i++) {
+        if (cache->entries[i].result == PLCRASH_ESUCCESS)
+            plcrash_async_mobject_free(&cache->entries[i].mobj);
+    }
+
+    plcrash_async_scratch_deallocate((vm_address_t) cache->entries, section_cache_allocation_size());
+    cache->entries = NULL;
+    cache->count = 0;
+}
+
 /**
  * @internal
  * Common wrapper of nlist/nlist_64. We verify that this union is valid for our purposes in pl_async_macho_find_symtab_symbol().
@@ -587,7 +1049,7 @@ plcrash_error_t plcrash_async_macho_find_symbol_by_name (plcrash_async_macho_t *
     plcrash_error_t ret;
 
     /* Initialize the reader */
-    ret = plcrash_async_macho_symtab_reader_init(&reader, image);
+    ret = plcrash_async_macho_symtab_reader_init(&reader, image, NULL);
     if (ret != PLCRASH_ESUCCESS)
         return ret;
 
@@ -620,11 +1082,12 @@ plcrash_error_t plcrash_async_macho_find_symbol_by_name (plcrash_async_macho_t *
  *
  * @param reader The reader to be initialized.
  * @param image The image from which the symbol table will be mapped.
+ * @param pool A mapping pool from which the LINKEDIT segment will be mapped, or NULL.
  *
  * @return On success, returns PLCRASH_ESUCCESS. On failure, one of the plcrash_error_t error values will be returned, and no
  * mapping will be performed.
  */
-plcrash_error_t plcrash_async_macho_symtab_reader_init (plcrash_async_macho_symtab_reader_t *reader, plcrash_async_macho_t *image) {
+plcrash_error_t plcrash_async_macho_symtab_reader_init (plcrash_async_macho_symtab_reader_t *reader, plcrash_async_macho_t *image, plcrash_async_mobject_pool_t *pool) {
     plcrash_error_t retval;
 
     /* Fetch the symtab commands, if available. */
@@ -638,35 +1101,35 @@ plcrash_error_t plcrash_async_macho_symtab_reader_init (plcrash_async_macho_symt
     }
     
     /* Map in the __LINKEDIT segment, which includes the symbol and string tables */
-    plcrash_error_t err = plcrash_async_macho_map_segment(image, "__LINKEDIT", &reader->linkedit);
+    plcrash_error_t err = plcrash_async_macho_pool_map_segment(pool, image, "__LINKEDIT", &reader->linkedit);
     if (err != PLCRASH_ESUCCESS) {
         PLCF_DEBUG("plcrash_async_mobject_init() failure: %d in %s", err, image->name);
         return PLCRASH_EINTERNAL;
     }
     
     /* Determine the string and symbol table sizes. */
-    uint32_t nsyms = image->byteorder->swap32(symtab_cmd->nsyms);
-    size_t nlist_struct_size = image->m64 ? sizeof(struct nlist_64) : sizeof(struct nlist);
+    uint32_t nsyms = plcrash_async_swap32(image->byteorder, symtab_cmd->nsyms);
+    size_t nlist_struct_size = plcrash_async_macho_m64(image) ? sizeof(struct nlist_64) : sizeof(struct nlist);
     size_t nlist_table_size = nsyms * nlist_struct_size;
     
-    size_t string_size = image->byteorder->swap32(symtab_cmd->strsize);
+    size_t string_size = plcrash_async_swap32(image->byteorder, symtab_cmd->strsize);
     
     /* Fetch pointers to the symbol and string tables, and verify their size values */
     void *nlist_table;
     char *string_table;
     
-    nlist_table = plcrash_async_mobject_remap_address(&reader->linkedit.mobj, reader->linkedit.mobj.task_address, (image->byteorder->swap32(symtab_cmd->symoff) - reader->linkedit.fileoff), nlist_table_size);
+    nlist_table = plcrash_async_mobject_remap_address(&reader->linkedit.mobj, reader->linkedit.mobj.task_address, (plcrash_async_swap32(image->byteorder, symtab_cmd->symoff) - reader->linkedit.fileoff), nlist_table_size);
     if (nlist_table == NULL) {
         PLCF_DEBUG("plcrash_async_mobject_remap_address(mobj, %" PRIx64 ", %" PRIx64") returned NULL mapping __LINKEDIT.symoff in %s",
-                   (uint64_t) reader->linkedit.mobj.address + image->byteorder->swap32(symtab_cmd->symoff), (uint64_t) nlist_table_size, image->name);
+                   (uint64_t) reader->linkedit.mobj.address + plcrash_async_swap32(image->byteorder, symtab_cmd->symoff), (uint64_t) nlist_table_size, image->name);
         retval = PLCRASH_EINTERNAL;
         goto cleanup;
     }
     
-    string_table = plcrash_async_mobject_remap_address(&reader->linkedit.mobj, reader->linkedit.mobj.task_address, (image->byteorder->swap32(symtab_cmd->stroff) - reader->linkedit.fileoff), string_size);
+    string_table = plcrash_async_mobject_remap_address(&reader->linkedit.mobj, reader->linkedit.mobj.task_address, (plcrash_async_swap32(image->byteorder, symtab_cmd->stroff) - reader->linkedit.fileoff), string_size);
     if (string_table == NULL) {
         PLCF_DEBUG("plcrash_async_mobject_remap_address(mobj, %" PRIx64 ", %" PRIx64") returned NULL mapping __LINKEDIT.stroff in %s",
-                   (uint64_t) reader->linkedit.mobj.address + image->byteorder->swap32(symtab_cmd->stroff), (uint64_t) string_size, image->name);
+                   (uint64_t) reader->linkedit.mobj.address + plcrash_async_swap32(image->byteorder, symtab_cmd->stroff), (uint64_t) string_size, image->name);
         retval = PLCRASH_EINTERNAL;
         goto cleanup;
     }
@@ -682,11 +1145,11 @@ plcrash_error_t plcrash_async_macho_symtab_reader_init (plcrash_async_macho_symt
     if (dysymtab_cmd != NULL) {
         /* dysymtab is available; use it to constrain our symbol search to the global and local sections of the symbol table. */
         
-        uint32_t idx_syms_global = image->byteorder->swap32(dysymtab_cmd->iextdefsym);
-        uint32_t idx_syms_local = image->byteorder->swap32(dysymtab_cmd->ilocalsym);
+        uint32_t idx_syms_global = plcrash_async_swap32(image->byteorder, dysymtab_cmd->iextdefsym);
+        uint32_t idx_syms_local = plcrash_async_swap32(image->byteorder, dysymtab_cmd->ilocalsym);
         
-        uint32_t nsyms_global = image->byteorder->swap32(dysymtab_cmd->nextdefsym);
-        uint32_t nsyms_local = image->byteorder->swap32(dysymtab_cmd->nlocalsym);
+        uint32_t nsyms_global = plcrash_async_swap32(image->byteorder, dysymtab_cmd->nextdefsym);
+        uint32_t nsyms_local = plcrash_async_swap32(image->byteorder, dysymtab_cmd->nlocalsym);
         
         /* Sanity check the symbol offsets to ensure they're within our known-valid ranges */
         if (idx_syms_global + nsyms_global > nsyms || idx_syms_local + nsyms_local > nsyms) {
@@ -699,7 +1162,7 @@ plcrash_error_t plcrash_async_macho_symtab_reader_init (plcrash_async_macho_symt
         reader->nsyms_global = nsyms_global;
         reader->nsyms_local = nsyms_local;
 
-        if (image->m64) {
+        if (plcrash_async_macho_m64(image)) {
             struct nlist_64 *n64 = nlist_table;
             reader->symtab_global = (pl_nlist_common *) (n64 + idx_syms_global);
             reader->symtab_local = (pl_nlist_common *) (n64 + idx_syms_local);
@@ -748,21 +1211,21 @@ plcrash_async_macho_symtab_entry_t plcrash_async_macho_symtab_reader_read (plcra
 #undef pl_m_sizeof
     }
 
-#define pl_sym_value(image, nl) (image->m64 ? image->byteorder->swap64((nl)->n64.n_value) : image->byteorder->swap32((nl)->n32.n_value))
+#define pl_sym_value(image, nl) (plcrash_async_macho_m64(image) ? plcrash_async_swap64(image->byteorder, (nl)->n64.n_value) : plcrash_async_swap32(image->byteorder, (nl)->n32.n_value))
 
     /* Perform 32-bit/64-bit dependent aliased pointer math. */
     pl_nlist_common *symbol;
-    if (reader->image->m64) {
+    if (plcrash_async_macho_m64(reader->image)) {
         symbol = (pl_nlist_common *) &(((struct nlist_64 *) symtab)[index]);
     } else {
         symbol = (pl_nlist_common *) &(((struct nlist *) symtab)[index]);
     }
     
     plcrash_async_macho_symtab_entry_t entry = {
-        .n_strx = byteorder->swap32(symbol->n32.n_un.n_strx),
+        .n_strx = plcrash_async_swap32(byteorder, symbol->n32.n_un.n_strx),
         .n_type = symbol->n32.n_type,
         .n_sect = symbol->n32.n_sect,
-        .n_desc = byteorder->swap16(symbol->n32.n_desc),
+        .n_desc = plcrash_async_swap16(byteorder, symbol->n32.n_desc),
         .n_value = pl_sym_value(reader->image, symbol)
     };
     
@@ -865,63 +1328,752 @@ static void plcrash_async_macho_find_best_symbol (plcrash_async_macho_symtab_rea
     }
 }
 
-/**
- * Attempt to locate a symbol address and name for @a pc within @a image. This is performed using best-guess heuristics, and may
- * be incorrect.
- *
- * @param image The Mach-O image to search for @a pc
- * @param pc The PC value within the target process for which symbol information should be found.
- * @param symbol_cb A callback to be called if the symbol is found.
- * @param context Context to be passed to @a found_symbol.
+/*
+ * Locate the closest symbol occuring at or before @a slide_pc using the image's sorted symbol index.
  *
- * @return Returns PLCRASH_ESUCCESS if the symbol is found. If the symbol is not found, @a found_symbol will not be called.
+ * @param reader The Mach-O symbol table reader from which the found entry will be read.
+ * @param slide_pc The PC value within the target process for which symbol information should be found. The VM slide
+ * address should have already been applied to this value.
+ * @param found_symbol On success, will be set to the discovered symbol value.
  *
- * @todo Migrate this API to use the new non-callback based plcrash_async_macho_symtab_reader support for symbol (and symbol name)
- * reading.
+ * @return Returns true if a symbol was found, false otherwise.
  */
-plcrash_error_t plcrash_async_macho_find_symbol_by_pc (plcrash_async_macho_t *image, pl_vm_address_t pc, pl_async_macho_found_symbol_cb symbol_cb, void *context) {
-    plcrash_error_t retval;
-    
-    /* Initialize a symbol table reader */
-    plcrash_async_macho_symtab_reader_t reader;
-    retval = plcrash_async_macho_symtab_reader_init(&reader, image);
-    if (retval != PLCRASH_ESUCCESS)
-        return retval;
-
-    /* Compute the on-disk PC. */
-    pl_vm_address_t slide_pc = pc - image->vmaddr_slide;
-
-    /* Walk the symbol table. */
-    plcrash_async_macho_symtab_entry_t found_symbol;
-    bool did_find_symbol;
-
-    if (reader.symtab_global != NULL && reader.symtab_local != NULL) {
-        /* dysymtab is available; use it to constrain our symbol search to the global and local sections of the symbol table. */
-        plcrash_async_macho_find_best_symbol(&reader, slide_pc, reader.symtab_global, reader.nsyms_global, &found_symbol, NULL, &did_find_symbol);
-        plcrash_async_macho_find_best_symbol(&reader, slide_pc, reader.symtab_local, reader.nsyms_local, &found_symbol, &found_symbol, &did_find_symbol);
-    } else {
-        /* If dysymtab is not available, search all symbols */
-        plcrash_async_macho_find_best_symbol(&reader, slide_pc, reader.symtab, reader.nsyms, &found_symbol, NULL, &did_find_symbol);
+static bool plcrash_async_macho_find_indexed_symbol (plcrash_async_macho_symtab_reader_t *reader,
+                                                     pl_vm_address_t slide_pc,
+                                                     plcrash_async_macho_symtab_entry_t *found_symbol)
+{
+    /* The index pointer is published atomically; read it exactly once. */
+    const plcrash_async_macho_symbol_index_t *idx = reader->image->symbol_index;
+    if (idx == NULL)
+        return false;
+
+    const plcrash_async_macho_symbol_index_entry_t *index = idx->entries;
+    uint32_t lower = 0;
+    uint32_t upper = idx->count;
+
+    /* Find the first entry with an address greater than slide_pc */
+    while (lower < upper) {
+        uint32_t mid = lower + (upper - lower) / 2;
+        if (index[mid].n_value <= slide_pc)
+            lower = mid + 1;
+        else
+            upper = mid;
     }
 
-    /* No symbol found. */
-    if (!did_find_symbol) {
-        retval = PLCRASH_ENOTFOUND;
-        goto cleanup;
-    }
+    /* No symbol precedes slide_pc */
+    if (lower == 0)
+        return false;
 
-    /* Symbol found! */
-    const char *sym_name = plcrash_async_macho_symtab_reader_symbol_name(&reader, found_symbol.n_strx);
-    if (sym_name == NULL) {
-        PLCF_DEBUG("Failed to read symbol name\n");
-        retval = PLCRASH_EINVAL;
-        goto cleanup;
+    /* The index was validated against the symbol table when built. */
+    uint32_t symtab_index = index[lower - 1].symtab_index;
+    if (symtab_index >= reader->nsyms) {
+        PLCF_DEBUG("Symbol index entry %" PRIu32 " out of range nsyms=%" PRIu32, symtab_index, reader->nsyms);
+        return false;
     }
 
-    /* Inform our caller */
-    symbol_cb(found_symbol.normalized_value + image->vmaddr_slide, sym_name, context);
+    *found_symbol = plcrash_async_macho_symtab_reader_read(reader, reader->symtab, symtab_index);
+    return true;
+}
 
-    // fall through to cleanup
+/* Append all indexable symbols in @a symtab to @a index, returning the new entry count. */
+static uint32_t plcrash_async_macho_index_symbols (plcrash_async_macho_symtab_reader_t *reader,
+                                                   void *symtab, uint32_t nsyms,
+                                                   plcrash_async_macho_symbol_index_entry_t *index, uint32_t count)
+{
+    size_t nlist_struct_size = plcrash_async_macho_m64(reader->image) ? sizeof(struct nlist_64) : sizeof(struct nlist);
+    uint32_t base = (uint32_t) (((uintptr_t) symtab - (uintptr_t) reader->symtab) / nlist_struct_size);
+
+    for (uint32_t i = 0; i < nsyms; i++) {
+        plcrash_async_macho_symtab_entry_t entry = plcrash_async_macho_symtab_reader_read(reader, symtab, i);
+
+        /* Symbol must be within a section, and must not be a debugging entry. */
+        if ((entry.n_type & N_TYPE) != N_SECT || ((entry.n_type & N_STAB) != 0))
+            continue;
+
+        index[count].n_value = entry.n_value;
+        index[count].symtab_index = base + i;
+        count++;
+    }
+
+    return count;
+}
+
+/* Symbol index sort comparator */
+static int plcrash_async_macho_symbol_index_compare (const void *a, const void *b) {
+    const plcrash_async_macho_symbol_index_entry_t *lhs = a;
+    const plcrash_async_macho_symbol_index_entry_t *rhs = b;
+
+    if (lhs->n_value < rhs->n_value)
+        return -1;
+    else if (lhs->n_value > rhs->n_value)
+        return 1;
+    return 0;
+}
+
+/**
+ * Build an address-sorted index of @a image's symbols, allowing plcrash_async_macho_find_symbol_by_pc() to perform
+ * a binary search rather than a linear scan of the symbol table. The index contains the same symbols considered by the
+ * linear scan, and produces identical results.
+ *
+ * The completed index is published via an atomic pointer swap, and this function may be called from a background
+ * thread while @a image is in use by async-safe readers; readers will observe either no index, or a complete index.
+ * Once built, the index is released by plcrash_nasync_macho_free(). If an index has already been built, this
+ * function does nothing.
+ *
+ * @param image The image for which a symbol index will be built.
+ * @param max_bytes The maximum number of bytes that may be allocated for the index, or 0 for no limit. If the
+ * worst-case index size exceeds this limit, no index will be built.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOMEM if the index would exceed @a max_bytes or could not be
+ * allocated, or an appropriate error value if the symbol table could not be read. On failure, symbol lookups will
+ * continue to scan the symbol table.
+ *
+ * @warning This method is not async safe, and must not be called concurrently with plcrash_nasync_macho_free().
+ */
+plcrash_error_t plcrash_nasync_macho_build_symbol_index (plcrash_async_macho_t *image, size_t max_bytes) {
+    plcrash_async_macho_symtab_reader_t reader;
+    plcrash_error_t ret;
+
+    if (image->symbol_index != NULL)
+        return PLCRASH_ESUCCESS;
+
+    if ((ret = plcrash_async_macho_symtab_reader_init(&reader, image, NULL)) != PLCRASH_ESUCCESS)
+        return ret;
+
+    /* Size for the worst case; the allocation is trimmed below. */
+    uint32_t capacity = (reader.symtab_global != NULL && reader.symtab_local != NULL) ? reader.nsyms_global + reader.nsyms_local : reader.nsyms;
+    size_t alloc_size = sizeof(plcrash_async_macho_symbol_index_t) + sizeof(plcrash_async_macho_symbol_index_entry_t) * capacity;
+    if (max_bytes != 0 && alloc_size > max_bytes) {
+        PLCF_DEBUG("Symbol index for %s requires %zu bytes, exceeding the limit of %zu bytes", image->name, alloc_size, max_bytes);
+        plcrash_async_macho_symtab_reader_free(&reader);
+        return PLCRASH_ENOMEM;
+    }
+
+    plcrash_async_macho_symbol_index_t *idx = malloc(alloc_size);
+    if (idx == NULL) {
+        plcrash_async_macho_symtab_reader_free(&reader);
+        return PLCRASH_ENOMEM;
+    }
+    plcrash_async_macho_symbol_index_entry_t *index = idx->entries;
+
+    /* Collect the symbols in the same order as the linear scan performed by plcrash_async_macho_find_symbol_by_pc() */
+    uint32_t count = 0;
+    if (reader.symtab_global != NULL && reader.symtab_local != NULL) {
+        count = plcrash_async_macho_index_symbols(&reader, reader.symtab_global, reader.nsyms_global, index, count);
+        count = plcrash_async_macho_index_symbols(&reader, reader.symtab_local, reader.nsyms_local, index, count);
+    } else {
+        count = plcrash_async_macho_index_symbols(&reader, reader.symtab, reader.nsyms, index, count);
+    }
+    plcrash_async_macho_symtab_reader_free(&reader);
+
+    /*
+     * Sort by address. A stable sort is used, and only the first of each run of equal addresses is retained; this
+     * matches the linear scan, which selects the first symbol found at the closest address.
+     */
+    if (count > 1 && mergesort(index, count, sizeof(*index), plcrash_async_macho_symbol_index_compare) != 0) {
+        PLCF_DEBUG("Failed to sort symbol index for %s: %s", image->name, strerror(errno));
+        free(idx);
+        return PLCRASH_ENOMEM;
+    }
+
+    uint32_t unique = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (unique > 0 && index[unique - 1].n_value == index[i].n_value)
+            continue;
+        index[unique++] = index[i];
+    }
+    idx->count = unique;
+
+    if (unique < capacity) {
+        plcrash_async_macho_symbol_index_t *trimmed = realloc(idx, sizeof(*idx) + sizeof(*index) * unique);
+        if (trimmed != NULL)
+            idx = trimmed;
+    }
+
+    /* Publish the index. The barrier ensures the entries are visible before the pointer; if another thread
+     * published an index first, ours is discarded. */
+    if (!OSAtomicCompareAndSwapPtrBarrier(NULL, idx, (void * volatile *) &image->symbol_index))
+        free(idx);
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Return the number of bytes allocated for @a image's symbol index, or 0 if no index has been built.
+ *
+ * @param image The image to query.
+ */
+size_t plcrash_async_macho_symbol_index_size (plcrash_async_macho_t *image) {
+    const plcrash_async_macho_symbol_index_t *idx = image->symbol_index;
+    if (idx == NULL)
+        return 0;
+
+    return sizeof(*idx) + sizeof(idx->entries[0]) * idx->count;
+}
+
+static uint32_t plcrash_async_macho_symtab_count (plcrash_async_macho_t *image);
+
+/**
+ * Return an upper bound on the number of symbol table entries examined by a single plcrash_async_macho_find_symbol_by_pc()
+ * look-up within @a image: the binary search depth if a symbol index is available, or the entry count of the symbol
+ * table otherwise. Used for symbolication diagnostics.
+ *
+ * @param image The image to query.
+ */
+uint32_t plcrash_async_macho_symbol_scan_count (plcrash_async_macho_t *image) {
+    const plcrash_async_macho_symbol_index_t *idx = image->symbol_index;
+    if (idx == NULL)
+        return plcrash_async_macho_symtab_count(image);
+
+    uint32_t depth = 0;
+    for (uint32_t n = idx->count; n != 0; n >>= 1)
+        depth++;
+
+    return depth;
+}
+
+/** Magic number of a persisted symbol index file ('PLSI'). */
+#define PLCRASH_MACHO_SYMBOL_INDEX_FILE_MAGIC 0x504c5349
+
+/** Version of the persisted symbol index file format. */
+#define PLCRASH_MACHO_SYMBOL_INDEX_FILE_VERSION 1
+
+/**
+ * @internal
+ *
+ * Header of a persisted symbol index file. The header is immediately followed by a plcrash_async_macho_symbol_index_t,
+ * allowing the index to be used directly from a read-only mapping of the file. Index entries hold on-disk symbol
+ * addresses, and are independent of the image's slide.
+ */
+struct plcrash_async_macho_symbol_index_file {
+    /** PLCRASH_MACHO_SYMBOL_INDEX_FILE_MAGIC */
+    uint32_t magic;
+
+    /** PLCRASH_MACHO_SYMBOL_INDEX_FILE_VERSION */
+    uint32_t version;
+
+    /** The LC_UUID of the indexed image. */
+    uint8_t uuid[16];
+
+    /** The number of entries in the indexed image's symbol table. */
+    uint32_t nsyms;
+
+    /** The size of a single index entry, in bytes; guards against reading an index written by a different architecture. */
+    uint32_t entry_size;
+};
+
+/**
+ * Fetch the LC_UUID of @a image.
+ *
+ * @param image The image to query.
+ * @param uuid On success, will be populated with the image's UUID.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_ENOTFOUND if the image has no LC_UUID load command.
+ */
+plcrash_error_t plcrash_async_macho_uuid (plcrash_async_macho_t *image, uint8_t uuid[16]) {
+    struct uuid_command *cmd = plcrash_async_macho_find_command(image, LC_UUID);
+    if (cmd == NULL)
+        return PLCRASH_ENOTFOUND;
+
+    if (plcrash_async_swap32(image->byteorder, cmd->cmdsize) < sizeof(*cmd))
+        return PLCRASH_EINVALID_DATA;
+
+    plcrash_async_memcpy(uuid, cmd->uuid, sizeof(cmd->uuid));
+    return PLCRASH_ESUCCESS;
+}
+
+/* Return the symbol count declared by @a image's LC_SYMTAB command, or 0 if unavailable. */
+static uint32_t plcrash_async_macho_symtab_count (plcrash_async_macho_t *image) {
+    struct symtab_command *cmd = plcrash_async_macho_find_command(image, LC_SYMTAB);
+    if (cmd == NULL || plcrash_async_swap32(image->byteorder, cmd->cmdsize) < sizeof(*cmd))
+        return 0;
+
+    return plcrash_async_swap32(image->byteorder, cmd->nsyms);
+}
+
+/**
+ * Load a symbol index previously written by plcrash_nasync_macho_write_symbol_index() from @a path. The file is
+ * mapped read-only, and the index is used directly from the mapping. The file's modification time is updated on
+ * each successful load, allowing unused index files to be pruned in least-recently-used order.
+ *
+ * As with plcrash_nasync_macho_build_symbol_index(), the index is published atomically. If an index has already
+ * been built, this function does nothing.
+ *
+ * @param image The image for which a symbol index will be loaded.
+ * @param path The path of the index file.
+ * @param max_bytes The maximum size of the mapped index, or 0 for no limit. Mapped indexes are counted against the
+ * same limit as built indexes.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if the file does not exist, PLCRASH_EINVALID_DATA if
+ * the file does not describe @a image, PLCRASH_ENOMEM if the index would exceed @a max_bytes, or another appropriate
+ * error.
+ *
+ * @warning This method is not async safe, and must not be called concurrently with plcrash_nasync_macho_free().
+ */
+plcrash_error_t plcrash_nasync_macho_load_symbol_index (plcrash_async_macho_t *image, const char *path, size_t max_bytes) {
+    struct plcrash_async_macho_symbol_index_file *header;
+    uint8_t uuid[16];
+    plcrash_error_t err;
+    struct stat sb;
+
+    if (image->symbol_index != NULL)
+        return PLCRASH_ESUCCESS;
+
+    if ((err = plcrash_async_macho_uuid(image, uuid)) != PLCRASH_ESUCCESS)
+        return err;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return (errno == ENOENT) ? PLCRASH_ENOTFOUND : PLCRASH_EACCESS;
+
+    if (fstat(fd, &sb) != 0 || sb.st_size < (off_t) (sizeof(*header) + sizeof(plcrash_async_macho_symbol_index_t))) {
+        close(fd);
+        return PLCRASH_EINVALID_DATA;
+    }
+
+    size_t length = (size_t) sb.st_size;
+    if (max_bytes != 0 && length > max_bytes) {
+        close(fd);
+        return PLCRASH_ENOMEM;
+    }
+
+    void *mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping != MAP_FAILED)
+        futimes(fd, NULL);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        PLCF_DEBUG("Failed to map symbol index %s: %s", path, strerror(errno));
+        return PLCRASH_ENOMEM;
+    }
+
+    /* Validate the header; the index must describe this exact image, and must fit within the file. Entries are
+     * additionally bounds-checked against the symbol table on each lookup. */
+    header = mapping;
+    plcrash_async_macho_symbol_index_t *idx = (plcrash_async_macho_symbol_index_t *) (header + 1);
+    size_t available = (length - sizeof(*header) - sizeof(*idx)) / sizeof(idx->entries[0]);
+
+    if (header->magic != PLCRASH_MACHO_SYMBOL_INDEX_FILE_MAGIC ||
+        header->version != PLCRASH_MACHO_SYMBOL_INDEX_FILE_VERSION ||
+        header->entry_size != sizeof(idx->entries[0]) ||
+        memcmp(header->uuid, uuid, sizeof(uuid)) != 0 ||
+        header->nsyms != plcrash_async_macho_symtab_count(image) ||
+        idx->count > available)
+    {
+        munmap(mapping, length);
+        return PLCRASH_EINVALID_DATA;
+    }
+
+    /* Publish the index */
+    if (!OSAtomicCompareAndSwapPtrBarrier(NULL, idx, (void * volatile *) &image->symbol_index)) {
+        munmap(mapping, length);
+        return PLCRASH_ESUCCESS;
+    }
+
+    image->symbol_index_mapping = mapping;
+    image->symbol_index_mapping_size = length;
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Write @a image's symbol index to @a path, in a format that may be loaded by plcrash_nasync_macho_load_symbol_index().
+ * The file is written to a temporary path and atomically renamed into place.
+ *
+ * @param image The image whose index will be written.
+ * @param path The destination path.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if no index has been built or the image has no UUID,
+ * or PLCRASH_OUTPUT_ERR if the file could not be written.
+ *
+ * @warning This method is not async safe.
+ */
+plcrash_error_t plcrash_nasync_macho_write_symbol_index (plcrash_async_macho_t *image, const char *path) {
+    const plcrash_async_macho_symbol_index_t *idx = image->symbol_index;
+    struct plcrash_async_macho_symbol_index_file header;
+    char tmp_path[PATH_MAX];
+    plcrash_error_t err;
+
+    if (idx == NULL)
+        return PLCRASH_ENOTFOUND;
+
+    plcrash_async_memset(&header, 0, sizeof(header));
+    if ((err = plcrash_async_macho_uuid(image, header.uuid)) != PLCRASH_ESUCCESS)
+        return err;
+
+    header.magic = PLCRASH_MACHO_SYMBOL_INDEX_FILE_MAGIC;
+    header.version = PLCRASH_MACHO_SYMBOL_INDEX_FILE_VERSION;
+    header.nsyms = plcrash_async_macho_symtab_count(image);
+    header.entry_size = sizeof(idx->entries[0]);
+
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.%d.tmp", path, getpid()) >= (int) sizeof(tmp_path))
+        return PLCRASH_EINVAL;
+
+    int fd = open(tmp_path, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+    if (fd < 0) {
+        PLCF_DEBUG("Failed to open symbol index %s: %s", tmp_path, strerror(errno));
+        return PLCRASH_OUTPUT_ERR;
+    }
+
+    size_t index_size = sizeof(*idx) + sizeof(idx->entries[0]) * idx->count;
+    bool written = plcrash_async_writen(fd, &header, sizeof(header)) == (ssize_t) sizeof(header) &&
+                   plcrash_async_writen(fd, idx, index_size) == (ssize_t) index_size;
+    if (close(fd) != 0)
+        written = false;
+
+    if (!written) {
+        PLCF_DEBUG("Failed to write symbol index %s: %s", tmp_path, strerror(errno));
+        unlink(tmp_path);
+        return PLCRASH_OUTPUT_ERR;
+    }
+
+    if (rename(tmp_path, path) != 0) {
+        PLCF_DEBUG("Failed to rename symbol index %s: %s", tmp_path, strerror(errno));
+        unlink(tmp_path);
+        return PLCRASH_OUTPUT_ERR;
+    }
+
+    return PLCRASH_ESUCCESS;
+}
+
+/*
+ * Read a ULEB128 value from @a *cursor, advancing @a *cursor past the encoded value. Returns false if the value is
+ * truncated by @a end, or does not fit within 64 bits.
+ */
+static bool plcrash_async_macho_read_uleb128 (const uint8_t **cursor, const uint8_t *end, uint64_t *result) {
+    uint64_t value = 0;
+    unsigned int shift = 0;
+
+    for (const uint8_t *p = *cursor; p < end; p++) {
+        if (shift >= 64)
+            return false;
+
+        value |= ((uint64_t) (*p & 0x7f)) << shift;
+        shift += 7;
+
+        if ((*p & 0x80) == 0) {
+            *cursor = p + 1;
+            *result = value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Locate @a image's LC_FUNCTION_STARTS table within the already mapped @a linkedit segment.
+ *
+ * @param image The image to search.
+ * @param linkedit The image's mapped __LINKEDIT segment.
+ * @param data On success, will be set to the start of the encoded table.
+ * @param end On success, will be set to the end of the encoded table.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if the image has no function starts table, or an
+ * appropriate error value if the table could not be mapped.
+ */
+static plcrash_error_t plcrash_async_macho_function_starts_data (plcrash_async_macho_t *image, pl_async_macho_mapped_segment_t *linkedit, const uint8_t **data, const uint8_t **end) {
+    struct linkedit_data_command *cmd = plcrash_async_macho_find_command(image, LC_FUNCTION_STARTS);
+    if (cmd == NULL)
+        return PLCRASH_ENOTFOUND;
+
+    uint32_t dataoff = plcrash_async_swap32(image->byteorder, cmd->dataoff);
+    uint32_t datasize = plcrash_async_swap32(image->byteorder, cmd->datasize);
+    if (datasize == 0)
+        return PLCRASH_ENOTFOUND;
+
+    if (dataoff < linkedit->fileoff) {
+        PLCF_DEBUG("LC_FUNCTION_STARTS dataoff=%" PRIx32 " precedes __LINKEDIT in %s", dataoff, image->name);
+        return PLCRASH_EINVAL;
+    }
+
+    const uint8_t *table = plcrash_async_mobject_remap_address(&linkedit->mobj, linkedit->mobj.task_address, dataoff - linkedit->fileoff, datasize);
+    if (table == NULL) {
+        PLCF_DEBUG("plcrash_async_mobject_remap_address(mobj, %" PRIx64 ", %" PRIx32 ") returned NULL mapping LC_FUNCTION_STARTS in %s",
+                   (uint64_t) linkedit->mobj.address + dataoff, datasize, image->name);
+        return PLCRASH_EINTERNAL;
+    }
+
+    *data = table;
+    *end = table + datasize;
+    return PLCRASH_ESUCCESS;
+}
+
+/*
+ * Decode the next function start from the table at @a *cursor, where @a *address holds the previously decoded address
+ * (initially the image's unslid __TEXT address). The low-order THUMB bit is cleared from the returned @a start.
+ * Returns false once the table's zero terminator or end is reached.
+ */
+static bool plcrash_async_macho_next_function_start (plcrash_async_macho_t *image, const uint8_t **cursor, const uint8_t *end, pl_vm_address_t *address, pl_vm_address_t *start) {
+    uint64_t delta;
+    if (!plcrash_async_macho_read_uleb128(cursor, end, &delta)) {
+        if (*cursor != end)
+            PLCF_DEBUG("Invalid LC_FUNCTION_STARTS entry in %s", image->name);
+        return false;
+    }
+
+    if (delta == 0)
+        return false;
+
+    *address += delta;
+    *start = *address;
+    if (plcrash_async_macho_cpu_type(image) == CPU_TYPE_ARM)
+        *start &= ~((pl_vm_address_t) 1);
+
+    return true;
+}
+
+/* Binary search @a idx for the closest function start at or before @a slide_pc. */
+static bool plcrash_async_macho_find_indexed_function_start (plcrash_async_macho_t *image, const plcrash_async_macho_function_starts_t *idx, pl_vm_address_t slide_pc, pl_vm_address_t *start) {
+    if (slide_pc < image->text_vmaddr)
+        return false;
+
+    pl_vm_address_t offset = slide_pc - image->text_vmaddr;
+    uint32_t lower = 0;
+    uint32_t upper = idx->count;
+
+    /* Find the first entry greater than offset */
+    while (lower < upper) {
+        uint32_t mid = lower + (upper - lower) / 2;
+        if (idx->offsets[mid] <= offset)
+            lower = mid + 1;
+        else
+            upper = mid;
+    }
+
+    if (lower == 0)
+        return false;
+
+    *start = image->text_vmaddr + idx->offsets[lower - 1];
+    return true;
+}
+
+/*
+ * Locate the closest function start at or before @a slide_pc, using @a image's decoded function starts if available,
+ * or decoding the table from the mapped @a linkedit segment otherwise.
+ */
+static bool plcrash_async_macho_find_linkedit_function_start (plcrash_async_macho_t *image, pl_async_macho_mapped_segment_t *linkedit, pl_vm_address_t slide_pc, pl_vm_address_t *start) {
+    /* The decoded table is published atomically; read it exactly once. */
+    const plcrash_async_macho_function_starts_t *idx = image->function_starts;
+    if (idx != NULL)
+        return plcrash_async_macho_find_indexed_function_start(image, idx, slide_pc, start);
+
+    const uint8_t *p;
+    const uint8_t *end;
+    if (plcrash_async_macho_function_starts_data(image, linkedit, &p, &end) != PLCRASH_ESUCCESS)
+        return false;
+
+    /* Function starts are sorted; stop at the first start past slide_pc */
+    pl_vm_address_t address = image->text_vmaddr;
+    pl_vm_address_t next;
+    bool found = false;
+    while (plcrash_async_macho_next_function_start(image, &p, end, &address, &next) && next <= slide_pc) {
+        *start = next;
+        found = true;
+    }
+
+    return found;
+}
+
+/**
+ * Locate the start address of the function containing @a pc within @a image, using the image's LC_FUNCTION_STARTS
+ * table. Unlike plcrash_async_macho_find_symbol_by_pc(), this does not read the symbol table, and remains accurate
+ * for functions that have no symbol table entry.
+ *
+ * If a decoded table has been built by plcrash_nasync_macho_build_function_starts(), the look-up is performed using a
+ * binary search, and no memory is mapped. Otherwise, the table is decoded from the image's __LINKEDIT segment.
+ *
+ * @param image The Mach-O image to search for @a pc.
+ * @param pool A mapping pool from which the __LINKEDIT segment will be mapped, or NULL.
+ * @param pc The PC value within the target process.
+ * @param start On success, will be set to the function's start address within the target process. The low-order
+ * THUMB bit is not set.
+ *
+ * @return Returns PLCRASH_ESUCCESS if a function start was found, or PLCRASH_ENOTFOUND if the image has no function
+ * starts table or no function begins at or before @a pc.
+ */
+plcrash_error_t plcrash_async_macho_find_function_start (plcrash_async_macho_t *image, plcrash_async_mobject_pool_t *pool, pl_vm_address_t pc, pl_vm_address_t *start) {
+    pl_vm_address_t slide_pc = pc - image->vmaddr_slide;
+    pl_vm_address_t found_start;
+    bool found;
+
+    const plcrash_async_macho_function_starts_t *idx = image->function_starts;
+    if (idx != NULL) {
+        found = plcrash_async_macho_find_indexed_function_start(image, idx, slide_pc, &found_start);
+    } else {
+        if (plcrash_async_macho_find_command(image, LC_FUNCTION_STARTS) == NULL)
+            return PLCRASH_ENOTFOUND;
+
+        pl_async_macho_mapped_segment_t linkedit;
+        plcrash_error_t err = plcrash_async_macho_pool_map_segment(pool, image, "__LINKEDIT", &linkedit);
+        if (err != PLCRASH_ESUCCESS) {
+            PLCF_DEBUG("Failed to map __LINKEDIT for function starts in %s: %d", image->name, err);
+            return err;
+        }
+
+        found = plcrash_async_macho_find_linkedit_function_start(image, &linkedit, slide_pc, &found_start);
+        plcrash_async_macho_mapped_segment_free(&linkedit);
+    }
+
+    if (!found)
+        return PLCRASH_ENOTFOUND;
+
+    *start = found_start + image->vmaddr_slide;
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Decode @a image's LC_FUNCTION_STARTS table into a sorted array, allowing plcrash_async_macho_find_function_start()
+ * to perform a binary search rather than decoding the table on each look-up. Symbolication only consults the
+ * function starts once a decoded table is available (see plcrash_async_find_symbol()).
+ *
+ * As with plcrash_nasync_macho_build_symbol_index(), the table is published via an atomic pointer swap, and is
+ * released by plcrash_nasync_macho_free(). If a table has already been built, this function does nothing.
+ *
+ * @param image The image for which the function starts will be decoded.
+ * @param max_bytes The maximum number of bytes that may be allocated for the table, or 0 for no limit. If the
+ * worst-case table size exceeds this limit, no table will be built.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if the image has no function starts table,
+ * PLCRASH_ENOMEM if the table would exceed @a max_bytes or could not be allocated, or an appropriate error value if
+ * the table could not be read.
+ *
+ * @warning This method is not async safe, and must not be called concurrently with plcrash_nasync_macho_free().
+ */
+plcrash_error_t plcrash_nasync_macho_build_function_starts (plcrash_async_macho_t *image, size_t max_bytes) {
+    pl_async_macho_mapped_segment_t linkedit;
+    const uint8_t *p;
+    const uint8_t *end;
+    plcrash_error_t ret;
+
+    if (image->function_starts != NULL)
+        return PLCRASH_ESUCCESS;
+
+    if (plcrash_async_macho_find_command(image, LC_FUNCTION_STARTS) == NULL)
+        return PLCRASH_ENOTFOUND;
+
+    if ((ret = plcrash_async_macho_map_segment(image, "__LINKEDIT", &linkedit)) != PLCRASH_ESUCCESS)
+        return ret;
+
+    if ((ret = plcrash_async_macho_function_starts_data(image, &linkedit, &p, &end)) != PLCRASH_ESUCCESS) {
+        plcrash_async_macho_mapped_segment_free(&linkedit);
+        return ret;
+    }
+
+    /* Every entry is encoded in at least one byte; size for the worst case, and trim below. */
+    size_t capacity = (size_t) (end - p);
+    size_t alloc_size = sizeof(plcrash_async_macho_function_starts_t) + sizeof(uint32_t) * capacity;
+    if (max_bytes != 0 && alloc_size > max_bytes) {
+        PLCF_DEBUG("Function starts for %s require %zu bytes, exceeding the limit of %zu bytes", image->name, alloc_size, max_bytes);
+        plcrash_async_macho_mapped_segment_free(&linkedit);
+        return PLCRASH_ENOMEM;
+    }
+
+    plcrash_async_macho_function_starts_t *idx = malloc(alloc_size);
+    if (idx == NULL) {
+        plcrash_async_macho_mapped_segment_free(&linkedit);
+        return PLCRASH_ENOMEM;
+    }
+
+    uint32_t count = 0;
+    pl_vm_address_t address = image->text_vmaddr;
+    pl_vm_address_t start;
+    while (count < capacity && plcrash_async_macho_next_function_start(image, &p, end, &address, &start)) {
+        if (start - image->text_vmaddr > UINT32_MAX) {
+            PLCF_DEBUG("Function start 0x%" PRIx64 " out of range in %s", (uint64_t) start, image->name);
+            break;
+        }
+
+        idx->offsets[count++] = (uint32_t) (start - image->text_vmaddr);
+    }
+    idx->count = count;
+    plcrash_async_macho_mapped_segment_free(&linkedit);
+
+    if (count < capacity) {
+        plcrash_async_macho_function_starts_t *trimmed = realloc(idx, sizeof(*idx) + sizeof(idx->offsets[0]) * count);
+        if (trimmed != NULL)
+            idx = trimmed;
+    }
+
+    /* Publish the table; if another thread published a table first, ours is discarded. */
+    if (!OSAtomicCompareAndSwapPtrBarrier(NULL, idx, (void * volatile *) &image->function_starts))
+        free(idx);
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Return the number of bytes allocated for @a image's decoded function starts, or 0 if no table has been built.
+ *
+ * @param image The image to query.
+ */
+size_t plcrash_async_macho_function_starts_size (plcrash_async_macho_t *image) {
+    const plcrash_async_macho_function_starts_t *idx = image->function_starts;
+    if (idx == NULL)
+        return 0;
+
+    return sizeof(*idx) + sizeof(idx->offsets[0]) * idx->count;
+}
+
+/**
+ * Attempt to locate a symbol address and name for @a pc within @a image. This is performed using best-guess heuristics, and may
+ * be incorrect.
+ *
+ * @param image The Mach-O image to search for @a pc
+ * @param pool A mapping pool from which the symbol table will be mapped, or NULL.
+ * @param pc The PC value within the target process for which symbol information should be found.
+ * @param symbol_cb A callback to be called if the symbol is found.
+ * @param context Context to be passed to @a found_symbol.
+ *
+ * @return Returns PLCRASH_ESUCCESS if the symbol is found. If the symbol is not found, @a found_symbol will not be called.
+ *
+ * @todo Migrate this API to use the new non-callback based plcrash_async_macho_symtab_reader support for symbol (and symbol name)
+ * reading.
+ */
+plcrash_error_t plcrash_async_macho_find_symbol_by_pc (plcrash_async_macho_t *image, plcrash_async_mobject_pool_t *pool, pl_vm_address_t pc, pl_async_macho_found_symbol_cb symbol_cb, void *context) {
+    plcrash_error_t retval;
+    
+    /* Initialize a symbol table reader */
+    plcrash_async_macho_symtab_reader_t reader;
+    retval = plcrash_async_macho_symtab_reader_init(&reader, image, pool);
+    if (retval != PLCRASH_ESUCCESS)
+        return retval;
+
+    /* Compute the on-disk PC. */
+    pl_vm_address_t slide_pc = pc - image->vmaddr_slide;
+
+    /* Walk the symbol table. */
+    plcrash_async_macho_symtab_entry_t found_symbol;
+    bool did_find_symbol;
+
+    if (image->symbol_index != NULL) {
+        /* A sorted index is available; perform a binary search for the closest symbol occuring before PC. */
+        did_find_symbol = plcrash_async_macho_find_indexed_symbol(&reader, slide_pc, &found_symbol);
+    } else if (reader.symtab_global != NULL && reader.symtab_local != NULL) {
+        /* dysymtab is available; use it to constrain our symbol search to the global and local sections of the symbol table. */
+        plcrash_async_macho_find_best_symbol(&reader, slide_pc, reader.symtab_global, reader.nsyms_global, &found_symbol, NULL, &did_find_symbol);
+        plcrash_async_macho_find_best_symbol(&reader, slide_pc, reader.symtab_local, reader.nsyms_local, &found_symbol, &found_symbol, &did_find_symbol);
+    } else {
+        /* If dysymtab is not available, search all symbols */
+        plcrash_async_macho_find_best_symbol(&reader, slide_pc, reader.symtab, reader.nsyms, &found_symbol, NULL, &did_find_symbol);
+    }
+
+    /* No symbol found. */
+    if (!did_find_symbol) {
+        retval = PLCRASH_ENOTFOUND;
+        goto cleanup;
+    }
+
+    /* Symbol found! */
+    const char *sym_name = plcrash_async_macho_symtab_reader_symbol_name(&reader, found_symbol.n_strx);
+    if (sym_name == NULL) {
+        PLCF_DEBUG("Failed to read symbol name\n");
+        retval = PLCRASH_EINVAL;
+        goto cleanup;
+    }
+
+    /* Inform our caller */
+    symbol_cb(found_symbol.normalized_value + image->vmaddr_slide, sym_name, context);
+
+    // fall through to cleanup
     retval = PLCRASH_ESUCCESS;
 
 cleanup:
@@ -929,6 +2081,149 @@ cleanup:
     return retval;
 }
 
+/*
+ * Sort @a matches in place by on-disk PC. Batches are bounded by the number of frames in a backtrace; an insertion sort
+ * is used, as qsort() is not guaranteed to be async-safe.
+ */
+static void plcrash_async_macho_sort_matches (plcrash_async_macho_symbol_match_t *matches, size_t count, pl_vm_off_t slide) {
+    for (size_t i = 1; i < count; i++) {
+        plcrash_async_macho_symbol_match_t tmp = matches[i];
+        pl_vm_address_t key = tmp.pc - slide;
+
+        size_t j = i;
+        while (j > 0 && matches[j - 1].pc - slide > key) {
+            matches[j] = matches[j - 1];
+            j--;
+        }
+        matches[j] = tmp;
+    }
+}
+
+/*
+ * Record all indexable symbols in @a symtab against the sorted @a matches. Each symbol is recorded only against the
+ * first match with a PC at or after the symbol's address; plcrash_async_macho_find_symbols_by_pc() then propagates
+ * the best match forward to the following PCs.
+ */
+static void plcrash_async_macho_match_symbols (plcrash_async_macho_symtab_reader_t *reader,
+                                               pl_nlist_common *symtab, uint32_t nsyms,
+                                               plcrash_async_macho_symbol_match_t *matches, size_t count)
+{
+    pl_vm_off_t slide = reader->image->vmaddr_slide;
+
+    for (uint32_t i = 0; i < nsyms; i++) {
+        plcrash_async_macho_symtab_entry_t entry = plcrash_async_macho_symtab_reader_read(reader, symtab, i);
+
+        /* Symbol must be within a section, and must not be a debugging entry. */
+        if ((entry.n_type & N_TYPE) != N_SECT || ((entry.n_type & N_STAB) != 0))
+            continue;
+
+        /* Find the first PC at or after the symbol */
+        size_t lower = 0;
+        size_t upper = count;
+        while (lower < upper) {
+            size_t mid = lower + (upper - lower) / 2;
+            if (matches[mid].pc - slide < entry.n_value)
+                lower = mid + 1;
+            else
+                upper = mid;
+        }
+
+        if (lower == count)
+            continue;
+
+        /* As with the linear scan, the first symbol found at the closest address wins */
+        plcrash_async_macho_symbol_match_t *match = &matches[lower];
+        if (!match->found || match->symbol.n_value < entry.n_value) {
+            match->symbol = entry;
+            match->found = true;
+        }
+    }
+}
+
+/**
+ * Attempt to locate symbol addresses and names for all PCs in @a matches, reading @a image's symbol table exactly once.
+ * The results are identical to those of calling plcrash_async_macho_find_symbol_by_pc() for each PC.
+ *
+ * @param image The Mach-O image to search for the PCs.
+ * @param pool A mapping pool from which the symbol table will be mapped, or NULL.
+ * @param matches The PCs to be symbolicated; the pc field of each entry must be populated by the caller. The remaining
+ * fields are used as scratch space.
+ * @param count The number of entries in @a matches.
+ * @param symbol_cb A callback to be called with the result for each entry in @a matches, in order.
+ * @param context Context to be passed to @a symbol_cb.
+ *
+ * @return Returns PLCRASH_ESUCCESS if the symbol table was searched. If the symbol table could not be read, an error is
+ * returned and @a symbol_cb will not be called.
+ */
+plcrash_error_t plcrash_async_macho_find_symbols_by_pc (plcrash_async_macho_t *image, plcrash_async_mobject_pool_t *pool, plcrash_async_macho_symbol_match_t *matches, size_t count, pl_async_macho_found_symbols_cb symbol_cb, void *context) {
+    plcrash_error_t retval;
+
+    /* Initialize a symbol table reader */
+    plcrash_async_macho_symtab_reader_t reader;
+    retval = plcrash_async_macho_symtab_reader_init(&reader, image, pool);
+    if (retval != PLCRASH_ESUCCESS)
+        return retval;
+
+    for (size_t i = 0; i < count; i++) {
+        matches[i].order = (uint32_t) i;
+        matches[i].found = false;
+    }
+
+    if (image->symbol_index != NULL) {
+        /* A sorted index is available; perform a binary search for each PC. */
+        for (size_t i = 0; i < count; i++)
+            matches[i].found = plcrash_async_macho_find_indexed_symbol(&reader, matches[i].pc - image->vmaddr_slide, &matches[i].symbol);
+    } else {
+        /* Sort the PCs, and walk the symbol table once */
+        plcrash_async_macho_sort_matches(matches, count, image->vmaddr_slide);
+
+        if (reader.symtab_global != NULL && reader.symtab_local != NULL) {
+            plcrash_async_macho_match_symbols(&reader, reader.symtab_global, reader.nsyms_global, matches, count);
+            plcrash_async_macho_match_symbols(&reader, reader.symtab_local, reader.nsyms_local, matches, count);
+        } else {
+            plcrash_async_macho_match_symbols(&reader, reader.symtab, reader.nsyms, matches, count);
+        }
+
+        /* Propagate each match to the following PCs. Symbols recorded against a later PC lie after all earlier PCs,
+         * and thus always supersede the propagated match. */
+        for (size_t i = 1; i < count; i++) {
+            if (matches[i - 1].found && !matches[i].found) {
+                matches[i].symbol = matches[i - 1].symbol;
+                matches[i].found = true;
+            }
+        }
+
+        /* Restore the caller's ordering */
+        for (size_t i = 0; i < count; i++) {
+            while (matches[i].order != i) {
+                plcrash_async_macho_symbol_match_t tmp = matches[matches[i].order];
+                matches[matches[i].order] = matches[i];
+                matches[i] = tmp;
+            }
+        }
+    }
+
+    /* Inform our caller */
+    for (size_t i = 0; i < count; i++) {
+        if (!matches[i].found) {
+            symbol_cb(i, PLCRASH_ENOTFOUND, 0x0, NULL, context);
+            continue;
+        }
+
+        const char *sym_name = plcrash_async_macho_symtab_reader_symbol_name(&reader, matches[i].symbol.n_strx);
+        if (sym_name == NULL) {
+            PLCF_DEBUG("Failed to read symbol name\n");
+            symbol_cb(i, PLCRASH_EINVAL, 0x0, NULL, context);
+            continue;
+        }
+
+        symbol_cb(i, PLCRASH_ESUCCESS, matches[i].symbol.normalized_value + image->vmaddr_slide, sym_name, context);
+    }
+
+    plcrash_async_macho_symtab_reader_free(&reader);
+    return PLCRASH_ESUCCESS;
+}
+
 /**
  * Free all mapped segment resources.
  *
@@ -938,16 +2233,48 @@ void plcrash_async_macho_mapped_segment_free (pl_async_macho_mapped_segment_t *s
     plcrash_async_mobject_free(&segment->mobj);
 }
 
+/**
+ * Release @a image's mapping of its load commands. The image's header, __TEXT range, slide, name, and load command
+ * index are retained, and the load commands will be remapped on demand by any accessor that requires them.
+ *
+ * This is intended to be called once an image has been fully prepared for use at crash time, reducing the
+ * resources held by long-lived image records.
+ *
+ * @param image The image to compact.
+ *
+ * @warning This method is not async safe, and must not be called while @a image may be in use by other readers.
+ */
+void plcrash_nasync_macho_release_load_commands (plcrash_async_macho_t *image) {
+    if (image->load_cmds_state != PLCRASH_ASYNC_MACHO_LOAD_CMDS_MAPPED)
+        return;
+
+    plcrash_async_mobject_free(&image->load_cmds);
+    image->load_cmds_state = PLCRASH_ASYNC_MACHO_LOAD_CMDS_UNMAPPED;
+    OSMemoryBarrier();
+}
+
 /**
  * Free all Mach-O binary image resources.
  *
  * @warning This method is not async safe.
  */
 void plcrash_nasync_macho_free (plcrash_async_macho_t *image) {
-    if (image->name != NULL)
+    if (image->name != NULL && !image->name_borrowed)
         free(image->name);
+
+    if (image->symbol_index_mapping != NULL)
+        munmap(image->symbol_index_mapping, image->symbol_index_mapping_size);
+    else if (image->symbol_index != NULL)
+        free(image->symbol_index);
+
+    if (image->dwarf_fde_index != NULL)
+        free(image->dwarf_fde_index);
+
+    if (image->function_starts != NULL)
+        free(image->function_starts);
     
-    plcrash_async_mobject_free(&image->load_cmds);
+    if (image->load_cmds_state == PLCRASH_ASYNC_MACHO_LOAD_CMDS_MAPPED)
+        plcrash_async_mobject_free(&image->load_cmds);
 
     mach_port_mod_refs(mach_task_self(), image->task, MACH_PORT_RIGHT_SEND, -1);
 }
@@ -46,6 +46,104 @@ extern "C" {
  * @{
  */
 
+/**
+ * @internal
+ *
+ * An entry in a Mach-O image's address-sorted symbol index.
+ */
+typedef struct plcrash_async_macho_symbol_index_entry {
+    /** The symbol's (unslid) address. */
+    pl_vm_address_t n_value;
+
+    /** The index of the symbol's nlist entry within the image's complete symbol table. */
+    uint32_t symtab_index;
+} plcrash_async_macho_symbol_index_entry_t;
+
+/**
+ * @internal
+ *
+ * An address-sorted index of a Mach-O image's symbols. The entry count and entries are allocated together, allowing
+ * the index to be published to async-safe readers via a single atomic pointer swap.
+ */
+typedef struct plcrash_async_macho_symbol_index {
+    /** The number of entries. */
+    uint32_t count;
+
+    /** The index entries, sorted by address. */
+    plcrash_async_macho_symbol_index_entry_t entries[];
+} plcrash_async_macho_symbol_index_t;
+
+/**
+ * @internal
+ *
+ * A decoded copy of a Mach-O image's LC_FUNCTION_STARTS table. As with plcrash_async_macho_symbol_index_t, the count
+ * and offsets are allocated together, allowing the table to be published via a single atomic pointer swap.
+ */
+typedef struct plcrash_async_macho_function_starts {
+    /** The number of function start offsets. */
+    uint32_t count;
+
+    /** The function start offsets, relative to the image's unslid __TEXT address, in ascending order. */
+    uint32_t offsets[];
+} plcrash_async_macho_function_starts_t;
+
+/** The maximum number of distinct load command types that may be indexed by a plcrash_async_macho_t. */
+#define PLCRASH_ASYNC_MACHO_COMMAND_INDEX_SIZE 24
+
+/** The maximum number of segments that may be indexed by a plcrash_async_macho_t. */
+#define PLCRASH_ASYNC_MACHO_SEGMENT_INDEX_SIZE 16
+
+/**
+ * @internal
+ *
+ * A Mach-O image's index of its load commands, as built by plcrash_nasync_macho_init(). Offsets are relative
+ * to the start of the image's mapped load commands.
+ */
+typedef struct plcrash_async_macho_command_index {
+    /** The distinct load command types, in the order first seen. */
+    uint32_t cmd_types[PLCRASH_ASYNC_MACHO_COMMAND_INDEX_SIZE];
+
+    /** The offset of the first load command of the corresponding type in @a cmd_types. */
+    uint32_t cmd_offsets[PLCRASH_ASYNC_MACHO_COMMAND_INDEX_SIZE];
+
+    /** The number of valid entries in @a cmd_types and @a cmd_offsets. */
+    uint32_t cmd_count;
+
+    /** If true, every load command type was indexed, and a type missing from the index is absent from the image. */
+    bool cmds_complete;
+
+    /** The offsets of the image's LC_SEGMENT/LC_SEGMENT_64 commands, in load command order. */
+    uint32_t seg_offsets[PLCRASH_ASYNC_MACHO_SEGMENT_INDEX_SIZE];
+
+    /** The number of valid entries in @a seg_offsets. */
+    uint32_t seg_count;
+
+    /** If true, every segment was indexed, and a segment missing from the index is absent from the image. */
+    bool segs_complete;
+
+    /** The verified mappable size of the corresponding segment in @a seg_offsets, or 0 if not yet determined. This may
+     * be smaller than the segment's declared vmsize (see rdar://13707406), and allows later mappings of the segment to
+     * skip determining the mappable extent. Each entry is written at most once, as a single word, and may be read
+     * concurrently; a reader observes either 0 or the final value. */
+    volatile vm_size_t seg_mapped_sizes[PLCRASH_ASYNC_MACHO_SEGMENT_INDEX_SIZE];
+} plcrash_async_macho_command_index_t;
+
+/**
+ * @internal
+ *
+ * Mapping state of a Mach-O image's load commands (see plcrash_nasync_macho_release_load_commands()).
+ */
+typedef enum {
+    /** The load commands are mapped. */
+    PLCRASH_ASYNC_MACHO_LOAD_CMDS_MAPPED = 0,
+
+    /** The load commands have been released, and will be mapped on first use. */
+    PLCRASH_ASYNC_MACHO_LOAD_CMDS_UNMAPPED = 1,
+
+    /** The load commands are being mapped by another thread. */
+    PLCRASH_ASYNC_MACHO_LOAD_CMDS_MAPPING = 2
+} plcrash_async_macho_load_cmds_state_t;
+
 /**
  * @internal
  *
@@ -64,6 +162,15 @@ typedef struct plcrash_async_macho {
     /** The binary image's name/path. */
     char *name;
 
+    /** If true, @a name is borrowed from the caller (see plcrash_async_macho_init_borrowed_name()), and will not be freed. */
+    bool name_borrowed;
+
+    /** If true, the image was loaded from the dyld shared cache. */
+    bool in_shared_cache;
+
+    /** If true, the image contains Objective-C metadata (see plcrash_async_macho_has_objc()). */
+    bool has_objc;
+
     /** The Mach-O header. For our purposes, the 32-bit and 64-bit headers are identical. Note that the header
      * values may require byte-swapping for the local process' use. */
     struct mach_header header;
@@ -75,22 +182,125 @@ typedef struct plcrash_async_macho {
     /** Number of load commands */
     uint32_t ncmds;
 
-    /** Mapped Mach-O load commands */
+    /** Mapped Mach-O load commands. Valid only if @a load_cmds_state is PLCRASH_ASYNC_MACHO_LOAD_CMDS_MAPPED. */
     plcrash_async_mobject_t load_cmds;
 
+    /** The plcrash_async_macho_load_cmds_state_t mapping state of @a load_cmds. */
+    volatile int32_t load_cmds_state;
+
     /** The Mach-O image's __TEXT segment, as defined by the LC_SEGMENT/LC_SEGMENT_64 load command. */
     pl_vm_address_t text_vmaddr;
 
     /** Total size, in bytes, of the Mach-O image's __TEXT segment, as defined by the LC_SEGMENT/LC_SEGMENT_64 load command. */
     pl_vm_size_t text_size;
 
+    /** The Mach-O image's __DATA segment vmaddr, as defined by the LC_SEGMENT/LC_SEGMENT_64 load command. Valid only
+     * if @a has_data_segment is true. */
+    pl_vm_address_t data_vmaddr;
+
+    /** If true, the image defines a __DATA segment. */
+    bool has_data_segment;
+
     /** If true, the image is 64-bit Mach-O. If false, it is a 32-bit Mach-O image. */
     bool m64;
 
     /** The byte order functions to use for this image */
     const plcrash_async_byteorder_t *byteorder;
+
+    /** An optional index of the image's symbols, sorted by address, as built by
+     * plcrash_nasync_macho_build_symbol_index(). If NULL, symbol lookups will scan the symbol table. This value
+     * is published atomically, and may be set while the image is in use by async-safe readers. */
+    plcrash_async_macho_symbol_index_t * volatile symbol_index;
+
+    /** If non-NULL, @a symbol_index is backed by this read-only file mapping (see plcrash_nasync_macho_load_symbol_index()),
+     * rather than by a heap allocation. */
+    void *symbol_index_mapping;
+
+    /** The size of @a symbol_index_mapping, in bytes. */
+    size_t symbol_index_mapping_size;
+
+    /** An optional, opaque look-up table of the image's DWARF FDEs, as built by plframe_nasync_dwarf_build_fde_index().
+     * If NULL, FDE lookups will scan the image's eh_frame or debug_frame section. This value is published atomically,
+     * and may be set while the image is in use by async-safe readers. */
+    void * volatile dwarf_fde_index;
+
+    /** An optional decoded copy of the image's LC_FUNCTION_STARTS table, as built by
+     * plcrash_nasync_macho_build_function_starts(). If NULL, function start look-ups will decode the table from the
+     * image's __LINKEDIT segment. This value is published atomically, and may be set while the image is in use by
+     * async-safe readers. */
+    plcrash_async_macho_function_starts_t * volatile function_starts;
+
+    /** Index of the image's load commands and segments. */
+    plcrash_async_macho_command_index_t cmd_index;
 } plcrash_async_macho_t;
 
+#if PLCRASH_FEATURE_HOST_ONLY_CRASH_PATH && defined(__LP64__)
+/** The pointer width of all images accepted by plcrash_nasync_macho_init(); see #PLCRASH_FEATURE_HOST_ONLY_CRASH_PATH. */
+#  define PLCRASH_ASYNC_MACHO_HOST_M64 true
+#elif PLCRASH_FEATURE_HOST_ONLY_CRASH_PATH
+#  define PLCRASH_ASYNC_MACHO_HOST_M64 false
+#endif
+
+/**
+ * @internal
+ *
+ * Return true if @a image is a 64-bit Mach-O image. If #PLCRASH_FEATURE_HOST_ONLY_CRASH_PATH is enabled, only images
+ * matching the host's pointer width are accepted, and this resolves to a compile-time constant.
+ *
+ * @param image The image to query.
+ */
+static inline bool plcrash_async_macho_m64 (const plcrash_async_macho_t *image) {
+#if PLCRASH_FEATURE_HOST_ONLY_CRASH_PATH
+    return PLCRASH_ASYNC_MACHO_HOST_M64;
+#else
+    return image->m64;
+#endif
+}
+
+/** The maximum number of sections that may be held by a plcrash_async_macho_section_cache_t. */
+#define PLCRASH_ASYNC_MACHO_SECTION_CACHE_SIZE 64
+
+/**
+ * @internal
+ *
+ * A single plcrash_async_macho_section_cache_t entry.
+ */
+typedef struct plcrash_async_macho_section_cache_entry {
+    /** The header address of the image to which this entry belongs. */
+    pl_vm_address_t header_addr;
+
+    /** The section's segment name. */
+    char segname[16];
+
+    /** The section name. */
+    char sectname[16];
+
+    /** The result of mapping the section. If not PLCRASH_ESUCCESS, @a mobj is uninitialized. */
+    plcrash_error_t result;
+
+    /** The section mapping. */
+    plcrash_async_mobject_t mobj;
+} plcrash_async_macho_section_cache_entry_t;
+
+/**
+ * @internal
+ *
+ * A cache of mapped Mach-O sections, allowing repeated look-ups of the same section (eg, by the frame unwinders
+ * for each frame within an image) to share a single mapping. Failed mappings are also cached.
+ *
+ * The cache is intended to be scoped to a single crash report; entries are keyed by image header address, and are
+ * not invalidated if an image is unloaded.
+ *
+ * @warning A cache instance may not be used concurrently from multiple threads.
+ */
+typedef struct plcrash_async_macho_section_cache {
+    /** Cache entries. Lazily allocated on first use; NULL if unallocated, or if allocation failed. */
+    plcrash_async_macho_section_cache_entry_t *entries;
+
+    /** The number of entries in use. */
+    uint32_t count;
+} plcrash_async_macho_section_cache_t;
+
 /**
  * @internal
  *
@@ -186,13 +396,57 @@ typedef struct plcrash_async_macho_symtab_reader {
  */
 typedef void (*pl_async_macho_found_symbol_cb)(pl_vm_address_t address, const char *name, void *ctx);
 
+/**
+ * Prototype of a callback function used to return the results of a batched symbol lookup. The callback is issued once
+ * for every PC in the batch, in the order the PCs were supplied.
+ *
+ * @param index The index of the PC within the batch.
+ * @param err PLCRASH_ESUCCESS if a symbol was found, or the lookup error. If not PLCRASH_ESUCCESS, @a address and
+ * @a name are undefined.
+ * @param address The symbol address.
+ * @param name The symbol name. The callback is responsible for copying this value, as its backing storage is not gauranteed to exist
+ * after the callback returns.
+ * @param ctx The API client's supplied context value.
+ */
+typedef void (*pl_async_macho_found_symbols_cb)(size_t index, plcrash_error_t err, pl_vm_address_t address, const char *name, void *ctx);
+
+/**
+ * @internal
+ *
+ * A single entry in a batched symbol lookup performed by plcrash_async_macho_find_symbols_by_pc().
+ */
+typedef struct plcrash_async_macho_symbol_match {
+    /** The PC value within the target process to be symbolicated. Must be populated by the caller. */
+    pl_vm_address_t pc;
+
+    /** @internal The index of this entry prior to sorting. */
+    uint32_t order;
+
+    /** @internal If true, @a symbol contains the best match found so far. */
+    bool found;
+
+    /** @internal The best matching symbol. */
+    plcrash_async_macho_symtab_entry_t symbol;
+} plcrash_async_macho_symbol_match_t;
+
 plcrash_error_t plcrash_nasync_macho_init (plcrash_async_macho_t *image, mach_port_t task, const char *name, pl_vm_address_t header);
+plcrash_error_t plcrash_async_macho_init_borrowed_name (plcrash_async_macho_t *image, mach_port_t task, const char *name, pl_vm_address_t header);
+plcrash_error_t plcrash_nasync_macho_build_symbol_index (plcrash_async_macho_t *image, size_t max_bytes);
+size_t plcrash_async_macho_symbol_index_size (plcrash_async_macho_t *image);
+plcrash_error_t plcrash_nasync_macho_build_function_starts (plcrash_async_macho_t *image, size_t max_bytes);
+size_t plcrash_async_macho_function_starts_size (plcrash_async_macho_t *image);
+uint32_t plcrash_async_macho_symbol_scan_count (plcrash_async_macho_t *image);
+plcrash_error_t plcrash_nasync_macho_load_symbol_index (plcrash_async_macho_t *image, const char *path, size_t max_bytes);
+plcrash_error_t plcrash_nasync_macho_write_symbol_index (plcrash_async_macho_t *image, const char *path);
+plcrash_error_t plcrash_async_macho_uuid (plcrash_async_macho_t *image, uint8_t uuid[16]);
 
 const plcrash_async_byteorder_t *plcrash_async_macho_byteorder (plcrash_async_macho_t *image);
 const struct mach_header *plcrash_async_macho_header (plcrash_async_macho_t *image);
 pl_vm_size_t plcrash_async_macho_header_size (plcrash_async_macho_t *image);
     
 bool plcrash_async_macho_contains_address (plcrash_async_macho_t *image, pl_vm_address_t address);
+bool plcrash_async_macho_in_shared_cache (plcrash_async_macho_t *image);
+bool plcrash_async_macho_has_objc (plcrash_async_macho_t *image);
 
 cpu_type_t plcrash_async_macho_cpu_type (plcrash_async_macho_t *image);
 cpu_subtype_t plcrash_async_macho_cpu_subtype (plcrash_async_macho_t *image);
@@ -204,17 +458,32 @@ void *plcrash_async_macho_find_segment_cmd (plcrash_async_macho_t *image, const
 
 plcrash_error_t plcrash_async_macho_map_segment (plcrash_async_macho_t *image, const char *segname, pl_async_macho_mapped_segment_t *seg);
 plcrash_error_t plcrash_async_macho_map_section (plcrash_async_macho_t *image, const char *segname, const char *sectname, plcrash_async_mobject_t *mobj);
-
-plcrash_error_t plcrash_async_macho_find_symbol_by_pc (plcrash_async_macho_t *image, pl_vm_address_t pc, pl_async_macho_found_symbol_cb symbol_cb, void *context);
+plcrash_error_t plcrash_async_macho_pool_map_segment (plcrash_async_mobject_pool_t *pool, plcrash_async_macho_t *image, const char *segname, pl_async_macho_mapped_segment_t *seg);
+plcrash_error_t plcrash_async_macho_pool_map_section (plcrash_async_mobject_pool_t *pool, plcrash_async_macho_t *image, const char *segname, const char *sectname, plcrash_async_mobject_t *mobj);
+
+void plcrash_async_macho_section_cache_init (plcrash_async_macho_section_cache_t *cache);
+plcrash_error_t plcrash_async_macho_section_cache_map (plcrash_async_macho_section_cache_t *cache,
+                                                       plcrash_async_macho_t *image,
+                                                       const char *segname,
+                                                       const char *sectname,
+                                                       plcrash_async_mobject_t *storage,
+                                                       plcrash_async_mobject_t **mobj);
+void plcrash_async_macho_section_cache_unmap (plcrash_async_macho_section_cache_t *cache, plcrash_async_mobject_t *mobj);
+void plcrash_async_macho_section_cache_free (plcrash_async_macho_section_cache_t *cache);
+
+plcrash_error_t plcrash_async_macho_find_symbol_by_pc (plcrash_async_macho_t *image, plcrash_async_mobject_pool_t *pool, pl_vm_address_t pc, pl_async_macho_found_symbol_cb symbol_cb, void *context);
+plcrash_error_t plcrash_async_macho_find_symbols_by_pc (plcrash_async_macho_t *image, plcrash_async_mobject_pool_t *pool, plcrash_async_macho_symbol_match_t *matches, size_t count, pl_async_macho_found_symbols_cb symbol_cb, void *context);
+plcrash_error_t plcrash_async_macho_find_function_start (plcrash_async_macho_t *image, plcrash_async_mobject_pool_t *pool, pl_vm_address_t pc, pl_vm_address_t *start);
 plcrash_error_t plcrash_async_macho_find_symbol_by_name (plcrash_async_macho_t *image, const char *symbol, pl_vm_address_t *pc);
 
-plcrash_error_t plcrash_async_macho_symtab_reader_init (plcrash_async_macho_symtab_reader_t *reader, plcrash_async_macho_t *image);
+plcrash_error_t plcrash_async_macho_symtab_reader_init (plcrash_async_macho_symtab_reader_t *reader, plcrash_async_macho_t *image, plcrash_async_mobject_pool_t *pool);
 plcrash_async_macho_symtab_entry_t plcrash_async_macho_symtab_reader_read (plcrash_async_macho_symtab_reader_t *reader, void *symtab, uint32_t index);
 const char *plcrash_async_macho_symtab_reader_symbol_name (plcrash_async_macho_symtab_reader_t *reader, uint32_t n_strx);
 void plcrash_async_macho_symtab_reader_free (plcrash_async_macho_symtab_reader_t *reader);
 
 void plcrash_async_macho_mapped_segment_free (pl_async_macho_mapped_segment_t *segment);
 
+void plcrash_nasync_macho_release_load_commands (plcrash_async_macho_t *image);
 void plcrash_nasync_macho_free (plcrash_async_macho_t *image);
 
 /**
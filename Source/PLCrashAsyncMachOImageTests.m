@@ -111,6 +111,18 @@
     STAssertTrue(plcrash_async_macho_contains_address(&_image, _image.header_addr+_image.text_size-1), @"The final byte should be within the mapped range");
 }
 
+/**
+ * Test detection of Objective-C metadata.
+ */
+- (void) testHasObjC {
+    unsigned long size;
+    bool classlist = getsectiondata((void *) _image.header_addr, "__DATA", "__objc_classlist", &size) != NULL;
+    bool objc_const = getsectiondata((void *) _image.header_addr, "__DATA", "__objc_const", &size) != NULL;
+    bool objc1 = getsegmentdata((void *) _image.header_addr, "__OBJC", &size) != NULL;
+
+    STAssertEquals((bool) ((classlist && objc_const) || objc1), plcrash_async_macho_has_objc(&_image), @"Incorrect ObjC flag");
+}
+
 /**
  * Test CPU type/subtype getters.
  */
@@ -149,6 +161,29 @@
     }
 }
 
+/**
+ * Test on-demand remapping of released load commands.
+ */
+- (void) testReleaseLoadCommands {
+    void *segment = plcrash_async_macho_find_segment_cmd(&_image, SEG_TEXT);
+    STAssertNotNULL(segment, @"Failed to find __TEXT segment");
+    uint32_t ncmds = 0;
+    for (void *cmd = NULL; (cmd = plcrash_async_macho_next_command(&_image, cmd)) != NULL;)
+        ncmds++;
+
+    plcrash_nasync_macho_release_load_commands(&_image);
+    STAssertEquals((int32_t) PLCRASH_ASYNC_MACHO_LOAD_CMDS_UNMAPPED, _image.load_cmds_state, @"Load commands were not released");
+
+    /* Accessors must transparently remap the load commands */
+    STAssertNotNULL(plcrash_async_macho_find_segment_cmd(&_image, SEG_TEXT), @"Failed to find __TEXT segment after release");
+    STAssertEquals((int32_t) PLCRASH_ASYNC_MACHO_LOAD_CMDS_MAPPED, _image.load_cmds_state, @"Load commands were not remapped");
+
+    uint32_t remapped_ncmds = 0;
+    for (void *cmd = NULL; (cmd = plcrash_async_macho_next_command(&_image, cmd)) != NULL;)
+        remapped_ncmds++;
+    STAssertEquals(ncmds, remapped_ncmds, @"Incorrect number of load commands after remapping");
+}
+
 /**
  * Test type-specific iteration of Mach-O load commands.
  */
@@ -203,6 +238,27 @@
     STAssertNULL(cmd, @"Should not have found the requested load command");
 }
 
+/**
+ * Verify that indexed command and segment look-ups match a linear scan of the load commands.
+ */
+- (void) testCommandIndex {
+    STAssertTrue(_image.cmd_index.cmd_count > 0, @"No load commands were indexed");
+    STAssertTrue(_image.cmd_index.seg_count > 0, @"No segments were indexed");
+
+    /* Every command type must resolve to its first occurrence */
+    struct load_command *cmd = NULL;
+    while ((cmd = plcrash_async_macho_next_command(&_image, cmd)) != NULL) {
+        uint32_t type = _image.byteorder->swap32(cmd->cmd);
+        STAssertEquals((void *) plcrash_async_macho_next_command_type(&_image, NULL, type), plcrash_async_macho_find_command(&_image, type), @"Indexed command does not match scan for type 0x%x", type);
+    }
+
+    /* Segments must resolve by name */
+    void *seg = plcrash_async_macho_next_command_type(&_image, NULL, _image.m64 ? LC_SEGMENT_64 : LC_SEGMENT);
+    STAssertNotNULL(seg, @"Could not find a segment");
+    STAssertEquals(seg, plcrash_async_macho_find_segment_cmd(&_image, ((struct segment_command *) seg)->segname), @"Indexed segment does not match scan");
+    STAssertNULL(plcrash_async_macho_find_segment_cmd(&_image, "__NO_SUCH_SEG"), @"Found a non-existent segment");
+}
+
 /**
  * Test memory mapping of a Mach-O segment
  */
@@ -251,6 +307,38 @@
     STAssertEquals(PLCRASH_ENOTFOUND, plcrash_async_macho_map_segment(&_image, "__NO_SUCH_SEG", &seg), @"Should have failed to map the segment");
 }
 
+/**
+ * Test caching of a segment's mappable extent.
+ */
+- (void) testMapSegmentExtentCache {
+    pl_async_macho_mapped_segment_t seg;
+
+    /* The first mapping determines the mappable extent */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_macho_map_segment(&_image, "__LINKEDIT", &seg), @"Failed to map segment");
+    pl_vm_size_t length = seg.mobj.length;
+    plcrash_async_macho_mapped_segment_free(&seg);
+
+    /* The extent must be recorded against the __LINKEDIT segment */
+    uintptr_t offset = (uintptr_t) plcrash_async_macho_find_segment_cmd(&_image, "__LINKEDIT") - _image.load_cmds.address;
+    bool found = false;
+    for (uint32_t i = 0; i < _image.cmd_index.seg_count; i++) {
+        if (_image.cmd_index.seg_offsets[i] == offset) {
+            found = true;
+            STAssertEquals((pl_vm_size_t) _image.cmd_index.seg_mapped_sizes[i], length, @"Segment extent was not cached");
+        }
+    }
+    STAssertTrue(found, @"__LINKEDIT was not indexed");
+
+    /* Mapping a second segment must not disturb the first segment's extent */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_macho_map_segment(&_image, "__TEXT", &seg), @"Failed to map segment");
+    plcrash_async_macho_mapped_segment_free(&seg);
+
+    /* Later mappings should use the cached extent */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_macho_map_segment(&_image, "__LINKEDIT", &seg), @"Failed to map segment");
+    STAssertEquals(seg.mobj.length, length, @"Incorrect segment length");
+    plcrash_async_macho_mapped_segment_free(&seg);
+}
+
 /**
  * Test memory mapping of a Mach-O section
  */
@@ -283,6 +371,42 @@
     STAssertEquals(PLCRASH_ENOTFOUND, plcrash_async_macho_map_section(&_image, "__DATA", "__NO_SUCH_SECT", &mobj), @"Should have failed to map the section");
 }
 
+/**
+ * Test caching of section mappings.
+ */
+- (void) testSectionCache {
+    plcrash_async_macho_section_cache_t cache;
+    plcrash_async_mobject_t storage;
+    plcrash_async_mobject_t *first;
+    plcrash_async_mobject_t *second;
+
+    plcrash_async_macho_section_cache_init(&cache);
+
+    /* Repeated look-ups must return the same cached mapping */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_macho_section_cache_map(&cache, &_image, "__DATA", "__const", &storage, &first), @"Failed to map section");
+    STAssertNotEquals(first, &storage, @"Mapping was not cached");
+    plcrash_async_macho_section_cache_unmap(&cache, first);
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_macho_section_cache_map(&cache, &_image, "__DATA", "__const", &storage, &second), @"Failed to map section");
+    STAssertEquals(first, second, @"Cached mapping was not returned");
+    STAssertEquals(cache.count, (uint32_t) 1, @"Incorrect entry count");
+
+    /* The cached mapping must match an uncached mapping */
+    plcrash_async_mobject_t *uncached;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_macho_section_cache_map(NULL, &_image, "__DATA", "__const", &storage, &uncached), @"Failed to map section");
+    STAssertEquals(uncached, &storage, @"Uncached mapping should use the provided storage");
+    STAssertEquals(uncached->task_address, second->task_address, @"Addresses do not match");
+    STAssertEquals(uncached->length, second->length, @"Sizes do not match");
+    plcrash_async_macho_section_cache_unmap(NULL, uncached);
+
+    /* Missing sections are cached, too */
+    STAssertEquals(PLCRASH_ENOTFOUND, plcrash_async_macho_section_cache_map(&cache, &_image, "__DATA", "__NO_SUCH_SECT", &storage, &first), @"Should have failed to map the section");
+    STAssertEquals(PLCRASH_ENOTFOUND, plcrash_async_macho_section_cache_map(&cache, &_image, "__DATA", "__NO_SUCH_SECT", &storage, &first), @"Should have failed to map the section");
+    STAssertEquals(cache.count, (uint32_t) 2, @"Incorrect entry count");
+
+    plcrash_async_macho_section_cache_free(&cache);
+}
+
 
 /**
  * Test memory mapping of a missing Mach-O segment
@@ -310,7 +434,7 @@ static void testFindSymbol_cb (pl_vm_address_t address, const char *name, void *
  */
 - (void) testInitSymtabReader {
     plcrash_async_macho_symtab_reader_t reader;
-    plcrash_error_t ret = plcrash_async_macho_symtab_reader_init(&reader, &_image);
+    plcrash_error_t ret = plcrash_async_macho_symtab_reader_init(&reader, &_image, NULL);
     STAssertEquals(ret, PLCRASH_ESUCCESS, @"Failed to initializer reader");
     
     STAssertNotNULL(reader.symtab, @"Failed to map symtab");
@@ -352,7 +476,7 @@ static void testFindSymbol_cb (pl_vm_address_t address, const char *name, void *
     
     /* Now walk the Mach-O table ourselves */
     plcrash_async_macho_symtab_reader_t reader;
-    plcrash_error_t ret = plcrash_async_macho_symtab_reader_init(&reader, &_image);
+    plcrash_error_t ret = plcrash_async_macho_symtab_reader_init(&reader, &_image, NULL);
     STAssertEquals(ret, PLCRASH_ESUCCESS, @"Failed to initializer reader");
 
     /* Find the symbol entry and extract the name name */
@@ -390,7 +514,7 @@ static void testFindSymbol_cb (pl_vm_address_t address, const char *name, void *
 
     /* Perform our symbol lookup */
     struct testFindSymbol_cb_ctx ctx;
-    plcrash_error_t res = plcrash_async_macho_find_symbol_by_pc(&_image, (pl_vm_address_t) callstack[0], testFindSymbol_cb, &ctx);
+    plcrash_error_t res = plcrash_async_macho_find_symbol_by_pc(&_image, NULL, (pl_vm_address_t) callstack[0], testFindSymbol_cb, &ctx);
     STAssertEquals(res, PLCRASH_ESUCCESS, @"Failed to locate symbol");
     
     /* The following tests will crash if the above did not succeed */
@@ -407,6 +531,249 @@ static void testFindSymbol_cb (pl_vm_address_t address, const char *name, void *
     STAssertEquals(dli.dli_saddr, (void *) ctx.addr, @"Returned incorrect symbol address with slide %" PRId64, (int64_t) _image.vmaddr_slide);
 }
 
+/**
+ * Test that symbol lookup via the sorted symbol index returns the same results as scanning the symbol table.
+ */
+- (void) testFindSymbolWithIndex {
+    /* Sample PCs across the image's text segment */
+    const size_t sample_count = 512;
+    pl_vm_address_t pcs[sample_count];
+    struct testFindSymbol_cb_ctx expected[sample_count];
+    plcrash_error_t expected_res[sample_count];
+
+    for (size_t i = 0; i < sample_count; i++) {
+        pcs[i] = _image.header_addr + (_image.text_size / sample_count) * i;
+        expected[i].name = NULL;
+        expected_res[i] = plcrash_async_macho_find_symbol_by_pc(&_image, NULL, pcs[i], testFindSymbol_cb, &expected[i]);
+    }
+
+    /* Build the index */
+    STAssertNULL(_image.symbol_index, @"Index should not be built by default");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_macho_build_symbol_index(&_image, 0), @"Failed to build symbol index");
+    STAssertNotNULL(_image.symbol_index, @"Index was not built");
+    STAssertTrue(plcrash_async_macho_symbol_index_size(&_image) > 0, @"Index size was not reported");
+
+    for (uint32_t i = 1; i < _image.symbol_index->count; i++)
+        STAssertTrue(_image.symbol_index->entries[i-1].n_value < _image.symbol_index->entries[i].n_value, @"Index is not sorted");
+
+    /* Compare the indexed results against the scanned results */
+    for (size_t i = 0; i < sample_count; i++) {
+        struct testFindSymbol_cb_ctx ctx = { .name = NULL };
+        plcrash_error_t res = plcrash_async_macho_find_symbol_by_pc(&_image, NULL, pcs[i], testFindSymbol_cb, &ctx);
+        STAssertEquals(expected_res[i], res, @"Indexed lookup result differs for PC 0x%" PRIx64, (uint64_t) pcs[i]);
+
+        if (res == PLCRASH_ESUCCESS && expected_res[i] == PLCRASH_ESUCCESS) {
+            STAssertEquals(expected[i].addr, ctx.addr, @"Indexed lookup address differs for PC 0x%" PRIx64, (uint64_t) pcs[i]);
+            STAssertEqualCStrings(expected[i].name, ctx.name, @"Indexed lookup name differs for PC 0x%" PRIx64, (uint64_t) pcs[i]);
+        }
+
+        free(ctx.name);
+        free(expected[i].name);
+    }
+}
+
+/**
+ * Test that a decoded function starts table does not alter symbol look-ups; PCs within functions that lack a symbol
+ * table entry of their own (eg, stripped local functions) continue to report the nearest preceding symbol.
+ */
+- (void) testFindSymbolWithFunctionStarts {
+    const size_t sample_count = 512;
+    pl_vm_address_t pcs[sample_count];
+    struct testFindSymbol_cb_ctx expected[sample_count];
+    plcrash_error_t expected_res[sample_count];
+
+    for (size_t i = 0; i < sample_count; i++) {
+        pcs[i] = _image.header_addr + (_image.text_size / sample_count) * i;
+        expected[i].name = NULL;
+        expected_res[i] = plcrash_async_macho_find_symbol_by_pc(&_image, NULL, pcs[i], testFindSymbol_cb, &expected[i]);
+    }
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_macho_build_function_starts(&_image, 0), @"Failed to decode function starts");
+
+    for (size_t i = 0; i < sample_count; i++) {
+        struct testFindSymbol_cb_ctx ctx = { .name = NULL };
+        plcrash_error_t res = plcrash_async_macho_find_symbol_by_pc(&_image, NULL, pcs[i], testFindSymbol_cb, &ctx);
+        STAssertEquals(expected_res[i], res, @"Lookup result differs for PC 0x%" PRIx64, (uint64_t) pcs[i]);
+
+        if (res == PLCRASH_ESUCCESS && expected_res[i] == PLCRASH_ESUCCESS) {
+            STAssertEquals(expected[i].addr, ctx.addr, @"Lookup address differs for PC 0x%" PRIx64, (uint64_t) pcs[i]);
+            STAssertEqualCStrings(expected[i].name, ctx.name, @"Lookup name differs for PC 0x%" PRIx64, (uint64_t) pcs[i]);
+        }
+
+        free(ctx.name);
+        free(expected[i].name);
+    }
+}
+
+/* testFindSymbolsBatch callback; records each result in an array of testFindSymbol_cb_ctx */
+struct testFindSymbolsBatch_ctx {
+    struct testFindSymbol_cb_ctx *results;
+    plcrash_error_t *errors;
+    size_t calls;
+};
+
+static void testFindSymbolsBatch_cb (size_t index, plcrash_error_t err, pl_vm_address_t address, const char *name, void *ctx) {
+    struct testFindSymbolsBatch_ctx *batch = ctx;
+    batch->errors[index] = err;
+    batch->calls++;
+
+    if (err == PLCRASH_ESUCCESS) {
+        batch->results[index].addr = address;
+        batch->results[index].name = strdup(name);
+    }
+}
+
+/**
+ * Test that batched symbol lookup returns the same results as individual lookups.
+ */
+- (void) testFindSymbolsBatch {
+    /* Sample PCs across the image's text segment, in descending order (as in a backtrace), with duplicates */
+    const size_t sample_count = 256;
+    plcrash_async_macho_symbol_match_t matches[sample_count];
+    pl_vm_address_t pcs[sample_count];
+    struct testFindSymbol_cb_ctx expected[sample_count];
+    plcrash_error_t expected_res[sample_count];
+
+    for (size_t i = 0; i < sample_count; i++) {
+        size_t slot = (sample_count - 1 - i) / 2 * 2;
+        pcs[i] = _image.header_addr + (_image.text_size / sample_count) * slot;
+        matches[i].pc = pcs[i];
+        expected[i].name = NULL;
+        expected_res[i] = plcrash_async_macho_find_symbol_by_pc(&_image, NULL, pcs[i], testFindSymbol_cb, &expected[i]);
+    }
+
+    struct testFindSymbol_cb_ctx results[sample_count];
+    plcrash_error_t errors[sample_count];
+    struct testFindSymbolsBatch_ctx ctx = { .results = results, .errors = errors, .calls = 0 };
+    for (size_t i = 0; i < sample_count; i++)
+        results[i].name = NULL;
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_macho_find_symbols_by_pc(&_image, NULL, matches, sample_count, testFindSymbolsBatch_cb, &ctx), @"Batch lookup failed");
+    STAssertEquals(sample_count, ctx.calls, @"Callback was not issued for every PC");
+
+    for (size_t i = 0; i < sample_count; i++) {
+        STAssertEquals(pcs[i], matches[i].pc, @"Batch lookup did not restore the PC order");
+        STAssertEquals(expected_res[i], errors[i], @"Batch lookup result differs for PC 0x%" PRIx64, (uint64_t) matches[i].pc);
+
+        if (errors[i] == PLCRASH_ESUCCESS && expected_res[i] == PLCRASH_ESUCCESS) {
+            STAssertEquals(expected[i].addr, results[i].addr, @"Batch lookup address differs for PC 0x%" PRIx64, (uint64_t) matches[i].pc);
+            STAssertEqualCStrings(expected[i].name, results[i].name, @"Batch lookup name differs for PC 0x%" PRIx64, (uint64_t) matches[i].pc);
+        }
+
+        free(results[i].name);
+        free(expected[i].name);
+    }
+}
+
+/**
+ * Test that symbol index construction respects the provided memory limit.
+ */
+- (void) testBuildSymbolIndexMemoryLimit {
+    STAssertEquals(PLCRASH_ENOMEM, plcrash_nasync_macho_build_symbol_index(&_image, 1), @"Index should exceed the memory limit");
+    STAssertNULL(_image.symbol_index, @"Index should not be published on failure");
+    STAssertEquals((size_t) 0, plcrash_async_macho_symbol_index_size(&_image), @"No index size should be reported");
+}
+
+/**
+ * Test function start look-up via LC_FUNCTION_STARTS, both decoding the table on demand and via the decoded table.
+ */
+- (void) testFindFunctionStart {
+    /* Our own IMP is a function start */
+    IMP localIMP = class_getMethodImplementation([self class], _cmd);
+    pl_vm_address_t imp = (pl_vm_address_t) localIMP;
+    pl_vm_address_t start;
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_macho_find_function_start(&_image, NULL, imp, &start), @"Failed to find function start");
+    STAssertEquals(imp, start, @"Returned incorrect function start for our IMP");
+
+    /* Our PC falls within our IMP */
+    void *callstack[1];
+    int frames = backtrace(callstack, 1);
+    STAssertEquals(1, frames, @"Could not fetch our PC");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_macho_find_function_start(&_image, NULL, (pl_vm_address_t) callstack[0], &start), @"Failed to find function start");
+    STAssertEquals(imp, start, @"Returned incorrect function start for our PC");
+
+    /* Sample PCs across the image's text segment */
+    const size_t sample_count = 512;
+    pl_vm_address_t pcs[sample_count];
+    pl_vm_address_t expected[sample_count];
+    plcrash_error_t expected_res[sample_count];
+
+    for (size_t i = 0; i < sample_count; i++) {
+        pcs[i] = _image.header_addr + (_image.text_size / sample_count) * i;
+        expected_res[i] = plcrash_async_macho_find_function_start(&_image, NULL, pcs[i], &expected[i]);
+        if (expected_res[i] == PLCRASH_ESUCCESS)
+            STAssertTrue(expected[i] <= pcs[i], @"Function start follows PC 0x%" PRIx64, (uint64_t) pcs[i]);
+    }
+
+    /* Decode the table, and compare the results */
+    STAssertNULL(_image.function_starts, @"Function starts should not be decoded by default");
+    STAssertEquals(PLCRASH_ENOMEM, plcrash_nasync_macho_build_function_starts(&_image, 1), @"Table should exceed the memory limit");
+    STAssertNULL(_image.function_starts, @"Table should not be published on failure");
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_macho_build_function_starts(&_image, 0), @"Failed to decode function starts");
+    STAssertNotNULL(_image.function_starts, @"Table was not built");
+    STAssertTrue(plcrash_async_macho_function_starts_size(&_image) > 0, @"Table size was not reported");
+
+    for (uint32_t i = 1; i < _image.function_starts->count; i++)
+        STAssertTrue(_image.function_starts->offsets[i-1] < _image.function_starts->offsets[i], @"Table is not sorted");
+
+    for (size_t i = 0; i < sample_count; i++) {
+        pl_vm_address_t indexed = 0;
+        plcrash_error_t res = plcrash_async_macho_find_function_start(&_image, NULL, pcs[i], &indexed);
+        STAssertEquals(expected_res[i], res, @"Decoded table result differs for PC 0x%" PRIx64, (uint64_t) pcs[i]);
+        if (res == PLCRASH_ESUCCESS && expected_res[i] == PLCRASH_ESUCCESS)
+            STAssertEquals(expected[i], indexed, @"Decoded table start differs for PC 0x%" PRIx64, (uint64_t) pcs[i]);
+    }
+}
+
+/**
+ * Test writing a symbol index to disk and mapping it into a newly initialized image.
+ */
+- (void) testPersistSymbolIndex {
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent: [[NSProcessInfo processInfo] globallyUniqueString]];
+    const char *cpath = [path fileSystemRepresentation];
+
+    /* Nothing to write until an index has been built */
+    STAssertEquals(PLCRASH_ENOTFOUND, plcrash_nasync_macho_write_symbol_index(&_image, cpath), @"Write should fail without an index");
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_macho_build_symbol_index(&_image, 0), @"Failed to build symbol index");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_macho_write_symbol_index(&_image, cpath), @"Failed to write symbol index");
+
+    /* Load the index into a fresh image */
+    plcrash_async_macho_t image;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_macho_init(&image, mach_task_self(), _image.name, _image.header_addr), @"Failed to initialize image");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_macho_load_symbol_index(&image, cpath, 0), @"Failed to load symbol index");
+    STAssertNotNULL(image.symbol_index_mapping, @"Index was not mapped");
+    STAssertEquals(plcrash_async_macho_symbol_index_size(&_image), plcrash_async_macho_symbol_index_size(&image), @"Incorrect index size");
+    STAssertEquals(0, memcmp(_image.symbol_index, image.symbol_index, plcrash_async_macho_symbol_index_size(&image)), @"Loaded index differs");
+
+    /* Indexes larger than the limit are not mapped */
+    plcrash_async_macho_t limited;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_macho_init(&limited, mach_task_self(), _image.name, _image.header_addr), @"Failed to initialize image");
+    STAssertEquals(PLCRASH_ENOMEM, plcrash_nasync_macho_load_symbol_index(&limited, cpath, plcrash_async_macho_symbol_index_size(&_image) - 1), @"Index exceeding the limit was loaded");
+    STAssertNULL(limited.symbol_index, @"Index exceeding the limit was published");
+    plcrash_nasync_macho_free(&limited);
+
+    /* Loading over an existing index is a no-op */
+    plcrash_async_macho_symbol_index_t *idx = image.symbol_index;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_macho_load_symbol_index(&image, cpath, 0), @"Failed to reload symbol index");
+    STAssertTrue(idx == image.symbol_index, @"Index should not be replaced");
+    plcrash_nasync_macho_free(&image);
+
+    /* A corrupt index must be rejected */
+    NSMutableData *data = [NSMutableData dataWithContentsOfFile: path];
+    ((uint8_t *) [data mutableBytes])[0] ^= 0xFF;
+    STAssertTrue([data writeToFile: path atomically: YES], @"Failed to write corrupt index");
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_macho_init(&image, mach_task_self(), _image.name, _image.header_addr), @"Failed to initialize image");
+    STAssertEquals(PLCRASH_EINVALID_DATA, plcrash_nasync_macho_load_symbol_index(&image, cpath, 0), @"Corrupt index should be rejected");
+    STAssertNULL(image.symbol_index, @"Corrupt index should not be published");
+    plcrash_nasync_macho_free(&image);
+
+    [[NSFileManager defaultManager] removeItemAtPath: path error: NULL];
+}
+
 /**
  * Test lookup of symbols by name.
  */
@@ -46,6 +46,46 @@ plcrash_error_t plcrash_async_macho_string_init (plcrash_async_macho_string_t *s
     string->image = image;
     string->address = address;
     string->mobjIsInitialized = false;
+    string->borrowed = NULL;
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Initialize a string object from a NUL-terminated C string, borrowing the string contents from an
+ * existing memory object that covers the string (eg, a mapping of the image's __objc_methname section).
+ * The string is then a (pointer, length) view of @a backing, and no further mapping is required.
+ *
+ * If @a backing is NULL, does not contain @a address, or does not contain the string's terminating NUL,
+ * the string contents will be lazily mapped, as per plcrash_async_macho_string_init().
+ *
+ * @param string A pointer to the string object to initialize.
+ * @param image The Mach-O image in which the string resides.
+ * @param address The address of the string.
+ * @param backing A memory object that may cover the string, or NULL. The memory object must remain valid
+ * for the lifetime of @a string.
+ * @return An error code.
+ */
+plcrash_error_t plcrash_async_macho_string_init_borrowed (plcrash_async_macho_string_t *string, plcrash_async_macho_t *image, pl_vm_address_t address, plcrash_async_mobject_t *backing) {
+    plcrash_error_t err = plcrash_async_macho_string_init(string, image, address);
+    if (err != PLCRASH_ESUCCESS || backing == NULL)
+        return err;
+
+    /* Verify that the string starts within the backing mapping */
+    if (address < backing->task_address || address - backing->task_address >= backing->length)
+        return PLCRASH_ESUCCESS;
+
+    pl_vm_size_t available = backing->length - (address - backing->task_address);
+    const char *p = plcrash_async_mobject_remap_address(backing, address, 0, available);
+    if (p == NULL)
+        return PLCRASH_ESUCCESS;
+
+    /* Scan for the terminating NUL, without reading past the end of the mapping */
+    size_t length = plcrash_async_strnlen(p, available);
+    if (length == available)
+        return PLCRASH_ESUCCESS;
+
+    string->borrowed = p;
+    string->length = length;
     return PLCRASH_ESUCCESS;
 }
 
@@ -56,7 +96,7 @@ plcrash_error_t plcrash_async_macho_string_init (plcrash_async_macho_string_t *s
  * @return An error code.
  */
 static plcrash_error_t plcrash_async_macho_string_read (plcrash_async_macho_string_t *string) {
-    if (string->mobjIsInitialized)
+    if (string->mobjIsInitialized || string->borrowed != NULL)
         return PLCRASH_ESUCCESS;
     
     pl_vm_address_t cursor = string->address;
@@ -119,6 +159,11 @@ plcrash_error_t plcrash_async_macho_string_get_length (plcrash_async_macho_strin
  * @return An error code.
  */
 plcrash_error_t plcrash_async_macho_string_get_pointer (plcrash_async_macho_string_t *string, const char **outPointer) {
+    if (string->borrowed != NULL) {
+        *outPointer = string->borrowed;
+        return PLCRASH_ESUCCESS;
+    }
+
     plcrash_error_t err = plcrash_async_macho_string_read(string);
     if (err == PLCRASH_ESUCCESS) {
         *outPointer = plcrash_async_mobject_remap_address(&string->mobj, string->mobj.task_address, 0, string->mobj.length);
@@ -56,6 +56,10 @@ typedef struct plcrash_async_macho_string {
     /** Whether the memory object is initialized. */
     bool mobjIsInitialized;
 
+    /** If non-NULL, the string contents are borrowed from a covering memory object owned by the caller,
+     * and @a mobj is unused. */
+    const char *borrowed;
+
     /** The string's length, in bytes, not counting the terminating NUL. */
     pl_vm_size_t length;
 } plcrash_async_macho_string_t;
@@ -63,6 +67,8 @@ typedef struct plcrash_async_macho_string {
 
 plcrash_error_t plcrash_async_macho_string_init (plcrash_async_macho_string_t *string, plcrash_async_macho_t *image, pl_vm_address_t address);
 
+plcrash_error_t plcrash_async_macho_string_init_borrowed (plcrash_async_macho_string_t *string, plcrash_async_macho_t *image, pl_vm_address_t address, plcrash_async_mobject_t *backing);
+
 plcrash_error_t plcrash_async_macho_string_get_length (plcrash_async_macho_string_t *string, pl_vm_size_t *outLength);
 
 plcrash_error_t plcrash_async_macho_string_get_pointer (plcrash_async_macho_string_t *string, const char **outPointer);
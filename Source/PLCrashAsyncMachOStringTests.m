@@ -98,4 +98,42 @@
     STAssertEquals(strncmp(str, ptr, len), 0, @"String contents do not match");
 }
 
+- (void) testBorrowedStringReading {
+    const char *str = "one two three four five";
+    plcrash_async_mobject_t backing;
+    plcrash_error_t err;
+
+    /* Map a covering object */
+    err = plcrash_async_mobject_init(&backing, mach_task_self(), (pl_vm_address_t) str, strlen(str) + 1, true);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"Failed to map backing object");
+
+    plcrash_async_macho_string_t strObj;
+    err = plcrash_async_macho_string_init_borrowed(&strObj, &_image, (pl_vm_address_t) (str + 4), &backing);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"Error initializing string object");
+    STAssertNotNULL(strObj.borrowed, @"String should be borrowed from the backing object");
+    STAssertFalse(strObj.mobjIsInitialized, @"No string mapping should be created");
+
+    pl_vm_size_t len;
+    const char *ptr;
+    STAssertEquals(plcrash_async_macho_string_get_length(&strObj, &len), PLCRASH_ESUCCESS, @"Error getting string length");
+    STAssertEquals(plcrash_async_macho_string_get_pointer(&strObj, &ptr), PLCRASH_ESUCCESS, @"Error getting string pointer");
+    STAssertEquals(strlen(str + 4), (unsigned long) len, @"String length does not match");
+    STAssertEquals(strncmp(str + 4, ptr, len), 0, @"String contents do not match");
+    plcrash_async_macho_string_free(&strObj);
+
+    /* A string that is not terminated within the backing object must fall back on a string mapping */
+    plcrash_async_mobject_free(&backing);
+    err = plcrash_async_mobject_init(&backing, mach_task_self(), (pl_vm_address_t) str, 3, true);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"Failed to map backing object");
+
+    err = plcrash_async_macho_string_init_borrowed(&strObj, &_image, (pl_vm_address_t) str, &backing);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"Error initializing string object");
+    STAssertNULL(strObj.borrowed, @"Unterminated string should not be borrowed");
+    STAssertEquals(plcrash_async_macho_string_get_length(&strObj, &len), PLCRASH_ESUCCESS, @"Error getting string length");
+    STAssertEquals(strlen(str), (unsigned long) len, @"String length does not match");
+    plcrash_async_macho_string_free(&strObj);
+
+    plcrash_async_mobject_free(&backing);
+}
+
 @end
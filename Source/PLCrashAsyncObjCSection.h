@@ -42,6 +42,66 @@ extern "C" {
  * @{
  */
 
+/**
+ * @internal
+ *
+ * The maximum number of per-image IMP tables retained by a plcrash_async_objc_cache_t.
+ */
+#define PLCRASH_ASYNC_OBJC_IMP_TABLE_COUNT 8
+
+/**
+ * @internal
+ *
+ * The install name of the Objective-C runtime. The runtime's shared cache copy carries the cache's precomputed
+ * ObjC optimization tables; see plcrash_async_objc_cache_set_shared_cache_image().
+ */
+#define PLCRASH_ASYNC_OBJC_RUNTIME_PATH "/usr/lib/libobjc.A.dylib"
+
+/**
+ * @internal
+ *
+ * A single Objective-C method record within a plcrash_async_objc_imp_table_t.
+ */
+typedef struct plcrash_async_objc_imp_entry {
+    /** The method's IMP. */
+    pl_vm_address_t imp;
+
+    /** The address of the method's class name. */
+    pl_vm_address_t class_name;
+
+    /** The address of the method's selector name. */
+    pl_vm_address_t method_name;
+
+    /** The order in which the method was found while parsing the image; used to resolve duplicate IMPs. */
+    uint32_t order;
+
+    /** If true, the method is a class (rather than an instance) method. */
+    bool isClassMethod;
+} plcrash_async_objc_imp_entry_t;
+
+/**
+ * @internal
+ *
+ * An IMP-sorted table of all Objective-C methods found within a single image, allowing methods to be found via a
+ * binary search rather than by re-parsing the image's class data.
+ */
+typedef struct plcrash_async_objc_imp_table {
+    /** The image described by this table, or NULL if the table is unused. */
+    plcrash_async_macho_t *image;
+
+    /** The result of building the table. If not PLCRASH_ESUCCESS, this error is returned for all lookups within @a image. */
+    plcrash_error_t status;
+
+    /** The table entries, sorted by IMP, or NULL if the table is empty. */
+    plcrash_async_objc_imp_entry_t *entries;
+
+    /** The number of valid entries in @a entries. */
+    uint32_t count;
+
+    /** The number of bytes allocated for @a entries. */
+    pl_vm_size_t allocation_size;
+} plcrash_async_objc_imp_table_t;
+
 /**
  * @internal
  *
@@ -62,6 +122,10 @@ typedef struct plcrash_async_objc_cache {
     
     /** The last MachO image seen. The image for which the memory objects below are valid. */
     plcrash_async_macho_t *lastImage;
+
+    /** An optional mapping pool from which the memory objects below will be mapped, or NULL. This is a borrowed
+     * reference, and must remain valid for the lifetime of the cache. */
+    plcrash_async_mobject_pool_t *mappingPool;
     
     /** Whether the objcConst object is initialized. */
     bool objcConstMobjInitialized;
@@ -86,19 +150,76 @@ typedef struct plcrash_async_objc_cache {
     
     /** A memory object for the __objc_data section. */
     plcrash_async_mobject_t objcDataMobj;
+
+    /** Whether the method name memory object is initialized. */
+    bool methNameMobjInitialized;
+
+    /** A memory object for the __objc_methname section, from which method name strings are borrowed. */
+    plcrash_async_mobject_t methNameMobj;
+
+    /** Whether the class name memory object is initialized. */
+    bool classNameMobjInitialized;
+
+    /** A memory object for the __objc_classname section, from which class name strings are borrowed. */
+    plcrash_async_mobject_t classNameMobj;
+
+    /** Whether the selector reference memory object is initialized. */
+    bool selRefsMobjInitialized;
+
+    /** A memory object for the __objc_selrefs section, through which relative method list names are resolved. */
+    plcrash_async_mobject_t selRefsMobj;
+
+    /** Whether the shared cache ObjC optimization memory object is initialized, and the header table below is valid. */
+    bool objcOptMobjInitialized;
+
+    /** A memory object for libobjc's __objc_opt_ro section, containing the shared cache's ObjC optimization tables. */
+    plcrash_async_mobject_t objcOptMobj;
+
+    /** The byte order of the shared cache ObjC optimization tables. */
+    const plcrash_async_byteorder_t *objcOptByteOrder;
+
+    /** If true, the shared cache ObjC optimization tables use 64-bit offsets. */
+    bool objcOptM64;
+
+    /** The task address of the first entry in the shared cache's ObjC image header table. */
+    pl_vm_address_t objcOptHeadersAddress;
+
+    /** The number of entries in the shared cache's ObjC image header table. */
+    uint32_t objcOptHeaderCount;
     
-    /** The size of the class cache, in entries. */
+    /** The size of the class cache, in entries. Always zero or a power of two. */
     size_t classCacheSize;
+
+    /** The number of occupied class cache entries. */
+    size_t classCacheCount;
     
     /** Array of class cache keys. These are class data pointers. */
     pl_vm_address_t *classCacheKeys;
     
     /** Array of class cache values. These are pointers to class_ro data. */
     pl_vm_address_t *classCacheValues;
+
+    /** The number of class structures read from the target and parsed, excluding those served from the class cache. */
+    uint32_t classParseCount;
+
+#ifndef PLCF_RELEASE_BUILD
+    /** The number of class cache lookups that found a cached value. */
+    uint64_t classCacheHits;
+
+    /** The number of class cache lookups that did not find a cached value. */
+    uint64_t classCacheMisses;
+#endif /* PLCF_RELEASE_BUILD */
+
+    /** Per-image IMP tables, built on the first method lookup within each image. */
+    plcrash_async_objc_imp_table_t impTables[PLCRASH_ASYNC_OBJC_IMP_TABLE_COUNT];
+
+    /** The index of the next IMP table slot to be replaced once all slots are in use. */
+    size_t impTableNext;
 } plcrash_async_objc_cache_t;
 
 plcrash_error_t plcrash_async_objc_cache_init (plcrash_async_objc_cache_t *context);
 void plcrash_async_objc_cache_free (plcrash_async_objc_cache_t *context);
+plcrash_error_t plcrash_async_objc_cache_set_shared_cache_image (plcrash_async_objc_cache_t *context, plcrash_async_macho_t *libobjc);
 pl_vm_address_t plcrash_async_objc_isa_pointer (pl_vm_address_t isa);
 
 /**
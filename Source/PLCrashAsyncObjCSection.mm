@@ -49,6 +49,11 @@ static const char * const kClassListSectionName = "__objc_classlist";
 static const char * const kCategoryListSectionName = "__objc_catlist";
 static const char * const kObjCConstSectionName = "__objc_const";
 static const char * const kObjCDataSectionName = "__objc_data";
+static const char * const kTextSegmentName = "__TEXT";
+static const char * const kObjCMethNameSectionName = "__objc_methname";
+static const char * const kObjCClassNameSectionName = "__objc_classname";
+static const char * const kObjCSelRefsSectionName = "__objc_selrefs";
+static const char * const kObjCOptSectionName = "__objc_opt_ro";
 
 static uint32_t CLS_NO_METHOD_ARRAY = 0x4000;
 static uint32_t END_OF_METHODS_LIST = -1;
@@ -259,33 +264,88 @@ struct pl_objc2_method_64 {
     uint64_t imp;
 };
 
+/* Relative ("small") method list entry. Each field is a signed offset from the field's own address. */
+struct pl_objc2_method_relative {
+    int32_t name;
+    int32_t types;
+    int32_t imp;
+};
+
 struct pl_objc2_list_header {
     uint32_t entsize;
     uint32_t count;
 };
 
+/** Method list entsize flag bits; the remaining bits are the entry size. */
+static const uint32_t METHOD_LIST_FLAG_MASK = 0xffff0003;
+
+/** Method list entsize flag marking a relative method list. */
+static const uint32_t METHOD_LIST_SMALL_FLAG = 0x80000000;
+
+/* The leading fields of the shared cache's ObjC optimization header (objc_opt_t), versions 13 through 16. */
+struct pl_objc_opt_header {
+    uint32_t version;
+    uint32_t flags;
+    int32_t selopt_offset;
+    int32_t headeropt_ro_offset;
+    int32_t clsopt_offset;
+};
+
+/* The shared cache's read-only image header table (objc_headeropt_ro_t). Each entry is a header_info record, consisting
+ * of pointer-sized offsets to the image's Mach-O header and ObjC image info; the entries are sorted by header address. */
+struct pl_objc_opt_headers {
+    uint32_t count;
+    uint32_t entsize;
+};
+
+/** The oldest supported ObjC optimization header version; earlier versions used pointer-based header records. */
+static const uint32_t OBJC_OPT_MIN_VERSION = 13;
+
+/** The newest supported ObjC optimization header version. */
+static const uint32_t OBJC_OPT_MAX_VERSION = 16;
+
+
+/**
+ * @internal
+ * The minimum class cache size, in entries.
+ */
+#define PLCRASH_ASYNC_OBJC_CLASS_CACHE_MIN_SIZE 1024
 
 /**
- * Get the index into the context's cache for the given key. Must only be called
+ * @internal
+ * The maximum class cache size, in entries. This bounds the cache at 16MB on 64-bit targets.
+ */
+#define PLCRASH_ASYNC_OBJC_CLASS_CACHE_MAX_SIZE (1024 * 1024)
+
+/**
+ * Get the initial probe index into the context's cache for the given key. Must only be called
  * if the cache size has been set.
  *
- * @param context The context.
+ * Class data pointers are aligned and clustered within a few pages, so the low bits carry little
+ * entropy; the key is mixed with the 64-bit MurmurHash3 finalizer before masking.
+ *
+ * @param size The cache size; must be a power of two.
  * @param key The key.
  * @return The index.
  */
-static size_t cache_index (plcrash_async_objc_cache_t *context, pl_vm_address_t key) {
-    return (key >> 2) % context->classCacheSize;
+static size_t cache_index (size_t size, pl_vm_address_t key) {
+    uint64_t h = key;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return (size_t) h & (size - 1);
 }
 
 /**
- * Get the context's cache's total memory allocation size, including both keys and values.
+ * Get the total memory allocation size of a cache with @a size entries, including both keys and values.
  *
- * @param context The context.
- * @return The total number of bytes allocated for the cache.
+ * @param size The cache size, in entries.
+ * @return The total number of bytes required for the cache.
  */
-static size_t cache_allocation_size (plcrash_async_objc_cache_t *context) {
-    size_t size = context->classCacheSize;
-    return size * sizeof(*context->classCacheKeys) + size * sizeof(*context->classCacheValues);
+static size_t cache_allocation_size (size_t size) {
+    return size * sizeof(pl_vm_address_t) * 2;
 }
 
 /**
@@ -296,51 +356,130 @@ static size_t cache_allocation_size (plcrash_async_objc_cache_t *context) {
  * @return The value stored in the cache for that key, or 0 if none was found.
  */
 static pl_vm_address_t cache_lookup (plcrash_async_objc_cache_t *context, pl_vm_address_t key) {
-    if (context->classCacheSize > 0) {
-        size_t index = cache_index(context, key);
-        if (context->classCacheKeys[index] == key) {
-            return context->classCacheValues[index];
+    if (context->classCacheSize > 0 && key != 0) {
+        size_t mask = context->classCacheSize - 1;
+        size_t index = cache_index(context->classCacheSize, key);
+
+        /* Linear probe until the key or an empty slot is found */
+        for (size_t probe = 0; probe < context->classCacheSize; probe++) {
+            pl_vm_address_t found = context->classCacheKeys[index];
+            if (found == key) {
+#ifndef PLCF_RELEASE_BUILD
+                context->classCacheHits++;
+#endif
+                return context->classCacheValues[index];
+            }
+
+            if (found == 0)
+                break;
+
+            index = (index + 1) & mask;
         }
     }
+
+#ifndef PLCF_RELEASE_BUILD
+    context->classCacheMisses++;
+#endif
     return 0;
 }
 
+/**
+ * Insert a key/value pair into the cache's tables without checking its load factor.
+ *
+ * @param keys The key table.
+ * @param values The value table.
+ * @param size The table size, in entries; must be a power of two.
+ * @param key The key to store. Must not be 0.
+ * @param value The value to store.
+ * @return Returns true if a new entry was added, or false if the key was already present or the table was full.
+ */
+static bool cache_insert (pl_vm_address_t *keys, pl_vm_address_t *values, size_t size, pl_vm_address_t key, pl_vm_address_t value) {
+    size_t mask = size - 1;
+    size_t index = cache_index(size, key);
+
+    for (size_t probe = 0; probe < size; probe++) {
+        if (keys[index] == key)
+            return false;
+
+        if (keys[index] == 0) {
+            keys[index] = key;
+            values[index] = value;
+            return true;
+        }
+
+        index = (index + 1) & mask;
+    }
+
+    return false;
+}
+
+/**
+ * Ensure that the cache can hold at least @a count entries at a load factor of no more than one half,
+ * allocating or growing the cache as required. Existing entries are rehashed into the new tables.
+ *
+ * @param context The context.
+ * @param count The number of entries to be reserved.
+ * @return Returns true if the cache has been allocated, or false if no cache is available. If growing the
+ * cache fails, the existing cache will be retained.
+ */
+static bool cache_reserve (plcrash_async_objc_cache_t *context, size_t count) {
+    size_t size = PLCRASH_ASYNC_OBJC_CLASS_CACHE_MIN_SIZE;
+    while (size < count * 2 && size < PLCRASH_ASYNC_OBJC_CLASS_CACHE_MAX_SIZE)
+        size *= 2;
+
+    if (size <= context->classCacheSize)
+        return true;
+
+    vm_address_t addr;
+    kern_return_t err = plcrash_async_scratch_allocate(&addr, cache_allocation_size(size));
+    /* If it fails, just bail out. We don't need the cache for correct operation. */
+    if (err != KERN_SUCCESS) {
+        PLCF_DEBUG("plcrash_async_scratch_allocate failed with error %x, the class cache could not be resized and ObjC parsing will be substantially slower", err);
+        return context->classCacheSize > 0;
+    }
+
+    pl_vm_address_t *keys = (pl_vm_address_t *) addr;
+    pl_vm_address_t *values = keys + size;
+
+    /* Rehash the existing entries; scratch allocations are zero-filled. */
+    size_t live = 0;
+    for (size_t i = 0; i < context->classCacheSize; i++) {
+        if (context->classCacheKeys[i] != 0 && cache_insert(keys, values, size, context->classCacheKeys[i], context->classCacheValues[i]))
+            live++;
+    }
+
+    if (context->classCacheKeys != NULL)
+        plcrash_async_scratch_deallocate((vm_address_t) context->classCacheKeys, cache_allocation_size(context->classCacheSize));
+
+    context->classCacheKeys = keys;
+    context->classCacheValues = values;
+    context->classCacheSize = size;
+    context->classCacheCount = live;
+    return true;
+}
+
 /**
  * Store a key/value pair in the cache. The cache is not guaranteed storage so storing may
- * silently fail, and the association can be evicted at any time. It's a CACHE.
+ * silently fail. If the key is already present, the existing entry wins.
  *
  * @param context The context.
  * @param key The key to store.
  * @param value The value to store.
  */
 static void cache_set (plcrash_async_objc_cache_t *context, pl_vm_address_t key, pl_vm_address_t value) {
-    /* If nothing has used the cache yet, allocate the memory. */
-    if (context->classCacheKeys == NULL) {
-        size_t size = 1024;
-        context->classCacheSize = size;
-        
-        size_t allocationSize = cache_allocation_size(context);
-        
-        vm_address_t addr;
-        kern_return_t err = vm_allocate(mach_task_self_, &addr, allocationSize, VM_FLAGS_ANYWHERE);
-        /* If it fails, just bail out. We don't need the cache for correct operation. */
-        if (err != KERN_SUCCESS) {
-            PLCF_DEBUG("vm_allocate failed with error %x, the class cache could not be initialized and ObjC parsing will be substantially slower", err);
-            context->classCacheSize = 0;
-            return;
-        }
-        
-        context->classCacheKeys = (pl_vm_address_t *)addr;
-        context->classCacheValues = (pl_vm_address_t *)(context->classCacheKeys + size);
-    }
-    
-    /* Treat the cache as a simple hash table with no chaining whatsoever. If the bucket is already
-     * occupied, then don't do anything. The existing entry wins. */
-    size_t index = cache_index(context, key);
-    if (context->classCacheKeys[index] == 0) {
-        context->classCacheKeys[index] = key;
-        context->classCacheValues[index] = value;
-    }
+    if (key == 0)
+        return;
+
+    /* Allocate the cache on first use, and grow it if the load factor would exceed one half. */
+    if (!cache_reserve(context, context->classCacheCount + 1))
+        return;
+
+    /* If the cache could not be grown, stop inserting at a load factor of 3/4 to keep probe sequences short. */
+    if (context->classCacheCount >= context->classCacheSize / 4 * 3)
+        return;
+
+    if (cache_insert(context->classCacheKeys, context->classCacheValues, context->classCacheSize, key, value))
+        context->classCacheCount++;
 }
 
 /**
@@ -365,6 +504,83 @@ static void free_mapped_sections (plcrash_async_objc_cache_t *context) {
         plcrash_async_mobject_free(&context->objcDataMobj);
         context->objcDataMobjInitialized = false;
     }
+    if (context->methNameMobjInitialized) {
+        plcrash_async_mobject_free(&context->methNameMobj);
+        context->methNameMobjInitialized = false;
+    }
+    if (context->classNameMobjInitialized) {
+        plcrash_async_mobject_free(&context->classNameMobj);
+        context->classNameMobjInitialized = false;
+    }
+    if (context->selRefsMobjInitialized) {
+        plcrash_async_mobject_free(&context->selRefsMobj);
+        context->selRefsMobjInitialized = false;
+    }
+}
+
+/**
+ * Look up @a image in the shared cache's ObjC image header table.
+ *
+ * @param context The ObjC context, which must have been configured via plcrash_async_objc_cache_set_shared_cache_image().
+ * @param image The shared cache image to look up.
+ * @return Returns true if the image is listed in the table, and thus may carry ObjC metadata.
+ */
+static bool objc_opt_contains_image (plcrash_async_objc_cache_t *context, plcrash_async_macho_t *image) {
+    size_t ptrsize = context->objcOptM64 ? sizeof(uint64_t) : sizeof(uint32_t);
+    size_t entsize = ptrsize * 2;
+
+    /* Binary search the header addresses; each entry's header offset is relative to the entry itself. */
+    uint32_t lower = 0;
+    uint32_t upper = context->objcOptHeaderCount;
+    while (lower < upper) {
+        uint32_t mid = lower + (upper - lower) / 2;
+        pl_vm_address_t entry = context->objcOptHeadersAddress + (pl_vm_address_t) entsize * mid;
+        pl_vm_address_t header;
+
+        if (context->objcOptM64) {
+            uint64_t offset;
+            if (plcrash_async_mobject_read_uint64(&context->objcOptMobj, context->objcOptByteOrder, entry, 0, &offset) != PLCRASH_ESUCCESS)
+                return true;
+            header = entry + (int64_t) offset;
+        } else {
+            uint32_t offset;
+            if (plcrash_async_mobject_read_uint32(&context->objcOptMobj, context->objcOptByteOrder, entry, 0, &offset) != PLCRASH_ESUCCESS)
+                return true;
+            header = entry + (int32_t) offset;
+        }
+
+        if (header == image->header_addr)
+            return true;
+        else if (header < image->header_addr)
+            lower = mid + 1;
+        else
+            upper = mid;
+    }
+
+    return false;
+}
+
+/**
+ * Initialize a string object for an ObjC class or method name. If the address falls within the image's mapped
+ * __objc_methname or __objc_classname section, the string contents will be borrowed from that mapping.
+ *
+ * @param image The MachO image containing the string.
+ * @param context The ObjC context.
+ * @param string The string object to initialize.
+ * @param address The address of the string.
+ * @return An error code.
+ */
+static plcrash_error_t objc_string_init (plcrash_async_macho_t *image, plcrash_async_objc_cache_t *context, plcrash_async_macho_string_t *string, pl_vm_address_t address) {
+    plcrash_async_mobject_t *backing = NULL;
+
+    if (context != NULL && context->lastImage == image) {
+        if (context->methNameMobjInitialized && address - context->methNameMobj.task_address < context->methNameMobj.length)
+            backing = &context->methNameMobj;
+        else if (context->classNameMobjInitialized && address - context->classNameMobj.task_address < context->classNameMobj.length)
+            backing = &context->classNameMobj;
+    }
+
+    return plcrash_async_macho_string_init_borrowed(string, image, address, backing);
 }
 
 /**
@@ -388,7 +604,7 @@ static plcrash_error_t map_sections (plcrash_async_macho_t *image, plcrash_async
     plcrash_error_t err;
     
     /* Map in the __objc_const section, which is where all the read-only class data lives. */
-    err = plcrash_async_macho_map_section(image, kDataSegmentName, kObjCConstSectionName, &context->objcConstMobj);
+    err = plcrash_async_macho_pool_map_section(context->mappingPool, image, kDataSegmentName, kObjCConstSectionName, &context->objcConstMobj);
     if (err != PLCRASH_ESUCCESS) {
         if (err != PLCRASH_ENOTFOUND)
             PLCF_DEBUG("pl_async_macho_map_section(%p, %s, %s, %p) failure %d", image, kDataSegmentName, kObjCConstSectionName, &context->objcConstMobj, err);
@@ -397,7 +613,7 @@ static plcrash_error_t map_sections (plcrash_async_macho_t *image, plcrash_async
     context->objcConstMobjInitialized = true;
     
     /* Map in the class list section.  */
-    err = plcrash_async_macho_map_section(image, kDataSegmentName, kClassListSectionName, &context->classMobj);
+    err = plcrash_async_macho_pool_map_section(context->mappingPool, image, kDataSegmentName, kClassListSectionName, &context->classMobj);
     if (err != PLCRASH_ESUCCESS) {
         if (err != PLCRASH_ENOTFOUND)
             PLCF_DEBUG("pl_async_macho_map_section(%s, %s, %s, %p) failure %d", image->name, kDataSegmentName, kClassListSectionName, &context->classMobj, err);
@@ -406,7 +622,7 @@ static plcrash_error_t map_sections (plcrash_async_macho_t *image, plcrash_async
     context->classMobjInitialized = true;
     
     /* Map in the category list section.  */
-    err = plcrash_async_macho_map_section(image, kDataSegmentName, kCategoryListSectionName, &context->catMobj);
+    err = plcrash_async_macho_pool_map_section(context->mappingPool, image, kDataSegmentName, kCategoryListSectionName, &context->catMobj);
     if (err != PLCRASH_ESUCCESS) {
         if (err != PLCRASH_ENOTFOUND)
             PLCF_DEBUG("pl_async_macho_map_section(%s, %s, %s, %p) failure %d", image->name, kDataSegmentName, kCategoryListSectionName, &context->catMobj, err);
@@ -415,14 +631,31 @@ static plcrash_error_t map_sections (plcrash_async_macho_t *image, plcrash_async
     context->catMobjInitialized = true;
     
     /* Map in the __objc_data section, which is where the actual classes live. */
-    err = plcrash_async_macho_map_section(image, kDataSegmentName, kObjCDataSectionName, &context->objcDataMobj);
+    err = plcrash_async_macho_pool_map_section(context->mappingPool, image, kDataSegmentName, kObjCDataSectionName, &context->objcDataMobj);
     if (err != PLCRASH_ESUCCESS) {
         /* If the class list was found, the data section must also be found */
         PLCF_DEBUG("pl_async_macho_map_section(%s, %s, %s, %p) failure %d", image->name, kDataSegmentName, kObjCDataSectionName, &context->objcDataMobj, err);
         goto cleanup;
     }
     context->objcDataMobjInitialized = true;
+
+    /* Map in the method and class name sections, from which name strings are borrowed. These are optional; if
+     * unavailable, names are mapped individually. */
+    if (plcrash_async_macho_pool_map_section(context->mappingPool, image, kTextSegmentName, kObjCMethNameSectionName, &context->methNameMobj) == PLCRASH_ESUCCESS)
+        context->methNameMobjInitialized = true;
+
+    if (plcrash_async_macho_pool_map_section(context->mappingPool, image, kTextSegmentName, kObjCClassNameSectionName, &context->classNameMobj) == PLCRASH_ESUCCESS)
+        context->classNameMobjInitialized = true;
+
+    /* Map in the selector references, through which relative method lists name their selectors. Optional; if
+     * unavailable, references are read individually. */
+    if (plcrash_async_macho_pool_map_section(context->mappingPool, image, kDataSegmentName, kObjCSelRefsSectionName, &context->selRefsMobj) == PLCRASH_ESUCCESS)
+        context->selRefsMobjInitialized = true;
     
+    /* Size the class cache for the image's classes, metaclasses, and categories. */
+    cache_reserve(context, (context->classMobj.length / (plcrash_async_macho_m64(image) ? sizeof(uint64_t) : sizeof(uint32_t))) * 2 +
+                           (context->catMobj.length / (plcrash_async_macho_m64(image) ? sizeof(uint64_t) : sizeof(uint32_t))));
+
     /* Only after all mappings succeed do we set the image. If any failed, the image won't be set,
      * and any mappings that DO succeed will be cleaned up on the next call (or when freeing the
      * context. */
@@ -436,7 +669,7 @@ static plcrash_error_t pl_async_parse_obj1_class(plcrash_async_macho_t *image, s
     plcrash_error_t err;
     
     /* Get the class's name. */
-    pl_vm_address_t namePtr = image->byteorder->swap32(cls->name);
+    pl_vm_address_t namePtr = plcrash_async_swap32(image->byteorder, cls->name);
     bool classNameInitialized = false;
     plcrash_async_macho_string_t className;
     err = plcrash_async_macho_string_init(&className, image, namePtr);
@@ -450,12 +683,12 @@ static plcrash_error_t pl_async_parse_obj1_class(plcrash_async_macho_t *image, s
      * a single method_list structure, OR a pointer to an array
      * of pointers to method_list structures, depending on the
      * flag in the .info field. Argh. */
-    pl_vm_address_t methodListPtr = image->byteorder->swap32(cls->methods);
+    pl_vm_address_t methodListPtr = plcrash_async_swap32(image->byteorder, cls->methods);
     
     /* If CLS_NO_METHOD_ARRAY is set, then methodListPtr points to
      * one method_list. If it's not set, then it points to an
      * array of pointers to method lists. */
-    bool hasMultipleMethodLists = (image->byteorder->swap32(cls->info) & CLS_NO_METHOD_ARRAY) == 0;
+    bool hasMultipleMethodLists = (plcrash_async_swap32(image->byteorder, cls->info) & CLS_NO_METHOD_ARRAY) == 0;
     pl_vm_address_t methodListCursor = methodListPtr;
     
     while (true) {
@@ -473,7 +706,7 @@ static plcrash_error_t pl_async_parse_obj1_class(plcrash_async_macho_t *image, s
                 goto cleanup;
             }
             
-            thisListPtr = image->byteorder->swap32(ptr);
+            thisListPtr = plcrash_async_swap32(image->byteorder, ptr);
             /* The end of the list is indicated with NULL or
              * END_OF_METHODS_LIST (the ObjC runtime source checks both). */
             if (thisListPtr == 0 || thisListPtr == END_OF_METHODS_LIST)
@@ -499,7 +732,7 @@ static plcrash_error_t pl_async_parse_obj1_class(plcrash_async_macho_t *image, s
         }
         
         /* Find out how many methods are in the list, and iterate. */
-        uint32_t count = image->byteorder->swap32(methodList.count);
+        uint32_t count = plcrash_async_swap32(image->byteorder, methodList.count);
         for (uint32_t i = 0; i < count; i++) {
             /* Method structures are laid out directly following the
              * method_list structure. */
@@ -512,7 +745,7 @@ static plcrash_error_t pl_async_parse_obj1_class(plcrash_async_macho_t *image, s
             }
             
             /* Load the method name from the .name field pointer. */
-            pl_vm_address_t methodNamePtr = image->byteorder->swap32(method.name);
+            pl_vm_address_t methodNamePtr = plcrash_async_swap32(image->byteorder, method.name);
             plcrash_async_macho_string_t methodName;
             err = plcrash_async_macho_string_init(&methodName, image, methodNamePtr);
             if (err != PLCRASH_ESUCCESS) {
@@ -521,7 +754,7 @@ static plcrash_error_t pl_async_parse_obj1_class(plcrash_async_macho_t *image, s
             }
             
             /* Grab the method's IMP as well. */
-            pl_vm_address_t imp = image->byteorder->swap32(method.imp);
+            pl_vm_address_t imp = plcrash_async_swap32(image->byteorder, method.imp);
             
             /* Callback! */
             callback(isMetaClass, &className, &methodName, imp, ctx);
@@ -583,7 +816,7 @@ static plcrash_error_t pl_async_objc_parse_from_module_info (plcrash_async_macho
     /* Read successive module structs from the section until we run out of data. */
     for (unsigned moduleIndex = 0; moduleIndex < moduleMobj.length / sizeof(*moduleData); moduleIndex++) {
         /* Grab the pointer to the symtab for this module struct. */
-        pl_vm_address_t symtabPtr = image->byteorder->swap32(moduleData[moduleIndex].symtab);
+        pl_vm_address_t symtabPtr = plcrash_async_swap32(image->byteorder, moduleData[moduleIndex].symtab);
         if (symtabPtr == 0)
             continue;
         
@@ -596,7 +829,7 @@ static plcrash_error_t pl_async_objc_parse_from_module_info (plcrash_async_macho
         }
         
         /* Iterate over the classes in the symtab. */
-        uint16_t classCount = image->byteorder->swap16(symtab.cls_def_count);
+        uint16_t classCount = plcrash_async_swap16(image->byteorder, symtab.cls_def_count);
         for (unsigned i = 0; i < classCount; i++) {
             /* Classes are indicated by pointers laid out sequentially after the
              * symtab structure. */
@@ -607,7 +840,7 @@ static plcrash_error_t pl_async_objc_parse_from_module_info (plcrash_async_macho
                 PLCF_DEBUG("plcrash_async_task_memcpy at 0x%llx error %d", (long long)cursor, err);
                 goto cleanup;
             }
-            classPtr = image->byteorder->swap32(classPtr);
+            classPtr = plcrash_async_swap32(image->byteorder, classPtr);
             
             /* Read a class structure from the class pointer. */
             struct pl_objc1_class cls;
@@ -648,10 +881,48 @@ cleanup:
     return err;
 }
 
+/**
+ * Read the selector reference at @a address, returning the referenced selector name address in @a result.
+ *
+ * @param image The image to read from.
+ * @param objc_cache The Objective-C cache object.
+ * @param address The address of the selector reference.
+ * @param[out] result On success, the address of the selector name.
+ * @return Returns PLCRASH_ESUCCESS on success, or an appropriate error on failure.
+ */
+static plcrash_error_t pl_async_objc_read_selref (plcrash_async_macho_t *image, plcrash_async_objc_cache_t *objc_cache, pl_vm_address_t address, pl_vm_address_t *result) {
+    plcrash_error_t err;
+
+    /* Prefer the mapped __objc_selrefs section; fall back on reading the reference directly */
+    if (plcrash_async_macho_m64(image)) {
+        uint64_t selref;
+        if (objc_cache->selRefsMobjInitialized && address - objc_cache->selRefsMobj.task_address < objc_cache->selRefsMobj.length)
+            err = plcrash_async_mobject_read_uint64(&objc_cache->selRefsMobj, image->byteorder, address, 0, &selref);
+        else
+            err = plcrash_async_task_read_uint64(image->task, image->byteorder, address, 0, &selref);
+
+        *result = (pl_vm_address_t) selref;
+    } else {
+        uint32_t selref;
+        if (objc_cache->selRefsMobjInitialized && address - objc_cache->selRefsMobj.task_address < objc_cache->selRefsMobj.length)
+            err = plcrash_async_mobject_read_uint32(&objc_cache->selRefsMobj, image->byteorder, address, 0, &selref);
+        else
+            err = plcrash_async_task_read_uint32(image->task, image->byteorder, address, 0, &selref);
+
+        *result = selref;
+    }
+
+    return err;
+}
+
 /**
  * Parse an ObjC 2.0 method_list_t structure at @a method_list_addr and call @a callback with all
  * parsed methods.
  *
+ * Both pointer-based method lists and the relative method lists emitted since iOS 14 and macOS 11 are
+ * supported. Relative method list entries are three signed 32-bit offsets from the address of each field; the name
+ * offset targets a selector reference, or -- within the shared cache -- the selector name itself.
+ *
  * @param image The image to read from.
  * @param objc_cache The Objective-C cache object.
  * @param class_name The name of the class being parsed.
@@ -679,9 +950,23 @@ static plcrash_error_t pl_async_objc_parse_objc2_method_list (plcrash_async_mach
         return PLCRASH_EINVALID_DATA;
     }
     
-    /* Extract the entry size and count from the list header. */
-    uint32_t entsize = image->byteorder->swap32(header->entsize) & ~(uint32_t)3;
-    uint32_t count = image->byteorder->swap32(header->count);
+    /* Extract the entry size, flags, and count from the list header. */
+    uint32_t entsize_flags = plcrash_async_swap32(image->byteorder, header->entsize);
+    uint32_t entsize = entsize_flags & ~METHOD_LIST_FLAG_MASK;
+    uint32_t count = plcrash_async_swap32(image->byteorder, header->count);
+    bool relative = (entsize_flags & METHOD_LIST_SMALL_FLAG) != 0;
+
+    /* Validate the entry size against the expected method structure */
+    size_t method_size;
+    if (relative)
+        method_size = sizeof(struct pl_objc2_method_relative);
+    else
+        method_size = plcrash_async_macho_m64(image) ? sizeof(struct pl_objc2_method_64) : sizeof(struct pl_objc2_method_32);
+
+    if (entsize < method_size) {
+        PLCF_DEBUG("Method list at 0x%llx has invalid entry size %u", (long long) method_list_addr, (unsigned int) entsize);
+        return PLCRASH_EINVALID_DATA;
+    }
     
     /* Compute the method list start position and length. */
     pl_vm_address_t method_list_start = method_list_addr + sizeof(*header);
@@ -696,28 +981,51 @@ static plcrash_error_t pl_async_objc_parse_objc2_method_list (plcrash_async_mach
     /* Extract methods from the list. */
     for (uint32_t i = 0; i < count; i++) {
         plcrash_error_t err;
-
-        /* Read an architecture-appropriate method structure from the
-         * current cursor. */
-        const struct pl_objc2_method_32 *method_32 = (const struct pl_objc2_method_32 *)cursor;
-        const struct pl_objc2_method_64 *method_64 = (const struct pl_objc2_method_64 *)cursor;
-        
-        /* Extract the method name pointer. */
-        pl_vm_address_t methodNamePtr = (image->m64
-                                         ? image->byteorder->swap64(method_64->name)
-                                         : image->byteorder->swap32(method_32->name));
+        pl_vm_address_t methodNamePtr;
+        pl_vm_address_t imp;
+
+        if (relative) {
+            /* Resolve each field's offset against the field's own address in the target. */
+            const struct pl_objc2_method_relative *method_rel = (const struct pl_objc2_method_relative *)cursor;
+            pl_vm_address_t entry_addr = method_list_start + (pl_vm_address_t)entsize * i;
+
+            int32_t nameOffset = (int32_t) plcrash_async_swap32(image->byteorder, (uint32_t) method_rel->name);
+            int32_t impOffset = (int32_t) plcrash_async_swap32(image->byteorder, (uint32_t) method_rel->imp);
+
+            pl_vm_address_t nameTarget = entry_addr + offsetof(struct pl_objc2_method_relative, name) + (int64_t) nameOffset;
+            imp = entry_addr + offsetof(struct pl_objc2_method_relative, imp) + (int64_t) impOffset;
+
+            /* Shared cache method lists reference selector names directly; all others indirect through
+             * a selector reference. */
+            if (plcrash_async_macho_in_shared_cache(image)) {
+                methodNamePtr = nameTarget;
+            } else if ((err = pl_async_objc_read_selref(image, objc_cache, nameTarget, &methodNamePtr)) != PLCRASH_ESUCCESS) {
+                PLCF_DEBUG("Failed to read selector reference at 0x%llx: %d", (long long) nameTarget, err);
+                return err;
+            }
+        } else {
+            /* Read an architecture-appropriate method structure from the
+             * current cursor. */
+            const struct pl_objc2_method_32 *method_32 = (const struct pl_objc2_method_32 *)cursor;
+            const struct pl_objc2_method_64 *method_64 = (const struct pl_objc2_method_64 *)cursor;
+            
+            /* Extract the method name pointer. */
+            methodNamePtr = (plcrash_async_macho_m64(image)
+                             ? plcrash_async_swap64(image->byteorder, method_64->name)
+                             : plcrash_async_swap32(image->byteorder, method_32->name));
+
+            /* Extract the method IMP. */
+            imp = (plcrash_async_macho_m64(image)
+                   ? plcrash_async_swap64(image->byteorder, method_64->imp)
+                   : plcrash_async_swap32(image->byteorder, method_32->imp));
+        }
         
         /* Read the method name. */
         plcrash_async_macho_string_t method_name;
-        if ((err = plcrash_async_macho_string_init(&method_name, image, methodNamePtr)) != PLCRASH_ESUCCESS) {
+        if ((err = objc_string_init(image, objc_cache, &method_name, methodNamePtr)) != PLCRASH_ESUCCESS) {
             PLCF_DEBUG("plcrash_async_macho_string_init at 0x%llx error %d", (long long)methodNamePtr, err);
             return err;
         }
-    
-        /* Extract the method IMP. */
-        pl_vm_address_t imp = (image->m64
-                               ? image->byteorder->swap64(method_64->imp)
-                               : image->byteorder->swap32(method_32->imp));
         
         /* Call the callback. */
         callback(is_meta_class, class_name, &method_name, imp, ctx);
@@ -742,6 +1050,7 @@ static plcrash_error_t pl_async_objc_parse_objc2_method_list (plcrash_async_mach
  * the returned value via plcrash_async_macho_string_free(). If the function returns an error, no class_name value
  * will be provided and the caller is not responsible for freeing any associated resources.
  * @param[out] cls_data_ro A buffer to which the class_ro data will be written. Must be at least sizeof(class_ro_t).
+ * @param prefetched_rw The class's class_rw data, if already fetched by the caller, or NULL.
  *
  * @tparam class_t The class type, one of pl_objc2_class_32 or pl_objc2_class_64.
  * @tparam class_ro_t The read-only class type, one of pl_objc2_class_data_ro_32 or pl_objc2_class_data_ro_64.
@@ -751,7 +1060,7 @@ static plcrash_error_t pl_async_objc_parse_objc2_method_list (plcrash_async_mach
  * the input format is invalid (including failed pointer dereferencing), or another appropriate error.
  */
 template<typename class_t, typename class_ro_t, typename class_rw_t>
-static plcrash_error_t pl_async_objc_parse_objc2_class (plcrash_async_macho_t *image, plcrash_async_objc_cache_t *objc_cache, class_t *cls, plcrash_async_macho_string_t *class_name, class_ro_t *cls_data_ro) {
+static plcrash_error_t pl_async_objc_parse_objc2_class (plcrash_async_macho_t *image, plcrash_async_objc_cache_t *objc_cache, class_t *cls, plcrash_async_macho_string_t *class_name, class_ro_t *cls_data_ro, const class_rw_t *prefetched_rw) {
     plcrash_error_t err;
     
     /* Grab the class's data_rw pointer. This needs masking because it also
@@ -763,10 +1072,13 @@ static plcrash_error_t pl_async_objc_parse_objc2_class (plcrash_async_macho_t *i
     pl_vm_address_t cached_data_ro_addr = cache_lookup(objc_cache, data_ptr);
     if (cached_data_ro_addr == 0) {
         class_rw_t cls_data_rw;
+
+        objc_cache->classParseCount++;
         
-        /* Read the class_rw structure. */
-        err = plcrash_async_task_memcpy(image->task, data_ptr, 0, &cls_data_rw, sizeof(cls_data_rw));
-        if (err != PLCRASH_ESUCCESS) {
+        /* Read the class_rw structure, if not already fetched by our caller. */
+        if (prefetched_rw != NULL) {
+            cls_data_rw = *prefetched_rw;
+        } else if ((err = plcrash_async_task_memcpy(image->task, data_ptr, 0, &cls_data_rw, sizeof(cls_data_rw))) != PLCRASH_ESUCCESS) {
             PLCF_DEBUG("plcrash_async_task_memcpy at 0x%llx error %d", (long long)data_ptr, err);
             return PLCRASH_EINVALID_DATA;
         }
@@ -818,7 +1130,7 @@ static plcrash_error_t pl_async_objc_parse_objc2_class (plcrash_async_macho_t *i
     
     /* Fetch the pointer to the class name, and make the string. */
     pl_vm_address_t class_name_ptr = image->byteorder->swap(cls_data_ro->name);
-    err = plcrash_async_macho_string_init(class_name, image, class_name_ptr);
+    err = objc_string_init(image, objc_cache, class_name, class_name_ptr);
     if (err != PLCRASH_ESUCCESS) {
         PLCF_DEBUG("plcrash_async_macho_string_init at 0x%llx error %d", (long long)class_name_ptr, err);
         return PLCRASH_EINVALID_DATA;
@@ -834,6 +1146,7 @@ static plcrash_error_t pl_async_objc_parse_objc2_class (plcrash_async_macho_t *i
  * @param objc_cache The Objective-C cache object.
  * @param cls A pointer to the class structure to be parsed
  * @param is_meta_class true if this is a metaclass.
+ * @param prefetched_rw The class's class_rw data, if already fetched by the caller, or NULL.
  * @param callback The callback to invoke for each method found.
  * @param ctx A context pointer to pass to the callback.
  *
@@ -844,13 +1157,13 @@ static plcrash_error_t pl_async_objc_parse_objc2_class (plcrash_async_macho_t *i
  * @return An error code.
  */
 template<typename class_t, typename class_ro_t, typename class_rw_t>
-static plcrash_error_t pl_async_objc_parse_objc2_class_methods (plcrash_async_macho_t *image, plcrash_async_objc_cache_t *objc_cache, class_t *cls, bool is_meta_class, plcrash_async_objc_found_method_cb callback, void *ctx) {
+static plcrash_error_t pl_async_objc_parse_objc2_class_methods (plcrash_async_macho_t *image, plcrash_async_objc_cache_t *objc_cache, class_t *cls, bool is_meta_class, const class_rw_t *prefetched_rw, plcrash_async_objc_found_method_cb callback, void *ctx) {
     plcrash_async_macho_string_t class_name;
     class_ro_t cls_data_ro;
     plcrash_error_t err;
     
     /* Parse the class */
-    if ((err = pl_async_objc_parse_objc2_class<class_t, class_ro_t, class_rw_t>(image, objc_cache, cls, &class_name, &cls_data_ro)) != PLCRASH_ESUCCESS)
+    if ((err = pl_async_objc_parse_objc2_class<class_t, class_ro_t, class_rw_t>(image, objc_cache, cls, &class_name, &cls_data_ro, prefetched_rw)) != PLCRASH_ESUCCESS)
         return err;
 
     /* Fetch and parse the method list. */
@@ -905,7 +1218,7 @@ static plcrash_error_t pl_async_objc_parse_objc2_category_methods (plcrash_async
         classPtr = &class_data;
     }
     
-    if ((err = pl_async_objc_parse_objc2_class<class_t, class_ro_t, class_rw_t>(image, objc_cache, classPtr, &class_name, &cls_data_ro)) != PLCRASH_ESUCCESS)
+    if ((err = pl_async_objc_parse_objc2_class<class_t, class_ro_t, class_rw_t>(image, objc_cache, classPtr, &class_name, &cls_data_ro, NULL)) != PLCRASH_ESUCCESS)
         return err;
     
     /* Fetch and parse the instance and class method lists. The method list will be NULL if no methods are defined for the category; in that case, we simply skip the category. */
@@ -977,9 +1290,35 @@ static plcrash_error_t pl_async_objc_parse_from_data_section (plcrash_async_mach
             PLCF_DEBUG("plcrash_async_mobject_remap_address in objcDataMobj for pointer %llx returned NULL", (long long)ptr);
             return PLCRASH_EINVALID_DATA;
         }
-        
+
+        /* Look up the architecture-appropriate class structure for the metaclass. */
+        pl_vm_address_t isa = plcrash_async_objc_isa_pointer(image->byteorder->swap(classPtr->isa));
+        class_t *metaclass = (class_t *) plcrash_async_mobject_remap_address(&objcContext->objcDataMobj, isa, 0, sizeof(*metaclass));
+
+        /* If neither the class nor the metaclass has been parsed previously, fetch both class_rw structures
+         * in a single batched read; they are generally allocated together by the runtime. */
+        class_rw_t rw_data[2];
+        const class_rw_t *class_rw = NULL;
+        const class_rw_t *metaclass_rw = NULL;
+        if (metaclass != NULL) {
+            pl_vm_address_t class_rw_ptr = image->byteorder->swap(classPtr->data_rw) & FAST_DATA_MASK;
+            pl_vm_address_t metaclass_rw_ptr = image->byteorder->swap(metaclass->data_rw) & FAST_DATA_MASK;
+
+            if (cache_lookup(objcContext, class_rw_ptr) == 0 && cache_lookup(objcContext, metaclass_rw_ptr) == 0) {
+                plcrash_async_task_read_t reads[2] = {
+                    { class_rw_ptr, sizeof(rw_data[0]), &rw_data[0] },
+                    { metaclass_rw_ptr, sizeof(rw_data[1]), &rw_data[1] }
+                };
+
+                if (plcrash_async_task_memcpy_batch(image->task, reads, 2) == PLCRASH_ESUCCESS) {
+                    class_rw = &rw_data[0];
+                    metaclass_rw = &rw_data[1];
+                }
+            }
+        }
+
         /* Parse the class. */
-        err = pl_async_objc_parse_objc2_class_methods<class_t, class_ro_t, class_rw_t>(image, objcContext, classPtr, false, callback, ctx);
+        err = pl_async_objc_parse_objc2_class_methods<class_t, class_ro_t, class_rw_t>(image, objcContext, classPtr, false, class_rw, callback, ctx);
         if (err != PLCRASH_ESUCCESS) {
             /* Skip unrealized classes; they'll never appear in a live backtrace. */
             if (err == PLCRASH_ENOTFOUND) {
@@ -992,16 +1331,14 @@ static plcrash_error_t pl_async_objc_parse_from_data_section (plcrash_async_mach
             return err;
         }
         
-        /* Read an architecture-appropriate class structure for the metaclass. */
-        pl_vm_address_t isa = plcrash_async_objc_isa_pointer(image->byteorder->swap(classPtr->isa));
-        class_t *metaclass = (class_t *) plcrash_async_mobject_remap_address(&objcContext->objcDataMobj, isa, 0, sizeof(*metaclass));
+        /* Verify the metaclass structure. */
         if (metaclass == NULL) {
             PLCF_DEBUG("plcrash_async_mobject_remap_address in objcDataMobj for pointer %llx returned NULL", (long long)isa);
             return PLCRASH_EINVALID_DATA;
         }
 
         /* Parse the metaclass. */
-        err = pl_async_objc_parse_objc2_class_methods<class_t, class_ro_t, class_rw_t>(image, objcContext, metaclass, true, callback, ctx);
+        err = pl_async_objc_parse_objc2_class_methods<class_t, class_ro_t, class_rw_t>(image, objcContext, metaclass, true, metaclass_rw, callback, ctx);
         if (err != PLCRASH_ESUCCESS) {
             PLCF_DEBUG("pl_async_objc_parse_objc2_class error %d while parsing metaclass", err);
             return err;
@@ -1046,6 +1383,211 @@ static plcrash_error_t pl_async_objc_parse_from_data_section (plcrash_async_mach
     return err;
 }
 
+static plcrash_error_t plcrash_async_objc_parse (plcrash_async_macho_t *image, plcrash_async_objc_cache_t *cache, plcrash_async_objc_found_method_cb callback, void *ctx);
+
+/**
+ * Release all resources associated with an IMP table, returning it to the unused state.
+ *
+ * @param table The table to be freed.
+ */
+static void imp_table_free (plcrash_async_objc_imp_table_t *table) {
+    if (table->entries != NULL)
+        plcrash_async_scratch_deallocate((vm_address_t) table->entries, table->allocation_size);
+
+    table->image = NULL;
+    table->status = PLCRASH_ESUCCESS;
+    table->entries = NULL;
+    table->count = 0;
+    table->allocation_size = 0;
+}
+
+/**
+ * Return true if @a lhs should be ordered before @a rhs; entries are ordered by IMP, and then by parse order.
+ */
+static bool imp_entry_less (const plcrash_async_objc_imp_entry_t *lhs, const plcrash_async_objc_imp_entry_t *rhs) {
+    if (lhs->imp != rhs->imp)
+        return lhs->imp < rhs->imp;
+    return lhs->order < rhs->order;
+}
+
+/**
+ * Restore the heap property for the subtree rooted at @a root.
+ */
+static void imp_entry_sift_down (plcrash_async_objc_imp_entry_t *entries, uint32_t root, uint32_t count) {
+    while (true) {
+        uint32_t child = root * 2 + 1;
+        if (child >= count)
+            return;
+
+        if (child + 1 < count && imp_entry_less(&entries[child], &entries[child + 1]))
+            child++;
+
+        if (!imp_entry_less(&entries[root], &entries[child]))
+            return;
+
+        plcrash_async_objc_imp_entry_t tmp = entries[root];
+        entries[root] = entries[child];
+        entries[child] = tmp;
+        root = child;
+    }
+}
+
+/**
+ * Sort @a entries in place by IMP and parse order. An in-place heapsort is used, as qsort() is not guaranteed to be
+ * async-safe.
+ */
+static void imp_entry_sort (plcrash_async_objc_imp_entry_t *entries, uint32_t count) {
+    if (count < 2)
+        return;
+
+    for (uint32_t i = count / 2; i > 0; i--)
+        imp_entry_sift_down(entries, i - 1, count);
+
+    for (uint32_t end = count - 1; end > 0; end--) {
+        plcrash_async_objc_imp_entry_t tmp = entries[0];
+        entries[0] = entries[end];
+        entries[end] = tmp;
+        imp_entry_sift_down(entries, 0, end);
+    }
+}
+
+/**
+ * Callback used to count the methods to be recorded in an IMP table. The context pointer is a pointer to a uint32_t
+ * count.
+ */
+static void imp_table_count_callback (bool isClassMethod, plcrash_async_macho_string_t *className, plcrash_async_macho_string_t *methodName, pl_vm_address_t imp, void *ctx) {
+    /* A zero IMP can never be matched; see plcrash_async_objc_find_method() */
+    if (imp != 0)
+        (*(uint32_t *) ctx)++;
+}
+
+struct imp_table_fill_context {
+    /** The table being populated. */
+    plcrash_async_objc_imp_table_t *table;
+
+    /** The number of entries allocated. */
+    uint32_t capacity;
+
+    /** The number of methods found, including any that did not fit within the allocated entries. */
+    uint32_t found;
+};
+
+/**
+ * Callback used to populate an IMP table. The context pointer is a pointer to an imp_table_fill_context.
+ */
+static void imp_table_fill_callback (bool isClassMethod, plcrash_async_macho_string_t *className, plcrash_async_macho_string_t *methodName, pl_vm_address_t imp, void *ctx) {
+    struct imp_table_fill_context *fill = (struct imp_table_fill_context *) ctx;
+    if (imp == 0)
+        return;
+
+    uint32_t order = fill->found++;
+    if (order >= fill->capacity)
+        return;
+
+    plcrash_async_objc_imp_entry_t *entry = &fill->table->entries[order];
+    entry->imp = imp;
+    entry->class_name = className->address;
+    entry->method_name = methodName->address;
+    entry->order = order;
+    entry->isClassMethod = isClassMethod;
+    fill->table->count = order + 1;
+}
+
+/**
+ * Build an IMP table for @a image. On return, @a table->status contains the result of parsing the image's Objective-C
+ * data; if the parse failed, the table will be empty.
+ *
+ * @param image The image to be parsed.
+ * @param cache The Objective-C cache object.
+ * @param table The unused table to be populated.
+ *
+ * @return Returns PLCRASH_ESUCCESS if @a table was populated (including with a recorded parse failure), or
+ * PLCRASH_ENOMEM if the table could not be allocated.
+ */
+static plcrash_error_t imp_table_build (plcrash_async_macho_t *image, plcrash_async_objc_cache_t *cache, plcrash_async_objc_imp_table_t *table) {
+    plcrash_error_t err;
+
+    table->image = image;
+
+    /* Count the methods */
+    uint32_t count = 0;
+    if ((err = plcrash_async_objc_parse(image, cache, imp_table_count_callback, &count)) != PLCRASH_ESUCCESS) {
+        table->status = err;
+        return PLCRASH_ESUCCESS;
+    }
+
+    if (count == 0) {
+        table->status = PLCRASH_ESUCCESS;
+        return PLCRASH_ESUCCESS;
+    }
+
+    /* Allocate and populate the table */
+    pl_vm_size_t allocation_size = round_page(sizeof(plcrash_async_objc_imp_entry_t) * count);
+    vm_address_t addr;
+    kern_return_t kt = plcrash_async_scratch_allocate(&addr, allocation_size);
+    if (kt != KERN_SUCCESS) {
+        PLCF_DEBUG("plcrash_async_scratch_allocate failed with error %x, the IMP table for %s could not be allocated", kt, image->name);
+        table->image = NULL;
+        return PLCRASH_ENOMEM;
+    }
+
+    table->entries = (plcrash_async_objc_imp_entry_t *) addr;
+    table->allocation_size = allocation_size;
+    table->count = 0;
+
+    struct imp_table_fill_context fill = {
+        .table = table,
+        .capacity = count,
+        .found = 0
+    };
+    if ((err = plcrash_async_objc_parse(image, cache, imp_table_fill_callback, &fill)) != PLCRASH_ESUCCESS) {
+        imp_table_free(table);
+        table->image = image;
+        table->status = err;
+        return PLCRASH_ESUCCESS;
+    }
+
+    /* Sort by IMP, and retain only the first-parsed of any duplicate IMPs; this matches the selection made by
+     * a linear search of the class data. */
+    imp_entry_sort(table->entries, table->count);
+
+    uint32_t unique = 0;
+    for (uint32_t i = 0; i < table->count; i++) {
+        if (unique > 0 && table->entries[unique - 1].imp == table->entries[i].imp)
+            continue;
+        table->entries[unique++] = table->entries[i];
+    }
+    table->count = unique;
+    table->status = PLCRASH_ESUCCESS;
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Return the IMP table for @a image, building it if necessary. If all table slots are in use, the least recently
+ * built table will be replaced.
+ *
+ * @param image The image for which a table should be returned.
+ * @param cache The Objective-C cache object.
+ *
+ * @return Returns the image's table, or NULL if a table could not be allocated.
+ */
+static plcrash_async_objc_imp_table_t *imp_table_lookup (plcrash_async_macho_t *image, plcrash_async_objc_cache_t *cache) {
+    for (size_t i = 0; i < PLCRASH_ASYNC_OBJC_IMP_TABLE_COUNT; i++) {
+        if (cache->impTables[i].image == image)
+            return &cache->impTables[i];
+    }
+
+    plcrash_async_objc_imp_table_t *table = &cache->impTables[cache->impTableNext];
+    cache->impTableNext = (cache->impTableNext + 1) % PLCRASH_ASYNC_OBJC_IMP_TABLE_COUNT;
+
+    imp_table_free(table);
+    if (imp_table_build(image, cache, table) != PLCRASH_ESUCCESS)
+        return NULL;
+
+    return table;
+}
+
 /**
  * Returns the pointer value for a non-pointer isa. This assumes that the lsb flag of 0x1 will continue to be
  * used to designate a non-pointer isa; see the PLCRASH_ASYNC_OBJC_SUPPORT_NONPTR_ISA documentation for more details.
@@ -1075,13 +1617,26 @@ pl_vm_address_t plcrash_async_objc_isa_pointer (pl_vm_address_t isa) {
 plcrash_error_t plcrash_async_objc_cache_init (plcrash_async_objc_cache_t *cache) {
     cache->gotObjC2Info = false;
     cache->lastImage = NULL;
+    cache->mappingPool = NULL;
     cache->objcConstMobjInitialized = false;
     cache->classMobjInitialized = false;
     cache->catMobjInitialized = false;
     cache->objcDataMobjInitialized = false;
+    cache->methNameMobjInitialized = false;
+    cache->classNameMobjInitialized = false;
+    cache->selRefsMobjInitialized = false;
+    cache->objcOptMobjInitialized = false;
     cache->classCacheSize = 0;
+    cache->classCacheCount = 0;
     cache->classCacheKeys = NULL;
     cache->classCacheValues = NULL;
+    cache->classParseCount = 0;
+#ifndef PLCF_RELEASE_BUILD
+    cache->classCacheHits = 0;
+    cache->classCacheMisses = 0;
+#endif
+    plcrash_async_memset(cache->impTables, 0, sizeof(cache->impTables));
+    cache->impTableNext = 0;
     return PLCRASH_ESUCCESS;
 }
 
@@ -1093,8 +1648,97 @@ plcrash_error_t plcrash_async_objc_cache_init (plcrash_async_objc_cache_t *cache
 void plcrash_async_objc_cache_free (plcrash_async_objc_cache_t *cache) {
     free_mapped_sections(cache);
 
+#ifndef PLCF_RELEASE_BUILD
+    if (cache->classCacheHits + cache->classCacheMisses > 0) {
+        PLCF_DEBUG("ObjC class cache: %llu hits, %llu misses, %zu/%zu entries", (unsigned long long) cache->classCacheHits,
+                   (unsigned long long) cache->classCacheMisses, cache->classCacheCount, cache->classCacheSize);
+    }
+#endif
+
     if (cache->classCacheKeys != NULL)
-        vm_deallocate(mach_task_self(), (vm_address_t)cache->classCacheKeys, cache_allocation_size(cache));
+        plcrash_async_scratch_deallocate((vm_address_t)cache->classCacheKeys, cache_allocation_size(cache->classCacheSize));
+
+    for (size_t i = 0; i < PLCRASH_ASYNC_OBJC_IMP_TABLE_COUNT; i++)
+        imp_table_free(&cache->impTables[i]);
+
+    if (cache->objcOptMobjInitialized)
+        plcrash_async_mobject_free(&cache->objcOptMobj);
+}
+
+/**
+ * Configure @a cache to use the dyld shared cache's precomputed ObjC optimization tables, as found in the shared
+ * cache copy of the ObjC runtime. Shared cache images that are absent from the cache's ObjC image table are then
+ * known to carry no ObjC metadata, and are skipped without mapping or probing their ObjC sections.
+ *
+ * This is an optional optimization; if the tables' layout version is not supported, @a cache is left unmodified
+ * and all images are parsed directly.
+ *
+ * @param cache The cache to configure.
+ * @param libobjc The ObjC runtime image (#PLCRASH_ASYNC_OBJC_RUNTIME_PATH), as loaded from the shared cache. The image
+ * must remain valid for the lifetime of @a cache.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if the optimization tables are not present,
+ * PLCRASH_ENOTSUP if the tables' layout version is not supported, or another error if the tables could not be read.
+ */
+plcrash_error_t plcrash_async_objc_cache_set_shared_cache_image (plcrash_async_objc_cache_t *cache, plcrash_async_macho_t *libobjc) {
+    plcrash_async_mobject_t mobj;
+    plcrash_error_t err;
+
+    if (cache->objcOptMobjInitialized)
+        return PLCRASH_ESUCCESS;
+
+    if (!plcrash_async_macho_in_shared_cache(libobjc))
+        return PLCRASH_ENOTFOUND;
+
+    if ((err = plcrash_async_macho_pool_map_section(cache->mappingPool, libobjc, kTextSegmentName, kObjCOptSectionName, &mobj)) != PLCRASH_ESUCCESS) {
+        if (err != PLCRASH_ENOTFOUND)
+            PLCF_DEBUG("pl_async_macho_map_section(%s, %s, %s) failure %d", libobjc->name, kTextSegmentName, kObjCOptSectionName, err);
+        return err;
+    }
+
+    /* Validate the header version; newer layouts are not supported, and older layouts use pointer-based records. */
+    struct pl_objc_opt_header *header = (struct pl_objc_opt_header *) plcrash_async_mobject_remap_address(&mobj, mobj.task_address, 0, sizeof(*header));
+    if (header == NULL) {
+        plcrash_async_mobject_free(&mobj);
+        return PLCRASH_EINVALID_DATA;
+    }
+
+    uint32_t version = plcrash_async_swap32(libobjc->byteorder, header->version);
+    if (version < OBJC_OPT_MIN_VERSION || version > OBJC_OPT_MAX_VERSION) {
+        PLCF_DEBUG("Unsupported ObjC optimization header version %u", (unsigned int) version);
+        plcrash_async_mobject_free(&mobj);
+        return PLCRASH_ENOTSUP;
+    }
+
+    /* Locate the image header table, which is addressed relative to the optimization header. */
+    int32_t headersOffset = (int32_t) plcrash_async_swap32(libobjc->byteorder, (uint32_t) header->headeropt_ro_offset);
+    pl_vm_address_t headersAddress = mobj.task_address + (int64_t) headersOffset;
+
+    struct pl_objc_opt_headers *headers = (struct pl_objc_opt_headers *) plcrash_async_mobject_remap_address(&mobj, headersAddress, 0, sizeof(*headers));
+    if (headersOffset == 0 || headers == NULL) {
+        plcrash_async_mobject_free(&mobj);
+        return PLCRASH_EINVALID_DATA;
+    }
+
+    uint32_t count = plcrash_async_swap32(libobjc->byteorder, headers->count);
+    uint32_t entsize = plcrash_async_swap32(libobjc->byteorder, headers->entsize);
+    size_t expected = libobjc->m64 ? sizeof(uint64_t) * 2 : sizeof(uint32_t) * 2;
+    pl_vm_address_t entries = headersAddress + sizeof(*headers);
+
+    if (entsize != expected || plcrash_async_mobject_remap_address(&mobj, entries, 0, (size_t) count * entsize) == NULL) {
+        PLCF_DEBUG("Invalid ObjC optimization image table (count=%u, entsize=%u)", (unsigned int) count, (unsigned int) entsize);
+        plcrash_async_mobject_free(&mobj);
+        return PLCRASH_EINVALID_DATA;
+    }
+
+    cache->objcOptMobj = mobj;
+    cache->objcOptByteOrder = libobjc->byteorder;
+    cache->objcOptM64 = libobjc->m64;
+    cache->objcOptHeadersAddress = entries;
+    cache->objcOptHeaderCount = count;
+    cache->objcOptMobjInitialized = true;
+
+    return PLCRASH_ESUCCESS;
 }
 
 /**
@@ -1115,8 +1759,17 @@ static plcrash_error_t plcrash_async_objc_parse (plcrash_async_macho_t *image, p
     
     if (cache == NULL)
         return PLCRASH_EACCESS;
+
+    /* Shared cache images absent from the cache's ObjC image table carry no ObjC metadata; those that are listed
+     * carry ObjC2 metadata. */
+    bool listed = false;
+    if (cache->objcOptMobjInitialized && plcrash_async_macho_in_shared_cache(image)) {
+        if (!objc_opt_contains_image(cache, image))
+            return PLCRASH_ENOTFOUND;
+        listed = true;
+    }
    
-    if (!cache->gotObjC2Info) {
+    if (!cache->gotObjC2Info && !listed) {
         /* Try ObjC1 data. */
         err = pl_async_objc_parse_from_module_info(image, callback, ctx);
     } else {
@@ -1126,7 +1779,7 @@ static plcrash_error_t plcrash_async_objc_parse (plcrash_async_macho_t *image, p
     
     /* If there wasn't any, try ObjC2 data. */
     if (err == PLCRASH_ENOTFOUND) {
-        if (image->m64)
+        if (plcrash_async_macho_m64(image))
             err = pl_async_objc_parse_from_data_section<pl_objc2_class_64, pl_objc2_class_data_ro_64, pl_objc2_class_data_rw_64, pl_objc2_category_64, uint64_t>(image, cache, callback, ctx);
         else
             err = pl_async_objc_parse_from_data_section<pl_objc2_class_32, pl_objc2_class_data_ro_32, pl_objc2_class_data_rw_32, pl_objc2_category_32, uint32_t>(image, cache, callback, ctx);
@@ -1182,6 +1835,40 @@ static void pl_async_objc_find_method_call_callback (bool isClassMethod, plcrash
     }
 }
 
+/**
+ * Fetch the class and method names for @a entry, and invoke @a callback with the result.
+ *
+ * @param image The image containing @a entry.
+ * @param objcContext The ObjC context from which the name strings may be borrowed.
+ * @param entry The IMP table entry.
+ * @param callback The callback to invoke.
+ * @param ctx The context pointer to pass to the callback.
+ * @return An error code.
+ */
+static plcrash_error_t imp_table_call (plcrash_async_macho_t *image, plcrash_async_objc_cache_t *objcContext, const plcrash_async_objc_imp_entry_t *entry, plcrash_async_objc_found_method_cb callback, void *ctx) {
+    plcrash_async_macho_string_t class_name;
+    plcrash_async_macho_string_t method_name;
+    plcrash_error_t err;
+
+    if ((err = objc_string_init(image, objcContext, &class_name, entry->class_name)) != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("plcrash_async_macho_string_init at 0x%llx error %d", (long long)entry->class_name, err);
+        return err;
+    }
+
+    if ((err = objc_string_init(image, objcContext, &method_name, entry->method_name)) != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("plcrash_async_macho_string_init at 0x%llx error %d", (long long)entry->method_name, err);
+        plcrash_async_macho_string_free(&class_name);
+        return err;
+    }
+
+    if (callback != NULL)
+        callback(entry->isClassMethod, &class_name, &method_name, entry->imp, ctx);
+
+    plcrash_async_macho_string_free(&method_name);
+    plcrash_async_macho_string_free(&class_name);
+    return PLCRASH_ESUCCESS;
+}
+
 /**
  * Search for the method that best matches the given code address.
  *
@@ -1193,6 +1880,40 @@ static void pl_async_objc_find_method_call_callback (bool isClassMethod, plcrash
  * @return An error code.
  */
 plcrash_error_t plcrash_async_objc_find_method (plcrash_async_macho_t *image, plcrash_async_objc_cache_t *objcContext, pl_vm_address_t imp, plcrash_async_objc_found_method_cb callback, void *ctx) {
+    if (objcContext == NULL)
+        return PLCRASH_EACCESS;
+
+    /* Skip images that were found to contain no ObjC metadata when they were initialized */
+    if (!plcrash_async_macho_has_objc(image))
+        return PLCRASH_ENOTFOUND;
+
+    /* Use the image's IMP table; if it can't be allocated, fall back on searching the class data directly. */
+    plcrash_async_objc_imp_table_t *table = imp_table_lookup(image, objcContext);
+    if (table != NULL) {
+        if (table->status != PLCRASH_ESUCCESS) {
+            /* Don't log an error if ObjC data was simply not found */
+            if (table->status != PLCRASH_ENOTFOUND)
+                PLCF_DEBUG("pl_async_objc_parse(%p, 0x%llx, %p, %p) failure %d", image, (long long)imp, callback, ctx, table->status);
+            return table->status;
+        }
+
+        /* Find the first entry with an IMP greater than the target */
+        uint32_t lower = 0;
+        uint32_t upper = table->count;
+        while (lower < upper) {
+            uint32_t mid = lower + (upper - lower) / 2;
+            if (table->entries[mid].imp <= imp)
+                lower = mid + 1;
+            else
+                upper = mid;
+        }
+
+        if (lower == 0)
+            return PLCRASH_ENOTFOUND;
+
+        return imp_table_call(image, objcContext, &table->entries[lower - 1], callback, ctx);
+    }
+
     struct pl_async_objc_find_method_search_context searchCtx = {
         .searchIMP = imp
     };
@@ -245,6 +245,114 @@ static void ParseCallbackTrampoline(bool isClassMethod, plcrash_async_macho_stri
     plcrash_async_objc_cache_free(&objCContext);
 }
 
+/**
+ * Verify that method lookups build a single sorted IMP table per image, and reuse it for subsequent lookups.
+ */
+- (void) testIMPTable {
+    plcrash_async_objc_cache_t objCContext;
+    plcrash_error_t err = plcrash_async_objc_cache_init(&objCContext);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"pl_async_objc_context_init failed");
+
+    __block pl_vm_address_t foundIMP = 0;
+    err = plcrash_async_objc_find_method(&_image, &objCContext, [self addressInCategory], ParseCallbackTrampoline, ^(bool isClassMethod, plcrash_async_macho_string_t *className, plcrash_async_macho_string_t *methodName, pl_vm_address_t imp, void *ctx) {
+        foundIMP = imp;
+    });
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"ObjC parse failed");
+    STAssertEquals(foundIMP, (pl_vm_address_t)[self methodForSelector: @selector(addressInCategory)], @"Method IMPs don't match");
+
+    /* Exactly one table should have been built, for our image */
+    plcrash_async_objc_imp_table_t *table = NULL;
+    for (size_t i = 0; i < PLCRASH_ASYNC_OBJC_IMP_TABLE_COUNT; i++) {
+        if (objCContext.impTables[i].image == NULL)
+            continue;
+
+        STAssertNULL(table, @"More than one IMP table was built");
+        table = &objCContext.impTables[i];
+    }
+    STAssertNotNULL(table, @"No IMP table was built");
+    STAssertEquals(table->image, &_image, @"Table built for the wrong image");
+    STAssertTrue(table->count > 0, @"Table is empty");
+
+    for (uint32_t i = 1; i < table->count; i++)
+        STAssertTrue(table->entries[i-1].imp < table->entries[i].imp, @"Table is not sorted");
+
+    /* A second lookup must reuse the existing table */
+    plcrash_async_objc_imp_entry_t *entries = table->entries;
+    err = plcrash_async_objc_find_method(&_image, &objCContext, [[self class] addressInClassMethod], ParseCallbackTrampoline, ^(bool isClassMethod, plcrash_async_macho_string_t *className, plcrash_async_macho_string_t *methodName, pl_vm_address_t imp, void *ctx) {
+        STAssertTrue(isClassMethod, @"Incorrectly indicated an instance method");
+        foundIMP = imp;
+    });
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"ObjC parse failed");
+    STAssertEquals(foundIMP, (pl_vm_address_t)[[self class] methodForSelector: @selector(addressInClassMethod)], @"Method IMPs don't match");
+    STAssertEquals(entries, table->entries, @"IMP table was rebuilt");
+
+    plcrash_async_objc_cache_free(&objCContext);
+}
+
+/**
+ * Verify that the class cache is sized for the parsed image, and populated during parsing.
+ */
+- (void) testClassCacheSizing {
+    plcrash_async_objc_cache_t objCContext;
+    plcrash_error_t err = plcrash_async_objc_cache_init(&objCContext);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"pl_async_objc_context_init failed");
+
+    err = plcrash_async_objc_find_method(&_image, &objCContext, [self addressInCategory], ParseCallbackTrampoline, ^(bool isClassMethod, plcrash_async_macho_string_t *className, plcrash_async_macho_string_t *methodName, pl_vm_address_t imp, void *ctx) {});
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"ObjC parse failed");
+
+    STAssertTrue(objCContext.classCacheSize > 0, @"Class cache was not allocated");
+    STAssertEquals((size_t) 0, objCContext.classCacheSize & (objCContext.classCacheSize - 1), @"Class cache size is not a power of two");
+    STAssertTrue(objCContext.classCacheCount > 0, @"Class cache was not populated");
+    STAssertTrue(objCContext.classCacheCount <= objCContext.classCacheSize / 2, @"Class cache load factor exceeds one half");
+
+#ifndef PLCF_RELEASE_BUILD
+    STAssertTrue(objCContext.classCacheMisses >= objCContext.classCacheCount, @"Class cache misses were not counted");
+#endif
+
+    plcrash_async_objc_cache_free(&objCContext);
+}
+
+/**
+ * Verify that the shared cache's ObjC image table is read from the runtime, and that shared cache images absent from
+ * the table are skipped.
+ */
+- (void) testSharedCacheObjCTables {
+    /* Find the ObjC runtime */
+    const struct mach_header *header = NULL;
+    for (uint32_t i = 0; i < _dyld_image_count(); i++) {
+        if (strcmp(_dyld_get_image_name(i), PLCRASH_ASYNC_OBJC_RUNTIME_PATH) == 0) {
+            header = _dyld_get_image_header(i);
+            break;
+        }
+    }
+    STAssertNotNULL(header, @"Could not find the ObjC runtime image");
+
+    plcrash_async_macho_t libobjc;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_macho_init(&libobjc, mach_task_self(), PLCRASH_ASYNC_OBJC_RUNTIME_PATH, (pl_vm_address_t) header), @"Failed to initialize image");
+    libobjc.in_shared_cache = true;
+
+    plcrash_async_objc_cache_t objCContext;
+    plcrash_error_t err = plcrash_async_objc_cache_init(&objCContext);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"pl_async_objc_context_init failed");
+
+    /* Newer runtimes store their tables elsewhere, or in an unsupported layout; the fast path is simply unavailable */
+    err = plcrash_async_objc_cache_set_shared_cache_image(&objCContext, &libobjc);
+    if (err == PLCRASH_ESUCCESS) {
+        STAssertTrue(objCContext.objcOptHeaderCount > 0, @"Empty image table");
+
+        /* Our image is not in the shared cache, and must not be found in the table */
+        _image.in_shared_cache = true;
+        err = plcrash_async_objc_find_method(&_image, &objCContext, [self addressInCategory], ParseCallbackTrampoline, ^(bool isClassMethod, plcrash_async_macho_string_t *className, plcrash_async_macho_string_t *methodName, pl_vm_address_t imp, void *ctx) {});
+        STAssertEquals(PLCRASH_ENOTFOUND, err, @"Unlisted image was parsed");
+        _image.in_shared_cache = false;
+    } else {
+        STAssertTrue(err == PLCRASH_ENOTSUP || err == PLCRASH_ENOTFOUND, @"Unexpected error reading the ObjC tables: %d", err);
+    }
+
+    plcrash_async_objc_cache_free(&objCContext);
+    plcrash_nasync_macho_free(&libobjc);
+}
+
 @end
 
 @implementation PLCrashAsyncObjCSectionTests (Category)
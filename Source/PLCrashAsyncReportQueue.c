@@ -0,0 +1,378 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "PLCrashAsyncReportQueue.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @internal
+ * @ingroup plcrash_async
+ * @defgroup plcrash_async_report_queue Async-safe Crash Report Queue
+ *
+ * Implements a bounded, on-disk queue of crash reports. Reports are enqueued from the crash path in constant time
+ * by hard-linking the completed report into the queue directory and updating a single fixed-size index slot; the
+ * queue is enumerated and purged in batches outside of the crash path.
+ * @{
+ */
+
+/** Name of the index file within the queue directory. */
+#define QUEUE_INDEX_NAME "index"
+
+/** Suffix appended to each queued report's hexadecimal sequence number. */
+#define QUEUE_REPORT_SUFFIX ".plcrash"
+
+/** Suffix appended to a queued report's file name to form the name of its summary. */
+#define QUEUE_SUMMARY_SUFFIX ".summary"
+
+/** Length of a queued report file name. */
+#define QUEUE_REPORT_NAME_LENGTH (16 + sizeof(QUEUE_REPORT_SUFFIX) - 1)
+
+/** Length of a queued report summary file name. */
+#define QUEUE_SUMMARY_NAME_LENGTH (QUEUE_REPORT_NAME_LENGTH + sizeof(QUEUE_SUMMARY_SUFFIX) - 1)
+
+/* Return the index file offset of @a slot. */
+static inline off_t queue_slot_offset (uint32_t slot) {
+    return (off_t) (sizeof(plcrash_async_report_queue_header_t) + slot * sizeof(plcrash_async_report_queue_entry_t));
+}
+
+/* Read the entry at @a slot, returning false on failure. */
+static bool queue_read_entry (plcrash_async_report_queue_t *queue, uint32_t slot, plcrash_async_report_queue_entry_t *entry) {
+    return pread(queue->index_fd, entry, sizeof(*entry), queue_slot_offset(slot)) == (ssize_t) sizeof(*entry);
+}
+
+/* Write the entry at @a slot, returning false on failure. */
+static bool queue_write_entry (plcrash_async_report_queue_t *queue, uint32_t slot, const plcrash_async_report_queue_entry_t *entry) {
+    return pwrite(queue->index_fd, entry, sizeof(*entry), queue_slot_offset(slot)) == (ssize_t) sizeof(*entry);
+}
+
+/* Return the path of the file within the queue directory named @a name. */
+static const char *queue_file_path (plcrash_async_report_queue_t *queue, const char *name) {
+    size_t len = plcrash_async_strnlen(name, sizeof(queue->path) - queue->directory_length - 1);
+    plcrash_async_memcpy(queue->path + queue->directory_length, name, len);
+    queue->path[queue->directory_length + len] = '\0';
+    return queue->path;
+}
+
+/* Write the NUL-terminated name of the queued report with the given @a sequence number to @a name, followed by
+ * @a suffix. */
+static void queue_report_name (uint64_t sequence, const char *suffix, size_t suffix_length, char name[QUEUE_SUMMARY_NAME_LENGTH + 1]) {
+    static const char hex[] = "0123456789abcdef";
+
+    for (int i = 0; i < 16; i++)
+        name[i] = hex[(sequence >> (60 - (i * 4))) & 0xF];
+
+    plcrash_async_memcpy(name + 16, QUEUE_REPORT_SUFFIX, sizeof(QUEUE_REPORT_SUFFIX) - 1);
+    plcrash_async_memcpy(name + QUEUE_REPORT_NAME_LENGTH, suffix, suffix_length);
+    name[QUEUE_REPORT_NAME_LENGTH + suffix_length] = '\0';
+}
+
+/* Remove the queued report with the given @a sequence number, and its summary, if any. Returns the result of
+ * unlinking the report. */
+static int queue_remove_report (plcrash_async_report_queue_t *queue, uint64_t sequence) {
+    unlink(plcrash_async_report_queue_summary_path(queue, sequence));
+    return unlink(plcrash_async_report_queue_path(queue, sequence));
+}
+
+/**
+ * Initialize @a queue, creating or opening the index file within @a directory. If the existing index has a different
+ * capacity, it is rebuilt: the most recent reports that fit within the new capacity are retained, and the remaining
+ * reports are removed.
+ *
+ * @param queue The queue to initialize.
+ * @param directory The queue directory. The directory must already exist.
+ * @param capacity The number of queue slots, no greater than #PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY. If 0, the
+ * capacity of the existing index is used, and no index will be created.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if @a capacity is 0 and no valid index exists,
+ * PLCRASH_EINVAL if @a capacity or @a directory is invalid, or PLCRASH_OUTPUT_ERR if the index could not be written.
+ * If an error is returned, no resources will have been retained.
+ *
+ * @warning This function is not async-safe, and must be called prior to entering the crash handler.
+ */
+plcrash_error_t plcrash_nasync_report_queue_init (plcrash_async_report_queue_t *queue, const char *directory, uint32_t capacity) {
+    plcrash_async_report_queue_header_t header;
+    plcrash_async_report_queue_entry_t entries[PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY];
+    plcrash_async_report_queue_entry_t existing[PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY];
+    uint32_t existing_capacity = 0;
+
+    if (capacity > PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY)
+        return PLCRASH_EINVAL;
+
+    /* Save the directory prefix; report file names are appended in place */
+    size_t dirlen = strlen(directory);
+    if (dirlen + 1 + QUEUE_SUMMARY_NAME_LENGTH + 1 > sizeof(queue->path))
+        return PLCRASH_EINVAL;
+
+    memcpy(queue->path, directory, dirlen);
+    queue->path[dirlen] = '/';
+    queue->directory_length = dirlen + 1;
+
+    /* Open the index */
+    queue->index_fd = open(queue_file_path(queue, QUEUE_INDEX_NAME), capacity > 0 ? O_RDWR|O_CREAT : O_RDWR, 0644);
+    if (queue->index_fd < 0) {
+        if (capacity == 0 && errno == ENOENT)
+            return PLCRASH_ENOTFOUND;
+
+        PLCF_DEBUG("Could not open the report queue index: %s", strerror(errno));
+        return PLCRASH_OUTPUT_ERR;
+    }
+
+    /* Read the existing entries, if any */
+    if (pread(queue->index_fd, &header, sizeof(header), 0) == (ssize_t) sizeof(header) &&
+        header.magic == PLCRASH_ASYNC_REPORT_QUEUE_MAGIC &&
+        header.version == PLCRASH_ASYNC_REPORT_QUEUE_VERSION &&
+        header.capacity > 0 && header.capacity <= PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY)
+    {
+        size_t len = header.capacity * sizeof(existing[0]);
+        if (pread(queue->index_fd, existing, len, queue_slot_offset(0)) == (ssize_t) len)
+            existing_capacity = header.capacity;
+    }
+
+    if (capacity == 0) {
+        if (existing_capacity == 0) {
+            close(queue->index_fd);
+            return PLCRASH_ENOTFOUND;
+        }
+        capacity = existing_capacity;
+    }
+
+    queue->capacity = capacity;
+
+    /* Place the existing entries in their new slots, retaining the most recent report of any that collide */
+    memset(entries, 0, sizeof(entries));
+    for (uint32_t i = 0; i < existing_capacity; i++) {
+        if (existing[i].sequence == 0)
+            continue;
+
+        plcrash_async_report_queue_entry_t *slot = &entries[existing[i].sequence % capacity];
+        if (slot->sequence < existing[i].sequence) {
+            if (slot->sequence != 0)
+                queue_remove_report(queue, slot->sequence);
+            *slot = existing[i];
+        } else {
+            queue_remove_report(queue, existing[i].sequence);
+        }
+    }
+
+    /* Rewrite the index if it was missing, invalid, or resized */
+    if (existing_capacity != capacity) {
+        header.magic = PLCRASH_ASYNC_REPORT_QUEUE_MAGIC;
+        header.version = PLCRASH_ASYNC_REPORT_QUEUE_VERSION;
+        header.capacity = capacity;
+        header.reserved = 0;
+
+        size_t len = capacity * sizeof(entries[0]);
+        if (pwrite(queue->index_fd, &header, sizeof(header), 0) != (ssize_t) sizeof(header) ||
+            pwrite(queue->index_fd, entries, len, queue_slot_offset(0)) != (ssize_t) len ||
+            ftruncate(queue->index_fd, queue_slot_offset(capacity)) != 0)
+        {
+            PLCF_DEBUG("Could not write the report queue index: %s", strerror(errno));
+            close(queue->index_fd);
+            return PLCRASH_OUTPUT_ERR;
+        }
+    }
+
+    /* Resume numbering after the most recent report */
+    queue->next_sequence = 1;
+    for (uint32_t i = 0; i < capacity; i++) {
+        if (entries[i].sequence >= queue->next_sequence)
+            queue->next_sequence = entries[i].sequence + 1;
+    }
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Add the completed report at @a report_path to the queue, evicting the oldest queued report if all slots are
+ * occupied. The report, and its summary if any, are hard-linked into the queue directory; @a report_path and
+ * @a summary_path are left in place.
+ *
+ * @param queue The queue.
+ * @param report_path The path of the completed report. The report must reside on the same volume as the queue.
+ * @param summary_path The path of the report's summary, or NULL. If the summary can not be linked, the report is
+ * queued without a summary.
+ * @param length The size of the report, in bytes.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_OUTPUT_ERR if the report could not be queued.
+ */
+plcrash_error_t plcrash_async_report_queue_enqueue (plcrash_async_report_queue_t *queue, const char *report_path, const char *summary_path, uint64_t length) {
+    uint64_t sequence = queue->next_sequence;
+    uint32_t slot = (uint32_t) (sequence % queue->capacity);
+    plcrash_async_report_queue_entry_t entry;
+
+    /* Evict the slot's current report */
+    if (queue_read_entry(queue, slot, &entry) && entry.sequence != 0)
+        queue_remove_report(queue, entry.sequence);
+
+    /* Link the report into place, replacing any stale files left by an interrupted purge */
+    queue_remove_report(queue, sequence);
+    if (link(report_path, plcrash_async_report_queue_path(queue, sequence)) != 0) {
+        PLCF_DEBUG("Could not link the report into the report queue: %s", strerror(errno));
+        return PLCRASH_OUTPUT_ERR;
+    }
+
+    if (summary_path != NULL && link(summary_path, plcrash_async_report_queue_summary_path(queue, sequence)) != 0)
+        PLCF_DEBUG("Could not link the report summary into the report queue: %s", strerror(errno));
+
+    /* Record the report */
+    entry.sequence = sequence;
+    entry.length = length;
+    if (!queue_write_entry(queue, slot, &entry)) {
+        PLCF_DEBUG("Could not update the report queue index: %s", strerror(errno));
+        return PLCRASH_OUTPUT_ERR;
+    }
+
+    queue->next_sequence++;
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Return the path of the queued report with the given @a sequence number. The returned buffer is owned by @a queue,
+ * and is only valid until the next call to a function that accepts @a queue.
+ *
+ * @param queue The queue.
+ * @param sequence The report's sequence number.
+ */
+const char *plcrash_async_report_queue_path (plcrash_async_report_queue_t *queue, uint64_t sequence) {
+    char name[QUEUE_SUMMARY_NAME_LENGTH + 1];
+    queue_report_name(sequence, "", 0, name);
+    return queue_file_path(queue, name);
+}
+
+/**
+ * Return the path of the summary of the queued report with the given @a sequence number. The summary may not exist.
+ * The returned buffer is owned by @a queue, and is only valid until the next call to a function that accepts @a queue.
+ *
+ * @param queue The queue.
+ * @param sequence The report's sequence number.
+ */
+const char *plcrash_async_report_queue_summary_path (plcrash_async_report_queue_t *queue, uint64_t sequence) {
+    char name[QUEUE_SUMMARY_NAME_LENGTH + 1];
+    queue_report_name(sequence, QUEUE_SUMMARY_SUFFIX, sizeof(QUEUE_SUMMARY_SUFFIX) - 1, name);
+    return queue_file_path(queue, name);
+}
+
+/**
+ * Read the queue's occupied slots, ordered from oldest to most recent.
+ *
+ * @param queue The queue.
+ * @param entries On return, the occupied entries.
+ * @param count On input, the number of elements available in @a entries. On return, the number of entries written.
+ * At most #PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY entries will be written.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_EINTERNAL if the index could not be read.
+ *
+ * @warning This function is not async-safe.
+ */
+plcrash_error_t plcrash_nasync_report_queue_entries (plcrash_async_report_queue_t *queue, plcrash_async_report_queue_entry_t *entries, uint32_t *count) {
+    plcrash_async_report_queue_entry_t slots[PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY];
+    size_t len = queue->capacity * sizeof(slots[0]);
+    uint32_t found = 0;
+
+    if (pread(queue->index_fd, slots, len, queue_slot_offset(0)) != (ssize_t) len) {
+        PLCF_DEBUG("Could not read the report queue index: %s", strerror(errno));
+        return PLCRASH_EINTERNAL;
+    }
+
+    /* Insertion sort by sequence number; the queue is small */
+    for (uint32_t i = 0; i < queue->capacity; i++) {
+        if (slots[i].sequence == 0)
+            continue;
+
+        uint32_t pos = found < *count ? found : *count;
+        while (pos > 0 && entries[pos - 1].sequence > slots[i].sequence) {
+            if (pos < *count)
+                entries[pos] = entries[pos - 1];
+            pos--;
+        }
+
+        if (pos < *count)
+            entries[pos] = slots[i];
+
+        if (found < *count)
+            found++;
+    }
+
+    *count = found;
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Remove all queued reports with a sequence number less than or equal to @a sequence. Reports enqueued after the
+ * queue was enumerated are retained.
+ *
+ * @param queue The queue.
+ * @param sequence The sequence number of the most recent report to be removed.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_OUTPUT_ERR if a report could not be removed.
+ *
+ * @warning This function is not async-safe.
+ */
+plcrash_error_t plcrash_nasync_report_queue_purge (plcrash_async_report_queue_t *queue, uint64_t sequence) {
+    static const plcrash_async_report_queue_entry_t empty = { 0, 0 };
+    plcrash_error_t err = PLCRASH_ESUCCESS;
+
+    for (uint32_t slot = 0; slot < queue->capacity; slot++) {
+        plcrash_async_report_queue_entry_t entry;
+        if (!queue_read_entry(queue, slot, &entry) || entry.sequence == 0 || entry.sequence > sequence)
+            continue;
+
+        /* Clear the slot first, so that the index never refers to a removed report */
+        if (!queue_write_entry(queue, slot, &empty)) {
+            PLCF_DEBUG("Could not update the report queue index: %s", strerror(errno));
+            err = PLCRASH_OUTPUT_ERR;
+            continue;
+        }
+
+        if (queue_remove_report(queue, entry.sequence) != 0 && errno != ENOENT) {
+            PLCF_DEBUG("Could not remove the queued report: %s", strerror(errno));
+            err = PLCRASH_OUTPUT_ERR;
+        }
+    }
+
+    return err;
+}
+
+/**
+ * Free all resources associated with @a queue.
+ *
+ * @param queue The queue to free.
+ *
+ * @warning This function is not async-safe.
+ */
+void plcrash_nasync_report_queue_free (plcrash_async_report_queue_t *queue) {
+    close(queue->index_fd);
+}
+
+/**
+ * @}
+ */
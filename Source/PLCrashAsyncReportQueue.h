@@ -0,0 +1,140 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PLCRASH_ASYNC_REPORT_QUEUE_H
+#define PLCRASH_ASYNC_REPORT_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <limits.h>
+
+#include "PLCrashAsync.h"
+
+/**
+ * @internal
+ * @ingroup plcrash_async_report_queue
+ *
+ * Magic value identifying a report queue index file.
+ */
+#define PLCRASH_ASYNC_REPORT_QUEUE_MAGIC 0x71636c70 /* 'plcq', little-endian */
+
+/**
+ * @internal
+ * @ingroup plcrash_async_report_queue
+ *
+ * The current version of the report queue index layout.
+ */
+#define PLCRASH_ASYNC_REPORT_QUEUE_VERSION 1
+
+/**
+ * @internal
+ * @ingroup plcrash_async_report_queue
+ *
+ * Maximum number of slots in a report queue.
+ */
+#define PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY 64
+
+/**
+ * @internal
+ * @ingroup plcrash_async_report_queue
+ *
+ * Report queue index file header. The index is written in host byte order, and is only intended to be read on the
+ * host that wrote it.
+ */
+typedef struct plcrash_async_report_queue_header {
+    /** The index magic value (#PLCRASH_ASYNC_REPORT_QUEUE_MAGIC). */
+    uint32_t magic;
+
+    /** The index layout version (#PLCRASH_ASYNC_REPORT_QUEUE_VERSION). */
+    uint32_t version;
+
+    /** The number of slots that follow the header. */
+    uint32_t capacity;
+
+    /** Reserved; must be zero. */
+    uint32_t reserved;
+} plcrash_async_report_queue_header_t;
+
+/**
+ * @internal
+ * @ingroup plcrash_async_report_queue
+ *
+ * A single report queue index slot.
+ */
+typedef struct plcrash_async_report_queue_entry {
+    /** The report's sequence number, or 0 if the slot is empty. Sequence numbers increase monotonically; the report
+     * with sequence number @a n occupies slot @a n modulo the queue's capacity. */
+    uint64_t sequence;
+
+    /** The size of the report file, in bytes. */
+    uint64_t length;
+} plcrash_async_report_queue_entry_t;
+
+/**
+ * @internal
+ * @ingroup plcrash_async_report_queue
+ *
+ * A bounded, on-disk queue of crash reports. The queue consists of a directory containing a fixed-size index file,
+ * and one report file per occupied slot. Once all slots are occupied, enqueueing a report evicts the oldest.
+ */
+typedef struct plcrash_async_report_queue {
+    /** The open index file descriptor. */
+    int index_fd;
+
+    /** The number of slots in the queue. */
+    uint32_t capacity;
+
+    /** The sequence number to be assigned to the next enqueued report. */
+    uint64_t next_sequence;
+
+    /** Length of the @a path directory prefix, including the trailing path separator. */
+    size_t directory_length;
+
+    /** The queue directory, followed by scratch space used to construct report file paths. */
+    char path[PATH_MAX];
+} plcrash_async_report_queue_t;
+
+plcrash_error_t plcrash_nasync_report_queue_init (plcrash_async_report_queue_t *queue, const char *directory, uint32_t capacity);
+plcrash_error_t plcrash_async_report_queue_enqueue (plcrash_async_report_queue_t *queue, const char *report_path, const char *summary_path, uint64_t length);
+const char *plcrash_async_report_queue_path (plcrash_async_report_queue_t *queue, uint64_t sequence);
+const char *plcrash_async_report_queue_summary_path (plcrash_async_report_queue_t *queue, uint64_t sequence);
+
+plcrash_error_t plcrash_nasync_report_queue_entries (plcrash_async_report_queue_t *queue, plcrash_async_report_queue_entry_t *entries, uint32_t *count);
+plcrash_error_t plcrash_nasync_report_queue_purge (plcrash_async_report_queue_t *queue, uint64_t sequence);
+void plcrash_nasync_report_queue_free (plcrash_async_report_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PLCRASH_ASYNC_REPORT_QUEUE_H */
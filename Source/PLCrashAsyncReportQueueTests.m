@@ -0,0 +1,159 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "SenTestCompat.h"
+
+#import "PLCrashAsyncReportQueue.h"
+
+@interface PLCrashAsyncReportQueueTests : SenTestCase {
+@private
+    /** Queue directory */
+    NSString *_directory;
+
+    /** Path to a report file to be enqueued */
+    NSString *_reportPath;
+}
+@end
+
+@implementation PLCrashAsyncReportQueueTests
+
+- (void) setUp {
+    _directory = [[NSTemporaryDirectory() stringByAppendingPathComponent: [[NSProcessInfo processInfo] globallyUniqueString]] retain];
+    STAssertTrue([[NSFileManager defaultManager] createDirectoryAtPath: _directory withIntermediateDirectories: YES attributes: nil error: NULL], @"Could not create queue directory");
+
+    _reportPath = [[_directory stringByAppendingPathComponent: @"live_report.plcrash"] retain];
+    STAssertTrue([[NSData dataWithBytes: "report" length: 6] writeToFile: _reportPath atomically: NO], @"Could not write report");
+}
+
+- (void) tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath: _directory error: NULL];
+    [_directory release];
+    [_reportPath release];
+}
+
+/**
+ * Return the sequence numbers of the queue's entries, oldest first.
+ */
+- (NSArray *) sequencesForQueue: (plcrash_async_report_queue_t *) queue {
+    plcrash_async_report_queue_entry_t entries[PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY];
+    uint32_t count = PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY;
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_report_queue_entries(queue, entries, &count), @"Failed to read entries");
+
+    NSMutableArray *result = [NSMutableArray array];
+    for (uint32_t i = 0; i < count; i++)
+        [result addObject: [NSNumber numberWithUnsignedLongLong: entries[i].sequence]];
+    return result;
+}
+
+- (void) testOpenMissing {
+    plcrash_async_report_queue_t queue;
+    STAssertEquals(PLCRASH_ENOTFOUND, plcrash_nasync_report_queue_init(&queue, [_directory fileSystemRepresentation], 0), @"Opened a missing queue");
+    STAssertEquals(PLCRASH_EINVAL, plcrash_nasync_report_queue_init(&queue, [_directory fileSystemRepresentation], PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY + 1), @"Accepted an invalid capacity");
+}
+
+- (void) testEnqueueEvictsOldest {
+    plcrash_async_report_queue_t queue;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_report_queue_init(&queue, [_directory fileSystemRepresentation], 3), @"Failed to create queue");
+
+    for (int i = 0; i < 5; i++)
+        STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_report_queue_enqueue(&queue, [_reportPath fileSystemRepresentation], NULL, 6), @"Failed to enqueue");
+
+    NSArray *expected = [NSArray arrayWithObjects: [NSNumber numberWithInt: 3], [NSNumber numberWithInt: 4], [NSNumber numberWithInt: 5], nil];
+    STAssertEqualObjects(expected, [self sequencesForQueue: &queue], @"Incorrect queue contents");
+
+    /* Evicted reports are removed; queued reports are copies of the original */
+    NSFileManager *fm = [NSFileManager defaultManager];
+    STAssertFalse([fm fileExistsAtPath: [NSString stringWithUTF8String: plcrash_async_report_queue_path(&queue, 2)]], @"Evicted report was not removed");
+    NSData *data = [NSData dataWithContentsOfFile: [NSString stringWithUTF8String: plcrash_async_report_queue_path(&queue, 5)]];
+    STAssertEqualObjects([NSData dataWithContentsOfFile: _reportPath], data, @"Incorrect queued report");
+
+    plcrash_nasync_report_queue_free(&queue);
+}
+
+- (void) testPurge {
+    plcrash_async_report_queue_t queue;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_report_queue_init(&queue, [_directory fileSystemRepresentation], 4), @"Failed to create queue");
+
+    for (int i = 0; i < 3; i++)
+        plcrash_async_report_queue_enqueue(&queue, [_reportPath fileSystemRepresentation], NULL, 6);
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_report_queue_purge(&queue, 2), @"Failed to purge");
+    STAssertEqualObjects([NSArray arrayWithObject: [NSNumber numberWithInt: 3]], [self sequencesForQueue: &queue], @"Incorrect queue contents");
+    STAssertFalse([[NSFileManager defaultManager] fileExistsAtPath: [NSString stringWithUTF8String: plcrash_async_report_queue_path(&queue, 1)]], @"Purged report was not removed");
+    STAssertTrue([[NSFileManager defaultManager] fileExistsAtPath: _reportPath], @"Original report was removed");
+
+    plcrash_nasync_report_queue_free(&queue);
+}
+
+- (void) testEnqueueSummary {
+    plcrash_async_report_queue_t queue;
+    NSFileManager *fm = [NSFileManager defaultManager];
+    NSString *summaryPath = [_directory stringByAppendingPathComponent: @"live_report.plcrash.summary"];
+    STAssertTrue([[NSData dataWithBytes: "summary" length: 7] writeToFile: summaryPath atomically: NO], @"Could not write summary");
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_report_queue_init(&queue, [_directory fileSystemRepresentation], 2), @"Failed to create queue");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_report_queue_enqueue(&queue, [_reportPath fileSystemRepresentation], [summaryPath fileSystemRepresentation], 6), @"Failed to enqueue");
+
+    /* A missing summary does not prevent the report from being queued */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_report_queue_enqueue(&queue, [_reportPath fileSystemRepresentation], "/nonexistent", 6), @"Failed to enqueue");
+
+    NSData *data = [NSData dataWithContentsOfFile: [NSString stringWithUTF8String: plcrash_async_report_queue_summary_path(&queue, 1)]];
+    STAssertEqualObjects([NSData dataWithContentsOfFile: summaryPath], data, @"Incorrect queued summary");
+    STAssertFalse([fm fileExistsAtPath: [NSString stringWithUTF8String: plcrash_async_report_queue_summary_path(&queue, 2)]], @"Unexpected summary");
+
+    /* Purging removes the summary along with its report */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_report_queue_purge(&queue, 1), @"Failed to purge");
+    STAssertFalse([fm fileExistsAtPath: [NSString stringWithUTF8String: plcrash_async_report_queue_summary_path(&queue, 1)]], @"Purged summary was not removed");
+    STAssertTrue([fm fileExistsAtPath: summaryPath], @"Original summary was removed");
+
+    plcrash_nasync_report_queue_free(&queue);
+}
+
+- (void) testReopenAndResize {
+    plcrash_async_report_queue_t queue;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_report_queue_init(&queue, [_directory fileSystemRepresentation], 4), @"Failed to create queue");
+    for (int i = 0; i < 4; i++)
+        plcrash_async_report_queue_enqueue(&queue, [_reportPath fileSystemRepresentation], NULL, 6);
+    plcrash_nasync_report_queue_free(&queue);
+
+    /* Reopening with the existing capacity resumes numbering */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_report_queue_init(&queue, [_directory fileSystemRepresentation], 0), @"Failed to open queue");
+    STAssertEquals((uint32_t) 4, queue.capacity, @"Incorrect capacity");
+    STAssertEquals((uint64_t) 5, queue.next_sequence, @"Incorrect next sequence number");
+    plcrash_nasync_report_queue_free(&queue);
+
+    /* Shrinking retains the most recent reports */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_report_queue_init(&queue, [_directory fileSystemRepresentation], 2), @"Failed to resize queue");
+    NSArray *expected = [NSArray arrayWithObjects: [NSNumber numberWithInt: 3], [NSNumber numberWithInt: 4], nil];
+    STAssertEqualObjects(expected, [self sequencesForQueue: &queue], @"Incorrect queue contents");
+    STAssertFalse([[NSFileManager defaultManager] fileExistsAtPath: [NSString stringWithUTF8String: plcrash_async_report_queue_path(&queue, 1)]], @"Dropped report was not removed");
+    plcrash_nasync_report_queue_free(&queue);
+}
+
+@end
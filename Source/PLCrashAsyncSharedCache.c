@@ -0,0 +1,198 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "PLCrashAsyncSharedCache.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <mach-o/dyld_images.h>
+
+/**
+ * @internal
+ * @ingroup plcrash_async
+ *
+ * Implements async-safe discovery of a task's dyld shared cache.
+ *
+ * @{
+ */
+
+/** The maximum number of shared cache mappings that will be read from the cache header. */
+#define SHARED_CACHE_MAX_MAPPINGS 16
+
+/** The leading fields of the dyld shared cache header. */
+struct shared_cache_header {
+    /** Magic value; "dyld_v1" followed by the architecture name. */
+    char magic[16];
+
+    /** The file offset of the first dyld_cache_mapping_info. */
+    uint32_t mappingOffset;
+
+    /** The number of dyld_cache_mapping_info entries. */
+    uint32_t mappingCount;
+};
+
+/** A shared cache mapping, as defined by the dyld shared cache header. */
+struct shared_cache_mapping {
+    /** The unslid address of the mapping. */
+    uint64_t address;
+
+    /** The size of the mapping, in bytes. */
+    uint64_t size;
+
+    /** The mapping's file offset. */
+    uint64_t fileOffset;
+
+    /** Maximum VM protection. */
+    uint32_t maxProt;
+
+    /** Initial VM protection. */
+    uint32_t initProt;
+};
+
+/**
+ * Determine the extent of the shared cache mapped at @a cache's base address, from the mappings declared in the
+ * cache header.
+ */
+static pl_vm_size_t shared_cache_size (mach_port_t task, const plcrash_async_shared_cache_t *cache) {
+    struct shared_cache_header header;
+    if (plcrash_async_task_memcpy(task, cache->base_address, 0, &header, sizeof(header)) != PLCRASH_ESUCCESS)
+        return 0;
+
+    if (plcrash_async_strncmp(header.magic, "dyld_v1", 7) != 0 || header.mappingCount == 0)
+        return 0;
+
+    struct shared_cache_mapping mappings[SHARED_CACHE_MAX_MAPPINGS];
+    uint32_t count = header.mappingCount < SHARED_CACHE_MAX_MAPPINGS ? header.mappingCount : SHARED_CACHE_MAX_MAPPINGS;
+    if (plcrash_async_task_memcpy(task, cache->base_address, header.mappingOffset, mappings, count * sizeof(mappings[0])) != PLCRASH_ESUCCESS)
+        return 0;
+
+    /* The mappings are unslid, and the first mapping begins at the cache base. */
+    uint64_t start = mappings[0].address;
+    uint64_t end = start;
+    for (uint32_t i = 0; i < count; i++) {
+        if (mappings[i].address < start)
+            return 0;
+
+        if (mappings[i].address + mappings[i].size > end)
+            end = mappings[i].address + mappings[i].size;
+    }
+
+    return (pl_vm_size_t) (end - start);
+}
+
+/**
+ * Determine the location and identity of the dyld shared cache mapped into @a task.
+ *
+ * @param cache The shared cache record to be initialized.
+ * @param task The task to be queried. The task's pointer width must match that of the current process.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if @a task has no shared cache or the running
+ * dyld does not report one, PLCRASH_ENOTSUP if @a task's image info format does not match the current process,
+ * or another error result if the task's dyld image info could not be read.
+ */
+plcrash_error_t plcrash_async_shared_cache_init (plcrash_async_shared_cache_t *cache, mach_port_t task) {
+    kern_return_t kr;
+    plcrash_error_t err;
+
+    memset(cache, 0, sizeof(*cache));
+
+    struct task_dyld_info dyld_info;
+    mach_msg_type_number_t info_count = TASK_DYLD_INFO_COUNT;
+    if ((kr = task_info(task, TASK_DYLD_INFO, (task_info_t) &dyld_info, &info_count)) != KERN_SUCCESS) {
+        PLCF_DEBUG("task_info(TASK_DYLD_INFO) failed: %d", kr);
+        return PLCRASH_EINTERNAL;
+    }
+
+#ifdef __LP64__
+    if (dyld_info.all_image_info_format != TASK_DYLD_ALL_IMAGE_INFO_64)
+        return PLCRASH_ENOTSUP;
+#else
+    if (dyld_info.all_image_info_format != TASK_DYLD_ALL_IMAGE_INFO_32)
+        return PLCRASH_ENOTSUP;
+#endif
+
+    /* Read only the fields supported by the target's dyld */
+    uint32_t version;
+    if ((err = plcrash_async_task_memcpy(task, dyld_info.all_image_info_addr, 0, &version, sizeof(version))) != PLCRASH_ESUCCESS)
+        return err;
+
+    /* The shared cache slide was introduced in version 12 */
+    if (version < 12)
+        return PLCRASH_ENOTFOUND;
+
+    struct dyld_all_image_infos infos;
+    size_t length;
+    if (version >= 15) {
+        length = offsetof(struct dyld_all_image_infos, sharedCacheBaseAddress) + sizeof(infos.sharedCacheBaseAddress);
+    } else if (version >= 13) {
+        length = offsetof(struct dyld_all_image_infos, sharedCacheUUID) + sizeof(infos.sharedCacheUUID);
+    } else {
+        length = offsetof(struct dyld_all_image_infos, sharedCacheSlide) + sizeof(infos.sharedCacheSlide);
+    }
+
+    if ((err = plcrash_async_task_memcpy(task, dyld_info.all_image_info_addr, 0, &infos, length)) != PLCRASH_ESUCCESS)
+        return err;
+
+    if (infos.processDetachedFromSharedRegion)
+        return PLCRASH_ENOTFOUND;
+
+    cache->slide = infos.sharedCacheSlide;
+
+    if (version >= 13) {
+        memcpy(cache->uuid, infos.sharedCacheUUID, sizeof(cache->uuid));
+        cache->has_uuid = true;
+    }
+
+    /* Prior to version 15, the base address is not reported. */
+    if (version >= 15 && infos.sharedCacheBaseAddress != 0) {
+        cache->base_address = infos.sharedCacheBaseAddress;
+        cache->size = shared_cache_size(task, cache);
+    }
+
+    if (cache->base_address == 0 && !cache->has_uuid)
+        return PLCRASH_ENOTFOUND;
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Return true if @a address falls within @a cache's mappings.
+ *
+ * @param cache An initialized shared cache record.
+ * @param address The task-relative address to test.
+ */
+bool plcrash_async_shared_cache_contains_address (const plcrash_async_shared_cache_t *cache, pl_vm_address_t address) {
+    if (cache->size == 0)
+        return false;
+
+    return (address >= cache->base_address && address - cache->base_address < cache->size);
+}
+
+/**
+ * @} plcrash_async
+ */
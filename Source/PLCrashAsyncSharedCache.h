@@ -0,0 +1,71 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PLCRASH_ASYNC_SHARED_CACHE_H
+#define PLCRASH_ASYNC_SHARED_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "PLCrashAsync.h"
+
+/**
+ * @internal
+ * @ingroup plcrash_async
+ *
+ * Describes the dyld shared cache mapped into a task.
+ */
+typedef struct plcrash_async_shared_cache {
+    /** The task-relative address at which the shared cache is mapped. */
+    pl_vm_address_t base_address;
+
+    /** The total size, in bytes, of the shared cache's mappings, or 0 if the cache header could not be read. */
+    pl_vm_size_t size;
+
+    /** The shared cache's slide. */
+    pl_vm_off_t slide;
+
+    /** The shared cache UUID. Only valid if @a has_uuid is true. */
+    uint8_t uuid[16];
+
+    /** If true, @a uuid is valid. */
+    bool has_uuid;
+} plcrash_async_shared_cache_t;
+
+plcrash_error_t plcrash_async_shared_cache_init (plcrash_async_shared_cache_t *cache, mach_port_t task);
+bool plcrash_async_shared_cache_contains_address (const plcrash_async_shared_cache_t *cache, pl_vm_address_t address);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PLCRASH_ASYNC_SHARED_CACHE_H */
@@ -0,0 +1,69 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "SenTestCompat.h"
+
+#import "PLCrashAsyncSharedCache.h"
+#import "PLCrashAsyncMachOImage.h"
+
+#import <dlfcn.h>
+
+@interface PLCrashAsyncSharedCacheTests : SenTestCase {
+@private
+}
+
+@end
+
+@implementation PLCrashAsyncSharedCacheTests
+
+/**
+ * Test discovery of the current process' shared cache, and identification of shared cache images.
+ */
+- (void) testSharedCache {
+    plcrash_async_shared_cache_t cache;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_shared_cache_init(&cache, mach_task_self()), @"Failed to find the shared cache");
+    STAssertTrue(cache.has_uuid, @"Shared cache UUID was not found");
+
+    /* libSystem is always loaded from the shared cache */
+    Dl_info info;
+    STAssertTrue(dladdr((const void *) dladdr, &info) > 0, @"Could not fetch dyld info for dladdr()");
+    if (cache.size != 0)
+        STAssertTrue(plcrash_async_shared_cache_contains_address(&cache, (pl_vm_address_t) info.dli_fbase), @"libSystem image is not within the shared cache");
+
+    /* Our own image is never in the shared cache */
+    Dl_info self_info;
+    STAssertTrue(dladdr([self class], &self_info) > 0, @"Could not fetch dyld info for %@", [self class]);
+    STAssertFalse(plcrash_async_shared_cache_contains_address(&cache, (pl_vm_address_t) self_info.dli_fbase), @"Test image reported within the shared cache");
+
+    plcrash_async_macho_t image;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_macho_init(&image, mach_task_self(), self_info.dli_fname, (pl_vm_address_t) self_info.dli_fbase), @"Failed to initialize image");
+    STAssertFalse(plcrash_async_macho_in_shared_cache(&image), @"Test image flagged as a shared cache image");
+    plcrash_nasync_macho_free(&image);
+}
+
+@end
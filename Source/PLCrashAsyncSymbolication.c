@@ -27,8 +27,12 @@
  */
 
 #include "PLCrashAsyncSymbolication.h"
+#include "PLCrashProbes.h"
 
 #include <inttypes.h>
+#include <string.h>
+
+#include <mach/mach_time.h>
 
 /**
  * @internal
@@ -36,20 +40,86 @@
  * @{
  */
 
-/* Maximum symbol name size */
-#define SYMBOL_NAME_BUFLEN 256
+/**
+ * Size of the buffer used to synthesize Objective-C method names, including the terminating NULL. Longer names
+ * will be truncated. Symbol table names are passed through from the image's string table, and are not subject
+ * to this limit. May be overridden at build time.
+ */
+#ifndef PLCRASH_ASYNC_SYMBOL_NAME_BUFLEN
+#define PLCRASH_ASYNC_SYMBOL_NAME_BUFLEN 1024
+#endif
 
+/**
+ * @internal
+ *
+ * Symbol look-up context shared by the Mach-O and Objective-C callbacks. The Objective-C look-up is performed first;
+ * if the symbol table provides a better match, its name is handed directly to the caller from the mapped string
+ * table, without an intermediate copy.
+ */
 struct symbol_lookup_ctx {
-    /** Buffer to which the symbol name should be written. */
-    char buffer[SYMBOL_NAME_BUFLEN];
+    /** Buffer to which a synthesized Objective-C symbol name is written. */
+    char buffer[PLCRASH_ASYNC_SYMBOL_NAME_BUFLEN];
 
     /** If true, the symbol was found. If false, no symbol was found */
     bool found;
 
+    /** If true, the result has been delivered to @a callback (and the cache). */
+    bool emitted;
+
     /** Address of the discovered symbol, or 0x0 if not found. */
     pl_vm_address_t symbol_address;
+
+    /** The cache to be populated with the result. */
+    plcrash_async_symbol_cache_t *cache;
+
+    /** The look-up strategy. */
+    plcrash_async_symbol_strategy_t strategy;
+
+    /** The PC being looked up. */
+    pl_vm_address_t pc;
+
+    /** The caller's result callback. */
+    plcrash_async_found_symbol_cb callback;
+
+    /** The context to be provided to @a callback. */
+    void *callback_ctx;
 };
 
+/* Number of entries in the PC look-up cache. Must be a power of two. */
+#define PC_CACHE_ENTRY_COUNT 2048
+
+/* Number of bytes reserved for symbol names in the PC look-up cache. */
+#define PC_CACHE_NAMES_SIZE (PC_CACHE_ENTRY_COUNT * 64)
+
+/* Maximum number of slots probed when looking up or inserting a PC cache entry. */
+#define PC_CACHE_MAX_PROBES 8
+
+/**
+ * @internal
+ *
+ * A single PC look-up cache entry.
+ */
+struct plcrash_async_symbol_cache_entry {
+    /** The PC value of this entry, or 0x0 if the entry is unused. */
+    pl_vm_address_t pc;
+
+    /** The strategy used to perform the cached look-up. */
+    plcrash_async_symbol_strategy_t strategy;
+
+    /** If true, a symbol was found. If false, the look-up failed with @a err. */
+    bool found;
+
+    /** The look-up error, if @a found is false. */
+    plcrash_error_t err;
+
+    /** Address of the discovered symbol. */
+    pl_vm_address_t symbol_address;
+
+    /** Offset of the symbol's NULL-terminated name within the cache's name storage. */
+    uint32_t name_offset;
+};
+
+static void symbol_lookup_emit (struct symbol_lookup_ctx *lookup_ctx, const char *name);
 static void macho_symbol_callback (pl_vm_address_t address, const char *name, void *ctx);
 static void objc_symbol_callback (bool isClassMethod, plcrash_async_macho_string_t *className, plcrash_async_macho_string_t *methodName, pl_vm_address_t imp, void *ctx);
 
@@ -60,7 +130,56 @@ static void objc_symbol_callback (bool isClassMethod, plcrash_async_macho_string
  * @return An error code.
  */
 plcrash_error_t plcrash_async_symbol_cache_init (plcrash_async_symbol_cache_t *cache) {
-    return plcrash_async_objc_cache_init(&cache->objc_cache);
+    cache->pc_cache_entries = NULL;
+    cache->pc_cache_names = NULL;
+    cache->pc_cache_names_used = 0;
+    cache->pc_cache_hits = 0;
+    cache->pc_cache_misses = 0;
+    cache->symbol_table_stats.lookups = 0;
+    cache->symbol_table_stats.elapsed = 0;
+    cache->objc_stats.lookups = 0;
+    cache->objc_stats.elapsed = 0;
+    cache->symbols_scanned = 0;
+    plcrash_async_mobject_pool_init(&cache->mappings);
+
+    plcrash_error_t err = plcrash_async_objc_cache_init(&cache->objc_cache);
+    cache->objc_cache.mappingPool = &cache->mappings;
+
+    return err;
+}
+
+/**
+ * Reset the look-up statistics of @a cache, retaining all cached state. This may be used to report per-use
+ * statistics from a cache that is reused across multiple reports.
+ *
+ * @param cache The cache to reset.
+ */
+void plcrash_async_symbol_cache_reset_stats (plcrash_async_symbol_cache_t *cache) {
+    cache->pc_cache_hits = 0;
+    cache->pc_cache_misses = 0;
+    cache->symbol_table_stats.lookups = 0;
+    cache->symbol_table_stats.elapsed = 0;
+    cache->objc_stats.lookups = 0;
+    cache->objc_stats.elapsed = 0;
+    cache->symbols_scanned = 0;
+}
+
+/**
+ * Record a single look-up in @a stats, begun at @a start.
+ *
+ * @param stats The strategy statistics to update.
+ * @param start The mach_absolute_time() value at which the look-up began.
+ */
+static void symbol_strategy_stats_record (plcrash_async_symbol_strategy_stats_t *stats, uint64_t start) {
+    stats->lookups++;
+    stats->elapsed += mach_absolute_time() - start;
+}
+
+/**
+ * Get the PC look-up cache's total memory allocation size, including both entries and names.
+ */
+static size_t pc_cache_allocation_size (void) {
+    return (sizeof(struct plcrash_async_symbol_cache_entry) * PC_CACHE_ENTRY_COUNT) + PC_CACHE_NAMES_SIZE;
 }
 
 /**
@@ -69,7 +188,111 @@ plcrash_error_t plcrash_async_symbol_cache_init (plcrash_async_symbol_cache_t *c
  * @param cache A pointer to the cache object to free.
  */
 void plcrash_async_symbol_cache_free (plcrash_async_symbol_cache_t *cache) {
+    /* The Objective-C cache's mappings must be released before the pool is freed */
     plcrash_async_objc_cache_free(&cache->objc_cache);
+    plcrash_async_mobject_pool_free(&cache->mappings);
+
+    if (cache->pc_cache_entries != NULL)
+        plcrash_async_scratch_deallocate((vm_address_t) cache->pc_cache_entries, pc_cache_allocation_size());
+}
+
+/**
+ * Compute the initial PC look-up cache index for @a pc.
+ */
+static size_t pc_cache_index (pl_vm_address_t pc) {
+    return (size_t) (((uint64_t) pc * 0x9E3779B97F4A7C15ULL) >> 32) & (PC_CACHE_ENTRY_COUNT - 1);
+}
+
+/**
+ * Look up a PC within the cache.
+ *
+ * @param cache The cache.
+ * @param strategy The look-up strategy.
+ * @param pc The PC to look up.
+ * @return The matching cache entry, or NULL if none was found.
+ */
+static struct plcrash_async_symbol_cache_entry *pc_cache_lookup (plcrash_async_symbol_cache_t *cache, plcrash_async_symbol_strategy_t strategy, pl_vm_address_t pc) {
+    if (cache->pc_cache_entries == NULL || pc == 0x0)
+        return NULL;
+
+    size_t index = pc_cache_index(pc);
+    for (size_t i = 0; i < PC_CACHE_MAX_PROBES; i++) {
+        struct plcrash_async_symbol_cache_entry *entry = &cache->pc_cache_entries[(index + i) & (PC_CACHE_ENTRY_COUNT - 1)];
+        if (entry->pc == 0x0)
+            return NULL;
+
+        if (entry->pc == pc && entry->strategy == strategy)
+            return entry;
+    }
+
+    return NULL;
+}
+
+/**
+ * Store a look-up result in the cache. The cache is not guaranteed storage; storing may silently fail
+ * if the cache can not be allocated, the probe limit is reached, or name storage has been exhausted.
+ *
+ * @param cache The cache.
+ * @param strategy The look-up strategy.
+ * @param pc The PC that was looked up.
+ * @param err The look-up result.
+ * @param symbol_address The symbol address, if @a err is PLCRASH_ESUCCESS.
+ * @param name The symbol name, if @a err is PLCRASH_ESUCCESS.
+ */
+static void pc_cache_set (plcrash_async_symbol_cache_t *cache, plcrash_async_symbol_strategy_t strategy, pl_vm_address_t pc, plcrash_error_t err, pl_vm_address_t symbol_address, const char *name) {
+    if (pc == 0x0)
+        return;
+
+    /* If nothing has used the cache yet, allocate the memory. */
+    if (cache->pc_cache_entries == NULL) {
+        vm_address_t addr;
+        kern_return_t kt = plcrash_async_scratch_allocate(&addr, pc_cache_allocation_size());
+        /* If it fails, just bail out. We don't need the cache for correct operation. */
+        if (kt != KERN_SUCCESS) {
+            PLCF_DEBUG("plcrash_async_scratch_allocate failed with error %x, the PC symbol cache could not be initialized", kt);
+            return;
+        }
+
+        /* scratch allocations are zero-filled; all entries are unused */
+        cache->pc_cache_entries = (struct plcrash_async_symbol_cache_entry *) addr;
+        cache->pc_cache_names = (char *) (cache->pc_cache_entries + PC_CACHE_ENTRY_COUNT);
+        cache->pc_cache_names_used = 0;
+    }
+
+    /* Find a free slot */
+    struct plcrash_async_symbol_cache_entry *entry = NULL;
+    size_t index = pc_cache_index(pc);
+    for (size_t i = 0; i < PC_CACHE_MAX_PROBES; i++) {
+        struct plcrash_async_symbol_cache_entry *candidate = &cache->pc_cache_entries[(index + i) & (PC_CACHE_ENTRY_COUNT - 1)];
+        if (candidate->pc == 0x0) {
+            entry = candidate;
+            break;
+        }
+    }
+
+    if (entry == NULL)
+        return;
+
+    /* Copy out the name */
+    uint32_t name_offset = 0;
+    if (err == PLCRASH_ESUCCESS) {
+        size_t len = strlen(name) + 1;
+        if (len > PC_CACHE_NAMES_SIZE - cache->pc_cache_names_used)
+            return;
+
+        name_offset = (uint32_t) cache->pc_cache_names_used;
+        plcrash_async_memcpy(cache->pc_cache_names + name_offset, name, len);
+        cache->pc_cache_names_used += len;
+    }
+
+    entry->strategy = strategy;
+    entry->found = (err == PLCRASH_ESUCCESS);
+    entry->err = err;
+    entry->symbol_address = symbol_address;
+    entry->name_offset = name_offset;
+
+    /* Populate the key last; the entry is not considered valid until the PC is set. */
+    entry->pc = pc;
 }
 
 /**
@@ -96,20 +319,62 @@ plcrash_error_t plcrash_async_find_symbol (plcrash_async_macho_t *image,
     plcrash_error_t machoErr = PLCRASH_ENOTFOUND;
     plcrash_error_t objcErr = PLCRASH_ENOTFOUND;
 
+    /* Check for a previously cached result */
+    struct plcrash_async_symbol_cache_entry *entry = pc_cache_lookup(cache, strategy, pc);
+    if (entry != NULL) {
+        cache->pc_cache_hits++;
+        if (!entry->found)
+            return entry->err;
+
+        callback(entry->symbol_address, cache->pc_cache_names + entry->name_offset, ctx);
+        return PLCRASH_ESUCCESS;
+    }
+    cache->pc_cache_misses++;
+
     lookup_ctx.symbol_address = 0x0;
     lookup_ctx.found = false;
+    lookup_ctx.emitted = false;
+    lookup_ctx.cache = cache;
+    lookup_ctx.strategy = strategy;
+    lookup_ctx.pc = pc;
+    lookup_ctx.callback = callback;
+    lookup_ctx.callback_ctx = ctx;
 
     /* Perform lookups; our callbacks will only update the lookup_ctx if they find a better match than the
-     * previously run callbacks */
-    if (strategy & PLCRASH_ASYNC_SYMBOL_STRATEGY_SYMBOL_TABLE)
-        machoErr = plcrash_async_macho_find_symbol_by_pc(image, pc, macho_symbol_callback, &lookup_ctx);
-    
-    if (strategy & PLCRASH_ASYNC_SYMBOL_STRATEGY_OBJC)
+     * previously run callbacks. The symbol table is searched last, allowing a winning symbol table name to be
+     * emitted directly from the mapped string table. */
+    if (strategy & PLCRASH_ASYNC_SYMBOL_STRATEGY_OBJC) {
+        uint64_t start = mach_absolute_time();
         objcErr = plcrash_async_objc_find_method(image, &cache->objc_cache, pc, objc_symbol_callback, &lookup_ctx);
+        symbol_strategy_stats_record(&cache->objc_stats, start);
+    }
+
+    /* If the Objective-C method begins exactly at the start of the function containing the PC, no symbol table entry
+     * can supersede it; skip the symbol table search. This is only checked against a decoded function starts table;
+     * decoding the table from __LINKEDIT would cost as much as the symbol table search it avoids. */
+    bool skip_symbol_table = false;
+    pl_vm_address_t function_start;
+    if (objcErr == PLCRASH_ESUCCESS && lookup_ctx.found && (strategy & PLCRASH_ASYNC_SYMBOL_STRATEGY_SYMBOL_TABLE) &&
+        image->function_starts != NULL &&
+        plcrash_async_macho_find_function_start(image, &cache->mappings, pc, &function_start) == PLCRASH_ESUCCESS)
+    {
+        skip_symbol_table = (function_start == lookup_ctx.symbol_address);
+    }
+
+    if ((strategy & PLCRASH_ASYNC_SYMBOL_STRATEGY_SYMBOL_TABLE) && !skip_symbol_table) {
+        uint64_t start = mach_absolute_time();
+        machoErr = plcrash_async_macho_find_symbol_by_pc(image, &cache->mappings, pc, macho_symbol_callback, &lookup_ctx);
+        symbol_strategy_stats_record(&cache->symbol_table_stats, start);
+        cache->symbols_scanned += plcrash_async_macho_symbol_scan_count(image);
+    }
+
+    PLCR_PROBE_EVENT("symbol_lookup", "pc=0x%llx strategy=%d objc=%d symtab=%d scanned=%u", (unsigned long long) pc,
+                     (int) strategy, (int) objcErr, (int) machoErr, plcrash_async_macho_symbol_scan_count(image));
 
     if (machoErr != PLCRASH_ESUCCESS && objcErr != PLCRASH_ESUCCESS) {
         PLCF_DEBUG("Could not find symbol for PC %" PRIx64 " image %p", (uint64_t) pc, image);
         PLCF_DEBUG("pl_async_macho_find_symbol error %d, pl_async_objc_find_method error %d", machoErr, objcErr);
+        pc_cache_set(cache, strategy, pc, machoErr, 0x0, NULL);
         return machoErr;
     }
 
@@ -120,54 +385,229 @@ plcrash_error_t plcrash_async_find_symbol (plcrash_async_macho_t *image,
         return PLCRASH_EINTERNAL;
     }
 
-    callback(lookup_ctx.symbol_address, lookup_ctx.buffer, ctx);
+    /* If the symbol table did not provide the best match, emit the synthesized Objective-C name */
+    if (!lookup_ctx.emitted)
+        symbol_lookup_emit(&lookup_ctx, lookup_ctx.buffer);
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * @internal
+ *
+ * Batch look-up context used by plcrash_async_find_symbols().
+ */
+struct symbol_batch_ctx {
+    plcrash_async_macho_t *image;
+    plcrash_async_symbol_strategy_t strategy;
+    plcrash_async_symbol_cache_t *cache;
+    plcrash_async_macho_symbol_match_t *matches;
+    plcrash_error_t *results;
+    plcrash_async_found_symbols_cb callback;
+    void *ctx;
+};
+
+/**
+ * @internal
+ *
+ * Adapts a single-PC plcrash_async_find_symbol() result to a plcrash_async_found_symbols_cb.
+ */
+struct symbol_batch_single_ctx {
+    struct symbol_batch_ctx *batch;
+    size_t index;
+};
+
+static void symbol_batch_single_callback (pl_vm_address_t address, const char *name, void *ctx) {
+    struct symbol_batch_single_ctx *single = ctx;
+    single->batch->callback(single->index, address, name, single->batch->ctx);
+}
+
+/**
+ * @internal
+ *
+ * Complete the look-up of a single batched PC, given the result of the batched symbol table search. This applies the
+ * same PC cache, Objective-C and best-match handling as plcrash_async_find_symbol().
+ */
+static void symbol_batch_callback (size_t index, plcrash_error_t machoErr, pl_vm_address_t address, const char *name, void *ctx) {
+    struct symbol_batch_ctx *batch = ctx;
+    pl_vm_address_t pc = batch->matches[index].pc;
+    plcrash_async_symbol_cache_t *cache = batch->cache;
+    plcrash_error_t objcErr = PLCRASH_ENOTFOUND;
+    struct symbol_batch_single_ctx single = { .batch = batch, .index = index };
+    struct symbol_lookup_ctx lookup_ctx;
+
+    /* Check for a previously cached result */
+    struct plcrash_async_symbol_cache_entry *entry = pc_cache_lookup(cache, batch->strategy, pc);
+    if (entry != NULL) {
+        cache->pc_cache_hits++;
+        batch->results[index] = entry->found ? PLCRASH_ESUCCESS : entry->err;
+        if (entry->found)
+            batch->callback(index, entry->symbol_address, cache->pc_cache_names + entry->name_offset, batch->ctx);
+        return;
+    }
+    cache->pc_cache_misses++;
+
+    lookup_ctx.symbol_address = 0x0;
+    lookup_ctx.found = false;
+    lookup_ctx.emitted = false;
+    lookup_ctx.cache = cache;
+    lookup_ctx.strategy = batch->strategy;
+    lookup_ctx.pc = pc;
+    lookup_ctx.callback = symbol_batch_single_callback;
+    lookup_ctx.callback_ctx = &single;
+
+    /* Apply the results in the same order as plcrash_async_find_symbol(); @a name remains valid for the
+     * duration of this callback, and will be emitted without copying if it is the best match. */
+    batch->results[index] = PLCRASH_ESUCCESS;
+
+    if (batch->strategy & PLCRASH_ASYNC_SYMBOL_STRATEGY_OBJC) {
+        uint64_t start = mach_absolute_time();
+        objcErr = plcrash_async_objc_find_method(batch->image, &cache->objc_cache, pc, objc_symbol_callback, &lookup_ctx);
+        symbol_strategy_stats_record(&cache->objc_stats, start);
+    }
+
+    if (machoErr == PLCRASH_ESUCCESS)
+        macho_symbol_callback(address, name, &lookup_ctx);
+
+    if (machoErr != PLCRASH_ESUCCESS && objcErr != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("Could not find symbol for PC %" PRIx64 " image %p", (uint64_t) pc, batch->image);
+        pc_cache_set(cache, batch->strategy, pc, machoErr, 0x0, NULL);
+        batch->results[index] = machoErr;
+        return;
+    }
+
+    if (!lookup_ctx.found) {
+        PLCF_DEBUG("Unexpected error occured in symbol lookup callbacks for PC %" PRIx64 "image %p; returning error", (uint64_t) pc, batch->image);
+        batch->results[index] = PLCRASH_EINTERNAL;
+        return;
+    }
+
+    if (!lookup_ctx.emitted)
+        symbol_lookup_emit(&lookup_ctx, lookup_ctx.buffer);
+}
+
+/**
+ * Find the best-guess matching symbol names for a batch of PCs within a single image. The results are identical to
+ * those of calling plcrash_async_find_symbol() for each PC, but the image's symbol table is read only once for the
+ * entire batch.
+ *
+ * @param image The Mach-O image to search for the symbols. All PCs must fall within this image.
+ * @param strategy The look-up strategy to be used to find the symbols.
+ * @param cache The task-specific cache to use for lookups.
+ * @param matches The PCs to be symbolicated; the pc field of each entry must be populated by the caller. The remaining
+ * fields are used as scratch space.
+ * @param count The number of entries in @a matches.
+ * @param results On return, the look-up result for each entry in @a matches. Must have room for @a count values.
+ * @param callback The callback to be issued for each PC for which a matching symbol is found.
+ * @param ctx The context to be provided to @a callback.
+ *
+ * @return Returns PLCRASH_ESUCCESS if the batch was processed; the per-PC results are returned via @a results.
+ */
+plcrash_error_t plcrash_async_find_symbols (plcrash_async_macho_t *image,
+                                            plcrash_async_symbol_strategy_t strategy,
+                                            plcrash_async_symbol_cache_t *cache,
+                                            plcrash_async_macho_symbol_match_t *matches,
+                                            size_t count,
+                                            plcrash_error_t *results,
+                                            plcrash_async_found_symbols_cb callback,
+                                            void *ctx)
+{
+    struct symbol_batch_ctx batch = {
+        .image = image,
+        .strategy = strategy,
+        .cache = cache,
+        .matches = matches,
+        .results = results,
+        .callback = callback,
+        .ctx = ctx
+    };
+
+    /* Search the symbol table once for all PCs */
+    if (strategy & PLCRASH_ASYNC_SYMBOL_STRATEGY_SYMBOL_TABLE) {
+        /* The Objective-C look-ups are performed from within the batch callback; their time is excluded from the
+         * symbol table statistics. */
+        uint64_t objc_elapsed = cache->objc_stats.elapsed;
+        uint32_t misses = cache->pc_cache_misses;
+        uint64_t start = mach_absolute_time();
+        uint32_t scanned = plcrash_async_macho_symbol_scan_count(image);
+        bool indexed = (image->symbol_index != NULL);
+
+        plcrash_error_t err = plcrash_async_macho_find_symbols_by_pc(image, &cache->mappings, matches, count, symbol_batch_callback, &batch);
+        if (err == PLCRASH_ESUCCESS) {
+            /* PCs served from the PC cache are counted as cache hits by the batch callback, and are not counted
+             * as symbol table look-ups; the search itself was still performed for the entire batch. */
+            cache->symbol_table_stats.lookups += cache->pc_cache_misses - misses;
+            cache->symbol_table_stats.elapsed += (mach_absolute_time() - start) - (cache->objc_stats.elapsed - objc_elapsed);
+            cache->symbols_scanned += indexed ? (uint64_t) scanned * count : scanned;
+            return PLCRASH_ESUCCESS;
+        }
+    }
+
+    /* Otherwise (or if the symbol table is unreadable), look up each PC individually */
+    for (size_t i = 0; i < count; i++) {
+        struct symbol_batch_single_ctx single = { .batch = &batch, .index = i };
+        results[i] = plcrash_async_find_symbol(image, strategy, cache, matches[i].pc, symbol_batch_single_callback, &single);
+    }
+
     return PLCRASH_ESUCCESS;
 }
 
 /**
- * Append a character to the given @a str, enforcing byte @a limit.
+ * Append @a len bytes of @a src to the given @a str, enforcing byte @a limit.
  *
- * @param str String to which character should be appended.
- * @param c Character to append.
+ * @param str String to which the bytes should be appended.
+ * @param src The bytes to append.
+ * @param len The number of bytes to append.
  * @param cursor Cursor used to store the current write position.
  * @param limit Maximum number of bytes that may be written to @a str.
  *
- * @return Returns true if the character was appended successfully, false
- * if the character limit was reached.
+ * @return Returns true if all bytes were appended successfully, false
+ * if the byte limit was reached.
  */
-static inline bool append_char(char *str, char c, int *cursor, int limit) {
-    if (*cursor >= limit)
-        return false;
-    
-    str[(*cursor)++] = c;
-    return true;
+static inline bool append_bytes(char *str, const char *src, size_t len, size_t *cursor, size_t limit) {
+    bool complete = true;
+    if (len > limit - *cursor) {
+        len = limit - *cursor;
+        complete = false;
+    }
+
+    plcrash_async_memcpy(str + *cursor, src, len);
+    *cursor += len;
+    return complete;
 }
 
 /**
  * @internal
  *
- * Record the Mach-O symbol in @a ctx.
+ * Deliver the found symbol to the caller's callback, and record it in the PC cache.
+ *
+ * @param lookup_ctx The look-up context. The symbol must have been found.
+ * @param name The symbol name; this may point directly into the image's mapped string table.
+ */
+static void symbol_lookup_emit (struct symbol_lookup_ctx *lookup_ctx, const char *name) {
+    pc_cache_set(lookup_ctx->cache, lookup_ctx->strategy, lookup_ctx->pc, PLCRASH_ESUCCESS, lookup_ctx->symbol_address, name);
+    lookup_ctx->callback(lookup_ctx->symbol_address, name, lookup_ctx->callback_ctx);
+    lookup_ctx->emitted = true;
+}
+
+/**
+ * @internal
+ *
+ * Record the Mach-O symbol in @a ctx. If it is the best match, it is emitted immediately, while @a name
+ * remains valid.
  */
 static void macho_symbol_callback (pl_vm_address_t address, const char *name, void *ctx) {
     struct symbol_lookup_ctx *lookup_ctx = ctx;
 
-    /* Skip this match if a better match has already been found */
-    if (lookup_ctx->found && address < lookup_ctx->symbol_address)
+    /* Skip this match if an equal or better Objective-C match has already been found */
+    if (lookup_ctx->found && address <= lookup_ctx->symbol_address)
         return;
     
     /* Mark as found */
     lookup_ctx->symbol_address = address;
     lookup_ctx->found = true;
 
-    /* Write out the symbol name; we set the limit with room for a terminating NULL */
-    int limit = SYMBOL_NAME_BUFLEN - 1;
-    int cursor = 0;
-
-    for (const char *p = name; *p != '\0'; p++)
-        if (!append_char(lookup_ctx->buffer, *p, &cursor, limit))
-            break;
-
-    append_char(lookup_ctx->buffer, '\0', &cursor, limit+1);
+    symbol_lookup_emit(lookup_ctx, name);
 }
 
 
@@ -211,30 +651,17 @@ static void objc_symbol_callback (bool isClassMethod, plcrash_async_macho_string
     }
 
     /* Write out the symbol name; we set the limit with room for a terminating NULL */
-    int limit = SYMBOL_NAME_BUFLEN - 1;
-    int cursor = 0;
-
-    append_char(lookup_ctx->buffer, isClassMethod ? '+' : '-', &cursor, limit);
-    append_char(lookup_ctx->buffer, '[', &cursor, limit);
-
-    for (pl_vm_size_t i = 0; i < classNameLength; i++) {
-        bool success = append_char(lookup_ctx->buffer, classNamePtr[i], &cursor, limit);
-        if (!success)
-            break;
-    }
-    
-    append_char(lookup_ctx->buffer, ' ', &cursor, limit);
-    
-    for (pl_vm_size_t i = 0; i < methodNameLength; i++) {
-        bool success = append_char(lookup_ctx->buffer, methodNamePtr[i], &cursor, limit);
-        if (!success)
-            break;
-    }
+    size_t limit = sizeof(lookup_ctx->buffer) - 1;
+    size_t cursor = 0;
 
-    append_char(lookup_ctx->buffer, ']', &cursor, limit);
+    append_bytes(lookup_ctx->buffer, isClassMethod ? "+[" : "-[", 2, &cursor, limit);
+    append_bytes(lookup_ctx->buffer, classNamePtr, classNameLength, &cursor, limit);
+    append_bytes(lookup_ctx->buffer, " ", 1, &cursor, limit);
+    append_bytes(lookup_ctx->buffer, methodNamePtr, methodNameLength, &cursor, limit);
+    append_bytes(lookup_ctx->buffer, "]", 1, &cursor, limit);
 
     /* NULL terminate */
-    append_char(lookup_ctx->buffer, '\0', &cursor, limit+1);
+    lookup_ctx->buffer[cursor] = '\0';
 
     /* Save the address. */
     lookup_ctx->symbol_address = imp;
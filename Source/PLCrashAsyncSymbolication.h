@@ -78,6 +78,19 @@ typedef enum {
     PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL = (PLCRASH_ASYNC_SYMBOL_STRATEGY_SYMBOL_TABLE|PLCRASH_ASYNC_SYMBOL_STRATEGY_OBJC)
 } plcrash_async_symbol_strategy_t;
 
+/**
+ * @internal
+ *
+ * Per-strategy symbol look-up statistics.
+ */
+typedef struct plcrash_async_symbol_strategy_stats {
+    /** Number of look-ups performed using this strategy. */
+    uint32_t lookups;
+
+    /** Total time spent performing look-ups using this strategy, in mach_absolute_time() units. */
+    uint64_t elapsed;
+} plcrash_async_symbol_strategy_stats_t;
+
 /**
  * @internal
  *
@@ -90,9 +103,37 @@ typedef enum {
 typedef struct plcrash_async_symbol_cache {
     /** Objective-C look-up cache. */
     plcrash_async_objc_cache_t objc_cache;
+
+    /** Mapping pool shared by the symbol table and Objective-C look-ups. */
+    plcrash_async_mobject_pool_t mappings;
+
+    /** PC look-up cache. Lazily allocated on first use; NULL if unallocated, or if allocation failed. */
+    struct plcrash_async_symbol_cache_entry *pc_cache_entries;
+
+    /** Symbol name storage backing the PC look-up cache entries. Allocated alongside @a pc_cache_entries. */
+    char *pc_cache_names;
+
+    /** Number of bytes of @a pc_cache_names currently in use. */
+    size_t pc_cache_names_used;
+
+    /** Number of PC look-ups served from the PC look-up cache. */
+    uint32_t pc_cache_hits;
+
+    /** Number of PC look-ups that could not be served from the PC look-up cache. */
+    uint32_t pc_cache_misses;
+
+    /** Symbol table (PLCRASH_ASYNC_SYMBOL_STRATEGY_SYMBOL_TABLE) look-up statistics. */
+    plcrash_async_symbol_strategy_stats_t symbol_table_stats;
+
+    /** Objective-C (PLCRASH_ASYNC_SYMBOL_STRATEGY_OBJC) look-up statistics. */
+    plcrash_async_symbol_strategy_stats_t objc_stats;
+
+    /** Upper bound on the number of symbol table entries examined by symbol table look-ups. */
+    uint64_t symbols_scanned;
 } plcrash_async_symbol_cache_t;
 
 plcrash_error_t plcrash_async_symbol_cache_init (plcrash_async_symbol_cache_t *cache);
+void plcrash_async_symbol_cache_reset_stats (plcrash_async_symbol_cache_t *cache);
 void plcrash_async_symbol_cache_free (plcrash_async_symbol_cache_t *cache);
 
 
@@ -112,6 +153,26 @@ plcrash_error_t plcrash_async_find_symbol(plcrash_async_macho_t *image,
                                           pl_vm_address_t pc,
                                           plcrash_async_found_symbol_cb callback,
                                           void *ctx);
+
+/**
+ * Prototype of a callback function used to return the results of plcrash_async_find_symbols().
+ *
+ * @param index The index of the PC within the batch.
+ * @param address The symbol address.
+ * @param name The symbol name. The callback is responsible for copying this value, as its backing storage is not gauranteed to exist
+ * after the callback returns.
+ * @param ctx The API client's supplied context value.
+ */
+typedef void (*plcrash_async_found_symbols_cb)(size_t index, pl_vm_address_t address, const char *name, void *ctx);
+
+plcrash_error_t plcrash_async_find_symbols(plcrash_async_macho_t *image,
+                                           plcrash_async_symbol_strategy_t strategy,
+                                           plcrash_async_symbol_cache_t *cache,
+                                           plcrash_async_macho_symbol_match_t *matches,
+                                           size_t count,
+                                           plcrash_error_t *results,
+                                           plcrash_async_found_symbols_cb callback,
+                                           void *ctx);
     
 #ifdef __cplusplus
 }
@@ -43,6 +43,10 @@
 
 @end
 
+/* Expand and stringify a macro argument */
+#define PLCRASH_TEST_STRINGIFY_(x) #x
+#define PLCRASH_TEST_STRINGIFY(x) PLCRASH_TEST_STRINGIFY_(x)
+
 @implementation PLCrashAsyncSymbolicationTests
 
 - (void) setUp {
@@ -117,6 +121,139 @@ void PLCrashAsyncLocalSymbolicationTestsDummyFunction(void) {}
     plcrash_async_symbol_cache_free(&findContext);
 }
 
+/* A symbol whose name exceeds the Objective-C name buffer used by the symbolication APIs; must be non-static. */
+#define LONG_FUNCTION_NAME PLCrashAsyncLocalSymbolicationTestsLongFunction_012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789
+void LONG_FUNCTION_NAME (void);
+void LONG_FUNCTION_NAME (void) {}
+
+/**
+ * Verify that symbol table names are returned in full, rather than being truncated to a fixed-size buffer.
+ */
+- (void) testFindLongSymbol {
+    struct testFindSymbol_cb_ctx ctx = {};
+    plcrash_async_symbol_cache_t findContext;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_symbol_cache_init(&findContext), @"Failed to initialize cache");
+
+    plcrash_error_t err = plcrash_async_find_symbol(&_image, PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, &findContext, (pl_vm_address_t) LONG_FUNCTION_NAME, testFindSymbol_cb, &ctx);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"Got error trying to find symbol");
+    STAssertEquals(ctx.addr, (pl_vm_address_t) LONG_FUNCTION_NAME, @"Got bad address finding symbol");
+
+    const char *expected = "_" PLCRASH_TEST_STRINGIFY(LONG_FUNCTION_NAME);
+    STAssertTrue(strlen(expected) > 256, @"Test symbol name is too short");
+    STAssertEqualCStrings(ctx.name, expected, @"Got wrong symbol name");
+
+    free(ctx.name);
+    plcrash_async_symbol_cache_free(&findContext);
+}
+
+/* testFindSymbols callback; records each result in an array of testFindSymbol_cb_ctx */
+static void testFindSymbols_cb (size_t index, pl_vm_address_t address, const char *name, void *ctx) {
+    struct testFindSymbol_cb_ctx *results = ctx;
+    results[index].addr = address;
+    results[index].name = strdup(name);
+}
+
+/**
+ * Verify that batched lookups return the same results as individual lookups, including Objective-C symbols.
+ */
+- (void) testFindSymbols {
+    struct testFindSymbol_cb_ctx results[2] = {};
+    plcrash_error_t errors[2];
+    plcrash_async_macho_symbol_match_t matches[2];
+    plcrash_error_t err;
+
+    plcrash_async_symbol_cache_t findContext;
+    err = plcrash_async_symbol_cache_init(&findContext);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"Failed to initialize cache");
+
+    matches[0].pc = [[[NSThread callStackReturnAddresses] objectAtIndex: 0] longLongValue];
+    matches[1].pc = (pl_vm_address_t)PLCrashAsyncLocalSymbolicationTestsDummyFunction;
+
+    err = plcrash_async_find_symbols(&_image, PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, &findContext, matches, 2, errors, testFindSymbols_cb, results);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"Got error trying to find symbols");
+
+    STAssertEquals(errors[0], PLCRASH_ESUCCESS, @"Got error trying to find symbol");
+    STAssertEquals(results[0].addr, (pl_vm_address_t)[self methodForSelector: _cmd], @"Got bad address finding symbol");
+    STAssertEqualCStrings(results[0].name, "-[PLCrashAsyncSymbolicationTests testFindSymbols]", @"Got wrong symbol name");
+
+    STAssertEquals(errors[1], PLCRASH_ESUCCESS, @"Got error trying to find symbol");
+    STAssertEquals(results[1].addr, (pl_vm_address_t)PLCrashAsyncLocalSymbolicationTestsDummyFunction, @"Got bad address finding symbol");
+    STAssertEqualCStrings(results[1].name, "_PLCrashAsyncLocalSymbolicationTestsDummyFunction", @"Got wrong symbol name");
+
+    free(results[0].name);
+    free(results[1].name);
+    plcrash_async_symbol_cache_free(&findContext);
+}
+
+/**
+ * Verify that batched PCs served from the PC cache are counted as cache hits, and not as symbol table look-ups.
+ */
+- (void) testFindSymbolsCacheStatistics {
+    struct testFindSymbol_cb_ctx ctx = {};
+    struct testFindSymbol_cb_ctx results[2] = {};
+    plcrash_error_t errors[2];
+    plcrash_async_macho_symbol_match_t matches[2];
+    plcrash_error_t err;
+
+    plcrash_async_symbol_cache_t findContext;
+    err = plcrash_async_symbol_cache_init(&findContext);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"Failed to initialize cache");
+
+    /* Populate the cache with the first PC */
+    matches[0].pc = (pl_vm_address_t)PLCrashAsyncLocalSymbolicationTestsDummyFunction;
+    matches[1].pc = [[[NSThread callStackReturnAddresses] objectAtIndex: 0] longLongValue];
+
+    err = plcrash_async_find_symbol(&_image, PLCRASH_ASYNC_SYMBOL_STRATEGY_SYMBOL_TABLE, &findContext, matches[0].pc, testFindSymbol_cb, &ctx);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"Got error trying to find symbol");
+    free(ctx.name);
+    plcrash_async_symbol_cache_reset_stats(&findContext);
+
+    /* Only the uncached PC is a symbol table look-up */
+    err = plcrash_async_find_symbols(&_image, PLCRASH_ASYNC_SYMBOL_STRATEGY_SYMBOL_TABLE, &findContext, matches, 2, errors, testFindSymbols_cb, results);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"Got error trying to find symbols");
+    STAssertEquals(errors[0], PLCRASH_ESUCCESS, @"Got error trying to find symbol");
+    STAssertEquals(errors[1], PLCRASH_ESUCCESS, @"Got error trying to find symbol");
+
+    STAssertEquals(findContext.pc_cache_hits, (uint32_t)1, @"Expected a cache hit");
+    STAssertEquals(findContext.pc_cache_misses, (uint32_t)1, @"Expected a cache miss");
+    STAssertEquals(findContext.symbol_table_stats.lookups, (uint32_t)1, @"Cache hit was counted as a symbol table look-up");
+
+    free(results[0].name);
+    free(results[1].name);
+    plcrash_async_symbol_cache_free(&findContext);
+}
+
+/**
+ * Verify that repeated lookups of a PC are served from the PC cache.
+ */
+- (void) testFindSymbolCache {
+    struct testFindSymbol_cb_ctx ctx = {};
+    plcrash_error_t err;
+    
+    plcrash_async_symbol_cache_t findContext;
+    err = plcrash_async_symbol_cache_init(&findContext);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"Failed to initialize cache");
+    
+    /* Populate the cache */
+    err = plcrash_async_find_symbol(&_image, PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, &findContext, (pl_vm_address_t)PLCrashAsyncLocalSymbolicationTestsDummyFunction, testFindSymbol_cb, &ctx);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"Got error trying to find symbol");
+    STAssertEquals(findContext.pc_cache_hits, (uint32_t)0, @"Unexpected cache hit");
+    STAssertEquals(findContext.pc_cache_misses, (uint32_t)1, @"Expected a cache miss");
+    free(ctx.name);
+    ctx.name = NULL;
+    
+    /* Verify that the cached result matches */
+    err = plcrash_async_find_symbol(&_image, PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, &findContext, (pl_vm_address_t)PLCrashAsyncLocalSymbolicationTestsDummyFunction, testFindSymbol_cb, &ctx);
+    STAssertEquals(err, PLCRASH_ESUCCESS, @"Got error trying to find symbol");
+    STAssertEquals(findContext.pc_cache_hits, (uint32_t)1, @"Expected a cache hit");
+    STAssertEquals(findContext.pc_cache_misses, (uint32_t)1, @"Unexpected cache miss");
+    STAssertEquals(ctx.addr, (pl_vm_address_t)PLCrashAsyncLocalSymbolicationTestsDummyFunction, @"Got bad address finding symbol");
+    STAssertEqualCStrings(ctx.name, "_PLCrashAsyncLocalSymbolicationTestsDummyFunction", @"Got wrong symbol name");
+    free(ctx.name);
+    
+    plcrash_async_symbol_cache_free(&findContext);
+}
+
 - (void) testStrategyFlags {
     struct testFindSymbol_cb_ctx ctx = {};
     plcrash_error_t err;
@@ -31,6 +31,7 @@
 
 #import <fcntl.h>
 #import <sys/stat.h>
+#import <sys/mman.h>
 
 @interface PLCrashAsyncTests : SenTestCase {
 @private
@@ -77,6 +78,19 @@
     }
 }
 
+- (void) testByteOrderSwap {
+    STAssertTrue(plcrash_async_byteorder_direct.native, @"Direct byte order should be native");
+    STAssertFalse(plcrash_async_byteorder_swapped.native, @"Swapped byte order should not be native");
+
+    STAssertEquals(plcrash_async_swap16(&plcrash_async_byteorder_direct, 0x0102), (uint16_t) 0x0102, @"Incorrect swap");
+    STAssertEquals(plcrash_async_swap32(&plcrash_async_byteorder_direct, 0x01020304), (uint32_t) 0x01020304, @"Incorrect swap");
+    STAssertEquals(plcrash_async_swap64(&plcrash_async_byteorder_direct, 0x0102030405060708ULL), (uint64_t) 0x0102030405060708ULL, @"Incorrect swap");
+
+    STAssertEquals(plcrash_async_swap16(&plcrash_async_byteorder_swapped, 0x0102), (uint16_t) 0x0201, @"Incorrect swap");
+    STAssertEquals(plcrash_async_swap32(&plcrash_async_byteorder_swapped, 0x01020304), (uint32_t) 0x04030201, @"Incorrect swap");
+    STAssertEquals(plcrash_async_swap64(&plcrash_async_byteorder_swapped, 0x0102030405060708ULL), (uint64_t) 0x0807060504030201ULL, @"Incorrect swap");
+}
+
 - (void) testApplyAddress {
     pl_vm_address_t result;
     
@@ -108,6 +122,29 @@
     STAssertEquals(PLCRASH_ENOMEM, plcrash_async_task_memcpy(mach_task_self(), PL_VM_ADDRESS_MAX, 1, dest, sizeof(bytes)), @"Bad read was performed");
 }
 
+- (void) testTaskMemcpyBatch {
+    const uint8_t bytes[] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07 };
+    uint8_t dest[3][2];
+
+    // Verify that coalesced reads succeed
+    plcrash_async_task_read_t reads[] = {
+        { (pl_vm_address_t) &bytes[6], 2, dest[0] },
+        { (pl_vm_address_t) &bytes[0], 2, dest[1] },
+        { (pl_vm_address_t) &bytes[3], 2, dest[2] }
+    };
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_task_memcpy_batch(mach_task_self(), reads, 3), @"Batched read failed");
+    STAssertTrue(memcmp(dest[0], &bytes[6], 2) == 0, @"Incorrect data");
+    STAssertTrue(memcmp(dest[1], &bytes[0], 2) == 0, @"Incorrect data");
+    STAssertTrue(memcmp(dest[2], &bytes[3], 2) == 0, @"Incorrect data");
+
+    // Verify that a bad request fails, without preventing the remaining reads
+    memset(dest, 0xFF, sizeof(dest));
+    reads[0].address = 0;
+    STAssertNotEquals(PLCRASH_ESUCCESS, plcrash_async_task_memcpy_batch(mach_task_self(), reads, 3), @"Bad read was performed");
+    STAssertTrue(memcmp(dest[1], &bytes[0], 2) == 0, @"Incorrect data");
+    STAssertTrue(memcmp(dest[2], &bytes[3], 2) == 0, @"Incorrect data");
+}
+
 - (void) testTaskReadInt {
     const plcrash_async_byteorder_t *byteorder = &plcrash_async_byteorder_swapped;
     union test_data {
@@ -159,6 +196,35 @@
     STAssertEquals(plcrash_async_strncmp("aaaaaaaaaa", "aaaaaaaaab", 9), 0, @"String prefixes should be equal");
 }
 
+- (void) testStrnlen {
+    const char str[] = "one two three four five six";
+
+    STAssertEquals(plcrash_async_strnlen(str, sizeof(str)), strlen(str), @"Incorrect length");
+    STAssertEquals(plcrash_async_strnlen(str, 5), (size_t) 5, @"Length should be bounded");
+    STAssertEquals(plcrash_async_strnlen(str, 0), (size_t) 0, @"Length should be bounded");
+
+    /* Verify all alignments */
+    for (size_t i = 0; i < sizeof(str) - 1; i++)
+        STAssertEquals(plcrash_async_strnlen(str + i, sizeof(str) - i), strlen(str + i), @"Incorrect length at offset %zu", i);
+}
+
+- (void) testUTF8Strlen {
+    const char str[] = "one two three \xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80 four five six";
+
+    STAssertEquals(plcrash_async_utf8_strlen(str), strlen(str), @"Incorrect length");
+
+    /* Verify all alignments */
+    for (size_t i = 0; i < 14; i++)
+        STAssertEquals(plcrash_async_utf8_strlen(str + i), strlen(str + i), @"Incorrect length at offset %zu", i);
+
+    /* Ill-formed sequences terminate the valid prefix */
+    STAssertEquals(plcrash_async_utf8_strlen("abc\x80"), (size_t) 3, @"Accepted a stray continuation byte");
+    STAssertEquals(plcrash_async_utf8_strlen("abc\xC0\xAF"), (size_t) 3, @"Accepted an overlong encoding");
+    STAssertEquals(plcrash_async_utf8_strlen("abc\xED\xA0\x80"), (size_t) 3, @"Accepted a surrogate");
+    STAssertEquals(plcrash_async_utf8_strlen("abc\xF4\x90\x80\x80"), (size_t) 3, @"Accepted a code point above U+10FFFF");
+    STAssertEquals(plcrash_async_utf8_strlen("abc\xE2\x82"), (size_t) 3, @"Accepted a truncated sequence");
+}
+
 - (void) testMemcpy {
     size_t size = 1024;
     uint8_t template[size];
@@ -197,6 +263,120 @@
     STAssertTrue(dest[1024] == (uint8_t)0xB, @"Sentinal was overwritten (0x%" PRIX8 ")", dest[1024]);
 }
 
+/**
+ * Verify the word-at-a-time string and memory routines across all relative alignments and lengths.
+ */
+- (void) testWordAlignment {
+    char a[64];
+    char b[64];
+    uint8_t dest[64];
+
+    for (size_t offset_a = 0; offset_a < sizeof(uintptr_t); offset_a++) {
+        for (size_t offset_b = 0; offset_b < sizeof(uintptr_t); offset_b++) {
+            for (size_t len = 0; len < 32; len++) {
+                memset(a, 'x', sizeof(a));
+                memset(b, 'x', sizeof(b));
+                a[offset_a + len] = '\0';
+                b[offset_b + len] = '\0';
+
+                STAssertEquals(plcrash_async_strcmp(a + offset_a, b + offset_b), 0, @"Strings should be equal (len=%zu)", len);
+                STAssertEquals(plcrash_async_strncmp(a + offset_a, b + offset_b, len + 1), 0, @"Strings should be equal (len=%zu)", len);
+
+                /* Mismatch in the final character */
+                if (len > 0) {
+                    b[offset_b + len - 1] = 'y';
+                    STAssertTrue(plcrash_async_strcmp(a + offset_a, b + offset_b) < 0, @"Strings compared incorrectly (len=%zu)", len);
+                    STAssertTrue(plcrash_async_strncmp(a + offset_a, b + offset_b, len) < 0, @"Strings compared incorrectly (len=%zu)", len);
+                    STAssertEquals(plcrash_async_strncmp(a + offset_a, b + offset_b, len - 1), 0, @"String prefixes should be equal (len=%zu)", len);
+                }
+
+                /* memcpy() must copy exactly len bytes */
+                memset(dest, 0xB, sizeof(dest));
+                plcrash_async_memcpy(dest + offset_b, a + offset_a, len);
+                STAssertTrue(memcmp(dest + offset_b, a + offset_a, len) == 0, @"Incorrect copy (len=%zu)", len);
+                STAssertEquals(dest[offset_b + len], (uint8_t) 0xB, @"Sentinal was overwritten (len=%zu)", len);
+
+                /* memset() must write exactly len bytes */
+                memset(dest, 0xB, sizeof(dest));
+                plcrash_async_memset(dest + offset_a, 0xAB, len);
+                for (size_t i = 0; i < len; i++)
+                    STAssertEquals(dest[offset_a + i], (uint8_t) 0xAB, @"Incorrect value (len=%zu)", len);
+                STAssertEquals(dest[offset_a + len], (uint8_t) 0xB, @"Sentinal was overwritten (len=%zu)", len);
+            }
+        }
+    }
+}
+
+/**
+ * Test prefaulting of a partially-paged range; the range's contents must not be modified.
+ */
+- (void) testPrefault {
+    vm_address_t addr;
+    vm_size_t size = vm_page_size * 4;
+    STAssertEquals(KERN_SUCCESS, vm_allocate(mach_task_self(), &addr, size, VM_FLAGS_ANYWHERE), @"Allocation failed");
+
+    uint8_t *bytes = (uint8_t *) addr;
+    bytes[vm_page_size + 1] = 0xAB;
+
+    /* Unaligned ranges fault in every page they touch */
+    plcrash_nasync_prefault(bytes + 1, size - 2, true);
+    STAssertEquals(bytes[vm_page_size + 1], (uint8_t) 0xAB, @"Prefaulting modified the range");
+    munlock(bytes + 1, size - 2);
+
+    /* Empty ranges are ignored */
+    plcrash_nasync_prefault(NULL, 0, true);
+
+    vm_deallocate(mach_task_self(), addr, size);
+}
+
+/**
+ * Microbenchmark of the async-safe string and memory routines, relative to libc. Results are logged rather than asserted.
+ */
+- (void) testArena {
+    plcrash_async_arena_t arena;
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_nasync_arena_init(&arena, 1), @"Failed to initialize arena");
+    STAssertEquals(arena.size, (size_t) vm_page_size, @"Arena size should be rounded to a page");
+
+    /* Allocations are aligned and zero-filled */
+    memset(arena.base, 0xFF, arena.size);
+    uint8_t *first = plcrash_async_arena_alloc(&arena, 3);
+    uint8_t *second = plcrash_async_arena_alloc(&arena, 8);
+    STAssertNotNULL(first, @"Allocation failed");
+    STAssertNotNULL(second, @"Allocation failed");
+    STAssertEquals(((uintptr_t) second) % 16, (uintptr_t) 0, @"Allocation is not aligned");
+    STAssertTrue(second >= first + 3, @"Allocations overlap");
+    for (size_t i = 0; i < 8; i++)
+        STAssertEquals(second[i], (uint8_t) 0, @"Allocation was not zero-filled");
+    STAssertTrue(plcrash_async_arena_contains(&arena, second), @"Allocation not within arena");
+
+    /* Exhaustion returns NULL; reset releases all allocations */
+    STAssertNULL(plcrash_async_arena_alloc(&arena, arena.size), @"Allocation should not fit in arena");
+    plcrash_async_arena_reset(&arena);
+    STAssertEquals((void *) arena.base, plcrash_async_arena_alloc(&arena, arena.size), @"Reset did not release allocations");
+
+    /* Scratch allocations are served from the arena only while active */
+    vm_address_t addr;
+    plcrash_nasync_scratch_set_arena(&arena);
+    plcrash_async_scratch_begin();
+    STAssertEquals(KERN_SUCCESS, plcrash_async_scratch_allocate(&addr, 64), @"Scratch allocation failed");
+    STAssertTrue(plcrash_async_arena_contains(&arena, (void *) addr), @"Scratch allocation not served from arena");
+    STAssertEquals(((uintptr_t) addr) % 16, (uintptr_t) 0, @"Scratch allocation is not aligned");
+    STAssertEquals(KERN_SUCCESS, plcrash_async_scratch_deallocate(addr, 64), @"Scratch deallocation failed");
+
+    /* Allocations that do not fit fall back on the VM allocator */
+    STAssertEquals(KERN_SUCCESS, plcrash_async_scratch_allocate(&addr, arena.size), @"Scratch allocation failed");
+    STAssertFalse(plcrash_async_arena_contains(&arena, (void *) addr), @"Oversized allocation served from arena");
+    STAssertEquals(KERN_SUCCESS, plcrash_async_scratch_deallocate(addr, arena.size), @"Scratch deallocation failed");
+    plcrash_async_scratch_end();
+
+    STAssertEquals(KERN_SUCCESS, plcrash_async_scratch_allocate(&addr, 64), @"Scratch allocation failed");
+    STAssertFalse(plcrash_async_arena_contains(&arena, (void *) addr), @"Inactive arena was used");
+    STAssertEquals(KERN_SUCCESS, plcrash_async_scratch_deallocate(addr, 64), @"Scratch deallocation failed");
+
+    plcrash_nasync_scratch_set_arena(NULL);
+    plcrash_nasync_arena_free(&arena);
+}
+
 - (void) testWriteLimits {
     plcrash_async_file_t file;
     uint32_t data = 1;
@@ -219,6 +399,115 @@
     STAssertEquals((off_t)8, fs.st_size, @"File size is not 8 bytes");
 }
 
+- (void) testBufferWrite {
+    plcrash_async_file_t file;
+    uint8_t buffer[8];
+    uint32_t data = 0xCAFEF00D;
+
+    /* Initialize the file instance with an 8 byte buffer */
+    plcrash_async_file_init_buffer(&file, buffer, sizeof(buffer));
+
+    /* Write to the limit */
+    STAssertTrue(plcrash_async_file_write(&file, &data, sizeof(data)), @"Write failed");
+    STAssertTrue(plcrash_async_file_write(&file, &data, sizeof(data)), @"Write failed");
+    STAssertFalse(plcrash_async_file_write(&file, &data, sizeof(data)), @"Limit not enforced");
+    STAssertTrue(plcrash_async_file_close(&file), @"File not closed");
+
+    STAssertEquals((off_t)8, file.total_bytes, @"Incorrect byte count");
+    STAssertTrue(memcmp(buffer, &data, sizeof(data)) == 0, @"Incorrect data written");
+    STAssertTrue(memcmp(buffer + sizeof(data), &data, sizeof(data)) == 0, @"Incorrect data written");
+}
+
+- (void) testGrowableWrite {
+    plcrash_async_file_t file;
+    size_t limit = vm_page_size * 4;
+    uint8_t data[100];
+
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = (uint8_t) i;
+
+    /* Initialize the file instance */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_file_init_vm(&file, limit), @"Failed to allocate buffer");
+
+    /* Write until the limit is reached; this will require growing the buffer */
+    size_t written = 0;
+    while (written + sizeof(data) <= limit) {
+        STAssertTrue(plcrash_async_file_write(&file, data, sizeof(data)), @"Write failed");
+        written += sizeof(data);
+    }
+    STAssertFalse(plcrash_async_file_write(&file, data, sizeof(data)), @"Limit not enforced");
+    STAssertTrue(plcrash_async_file_close(&file), @"File not closed");
+
+    STAssertEquals((off_t) written, file.total_bytes, @"Incorrect byte count");
+    STAssertTrue(file.mem_capacity >= written, @"Buffer was not grown");
+
+    /* Verify the contents */
+    for (size_t i = 0; i < written; i += sizeof(data))
+        STAssertTrue(memcmp((uint8_t *) file.mem_buffer + i, data, sizeof(data)) == 0, @"Incorrect data at offset %zu", i);
+
+    vm_deallocate(mach_task_self(), (vm_address_t) file.mem_buffer, file.mem_capacity);
+}
+
+- (void) testMappedWrite {
+    plcrash_async_file_t file;
+    const char data[] = "Hello";
+
+    /* Initialize the file instance with a 4096 byte mapping */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_file_nasync_init_mmap(&file, _testFd, 4096), @"Failed to map file");
+
+    /* Write the test data */
+    STAssertTrue(plcrash_async_file_write(&file, data, sizeof(data)), @"Write failed");
+    STAssertTrue(plcrash_async_file_close(&file), @"File not closed");
+
+    /* The file should have been truncated to the written length */
+    struct stat fs;
+    stat([_outputFile UTF8String], &fs);
+    STAssertEquals((off_t)sizeof(data), fs.st_size, @"File was not truncated to the written length");
+
+    NSData *contents = [NSData dataWithContentsOfFile: _outputFile];
+    STAssertTrue(memcmp([contents bytes], data, sizeof(data)) == 0, @"Incorrect data written");
+}
+
+- (void) testFilePreallocate {
+    plcrash_async_file_t file;
+    const char data[] = "Hello";
+
+    /* Reserving storage must not change the file's length. Not all filesystems support reservation. */
+    plcrash_error_t err = plcrash_async_file_nasync_preallocate(_testFd, 64 * 1024);
+    STAssertTrue(err == PLCRASH_ESUCCESS || err == PLCRASH_ENOTSUP, @"Failed to reserve storage: %d", err);
+
+    struct stat fs;
+    fstat(_testFd, &fs);
+    STAssertEquals((off_t) 0, fs.st_size, @"Reserving storage changed the file length");
+
+    /* Writes to the reserved file must succeed as usual */
+    plcrash_async_file_init(&file, _testFd, 0);
+    STAssertTrue(plcrash_async_file_write(&file, data, sizeof(data)), @"Write failed");
+    STAssertTrue(plcrash_async_file_close(&file), @"File not closed");
+
+    NSData *contents = [NSData dataWithContentsOfFile: _outputFile];
+    STAssertEquals((NSUInteger) sizeof(data), [contents length], @"Incorrect file length");
+    STAssertTrue(memcmp([contents bytes], data, sizeof(data)) == 0, @"Incorrect data written");
+}
+
+/**
+ * The mapped output file must be fully backed by storage, rather than sparse, so that crash-time writes to the mapping
+ * can not fault should the volume fill.
+ */
+- (void) testMappedFileNotSparse {
+    plcrash_async_file_t file;
+    const size_t size = 256 * 1024;
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_file_nasync_init_mmap(&file, _testFd, size), @"Failed to map file");
+
+    struct stat fs;
+    STAssertEquals(0, fstat(_testFd, &fs), @"Failed to stat file");
+    STAssertEquals((off_t) size, fs.st_size, @"Incorrect mapped file length");
+    STAssertTrue((off_t) fs.st_blocks * 512 >= (off_t) size, @"The mapped file is sparse: %lld blocks", (long long) fs.st_blocks);
+
+    STAssertTrue(plcrash_async_file_close(&file), @"File not closed");
+}
+
 /*
  * Read in the test file, verify that it matches the given data block. Returns the
  * total number of bytes read (which may be less than the data block, which will
@@ -274,4 +563,40 @@
     [input close];
 }
 
+- (void) testBufferedWriteWithCustomBuffer {
+    plcrash_async_file_t file;
+    char buffer[512];
+    int write_iterations = 8;
+    unsigned char data[200];
+    size_t nread = 0;
+    
+    /* Initialize the file instance with a custom buffer */
+    plcrash_async_file_init(&file, _testFd, 0);
+    plcrash_async_file_set_buffer(&file, buffer, sizeof(buffer));
+    
+    /* Create test data */
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = (unsigned char) i;
+    
+    /* Write out the test data; every other write will overflow the buffer, exercising the writev() path */
+    for (int i = 0; i < write_iterations; i++)
+        STAssertTrue(plcrash_async_file_write(&file, data, sizeof(data)), @"Failed to write to output buffer");
+    
+    /* Flush pending data and close the file */
+    STAssertTrue(plcrash_async_file_flush(&file), @"File flush failed");
+    STAssertTrue(plcrash_async_file_close(&file), @"File not closed");
+    
+    /* Validate the test file */
+    NSInputStream *input = [NSInputStream inputStreamWithFileAtPath: _outputFile];
+    [input open];
+    STAssertEquals((NSStreamStatus)NSStreamStatusOpen, [input streamStatus], @"Could not open input stream %@: %@", _outputFile, [input streamError]);
+    
+    for (int i = 0; i < write_iterations; i++)
+        nread += [self checkTestData: data bytes: sizeof(data) inputStream: input];
+    
+    STAssertEquals(nread, sizeof(data) * write_iterations, @"Fewer than expected bytes were written (%zu < %zu)", nread, sizeof(data) * write_iterations);
+    
+    [input close];
+}
+
 @end
@@ -93,6 +93,7 @@ plcrash_error_t plcrash_async_thread_state_init (plcrash_async_thread_state_t *t
             return PLCRASH_ENOTSUP;
     }
 
+    plcrash_async_thread_state_select_reg_table(thread_state);
     plcrash_async_thread_state_clear_all_regs(thread_state);
     return PLCRASH_ESUCCESS;
 }
@@ -216,6 +217,8 @@ plcrash_error_t plcrash_async_thread_state_mach_thread_init (plcrash_async_threa
 #error Add platform support
 #endif
 
+    plcrash_async_thread_state_select_reg_table(thread_state);
+
     /* Mark all registers as available */
     memset(&thread_state->valid_regs, 0xFF, sizeof(thread_state->valid_regs));
 
@@ -97,6 +97,25 @@ typedef enum {
     PLCRASH_ASYNC_THREAD_STACK_DIRECTION_DOWN = 2
 } plcrash_async_thread_stack_direction_t;
 
+/**
+ * @internal
+ *
+ * Describes the location of a single register within a plcrash_async_thread_state_t. Each supported architecture
+ * provides a constant table of register descriptors, indexed by register number, which is selected when the thread
+ * state is initialized.
+ */
+typedef struct plcrash_async_thread_reg_desc {
+    /** The register name. */
+    const char *name;
+
+    /** The byte offset of the register value within plcrash_async_thread_state_t. */
+    uint16_t offset;
+
+    /** The size of the register value, in bytes. If 0, the register must be accessed via the platform's
+     * accessor functions (eg, pointer-authenticated arm64e registers). */
+    uint8_t size;
+} plcrash_async_thread_reg_desc_t;
+
 /**
  * @internal
  *
@@ -116,6 +135,12 @@ typedef struct plcrash_async_thread_state {
     /** The set of available registers. */
     uint64_t valid_regs;
 
+    /** The register descriptor table for the thread state's architecture, indexed by register number. */
+    const plcrash_async_thread_reg_desc_t *reg_table;
+
+    /** The number of entries in @a reg_table. */
+    size_t reg_count;
+
     /* Union used to hold thread state for any supported architecture */
     union {
     #ifdef PLCRASH_ASYNC_THREAD_ARM_SUPPORT
@@ -171,6 +196,54 @@ typedef enum {
 /** Platform word type */
 typedef plcrash_pdef_greg_t plcrash_greg_t;
 
+/**
+ * @internal
+ *
+ * Load the value of the register described by @a desc from @a thread_state.
+ *
+ * @param thread_state The thread state from which the register will be read.
+ * @param desc The register descriptor. The descriptor must have a non-zero size.
+ */
+static inline plcrash_greg_t plcrash_async_thread_state_load_reg (const plcrash_async_thread_state_t *thread_state, const plcrash_async_thread_reg_desc_t *desc) {
+    const uint8_t *p = (const uint8_t *) thread_state + desc->offset;
+    switch (desc->size) {
+        case 8:
+            return (plcrash_greg_t) *(const uint64_t *) p;
+        case 4:
+            return *(const uint32_t *) p;
+        case 2:
+            return *(const uint16_t *) p;
+        default:
+            __builtin_trap();
+    }
+}
+
+/**
+ * @internal
+ *
+ * Store @a reg to the register described by @a desc in @a thread_state.
+ *
+ * @param thread_state The thread state to which the register will be written.
+ * @param desc The register descriptor. The descriptor must have a non-zero size.
+ * @param reg The register value.
+ */
+static inline void plcrash_async_thread_state_store_reg (plcrash_async_thread_state_t *thread_state, const plcrash_async_thread_reg_desc_t *desc, plcrash_greg_t reg) {
+    uint8_t *p = (uint8_t *) thread_state + desc->offset;
+    switch (desc->size) {
+        case 8:
+            *(uint64_t *) p = reg;
+            break;
+        case 4:
+            *(uint32_t *) p = (uint32_t) reg;
+            break;
+        case 2:
+            *(uint16_t *) p = (uint16_t) reg;
+            break;
+        default:
+            __builtin_trap();
+    }
+}
+
 plcrash_error_t plcrash_async_thread_state_init (plcrash_async_thread_state_t *thread_state, cpu_type_t cpu_type);
 void plcrash_async_thread_state_mcontext_init (plcrash_async_thread_state_t *thread_state, pl_mcontext_t *mctx);
 plcrash_error_t plcrash_async_thread_state_mach_thread_init (plcrash_async_thread_state_t *thread_state, thread_t thread);
@@ -205,6 +278,16 @@ void plcrash_async_thread_state_clear_all_regs (plcrash_async_thread_state_t *th
 
 /* Platform specific funtions */
 
+/**
+ * @internal
+ *
+ * Select the register descriptor table for @a thread_state's architecture. This is called by the thread state
+ * initializers once the thread state flavor is known.
+ *
+ * @param thread_state The target thread state.
+ */
+void plcrash_async_thread_state_select_reg_table (plcrash_async_thread_state_t *thread_state);
+
 /**
  * Get a register's name.
  */
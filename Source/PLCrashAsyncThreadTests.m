@@ -166,6 +166,38 @@
     }
 }
 
+/**
+ * Verify that the register descriptor table maps each register to a distinct location within the thread state.
+ */
+- (void) testRegisterTableLayout {
+    plcrash_async_thread_state_t ts;
+    plcrash_async_thread_state_mach_thread_init(&ts, pthread_mach_thread_np(_thr_args.thread));
+    size_t regcount = plcrash_async_thread_state_get_reg_count(&ts);
+
+    STAssertNotNULL(ts.reg_table, @"No register table was selected");
+    STAssertEquals(regcount, ts.reg_count, @"Register count does not match the register table");
+
+    /* Assign each register a distinct value; any overlapping descriptors will clobber an earlier value */
+    for (plcrash_regnum_t i = 0; i < regcount; i++)
+        plcrash_async_thread_state_set_reg(&ts, i, i + 1);
+
+    for (plcrash_regnum_t i = 0; i < regcount; i++)
+        STAssertEquals(plcrash_async_thread_state_get_reg(&ts, i), (plcrash_greg_t) (i + 1), @"Register %s was overwritten", plcrash_async_thread_state_get_reg_name(&ts, i));
+
+    /* Verify that the descriptor for the pseudo-IP register refers to the thread state's IP */
+#if defined(__x86_64__)
+    STAssertEquals((plcrash_greg_t) ts.x86_state.thread.uts.ts64.__rip, plcrash_async_thread_state_get_reg(&ts, PLCRASH_REG_IP), @"Incorrect IP register location");
+#elif defined(__i386__)
+    STAssertEquals((plcrash_greg_t) ts.x86_state.thread.uts.ts32.__eip, plcrash_async_thread_state_get_reg(&ts, PLCRASH_REG_IP), @"Incorrect IP register location");
+#elif defined(__arm64__) && defined(arm_thread_state64_get_pc)
+    STAssertEquals((plcrash_greg_t) arm_thread_state64_get_pc(ts.arm_state.thread.ts_64), plcrash_async_thread_state_get_reg(&ts, PLCRASH_REG_IP), @"Incorrect IP register location");
+#elif defined(__arm64__)
+    STAssertEquals((plcrash_greg_t) ts.arm_state.thread.ts_64.__pc, plcrash_async_thread_state_get_reg(&ts, PLCRASH_REG_IP), @"Incorrect IP register location");
+#elif defined(__arm__)
+    STAssertEquals((plcrash_greg_t) ts.arm_state.thread.ts_32.__pc, plcrash_async_thread_state_get_reg(&ts, PLCRASH_REG_IP), @"Incorrect IP register location");
+#endif
+}
+
 /**
  * Test mapping of DWARF register values.
  */
@@ -28,50 +28,31 @@
 
 #include "PLCrashAsyncThread.h"
 #include "PLCrashAsync.h"
+#include "PLCrashMacros.h"
 
 #include <signal.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <assert.h>
 
 #if defined(__arm__) || defined(__arm64__)
 
-#define RETGEN(name, type, ts) {\
-    return (ts->arm_state. type . __ ## name); \
-}
-
-#define SETGEN(name, type, ts, regnum, value) {\
-    ts->valid_regs |= 1ULL<<regnum; \
-    (ts->arm_state. type . __ ## name) = value; \
-    break; \
+/* Define a register descriptor for the ARM thread state field __<field> within <type> */
+#define REGDESC(regname, type, field) { \
+    .name = regname, \
+    .offset = offsetof(plcrash_async_thread_state_t, arm_state.thread. type . __ ## field), \
+    .size = sizeof(((plcrash_async_thread_state_t *) NULL)->arm_state.thread. type . __ ## field) \
 }
 
 /* Access thread status via macro when defined (will be for arch arm64 and arm64e on Xcode 10 and newer),
- if macros are not available fall back to the old ones */
+ if macros are not available fall back to direct access. Registers accessed via macro are described with a
+ zero size. */
 #if defined(arm_thread_state64_get_pc)
-#define RETGENM(name, type, ts) {\
-    return arm_thread_state64_get_ ## name (((plcrash_async_thread_state_t *)ts)->arm_state. type );\
-}
-
-#define SETGENM(name, type, ts, regnum, value) {\
-    ts->valid_regs |= 1ULL<<regnum; \
-    arm_thread_state64_set_ ## name (ts->arm_state. type, value) ;\
-    break; \
-}
-
-#define SETGENMF(name, type, ts, regnum, value) {\
-    ts->valid_regs |= 1ULL<<regnum; \
-    arm_thread_state64_set_ ## name ## _fptr(ts->arm_state. type, (void *)value) ;\
-    break; \
-}
-
-#else /* defined(arm_thread_state64_get_pc) */
-#define RETGENM(name, type, ts) RETGEN(name, type, ts)
-#define SETGENM(name, type, ts, regnum, value) SETGEN(name, type, ts, regnum, value)
-#define SETGENMF(name, type, ts, regnum, value) SETGEN(name, type, ts, regnum, value)
+#define REGDESC_M(regname, type, field) { .name = regname, .offset = 0, .size = 0 }
+#else
+#define REGDESC_M(regname, type, field) REGDESC(regname, type, field)
 #endif /* defined(arm_thread_state64_get_pc) */
 
-
-
 /* Mapping of DWARF register numbers to PLCrashReporter register numbers. */
 struct dwarf_register_table {
     /** Standard register number. */
@@ -202,506 +183,178 @@ static const struct dwarf_register_table arm64_dwarf_table [] = {
     { PLCRASH_ARM64_SP,  31 },
 };
 
+/* ARM register descriptors, indexed by register number */
+static const plcrash_async_thread_reg_desc_t arm_reg_table[] = {
+    [PLCRASH_ARM_R0]     = REGDESC("r0",    ts_32, r[0]),
+    [PLCRASH_ARM_R1]     = REGDESC("r1",    ts_32, r[1]),
+    [PLCRASH_ARM_R2]     = REGDESC("r2",    ts_32, r[2]),
+    [PLCRASH_ARM_R3]     = REGDESC("r3",    ts_32, r[3]),
+    [PLCRASH_ARM_R4]     = REGDESC("r4",    ts_32, r[4]),
+    [PLCRASH_ARM_R5]     = REGDESC("r5",    ts_32, r[5]),
+    [PLCRASH_ARM_R6]     = REGDESC("r6",    ts_32, r[6]),
+    [PLCRASH_ARM_R7]     = REGDESC("r7",    ts_32, r[7]),
+    [PLCRASH_ARM_R8]     = REGDESC("r8",    ts_32, r[8]),
+    [PLCRASH_ARM_R9]     = REGDESC("r9",    ts_32, r[9]),
+    [PLCRASH_ARM_R10]    = REGDESC("r10",   ts_32, r[10]),
+    [PLCRASH_ARM_R11]    = REGDESC("r11",   ts_32, r[11]),
+    [PLCRASH_ARM_R12]    = REGDESC("r12",   ts_32, r[12]),
+    [PLCRASH_ARM_SP]     = REGDESC("sp",    ts_32, sp),
+    [PLCRASH_ARM_LR]     = REGDESC("lr",    ts_32, lr),
+    [PLCRASH_ARM_PC]     = REGDESC("pc",    ts_32, pc),
+    [PLCRASH_ARM_CPSR]   = REGDESC("cpsr",  ts_32, cpsr)
+};
+PLCR_ASSERT_STATIC(arm_reg_table_complete, sizeof(arm_reg_table) / sizeof(arm_reg_table[0]) == PLCRASH_ARM_LAST_REG+1);
+
+/* ARM64 register descriptors, indexed by register number */
+static const plcrash_async_thread_reg_desc_t arm64_reg_table[] = {
+    [PLCRASH_ARM64_X0]     = REGDESC("x0",    ts_64, x[0]),
+    [PLCRASH_ARM64_X1]     = REGDESC("x1",    ts_64, x[1]),
+    [PLCRASH_ARM64_X2]     = REGDESC("x2",    ts_64, x[2]),
+    [PLCRASH_ARM64_X3]     = REGDESC("x3",    ts_64, x[3]),
+    [PLCRASH_ARM64_X4]     = REGDESC("x4",    ts_64, x[4]),
+    [PLCRASH_ARM64_X5]     = REGDESC("x5",    ts_64, x[5]),
+    [PLCRASH_ARM64_X6]     = REGDESC("x6",    ts_64, x[6]),
+    [PLCRASH_ARM64_X7]     = REGDESC("x7",    ts_64, x[7]),
+    [PLCRASH_ARM64_X8]     = REGDESC("x8",    ts_64, x[8]),
+    [PLCRASH_ARM64_X9]     = REGDESC("x9",    ts_64, x[9]),
+    [PLCRASH_ARM64_X10]    = REGDESC("x10",   ts_64, x[10]),
+    [PLCRASH_ARM64_X11]    = REGDESC("x11",   ts_64, x[11]),
+    [PLCRASH_ARM64_X12]    = REGDESC("x12",   ts_64, x[12]),
+    [PLCRASH_ARM64_X13]    = REGDESC("x13",   ts_64, x[13]),
+    [PLCRASH_ARM64_X14]    = REGDESC("x14",   ts_64, x[14]),
+    [PLCRASH_ARM64_X15]    = REGDESC("x15",   ts_64, x[15]),
+    [PLCRASH_ARM64_X16]    = REGDESC("x16",   ts_64, x[16]),
+    [PLCRASH_ARM64_X17]    = REGDESC("x17",   ts_64, x[17]),
+    [PLCRASH_ARM64_X18]    = REGDESC("x18",   ts_64, x[18]),
+    [PLCRASH_ARM64_X19]    = REGDESC("x19",   ts_64, x[19]),
+    [PLCRASH_ARM64_X20]    = REGDESC("x20",   ts_64, x[20]),
+    [PLCRASH_ARM64_X21]    = REGDESC("x21",   ts_64, x[21]),
+    [PLCRASH_ARM64_X22]    = REGDESC("x22",   ts_64, x[22]),
+    [PLCRASH_ARM64_X23]    = REGDESC("x23",   ts_64, x[23]),
+    [PLCRASH_ARM64_X24]    = REGDESC("x24",   ts_64, x[24]),
+    [PLCRASH_ARM64_X25]    = REGDESC("x25",   ts_64, x[25]),
+    [PLCRASH_ARM64_X26]    = REGDESC("x26",   ts_64, x[26]),
+    [PLCRASH_ARM64_X27]    = REGDESC("x27",   ts_64, x[27]),
+    [PLCRASH_ARM64_X28]    = REGDESC("x28",   ts_64, x[28]),
+    [PLCRASH_ARM64_FP]     = REGDESC_M("fp",  ts_64, fp),
+    [PLCRASH_ARM64_SP]     = REGDESC_M("sp",  ts_64, sp),
+    [PLCRASH_ARM64_LR]     = REGDESC_M("lr",  ts_64, lr),
+    [PLCRASH_ARM64_PC]     = REGDESC_M("pc",  ts_64, pc),
+    [PLCRASH_ARM64_CPSR]   = REGDESC("cpsr",  ts_64, cpsr)
+};
+PLCR_ASSERT_STATIC(arm64_reg_table_complete, sizeof(arm64_reg_table) / sizeof(arm64_reg_table[0]) == PLCRASH_ARM64_LAST_REG+1);
+
+#if defined(arm_thread_state64_get_pc)
+/**
+ * @internal
+ * Fetch an ARM64 register that must be accessed via the thread state accessor macros.
+ */
+static plcrash_greg_t arm64_get_reg_m (const plcrash_async_thread_state_t *ts, plcrash_regnum_t regnum) {
+    arm_thread_state64_t *state = (arm_thread_state64_t *) &ts->arm_state.thread.ts_64;
+
+    switch (regnum) {
+        case PLCRASH_ARM64_FP:
+            return arm_thread_state64_get_fp(*state);
+
+        case PLCRASH_ARM64_SP:
+            return arm_thread_state64_get_sp(*state);
+
+        case PLCRASH_ARM64_LR:
+            return arm_thread_state64_get_lr(*state);
+
+        case PLCRASH_ARM64_PC:
+            return arm_thread_state64_get_pc(*state);
+
+        default:
+            __builtin_trap();
+    }
+}
+
+/**
+ * @internal
+ * Set an ARM64 register that must be accessed via the thread state accessor macros.
+ */
+static void arm64_set_reg_m (plcrash_async_thread_state_t *ts, plcrash_regnum_t regnum, plcrash_greg_t reg) {
+    switch (regnum) {
+        case PLCRASH_ARM64_FP:
+            arm_thread_state64_set_fp(ts->arm_state.thread.ts_64, reg);
+            break;
+
+        case PLCRASH_ARM64_SP:
+            arm_thread_state64_set_sp(ts->arm_state.thread.ts_64, reg);
+            break;
+
+        case PLCRASH_ARM64_LR:
+            arm_thread_state64_set_lr_fptr(ts->arm_state.thread.ts_64, (void *) reg);
+            break;
+
+        case PLCRASH_ARM64_PC:
+            arm_thread_state64_set_pc_fptr(ts->arm_state.thread.ts_64, (void *) reg);
+            break;
+
+        default:
+            __builtin_trap();
+    }
+}
+#endif /* defined(arm_thread_state64_get_pc) */
+
 // PLCrashAsyncThread API
-plcrash_greg_t plcrash_async_thread_state_get_reg (const plcrash_async_thread_state_t *ts, plcrash_regnum_t regnum) {
-    if (ts->arm_state.thread.ash.flavor == ARM_THREAD_STATE32) {
-        switch (regnum) {
-            case PLCRASH_ARM_R0:
-                RETGEN(r[0], thread.ts_32, ts);
-                
-            case PLCRASH_ARM_R1:
-                RETGEN(r[1], thread.ts_32, ts);
-                
-            case PLCRASH_ARM_R2:
-                RETGEN(r[2], thread.ts_32, ts);
-                
-            case PLCRASH_ARM_R3:
-                RETGEN(r[3], thread.ts_32, ts);
-                
-            case PLCRASH_ARM_R4:
-                RETGEN(r[4], thread.ts_32, ts);
-                
-            case PLCRASH_ARM_R5:
-                RETGEN(r[5], thread.ts_32, ts);
-                
-            case PLCRASH_ARM_R6:
-                RETGEN(r[6], thread.ts_32, ts);
-                
-            case PLCRASH_ARM_R7:
-                RETGEN(r[7], thread.ts_32, ts);
-                
-            case PLCRASH_ARM_R8:
-                RETGEN(r[8], thread.ts_32, ts);
-                
-            case PLCRASH_ARM_R9:
-                RETGEN(r[9], thread.ts_32, ts);
-                
-            case PLCRASH_ARM_R10:
-                RETGEN(r[10], thread.ts_32, ts);
-                
-            case PLCRASH_ARM_R11:
-                RETGEN(r[11], thread.ts_32, ts);
-                
-            case PLCRASH_ARM_R12:
-                RETGEN(r[12], thread.ts_32, ts);
-                
-            case PLCRASH_ARM_SP:
-                RETGEN(sp, thread.ts_32, ts);
-                
-            case PLCRASH_ARM_LR:
-                RETGEN(lr, thread.ts_32, ts);
-                
-            case PLCRASH_ARM_PC:
-                RETGEN(pc, thread.ts_32, ts);
-                
-            case PLCRASH_ARM_CPSR:
-                RETGEN(cpsr, thread.ts_32, ts);
-                
-            default:
-                __builtin_trap();
-        }
+void plcrash_async_thread_state_select_reg_table (plcrash_async_thread_state_t *thread_state) {
+    if (thread_state->arm_state.thread.ash.flavor == ARM_THREAD_STATE32) {
+        thread_state->reg_table = arm_reg_table;
+        thread_state->reg_count = sizeof(arm_reg_table) / sizeof(arm_reg_table[0]);
     } else {
-        switch (regnum) {
-            case PLCRASH_ARM64_X0:
-                RETGEN(x[0], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X1:
-                RETGEN(x[1], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X2:
-                RETGEN(x[2], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X3:
-                RETGEN(x[3], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X4:
-                RETGEN(x[4], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X5:
-                RETGEN(x[5], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X6:
-                RETGEN(x[6], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X7:
-                RETGEN(x[7], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X8:
-                RETGEN(x[8], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X9:
-                RETGEN(x[9], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X10:
-                RETGEN(x[10], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X11:
-                RETGEN(x[11], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X12:
-                RETGEN(x[12], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X13:
-                RETGEN(x[13], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X14:
-                RETGEN(x[14], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X15:
-                RETGEN(x[15], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X16:
-                RETGEN(x[16], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X17:
-                RETGEN(x[17], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X18:
-                RETGEN(x[18], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X19:
-                RETGEN(x[19], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X20:
-                RETGEN(x[20], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X21:
-                RETGEN(x[21], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X22:
-                RETGEN(x[22], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X23:
-                RETGEN(x[23], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X24:
-                RETGEN(x[24], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X25:
-                RETGEN(x[25], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X26:
-                RETGEN(x[26], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X27:
-                RETGEN(x[27], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_X28:
-                RETGEN(x[28], thread.ts_64, ts);
-                
-            case PLCRASH_ARM64_FP:
-                RETGENM(fp, thread.ts_64, ts);
-
-            case PLCRASH_ARM64_SP:
-                RETGENM(sp, thread.ts_64, ts);
-            
-            case PLCRASH_ARM64_LR:
-                RETGENM(lr, thread.ts_64, ts);
-            
-            case PLCRASH_ARM64_PC:
-                RETGENM(pc, thread.ts_64, ts);
-            
-            case PLCRASH_ARM64_CPSR:
-                RETGEN(cpsr, thread.ts_64, ts);
-
-            default:
-                __builtin_trap();
-        }
+        thread_state->reg_table = arm64_reg_table;
+        thread_state->reg_count = sizeof(arm64_reg_table) / sizeof(arm64_reg_table[0]);
     }
-    /* Should not be reachable */
-    return 0;
+}
+
+// PLCrashAsyncThread API
+plcrash_greg_t plcrash_async_thread_state_get_reg (const plcrash_async_thread_state_t *ts, plcrash_regnum_t regnum) {
+    if (regnum >= ts->reg_count) {
+        // Unsupported register
+        __builtin_trap();
+    }
+
+    const plcrash_async_thread_reg_desc_t *desc = &ts->reg_table[regnum];
+#if defined(arm_thread_state64_get_pc)
+    if (desc->size == 0)
+        return arm64_get_reg_m(ts, regnum);
+#endif
+
+    return plcrash_async_thread_state_load_reg(ts, desc);
 }
 
 // PLCrashAsyncThread API
 void plcrash_async_thread_state_set_reg (plcrash_async_thread_state_t *thread_state, plcrash_regnum_t regnum, plcrash_greg_t reg) {
-    plcrash_async_thread_state_t *ts = thread_state;
-
-    if (ts->arm_state.thread.ash.flavor == ARM_THREAD_STATE32) {
-        switch (regnum) {
-            case PLCRASH_ARM_R0:
-                SETGEN(r[0], thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_R1:
-                SETGEN(r[1], thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_R2:
-                SETGEN(r[2], thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_R3:
-                SETGEN(r[3], thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_R4:
-                SETGEN(r[4], thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_R5:
-                SETGEN(r[5], thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_R6:
-                SETGEN(r[6], thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_R7:
-                SETGEN(r[7], thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_R8:
-                SETGEN(r[8], thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_R9:
-                SETGEN(r[9], thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_R10:
-                SETGEN(r[10], thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_R11:
-                SETGEN(r[11], thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_R12:
-                SETGEN(r[12], thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_SP:
-                SETGEN(sp, thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_LR:
-                SETGEN(lr, thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_PC:
-                SETGEN(pc, thread.ts_32, ts, regnum, reg);
-                
-            case PLCRASH_ARM_CPSR:
-                SETGEN(cpsr, thread.ts_32, ts, regnum, reg);
-                
-            default:
-                // Unsupported register
-                __builtin_trap();
-        }
-    } else {
-        switch (regnum) {
-            case PLCRASH_ARM64_X0:
-                SETGEN(x[0], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X1:
-                SETGEN(x[1], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X2:
-                SETGEN(x[2], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X3:
-                SETGEN(x[3], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X4:
-                SETGEN(x[4], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X5:
-                SETGEN(x[5], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X6:
-                SETGEN(x[6], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X7:
-                SETGEN(x[7], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X8:
-                SETGEN(x[8], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X9:
-                SETGEN(x[9], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X10:
-                SETGEN(x[10], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X11:
-                SETGEN(x[11], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X12:
-                SETGEN(x[12], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X13:
-                SETGEN(x[13], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X14:
-                SETGEN(x[14], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X15:
-                SETGEN(x[15], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X16:
-                SETGEN(x[16], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X17:
-                SETGEN(x[17], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X18:
-                SETGEN(x[18], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X19:
-                SETGEN(x[19], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X20:
-                SETGEN(x[20], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X21:
-                SETGEN(x[21], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X22:
-                SETGEN(x[22], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X23:
-                SETGEN(x[23], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X24:
-                SETGEN(x[24], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X25:
-                SETGEN(x[25], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X26:
-                SETGEN(x[26], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X27:
-                SETGEN(x[27], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_X28:
-                SETGEN(x[28], thread.ts_64, ts, regnum, reg);
-                
-            case PLCRASH_ARM64_FP:
-                SETGENM(fp, thread.ts_64, ts, regnum, reg);
-            
-            case PLCRASH_ARM64_SP:
-                SETGENM(sp, thread.ts_64, ts, regnum, reg);
-
-            case PLCRASH_ARM64_LR:
-                SETGENMF(lr, thread.ts_64, ts, regnum, reg);
-            
-            case PLCRASH_ARM64_PC:
-                SETGENMF(pc, thread.ts_64, ts, regnum, reg);
-            
-            case PLCRASH_ARM64_CPSR:
-                SETGEN(cpsr, thread.ts_64, ts, regnum, reg);
-                
-            default:
-                __builtin_trap();
-        }
+    if (regnum >= thread_state->reg_count) {
+        // Unsupported register
+        __builtin_trap();
+    }
+
+    const plcrash_async_thread_reg_desc_t *desc = &thread_state->reg_table[regnum];
+#if defined(arm_thread_state64_get_pc)
+    if (desc->size == 0) {
+        arm64_set_reg_m(thread_state, regnum, reg);
+        thread_state->valid_regs |= 1ULL<<regnum;
+        return;
     }
+#endif
+
+    plcrash_async_thread_state_store_reg(thread_state, desc, reg);
+    thread_state->valid_regs |= 1ULL<<regnum;
 }
 
 // PLCrashAsyncThread API
 size_t plcrash_async_thread_state_get_reg_count (const plcrash_async_thread_state_t *thread_state) {
-    /* Last is an index value, so increment to get the count */
-    if (thread_state->arm_state.thread.ash.flavor == ARM_THREAD_STATE32) {
-        return PLCRASH_ARM_LAST_REG+1;
-    } else {
-        return PLCRASH_ARM64_LAST_REG+1;
-    }
+    return thread_state->reg_count;
 }
 
 // PLCrashAsyncThread API
 char const *plcrash_async_thread_state_get_reg_name (const plcrash_async_thread_state_t *thread_state, plcrash_regnum_t regnum) {
-    if (thread_state->arm_state.thread.ash.flavor == ARM_THREAD_STATE32) {
-        switch ((plcrash_arm_regnum_t) regnum) {
-            case PLCRASH_ARM_R0:
-                return "r0";
-            case PLCRASH_ARM_R1:
-                return "r1";
-            case PLCRASH_ARM_R2:
-                return "r2";
-            case PLCRASH_ARM_R3:
-                return "r3";
-            case PLCRASH_ARM_R4:
-                return "r4";
-            case PLCRASH_ARM_R5:
-                return "r5";
-            case PLCRASH_ARM_R6:
-                return "r6";
-            case PLCRASH_ARM_R7:
-                return "r7";
-            case PLCRASH_ARM_R8:
-                return "r8";
-            case PLCRASH_ARM_R9:
-                return "r9";
-            case PLCRASH_ARM_R10:
-                return "r10";
-            case PLCRASH_ARM_R11:
-                return "r11";
-            case PLCRASH_ARM_R12:
-                return "r12";
-                
-            case PLCRASH_ARM_SP:
-                return "sp";
-                
-            case PLCRASH_ARM_LR:
-                return "lr";
-                
-            case PLCRASH_ARM_PC:
-                return "pc";
-                
-            case PLCRASH_ARM_CPSR:
-                return "cpsr";
-        }
-    } else {
-        switch ((plcrash_arm64_regnum_t) regnum) {
-            case PLCRASH_ARM64_X0:
-                return "x0";
-                
-            case PLCRASH_ARM64_X1:
-                return "x1";
-                
-            case PLCRASH_ARM64_X2:
-                return "x2";
-                
-            case PLCRASH_ARM64_X3:
-                return "x3";
-                
-            case PLCRASH_ARM64_X4:
-                return "x4";
-                
-            case PLCRASH_ARM64_X5:
-                return "x5";
-                
-            case PLCRASH_ARM64_X6:
-                return "x6";
-                
-            case PLCRASH_ARM64_X7:
-                return "x7";
-                
-            case PLCRASH_ARM64_X8:
-                return "x8";
-                
-            case PLCRASH_ARM64_X9:
-                return "x9";
-                
-            case PLCRASH_ARM64_X10:
-                return "x10";
-                
-            case PLCRASH_ARM64_X11:
-                return "x11";
-                
-            case PLCRASH_ARM64_X12:
-                return "x12";
-                
-            case PLCRASH_ARM64_X13:
-                return "x13";
-                
-            case PLCRASH_ARM64_X14:
-                return "x14";
-                
-            case PLCRASH_ARM64_X15:
-                return "x15";
-                
-            case PLCRASH_ARM64_X16:
-                return "x16";
-                
-            case PLCRASH_ARM64_X17:
-                return "x17";
-                
-            case PLCRASH_ARM64_X18:
-                return "x18";
-                
-            case PLCRASH_ARM64_X19:
-                return "x19";
-                
-            case PLCRASH_ARM64_X20:
-                return "x20";
-                
-            case PLCRASH_ARM64_X21:
-                return "x21";
-                
-            case PLCRASH_ARM64_X22:
-                return "x22";
-                
-            case PLCRASH_ARM64_X23:
-                return "x23";
-                
-            case PLCRASH_ARM64_X24:
-                return "x24";
-                
-            case PLCRASH_ARM64_X25:
-                return "x25";
-                
-            case PLCRASH_ARM64_X26:
-                return "x26";
-                
-            case PLCRASH_ARM64_X27:
-                return "x27";
-                
-            case PLCRASH_ARM64_X28:
-                return "x28";
-                
-            case PLCRASH_ARM64_FP:
-                return "fp";
-                
-            case PLCRASH_ARM64_SP:
-                return "sp";
-                
-            case PLCRASH_ARM64_LR:
-                return "lr";
-                
-            case PLCRASH_ARM64_PC:
-                return "pc";
-                
-            case PLCRASH_ARM64_CPSR:
-                return "cpsr";
-        }
-    }
-    
+    if (regnum < thread_state->reg_count)
+        return thread_state->reg_table[regnum].name;
+
     /* Unsupported register is an implementation error (checked in unit tests) */
     PLCF_DEBUG("Missing register name for register id: %d", regnum);
     abort();
@@ -28,23 +28,22 @@
 
 #include "PLCrashAsyncThread.h"
 #include "PLCrashAsync.h"
+#include "PLCrashMacros.h"
 
 #include <signal.h>
+#include <stddef.h>
 #include <assert.h>
 #include <stdlib.h>
 
-#define RETGEN(name, type, ts) {\
-    return (ts->x86_state. type . __ ## name); \
-}
+#if defined(__i386__) || defined(__x86_64__)
 
-#define SETGEN(name, type, ts, regnum, value) {\
-    ts->valid_regs |= 1ULL<<regnum; \
-    (ts->x86_state. type . __ ## name) = value; \
-    break; \
+/* Define a register descriptor for the x86 thread state field __<field> within <type> */
+#define REGDESC(regname, type, field) { \
+    .name = regname, \
+    .offset = offsetof(plcrash_async_thread_state_t, x86_state. type . __ ## field), \
+    .size = sizeof(((plcrash_async_thread_state_t *) NULL)->x86_state. type . __ ## field) \
 }
 
-#if defined(__i386__) || defined(__x86_64__)
-
 /* Mapping of DWARF register numbers to PLCrashReporter register numbers. */
 struct dwarf_register_table {
     /** Standard register number. */
@@ -140,53 +139,98 @@ static const struct dwarf_register_table x86_64_dwarf_table [] = {
     { PLCRASH_X86_64_GS, 55 }
 };
 
-static plcrash_greg_t plcrash_async_thread_state_get_reg_32 (const plcrash_async_thread_state_t *thread_state, plcrash_regnum_t regnum);
-static plcrash_greg_t plcrash_async_thread_state_get_reg_64 (const plcrash_async_thread_state_t *thread_state, plcrash_regnum_t regnum);
-
-static void plcrash_async_thread_state_set_reg_32 (plcrash_async_thread_state_t *cursor, plcrash_regnum_t regnum, plcrash_greg_t reg);
-static void plcrash_async_thread_state_set_reg_64 (plcrash_async_thread_state_t *cursor, plcrash_regnum_t regnum, plcrash_greg_t reg);
-
-static const char *plcrash_async_thread_state_get_regname_32 (plcrash_regnum_t regnum);
-static const char *plcrash_async_thread_state_get_regname_64 (plcrash_regnum_t regnum);
-
-plcrash_regnum_t plcrash_async_thread_state_map_dwarf_reg_32 (uint64_t dwarf_reg, plcrash_regnum_t *regnum);
-plcrash_regnum_t plcrash_async_thread_state_map_dwarf_reg_64 (uint64_t dwarf_reg, plcrash_regnum_t *regnum);
+/* i386 register descriptors, indexed by register number */
+static const plcrash_async_thread_reg_desc_t x86_32_reg_table[] = {
+    [PLCRASH_X86_EAX]       = REGDESC("eax",    thread.uts.ts32, eax),
+    [PLCRASH_X86_EDX]       = REGDESC("edx",    thread.uts.ts32, edx),
+    [PLCRASH_X86_ECX]       = REGDESC("ecx",    thread.uts.ts32, ecx),
+    [PLCRASH_X86_EBX]       = REGDESC("ebx",    thread.uts.ts32, ebx),
+    [PLCRASH_X86_EBP]       = REGDESC("ebp",    thread.uts.ts32, ebp),
+    [PLCRASH_X86_ESI]       = REGDESC("esi",    thread.uts.ts32, esi),
+    [PLCRASH_X86_EDI]       = REGDESC("edi",    thread.uts.ts32, edi),
+    [PLCRASH_X86_ESP]       = REGDESC("esp",    thread.uts.ts32, esp),
+    [PLCRASH_X86_EIP]       = REGDESC("eip",    thread.uts.ts32, eip),
+    [PLCRASH_X86_EFLAGS]    = REGDESC("eflags", thread.uts.ts32, eflags),
+    [PLCRASH_X86_TRAPNO]    = REGDESC("trapno", exception.ues.es32, trapno),
+    [PLCRASH_X86_CS]        = REGDESC("cs",     thread.uts.ts32, cs),
+    [PLCRASH_X86_DS]        = REGDESC("ds",     thread.uts.ts32, ds),
+    [PLCRASH_X86_ES]        = REGDESC("es",     thread.uts.ts32, es),
+    [PLCRASH_X86_FS]        = REGDESC("fs",     thread.uts.ts32, fs),
+    [PLCRASH_X86_GS]        = REGDESC("gs",     thread.uts.ts32, gs)
+};
+PLCR_ASSERT_STATIC(x86_32_reg_table_complete, sizeof(x86_32_reg_table) / sizeof(x86_32_reg_table[0]) == PLCRASH_X86_LAST_REG+1);
+
+/* x86-64 register descriptors, indexed by register number */
+static const plcrash_async_thread_reg_desc_t x86_64_reg_table[] = {
+    [PLCRASH_X86_64_RAX]    = REGDESC("rax",    thread.uts.ts64, rax),
+    [PLCRASH_X86_64_RBX]    = REGDESC("rbx",    thread.uts.ts64, rbx),
+    [PLCRASH_X86_64_RCX]    = REGDESC("rcx",    thread.uts.ts64, rcx),
+    [PLCRASH_X86_64_RDX]    = REGDESC("rdx",    thread.uts.ts64, rdx),
+    [PLCRASH_X86_64_RDI]    = REGDESC("rdi",    thread.uts.ts64, rdi),
+    [PLCRASH_X86_64_RSI]    = REGDESC("rsi",    thread.uts.ts64, rsi),
+    [PLCRASH_X86_64_RBP]    = REGDESC("rbp",    thread.uts.ts64, rbp),
+    [PLCRASH_X86_64_RSP]    = REGDESC("rsp",    thread.uts.ts64, rsp),
+    [PLCRASH_X86_64_R8]     = REGDESC("r8",     thread.uts.ts64, r8),
+    [PLCRASH_X86_64_R9]     = REGDESC("r9",     thread.uts.ts64, r9),
+    [PLCRASH_X86_64_R10]    = REGDESC("r10",    thread.uts.ts64, r10),
+    [PLCRASH_X86_64_R11]    = REGDESC("r11",    thread.uts.ts64, r11),
+    [PLCRASH_X86_64_R12]    = REGDESC("r12",    thread.uts.ts64, r12),
+    [PLCRASH_X86_64_R13]    = REGDESC("r13",    thread.uts.ts64, r13),
+    [PLCRASH_X86_64_R14]    = REGDESC("r14",    thread.uts.ts64, r14),
+    [PLCRASH_X86_64_R15]    = REGDESC("r15",    thread.uts.ts64, r15),
+    [PLCRASH_X86_64_RIP]    = REGDESC("rip",    thread.uts.ts64, rip),
+    [PLCRASH_X86_64_RFLAGS] = REGDESC("rflags", thread.uts.ts64, rflags),
+    [PLCRASH_X86_64_CS]     = REGDESC("cs",     thread.uts.ts64, cs),
+    [PLCRASH_X86_64_FS]     = REGDESC("fs",     thread.uts.ts64, fs),
+    [PLCRASH_X86_64_GS]     = REGDESC("gs",     thread.uts.ts64, gs)
+};
+PLCR_ASSERT_STATIC(x86_64_reg_table_complete, sizeof(x86_64_reg_table) / sizeof(x86_64_reg_table[0]) == PLCRASH_X86_64_LAST_REG+1);
 
 // PLCrashAsyncThread API
-plcrash_greg_t plcrash_async_thread_state_get_reg (const plcrash_async_thread_state_t *thread_state, plcrash_regnum_t regnum) {
+void plcrash_async_thread_state_select_reg_table (plcrash_async_thread_state_t *thread_state) {
     if (thread_state->x86_state.thread.tsh.flavor == x86_THREAD_STATE32) {
-        return plcrash_async_thread_state_get_reg_32(thread_state, regnum);
+        thread_state->reg_table = x86_32_reg_table;
+        thread_state->reg_count = sizeof(x86_32_reg_table) / sizeof(x86_32_reg_table[0]);
     } else {
-        return plcrash_async_thread_state_get_reg_64(thread_state, regnum);
+        thread_state->reg_table = x86_64_reg_table;
+        thread_state->reg_count = sizeof(x86_64_reg_table) / sizeof(x86_64_reg_table[0]);
+    }
+}
+
+// PLCrashAsyncThread API
+plcrash_greg_t plcrash_async_thread_state_get_reg (const plcrash_async_thread_state_t *thread_state, plcrash_regnum_t regnum) {
+    if (regnum >= thread_state->reg_count) {
+        // Unsupported register
+        __builtin_trap();
     }
+
+    return plcrash_async_thread_state_load_reg(thread_state, &thread_state->reg_table[regnum]);
 }
 
 // PLCrashAsyncThread API
 void plcrash_async_thread_state_set_reg (plcrash_async_thread_state_t *thread_state, plcrash_regnum_t regnum, plcrash_greg_t reg) {
-    if (thread_state->x86_state.thread.tsh.flavor == x86_THREAD_STATE32) {
-        return plcrash_async_thread_state_set_reg_32(thread_state, regnum, reg);
-    } else {
-        return plcrash_async_thread_state_set_reg_64(thread_state, regnum, reg);
+    if (regnum >= thread_state->reg_count) {
+        // Unsupported register
+        __builtin_trap();
     }
+
+    plcrash_async_thread_state_store_reg(thread_state, &thread_state->reg_table[regnum], reg);
+    thread_state->valid_regs |= 1ULL<<regnum;
 }
 
 // PLCrashAsyncThread API
 char const *plcrash_async_thread_state_get_reg_name (const plcrash_async_thread_state_t *thread_state, plcrash_regnum_t regnum) {
-    if (thread_state->x86_state.thread.tsh.flavor == x86_THREAD_STATE32) {
-        return plcrash_async_thread_state_get_regname_32(regnum);
-    } else {
-        return plcrash_async_thread_state_get_regname_64(regnum);
-    }
+    if (regnum < thread_state->reg_count)
+        return thread_state->reg_table[regnum].name;
+
+    /* Unsupported register is an implementation error (checked in unit tests) */
+    PLCF_DEBUG("Missing register name for register id: %d", regnum);
+    abort();
 }
 
 // PLCrashAsyncThread API
 size_t plcrash_async_thread_state_get_reg_count (const plcrash_async_thread_state_t *thread_state) {
-    /* Last is an index value, so increment to get the count */
-    if (thread_state->x86_state.thread.tsh.flavor == x86_THREAD_STATE32) {
-        return PLCRASH_X86_LAST_REG+1;
-    } else {
-        return PLCRASH_X86_64_LAST_REG+1;
-    }
+    return thread_state->reg_count;
 }
 
 // PLCrashAsyncThread API
@@ -271,434 +315,4 @@ bool plcrash_async_thread_state_map_reg_to_dwarf (plcrash_async_thread_state_t *
     return false;
 }
 
-/**
- * @internal
- * 32-bit implementation of plcrash_async_thread_state_get_reg()
- */
-static plcrash_greg_t plcrash_async_thread_state_get_reg_32 (const plcrash_async_thread_state_t *thread_state, plcrash_regnum_t regnum) {
-    const plcrash_async_thread_state_t *ts = thread_state;
-
-    /* All word-sized registers */
-    switch (regnum) {
-        case PLCRASH_X86_EAX:
-            RETGEN(eax, thread.uts.ts32, ts);
-            
-        case PLCRASH_X86_EDX:
-            RETGEN(edx, thread.uts.ts32, ts);
-            
-        case PLCRASH_X86_ECX:
-            RETGEN(ecx, thread.uts.ts32, ts);
-            
-        case PLCRASH_X86_EBX:
-            RETGEN(ebx, thread.uts.ts32, ts);
-            
-        case PLCRASH_X86_EBP:
-            RETGEN(ebp, thread.uts.ts32, ts);
-            
-        case PLCRASH_X86_ESI:
-            RETGEN(esi, thread.uts.ts32, ts);
-            
-        case PLCRASH_X86_EDI:
-            RETGEN(edi, thread.uts.ts32, ts);
-            
-        case PLCRASH_X86_ESP:
-            RETGEN(esp, thread.uts.ts32, ts);
-            
-        case PLCRASH_X86_EIP:
-            RETGEN(eip, thread.uts.ts32, ts);
-            
-        case PLCRASH_X86_EFLAGS:
-            RETGEN(eflags, thread.uts.ts32, ts);
-            
-        case PLCRASH_X86_TRAPNO:
-            RETGEN(trapno, exception.ues.es32, ts);
-            
-        case PLCRASH_X86_CS:
-            RETGEN(cs, thread.uts.ts32, ts);
-            
-        case PLCRASH_X86_DS:
-            RETGEN(ds, thread.uts.ts32, ts);
-            
-        case PLCRASH_X86_ES:
-            RETGEN(es, thread.uts.ts32, ts);
-            
-        case PLCRASH_X86_FS:
-            RETGEN(fs, thread.uts.ts32, ts);
-            
-        case PLCRASH_X86_GS:
-            RETGEN(gs, thread.uts.ts32, ts);
-            
-        default:
-            // Unsupported register
-            __builtin_trap();
-    }
-    
-    /* Shouldn't be reachable */
-    return 0;
-}
-
-/**
- * @internal
- * 64-bit implementation of plcrash_async_thread_state_get_reg()
- */
-static plcrash_greg_t plcrash_async_thread_state_get_reg_64 (const plcrash_async_thread_state_t *thread_state, plcrash_regnum_t regnum) {
-    const plcrash_async_thread_state_t *ts = thread_state;
-
-    switch (regnum) {
-        case PLCRASH_X86_64_RAX:
-            RETGEN(rax, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_RBX:
-            RETGEN(rbx, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_RCX:
-            RETGEN(rcx, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_RDX:
-            RETGEN(rdx, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_RDI:
-            RETGEN(rdi, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_RSI:
-            RETGEN(rsi, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_RBP:
-            RETGEN(rbp, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_RSP:
-            RETGEN(rsp, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_R8:
-            RETGEN(r8, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_R9:
-            RETGEN(r9, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_R10:
-            RETGEN(r10, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_R11:
-            RETGEN(r11, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_R12:
-            RETGEN(r12, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_R13:
-            RETGEN(r13, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_R14:
-            RETGEN(r14, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_R15:
-            RETGEN(r15, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_RIP:
-            RETGEN(rip, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_RFLAGS:
-            RETGEN(rflags, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_CS:
-            RETGEN(cs, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_FS:
-            RETGEN(fs, thread.uts.ts64, ts);
-            
-        case PLCRASH_X86_64_GS:
-            RETGEN(gs, thread.uts.ts64, ts);
-            
-        default:
-            // Unsupported register
-            __builtin_trap();
-    }
-
-    /* Should not be reachable */
-    return 0;
-}
-
-/**
- * @internal
- * 32-bit implementation of plcrash_async_thread_state_set_reg()
- */
-static void plcrash_async_thread_state_set_reg_32 (plcrash_async_thread_state_t *thread_state, plcrash_regnum_t regnum, plcrash_greg_t reg) {
-    plcrash_async_thread_state_t *ts = thread_state;
-    
-    /* All word-sized registers */
-    switch (regnum) {
-        case PLCRASH_X86_EAX:
-            SETGEN(eax, thread.uts.ts32, ts, regnum, reg);
-            
-        case PLCRASH_X86_EDX:
-            SETGEN(edx, thread.uts.ts32, ts, regnum, reg);
-            
-        case PLCRASH_X86_ECX:
-            SETGEN(ecx, thread.uts.ts32, ts, regnum, reg);
-            
-        case PLCRASH_X86_EBX:
-            SETGEN(ebx, thread.uts.ts32, ts, regnum, reg);
-            
-        case PLCRASH_X86_EBP:
-            SETGEN(ebp, thread.uts.ts32, ts, regnum, reg);
-            
-        case PLCRASH_X86_ESI:
-            SETGEN(esi, thread.uts.ts32, ts, regnum, reg);
-            
-        case PLCRASH_X86_EDI:
-            SETGEN(edi, thread.uts.ts32, ts, regnum, reg);
-            
-        case PLCRASH_X86_ESP:
-            SETGEN(esp, thread.uts.ts32, ts, regnum, reg);
-            
-        case PLCRASH_X86_EIP:
-            SETGEN(eip, thread.uts.ts32, ts, regnum, reg);
-            
-        case PLCRASH_X86_EFLAGS:
-            SETGEN(eflags, thread.uts.ts32, ts, regnum, reg);
-            
-        case PLCRASH_X86_TRAPNO:
-            SETGEN(trapno, exception.ues.es32, ts, regnum, reg);
-            
-        case PLCRASH_X86_CS:
-            SETGEN(cs, thread.uts.ts32, ts, regnum, reg);
-            
-        case PLCRASH_X86_DS:
-            SETGEN(ds, thread.uts.ts32, ts, regnum, reg);
-            
-        case PLCRASH_X86_ES:
-            SETGEN(es, thread.uts.ts32, ts, regnum, reg);
-            
-        case PLCRASH_X86_FS:
-            SETGEN(fs, thread.uts.ts32, ts, regnum, reg);
-            
-        case PLCRASH_X86_GS:
-            SETGEN(gs, thread.uts.ts32, ts, regnum, reg);
-            
-        default:
-            // Unsupported register
-            __builtin_trap();
-    }
-}
-
-/**
- * @internal
- * 64-bit implementation of plcrash_async_thread_state_set_reg()
- */
-static void plcrash_async_thread_state_set_reg_64 (plcrash_async_thread_state_t *thread_state, plcrash_regnum_t regnum, plcrash_greg_t reg) {
-    plcrash_async_thread_state_t *ts = thread_state;
-    
-    switch (regnum) {
-        case PLCRASH_X86_64_RAX:
-            SETGEN(rax, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_RBX:
-            SETGEN(rbx, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_RCX:
-            SETGEN(rcx, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_RDX:
-            SETGEN(rdx, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_RDI:
-            SETGEN(rdi, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_RSI:
-            SETGEN(rsi, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_RBP:
-            SETGEN(rbp, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_RSP:
-            SETGEN(rsp, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_R8:
-            SETGEN(r8, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_R9:
-            SETGEN(r9, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_R10:
-            SETGEN(r10, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_R11:
-            SETGEN(r11, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_R12:
-            SETGEN(r12, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_R13:
-            SETGEN(r13, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_R14:
-            SETGEN(r14, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_R15:
-            SETGEN(r15, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_RIP:
-            SETGEN(rip, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_RFLAGS:
-            SETGEN(rflags, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_CS:
-            SETGEN(cs, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_FS:
-            SETGEN(fs, thread.uts.ts64, ts, regnum, reg);
-            
-        case PLCRASH_X86_64_GS:
-            SETGEN(gs, thread.uts.ts64, ts, regnum, reg);
-            
-        default:
-            // Unsupported register
-            __builtin_trap();
-    }    
-}
-
-/**
- * @internal
- * 32-bit implementation of plcrash_async_thread_state_get_regname()
- */
-static char const *plcrash_async_thread_state_get_regname_32 (plcrash_regnum_t regnum) {
-    /* All word-sized registers */
-    switch (regnum) {
-        case PLCRASH_X86_EAX:
-            return "eax";
-            
-        case PLCRASH_X86_EDX:
-            return "edx";
-            
-        case PLCRASH_X86_ECX:
-            return "ecx";
-            
-        case PLCRASH_X86_EBX:
-            return "ebx";
-            
-        case PLCRASH_X86_EBP:
-            return "ebp";
-            
-        case PLCRASH_X86_ESI:
-            return "esi";
-            
-        case PLCRASH_X86_EDI:
-            return "edi";
-            
-        case PLCRASH_X86_ESP:
-            return "esp";
-            
-        case PLCRASH_X86_EIP:
-            return "eip";
-            
-        case PLCRASH_X86_EFLAGS:
-            return "eflags";
-            
-        case PLCRASH_X86_TRAPNO:
-            return "trapno";
-            
-        case PLCRASH_X86_CS:
-            return "cs";
-            
-        case PLCRASH_X86_DS:
-            return "ds";
-            
-        case PLCRASH_X86_ES:
-            return "es";
-            
-        case PLCRASH_X86_FS:
-            return "fs";
-            
-        case PLCRASH_X86_GS:
-            return "gs";
-            
-        default:
-            // Unsupported register
-            break;
-    }
-    
-    /* Unsupported register is an implementation error (checked in unit tests) */
-    PLCF_DEBUG("Missing register name for register id: %d", regnum);
-    abort();
-}
-
-/**
- * @internal
- * 64-bit implementation of plcrash_async_thread_state_get_regname()
- */
-static const char *plcrash_async_thread_state_get_regname_64 (plcrash_regnum_t regnum) {
-    switch (regnum) {
-        case PLCRASH_X86_64_RAX:
-            return "rax";
-            
-        case PLCRASH_X86_64_RBX:
-            return "rbx";
-            
-        case PLCRASH_X86_64_RCX:
-            return "rcx";
-            
-        case PLCRASH_X86_64_RDX:
-            return "rdx";
-            
-        case PLCRASH_X86_64_RDI:
-            return "rdi";
-            
-        case PLCRASH_X86_64_RSI:
-            return "rsi";
-            
-        case PLCRASH_X86_64_RBP:
-            return "rbp";
-            
-        case PLCRASH_X86_64_RSP:
-            return "rsp";
-            
-        case PLCRASH_X86_64_R8:
-            return "r8";
-            
-        case PLCRASH_X86_64_R9:
-            return "r9";
-            
-        case PLCRASH_X86_64_R10:
-            return "r10";
-            
-        case PLCRASH_X86_64_R11:
-            return "r11";
-            
-        case PLCRASH_X86_64_R12:
-            return "r12";
-            
-        case PLCRASH_X86_64_R13:
-            return "r13";
-            
-        case PLCRASH_X86_64_R14:
-            return "r14";
-            
-        case PLCRASH_X86_64_R15:
-            return "r15";
-            
-        case PLCRASH_X86_64_RIP:
-            return "rip";
-            
-        case PLCRASH_X86_64_RFLAGS:
-            return "rflags";
-            
-        case PLCRASH_X86_64_CS:
-            return "cs";
-            
-        case PLCRASH_X86_64_FS:
-            return "fs";
-            
-        case PLCRASH_X86_64_GS:
-            return "gs";
-            
-        default:
-            // Unsupported register
-            break;
-    }
-    
-    /* Unsupported register is an implementation error (checked in unit tests) */
-    PLCF_DEBUG("Missing register name for register id: %d", regnum);
-    abort();
-}
-
 #endif /* defined(__i386__) || defined(__x86_64__) */
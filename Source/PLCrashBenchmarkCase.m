@@ -0,0 +1,153 @@
+/*
+ * Author: Landon Fuller <landonf@plausible.coop>
+ *
+ * Copyright (c) 2012-2013 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashBenchmarkCase.h"
+
+#import <mach/mach_time.h>
+#import <stdlib.h>
+
+/** Number of timed samples collected for each benchmark. */
+#define PLCRASH_BENCHMARK_SAMPLES 11
+
+/** Environment variable that enables timed benchmark runs. */
+#define PLCRASH_BENCHMARK_ENV "PLCRASH_BENCHMARK"
+
+/** Environment variable naming the path to which benchmark results are written as JSON. */
+#define PLCRASH_BENCHMARK_OUTPUT_ENV "PLCRASH_BENCHMARK_OUTPUT"
+
+/** All benchmark results recorded by this process. */
+static NSMutableArray *benchmarkResults = nil;
+
+/*
+ * Compare two double values for qsort().
+ */
+static int compare_double (const void *a, const void *b) {
+    double lhs = *(const double *) a;
+    double rhs = *(const double *) b;
+    if (lhs < rhs)
+        return -1;
+    else if (lhs > rhs)
+        return 1;
+    return 0;
+}
+
+/**
+ * A test case supporting timed microbenchmarks of individual operations.
+ *
+ * Benchmarks are run as ordinary test methods. By default, each benchmark's block is executed once with a single
+ * iteration, verifying that the benchmark remains functional without adding to the test run time. If the
+ * PLCRASH_BENCHMARK environment variable is set, each benchmark is warmed up and then timed over a fixed number of
+ * samples, each of which performs the caller's fixed iteration count. The median, minimum, and maximum time per
+ * operation are logged, and if PLCRASH_BENCHMARK_OUTPUT names a file, all results recorded by the test run are
+ * written to it as JSON.
+ */
+@implementation PLCrashBenchmarkCase
+
+/**
+ * Return YES if timed benchmark runs are enabled.
+ */
++ (BOOL) benchmarksEnabled {
+    return getenv(PLCRASH_BENCHMARK_ENV) != NULL;
+}
+
+/**
+ * Write all recorded results to the path named by PLCRASH_BENCHMARK_OUTPUT, if any.
+ */
++ (void) writeResults {
+    const char *path = getenv(PLCRASH_BENCHMARK_OUTPUT_ENV);
+    if (path == NULL)
+        return;
+
+    NSError *error;
+    NSDictionary *document = [NSDictionary dictionaryWithObject: benchmarkResults forKey: @"benchmarks"];
+    NSData *data = [NSJSONSerialization dataWithJSONObject: document options: NSJSONWritingPrettyPrinted error: &error];
+    if (data == nil || ![data writeToFile: [NSString stringWithUTF8String: path] options: NSDataWritingAtomic error: &error])
+        NSLog(@"Could not write benchmark results to %s: %@", path, error);
+}
+
+/**
+ * Measure the time per operation of @a block.
+ *
+ * @param name The benchmark name. Results are recorded as "TestClass.name".
+ * @param iterations The number of operations performed by each invocation of @a block. This should be fixed for a
+ * given benchmark, allowing results to be compared across runs.
+ * @param block The block to be measured.
+ */
+- (void) measureBenchmark: (NSString *) name iterations: (NSUInteger) iterations block: (PLCrashBenchmarkBlock) block {
+    /* Without timing enabled, just verify that the benchmark runs */
+    if (![[self class] benchmarksEnabled]) {
+        block(1);
+        return;
+    }
+
+    mach_timebase_info_data_t timebase;
+    if (mach_timebase_info(&timebase) != KERN_SUCCESS || timebase.denom == 0) {
+        timebase.numer = 1;
+        timebase.denom = 1;
+    }
+
+    /* Warm up */
+    block(iterations);
+
+    /* Collect the samples */
+    double samples[PLCRASH_BENCHMARK_SAMPLES];
+    for (size_t i = 0; i < PLCRASH_BENCHMARK_SAMPLES; i++) {
+        uint64_t start = mach_absolute_time();
+        block(iterations);
+        uint64_t elapsed = (mach_absolute_time() - start) * timebase.numer / timebase.denom;
+
+        samples[i] = (double) elapsed / iterations;
+    }
+    qsort(samples, PLCRASH_BENCHMARK_SAMPLES, sizeof(samples[0]), compare_double);
+
+    double median = samples[PLCRASH_BENCHMARK_SAMPLES / 2];
+    double min = samples[0];
+    double max = samples[PLCRASH_BENCHMARK_SAMPLES - 1];
+    NSString *fullName = [NSString stringWithFormat: @"%@.%@", NSStringFromClass([self class]), name];
+
+    NSLog(@"%@: %.1f ns/op (min %.1f, max %.1f, %lu iterations)", fullName, median, min, max, (unsigned long) iterations);
+
+    /* Record the result */
+    @synchronized ([PLCrashBenchmarkCase class]) {
+        if (benchmarkResults == nil)
+            benchmarkResults = [[NSMutableArray alloc] init];
+
+        [benchmarkResults addObject: [NSDictionary dictionaryWithObjectsAndKeys:
+                                      fullName, @"name",
+                                      [NSNumber numberWithUnsignedInteger: iterations], @"iterations",
+                                      [NSNumber numberWithUnsignedInteger: PLCRASH_BENCHMARK_SAMPLES], @"samples",
+                                      [NSNumber numberWithDouble: median], @"ns_per_op",
+                                      [NSNumber numberWithDouble: min], @"ns_per_op_min",
+                                      [NSNumber numberWithDouble: max], @"ns_per_op_max",
+                                      nil]];
+
+        [PLCrashBenchmarkCase writeResults];
+    }
+}
+
+@end
@@ -0,0 +1,258 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "PLCrashCustomData.h"
+
+#include <string.h>
+#include <sys/time.h>
+#include <mach/mach_time.h>
+#include <libkern/OSAtomic.h>
+
+/**
+ * @defgroup custom_data Custom Report Data
+ * @ingroup functions
+ *
+ * Preallocated, async-safe memory regions that are copied verbatim into crash reports.
+ *
+ * Both regions are laid out in the report format as they are updated, during normal execution; when a crash report
+ * is written, the regions are copied into the report's custom_data section without any further encoding. Updates
+ * are lock-free, and may be performed from any thread, including from within a signal handler.
+ *
+ * @{
+ */
+
+/**
+ * Return the number of bytes required for a key/value area containing @a slotCount slots.
+ *
+ * @param slotCount The number of key/value pairs the area must be able to hold.
+ */
+size_t PLCrashKeyValueAreaSize (uint32_t slotCount) {
+    return sizeof(PLCrashKeyValueArea) + sizeof(plcrash_key_value_slot_t) * (size_t) slotCount;
+}
+
+/**
+ * Initialize a key/value area within @a memory. The area's slot count is derived from @a length; use
+ * PLCrashKeyValueAreaSize() to determine the length required for a given number of slots.
+ *
+ * @param memory The memory within which the area will be initialized. The memory must be 8-byte aligned, and must
+ * remain valid for as long as the area is registered with PLCrashReporter.
+ * @param length The size of @a memory, in bytes.
+ *
+ * @return Returns the initialized area, or NULL if @a memory is misaligned or too small to hold a single slot.
+ *
+ * @warning This function is not async-safe, and must not be called while the area is registered.
+ */
+PLCrashKeyValueArea *PLCrashKeyValueAreaInit (void *memory, size_t length) {
+    if (memory == NULL || ((uintptr_t) memory % sizeof(uint64_t)) != 0 || length < PLCrashKeyValueAreaSize(1))
+        return NULL;
+
+    size_t count = (length - sizeof(PLCrashKeyValueArea)) / sizeof(plcrash_key_value_slot_t);
+    if (count > UINT32_MAX)
+        count = UINT32_MAX;
+
+    PLCrashKeyValueArea *area = memory;
+    memset(area, 0, PLCrashKeyValueAreaSize((uint32_t) count));
+    area->slot_count = (uint32_t) count;
+
+    /* The magic value marks the area as valid; ensure it is written last */
+    OSMemoryBarrier();
+    area->magic = PLCRASH_KEY_VALUE_AREA_MAGIC;
+
+    return area;
+}
+
+/* Acquire the slot's sequence lock, returning false if the slot is currently held. */
+static bool key_value_slot_lock (plcrash_key_value_slot_t *slot) {
+    int32_t sequence = slot->sequence;
+    if ((sequence & 1) != 0)
+        return false;
+
+    return OSAtomicCompareAndSwap32Barrier(sequence, sequence + 1, &slot->sequence);
+}
+
+/* Release the slot's sequence lock. */
+static void key_value_slot_unlock (plcrash_key_value_slot_t *slot) {
+    OSAtomicIncrement32Barrier(&slot->sequence);
+}
+
+/* Return true if @a slot holds @a key. */
+static bool key_value_slot_matches (plcrash_key_value_slot_t *slot, const char *key, size_t key_length) {
+    return slot->key_length == key_length && memcmp(slot->key, key, key_length) == 0;
+}
+
+/**
+ * Set the value of @a key, replacing any existing value.
+ *
+ * If the slot holding @a key is concurrently being written by another thread, a second slot may be claimed for the
+ * key; the most recently written slot takes precedence when the report is decoded.
+ *
+ * @param area The key/value area.
+ * @param key The NUL-terminated key, at most #PLCRASH_KEY_VALUE_AREA_MAX_KEY_LENGTH bytes in length.
+ * @param value The NUL-terminated value, at most #PLCRASH_KEY_VALUE_AREA_MAX_VALUE_LENGTH bytes in length.
+ *
+ * @return Returns true on success, or false if the key or value is too long, or if no free slot is available.
+ *
+ * @warning This function is async-safe.
+ */
+bool PLCrashKeyValueAreaSet (PLCrashKeyValueArea *area, const char *key, const char *value) {
+    size_t key_length = strlen(key);
+    size_t value_length = strlen(value);
+    if (key_length == 0 || key_length > PLCRASH_KEY_VALUE_AREA_MAX_KEY_LENGTH || value_length > PLCRASH_KEY_VALUE_AREA_MAX_VALUE_LENGTH)
+        return false;
+
+    /* Prefer the slot already holding the key; otherwise, claim the first empty slot */
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint32_t i = 0; i < area->slot_count; i++) {
+            plcrash_key_value_slot_t *slot = &area->slots[i];
+            bool candidate = (pass == 0) ? key_value_slot_matches(slot, key, key_length) : slot->key_length == 0;
+            if (!candidate || !key_value_slot_lock(slot))
+                continue;
+
+            /* Verify that the slot was not modified before it was locked */
+            candidate = (pass == 0) ? key_value_slot_matches(slot, key, key_length) : slot->key_length == 0;
+            if (!candidate) {
+                key_value_slot_unlock(slot);
+                continue;
+            }
+
+            memcpy(slot->key, key, key_length);
+            memcpy(slot->value, value, value_length);
+            slot->key_length = (uint16_t) key_length;
+            slot->value_length = (uint16_t) value_length;
+
+            key_value_slot_unlock(slot);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Remove @a key and its value, if any.
+ *
+ * @param area The key/value area.
+ * @param key The NUL-terminated key.
+ *
+ * @warning This function is async-safe.
+ */
+void PLCrashKeyValueAreaRemove (PLCrashKeyValueArea *area, const char *key) {
+    size_t key_length = strlen(key);
+
+    for (uint32_t i = 0; i < area->slot_count; i++) {
+        plcrash_key_value_slot_t *slot = &area->slots[i];
+        if (!key_value_slot_matches(slot, key, key_length) || !key_value_slot_lock(slot))
+            continue;
+
+        if (key_value_slot_matches(slot, key, key_length))
+            slot->key_length = 0;
+
+        key_value_slot_unlock(slot);
+    }
+}
+
+/**
+ * Return the number of bytes required for a breadcrumb buffer containing @a capacity entries.
+ *
+ * @param capacity The number of breadcrumbs the buffer must retain.
+ */
+size_t PLCrashBreadcrumbBufferSize (uint32_t capacity) {
+    return sizeof(PLCrashBreadcrumbBuffer) + sizeof(plcrash_breadcrumb_entry_t) * (size_t) capacity;
+}
+
+/**
+ * Initialize a breadcrumb buffer within @a memory. The buffer's capacity is derived from @a length; use
+ * PLCrashBreadcrumbBufferSize() to determine the length required for a given capacity.
+ *
+ * @param memory The memory within which the buffer will be initialized. The memory must be 8-byte aligned, and must
+ * remain valid for as long as the buffer is registered with PLCrashReporter.
+ * @param length The size of @a memory, in bytes.
+ *
+ * @return Returns the initialized buffer, or NULL if @a memory is misaligned or too small to hold a single entry.
+ *
+ * @warning This function is not async-safe, and must not be called while the buffer is registered.
+ */
+PLCrashBreadcrumbBuffer *PLCrashBreadcrumbBufferInit (void *memory, size_t length) {
+    if (memory == NULL || ((uintptr_t) memory % sizeof(uint64_t)) != 0 || length < PLCrashBreadcrumbBufferSize(1))
+        return NULL;
+
+    size_t capacity = (length - sizeof(PLCrashBreadcrumbBuffer)) / sizeof(plcrash_breadcrumb_entry_t);
+    if (capacity > INT32_MAX)
+        capacity = INT32_MAX;
+
+    PLCrashBreadcrumbBuffer *buffer = memory;
+    memset(buffer, 0, PLCrashBreadcrumbBufferSize((uint32_t) capacity));
+    buffer->capacity = (uint32_t) capacity;
+
+    /* Record the reference points from which entry timestamps are converted to wall clock time */
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    buffer->timebase_numer = timebase.numer;
+    buffer->timebase_denom = timebase.denom;
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    buffer->reference_mach_time = mach_absolute_time();
+    buffer->reference_time = (int64_t) tv.tv_sec * 1000000 + tv.tv_usec;
+
+    /* The magic value marks the buffer as valid; ensure it is written last */
+    OSMemoryBarrier();
+    buffer->magic = PLCRASH_BREADCRUMB_BUFFER_MAGIC;
+
+    return buffer;
+}
+
+/**
+ * Append a breadcrumb to @a buffer, replacing the oldest breadcrumb if the buffer is full.
+ *
+ * @param buffer The breadcrumb buffer.
+ * @param message The NUL-terminated message. Messages longer than #PLCRASH_BREADCRUMB_MAX_MESSAGE_LENGTH bytes
+ * are truncated.
+ *
+ * @warning This function is async-safe.
+ */
+void PLCrashBreadcrumbBufferAppend (PLCrashBreadcrumbBuffer *buffer, const char *message) {
+    uint32_t index = (uint32_t) OSAtomicIncrement32Barrier(&buffer->next) - 1;
+    plcrash_breadcrumb_entry_t *entry = &buffer->entries[index % buffer->capacity];
+
+    /* Invalidate the entry while it is written; the sequence value is only restored once the entry is complete */
+    entry->sequence = 0;
+    OSMemoryBarrier();
+
+    size_t length = strnlen(message, PLCRASH_BREADCRUMB_MAX_MESSAGE_LENGTH);
+    entry->timestamp = mach_absolute_time();
+    entry->length = (uint16_t) length;
+    memcpy(entry->message, message, length);
+
+    OSMemoryBarrier();
+    entry->sequence = index + 1;
+}
+
+/**
+ * @}
+ */
@@ -0,0 +1,194 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PLCRASH_CUSTOM_DATA_H
+#define PLCRASH_CUSTOM_DATA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @ingroup constants
+ *
+ * Maximum length of a key stored in a PLCrashKeyValueArea, in bytes.
+ */
+#define PLCRASH_KEY_VALUE_AREA_MAX_KEY_LENGTH 32
+
+/**
+ * @ingroup constants
+ *
+ * Maximum length of a value stored in a PLCrashKeyValueArea, in bytes.
+ */
+#define PLCRASH_KEY_VALUE_AREA_MAX_VALUE_LENGTH 88
+
+/**
+ * @ingroup constants
+ *
+ * Maximum length of a breadcrumb message stored in a PLCrashBreadcrumbBuffer, in bytes. Longer messages are
+ * truncated.
+ */
+#define PLCRASH_BREADCRUMB_MAX_MESSAGE_LENGTH 48
+
+/**
+ * @internal
+ *
+ * Magic value identifying a key/value area.
+ */
+#define PLCRASH_KEY_VALUE_AREA_MAGIC 0x766b6c70 /* 'plkv', little-endian */
+
+/**
+ * @internal
+ *
+ * Magic value identifying a breadcrumb buffer.
+ */
+#define PLCRASH_BREADCRUMB_BUFFER_MAGIC 0x63626c70 /* 'plbc', little-endian */
+
+/**
+ * @internal
+ *
+ * A single key/value slot. Slots are updated under a per-slot sequence lock; a slot with an odd sequence value
+ * was being written when it was copied, and must be ignored.
+ */
+typedef struct plcrash_key_value_slot {
+    /** The slot's sequence lock value. */
+    volatile int32_t sequence;
+
+    /** The length of the key, in bytes, or 0 if the slot is empty. */
+    uint16_t key_length;
+
+    /** The length of the value, in bytes. */
+    uint16_t value_length;
+
+    /** The key, followed by unused space. The key is not NUL-terminated. */
+    char key[PLCRASH_KEY_VALUE_AREA_MAX_KEY_LENGTH];
+
+    /** The value, followed by unused space. The value is not NUL-terminated. */
+    char value[PLCRASH_KEY_VALUE_AREA_MAX_VALUE_LENGTH];
+} plcrash_key_value_slot_t;
+
+/**
+ * @ingroup types
+ *
+ * A fixed-size, preallocated area of key/value pairs, copied verbatim into crash reports. The area is laid out in
+ * its on-disk format when it is updated, so that no encoding is performed when a crash report is written.
+ *
+ * The area is initialized within caller-supplied memory by PLCrashKeyValueAreaInit(), and registered with
+ * PLCrashReporter::setKeyValueArea:.
+ */
+typedef struct PLCrashKeyValueArea {
+    /** @internal The area magic value (#PLCRASH_KEY_VALUE_AREA_MAGIC). */
+    uint32_t magic;
+
+    /** @internal The number of slots that follow the header. */
+    uint32_t slot_count;
+
+    /** @internal The area's slots. */
+    plcrash_key_value_slot_t slots[];
+} PLCrashKeyValueArea;
+
+/**
+ * @internal
+ *
+ * A single breadcrumb entry. An entry is valid only if its @a sequence is equal to its absolute index in the
+ * buffer plus one; other entries were being written when the buffer was copied, or have not yet been written.
+ */
+typedef struct plcrash_breadcrumb_entry {
+    /** The mach_absolute_time() at which the breadcrumb was recorded. */
+    uint64_t timestamp;
+
+    /** The absolute index of the entry, plus one. Written after the entry's contents. */
+    volatile uint32_t sequence;
+
+    /** The length of @a message, in bytes. */
+    uint16_t length;
+
+    /** Reserved; must be zero. */
+    uint16_t reserved;
+
+    /** The message. The message is not NUL-terminated. */
+    char message[PLCRASH_BREADCRUMB_MAX_MESSAGE_LENGTH];
+} plcrash_breadcrumb_entry_t;
+
+/**
+ * @ingroup types
+ *
+ * A preallocated, lock-free ring buffer of breadcrumb messages, copied verbatim into crash reports. Once full,
+ * each new breadcrumb replaces the oldest.
+ *
+ * The buffer is initialized within caller-supplied memory by PLCrashBreadcrumbBufferInit(), and registered with
+ * PLCrashReporter::setBreadcrumbBuffer:.
+ */
+typedef struct PLCrashBreadcrumbBuffer {
+    /** @internal The buffer magic value (#PLCRASH_BREADCRUMB_BUFFER_MAGIC). */
+    uint32_t magic;
+
+    /** @internal The number of entries that follow the header. */
+    uint32_t capacity;
+
+    /** @internal The mach_timebase_info() numerator. */
+    uint32_t timebase_numer;
+
+    /** @internal The mach_timebase_info() denominator. */
+    uint32_t timebase_denom;
+
+    /** @internal The wall clock time at which the buffer was initialized, in microseconds since the UNIX epoch. */
+    int64_t reference_time;
+
+    /** @internal The mach_absolute_time() at which the buffer was initialized. */
+    uint64_t reference_mach_time;
+
+    /** @internal The total number of entries ever claimed. The next entry is written at this index modulo
+     * @a capacity. */
+    volatile int32_t next;
+
+    /** @internal Reserved; must be zero. */
+    uint32_t reserved;
+
+    /** @internal The buffer's entries. */
+    plcrash_breadcrumb_entry_t entries[];
+} PLCrashBreadcrumbBuffer;
+
+size_t PLCrashKeyValueAreaSize (uint32_t slotCount);
+PLCrashKeyValueArea *PLCrashKeyValueAreaInit (void *memory, size_t length);
+bool PLCrashKeyValueAreaSet (PLCrashKeyValueArea *area, const char *key, const char *value);
+void PLCrashKeyValueAreaRemove (PLCrashKeyValueArea *area, const char *key);
+
+size_t PLCrashBreadcrumbBufferSize (uint32_t capacity);
+PLCrashBreadcrumbBuffer *PLCrashBreadcrumbBufferInit (void *memory, size_t length);
+void PLCrashBreadcrumbBufferAppend (PLCrashBreadcrumbBuffer *buffer, const char *message);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PLCRASH_CUSTOM_DATA_H */
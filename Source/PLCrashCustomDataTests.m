@@ -0,0 +1,112 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "SenTestCompat.h"
+
+#import "PLCrashCustomData.h"
+
+@interface PLCrashCustomDataTests : SenTestCase {
+@private
+    /** Backing memory for the key/value area */
+    uint64_t _kvMemory[(sizeof(PLCrashKeyValueArea) + 3 * sizeof(plcrash_key_value_slot_t)) / sizeof(uint64_t)];
+
+    /** Backing memory for the breadcrumb buffer */
+    uint64_t _bcMemory[(sizeof(PLCrashBreadcrumbBuffer) + 3 * sizeof(plcrash_breadcrumb_entry_t)) / sizeof(uint64_t)];
+}
+@end
+
+@implementation PLCrashCustomDataTests
+
+- (void) testKeyValueAreaInit {
+    STAssertEquals(sizeof(_kvMemory), PLCrashKeyValueAreaSize(3), @"Incorrect area size");
+    STAssertNULL(PLCrashKeyValueAreaInit(_kvMemory, sizeof(PLCrashKeyValueArea)), @"Accepted an area without slots");
+    STAssertNULL(PLCrashKeyValueAreaInit(((uint8_t *) _kvMemory) + 1, sizeof(_kvMemory) - 1), @"Accepted misaligned memory");
+
+    PLCrashKeyValueArea *area = PLCrashKeyValueAreaInit(_kvMemory, sizeof(_kvMemory));
+    STAssertNotNULL(area, @"Failed to initialize area");
+    STAssertEquals((uint32_t) PLCRASH_KEY_VALUE_AREA_MAGIC, area->magic, @"Incorrect magic");
+    STAssertEquals((uint32_t) 3, area->slot_count, @"Incorrect slot count");
+}
+
+- (void) testKeyValueAreaSet {
+    PLCrashKeyValueArea *area = PLCrashKeyValueAreaInit(_kvMemory, sizeof(_kvMemory));
+
+    STAssertTrue(PLCrashKeyValueAreaSet(area, "a", "1"), @"Failed to set value");
+    STAssertTrue(PLCrashKeyValueAreaSet(area, "b", "2"), @"Failed to set value");
+
+    /* Replacing a value must reuse the key's slot */
+    STAssertTrue(PLCrashKeyValueAreaSet(area, "a", "replaced"), @"Failed to replace value");
+    STAssertEquals((uint16_t) 8, area->slots[0].value_length, @"Value was not replaced in place");
+    STAssertTrue(memcmp(area->slots[0].value, "replaced", 8) == 0, @"Incorrect value");
+    STAssertEquals((int32_t) 4, area->slots[0].sequence, @"Sequence was not advanced for each write");
+
+    /* Removal frees the slot for reuse */
+    STAssertTrue(PLCrashKeyValueAreaSet(area, "c", "3"), @"Failed to set value");
+    STAssertFalse(PLCrashKeyValueAreaSet(area, "d", "4"), @"Set a value in a full area");
+    PLCrashKeyValueAreaRemove(area, "b");
+    STAssertEquals((uint16_t) 0, area->slots[1].key_length, @"Key was not removed");
+    STAssertTrue(PLCrashKeyValueAreaSet(area, "d", "4"), @"Removed slot was not reused");
+
+    /* Oversized keys and values are rejected */
+    char value[PLCRASH_KEY_VALUE_AREA_MAX_VALUE_LENGTH + 2];
+    memset(value, 'x', sizeof(value) - 1);
+    value[sizeof(value) - 1] = '\0';
+    STAssertFalse(PLCrashKeyValueAreaSet(area, "a", value), @"Accepted an oversized value");
+    STAssertFalse(PLCrashKeyValueAreaSet(area, "", "1"), @"Accepted an empty key");
+}
+
+- (void) testBreadcrumbBufferAppend {
+    STAssertEquals(sizeof(_bcMemory), PLCrashBreadcrumbBufferSize(3), @"Incorrect buffer size");
+
+    PLCrashBreadcrumbBuffer *buffer = PLCrashBreadcrumbBufferInit(_bcMemory, sizeof(_bcMemory));
+    STAssertNotNULL(buffer, @"Failed to initialize buffer");
+    STAssertEquals((uint32_t) 3, buffer->capacity, @"Incorrect capacity");
+    STAssertTrue(buffer->timebase_denom != 0, @"Timebase was not recorded");
+
+    for (int i = 0; i < 5; i++) {
+        char message[8];
+        snprintf(message, sizeof(message), "msg%d", i);
+        PLCrashBreadcrumbBufferAppend(buffer, message);
+    }
+
+    /* The most recent entries overwrite the oldest, and each entry is stamped with its absolute index */
+    STAssertEquals((int32_t) 5, buffer->next, @"Incorrect entry count");
+    STAssertEquals((uint32_t) 4, buffer->entries[0].sequence, @"Incorrect sequence");
+    STAssertTrue(memcmp(buffer->entries[0].message, "msg3", 4) == 0, @"Oldest entry was not replaced");
+    STAssertEquals((uint32_t) 5, buffer->entries[1].sequence, @"Incorrect sequence");
+    STAssertEquals((uint32_t) 3, buffer->entries[2].sequence, @"Incorrect sequence");
+
+    /* Long messages are truncated */
+    char message[PLCRASH_BREADCRUMB_MAX_MESSAGE_LENGTH + 16];
+    memset(message, 'x', sizeof(message) - 1);
+    message[sizeof(message) - 1] = '\0';
+    PLCrashBreadcrumbBufferAppend(buffer, message);
+    STAssertEquals((uint16_t) PLCRASH_BREADCRUMB_MAX_MESSAGE_LENGTH, buffer->entries[2].length, @"Message was not truncated");
+}
+
+@end
@@ -101,6 +101,66 @@
 #    define PLCRASH_FEATURE_UNWIND_COMPACT 1
 #endif
 
+#ifndef PLCRASH_FEATURE_MMAP_OUTPUT
+/**
+ * If true, crash reports are written to a preallocated, memory-mapped output file that is created when the
+ * crash reporter is enabled, rather than through buffered write(2) calls to a file opened at crash time.
+ */
+#    define PLCRASH_FEATURE_MMAP_OUTPUT 1
+#endif
+
+#ifndef PLCRASH_FEATURE_DEFERRED_IMAGE_REGISTRATION
+/**
+ * If true, dyld image add notifications only record the image's header address; the image is parsed and
+ * registered on a background queue. All outstanding registrations are flushed prior to enabling the crash
+ * reporter and prior to writing a live report.
+ */
+#    define PLCRASH_FEATURE_DEFERRED_IMAGE_REGISTRATION 1
+#endif
+
+#ifndef PLCRASH_FEATURE_LAZY_IMAGE_PARSING
+/**
+ * If true, registered images record only their header address and name; Mach-O parsing is deferred until the
+ * image is first accessed, or until a low-priority background pass parses and pre-encodes it. Parsing may
+ * then occur at crash time.
+ */
+#    define PLCRASH_FEATURE_LAZY_IMAGE_PARSING 1
+#endif
+
+#ifndef PLCRASH_FEATURE_OUT_OF_PROCESS_HELPER
+/**
+ * If true, enable support for writing crash reports from an out-of-process helper (see PLCrashHelperServer). The
+ * helper requires Mach exception support and the mach_exc APIs, and is only supported on Mac OS X.
+ */
+#  if PLCRASH_FEATURE_MACH_EXCEPTIONS && !TARGET_OS_IPHONE
+#    define PLCRASH_FEATURE_OUT_OF_PROCESS_HELPER 1
+#  else
+#    define PLCRASH_FEATURE_OUT_OF_PROCESS_HELPER 0
+#  endif
+#endif
+
+#ifndef PLCRASH_FEATURE_HOST_ONLY_CRASH_PATH
+/**
+ * If true, the crash path is specialized at compile time for the host's pointer width and byte order. Mach-O images
+ * that do not match the host are rejected, byte swapping is performed inline rather than through the byte order
+ * function table, and 32-bit/64-bit dispatch on image width is resolved by the compiler, allowing the unused
+ * variants to be dropped.
+ *
+ * This is intended for size- and latency-sensitive release builds; it must not be enabled in builds that parse
+ * images of a foreign architecture, such as the out-of-process helper or the test suite.
+ */
+#    define PLCRASH_FEATURE_HOST_ONLY_CRASH_PATH 0
+#endif
+
+#ifndef PLCRASH_FEATURE_PROBES
+/**
+ * If true, os_signpost probes are emitted from the frame walker, symbol look-ups, memory object mappings and each
+ * section of the report writer while a live report is being written. Probes are never emitted from the crash
+ * handlers. If false, the probes are compiled out entirely.
+ */
+#  define PLCRASH_FEATURE_PROBES 0
+#endif
+
 /**
  * @}
  */
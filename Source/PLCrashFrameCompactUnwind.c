@@ -26,18 +26,243 @@
 
 
 #include "PLCrashFrameCompactUnwind.h"
+#include "PLCrashFrameDWARFUnwind.h"
 #include "PLCrashAsyncCompactUnwindEncoding.h"
 #include "PLCrashFeatureConfig.h"
+#include "PLCrashAsync.h"
 
 #include <inttypes.h>
 
 #if PLCRASH_FEATURE_UNWIND_DWARF
 
+/** The number of entry slots in a plframe_compact_unwind_cache. Must be a power of two. */
+#define PLFRAME_COMPACT_UNWIND_CACHE_SIZE 128
+
+/** The maximum number of slots that will be probed when looking up or inserting a cache entry. */
+#define PLFRAME_COMPACT_UNWIND_CACHE_MAX_PROBES 4
+
+/** The number of per-image CFE readers retained by a plframe_compact_unwind_cache. */
+#define PLFRAME_COMPACT_UNWIND_READER_CACHE_SIZE 8
+
+/**
+ * @internal
+ *
+ * A decoded compact unwind entry.
+ */
+typedef struct plframe_compact_unwind_cache_entry {
+    /** The PC for which the entry was found, or 0x0 if the slot is unused. */
+    pl_vm_address_t pc;
+
+    /** The in-core address of the function containing @a pc. */
+    pl_vm_address_t function_address;
+
+    /** The decoded entry. */
+    plcrash_async_cfe_entry_t entry;
+} plframe_compact_unwind_cache_entry_t;
+
+/**
+ * @internal
+ *
+ * A CFE reader retained for an image's cached __unwind_info mapping.
+ */
+typedef struct plframe_compact_unwind_reader_entry {
+    /** The section cache mapping from which @a reader was initialized, or NULL if the slot is unused. */
+    plcrash_async_mobject_t *mobj;
+
+    /** The initialized reader. */
+    plcrash_async_cfe_reader_t reader;
+} plframe_compact_unwind_reader_entry_t;
+
+/**
+ * @internal
+ *
+ * A cache of decoded compact unwind entries, keyed by PC. Multiple threads will often be suspended at the same
+ * PC (eg, within the run loop or a condition variable wait), and each will otherwise require a search of the
+ * image's __unwind_info section.
+ */
+struct plframe_compact_unwind_cache {
+    /** Open-addressed cache entries. */
+    plframe_compact_unwind_cache_entry_t entries[PLFRAME_COMPACT_UNWIND_CACHE_SIZE];
+
+    /** CFE readers, keyed by their section cache mapping. Retaining the readers allows their decoded second-level
+     * pages to be reused by later frames within the same image. */
+    plframe_compact_unwind_reader_entry_t readers[PLFRAME_COMPACT_UNWIND_READER_CACHE_SIZE];
+
+    /** The @a readers slot to be replaced by the next reader. */
+    uint32_t next_reader;
+};
+
+/* Compute the initial cache index for @a pc */
+static size_t plframe_compact_unwind_cache_index (pl_vm_address_t pc) {
+    return (size_t) (((uint64_t) pc * 0x9E3779B97F4A7C15ULL) >> 32) & (PLFRAME_COMPACT_UNWIND_CACHE_SIZE - 1);
+}
+
+/* Return the size of the cache allocation */
+static vm_size_t plframe_compact_unwind_cache_allocation_size (void) {
+    return round_page(sizeof(struct plframe_compact_unwind_cache));
+}
+
+/**
+ * @internal
+ *
+ * Return the compact unwind cache of @a unwind_cache, lazily allocating it if necessary.
+ *
+ * @param unwind_cache The unwind cache, or NULL.
+ *
+ * @return Returns the cache, or NULL if @a unwind_cache is NULL or the cache could not be allocated.
+ */
+static struct plframe_compact_unwind_cache *plframe_compact_unwind_cache_get (plframe_unwind_cache_t *unwind_cache) {
+    if (unwind_cache == NULL)
+        return NULL;
+
+    /* Lazily allocate the cache; scratch allocations are zero-filled, and no entries are in use */
+    if (unwind_cache->compact_cache == NULL) {
+        vm_address_t addr;
+        kern_return_t kt = plcrash_async_scratch_allocate(&addr, plframe_compact_unwind_cache_allocation_size());
+        if (kt != KERN_SUCCESS) {
+            PLCF_DEBUG("plcrash_async_scratch_allocate failed with error %x, the compact unwind cache could not be initialized", kt);
+            return NULL;
+        }
+
+        unwind_cache->compact_cache = (struct plframe_compact_unwind_cache *) addr;
+    }
+
+    return unwind_cache->compact_cache;
+}
+
+/**
+ * @internal
+ *
+ * Look up the cached compact unwind entry for @a pc.
+ *
+ * @param unwind_cache The unwind cache, or NULL.
+ * @param pc The PC to look up.
+ *
+ * @return Returns the cached entry, or NULL if not found.
+ */
+static plframe_compact_unwind_cache_entry_t *plframe_compact_unwind_cache_lookup (plframe_unwind_cache_t *unwind_cache, pl_vm_address_t pc) {
+    if (unwind_cache == NULL || unwind_cache->compact_cache == NULL || pc == 0x0)
+        return NULL;
+
+    size_t index = plframe_compact_unwind_cache_index(pc);
+    for (size_t i = 0; i < PLFRAME_COMPACT_UNWIND_CACHE_MAX_PROBES; i++) {
+        plframe_compact_unwind_cache_entry_t *cached = &unwind_cache->compact_cache->entries[(index + i) & (PLFRAME_COMPACT_UNWIND_CACHE_SIZE - 1)];
+        if (cached->pc == 0x0)
+            return NULL;
+
+        if (cached->pc == pc)
+            return cached;
+    }
+
+    return NULL;
+}
+
+/**
+ * @internal
+ *
+ * Record a decoded compact unwind entry in the cache. The cache is not guaranteed storage; storing may silently
+ * fail if the cache can not be allocated, or the probe limit is reached.
+ *
+ * @param unwind_cache The unwind cache, or NULL.
+ * @param pc The PC for which the entry was found.
+ * @param function_address The in-core address of the function containing @a pc.
+ * @param entry The decoded entry.
+ */
+static void plframe_compact_unwind_cache_insert (plframe_unwind_cache_t *unwind_cache, pl_vm_address_t pc, pl_vm_address_t function_address, plcrash_async_cfe_entry_t *entry) {
+    if (pc == 0x0 || plframe_compact_unwind_cache_get(unwind_cache) == NULL)
+        return;
+
+    size_t index = plframe_compact_unwind_cache_index(pc);
+    for (size_t i = 0; i < PLFRAME_COMPACT_UNWIND_CACHE_MAX_PROBES; i++) {
+        plframe_compact_unwind_cache_entry_t *cached = &unwind_cache->compact_cache->entries[(index + i) & (PLFRAME_COMPACT_UNWIND_CACHE_SIZE - 1)];
+        if (cached->pc != 0x0)
+            continue;
+
+        cached->pc = pc;
+        cached->function_address = function_address;
+        plcrash_async_memcpy(&cached->entry, entry, sizeof(cached->entry));
+        return;
+    }
+}
+
+/**
+ * @internal
+ *
+ * Fetch a CFE reader for @a mobj. If @a mobj is a section cache mapping, the reader will be retained by the compact
+ * unwind cache, and reused by later look-ups within the same image.
+ *
+ * @param unwind_cache The unwind cache, or NULL.
+ * @param mobj The mapped __unwind_info section.
+ * @param cached True if @a mobj is owned by the unwind cache's section cache, and will remain valid for the lifetime
+ * of @a unwind_cache.
+ * @param cputype The target CPU type.
+ * @param storage Storage to be used if the reader can not be retained by the cache.
+ * @param reader On success, the reader. If set to @a storage, the caller is responsible for freeing the reader
+ * via plcrash_async_cfe_reader_free().
+ */
+static plcrash_error_t plframe_compact_unwind_cache_reader (plframe_unwind_cache_t *unwind_cache,
+                                                            plcrash_async_mobject_t *mobj,
+                                                            bool cached,
+                                                            cpu_type_t cputype,
+                                                            plcrash_async_cfe_reader_t *storage,
+                                                            plcrash_async_cfe_reader_t **reader)
+{
+    struct plframe_compact_unwind_cache *cache = cached ? plframe_compact_unwind_cache_get(unwind_cache) : NULL;
+    plcrash_error_t err;
+
+    if (cache == NULL) {
+        if ((err = plcrash_async_cfe_reader_init(storage, mobj, cputype)) != PLCRASH_ESUCCESS)
+            return err;
+
+        *reader = storage;
+        return PLCRASH_ESUCCESS;
+    }
+
+    /* Check for an existing reader */
+    for (uint32_t i = 0; i < PLFRAME_COMPACT_UNWIND_READER_CACHE_SIZE; i++) {
+        if (cache->readers[i].mobj == mobj) {
+            *reader = &cache->readers[i].reader;
+            return PLCRASH_ESUCCESS;
+        }
+    }
+
+    /* Replace the oldest reader */
+    plframe_compact_unwind_reader_entry_t *slot = &cache->readers[cache->next_reader];
+    cache->next_reader = (cache->next_reader + 1) % PLFRAME_COMPACT_UNWIND_READER_CACHE_SIZE;
+
+    if (slot->mobj != NULL) {
+        plcrash_async_cfe_reader_free(&slot->reader);
+        slot->mobj = NULL;
+    }
+
+    if ((err = plcrash_async_cfe_reader_init(&slot->reader, mobj, cputype)) != PLCRASH_ESUCCESS)
+        return err;
+
+    slot->mobj = mobj;
+    *reader = &slot->reader;
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Free a compact unwind cache allocated by the compact unwind frame reader.
+ *
+ * @param cache The cache to be freed.
+ */
+void plframe_compact_unwind_cache_free (struct plframe_compact_unwind_cache *cache) {
+    for (uint32_t i = 0; i < PLFRAME_COMPACT_UNWIND_READER_CACHE_SIZE; i++) {
+        if (cache->readers[i].mobj != NULL)
+            plcrash_async_cfe_reader_free(&cache->readers[i].reader);
+    }
+
+    plcrash_async_scratch_deallocate((vm_address_t) cache, plframe_compact_unwind_cache_allocation_size());
+}
+
 /**
  * Attempt to fetch next frame using compact frame unwinding data from @a image_list.
  *
  * @param task The task containing the target frame stack.
  * @param image_list The list of images loaded in the target @a task.
+ * @param unwind_cache A cache of unwind data to be used by the reader, or NULL.
  * @param current_frame The current stack frame.
  * @param previous_frame The previous stack frame, or NULL if this is the first frame.
  * @param next_frame The new frame to be initialized.
@@ -46,6 +271,7 @@
  */
 plframe_error_t plframe_cursor_read_compact_unwind (task_t task,
                                                     plcrash_async_image_list_t *image_list,
+                                                    plframe_unwind_cache_t *unwind_cache,
                                                     const plframe_stackframe_t *current_frame,
                                                     const plframe_stackframe_t *previous_frame,
                                                     plframe_stackframe_t *next_frame)
@@ -53,12 +279,43 @@ plframe_error_t plframe_cursor_read_compact_unwind (task_t task,
     plframe_error_t result;
     plcrash_error_t err;
 
+    /* Mapped __unwind_info section; either cached, or backed by unwind_mobj_storage */
+    plcrash_async_mobject_t unwind_mobj_storage;
+    plcrash_async_mobject_t *unwind_mobj = NULL;
+
     /* Fetch the IP. It should always be available */
     if (!plcrash_async_thread_state_has_reg(&current_frame->thread_state, PLCRASH_REG_IP)) {
         PLCF_DEBUG("Frame is missing a valid IP register, skipping compact unwind encoding");
         return PLFRAME_EBADFRAME;
     }
     plcrash_greg_t pc = plcrash_async_thread_state_get_reg(&current_frame->thread_state, PLCRASH_REG_IP);
+
+    /* If the entry for this PC has already been decoded, the unwind section need not be consulted */
+    plframe_compact_unwind_cache_entry_t *cached = plframe_compact_unwind_cache_lookup(unwind_cache, pc);
+    if (cached != NULL) {
+        if (plcrash_async_cfe_entry_type(&cached->entry) == PLCRASH_ASYNC_CFE_ENTRY_TYPE_NONE)
+            return PLFRAME_ENOFRAME;
+
+        /* Hand DWARF entries off to the DWARF reader, which requires the image */
+        if (plcrash_async_cfe_entry_type(&cached->entry) == PLCRASH_ASYNC_CFE_ENTRY_TYPE_DWARF) {
+            plcrash_async_image_list_set_reading(image_list, true);
+            plcrash_async_image_t *image = plcrash_async_image_containing_address(image_list, pc);
+            if (image != NULL) {
+                result = plframe_cursor_read_dwarf_unwind_fde(task, image, plcrash_async_cfe_entry_stack_offset(&cached->entry), unwind_cache, current_frame, previous_frame, next_frame);
+            } else {
+                result = PLFRAME_ENOTSUP;
+            }
+            plcrash_async_image_list_set_reading(image_list, false);
+            return result;
+        }
+
+        if ((err = plcrash_async_cfe_entry_apply(task, cached->function_address, &current_frame->thread_state, &cached->entry, &next_frame->thread_state, plframe_unwind_cache_stack(unwind_cache))) != PLCRASH_ESUCCESS) {
+            PLCF_DEBUG("Failed to apply cached CFE entry for PC 0x%" PRIx64 ": %d", (uint64_t) pc, err);
+            return PLFRAME_ENOFRAME;
+        }
+
+        return PLFRAME_ESUCCESS;
+    }
     
     /* Find the corresponding image */
     plcrash_async_image_list_set_reading(image_list, true);
@@ -69,32 +326,42 @@ plframe_error_t plframe_cursor_read_compact_unwind (task_t task,
         goto cleanup;
     }
     
+    /* Skip images already known to lack compact unwind data */
+    if (plcrash_async_image_has_flags(image, PLCRASH_ASYNC_IMAGE_NO_COMPACT_UNWIND)) {
+        result = PLFRAME_ENOTSUP;
+        goto cleanup;
+    }
+
     /* Map the unwind section */
-    plcrash_async_mobject_t unwind_mobj;
-    err = plcrash_async_macho_map_section(&image->macho_image, SEG_TEXT, "__unwind_info", &unwind_mobj);
+    err = plcrash_async_macho_section_cache_map(plframe_unwind_cache_sections(unwind_cache), &image->macho_image, SEG_TEXT, "__unwind_info", &unwind_mobj_storage, &unwind_mobj);
     if (err != PLCRASH_ESUCCESS) {
-        if (err != PLCRASH_ENOTFOUND)
+        unwind_mobj = NULL;
+        if (err == PLCRASH_ENOTFOUND)
+            plcrash_async_image_set_flags(image, PLCRASH_ASYNC_IMAGE_NO_COMPACT_UNWIND);
+        else
             PLCF_DEBUG("Could not map the compact unwind info section for image %s: %d", image->macho_image.name, err);
         result = PLFRAME_ENOTSUP;
         goto cleanup;
     }
 
-    /* Initialize the CFE reader. */
-    cpu_type_t cputype = image->macho_image.byteorder->swap32(image->macho_image.header.cputype);
-    plcrash_async_cfe_reader_t reader;
+    /* Fetch the CFE reader; readers for cached section mappings are retained for the lifetime of the unwind cache */
+    cpu_type_t cputype = plcrash_async_swap32(image->macho_image.byteorder, image->macho_image.header.cputype);
+    plcrash_async_cfe_reader_t reader_storage;
+    plcrash_async_cfe_reader_t *reader;
 
-    err = plcrash_async_cfe_reader_init(&reader, &unwind_mobj, cputype);
+    err = plframe_compact_unwind_cache_reader(unwind_cache, unwind_mobj, unwind_mobj != &unwind_mobj_storage, cputype, &reader_storage, &reader);
     if (err != PLCRASH_ESUCCESS) {
         PLCF_DEBUG("Could not parse the compact unwind info section for image '%s': %d", image->macho_image.name, err);
         result = PLFRAME_EINVAL;
         goto cleanup;
     }
 
-    /* Find the encoding entry (if any) and free the reader */
+    /* Find the encoding entry (if any) and free the reader if it was not retained */
     pl_vm_address_t function_base;
     uint32_t encoding;
-    err = plcrash_async_cfe_reader_find_pc(&reader, pc - image->macho_image.header_addr, &function_base, &encoding);
-    plcrash_async_cfe_reader_free(&reader);
+    err = plcrash_async_cfe_reader_find_pc(reader, pc - image->macho_image.header_addr, &function_base, &encoding);
+    if (reader == &reader_storage)
+        plcrash_async_cfe_reader_free(reader);
     if (err != PLCRASH_ESUCCESS) {
         PLCF_DEBUG("Did not find CFE entry for PC 0x%" PRIx64 ": %d", (uint64_t) pc, err);
         result = PLFRAME_ENOTSUP;
@@ -110,6 +377,19 @@ plframe_error_t plframe_cursor_read_compact_unwind (task_t task,
         goto cleanup;
     }
 
+    /* Compute the in-core function address */
+    pl_vm_address_t function_address;
+    if (!plcrash_async_address_apply_offset(image->macho_image.header_addr, function_base, &function_address)) {
+        PLCF_DEBUG("The provided function base (0x%" PRIx64 ") plus header address (0x%" PRIx64 ") will overflow pl_vm_address_t",
+                   (uint64_t) function_base, (uint64_t) image->macho_image.header_addr);
+        result = PLFRAME_EINVAL;
+
+        plcrash_async_cfe_entry_free(&entry);
+        goto cleanup;
+    }
+
+    plframe_compact_unwind_cache_insert(unwind_cache, pc, function_address, &entry);
+
     /* Skip entries for which no unwind information is unavailable */
     if (plcrash_async_cfe_entry_type(&entry) == PLCRASH_ASYNC_CFE_ENTRY_TYPE_NONE) {
         result = PLFRAME_ENOFRAME;
@@ -117,20 +397,18 @@ plframe_error_t plframe_cursor_read_compact_unwind (task_t task,
         plcrash_async_cfe_entry_free(&entry);
         goto cleanup;
     }
-    
-    /* Compute the in-core function address */
-    pl_vm_address_t function_address;
-    if (!plcrash_async_address_apply_offset(image->macho_image.header_addr, function_base, &function_address)) {
-        PLCF_DEBUG("The provided function base (0x%" PRIx64 ") plus header address (0x%" PRIx64 ") will overflow pl_vm_address_t",
-                   (uint64_t) function_base, (uint64_t) image->macho_image.header_addr);
-        result = PLFRAME_EINVAL;
+
+    /* The encoding supplies the offset of the function's FDE; hand the frame off to the DWARF reader, which would
+     * otherwise have to search the DWARF section for the FDE. */
+    if (plcrash_async_cfe_entry_type(&entry) == PLCRASH_ASYNC_CFE_ENTRY_TYPE_DWARF) {
+        result = plframe_cursor_read_dwarf_unwind_fde(task, image, plcrash_async_cfe_entry_stack_offset(&entry), unwind_cache, current_frame, previous_frame, next_frame);
 
         plcrash_async_cfe_entry_free(&entry);
         goto cleanup;
     }
 
     /* Apply the frame delta -- this may fail. */
-    if ((err = plcrash_async_cfe_entry_apply(task, function_address, &current_frame->thread_state, &entry, &next_frame->thread_state)) == PLCRASH_ESUCCESS) {
+    if ((err = plcrash_async_cfe_entry_apply(task, function_address, &current_frame->thread_state, &entry, &next_frame->thread_state, plframe_unwind_cache_stack(unwind_cache))) == PLCRASH_ESUCCESS) {
         result = PLFRAME_ESUCCESS;
     } else {
         PLCF_DEBUG("Failed to apply CFE encoding 0x%" PRIx32 " for PC 0x%" PRIx64 ": %d", encoding, (uint64_t) pc, err);
@@ -140,6 +418,9 @@ plframe_error_t plframe_cursor_read_compact_unwind (task_t task,
     plcrash_async_cfe_entry_free(&entry);
 
 cleanup:
+    if (unwind_mobj != NULL)
+        plcrash_async_macho_section_cache_unmap(plframe_unwind_cache_sections(unwind_cache), unwind_mobj);
+
     plcrash_async_image_list_set_reading(image_list, false);
     return result;
 }
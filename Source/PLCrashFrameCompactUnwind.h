@@ -39,9 +39,12 @@ extern "C" {
 
 plframe_error_t plframe_cursor_read_compact_unwind (task_t task,
                                                     plcrash_async_image_list_t *image_list,
+                                                    plframe_unwind_cache_t *unwind_cache,
                                                     const plframe_stackframe_t *current_frame,
                                                     const plframe_stackframe_t *previous_frame,
                                                     plframe_stackframe_t *next_frame);
+
+void plframe_compact_unwind_cache_free (struct plframe_compact_unwind_cache *cache);
     
 #ifdef __cplusplus
 }
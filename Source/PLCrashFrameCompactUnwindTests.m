@@ -59,7 +59,7 @@
     plframe_error_t err;
 
     plcrash_async_thread_state_clear_all_regs(&frame.thread_state);
-    err = plframe_cursor_read_compact_unwind(mach_task_self(), &_image_list, &frame, NULL, &next);
+    err = plframe_cursor_read_compact_unwind(mach_task_self(), &_image_list, NULL, &frame, NULL, &next);
     STAssertEquals(err, PLFRAME_EBADFRAME, @"Unexpected result for a frame missing a valid PC");
 }
 
@@ -71,7 +71,7 @@
     plcrash_async_thread_state_clear_all_regs(&frame.thread_state);
     plcrash_async_thread_state_set_reg(&frame.thread_state, PLCRASH_REG_IP, NULL);
     
-    err = plframe_cursor_read_compact_unwind(mach_task_self(), &_image_list, &frame, NULL, &next);
+    err = plframe_cursor_read_compact_unwind(mach_task_self(), &_image_list, NULL, &frame, NULL, &next);
     STAssertEquals(err, PLFRAME_ENOTSUP, @"Unexpected result for a frame missing a valid image");
 }
 
@@ -35,6 +35,8 @@
 #include "PLCrashFeatureConfig.h"
 
 #include <inttypes.h>
+#include <stdlib.h>
+#include <libkern/OSAtomic.h>
 
 #include <limits>
 
@@ -42,6 +44,368 @@
 
 using namespace plcrash::async;
 
+/**
+ * @internal
+ *
+ * Map the DWARF frame section of @a image. Apple doesn't seem to use debug_frame at all; as such, we prefer eh_frame,
+ * but allow falling back on debug_frame.
+ *
+ * @param section_cache The section cache to be used, or NULL.
+ * @param image The image to be mapped.
+ * @param storage Caller-provided storage to be used if the mapping can not be cached.
+ * @param mobj On success, will be set to the mapped section. The caller is responsible for releasing this
+ * mapping via plcrash_async_macho_section_cache_unmap().
+ * @param is_debug_frame On success, will be set to true if the mapped section is debug_frame, or false if it is eh_frame.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if neither section is available, or another
+ * plcrash_error_t code if an available section could not be mapped.
+ */
+static plcrash_error_t plframe_dwarf_map_section (plcrash_async_macho_section_cache_t *section_cache,
+                                                  plcrash_async_macho_t *image,
+                                                  plcrash_async_mobject_t *storage,
+                                                  plcrash_async_mobject_t **mobj,
+                                                  bool *is_debug_frame)
+{
+    plcrash_error_t eh_err, debug_err;
+
+    if ((eh_err = plcrash_async_macho_section_cache_map(section_cache, image, "__TEXT", "__eh_frame", storage, mobj)) == PLCRASH_ESUCCESS) {
+        *is_debug_frame = false;
+        return PLCRASH_ESUCCESS;
+    }
+
+    if ((debug_err = plcrash_async_macho_section_cache_map(section_cache, image, "__DWARF", "__debug_frame", storage, mobj)) == PLCRASH_ESUCCESS) {
+        *is_debug_frame = true;
+        return PLCRASH_ESUCCESS;
+    }
+
+    /* Only report PLCRASH_ENOTFOUND if neither section exists */
+    if (eh_err != PLCRASH_ENOTFOUND)
+        return eh_err;
+
+    return debug_err;
+}
+
+/**
+ * @internal
+ *
+ * Return the GNU eh_frame pointer base addresses of @a image. These are derived from the segment addresses recorded
+ * when the image was initialized, and require no load command look-ups.
+ *
+ * @param image The image for which the base addresses will be returned.
+ */
+static plcrash_async_dwarf_ehptr_bases_t plframe_dwarf_ehptr_bases (plcrash_async_macho_t *image) {
+    plcrash_async_dwarf_ehptr_bases_t bases;
+
+    bases.has_text_base = true;
+    bases.text_base = image->header_addr;
+
+    bases.has_data_base = image->has_data_segment;
+    bases.data_base = image->has_data_segment ? image->data_vmaddr + image->vmaddr_slide : 0x0;
+
+    return bases;
+}
+
+/** The maximum number of CIEs that may be held by a plframe_dwarf_cache. */
+#define PLFRAME_DWARF_CIE_CACHE_SIZE 16
+
+/** The number of unwind row slots in a plframe_dwarf_cache. Must be a power of two. */
+#define PLFRAME_DWARF_ROW_CACHE_SIZE 32
+
+/** The maximum number of slots that will be probed when looking up or inserting an unwind row. */
+#define PLFRAME_DWARF_ROW_CACHE_MAX_PROBES 4
+
+/**
+ * @internal
+ *
+ * A parsed CIE, and the CFA state produced by evaluating its initial instructions.
+ */
+template<typename machine_ptr, typename machine_ptr_s>
+struct plframe_dwarf_cie_cache_entry {
+    /** The header address of the image containing the CIE. */
+    pl_vm_address_t header_addr;
+
+    /** The task-relative address of the CIE. */
+    pl_vm_address_t cie_address;
+
+    /** The parsed CIE. */
+    plcrash_async_dwarf_cie_info_t cie_info;
+
+    /** The CFA state following evaluation of the CIE's initial instructions. */
+    dwarf_cfa_state<machine_ptr, machine_ptr_s> initial_state;
+};
+
+/**
+ * @internal
+ *
+ * A computed unwind row: the CFA state produced by evaluating both the CIE and FDE instructions up to a given PC.
+ */
+template<typename machine_ptr, typename machine_ptr_s>
+struct plframe_dwarf_row_cache_entry {
+    /** The PC for which the row was computed, or 0x0 if the slot is unused. */
+    pl_vm_address_t pc;
+
+    /** The parsed CIE. */
+    plcrash_async_dwarf_cie_info_t cie_info;
+
+    /** The CFA state at @a pc. */
+    dwarf_cfa_state<machine_ptr, machine_ptr_s> state;
+};
+
+/**
+ * @internal
+ *
+ * A cache of parsed DWARF CIEs, keyed by image and CIE address, and of computed unwind rows, keyed by PC.
+ *
+ * A binary will generally contain only a handful of distinct CIEs, shared by all of its FDEs, and multiple threads will
+ * often be suspended at the same PC (eg, within the run loop or a condition variable wait).
+ *
+ * The header is immediately followed by PLFRAME_DWARF_CIE_CACHE_SIZE CIE entries and PLFRAME_DWARF_ROW_CACHE_SIZE
+ * row entries, which are typed according to @a m64.
+ */
+struct plframe_dwarf_cache {
+    /** True if the entries hold 64-bit CFA state, false if they hold 32-bit state. */
+    bool m64;
+
+    /** The number of CIE entries in use. */
+    uint32_t count;
+
+    /** Padding; ensures that the trailing entries are 8-byte aligned. */
+    uint64_t reserved;
+
+    /** Decoded DWARF expressions referenced by CFA and register rules. */
+    plcrash_async_dwarf_expression_cache_t expressions;
+};
+
+/* Return the size of the cache allocation for the given entry types */
+template<typename machine_ptr, typename machine_ptr_s>
+static size_t plframe_dwarf_cache_entries_size (void) {
+    return sizeof(plframe_dwarf_cache) +
+        sizeof(plframe_dwarf_cie_cache_entry<machine_ptr, machine_ptr_s>) * PLFRAME_DWARF_CIE_CACHE_SIZE +
+        sizeof(plframe_dwarf_row_cache_entry<machine_ptr, machine_ptr_s>) * PLFRAME_DWARF_ROW_CACHE_SIZE;
+}
+
+/* Return the size of the cache allocation */
+static size_t plframe_dwarf_cache_allocation_size (void) {
+    /* Sized for the (larger) 64-bit entries */
+    return round_page(plframe_dwarf_cache_entries_size<uint64_t, int64_t>());
+}
+
+/* Return the CIE entries of @a cache */
+template<typename machine_ptr, typename machine_ptr_s>
+static plframe_dwarf_cie_cache_entry<machine_ptr, machine_ptr_s> *plframe_dwarf_cie_cache_entries (plframe_dwarf_cache *cache) {
+    return (plframe_dwarf_cie_cache_entry<machine_ptr, machine_ptr_s> *) (cache + 1);
+}
+
+/* Return the row entries of @a cache */
+template<typename machine_ptr, typename machine_ptr_s>
+static plframe_dwarf_row_cache_entry<machine_ptr, machine_ptr_s> *plframe_dwarf_row_cache_entries (plframe_dwarf_cache *cache) {
+    return (plframe_dwarf_row_cache_entry<machine_ptr, machine_ptr_s> *) (plframe_dwarf_cie_cache_entries<machine_ptr, machine_ptr_s>(cache) + PLFRAME_DWARF_CIE_CACHE_SIZE);
+}
+
+/**
+ * @internal
+ *
+ * Return @a unwind_cache's DWARF cache, allocating it if necessary, or NULL if the cache is unavailable or holds
+ * state of a different width.
+ *
+ * @param unwind_cache The unwind cache, or NULL.
+ * @param allocate If true, the cache will be allocated if it has not yet been.
+ */
+template<typename machine_ptr, typename machine_ptr_s>
+static plframe_dwarf_cache *plframe_dwarf_cache_get (plframe_unwind_cache_t *unwind_cache, bool allocate) {
+    const bool m64 = (sizeof(machine_ptr) == sizeof(uint64_t));
+
+    if (unwind_cache == NULL)
+        return NULL;
+
+    /* Lazily allocate the cache */
+    if (unwind_cache->dwarf_cache == NULL) {
+        if (!allocate)
+            return NULL;
+
+        vm_address_t addr;
+        kern_return_t kt = plcrash_async_scratch_allocate(&addr, plframe_dwarf_cache_allocation_size());
+        if (kt != KERN_SUCCESS) {
+            PLCF_DEBUG("plcrash_async_scratch_allocate failed with error %x, the DWARF cache could not be initialized", kt);
+            return NULL;
+        }
+
+        /* scratch allocations are zero-filled; no entries are in use */
+        unwind_cache->dwarf_cache = (plframe_dwarf_cache *) addr;
+        unwind_cache->dwarf_cache->m64 = m64;
+        plcrash_async_dwarf_expression_cache_init(&unwind_cache->dwarf_cache->expressions);
+    }
+
+    if (unwind_cache->dwarf_cache->m64 != m64)
+        return NULL;
+
+    return unwind_cache->dwarf_cache;
+}
+
+/**
+ * @internal
+ *
+ * Return @a unwind_cache's decoded DWARF expression cache, or NULL if unavailable.
+ *
+ * @param unwind_cache The unwind cache, or NULL.
+ */
+template<typename machine_ptr, typename machine_ptr_s>
+static plcrash_async_dwarf_expression_cache_t *plframe_dwarf_expression_cache (plframe_unwind_cache_t *unwind_cache) {
+    plframe_dwarf_cache *cache = plframe_dwarf_cache_get<machine_ptr, machine_ptr_s>(unwind_cache, true);
+    if (cache == NULL)
+        return NULL;
+
+    return &cache->expressions;
+}
+
+/**
+ * @internal
+ *
+ * Look up a cached CIE.
+ *
+ * @param unwind_cache The unwind cache, or NULL.
+ * @param image The image containing the CIE.
+ * @param cie_address The task-relative address of the CIE.
+ * @param cie_info On success, will be initialized with the parsed CIE.
+ * @param cfa_state On success, will be set to the CFA state following evaluation of the CIE's initial instructions.
+ *
+ * @return Returns true if the CIE was found, false otherwise.
+ */
+template<typename machine_ptr, typename machine_ptr_s>
+static bool plframe_dwarf_cie_cache_lookup (plframe_unwind_cache_t *unwind_cache,
+                                            plcrash_async_macho_t *image,
+                                            pl_vm_address_t cie_address,
+                                            plcrash_async_dwarf_cie_info_t *cie_info,
+                                            dwarf_cfa_state<machine_ptr, machine_ptr_s> *cfa_state)
+{
+    plframe_dwarf_cache *cache = plframe_dwarf_cache_get<machine_ptr, machine_ptr_s>(unwind_cache, false);
+    if (cache == NULL)
+        return false;
+
+    plframe_dwarf_cie_cache_entry<machine_ptr, machine_ptr_s> *entries = plframe_dwarf_cie_cache_entries<machine_ptr, machine_ptr_s>(cache);
+    for (uint32_t i = 0; i < cache->count; i++) {
+        if (entries[i].header_addr != image->header_addr || entries[i].cie_address != cie_address)
+            continue;
+
+        plcrash_async_memcpy(cie_info, &entries[i].cie_info, sizeof(*cie_info));
+        plcrash_async_memcpy(cfa_state, &entries[i].initial_state, sizeof(*cfa_state));
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @internal
+ *
+ * Record a parsed CIE in the cache. If the cache is unavailable or full, this function does nothing.
+ *
+ * The cached CFA state is reused for all FDEs referencing the CIE; this assumes that the CIE's initial instructions
+ * do not advance the location counter, which would make their result depend on the FDE's pc_start.
+ *
+ * @param unwind_cache The unwind cache, or NULL.
+ * @param image The image containing the CIE.
+ * @param cie_address The task-relative address of the CIE.
+ * @param cie_info The parsed CIE.
+ * @param cfa_state The CFA state following evaluation of the CIE's initial instructions.
+ */
+template<typename machine_ptr, typename machine_ptr_s>
+static void plframe_dwarf_cie_cache_insert (plframe_unwind_cache_t *unwind_cache,
+                                            plcrash_async_macho_t *image,
+                                            pl_vm_address_t cie_address,
+                                            plcrash_async_dwarf_cie_info_t *cie_info,
+                                            dwarf_cfa_state<machine_ptr, machine_ptr_s> *cfa_state)
+{
+    plframe_dwarf_cache *cache = plframe_dwarf_cache_get<machine_ptr, machine_ptr_s>(unwind_cache, true);
+    if (cache == NULL || cache->count == PLFRAME_DWARF_CIE_CACHE_SIZE)
+        return;
+
+    plframe_dwarf_cie_cache_entry<machine_ptr, machine_ptr_s> *entry = &plframe_dwarf_cie_cache_entries<machine_ptr, machine_ptr_s>(cache)[cache->count++];
+    entry->header_addr = image->header_addr;
+    entry->cie_address = cie_address;
+    plcrash_async_memcpy(&entry->cie_info, cie_info, sizeof(entry->cie_info));
+    plcrash_async_memcpy(&entry->initial_state, cfa_state, sizeof(entry->initial_state));
+}
+
+/* Compute the initial row cache index for @a pc */
+static size_t plframe_dwarf_row_cache_index (pl_vm_address_t pc) {
+    return (size_t) (((uint64_t) pc * 0x9E3779B97F4A7C15ULL) >> 32) & (PLFRAME_DWARF_ROW_CACHE_SIZE - 1);
+}
+
+/**
+ * @internal
+ *
+ * Look up a cached unwind row.
+ *
+ * @param unwind_cache The unwind cache, or NULL.
+ * @param pc The PC to look up.
+ *
+ * @return Returns the cached row, or NULL if not found.
+ */
+template<typename machine_ptr, typename machine_ptr_s>
+static plframe_dwarf_row_cache_entry<machine_ptr, machine_ptr_s> *plframe_dwarf_row_cache_lookup (plframe_unwind_cache_t *unwind_cache, pl_vm_address_t pc) {
+    plframe_dwarf_cache *cache = plframe_dwarf_cache_get<machine_ptr, machine_ptr_s>(unwind_cache, false);
+    if (cache == NULL || pc == 0x0)
+        return NULL;
+
+    plframe_dwarf_row_cache_entry<machine_ptr, machine_ptr_s> *rows = plframe_dwarf_row_cache_entries<machine_ptr, machine_ptr_s>(cache);
+    size_t index = plframe_dwarf_row_cache_index(pc);
+    for (size_t i = 0; i < PLFRAME_DWARF_ROW_CACHE_MAX_PROBES; i++) {
+        plframe_dwarf_row_cache_entry<machine_ptr, machine_ptr_s> *row = &rows[(index + i) & (PLFRAME_DWARF_ROW_CACHE_SIZE - 1)];
+        if (row->pc == 0x0)
+            return NULL;
+
+        if (row->pc == pc)
+            return row;
+    }
+
+    return NULL;
+}
+
+/**
+ * @internal
+ *
+ * Record a computed unwind row in the cache. The cache is not guaranteed storage; storing may silently fail
+ * if the cache can not be allocated, or the probe limit is reached.
+ *
+ * @param unwind_cache The unwind cache, or NULL.
+ * @param pc The PC for which the row was computed.
+ * @param cie_info The parsed CIE.
+ * @param cfa_state The CFA state at @a pc.
+ */
+template<typename machine_ptr, typename machine_ptr_s>
+static void plframe_dwarf_row_cache_insert (plframe_unwind_cache_t *unwind_cache,
+                                            pl_vm_address_t pc,
+                                            plcrash_async_dwarf_cie_info_t *cie_info,
+                                            dwarf_cfa_state<machine_ptr, machine_ptr_s> *cfa_state)
+{
+    plframe_dwarf_cache *cache = plframe_dwarf_cache_get<machine_ptr, machine_ptr_s>(unwind_cache, true);
+    if (cache == NULL || pc == 0x0)
+        return;
+
+    plframe_dwarf_row_cache_entry<machine_ptr, machine_ptr_s> *rows = plframe_dwarf_row_cache_entries<machine_ptr, machine_ptr_s>(cache);
+    size_t index = plframe_dwarf_row_cache_index(pc);
+    for (size_t i = 0; i < PLFRAME_DWARF_ROW_CACHE_MAX_PROBES; i++) {
+        plframe_dwarf_row_cache_entry<machine_ptr, machine_ptr_s> *row = &rows[(index + i) & (PLFRAME_DWARF_ROW_CACHE_SIZE - 1)];
+        if (row->pc != 0x0)
+            continue;
+
+        row->pc = pc;
+        plcrash_async_memcpy(&row->cie_info, cie_info, sizeof(row->cie_info));
+        plcrash_async_memcpy(&row->state, cfa_state, sizeof(row->state));
+        return;
+    }
+}
+
+/**
+ * Free a DWARF cache allocated by the DWARF frame reader.
+ *
+ * @param cache The cache to be freed.
+ */
+void plframe_dwarf_cache_free (struct plframe_dwarf_cache *cache) {
+    plcrash_async_scratch_deallocate((vm_address_t) cache, plframe_dwarf_cache_allocation_size());
+}
+
 /**
  * @internal
  *
@@ -49,7 +413,10 @@ using namespace plcrash::async;
  *
  * @param task The task containing the target frame stack.
  * @param pc The current frame's PC value.
- * @param image The Mach-O image for the current stack frame.
+ * @param list_image The image list entry for the current stack frame.
+ * @param fde_offset The __eh_frame-relative offset of the FDE for @a pc, as supplied by the image's compact unwind
+ * encoding, or 0 if unknown.
+ * @param unwind_cache A cache of unwind data to be used by the reader, or NULL.
  * @param current_frame The current stack frame.
  * @param previous_frame The previous stack frame, or NULL if this is the first frame.
  * @param next_frame The new frame to be initialized.
@@ -62,16 +429,19 @@ using namespace plcrash::async;
 template<typename machine_ptr, typename machine_ptr_s>
 static plframe_error_t plframe_cursor_read_dwarf_unwind_int (task_t task,
                                                              machine_ptr pc,
-                                                             plcrash_async_macho_t *image,
+                                                             plcrash_async_image_t *list_image,
+                                                             pl_vm_off_t fde_offset,
+                                                             plframe_unwind_cache_t *unwind_cache,
                                                              const plframe_stackframe_t *current_frame,
                                                              const plframe_stackframe_t *previous_frame,
                                                              plframe_stackframe_t *next_frame)
 {
-    gnu_ehptr_reader<machine_ptr> ptr_state(image->byteorder);
+    plcrash_async_macho_t *image = &list_image->macho_image;
+    plcrash_async_dwarf_ehptr_bases_t ptr_bases = plframe_dwarf_ehptr_bases(image);
+    gnu_ehptr_reader<machine_ptr> ptr_state(image->byteorder, &ptr_bases);
 
-    /* Mapped DWARF sections; only one of eh_frame/debug_frame will be mapped */
-    plcrash_async_mobject_t eh_frame;
-    plcrash_async_mobject_t debug_frame;
+    /* Mapped DWARF section; either eh_frame or debug_frame, and either cached or backed by dwarf_mobj */
+    plcrash_async_mobject_t dwarf_mobj;
     plcrash_async_mobject_t *dwarf_section = NULL;
     bool is_debug_frame = false;
     
@@ -82,6 +452,7 @@ static plframe_error_t plframe_cursor_read_dwarf_unwind_int (task_t task,
     bool did_init_fde = false;
     
     plcrash_async_dwarf_cie_info_t cie_info;
+    pl_vm_address_t cie_address;
     bool did_init_cie = false;
     
     /* CFA evaluation stack */
@@ -89,43 +460,46 @@ static plframe_error_t plframe_cursor_read_dwarf_unwind_int (task_t task,
     
     plframe_error_t result;
     plcrash_error_t err;
-        
-    /*
-     * Map the eh_frame or debug_frame DWARF sections. Apple doesn't seem to use debug_frame at all;
-     * as such, we prefer eh_frame, but allow falling back on debug_frame.
-     */
+
+    /* If the unwind row for this PC has already been computed, the DWARF data need not be consulted */
     {
-        err = plcrash_async_macho_map_section(image, "__TEXT", "__eh_frame", &eh_frame);
-        if (err == PLCRASH_ESUCCESS) {
-            dwarf_section = &eh_frame;
-        }
-        
-        if (dwarf_section == NULL) {
-            err = plcrash_async_macho_map_section(image, "__DWARF", "__debug_frame", &debug_frame);
-            if (err == PLCRASH_ESUCCESS) {
-                dwarf_section = &debug_frame;
-                is_debug_frame = true;
+        plframe_dwarf_row_cache_entry<machine_ptr, machine_ptr_s> *row = plframe_dwarf_row_cache_lookup<machine_ptr, machine_ptr_s>(unwind_cache, pc);
+        if (row != NULL) {
+            if ((err = row->state.apply_state(task, &row->cie_info, &current_frame->thread_state, image->byteorder, &next_frame->thread_state, plframe_dwarf_expression_cache<machine_ptr, machine_ptr_s>(unwind_cache), plframe_unwind_cache_stack(unwind_cache))) != PLCRASH_ESUCCESS) {
+                PLCF_DEBUG("Failed to apply cached CFA state for PC 0x%" PRIx64 ": %d", (uint64_t) pc, err);
+                return PLFRAME_ENOFRAME;
             }
+
+            return PLFRAME_ESUCCESS;
         }
-        
-        /* If neither, there's nothing to do */
-        if (dwarf_section == NULL) {
-            /* The lack of debug_frame/eh_frame is not an error, but we can't proceed. */
-            result = PLFRAME_ENOFRAME;
-            goto cleanup;
-        }
+    }
+
+    /* Skip images already known to lack DWARF unwind data */
+    if (plcrash_async_image_has_flags(list_image, PLCRASH_ASYNC_IMAGE_NO_DWARF_UNWIND))
+        return PLFRAME_ENOFRAME;
+
+    /* Map the eh_frame or debug_frame DWARF section */
+    if ((err = plframe_dwarf_map_section(plframe_unwind_cache_sections(unwind_cache), image, &dwarf_mobj, &dwarf_section, &is_debug_frame)) != PLCRASH_ESUCCESS) {
+        /* The lack of debug_frame/eh_frame is not an error, but we can't proceed. */
+        if (err == PLCRASH_ENOTFOUND)
+            plcrash_async_image_set_flags(list_image, PLCRASH_ASYNC_IMAGE_NO_DWARF_UNWIND);
+
+        dwarf_section = NULL;
+        result = PLFRAME_ENOFRAME;
+        goto cleanup;
     }
     
     /* Initialize the reader. */
-    if ((err = reader.init(dwarf_section, image->byteorder, image->m64, is_debug_frame)) != PLCRASH_ESUCCESS) {
+    if ((err = reader.init(dwarf_section, image->byteorder, plcrash_async_macho_m64(image), is_debug_frame, (const plcrash_async_dwarf_fde_index_t *) image->dwarf_fde_index)) != PLCRASH_ESUCCESS) {
         PLCF_DEBUG("Could not initialize a %s DWARF parser for the current frame pc: 0x%" PRIx64 ": %d", (is_debug_frame ? "debug_frame" : "eh_frame"), (uint64_t) pc, err);
         result = PLFRAME_EINVAL;
         goto cleanup;
     }
     
-    /* Find the FDE (if any) */
+    /* Find the FDE (if any). The compact unwind FDE offset is relative to __eh_frame, and can not be applied to
+     * debug_frame. */
     {
-        err = reader.find_fde(0x0 /* offset hint */, pc, &fde_info);
+        err = reader.find_fde(is_debug_frame ? 0x0 : fde_offset, pc, &fde_info);
         
         if (err != PLCRASH_ESUCCESS) {
             PLCF_DEBUG("Failed to find FDE the current frame pc: 0x%" PRIx64 ": %d", (uint64_t) pc, err);
@@ -135,14 +509,22 @@ static plframe_error_t plframe_cursor_read_dwarf_unwind_int (task_t task,
         did_init_fde = true;
     }
     
-    /* Initialize pointer state */
+    /* Initialize pointer state; the text and data bases were supplied by the image at construction */
     {
-        // TODO - configure the pointer state */
+        machine_ptr section_base = (machine_ptr) plcrash_async_mobject_base_address(dwarf_section);
+        ptr_state.set_frame_section_base(section_base, section_base);
     }
     
-    /* Parse CIE info */
-    {
-        err = plcrash_async_dwarf_cie_info_init(&cie_info, dwarf_section, image->byteorder, &ptr_state, plcrash_async_mobject_base_address(dwarf_section) + fde_info.cie_offset);
+    /* Assert that pc_start won't overflow machine_ptr. This could only occur if we were to use a 64-bit FDE parser with 32-bit CFA evaluation
+     * TODO: The FDE pc_start value should probably by typed for the target architecture. */
+    PLCF_ASSERT(fde_info.pc_start < std::numeric_limits<machine_ptr>::max());
+
+    /* Parse CIE info and evaluate the CIE's initial instructions, or fetch both from the cache */
+    cie_address = plcrash_async_mobject_base_address(dwarf_section) + fde_info.cie_offset;
+    if (plframe_dwarf_cie_cache_lookup(unwind_cache, image, cie_address, &cie_info, &cfa_state)) {
+        did_init_cie = true;
+    } else {
+        err = plcrash_async_dwarf_cie_info_init(&cie_info, dwarf_section, image->byteorder, &ptr_state, cie_address);
         if (err != PLCRASH_ESUCCESS) {
             PLCF_DEBUG("Failed to parse CIE at offset of 0x%" PRIx64 ": %d", (uint64_t) fde_info.cie_offset, err);
             result = PLFRAME_ENOTSUP;
@@ -151,13 +533,6 @@ static plframe_error_t plframe_cursor_read_dwarf_unwind_int (task_t task,
             goto cleanup;
         }
         did_init_cie = true;
-    }
-    
-    /* Evaluate the CFA instruction opcodes */
-    {
-        /* Assert that pc_start won't overflow machine_ptr. This could only occur if we were to use a 64-bit FDE parser with 32-bit CFA evaluation
-         * TODO: The FDE pc_start value should probably by typed for the target architecture. */
-        PLCF_ASSERT(fde_info.pc_start < std::numeric_limits<machine_ptr>::max());
 
         /* Initial instructions */
         err = cfa_state.eval_program(dwarf_section, pc, fde_info.pc_start, &cie_info, &ptr_state, image->byteorder, plcrash_async_mobject_base_address(dwarf_section), cie_info.initial_instructions_offset, cie_info.initial_instructions_length);
@@ -166,7 +541,12 @@ static plframe_error_t plframe_cursor_read_dwarf_unwind_int (task_t task,
             result = PLFRAME_ENOTSUP;
             goto cleanup;
         }
-        
+
+        plframe_dwarf_cie_cache_insert(unwind_cache, image, cie_address, &cie_info, &cfa_state);
+    }
+    
+    /* Evaluate the FDE's CFA instruction opcodes */
+    {
         /*  FDE instructions */
         err = cfa_state.eval_program(dwarf_section, pc, fde_info.pc_start, &cie_info, &ptr_state, image->byteorder, plcrash_async_mobject_base_address(dwarf_section), fde_info.instructions_offset, fde_info.instructions_length);
         if (err != PLCRASH_ESUCCESS) {
@@ -175,9 +555,11 @@ static plframe_error_t plframe_cursor_read_dwarf_unwind_int (task_t task,
             goto cleanup;
         }
     }
+
+    plframe_dwarf_row_cache_insert(unwind_cache, pc, &cie_info, &cfa_state);
     
     /* Apply the frame delta -- this may fail. */
-    if ((err = cfa_state.apply_state(task, &cie_info, &current_frame->thread_state, image->byteorder, &next_frame->thread_state)) == PLCRASH_ESUCCESS) {
+    if ((err = cfa_state.apply_state(task, &cie_info, &current_frame->thread_state, image->byteorder, &next_frame->thread_state, plframe_dwarf_expression_cache<machine_ptr, machine_ptr_s>(unwind_cache), plframe_unwind_cache_stack(unwind_cache))) == PLCRASH_ESUCCESS) {
         result = PLFRAME_ESUCCESS;
     } else {
         PLCF_DEBUG("Failed to apply CFA state for PC 0x%" PRIx64 ": %d", (uint64_t) pc, err);
@@ -188,7 +570,7 @@ static plframe_error_t plframe_cursor_read_dwarf_unwind_int (task_t task,
     
 cleanup:
     if (dwarf_section != NULL)
-        plcrash_async_mobject_free(dwarf_section);
+        plcrash_async_macho_section_cache_unmap(plframe_unwind_cache_sections(unwind_cache), dwarf_section);
     
     if (did_init_cie)
         plcrash_async_dwarf_cie_info_free(&cie_info);
@@ -199,11 +581,48 @@ cleanup:
     return result;
 }
 
+/**
+ * @internal
+ *
+ * Fetch the next frame from @a image's DWARF unwind data, dispatching on the image's pointer width.
+ *
+ * @param task The task containing the target frame stack.
+ * @param pc The current frame's PC value.
+ * @param image The image list entry for the current stack frame.
+ * @param fde_offset The __eh_frame-relative offset of the FDE for @a pc, or 0 if unknown.
+ * @param unwind_cache A cache of unwind data to be used by the reader, or NULL.
+ * @param current_frame The current stack frame.
+ * @param previous_frame The previous stack frame, or NULL if this is the first frame.
+ * @param next_frame The new frame to be initialized.
+ */
+static plframe_error_t plframe_cursor_read_dwarf_unwind_image (task_t task,
+                                                               plcrash_greg_t pc,
+                                                               plcrash_async_image_t *image,
+                                                               pl_vm_off_t fde_offset,
+                                                               plframe_unwind_cache_t *unwind_cache,
+                                                               const plframe_stackframe_t *current_frame,
+                                                               const plframe_stackframe_t *previous_frame,
+                                                               plframe_stackframe_t *next_frame)
+{
+    if (plcrash_async_macho_m64(&image->macho_image)) {
+        /* Could only happen due to programmer error; eg, an image that doesn't actually match our thread state */
+        PLCF_ASSERT(pc <= UINT64_MAX);
+
+        return plframe_cursor_read_dwarf_unwind_int<uint64_t, int64_t>(task, pc, image, fde_offset, unwind_cache, current_frame, previous_frame, next_frame);
+    } else {
+        /* Could only happen due to programmer error; eg, an image that doesn't actually match our thread state */
+        PLCF_ASSERT(pc <= UINT32_MAX);
+
+        return plframe_cursor_read_dwarf_unwind_int<uint32_t, int32_t>(task, pc, image, fde_offset, unwind_cache, current_frame, previous_frame, next_frame);
+    }
+}
+
 /**
  * Attempt to fetch next frame using compact frame unwinding data from @a image_list.
  *
  * @param task The task containing the target frame stack.
  * @param image_list The list of images loaded in the target @a task.
+ * @param unwind_cache A cache of unwind data to be used by the reader, or NULL.
  * @param current_frame The current stack frame.
  * @param previous_frame The previous stack frame, or NULL if this is the first frame.
  * @param next_frame The new frame to be initialized.
@@ -212,6 +631,7 @@ cleanup:
  */
 plframe_error_t plframe_cursor_read_dwarf_unwind (task_t task,
                                                   plcrash_async_image_list_t *image_list,
+                                                  plframe_unwind_cache_t *unwind_cache,
                                                   const plframe_stackframe_t *current_frame,
                                                   const plframe_stackframe_t *previous_frame,
                                                   plframe_stackframe_t *next_frame)
@@ -240,20 +660,149 @@ plframe_error_t plframe_cursor_read_dwarf_unwind (task_t task,
     }
     
     /* Perform the actual read */
-    if (image->macho_image.m64) {
-        /* Could only happen due to programmer error; eg, an image that doesn't actually match our thread state */
-        PLCF_ASSERT(pc <= UINT64_MAX);
-
-        ferr = plframe_cursor_read_dwarf_unwind_int<uint64_t, int64_t>(task, pc, &image->macho_image, current_frame, previous_frame, next_frame);
-    } else {
-        /* Could only happen due to programmer error; eg, an image that doesn't actually match our thread state */
-        PLCF_ASSERT(pc <= UINT32_MAX);
-
-        ferr = plframe_cursor_read_dwarf_unwind_int<uint32_t, int32_t>(task, pc, &image->macho_image, current_frame, previous_frame, next_frame);
-    }
+    ferr = plframe_cursor_read_dwarf_unwind_image(task, pc, image, 0x0, unwind_cache, current_frame, previous_frame, next_frame);
     
     plcrash_async_image_list_set_reading(image_list, false);
     return ferr;
 }
 
+/**
+ * Attempt to fetch the next frame using the DWARF FDE at @a fde_offset within @a image's __eh_frame section. This is
+ * used by the compact unwind reader to hand off frames for which the compact unwind encoding refers to DWARF unwind
+ * data, avoiding a search of the section for the FDE.
+ *
+ * @param task The task containing the target frame stack.
+ * @param image The image containing the current frame's PC. This is a borrowed reference; the caller must hold the
+ * image list's read lock for the duration of the call.
+ * @param fde_offset The __eh_frame-relative offset of the FDE, as supplied by the compact unwind encoding.
+ * @param unwind_cache A cache of unwind data to be used by the reader, or NULL.
+ * @param current_frame The current stack frame.
+ * @param previous_frame The previous stack frame, or NULL if this is the first frame.
+ * @param next_frame The new frame to be initialized.
+ *
+ * @return Returns PLFRAME_ESUCCESS on success, PLFRAME_ENOFRAME is no additional frames are available, or a standard plframe_error_t code if an error occurs.
+ */
+plframe_error_t plframe_cursor_read_dwarf_unwind_fde (task_t task,
+                                                      plcrash_async_image_t *image,
+                                                      pl_vm_off_t fde_offset,
+                                                      plframe_unwind_cache_t *unwind_cache,
+                                                      const plframe_stackframe_t *current_frame,
+                                                      const plframe_stackframe_t *previous_frame,
+                                                      plframe_stackframe_t *next_frame)
+{
+    if (!plcrash_async_thread_state_has_reg(&current_frame->thread_state, PLCRASH_REG_IP)) {
+        PLCF_DEBUG("Frame is missing a valid IP register, skipping DWARF unwind");
+        return PLFRAME_EBADFRAME;
+    }
+    plcrash_greg_t pc = plcrash_async_thread_state_get_reg(&current_frame->thread_state, PLCRASH_REG_IP);
+
+    return plframe_cursor_read_dwarf_unwind_image(task, pc, image, fde_offset, unwind_cache, current_frame, previous_frame, next_frame);
+}
+
+/**
+ * Return the size, in bytes, of the FDE look-up table for @a image, or 0 if no table has been built.
+ *
+ * @param image The image to query.
+ */
+size_t plframe_async_dwarf_fde_index_size (plcrash_async_macho_t *image) {
+    const plcrash_async_dwarf_fde_index_t *idx = (const plcrash_async_dwarf_fde_index_t *) image->dwarf_fde_index;
+    if (idx == NULL)
+        return 0;
+
+    return sizeof(*idx) + sizeof(idx->entries[0]) * idx->count;
+}
+
+/**
+ * Build a look-up table of the FDEs in @a image's eh_frame or debug_frame section, sorted by PC, allowing FDE lookups
+ * during unwinding to binary search the table rather than scanning the section.
+ *
+ * Once built, the table is published atomically to @a image, and released by plcrash_nasync_macho_free(). If a table
+ * has already been built, this function does nothing.
+ *
+ * @param image The image for which a FDE table will be built.
+ * @param max_bytes The maximum number of bytes that may be allocated for the table, or 0 for no limit.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if the image has no DWARF frame data, PLCRASH_ENOMEM
+ * if the table would exceed @a max_bytes or could not be allocated, or an appropriate error value if the frame data
+ * could not be parsed. On failure, FDE lookups will continue to scan the section.
+ *
+ * @warning This method is not async safe, and must not be called concurrently with plcrash_nasync_macho_free().
+ */
+plcrash_error_t plframe_nasync_dwarf_build_fde_index (plcrash_async_macho_t *image, size_t max_bytes) {
+    plcrash_async_mobject_t storage;
+    plcrash_async_mobject_t *mobj;
+    dwarf_frame_reader reader;
+    plcrash_async_dwarf_fde_index_t *idx;
+    bool is_debug_frame;
+    plcrash_error_t err;
+
+    if (image->dwarf_fde_index != NULL)
+        return PLCRASH_ESUCCESS;
+
+    if ((err = plframe_dwarf_map_section(NULL, image, &storage, &mobj, &is_debug_frame)) != PLCRASH_ESUCCESS)
+        return err;
+
+    if ((err = reader.init(mobj, image->byteorder, plcrash_async_macho_m64(image), is_debug_frame)) == PLCRASH_ESUCCESS)
+        err = reader.build_fde_index(max_bytes, &idx);
+
+    plcrash_async_macho_section_cache_unmap(NULL, mobj);
+
+    if (err != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("Failed to build FDE index for %s: %d", image->name, err);
+        return err;
+    }
+
+    if (!OSAtomicCompareAndSwapPtrBarrier(NULL, idx, (void * volatile *) &image->dwarf_fde_index))
+        free(idx);
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Build FDE look-up tables (see plframe_nasync_dwarf_build_fde_index()) for any images in @a list that do not yet
+ * have a table, stopping once the total memory allocated for tables would exceed @a memory_limit.
+ *
+ * As with plcrash_nasync_image_list_build_symbol_indexes(), this function may be called from a background thread
+ * concurrently with both async-safe readers and list mutation.
+ *
+ * @param list The list to be indexed.
+ * @param memory_limit The maximum number of bytes to be allocated for all FDE tables in @a list, including any
+ * tables that have already been built, or 0 for no limit.
+ *
+ * @return Returns the total number of bytes allocated for FDE tables in @a list.
+ *
+ * @warning This method is not async safe.
+ */
+size_t plframe_nasync_dwarf_build_fde_indexes (plcrash_async_image_list_t *list, size_t memory_limit) {
+    plcrash_async_image_t *image = NULL;
+    size_t used = 0;
+
+    plcrash_async_image_list_set_reading(list, true);
+
+    /* Account for existing tables first, so that the limit applies to the list as a whole */
+    while ((image = plcrash_async_image_list_next(list, image)) != NULL)
+        used += plframe_async_dwarf_fde_index_size(&image->macho_image);
+
+    while ((image = plcrash_async_image_list_next(list, image)) != NULL) {
+        if (image->macho_image.dwarf_fde_index != NULL)
+            continue;
+
+        size_t remaining = 0;
+        if (memory_limit != 0) {
+            if (used >= memory_limit)
+                break;
+            remaining = memory_limit - used;
+        }
+
+        /* Images whose table would exceed the remaining budget are skipped; smaller images may still fit. */
+        if (plframe_nasync_dwarf_build_fde_index(&image->macho_image, remaining) != PLCRASH_ESUCCESS)
+            continue;
+
+        used += plframe_async_dwarf_fde_index_size(&image->macho_image);
+    }
+
+    plcrash_async_image_list_set_reading(list, false);
+    return used;
+}
+
 #endif /* PLCRASH_FEATURE_UNWIND_DWARF */
@@ -39,10 +39,24 @@ extern "C" {
 
 plframe_error_t plframe_cursor_read_dwarf_unwind (task_t task,
                                                   plcrash_async_image_list_t *image_list,
+                                                  plframe_unwind_cache_t *unwind_cache,
                                                   const plframe_stackframe_t *current_frame,
                                                   const plframe_stackframe_t *previous_frame,
                                                   plframe_stackframe_t *next_frame);
 
+plframe_error_t plframe_cursor_read_dwarf_unwind_fde (task_t task,
+                                                      plcrash_async_image_t *image,
+                                                      pl_vm_off_t fde_offset,
+                                                      plframe_unwind_cache_t *unwind_cache,
+                                                      const plframe_stackframe_t *current_frame,
+                                                      const plframe_stackframe_t *previous_frame,
+                                                      plframe_stackframe_t *next_frame);
+
+void plframe_dwarf_cache_free (struct plframe_dwarf_cache *cache);
+
+plcrash_error_t plframe_nasync_dwarf_build_fde_index (plcrash_async_macho_t *image, size_t max_bytes);
+size_t plframe_async_dwarf_fde_index_size (plcrash_async_macho_t *image);
+size_t plframe_nasync_dwarf_build_fde_indexes (plcrash_async_image_list_t *list, size_t memory_limit);
     
 #ifdef __cplusplus
 }
@@ -41,6 +41,7 @@
  */
 plframe_error_t plframe_cursor_read_frame_ptr (task_t task,
                                                plcrash_async_image_list_t *image_list,
+                                               plframe_unwind_cache_t *unwind_cache,
                                                const plframe_stackframe_t *current_frame,
                                                const plframe_stackframe_t *previous_frame,
                                                plframe_stackframe_t *next_frame)
@@ -93,7 +94,7 @@ plframe_error_t plframe_cursor_read_frame_ptr (task_t task,
     plcrash_greg_t new_pc;
     plcrash_error_t err;
     
-    err = plcrash_async_task_memcpy(task, (pl_vm_address_t) fp, 0, dest, len);
+    err = plcrash_async_mobject_task_memcpy(plframe_unwind_cache_stack(unwind_cache), task, (pl_vm_address_t) fp, 0, dest, len);
     if (err != PLCRASH_ESUCCESS) {
         PLCF_DEBUG("Failed to read frame: %d", err);
         return PLFRAME_EBADFRAME;
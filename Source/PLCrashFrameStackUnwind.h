@@ -37,6 +37,7 @@ extern "C" {
 
 plframe_error_t plframe_cursor_read_frame_ptr (task_t task,
                                                plcrash_async_image_list_t *image_list,
+                                               plframe_unwind_cache_t *unwind_cache,
                                                const plframe_stackframe_t *current_frame,
                                                const plframe_stackframe_t *previous_frame,
                                                plframe_stackframe_t *next_frame);
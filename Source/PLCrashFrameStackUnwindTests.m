@@ -91,7 +91,7 @@ struct stack_frame {
                 has_prev_frame = &prev_frame;
 
             /* Fetch the next frame */
-            STAssertEquals(plframe_cursor_read_frame_ptr(cursor.task, &_image_list, &frame, has_prev_frame, &new_frame), PLFRAME_ESUCCESS, @"Failed to read next frame");
+            STAssertEquals(plframe_cursor_read_frame_ptr(cursor.task, &_image_list, NULL, &frame, has_prev_frame, &new_frame), PLFRAME_ESUCCESS, @"Failed to read next frame");
             prev_frame = frame;
             frame = new_frame;
         }
@@ -103,7 +103,7 @@ struct stack_frame {
     }
 
     /* Ensure that the final frame's NULL fp triggers an ENOFRAME */
-    STAssertEquals(plframe_cursor_read_frame_ptr(cursor.task, &_image_list, &frame, &prev_frame, &new_frame), PLFRAME_ENOFRAME, @"Expected to hit end of frames");
+    STAssertEquals(plframe_cursor_read_frame_ptr(cursor.task, &_image_list, NULL, &frame, &prev_frame, &new_frame), PLFRAME_ENOFRAME, @"Expected to hit end of frames");
 }
 
 /**
@@ -140,7 +140,7 @@ struct stack_frame {
                 has_prev_frame = &prev_frame;
             
             /* Fetch the next frame */
-            STAssertEquals(plframe_cursor_read_frame_ptr(cursor.task, &_image_list, &frame, has_prev_frame, &new_frame), PLFRAME_ESUCCESS, @"Failed to read next frame");
+            STAssertEquals(plframe_cursor_read_frame_ptr(cursor.task, &_image_list, NULL, &frame, has_prev_frame, &new_frame), PLFRAME_ESUCCESS, @"Failed to read next frame");
             prev_frame = frame;
             frame = new_frame;
         }
@@ -152,7 +152,7 @@ struct stack_frame {
     }
 
     /* Ensure that the final frame's bad fp triggers an EBADFRAME */
-    STAssertEquals(plframe_cursor_read_frame_ptr(cursor.task, &_image_list, &frame, &prev_frame, &new_frame), PLFRAME_EBADFRAME, @"Expected to hit end of frames");
+    STAssertEquals(plframe_cursor_read_frame_ptr(cursor.task, &_image_list, NULL, &frame, &prev_frame, &new_frame), PLFRAME_EBADFRAME, @"Expected to hit end of frames");
 }
 
 @end
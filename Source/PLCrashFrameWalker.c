@@ -35,6 +35,9 @@
 #include "PLCrashFrameDWARFUnwind.h"
 
 #include "PLCrashFeatureConfig.h"
+#include "PLCrashProbes.h"
+
+#include <inttypes.h>
 
 #pragma mark Error Handling
 
@@ -65,6 +68,137 @@ const char *plframe_strerror (plframe_error_t error) {
     return "Unhandled error code";
 }
 
+#pragma mark Unwind Cache
+
+/**
+ * Initialize a new unwind cache.
+ *
+ * @param cache The cache to initialize. The cache must be released via plframe_unwind_cache_free().
+ */
+void plframe_unwind_cache_init (plframe_unwind_cache_t *cache) {
+    plcrash_async_macho_section_cache_init(&cache->sections);
+    cache->dwarf_cache = NULL;
+    cache->compact_cache = NULL;
+    cache->stack_mapped = false;
+    cache->stack_pinned = false;
+}
+
+/**
+ * Return the section cache held by @a cache, or NULL if @a cache is NULL.
+ *
+ * @param cache The unwind cache, or NULL.
+ */
+plcrash_async_macho_section_cache_t *plframe_unwind_cache_sections (plframe_unwind_cache_t *cache) {
+    if (cache == NULL)
+        return NULL;
+
+    return &cache->sections;
+}
+
+/**
+ * Map up to PLFRAME_STACK_MAPPING_SIZE bytes of the stack described by @a thread_state into @a cache, replacing any
+ * existing stack mapping. Subsequent stack reads performed by the frame readers will be served from this mapping,
+ * rather than requiring a separate read of the target task's memory for every frame.
+ *
+ * Stack reads that fall outside of the mapping are confined to the VM region containing the thread's stack pointer;
+ * reads outside of that region will fail without being issued against the target task. If the stack can not be
+ * mapped, stack reads will fall back to reading directly from the target task.
+ *
+ * @param cache The unwind cache, or NULL.
+ * @param task The task containing the thread's stack.
+ * @param thread_state The thread state from which the stack pointer will be fetched.
+ */
+void plframe_unwind_cache_map_stack (plframe_unwind_cache_t *cache, task_t task, const plcrash_async_thread_state_t *thread_state) {
+    if (cache == NULL)
+        return;
+
+    /* A stack supplied by the caller is retained for the lifetime of the cache */
+    if (cache->stack_pinned)
+        return;
+
+    /* Discard any previous thread's mapping */
+    if (cache->stack_mapped) {
+        plcrash_async_mobject_free(&cache->stack);
+        cache->stack_mapped = false;
+    }
+
+    if (!plcrash_async_thread_state_has_reg(thread_state, PLCRASH_REG_SP))
+        return;
+
+    /* All supported architectures use a downward growing stack; the live frames reside above the stack pointer. */
+    if (plcrash_async_thread_state_get_stack_direction(thread_state) != PLCRASH_ASYNC_THREAD_STACK_DIRECTION_DOWN)
+        return;
+
+    /* Map the stack, permitting a short mapping if the stack ends within PLFRAME_STACK_MAPPING_SIZE bytes */
+    plcrash_greg_t sp = plcrash_async_thread_state_get_reg(thread_state, PLCRASH_REG_SP);
+    if (plcrash_async_mobject_init(&cache->stack, task, (pl_vm_address_t) sp, PLFRAME_STACK_MAPPING_SIZE, false) != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("Could not map the stack at 0x%" PRIx64 "; stack reads will not be cached", (uint64_t) sp);
+        return;
+    }
+
+    /* Confine stack reads that miss the mapping to the VM region containing the stack pointer; a corrupt frame
+     * pointer will then be rejected without issuing a read against the task. */
+    pl_vm_address_t stack_base;
+    pl_vm_size_t stack_size;
+    if (plcrash_async_mobject_region_lookup(task, (pl_vm_address_t) sp, &stack_base, &stack_size))
+        plcrash_async_mobject_set_read_bounds(&cache->stack, stack_base, stack_size);
+
+    cache->stack_mapped = true;
+}
+
+/**
+ * Return the stack mapping held by @a cache, or NULL if @a cache is NULL or no stack has been mapped. The result
+ * may be passed to plcrash_async_mobject_task_memcpy() to perform stack reads.
+ *
+ * @param cache The unwind cache, or NULL.
+ */
+plcrash_async_mobject_t *plframe_unwind_cache_stack (plframe_unwind_cache_t *cache) {
+    if (cache == NULL || !cache->stack_mapped)
+        return NULL;
+
+    return &cache->stack;
+}
+
+/**
+ * Supply the stack mapping to be used by the frame readers, replacing any existing mapping. The mapping will not be
+ * replaced by plframe_unwind_cache_map_stack(), and will be freed along with @a cache.
+ *
+ * @param cache The unwind cache.
+ * @param stack The stack mapping. Ownership of the mapping is transfered to @a cache.
+ */
+void plframe_unwind_cache_set_stack (plframe_unwind_cache_t *cache, const plcrash_async_mobject_t *stack) {
+    if (cache->stack_mapped)
+        plcrash_async_mobject_free(&cache->stack);
+
+    cache->stack = *stack;
+    cache->stack_mapped = true;
+    cache->stack_pinned = true;
+}
+
+/**
+ * Free all resources held by @a cache.
+ *
+ * @param cache The cache to be freed.
+ */
+void plframe_unwind_cache_free (plframe_unwind_cache_t *cache) {
+#if PLCRASH_FEATURE_UNWIND_DWARF
+    if (cache->dwarf_cache != NULL)
+        plframe_dwarf_cache_free(cache->dwarf_cache);
+
+    if (cache->compact_cache != NULL)
+        plframe_compact_unwind_cache_free(cache->compact_cache);
+#endif
+    cache->dwarf_cache = NULL;
+    cache->compact_cache = NULL;
+
+    if (cache->stack_mapped)
+        plcrash_async_mobject_free(&cache->stack);
+    cache->stack_mapped = false;
+    cache->stack_pinned = false;
+
+    plcrash_async_macho_section_cache_free(&cache->sections);
+}
+
 #pragma mark Frame Walking
 
 /**
@@ -79,6 +213,9 @@ static void plframe_cursor_internal_init (plframe_cursor_t *cursor, task_t task,
     cursor->depth = 0;
     cursor->task = task;
     cursor->image_list = image_list;
+    cursor->unwind_cache = NULL;
+    cursor->stalled_frames = 0;
+    cursor->stalled_filter = 0;
     mach_port_mod_refs(mach_task_self(), cursor->task, MACH_PORT_RIGHT_SEND, 1);    
 }
 
@@ -124,6 +261,92 @@ plframe_error_t plframe_cursor_thread_init (plframe_cursor_t *cursor, task_t tas
     return plcrash_async_thread_state_mach_thread_init(&cursor->frame.thread_state, thread);
 }
 
+/**
+ * Configure an unwind cache to be used by the cursor's frame readers. If not configured, the frame readers will
+ * map and decode the required unwind data for every frame.
+ *
+ * @param cursor A cursor instance initialized with plframe_cursor_init();
+ * @param unwind_cache The unwind cache to be used, or NULL. This is a borrowed reference, and must remain valid for the
+ * lifetime of the cursor.
+ */
+void plframe_cursor_set_unwind_cache (plframe_cursor_t *cursor, plframe_unwind_cache_t *unwind_cache) {
+    cursor->unwind_cache = unwind_cache;
+}
+
+/**
+ * @internal
+ * Return the bloom filter bits for the frame identified by @a pc and @a stack_addr.
+ */
+static uint64_t plframe_cursor_stall_filter_bits (plcrash_greg_t pc, plcrash_greg_t stack_addr) {
+    uint64_t hash = ((uint64_t) pc ^ ((uint64_t) stack_addr * 0x9E3779B97F4A7C15ULL)) * 0xFF51AFD7ED558CCDULL;
+    return (1ULL << (hash >> 58)) | (1ULL << ((hash >> 52) & 63));
+}
+
+/**
+ * @internal
+ * Verify that @a next_frame makes progress up the stack relative to @a cursor's current frame.
+ *
+ * The stack pointer -- or the frame pointer, if the stack pointer is unavailable in either frame -- must not move
+ * against the stack's growth direction. A frame that does not advance the stack is permitted, up to
+ * PLFRAME_MAX_STALLED_FRAMES consecutive frames, as long as its (PC, stack address) pair has not already been seen
+ * since the stack last advanced. While the stack is advancing no pair can repeat, and so only stalled frames need be
+ * tracked.
+ *
+ * @param cursor The cursor.
+ * @param next_frame The frame read from @a cursor's current frame.
+ *
+ * @return Returns PLFRAME_ESUCCESS if the frame may be returned, or PLFRAME_EBADFRAME if the frame chain is corrupt.
+ */
+static plframe_error_t plframe_cursor_check_progress (plframe_cursor_t *cursor, const plframe_stackframe_t *next_frame) {
+    const plcrash_async_thread_state_t *cur = &cursor->frame.thread_state;
+    const plcrash_async_thread_state_t *next = &next_frame->thread_state;
+    plcrash_regnum_t reg;
+
+    /* Prefer the stack pointer; the frame pointer reader only supplies FP and IP. */
+    if (plcrash_async_thread_state_has_reg(cur, PLCRASH_REG_SP) && plcrash_async_thread_state_has_reg(next, PLCRASH_REG_SP)) {
+        reg = PLCRASH_REG_SP;
+    } else if (plcrash_async_thread_state_has_reg(cur, PLCRASH_REG_FP) && plcrash_async_thread_state_has_reg(next, PLCRASH_REG_FP)) {
+        reg = PLCRASH_REG_FP;
+    } else {
+        /* No basis for comparison */
+        return PLFRAME_ESUCCESS;
+    }
+
+    plcrash_greg_t cur_addr = plcrash_async_thread_state_get_reg(cur, reg);
+    plcrash_greg_t next_addr = plcrash_async_thread_state_get_reg(next, reg);
+
+    if (cur_addr != next_addr) {
+        bool down = (plcrash_async_thread_state_get_stack_direction(cur) == PLCRASH_ASYNC_THREAD_STACK_DIRECTION_DOWN);
+        if ((down && next_addr < cur_addr) || (!down && next_addr > cur_addr)) {
+            PLCF_DEBUG("Stack address moved against the stack direction, terminating stack walk");
+            return PLFRAME_EBADFRAME;
+        }
+
+        /* The stack advanced */
+        cursor->stalled_frames = 0;
+        cursor->stalled_filter = 0;
+        return PLFRAME_ESUCCESS;
+    }
+
+    /* The stack did not advance; the current frame begins a new stalled run. */
+    if (cursor->stalled_frames == 0 && plcrash_async_thread_state_has_reg(cur, PLCRASH_REG_IP))
+        cursor->stalled_filter |= plframe_cursor_stall_filter_bits(plcrash_async_thread_state_get_reg(cur, PLCRASH_REG_IP), cur_addr);
+
+    if (++cursor->stalled_frames > PLFRAME_MAX_STALLED_FRAMES) {
+        PLCF_DEBUG("Stack failed to advance over %u frames, terminating stack walk", cursor->stalled_frames);
+        return PLFRAME_EBADFRAME;
+    }
+
+    uint64_t bits = plframe_cursor_stall_filter_bits(plcrash_async_thread_state_get_reg(next, PLCRASH_REG_IP), next_addr);
+    if ((cursor->stalled_filter & bits) == bits) {
+        PLCF_DEBUG("Cycle detected in frame chain at 0x%" PRIx64 ", terminating stack walk", (uint64_t) next_addr);
+        return PLFRAME_EBADFRAME;
+    }
+    cursor->stalled_filter |= bits;
+
+    return PLFRAME_ESUCCESS;
+}
+
 /**
  * Fetch the next frame using the provided frame readers.
  *
@@ -139,6 +362,10 @@ plframe_error_t plframe_cursor_next_with_readers (plframe_cursor_t *cursor, plfr
         return PLFRAME_ESUCCESS;
     }
     
+    /* Map the thread's stack on the first step, allowing the stack reads for all frames to be served from one mapping. */
+    if (cursor->depth == 1)
+        plframe_unwind_cache_map_stack(cursor->unwind_cache, cursor->task, &cursor->frame.thread_state);
+
     /* A previous frame is only available if we're on the second frame */
     plframe_stackframe_t *prev_frame = NULL;
     if (cursor->depth >= 2)
@@ -149,7 +376,8 @@ plframe_error_t plframe_cursor_next_with_readers (plframe_cursor_t *cursor, plfr
     plframe_error_t ferr = PLFRAME_EINVAL; // default return value if reader_count is 0.
     
     for (size_t i = 0; i < reader_count; i++) {
-        ferr = readers[i](cursor->task, cursor->image_list, &cursor->frame, prev_frame, &frame);
+        ferr = readers[i](cursor->task, cursor->image_list, cursor->unwind_cache, &cursor->frame, prev_frame, &frame);
+        PLCR_PROBE_EVENT("frame_reader", "depth=%u reader=%zu result=%d", (unsigned int) cursor->depth, i, (int) ferr);
         if (ferr == PLFRAME_ESUCCESS)
             break;
     }
@@ -168,6 +396,10 @@ plframe_error_t plframe_cursor_next_with_readers (plframe_cursor_t *cursor, plfr
     plcrash_greg_t ip = plcrash_async_thread_state_get_reg(&frame.thread_state, PLCRASH_REG_IP);
     if (ip <= PAGE_SIZE)
         return PLFRAME_ENOFRAME;
+
+    /* Terminate walks of looping or stalled frame chains */
+    if ((ferr = plframe_cursor_check_progress(cursor, &frame)) != PLFRAME_ESUCCESS)
+        return ferr;
     
     /* Save the newly fetched frame */
     cursor->prev_frame = cursor->frame;
@@ -246,3 +478,55 @@ void plframe_cursor_free(plframe_cursor_t *cursor) {
     if (cursor->task != MACH_PORT_NULL)
         mach_port_mod_refs(mach_task_self(), cursor->task, MACH_PORT_RIGHT_SEND, -1);
 }
+
+/**
+ * Walk a stack previously captured from a thread, such as the stack memory included in a raw capture crash report,
+ * recording the PC of each frame.
+ *
+ * The originating process is not required to be running; all stack reads are served from @a stack. Only the frame
+ * pointer reader is used, as the compact unwind and DWARF readers require access to the originating process' images.
+ *
+ * @param thread_state The thread's initial register state.
+ * @param stack_address The address at which @a stack resided in the originating process.
+ * @param stack The captured stack memory.
+ * @param stack_length The size of @a stack, in bytes.
+ * @param pcs On return, the PC of each walked frame, starting with the initial frame.
+ * @param max_pcs The maximum number of PCs to be written to @a pcs.
+ *
+ * @return Returns the number of PCs written to @a pcs.
+ */
+size_t plframe_walk_captured_stack (const plcrash_async_thread_state_t *thread_state,
+                                    pl_vm_address_t stack_address,
+                                    const void *stack,
+                                    pl_vm_size_t stack_length,
+                                    plcrash_greg_t *pcs,
+                                    size_t max_pcs)
+{
+    plframe_cursor_frame_reader_t *readers[] = { plframe_cursor_read_frame_ptr };
+    plcrash_async_thread_state_t state = *thread_state;
+    plframe_unwind_cache_t cache;
+    plcrash_async_mobject_t mobj;
+    plframe_cursor_t cursor;
+    size_t count = 0;
+
+    /* Serve all stack reads from the captured memory */
+    plframe_unwind_cache_init(&cache);
+    plcrash_async_mobject_init_buffer(&mobj, stack_address, stack, stack_length);
+    plframe_unwind_cache_set_stack(&cache, &mobj);
+
+    plframe_cursor_init(&cursor, MACH_PORT_NULL, &state, NULL);
+    plframe_cursor_set_unwind_cache(&cursor, &cache);
+
+    while (count < max_pcs && plframe_cursor_next_with_readers(&cursor, readers, sizeof(readers)/sizeof(readers[0])) == PLFRAME_ESUCCESS) {
+        plcrash_greg_t pc;
+        if (plframe_cursor_get_reg(&cursor, PLCRASH_REG_IP, &pc) != PLFRAME_ESUCCESS)
+            break;
+
+        pcs[count++] = pc;
+    }
+
+    plframe_cursor_free(&cursor);
+    plframe_unwind_cache_free(&cache);
+
+    return count;
+}
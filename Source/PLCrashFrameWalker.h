@@ -121,6 +121,61 @@ typedef struct plframe_stackframe {
     plcrash_async_thread_state_t thread_state;
 } plframe_stackframe_t;
 
+/**
+ * @internal
+ *
+ * The maximum number of bytes of a thread's stack, starting at the thread's initial stack pointer, that will be
+ * mapped by plframe_unwind_cache_map_stack().
+ */
+#define PLFRAME_STACK_MAPPING_SIZE (128 * 1024)
+
+/**
+ * @internal
+ *
+ * The maximum number of consecutive frames that may be read without the stack advancing before the stack walk is
+ * terminated. A leaf function that does not allocate stack space legitimately shares its caller's stack pointer, but
+ * a longer run indicates a corrupt or looping frame chain.
+ */
+#define PLFRAME_MAX_STALLED_FRAMES 4
+
+/**
+ * @internal
+ *
+ * Unwind data cached across frame reads, allowing a section's unwind data to be mapped and decoded once per
+ * report, rather than once per frame. The cache may be shared by cursors walking different threads of the same task,
+ * but may not be used concurrently from multiple threads.
+ */
+typedef struct plframe_unwind_cache {
+    /** Mapped Mach-O sections (eg, __unwind_info, __eh_frame). */
+    plcrash_async_macho_section_cache_t sections;
+
+    /** Parsed DWARF CIEs, and computed DWARF unwind rows keyed by PC. Lazily allocated by the DWARF frame reader;
+     * NULL if unallocated. */
+    struct plframe_dwarf_cache *dwarf_cache;
+
+    /** Decoded compact unwind entries, keyed by PC. Lazily allocated by the compact unwind frame reader; NULL if
+     * unallocated. */
+    struct plframe_compact_unwind_cache *compact_cache;
+
+    /** A mapping of the stack of the thread most recently walked, from which the frame readers will serve stack
+     * reads. Only valid if @a stack_mapped is true. */
+    plcrash_async_mobject_t stack;
+
+    /** True if @a stack holds a valid mapping. */
+    bool stack_mapped;
+
+    /** True if @a stack was supplied via plframe_unwind_cache_set_stack(), and must not be replaced when a
+     * thread's stack is mapped. */
+    bool stack_pinned;
+} plframe_unwind_cache_t;
+
+void plframe_unwind_cache_init (plframe_unwind_cache_t *cache);
+plcrash_async_macho_section_cache_t *plframe_unwind_cache_sections (plframe_unwind_cache_t *cache);
+void plframe_unwind_cache_map_stack (plframe_unwind_cache_t *cache, task_t task, const plcrash_async_thread_state_t *thread_state);
+plcrash_async_mobject_t *plframe_unwind_cache_stack (plframe_unwind_cache_t *cache);
+void plframe_unwind_cache_set_stack (plframe_unwind_cache_t *cache, const plcrash_async_mobject_t *stack);
+void plframe_unwind_cache_free (plframe_unwind_cache_t *cache);
+
 /**
  * @internal
  * Frame cursor context.
@@ -131,6 +186,10 @@ typedef struct plframe_cursor {
     
     /** The task's current image list. This is a borrowed reference, and must remain valid for the lifetime of the cursor. */
     plcrash_async_image_list_t *image_list;
+
+    /** An optional unwind cache to be used by the frame readers, or NULL. This is a borrowed reference, and must remain
+     * valid for the lifetime of the cursor. */
+    plframe_unwind_cache_t *unwind_cache;
     
     /** The current frame depth. If the depth is 0, the cursor has not been stepped, and the remainder of this
      * structure should be considered uninitialized. */
@@ -141,6 +200,13 @@ typedef struct plframe_cursor {
 
     /** The current stack frame data */
     plframe_stackframe_t frame;
+
+    /** The number of consecutive frames read without the stack advancing. */
+    uint32_t stalled_frames;
+
+    /** A bloom filter of the (PC, stack address) pairs of the frames read since the stack last advanced, used to
+     * detect cycles in the frame chain. */
+    uint64_t stalled_filter;
 } plframe_cursor_t;
 
 /**
@@ -148,6 +214,7 @@ typedef struct plframe_cursor {
  *
  * @param task The task containing the target frame stack.
  * @param image_list The list of images loaded in the target @a task.
+ * @param unwind_cache A cache of unwind data to be used by the reader, or NULL.
  * @param current_frame The current stack frame.
  * @param previous_frame The previous stack frame, or NULL if this is the first frame.
  * @param next_frame The new frame to be initialized.
@@ -156,6 +223,7 @@ typedef struct plframe_cursor {
  */
 typedef plframe_error_t plframe_cursor_frame_reader_t (task_t task,
                                                        plcrash_async_image_list_t *image_list,
+                                                       plframe_unwind_cache_t *unwind_cache,
                                                        const plframe_stackframe_t *current_frame,
                                                        const plframe_stackframe_t *previous_frame,
                                                        plframe_stackframe_t *next_frame);
@@ -165,6 +233,8 @@ const char *plframe_strerror (plframe_error_t error);
 plframe_error_t plframe_cursor_init (plframe_cursor_t *cursor, task_t task, plcrash_async_thread_state_t *thread_state, plcrash_async_image_list_t *image_list);
 plframe_error_t plframe_cursor_thread_init (plframe_cursor_t *cursor, task_t task, thread_t thread, plcrash_async_image_list_t *image_list);
 
+void plframe_cursor_set_unwind_cache (plframe_cursor_t *cursor, plframe_unwind_cache_t *unwind_cache);
+
 char const *plframe_cursor_get_regname (plframe_cursor_t *cursor, plcrash_regnum_t regnum);
 size_t plframe_cursor_get_regcount (plframe_cursor_t *cursor);
 plframe_error_t plframe_cursor_get_reg (plframe_cursor_t *cursor, plcrash_regnum_t regnum, plcrash_greg_t *reg);
@@ -174,6 +244,13 @@ plframe_error_t plframe_cursor_next_with_readers (plframe_cursor_t *cursor, plfr
 
 void plframe_cursor_free(plframe_cursor_t *cursor);
 
+size_t plframe_walk_captured_stack (const plcrash_async_thread_state_t *thread_state,
+                                    pl_vm_address_t stack_address,
+                                    const void *stack,
+                                    pl_vm_size_t stack_length,
+                                    plcrash_greg_t *pcs,
+                                    size_t max_pcs);
+
 /**
  * @} plcrash_framewalker
  */
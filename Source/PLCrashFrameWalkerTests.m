@@ -27,10 +27,12 @@
  */
 
 #import <pthread.h>
+#import <mach-o/dyld.h>
 
 #import "SenTestCompat.h"
 
 #import "PLCrashFrameWalker.h"
+#import "PLCrashFeatureConfig.h"
 #import "PLCrashTestThread.h"
 
 #import "unwind_test_harness.h"
@@ -88,6 +90,7 @@
 /* Test-only frame readers */
 static plframe_error_t null_ip_reader (task_t task,
                                        plcrash_async_image_list_t *image_list,
+                                       plframe_unwind_cache_t *unwind_cache,
                                        const plframe_stackframe_t *current_frame,
                                        const plframe_stackframe_t *previous_frame,
                                        plframe_stackframe_t *next_frame)
@@ -99,6 +102,7 @@ static plframe_error_t null_ip_reader (task_t task,
 
 static plframe_error_t esuccess_reader (task_t task,
                                         plcrash_async_image_list_t *image_list,
+                                        plframe_unwind_cache_t *unwind_cache,
                                         const plframe_stackframe_t *current_frame,
                                         const plframe_stackframe_t *previous_frame,
                                         plframe_stackframe_t *next_frame)
@@ -128,6 +132,123 @@ static plframe_error_t esuccess_reader (task_t task,
     
 }
 
+/* Alternates between two PCs without advancing the stack */
+static plframe_error_t cycle_reader (task_t task,
+                                     plcrash_async_image_list_t *image_list,
+                                     plframe_unwind_cache_t *unwind_cache,
+                                     const plframe_stackframe_t *current_frame,
+                                     const plframe_stackframe_t *previous_frame,
+                                     plframe_stackframe_t *next_frame)
+{
+    plcrash_async_thread_state_copy(&next_frame->thread_state, &current_frame->thread_state);
+    plcrash_greg_t ip = plcrash_async_thread_state_get_reg(&current_frame->thread_state, PLCRASH_REG_IP);
+    plcrash_async_thread_state_set_reg(&next_frame->thread_state, PLCRASH_REG_IP, ip == 0x2000 ? 0x3000 : 0x2000);
+    return PLFRAME_ESUCCESS;
+}
+
+/* Moves the stack pointer against the stack direction */
+static plframe_error_t reversed_sp_reader (task_t task,
+                                           plcrash_async_image_list_t *image_list,
+                                           plframe_unwind_cache_t *unwind_cache,
+                                           const plframe_stackframe_t *current_frame,
+                                           const plframe_stackframe_t *previous_frame,
+                                           plframe_stackframe_t *next_frame)
+{
+    plcrash_async_thread_state_copy(&next_frame->thread_state, &current_frame->thread_state);
+    plcrash_greg_t sp = plcrash_async_thread_state_get_reg(&current_frame->thread_state, PLCRASH_REG_SP);
+    if (plcrash_async_thread_state_get_stack_direction(&current_frame->thread_state) == PLCRASH_ASYNC_THREAD_STACK_DIRECTION_DOWN)
+        sp -= 16;
+    else
+        sp += 16;
+    plcrash_async_thread_state_set_reg(&next_frame->thread_state, PLCRASH_REG_SP, sp);
+    return PLFRAME_ESUCCESS;
+}
+
+/**
+ * Verify that frame chains that fail to advance the stack, loop, or move against the stack direction are terminated.
+ */
+- (void) testStalledFrames {
+    plframe_cursor_t cursor;
+    plframe_error_t err;
+    uint32_t count;
+
+    /* A repeating frame is rejected on its first repetition */
+    STAssertEquals(PLFRAME_ESUCCESS, plframe_cursor_thread_init(&cursor, mach_task_self(), pthread_mach_thread_np(_thr_args.thread), &_image_list), @"Initialization failed");
+    STAssertEquals(PLFRAME_ESUCCESS, plframe_cursor_next(&cursor), @"Failed to fetch first frame");
+
+    plframe_cursor_frame_reader_t *stall_readers[] = { esuccess_reader };
+    STAssertEquals(PLFRAME_EBADFRAME, plframe_cursor_next_with_readers(&cursor, stall_readers, 1), @"Stalled frame was not rejected");
+    plframe_cursor_free(&cursor);
+
+    /* A cycle is rejected within PLFRAME_MAX_STALLED_FRAMES frames */
+    STAssertEquals(PLFRAME_ESUCCESS, plframe_cursor_thread_init(&cursor, mach_task_self(), pthread_mach_thread_np(_thr_args.thread), &_image_list), @"Initialization failed");
+    STAssertEquals(PLFRAME_ESUCCESS, plframe_cursor_next(&cursor), @"Failed to fetch first frame");
+
+    plframe_cursor_frame_reader_t *cycle_readers[] = { cycle_reader };
+    for (count = 0; (err = plframe_cursor_next_with_readers(&cursor, cycle_readers, 1)) == PLFRAME_ESUCCESS; count++)
+        STAssertTrue(count <= PLFRAME_MAX_STALLED_FRAMES, @"Cycle was not detected");
+    STAssertEquals(PLFRAME_EBADFRAME, err, @"Cycle was not rejected");
+    plframe_cursor_free(&cursor);
+
+    /* A stack pointer moving against the stack direction is rejected */
+    STAssertEquals(PLFRAME_ESUCCESS, plframe_cursor_thread_init(&cursor, mach_task_self(), pthread_mach_thread_np(_thr_args.thread), &_image_list), @"Initialization failed");
+    STAssertEquals(PLFRAME_ESUCCESS, plframe_cursor_next(&cursor), @"Failed to fetch first frame");
+
+    plframe_cursor_frame_reader_t *reversed_readers[] = { reversed_sp_reader };
+    STAssertEquals(PLFRAME_EBADFRAME, plframe_cursor_next_with_readers(&cursor, reversed_readers, 1), @"Reversed stack pointer was not rejected");
+    plframe_cursor_free(&cursor);
+}
+
+/* Walk the test thread's stack, recording up to @a max PC values */
+static size_t walk_test_thread (plcrash_test_thread_t *thr, plcrash_async_image_list_t *image_list, plframe_unwind_cache_t *unwind_cache, plcrash_greg_t *pcs, size_t max) {
+    plframe_cursor_t cursor;
+    size_t count = 0;
+
+    if (plframe_cursor_thread_init(&cursor, mach_task_self(), pthread_mach_thread_np(thr->thread), image_list) != PLFRAME_ESUCCESS) {
+        plframe_cursor_free(&cursor);
+        return 0;
+    }
+    plframe_cursor_set_unwind_cache(&cursor, unwind_cache);
+
+    while (count < max && plframe_cursor_next(&cursor) == PLFRAME_ESUCCESS) {
+        if (plframe_cursor_get_reg(&cursor, PLCRASH_REG_IP, &pcs[count]) != PLFRAME_ESUCCESS)
+            break;
+        count++;
+    }
+
+    plframe_cursor_free(&cursor);
+    return count;
+}
+
+/**
+ * Verify that walking with an unwind cache produces the same frames as walking without one.
+ */
+- (void) testUnwindCache {
+    plcrash_greg_t uncached[64];
+    plcrash_greg_t cached[64];
+    plframe_unwind_cache_t cache;
+
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&_image_list, (pl_vm_address_t) _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    size_t count = walk_test_thread(&_thr_args, &_image_list, NULL, uncached, 64);
+    STAssertTrue(count > 1, @"Failed to walk the test thread");
+
+    /* Walk twice; the second walk is served from the populated cache */
+    plframe_unwind_cache_init(&cache);
+    for (int pass = 0; pass < 2; pass++) {
+        STAssertEquals(count, walk_test_thread(&_thr_args, &_image_list, &cache, cached, 64), @"Incorrect frame count for pass %d", pass);
+        for (size_t i = 0; i < count; i++)
+            STAssertEquals(uncached[i], cached[i], @"Incorrect PC for frame %zu in pass %d", i, pass);
+    }
+    STAssertTrue(cache.sections.count > 0, @"No sections were cached");
+#if PLCRASH_FEATURE_UNWIND_COMPACT
+    STAssertNotNULL(cache.compact_cache, @"No compact unwind entries were cached");
+#endif
+    STAssertTrue(cache.stack_mapped, @"The thread stack was not mapped");
+    plframe_unwind_cache_free(&cache);
+}
+
 /*
  * Perform stack walking regression tests.
  */
@@ -135,4 +256,17 @@ static plframe_error_t esuccess_reader (task_t task,
     STAssertTrue(unwind_test_harness(), @"Regression tests failed");
 }
 
+/*
+ * Benchmark the frame readers against the stack walker regression tests. The benchmark is only run if the
+ * PLCRASH_UNWIND_BENCHMARK_ITERATIONS environment variable is set to the number of iterations to be performed
+ * for each frame; the machine readable results are written to stdout.
+ */
+- (void) testStackWalkerBenchmark {
+    const char *iterations = getenv("PLCRASH_UNWIND_BENCHMARK_ITERATIONS");
+    if (iterations == NULL)
+        return;
+
+    STAssertTrue(unwind_benchmark_harness((uint32_t) strtoul(iterations, NULL, 10)), @"Benchmark failed");
+}
+
 @end
@@ -0,0 +1,76 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import <mach/mach.h>
+
+#import "PLCrashFeatureConfig.h"
+#import "PLCrashAsyncSymbolication.h"
+#import "PLCrashMachExceptionPort.h"
+
+#if PLCRASH_FEATURE_OUT_OF_PROCESS_HELPER
+
+/**
+ * @internal
+ *
+ * The maximum length, including the terminating NUL, of the application strings supplied to
+ * PLCrashHelperServer::registerWithServiceName:reportPath:applicationIdentifier:applicationVersion:applicationMarketingVersion:symbolStrategy:mask:error:.
+ */
+#define PLCRASH_HELPER_MAX_STRING 256
+
+@interface PLCrashHelperServer : NSObject {
+@private
+    /** The bootstrap service port, on which client registrations are received. */
+    mach_port_t _servicePort;
+
+    /** The port on which client task dead-name notifications are received. */
+    mach_port_t _notifyPort;
+
+    /** Port set containing @a _servicePort and @a _notifyPort. */
+    mach_port_t _portSet;
+
+    /** Registered clients, keyed by the client task's port name. */
+    NSMutableDictionary *_clients;
+}
+
+- (instancetype) initWithServiceName: (NSString *) serviceName error: (NSError **) outError;
+
+- (void) run;
+
++ (PLCrashMachExceptionPort *) registerWithServiceName: (NSString *) serviceName
+                                            reportPath: (NSString *) reportPath
+                                 applicationIdentifier: (NSString *) applicationIdentifier
+                                    applicationVersion: (NSString *) applicationVersion
+                           applicationMarketingVersion: (NSString *) applicationMarketingVersion
+                                        symbolStrategy: (plcrash_async_symbol_strategy_t) symbolStrategy
+                                                  mask: (exception_mask_t) mask
+                                                 error: (NSError **) outError;
+
+@end
+
+#endif /* PLCRASH_FEATURE_OUT_OF_PROCESS_HELPER */
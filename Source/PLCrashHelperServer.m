@@ -0,0 +1,746 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashHelperServer.h"
+
+#if PLCRASH_FEATURE_OUT_OF_PROCESS_HELPER
+
+#import "PLCrashMachExceptionServer.h"
+#import "PLCrashReporterNSError.h"
+#import "PLCrashLogWriter.h"
+#import "PLCrashAsyncImageList.h"
+#import "PLCrashAsyncMachExceptionInfo.h"
+#import "PLCrashAsync.h"
+
+#import <servers/bootstrap.h>
+#import <mach/notify.h>
+#import <fcntl.h>
+#import <limits.h>
+
+/**
+ * @internal
+ * The msgh_id of a helper registration request. As per MIG convention, the reply's msgh_id is the request's
+ * msgh_id + 100.
+ */
+#define PLCRASH_HELPER_REGISTER_MSGH_ID 0x706c6872 /* 'plhr' */
+
+/** @internal The msgh_id of a helper registration reply. */
+#define PLCRASH_HELPER_REGISTER_REPLY_MSGH_ID (PLCRASH_HELPER_REGISTER_MSGH_ID + 100)
+
+/** @internal The helper registration protocol version. */
+#define PLCRASH_HELPER_PROTOCOL_VERSION 1
+
+/** @internal The maximum time to wait on the helper when registering, in milliseconds. */
+#define PLCRASH_HELPER_REGISTER_TIMEOUT_MS 5000
+
+/** @internal The maximum number of attempts made to read a crashed client's images while dyld is modifying them. */
+#define PLCRASH_HELPER_IMAGE_LIST_ATTEMPTS 3
+
+/**
+ * @internal
+ * Registration request, sent by a client to the helper's bootstrap service.
+ */
+typedef struct plcrash_helper_register_request {
+    mach_msg_header_t header;
+    mach_msg_body_t body;
+
+    /** The client's task port. */
+    mach_msg_port_descriptor_t task;
+
+    /** The protocol version (#PLCRASH_HELPER_PROTOCOL_VERSION). */
+    uint32_t version;
+
+    /** The symbolication strategy to be used when writing the client's crash report. */
+    uint32_t symbol_strategy;
+
+    /** The path to which the client's crash report will be written. */
+    char report_path[PATH_MAX];
+
+    /** The client's application identifier. */
+    char app_identifier[PLCRASH_HELPER_MAX_STRING];
+
+    /** The client's application version. */
+    char app_version[PLCRASH_HELPER_MAX_STRING];
+
+    /** The client's application marketing version, or an empty string. */
+    char app_marketing_version[PLCRASH_HELPER_MAX_STRING];
+} plcrash_helper_register_request_t;
+
+/**
+ * @internal
+ * Registration reply.
+ */
+typedef struct plcrash_helper_register_reply {
+    mach_msg_header_t header;
+    mach_msg_body_t body;
+
+    /** A send right for the client's exception server, or MACH_PORT_NULL if registration failed. */
+    mach_msg_port_descriptor_t exception_port;
+
+    /** KERN_SUCCESS, or the reason for which registration failed. */
+    kern_return_t result;
+
+    /** The exception behavior expected by the exception server. */
+    exception_behavior_t behavior;
+
+    /** The thread state flavor expected by the exception server. */
+    thread_state_flavor_t flavor;
+} plcrash_helper_register_reply_t;
+
+/**
+ * @internal
+ * Receive buffer for any message handled by the helper server, including the largest trailer.
+ */
+typedef union plcrash_helper_message {
+    mach_msg_header_t header;
+
+    struct {
+        plcrash_helper_register_request_t request;
+        mach_msg_max_trailer_t trailer;
+    } registration;
+
+    struct {
+        mach_dead_name_notification_t notification;
+        mach_msg_max_trailer_t trailer;
+    } dead_name;
+} plcrash_helper_message_t;
+
+/**
+ * @internal
+ *
+ * Copy @a string to the fixed-size @a buffer, returning false if @a string does not fit.
+ */
+static BOOL plcrash_helper_copy_string (char *buffer, size_t size, NSString *string) {
+    if (string == nil) {
+        buffer[0] = '\0';
+        return YES;
+    }
+
+    return [string getCString: buffer maxLength: size encoding: NSUTF8StringEncoding];
+}
+
+/**
+ * @internal
+ *
+ * A registered client of the helper. Each client is served by a dedicated exception server, and a report writer
+ * targeting the client's task.
+ */
+@interface PLCrashHelperClient : NSObject {
+@private
+    /** The client's task. */
+    task_t _task;
+
+    /** The writer used to write the client's crash report. */
+    plcrash_log_writer_t _writer;
+
+    /** If true, @a _writer has been initialized, and must be freed. */
+    BOOL _writerInitialized;
+
+    /** The path to which the crash report will be written. */
+    char *_reportPath;
+
+    /** The path to which the crash report is written before being moved into place. */
+    char *_tempPath;
+
+    /** If true, a crash report has been written for the client. */
+    BOOL _reported;
+
+    /** The client's exception server. */
+    PLCrashMachExceptionServer *_server;
+}
+
+- (instancetype) initWithRequest: (plcrash_helper_register_request_t *) request error: (NSError **) outError;
+
+- (PLCrashMachExceptionPort *) exceptionPortWithError: (NSError **) outError;
+
+@end
+
+/**
+ * @internal
+ *
+ * Exception callback for a registered client. This executes on the client's exception server thread, in the helper
+ * process, and is not constrained to async-safe operations; the crashed client remains blocked on the exception
+ * reply until the report has been written.
+ */
+static kern_return_t plcrash_helper_exception_callback (task_t task,
+                                                        thread_t thread,
+                                                        exception_type_t exception_type,
+                                                        mach_exception_data_t code,
+                                                        mach_msg_type_number_t code_count,
+                                                        void *context);
+
+@implementation PLCrashHelperClient
+
+/**
+ * Initialize a new client from a registration @a request. On success, the client assumes ownership of the
+ * request's task port.
+ *
+ * @param request The registration request.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error
+ * object indicating why the client could not be registered. You may specify nil for this parameter.
+ */
+- (instancetype) initWithRequest: (plcrash_helper_register_request_t *) request error: (NSError **) outError {
+    plcrash_error_t err;
+
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _task = MACH_PORT_NULL;
+
+    /* Ensure all strings are terminated */
+    request->report_path[sizeof(request->report_path) - 1] = '\0';
+    request->app_identifier[sizeof(request->app_identifier) - 1] = '\0';
+    request->app_version[sizeof(request->app_version) - 1] = '\0';
+    request->app_marketing_version[sizeof(request->app_marketing_version) - 1] = '\0';
+
+    _reportPath = strdup(request->report_path);
+    if (_reportPath == NULL || asprintf(&_tempPath, "%s.helper", request->report_path) < 0) {
+        _tempPath = NULL;
+        plcrash_populate_posix_error(outError, ENOMEM, @"Could not allocate the client's report paths");
+        [self release];
+        return nil;
+    }
+
+    /* Prepare the writer, targeting the client task */
+    NSString *marketingVersion = nil;
+    if (request->app_marketing_version[0] != '\0')
+        marketingVersion = [NSString stringWithUTF8String: request->app_marketing_version];
+
+    err = plcrash_log_writer_init(&_writer,
+                                  [NSString stringWithUTF8String: request->app_identifier],
+                                  [NSString stringWithUTF8String: request->app_version],
+                                  marketingVersion,
+                                  (plcrash_async_symbol_strategy_t) request->symbol_strategy,
+                                  false);
+    _writerInitialized = YES;
+    if (err != PLCRASH_ESUCCESS) {
+        plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Could not initialize the client's report writer", nil);
+        [self release];
+        return nil;
+    }
+
+    if ((err = plcrash_log_writer_nasync_set_target_task(&_writer, request->task.name)) != PLCRASH_ESUCCESS) {
+        plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Could not target the client's task", nil);
+        [self release];
+        return nil;
+    }
+
+    /* The client's stacks are walked from outside of the client, and may be walked in parallel */
+    plcrash_log_writer_nasync_set_unwind_workers(&_writer, (uint32_t) [[NSProcessInfo processInfo] activeProcessorCount]);
+
+    /* Start the client's exception server */
+    NSError *osError;
+    _server = [[PLCrashMachExceptionServer alloc] initWithCallBack: &plcrash_helper_exception_callback
+                                                           context: self
+                                                      highPriority: YES
+                                                             error: &osError];
+    if (_server == nil) {
+        plcrash_populate_error(outError, PLCrashReporterErrorOperatingSystem, @"Failed to instantiate the client's Mach exception server.", osError);
+        [self release];
+        return nil;
+    }
+
+    /* Take ownership of the task port */
+    _task = request->task.name;
+    request->task.name = MACH_PORT_NULL;
+
+    return self;
+}
+
+- (void) dealloc {
+    /* Stop the exception server prior to releasing any state used by its callback */
+    [_server release];
+
+    if (_writerInitialized)
+        plcrash_log_writer_free(&_writer);
+
+    if (_reportPath != NULL)
+        free(_reportPath);
+
+    if (_tempPath != NULL)
+        free(_tempPath);
+
+    if (MACH_PORT_VALID(_task))
+        mach_port_deallocate(mach_task_self(), _task);
+
+    [super dealloc];
+}
+
+/**
+ * Return a new exception port for the client's exception server.
+ *
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error
+ * object indicating why the port could not be created. You may specify nil for this parameter.
+ */
+- (PLCrashMachExceptionPort *) exceptionPortWithError: (NSError **) outError {
+    return [_server exceptionPortWithMask: 0 error: outError];
+}
+
+/**
+ * Write a crash report for the client.
+ *
+ * @param thread The crashed thread.
+ * @param siginfo The signal information.
+ */
+- (plcrash_error_t) writeReportForThread: (thread_t) thread siginfo: (plcrash_log_signal_info_t *) siginfo {
+    plcrash_async_image_list_t image_list;
+    plcrash_async_file_t file;
+    plcrash_error_t err;
+
+    /* Only a single report is written; the client is expected to terminate */
+    if (_reported)
+        return PLCRASH_EINVAL;
+    _reported = YES;
+
+    /* Read the client's images. The client's threads are suspended, but dyld may have been interrupted while
+     * modifying its image array. The helper is not memory constrained, and all symbol indexes are built up front. */
+    plcrash_nasync_image_list_init(&image_list, _task);
+    if (_writer.process_info.has_shared_cache)
+        plcrash_nasync_image_list_set_shared_cache(&image_list, &_writer.process_info.shared_cache);
+    if (_writer.symbol_strategy & PLCRASH_ASYNC_SYMBOL_STRATEGY_SYMBOL_TABLE)
+        plcrash_nasync_image_list_set_symbol_indexing(&image_list, true);
+
+    for (int i = 0; i < PLCRASH_HELPER_IMAGE_LIST_ATTEMPTS; i++) {
+        if ((err = plcrash_nasync_image_list_append_task_images(&image_list)) != PLCRASH_EINTERNAL)
+            break;
+    }
+    if (err != PLCRASH_ESUCCESS)
+        PLCF_DEBUG("Could not read the client's images, writing the report without them: %d", err);
+
+    /* Write the report */
+    int fd = open(_tempPath, O_RDWR|O_CREAT|O_TRUNC, 0644);
+    if (fd < 0) {
+        PLCF_DEBUG("Could not open the client's crash report output file: %s", strerror(errno));
+        plcrash_nasync_image_list_free(&image_list);
+        return PLCRASH_EINTERNAL;
+    }
+
+    plcrash_async_file_init(&file, fd, 0);
+    err = plcrash_log_writer_write(&_writer, thread, &image_list, &file, siginfo, NULL);
+    plcrash_log_writer_close(&_writer);
+
+    if (!plcrash_async_file_flush(&file) || !plcrash_async_file_close(&file)) {
+        PLCF_DEBUG("Failed to write the client's crash report");
+        plcrash_nasync_image_list_free(&image_list);
+        return PLCRASH_EINTERNAL;
+    }
+
+    plcrash_nasync_image_list_free(&image_list);
+
+    /* Move the completed report into place */
+    if (err == PLCRASH_ESUCCESS && rename(_tempPath, _reportPath) != 0) {
+        PLCF_DEBUG("Could not move the client's crash report into place: %s", strerror(errno));
+        return PLCRASH_EINTERNAL;
+    }
+
+    return err;
+}
+
+@end
+
+static kern_return_t plcrash_helper_exception_callback (task_t task,
+                                                        thread_t thread,
+                                                        exception_type_t exception_type,
+                                                        mach_exception_data_t code,
+                                                        mach_msg_type_number_t code_count,
+                                                        void *context)
+{
+    PLCrashHelperClient *client = (PLCrashHelperClient *) context;
+    plcrash_log_signal_info_t signal_info;
+    plcrash_log_bsd_signal_info_t bsd_signal_info;
+    plcrash_log_mach_signal_info_t mach_signal_info;
+    plcrash_error_t err;
+
+    /* Set up the BSD signal info */
+    siginfo_t si;
+    if (plcrash_async_mach_exception_get_siginfo(exception_type, code, code_count, CPU_TYPE_ANY, &si)) {
+        bsd_signal_info.signo = si.si_signo;
+        bsd_signal_info.code = si.si_code;
+        bsd_signal_info.address = si.si_addr;
+        signal_info.bsd_info = &bsd_signal_info;
+    } else {
+        PLCF_DEBUG("Unexpected error mapping Mach exception to a POSIX signal");
+        signal_info.bsd_info = NULL;
+    }
+
+    /* Set up the Mach signal info */
+    mach_signal_info.type = exception_type;
+    mach_signal_info.code = code;
+    mach_signal_info.code_count = code_count;
+    signal_info.mach_info = &mach_signal_info;
+
+    /* Write the report */
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    if ((err = [client writeReportForThread: thread siginfo: &signal_info]) != PLCRASH_ESUCCESS)
+        PLCF_DEBUG("Failed to write the client's crash report: %d", err);
+    [pool drain];
+
+    /* The exception message's task and thread rights are not otherwise released */
+    mach_port_deallocate(mach_task_self(), task);
+    mach_port_deallocate(mach_task_self(), thread);
+
+    /* Never report the exception as handled; the kernel will continue on to the host's exception handler, terminating
+     * the client */
+    return KERN_FAILURE;
+}
+
+/**
+ * @internal
+ *
+ * Out-of-process crash reporting helper.
+ *
+ * Crash reports are ordinarily written from within the crashing process, on a possibly corrupted heap and stack,
+ * and with the report writer constrained to async-safe operations and preallocated memory. The helper server instead
+ * runs within a separate helper process -- such as a launchd agent or XPC service declaring a Mach service --
+ * and writes the reports of its clients using the same task-agnostic readers, with no such constraints.
+ *
+ * A client registers once, at startup, via
+ * PLCrashHelperServer::registerWithServiceName:reportPath:applicationIdentifier:applicationVersion:applicationMarketingVersion:symbolStrategy:mask:error:,
+ * which sends the client's task port to the helper, and returns the exception port of a helper-hosted exception
+ * server dedicated to the client. On a crash, the crashing thread blocks on the exception reply while the helper
+ * writes the report to the path supplied at registration. A client is released once its task terminates.
+ *
+ * The helper must be running on the same host, and with the same pointer width, as its clients.
+ *
+ * @par Usage
+ *
+ * @code
+ * int main (int argc, char *argv[]) {
+ *     PLCrashHelperServer *server = [[PLCrashHelperServer alloc] initWithServiceName: @"com.example.crash-helper" error: NULL];
+ *     [server run];
+ * }
+ * @endcode
+ */
+@implementation PLCrashHelperServer
+
+/**
+ * Initialize a new helper server, checking in with launchd to receive the given bootstrap service's port. The
+ * service must be declared in the helper's launchd or XPC service property list.
+ *
+ * @param serviceName The bootstrap service name.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error
+ * object in the NSMachErrorDomain indicating why the server could not be initialized. You may specify nil for
+ * this parameter.
+ */
+- (instancetype) initWithServiceName: (NSString *) serviceName error: (NSError **) outError {
+    kern_return_t kr;
+
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _servicePort = MACH_PORT_NULL;
+    _notifyPort = MACH_PORT_NULL;
+    _portSet = MACH_PORT_NULL;
+    _clients = [[NSMutableDictionary alloc] init];
+
+    kr = bootstrap_check_in(bootstrap_port, [serviceName UTF8String], &_servicePort);
+    if (kr != KERN_SUCCESS) {
+        plcrash_populate_mach_error(outError, kr, @"Failed to check in the helper's bootstrap service");
+        [self release];
+        return nil;
+    }
+
+    kr = mach_port_allocate(mach_task_self(), MACH_PORT_RIGHT_RECEIVE, &_notifyPort);
+    if (kr != KERN_SUCCESS) {
+        plcrash_populate_mach_error(outError, kr, @"Failed to allocate the helper's notification port");
+        [self release];
+        return nil;
+    }
+
+    kr = mach_port_allocate(mach_task_self(), MACH_PORT_RIGHT_PORT_SET, &_portSet);
+    if (kr != KERN_SUCCESS) {
+        plcrash_populate_mach_error(outError, kr, @"Failed to allocate the helper's port set");
+        [self release];
+        return nil;
+    }
+
+    if ((kr = mach_port_move_member(mach_task_self(), _servicePort, _portSet)) != KERN_SUCCESS ||
+        (kr = mach_port_move_member(mach_task_self(), _notifyPort, _portSet)) != KERN_SUCCESS)
+    {
+        plcrash_populate_mach_error(outError, kr, @"Failed to add the helper's ports to its port set");
+        [self release];
+        return nil;
+    }
+
+    return self;
+}
+
+- (void) dealloc {
+    /* Stop all client exception servers */
+    [_clients release];
+
+    if (_servicePort != MACH_PORT_NULL)
+        mach_port_mod_refs(mach_task_self(), _servicePort, MACH_PORT_RIGHT_RECEIVE, -1);
+
+    if (_notifyPort != MACH_PORT_NULL)
+        mach_port_mod_refs(mach_task_self(), _notifyPort, MACH_PORT_RIGHT_RECEIVE, -1);
+
+    if (_portSet != MACH_PORT_NULL)
+        mach_port_mod_refs(mach_task_self(), _portSet, MACH_PORT_RIGHT_PORT_SET, -1);
+
+    [super dealloc];
+}
+
+/**
+ * Handle a registration @a request, sending the reply to the request's reply port.
+ */
+- (void) handleRegistration: (plcrash_helper_register_request_t *) request {
+    plcrash_helper_register_reply_t reply;
+    PLCrashMachExceptionPort *port = nil;
+    NSError *error = nil;
+    kern_return_t kr;
+
+    memset(&reply, 0, sizeof(reply));
+    reply.result = KERN_FAILURE;
+
+    if (request->version != PLCRASH_HELPER_PROTOCOL_VERSION) {
+        NSLog(@"Unsupported helper protocol version %" PRIu32, request->version);
+        reply.result = KERN_INVALID_ARGUMENT;
+    } else {
+        mach_port_t task = request->task.name;
+        PLCrashHelperClient *client = [[[PLCrashHelperClient alloc] initWithRequest: request error: &error] autorelease];
+        if (client != nil)
+            port = [client exceptionPortWithError: &error];
+
+        if (port != nil) {
+            /* Release the client once its task terminates. Any previous registration for the task is replaced. */
+            mach_port_t previous = MACH_PORT_NULL;
+            kr = mach_port_request_notification(mach_task_self(), task, MACH_NOTIFY_DEAD_NAME, 0, _notifyPort, MACH_MSG_TYPE_MAKE_SEND_ONCE, &previous);
+            if (kr == KERN_SUCCESS) {
+                if (MACH_PORT_VALID(previous))
+                    mach_port_deallocate(mach_task_self(), previous);
+
+                [_clients setObject: client forKey: [NSNumber numberWithUnsignedInt: task]];
+
+                reply.exception_port.name = port.server_port;
+                reply.behavior = port.behavior;
+                reply.flavor = port.flavor;
+                reply.result = KERN_SUCCESS;
+            } else {
+                NSLog(@"Failed to request the client task's dead-name notification: %d", kr);
+                reply.result = kr;
+            }
+        } else {
+            NSLog(@"Failed to register helper client: %@", error);
+        }
+    }
+
+    /* Send the reply; the exception port's send right is copied, and remains owned by the port instance */
+    reply.header.msgh_bits = MACH_MSGH_BITS_COMPLEX | MACH_MSGH_BITS(MACH_MSGH_BITS_REMOTE(request->header.msgh_bits), 0);
+    reply.header.msgh_remote_port = request->header.msgh_remote_port;
+    reply.header.msgh_local_port = MACH_PORT_NULL;
+    reply.header.msgh_size = sizeof(reply);
+    reply.header.msgh_id = PLCRASH_HELPER_REGISTER_REPLY_MSGH_ID;
+    reply.body.msgh_descriptor_count = 1;
+    reply.exception_port.disposition = MACH_MSG_TYPE_COPY_SEND;
+    reply.exception_port.type = MACH_MSG_PORT_DESCRIPTOR;
+
+    kr = mach_msg(&reply.header, MACH_SEND_MSG|MACH_SEND_TIMEOUT, reply.header.msgh_size, 0, MACH_PORT_NULL, PLCRASH_HELPER_REGISTER_TIMEOUT_MS, MACH_PORT_NULL);
+    if (kr != MACH_MSG_SUCCESS) {
+        NSLog(@"Failed to reply to helper client registration: %d", kr);
+        mach_msg_destroy(&reply.header);
+    }
+
+    /* Release any rights not claimed by a client */
+    request->header.msgh_remote_port = MACH_PORT_NULL;
+    mach_msg_destroy(&request->header);
+}
+
+/**
+ * Run the helper server, handling client registrations and terminations. This method does not return.
+ */
+- (void) run {
+    plcrash_helper_message_t *message = malloc(sizeof(*message));
+    kern_return_t kr;
+
+    while (true) {
+        NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+
+        memset(message, 0, sizeof(*message));
+        kr = mach_msg(&message->header, MACH_RCV_MSG|MACH_RCV_LARGE, 0, sizeof(*message), _portSet, MACH_MSG_TIMEOUT_NONE, MACH_PORT_NULL);
+        if (kr == MACH_RCV_TOO_LARGE) {
+            /* Not a message we handle; receive and discard it */
+            mach_msg_size_t size = message->header.msgh_size + MAX_TRAILER_SIZE;
+            mach_msg_header_t *discard = malloc(size);
+            if (discard != NULL && mach_msg(discard, MACH_RCV_MSG, 0, size, _portSet, MACH_MSG_TIMEOUT_NONE, MACH_PORT_NULL) == MACH_MSG_SUCCESS)
+                mach_msg_destroy(discard);
+            free(discard);
+        } else if (kr != MACH_MSG_SUCCESS) {
+            NSLog(@"Unexpected error receiving helper message: %d", kr);
+        } else if (message->header.msgh_local_port == _notifyPort && message->header.msgh_id == MACH_NOTIFY_DEAD_NAME) {
+            /* A client task has terminated. The notification holds an additional reference to the dead name. */
+            mach_port_t task = message->dead_name.notification.not_port;
+            [_clients removeObjectForKey: [NSNumber numberWithUnsignedInt: task]];
+            mach_port_deallocate(mach_task_self(), task);
+        } else if (message->header.msgh_local_port == _servicePort &&
+                   message->header.msgh_id == PLCRASH_HELPER_REGISTER_MSGH_ID &&
+                   (message->header.msgh_bits & MACH_MSGH_BITS_COMPLEX) != 0 &&
+                   message->header.msgh_size == sizeof(plcrash_helper_register_request_t) &&
+                   message->registration.request.body.msgh_descriptor_count == 1 &&
+                   message->registration.request.task.type == MACH_MSG_PORT_DESCRIPTOR &&
+                   MACH_PORT_VALID(message->header.msgh_remote_port))
+        {
+            [self handleRegistration: &message->registration.request];
+        } else {
+            mach_msg_destroy(&message->header);
+        }
+
+        [pool drain];
+    }
+}
+
+/**
+ * Register the current task with the helper serving the bootstrap service @a serviceName, returning the exception
+ * port to which the current task's crashes should be delivered. The returned port must be registered by the caller,
+ * eg, via PLCrashMachExceptionPort::registerForTask:previousPortSet:error:.
+ *
+ * @param serviceName The helper's bootstrap service name.
+ * @param reportPath The path to which the helper should write the crash report.
+ * @param applicationIdentifier The application identifier to be included in the crash report.
+ * @param applicationVersion The application version to be included in the crash report.
+ * @param applicationMarketingVersion The application marketing version to be included in the crash report, or nil.
+ * @param symbolStrategy The symbolication strategy to be used by the helper.
+ * @param mask The exception mask for which the returned port will be registered.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error
+ * object indicating why the task could not be registered. You may specify nil for this parameter.
+ *
+ * @return Returns the exception port on success, or nil on failure.
+ */
++ (PLCrashMachExceptionPort *) registerWithServiceName: (NSString *) serviceName
+                                            reportPath: (NSString *) reportPath
+                                 applicationIdentifier: (NSString *) applicationIdentifier
+                                    applicationVersion: (NSString *) applicationVersion
+                           applicationMarketingVersion: (NSString *) applicationMarketingVersion
+                                        symbolStrategy: (plcrash_async_symbol_strategy_t) symbolStrategy
+                                                  mask: (exception_mask_t) mask
+                                                 error: (NSError **) outError
+{
+    union {
+        plcrash_helper_register_request_t request;
+        struct {
+            plcrash_helper_register_reply_t reply;
+            mach_msg_max_trailer_t trailer;
+        } reply;
+    } *message;
+    mach_port_t service = MACH_PORT_NULL;
+    mach_port_t reply_port = MACH_PORT_NULL;
+    PLCrashMachExceptionPort *result = nil;
+    kern_return_t kr;
+
+    message = calloc(1, sizeof(*message));
+    if (message == NULL) {
+        plcrash_populate_posix_error(outError, ENOMEM, @"Could not allocate the helper registration message");
+        return nil;
+    }
+
+    /* Populate the request */
+    plcrash_helper_register_request_t *request = &message->request;
+    if (!plcrash_helper_copy_string(request->report_path, sizeof(request->report_path), reportPath) ||
+        !plcrash_helper_copy_string(request->app_identifier, sizeof(request->app_identifier), applicationIdentifier) ||
+        !plcrash_helper_copy_string(request->app_version, sizeof(request->app_version), applicationVersion) ||
+        !plcrash_helper_copy_string(request->app_marketing_version, sizeof(request->app_marketing_version), applicationMarketingVersion))
+    {
+        plcrash_populate_posix_error(outError, ENAMETOOLONG, @"The helper registration values are too long");
+        goto cleanup;
+    }
+
+    /* Look up the helper */
+    if ((kr = bootstrap_look_up(bootstrap_port, [serviceName UTF8String], &service)) != KERN_SUCCESS) {
+        plcrash_populate_mach_error(outError, kr, @"Could not look up the crash reporting helper's bootstrap service");
+        goto cleanup;
+    }
+
+    if ((kr = mach_port_allocate(mach_task_self(), MACH_PORT_RIGHT_RECEIVE, &reply_port)) != KERN_SUCCESS) {
+        plcrash_populate_mach_error(outError, kr, @"Could not allocate the helper registration reply port");
+        goto cleanup;
+    }
+
+    request->header.msgh_bits = MACH_MSGH_BITS_COMPLEX | MACH_MSGH_BITS(MACH_MSG_TYPE_COPY_SEND, MACH_MSG_TYPE_MAKE_SEND_ONCE);
+    request->header.msgh_remote_port = service;
+    request->header.msgh_local_port = reply_port;
+    request->header.msgh_size = sizeof(*request);
+    request->header.msgh_id = PLCRASH_HELPER_REGISTER_MSGH_ID;
+    request->body.msgh_descriptor_count = 1;
+    request->task.name = mach_task_self();
+    request->task.disposition = MACH_MSG_TYPE_COPY_SEND;
+    request->task.type = MACH_MSG_PORT_DESCRIPTOR;
+    request->version = PLCRASH_HELPER_PROTOCOL_VERSION;
+    request->symbol_strategy = symbolStrategy;
+
+    /* Send the request and wait for the reply */
+    kr = mach_msg(&request->header,
+                  MACH_SEND_MSG|MACH_RCV_MSG|MACH_SEND_TIMEOUT|MACH_RCV_TIMEOUT,
+                  request->header.msgh_size,
+                  sizeof(message->reply),
+                  reply_port,
+                  PLCRASH_HELPER_REGISTER_TIMEOUT_MS,
+                  MACH_PORT_NULL);
+    if (kr != MACH_MSG_SUCCESS) {
+        plcrash_populate_mach_error(outError, kr, @"The crash reporting helper did not reply to the registration request");
+        goto cleanup;
+    }
+
+    plcrash_helper_register_reply_t *reply = &message->reply.reply;
+    if (reply->header.msgh_id != PLCRASH_HELPER_REGISTER_REPLY_MSGH_ID ||
+        (reply->header.msgh_bits & MACH_MSGH_BITS_COMPLEX) == 0 ||
+        reply->header.msgh_size != sizeof(*reply) ||
+        reply->body.msgh_descriptor_count != 1 ||
+        reply->exception_port.type != MACH_MSG_PORT_DESCRIPTOR)
+    {
+        plcrash_populate_mach_error(outError, MIG_BAD_ARGUMENTS, @"Received an invalid reply from the crash reporting helper");
+        mach_msg_destroy(&reply->header);
+        goto cleanup;
+    }
+
+    if (reply->result != KERN_SUCCESS || !MACH_PORT_VALID(reply->exception_port.name)) {
+        plcrash_populate_mach_error(outError, reply->result, @"The crash reporting helper rejected the registration request");
+        mach_msg_destroy(&reply->header);
+        goto cleanup;
+    }
+
+    /* The port instance retains its own send right */
+    result = [[[PLCrashMachExceptionPort alloc] initWithServerPort: reply->exception_port.name
+                                                              mask: mask
+                                                          behavior: reply->behavior
+                                                            flavor: reply->flavor] autorelease];
+    mach_port_deallocate(mach_task_self(), reply->exception_port.name);
+
+cleanup:
+    if (MACH_PORT_VALID(service))
+        mach_port_deallocate(mach_task_self(), service);
+
+    if (MACH_PORT_VALID(reply_port))
+        mach_port_mod_refs(mach_task_self(), reply_port, MACH_PORT_RIGHT_RECEIVE, -1);
+
+    free(message);
+    return result;
+}
+
+@end
+
+#endif /* PLCRASH_FEATURE_OUT_OF_PROCESS_HELPER */
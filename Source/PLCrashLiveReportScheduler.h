@@ -0,0 +1,88 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/**
+ * @internal
+ *
+ * Block invoked by PLCrashLiveReportScheduler to capture a single live report. Returns the encoded report, or nil
+ * on failure, in which case @a outError should be populated.
+ */
+typedef NSData *(^PLCrashLiveReportCaptureBlock)(NSError **outError);
+
+/**
+ * @internal
+ *
+ * Block invoked with the result of a scheduled live report. On failure, @a reportData is nil, and @a error describes
+ * the failure.
+ */
+typedef void (^PLCrashLiveReportHandler)(NSData *reportData, NSError *error);
+
+@interface PLCrashLiveReportScheduler : NSObject {
+@private
+    /** The capture block. */
+    PLCrashLiveReportCaptureBlock _captureBlock;
+
+    /** The minimum interval between the start of consecutive captures, in seconds. */
+    NSTimeInterval _minimumInterval;
+
+    /** Serial queue on which captures are performed. */
+    dispatch_queue_t _queue;
+
+    /** Lock guarding the scheduling state below. */
+    NSLock *_lock;
+
+    /** The handlers waiting on the next capture. Guarded by @a _lock. */
+    NSMutableArray *_pendingHandlers;
+
+    /** If YES, a capture has been scheduled for @a _pendingHandlers. Guarded by @a _lock. */
+    BOOL _scheduled;
+
+    /** The time at which the most recent capture started, or 0 if no capture has been performed. Guarded by
+     * @a _lock. */
+    CFAbsoluteTime _lastCaptureTime;
+
+    /** The number of captures performed. Guarded by @a _lock. */
+    NSUInteger _captureCount;
+
+    /** If YES, the scheduler has been invalidated, and no further captures will be performed. Guarded by
+     * @a _lock. */
+    BOOL _invalidated;
+}
+
+- (instancetype) initWithMinimumInterval: (NSTimeInterval) minimumInterval captureBlock: (PLCrashLiveReportCaptureBlock) captureBlock;
+
+- (void) scheduleReportWithHandler: (PLCrashLiveReportHandler) handler;
+
+- (void) invalidate;
+
+/** The number of captures performed. */
+@property(nonatomic, readonly) NSUInteger captureCount;
+
+@end
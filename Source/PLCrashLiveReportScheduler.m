@@ -0,0 +1,220 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashLiveReportScheduler.h"
+#import "PLCrashReporterNSError.h"
+
+/** Queue-specific key used to identify the scheduler's capture queue. */
+static char PLCrashLiveReportQueueKey;
+
+/**
+ * @internal
+ *
+ * Coalesces concurrent live report requests into a single capture.
+ *
+ * Capturing a live report suspends all other threads, and writing the report is serialized on the shared writer; if
+ * several subsystems (eg, a hang detector and a user-triggered diagnostics action) each captured their own report,
+ * they would suspend one another in turn. Instead, every request that arrives before a scheduled capture starts
+ * shares that capture, and receives the same report data.
+ *
+ * Captures are additionally rate limited: a capture never starts sooner than the configured minimum interval after
+ * the start of the previous capture. Requests arriving within the interval are deferred and coalesced into the next
+ * capture, bounding the cost of a storm of requests to one capture per interval.
+ *
+ * Captures are performed on the scheduler's serial queue, and the handlers are invoked on a global concurrent queue,
+ * so that the handlers of one capture can not delay the next.
+ *
+ * The capture block is not expected to retain its owner; the owner must call -invalidate before it is deallocated,
+ * after which no further captures will be started, and any capture in progress will have completed.
+ */
+@implementation PLCrashLiveReportScheduler
+
+@synthesize captureCount = _captureCount;
+
+/**
+ * Initialize a new scheduler.
+ *
+ * @param minimumInterval The minimum interval between the start of consecutive captures, in seconds, or 0 to only
+ * coalesce requests that arrive before a pending capture has started.
+ * @param captureBlock The block to be invoked to capture each live report. The block is invoked on the scheduler's
+ * serial queue.
+ */
+- (instancetype) initWithMinimumInterval: (NSTimeInterval) minimumInterval captureBlock: (PLCrashLiveReportCaptureBlock) captureBlock {
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _captureBlock = [captureBlock copy];
+    _minimumInterval = MAX(minimumInterval, 0.0);
+    _queue = dispatch_queue_create("com.plausiblelabs.crashreporter.live-report", DISPATCH_QUEUE_SERIAL);
+    dispatch_queue_set_specific(_queue, &PLCrashLiveReportQueueKey, &PLCrashLiveReportQueueKey, NULL);
+    _lock = [[NSLock alloc] init];
+    _pendingHandlers = [[NSMutableArray alloc] init];
+
+    return self;
+}
+
+- (void) dealloc {
+    [_captureBlock release];
+    dispatch_release(_queue);
+    [_lock release];
+    [_pendingHandlers release];
+    [super dealloc];
+}
+
+/**
+ * Request a live report. If a capture has already been scheduled and has not yet started, the request joins it;
+ * otherwise, a new capture is scheduled, no sooner than the minimum interval after the start of the previous
+ * capture.
+ *
+ * @param handler The block to be invoked with the captured report data, or the error that occurred. The block is
+ * invoked on a global concurrent queue, and the report data is shared by all requests coalesced into the capture.
+ * If the scheduler has been invalidated, the block is invoked with an error.
+ */
+- (void) scheduleReportWithHandler: (PLCrashLiveReportHandler) handler {
+    PLCrashLiveReportHandler handlerCopy = [handler copy];
+
+    [_lock lock];
+    if (_invalidated) {
+        [_lock unlock];
+        [self cancelHandlers: [NSArray arrayWithObject: handlerCopy]];
+        [handlerCopy release];
+        return;
+    }
+
+    [_pendingHandlers addObject: handlerCopy];
+    [handlerCopy release];
+
+    /* Join the pending capture, if any */
+    if (_scheduled) {
+        [_lock unlock];
+        return;
+    }
+    _scheduled = YES;
+
+    NSTimeInterval delay = 0;
+    if (_lastCaptureTime != 0)
+        delay = MAX(_lastCaptureTime + _minimumInterval - CFAbsoluteTimeGetCurrent(), 0.0);
+    [_lock unlock];
+
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t) (delay * NSEC_PER_SEC)), _queue, ^{
+        [self performCapture];
+    });
+}
+
+/**
+ * @internal
+ *
+ * Capture a single report on behalf of all pending requests, and dispatch the result to their handlers. Requests
+ * arriving once the capture has started are deferred to the next capture.
+ */
+- (void) performCapture {
+    [_lock lock];
+
+    /* Pending handlers were cancelled on invalidation */
+    if (_invalidated) {
+        [_lock unlock];
+        return;
+    }
+
+    NSArray *handlers = [_pendingHandlers copy];
+    [_pendingHandlers removeAllObjects];
+    _scheduled = NO;
+    _lastCaptureTime = CFAbsoluteTimeGetCurrent();
+    _captureCount++;
+    [_lock unlock];
+
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    NSError *error = nil;
+    NSData *data = [_captureBlock(&error) retain];
+    if (data == nil)
+        [error retain];
+    [pool drain];
+
+    /* The blocks retain the shared report data and error */
+    dispatch_queue_t handlerQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    for (PLCrashLiveReportHandler handler in handlers) {
+        dispatch_async(handlerQueue, ^{
+            handler(data, data != nil ? nil : error);
+        });
+    }
+
+    [data release];
+    if (data == nil)
+        [error release];
+    [handlers release];
+}
+
+/**
+ * Invalidate the scheduler. Pending requests are failed, and requests made after invalidation fail immediately. On
+ * return, any capture in progress has completed, and the capture block will not be invoked again.
+ *
+ * This must be called by the owner of the capture block before the state referenced by the block is deallocated. It
+ * must not be called from within the capture block.
+ */
+- (void) invalidate {
+    [_lock lock];
+    if (_invalidated) {
+        [_lock unlock];
+        return;
+    }
+    _invalidated = YES;
+
+    NSArray *handlers = [_pendingHandlers copy];
+    [_pendingHandlers removeAllObjects];
+    _scheduled = NO;
+    [_lock unlock];
+
+    [self cancelHandlers: handlers];
+    [handlers release];
+
+    /* Wait for any capture in progress; captures scheduled after this point will observe the invalidation */
+    if (dispatch_get_specific(&PLCrashLiveReportQueueKey) == NULL)
+        dispatch_sync(_queue, ^{});
+}
+
+/**
+ * @internal
+ *
+ * Fail all @a handlers with a cancellation error.
+ */
+- (void) cancelHandlers: (NSArray *) handlers {
+    if ([handlers count] == 0)
+        return;
+
+    NSError *error = nil;
+    plcrash_populate_error(&error, PLCrashReporterErrorUnknown, @"The live report request was cancelled", nil);
+
+    dispatch_queue_t handlerQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    for (PLCrashLiveReportHandler handler in handlers) {
+        dispatch_async(handlerQueue, ^{
+            handler(nil, error);
+        });
+    }
+}
+
+@end
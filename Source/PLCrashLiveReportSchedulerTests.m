@@ -0,0 +1,234 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "SenTestCompat.h"
+
+#import "PLCrashLiveReportScheduler.h"
+#import "PLCrashReporterNSError.h"
+
+@interface PLCrashLiveReportSchedulerTests : SenTestCase @end
+
+@implementation PLCrashLiveReportSchedulerTests
+
+/* Wait up to 5 seconds for @a semaphore to be signaled */
+static BOOL wait_semaphore (dispatch_semaphore_t semaphore) {
+    return dispatch_semaphore_wait(semaphore, dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC)) == 0;
+}
+
+/**
+ * Requests that arrive while a capture is in progress must be coalesced into a single subsequent capture, and share
+ * its report data.
+ */
+- (void) testCoalescesPendingRequests {
+    dispatch_semaphore_t started = dispatch_semaphore_create(0);
+    dispatch_semaphore_t gate = dispatch_semaphore_create(0);
+    dispatch_semaphore_t done = dispatch_semaphore_create(0);
+    __block NSUInteger captures = 0;
+
+    PLCrashLiveReportScheduler *scheduler = [[PLCrashLiveReportScheduler alloc] initWithMinimumInterval: 0 captureBlock: ^NSData *(NSError **outError) {
+        NSUInteger n = ++captures;
+
+        /* Hold the first capture until the remaining requests have been made */
+        if (n == 1) {
+            dispatch_semaphore_signal(started);
+            dispatch_semaphore_wait(gate, DISPATCH_TIME_FOREVER);
+        }
+        return [NSData dataWithBytes: &n length: sizeof(n)];
+    }];
+
+    /* Each handler stores to its own entry */
+    NSData *resultStorage[4] = { nil, nil, nil, nil };
+    NSData **results = resultStorage;
+    for (NSUInteger i = 0; i < 4; i++) {
+        [scheduler scheduleReportWithHandler: ^(NSData *reportData, NSError *error) {
+            results[i] = [reportData retain];
+            dispatch_semaphore_signal(done);
+        }];
+
+        /* Wait for the first capture to start before making the remaining requests */
+        if (i == 0)
+            STAssertTrue(wait_semaphore(started), @"The first capture did not start");
+    }
+    dispatch_semaphore_signal(gate);
+
+    for (NSUInteger i = 0; i < 4; i++)
+        STAssertTrue(wait_semaphore(done), @"A handler was not invoked");
+
+    STAssertEquals((NSUInteger) 2, captures, @"The pending requests were not coalesced");
+    STAssertEquals((NSUInteger) 2, scheduler.captureCount, @"Incorrect capture count");
+
+    NSUInteger n;
+    [results[0] getBytes: &n length: sizeof(n)];
+    STAssertEquals((NSUInteger) 1, n, @"The first request was not served by the first capture");
+    for (NSUInteger i = 1; i < 4; i++) {
+        STAssertTrue(results[i] == results[1], @"The coalesced requests did not share the report data");
+        [results[i] getBytes: &n length: sizeof(n)];
+        STAssertEquals((NSUInteger) 2, n, @"A coalesced request was not served by the second capture");
+    }
+
+    for (NSUInteger i = 0; i < 4; i++)
+        [results[i] release];
+    [scheduler release];
+    dispatch_release(started);
+    dispatch_release(gate);
+    dispatch_release(done);
+}
+
+/**
+ * Consecutive captures must be separated by at least the minimum interval.
+ */
+- (void) testRateLimit {
+    dispatch_semaphore_t done = dispatch_semaphore_create(0);
+    CFAbsoluteTime timeStorage[2] = { 0, 0 };
+    CFAbsoluteTime *times = timeStorage;
+    __block NSUInteger captures = 0;
+
+    PLCrashLiveReportScheduler *scheduler = [[PLCrashLiveReportScheduler alloc] initWithMinimumInterval: 0.2 captureBlock: ^NSData *(NSError **outError) {
+        if (captures < 2)
+            times[captures] = CFAbsoluteTimeGetCurrent();
+        captures++;
+        return [NSData data];
+    }];
+
+    for (NSUInteger i = 0; i < 2; i++) {
+        [scheduler scheduleReportWithHandler: ^(NSData *reportData, NSError *error) {
+            dispatch_semaphore_signal(done);
+        }];
+        STAssertTrue(wait_semaphore(done), @"A handler was not invoked");
+    }
+
+    STAssertEquals((NSUInteger) 2, captures, @"Incorrect capture count");
+    STAssertTrue(times[1] - times[0] >= 0.19, @"The second capture was not rate limited: %f", times[1] - times[0]);
+
+    [scheduler release];
+    dispatch_release(done);
+}
+
+/**
+ * A capture failure must be provided to all coalesced requests.
+ */
+- (void) testCaptureFailure {
+    dispatch_semaphore_t done = dispatch_semaphore_create(0);
+    __block NSError *result = nil;
+
+    PLCrashLiveReportScheduler *scheduler = [[PLCrashLiveReportScheduler alloc] initWithMinimumInterval: 0 captureBlock: ^NSData *(NSError **outError) {
+        plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Capture failed", nil);
+        return nil;
+    }];
+
+    [scheduler scheduleReportWithHandler: ^(NSData *reportData, NSError *error) {
+        STAssertNil(reportData, @"Report data was provided for a failed capture");
+        result = [error retain];
+        dispatch_semaphore_signal(done);
+    }];
+    STAssertTrue(wait_semaphore(done), @"The handler was not invoked");
+
+    STAssertNotNil(result, @"No error was provided");
+    STAssertEquals((NSInteger) PLCrashReporterErrorUnknown, [result code], @"Incorrect error code");
+
+    [result release];
+    [scheduler release];
+    dispatch_release(done);
+}
+
+/**
+ * Invalidation must cancel a pending capture, fail its handlers, and fail any later requests without invoking the
+ * capture block.
+ */
+- (void) testInvalidateCancelsPendingCapture {
+    dispatch_semaphore_t done = dispatch_semaphore_create(0);
+    __block NSUInteger captures = 0;
+    __block NSError *pendingError = nil;
+    __block NSError *lateError = nil;
+
+    /* Use a long interval so that the second capture is still pending on invalidation */
+    PLCrashLiveReportScheduler *scheduler = [[PLCrashLiveReportScheduler alloc] initWithMinimumInterval: 60 captureBlock: ^NSData *(NSError **outError) {
+        captures++;
+        return [NSData data];
+    }];
+
+    [scheduler scheduleReportWithHandler: ^(NSData *reportData, NSError *error) {
+        dispatch_semaphore_signal(done);
+    }];
+    STAssertTrue(wait_semaphore(done), @"The first handler was not invoked");
+
+    [scheduler scheduleReportWithHandler: ^(NSData *reportData, NSError *error) {
+        STAssertNil(reportData, @"Report data was provided for a cancelled capture");
+        pendingError = [error retain];
+        dispatch_semaphore_signal(done);
+    }];
+    [scheduler invalidate];
+    STAssertTrue(wait_semaphore(done), @"The pending handler was not invoked");
+
+    [scheduler scheduleReportWithHandler: ^(NSData *reportData, NSError *error) {
+        STAssertNil(reportData, @"Report data was provided after invalidation");
+        lateError = [error retain];
+        dispatch_semaphore_signal(done);
+    }];
+    STAssertTrue(wait_semaphore(done), @"The late handler was not invoked");
+
+    STAssertEquals((NSUInteger) 1, captures, @"A capture was performed after invalidation");
+    STAssertNotNil(pendingError, @"No error was provided to the pending request");
+    STAssertNotNil(lateError, @"No error was provided to the late request");
+
+    [pendingError release];
+    [lateError release];
+    [scheduler release];
+    dispatch_release(done);
+}
+
+/**
+ * Invalidation must wait for a capture in progress to complete.
+ */
+- (void) testInvalidateWaitsForCapture {
+    dispatch_semaphore_t started = dispatch_semaphore_create(0);
+    dispatch_semaphore_t done = dispatch_semaphore_create(0);
+    __block BOOL finished = NO;
+
+    PLCrashLiveReportScheduler *scheduler = [[PLCrashLiveReportScheduler alloc] initWithMinimumInterval: 0 captureBlock: ^NSData *(NSError **outError) {
+        dispatch_semaphore_signal(started);
+        usleep(100 * 1000);
+        finished = YES;
+        return [NSData data];
+    }];
+
+    [scheduler scheduleReportWithHandler: ^(NSData *reportData, NSError *error) {
+        dispatch_semaphore_signal(done);
+    }];
+    STAssertTrue(wait_semaphore(started), @"The capture did not start");
+
+    [scheduler invalidate];
+    STAssertTrue(finished, @"Invalidation returned before the capture in progress completed");
+    STAssertTrue(wait_semaphore(done), @"The handler was not invoked");
+
+    [scheduler release];
+    dispatch_release(started);
+    dispatch_release(done);
+}
+
+@end
@@ -0,0 +1,60 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "PLCrashLogWriter.h"
+#import "PLCrashReporterConfig.h"
+
+@interface PLCrashLiveReportSession : NSObject {
+@private
+    /** The backing writer. Guarded by @a _lock. */
+    plcrash_log_writer_t _writer;
+
+    /** Lock serializing use of @a _writer. */
+    NSLock *_lock;
+
+    /** The incremental report baseline, or NULL if incremental reports are disabled. Guarded by @a _lock. */
+    plcrash_log_writer_baseline_t *_baseline;
+}
+
+- (instancetype) initWithApplicationIdentifier: (NSString *) applicationIdentifier
+                                    appVersion: (NSString *) applicationVersion
+                           appMarketingVersion: (NSString *) applicationMarketingVersion
+                                symbolStrategy: (plcrash_async_symbol_strategy_t) symbolStrategy
+                                 configuration: (PLCrashReporterConfig *) config;
+
+- (plcrash_log_writer_t *) beginReport;
+- (void) endReport;
+
+- (BOOL) setTargetTask: (task_t) task;
+- (void) setStackSampler: (plcrash_stack_sampler_t *) sampler;
+- (void) setKeyValueArea: (const void *) keyValueArea length: (size_t) keyValueAreaLength breadcrumbs: (const void *) breadcrumbs length: (size_t) breadcrumbsLength;
+- (void) resetBaseline;
+
+@end
@@ -0,0 +1,211 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashLiveReportSession.h"
+
+/**
+ * @internal
+ *
+ * Map the configuration's thread metadata options to the writer's thread metadata flags.
+ */
+static uint32_t plcrash_live_report_thread_metadata (PLCrashReporterThreadMetadata metadata) {
+    uint32_t result = 0;
+
+    if (metadata & PLCrashReporterThreadMetadataName)
+        result |= PLCRASH_LOG_WRITER_THREAD_METADATA_NAME;
+
+    if (metadata & PLCrashReporterThreadMetadataDispatchQueue)
+        result |= PLCRASH_LOG_WRITER_THREAD_METADATA_DISPATCH_QUEUE;
+
+    if (metadata & PLCrashReporterThreadMetadataQoS)
+        result |= PLCRASH_LOG_WRITER_THREAD_METADATA_QOS;
+
+    if (metadata & PLCrashReporterThreadMetadataCPUTime)
+        result |= PLCRASH_LOG_WRITER_THREAD_METADATA_CPU_TIME;
+
+    return result;
+}
+
+/**
+ * @internal
+ *
+ * A persistent live report writer. The writer's environment data, pre-encoded static report sections, and
+ * symbol cache are initialized once, and are shared by all live reports written through the session.
+ */
+@implementation PLCrashLiveReportSession
+
+/**
+ * Initialize a new live report session.
+ *
+ * @param applicationIdentifier The application identifier to be included in written reports.
+ * @param applicationVersion The application version to be included in written reports.
+ * @param applicationMarketingVersion The application marketing version to be included in written reports, or nil.
+ * @param symbolStrategy The symbolication strategy to be used by the writer.
+ * @param config The reporter configuration from which the writer's report options are derived.
+ *
+ * @return Returns the initialized session, or nil if the writer could not be initialized.
+ */
+- (instancetype) initWithApplicationIdentifier: (NSString *) applicationIdentifier
+                                    appVersion: (NSString *) applicationVersion
+                           appMarketingVersion: (NSString *) applicationMarketingVersion
+                                symbolStrategy: (plcrash_async_symbol_strategy_t) symbolStrategy
+                                 configuration: (PLCrashReporterConfig *) config
+{
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _lock = [[NSLock alloc] init];
+
+    if (plcrash_log_writer_init(&_writer, applicationIdentifier, applicationVersion, applicationMarketingVersion, symbolStrategy, true) != PLCRASH_ESUCCESS) {
+        plcrash_log_writer_free(&_writer);
+        [_lock release];
+        _lock = nil;
+
+        [self release];
+        return nil;
+    }
+
+    if (config.shouldUseSymbolNameTable)
+        plcrash_log_writer_enable_symbol_names(&_writer);
+    if (config.shouldWriteReferencedImagesOnly)
+        plcrash_log_writer_set_referenced_images_only(&_writer, true);
+    if (config.shouldSnapshotLiveReportThreads)
+        plcrash_log_writer_set_snapshot_threads(&_writer, true);
+    if (config.shouldWriteRegistersForAllThreads)
+        plcrash_log_writer_set_all_thread_registers(&_writer, true);
+    if (config.threadMetadata != PLCrashReporterThreadMetadataNone)
+        plcrash_log_writer_set_thread_metadata(&_writer, plcrash_live_report_thread_metadata(config.threadMetadata));
+    if (config.shouldCaptureMemoryStatistics)
+        plcrash_log_writer_set_memory_statistics(&_writer, true);
+
+    /* Failure to allocate the baseline is non-fatal; all reports will be written in full. */
+    if (config.shouldWriteIncrementalLiveReports) {
+        _baseline = malloc(sizeof(*_baseline));
+        if (_baseline != NULL) {
+            plcrash_log_writer_baseline_reset(_baseline);
+            plcrash_log_writer_set_baseline(&_writer, _baseline);
+        }
+    }
+
+    /* Failure to allocate the persistent cache is non-fatal; each report will fall back to a per-report cache. */
+    plcrash_log_writer_enable_persistent_symbol_cache(&_writer);
+
+    return self;
+}
+
+- (void) dealloc {
+    if (_lock != nil) {
+        plcrash_log_writer_free(&_writer);
+        [_lock release];
+    }
+
+    if (_baseline != NULL)
+        free(_baseline);
+
+    [super dealloc];
+}
+
+/**
+ * Acquire the session's writer for a single report. The caller must call -endReport once the report has been
+ * written; concurrent callers will block until the writer is released.
+ *
+ * @return Returns the writer, prepared for a new report.
+ */
+- (plcrash_log_writer_t *) beginReport {
+    [_lock lock];
+    plcrash_log_writer_reset(&_writer);
+    return &_writer;
+}
+
+/**
+ * Release the writer acquired via -beginReport.
+ */
+- (void) endReport {
+    plcrash_log_writer_close(&_writer);
+    [_lock unlock];
+}
+
+/**
+ * Target the task for which all subsequent reports are written. By default, reports are written for the current task.
+ *
+ * The task's stacks are walked from outside of the task, and will be walked in parallel.
+ *
+ * @param task The target task. The task must share the current task's pointer width.
+ *
+ * @return Returns YES on success, or NO if the task's process information could not be fetched.
+ */
+- (BOOL) setTargetTask: (task_t) task {
+    plcrash_error_t err;
+
+    [_lock lock];
+    if ((err = plcrash_log_writer_nasync_set_target_task(&_writer, task)) == PLCRASH_ESUCCESS)
+        plcrash_log_writer_nasync_set_unwind_workers(&_writer, (uint32_t) [[NSProcessInfo processInfo] activeProcessorCount]);
+    [_lock unlock];
+
+    return err == PLCRASH_ESUCCESS;
+}
+
+/**
+ * Set the stack sampler whose samples will be included in all subsequent reports. This blocks until any report
+ * that is currently being written has completed, after which a previously set sampler may be safely freed.
+ *
+ * @param sampler The sampler, or NULL to stop including stack samples.
+ */
+- (void) setStackSampler: (plcrash_stack_sampler_t *) sampler {
+    [_lock lock];
+    plcrash_log_writer_set_stack_sampler(&_writer, sampler);
+    [_lock unlock];
+}
+
+/**
+ * Set the application-supplied memory regions to be copied verbatim to all subsequent reports. This blocks until
+ * any report in progress has been written.
+ *
+ * @param keyValueArea The key/value area, or NULL if none.
+ * @param keyValueAreaLength The length of @a keyValueArea, in bytes.
+ * @param breadcrumbs The breadcrumb buffer, or NULL if none.
+ * @param breadcrumbsLength The length of @a breadcrumbs, in bytes.
+ */
+- (void) setKeyValueArea: (const void *) keyValueArea length: (size_t) keyValueAreaLength breadcrumbs: (const void *) breadcrumbs length: (size_t) breadcrumbsLength {
+    [_lock lock];
+    plcrash_log_writer_set_custom_data(&_writer, keyValueArea, keyValueAreaLength, breadcrumbs, breadcrumbsLength);
+    [_lock unlock];
+}
+
+/**
+ * Discard the base report of incremental live reports. The next report will be written in full, and will become
+ * the base report of all subsequent reports. This has no effect if incremental reports are disabled.
+ */
+- (void) resetBaseline {
+    [_lock lock];
+    if (_baseline != NULL)
+        plcrash_log_writer_baseline_reset(_baseline);
+    [_lock unlock];
+}
+
+@end
@@ -38,7 +38,9 @@ extern "C" {
 
 #import "PLCrashAsync.h"
 #import "PLCrashAsyncImageList.h"
+#import "PLCrashAsyncLZ.h"
 #import "PLCrashFrameWalker.h"
+#import "PLCrashStackSampler.h"
     
 #import "PLCrashAsyncSymbolication.h"
 
@@ -55,6 +57,575 @@ extern "C" {
  * @{
  */
 
+/**
+ * @internal
+ * Maximum number of frames that will be captured (and written to the crash report) for a single thread. Used as a
+ * safety measure to avoid overrunning our output limit when writing a crash report triggered by frame recursion.
+ */
+#define PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES 512 // matches Apple's crash reporting on Snow Leopard
+
+/**
+ * @internal
+ * Maximum number of registers that will be captured for the crashed thread. This must be equal to or greater than
+ * the register count of all supported architectures.
+ */
+#define PLCRASH_LOG_WRITER_MAX_THREAD_REGISTERS 64
+
+/**
+ * @internal
+ * Maximum number of bytes of stack memory, starting at the thread's stack pointer, that will be written for a single
+ * thread in raw capture mode.
+ */
+#define PLCRASH_LOG_WRITER_RAW_STACK_SIZE (32 * 1024)
+
+/**
+ * @internal
+ * Maximum total number of bytes of stack memory that will be written for all threads in raw capture mode, or when
+ * stack memory capture is enabled. Threads written once the budget has been exhausted will not include any stack
+ * memory.
+ */
+#define PLCRASH_LOG_WRITER_RAW_STACK_BUDGET (1024 * 1024)
+
+/**
+ * @internal
+ * Size of the per-thread symbol name pool, in bytes. Symbol names that do not fit within the remaining pool space
+ * will be resolved again when the frame is encoded.
+ */
+#define PLCRASH_LOG_WRITER_SYMBOL_POOL_SIZE (64 * 1024)
+
+/**
+ * @internal
+ * Maximum number of unique symbol names that may be recorded in a report's symbol name table. Symbols that do not
+ * fit within the table will be written with an inline name.
+ */
+#define PLCRASH_LOG_WRITER_MAX_SYMBOL_NAMES 4096
+
+/**
+ * @internal
+ * Maximum number of binary images, referenced by captured frames, that will be written ahead of the report's remaining
+ * images. Referenced images beyond this limit are written along with the remaining images.
+ */
+#define PLCRASH_LOG_WRITER_MAX_REFERENCED_IMAGES 256
+
+/**
+ * @internal
+ * Maximum number of threads recorded in an incremental report baseline. Threads numbered beyond this limit are
+ * always written to incremental reports.
+ */
+#define PLCRASH_LOG_WRITER_MAX_BASELINE_THREADS 512
+
+/**
+ * @internal
+ * Maximum number of binary images recorded in an incremental report baseline. Images beyond this limit are
+ * always written to incremental reports.
+ */
+#define PLCRASH_LOG_WRITER_MAX_BASELINE_IMAGES 2048
+
+/**
+ * @internal
+ * Number of the largest VM regions recorded in a report's memory statistics.
+ */
+#define PLCRASH_LOG_WRITER_MEMORY_REGION_COUNT 8
+
+/**
+ * @internal
+ * Maximum number of VM regions walked when searching for the largest regions. Each region costs a single
+ * mach_vm_region_recurse() call; the walk is bounded to keep the cost of memory statistics capture predictable.
+ */
+#define PLCRASH_LOG_WRITER_MEMORY_REGION_WALK_LIMIT 256
+
+/**
+ * @internal
+ * Magic value identifying a report summary file (see plcrash_log_summary_t).
+ */
+#define PLCRASH_LOG_SUMMARY_MAGIC 0x73636c70 /* 'plcs', little-endian */
+
+/**
+ * @internal
+ * The current version of the plcrash_log_summary_t layout.
+ */
+#define PLCRASH_LOG_SUMMARY_VERSION 2
+
+/**
+ * @internal
+ * Number of the crashed thread's top frames included in the summary's crashed thread signature.
+ */
+#define PLCRASH_LOG_SUMMARY_SIGNATURE_FRAMES 5
+
+/**
+ * @internal
+ * Size of the report-level symbol name table's string pool, in bytes.
+ */
+#define PLCRASH_LOG_WRITER_SYMBOL_NAMES_POOL_SIZE (256 * 1024)
+
+/**
+ * @internal
+ *
+ * Symbol state of a captured frame.
+ */
+typedef enum {
+    /** No symbol was found for the frame. */
+    PLCRASH_LOG_WRITER_FRAME_SYMBOL_NONE = 0,
+
+    /** The symbol was resolved and its name stored in the capture's symbol pool. */
+    PLCRASH_LOG_WRITER_FRAME_SYMBOL_CAPTURED = 1,
+
+    /** A symbol was found, but could not be stored in the symbol pool; it must be resolved again when encoded. */
+    PLCRASH_LOG_WRITER_FRAME_SYMBOL_DEFERRED = 2,
+
+    /** The symbol was resolved and its name recorded in the writer's symbol name table. */
+    PLCRASH_LOG_WRITER_FRAME_SYMBOL_INDEXED = 3
+} plcrash_log_writer_frame_symbol_state_t;
+
+/**
+ * @internal
+ *
+ * A single captured stack frame.
+ */
+typedef struct plcrash_log_writer_frame {
+    /** The frame's PC value. */
+    uint64_t pc;
+
+    /** The symbol state of this frame. */
+    plcrash_log_writer_frame_symbol_state_t symbol_state;
+
+    /** The symbol start address. Only valid if @a symbol_state is PLCRASH_LOG_WRITER_FRAME_SYMBOL_CAPTURED or
+     * PLCRASH_LOG_WRITER_FRAME_SYMBOL_INDEXED. */
+    uint64_t symbol_start;
+
+    /** The NULL-terminated symbol name, allocated from the capture's symbol pool. Only valid if @a symbol_state is
+     * PLCRASH_LOG_WRITER_FRAME_SYMBOL_CAPTURED. */
+    const char *symbol_name;
+
+    /** The index of the symbol name within the writer's symbol name table. Only valid if @a symbol_state is
+     * PLCRASH_LOG_WRITER_FRAME_SYMBOL_INDEXED. */
+    uint32_t symbol_name_index;
+} plcrash_log_writer_frame_t;
+
+/**
+ * @internal
+ *
+ * Thread metadata capture flags (see plcrash_log_writer_set_thread_metadata()).
+ */
+typedef enum {
+    /** Capture the thread's pthread name. */
+    PLCRASH_LOG_WRITER_THREAD_METADATA_NAME = 1 << 0,
+
+    /** Capture the label of the dispatch queue the thread is executing. */
+    PLCRASH_LOG_WRITER_THREAD_METADATA_DISPATCH_QUEUE = 1 << 1,
+
+    /** Capture the thread's QoS class. */
+    PLCRASH_LOG_WRITER_THREAD_METADATA_QOS = 1 << 2,
+
+    /** Capture the thread's user and system CPU time. */
+    PLCRASH_LOG_WRITER_THREAD_METADATA_CPU_TIME = 1 << 3
+} plcrash_log_writer_thread_metadata_flags_t;
+
+/**
+ * @internal
+ *
+ * Thread symbolication policy flags (see plcrash_log_writer_set_symbolicated_threads()). If no flags are set, all
+ * threads are symbolicated.
+ */
+typedef enum {
+    /** Symbolicate the crashed thread. */
+    PLCRASH_LOG_WRITER_SYMBOLICATE_CRASHED = 1 << 0,
+
+    /** Symbolicate the main thread. */
+    PLCRASH_LOG_WRITER_SYMBOLICATE_MAIN = 1 << 1,
+
+    /** Symbolicate the threads with the highest CPU time. */
+    PLCRASH_LOG_WRITER_SYMBOLICATE_HOT = 1 << 2,
+
+    /** Symbolicate the threads whose names match one of the configured prefixes. */
+    PLCRASH_LOG_WRITER_SYMBOLICATE_NAMED = 1 << 3
+} plcrash_log_writer_symbolicated_threads_t;
+
+/**
+ * @internal
+ * Maximum number of hot threads that may be selected for symbolication.
+ */
+#define PLCRASH_LOG_WRITER_MAX_HOT_THREADS 16
+
+/**
+ * @internal
+ * Maximum length of a captured thread name or dispatch queue label, including the NUL terminator.
+ */
+#define PLCRASH_LOG_WRITER_THREAD_LABEL_SIZE 64
+
+/**
+ * @internal
+ *
+ * A thread's captured metadata. Each value is only valid if its capture was enabled and the value was available.
+ */
+typedef struct plcrash_log_writer_thread_metadata {
+    /** If true, @a thread_id is valid. */
+    bool has_thread_id;
+
+    /** The thread's system-wide unique identifier. */
+    uint64_t thread_id;
+
+    /** The NUL-terminated pthread name, or an empty string if unavailable. */
+    char name[PLCRASH_LOG_WRITER_THREAD_LABEL_SIZE];
+
+    /** The NUL-terminated dispatch queue label, or an empty string if unavailable. */
+    char dispatch_queue[PLCRASH_LOG_WRITER_THREAD_LABEL_SIZE];
+
+    /** If true, @a qos_class is valid. */
+    bool has_qos_class;
+
+    /** The thread's QoS class, as a qos_class_t value. */
+    uint32_t qos_class;
+
+    /** If true, @a user_time and @a system_time are valid. */
+    bool has_cpu_time;
+
+    /** The thread's user CPU time, in nanoseconds. */
+    uint64_t user_time;
+
+    /** The thread's system CPU time, in nanoseconds. */
+    uint64_t system_time;
+} plcrash_log_writer_thread_metadata_t;
+
+/**
+ * @internal
+ *
+ * A single captured register.
+ */
+typedef struct plcrash_log_writer_register {
+    /** The register name. */
+    const char *name;
+
+    /** The register value. */
+    plcrash_greg_t value;
+} plcrash_log_writer_register_t;
+
+/**
+ * @internal
+ *
+ * Preallocated thread capture buffer. Each thread's stack is walked and symbolicated exactly once into this
+ * buffer; both the size computation and the encoding of the thread message are then served from the captured data.
+ */
+typedef struct plcrash_log_writer_thread_capture {
+    /** Number of valid entries in @a frames. */
+    uint32_t frame_count;
+
+    /** Captured frames. */
+    plcrash_log_writer_frame_t frames[PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES];
+
+    /** If true, the registers of the first frame were captured (the crashed thread, or all threads if
+     * registers are written for all threads). */
+    bool has_registers;
+
+    /** Number of valid entries in @a registers. */
+    uint32_t register_count;
+
+    /** Captured registers of the first frame, in plcrash_regnum_t order. */
+    plcrash_log_writer_register_t registers[PLCRASH_LOG_WRITER_MAX_THREAD_REGISTERS];
+
+    /** If true, @a stack maps the thread's stack memory, which will be written with the thread. */
+    bool has_stack;
+
+    /** The thread's metadata. Only populated if thread metadata capture is enabled. */
+    plcrash_log_writer_thread_metadata_t metadata;
+
+    /** A mapping of the thread's stack memory, starting at the thread's stack pointer. Only valid if @a has_stack
+     * is true. */
+    plcrash_async_mobject_t stack;
+
+    /** Number of bytes of @a symbol_pool currently in use. */
+    size_t symbol_pool_used;
+
+    /** Backing storage for captured symbol names. */
+    char symbol_pool[PLCRASH_LOG_WRITER_SYMBOL_POOL_SIZE];
+
+    /** Scratch space for batched symbol lookups of the frames within a single image. */
+    plcrash_async_macho_symbol_match_t symbol_batch[PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES];
+
+    /** The index within @a frames of each entry in @a symbol_batch. */
+    uint32_t symbol_batch_frames[PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES];
+
+    /** The look-up result of each entry in @a symbol_batch. */
+    plcrash_error_t symbol_batch_results[PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES];
+
+    /** For each entry in @a frames, 0 if the frame's image has not been written to the report, or one greater than
+     * the index of the frame's image within the report's binary image list. Populated once the thread's referenced
+     * images have been written. */
+    uint32_t frame_images[PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES];
+
+    /** Scratch space for the 64-bit columns of the packed thread encoding. */
+    uint64_t packed_values[PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES];
+
+    /** Scratch space for the 32-bit columns of the packed thread encoding. */
+    uint32_t packed_indices[PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES];
+} plcrash_log_writer_thread_capture_t;
+
+/**
+ * @internal
+ *
+ * A thread's walked frames and registers, saved while all threads are suspended so that the threads may be
+ * resumed before the report is symbolicated and written.
+ */
+typedef struct plcrash_log_writer_thread_snapshot {
+    /** The thread's index number. */
+    uint32_t thread_number;
+
+    /** If true, this is the crashed thread. */
+    bool crashed;
+
+    /** If true, the thread's frames are to be symbolicated. */
+    bool symbolicate;
+
+    /** Number of valid entries in @a pcs. */
+    uint32_t frame_count;
+
+    /** The PC values of the walked frames. */
+    uint64_t pcs[PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES];
+
+    /** If true, the registers of the first frame were captured (the crashed thread). */
+    bool has_registers;
+
+    /** Number of valid entries in @a registers. */
+    uint32_t register_count;
+
+    /** Captured registers of the first frame. */
+    plcrash_log_writer_register_t registers[PLCRASH_LOG_WRITER_MAX_THREAD_REGISTERS];
+
+    /** The thread's metadata, captured while the thread was suspended. */
+    plcrash_log_writer_thread_metadata_t metadata;
+
+    /** The time spent walking the thread's stack, in mach_absolute_time() units. Only populated by parallel walks. */
+    uint64_t walk_time;
+} plcrash_log_writer_thread_snapshot_t;
+
+/**
+ * @internal
+ *
+ * The set of binary images already written to a report, allowing images referenced by captured frames to be
+ * written ahead of the remaining images without being written twice.
+ */
+typedef struct plcrash_log_writer_image_set {
+    /** Number of valid entries in @a images. */
+    uint32_t count;
+
+    /** If true, a referenced image could not be recorded, as the set was full. */
+    bool overflowed;
+
+    /** The written images, sorted by address. */
+    plcrash_async_image_t *images[PLCRASH_LOG_WRITER_MAX_REFERENCED_IMAGES];
+
+    /** The index of each entry in @a images within the report's binary image list. */
+    uint32_t indices[PLCRASH_LOG_WRITER_MAX_REFERENCED_IMAGES];
+
+    /** The written images, in the order in which they were written. */
+    plcrash_async_image_t *ordered[PLCRASH_LOG_WRITER_MAX_REFERENCED_IMAGES];
+} plcrash_log_writer_image_set_t;
+
+/**
+ * @internal
+ *
+ * Report-level table of unique symbol names. Frames refer to names within the table by index. Names are written
+ * to the report incrementally, ahead of the first record that refers to them, ensuring that a report truncated
+ * by the output limit retains the names referenced by every complete thread.
+ */
+typedef struct plcrash_log_writer_symbol_names {
+    /** Number of names in the table. */
+    uint32_t count;
+
+    /** Number of names, in insertion order, that have been written to the report. */
+    uint32_t written;
+
+    /** Offset of each name within @a pool, in insertion order. */
+    uint32_t offsets[PLCRASH_LOG_WRITER_MAX_SYMBOL_NAMES];
+
+    /** Open-addressed hash buckets; each non-zero value is one greater than the index of a name within
+     * @a offsets. The bucket count is twice the maximum name count, bounding the load factor to 1/2. */
+    uint32_t buckets[PLCRASH_LOG_WRITER_MAX_SYMBOL_NAMES * 2];
+
+    /** Number of bytes of @a pool currently in use. */
+    size_t pool_used;
+
+    /** Backing storage for the NULL-terminated names. */
+    char pool[PLCRASH_LOG_WRITER_SYMBOL_NAMES_POOL_SIZE];
+} plcrash_log_writer_symbol_names_t;
+
+/**
+ * @internal
+ *
+ * A thread recorded in an incremental report baseline.
+ */
+typedef struct plcrash_log_writer_baseline_thread {
+    /** The thread, or MACH_PORT_NULL if no thread was written with this thread number. */
+    thread_t thread;
+
+    /** FNV-1a hash of the thread's walked frame PCs. */
+    uint64_t hash;
+} plcrash_log_writer_baseline_thread_t;
+
+/**
+ * @internal
+ *
+ * The threads and binary images written to an incremental report's base report. Once a base report has been
+ * written, subsequent reports omit the threads whose stacks are unchanged, and the images that were already
+ * written to the base report.
+ */
+typedef struct plcrash_log_writer_baseline {
+    /** If false, no base report has been written; the next report will be written in full, and recorded as the
+     * base report. */
+    bool valid;
+
+    /** The base report's UUID. */
+    uuid_t uuid;
+
+    /** Number of valid entries in @a threads. */
+    uint32_t thread_count;
+
+    /** The base report's walked threads, indexed by thread number. */
+    plcrash_log_writer_baseline_thread_t threads[PLCRASH_LOG_WRITER_MAX_BASELINE_THREADS];
+
+    /** Number of valid entries in @a images. */
+    uint32_t image_count;
+
+    /** The header addresses of the base report's binary images, sorted by address. */
+    pl_vm_address_t images[PLCRASH_LOG_WRITER_MAX_BASELINE_IMAGES];
+} plcrash_log_writer_baseline_t;
+
+/**
+ * @internal
+ *
+ * A fixed-layout summary of a written crash report, recorded alongside the report so that pending reports
+ * may be inspected without decoding the full report. The summary is written in host byte order, and is only
+ * intended to be read on the host that wrote it.
+ */
+typedef struct plcrash_log_summary {
+    /** The summary magic value (#PLCRASH_LOG_SUMMARY_MAGIC). */
+    uint32_t magic;
+
+    /** The summary layout version (#PLCRASH_LOG_SUMMARY_VERSION). */
+    uint32_t version;
+
+    /** The report timestamp, in seconds since the UNIX epoch, or 0 if unavailable. */
+    int64_t timestamp;
+
+    /** The BSD signal number. */
+    int32_t signo;
+
+    /** The BSD signal code. */
+    int32_t code;
+
+    /** FNV-1a hash of the uncaught exception name, or 0 if no exception was recorded. */
+    uint64_t exception_name_hash;
+
+    /** FNV-1a hash of the image identities and image-relative PCs of the crashed thread's top
+     * #PLCRASH_LOG_SUMMARY_SIGNATURE_FRAMES frames, or 0 if no crashed thread was written. */
+    uint64_t crashed_thread_signature;
+
+    /** The size of the complete report file, in bytes. */
+    uint64_t report_size;
+
+    /** Number of crashes recorded by this report, including the crash that wrote it. Repeated crashes are collapsed
+     * into the pending report by plcrash_log_writer_collapse_repeat(). Added in version 2. */
+    uint32_t occurrence_count;
+
+    /** Reserved; must be zero. */
+    uint32_t reserved;
+
+    /** The timestamp of the most recently recorded crash, in seconds since the UNIX epoch, or 0 if unavailable.
+     * Added in version 2. */
+    int64_t last_timestamp;
+} plcrash_log_summary_t;
+
+/**
+ * @internal
+ * Size of a version 1 plcrash_log_summary_t, which does not include the occurrence record.
+ */
+#define PLCRASH_LOG_SUMMARY_V1_SIZE offsetof(plcrash_log_summary_t, occurrence_count)
+
+/**
+ * @internal
+ * Maximum number of threads for which crash path timing will be recorded in a single report.
+ */
+#define PLCRASH_LOG_WRITER_MAX_THREAD_TIMINGS 64
+
+/**
+ * @internal
+ *
+ * The crash path timing of a single thread. All times are in mach_absolute_time() units.
+ */
+typedef struct plcrash_log_writer_thread_timing {
+    /** The thread's number. */
+    uint32_t thread_number;
+
+    /** Number of frames walked. */
+    uint32_t frame_count;
+
+    /** Time spent walking the thread's stack. */
+    uint64_t walk_time;
+
+    /** Time spent symbolicating and writing the thread, including its referenced images. */
+    uint64_t symbolication_time;
+} plcrash_log_writer_thread_timing_t;
+
+/**
+ * @internal
+ *
+ * Crash path timing of the most recently written report. All times are in mach_absolute_time() units.
+ */
+typedef struct plcrash_log_writer_timings {
+    /** The mach_absolute_time() at which the report was started. */
+    uint64_t start;
+
+    /** Time spent suspending all other threads. */
+    uint64_t suspend_time;
+
+    /** Time spent writing the binary images not referenced by any thread. */
+    uint64_t image_time;
+
+    /** Number of valid entries in @a threads. */
+    uint32_t thread_count;
+
+    /** Per-thread timing, in the order in which the threads were walked. */
+    plcrash_log_writer_thread_timing_t threads[PLCRASH_LOG_WRITER_MAX_THREAD_TIMINGS];
+} plcrash_log_writer_timings_t;
+
+/**
+ * @internal
+ *
+ * Crash log writer capture budget. A value of 0 disables the corresponding limit.
+ */
+typedef struct plcrash_log_writer_budget {
+    /** Maximum number of threads to write. The crashed thread is always written first. */
+    uint32_t max_threads;
+
+    /** Maximum number of frames to walk per thread. Values larger than PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES
+     * are clamped. */
+    uint32_t max_frames;
+
+    /** Maximum number of frames to walk for each thread other than the crashed and main threads. Values larger than
+     * @a max_frames are clamped. */
+    uint32_t max_other_frames;
+
+    /** Maximum number of frames to symbolicate across all threads. */
+    uint32_t max_symbolicated_frames;
+
+    /** Maximum time to spend walking and symbolicating threads, in nanoseconds. */
+    uint64_t time_limit;
+} plcrash_log_writer_budget_t;
+
+/**
+ * @internal
+ *
+ * A path prefix to which symbolication is limited (see plcrash_log_writer_set_symbolication_scope()), or a thread
+ * name prefix (see plcrash_log_writer_set_symbolicated_thread_names()).
+ */
+typedef struct plcrash_log_writer_scope_path {
+    /** The path, without a trailing path separator. */
+    char *path;
+
+    /** The length of @a path, in bytes. */
+    size_t length;
+} plcrash_log_writer_scope_path_t;
+
 /**
  * @internal
  *
@@ -135,6 +706,12 @@ typedef struct plcrash_log_writer {
         
         /** If false, the reporting process is being run under process emulation (such as Rosetta). */
         bool native;
+
+        /** The process' dyld shared cache. Only valid if @a has_shared_cache is true. */
+        plcrash_async_shared_cache_t shared_cache;
+
+        /** If true, @a shared_cache is valid. */
+        bool has_shared_cache;
     } process_info;
 
     /** Uncaught exception (if any) */
@@ -148,12 +725,170 @@ typedef struct plcrash_log_writer {
         /** Exception reason (may be null) */
         char *reason;
 
-        /** The original exception call stack (may be null) */
-        void **callstack;
+        /** The original exception call stack. Only the first PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES return addresses
+         * are retained; this storage is preallocated with the writer, as to avoid allocation when the exception is
+         * set. */
+        uint64_t callstack[PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES];
         
         /** Call stack frame count, or 0 if the call stack is unavailable */
         size_t callstack_count;
     } uncaught_exception;
+
+    /** Report sections that are fixed at initialization time, pre-encoded by plcrash_log_writer_init(). */
+    struct {
+        /** The encoded section data. */
+        uint8_t *data;
+
+        /** Length of the complete CrashReport.report_info record at the start of @a data. */
+        size_t report_info_length;
+
+        /** Length of the CrashReport.system_info message body, excluding the timestamp field, following the
+         * report_info record. */
+        size_t system_info_length;
+
+        /** Length of the complete machine_info, application_info and process_info records following the
+         * system_info message body. */
+        size_t info_length;
+    } static_sections;
+
+    /** Preallocated thread capture buffer, used to walk each thread only once. */
+    plcrash_log_writer_thread_capture_t *thread_capture;
+
+    /** Binary images written to the current report ahead of the remaining images. */
+    plcrash_log_writer_image_set_t written_images;
+
+    /** If non-NULL, symbol names will be written once to this report-level table and referenced by index. */
+    plcrash_log_writer_symbol_names_t *symbol_names;
+
+    /** If non-NULL, the report body will be compressed using this compressor state. */
+    plcrash_async_lz_t *compressor;
+
+    /** If true, only the binary images referenced by captured frames will be written. */
+    bool referenced_images_only;
+
+    /** If true, threads are resumed once all thread stacks have been walked, prior to symbolication and output. */
+    bool snapshot_threads;
+
+    /** If true, threads are written as raw register state and stack memory, with unwinding and symbolication deferred
+     * until the report is decoded. */
+    bool raw_capture;
+
+    /** The number of threads across which thread stacks are walked, or 0 or 1 if stacks are walked serially by the
+     * writing thread. */
+    uint32_t unwind_workers;
+
+    /** If true, the signal is written ahead of the threads, the main thread is written immediately after the crashed
+     * thread, and the output is flushed once the crashed thread has been written. */
+    bool prioritize_threads;
+
+    /** If true, threads are written using the packed thread encoding, where possible. Requires @a symbol_names. */
+    bool packed_threads;
+
+    /** If true, registers are written for all walked threads, as a packed array of values in canonical register
+     * order. */
+    bool all_thread_registers;
+
+    /** The number of bytes of stack memory to be written with walked threads, or 0 if disabled. In raw capture mode,
+     * if non-zero, this replaces PLCRASH_LOG_WRITER_RAW_STACK_SIZE. */
+    size_t stack_capture_size;
+
+    /** If true, stack memory is written for all walked threads; otherwise, only for the crashed thread. */
+    bool stack_capture_all_threads;
+
+    /** The thread metadata to be captured for each walked thread, as a set of
+     * plcrash_log_writer_thread_metadata_flags_t values, or 0 if disabled. */
+    uint32_t thread_metadata;
+
+    /** If true, the task's memory statistics are written to the report. */
+    bool memory_statistics;
+
+    /** If true, the symbol look-up statistics of local symbolication are written to the report. */
+    bool symbolication_diagnostics;
+
+    /** If true, the writer's own crash path timing is written to the report. */
+    bool writer_diagnostics;
+
+    /** The task for which reports are written. This is the current task, unless configured via
+     * plcrash_log_writer_nasync_set_target_task(). */
+    task_t task;
+
+    /** The process' main thread, as determined when the writer was initialized. */
+    thread_t main_thread;
+
+    /** If non-NULL, a symbol cache retained across all reports written by this writer. */
+    plcrash_async_symbol_cache_t *symbol_cache;
+
+    /** If true, @a symbol_cache has been initialized. */
+    bool symbol_cache_valid;
+
+    /** The image list for which @a symbol_cache was initialized. */
+    plcrash_async_image_list_t *symbol_cache_image_list;
+
+    /** The image list's removal generation at the time @a symbol_cache was initialized. */
+    uint32_t symbol_cache_generation;
+
+    /** If non-NULL, the stack sampler whose samples will be written to the report. */
+    plcrash_stack_sampler_t *stack_sampler;
+
+    /** If non-NULL, reports are written incrementally against this baseline. */
+    plcrash_log_writer_baseline_t *baseline;
+
+    /** Summary of the most recently written report. The @a report_size is populated by
+     * plcrash_log_writer_write_summary(). */
+    plcrash_log_summary_t summary;
+
+    /** Crash path timing of the most recently written report. */
+    plcrash_log_writer_timings_t timings;
+
+    /** The capture budget. */
+    plcrash_log_writer_budget_t budget;
+
+    /** The budget's time limit, in mach_absolute_time() units, or 0 if unlimited. */
+    uint64_t budget_time_limit;
+
+    /** The mach_absolute_time() after which the current report will no longer be walked or symbolicated. */
+    uint64_t deadline;
+
+    /** Number of frames symbolicated in the current report. */
+    uint32_t symbolicated_frames;
+
+    /** The paths of the images to which symbolication is limited, or NULL if all images are symbolicated. */
+    plcrash_log_writer_scope_path_t *symbolication_scope;
+
+    /** Number of entries in @a symbolication_scope. */
+    size_t symbolication_scope_count;
+
+    /** The threads to which symbolication is limited (see plcrash_log_writer_symbolicated_threads_t), or 0 if all
+     * threads are symbolicated. */
+    uint32_t symbolicated_threads;
+
+    /** The number of threads with the highest CPU time to be symbolicated, if PLCRASH_LOG_WRITER_SYMBOLICATE_HOT is
+     * set. */
+    uint32_t symbolicated_hot_thread_count;
+
+    /** The name prefixes of the threads to be symbolicated, if PLCRASH_LOG_WRITER_SYMBOLICATE_NAMED is set. */
+    plcrash_log_writer_scope_path_t *symbolicated_thread_names;
+
+    /** Number of entries in @a symbolicated_thread_names. */
+    size_t symbolicated_thread_names_count;
+
+    /** The hot threads selected for symbolication in the current report. */
+    thread_t hot_threads[PLCRASH_LOG_WRITER_MAX_HOT_THREADS];
+
+    /** Number of valid entries in @a hot_threads. */
+    uint32_t hot_thread_count;
+
+    /** The application-supplied key/value area to be written verbatim to the report, or NULL if none. */
+    const void *custom_key_value_area;
+
+    /** Length of @a custom_key_value_area, in bytes. */
+    size_t custom_key_value_area_length;
+
+    /** The application-supplied breadcrumb buffer to be written verbatim to the report, or NULL if none. */
+    const void *custom_breadcrumbs;
+
+    /** Length of @a custom_breadcrumbs, in bytes. */
+    size_t custom_breadcrumbs_length;
 } plcrash_log_writer_t;
 
 /**
@@ -219,6 +954,30 @@ plcrash_error_t plcrash_log_writer_init (plcrash_log_writer_t *writer,
                                          plcrash_async_symbol_strategy_t symbol_strategy,
                                          BOOL user_requested);
 void plcrash_log_writer_set_exception (plcrash_log_writer_t *writer, NSException *exception);
+void plcrash_log_writer_set_compressor (plcrash_log_writer_t *writer, plcrash_async_lz_t *compressor);
+void plcrash_log_writer_set_referenced_images_only (plcrash_log_writer_t *writer, bool enabled);
+void plcrash_log_writer_set_snapshot_threads (plcrash_log_writer_t *writer, bool enabled);
+void plcrash_log_writer_set_raw_capture (plcrash_log_writer_t *writer, bool enabled);
+void plcrash_log_writer_nasync_set_unwind_workers (plcrash_log_writer_t *writer, uint32_t count);
+void plcrash_log_writer_set_budget (plcrash_log_writer_t *writer, const plcrash_log_writer_budget_t *budget);
+plcrash_error_t plcrash_log_writer_set_symbolication_scope (plcrash_log_writer_t *writer, const char * const *paths, size_t count);
+void plcrash_log_writer_set_symbolicated_threads (plcrash_log_writer_t *writer, uint32_t flags, uint32_t hot_thread_count);
+plcrash_error_t plcrash_log_writer_set_symbolicated_thread_names (plcrash_log_writer_t *writer, const char * const *names, size_t count);
+void plcrash_log_writer_set_prioritize_threads (plcrash_log_writer_t *writer, bool enabled);
+void plcrash_log_writer_set_packed_threads (plcrash_log_writer_t *writer, bool enabled);
+void plcrash_log_writer_set_all_thread_registers (plcrash_log_writer_t *writer, bool enabled);
+void plcrash_log_writer_set_thread_metadata (plcrash_log_writer_t *writer, uint32_t flags);
+void plcrash_log_writer_set_memory_statistics (plcrash_log_writer_t *writer, bool enabled);
+void plcrash_log_writer_set_symbolication_diagnostics (plcrash_log_writer_t *writer, bool enabled);
+void plcrash_log_writer_set_writer_diagnostics (plcrash_log_writer_t *writer, bool enabled);
+void plcrash_log_writer_set_stack_capture (plcrash_log_writer_t *writer, size_t size, bool all_threads);
+void plcrash_log_writer_set_stack_sampler (plcrash_log_writer_t *writer, plcrash_stack_sampler_t *sampler);
+void plcrash_log_writer_set_baseline (plcrash_log_writer_t *writer, plcrash_log_writer_baseline_t *baseline);
+void plcrash_log_writer_set_custom_data (plcrash_log_writer_t *writer, const void *key_value_area, size_t key_value_area_length, const void *breadcrumbs, size_t breadcrumbs_length);
+void plcrash_log_writer_baseline_reset (plcrash_log_writer_baseline_t *baseline);
+plcrash_error_t plcrash_log_writer_enable_symbol_names (plcrash_log_writer_t *writer);
+plcrash_error_t plcrash_log_writer_enable_persistent_symbol_cache (plcrash_log_writer_t *writer);
+plcrash_error_t plcrash_log_writer_reset (plcrash_log_writer_t *writer);
 
 plcrash_error_t plcrash_log_writer_write (plcrash_log_writer_t *writer,
                                           thread_t crashed_thread,
@@ -227,7 +986,19 @@ plcrash_error_t plcrash_log_writer_write (plcrash_log_writer_t *writer,
                                           plcrash_log_signal_info_t *siginfo,
                                           plcrash_async_thread_state_t *current_state);
 
+plcrash_error_t plcrash_log_writer_write_summary (plcrash_log_writer_t *writer, const char *path, uint64_t report_size);
+plcrash_error_t plcrash_log_writer_collapse_repeat (plcrash_log_writer_t *writer,
+                                                   thread_t crashed_thread,
+                                                   plcrash_async_image_list_t *image_list,
+                                                   const char *summary_path,
+                                                   plcrash_log_signal_info_t *siginfo,
+                                                   plcrash_async_thread_state_t *current_state);
+
 plcrash_error_t plcrash_log_writer_close (plcrash_log_writer_t *writer);
+
+plcrash_error_t plcrash_log_writer_nasync_encode_binary_image (plcrash_async_macho_t *image, void **data, size_t *length);
+plcrash_error_t plcrash_log_writer_nasync_refresh_host_snapshot (void);
+plcrash_error_t plcrash_log_writer_nasync_set_target_task (plcrash_log_writer_t *writer, task_t task);
 void plcrash_log_writer_free (plcrash_log_writer_t *writer);
 
 /**
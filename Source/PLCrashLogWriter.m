@@ -28,33 +28,44 @@
 
 #import <stdlib.h>
 #import <fcntl.h>
+#import <unistd.h>
 #import <errno.h>
 #import <string.h>
 #import <stdbool.h>
 #import <dlfcn.h>
+#import <pthread.h>
 
 #import <sys/sysctl.h>
 #import <sys/time.h>
+#import <sys/proc.h>
 
 #import <mach-o/dyld.h>
+#import <mach/mach_time.h>
+#import <mach/thread_policy.h>
+#import <sys/qos.h>
+
+#if !TARGET_OS_IPHONE
+#import <libproc.h>
+#endif
 
 #import <libkern/OSAtomic.h>
 
+#if __has_feature(ptrauth_calls)
+#import <ptrauth.h>
+#endif
+
 #import "PLCrashReport.h"
 #import "PLCrashLogWriter.h"
 #import "PLCrashLogWriterEncoding.h"
 #import "PLCrashAsyncSignalInfo.h"
 #import "PLCrashAsyncSymbolication.h"
+#import "PLCrashProbes.h"
 
 #import "PLCrashSysctl.h"
 #import "PLCrashProcessInfo.h"
 
-/**
- * @internal
- * Maximum number of frames that will be written to the crash report for a single thread. Used as a safety measure
- * to avoid overrunning our output limit when writing a crash report triggered by frame recursion.
- */
-#define MAX_THREAD_FRAMES 512 // matches Apple's crash reporting on Snow Leopard
+static plcrash_error_t plcrash_writer_nasync_encode_static_sections (plcrash_log_writer_t *writer);
+static size_t plcrash_writer_write_report_info_record (plcrash_async_file_t *file, plcrash_log_writer_t *writer);
 
 /**
  * @internal
@@ -101,6 +112,9 @@ enum {
     /** CrashReport.symbol.end_address */
     PLCRASH_PROTO_SYMBOL_END_ADDRESS = 3,
 
+    /** CrashReport.symbol.name_index */
+    PLCRASH_PROTO_SYMBOL_NAME_INDEX = 4,
+
 
     /** CrashReport.threads */
     PLCRASH_PROTO_THREADS_ID = 3,
@@ -132,6 +146,51 @@ enum {
     /** CrashReport.thread.register.value */
     PLCRASH_PROTO_THREAD_REGISTER_VALUE_ID = 2,
 
+    /** CrashReport.thread.stack_address */
+    PLCRASH_PROTO_THREAD_STACK_ADDRESS_ID = 5,
+
+    /** CrashReport.thread.stack_memory */
+    PLCRASH_PROTO_THREAD_STACK_MEMORY_ID = 6,
+
+    /** CrashReport.thread.frame_pcs */
+    PLCRASH_PROTO_THREAD_FRAME_PCS_ID = 7,
+
+    /** CrashReport.thread.frame_symbol_names */
+    PLCRASH_PROTO_THREAD_FRAME_SYMBOL_NAMES_ID = 8,
+
+    /** CrashReport.thread.frame_symbol_offsets */
+    PLCRASH_PROTO_THREAD_FRAME_SYMBOL_OFFSETS_ID = 9,
+
+    /** CrashReport.thread.register_values */
+    PLCRASH_PROTO_THREAD_REGISTER_VALUES_ID = 10,
+
+    /** CrashReport.thread.register_names */
+    PLCRASH_PROTO_THREAD_REGISTER_NAMES_ID = 11,
+
+    /** CrashReport.thread.frame_images */
+    PLCRASH_PROTO_THREAD_FRAME_IMAGES_ID = 12,
+
+    /** CrashReport.thread.register_state */
+    PLCRASH_PROTO_THREAD_REGISTER_STATE_ID = 13,
+
+    /** CrashReport.thread.name */
+    PLCRASH_PROTO_THREAD_NAME_ID = 14,
+
+    /** CrashReport.thread.dispatch_queue */
+    PLCRASH_PROTO_THREAD_DISPATCH_QUEUE_ID = 15,
+
+    /** CrashReport.thread.qos_class */
+    PLCRASH_PROTO_THREAD_QOS_CLASS_ID = 16,
+
+    /** CrashReport.thread.user_time */
+    PLCRASH_PROTO_THREAD_USER_TIME_ID = 17,
+
+    /** CrashReport.thread.system_time */
+    PLCRASH_PROTO_THREAD_SYSTEM_TIME_ID = 18,
+
+    /** CrashReport.thread.thread_id */
+    PLCRASH_PROTO_THREAD_THREAD_ID_ID = 19,
+
 
     /** CrashReport.images */
     PLCRASH_PROTO_BINARY_IMAGES_ID = 4,
@@ -212,6 +271,12 @@ enum {
     /** CrashReport.process_info.start_time */
     PLCRASH_PROTO_PROCESS_INFO_START_TIME_ID = 7,
 
+    /** CrashReport.process_info.shared_cache_uuid */
+    PLCRASH_PROTO_PROCESS_INFO_SHARED_CACHE_UUID_ID = 8,
+
+    /** CrashReport.process_info.shared_cache_base_address */
+    PLCRASH_PROTO_PROCESS_INFO_SHARED_CACHE_BASE_ADDRESS_ID = 9,
+
     
     /** CrashReport.Processor.encoding */
     PLCRASH_PROTO_PROCESSOR_ENCODING_ID = 1,
@@ -247,60 +312,261 @@ enum {
 
     /** CrashReport.report_info.uuid */
     PLCRASH_PROTO_REPORT_INFO_UUID_ID = 2,
+
+    /** CrashReport.report_info.writer_diagnostics */
+    PLCRASH_PROTO_REPORT_INFO_WRITER_DIAGNOSTICS_ID = 3,
+
+    /** CrashReport.report_info.writer_diagnostics.suspend_time */
+    PLCRASH_PROTO_WRITER_DIAGNOSTICS_SUSPEND_TIME_ID = 1,
+
+    /** CrashReport.report_info.writer_diagnostics.threads */
+    PLCRASH_PROTO_WRITER_DIAGNOSTICS_THREADS_ID = 2,
+
+    /** CrashReport.report_info.writer_diagnostics.image_time */
+    PLCRASH_PROTO_WRITER_DIAGNOSTICS_IMAGE_TIME_ID = 3,
+
+    /** CrashReport.report_info.writer_diagnostics.total_time */
+    PLCRASH_PROTO_WRITER_DIAGNOSTICS_TOTAL_TIME_ID = 4,
+
+    /** CrashReport.report_info.writer_diagnostics.thread_timing.thread_number */
+    PLCRASH_PROTO_THREAD_TIMING_THREAD_NUMBER_ID = 1,
+
+    /** CrashReport.report_info.writer_diagnostics.thread_timing.frame_count */
+    PLCRASH_PROTO_THREAD_TIMING_FRAME_COUNT_ID = 2,
+
+    /** CrashReport.report_info.writer_diagnostics.thread_timing.walk_time */
+    PLCRASH_PROTO_THREAD_TIMING_WALK_TIME_ID = 3,
+
+    /** CrashReport.report_info.writer_diagnostics.thread_timing.symbolication_time */
+    PLCRASH_PROTO_THREAD_TIMING_SYMBOLICATION_TIME_ID = 4,
+
+
+    /** CrashReport.symbol_names */
+    PLCRASH_PROTO_SYMBOL_NAMES_ID = 10,
+
+
+    /** CrashReport.symbolication_diagnostics */
+    PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_ID = 11,
+
+    /** CrashReport.symbolication_diagnostics.lookups */
+    PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_LOOKUPS_ID = 1,
+
+    /** CrashReport.symbolication_diagnostics.cache_hits */
+    PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_CACHE_HITS_ID = 2,
+
+    /** CrashReport.symbolication_diagnostics.symbols_scanned */
+    PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_SYMBOLS_SCANNED_ID = 3,
+
+    /** CrashReport.symbolication_diagnostics.objc_classes_parsed */
+    PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_OBJC_CLASSES_PARSED_ID = 4,
+
+    /** CrashReport.symbolication_diagnostics.symbol_table_lookups */
+    PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_SYMBOL_TABLE_LOOKUPS_ID = 5,
+
+    /** CrashReport.symbolication_diagnostics.symbol_table_time */
+    PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_SYMBOL_TABLE_TIME_ID = 6,
+
+    /** CrashReport.symbolication_diagnostics.objc_lookups */
+    PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_OBJC_LOOKUPS_ID = 7,
+
+    /** CrashReport.symbolication_diagnostics.objc_time */
+    PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_OBJC_TIME_ID = 8,
+
+    /** CrashReport.omitted_image_count */
+    PLCRASH_PROTO_OMITTED_IMAGE_COUNT_ID = 12,
+
+    /** CrashReport.omitted_image_hash */
+    PLCRASH_PROTO_OMITTED_IMAGE_HASH_ID = 13,
+
+    /** CrashReport.stack_samples */
+    PLCRASH_PROTO_STACK_SAMPLES_ID = 14,
+
+    /** CrashReport.stack_samples.interval */
+    PLCRASH_PROTO_STACK_SAMPLES_INTERVAL_ID = 1,
+
+    /** CrashReport.stack_samples.sample_count */
+    PLCRASH_PROTO_STACK_SAMPLES_SAMPLE_COUNT_ID = 2,
+
+    /** CrashReport.stack_samples.evicted_count */
+    PLCRASH_PROTO_STACK_SAMPLES_EVICTED_COUNT_ID = 3,
+
+    /** CrashReport.stack_samples.stacks */
+    PLCRASH_PROTO_STACK_SAMPLES_STACKS_ID = 4,
+
+    /** CrashReport.stack_samples.stacks.thread_index */
+    PLCRASH_PROTO_STACK_SAMPLES_STACK_THREAD_INDEX_ID = 1,
+
+    /** CrashReport.stack_samples.stacks.count */
+    PLCRASH_PROTO_STACK_SAMPLES_STACK_COUNT_ID = 2,
+
+    /** CrashReport.stack_samples.stacks.pcs */
+    PLCRASH_PROTO_STACK_SAMPLES_STACK_PCS_ID = 3,
+
+    /** CrashReport.base_report */
+    PLCRASH_PROTO_BASE_REPORT_ID = 15,
+
+    /** CrashReport.base_report.uuid */
+    PLCRASH_PROTO_BASE_REPORT_UUID_ID = 1,
+
+    /** CrashReport.base_report.thread_count */
+    PLCRASH_PROTO_BASE_REPORT_THREAD_COUNT_ID = 2,
+
+    /** CrashReport.custom_data */
+    PLCRASH_PROTO_CUSTOM_DATA_ID = 16,
+
+    /** CrashReport.custom_data.key_value_area */
+    PLCRASH_PROTO_CUSTOM_DATA_KEY_VALUE_AREA_ID = 1,
+
+    /** CrashReport.custom_data.breadcrumbs */
+    PLCRASH_PROTO_CUSTOM_DATA_BREADCRUMBS_ID = 2,
+
+    /** CrashReport.memory_statistics */
+    PLCRASH_PROTO_MEMORY_STATISTICS_ID = 17,
+
+    /** CrashReport.memory_statistics.phys_footprint */
+    PLCRASH_PROTO_MEMORY_STATISTICS_PHYS_FOOTPRINT_ID = 1,
+
+    /** CrashReport.memory_statistics.resident_size */
+    PLCRASH_PROTO_MEMORY_STATISTICS_RESIDENT_SIZE_ID = 2,
+
+    /** CrashReport.memory_statistics.resident_size_peak */
+    PLCRASH_PROTO_MEMORY_STATISTICS_RESIDENT_SIZE_PEAK_ID = 3,
+
+    /** CrashReport.memory_statistics.compressed_size */
+    PLCRASH_PROTO_MEMORY_STATISTICS_COMPRESSED_SIZE_ID = 4,
+
+    /** CrashReport.memory_statistics.virtual_size */
+    PLCRASH_PROTO_MEMORY_STATISTICS_VIRTUAL_SIZE_ID = 5,
+
+    /** CrashReport.memory_statistics.region_count */
+    PLCRASH_PROTO_MEMORY_STATISTICS_REGION_COUNT_ID = 6,
+
+    /** CrashReport.memory_statistics.largest_regions */
+    PLCRASH_PROTO_MEMORY_STATISTICS_LARGEST_REGIONS_ID = 7,
+
+    /** CrashReport.memory_statistics.largest_regions.address */
+    PLCRASH_PROTO_MEMORY_STATISTICS_REGION_ADDRESS_ID = 1,
+
+    /** CrashReport.memory_statistics.largest_regions.size */
+    PLCRASH_PROTO_MEMORY_STATISTICS_REGION_SIZE_ID = 2,
+
+    /** CrashReport.memory_statistics.largest_regions.protection */
+    PLCRASH_PROTO_MEMORY_STATISTICS_REGION_PROTECTION_ID = 3,
+
+    /** CrashReport.memory_statistics.largest_regions.user_tag */
+    PLCRASH_PROTO_MEMORY_STATISTICS_REGION_USER_TAG_ID = 4,
+
+    /** CrashReport.memory_statistics.regions_truncated */
+    PLCRASH_PROTO_MEMORY_STATISTICS_REGIONS_TRUNCATED_ID = 8,
 };
 
 /**
- * Initialize a new crash log writer instance and issue a memory barrier upon completion. This fetches all necessary
- * environment information.
+ * @internal
  *
- * @param writer Writer instance to be initialized.
- * @param app_identifier Unique per-application identifier. On Mac OS X, this is likely the CFBundleIdentifier.
- * @param app_version Application version string.
- * @param app_marketing_version Application marketing version string (may be nil).
- * @param symbol_strategy The strategy to use for local symbolication.
- * @param user_requested If true, the written report will be marked as a 'generated' non-crash report, rather than as
- * a true crash report created upon an actual crash.
+ * Generate a new report UUID for @a writer; CFUUID is used in favor of NSUUID as to maintain compatibility
+ * with (Mac OS X 10.7|iOS 5) and earlier.
  *
- * @note If this function fails, plcrash_log_writer_free() should be called
- * to free any partially allocated data.
+ * @warning This function is not async-safe.
+ */
+static void plcrash_writer_nasync_generate_uuid (plcrash_log_writer_t *writer) {
+    CFUUIDRef uuid = CFUUIDCreate(NULL);
+    CFUUIDBytes bytes = CFUUIDGetUUIDBytes(uuid);
+    PLCF_ASSERT(sizeof(bytes) == sizeof(writer->report_info.uuid_bytes));
+    memcpy(writer->report_info.uuid_bytes, &bytes, sizeof(writer->report_info.uuid_bytes));
+    CFRelease(uuid);
+}
+
+/**
+ * @internal
  *
- * @warning This function is not guaranteed to be async-safe, and must be called prior to enabling the crash handler.
+ * Host and process metadata that is fixed for the lifetime of the process. This is gathered once, rather than by
+ * each writer, as the required sysctls and process look-ups are comparatively expensive.
  */
-plcrash_error_t plcrash_log_writer_init (plcrash_log_writer_t *writer,
-                                         NSString *app_identifier,
-                                         NSString *app_version,
-                                         NSString *app_marketing_version,
-                                         plcrash_async_symbol_strategy_t symbol_strategy,
-                                         BOOL user_requested)
-{
-    /* Default to 0 */
-    memset(writer, 0, sizeof(*writer));
+typedef struct plcrash_writer_host_snapshot {
+    /** The host OS version. */
+    char *os_version;
 
-    /* Initialize configuration */
-    writer->symbol_strategy = symbol_strategy;
+    /** The host OS build number (may be NULL). */
+    char *os_build;
 
-    /* Default to false */
-    writer->report_info.user_requested = user_requested;
+    /** The host model (may be NULL). */
+    char *model;
 
-    /* Generate a UUID for this incident; CFUUID is used in favor of NSUUID as to maintain compatibility
-     * with (Mac OS X 10.7|iOS 5) and earlier. */
-    {
-        CFUUIDRef uuid = CFUUIDCreate(NULL);
-        CFUUIDBytes bytes = CFUUIDGetUUIDBytes(uuid);
-        PLCF_ASSERT(sizeof(bytes) == sizeof(writer->report_info.uuid_bytes));
-        memcpy(writer->report_info.uuid_bytes, &bytes, sizeof(writer->report_info.uuid_bytes));
-        CFRelease(uuid);
-    }
+    /** The host CPU type. */
+    uint64_t cpu_type;
+
+    /** The host CPU subtype. */
+    uint64_t cpu_subtype;
+
+    /** The total number of physical cores. */
+    uint32_t processor_count;
+
+    /** The total number of logical cores. */
+    uint32_t logical_processor_count;
+
+    /** Process name (may be NULL). */
+    char *process_name;
+
+    /** Process ID. */
+    pid_t process_id;
+
+    /** Process path (may be NULL). */
+    char *process_path;
+
+    /** Process start time. */
+    time_t start_time;
+
+    /** Parent process name (may be NULL). */
+    char *parent_process_name;
+
+    /** Parent process ID. */
+    pid_t parent_process_id;
+
+    /** If false, the process is being run under process emulation (such as Rosetta). */
+    bool native;
+} plcrash_writer_host_snapshot_t;
+
+/** The current host snapshot, or NULL if not yet gathered. Guarded by host_snapshot_lock. */
+static plcrash_writer_host_snapshot_t *host_snapshot = NULL;
+
+/** Lock guarding host_snapshot. */
+static pthread_mutex_t host_snapshot_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @internal
+ *
+ * Free a host snapshot allocated by plcrash_writer_nasync_host_snapshot_create().
+ */
+static void plcrash_writer_nasync_host_snapshot_free (plcrash_writer_host_snapshot_t *snapshot) {
+    if (snapshot->os_version != NULL)
+        free(snapshot->os_version);
+    if (snapshot->os_build != NULL)
+        free(snapshot->os_build);
+    if (snapshot->model != NULL)
+        free(snapshot->model);
+    if (snapshot->process_name != NULL)
+        free(snapshot->process_name);
+    if (snapshot->process_path != NULL)
+        free(snapshot->process_path);
+    if (snapshot->parent_process_name != NULL)
+        free(snapshot->parent_process_name);
+
+    free(snapshot);
+}
+
+/**
+ * @internal
+ *
+ * Gather a new host snapshot.
+ *
+ * @param result On success, the newly allocated snapshot. The caller is responsible for freeing the snapshot
+ * via plcrash_writer_nasync_host_snapshot_free().
+ */
+static plcrash_error_t plcrash_writer_nasync_host_snapshot_create (plcrash_writer_host_snapshot_t **result) {
+    plcrash_writer_host_snapshot_t *snapshot = calloc(1, sizeof(*snapshot));
+    if (snapshot == NULL)
+        return PLCRASH_ENOMEM;
 
-    /* Fetch the application information */
-    {
-        writer->application_info.app_identifier = strdup([app_identifier UTF8String]);
-        writer->application_info.app_version = strdup([app_version UTF8String]);
-        if (app_marketing_version != nil) {
-            writer->application_info.app_marketing_version = strdup([app_marketing_version UTF8String]);
-        }
-    }
-    
     /* Fetch the process information */
     {
         /* Current process */
@@ -308,18 +574,19 @@ plcrash_error_t plcrash_log_writer_init (plcrash_log_writer_t *writer,
         if (pinfo == nil) {
             /* Should only occur if the process is no longer valid */
             PLCF_DEBUG("Could not retreive process info for target");
+            plcrash_writer_nasync_host_snapshot_free(snapshot);
             return PLCRASH_EINVAL;
         }
 
         {
             /* Retrieve PID */
-            writer->process_info.process_id = pinfo.processID;
+            snapshot->process_id = pinfo.processID;
 
             /* Retrieve name and start time. */
             if (pinfo.processName != nil) {
-                writer->process_info.process_name = strdup([pinfo.processName UTF8String]);
+                snapshot->process_name = strdup([pinfo.processName UTF8String]);
             }
-            writer->process_info.start_time = pinfo.startTime.tv_sec;
+            snapshot->start_time = pinfo.startTime.tv_sec;
 
             /* Retrieve path */
             char *process_path = NULL;
@@ -329,20 +596,20 @@ plcrash_error_t plcrash_log_writer_init (plcrash_log_writer_t *writer,
             if (process_path_len > 0) {
                 process_path = malloc(process_path_len);
                 _NSGetExecutablePath(process_path, &process_path_len);
-                writer->process_info.process_path = process_path;
+                snapshot->process_path = process_path;
             }
         }
 
         /* Parent process */
         {
             /* Retrieve PID */
-            writer->process_info.parent_process_id = pinfo.parentProcessID;
+            snapshot->parent_process_id = pinfo.parentProcessID;
 
             /* Retrieve name. This will fail on iOS 9+, where EPERM is returned due to new sandbox constraints. */
             PLCrashProcessInfo *parentInfo = [[[PLCrashProcessInfo alloc] initWithProcessID: pinfo.parentProcessID] autorelease];
             if (parentInfo != nil) {
                 if (parentInfo.processName != nil) {
-                    writer->process_info.parent_process_name = strdup([parentInfo.processName UTF8String]);
+                    snapshot->parent_process_name = strdup([parentInfo.processName UTF8String]);
                 }
             } else {
                 PLCF_DEBUG("Could not retreive parent process name: %s", strerror(errno));
@@ -356,12 +623,12 @@ plcrash_error_t plcrash_log_writer_init (plcrash_log_writer_t *writer,
         /* Model */
 #if TARGET_OS_IPHONE
         /* On iOS, we want hw.machine (e.g. hw.machine = iPad2,1; hw.model = K93AP) */
-        writer->machine_info.model = plcrash_sysctl_string("hw.machine");
+        snapshot->model = plcrash_sysctl_string("hw.machine");
 #else
         /* On Mac OS X, we want hw.model (e.g. hw.machine = x86_64; hw.model = Macmini5,3) */
-        writer->machine_info.model = plcrash_sysctl_string("hw.model");
+        snapshot->model = plcrash_sysctl_string("hw.model");
 #endif
-        if (writer->machine_info.model == NULL) {
+        if (snapshot->model == NULL) {
             PLCF_DEBUG("Could not retrive hw.model: %s", strerror(errno));
         }
         
@@ -371,26 +638,26 @@ plcrash_error_t plcrash_log_writer_init (plcrash_log_writer_t *writer,
 
             /* Fetch the CPU types */
             if (plcrash_sysctl_int("hw.cputype", &retval)) {
-                writer->machine_info.cpu_type = retval;
+                snapshot->cpu_type = retval;
             } else {
                 PLCF_DEBUG("Could not retrive hw.cputype: %s", strerror(errno));
             }
             
             if (plcrash_sysctl_int("hw.cpusubtype", &retval)) {
-                writer->machine_info.cpu_subtype = retval;
+                snapshot->cpu_subtype = retval;
             } else {
                 PLCF_DEBUG("Could not retrive hw.cpusubtype: %s", strerror(errno));
             }
 
             /* Processor count */
             if (plcrash_sysctl_int("hw.physicalcpu_max", &retval)) {
-                writer->machine_info.processor_count = retval;
+                snapshot->processor_count = retval;
             } else {
                 PLCF_DEBUG("Could not retrive hw.physicalcpu_max: %s", strerror(errno));
             }
 
             if (plcrash_sysctl_int("hw.logicalcpu_max", &retval)) {
-                writer->machine_info.logical_processor_count = retval;
+                snapshot->logical_processor_count = retval;
             } else {
                 PLCF_DEBUG("Could not retrive hw.logicalcpu_max: %s", strerror(errno));
             }
@@ -407,20 +674,20 @@ plcrash_error_t plcrash_log_writer_init (plcrash_log_writer_t *writer,
 
             if (plcrash_sysctl_int("sysctl.proc_native", &retval)) {
                 if (retval == 0) {
-                    writer->process_info.native = false;
+                    snapshot->native = false;
                 } else {
-                    writer->process_info.native = true;
+                    snapshot->native = true;
                 }
             } else {
                 /* If the sysctl is not available, the process can be assumed to be native. */
-                writer->process_info.native = true;
+                snapshot->native = true;
             }
         }
     }
 
     /* Fetch the OS information */    
-    writer->system_info.build = plcrash_sysctl_string("kern.osversion");
-    if (writer->system_info.build == NULL) {
+    snapshot->os_build = plcrash_sysctl_string("kern.osversion");
+    if (snapshot->os_build == NULL) {
         PLCF_DEBUG("Could not retrive kern.osversion: %s", strerror(errno));
     }
 
@@ -434,7 +701,7 @@ plcrash_error_t plcrash_log_writer_init (plcrash_log_writer_t *writer,
             systemVersionString = [systemVersionString stringByAppendingFormat:@".%ld", (long)systemVersion.patchVersion];
         }
 
-        writer->system_info.version = strdup([systemVersionString UTF8String]);
+        snapshot->os_version = strdup([systemVersionString UTF8String]);
     }
 #elif TARGET_OS_MAC
     /* Mac OS X */
@@ -445,297 +712,3569 @@ plcrash_error_t plcrash_log_writer_init (plcrash_log_writer_t *writer,
          * Fetching the OS version should not fail. */
         if (Gestalt(gestaltSystemVersionMajor, &major) != noErr) {
             PLCF_DEBUG("Could not retrieve system major version with Gestalt");
+            plcrash_writer_nasync_host_snapshot_free(snapshot);
             return PLCRASH_EINTERNAL;
         }
         if (Gestalt(gestaltSystemVersionMinor, &minor) != noErr) {
             PLCF_DEBUG("Could not retrieve system minor version with Gestalt");
+            plcrash_writer_nasync_host_snapshot_free(snapshot);
             return PLCRASH_EINTERNAL;
         }
         if (Gestalt(gestaltSystemVersionBugFix, &bugfix) != noErr) {
             PLCF_DEBUG("Could not retrieve system bugfix version with Gestalt");
+            plcrash_writer_nasync_host_snapshot_free(snapshot);
             return PLCRASH_EINTERNAL;
         }
 
         /* Compose the string */
-        asprintf(&writer->system_info.version, "%" PRId32 ".%" PRId32 ".%" PRId32, (int32_t)major, (int32_t)minor, (int32_t)bugfix);
+        asprintf(&snapshot->os_version, "%" PRId32 ".%" PRId32 ".%" PRId32, (int32_t)major, (int32_t)minor, (int32_t)bugfix);
     }
 #else
 #error Unsupported Platform
 #endif
 
-    /* Ensure that any signal handler has a consistent view of the above initialization. */
-    OSMemoryBarrier();
-
+    *result = snapshot;
     return PLCRASH_ESUCCESS;
 }
 
+/* strdup() wrapper that passes through NULL */
+static char *plcrash_writer_strdup_nullable (const char *str) {
+    if (str == NULL)
+        return NULL;
+
+    return strdup(str);
+}
+
 /**
- * Set the uncaught exception for this writer. Once set, this exception will be used to
- * provide exception data for the crash log output.
+ * @internal
  *
- * @warning This function is not async safe, and must be called outside of a signal handler.
+ * Copy the host and process metadata of the current host snapshot to @a writer, gathering the snapshot if it
+ * has not already been gathered.
+ *
+ * @param writer The writer to be populated.
  */
-void plcrash_log_writer_set_exception (plcrash_log_writer_t *writer, NSException *exception) {
-    assert(writer->uncaught_exception.has_exception == false);
-
-    /* Save the exception data */
-    writer->uncaught_exception.has_exception = true;
-    writer->uncaught_exception.name = strdup([[exception name] UTF8String]);
-    writer->uncaught_exception.reason = strdup([exception reason] != nil ? [[exception reason] UTF8String] : "");
+static plcrash_error_t plcrash_writer_nasync_copy_host_snapshot (plcrash_log_writer_t *writer) {
+    plcrash_error_t err = PLCRASH_ESUCCESS;
 
-    /* Save the call stack, if available */
-    NSArray *callStackArray = [exception callStackReturnAddresses];
-    if (callStackArray != nil && [callStackArray count] > 0) {
-        size_t count = [callStackArray count];
-        writer->uncaught_exception.callstack_count = count;
-        writer->uncaught_exception.callstack = malloc(sizeof(void *) * count);
-
-        size_t i = 0;
-        for (NSNumber *num in callStackArray) {
-            assert(i < count);
-            writer->uncaught_exception.callstack[i] = (void *)(uintptr_t)[num unsignedLongLongValue];
-            i++;
-        }
+    pthread_mutex_lock(&host_snapshot_lock);
+    if (host_snapshot == NULL && (err = plcrash_writer_nasync_host_snapshot_create(&host_snapshot)) != PLCRASH_ESUCCESS) {
+        pthread_mutex_unlock(&host_snapshot_lock);
+        return err;
     }
 
-    /* Ensure that any signal handler has a consistent view of the above initialization. */
-    OSMemoryBarrier();
+    plcrash_writer_host_snapshot_t *snapshot = host_snapshot;
+
+    writer->system_info.version = plcrash_writer_strdup_nullable(snapshot->os_version);
+    writer->system_info.build = plcrash_writer_strdup_nullable(snapshot->os_build);
+
+    writer->machine_info.model = plcrash_writer_strdup_nullable(snapshot->model);
+    writer->machine_info.cpu_type = snapshot->cpu_type;
+    writer->machine_info.cpu_subtype = snapshot->cpu_subtype;
+    writer->machine_info.processor_count = snapshot->processor_count;
+    writer->machine_info.logical_processor_count = snapshot->logical_processor_count;
+
+    writer->process_info.process_name = plcrash_writer_strdup_nullable(snapshot->process_name);
+    writer->process_info.process_id = snapshot->process_id;
+    writer->process_info.process_path = plcrash_writer_strdup_nullable(snapshot->process_path);
+    writer->process_info.start_time = snapshot->start_time;
+    writer->process_info.parent_process_name = plcrash_writer_strdup_nullable(snapshot->parent_process_name);
+    writer->process_info.parent_process_id = snapshot->parent_process_id;
+    writer->process_info.native = snapshot->native;
+
+    pthread_mutex_unlock(&host_snapshot_lock);
+    return PLCRASH_ESUCCESS;
 }
 
 /**
- * Close the plcrash_writer_t output.
+ * Re-gather the process-wide host and process metadata snapshot from which writers are initialized. The snapshot
+ * is otherwise gathered once, by the first call to plcrash_log_writer_init(); this function need only be called if
+ * the metadata is known to have changed. Only writers initialized after the refresh are affected.
  *
- * @param writer Writer instance to be closed.
+ * If the new snapshot can not be gathered, the existing snapshot is retained.
+ *
+ * @warning This function is not async-safe.
  */
-plcrash_error_t plcrash_log_writer_close (plcrash_log_writer_t *writer) {
+plcrash_error_t plcrash_log_writer_nasync_refresh_host_snapshot (void) {
+    plcrash_writer_host_snapshot_t *snapshot;
+    plcrash_error_t err;
+
+    /* Gather the new snapshot outside of the lock, and then swap it in */
+    if ((err = plcrash_writer_nasync_host_snapshot_create(&snapshot)) != PLCRASH_ESUCCESS)
+        return err;
+
+    pthread_mutex_lock(&host_snapshot_lock);
+    plcrash_writer_host_snapshot_t *previous = host_snapshot;
+    host_snapshot = snapshot;
+    pthread_mutex_unlock(&host_snapshot_lock);
+
+    if (previous != NULL)
+        plcrash_writer_nasync_host_snapshot_free(previous);
+
     return PLCRASH_ESUCCESS;
 }
 
 /**
- * Free any crash log writer resources.
+ * Configure @a writer to write reports for @a task, rather than the current task, such as when running within an
+ * out-of-process crash reporting helper. The process metadata, main thread, and shared cache are re-gathered for
+ * @a task's process, and the pre-encoded report sections are regenerated.
  *
- * @warning This method is not async safe.
+ * The host metadata is retained, and must describe the host on which @a task is running.
+ *
+ * @param writer The writer.
+ * @param task The target task. A send right is retained by the writer, and released by plcrash_log_writer_free().
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or an appropriate error on failure. If the target process' metadata
+ * can not be gathered, the writer is left unmodified.
+ *
+ * @warning This function is not async safe, and must be called prior to writing any reports.
  */
-void plcrash_log_writer_free (plcrash_log_writer_t *writer) {
-    /* Free the app info */
-    if (writer->application_info.app_identifier != NULL)
-        free(writer->application_info.app_identifier);
-    if (writer->application_info.app_version != NULL)
-        free(writer->application_info.app_version);
-    if (writer->application_info.app_marketing_version != NULL)
-        free(writer->application_info.app_marketing_version);
+plcrash_error_t plcrash_log_writer_nasync_set_target_task (plcrash_log_writer_t *writer, task_t task) {
+    plcrash_error_t err;
+    kern_return_t kr;
+    pid_t pid;
+
+    if ((kr = pid_for_task(task, &pid)) != KERN_SUCCESS) {
+        PLCF_DEBUG("Could not determine the target task's process ID: %d", kr);
+        return PLCRASH_EINVAL;
+    }
 
-    /* Free the process info */
-    if (writer->process_info.process_name != NULL) 
+    PLCrashProcessInfo *pinfo = [[[PLCrashProcessInfo alloc] initWithProcessID: pid] autorelease];
+    if (pinfo == nil) {
+        PLCF_DEBUG("Could not retrieve process info for target: %s", strerror(errno));
+        return PLCRASH_EINVAL;
+    }
+
+    /* The task's first thread is its main thread */
+    thread_act_array_t threads;
+    mach_msg_type_number_t thread_count;
+    if ((kr = task_threads(task, &threads, &thread_count)) != KERN_SUCCESS) {
+        PLCF_DEBUG("Could not fetch the target task's threads: %d", kr);
+        return PLCRASH_EINTERNAL;
+    }
+
+    thread_t main_thread = MACH_PORT_NULL;
+    for (mach_msg_type_number_t i = 0; i < thread_count; i++) {
+        if (i == 0)
+            main_thread = threads[i];
+        else
+            mach_port_deallocate(mach_task_self(), threads[i]);
+    }
+    vm_deallocate(mach_task_self(), (vm_address_t) threads, sizeof(thread_t) * thread_count);
+
+    /* Release any previously configured target */
+    if (writer->task != mach_task_self()) {
+        if (writer->main_thread != MACH_PORT_NULL)
+            mach_port_deallocate(mach_task_self(), writer->main_thread);
+        mach_port_deallocate(mach_task_self(), writer->task);
+    }
+
+    mach_port_mod_refs(mach_task_self(), task, MACH_PORT_RIGHT_SEND, 1);
+    writer->task = task;
+    writer->main_thread = main_thread;
+
+    /* Replace the process metadata */
+    if (writer->process_info.process_name != NULL)
         free(writer->process_info.process_name);
-    if (writer->process_info.process_path != NULL) 
+    if (writer->process_info.process_path != NULL)
         free(writer->process_info.process_path);
-    if (writer->process_info.parent_process_name != NULL) 
+    if (writer->process_info.parent_process_name != NULL)
         free(writer->process_info.parent_process_name);
-    
-    /* Free the system info */
-    if (writer->system_info.version != NULL)
-        free(writer->system_info.version);
-    
-    if (writer->system_info.build != NULL)
-        free(writer->system_info.build);
-    
-    /* Free the machine info */
-    if (writer->machine_info.model != NULL)
-        free(writer->machine_info.model);
 
-    /* Free the exception data */
-    if (writer->uncaught_exception.has_exception) {
-        if (writer->uncaught_exception.name != NULL)
-            free(writer->uncaught_exception.name);
+    writer->process_info.process_id = pinfo.processID;
+    writer->process_info.process_name = pinfo.processName != nil ? strdup([pinfo.processName UTF8String]) : NULL;
+    writer->process_info.start_time = pinfo.startTime.tv_sec;
+    writer->process_info.parent_process_id = pinfo.parentProcessID;
 
-        if (writer->uncaught_exception.reason != NULL)
-            free(writer->uncaught_exception.reason);
-        
-        if (writer->uncaught_exception.callstack != NULL)
-            free(writer->uncaught_exception.callstack);
-    }
-}
+    writer->process_info.process_path = NULL;
+#if !TARGET_OS_IPHONE
+    char process_path[PROC_PIDPATHINFO_MAXSIZE];
+    if (proc_pidpath(pid, process_path, sizeof(process_path)) > 0)
+        writer->process_info.process_path = strdup(process_path);
+#endif
 
-/**
- * @internal
- *
- * Write the system info message.
- *
- * @param file Output file
- * @param timestamp Timestamp to use (seconds since epoch). Must be same across calls, as varint encoding.
- */
-static size_t plcrash_writer_write_system_info (plcrash_async_file_t *file, plcrash_log_writer_t *writer, int64_t timestamp) {
-    size_t rv = 0;
-    uint32_t enumval;
+    PLCrashProcessInfo *parentInfo = [[[PLCrashProcessInfo alloc] initWithProcessID: pinfo.parentProcessID] autorelease];
+    writer->process_info.parent_process_name = (parentInfo.processName != nil) ? strdup([parentInfo.processName UTF8String]) : NULL;
 
-    /* OS */
-    enumval = PLCrashReportHostOperatingSystem;
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYSTEM_INFO_OS_ID, PLPROTOBUF_C_TYPE_ENUM, &enumval);
+    /* A process running under emulation is marked P_TRANSLATED */
+    struct kinfo_proc process;
+    size_t process_length = sizeof(process);
+    int mib[] = { CTL_KERN, KERN_PROC, KERN_PROC_PID, pid };
+    if (sysctl(mib, sizeof(mib) / sizeof(mib[0]), &process, &process_length, NULL, 0) == 0 && process_length > 0)
+        writer->process_info.native = (process.kp_proc.p_flag & P_TRANSLATED) == 0;
 
-    /* OS Version */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYSTEM_INFO_OS_VERSION_ID, PLPROTOBUF_C_TYPE_STRING, writer->system_info.version);
-    
-    /* OS Build */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYSTEM_INFO_OS_BUILD_ID, PLPROTOBUF_C_TYPE_STRING, writer->system_info.build);
+    /* Retrieve the target's shared cache */
+    writer->process_info.has_shared_cache = (plcrash_async_shared_cache_init(&writer->process_info.shared_cache, task) == PLCRASH_ESUCCESS);
 
-    /* Machine type */
-    enumval = PLCrashReportHostArchitecture;
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYSTEM_INFO_ARCHITECTURE_TYPE_ID, PLPROTOBUF_C_TYPE_ENUM, &enumval);
+    /* Re-encode the static sections */
+    if (writer->static_sections.data != NULL) {
+        free(writer->static_sections.data);
+        writer->static_sections.data = NULL;
+    }
 
-    /* Timestamp */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYSTEM_INFO_TIMESTAMP_ID, PLPROTOBUF_C_TYPE_INT64, &timestamp);
+    if ((err = plcrash_writer_nasync_encode_static_sections(writer)) != PLCRASH_ESUCCESS)
+        return err;
 
-    return rv;
+    /* Ensure that any signal handler has a consistent view of the above. */
+    OSMemoryBarrier();
+
+    return PLCRASH_ESUCCESS;
 }
 
 /**
- * @internal
+ * Initialize a new crash log writer instance and issue a memory barrier upon completion. This fetches all necessary
+ * environment information.
+ *
+ * @param writer Writer instance to be initialized.
+ * @param app_identifier Unique per-application identifier. On Mac OS X, this is likely the CFBundleIdentifier.
+ * @param app_version Application version string.
+ * @param app_marketing_version Application marketing version string (may be nil).
+ * @param symbol_strategy The strategy to use for local symbolication.
+ * @param user_requested If true, the written report will be marked as a 'generated' non-crash report, rather than as
+ * a true crash report created upon an actual crash.
+ *
+ * @note If this function fails, plcrash_log_writer_free() should be called
+ * to free any partially allocated data.
+ *
+ * @warning This function is not guaranteed to be async-safe, and must be called prior to enabling the crash handler.
+ */
+plcrash_error_t plcrash_log_writer_init (plcrash_log_writer_t *writer,
+                                         NSString *app_identifier,
+                                         NSString *app_version,
+                                         NSString *app_marketing_version,
+                                         plcrash_async_symbol_strategy_t symbol_strategy,
+                                         BOOL user_requested)
+{
+    /* Default to 0 */
+    memset(writer, 0, sizeof(*writer));
+
+    /* Allocate the thread capture buffer. This must be allocated here, as it is used from the async-safe
+     * report writing path. */
+    writer->thread_capture = malloc(sizeof(*writer->thread_capture));
+    if (writer->thread_capture == NULL)
+        return PLCRASH_ENOMEM;
+
+    /* Initialize configuration */
+    writer->symbol_strategy = symbol_strategy;
+    writer->task = mach_task_self();
+    writer->main_thread = pthread_mach_thread_np(pthread_main_thread_np());
+
+    /* Default to false */
+    writer->report_info.user_requested = user_requested;
+
+    /* Generate a UUID for this incident */
+    plcrash_writer_nasync_generate_uuid(writer);
+
+    /* Fetch the application information */
+    {
+        writer->application_info.app_identifier = strdup([app_identifier UTF8String]);
+        writer->application_info.app_version = strdup([app_version UTF8String]);
+        if (app_marketing_version != nil) {
+            writer->application_info.app_marketing_version = strdup([app_marketing_version UTF8String]);
+        }
+    }
+    
+    /* Copy the host and process metadata from the process-wide snapshot */
+    plcrash_error_t err;
+    if ((err = plcrash_writer_nasync_copy_host_snapshot(writer)) != PLCRASH_ESUCCESS)
+        return err;
+
+    /* Retrieve the shared cache, which is recorded once rather than per image */
+    if (plcrash_async_shared_cache_init(&writer->process_info.shared_cache, mach_task_self()) == PLCRASH_ESUCCESS)
+        writer->process_info.has_shared_cache = true;
+
+    /* Pre-encode all report sections that will not change after initialization */
+    if ((err = plcrash_writer_nasync_encode_static_sections(writer)) != PLCRASH_ESUCCESS)
+        return err;
+
+    /* Ensure that any signal handler has a consistent view of the above initialization. */
+    OSMemoryBarrier();
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Enable compression of the crash report body. When set, reports are written with the
+ * #PLCRASH_REPORT_FILE_VERSION_COMPRESSED file header, followed by the LZ-compressed report
+ * message.
+ *
+ * @param writer The writer.
+ * @param compressor The compressor state to use, or NULL to disable compression. This must remain valid
+ * for the lifetime of the writer; as the state is large, it should be statically allocated.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_compressor (plcrash_log_writer_t *writer, plcrash_async_lz_t *compressor) {
+    writer->compressor = compressor;
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+}
+
+/**
+ * Configure whether only the binary images referenced by the report's captured frames are written. When enabled,
+ * all other images are summarized by the CrashReport.omitted_image_count and CrashReport.omitted_image_hash fields.
+ * If more images are referenced than can be tracked (see #PLCRASH_LOG_WRITER_MAX_REFERENCED_IMAGES), all images
+ * will be written.
+ *
+ * @param writer The writer.
+ * @param enabled If true, only referenced images will be written.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_referenced_images_only (plcrash_log_writer_t *writer, bool enabled) {
+    writer->referenced_images_only = enabled;
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+}
+
+/**
+ * Configure whether all threads are resumed as soon as their stacks have been walked. When enabled, each thread's
+ * frames and registers are saved to a snapshot while the threads are suspended, and the report is symbolicated
+ * and written from the snapshots after the threads have been resumed. This bounds the time for which the process
+ * is suspended to the stack walk, at the cost of the snapshot allocation.
+ *
+ * This must only be enabled for live reports; the snapshots are allocated prior to suspending the process'
+ * threads, which is not async-safe.
+ *
+ * Once resumed, the process may unload images concurrently with symbolication. Snapshot reports therefore never
+ * reference image memory directly: image names are owned by the image list, and image data is read only via remapped
+ * (copied) mappings, such that an image unloaded mid-report is reported without its symbols, rather than read
+ * after it has been freed.
+ *
+ * @param writer The writer.
+ * @param enabled If true, threads will be resumed prior to symbolication.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_snapshot_threads (plcrash_log_writer_t *writer, bool enabled) {
+    writer->snapshot_threads = enabled;
+}
+
+/**
+ * Configure raw capture mode. When enabled, each thread is written as its raw register state and a bounded copy of its
+ * stack memory; no stack walking or symbolication is performed while the process is suspended. All binary images are
+ * written, and the thread's frames are recovered from the captured memory when the report is decoded.
+ *
+ * @param writer The writer.
+ * @param enabled If true, threads will be written in raw form.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_raw_capture (plcrash_log_writer_t *writer, bool enabled) {
+    writer->raw_capture = enabled;
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+}
+
+/**
+ * Configure parallel stack walking. When enabled, the stacks of all threads are walked across @a count threads --
+ * the writing thread, and up to @a count - 1 additional threads spawned for the duration of the walk -- before the
+ * threads are symbolicated and written in order by the writing thread.
+ *
+ * Spawning threads is not async-safe; this must only be enabled for a writer that is never used from a signal
+ * handler or exception server within the target task, such as an out-of-process writer targeting another task
+ * via plcrash_log_writer_nasync_set_target_task().
+ *
+ * Parallel walks are not performed in raw capture mode, in which no stacks are walked.
+ *
+ * @param writer The writer.
+ * @param count The number of threads across which stacks will be walked. If 0 or 1, stacks are walked serially.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_nasync_set_unwind_workers (plcrash_log_writer_t *writer, uint32_t count) {
+    writer->unwind_workers = count;
+}
+
+/**
+ * Configure stack memory capture. When enabled, up to @a size bytes of stack memory above the stack pointer are
+ * written with the crashed thread and, if @a all_threads is true, with all other threads, allowing the threads to be
+ * unwound again from the captured memory once the report has been decoded. The total stack memory written to a single
+ * report is bounded by PLCRASH_LOG_WRITER_RAW_STACK_BUDGET.
+ *
+ * Stack memory is written directly from the suspended thread's stack, and is not captured for threads that are resumed
+ * prior to output via plcrash_log_writer_set_snapshot_threads(). In raw capture mode, a non-zero @a size replaces the
+ * default per-thread stack size, and stack memory is written for all threads.
+ *
+ * @param writer The writer.
+ * @param size The number of bytes of stack memory to be written per thread, or 0 to disable stack memory capture.
+ * @param all_threads If true, stack memory will be written for all threads, rather than only the crashed thread.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_stack_capture (plcrash_log_writer_t *writer, size_t size, bool all_threads) {
+    writer->stack_capture_size = size;
+    writer->stack_capture_all_threads = all_threads;
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+}
+
+/**
+ * Configure crashed thread priority output. When enabled, the signal is written ahead of all threads, the main
+ * thread is written immediately after the crashed thread, and the output is flushed once the crashed thread and its
+ * referenced images have been written. If the process is terminated while the remaining threads are being written,
+ * the truncated report still contains every required section and the crashed thread.
+ *
+ * @param writer The writer.
+ * @param enabled If true, the crashed and main threads will be written ahead of all other threads.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_prioritize_threads (plcrash_log_writer_t *writer, bool enabled) {
+    writer->prioritize_threads = enabled;
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+}
+
+/**
+ * Configure packed thread output. When enabled, each thread's frames and registers are written as parallel packed
+ * arrays rather than as a nested message per frame and per register, and frame symbol and register names are written
+ * by reference to the report-level symbol name table. Threads whose names can not all be referenced from the table
+ * are written using the standard encoding.
+ *
+ * The packed encoding requires the symbol name table; if plcrash_log_writer_enable_symbol_names() has not been
+ * called, all threads are written using the standard encoding.
+ *
+ * @param writer The writer.
+ * @param enabled If true, threads will be written using the packed thread encoding.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_packed_threads (plcrash_log_writer_t *writer, bool enabled) {
+    writer->packed_threads = enabled;
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+}
+
+/**
+ * Configure register output for all threads. When enabled, the first frame's registers are written for every walked
+ * thread, rather than only for the crashed thread, and all register values are written as a single packed array in
+ * canonical plcrash_regnum_t order, without register names. Register names are restored from the report's
+ * architecture when the report is decoded.
+ *
+ * @param writer The writer.
+ * @param enabled If true, registers will be written for all threads using the compact register encoding.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_all_thread_registers (plcrash_log_writer_t *writer, bool enabled) {
+    writer->all_thread_registers = enabled;
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+}
+
+/**
+ * Configure the metadata captured for each walked thread in all subsequent reports. Each value is fetched with a
+ * single thread_info() or thread_policy_get() call; the dispatch queue label additionally requires reading the
+ * queue's label from the target task's memory.
+ *
+ * @param writer The writer.
+ * @param flags The metadata to be captured, as a set of plcrash_log_writer_thread_metadata_flags_t values, or 0
+ * to disable thread metadata capture.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_thread_metadata (plcrash_log_writer_t *writer, uint32_t flags) {
+    writer->thread_metadata = flags;
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+}
+
+/**
+ * Configure the capture budget applied to all subsequent reports. Threads beyond the thread limit are omitted, and
+ * frames beyond the symbolication limit are written with their PC only. Once the time limit has elapsed, the thread
+ * being walked is truncated, no further frames are symbolicated, and any remaining threads are omitted; the binary
+ * images are always written, ensuring that the report completes.
+ *
+ * @param writer The writer.
+ * @param budget The capture budget. A limit of 0 disables the corresponding check.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_budget (plcrash_log_writer_t *writer, const plcrash_log_writer_budget_t *budget) {
+    mach_timebase_info_data_t timebase;
+
+    writer->budget = *budget;
+
+    /* Convert the time limit to mach_absolute_time() units now, rather than at crash time */
+    if (mach_timebase_info(&timebase) != KERN_SUCCESS || timebase.numer == 0) {
+        timebase.numer = 1;
+        timebase.denom = 1;
+    }
+    writer->budget_time_limit = budget->time_limit * timebase.denom / timebase.numer;
+    if (budget->time_limit > 0 && writer->budget_time_limit == 0)
+        writer->budget_time_limit = 1;
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+}
+
+/* Free the writer's symbolication scope paths */
+static void plcrash_writer_free_symbolication_scope (plcrash_log_writer_scope_path_t *scope, size_t count) {
+    if (scope == NULL)
+        return;
+
+    for (size_t i = 0; i < count; i++) {
+        if (scope[i].path != NULL)
+            free(scope[i].path);
+    }
+    free(scope);
+}
+
+/**
+ * Limit symbolication to the images whose paths are equal to, or are contained within, one of @a paths. Frames
+ * within all other images will be written with their PC values only, bounding the crash-time cost of symbolication
+ * to the images of interest; eg, the main executable and the application's own frameworks.
+ *
+ * @param writer The writer.
+ * @param paths The image paths or directory prefixes to be symbolicated. The paths will be copied.
+ * @param count The number of entries in @a paths, or 0 to symbolicate all images.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_ENOMEM if the paths could not be copied. On failure, the
+ * writer's existing configuration is left unmodified.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+plcrash_error_t plcrash_log_writer_set_symbolication_scope (plcrash_log_writer_t *writer, const char * const *paths, size_t count) {
+    plcrash_log_writer_scope_path_t *scope = NULL;
+
+    if (count > 0) {
+        scope = calloc(count, sizeof(*scope));
+        if (scope == NULL)
+            return PLCRASH_ENOMEM;
+
+        for (size_t i = 0; i < count; i++) {
+            if ((scope[i].path = strdup(paths[i])) == NULL) {
+                plcrash_writer_free_symbolication_scope(scope, count);
+                return PLCRASH_ENOMEM;
+            }
+
+            /* Trailing separators are dropped; a prefix only matches at a path component boundary. */
+            scope[i].length = strlen(scope[i].path);
+            while (scope[i].length > 1 && scope[i].path[scope[i].length - 1] == '/')
+                scope[i].path[--scope[i].length] = '\0';
+        }
+    }
+
+    /* Disable the existing scope before it is freed. */
+    plcrash_log_writer_scope_path_t *previous = writer->symbolication_scope;
+    size_t previous_count = writer->symbolication_scope_count;
+    writer->symbolication_scope_count = 0;
+    OSMemoryBarrier();
+
+    writer->symbolication_scope = scope;
+    OSMemoryBarrier();
+    writer->symbolication_scope_count = count;
+
+    plcrash_writer_free_symbolication_scope(previous, previous_count);
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Limit symbolication to the threads selected by @a flags. Frames of all other threads will be written with their PC
+ * values only, so that the crash-time cost of symbolication scales with the number of threads of interest, rather
+ * than the total thread count.
+ *
+ * @param writer The writer.
+ * @param flags The threads to be symbolicated (see plcrash_log_writer_symbolicated_threads_t), or 0 to symbolicate
+ * all threads.
+ * @param hot_thread_count The number of threads with the highest CPU time to be symbolicated, if
+ * PLCRASH_LOG_WRITER_SYMBOLICATE_HOT is set. Values larger than PLCRASH_LOG_WRITER_MAX_HOT_THREADS are clamped.
+ */
+void plcrash_log_writer_set_symbolicated_threads (plcrash_log_writer_t *writer, uint32_t flags, uint32_t hot_thread_count) {
+    if (hot_thread_count > PLCRASH_LOG_WRITER_MAX_HOT_THREADS)
+        hot_thread_count = PLCRASH_LOG_WRITER_MAX_HOT_THREADS;
+
+    writer->symbolicated_hot_thread_count = hot_thread_count;
+    OSMemoryBarrier();
+    writer->symbolicated_threads = flags;
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+}
+
+/**
+ * Set the name prefixes of the threads to be symbolicated if PLCRASH_LOG_WRITER_SYMBOLICATE_NAMED is set (see
+ * plcrash_log_writer_set_symbolicated_threads()). A thread is selected if its pthread name begins with one of
+ * @a names.
+ *
+ * @param writer The writer.
+ * @param names The thread name prefixes. The names will be copied.
+ * @param count The number of entries in @a names.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_ENOMEM if the names could not be copied. On failure, the
+ * writer's existing configuration is left unmodified.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+plcrash_error_t plcrash_log_writer_set_symbolicated_thread_names (plcrash_log_writer_t *writer, const char * const *names, size_t count) {
+    plcrash_log_writer_scope_path_t *prefixes = NULL;
+
+    if (count > 0) {
+        prefixes = calloc(count, sizeof(*prefixes));
+        if (prefixes == NULL)
+            return PLCRASH_ENOMEM;
+
+        for (size_t i = 0; i < count; i++) {
+            if ((prefixes[i].path = strdup(names[i])) == NULL) {
+                plcrash_writer_free_symbolication_scope(prefixes, count);
+                return PLCRASH_ENOMEM;
+            }
+            prefixes[i].length = strlen(prefixes[i].path);
+        }
+    }
+
+    /* Disable the existing names before they are freed. */
+    plcrash_log_writer_scope_path_t *previous = writer->symbolicated_thread_names;
+    size_t previous_count = writer->symbolicated_thread_names_count;
+    writer->symbolicated_thread_names_count = 0;
+    OSMemoryBarrier();
+
+    writer->symbolicated_thread_names = prefixes;
+    OSMemoryBarrier();
+    writer->symbolicated_thread_names_count = count;
+
+    plcrash_writer_free_symbolication_scope(previous, previous_count);
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Configure the stack sampler whose aggregated samples will be written to all subsequent reports. The sampler's
+ * lock is acquired while the samples are written.
+ *
+ * This must only be configured for live reports; acquiring the sampler's lock is not async-safe.
+ *
+ * @param writer The writer.
+ * @param sampler The sampler, or NULL to disable writing of stack samples. This is a borrowed reference, and must
+ * remain valid until it is replaced.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_stack_sampler (plcrash_log_writer_t *writer, plcrash_stack_sampler_t *sampler) {
+    writer->stack_sampler = sampler;
+}
+
+/**
+ * Configure the baseline against which all subsequent reports will be written incrementally. If the baseline has
+ * not yet been populated, the next report is written in full and recorded as the base report. Each following report
+ * refers to the base report by UUID, and includes only the crashed thread, the threads whose walked stacks differ
+ * from the base report, and the binary images that were not written to the base report. Raw capture reports are
+ * always written in full, and do not populate the baseline.
+ *
+ * This must only be configured for live reports.
+ *
+ * @param writer The writer.
+ * @param baseline The baseline, or NULL to disable incremental reports. This is a borrowed reference, and must
+ * remain valid until it is replaced.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_baseline (plcrash_log_writer_t *writer, plcrash_log_writer_baseline_t *baseline) {
+    writer->baseline = baseline;
+    OSMemoryBarrier();
+}
+
+/**
+ * Configure the application-supplied memory regions to be copied verbatim to all subsequent reports. The regions
+ * are read directly from the crashed process' memory at the time the report is written; no copy is made.
+ *
+ * @param writer The writer.
+ * @param key_value_area The key/value area, or NULL if none.
+ * @param key_value_area_length The length of @a key_value_area, in bytes.
+ * @param breadcrumbs The breadcrumb buffer, or NULL if none.
+ * @param breadcrumbs_length The length of @a breadcrumbs, in bytes.
+ *
+ * @warning The regions are borrowed references, and must remain valid until they are replaced.
+ */
+void plcrash_log_writer_set_custom_data (plcrash_log_writer_t *writer, const void *key_value_area, size_t key_value_area_length, const void *breadcrumbs, size_t breadcrumbs_length) {
+    writer->custom_key_value_area = NULL;
+    writer->custom_breadcrumbs = NULL;
+    OSMemoryBarrier();
+
+    writer->custom_key_value_area_length = key_value_area_length;
+    writer->custom_breadcrumbs_length = breadcrumbs_length;
+    OSMemoryBarrier();
+
+    writer->custom_key_value_area = key_value_area;
+    writer->custom_breadcrumbs = breadcrumbs;
+    OSMemoryBarrier();
+}
+
+/**
+ * Enable or disable the capture of the target task's memory statistics in all subsequent reports. The statistics are
+ * fetched with a single task_info(TASK_VM_INFO) call, followed by a walk of at most
+ * PLCRASH_LOG_WRITER_MEMORY_REGION_WALK_LIMIT regions to find the largest VM regions.
+ *
+ * @param writer The writer.
+ * @param enabled If true, memory statistics will be written to the report.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_memory_statistics (plcrash_log_writer_t *writer, bool enabled) {
+    writer->memory_statistics = enabled;
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+}
+
+/**
+ * Enable or disable writing of symbolication diagnostics in all subsequent reports. When enabled, the symbol look-up
+ * statistics gathered during local symbolication are written as CrashReport.symbolication_diagnostics, provided that
+ * at least one symbol look-up was performed.
+ *
+ * @param writer The writer.
+ * @param enabled If true, symbolication diagnostics will be written to the report.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_symbolication_diagnostics (plcrash_log_writer_t *writer, bool enabled) {
+    writer->symbolication_diagnostics = enabled;
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+}
+
+/**
+ * Enable or disable writing of writer diagnostics in all subsequent reports. When enabled, the crash path timing of
+ * the writer is written as CrashReport.report_info.writer_diagnostics, in a second report info record at the end of
+ * the report.
+ *
+ * @param writer The writer.
+ * @param enabled If true, writer diagnostics will be written to the report.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_writer_diagnostics (plcrash_log_writer_t *writer, bool enabled) {
+    writer->writer_diagnostics = enabled;
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+}
+
+/**
+ * Discard the base report recorded in @a baseline; the next report written against the baseline will be written
+ * in full, and will become the new base report.
+ *
+ * @param baseline The baseline to reset.
+ */
+void plcrash_log_writer_baseline_reset (plcrash_log_writer_baseline_t *baseline) {
+    baseline->valid = false;
+    baseline->thread_count = 0;
+    baseline->image_count = 0;
+}
+
+/**
+ * Enable the report-level symbol name table. When enabled, each unique symbol name is written once to the
+ * CrashReport.symbol_names table, and frame symbols refer to their names by index. Reports written with a symbol
+ * name table use the #PLCRASH_REPORT_FILE_VERSION_SYMBOL_NAMES file version, and are rejected as unsupported by
+ * readers that predate CrashReport.symbol_names.
+ *
+ * @param writer The writer.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_ENOMEM if the table could not be allocated.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+plcrash_error_t plcrash_log_writer_enable_symbol_names (plcrash_log_writer_t *writer) {
+    if (writer->symbol_names != NULL)
+        return PLCRASH_ESUCCESS;
+
+    /* The table is used from the async-safe report writing path, and must be allocated here. */
+    plcrash_log_writer_symbol_names_t *names = calloc(1, sizeof(*names));
+    if (names == NULL)
+        return PLCRASH_ENOMEM;
+
+    writer->symbol_names = names;
+
+    /* Ensure that any signal handler has a consistent view of the configuration. */
+    OSMemoryBarrier();
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Enable a symbol cache that persists across all reports written by @a writer. By default, the symbol cache
+ * (including the cached Objective-C metadata) is initialized and discarded by each call to
+ * plcrash_log_writer_write(); when enabled, the cache is instead retained, and is only discarded if the image list
+ * changes or an image is removed from it.
+ *
+ * This must only be enabled for writers used to produce multiple live reports; a crash report is written only
+ * once, and does not benefit from the cache.
+ *
+ * @param writer The writer.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_ENOMEM if the cache could not be allocated.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+plcrash_error_t plcrash_log_writer_enable_persistent_symbol_cache (plcrash_log_writer_t *writer) {
+    if (writer->symbol_cache != NULL)
+        return PLCRASH_ESUCCESS;
+
+    writer->symbol_cache = calloc(1, sizeof(*writer->symbol_cache));
+    if (writer->symbol_cache == NULL)
+        return PLCRASH_ENOMEM;
+
+    writer->symbol_cache_valid = false;
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Prepare @a writer to write a new report. The uncaught exception, if any, is discarded, and a new report UUID
+ * is generated. All other writer state, including the pre-encoded static report sections, is retained.
+ *
+ * @param writer The writer.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+plcrash_error_t plcrash_log_writer_reset (plcrash_log_writer_t *writer) {
+    /* Discard the exception data */
+    if (writer->uncaught_exception.has_exception) {
+        if (writer->uncaught_exception.name != NULL)
+            free(writer->uncaught_exception.name);
+
+        if (writer->uncaught_exception.reason != NULL)
+            free(writer->uncaught_exception.reason);
+
+        memset(&writer->uncaught_exception, 0, sizeof(writer->uncaught_exception));
+    }
+
+    /* Generate a new UUID, and re-encode the report info section in place; the encoded length is fixed. */
+    plcrash_writer_nasync_generate_uuid(writer);
+    if (writer->static_sections.data != NULL) {
+        plcrash_async_file_t file;
+        size_t length = writer->static_sections.report_info_length;
+
+        PLCF_ASSERT(plcrash_writer_write_report_info_record(NULL, writer) == length);
+        plcrash_async_file_init_buffer(&file, writer->static_sections.data, length);
+        plcrash_writer_write_report_info_record(&file, writer);
+        plcrash_async_file_close(&file);
+    }
+
+    /* Ensure that any signal handler has a consistent view of the above. */
+    OSMemoryBarrier();
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Set the uncaught exception for this writer. Once set, this exception will be used to
+ * provide exception data for the crash log output.
+ *
+ * @warning This function is not async safe, and must be called outside of a signal handler.
+ */
+void plcrash_log_writer_set_exception (plcrash_log_writer_t *writer, NSException *exception) {
+    assert(writer->uncaught_exception.has_exception == false);
+
+    /* Save the exception data */
+    writer->uncaught_exception.has_exception = true;
+    writer->uncaught_exception.name = strdup([[exception name] UTF8String]);
+    writer->uncaught_exception.reason = strdup([exception reason] != nil ? [[exception reason] UTF8String] : "");
+
+    /* Save the call stack, if available. Frames beyond PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES would not be written,
+     * and are discarded. */
+    size_t i = 0;
+    for (NSNumber *num in [exception callStackReturnAddresses]) {
+        if (i == PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES)
+            break;
+
+        writer->uncaught_exception.callstack[i++] = [num unsignedLongLongValue];
+    }
+    writer->uncaught_exception.callstack_count = i;
+
+    /* Ensure that any signal handler has a consistent view of the above initialization. */
+    OSMemoryBarrier();
+}
+
+/**
+ * Write the summary of the most recently written report to @a path, replacing any existing file. The summary
+ * should be written once the report itself has been completed, allowing readers to treat a missing or invalid
+ * summary as unavailable.
+ *
+ * @param writer The writer that wrote the report.
+ * @param path The summary output path.
+ * @param report_size The size of the completed report file, in bytes.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_EINTERNAL if the summary could not be written.
+ *
+ * @warning This function is async-safe.
+ */
+plcrash_error_t plcrash_log_writer_write_summary (plcrash_log_writer_t *writer, const char *path, uint64_t report_size) {
+    writer->summary.report_size = report_size;
+
+    int fd = open(path, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+    if (fd < 0) {
+        PLCF_DEBUG("Could not open the summary output file: %s", strerror(errno));
+        return PLCRASH_EINTERNAL;
+    }
+
+    ssize_t written = plcrash_async_writen(fd, &writer->summary, sizeof(writer->summary));
+    if (close(fd) != 0 || written != (ssize_t) sizeof(writer->summary)) {
+        PLCF_DEBUG("Failed to write the summary output file");
+        return PLCRASH_EINTERNAL;
+    }
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Close the plcrash_writer_t output.
+ *
+ * @param writer Writer instance to be closed.
+ */
+plcrash_error_t plcrash_log_writer_close (plcrash_log_writer_t *writer) {
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Free any crash log writer resources.
+ *
+ * @warning This method is not async safe.
+ */
+void plcrash_log_writer_free (plcrash_log_writer_t *writer) {
+    /* Free the app info */
+    if (writer->application_info.app_identifier != NULL)
+        free(writer->application_info.app_identifier);
+    if (writer->application_info.app_version != NULL)
+        free(writer->application_info.app_version);
+    if (writer->application_info.app_marketing_version != NULL)
+        free(writer->application_info.app_marketing_version);
+
+    /* Free the process info */
+    if (writer->process_info.process_name != NULL) 
+        free(writer->process_info.process_name);
+    if (writer->process_info.process_path != NULL) 
+        free(writer->process_info.process_path);
+    if (writer->process_info.parent_process_name != NULL) 
+        free(writer->process_info.parent_process_name);
+    
+    /* Free the system info */
+    if (writer->system_info.version != NULL)
+        free(writer->system_info.version);
+    
+    if (writer->system_info.build != NULL)
+        free(writer->system_info.build);
+    
+    /* Free the machine info */
+    if (writer->machine_info.model != NULL)
+        free(writer->machine_info.model);
+
+    /* Free the exception data */
+    if (writer->uncaught_exception.has_exception) {
+        if (writer->uncaught_exception.name != NULL)
+            free(writer->uncaught_exception.name);
+
+        if (writer->uncaught_exception.reason != NULL)
+            free(writer->uncaught_exception.reason);
+    }
+
+    /* Free the pre-encoded sections */
+    if (writer->static_sections.data != NULL)
+        free(writer->static_sections.data);
+
+    /* Free the thread capture buffer */
+    if (writer->thread_capture != NULL)
+        free(writer->thread_capture);
+
+    /* Free the symbol name table */
+    if (writer->symbol_names != NULL)
+        free(writer->symbol_names);
+
+    /* Free the symbolication scope and thread names */
+    plcrash_writer_free_symbolication_scope(writer->symbolication_scope, writer->symbolication_scope_count);
+    plcrash_writer_free_symbolication_scope(writer->symbolicated_thread_names, writer->symbolicated_thread_names_count);
+
+    /* Free the persistent symbol cache */
+    if (writer->symbol_cache != NULL) {
+        if (writer->symbol_cache_valid)
+            plcrash_async_symbol_cache_free(writer->symbol_cache);
+        free(writer->symbol_cache);
+    }
+
+    /* Release the target task and its main thread */
+    if (writer->task != mach_task_self() && writer->task != MACH_PORT_NULL) {
+        if (writer->main_thread != MACH_PORT_NULL)
+            mach_port_deallocate(mach_task_self(), writer->main_thread);
+        mach_port_deallocate(mach_task_self(), writer->task);
+    }
+}
+
+/**
+ * @internal
+ *
+ * Write the system info message fields that are fixed at initialization time; this excludes the timestamp.
+ *
+ * @param file Output file
+ */
+static size_t plcrash_writer_write_system_info_static (plcrash_async_file_t *file, plcrash_log_writer_t *writer) {
+    size_t rv = 0;
+    uint32_t enumval;
+
+    /* OS */
+    enumval = PLCrashReportHostOperatingSystem;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYSTEM_INFO_OS_ID, PLPROTOBUF_C_TYPE_ENUM, &enumval);
+
+    /* OS Version */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYSTEM_INFO_OS_VERSION_ID, PLPROTOBUF_C_TYPE_STRING, writer->system_info.version);
+    
+    /* OS Build */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYSTEM_INFO_OS_BUILD_ID, PLPROTOBUF_C_TYPE_STRING, writer->system_info.build);
+
+    /* Machine type */
+    enumval = PLCrashReportHostArchitecture;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYSTEM_INFO_ARCHITECTURE_TYPE_ID, PLPROTOBUF_C_TYPE_ENUM, &enumval);
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write the system info message timestamp field.
+ *
+ * @param file Output file
+ * @param timestamp Timestamp to use (seconds since epoch). Must be same across calls, as varint encoding.
+ */
+static size_t plcrash_writer_write_system_info_timestamp (plcrash_async_file_t *file, int64_t timestamp) {
+    return plcrash_writer_pack(file, PLCRASH_PROTO_SYSTEM_INFO_TIMESTAMP_ID, PLPROTOBUF_C_TYPE_INT64, &timestamp);
+}
+
+/**
+ * @internal
+ *
+ * Write the processor info message.
+ *
+ * @param file Output file
+ * @param cpu_type The Mach CPU type.
+ * @param cpu_subtype The Mach CPU subtype
+ */
+static size_t plcrash_writer_write_processor_info (plcrash_async_file_t *file, uint64_t cpu_type, uint64_t cpu_subtype) {
+    size_t rv = 0;
+    uint32_t enumval;
+    
+    /* Encoding */
+    enumval = PLCrashReportProcessorTypeEncodingMach;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESSOR_ENCODING_ID, PLPROTOBUF_C_TYPE_ENUM, &enumval);
+
+    /* Type */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESSOR_TYPE_ID, PLPROTOBUF_C_TYPE_UINT64, &cpu_type);
+
+    /* Subtype */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESSOR_SUBTYPE_ID, PLPROTOBUF_C_TYPE_UINT64, &cpu_subtype);
+    
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write the machine info message.
+ *
+ * @param file Output file
+ */
+static size_t plcrash_writer_write_machine_info (plcrash_async_file_t *file, plcrash_log_writer_t *writer) {
+    size_t rv = 0;
+    
+    /* Model */
+    if (writer->machine_info.model != NULL)
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_MACHINE_INFO_MODEL_ID, PLPROTOBUF_C_TYPE_STRING, writer->machine_info.model);
+
+    /* Processor */
+    {
+        plcrash_writer_reservation_t reservation;
+        uint32_t size;
+
+        if (plcrash_writer_pack_reserve(file, PLCRASH_PROTO_MACHINE_INFO_PROCESSOR_ID, &reservation)) {
+            /* Write message, patching in the size once complete */
+            plcrash_writer_write_processor_info(file, writer->machine_info.cpu_type, writer->machine_info.cpu_subtype);
+            rv += plcrash_writer_pack_commit(file, &reservation);
+        } else {
+            /* Determine size */
+            size = plcrash_writer_write_processor_info(NULL, writer->machine_info.cpu_type, writer->machine_info.cpu_subtype);
+
+            /* Write message */
+            rv += plcrash_writer_pack(file, PLCRASH_PROTO_MACHINE_INFO_PROCESSOR_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+            rv += plcrash_writer_write_processor_info(file, writer->machine_info.cpu_type, writer->machine_info.cpu_subtype);
+        }
+    }
+
+    /* Physical Processor Count */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_MACHINE_INFO_PROCESSOR_COUNT_ID, PLPROTOBUF_C_TYPE_UINT32, &writer->machine_info.processor_count);
+    
+    /* Logical Processor Count */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_MACHINE_INFO_LOGICAL_PROCESSOR_COUNT_ID, PLPROTOBUF_C_TYPE_UINT32, &writer->machine_info.logical_processor_count);
+    
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write the app info message.
+ *
+ * @param file Output file
+ * @param app_identifier Application identifier
+ * @param app_version Application version
+ * @param app_marketing_version Application marketing version
+ */
+static size_t plcrash_writer_write_app_info (plcrash_async_file_t *file, const char *app_identifier, const char *app_version, const char *app_marketing_version) {
+    size_t rv = 0;
+
+    /* App identifier */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_APP_INFO_APP_IDENTIFIER_ID, PLPROTOBUF_C_TYPE_STRING, app_identifier);
+    
+    /* App version */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_APP_INFO_APP_VERSION_ID, PLPROTOBUF_C_TYPE_STRING, app_version);
+    
+    /* App marketing version */
+    if (app_marketing_version != NULL)
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_APP_INFO_APP_MARKETING_VERSION_ID, PLPROTOBUF_C_TYPE_STRING, app_marketing_version);
+    
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write the process info message.
+ *
+ * @param file Output file
+ * @param process_name Process name, or NULL if unavailable.
+ * @param process_id Process ID
+ * @param process_path Process path, or NULL if unavailable.
+ * @param parent_process_name Parent process name, or NULL if unavailable.
+ * @param parent_process_id Parent process ID
+ * @param native If false, process is running under emulation.
+ * @param start_time The start time of the process.
+ * @param shared_cache The process' dyld shared cache, or NULL if unavailable.
+ */
+static size_t plcrash_writer_write_process_info (plcrash_async_file_t *file, const char *process_name,
+                                                 const pid_t process_id, const char *process_path, 
+                                                 const char *parent_process_name, const pid_t parent_process_id,
+                                                 bool native, time_t start_time,
+                                                 const plcrash_async_shared_cache_t *shared_cache)
+{
+    size_t rv = 0;
+    uint64_t tval;
+
+    /*
+     * In the current crash reporter serialization format, pid values are serialized as unsigned 32-bit integers. This
+     * conforms with the actual implementation of pid_t on both 32-bit and 64-bit Darwin systems. To conform with
+     * SuSV3, however, the values should be encoded as signed integers; the actual width of the type being implementation
+     * defined.
+     *
+     * To maintain compatibility with existing report readers the values remain encoded as unsigned 32-bit integers,
+     * but should be updated to int64 values in future major revision of the data format.
+     */
+    uint32_t pidval;
+
+    /* Process name */
+    if (process_name != NULL)
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_PROCESS_NAME_ID, PLPROTOBUF_C_TYPE_STRING, process_name);
+
+    /* Process ID */
+    pidval = process_id;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_PROCESS_ID_ID, PLPROTOBUF_C_TYPE_UINT32, &pidval);
+
+    /* Process path */
+    if (process_path != NULL)
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_PROCESS_PATH_ID, PLPROTOBUF_C_TYPE_STRING, process_path);
+    
+    /* Parent process name */
+    if (parent_process_name != NULL)
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_PARENT_PROCESS_NAME_ID, PLPROTOBUF_C_TYPE_STRING, parent_process_name);
+    
+
+    /* Parent process ID */
+    pidval = parent_process_id;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_PARENT_PROCESS_ID_ID, PLPROTOBUF_C_TYPE_UINT32, &pidval);
+
+    /* Native process. */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_NATIVE_ID, PLPROTOBUF_C_TYPE_BOOL, &native);
+    
+    /* Start time */
+    tval = start_time;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_START_TIME_ID, PLPROTOBUF_C_TYPE_UINT64, &tval);
+
+    /* Shared cache */
+    if (shared_cache != NULL) {
+        if (shared_cache->has_uuid) {
+            PLProtobufCBinaryData binary;
+            binary.len = sizeof(shared_cache->uuid);
+            binary.data = (void *) shared_cache->uuid;
+            rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_SHARED_CACHE_UUID_ID, PLPROTOBUF_C_TYPE_BYTES, &binary);
+        }
+
+        if (shared_cache->base_address != 0) {
+            tval = shared_cache->base_address;
+            rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_SHARED_CACHE_BASE_ADDRESS_ID, PLPROTOBUF_C_TYPE_UINT64, &tval);
+        }
+    }
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write a single register.
+ *
+ * @param file Output file
+ * @param regname The register to write's name.
+ * @param regval The register to write's value.
+ */
+static size_t plcrash_writer_write_thread_register (plcrash_async_file_t *file, const char *regname, plcrash_greg_t regval) {
+    uint64_t uint64val;
+    size_t rv = 0;
+
+    /* Write the name */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_REGISTER_NAME_ID, PLPROTOBUF_C_TYPE_STRING, regname);
+
+    /* Write the value */
+    uint64val = regval;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_REGISTER_VALUE_ID, PLPROTOBUF_C_TYPE_UINT64, &uint64val);
+    
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write all thread backtrace register messages
+ *
+ * @param file Output file
+ * @param capture The thread capture from which to acquire frame registers.
+ */
+static size_t plcrash_writer_write_thread_registers (plcrash_async_file_t *file, plcrash_log_writer_thread_capture_t *capture) {
+    size_t rv = 0;
+    
+    /* Write out register messages */
+    for (uint32_t i = 0; i < capture->register_count; i++) {
+        plcrash_log_writer_register_t *reg = &capture->registers[i];
+        plcrash_writer_reservation_t reservation;
+        uint32_t msgsize;
+
+        /* Write the header and message in a single pass, if supported by the output */
+        if (plcrash_writer_pack_reserve(file, PLCRASH_PROTO_THREAD_REGISTERS_ID, &reservation)) {
+            plcrash_writer_write_thread_register(file, reg->name, reg->value);
+            rv += plcrash_writer_pack_commit(file, &reservation);
+            continue;
+        }
+
+        /* Get the register message size */
+        msgsize = plcrash_writer_write_thread_register(NULL, reg->name, reg->value);
+        
+        /* Write the header and message */
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_REGISTERS_ID, PLPROTOBUF_C_TYPE_MESSAGE, &msgsize);
+        rv += plcrash_writer_write_thread_register(file, reg->name, reg->value);
+    }
+    
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write the captured registers as a single packed array of values, in canonical plcrash_regnum_t order.
+ *
+ * @param file Output file
+ * @param capture The thread capture from which to acquire frame registers.
+ */
+static size_t plcrash_writer_write_register_state (plcrash_async_file_t *file, plcrash_log_writer_thread_capture_t *capture) {
+    uint64_t *values = capture->packed_values;
+
+    for (uint32_t i = 0; i < capture->register_count; i++)
+        values[i] = capture->registers[i].value;
+
+    return plcrash_writer_pack_packed(file, PLCRASH_PROTO_THREAD_REGISTER_STATE_ID, PLPROTOBUF_C_TYPE_UINT64, values, capture->register_count);
+}
+
+/**
+ * @internal
+ *
+ * Write a symbol
+ *
+ * @param file Output file
+ * @param name The symbol name, or NULL if the name is to be referenced by @a name_index.
+ * @param name_index The index of the symbol name within the report's symbol name table. Ignored if @a name is non-NULL.
+ * @param start_address The symbol start address
+ */
+static size_t plcrash_writer_write_symbol (plcrash_async_file_t *file, const char *name, uint32_t name_index, uint64_t start_address) {
+    size_t rv = 0;
+    
+    /* name, or name_index */
+    if (name != NULL) {
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYMBOL_NAME, PLPROTOBUF_C_TYPE_STRING, name);
+    } else {
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYMBOL_NAME_INDEX, PLPROTOBUF_C_TYPE_UINT32, &name_index);
+    }
+    
+    /* start_address */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYMBOL_START_ADDRESS, PLPROTOBUF_C_TYPE_UINT64, &start_address);
+    
+    return rv;
+}
+
+/**
+ * @internal
+ * Symbol lookup callback context
+ */
+struct pl_symbol_cb_ctx {
+    /** File to use for writing out a symbol entry. May be NULL. */
+    plcrash_async_file_t *file;
+
+    /** Size of the symbol entry, to be written by the callback function upon writing an entry. */
+    uint32_t msgsize;
+};
+
+/**
+ * @internal
+ *
+ * pl_async_macho_found_symbol_cb callback implementation. Writes the result to the file available via @a ctx,
+ * which must be a valid pl_symbol_cb_ctx structure.
+ */
+static void plcrash_writer_write_thread_frame_symbol_cb (pl_vm_address_t address, const char *name, void *ctx) {
+    struct pl_symbol_cb_ctx *cb_ctx = ctx;
+    cb_ctx->msgsize = plcrash_writer_write_symbol(cb_ctx->file, name, 0, address);
+}
+
+/**
+ * @internal
+ *
+ * Return the task_threads() index of the thread to be written at position @a n. The @a first and @a second threads
+ * are written ahead of all others, followed by the remaining threads in task_threads() order.
+ *
+ * @param n The write position.
+ * @param count The total number of threads.
+ * @param first The index of the thread to write first, or @a count if none.
+ * @param second The index of the thread to write second, or @a count if none.
+ */
+static mach_msg_type_number_t plcrash_writer_thread_write_index (mach_msg_type_number_t n,
+                                                                 mach_msg_type_number_t count,
+                                                                 mach_msg_type_number_t first,
+                                                                 mach_msg_type_number_t second)
+{
+    mach_msg_type_number_t prioritized[2];
+    mach_msg_type_number_t prioritized_count = 0;
+
+    if (first < count)
+        prioritized[prioritized_count++] = first;
+
+    if (second < count && second != first)
+        prioritized[prioritized_count++] = second;
+
+    if (n < prioritized_count)
+        return prioritized[n];
+
+    /* Skip over the prioritized threads, in index order */
+    if (prioritized_count == 2 && prioritized[0] > prioritized[1]) {
+        mach_msg_type_number_t tmp = prioritized[0];
+        prioritized[0] = prioritized[1];
+        prioritized[1] = tmp;
+    }
+
+    mach_msg_type_number_t i = n - prioritized_count;
+    for (mach_msg_type_number_t j = 0; j < prioritized_count; j++) {
+        if (prioritized[j] <= i)
+            i++;
+    }
+
+    return i;
+}
+
+/**
+ * @internal
+ *
+ * Return true if the current report's capture deadline has passed.
+ *
+ * @param writer The writer context.
+ */
+static bool plcrash_writer_past_deadline (plcrash_log_writer_t *writer) {
+    return writer->deadline != 0 && mach_absolute_time() >= writer->deadline;
+}
+
+/**
+ * @internal
+ *
+ * Return the number of additional frames that may be symbolicated within the current report's capture budget.
+ *
+ * @param writer The writer context.
+ */
+static uint32_t plcrash_writer_symbolication_remaining (plcrash_log_writer_t *writer) {
+    if (plcrash_writer_past_deadline(writer))
+        return 0;
+
+    if (writer->budget.max_symbolicated_frames == 0)
+        return UINT32_MAX;
+
+    if (writer->symbolicated_frames >= writer->budget.max_symbolicated_frames)
+        return 0;
+
+    return writer->budget.max_symbolicated_frames - writer->symbolicated_frames;
+}
+
+/**
+ * @internal
+ *
+ * Return true if frames within @a image should be symbolicated, as per the writer's symbolication scope.
+ *
+ * @param writer The writer.
+ * @param image The image containing the frame.
+ */
+static bool plcrash_writer_symbolication_in_scope (plcrash_log_writer_t *writer, plcrash_async_macho_t *image) {
+    size_t count = writer->symbolication_scope_count;
+    if (count == 0)
+        return true;
+
+    if (image->name == NULL)
+        return false;
+
+    for (size_t i = 0; i < count; i++) {
+        const plcrash_log_writer_scope_path_t *entry = &writer->symbolication_scope[i];
+        if (plcrash_async_strncmp(image->name, entry->path, entry->length) != 0)
+            continue;
+
+        /* Only match whole path components */
+        char next = image->name[entry->length];
+        if (entry->length == 0 || next == '\0' || next == '/' || entry->path[entry->length - 1] == '/')
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * @internal
+ *
+ * Write a thread backtrace frame
+ *
+ * @param file Output file
+ * @param pcval The frame PC value.
+ * @param symbolicate If false, only the frame's PC will be written. This must not vary between the sizing and
+ * writing passes over the frame.
+ */
+static size_t plcrash_writer_write_thread_frame (plcrash_async_file_t *file, plcrash_log_writer_t *writer, uint64_t pcval, plcrash_async_image_list_t *image_list, plcrash_async_symbol_cache_t *findContext, bool symbolicate) {
+    size_t rv = 0;
+
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_FRAME_PC_ID, PLPROTOBUF_C_TYPE_UINT64, &pcval);
+    if (!symbolicate)
+        return rv;
+    
+    plcrash_async_image_list_set_reading(image_list, true);
+    plcrash_async_image_t *image = plcrash_async_image_containing_address(image_list, (pl_vm_address_t) pcval);
+    
+    if (image != NULL && writer->symbol_strategy != PLCRASH_ASYNC_SYMBOL_STRATEGY_NONE && plcrash_writer_symbolication_in_scope(writer, &image->macho_image)) {
+        struct pl_symbol_cb_ctx ctx;
+        plcrash_error_t ret;
+        
+        /* Get the symbol message size. If the symbol can not be found, our callback will not be called. If the symbol is found,
+         * our callback is called and PLCRASH_ESUCCESS is returned. */
+        ctx.file = NULL;
+        ctx.msgsize = 0x0;
+        ret = plcrash_async_find_symbol(&image->macho_image, writer->symbol_strategy, findContext, (pl_vm_address_t) pcval, plcrash_writer_write_thread_frame_symbol_cb, &ctx);
+        if (ret == PLCRASH_ESUCCESS) {
+            /* Write the header and message */
+            rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_FRAME_SYMBOL_ID, PLPROTOBUF_C_TYPE_MESSAGE, &ctx.msgsize);
+
+            ctx.file = file;
+            ret = plcrash_async_find_symbol(&image->macho_image, writer->symbol_strategy, findContext, (pl_vm_address_t) pcval, plcrash_writer_write_thread_frame_symbol_cb, &ctx);
+            if (ret == PLCRASH_ESUCCESS) {
+                rv += ctx.msgsize;
+            } else {
+                /* This should not happen, but it would be very confusing if it did and nothing was logged. */
+                PLCF_DEBUG("Fetching the symbol unexpectedly failed during the second call");
+            }
+        }
+    }
+
+    plcrash_async_image_list_set_reading(image_list, false);
+
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Reset @a names to an empty table.
+ *
+ * @param names The table to reset.
+ */
+static void plcrash_writer_symbol_names_reset (plcrash_log_writer_symbol_names_t *names) {
+    names->count = 0;
+    names->written = 0;
+    names->pool_used = 0;
+    plcrash_async_memset(names->buckets, 0, sizeof(names->buckets));
+}
+
+/**
+ * @internal
+ *
+ * Find or insert @a name within @a names.
+ *
+ * @param names The symbol name table.
+ * @param name The NULL-terminated symbol name.
+ * @param[out] index On success, the index of @a name within the table.
+ *
+ * @return Returns true on success, or false if the table is full.
+ */
+static bool plcrash_writer_symbol_names_intern (plcrash_log_writer_symbol_names_t *names, const char *name, uint32_t *index) {
+    const size_t mask = (sizeof(names->buckets) / sizeof(names->buckets[0])) - 1;
+
+    /* FNV-1a */
+    uint32_t hash = 2166136261U;
+    size_t len = 0;
+    for (const char *p = name; *p != '\0'; p++, len++) {
+        hash ^= (uint8_t) *p;
+        hash *= 16777619U;
+    }
+    len++;
+
+    /* Probe for an existing entry; the table is at most half full, so an empty bucket will always be found */
+    size_t bucket = hash & mask;
+    while (names->buckets[bucket] != 0) {
+        uint32_t candidate = names->buckets[bucket] - 1;
+        if (plcrash_async_strcmp(names->pool + names->offsets[candidate], name) == 0) {
+            *index = candidate;
+            return true;
+        }
+
+        bucket = (bucket + 1) & mask;
+    }
+
+    /* Insert a new entry */
+    if (names->count == PLCRASH_LOG_WRITER_MAX_SYMBOL_NAMES || len > sizeof(names->pool) - names->pool_used)
+        return false;
+
+    plcrash_async_memcpy(names->pool + names->pool_used, name, len);
+    names->offsets[names->count] = (uint32_t) names->pool_used;
+    names->pool_used += len;
+
+    *index = names->count;
+    names->buckets[bucket] = ++names->count;
+    return true;
+}
+
+/**
+ * @internal
+ *
+ * Write the symbol name table records added since the previous call. The table's records may be interleaved with
+ * other top-level fields; the decoder concatenates repeated fields in the order they appear.
+ *
+ * @param file Output file
+ * @param names The symbol name table.
+ */
+static size_t plcrash_writer_write_symbol_names (plcrash_async_file_t *file, plcrash_log_writer_symbol_names_t *names) {
+    size_t rv = 0;
+
+    for (; names->written < names->count; names->written++)
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYMBOL_NAMES_ID, PLPROTOBUF_C_TYPE_STRING, names->pool + names->offsets[names->written]);
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write the symbolication diagnostics message.
+ *
+ * @param file Output file
+ * @param cache The symbol cache used for all of the report's symbol look-ups.
+ */
+static size_t plcrash_writer_write_symbolication_diagnostics (plcrash_async_file_t *file, plcrash_async_symbol_cache_t *cache) {
+    mach_timebase_info_data_t timebase;
+    size_t rv = 0;
+    uint32_t u32;
+    uint64_t u64;
+
+    /* Fall back on reporting mach_absolute_time() units if the timebase is unavailable */
+    if (mach_timebase_info(&timebase) != KERN_SUCCESS || timebase.denom == 0) {
+        timebase.numer = 1;
+        timebase.denom = 1;
+    }
+
+    u32 = cache->pc_cache_hits + cache->pc_cache_misses;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_LOOKUPS_ID, PLPROTOBUF_C_TYPE_UINT32, &u32);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_CACHE_HITS_ID, PLPROTOBUF_C_TYPE_UINT32, &cache->pc_cache_hits);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_SYMBOLS_SCANNED_ID, PLPROTOBUF_C_TYPE_UINT64, &cache->symbols_scanned);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_OBJC_CLASSES_PARSED_ID, PLPROTOBUF_C_TYPE_UINT32, &cache->objc_cache.classParseCount);
+
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_SYMBOL_TABLE_LOOKUPS_ID, PLPROTOBUF_C_TYPE_UINT32, &cache->symbol_table_stats.lookups);
+    u64 = cache->symbol_table_stats.elapsed * timebase.numer / timebase.denom;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_SYMBOL_TABLE_TIME_ID, PLPROTOBUF_C_TYPE_UINT64, &u64);
+
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_OBJC_LOOKUPS_ID, PLPROTOBUF_C_TYPE_UINT32, &cache->objc_stats.lookups);
+    u64 = cache->objc_stats.elapsed * timebase.numer / timebase.denom;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_OBJC_TIME_ID, PLPROTOBUF_C_TYPE_UINT64, &u64);
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write a single thread timing message.
+ *
+ * @param file Output file
+ * @param timing The thread's timing.
+ * @param timebase The timebase used to convert mach_absolute_time() units to nanoseconds.
+ */
+static size_t plcrash_writer_write_thread_timing (plcrash_async_file_t *file, plcrash_log_writer_thread_timing_t *timing, mach_timebase_info_data_t *timebase) {
+    size_t rv = 0;
+    uint64_t u64;
+
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_TIMING_THREAD_NUMBER_ID, PLPROTOBUF_C_TYPE_UINT32, &timing->thread_number);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_TIMING_FRAME_COUNT_ID, PLPROTOBUF_C_TYPE_UINT32, &timing->frame_count);
+
+    u64 = timing->walk_time * timebase->numer / timebase->denom;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_TIMING_WALK_TIME_ID, PLPROTOBUF_C_TYPE_UINT64, &u64);
+
+    u64 = timing->symbolication_time * timebase->numer / timebase->denom;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_TIMING_SYMBOLICATION_TIME_ID, PLPROTOBUF_C_TYPE_UINT64, &u64);
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write the writer diagnostics message.
+ *
+ * @param file Output file
+ * @param timings The report's crash path timing.
+ * @param total_time The total time elapsed while writing the report, in mach_absolute_time() units.
+ * @param timebase The timebase used to convert mach_absolute_time() units to nanoseconds.
+ */
+static size_t plcrash_writer_write_writer_diagnostics (plcrash_async_file_t *file, plcrash_log_writer_timings_t *timings, uint64_t total_time, mach_timebase_info_data_t *timebase) {
+    size_t rv = 0;
+    uint64_t u64;
+
+    u64 = timings->suspend_time * timebase->numer / timebase->denom;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_WRITER_DIAGNOSTICS_SUSPEND_TIME_ID, PLPROTOBUF_C_TYPE_UINT64, &u64);
+
+    for (uint32_t i = 0; i < timings->thread_count; i++) {
+        uint32_t size = (uint32_t) plcrash_writer_write_thread_timing(NULL, &timings->threads[i], timebase);
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_WRITER_DIAGNOSTICS_THREADS_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+        rv += plcrash_writer_write_thread_timing(file, &timings->threads[i], timebase);
+    }
+
+    u64 = timings->image_time * timebase->numer / timebase->denom;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_WRITER_DIAGNOSTICS_IMAGE_TIME_ID, PLPROTOBUF_C_TYPE_UINT64, &u64);
+
+    u64 = total_time * timebase->numer / timebase->denom;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_WRITER_DIAGNOSTICS_TOTAL_TIME_ID, PLPROTOBUF_C_TYPE_UINT64, &u64);
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write the trailing report info message, containing the writer diagnostics. The report info's required fields are
+ * repeated, and the message is merged with the leading report info message when decoded.
+ *
+ * @param file Output file
+ * @param writer The writer context.
+ * @param total_time The total time elapsed while writing the report, in mach_absolute_time() units.
+ * @param timebase The timebase used to convert mach_absolute_time() units to nanoseconds.
+ */
+static size_t plcrash_writer_write_report_info_diagnostics (plcrash_async_file_t *file, plcrash_log_writer_t *writer, uint64_t total_time, mach_timebase_info_data_t *timebase) {
+    size_t rv = 0;
+    uint32_t size;
+
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_REPORT_INFO_USER_REQUESTED_ID, PLPROTOBUF_C_TYPE_BOOL, &writer->report_info.user_requested);
+
+    size = (uint32_t) plcrash_writer_write_writer_diagnostics(NULL, &writer->timings, total_time, timebase);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_REPORT_INFO_WRITER_DIAGNOSTICS_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+    rv += plcrash_writer_write_writer_diagnostics(file, &writer->timings, total_time, timebase);
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Record the stack walk timing of a thread, returning the thread's timing record, or NULL if the timing limit
+ * has been reached.
+ *
+ * @param writer The writer context.
+ * @param thread_number The thread's number.
+ * @param frame_count The number of frames walked.
+ * @param walk_time The time spent walking the thread's stack, in mach_absolute_time() units.
+ */
+static plcrash_log_writer_thread_timing_t *plcrash_writer_record_thread_walk (plcrash_log_writer_t *writer, uint32_t thread_number, uint32_t frame_count, uint64_t walk_time) {
+    if (writer->timings.thread_count >= PLCRASH_LOG_WRITER_MAX_THREAD_TIMINGS)
+        return NULL;
+
+    plcrash_log_writer_thread_timing_t *timing = &writer->timings.threads[writer->timings.thread_count++];
+    timing->thread_number = thread_number;
+    timing->frame_count = frame_count;
+    timing->walk_time = walk_time;
+    timing->symbolication_time = 0;
+
+    return timing;
+}
+
+/**
+ * @internal
+ *
+ * Write a single sampled stack message.
+ *
+ * @param file Output file
+ * @param sample The sampled stack.
+ */
+static size_t plcrash_writer_write_stack_sample (plcrash_async_file_t *file, plcrash_stack_sample_t *sample) {
+    size_t rv = 0;
+
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_STACK_SAMPLES_STACK_THREAD_INDEX_ID, PLPROTOBUF_C_TYPE_UINT32, &sample->thread_index);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_STACK_SAMPLES_STACK_COUNT_ID, PLPROTOBUF_C_TYPE_UINT32, &sample->count);
+
+    for (uint32_t i = 0; i < sample->frame_count; i++) {
+        uint64_t pc = sample->pcs[i];
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_STACK_SAMPLES_STACK_PCS_ID, PLPROTOBUF_C_TYPE_UINT64, &pc);
+    }
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write the stack samples message. The caller must hold the sampler's lock.
+ *
+ * @param file Output file
+ * @param sampler The stack sampler.
+ */
+static size_t plcrash_writer_write_stack_samples (plcrash_async_file_t *file, plcrash_stack_sampler_t *sampler) {
+    size_t rv = 0;
+
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_STACK_SAMPLES_INTERVAL_ID, PLPROTOBUF_C_TYPE_UINT64, &sampler->interval);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_STACK_SAMPLES_SAMPLE_COUNT_ID, PLPROTOBUF_C_TYPE_UINT32, &sampler->total_samples);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_STACK_SAMPLES_EVICTED_COUNT_ID, PLPROTOBUF_C_TYPE_UINT32, &sampler->evicted_samples);
+
+    for (uint32_t i = 0; i < sampler->count; i++) {
+        uint32_t size;
+
+        /* Determine the size */
+        size = (uint32_t) plcrash_writer_write_stack_sample(NULL, &sampler->samples[i]);
+
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_STACK_SAMPLES_STACKS_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+        rv += plcrash_writer_write_stack_sample(file, &sampler->samples[i]);
+    }
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write the custom data message.
+ *
+ * @param file Output file
+ * @param key_value_area The key/value area, or NULL if none.
+ * @param breadcrumbs The breadcrumb buffer, or NULL if none.
+ */
+static size_t plcrash_writer_write_custom_data (plcrash_async_file_t *file, PLProtobufCBinaryData *key_value_area, PLProtobufCBinaryData *breadcrumbs) {
+    size_t rv = 0;
+
+    if (key_value_area != NULL)
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_CUSTOM_DATA_KEY_VALUE_AREA_ID, PLPROTOBUF_C_TYPE_BYTES, key_value_area);
+
+    if (breadcrumbs != NULL)
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_CUSTOM_DATA_BREADCRUMBS_ID, PLPROTOBUF_C_TYPE_BYTES, breadcrumbs);
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * A VM region recorded in a report's memory statistics.
+ */
+typedef struct plcrash_writer_memory_region {
+    /** The region's start address. */
+    uint64_t address;
+
+    /** The region's size, in bytes. */
+    uint64_t size;
+
+    /** The region's current protection. */
+    uint32_t protection;
+
+    /** The region's VM user tag. */
+    uint32_t user_tag;
+} plcrash_writer_memory_region_t;
+
+/**
+ * @internal
+ *
+ * Memory statistics captured for a report.
+ */
+typedef struct plcrash_writer_memory_stats {
+    /** The task's VM statistics. */
+    task_vm_info_data_t vm_info;
+
+    /** The largest regions walked, largest first. */
+    plcrash_writer_memory_region_t regions[PLCRASH_LOG_WRITER_MEMORY_REGION_COUNT];
+
+    /** Number of valid entries in @a regions. */
+    uint32_t region_count;
+
+    /** If true, the region walk ended at PLCRASH_LOG_WRITER_MEMORY_REGION_WALK_LIMIT. */
+    bool regions_truncated;
+} plcrash_writer_memory_stats_t;
+
+/**
+ * @internal
+ *
+ * Capture the memory statistics of @a task.
+ *
+ * @param task The task for which statistics will be captured.
+ * @param stats The statistics to populate.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_EINTERNAL if the task's VM statistics could not be fetched.
+ * The region summary is best-effort, and its failure is not reported.
+ */
+static plcrash_error_t plcrash_writer_capture_memory_stats (task_t task, plcrash_writer_memory_stats_t *stats) {
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+    kern_return_t kr;
+
+    /* Zero-fill any fields not populated by an older kernel */
+    plcrash_async_memset(&stats->vm_info, 0, sizeof(stats->vm_info));
+    stats->region_count = 0;
+    stats->regions_truncated = false;
+
+    if ((kr = task_info(task, TASK_VM_INFO, (task_info_t) &stats->vm_info, &count)) != KERN_SUCCESS) {
+        PLCF_DEBUG("Fetching TASK_VM_INFO failed: %d", kr);
+        return PLCRASH_EINTERNAL;
+    }
+
+    /* Walk the top-level regions, retaining the largest in descending order of size. Submaps (eg, the shared cache)
+     * are recorded as a single region. */
+    pl_vm_address_t addr = 0;
+    for (uint32_t walked = 0; ; walked++) {
+        vm_region_submap_short_info_data_64_t info;
+        mach_msg_type_number_t info_count = VM_REGION_SUBMAP_SHORT_INFO_COUNT_64;
+        natural_t depth = 0;
+
+        if (walked == PLCRASH_LOG_WRITER_MEMORY_REGION_WALK_LIMIT) {
+            stats->regions_truncated = true;
+            break;
+        }
+
+#ifdef PL_HAVE_MACH_VM
+        mach_vm_address_t r_addr = addr;
+        mach_vm_size_t r_size;
+        kr = mach_vm_region_recurse(task, &r_addr, &r_size, &depth, (vm_region_recurse_info_t) &info, &info_count);
+#else
+        vm_address_t r_addr = addr;
+        vm_size_t r_size;
+        kr = vm_region_recurse_64(task, &r_addr, &r_size, &depth, (vm_region_recurse_info_t) &info, &info_count);
+#endif
+        /* KERN_INVALID_ADDRESS marks the end of the address space */
+        if (kr != KERN_SUCCESS)
+            break;
+
+        /* Insert the region, if it is among the largest found */
+        uint32_t idx = stats->region_count;
+        while (idx > 0 && stats->regions[idx - 1].size < r_size) {
+            if (idx < PLCRASH_LOG_WRITER_MEMORY_REGION_COUNT)
+                stats->regions[idx] = stats->regions[idx - 1];
+            idx--;
+        }
+
+        if (idx < PLCRASH_LOG_WRITER_MEMORY_REGION_COUNT) {
+            stats->regions[idx].address = r_addr;
+            stats->regions[idx].size = r_size;
+            stats->regions[idx].protection = (uint32_t) info.protection;
+            stats->regions[idx].user_tag = info.user_tag;
+            if (stats->region_count < PLCRASH_LOG_WRITER_MEMORY_REGION_COUNT)
+                stats->region_count++;
+        }
+
+        /* Advance to the next region, stopping on overflow */
+        if (r_addr + r_size <= addr)
+            break;
+        addr = (pl_vm_address_t) (r_addr + r_size);
+    }
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * @internal
+ *
+ * Write a single memory region message.
+ *
+ * @param file Output file
+ * @param region The region.
+ */
+static size_t plcrash_writer_write_memory_region (plcrash_async_file_t *file, plcrash_writer_memory_region_t *region) {
+    size_t rv = 0;
+
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_MEMORY_STATISTICS_REGION_ADDRESS_ID, PLPROTOBUF_C_TYPE_UINT64, &region->address);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_MEMORY_STATISTICS_REGION_SIZE_ID, PLPROTOBUF_C_TYPE_UINT64, &region->size);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_MEMORY_STATISTICS_REGION_PROTECTION_ID, PLPROTOBUF_C_TYPE_UINT32, &region->protection);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_MEMORY_STATISTICS_REGION_USER_TAG_ID, PLPROTOBUF_C_TYPE_UINT32, &region->user_tag);
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write the memory statistics message.
+ *
+ * @param file Output file
+ * @param stats The captured memory statistics.
+ */
+static size_t plcrash_writer_write_memory_stats (plcrash_async_file_t *file, plcrash_writer_memory_stats_t *stats) {
+    size_t rv = 0;
+    uint64_t value;
+    uint32_t region_count;
+
+    value = stats->vm_info.phys_footprint;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_MEMORY_STATISTICS_PHYS_FOOTPRINT_ID, PLPROTOBUF_C_TYPE_UINT64, &value);
+
+    value = stats->vm_info.resident_size;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_MEMORY_STATISTICS_RESIDENT_SIZE_ID, PLPROTOBUF_C_TYPE_UINT64, &value);
+
+    value = stats->vm_info.resident_size_peak;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_MEMORY_STATISTICS_RESIDENT_SIZE_PEAK_ID, PLPROTOBUF_C_TYPE_UINT64, &value);
+
+    value = stats->vm_info.compressed;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_MEMORY_STATISTICS_COMPRESSED_SIZE_ID, PLPROTOBUF_C_TYPE_UINT64, &value);
+
+    value = stats->vm_info.virtual_size;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_MEMORY_STATISTICS_VIRTUAL_SIZE_ID, PLPROTOBUF_C_TYPE_UINT64, &value);
+
+    region_count = (uint32_t) stats->vm_info.region_count;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_MEMORY_STATISTICS_REGION_COUNT_ID, PLPROTOBUF_C_TYPE_UINT32, &region_count);
+
+    for (uint32_t i = 0; i < stats->region_count; i++) {
+        uint32_t size;
+
+        /* Calculate the message size */
+        size = (uint32_t) plcrash_writer_write_memory_region(NULL, &stats->regions[i]);
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_MEMORY_STATISTICS_LARGEST_REGIONS_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+        rv += plcrash_writer_write_memory_region(file, &stats->regions[i]);
+    }
+
+    if (stats->regions_truncated)
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_MEMORY_STATISTICS_REGIONS_TRUNCATED_ID, PLPROTOBUF_C_TYPE_BOOL, &stats->regions_truncated);
+
+    return rv;
+}
+
+/**
+ * @internal
+ * Symbol capture callback context
+ */
+struct pl_symbol_capture_ctx {
+    /** Capture buffer from which the symbol name should be allocated. */
+    plcrash_log_writer_thread_capture_t *capture;
+
+    /** The report-level symbol name table, or NULL if names are to be stored in the capture buffer. */
+    plcrash_log_writer_symbol_names_t *symbol_names;
+
+    /** Frame to be populated by the callback function. */
+    plcrash_log_writer_frame_t *frame;
+};
+
+/**
+ * @internal
+ *
+ * pl_async_macho_found_symbol_cb callback implementation. Copies the result to the capture frame available via @a ctx,
+ * which must be a valid pl_symbol_capture_ctx structure.
+ */
+static void plcrash_writer_capture_frame_symbol_cb (pl_vm_address_t address, const char *name, void *ctx) {
+    struct pl_symbol_capture_ctx *cb_ctx = ctx;
+    plcrash_log_writer_thread_capture_t *capture = cb_ctx->capture;
+    plcrash_log_writer_frame_t *frame = cb_ctx->frame;
+
+    /* Prefer the report-level name table; if full, fall back on the capture's pool */
+    if (cb_ctx->symbol_names != NULL && plcrash_writer_symbol_names_intern(cb_ctx->symbol_names, name, &frame->symbol_name_index)) {
+        frame->symbol_state = PLCRASH_LOG_WRITER_FRAME_SYMBOL_INDEXED;
+        frame->symbol_start = address;
+        return;
+    }
+
+    size_t len = strlen(name) + 1;
+
+    /* If the name won't fit in the remaining pool space, defer symbol lookup until the frame is encoded. */
+    if (len > sizeof(capture->symbol_pool) - capture->symbol_pool_used) {
+        frame->symbol_state = PLCRASH_LOG_WRITER_FRAME_SYMBOL_DEFERRED;
+        return;
+    }
+
+    char *dest = capture->symbol_pool + capture->symbol_pool_used;
+    plcrash_async_memcpy(dest, name, len);
+    capture->symbol_pool_used += len;
+
+    frame->symbol_state = PLCRASH_LOG_WRITER_FRAME_SYMBOL_CAPTURED;
+    frame->symbol_start = address;
+    frame->symbol_name = dest;
+}
+
+/**
+ * @internal
+ *
+ * plcrash_async_found_symbols_cb callback implementation. Copies the result to the captured frame corresponding to
+ * @a index, using the pl_symbol_capture_ctx available via @a ctx.
+ */
+static void plcrash_writer_capture_frame_symbols_cb (size_t index, pl_vm_address_t address, const char *name, void *ctx) {
+    struct pl_symbol_capture_ctx *cb_ctx = ctx;
+    cb_ctx->frame = &cb_ctx->capture->frames[cb_ctx->capture->symbol_batch_frames[index]];
+
+    plcrash_writer_capture_frame_symbol_cb(address, name, cb_ctx);
+}
+
+/**
+ * @internal
+ *
+ * Resolve and capture the symbols for all frames in @a capture. Frames are grouped by image, and each image's
+ * symbol table is searched once for all of its frames.
+ *
+ * @param writer The writer context.
+ * @param capture The capture buffer. The frames' PC values must already be populated.
+ * @param image_list The Mach-O image list.
+ * @param findContext Symbol lookup cache.
+ * @param symbolicate If false, no symbols are resolved, and all frames are written with their PC only.
+ */
+static void plcrash_writer_capture_frame_symbols (plcrash_log_writer_t *writer,
+                                                  plcrash_log_writer_thread_capture_t *capture,
+                                                  plcrash_async_image_list_t *image_list,
+                                                  plcrash_async_symbol_cache_t *findContext,
+                                                  bool symbolicate)
+{
+    bool grouped[PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES];
+    struct pl_symbol_capture_ctx cb_ctx;
+    cb_ctx.capture = capture;
+    cb_ctx.symbol_names = writer->symbol_names;
+    cb_ctx.frame = NULL;
+
+    for (uint32_t i = 0; i < capture->frame_count; i++) {
+        capture->frames[i].symbol_state = PLCRASH_LOG_WRITER_FRAME_SYMBOL_NONE;
+        grouped[i] = false;
+    }
+
+    if (!symbolicate || writer->symbol_strategy == PLCRASH_ASYNC_SYMBOL_STRATEGY_NONE)
+        return;
+
+    plcrash_async_image_list_set_reading(image_list, true);
+    for (uint32_t i = 0; i < capture->frame_count; i++) {
+        if (grouped[i])
+            continue;
+
+        grouped[i] = true;
+        plcrash_async_image_t *image = plcrash_async_image_containing_address(image_list, (pl_vm_address_t) capture->frames[i].pc);
+        if (image == NULL)
+            continue;
+
+        /* Frames within images outside of the symbolication scope are written with their PC only */
+        if (!plcrash_writer_symbolication_in_scope(writer, &image->macho_image))
+            continue;
+
+        /* Frames beyond the symbolication budget are written with their PC only */
+        uint32_t remaining = plcrash_writer_symbolication_remaining(writer);
+        if (remaining == 0)
+            break;
+
+        /* Collect this and all later frames within the same image */
+        size_t count = 0;
+        for (uint32_t j = i; j < capture->frame_count && count < remaining; j++) {
+            if (j != i && (grouped[j] || !plcrash_async_macho_contains_address(&image->macho_image, (pl_vm_address_t) capture->frames[j].pc)))
+                continue;
+
+            grouped[j] = true;
+            capture->symbol_batch_frames[count] = j;
+            capture->symbol_batch[count].pc = (pl_vm_address_t) capture->frames[j].pc;
+            count++;
+        }
+
+        /* If a symbol can not be found, our callback will not be called, and the frame's state is left as-is. */
+        writer->symbolicated_frames += (uint32_t) count;
+        plcrash_async_find_symbols(&image->macho_image, writer->symbol_strategy, findContext, capture->symbol_batch, count, capture->symbol_batch_results, plcrash_writer_capture_frame_symbols_cb, &cb_ctx);
+    }
+    plcrash_async_image_list_set_reading(image_list, false);
+}
+
+/**
+ * @internal
+ *
+ * Strip any pointer authentication code from @a pc, returning the plain code address. Return addresses recovered
+ * from the stack are signed on platforms with pointer authentication, and must be stripped before they may be
+ * matched against the loaded images.
+ */
+static inline uint64_t plcrash_writer_strip_pc (uint64_t pc) {
+#if __has_feature(ptrauth_calls)
+    return (uint64_t) ptrauth_strip((void *) (uintptr_t) pc, ptrauth_key_return_address);
+#else
+    return pc;
+#endif
+}
+
+/**
+ * @internal
+ *
+ * libdispatch's description of its queue layout, exported for use by debuggers and crash reporters. Only the
+ * leading fields are declared.
+ */
+extern const struct dispatch_queue_offsets_s {
+    /** The layout version. */
+    const uint16_t dqo_version;
+
+    /** Offset of the queue's label pointer. */
+    const uint16_t dqo_label;
+
+    /** Size of the queue's label pointer. */
+    const uint16_t dqo_label_size;
+} dispatch_queue_offsets __attribute__((weak_import));
+
+/**
+ * @internal
+ *
+ * Read the label of the dispatch queue referenced by a thread's dispatch queue address.
+ *
+ * @param task The task in which the thread is executing.
+ * @param dispatch_qaddr The thread's dispatch_qaddr, as returned by THREAD_IDENTIFIER_INFO.
+ * @param label The buffer to which the NUL-terminated label will be written.
+ * @param size The size of @a label. Must be non-zero.
+ */
+static void plcrash_writer_read_queue_label (task_t task, uint64_t dispatch_qaddr, char *label, size_t size) {
+    pl_vm_address_t queue = 0;
+    pl_vm_address_t label_addr = 0;
+
+    label[0] = '\0';
+    if (&dispatch_queue_offsets == NULL || dispatch_queue_offsets.dqo_label_size != sizeof(label_addr))
+        return;
+
+    /* Fetch the queue, and its label pointer */
+    if (plcrash_async_task_memcpy(task, (pl_vm_address_t) dispatch_qaddr, 0, &queue, sizeof(queue)) != PLCRASH_ESUCCESS || queue == 0)
+        return;
+
+    if (plcrash_async_task_memcpy(task, queue, dispatch_queue_offsets.dqo_label, &label_addr, sizeof(label_addr)) != PLCRASH_ESUCCESS || label_addr == 0)
+        return;
+
+    /* Copy the label a byte at a time, stopping at the first unreadable byte */
+    for (size_t i = 0; i < size - 1; i++) {
+        uint8_t c;
+        if (plcrash_async_task_read_uint8(task, label_addr, (pl_vm_off_t) i, &c) != PLCRASH_ESUCCESS)
+            c = '\0';
+
+        label[i] = (char) c;
+        if (c == '\0')
+            return;
+    }
+    label[size - 1] = '\0';
+}
+
+/**
+ * @internal
+ *
+ * Map a THREAD_QOS_POLICY tier to the corresponding qos_class_t value.
+ */
+static uint32_t plcrash_writer_qos_class (integer_t qos_tier) {
+    switch (qos_tier) {
+        case THREAD_QOS_USER_INTERACTIVE:
+            return QOS_CLASS_USER_INTERACTIVE;
+        case THREAD_QOS_USER_INITIATED:
+            return QOS_CLASS_USER_INITIATED;
+        case THREAD_QOS_LEGACY:
+            return QOS_CLASS_DEFAULT;
+        case THREAD_QOS_UTILITY:
+            return QOS_CLASS_UTILITY;
+        case THREAD_QOS_BACKGROUND:
+        case THREAD_QOS_MAINTENANCE:
+            /* There is no public qos_class_t value for the maintenance tier */
+            return QOS_CLASS_BACKGROUND;
+        default:
+            return QOS_CLASS_UNSPECIFIED;
+    }
+}
+
+/**
+ * @internal
+ *
+ * Capture the metadata enabled via plcrash_log_writer_set_thread_metadata() for @a thread.
+ *
+ * @param writer The writer.
+ * @param thread The thread for which metadata will be captured.
+ * @param metadata The metadata to populate. Any existing contents will be discarded.
+ */
+static void plcrash_writer_capture_thread_metadata (plcrash_log_writer_t *writer, thread_t thread, plcrash_log_writer_thread_metadata_t *metadata) {
+    uint32_t flags = writer->thread_metadata;
+    mach_msg_type_number_t count;
+
+    metadata->has_thread_id = false;
+    metadata->name[0] = '\0';
+    metadata->dispatch_queue[0] = '\0';
+    metadata->has_qos_class = false;
+    metadata->has_cpu_time = false;
+
+    if (flags == 0)
+        return;
+
+    /* The thread's unique identifier, and its dispatch queue */
+    thread_identifier_info_data_t identifier;
+    count = THREAD_IDENTIFIER_INFO_COUNT;
+    if (thread_info(thread, THREAD_IDENTIFIER_INFO, (thread_info_t) &identifier, &count) == KERN_SUCCESS) {
+        metadata->has_thread_id = true;
+        metadata->thread_id = identifier.thread_id;
+
+        if ((flags & PLCRASH_LOG_WRITER_THREAD_METADATA_DISPATCH_QUEUE) && identifier.dispatch_qaddr != 0)
+            plcrash_writer_read_queue_label(writer->task, identifier.dispatch_qaddr, metadata->dispatch_queue, sizeof(metadata->dispatch_queue));
+    }
+
+    /* The pthread name is only available via the extended thread info */
+    if (flags & PLCRASH_LOG_WRITER_THREAD_METADATA_NAME) {
+        thread_extended_info_data_t extended;
+        count = THREAD_EXTENDED_INFO_COUNT;
+        if (thread_info(thread, THREAD_EXTENDED_INFO, (thread_info_t) &extended, &count) == KERN_SUCCESS) {
+            size_t i;
+            for (i = 0; i < sizeof(metadata->name) - 1 && i < sizeof(extended.pth_name) && extended.pth_name[i] != '\0'; i++)
+                metadata->name[i] = extended.pth_name[i];
+            metadata->name[i] = '\0';
+        }
+    }
+
+    if (flags & PLCRASH_LOG_WRITER_THREAD_METADATA_QOS) {
+        thread_qos_policy_data_t policy;
+        boolean_t get_default = FALSE;
+        count = THREAD_QOS_POLICY_COUNT;
+        if (thread_policy_get(thread, THREAD_QOS_POLICY, (thread_policy_t) &policy, &count, &get_default) == KERN_SUCCESS) {
+            metadata->has_qos_class = true;
+            metadata->qos_class = plcrash_writer_qos_class(policy.qos_tier);
+        }
+    }
+
+    if (flags & PLCRASH_LOG_WRITER_THREAD_METADATA_CPU_TIME) {
+        thread_basic_info_data_t basic;
+        count = THREAD_BASIC_INFO_COUNT;
+        if (thread_info(thread, THREAD_BASIC_INFO, (thread_info_t) &basic, &count) == KERN_SUCCESS) {
+            metadata->has_cpu_time = true;
+            metadata->user_time = (uint64_t) basic.user_time.seconds * NSEC_PER_SEC + (uint64_t) basic.user_time.microseconds * NSEC_PER_USEC;
+            metadata->system_time = (uint64_t) basic.system_time.seconds * NSEC_PER_SEC + (uint64_t) basic.system_time.microseconds * NSEC_PER_USEC;
+        }
+    }
+}
+
+/**
+ * @internal
+ *
+ * Walk a thread's stack exactly once, capturing the frame PC values and (if requested) the first frame's registers
+ * into @a capture. Symbols are resolved separately, by plcrash_writer_capture_frame_symbols().
+ *
+ * @param capture The capture buffer to populate. Any existing contents will be discarded.
+ * @param task The task in which @a thread is executing.
+ * @param thread Thread for which we'll capture data.
+ * @param thread_ctx Thread state to use for stack walking. If NULL, the thread state will be fetched from @a thread. If
+ * @a thread is the currently executing thread, <em>must</em> be non-NULL.
+ * @param image_list The Mach-O image list.
+ * @param unwind_cache Unwind cache used by the frame readers.
+ * @param capture_registers If true, capture the registers of the first frame.
+ * @param max_frames The maximum number of frames to capture. Must not exceed PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES.
+ * @param deadline The mach_absolute_time() after which no further frames will be walked, or 0 if unlimited. The
+ * first frame is always captured.
+ */
+static void plcrash_writer_capture_thread (plcrash_log_writer_thread_capture_t *capture,
+                                           task_t task,
+                                           thread_t thread,
+                                           plcrash_async_thread_state_t *thread_ctx,
+                                           plcrash_async_image_list_t *image_list,
+                                           plframe_unwind_cache_t *unwind_cache,
+                                           bool capture_registers,
+                                           uint32_t max_frames,
+                                           uint64_t deadline)
+{
+    plframe_cursor_t cursor;
+    plframe_error_t ferr;
+
+    /* A context must be supplied when walking the current thread */
+    PLCF_ASSERT(task != mach_task_self() || thread_ctx != NULL || thread != pl_mach_thread_self());
+
+    /* Reset the capture state */
+    capture->frame_count = 0;
+    capture->has_registers = false;
+    capture->register_count = 0;
+    capture->has_stack = false;
+    capture->symbol_pool_used = 0;
+
+    /* Set up the frame cursor. */
+    {
+        /* Use the provided context if available, otherwise initialize a new thread context
+         * from the target thread's state. */
+        plcrash_async_thread_state_t cursor_thr_state;
+        if (thread_ctx) {
+            cursor_thr_state = *thread_ctx;
+        } else {
+            plcrash_async_thread_state_mach_thread_init(&cursor_thr_state, thread);
+        }
+
+        /* Initialize the cursor */
+        ferr = plframe_cursor_init(&cursor, task, &cursor_thr_state, image_list);
+        if (ferr != PLFRAME_ESUCCESS) {
+            PLCF_DEBUG("An error occured initializing the frame cursor: %s", plframe_strerror(ferr));
+            return;
+        }
+
+        plframe_cursor_set_unwind_cache(&cursor, unwind_cache);
+    }
+
+    /* Walk the stack, limiting the total number of frames that are captured. */
+    PLCF_ASSERT(max_frames <= PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES);
+    while ((ferr = plframe_cursor_next(&cursor)) == PLFRAME_ESUCCESS && capture->frame_count < max_frames) {
+        /* On the first frame, capture registers if requested */
+        if (capture->frame_count == 0 && capture_registers) {
+            size_t regCount = plframe_cursor_get_regcount(&cursor);
+            PLCF_ASSERT(regCount <= PLCRASH_LOG_WRITER_MAX_THREAD_REGISTERS);
+            if (regCount > PLCRASH_LOG_WRITER_MAX_THREAD_REGISTERS)
+                regCount = PLCRASH_LOG_WRITER_MAX_THREAD_REGISTERS;
+
+            for (uint32_t i = 0; i < regCount; i++) {
+                plcrash_log_writer_register_t *reg = &capture->registers[i];
+
+                /* Fetch the register value */
+                if ((ferr = plframe_cursor_get_reg(&cursor, i, &reg->value)) != PLFRAME_ESUCCESS) {
+                    // Should never happen
+                    PLCF_DEBUG("Could not fetch register %i value: %s", i, plframe_strerror(ferr));
+                    reg->value = 0;
+                }
+
+                /* Fetch the register name */
+                reg->name = plframe_cursor_get_regname(&cursor, i);
+            }
+
+            capture->register_count = (uint32_t) regCount;
+            capture->has_registers = true;
+        }
+
+        /* Fetch the PC value */
+        plcrash_greg_t pc = 0;
+        if ((ferr = plframe_cursor_get_reg(&cursor, PLCRASH_REG_IP, &pc)) != PLFRAME_ESUCCESS) {
+            PLCF_DEBUG("Could not retrieve frame PC register: %s", plframe_strerror(ferr));
+            break;
+        }
+
+        /* Record the frame; symbols are resolved once the walk is complete */
+        plcrash_log_writer_frame_t *frame = &capture->frames[capture->frame_count];
+        frame->pc = plcrash_writer_strip_pc(pc);
+        capture->frame_count++;
+
+        /* Truncate the walk once the deadline has passed */
+        if (deadline != 0 && mach_absolute_time() >= deadline) {
+            PLCF_DEBUG("Capture deadline reached after %" PRIu32 " frames", capture->frame_count);
+            break;
+        }
+    }
+
+    /* Did we reach the end successfully? */
+    if (ferr != PLFRAME_ENOFRAME) {
+        /* This is non-fatal, and in some circumstances -could- be caused by reaching the end of the stack if the
+         * final frame pointer is not NULL. */
+        PLCF_DEBUG("Terminated stack walking early: %s", plframe_strerror(ferr));
+    }
+
+    plframe_cursor_free(&cursor);
+}
+
+/**
+ * @internal
+ *
+ * Save the walked frames and registers of @a capture to @a snapshot.
+ */
+static void plcrash_writer_thread_snapshot_save (plcrash_log_writer_thread_snapshot_t *snapshot,
+                                                 plcrash_log_writer_thread_capture_t *capture,
+                                                 uint32_t thread_number,
+                                                 bool crashed)
+{
+    snapshot->thread_number = thread_number;
+    snapshot->crashed = crashed;
+    snapshot->frame_count = capture->frame_count;
+    for (uint32_t i = 0; i < capture->frame_count; i++)
+        snapshot->pcs[i] = capture->frames[i].pc;
+
+    snapshot->has_registers = capture->has_registers;
+    snapshot->register_count = capture->register_count;
+    for (uint32_t i = 0; i < capture->register_count; i++)
+        snapshot->registers[i] = capture->registers[i];
+
+    snapshot->metadata = capture->metadata;
+}
+
+/**
+ * @internal
+ *
+ * Restore the walked frames and registers of @a snapshot to @a capture, discarding any existing contents.
+ */
+static void plcrash_writer_thread_snapshot_restore (plcrash_log_writer_thread_snapshot_t *snapshot,
+                                                    plcrash_log_writer_thread_capture_t *capture)
+{
+    capture->has_stack = false;
+    capture->symbol_pool_used = 0;
+    capture->frame_count = snapshot->frame_count;
+    for (uint32_t i = 0; i < snapshot->frame_count; i++)
+        capture->frames[i].pc = snapshot->pcs[i];
+
+    capture->has_registers = snapshot->has_registers;
+    capture->register_count = snapshot->register_count;
+    for (uint32_t i = 0; i < snapshot->register_count; i++)
+        capture->registers[i] = snapshot->registers[i];
+
+    capture->metadata = snapshot->metadata;
+}
+
+/**
+ * @internal
+ *
+ * Return the maximum number of frames to be walked for @a thread.
+ *
+ * @param writer The writer.
+ * @param thread The thread to be walked.
+ * @param crashed If true, @a thread is the crashed thread.
+ * @param max_frames The maximum number of frames to be walked for the crashed and main threads.
+ */
+static uint32_t plcrash_writer_thread_max_frames (plcrash_log_writer_t *writer, thread_t thread, bool crashed, uint32_t max_frames) {
+    /* Threads other than the crashed and main threads may be walked to a lesser depth */
+    if (!crashed && thread != writer->main_thread && writer->budget.max_other_frames != 0 && writer->budget.max_other_frames < max_frames)
+        return writer->budget.max_other_frames;
+
+    return max_frames;
+}
+
+/**
+ * @internal
+ *
+ * Select the threads with the highest CPU time for symbolication, if PLCRASH_LOG_WRITER_SYMBOLICATE_HOT is enabled,
+ * populating @a writer's hot thread list. The threads should be suspended, and the CPU times are fetched with a
+ * single THREAD_BASIC_INFO call per thread.
+ *
+ * @param writer The writer.
+ * @param threads The task's threads.
+ * @param thread_count The number of entries in @a threads.
+ */
+static void plcrash_writer_select_hot_threads (plcrash_log_writer_t *writer, thread_act_array_t threads, mach_msg_type_number_t thread_count) {
+    uint64_t cpu_times[PLCRASH_LOG_WRITER_MAX_HOT_THREADS];
+    uint32_t max_count = writer->symbolicated_hot_thread_count;
+
+    writer->hot_thread_count = 0;
+    if (!(writer->symbolicated_threads & PLCRASH_LOG_WRITER_SYMBOLICATE_HOT) || max_count == 0)
+        return;
+
+    for (mach_msg_type_number_t i = 0; i < thread_count; i++) {
+        thread_basic_info_data_t basic;
+        mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
+        if (thread_info(threads[i], THREAD_BASIC_INFO, (thread_info_t) &basic, &count) != KERN_SUCCESS)
+            continue;
+
+        uint64_t cpu_time = (uint64_t) basic.user_time.seconds * USEC_PER_SEC + (uint64_t) basic.user_time.microseconds +
+                            (uint64_t) basic.system_time.seconds * USEC_PER_SEC + (uint64_t) basic.system_time.microseconds;
+
+        /* Insert in descending order of CPU time, dropping the least busy thread once the list is full */
+        uint32_t n = writer->hot_thread_count;
+        if (n == max_count) {
+            if (cpu_time <= cpu_times[n - 1])
+                continue;
+            n--;
+        } else {
+            writer->hot_thread_count++;
+        }
+
+        for (; n > 0 && cpu_times[n - 1] < cpu_time; n--) {
+            cpu_times[n] = cpu_times[n - 1];
+            writer->hot_threads[n] = writer->hot_threads[n - 1];
+        }
+        cpu_times[n] = cpu_time;
+        writer->hot_threads[n] = threads[i];
+    }
+}
+
+/**
+ * @internal
+ *
+ * Return true if @a thread's frames are to be symbolicated, as per the writer's thread symbolication policy. The
+ * hot threads must already have been selected via plcrash_writer_select_hot_threads().
+ *
+ * @param writer The writer.
+ * @param thread The thread to be written.
+ * @param crashed If true, @a thread is the crashed thread.
+ */
+static bool plcrash_writer_thread_symbolicated (plcrash_log_writer_t *writer, thread_t thread, bool crashed) {
+    uint32_t flags = writer->symbolicated_threads;
+    if (flags == 0)
+        return true;
+
+    if ((flags & PLCRASH_LOG_WRITER_SYMBOLICATE_CRASHED) && crashed)
+        return true;
+
+    if ((flags & PLCRASH_LOG_WRITER_SYMBOLICATE_MAIN) && thread == writer->main_thread)
+        return true;
+
+    if (flags & PLCRASH_LOG_WRITER_SYMBOLICATE_HOT) {
+        for (uint32_t i = 0; i < writer->hot_thread_count; i++) {
+            if (writer->hot_threads[i] == thread)
+                return true;
+        }
+    }
+
+    size_t name_count = writer->symbolicated_thread_names_count;
+    if ((flags & PLCRASH_LOG_WRITER_SYMBOLICATE_NAMED) && name_count > 0) {
+        /* The pthread name is only available via the extended thread info */
+        thread_extended_info_data_t extended;
+        mach_msg_type_number_t count = THREAD_EXTENDED_INFO_COUNT;
+        if (thread_info(thread, THREAD_EXTENDED_INFO, (thread_info_t) &extended, &count) != KERN_SUCCESS)
+            return false;
+
+        for (size_t i = 0; i < name_count; i++) {
+            const plcrash_log_writer_scope_path_t *prefix = &writer->symbolicated_thread_names[i];
+            if (prefix->length <= sizeof(extended.pth_name) && plcrash_async_strncmp(extended.pth_name, prefix->path, prefix->length) == 0)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @internal
+ *
+ * Shared state of a parallel stack walk.
+ */
+typedef struct plcrash_writer_walk_pool {
+    /** The writer. */
+    plcrash_log_writer_t *writer;
+
+    /** The threads to be walked. */
+    thread_act_array_t threads;
+
+    /** The number of entries in @a threads. */
+    mach_msg_type_number_t thread_count;
+
+    /** The crashed thread. */
+    thread_t crashed_thread;
+
+    /** The writing thread, which is not walked; its state must be supplied by the caller of plcrash_log_writer_write(). */
+    thread_t self_thread;
+
+    /** The image list used by the frame readers. */
+    plcrash_async_image_list_t *image_list;
+
+    /** The maximum number of frames to be walked for the crashed and main threads. */
+    uint32_t max_frames;
+
+    /** One snapshot per entry in @a threads. A snapshot's thread_number is set to its index once walked, and is
+     * otherwise UINT32_MAX. */
+    plcrash_log_writer_thread_snapshot_t *snapshots;
+
+    /** The index of the next thread to be walked. */
+    volatile int32_t next;
+} plcrash_writer_walk_pool_t;
+
+/**
+ * @internal
+ *
+ * Walk threads from @a ctx (a plcrash_writer_walk_pool_t) until none remain. Each worker walks with its own capture
+ * buffer and unwind cache; the image list and its lazily parsed images may be safely shared.
+ */
+static void *plcrash_writer_walk_worker (void *ctx) {
+    plcrash_writer_walk_pool_t *pool = (plcrash_writer_walk_pool_t *) ctx;
+    plcrash_log_writer_t *writer = pool->writer;
+    plcrash_log_writer_thread_capture_t *capture;
+    vm_size_t capture_size = round_page(sizeof(*capture));
+    vm_address_t addr;
+
+    if (vm_allocate(mach_task_self(), &addr, capture_size, VM_FLAGS_ANYWHERE) != KERN_SUCCESS) {
+        PLCF_DEBUG("Could not allocate a capture buffer for a stack walk worker");
+        return NULL;
+    }
+    capture = (plcrash_log_writer_thread_capture_t *) addr;
+
+    plframe_unwind_cache_t unwind_cache;
+    plframe_unwind_cache_init(&unwind_cache);
+
+    int32_t i;
+    while ((i = OSAtomicIncrement32Barrier(&pool->next) - 1) < (int32_t) pool->thread_count) {
+        thread_t thread = pool->threads[i];
+        if (thread == pool->self_thread)
+            continue;
+
+        bool crashed = (thread == pool->crashed_thread);
+        uint32_t max_frames = plcrash_writer_thread_max_frames(writer, thread, crashed, pool->max_frames);
+
+        uint64_t walk_start = mach_absolute_time();
+        plcrash_writer_capture_thread(capture, writer->task, thread, NULL, pool->image_list, &unwind_cache,
+                                      crashed || writer->all_thread_registers, max_frames, writer->deadline);
+        plcrash_writer_capture_thread_metadata(writer, thread, &capture->metadata);
+        plcrash_writer_thread_snapshot_save(&pool->snapshots[i], capture, i, crashed);
+        pool->snapshots[i].walk_time = mach_absolute_time() - walk_start;
+    }
+
+    plframe_unwind_cache_free(&unwind_cache);
+    vm_deallocate(mach_task_self(), addr, capture_size);
+    return NULL;
+}
+
+/**
+ * @internal
+ *
+ * Walk the stacks of @a threads in parallel, across the writer's configured number of unwind workers. Threads that
+ * could not be walked -- including the writing thread -- are left to be walked serially.
+ *
+ * @param writer The writer.
+ * @param threads The threads to be walked.
+ * @param thread_count The number of entries in @a threads.
+ * @param crashed_thread The crashed thread.
+ * @param image_list The image list.
+ * @param max_frames The maximum number of frames to be walked for the crashed and main threads.
+ * @param[out] size On success, the size of the returned allocation.
+ *
+ * @return Returns a vm_allocate()'d array of @a thread_count snapshots, indexed as per @a threads, or NULL if the
+ * snapshots could not be allocated. The caller is responsible for deallocating the array.
+ *
+ * @warning This function is not async safe.
+ */
+static plcrash_log_writer_thread_snapshot_t *plcrash_writer_parallel_walk (plcrash_log_writer_t *writer,
+                                                                           thread_act_array_t threads,
+                                                                           mach_msg_type_number_t thread_count,
+                                                                           thread_t crashed_thread,
+                                                                           plcrash_async_image_list_t *image_list,
+                                                                           uint32_t max_frames,
+                                                                           vm_size_t *size)
+{
+    vm_size_t snapshots_size = round_page(sizeof(plcrash_log_writer_thread_snapshot_t) * thread_count);
+    vm_address_t addr;
+
+    if (vm_allocate(mach_task_self(), &addr, snapshots_size, VM_FLAGS_ANYWHERE) != KERN_SUCCESS) {
+        PLCF_DEBUG("Could not allocate parallel walk snapshots; stacks will be walked serially");
+        return NULL;
+    }
+
+    plcrash_writer_walk_pool_t pool;
+    pool.writer = writer;
+    pool.threads = threads;
+    pool.thread_count = thread_count;
+    pool.crashed_thread = crashed_thread;
+    pool.self_thread = pl_mach_thread_self();
+    pool.image_list = image_list;
+    pool.max_frames = max_frames;
+    pool.snapshots = (plcrash_log_writer_thread_snapshot_t *) addr;
+    pool.next = 0;
+
+    for (mach_msg_type_number_t i = 0; i < thread_count; i++)
+        pool.snapshots[i].thread_number = UINT32_MAX;
+
+    /* Spawn the additional workers; the writing thread also walks */
+    uint32_t worker_count = MIN(writer->unwind_workers, thread_count);
+    pthread_t workers[worker_count];
+    uint32_t spawned = 0;
+    for (uint32_t i = 1; i < worker_count; i++) {
+        if (pthread_create(&workers[spawned], NULL, plcrash_writer_walk_worker, &pool) != 0) {
+            PLCF_DEBUG("Could not spawn stack walk worker: %s", strerror(errno));
+            break;
+        }
+        spawned++;
+    }
+
+    plcrash_writer_walk_worker(&pool);
+    for (uint32_t i = 0; i < spawned; i++)
+        pthread_join(workers[i], NULL);
+
+    *size = snapshots_size;
+    return pool.snapshots;
+}
+
+/**
+ * @internal
+ *
+ * Write a captured thread backtrace frame
+ *
+ * @param file Output file
+ * @param writer The writer context.
+ * @param frame The captured frame.
+ * @param image_list The Mach-O image list. Used only to resolve deferred symbols.
+ * @param findContext Symbol lookup cache. Used only to resolve deferred symbols.
+ */
+static size_t plcrash_writer_write_captured_thread_frame (plcrash_async_file_t *file,
+                                                          plcrash_log_writer_t *writer,
+                                                          plcrash_log_writer_frame_t *frame,
+                                                          plcrash_async_image_list_t *image_list,
+                                                          plcrash_async_symbol_cache_t *findContext)
+{
+    size_t rv = 0;
+
+    switch (frame->symbol_state) {
+        case PLCRASH_LOG_WRITER_FRAME_SYMBOL_NONE:
+            rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_FRAME_PC_ID, PLPROTOBUF_C_TYPE_UINT64, &frame->pc);
+            break;
+
+        case PLCRASH_LOG_WRITER_FRAME_SYMBOL_CAPTURED:
+        case PLCRASH_LOG_WRITER_FRAME_SYMBOL_INDEXED: {
+            plcrash_writer_reservation_t reservation;
+            uint32_t msgsize;
+
+            /* Indexed symbols are written without an inline name */
+            const char *name = NULL;
+            if (frame->symbol_state == PLCRASH_LOG_WRITER_FRAME_SYMBOL_CAPTURED)
+                name = frame->symbol_name;
+
+            rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_FRAME_PC_ID, PLPROTOBUF_C_TYPE_UINT64, &frame->pc);
+
+            /* Write the symbol header and message in a single pass, if supported by the output */
+            if (plcrash_writer_pack_reserve(file, PLCRASH_PROTO_THREAD_FRAME_SYMBOL_ID, &reservation)) {
+                plcrash_writer_write_symbol(file, name, frame->symbol_name_index, frame->symbol_start);
+                rv += plcrash_writer_pack_commit(file, &reservation);
+                break;
+            }
+
+            /* Write the symbol header and message */
+            msgsize = plcrash_writer_write_symbol(NULL, name, frame->symbol_name_index, frame->symbol_start);
+            rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_FRAME_SYMBOL_ID, PLPROTOBUF_C_TYPE_MESSAGE, &msgsize);
+            rv += plcrash_writer_write_symbol(file, name, frame->symbol_name_index, frame->symbol_start);
+            break;
+        }
+
+        case PLCRASH_LOG_WRITER_FRAME_SYMBOL_DEFERRED:
+            /* The symbol name did not fit in the capture pool; fall back on direct lookup. The frame was already
+             * admitted to the symbolication budget when its symbol was captured. */
+            rv += plcrash_writer_write_thread_frame(file, writer, frame->pc, image_list, findContext, true);
+            break;
+    }
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Map up to @a size bytes of the stack memory above the stack pointer of @a thread_state, consuming the mapped
+ * length from @a stack_budget. The mapping references the stack directly, and is permitted to be short if the stack
+ * ends within the requested length.
+ *
+ * @param task The task in which the thread is executing.
+ * @param thread_state The thread's register state.
+ * @param size The maximum number of bytes to be mapped.
+ * @param stack_budget The remaining stack memory budget, in bytes. Will be decremented by the number of bytes mapped.
+ * @param thread_number The thread's index number, used for logging.
+ * @param stack On success, will be initialized with the stack mapping. The caller is responsible for freeing the
+ * mapping via plcrash_async_mobject_free().
+ *
+ * @return Returns true if the stack was mapped, or false if the budget is exhausted or the stack could not be mapped.
+ */
+static bool plcrash_writer_map_stack (task_t task,
+                                      plcrash_async_thread_state_t *thread_state,
+                                      size_t size,
+                                      size_t *stack_budget,
+                                      uint32_t thread_number,
+                                      plcrash_async_mobject_t *stack)
+{
+    if (size > *stack_budget)
+        size = *stack_budget;
+
+    if (size == 0 || !plcrash_async_thread_state_has_reg(thread_state, PLCRASH_REG_SP) ||
+        plcrash_async_thread_state_get_stack_direction(thread_state) != PLCRASH_ASYNC_THREAD_STACK_DIRECTION_DOWN)
+    {
+        return false;
+    }
+
+    plcrash_greg_t sp = plcrash_async_thread_state_get_reg(thread_state, PLCRASH_REG_SP);
+    if (plcrash_async_mobject_init(stack, task, (pl_vm_address_t) sp, size, false) != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("Could not map the stack of thread %" PRIu32 " at 0x%" PRIx64, thread_number, (uint64_t) sp);
+        return false;
+    }
+
+    *stack_budget -= plcrash_async_mobject_length(stack);
+    return true;
+}
+
+/**
+ * @internal
+ *
+ * Write the address and contents of a thread's stack memory mapping.
+ *
+ * @param file Output file
+ * @param stack The stack mapping, as returned by plcrash_writer_map_stack().
+ */
+static size_t plcrash_writer_write_thread_stack (plcrash_async_file_t *file, plcrash_async_mobject_t *stack) {
+    uint64_t address = plcrash_async_mobject_base_address(stack);
+    PLProtobufCBinaryData data;
+    size_t rv = 0;
+
+    data.len = plcrash_async_mobject_length(stack);
+    data.data = plcrash_async_mobject_remap_address(stack, address, 0, data.len);
+
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_STACK_ADDRESS_ID, PLPROTOBUF_C_TYPE_UINT64, &address);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_STACK_MEMORY_ID, PLPROTOBUF_C_TYPE_BYTES, &data);
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Determine whether @a capture may be written using the packed thread encoding. All frame symbols must have been
+ * written to the symbol name table, and all register names must be added to the table.
+ *
+ * @param writer The writer context.
+ * @param capture The thread capture.
+ */
+static bool plcrash_writer_thread_packable (plcrash_log_writer_t *writer, plcrash_log_writer_thread_capture_t *capture) {
+    if (!writer->packed_threads || writer->symbol_names == NULL)
+        return false;
+
+    for (uint32_t i = 0; i < capture->frame_count; i++) {
+        plcrash_log_writer_frame_symbol_state_t state = capture->frames[i].symbol_state;
+        if (state != PLCRASH_LOG_WRITER_FRAME_SYMBOL_NONE && state != PLCRASH_LOG_WRITER_FRAME_SYMBOL_INDEXED)
+            return false;
+    }
+
+    if (capture->has_registers && !writer->all_thread_registers) {
+        for (uint32_t i = 0; i < capture->register_count; i++) {
+            uint32_t index;
+            if (!plcrash_writer_symbol_names_intern(writer->symbol_names, capture->registers[i].name, &index))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @internal
+ *
+ * Write the frames and registers of @a capture using the packed thread encoding. The caller must have verified
+ * that the capture is packable via plcrash_writer_thread_packable().
+ *
+ * @param file Output file
+ * @param writer The writer context.
+ * @param capture The thread capture.
+ */
+static size_t plcrash_writer_write_packed_thread (plcrash_async_file_t *file,
+                                                  plcrash_log_writer_t *writer,
+                                                  plcrash_log_writer_thread_capture_t *capture)
+{
+    uint64_t *values = capture->packed_values;
+    uint32_t *indices = capture->packed_indices;
+    plcrash_log_writer_image_set_t *set = &writer->written_images;
+    uint32_t count = capture->frame_count;
+    size_t rv = 0;
+
+    /* Frame PCs, relative to the base address of their image where the image has been written */
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t image_ref = capture->frame_images[i];
+        values[i] = capture->frames[i].pc;
+        if (image_ref != 0)
+            values[i] -= set->ordered[image_ref - 1]->header_addr;
+    }
+    rv += plcrash_writer_pack_packed(file, PLCRASH_PROTO_THREAD_FRAME_PCS_ID, PLPROTOBUF_C_TYPE_UINT64, values, count);
+    rv += plcrash_writer_pack_packed(file, PLCRASH_PROTO_THREAD_FRAME_IMAGES_ID, PLPROTOBUF_C_TYPE_UINT32, capture->frame_images, count);
+
+    /* Frame symbol names and offsets */
+    for (uint32_t i = 0; i < count; i++) {
+        plcrash_log_writer_frame_t *frame = &capture->frames[i];
+        if (frame->symbol_state == PLCRASH_LOG_WRITER_FRAME_SYMBOL_INDEXED) {
+            indices[i] = frame->symbol_name_index + 1;
+            values[i] = frame->pc - frame->symbol_start;
+        } else {
+            indices[i] = 0;
+            values[i] = 0;
+        }
+    }
+    rv += plcrash_writer_pack_packed(file, PLCRASH_PROTO_THREAD_FRAME_SYMBOL_NAMES_ID, PLPROTOBUF_C_TYPE_UINT32, indices, count);
+    rv += plcrash_writer_pack_packed(file, PLCRASH_PROTO_THREAD_FRAME_SYMBOL_OFFSETS_ID, PLPROTOBUF_C_TYPE_UINT64, values, count);
+
+    if (!capture->has_registers)
+        return rv;
+
+    if (writer->all_thread_registers) {
+        rv += plcrash_writer_write_register_state(file, capture);
+        return rv;
+    }
+
+    /* Register values and names; the names were added to the table by plcrash_writer_thread_packable() */
+    for (uint32_t i = 0; i < capture->register_count; i++) {
+        values[i] = capture->registers[i].value;
+        plcrash_writer_symbol_names_intern(writer->symbol_names, capture->registers[i].name, &indices[i]);
+    }
+    rv += plcrash_writer_pack_packed(file, PLCRASH_PROTO_THREAD_REGISTER_VALUES_ID, PLPROTOBUF_C_TYPE_UINT64, values, capture->register_count);
+    rv += plcrash_writer_pack_packed(file, PLCRASH_PROTO_THREAD_REGISTER_NAMES_ID, PLPROTOBUF_C_TYPE_UINT32, indices, capture->register_count);
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write a thread message from a previously populated thread capture.
+ *
+ * @param file Output file
+ * @param writer The writer context.
+ * @param capture The thread capture, as populated by plcrash_writer_capture_thread() and
+ * plcrash_writer_capture_frame_symbols().
+ * @param thread_number The thread's index number.
+ * @param image_list The Mach-O image list.
+ * @param findContext Symbol lookup cache.
+ * @param crashed If true, mark this as a crashed thread.
+ */
+static size_t plcrash_writer_write_thread (plcrash_async_file_t *file,
+                                           plcrash_log_writer_t *writer,
+                                           plcrash_log_writer_thread_capture_t *capture,
+                                           uint32_t thread_number,
+                                           plcrash_async_image_list_t *image_list,
+                                           plcrash_async_symbol_cache_t *findContext,
+                                           bool crashed)
+{
+    size_t rv = 0;
+
+    /* Write the thread ID */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_THREAD_NUMBER_ID, PLPROTOBUF_C_TYPE_UINT32, &thread_number);
+
+    /* Note crashed status */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_CRASHED_ID, PLPROTOBUF_C_TYPE_BOOL, &crashed);
+
+    /* Write the thread's metadata, if captured */
+    rv += plcrash_writer_write_thread_metadata(file, &capture->metadata);
+
+    /* Write the captured stack memory, if any */
+    if (capture->has_stack)
+        rv += plcrash_writer_write_thread_stack(file, &capture->stack);
+
+    /* Write the frames and registers as packed arrays, if enabled */
+    if (plcrash_writer_thread_packable(writer, capture)) {
+        rv += plcrash_writer_write_packed_thread(file, writer, capture);
+        return rv;
+    }
+
+    /* Write out the stack frames. */
+    for (uint32_t i = 0; i < capture->frame_count; i++) {
+        plcrash_writer_reservation_t reservation;
+        uint32_t frame_size;
+
+        /* On the first frame, dump the captured registers */
+        if (i == 0 && capture->has_registers) {
+            if (writer->all_thread_registers)
+                rv += plcrash_writer_write_register_state(file, capture);
+            else
+                rv += plcrash_writer_write_thread_registers(file, capture);
+        }
+
+        /* Write the frame in a single pass, if supported by the output */
+        if (plcrash_writer_pack_reserve(file, PLCRASH_PROTO_THREAD_FRAMES_ID, &reservation)) {
+            plcrash_writer_write_captured_thread_frame(file, writer, &capture->frames[i], image_list, findContext);
+            rv += plcrash_writer_pack_commit(file, &reservation);
+            continue;
+        }
+
+        /* Determine the size */
+        frame_size = plcrash_writer_write_captured_thread_frame(NULL, writer, &capture->frames[i], image_list, findContext);
+
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_FRAMES_ID, PLPROTOBUF_C_TYPE_MESSAGE, &frame_size);
+        rv += plcrash_writer_write_captured_thread_frame(file, writer, &capture->frames[i], image_list, findContext);
+    }
+
+    return rv;
+}
+
+
+/**
+ * @internal
+ *
+ * Write a binary image frame
+ *
+ * @param file Output file
+ * @param image Mach-O image.
+ */
+static size_t plcrash_writer_write_binary_image (plcrash_async_file_t *file, plcrash_async_macho_t *image) {
+    size_t rv = 0;
+
+    /* Fetch the CPU types. Note that the wire format represents these as 64-bit unsigned integers.
+     * We explicitly cast to an equivalently sized unsigned type to prevent improper sign extension. */
+    uint64_t cpu_type = (uint32_t) image->byteorder->swap32(image->header.cputype);
+    uint64_t cpu_subtype = (uint32_t) image->byteorder->swap32(image->header.cpusubtype);
+
+    /* Text segment size */
+    uint64_t mach_size = image->text_size;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_BINARY_IMAGE_SIZE_ID, PLPROTOBUF_C_TYPE_UINT64, &mach_size);
+    
+    /* Base address */
+    {
+        uintptr_t base_addr;
+        uint64_t u64;
+
+        base_addr = (uintptr_t) image->header_addr;
+        u64 = base_addr;
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_BINARY_IMAGE_ADDR_ID, PLPROTOBUF_C_TYPE_UINT64, &u64);
+    }
+
+    /* Name */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_BINARY_IMAGE_NAME_ID, PLPROTOBUF_C_TYPE_STRING, image->name);
+
+    /* UUID */
+    struct uuid_command *uuid;
+    uuid = plcrash_async_macho_find_command(image, LC_UUID);
+    if (uuid != NULL) {
+        PLProtobufCBinaryData binary;
+    
+        /* Write the 128-bit UUID */
+        binary.len = sizeof(uuid->uuid);
+        binary.data = uuid->uuid;
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_BINARY_IMAGE_UUID_ID, PLPROTOBUF_C_TYPE_BYTES, &binary);
+    }
+    
+    /* Get the processor message size */
+    uint32_t msgsize = plcrash_writer_write_processor_info(NULL, cpu_type, cpu_subtype);
+
+    /* Write the header and message */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_BINARY_IMAGE_CODE_TYPE_ID, PLPROTOBUF_C_TYPE_MESSAGE, &msgsize);
+    rv += plcrash_writer_write_processor_info(file, cpu_type, cpu_subtype);
+
+    return rv;
+}
+
+
+/**
+ * @internal
+ *
+ * Write a complete CrashReport.binary_images record, including its field header.
+ *
+ * @param file Output file
+ * @param image Mach-O image.
+ */
+static size_t plcrash_writer_write_binary_image_record (plcrash_async_file_t *file, plcrash_async_macho_t *image) {
+    size_t rv = 0;
+    uint32_t size;
+
+    /* Calculate the message size */
+    size = plcrash_writer_write_binary_image(NULL, image);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_BINARY_IMAGES_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+    rv += plcrash_writer_write_binary_image(file, image);
+
+    return rv;
+}
+
+/**
+ * @internal
+ *
+ * Write @a image's CrashReport.binary_images record, using its pre-encoded record if available.
+ *
+ * @param file Output file
+ * @param image The image to write.
+ */
+static void plcrash_writer_write_image_list_entry (plcrash_async_file_t *file, plcrash_async_image_t *image) {
+    if (image->encoded_record != NULL) {
+        plcrash_async_file_write(file, image->encoded_record, image->encoded_record_length);
+        return;
+    }
+
+    plcrash_writer_write_binary_image_record(file, &image->macho_image);
+}
+
+/**
+ * @internal
+ *
+ * Return the index at which @a image is, or would be, found within @a set.
+ */
+static uint32_t plcrash_writer_image_set_search (plcrash_log_writer_image_set_t *set, plcrash_async_image_t *image) {
+    uint32_t low = 0;
+    uint32_t high = set->count;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if ((uintptr_t) set->images[mid] < (uintptr_t) image) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+/**
+ * @internal
+ *
+ * Return @a image's contribution to CrashReport.omitted_image_hash: the FNV-1a hash of the image's little-endian
+ * 64-bit base address, followed by its path.
+ */
+static uint64_t plcrash_writer_omitted_image_hash (plcrash_async_image_t *image) {
+    uint64_t hash = 14695981039346656037ULL;
+    uint64_t addr = image->header_addr;
+
+    for (size_t i = 0; i < sizeof(addr); i++) {
+        hash ^= (uint8_t) (addr >> (i * 8));
+        hash *= 1099511628211ULL;
+    }
+
+    for (const char *p = image->name; p != NULL && *p != '\0'; p++) {
+        hash ^= (uint8_t) *p;
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+/**
+ * @internal
+ *
+ * Configure @a cache's ObjC parser to use the shared cache's precomputed ObjC tables, if the ObjC runtime in
+ * @a image_list was loaded from the shared cache. Failure is not an error; the tables are an optional optimization.
+ */
+static void plcrash_writer_configure_objc_cache (plcrash_async_symbol_cache_t *cache, plcrash_async_image_list_t *image_list) {
+    plcrash_async_image_list_set_reading(image_list, true);
+
+    plcrash_async_image_t *libobjc = plcrash_async_image_list_find_named(image_list, PLCRASH_ASYNC_OBJC_RUNTIME_PATH);
+    if (libobjc != NULL)
+        plcrash_async_objc_cache_set_shared_cache_image(&cache->objc_cache, &libobjc->macho_image);
+
+    plcrash_async_image_list_set_reading(image_list, false);
+}
+
+/**
+ * @internal
+ *
+ * Acquire the symbol cache to be used for a single report. If @a writer has a persistent symbol cache, it is
+ * returned, and is re-initialized if it has not yet been initialized, or if the images it may reference are no
+ * longer valid; otherwise, @a local_cache is initialized and returned, and must be freed by the caller.
+ *
+ * @param writer The writer context.
+ * @param image_list The image list that will be used to write the report.
+ * @param local_cache The cache to initialize if no persistent cache is available.
+ * @param[out] cache On success, the cache to be used for the report.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or an error if the cache could not be initialized.
+ */
+static plcrash_error_t plcrash_writer_acquire_symbol_cache (plcrash_log_writer_t *writer,
+                                                            plcrash_async_image_list_t *image_list,
+                                                            plcrash_async_symbol_cache_t *local_cache,
+                                                            plcrash_async_symbol_cache_t **cache)
+{
+    plcrash_async_symbol_cache_t *persistent = writer->symbol_cache;
+    plcrash_error_t err;
+
+    if (persistent == NULL) {
+        if ((err = plcrash_async_symbol_cache_init(local_cache)) != PLCRASH_ESUCCESS)
+            return err;
+
+        plcrash_writer_configure_objc_cache(local_cache, image_list);
+        *cache = local_cache;
+        return PLCRASH_ESUCCESS;
+    }
+
+    /* Cached entries refer to image mappings; they must be discarded once any image has been removed. */
+    uint32_t generation = image_list->removal_generation;
+    if (writer->symbol_cache_valid && (writer->symbol_cache_image_list != image_list || writer->symbol_cache_generation != generation)) {
+        plcrash_async_symbol_cache_free(persistent);
+        writer->symbol_cache_valid = false;
+    }
+
+    if (!writer->symbol_cache_valid) {
+        if ((err = plcrash_async_symbol_cache_init(persistent)) != PLCRASH_ESUCCESS)
+            return err;
+
+        plcrash_writer_configure_objc_cache(persistent, image_list);
+
+        writer->symbol_cache_valid = true;
+        writer->symbol_cache_image_list = image_list;
+        writer->symbol_cache_generation = generation;
+    } else {
+        plcrash_async_symbol_cache_reset_stats(persistent);
+    }
+
+    *cache = persistent;
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * @internal
  *
- * Write the processor info message.
+ * Report-scoped state, shared by all threads and frames of a single report. The context is initialized once before
+ * the first thread is captured, and released once the report has been written.
+ */
+typedef struct plcrash_writer_report_context {
+    /** The symbol cache, including its image mapping pool; either the writer's persistent cache, or
+     * @a local_symbol_cache. */
+    plcrash_async_symbol_cache_t *symbol_cache;
+
+    /** Storage for a symbol cache scoped to this report, used if the writer has no persistent cache. */
+    plcrash_async_symbol_cache_t local_symbol_cache;
+
+    /** Mapped unwind sections, decoded CFE and DWARF unwind state, and stack mappings, passed to every frame reader. */
+    plframe_unwind_cache_t unwind_cache;
+} plcrash_writer_report_context_t;
+
+/**
+ * @internal
  *
- * @param file Output file
- * @param cpu_type The Mach CPU type.
- * @param cpu_subtype The Mach CPU subtype
+ * Initialize a report context for writing a report from @a image_list.
+ *
+ * @param context The context to initialize. The context must be released via plcrash_writer_report_context_free().
+ * @param writer The writer context.
+ * @param image_list The image list that will be used to write the report.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or an error if the symbol cache could not be initialized.
  */
-static size_t plcrash_writer_write_processor_info (plcrash_async_file_t *file, uint64_t cpu_type, uint64_t cpu_subtype) {
-    size_t rv = 0;
-    uint32_t enumval;
-    
-    /* Encoding */
-    enumval = PLCrashReportProcessorTypeEncodingMach;
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESSOR_ENCODING_ID, PLPROTOBUF_C_TYPE_ENUM, &enumval);
+static plcrash_error_t plcrash_writer_report_context_init (plcrash_writer_report_context_t *context, plcrash_log_writer_t *writer, plcrash_async_image_list_t *image_list) {
+    plcrash_error_t err;
 
-    /* Type */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESSOR_TYPE_ID, PLPROTOBUF_C_TYPE_UINT64, &cpu_type);
+    if ((err = plcrash_writer_acquire_symbol_cache(writer, image_list, &context->local_symbol_cache, &context->symbol_cache)) != PLCRASH_ESUCCESS)
+        return err;
 
-    /* Subtype */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESSOR_SUBTYPE_ID, PLPROTOBUF_C_TYPE_UINT64, &cpu_subtype);
-    
-    return rv;
+    plframe_unwind_cache_init(&context->unwind_cache);
+    return PLCRASH_ESUCCESS;
 }
 
 /**
  * @internal
  *
- * Write the machine info message.
+ * Free all resources held by @a context. A persistent symbol cache is retained by the writer.
+ */
+static void plcrash_writer_report_context_free (plcrash_writer_report_context_t *context) {
+    if (context->symbol_cache == &context->local_symbol_cache)
+        plcrash_async_symbol_cache_free(context->symbol_cache);
+
+    plframe_unwind_cache_free(&context->unwind_cache);
+}
+
+/**
+ * @internal
  *
- * @param file Output file
+ * Return the FNV-1a hash of @a writer's uncaught exception name, or 0 if no exception has been recorded.
  */
-static size_t plcrash_writer_write_machine_info (plcrash_async_file_t *file, plcrash_log_writer_t *writer) {
-    size_t rv = 0;
-    
-    /* Model */
-    if (writer->machine_info.model != NULL)
-        rv += plcrash_writer_pack(file, PLCRASH_PROTO_MACHINE_INFO_MODEL_ID, PLPROTOBUF_C_TYPE_STRING, writer->machine_info.model);
+static uint64_t plcrash_writer_exception_name_hash (plcrash_log_writer_t *writer) {
+    if (!writer->uncaught_exception.has_exception || writer->uncaught_exception.name == NULL)
+        return 0;
+
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char *p = writer->uncaught_exception.name; *p != '\0'; p++) {
+        hash ^= (uint8_t) *p;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
 
-    /* Processor */
-    {
-        uint32_t size;
+/**
+ * @internal
+ *
+ * Update the FNV-1a @a hash with @a length bytes of @a data, returning the new hash.
+ */
+static uint64_t plcrash_writer_signature_update (uint64_t hash, const void *data, size_t length) {
+    const uint8_t *bytes = data;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
 
-        /* Determine size */
-        size = plcrash_writer_write_processor_info(NULL, writer->machine_info.cpu_type, writer->machine_info.cpu_subtype);
+/**
+ * @internal
+ *
+ * Compute the summary signature of the crashed thread from the top #PLCRASH_LOG_SUMMARY_SIGNATURE_FRAMES frames of
+ * @a capture. Each frame contributes the identity of its image -- the image's LC_UUID, or its path if it has none --
+ * followed by its image-relative PC, such that equal offsets within differing images produce differing signatures.
+ * Frames that fall outside of any image contribute a fixed sentinel, as their absolute PCs vary between launches.
+ */
+static uint64_t plcrash_writer_crashed_thread_signature (plcrash_log_writer_thread_capture_t *capture, plcrash_async_image_list_t *image_list) {
+    static const uint64_t unknown_image_sentinel = UINT64_MAX;
+    uint64_t hash = 14695981039346656037ULL;
 
-        /* Write message */
-        rv += plcrash_writer_pack(file, PLCRASH_PROTO_MACHINE_INFO_PROCESSOR_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
-        rv += plcrash_writer_write_processor_info(file, writer->machine_info.cpu_type, writer->machine_info.cpu_subtype);
+    plcrash_async_image_list_set_reading(image_list, true);
+    for (uint32_t i = 0; i < capture->frame_count && i < PLCRASH_LOG_SUMMARY_SIGNATURE_FRAMES; i++) {
+        uint64_t pc = capture->frames[i].pc;
+        plcrash_async_image_t *image = plcrash_async_image_containing_address(image_list, (pl_vm_address_t) pc);
+        if (image == NULL) {
+            hash = plcrash_writer_signature_update(hash, &unknown_image_sentinel, sizeof(unknown_image_sentinel));
+            continue;
+        }
+
+        uint8_t uuid[16];
+        if (plcrash_async_macho_uuid(&image->macho_image, uuid) == PLCRASH_ESUCCESS) {
+            hash = plcrash_writer_signature_update(hash, uuid, sizeof(uuid));
+        } else if (image->name != NULL) {
+            hash = plcrash_writer_signature_update(hash, image->name, plcrash_async_strnlen(image->name, PATH_MAX));
+        }
+
+        /* Hash the little-endian image-relative PC */
+        pc -= image->header_addr;
+        for (size_t j = 0; j < sizeof(pc); j++) {
+            hash ^= (uint8_t) (pc >> (j * 8));
+            hash *= 1099511628211ULL;
+        }
     }
+    plcrash_async_image_list_set_reading(image_list, false);
 
-    /* Physical Processor Count */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_MACHINE_INFO_PROCESSOR_COUNT_ID, PLPROTOBUF_C_TYPE_UINT32, &writer->machine_info.processor_count);
-    
-    /* Logical Processor Count */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_MACHINE_INFO_LOGICAL_PROCESSOR_COUNT_ID, PLPROTOBUF_C_TYPE_UINT32, &writer->machine_info.logical_processor_count);
-    
-    return rv;
+    return hash;
 }
 
 /**
  * @internal
  *
- * Write the app info message.
+ * Return true if @a image has been recorded in @a set.
+ */
+static bool plcrash_writer_image_set_contains (plcrash_log_writer_image_set_t *set, plcrash_async_image_t *image) {
+    uint32_t idx = plcrash_writer_image_set_search(set, image);
+    return idx < set->count && set->images[idx] == image;
+}
+
+/**
+ * @internal
+ *
+ * Return true if the current report is being written incrementally against a previously written base report.
+ */
+static bool plcrash_writer_incremental (plcrash_log_writer_t *writer) {
+    return writer->baseline != NULL && writer->baseline->valid && !writer->raw_capture;
+}
+
+/**
+ * @internal
+ *
+ * Return the index of the first entry in @a baseline's images with a header address not less than @a addr.
+ */
+static uint32_t plcrash_writer_baseline_image_search (plcrash_log_writer_baseline_t *baseline, pl_vm_address_t addr) {
+    uint32_t lo = 0;
+    uint32_t hi = baseline->image_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (baseline->images[mid] < addr)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/**
+ * @internal
+ *
+ * Return true if @a image was written to @a baseline's base report.
+ */
+static bool plcrash_writer_baseline_contains_image (plcrash_log_writer_baseline_t *baseline, plcrash_async_image_t *image) {
+    uint32_t idx = plcrash_writer_baseline_image_search(baseline, image->header_addr);
+    return idx < baseline->image_count && baseline->images[idx] == image->header_addr;
+}
+
+/**
+ * @internal
+ *
+ * Record @a image as having been written to @a baseline's base report. Images beyond
+ * #PLCRASH_LOG_WRITER_MAX_BASELINE_IMAGES are not recorded, and will be written again to each incremental report.
+ */
+static void plcrash_writer_baseline_add_image (plcrash_log_writer_baseline_t *baseline, plcrash_async_image_t *image) {
+    uint32_t idx = plcrash_writer_baseline_image_search(baseline, image->header_addr);
+    if (idx < baseline->image_count && baseline->images[idx] == image->header_addr)
+        return;
+
+    if (baseline->image_count == PLCRASH_LOG_WRITER_MAX_BASELINE_IMAGES)
+        return;
+
+    for (uint32_t i = baseline->image_count; i > idx; i--)
+        baseline->images[i] = baseline->images[i - 1];
+    baseline->images[idx] = image->header_addr;
+    baseline->image_count++;
+}
+
+/**
+ * @internal
+ *
+ * Compute the FNV-1a hash of @a capture's walked frame PCs, used to determine whether a thread's stack has changed
+ * since the base report was written.
+ */
+static uint64_t plcrash_writer_thread_hash (plcrash_log_writer_thread_capture_t *capture) {
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (uint32_t i = 0; i < capture->frame_count; i++) {
+        uint64_t pc = capture->frames[i].pc;
+        for (size_t j = 0; j < sizeof(pc); j++) {
+            hash ^= (uint8_t) (pc >> (j * 8));
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return hash;
+}
+
+/**
+ * @internal
+ *
+ * Write the binary image record of the image containing @a pc, if it has not yet been written, recording it in the
+ * writer's set of written images. The caller must have enabled reading of @a image_list.
  *
  * @param file Output file
- * @param app_identifier Application identifier
- * @param app_version Application version
- * @param app_marketing_version Application marketing version
+ * @param writer Writer instance.
+ * @param image_list The list of loaded images.
+ * @param pc The referenced address.
+ * @param image_ref If non-NULL, will be set to 0 if @a pc is not within a written image, or to one greater than the
+ * index of the image containing @a pc within the report's binary image list.
+ *
+ * @return Returns false if the set of written images has overflowed, in which case no further images may be recorded.
  */
-static size_t plcrash_writer_write_app_info (plcrash_async_file_t *file, const char *app_identifier, const char *app_version, const char *app_marketing_version) {
-    size_t rv = 0;
+static bool plcrash_writer_write_referenced_image (plcrash_async_file_t *file,
+                                                   plcrash_log_writer_t *writer,
+                                                   plcrash_async_image_list_t *image_list,
+                                                   uint64_t pc,
+                                                   uint32_t *image_ref)
+{
+    plcrash_log_writer_image_set_t *set = &writer->written_images;
+    if (image_ref != NULL)
+        *image_ref = 0;
+
+    if (set->overflowed)
+        return false;
+
+    plcrash_async_image_t *image = plcrash_async_image_containing_address(image_list, (pl_vm_address_t) pc);
+    if (image == NULL)
+        return true;
+
+    /* Images written to the base report of an incremental report are not written again */
+    if (plcrash_writer_incremental(writer) && plcrash_writer_baseline_contains_image(writer->baseline, image))
+        return true;
+
+    uint32_t idx = plcrash_writer_image_set_search(set, image);
+    if (idx < set->count && set->images[idx] == image) {
+        if (image_ref != NULL)
+            *image_ref = set->indices[idx] + 1;
+        return true;
+    }
 
-    /* App identifier */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_APP_INFO_APP_IDENTIFIER_ID, PLPROTOBUF_C_TYPE_STRING, app_identifier);
-    
-    /* App version */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_APP_INFO_APP_VERSION_ID, PLPROTOBUF_C_TYPE_STRING, app_version);
-    
-    /* App marketing version */
-    if (app_marketing_version != NULL)
-        rv += plcrash_writer_pack(file, PLCRASH_PROTO_APP_INFO_APP_MARKETING_VERSION_ID, PLPROTOBUF_C_TYPE_STRING, app_marketing_version);
-    
-    return rv;
+    if (set->count == PLCRASH_LOG_WRITER_MAX_REFERENCED_IMAGES) {
+        set->overflowed = true;
+        return false;
+    }
+
+    /* Images recorded in the set are written in the order in which they are first referenced, ahead of all other
+     * images; the image's index within the report is the number of images previously recorded. */
+    for (uint32_t j = set->count; j > idx; j--) {
+        set->images[j] = set->images[j - 1];
+        set->indices[j] = set->indices[j - 1];
+    }
+    set->images[idx] = image;
+    set->indices[idx] = set->count;
+    set->ordered[set->count] = image;
+    set->count++;
+
+    if (image_ref != NULL)
+        *image_ref = set->indices[idx] + 1;
+
+    plcrash_writer_write_image_list_entry(file, image);
+    return true;
 }
 
 /**
  * @internal
  *
- * Write the process info message.
+ * Write the binary image records of all images referenced by @a capture's frames that have not yet been written,
+ * recording them in the writer's set of written images. If the set is full, it is marked as overflowed, and the
+ * remaining referenced images are left to be written with all other images.
+ *
+ * The report index of each frame's image is recorded in the capture's @a frame_images.
  *
  * @param file Output file
- * @param process_name Process name, or NULL if unavailable.
- * @param process_id Process ID
- * @param process_path Process path, or NULL if unavailable.
- * @param parent_process_name Parent process name, or NULL if unavailable.
- * @param parent_process_id Parent process ID
- * @param native If false, process is running under emulation.
- * @param start_time The start time of the process.
+ * @param writer Writer instance.
+ * @param capture The captured thread.
+ * @param image_list The list of loaded images.
  */
-static size_t plcrash_writer_write_process_info (plcrash_async_file_t *file, const char *process_name,
-                                                 const pid_t process_id, const char *process_path, 
-                                                 const char *parent_process_name, const pid_t parent_process_id,
-                                                 bool native, time_t start_time)
+static void plcrash_writer_write_referenced_images (plcrash_async_file_t *file,
+                                                    plcrash_log_writer_t *writer,
+                                                    plcrash_log_writer_thread_capture_t *capture,
+                                                    plcrash_async_image_list_t *image_list)
 {
-    size_t rv = 0;
-    uint64_t tval;
+    for (uint32_t i = 0; i < capture->frame_count; i++)
+        capture->frame_images[i] = 0;
 
-    /*
-     * In the current crash reporter serialization format, pid values are serialized as unsigned 32-bit integers. This
-     * conforms with the actual implementation of pid_t on both 32-bit and 64-bit Darwin systems. To conform with
-     * SuSV3, however, the values should be encoded as signed integers; the actual width of the type being implementation
-     * defined.
-     *
-     * To maintain compatibility with existing report readers the values remain encoded as unsigned 32-bit integers,
-     * but should be updated to int64 values in future major revision of the data format.
-     */
-    uint32_t pidval;
+    plcrash_async_image_list_set_reading(image_list, true);
+    for (uint32_t i = 0; i < capture->frame_count; i++) {
+        if (!plcrash_writer_write_referenced_image(file, writer, image_list, capture->frames[i].pc, &capture->frame_images[i]))
+            break;
+    }
+    plcrash_async_image_list_set_reading(image_list, false);
+}
 
-    /* Process name */
-    if (process_name != NULL)
-        rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_PROCESS_NAME_ID, PLPROTOBUF_C_TYPE_STRING, process_name);
+/**
+ * Pre-encode the crash report binary image record for @a image. This function conforms to
+ * plcrash_async_image_encoder_fn, and may be registered with an image list via plcrash_nasync_image_list_set_encoder().
+ *
+ * @param image The Mach-O image to encode.
+ * @param data On success, will be set to a malloc()-allocated buffer containing the encoded record. The caller
+ * is responsible for free()'ing this buffer.
+ * @param length On success, will be set to the length of @a data, in bytes.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_ENOMEM if the buffer could not be allocated.
+ *
+ * @warning This function is not async-safe.
+ */
+plcrash_error_t plcrash_log_writer_nasync_encode_binary_image (plcrash_async_macho_t *image, void **data, size_t *length) {
+    plcrash_async_file_t file;
+    size_t size;
+    void *buffer;
 
-    /* Process ID */
-    pidval = process_id;
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_PROCESS_ID_ID, PLPROTOBUF_C_TYPE_UINT32, &pidval);
+    /* Determine the record size */
+    size = plcrash_writer_write_binary_image_record(NULL, image);
 
-    /* Process path */
-    if (process_path != NULL)
-        rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_PROCESS_PATH_ID, PLPROTOBUF_C_TYPE_STRING, process_path);
-    
-    /* Parent process name */
-    if (parent_process_name != NULL)
-        rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_PARENT_PROCESS_NAME_ID, PLPROTOBUF_C_TYPE_STRING, parent_process_name);
-    
+    buffer = malloc(size);
+    if (buffer == NULL)
+        return PLCRASH_ENOMEM;
 
-    /* Parent process ID */
-    pidval = parent_process_id;
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_PARENT_PROCESS_ID_ID, PLPROTOBUF_C_TYPE_UINT32, &pidval);
+    /* Encode the record */
+    plcrash_async_file_init_buffer(&file, buffer, size);
+    plcrash_writer_write_binary_image_record(&file, image);
+    plcrash_async_file_close(&file);
 
-    /* Native process. */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_NATIVE_ID, PLPROTOBUF_C_TYPE_BOOL, &native);
+    PLCF_ASSERT(file.total_bytes == size);
+
+    *data = buffer;
+    *length = size;
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * @internal
+ *
+ * Write the crash Exception message
+ *
+ * @param file Output file
+ * @param writer Writer containing exception data
+ * @param capture The exception's frames, as populated by plcrash_writer_capture_exception().
+ * @param image_list The Mach-O image list. Used only to resolve deferred symbols.
+ * @param findContext Symbol lookup cache. Used only to resolve deferred symbols.
+ */
+static size_t plcrash_writer_write_exception (plcrash_async_file_t *file,
+                                              plcrash_log_writer_t *writer,
+                                              plcrash_log_writer_thread_capture_t *capture,
+                                              plcrash_async_image_list_t *image_list,
+                                              plcrash_async_symbol_cache_t *findContext)
+{
+    size_t rv = 0;
+
+    /* Write the name and reason */
+    assert(writer->uncaught_exception.has_exception);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_EXCEPTION_NAME_ID, PLPROTOBUF_C_TYPE_STRING, writer->uncaught_exception.name);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_EXCEPTION_REASON_ID, PLPROTOBUF_C_TYPE_STRING, writer->uncaught_exception.reason);
     
-    /* Start time */
-    tval = start_time;
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_START_TIME_ID, PLPROTOBUF_C_TYPE_UINT64, &tval);
+    /* Write the stack frames, if any */
+    for (uint32_t i = 0; i < capture->frame_count; i++) {
+        plcrash_log_writer_frame_t *frame = &capture->frames[i];
+
+        /* Determine the size. The frame is written as a pre-sized message, within which plcrash_writer_pack_reserve()
+         * is disabled, ensuring that the nested symbol record is written with the same framing used here. */
+        uint32_t frame_size = (uint32_t) plcrash_writer_write_captured_thread_frame(NULL, writer, frame, image_list, findContext);
+        
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_EXCEPTION_FRAMES_ID, PLPROTOBUF_C_TYPE_MESSAGE, &frame_size);
+        rv += plcrash_writer_write_captured_thread_frame(file, writer, frame, image_list, findContext);
+    }
 
     return rv;
 }
@@ -743,153 +4282,150 @@ static size_t plcrash_writer_write_process_info (plcrash_async_file_t *file, con
 /**
  * @internal
  *
- * Write a single register.
+ * Populate @a capture with the uncaught exception's call stack, and resolve the frames' symbols. The frames are
+ * symbolicated in a batch per image, sharing the report's symbol cache and symbol name table with the thread
+ * frames; as the exception's call stack largely overlaps with the crashed thread's, most look-ups are served
+ * from the cache.
+ *
+ * @param writer Writer containing exception data
+ * @param capture The capture buffer to populate. Any existing contents will be discarded.
+ * @param image_list The Mach-O image list.
+ * @param findContext Symbol lookup cache.
+ */
+static void plcrash_writer_capture_exception (plcrash_log_writer_t *writer,
+                                              plcrash_log_writer_thread_capture_t *capture,
+                                              plcrash_async_image_list_t *image_list,
+                                              plcrash_async_symbol_cache_t *findContext)
+{
+    capture->has_registers = false;
+    capture->register_count = 0;
+    capture->has_stack = false;
+    capture->symbol_pool_used = 0;
+
+    capture->frame_count = (uint32_t) writer->uncaught_exception.callstack_count;
+    for (uint32_t i = 0; i < capture->frame_count; i++)
+        capture->frames[i].pc = writer->uncaught_exception.callstack[i];
+
+    plcrash_writer_capture_frame_symbols(writer, capture, image_list, findContext, true);
+}
+
+/**
+ * @internal
+ *
+ * Write the crash signal's mach exception info.
  *
  * @param file Output file
- * @param regname The register to write's name.
- * @param regval The register to write's value.
+ * @param siginfo The signal information
  */
-static size_t plcrash_writer_write_thread_register (plcrash_async_file_t *file, const char *regname, plcrash_greg_t regval) {
-    uint64_t uint64val;
+static size_t plcrash_writer_write_mach_signal (plcrash_async_file_t *file, plcrash_log_mach_signal_info_t *siginfo) {
     size_t rv = 0;
 
-    /* Write the name */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_REGISTER_NAME_ID, PLPROTOBUF_C_TYPE_STRING, regname);
-
-    /* Write the value */
-    uint64val = regval;
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_REGISTER_VALUE_ID, PLPROTOBUF_C_TYPE_UINT64, &uint64val);
+    /* Type */
+    uint64_t type = siginfo->type;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SIGNAL_MACH_EXCEPTION_TYPE_ID, PLPROTOBUF_C_TYPE_UINT64, &type);
     
+    /* Code(s) */
+    for (mach_msg_type_number_t i = 0; i < siginfo->code_count; i++) {
+        uint64_t code = siginfo->code[i];
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_SIGNAL_MACH_EXCEPTION_CODES_ID, PLPROTOBUF_C_TYPE_UINT64, &code);
+    }
+
     return rv;
 }
 
 /**
  * @internal
  *
- * Write all thread backtrace register messages
+ * Write the crash signal message
  *
  * @param file Output file
- * @param task The task from which @a uap was derived. All memory accesses will be mapped from this task.
- * @param cursor The cursor from which to acquire frame registers.
+ * @param siginfo The signal information
  */
-static size_t plcrash_writer_write_thread_registers (plcrash_async_file_t *file, task_t task, plframe_cursor_t *cursor) {
-    plframe_error_t frame_err;
-    uint32_t regCount = plframe_cursor_get_regcount(cursor);
+static size_t plcrash_writer_write_signal (plcrash_async_file_t *file, plcrash_log_signal_info_t *siginfo) {
     size_t rv = 0;
     
-    /* Write out register messages */
-    for (int i = 0; i < regCount; i++) {
-        plcrash_greg_t regVal;
-        const char *regname;
-        uint32_t msgsize;
-
-        /* Fetch the register value */
-        if ((frame_err = plframe_cursor_get_reg(cursor, i, &regVal)) != PLFRAME_ESUCCESS) {
-            // Should never happen
-            PLCF_DEBUG("Could not fetch register %i value: %s", i, plframe_strerror(frame_err));
-            regVal = 0;
-        }
+    /* BSD signal info is always required in the current report format; this restriction will be lifted
+     * once we switch to the 2.0 format. */
+    PLCF_ASSERT(siginfo->bsd_info != NULL);
+    
+    /* Fetch the signal name */
+    char name_buf[10];
+    const char *name;
+    if ((name = plcrash_async_signal_signame(siginfo->bsd_info->signo)) == NULL) {
+        PLCF_DEBUG("Warning -- unhandled signal number (signo=%d). This is a bug.", siginfo->bsd_info->signo);
+        snprintf(name_buf, sizeof(name_buf), "#%d", siginfo->bsd_info->signo);
+        name = name_buf;
+    }
 
-        /* Fetch the register name */
-        regname = plframe_cursor_get_regname(cursor, i);
+    /* Fetch the signal code string */
+    char code_buf[10];
+    const char *code;
+    if ((code = plcrash_async_signal_sigcode(siginfo->bsd_info->signo, siginfo->bsd_info->code)) == NULL) {
+        PLCF_DEBUG("Warning -- unhandled signal sicode (signo=%d, code=%d). This is a bug.", siginfo->bsd_info->signo, siginfo->bsd_info->code);
+        snprintf(code_buf, sizeof(code_buf), "#%d", siginfo->bsd_info->code);
+        code = code_buf;
+    }
+    
+    /* Address value */
+    uint64_t addr = (uintptr_t) siginfo->bsd_info->address;
 
-        /* Get the register message size */
-        msgsize = plcrash_writer_write_thread_register(NULL, regname, regVal);
+    /* Write it out */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SIGNAL_NAME_ID, PLPROTOBUF_C_TYPE_STRING, name);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SIGNAL_CODE_ID, PLPROTOBUF_C_TYPE_STRING, code);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SIGNAL_ADDRESS_ID, PLPROTOBUF_C_TYPE_UINT64, &addr);
+    
+    /* Mach exception info */
+    if (siginfo->mach_info != NULL) {
+        uint32_t size;
         
-        /* Write the header and message */
-        rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_REGISTERS_ID, PLPROTOBUF_C_TYPE_MESSAGE, &msgsize);
-        rv += plcrash_writer_write_thread_register(file, regname, regVal);
+        /* Determine size */
+        size = plcrash_writer_write_mach_signal(NULL, siginfo->mach_info);
+        
+        /* Write message */
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_SIGNAL_MACH_EXCEPTION_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+        rv += plcrash_writer_write_mach_signal(file, siginfo->mach_info);
     }
-    
+
     return rv;
 }
 
 /**
  * @internal
  *
- * Write a symbol
+ * Write the complete signal message.
  *
  * @param file Output file
- * @param name The symbol name
- * @param start_address The symbol start address
- */
-static size_t plcrash_writer_write_symbol (plcrash_async_file_t *file, const char *name, uint64_t start_address) {
-    size_t rv = 0;
-    
-    /* name */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYMBOL_NAME, PLPROTOBUF_C_TYPE_STRING, name);
-    
-    /* start_address */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SYMBOL_START_ADDRESS, PLPROTOBUF_C_TYPE_UINT64, &start_address);
-    
-    return rv;
-}
-
-/**
- * @internal
- * Symbol lookup callback context
+ * @param siginfo The signal information
  */
-struct pl_symbol_cb_ctx {
-    /** File to use for writing out a symbol entry. May be NULL. */
-    plcrash_async_file_t *file;
-
-    /** Size of the symbol entry, to be written by the callback function upon writing an entry. */
-    uint32_t msgsize;
-};
+static void plcrash_writer_write_signal_message (plcrash_async_file_t *file, plcrash_log_signal_info_t *siginfo) {
+    uint32_t size;
 
-/**
- * @internal
- *
- * pl_async_macho_found_symbol_cb callback implementation. Writes the result to the file available via @a ctx,
- * which must be a valid pl_symbol_cb_ctx structure.
- */
-static void plcrash_writer_write_thread_frame_symbol_cb (pl_vm_address_t address, const char *name, void *ctx) {
-    struct pl_symbol_cb_ctx *cb_ctx = ctx;
-    cb_ctx->msgsize = plcrash_writer_write_symbol(cb_ctx->file, name, address);
+    /* Calculate the message size */
+    size = plcrash_writer_write_signal(NULL, siginfo);
+    plcrash_writer_pack(file, PLCRASH_PROTO_SIGNAL_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+    plcrash_writer_write_signal(file, siginfo);
 }
 
 /**
  * @internal
  *
- * Write a thread backtrace frame
+ * Write the report info message
  *
  * @param file Output file
- * @param pcval The frame PC value.
+ * @param writer Writer containing report data
  */
-static size_t plcrash_writer_write_thread_frame (plcrash_async_file_t *file, plcrash_log_writer_t *writer, uint64_t pcval, plcrash_async_image_list_t *image_list, plcrash_async_symbol_cache_t *findContext) {
+static size_t plcrash_writer_write_report_info (plcrash_async_file_t *file, plcrash_log_writer_t *writer) {
     size_t rv = 0;
 
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_FRAME_PC_ID, PLPROTOBUF_C_TYPE_UINT64, &pcval);
+    /* Note crashed status */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_REPORT_INFO_USER_REQUESTED_ID, PLPROTOBUF_C_TYPE_BOOL, &writer->report_info.user_requested);
     
-    plcrash_async_image_list_set_reading(image_list, true);
-    plcrash_async_image_t *image = plcrash_async_image_containing_address(image_list, (pl_vm_address_t) pcval);
+    /* Write the 128-bit UUID */
+    PLProtobufCBinaryData uuid_bin;
     
-    if (image != NULL && writer->symbol_strategy != PLCRASH_ASYNC_SYMBOL_STRATEGY_NONE) {
-        struct pl_symbol_cb_ctx ctx;
-        plcrash_error_t ret;
-        
-        /* Get the symbol message size. If the symbol can not be found, our callback will not be called. If the symbol is found,
-         * our callback is called and PLCRASH_ESUCCESS is returned. */
-        ctx.file = NULL;
-        ctx.msgsize = 0x0;
-        ret = plcrash_async_find_symbol(&image->macho_image, writer->symbol_strategy, findContext, (pl_vm_address_t) pcval, plcrash_writer_write_thread_frame_symbol_cb, &ctx);
-        if (ret == PLCRASH_ESUCCESS) {
-            /* Write the header and message */
-            rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_FRAME_SYMBOL_ID, PLPROTOBUF_C_TYPE_MESSAGE, &ctx.msgsize);
-
-            ctx.file = file;
-            ret = plcrash_async_find_symbol(&image->macho_image, writer->symbol_strategy, findContext, (pl_vm_address_t) pcval, plcrash_writer_write_thread_frame_symbol_cb, &ctx);
-            if (ret == PLCRASH_ESUCCESS) {
-                rv += ctx.msgsize;
-            } else {
-                /* This should not happen, but it would be very confusing if it did and nothing was logged. */
-                PLCF_DEBUG("Fetching the symbol unexpectedly failed during the second call");
-            }
-        }
-    }
-
-    plcrash_async_image_list_set_reading(image_list, false);
-
+    uuid_bin.len = sizeof(writer->report_info.uuid_bytes);
+    uuid_bin.data = &writer->report_info.uuid_bytes;
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_REPORT_INFO_UUID_ID, PLPROTOBUF_C_TYPE_BYTES, &uuid_bin);
 
     return rv;
 }
@@ -897,212 +4433,206 @@ static size_t plcrash_writer_write_thread_frame (plcrash_async_file_t *file, plc
 /**
  * @internal
  *
- * Write a thread message
+ * Write the machine_info, application_info and process_info records, including their field headers.
  *
  * @param file Output file
- * @param task The task in which @a thread is executing.
- * @param thread Thread for which we'll output data.
- * @param thread_number The thread's index number.
- * @param thread_ctx Thread state to use for stack walking. If NULL, the thread state will be fetched from @a thread. If
- * @a thread is the currently executing thread, <em>must</em> be non-NULL.
- * @param image_list The Mach-O image list.
- * @param findContext Symbol lookup cache.
- * @param crashed If true, mark this as a crashed thread.
+ * @param writer The writer context.
  */
-static size_t plcrash_writer_write_thread (plcrash_async_file_t *file,
-                                           plcrash_log_writer_t *writer,
-                                           task_t task,
-                                           thread_t thread,
-                                           uint32_t thread_number,
-                                           plcrash_async_thread_state_t *thread_ctx,
-                                           plcrash_async_image_list_t *image_list,
-                                           plcrash_async_symbol_cache_t *findContext,
-                                           bool crashed)
-{
+static size_t plcrash_writer_write_info_records (plcrash_async_file_t *file, plcrash_log_writer_t *writer) {
     size_t rv = 0;
-    plframe_cursor_t cursor;
-    plframe_error_t ferr;
-
-    /* A context must be supplied when walking the current thread */
-    PLCF_ASSERT(task != mach_task_self() || thread_ctx != NULL || thread != pl_mach_thread_self());
 
-    /* Write the required elements first; fatal errors may occur below, in which case we need to have
-     * written out required elements before returning. */
+    /* Machine Info */
     {
-        /* Write the thread ID */
-        rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_THREAD_NUMBER_ID, PLPROTOBUF_C_TYPE_UINT32, &thread_number);
+        uint32_t size;
 
-        /* Note crashed status */
-        rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_CRASHED_ID, PLPROTOBUF_C_TYPE_BOOL, &crashed);
-    }
+        /* Determine size */
+        size = plcrash_writer_write_machine_info(NULL, writer);
 
+        /* Write message */
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_MACHINE_INFO_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+        rv += plcrash_writer_write_machine_info(file, writer);
+    }
 
-    /* Write out the stack frames. */
+    /* App info */
     {
-        /* Set up the frame cursor. */
-        {            
-            /* Use the provided context if available, otherwise initialize a new thread context
-             * from the target thread's state. */
-            plcrash_async_thread_state_t cursor_thr_state;
-            if (thread_ctx) {
-                cursor_thr_state = *thread_ctx;
-            } else {
-                plcrash_async_thread_state_mach_thread_init(&cursor_thr_state, thread);
-            }
-
-            /* Initialize the cursor */
-            ferr = plframe_cursor_init(&cursor, task, &cursor_thr_state, image_list);
-            if (ferr != PLFRAME_ESUCCESS) {
-                PLCF_DEBUG("An error occured initializing the frame cursor: %s", plframe_strerror(ferr));
-                return rv;
-            }
-        }
-
-        /* Walk the stack, limiting the total number of frames that are output. */
-        uint32_t frame_count = 0;
-        while ((ferr = plframe_cursor_next(&cursor)) == PLFRAME_ESUCCESS && frame_count < MAX_THREAD_FRAMES) {
-            uint32_t frame_size;
-            
-            /* On the first frame, dump registers for the crashed thread */
-            if (frame_count == 0 && crashed) {
-                rv += plcrash_writer_write_thread_registers(file, task, &cursor);
-            }
-
-            /* Fetch the PC value */
-            plcrash_greg_t pc = 0;
-            if ((ferr = plframe_cursor_get_reg(&cursor, PLCRASH_REG_IP, &pc)) != PLFRAME_ESUCCESS) {
-                PLCF_DEBUG("Could not retrieve frame PC register: %s", plframe_strerror(ferr));
-                break;
-            }
+        uint32_t size;
 
-            /* Determine the size */
-            frame_size = plcrash_writer_write_thread_frame(NULL, writer, pc, image_list, findContext);
-            
-            rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_FRAMES_ID, PLPROTOBUF_C_TYPE_MESSAGE, &frame_size);
-            rv += plcrash_writer_write_thread_frame(file, writer, pc, image_list, findContext);
-            frame_count++;
-        }
+        /* Determine size */
+        size = plcrash_writer_write_app_info(NULL, writer->application_info.app_identifier, writer->application_info.app_version, writer->application_info.app_marketing_version);
+        
+        /* Write message */
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_APP_INFO_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+        rv += plcrash_writer_write_app_info(file, writer->application_info.app_identifier, writer->application_info.app_version, writer->application_info.app_marketing_version);
+    }
+    
+    /* Process info */
+    {
+        uint32_t size;
+        
+        const plcrash_async_shared_cache_t *shared_cache = writer->process_info.has_shared_cache ? &writer->process_info.shared_cache : NULL;
 
-        /* Did we reach the end successfully? */
-        if (ferr != PLFRAME_ENOFRAME) {
-            /* This is non-fatal, and in some circumstances -could- be caused by reaching the end of the stack if the
-             * final frame pointer is not NULL. */
-            PLCF_DEBUG("Terminated stack walking early: %s", plframe_strerror(ferr));
-        }
+        /* Determine size */
+        size = plcrash_writer_write_process_info(NULL, writer->process_info.process_name, writer->process_info.process_id, 
+                                                 writer->process_info.process_path, writer->process_info.parent_process_name,
+                                                 writer->process_info.parent_process_id, writer->process_info.native,
+                                                 writer->process_info.start_time, shared_cache);
+        
+        /* Write message */
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+        rv += plcrash_writer_write_process_info(file, writer->process_info.process_name, writer->process_info.process_id, 
+                                                writer->process_info.process_path, writer->process_info.parent_process_name, 
+                                                writer->process_info.parent_process_id, writer->process_info.native,
+                                                writer->process_info.start_time, shared_cache);
     }
 
-    plframe_cursor_free(&cursor);
     return rv;
 }
 
-
 /**
  * @internal
  *
- * Write a binary image frame
+ * Write the report_info record, including its field header.
  *
  * @param file Output file
- * @param image Mach-O image.
+ * @param writer The writer context.
  */
-static size_t plcrash_writer_write_binary_image (plcrash_async_file_t *file, plcrash_async_macho_t *image) {
+static size_t plcrash_writer_write_report_info_record (plcrash_async_file_t *file, plcrash_log_writer_t *writer) {
     size_t rv = 0;
+    uint32_t size;
 
-    /* Fetch the CPU types. Note that the wire format represents these as 64-bit unsigned integers.
-     * We explicitly cast to an equivalently sized unsigned type to prevent improper sign extension. */
-    uint64_t cpu_type = (uint32_t) image->byteorder->swap32(image->header.cputype);
-    uint64_t cpu_subtype = (uint32_t) image->byteorder->swap32(image->header.cpusubtype);
+    /* Determine size */
+    size = plcrash_writer_write_report_info(NULL, writer);
 
-    /* Text segment size */
-    uint64_t mach_size = image->text_size;
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_BINARY_IMAGE_SIZE_ID, PLPROTOBUF_C_TYPE_UINT64, &mach_size);
-    
-    /* Base address */
-    {
-        uintptr_t base_addr;
-        uint64_t u64;
+    /* Write message */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_REPORT_INFO_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+    rv += plcrash_writer_write_report_info(file, writer);
 
-        base_addr = (uintptr_t) image->header_addr;
-        u64 = base_addr;
-        rv += plcrash_writer_pack(file, PLCRASH_PROTO_BINARY_IMAGE_ADDR_ID, PLPROTOBUF_C_TYPE_UINT64, &u64);
-    }
+    return rv;
+}
 
-    /* Name */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_BINARY_IMAGE_NAME_ID, PLPROTOBUF_C_TYPE_STRING, image->name);
+/**
+ * @internal
+ *
+ * Encode all report sections that are fixed at initialization time (report info, system info excluding
+ * the timestamp, machine info, application info, and process info) into @a writer's static_sections buffer.
+ *
+ * @param writer The writer context. All report data must have been initialized.
+ *
+ * @warning This function is not async-safe.
+ */
+static plcrash_error_t plcrash_writer_nasync_encode_static_sections (plcrash_log_writer_t *writer) {
+    plcrash_async_file_t file;
+    size_t total;
 
-    /* UUID */
-    struct uuid_command *uuid;
-    uuid = plcrash_async_macho_find_command(image, LC_UUID);
-    if (uuid != NULL) {
-        PLProtobufCBinaryData binary;
-    
-        /* Write the 128-bit UUID */
-        binary.len = sizeof(uuid->uuid);
-        binary.data = uuid->uuid;
-        rv += plcrash_writer_pack(file, PLCRASH_PROTO_BINARY_IMAGE_UUID_ID, PLPROTOBUF_C_TYPE_BYTES, &binary);
-    }
-    
-    /* Get the processor message size */
-    uint32_t msgsize = plcrash_writer_write_processor_info(NULL, cpu_type, cpu_subtype);
+    /* Determine the section sizes */
+    writer->static_sections.report_info_length = plcrash_writer_write_report_info_record(NULL, writer);
+    writer->static_sections.system_info_length = plcrash_writer_write_system_info_static(NULL, writer);
+    writer->static_sections.info_length = plcrash_writer_write_info_records(NULL, writer);
 
-    /* Write the header and message */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_BINARY_IMAGE_CODE_TYPE_ID, PLPROTOBUF_C_TYPE_MESSAGE, &msgsize);
-    rv += plcrash_writer_write_processor_info(file, cpu_type, cpu_subtype);
+    total = writer->static_sections.report_info_length + writer->static_sections.system_info_length + writer->static_sections.info_length;
+    writer->static_sections.data = malloc(total);
+    if (writer->static_sections.data == NULL)
+        return PLCRASH_ENOMEM;
 
-    return rv;
-}
+    /* Encode the sections */
+    plcrash_async_file_init_buffer(&file, writer->static_sections.data, total);
+    plcrash_writer_write_report_info_record(&file, writer);
+    plcrash_writer_write_system_info_static(&file, writer);
+    plcrash_writer_write_info_records(&file, writer);
+    plcrash_async_file_close(&file);
 
+    PLCF_ASSERT(file.total_bytes == total);
+
+    return PLCRASH_ESUCCESS;
+}
 
 /**
  * @internal
  *
- * Write the crash Exception message
+ * Resolve the symbols of the thread captured in @a writer's capture buffer, and write its thread message, followed
+ * by the records of any images referenced by its frames that have not already been written. If the packed thread
+ * encoding is enabled, the image records are instead written ahead of the thread message.
  *
  * @param file Output file
- * @param writer Writer containing exception data
- */
-static size_t plcrash_writer_write_exception (plcrash_async_file_t *file, plcrash_log_writer_t *writer, plcrash_async_image_list_t *image_list, plcrash_async_symbol_cache_t *findContext) {
-    size_t rv = 0;
-
-    /* Write the name and reason */
-    assert(writer->uncaught_exception.has_exception);
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_EXCEPTION_NAME_ID, PLPROTOBUF_C_TYPE_STRING, writer->uncaught_exception.name);
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_EXCEPTION_REASON_ID, PLPROTOBUF_C_TYPE_STRING, writer->uncaught_exception.reason);
-    
-    /* Write the stack frames, if any */
-    uint32_t frame_count = 0;
-    for (size_t i = 0; i < writer->uncaught_exception.callstack_count && frame_count < MAX_THREAD_FRAMES; i++) {
-        uint64_t pc = (uint64_t)(uintptr_t) writer->uncaught_exception.callstack[i];
-        
+ * @param writer The writer context.
+ * @param thread_number The thread's index number.
+ * @param image_list The Mach-O image list.
+ * @param findContext Symbol lookup cache.
+ * @param crashed If true, mark this as a crashed thread.
+ * @param symbolicate If false, the thread's frames are written with their PC only.
+ */
+static void plcrash_writer_write_captured_thread (plcrash_async_file_t *file,
+                                                  plcrash_log_writer_t *writer,
+                                                  uint32_t thread_number,
+                                                  plcrash_async_image_list_t *image_list,
+                                                  plcrash_async_symbol_cache_t *findContext,
+                                                  bool crashed,
+                                                  bool symbolicate)
+{
+    plcrash_log_writer_thread_capture_t *capture = writer->thread_capture;
+
+    /* Resolve the captured frames' symbols, grouped by image */
+    plcrash_writer_capture_frame_symbols(writer, capture, image_list, findContext, symbolicate);
+    if (crashed)
+        writer->summary.crashed_thread_signature = plcrash_writer_crashed_thread_signature(capture, image_list);
+
+    /* Write the names added to the symbol name table ahead of the thread that refers to them. The packed encoding
+     * also refers to register names, which are added when determining whether the thread is packable. */
+    if (writer->symbol_names != NULL) {
+        plcrash_writer_thread_packable(writer, capture);
+        plcrash_writer_write_symbol_names(file, writer->symbol_names);
+    }
+
+    /* Packed threads refer to their frames' images by report index, which is assigned as the images are written */
+    if (writer->packed_threads)
+        plcrash_writer_write_referenced_images(file, writer, capture, image_list);
+
+    /* Write the thread message in a single pass if the output supports back-patching the length, avoiding
+     * a full sizing pass over the thread's frames. */
+    plcrash_writer_reservation_t reservation;
+    if (plcrash_writer_pack_reserve(file, PLCRASH_PROTO_THREADS_ID, &reservation)) {
+        plcrash_writer_write_thread(file, writer, capture, thread_number, image_list, findContext, crashed);
+        plcrash_writer_pack_commit(file, &reservation);
+    } else {
         /* Determine the size */
-        uint32_t frame_size = plcrash_writer_write_thread_frame(NULL, writer, pc, image_list, findContext);
-        
-        rv += plcrash_writer_pack(file, PLCRASH_PROTO_EXCEPTION_FRAMES_ID, PLPROTOBUF_C_TYPE_MESSAGE, &frame_size);
-        rv += plcrash_writer_write_thread_frame(file, writer, pc, image_list, findContext);
-        frame_count++;
+        uint32_t size = plcrash_writer_write_thread(NULL, writer, capture, thread_number, image_list, findContext, crashed);
+
+        /* Write message */
+        plcrash_writer_pack(file, PLCRASH_PROTO_THREADS_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+        plcrash_writer_write_thread(file, writer, capture, thread_number, image_list, findContext, crashed);
     }
 
-    return rv;
+    /* Images referenced by the thread's frames */
+    if (!writer->packed_threads)
+        plcrash_writer_write_referenced_images(file, writer, capture, image_list);
 }
 
 /**
  * @internal
  *
- * Write the crash signal's mach exception info.
+ * Write a thread's captured metadata fields.
  *
  * @param file Output file
- * @param siginfo The signal information
+ * @param metadata The thread's metadata.
  */
-static size_t plcrash_writer_write_mach_signal (plcrash_async_file_t *file, plcrash_log_mach_signal_info_t *siginfo) {
+static size_t plcrash_writer_write_thread_metadata (plcrash_async_file_t *file, plcrash_log_writer_thread_metadata_t *metadata) {
     size_t rv = 0;
 
-    /* Type */
-    uint64_t type = siginfo->type;
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SIGNAL_MACH_EXCEPTION_TYPE_ID, PLPROTOBUF_C_TYPE_UINT64, &type);
-    
-    /* Code(s) */
-    for (mach_msg_type_number_t i = 0; i < siginfo->code_count; i++) {
-        uint64_t code = siginfo->code[i];
-        rv += plcrash_writer_pack(file, PLCRASH_PROTO_SIGNAL_MACH_EXCEPTION_CODES_ID, PLPROTOBUF_C_TYPE_UINT64, &code);
+    if (metadata->has_thread_id)
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_THREAD_ID_ID, PLPROTOBUF_C_TYPE_UINT64, &metadata->thread_id);
+
+    if (metadata->name[0] != '\0')
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_NAME_ID, PLPROTOBUF_C_TYPE_STRING, metadata->name);
+
+    if (metadata->dispatch_queue[0] != '\0')
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_DISPATCH_QUEUE_ID, PLPROTOBUF_C_TYPE_STRING, metadata->dispatch_queue);
+
+    if (metadata->has_qos_class)
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_QOS_CLASS_ID, PLPROTOBUF_C_TYPE_UINT32, &metadata->qos_class);
+
+    if (metadata->has_cpu_time) {
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_USER_TIME_ID, PLPROTOBUF_C_TYPE_UINT64, &metadata->user_time);
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_SYSTEM_TIME_ID, PLPROTOBUF_C_TYPE_UINT64, &metadata->system_time);
     }
 
     return rv;
@@ -1111,85 +4641,116 @@ static size_t plcrash_writer_write_mach_signal (plcrash_async_file_t *file, plcr
 /**
  * @internal
  *
- * Write the crash signal message
+ * Write a raw capture thread message, containing all available registers from @a thread_state and, if non-NULL,
+ * the contents of @a stack.
  *
  * @param file Output file
- * @param siginfo The signal information
+ * @param thread_state The thread's register state.
+ * @param thread_number The thread's index number.
+ * @param crashed If true, mark this as a crashed thread.
+ * @param stack A mapping of the thread's stack memory, or NULL.
+ * @param metadata The thread's captured metadata.
  */
-static size_t plcrash_writer_write_signal (plcrash_async_file_t *file, plcrash_log_signal_info_t *siginfo) {
+static size_t plcrash_writer_write_raw_thread (plcrash_async_file_t *file,
+                                               plcrash_async_thread_state_t *thread_state,
+                                               uint32_t thread_number,
+                                               bool crashed,
+                                               plcrash_async_mobject_t *stack,
+                                               plcrash_log_writer_thread_metadata_t *metadata)
+{
     size_t rv = 0;
-    
-    /* BSD signal info is always required in the current report format; this restriction will be lifted
-     * once we switch to the 2.0 format. */
-    PLCF_ASSERT(siginfo->bsd_info != NULL);
-    
-    /* Fetch the signal name */
-    char name_buf[10];
-    const char *name;
-    if ((name = plcrash_async_signal_signame(siginfo->bsd_info->signo)) == NULL) {
-        PLCF_DEBUG("Warning -- unhandled signal number (signo=%d). This is a bug.", siginfo->bsd_info->signo);
-        snprintf(name_buf, sizeof(name_buf), "#%d", siginfo->bsd_info->signo);
-        name = name_buf;
-    }
 
-    /* Fetch the signal code string */
-    char code_buf[10];
-    const char *code;
-    if ((code = plcrash_async_signal_sigcode(siginfo->bsd_info->signo, siginfo->bsd_info->code)) == NULL) {
-        PLCF_DEBUG("Warning -- unhandled signal sicode (signo=%d, code=%d). This is a bug.", siginfo->bsd_info->signo, siginfo->bsd_info->code);
-        snprintf(code_buf, sizeof(code_buf), "#%d", siginfo->bsd_info->code);
-        code = code_buf;
-    }
-    
-    /* Address value */
-    uint64_t addr = (uintptr_t) siginfo->bsd_info->address;
+    /* Write the thread ID and crashed flag */
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_THREAD_NUMBER_ID, PLPROTOBUF_C_TYPE_UINT32, &thread_number);
+    rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_CRASHED_ID, PLPROTOBUF_C_TYPE_BOOL, &crashed);
+    rv += plcrash_writer_write_thread_metadata(file, metadata);
 
-    /* Write it out */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SIGNAL_NAME_ID, PLPROTOBUF_C_TYPE_STRING, name);
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SIGNAL_CODE_ID, PLPROTOBUF_C_TYPE_STRING, code);
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_SIGNAL_ADDRESS_ID, PLPROTOBUF_C_TYPE_UINT64, &addr);
-    
-    /* Mach exception info */
-    if (siginfo->mach_info != NULL) {
-        uint32_t size;
-        
-        /* Determine size */
-        size = plcrash_writer_write_mach_signal(NULL, siginfo->mach_info);
-        
-        /* Write message */
-        rv += plcrash_writer_pack(file, PLCRASH_PROTO_SIGNAL_MACH_EXCEPTION_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
-        rv += plcrash_writer_write_mach_signal(file, siginfo->mach_info);
+    /* Write out all available registers */
+    size_t reg_count = plcrash_async_thread_state_get_reg_count(thread_state);
+    for (plcrash_regnum_t i = 0; i < reg_count; i++) {
+        if (!plcrash_async_thread_state_has_reg(thread_state, i))
+            continue;
+
+        const char *name = plcrash_async_thread_state_get_reg_name(thread_state, i);
+        plcrash_greg_t value = plcrash_async_thread_state_get_reg(thread_state, i);
+        uint32_t msgsize = (uint32_t) plcrash_writer_write_thread_register(NULL, name, value);
+
+        rv += plcrash_writer_pack(file, PLCRASH_PROTO_THREAD_REGISTERS_ID, PLPROTOBUF_C_TYPE_MESSAGE, &msgsize);
+        rv += plcrash_writer_write_thread_register(file, name, value);
     }
 
+    /* Write the stack memory */
+    if (stack != NULL)
+        rv += plcrash_writer_write_thread_stack(file, stack);
+
     return rv;
 }
 
 /**
  * @internal
  *
- * Write the report info message
+ * Capture and write @a thread in raw form, consuming up to PLCRASH_LOG_WRITER_RAW_STACK_SIZE bytes (or the writer's
+ * configured stack capture size) of @a stack_budget. If the budget is exhausted, only the thread's registers will be
+ * written.
  *
  * @param file Output file
- * @param writer Writer containing report data
+ * @param writer The writer context.
+ * @param thread The thread to be written.
+ * @param thread_ctx Thread state to be written. If NULL, the thread state will be fetched from @a thread.
+ * @param thread_number The thread's index number.
+ * @param crashed If true, mark this as a crashed thread.
+ * @param stack_budget The remaining stack memory budget, in bytes. Will be decremented by the number of stack bytes
+ * written.
  */
-static size_t plcrash_writer_write_report_info (plcrash_async_file_t *file, plcrash_log_writer_t *writer) {
-    size_t rv = 0;
+static void plcrash_writer_write_captured_raw_thread (plcrash_async_file_t *file,
+                                                      plcrash_log_writer_t *writer,
+                                                      thread_t thread,
+                                                      plcrash_async_thread_state_t *thread_ctx,
+                                                      uint32_t thread_number,
+                                                      bool crashed,
+                                                      size_t *stack_budget)
+{
+    plcrash_async_thread_state_t thread_state;
+    plcrash_async_mobject_t stack;
+    plcrash_async_mobject_t *stackp = NULL;
+
+    if (thread_ctx != NULL) {
+        thread_state = *thread_ctx;
+    } else if (plcrash_async_thread_state_mach_thread_init(&thread_state, thread) != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("Could not fetch the thread state for thread %" PRIu32, thread_number);
+        return;
+    }
 
-    /* Note crashed status */
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_REPORT_INFO_USER_REQUESTED_ID, PLPROTOBUF_C_TYPE_BOOL, &writer->report_info.user_requested);
-    
-    /* Write the 128-bit UUID */
-    PLProtobufCBinaryData uuid_bin;
-    
-    uuid_bin.len = sizeof(writer->report_info.uuid_bytes);
-    uuid_bin.data = &writer->report_info.uuid_bytes;
-    rv += plcrash_writer_pack(file, PLCRASH_PROTO_REPORT_INFO_UUID_ID, PLPROTOBUF_C_TYPE_BYTES, &uuid_bin);
+    /* Map the stack memory above the stack pointer */
+    size_t stack_size = writer->stack_capture_size != 0 ? writer->stack_capture_size : PLCRASH_LOG_WRITER_RAW_STACK_SIZE;
+    if (plcrash_writer_map_stack(writer->task, &thread_state, stack_size, stack_budget, thread_number, &stack))
+        stackp = &stack;
+
+    plcrash_log_writer_thread_metadata_t metadata;
+    plcrash_writer_capture_thread_metadata(writer, thread, &metadata);
+
+    /* Write the thread message */
+    plcrash_writer_reservation_t reservation;
+    if (plcrash_writer_pack_reserve(file, PLCRASH_PROTO_THREADS_ID, &reservation)) {
+        plcrash_writer_write_raw_thread(file, &thread_state, thread_number, crashed, stackp, &metadata);
+        plcrash_writer_pack_commit(file, &reservation);
+    } else {
+        uint32_t size = (uint32_t) plcrash_writer_write_raw_thread(NULL, &thread_state, thread_number, crashed, stackp, &metadata);
+        plcrash_writer_pack(file, PLCRASH_PROTO_THREADS_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+        plcrash_writer_write_raw_thread(file, &thread_state, thread_number, crashed, stackp, &metadata);
+    }
 
-    return rv;
+    if (stackp != NULL)
+        plcrash_async_mobject_free(stackp);
 }
 
+/* Emit a probe marking the start of the named report section */
+#define PLCR_WRITER_SECTION_PROBE(section) PLCR_PROBE_EVENT("writer_section", "%{public}s", section)
+
 /**
- * Write the crash report. All other running threads are suspended while the crash report is generated.
+ * Write the crash report. All other running threads are suspended while the crash report is generated, unless
+ * thread snapshots are enabled via plcrash_log_writer_set_snapshot_threads(), in which case the threads are
+ * resumed once their stacks have been walked.
  *
  * @param writer The writer context.
  * @param crashed_thread The crashed thread. 
@@ -1216,48 +4777,111 @@ plcrash_error_t plcrash_log_writer_write (plcrash_log_writer_t *writer,
      * the thread's stack can not be safely walked. */
     PLCF_ASSERT(pl_mach_thread_self() != crashed_thread || current_state != NULL);
 
+    /* Reset the crash path timing */
+    writer->timings.start = mach_absolute_time();
+    writer->timings.suspend_time = 0;
+    writer->timings.image_time = 0;
+    writer->timings.thread_count = 0;
+
+    /* Start the capture budget */
+    writer->deadline = 0;
+    if (writer->budget_time_limit != 0)
+        writer->deadline = writer->timings.start + writer->budget_time_limit;
+    writer->symbolicated_frames = 0;
+
+    uint32_t max_frames = PLCRASH_LOG_WRITER_MAX_THREAD_FRAMES;
+    if (writer->budget.max_frames != 0 && writer->budget.max_frames < max_frames)
+        max_frames = writer->budget.max_frames;
+
     /* Get a list of all threads */
-    if (task_threads(mach_task_self(), &threads, &thread_count) != KERN_SUCCESS) {
+    if (task_threads(writer->task, &threads, &thread_count) != KERN_SUCCESS) {
         PLCF_DEBUG("Fetching thread list failed");
         thread_count = 0;
     }
     
+    /* In snapshot mode, allocate the thread snapshots before any thread is suspended. If the allocation fails,
+     * the report is written with all threads suspended. */
+    plcrash_log_writer_thread_snapshot_t *snapshots = NULL;
+    vm_size_t snapshots_size = 0;
+    mach_msg_type_number_t snapshot_count = 0;
+    bool threads_resumed = false;
+
+    if (writer->snapshot_threads && thread_count > 0) {
+        vm_address_t addr;
+        snapshots_size = round_page(sizeof(*snapshots) * thread_count);
+        if (vm_allocate(mach_task_self(), &addr, snapshots_size, VM_FLAGS_ANYWHERE) == KERN_SUCCESS) {
+            snapshots = (plcrash_log_writer_thread_snapshot_t *) addr;
+        } else {
+            PLCF_DEBUG("Could not allocate thread snapshots; threads will remain suspended");
+        }
+    }
+
     /* Suspend all but the current thread. */
+    uint64_t suspend_start = mach_absolute_time();
     for (mach_msg_type_number_t i = 0; i < thread_count; i++) {
         if (threads[i] != pl_mach_thread_self())
             thread_suspend(threads[i]);
     }
+    writer->timings.suspend_time = mach_absolute_time() - suspend_start;
 
-    /* Set up a symbol-finding context. */
-    plcrash_async_symbol_cache_t findContext;
-    plcrash_error_t err = plcrash_async_symbol_cache_init(&findContext);
+    /* Select the hot threads to be symbolicated, if any, while their CPU times are stable */
+    plcrash_writer_select_hot_threads(writer, threads, thread_count);
+
+    /* Set up the report context; symbol lookups, unwind data and mappings are cached once per report, and shared by
+     * all threads. */
+    plcrash_writer_report_context_t reportContext;
+    plcrash_error_t err = plcrash_writer_report_context_init(&reportContext, writer, image_list);
     /* Abort if it failed, although that should never actually happen, ever. */
     if (err != PLCRASH_ESUCCESS)
         return err;
 
+    plcrash_async_symbol_cache_t *findContext = reportContext.symbol_cache;
+    PLCR_PROBE_BEGIN("report", "threads=%u", (unsigned int) thread_count);
+
+    /* Image memory may only be referenced directly, rather than remapped, when writing a crash report with all other
+     * threads suspended for the duration; live and snapshot reports may race with image unloading. */
+    bool direct_mappings = !writer->report_info.user_requested && snapshots == NULL;
+    if (direct_mappings)
+        plcrash_async_mobject_pool_set_direct(&findContext->mappings, true);
+
+    /* If configured, walk all stacks in parallel before any thread is written; the walked threads are then
+     * symbolicated and written in order below. */
+    plcrash_log_writer_thread_snapshot_t *walked = NULL;
+    vm_size_t walked_size = 0;
+    if (writer->unwind_workers > 1 && !writer->raw_capture && thread_count > 1)
+        walked = plcrash_writer_parallel_walk(writer, threads, thread_count, crashed_thread, image_list, max_frames, &walked_size);
+
+    /* Reset the symbol name table; names are recorded as threads are captured, and written ahead of each thread */
+    if (writer->symbol_names != NULL)
+        plcrash_writer_symbol_names_reset(writer->symbol_names);
+
     /* Write the file header */
+    PLCR_WRITER_SECTION_PROBE("header");
     {
-        uint8_t version = PLCRASH_REPORT_FILE_VERSION;
+        uint8_t version;
+        if (writer->symbol_names != NULL)
+            version = writer->compressor != NULL ? PLCRASH_REPORT_FILE_VERSION_SYMBOL_NAMES_COMPRESSED : PLCRASH_REPORT_FILE_VERSION_SYMBOL_NAMES;
+        else
+            version = writer->compressor != NULL ? PLCRASH_REPORT_FILE_VERSION_COMPRESSED : PLCRASH_REPORT_FILE_VERSION;
 
         /* Write the magic string (with no trailing NULL) and the version number */
         plcrash_async_file_write(file, PLCRASH_REPORT_FILE_MAGIC, strlen(PLCRASH_REPORT_FILE_MAGIC));
         plcrash_async_file_write(file, &version, sizeof(version));
+
+        /* Compress everything following the header; the compressed data is emitted when the file is flushed. */
+        if (writer->compressor != NULL)
+            plcrash_async_file_set_compressor(file, writer->compressor);
     }
     
     
     /* Report Info */
-    {
-        uint32_t size;
-        
-        /* Determine size */
-        size = plcrash_writer_write_report_info(NULL, writer);
-        
-        /* Write message */
-        plcrash_writer_pack(file, PLCRASH_PROTO_REPORT_INFO_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
-        plcrash_writer_write_report_info(file, writer);
-    }
+    PLCR_WRITER_SECTION_PROBE("report_info");
+    uint8_t *static_data = writer->static_sections.data;
+    plcrash_async_file_write(file, static_data, writer->static_sections.report_info_length);
+    static_data += writer->static_sections.report_info_length;
 
     /* System Info */
+    PLCR_WRITER_SECTION_PROBE("system_info");
     {
         time_t timestamp;
         uint32_t size;
@@ -1268,63 +4892,112 @@ plcrash_error_t plcrash_log_writer_write (plcrash_log_writer_t *writer,
             timestamp = 0;
         }
 
+        writer->summary.timestamp = timestamp;
+
         /* Determine size */
-        size = plcrash_writer_write_system_info(NULL, writer, timestamp);
+        size = writer->static_sections.system_info_length + plcrash_writer_write_system_info_timestamp(NULL, timestamp);
         
         /* Write message */
         plcrash_writer_pack(file, PLCRASH_PROTO_SYSTEM_INFO_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
-        plcrash_writer_write_system_info(file, writer, timestamp);
+        plcrash_async_file_write(file, static_data, writer->static_sections.system_info_length);
+        plcrash_writer_write_system_info_timestamp(file, timestamp);
+        static_data += writer->static_sections.system_info_length;
     }
     
-    /* Machine Info */
-    {
+    /* Machine, App, and Process Info */
+    PLCR_WRITER_SECTION_PROBE("process_info");
+    plcrash_async_file_write(file, static_data, writer->static_sections.info_length);
+
+    /* Incremental reports refer to their base report. If the baseline has not yet been populated, this report is
+     * written in full, and recorded as the new base report. */
+    plcrash_log_writer_baseline_t *baseline = writer->raw_capture ? NULL : writer->baseline;
+    bool incremental = plcrash_writer_incremental(writer);
+    uint32_t numbered_threads = thread_count;
+    if (current_state == NULL) {
+        for (mach_msg_type_number_t i = 0; i < thread_count; i++) {
+            if (threads[i] == pl_mach_thread_self())
+                numbered_threads--;
+        }
+    }
+
+    if (incremental) {
+        PLProtobufCBinaryData uuid_bin;
         uint32_t size;
 
-        /* Determine size */
-        size = plcrash_writer_write_machine_info(NULL, writer);
+        uuid_bin.len = sizeof(baseline->uuid);
+        uuid_bin.data = baseline->uuid;
 
-        /* Write message */
-        plcrash_writer_pack(file, PLCRASH_PROTO_MACHINE_INFO_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
-        plcrash_writer_write_machine_info(file, writer);
+        size = (uint32_t) plcrash_writer_pack(NULL, PLCRASH_PROTO_BASE_REPORT_UUID_ID, PLPROTOBUF_C_TYPE_BYTES, &uuid_bin);
+        size += plcrash_writer_pack(NULL, PLCRASH_PROTO_BASE_REPORT_THREAD_COUNT_ID, PLPROTOBUF_C_TYPE_UINT32, &numbered_threads);
+
+        plcrash_writer_pack(file, PLCRASH_PROTO_BASE_REPORT_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+        plcrash_writer_pack(file, PLCRASH_PROTO_BASE_REPORT_UUID_ID, PLPROTOBUF_C_TYPE_BYTES, &uuid_bin);
+        plcrash_writer_pack(file, PLCRASH_PROTO_BASE_REPORT_THREAD_COUNT_ID, PLPROTOBUF_C_TYPE_UINT32, &numbered_threads);
+    } else if (baseline != NULL) {
+        memcpy(baseline->uuid, writer->report_info.uuid_bytes, sizeof(baseline->uuid));
+        memset(baseline->threads, 0, sizeof(baseline->threads));
+        baseline->thread_count = 0;
+        baseline->image_count = 0;
     }
 
-    /* App info */
-    {
-        uint32_t size;
+    /* If prioritizing the crashed thread, write the signal ahead of the threads. All required report sections then
+     * precede the threads, and a report truncated after the crashed thread remains decodable. */
+    if (writer->prioritize_threads)
+        plcrash_writer_write_signal_message(file, siginfo);
 
-        /* Determine size */
-        size = plcrash_writer_write_app_info(NULL, writer->application_info.app_identifier, writer->application_info.app_version, writer->application_info.app_marketing_version);
-        
-        /* Write message */
-        plcrash_writer_pack(file, PLCRASH_PROTO_APP_INFO_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
-        plcrash_writer_write_app_info(file, writer->application_info.app_identifier, writer->application_info.app_version, writer->application_info.app_marketing_version);
-    }
-    
-    /* Process info */
-    {
-        uint32_t size;
-        
-        /* Determine size */
-        size = plcrash_writer_write_process_info(NULL, writer->process_info.process_name, writer->process_info.process_id, 
-                                                 writer->process_info.process_path, writer->process_info.parent_process_name,
-                                                 writer->process_info.parent_process_id, writer->process_info.native,
-                                                 writer->process_info.start_time);
-        
-        /* Write message */
-        plcrash_writer_pack(file, PLCRASH_PROTO_PROCESS_INFO_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
-        plcrash_writer_write_process_info(file, writer->process_info.process_name, writer->process_info.process_id, 
-                                          writer->process_info.process_path, writer->process_info.parent_process_name, 
-                                          writer->process_info.parent_process_id, writer->process_info.native,
-                                          writer->process_info.start_time);
-    }
-    
-    /* Threads */
-    uint32_t thread_number = 0;
+    /*
+     * Threads and their referenced images. These are written in priority order, ensuring that a report truncated by
+     * the output limit retains the data required to symbolicate the crashed thread: the crashed thread, followed by
+     * the images referenced by its frames, and then each remaining thread, followed by any images referenced by
+     * its frames that have not already been written.
+     *
+     * Thread numbers are assigned in task_threads() order, regardless of the order in which threads are written.
+     * If thread prioritization is enabled, the main thread is written immediately after the crashed thread.
+     */
+    PLCR_WRITER_SECTION_PROBE("threads");
+    mach_msg_type_number_t crashed_index = thread_count;
+    mach_msg_type_number_t self_index = thread_count;
+    mach_msg_type_number_t main_index = thread_count;
     for (mach_msg_type_number_t i = 0; i < thread_count; i++) {
+        if (threads[i] == crashed_thread)
+            crashed_index = i;
+
+        if (writer->prioritize_threads && threads[i] == writer->main_thread)
+            main_index = i;
+
+        if (threads[i] == pl_mach_thread_self())
+            self_index = i;
+    }
+
+    writer->written_images.count = 0;
+    writer->written_images.overflowed = false;
+
+    /* Summary */
+    writer->summary.magic = PLCRASH_LOG_SUMMARY_MAGIC;
+    writer->summary.version = PLCRASH_LOG_SUMMARY_VERSION;
+    writer->summary.signo = siginfo->bsd_info->signo;
+    writer->summary.code = siginfo->bsd_info->code;
+    writer->summary.exception_name_hash = plcrash_writer_exception_name_hash(writer);
+    writer->summary.crashed_thread_signature = 0;
+    writer->summary.report_size = 0;
+    writer->summary.occurrence_count = 1;
+    writer->summary.reserved = 0;
+    writer->summary.last_timestamp = writer->summary.timestamp;
+
+    size_t stack_budget = PLCRASH_LOG_WRITER_RAW_STACK_BUDGET;
+    uint32_t written_threads = 0;
+    for (mach_msg_type_number_t n = 0; n < thread_count; n++) {
+        /* Write the crashed thread first, followed by the main thread if prioritized, and all other threads in order */
+        mach_msg_type_number_t i = plcrash_writer_thread_write_index(n, thread_count, crashed_index, main_index);
+
         thread_t thread = threads[i];
         plcrash_async_thread_state_t *thr_ctx = NULL;
         bool crashed = false;
-        uint32_t size;
+
+        /* The current thread is omitted if no context is available; it is not assigned a thread number */
+        uint32_t thread_number = i;
+        if (current_state == NULL && self_index < i)
+            thread_number--;
 
         /* If executing on the target thread, we need to a valid context to walk */
         if (pl_mach_thread_self() == thread) {
@@ -1340,56 +5013,307 @@ plcrash_error_t plcrash_log_writer_write (plcrash_log_writer_t *writer,
             crashed = true;
         }
 
-        /* Determine the size */
-        size = plcrash_writer_write_thread(NULL, writer, mach_task_self(), thread, thread_number, thr_ctx, image_list, &findContext, crashed);
+        /* Omit the remaining threads once the thread limit or deadline has been reached. The crashed thread is
+         * written first, and is always included. */
+        if (written_threads > 0) {
+            if (writer->budget.max_threads != 0 && written_threads >= writer->budget.max_threads)
+                break;
 
-        /* Write message */
-        plcrash_writer_pack(file, PLCRASH_PROTO_THREADS_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
-        plcrash_writer_write_thread(file, writer, mach_task_self(), thread, thread_number, thr_ctx, image_list, &findContext, crashed);
+            if (plcrash_writer_past_deadline(writer)) {
+                PLCF_DEBUG("Capture deadline reached after %" PRIu32 " threads", written_threads);
+                break;
+            }
+        }
+        written_threads++;
+
+        /* In raw capture mode, write the thread's registers and stack memory without walking the stack */
+        uint64_t walk_start = mach_absolute_time();
+        if (writer->raw_capture) {
+            plcrash_writer_write_captured_raw_thread(file, writer, thread, thr_ctx, thread_number, crashed, &stack_budget);
+            plcrash_writer_record_thread_walk(writer, thread_number, 0, mach_absolute_time() - walk_start);
+            if (crashed && writer->prioritize_threads)
+                plcrash_async_file_flush(file);
+            continue;
+        }
+
+        /* Walk the thread's stack once, unless already walked in parallel */
+        uint64_t walk_time;
+        if (walked != NULL && walked[i].thread_number != UINT32_MAX) {
+            plcrash_writer_thread_snapshot_restore(&walked[i], writer->thread_capture);
+            walk_time = walked[i].walk_time;
+        } else {
+            uint32_t thread_max_frames = plcrash_writer_thread_max_frames(writer, thread, crashed, max_frames);
+            bool capture_registers = crashed || writer->all_thread_registers;
+            plcrash_writer_capture_thread(writer->thread_capture, writer->task, thread, thr_ctx, image_list, &reportContext.unwind_cache, capture_registers, thread_max_frames, writer->deadline);
+            plcrash_writer_capture_thread_metadata(writer, thread, &writer->thread_capture->metadata);
+            walk_time = mach_absolute_time() - walk_start;
+        }
+        plcrash_log_writer_thread_timing_t *timing = plcrash_writer_record_thread_walk(writer, thread_number, writer->thread_capture->frame_count, walk_time);
+
+        /* Omit threads whose stacks are unchanged since the base report; the crashed thread is always written. When
+         * writing the base report, record each thread's stack. */
+        if (baseline != NULL && thread_number < PLCRASH_LOG_WRITER_MAX_BASELINE_THREADS) {
+            plcrash_log_writer_baseline_thread_t *base_thread = &baseline->threads[thread_number];
+            uint64_t hash = plcrash_writer_thread_hash(writer->thread_capture);
+
+            if (!incremental) {
+                base_thread->thread = thread;
+                base_thread->hash = hash;
+                if (thread_number >= baseline->thread_count)
+                    baseline->thread_count = thread_number + 1;
+            } else if (!crashed && thread_number < baseline->thread_count && base_thread->thread == thread && base_thread->hash == hash) {
+                continue;
+            }
+        }
+
+        /* Capture the thread's stack memory, if enabled. The stack is mapped directly, and is not captured for
+         * snapshots, as the thread will have been resumed before the snapshot is written. */
+        if (writer->stack_capture_size != 0 && snapshots == NULL && (crashed || writer->stack_capture_all_threads)) {
+            plcrash_async_thread_state_t thread_state;
+            plcrash_error_t err = PLCRASH_ESUCCESS;
+            if (thr_ctx != NULL)
+                thread_state = *thr_ctx;
+            else
+                err = plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+            if (err == PLCRASH_ESUCCESS) {
+                writer->thread_capture->has_stack = plcrash_writer_map_stack(writer->task, &thread_state, writer->stack_capture_size,
+                                                                             &stack_budget, thread_number, &writer->thread_capture->stack);
+            }
+        }
+
+        /* Threads outside of the symbolication policy are written with their PCs only */
+        bool symbolicate = plcrash_writer_thread_symbolicated(writer, thread, crashed);
+
+        /* In snapshot mode, defer symbolication and output until all threads have been resumed */
+        if (snapshots != NULL) {
+            plcrash_writer_thread_snapshot_save(&snapshots[snapshot_count], writer->thread_capture, thread_number, crashed);
+            snapshots[snapshot_count++].symbolicate = symbolicate;
+            continue;
+        }
 
-        thread_number++;
+        uint64_t symbolication_start = mach_absolute_time();
+        plcrash_writer_write_captured_thread(file, writer, thread_number, image_list, findContext, crashed, symbolicate);
+        if (timing != NULL)
+            timing->symbolication_time = mach_absolute_time() - symbolication_start;
+
+        if (writer->thread_capture->has_stack) {
+            plcrash_async_mobject_free(&writer->thread_capture->stack);
+            writer->thread_capture->has_stack = false;
+        }
+
+        /* Flush the crashed thread to disk before the remaining threads are walked */
+        if (crashed && writer->prioritize_threads)
+            plcrash_async_file_flush(file);
     }
 
-    /* Binary Images */
-    plcrash_async_image_list_set_reading(image_list, true);
+    if (snapshots != NULL) {
+        /* All stacks have been walked; resume the threads before symbolicating and writing the snapshots. From here
+         * on, images may be unloaded concurrently, and must not be referenced directly. */
+        PLCF_ASSERT(!direct_mappings);
+        for (mach_msg_type_number_t i = 0; i < thread_count; i++) {
+            if (threads[i] != pl_mach_thread_self())
+                thread_resume(threads[i]);
+        }
+        threads_resumed = true;
+
+        for (mach_msg_type_number_t i = 0; i < snapshot_count; i++) {
+            uint64_t symbolication_start = mach_absolute_time();
+            plcrash_writer_thread_snapshot_restore(&snapshots[i], writer->thread_capture);
+            plcrash_writer_write_captured_thread(file, writer, snapshots[i].thread_number, image_list, findContext, snapshots[i].crashed, snapshots[i].symbolicate);
+            if (snapshots[i].crashed && writer->prioritize_threads)
+                plcrash_async_file_flush(file);
+
+            /* Attribute the symbolication time to the snapshot's thread timing, if any */
+            for (uint32_t j = 0; j < writer->timings.thread_count; j++) {
+                if (writer->timings.threads[j].thread_number == snapshots[i].thread_number) {
+                    writer->timings.threads[j].symbolication_time = mach_absolute_time() - symbolication_start;
+                    break;
+                }
+            }
+        }
 
-    plcrash_async_image_t *image = NULL;
-    while ((image = plcrash_async_image_list_next(image_list, image)) != NULL) {
+        vm_deallocate(mach_task_self(), (vm_address_t) snapshots, snapshots_size);
+    }
+
+    if (walked != NULL)
+        vm_deallocate(mach_task_self(), (vm_address_t) walked, walked_size);
+
+    /* Stack Samples, and the images they reference */
+    PLCR_WRITER_SECTION_PROBE("stack_samples");
+    if (writer->stack_sampler != NULL) {
+        plcrash_stack_sampler_t *sampler = writer->stack_sampler;
         uint32_t size;
 
+        plcrash_stack_sampler_lock(sampler);
+
         /* Calculate the message size */
-        size = plcrash_writer_write_binary_image(NULL, &image->macho_image);
-        plcrash_writer_pack(file, PLCRASH_PROTO_BINARY_IMAGES_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
-        plcrash_writer_write_binary_image(file, &image->macho_image);
+        size = (uint32_t) plcrash_writer_write_stack_samples(NULL, sampler);
+        plcrash_writer_pack(file, PLCRASH_PROTO_STACK_SAMPLES_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+        plcrash_writer_write_stack_samples(file, sampler);
+
+        plcrash_async_image_list_set_reading(image_list, true);
+        for (uint32_t i = 0; i < sampler->count; i++) {
+            for (uint32_t j = 0; j < sampler->samples[i].frame_count; j++) {
+                if (!plcrash_writer_write_referenced_image(file, writer, image_list, sampler->samples[i].pcs[j], NULL))
+                    break;
+            }
+        }
+        plcrash_async_image_list_set_reading(image_list, false);
+
+        plcrash_stack_sampler_unlock(sampler);
+    }
+
+    /* Custom Data. The registered regions are written as-is; entries that were being modified at the time of the
+     * crash are identified and discarded by their sequence numbers when the report is decoded. */
+    PLCR_WRITER_SECTION_PROBE("custom_data");
+    if (writer->custom_key_value_area != NULL || writer->custom_breadcrumbs != NULL) {
+        PLProtobufCBinaryData key_value_area;
+        PLProtobufCBinaryData breadcrumbs;
+        uint32_t size;
+
+        key_value_area.data = (void *) writer->custom_key_value_area;
+        key_value_area.len = writer->custom_key_value_area_length;
+        breadcrumbs.data = (void *) writer->custom_breadcrumbs;
+        breadcrumbs.len = writer->custom_breadcrumbs_length;
+
+        PLProtobufCBinaryData *kv = key_value_area.data != NULL ? &key_value_area : NULL;
+        PLProtobufCBinaryData *bc = breadcrumbs.data != NULL ? &breadcrumbs : NULL;
+
+        size = (uint32_t) plcrash_writer_write_custom_data(NULL, kv, bc);
+        plcrash_writer_pack(file, PLCRASH_PROTO_CUSTOM_DATA_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+        plcrash_writer_write_custom_data(file, kv, bc);
+    }
+
+    /* Memory Statistics */
+    PLCR_WRITER_SECTION_PROBE("memory_stats");
+    if (writer->memory_statistics) {
+        plcrash_writer_memory_stats_t stats;
+        uint32_t size;
+
+        if (plcrash_writer_capture_memory_stats(writer->task, &stats) == PLCRASH_ESUCCESS) {
+            /* Calculate the message size */
+            size = (uint32_t) plcrash_writer_write_memory_stats(NULL, &stats);
+            plcrash_writer_pack(file, PLCRASH_PROTO_MEMORY_STATISTICS_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+            plcrash_writer_write_memory_stats(file, &stats);
+        }
+    }
+
+    /* Remaining Binary Images. If only referenced images are to be written, the remaining images are summarized. Raw
+     * capture reports must include all images, as the referenced images are not known until the report is decoded. */
+    PLCR_WRITER_SECTION_PROBE("binary_images");
+    bool omit_images = writer->referenced_images_only && !writer->written_images.overflowed && !writer->raw_capture;
+    uint32_t omitted_count = 0;
+    uint64_t omitted_hash = 0;
+    uint64_t image_start = mach_absolute_time();
+
+    plcrash_async_image_list_set_reading(image_list, true);
+
+    plcrash_async_image_cursor_t image_cursor;
+    plcrash_async_image_t *image;
+    plcrash_async_image_cursor_init(&image_cursor, image_list);
+    while ((image = plcrash_async_image_cursor_next(&image_cursor)) != NULL) {
+        if (plcrash_writer_image_set_contains(&writer->written_images, image))
+            continue;
+
+        if (incremental && plcrash_writer_baseline_contains_image(baseline, image))
+            continue;
+
+        if (omit_images) {
+            omitted_count++;
+            omitted_hash += plcrash_writer_omitted_image_hash(image);
+            continue;
+        }
+
+        plcrash_writer_write_image_list_entry(file, image);
+        if (baseline != NULL && !incremental)
+            plcrash_writer_baseline_add_image(baseline, image);
+    }
+
+    /* Record the referenced images written ahead of the remaining images */
+    if (baseline != NULL && !incremental) {
+        for (uint32_t i = 0; i < writer->written_images.count; i++)
+            plcrash_writer_baseline_add_image(baseline, writer->written_images.ordered[i]);
     }
 
     plcrash_async_image_list_set_reading(image_list, false);
+    writer->timings.image_time = mach_absolute_time() - image_start;
 
     /* Exception */
+    PLCR_WRITER_SECTION_PROBE("exception");
     if (writer->uncaught_exception.has_exception) {
         uint32_t size;
 
+        /* The threads have been written; reuse the capture buffer to resolve the exception's symbols once, within
+         * the symbolication budget, ahead of the sizing and writing passes. */
+        plcrash_writer_capture_exception(writer, writer->thread_capture, image_list, findContext);
+        if (writer->symbol_names != NULL)
+            plcrash_writer_write_symbol_names(file, writer->symbol_names);
+
         /* Calculate the message size */
-        size = plcrash_writer_write_exception(NULL, writer, image_list, &findContext);
+        size = (uint32_t) plcrash_writer_write_exception(NULL, writer, writer->thread_capture, image_list, findContext);
         plcrash_writer_pack(file, PLCRASH_PROTO_EXCEPTION_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
-        plcrash_writer_write_exception(file, writer, image_list, &findContext);
+        plcrash_writer_write_exception(file, writer, writer->thread_capture, image_list, findContext);
     }
     
-    /* Signal */
-    {
+    /* Signal, if not already written ahead of the threads */
+    PLCR_WRITER_SECTION_PROBE("signal");
+    if (!writer->prioritize_threads)
+        plcrash_writer_write_signal_message(file, siginfo);
+
+    /* Any remaining symbol names not yet written ahead of the records that refer to them */
+    PLCR_WRITER_SECTION_PROBE("symbol_names");
+    if (writer->symbol_names != NULL)
+        plcrash_writer_write_symbol_names(file, writer->symbol_names);
+
+    /* Symbolication Diagnostics */
+    PLCR_WRITER_SECTION_PROBE("symbolication_diagnostics");
+    if (writer->symbolication_diagnostics && findContext->pc_cache_hits + findContext->pc_cache_misses > 0) {
         uint32_t size;
-        
+
         /* Calculate the message size */
-        size = plcrash_writer_write_signal(NULL, siginfo);
-        plcrash_writer_pack(file, PLCRASH_PROTO_SIGNAL_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
-        plcrash_writer_write_signal(file, siginfo);
+        size = plcrash_writer_write_symbolication_diagnostics(NULL, findContext);
+        plcrash_writer_pack(file, PLCRASH_PROTO_SYMBOLICATION_DIAGNOSTICS_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+        plcrash_writer_write_symbolication_diagnostics(file, findContext);
+    }
+
+    /* Omitted Images */
+    PLCR_WRITER_SECTION_PROBE("omitted_images");
+    if (omit_images) {
+        plcrash_writer_pack(file, PLCRASH_PROTO_OMITTED_IMAGE_COUNT_ID, PLPROTOBUF_C_TYPE_UINT32, &omitted_count);
+        plcrash_writer_pack(file, PLCRASH_PROTO_OMITTED_IMAGE_HASH_ID, PLPROTOBUF_C_TYPE_UINT64, &omitted_hash);
+    }
+
+    /* Writer Diagnostics. These are written last, in a second report info record, so that all prior phases are timed. */
+    PLCR_WRITER_SECTION_PROBE("writer_diagnostics");
+    if (writer->writer_diagnostics) {
+        mach_timebase_info_data_t timebase;
+        uint64_t total_time = mach_absolute_time() - writer->timings.start;
+        uint32_t size;
+
+        /* Fall back on reporting mach_absolute_time() units if the timebase is unavailable */
+        if (mach_timebase_info(&timebase) != KERN_SUCCESS || timebase.denom == 0) {
+            timebase.numer = 1;
+            timebase.denom = 1;
+        }
+
+        size = (uint32_t) plcrash_writer_write_report_info_diagnostics(NULL, writer, total_time, &timebase);
+        plcrash_writer_pack(file, PLCRASH_PROTO_REPORT_INFO_ID, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+        plcrash_writer_write_report_info_diagnostics(file, writer, total_time, &timebase);
     }
     
-    plcrash_async_symbol_cache_free(&findContext);
+    /* The base report has been written in full */
+    if (baseline != NULL && !incremental)
+        baseline->valid = true;
+
+    PLCF_DEBUG("Symbol cache: %" PRIu32 " hits, %" PRIu32 " misses", findContext->pc_cache_hits, findContext->pc_cache_misses);
+    if (direct_mappings)
+        plcrash_async_mobject_pool_set_direct(&findContext->mappings, false);
+    plcrash_writer_report_context_free(&reportContext);
     
     /* Clean up the thread array */
     for (mach_msg_type_number_t i = 0; i < thread_count; i++) {
-        if (threads[i] != pl_mach_thread_self())
+        if (threads[i] != pl_mach_thread_self() && !threads_resumed)
             thread_resume(threads[i]);
 
         mach_port_deallocate(mach_task_self(), threads[i]);
@@ -1397,9 +5321,104 @@ plcrash_error_t plcrash_log_writer_write (plcrash_log_writer_t *writer,
 
     vm_deallocate(mach_task_self(), (vm_address_t)threads, sizeof(thread_t) * thread_count);
     
+    PLCR_PROBE_END("report", "");
     return PLCRASH_ESUCCESS;
 }
 
+/**
+ * Determine whether a crash repeats the crash recorded by the pending report's summary at @a summary_path and, if
+ * so, record the repeat in the summary's occurrence record rather than writing a new report.
+ *
+ * Only the crashed thread's top #PLCRASH_LOG_SUMMARY_SIGNATURE_FRAMES frames are walked, into the writer's thread
+ * capture buffer; the walked frames are not symbolicated. A crash is considered a repeat if its signal, uncaught
+ * exception name, and crashed thread signature are all equal to those of the summary. Other threads are neither
+ * suspended nor walked.
+ *
+ * @param writer The writer that would otherwise write the report.
+ * @param crashed_thread The crashed thread.
+ * @param image_list The Mach-O image list.
+ * @param summary_path The path of the pending report's summary, as written by plcrash_log_writer_write_summary().
+ * @param siginfo Signal information.
+ * @param current_state If non-NULL, the given thread state will be used when walking the current thread. The state
+ * must remain valid until this function returns. Must be non-NULL if @a crashed_thread is the current thread.
+ *
+ * @return Returns PLCRASH_ESUCCESS if the crash was recorded as a repeat, in which case no report should be written.
+ * Returns PLCRASH_ENOTFOUND if no summary is pending or the crash does not match it, or another error if the summary
+ * could not be read or updated; in either case, the report should be written as usual.
+ *
+ * @warning This function is async-safe.
+ */
+plcrash_error_t plcrash_log_writer_collapse_repeat (plcrash_log_writer_t *writer,
+                                                   thread_t crashed_thread,
+                                                   plcrash_async_image_list_t *image_list,
+                                                   const char *summary_path,
+                                                   plcrash_log_signal_info_t *siginfo,
+                                                   plcrash_async_thread_state_t *current_state)
+{
+    plcrash_log_summary_t summary;
+    plcrash_error_t err;
+
+    /* A context must be supplied if the current thread is marked as the crashed thread */
+    PLCF_ASSERT(pl_mach_thread_self() != crashed_thread || current_state != NULL);
+
+    int fd = open(summary_path, O_RDWR);
+    if (fd < 0)
+        return PLCRASH_ENOTFOUND;
+
+    /* Compare the cheap fields before walking the crashed thread */
+    if (pread(fd, &summary, sizeof(summary), 0) != (ssize_t) sizeof(summary)) {
+        err = PLCRASH_ENOTFOUND;
+        goto cleanup;
+    }
+
+    if (summary.magic != PLCRASH_LOG_SUMMARY_MAGIC || summary.version != PLCRASH_LOG_SUMMARY_VERSION ||
+        summary.signo != siginfo->bsd_info->signo || summary.code != siginfo->bsd_info->code ||
+        summary.exception_name_hash != plcrash_writer_exception_name_hash(writer) ||
+        summary.crashed_thread_signature == 0)
+    {
+        err = PLCRASH_ENOTFOUND;
+        goto cleanup;
+    }
+
+    /* Walk only the frames that contribute to the signature */
+    uint32_t max_frames = PLCRASH_LOG_SUMMARY_SIGNATURE_FRAMES;
+    if (writer->budget.max_frames != 0 && writer->budget.max_frames < max_frames)
+        max_frames = writer->budget.max_frames;
+
+    plcrash_async_thread_state_t *thr_ctx = crashed_thread == pl_mach_thread_self() ? current_state : NULL;
+    plframe_unwind_cache_t unwindCache;
+    plframe_unwind_cache_init(&unwindCache);
+    plcrash_writer_capture_thread(writer->thread_capture, writer->task, crashed_thread, thr_ctx, image_list, &unwindCache, false, max_frames, 0);
+    plframe_unwind_cache_free(&unwindCache);
+
+    if (plcrash_writer_crashed_thread_signature(writer->thread_capture, image_list) != summary.crashed_thread_signature) {
+        err = PLCRASH_ENOTFOUND;
+        goto cleanup;
+    }
+
+    /* Update the fixed-offset occurrence record in place */
+    time_t timestamp;
+    if (time(&timestamp) == (time_t)-1)
+        timestamp = 0;
+
+    summary.occurrence_count = summary.occurrence_count < UINT32_MAX ? summary.occurrence_count + 1 : UINT32_MAX;
+    summary.last_timestamp = timestamp;
+
+    off_t offset = offsetof(plcrash_log_summary_t, occurrence_count);
+    size_t length = sizeof(summary) - (size_t) offset;
+    if (pwrite(fd, ((uint8_t *) &summary) + offset, length, offset) != (ssize_t) length) {
+        PLCF_DEBUG("Failed to update the summary occurrence record: %s", strerror(errno));
+        err = PLCRASH_EINTERNAL;
+        goto cleanup;
+    }
+
+    err = PLCRASH_ESUCCESS;
+
+cleanup:
+    close(fd);
+    return err;
+}
+
 
 /**
  * @} plcrash_log_writer
@@ -43,98 +43,73 @@ typedef enum {
 static inline uint32_t
 zigzag32 (int32_t v)
 {
-    if (v < 0)
-        return ((uint32_t)(-v)) * 2 - 1;
-    else
-        return v * 2;
+    return ((uint32_t) v << 1) ^ (uint32_t) (v >> 31);
 }
 static inline uint64_t
 zigzag64 (int64_t v)
 {
-    if (v < 0)
-        return ((uint64_t)(-v)) * 2 - 1;
-    else
-        return v * 2;
+    return ((uint64_t) v << 1) ^ (uint64_t) (v >> 63);
 }
+
+/*
+ * Return the number of bytes required to varint-encode @a value. The bit width is derived
+ * via clz, avoiding the per-byte comparisons of the original protobuf-c implementation.
+ */
 static inline size_t
-uint32_pack (uint32_t value, uint8_t *out)
+uint64_size (uint64_t value)
 {
-    unsigned rv = 0;
-    if (value >= 0x80)
-    {
-        out[rv++] = value | 0x80;
+    /* value|1 ensures clz is defined for zero, which encodes as a single byte. */
+    unsigned bits = 64 - __builtin_clzll (value | 1);
+    return (bits + 6) / 7;
+}
+static inline size_t
+uint32_size (uint32_t value)
+{
+    unsigned bits = 32 - __builtin_clz (value | 1);
+    return (bits + 6) / 7;
+}
+static inline size_t
+int32_size (int32_t value)
+{
+    /* Negative values are sign-extended to 64 bits, and always require 10 bytes. */
+    if (value < 0)
+        return MAX_UINT64_ENCODED_SIZE;
+    return uint32_size (value);
+}
+
+/*
+ * Encode @a value as a varint of exactly @a length bytes, as computed by uint64_size(). The
+ * store loop has a fixed trip count and no data-dependent branches.
+ */
+static inline size_t
+varint_pack (uint64_t value, size_t length, uint8_t *out)
+{
+    size_t i;
+    for (i = 0; i < length - 1; i++) {
+        out[i] = (uint8_t) (value | 0x80);
         value >>= 7;
-        if (value >= 0x80)
-        {
-            out[rv++] = value | 0x80;
-            value >>= 7;
-            if (value >= 0x80)
-            {
-                out[rv++] = value | 0x80;
-                value >>= 7;
-                if (value >= 0x80)
-                {
-                    out[rv++] = value | 0x80;
-                    value >>= 7;
-                }
-            }
-        }
     }
-    /* assert: value<128 */
-    out[rv++] = value;
-    return rv;
+    out[i] = (uint8_t) value;
+    return length;
+}
+static inline size_t
+uint32_pack (uint32_t value, uint8_t *out)
+{
+    return varint_pack (value, uint32_size (value), out);
 }
 static inline size_t
 int32_pack (int32_t value, uint8_t *out)
 {
-    if (value < 0)
-    {
-        out[0] = value | 0x80;
-        out[1] = (value>>7) | 0x80;
-        out[2] = (value>>14) | 0x80;
-        out[3] = (value>>21) | 0x80;
-        out[4] = (value>>28) | 0x80;
-        out[5] = out[6] = out[7] = out[8] = 0xff;
-        out[9] = 0x01;
-        return 10;
-    }
-    else
-        return uint32_pack (value, out);
+    return varint_pack ((uint64_t) (int64_t) value, int32_size (value), out);
 }
 static inline size_t sint32_pack (int32_t value, uint8_t *out)
 {
     return uint32_pack (zigzag32 (value), out);
 }
-static size_t
+static inline size_t
 uint64_pack (uint64_t value, uint8_t *out)
 {
-    uint32_t hi = value>>32;
-    uint32_t lo = value;
-    unsigned rv;
-    if (hi == 0)
-        return uint32_pack ((uint32_t)lo, out);
-    out[0] = (lo) | 0x80;
-    out[1] = (lo>>7) | 0x80;
-    out[2] = (lo>>14) | 0x80;
-    out[3] = (lo>>21) | 0x80;
-    if (hi < 8)
-    {
-        out[4] = (hi<<4) | (lo>>28);
-        return 5;
-    }
-    else
-    {
-        out[4] = ((hi&7)<<4) | (lo>>28) | 0x80;
-        hi >>= 3;
-    }
-    rv = 5;
-    while (hi >= 128)
-    {
-        out[rv++] = hi | 0x80;
-        hi >>= 7;
-    }
-    out[rv++] = hi;
-    return rv;
+    return varint_pack (value, uint64_size (value), out);
 }
 static inline size_t sint64_pack (int64_t value, uint8_t *out)
 {
@@ -169,12 +144,65 @@ static inline size_t boolean_pack (bool value, uint8_t *out)
 }
 
 /* wire-type will be added in required_field_pack() */
-static size_t tag_pack (uint32_t id, uint8_t *out)
+static inline size_t tag_pack (uint32_t id, uint8_t *out)
+{
+    return uint64_pack (((uint64_t)id) << 3, out);
+}
+static inline size_t tag_size (uint32_t id)
 {
-    if (id < (1<<(32-3)))
-        return uint32_pack (id<<3, out);
-    else
-        return uint64_pack (((uint64_t)id) << 3, out);
+    return uint64_size (((uint64_t)id) << 3);
+}
+
+/* === get_packed_size() === */
+
+/**
+ * @internal
+ *
+ * Compute the encoded size of a field without performing any stores. This implements the
+ * file == NULL sizing pass of plcrash_writer_pack().
+ */
+static size_t plcrash_writer_pack_size (uint32_t field_id, PLProtobufCType field_type, const void *value) {
+    size_t rv = tag_size (field_id);
+
+    switch (field_type)
+    {
+        case PLPROTOBUF_C_TYPE_SINT32:
+            return rv + uint32_size (zigzag32 (*(const int32_t *) value));
+        case PLPROTOBUF_C_TYPE_INT32:
+            return rv + int32_size (*(const int32_t *) value);
+        case PLPROTOBUF_C_TYPE_UINT32:
+        case PLPROTOBUF_C_TYPE_ENUM:
+        case PLPROTOBUF_C_TYPE_MESSAGE:
+            return rv + uint32_size (*(const uint32_t *) value);
+        case PLPROTOBUF_C_TYPE_SINT64:
+            return rv + uint64_size (zigzag64 (*(const int64_t *) value));
+        case PLPROTOBUF_C_TYPE_INT64:
+        case PLPROTOBUF_C_TYPE_UINT64:
+            return rv + uint64_size (*(const uint64_t *) value);
+        case PLPROTOBUF_C_TYPE_SFIXED32:
+        case PLPROTOBUF_C_TYPE_FIXED32:
+        case PLPROTOBUF_C_TYPE_FLOAT:
+            return rv + 4;
+        case PLPROTOBUF_C_TYPE_SFIXED64:
+        case PLPROTOBUF_C_TYPE_FIXED64:
+        case PLPROTOBUF_C_TYPE_DOUBLE:
+            return rv + 8;
+        case PLPROTOBUF_C_TYPE_BOOL:
+            return rv + 1;
+        case PLPROTOBUF_C_TYPE_STRING:
+        {
+            size_t sublen = plcrash_async_utf8_strlen (value);
+            return rv + uint32_size (sublen) + sublen;
+        }
+        case PLPROTOBUF_C_TYPE_BYTES:
+        {
+            size_t sublen = ((const PLProtobufCBinaryData*) value)->len;
+            return rv + uint32_size (sublen) + sublen;
+        }
+        default:
+            PLCF_DEBUG("Unhandled field type %d", field_type);
+            abort();
+    }
 }
 
 /* === pack_to_buffer() === */
@@ -182,6 +210,11 @@ static size_t tag_pack (uint32_t id, uint8_t *out)
 size_t plcrash_writer_pack (plcrash_async_file_t *file, uint32_t field_id, PLProtobufCType field_type, const void *value) {
     size_t rv;
     uint8_t scratch[MAX_UINT64_ENCODED_SIZE * 2];
+
+    /* Sizing pass; no output is required. */
+    if (file == NULL)
+        return plcrash_writer_pack_size (field_id, field_type, value);
+
     rv = tag_pack (field_id, scratch);
     switch (field_type)
     {
@@ -242,7 +275,8 @@ size_t plcrash_writer_pack (plcrash_async_file_t *file, uint32_t field_id, PLPro
             
         case PLPROTOBUF_C_TYPE_STRING:
         {
-            size_t sublen = strlen (value);
+            /* Strings are truncated at the first ill-formed UTF-8 sequence, matching the sizing pass */
+            size_t sublen = plcrash_async_utf8_strlen (value);
             scratch[0] |= PLPROTOBUF_C_WIRE_TYPE_LENGTH_PREFIXED;
             rv += uint32_pack (sublen, scratch + rv);
             if (file != NULL) {
@@ -272,8 +306,14 @@ size_t plcrash_writer_pack (plcrash_async_file_t *file, uint32_t field_id, PLPro
         {
             scratch[0] |= PLPROTOBUF_C_WIRE_TYPE_LENGTH_PREFIXED;
             rv += uint32_pack (*(const uint32_t *) value, scratch + rv);
-            if (file != NULL)
+            if (file != NULL) {
                 plcrash_async_file_write(file, scratch, rv);
+
+                /* The message was sized with minimal-width length prefixes; disable reservations until its end */
+                off_t end = file->total_bytes + *(const uint32_t *) value;
+                if (end > file->presized_end)
+                    file->presized_end = end;
+            }
             break;
         }
         default:
@@ -282,3 +322,141 @@ size_t plcrash_writer_pack (plcrash_async_file_t *file, uint32_t field_id, PLPro
     }
     return rv;
 }
+
+/**
+ * Write a packed repeated field of @a count values of @a field_type. Packed fields are encoded as a single
+ * length-prefixed field containing the concatenated values, avoiding a tag per element.
+ *
+ * Only PLPROTOBUF_C_TYPE_UINT32 and PLPROTOBUF_C_TYPE_UINT64 fields are supported. If @a count is 0, no data will be
+ * written.
+ *
+ * @param file The output file, or NULL to compute the encoded size without writing.
+ * @param field_id The field identifier.
+ * @param field_type The element type.
+ * @param values An array of @a count elements of @a field_type.
+ * @param count The number of elements in @a values.
+ *
+ * @return Returns the total number of bytes written (or that would be written) for the field.
+ */
+size_t plcrash_writer_pack_packed (plcrash_async_file_t *file, uint32_t field_id, PLProtobufCType field_type, const void *values, size_t count) {
+    uint8_t scratch[MAX_UINT64_ENCODED_SIZE * 2];
+    size_t body = 0;
+    size_t rv;
+
+    if (count == 0)
+        return 0;
+
+    /* Compute the body length */
+    for (size_t i = 0; i < count; i++) {
+        switch (field_type) {
+            case PLPROTOBUF_C_TYPE_UINT32:
+                body += uint32_size (((const uint32_t *) values)[i]);
+                break;
+            case PLPROTOBUF_C_TYPE_UINT64:
+                body += uint64_size (((const uint64_t *) values)[i]);
+                break;
+            default:
+                PLCF_DEBUG("Unhandled packed field type %d", field_type);
+                abort();
+        }
+    }
+
+    /* Write the header */
+    rv = tag_pack (field_id, scratch);
+    scratch[0] |= PLPROTOBUF_C_WIRE_TYPE_LENGTH_PREFIXED;
+    rv += uint32_pack ((uint32_t) body, scratch + rv);
+
+    if (file == NULL)
+        return rv + body;
+
+    plcrash_async_file_write(file, scratch, rv);
+
+    /* Write the values */
+    for (size_t i = 0; i < count; i++) {
+        size_t len;
+        if (field_type == PLPROTOBUF_C_TYPE_UINT32)
+            len = uint32_pack (((const uint32_t *) values)[i], scratch);
+        else
+            len = uint64_pack (((const uint64_t *) values)[i], scratch);
+
+        plcrash_async_file_write(file, scratch, len);
+    }
+
+    return rv + body;
+}
+
+/**
+ * Begin writing a length-prefixed field of @a field_id, without first computing the field's length. A maximum-width
+ * length prefix is written, and must be back-patched via plcrash_writer_pack_commit() once the field's contents
+ * have been written.
+ *
+ * This allows nested messages to be written in a single pass, rather than sizing each message (and all of its
+ * children) via an additional plcrash_writer_pack() pass with a NULL @a file.
+ *
+ * Reservations are only supported by memory-backed outputs, which can be patched after the fact; if @a file is NULL
+ * or otherwise can not be patched, no data will be written and false will be returned. In that case, the caller must
+ * fall back on sizing the field's contents prior to writing.
+ *
+ * Reservations are also refused within a message whose length was written via plcrash_writer_pack(); that length was
+ * computed by a NULL @a file sizing pass, which counts minimal-width length prefixes for all nested fields.
+ *
+ * @param file The output file, or NULL.
+ * @param field_id The field identifier.
+ * @param reservation On success, will be initialized with the reservation state to be passed to
+ * plcrash_writer_pack_commit().
+ *
+ * @return Returns true if the length prefix was reserved, or false if reservations are not supported by @a file.
+ */
+bool plcrash_writer_pack_reserve (plcrash_async_file_t *file, uint32_t field_id, plcrash_writer_reservation_t *reservation) {
+    uint8_t scratch[MAX_UINT64_ENCODED_SIZE + PLCRASH_WRITER_RESERVED_LENGTH_SIZE];
+    size_t rv;
+
+    if (file == NULL || !plcrash_async_file_is_patchable(file))
+        return false;
+
+    /* Within a pre-sized message, the reserved width would not match the enclosing message's computed length */
+    if (file->total_bytes < file->presized_end)
+        return false;
+
+    rv = tag_pack (field_id, scratch);
+    scratch[0] |= PLPROTOBUF_C_WIRE_TYPE_LENGTH_PREFIXED;
+
+    /* Zero-length placeholder; patched by plcrash_writer_pack_commit() */
+    for (size_t i = 0; i < PLCRASH_WRITER_RESERVED_LENGTH_SIZE - 1; i++)
+        scratch[rv++] = 0x80;
+    scratch[rv++] = 0x00;
+
+    if (!plcrash_async_file_write(file, scratch, rv))
+        return false;
+
+    reservation->prefix_offset = file->total_bytes - PLCRASH_WRITER_RESERVED_LENGTH_SIZE;
+    reservation->header_size = rv;
+    return true;
+}
+
+/**
+ * Complete a field started via plcrash_writer_pack_reserve(), back-patching the field's length prefix with
+ * the number of bytes written since the reservation was made.
+ *
+ * @param file The output file previously passed to plcrash_writer_pack_reserve().
+ * @param reservation The reservation state.
+ *
+ * @return Returns the total number of bytes written for the field, including the tag and length prefix.
+ */
+size_t plcrash_writer_pack_commit (plcrash_async_file_t *file, plcrash_writer_reservation_t *reservation) {
+    uint8_t prefix[PLCRASH_WRITER_RESERVED_LENGTH_SIZE];
+    off_t body_offset = reservation->prefix_offset + PLCRASH_WRITER_RESERVED_LENGTH_SIZE;
+    uint32_t length = (uint32_t) (file->total_bytes - body_offset);
+
+    /* Encode a padded varint of exactly PLCRASH_WRITER_RESERVED_LENGTH_SIZE bytes */
+    for (size_t i = 0; i < PLCRASH_WRITER_RESERVED_LENGTH_SIZE - 1; i++) {
+        prefix[i] = (uint8_t) (length | 0x80);
+        length >>= 7;
+    }
+    prefix[PLCRASH_WRITER_RESERVED_LENGTH_SIZE - 1] = (uint8_t) length;
+
+    if (!plcrash_async_file_patch(file, reservation->prefix_offset, prefix, sizeof(prefix)))
+        PLCF_DEBUG("Failed to patch reserved length prefix at offset %lld", (long long) reservation->prefix_offset);
+
+    return reservation->header_size + (size_t) (file->total_bytes - body_offset);
+}
@@ -49,7 +49,26 @@ typedef struct PLProtobufCBinaryData {
     void *data;
 } PLProtobufCBinaryData;
 
+/** The size of the padded, maximum-width length prefix written by plcrash_writer_pack_reserve(). */
+#define PLCRASH_WRITER_RESERVED_LENGTH_SIZE 5
+
+/**
+ * A length-prefixed field whose length is written once the field's contents have been written.
+ * @sa plcrash_writer_pack_reserve()
+ */
+typedef struct plcrash_writer_reservation {
+    /** The output offset of the reserved length prefix. */
+    off_t prefix_offset;
+
+    /** The number of bytes written for the field tag and the reserved length prefix. */
+    size_t header_size;
+} plcrash_writer_reservation_t;
+
 size_t plcrash_writer_pack (plcrash_async_file_t *file, uint32_t field_id, PLProtobufCType field_type, const void *value);
+size_t plcrash_writer_pack_packed (plcrash_async_file_t *file, uint32_t field_id, PLProtobufCType field_type, const void *values, size_t count);
+
+bool plcrash_writer_pack_reserve (plcrash_async_file_t *file, uint32_t field_id, plcrash_writer_reservation_t *reservation);
+size_t plcrash_writer_pack_commit (plcrash_async_file_t *file, plcrash_writer_reservation_t *reservation);
     
 #ifdef __cplusplus
 }
@@ -153,4 +153,155 @@ TEST_PACK(EncoderTest__Enum, enum_, enum, ENCODER_TEST__ENUM__Value2, 14, PLPROT
     STAssertTrue(strcmp(et->string, str) == 0, @"Did not encode correct value");
 }
 
+/**
+ * Verify that strings are truncated at the first ill-formed UTF-8 sequence, and that the sizing pass agrees.
+ */
+- (void) testPackInvalidString {
+    const char *str = "caf\xC3\xA9\xFF tail";
+    size_t expected = plcrash_writer_pack(NULL, 16, PLPROTOBUF_C_TYPE_STRING, str);
+    STAssertEquals(expected, plcrash_writer_pack(&_file, 16, PLPROTOBUF_C_TYPE_STRING, str), @"Sizing pass disagrees with written size");
+    STAssertTrue(plcrash_async_file_flush(&_file), @"Failed to flush file");
+
+    NSData *data = [NSData dataWithContentsOfFile: _filePath];
+    STAssertNotNil(data, @"Failed to load encoded data");
+    if (data == nil)
+        return;
+
+    EncoderTest *et = encoder_test__unpack(NULL, [data length], [data bytes]);
+    STAssertNotNULL(et, @"Failed to decode test data");
+    if (et == NULL)
+        return;
+
+    STAssertNotNULL(et->string, @"Did not encode correct type");
+    STAssertTrue(strcmp(et->string, "caf\xC3\xA9") == 0, @"Did not truncate at the invalid sequence");
+}
+
+/**
+ * Verify that a reserved length prefix is back-patched with the field's actual length.
+ */
+- (void) testPackReserve {
+    uint8_t buffer[64];
+    uint8_t bytes[] = { 0xC, 0xA, 0xF, 0xE };
+    plcrash_async_file_t file;
+    plcrash_writer_reservation_t reservation;
+
+    /* Descriptor-backed output can not be patched */
+    STAssertFalse(plcrash_writer_pack_reserve(&_file, 15, &reservation), @"Reservation unexpectedly supported");
+    STAssertFalse(plcrash_writer_pack_reserve(NULL, 15, &reservation), @"Reservation unexpectedly supported");
+
+    /* Write the field contents following a reserved prefix */
+    plcrash_async_file_init_buffer(&file, buffer, sizeof(buffer));
+    STAssertTrue(plcrash_writer_pack_reserve(&file, 15, &reservation), @"Reservation failed");
+    STAssertTrue(plcrash_async_file_write(&file, bytes, sizeof(bytes)), @"Write failed");
+
+    size_t written = plcrash_writer_pack_commit(&file, &reservation);
+    STAssertEquals((off_t) written, file.total_bytes, @"Incorrect field size");
+    STAssertEquals(written, (size_t) 1 + PLCRASH_WRITER_RESERVED_LENGTH_SIZE + sizeof(bytes), @"Incorrect field size");
+
+    EncoderTest *et = encoder_test__unpack(NULL, (size_t) file.total_bytes, buffer);
+    STAssertNotNULL(et, @"Failed to decode test data");
+    if (et == NULL)
+        return;
+
+    STAssertTrue(et->has_bytes, @"Did not encode correct type");
+    STAssertEquals(et->bytes.len, sizeof(bytes), @"Encoded incorrect size");
+    STAssertTrue((memcmp(et->bytes.data, bytes, sizeof(bytes)) == 0), @"Did not encode correct value");
+}
+
+/**
+ * Verify that length prefixes are not reserved within a message whose length was written via plcrash_writer_pack().
+ */
+- (void) testPackReserveWithinPresizedMessage {
+    uint8_t buffer[64];
+    uint8_t bytes[] = { 0xC, 0xA, 0xF, 0xE };
+    plcrash_async_file_t file;
+    plcrash_writer_reservation_t reservation;
+    uint32_t size = 4;
+
+    plcrash_async_file_init_buffer(&file, buffer, sizeof(buffer));
+    plcrash_writer_pack(&file, 15, PLPROTOBUF_C_TYPE_MESSAGE, &size);
+    STAssertFalse(plcrash_writer_pack_reserve(&file, 15, &reservation), @"Reservation within a pre-sized message");
+
+    /* Reservations are permitted once the pre-sized message has been written */
+    STAssertTrue(plcrash_async_file_write(&file, bytes, sizeof(bytes)), @"Write failed");
+    STAssertTrue(plcrash_writer_pack_reserve(&file, 15, &reservation), @"Reservation failed");
+}
+
+/**
+ * Verify that packed repeated fields are sized and written correctly.
+ */
+- (void) testPackPacked {
+    uint64_t values[] = { 0, 1, 0x80, UINT32_MAX, UINT64_MAX };
+    size_t count = sizeof(values) / sizeof(values[0]);
+
+    size_t expected = plcrash_writer_pack_packed(NULL, 17, PLPROTOBUF_C_TYPE_UINT64, values, count);
+    STAssertEquals((size_t) 0, plcrash_writer_pack_packed(&_file, 17, PLPROTOBUF_C_TYPE_UINT64, values, 0), @"Empty field was written");
+    STAssertEquals(expected, plcrash_writer_pack_packed(&_file, 17, PLPROTOBUF_C_TYPE_UINT64, values, count), @"Incorrect field size");
+    STAssertTrue(plcrash_async_file_flush(&_file), @"Failed to flush file");
+
+    NSData *data = [NSData dataWithContentsOfFile: _filePath];
+    STAssertNotNil(data, @"Failed to load encoded data");
+    if (data == nil)
+        return;
+
+    STAssertEquals(expected, (size_t) [data length], @"Incorrect encoded size");
+
+    EncoderTest *et = encoder_test__unpack(NULL, [data length], [data bytes]);
+    STAssertNotNULL(et, @"Failed to decode test data");
+    if (et == NULL)
+        return;
+
+    STAssertEquals(et->n_packed_uint64, count, @"Incorrect value count");
+    for (size_t i = 0; i < count && i < et->n_packed_uint64; i++)
+        STAssertEquals(et->packed_uint64[i], values[i], @"Incorrect value at %zu", i);
+}
+
+/* Integer vectors shared by the sizing and benchmark tests; these mirror the TEST_PACK_INT() vectors above. */
+static const struct {
+    PLProtobufCType type;
+    uint64_t value;
+} encoding_vectors[] = {
+    { PLPROTOBUF_C_TYPE_INT32,   (uint64_t) (int64_t) INT32_MIN },
+    { PLPROTOBUF_C_TYPE_INT32,   INT32_MAX },
+    { PLPROTOBUF_C_TYPE_UINT32,  0 },
+    { PLPROTOBUF_C_TYPE_UINT32,  UINT32_MAX },
+    { PLPROTOBUF_C_TYPE_SINT32,  (uint64_t) (int64_t) INT32_MIN },
+    { PLPROTOBUF_C_TYPE_SINT32,  INT32_MAX },
+    { PLPROTOBUF_C_TYPE_FIXED32, UINT32_MAX },
+    { PLPROTOBUF_C_TYPE_INT64,   (uint64_t) INT64_MIN },
+    { PLPROTOBUF_C_TYPE_INT64,   INT64_MAX },
+    { PLPROTOBUF_C_TYPE_UINT64,  0 },
+    { PLPROTOBUF_C_TYPE_UINT64,  UINT64_MAX },
+    { PLPROTOBUF_C_TYPE_SINT64,  (uint64_t) INT64_MIN },
+    { PLPROTOBUF_C_TYPE_SINT64,  INT64_MAX },
+    { PLPROTOBUF_C_TYPE_FIXED64, UINT64_MAX },
+    { PLPROTOBUF_C_TYPE_ENUM,    ENCODER_TEST__ENUM__Value2 },
+};
+
+/**
+ * Verify that the store-free sizing pass (file == NULL) agrees with the number of bytes actually written.
+ */
+- (void) testPackedSize {
+    uint8_t buffer[64];
+
+    for (size_t i = 0; i < sizeof(encoding_vectors) / sizeof(encoding_vectors[0]); i++) {
+        for (uint32_t tag = 1; tag < UINT32_MAX / 2; tag = (tag << 4) | 1) {
+            /* 32-bit types are read from the low word of the value; this assumes a little-endian host. */
+            uint64_t value = encoding_vectors[i].value;
+            plcrash_async_file_t file;
+            plcrash_async_file_init_buffer(&file, buffer, sizeof(buffer));
+
+            size_t expected = plcrash_writer_pack(NULL, tag, encoding_vectors[i].type, &value);
+            size_t written = plcrash_writer_pack(&file, tag, encoding_vectors[i].type, &value);
+            STAssertTrue(plcrash_async_file_flush(&file), @"Failed to flush buffer");
+
+            STAssertEquals(expected, written, @"Sizing pass disagrees with encoded size for vector %zu, tag %u", i, tag);
+            STAssertEquals((off_t) written, file.total_bytes, @"Returned size disagrees with bytes written for vector %zu", i);
+        }
+    }
+
+    const char *str = "cafe";
+    STAssertEquals(plcrash_writer_pack(NULL, 16, PLPROTOBUF_C_TYPE_STRING, str), (size_t) 6, @"Incorrect string size");
+}
+
 @end
@@ -32,6 +32,8 @@
 #import "PLCrashFrameWalker.h"
 #import "PLCrashAsyncImageList.h"
 #import "PLCrashReport.h"
+#import "PLCrashCustomData.h"
+#import "PLCrashReportStream.h"
 
 #import "PLCrashProcessInfo.h"
 #import "PLCrashHostInfo.h"
@@ -199,15 +201,21 @@
     STAssertNotNULL(threads, @"No thread messages were written");
     STAssertTrue(crashReport->n_threads > 0, @"0 thread messages were written");
 
+    /* The crashed thread is written first */
+    STAssertTrue(threads[0]->crashed, @"The crashed thread was not written first");
+
     uint32_t lastThreadNumber;
     for (int i = 0; i < crashReport->n_threads; i++) {
         Plcrash__CrashReport__Thread *thread = threads[i];
 
-        /* Check that the threads are provided in order */
-        if (i > 0) {
+        /* Check that the remaining threads are provided in order */
+        if (i > 1) {
             STAssertTrue(lastThreadNumber < thread->thread_number, @"Threads were encoded out of order (%d vs %d)", i, thread->thread_number);
         }
-        lastThreadNumber = thread->thread_number;
+        if (i > 0) {
+            STAssertNotEquals(threads[0]->thread_number, thread->thread_number, @"Duplicate thread number %d", thread->thread_number);
+            lastThreadNumber = thread->thread_number;
+        }
         
         /* Check that there is at least one frame */
         STAssertNotEquals((size_t)0, thread->n_frames, @"No frames available in backtrace");
@@ -282,7 +290,7 @@
     STAssertTrue([data length] > sizeof(struct PLCrashReportFileHeader), @"File is too small for magic + version + data");
     // verifies correct byte ordering of the file magic
     STAssertTrue(memcmp(header->magic, PLCRASH_REPORT_FILE_MAGIC, strlen(PLCRASH_REPORT_FILE_MAGIC)) == 0, @"File header is not 'plcrash', is: '%s'", (const char *) &header->magic);
-    STAssertEquals(header->version, (uint8_t) PLCRASH_REPORT_FILE_VERSION, @"File version is not equal to 0");
+    STAssertTrue(header->version == PLCRASH_REPORT_FILE_VERSION || header->version == PLCRASH_REPORT_FILE_VERSION_SYMBOL_NAMES, @"Unexpected file version %u", header->version);
     
     /* Try to read the crash report */
     Plcrash__CrashReport *crashReport;
@@ -303,6 +311,28 @@
     STAssertTrue(version && version[0], @"Device version not saved");
 }
 
+/**
+ * Verify that writers initialized before and after a host snapshot refresh record the same host metadata, and that
+ * each writer owns its copy.
+ */
+- (void) testHostSnapshotRefresh {
+    plcrash_log_writer_t first;
+    plcrash_log_writer_t second;
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&first, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, false), @"Initialization failed");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_nasync_refresh_host_snapshot(), @"Refresh failed");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&second, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, false), @"Initialization failed");
+
+    STAssertTrue(first.system_info.version != second.system_info.version, @"Writers share the version string");
+    STAssertTrue(strcmp(first.system_info.version, second.system_info.version) == 0, @"Incorrect version");
+    STAssertEquals(first.machine_info.cpu_type, second.machine_info.cpu_type, @"Incorrect CPU type");
+    STAssertEquals(first.process_info.process_id, second.process_info.process_id, @"Incorrect process ID");
+    STAssertEquals(getpid(), second.process_info.process_id, @"Incorrect process ID");
+
+    plcrash_log_writer_free(&first);
+    plcrash_log_writer_free(&second);
+}
+
 - (void) testWriteLogWithNilReason {
     plcrash_log_writer_t writer;
 
@@ -326,8 +356,9 @@
     plcrash_async_thread_state_t thread_state;
     thread_t thread;
 
-    /* Initialize the image list */
+    /* Initialize the image list, using pre-encoded image records */
     plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    plcrash_nasync_image_list_set_encoder(&image_list, plcrash_log_writer_nasync_encode_binary_image);
     for (uint32_t i = 0; i < _dyld_image_count(); i++)
         plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
 
@@ -372,6 +403,7 @@
         e = exception;
     }
     plcrash_log_writer_set_exception(&writer, e);
+    plcrash_log_writer_set_symbolication_diagnostics(&writer, true);
 
     /* Write the crash report */
     STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
@@ -408,6 +440,7 @@
     [self checkAppInfo: crashReport];
     [self checkProcessInfo: crashReport];
     [self checkThreads: crashReport];
+    [self checkBinaryImages: crashReport];
     [self checkException: crashReport];
     
     /* Check the signal info */
@@ -423,6 +456,15 @@
     STAssertEquals((uint64_t) 0x42, crashReport->signal->mach_exception->codes[1], @"code[1] incorrect");
 
 
+    /* Symbolication diagnostics */
+    Plcrash__CrashReport__SymbolicationDiagnostics *diagnostics = crashReport->symbolication_diagnostics;
+    STAssertNotNULL(diagnostics, @"Missing symbolication diagnostics");
+    STAssertTrue(diagnostics->lookups > 0, @"No symbol look-ups were recorded");
+    STAssertTrue(diagnostics->cache_hits <= diagnostics->lookups, @"More cache hits than look-ups");
+    STAssertTrue(diagnostics->symbol_table_lookups <= diagnostics->lookups - diagnostics->cache_hits, @"Cache hits were counted as symbol table look-ups");
+    STAssertTrue(diagnostics->symbol_table_lookups > 0, @"No symbol table look-ups were recorded");
+    STAssertTrue(diagnostics->symbols_scanned > 0, @"No scanned symbols were recorded");
+
     /* Validate the 'crashed' flag is on a thread with the expected PC. */
     uint64_t expectedPC;
 #if __x86_64__
@@ -464,4 +506,1556 @@
     protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
 }
 
+/*
+ * Write a report for the test thread to a memory-mapped (and thus patchable) output file, as used by the crash handler.
+ * The report includes the writer's pre-encoded static sections.
+ */
+- (Plcrash__CrashReport *) writePatchableReportWithException: (NSException *) exception {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGSEGV, .code = SEGV_MAPERR, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_file_nasync_init_mmap(&file, fd, 4 * 1024 * 1024), @"Failed to map the output file");
+    STAssertTrue(plcrash_async_file_is_patchable(&file), @"Mapped output should be patchable");
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, false), @"Initialization failed");
+    if (exception != nil)
+        plcrash_log_writer_set_exception(&writer, exception);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    return [self loadReport];
+}
+
+/* Verify that a report written to a patchable file, including the pre-encoded static sections, can be decoded */
+- (void) testWriteReportToPatchableFile {
+    Plcrash__CrashReport *crashReport = [self writePatchableReportWithException: nil];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    /* The static sections include the machine info, whose processor record may not use a reserved length prefix */
+    STAssertNotNULL(crashReport->machine_info, @"No machine info available");
+    STAssertNotNULL(crashReport->machine_info->processor, @"No processor info available");
+    [self checkSystemInfo: crashReport];
+    [self checkAppInfo: crashReport];
+    [self checkProcessInfo: crashReport];
+    [self checkThreads: crashReport];
+    [self checkBinaryImages: crashReport];
+
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+}
+
+/* Verify that an uncaught exception with a symbolicated backtrace round-trips through a patchable output file */
+- (void) testWriteSymbolicatedExceptionToPatchableFile {
+    NSException *e = nil;
+    @try {
+        [NSException raise: @"TestException" format: @"TestReason"];
+    }
+    @catch (NSException *exception) {
+        e = exception;
+    }
+
+    Plcrash__CrashReport *crashReport = [self writePatchableReportWithException: e];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    [self checkException: crashReport];
+
+    /* The exception frames (and their nested symbol records) must be framed correctly */
+    size_t symbolicated = 0;
+    for (size_t i = 0; i < crashReport->exception->n_frames; i++) {
+        Plcrash__CrashReport__Symbol *symbol = crashReport->exception->frames[i]->symbol;
+        if (symbol != NULL && symbol->start_address != 0)
+            symbolicated++;
+    }
+    STAssertTrue(symbolicated > 0, @"No exception frames were symbolicated");
+
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+}
+
+/* Verify that symbol names are written once to the report-level table, and are resolved by PLCrashReport */
+- (void) testWriteReportWithSymbolNames {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGSEGV, .code = SEGV_MAPERR, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Write the report */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, false), @"Initialization failed");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_enable_symbol_names(&writer), @"Failed to enable symbol names");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    /* Reports referring to the table must be rejected by readers that predate it */
+    NSData *data = [NSData dataWithContentsOfFile: _logPath];
+    const struct PLCrashReportFileHeader *header = [data bytes];
+    STAssertEquals(header->version, (uint8_t) PLCRASH_REPORT_FILE_VERSION_SYMBOL_NAMES, @"Incorrect file version");
+
+    /* Each thread's names must be written ahead of the thread, ensuring that a truncated report can be resolved */
+    plcrash_report_stream_t stream;
+    plcrash_report_stream_field_t field;
+    size_t namesWritten = 0;
+    size_t threadCount = 0;
+    plcrash_report_stream_init(&stream, header->data, [data length] - sizeof(*header));
+    while (plcrash_report_stream_next(&stream, &field) == PLCRASH_ESUCCESS) {
+        if (field.number == 10) {
+            namesWritten++;
+        } else if (field.number == 3) {
+            Plcrash__CrashReport__Thread *reportThread = plcrash__crash_report__thread__unpack(NULL, field.length, field.data);
+            STAssertNotNULL(reportThread, @"Failed to unpack thread");
+            if (reportThread == NULL)
+                continue;
+
+            for (size_t j = 0; j < reportThread->n_frames; j++) {
+                Plcrash__CrashReport__Symbol *symbol = reportThread->frames[j]->symbol;
+                if (symbol != NULL && symbol->has_name_index)
+                    STAssertTrue(symbol->name_index < namesWritten, @"Symbol name was not written ahead of its thread");
+            }
+
+            threadCount++;
+            protobuf_c_message_free_unpacked((ProtobufCMessage *) reportThread, NULL);
+        }
+    }
+    STAssertTrue(threadCount > 0, @"No threads were written");
+
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    /* Each name must be included only once */
+    STAssertTrue(crashReport->n_symbol_names > 0, @"No symbol names were written");
+    for (size_t i = 0; i < crashReport->n_symbol_names; i++) {
+        for (size_t j = i + 1; j < crashReport->n_symbol_names; j++)
+            STAssertTrue(strcmp(crashReport->symbol_names[i], crashReport->symbol_names[j]) != 0, @"Duplicate symbol name %s", crashReport->symbol_names[i]);
+    }
+
+    /* Frame symbols must refer to the table */
+    for (size_t i = 0; i < crashReport->n_threads; i++) {
+        Plcrash__CrashReport__Thread *reportThread = crashReport->threads[i];
+        for (size_t j = 0; j < reportThread->n_frames; j++) {
+            Plcrash__CrashReport__Symbol *symbol = reportThread->frames[j]->symbol;
+            if (symbol == NULL)
+                continue;
+
+            STAssertNULL(symbol->name, @"Symbol name was written inline");
+            STAssertTrue(symbol->has_name_index, @"Symbol name index was not written");
+            STAssertTrue(symbol->name_index < crashReport->n_symbol_names, @"Symbol name index is out of range");
+        }
+    }
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+
+    /* The names must be resolved when decoded */
+    NSError *error = nil;
+    PLCrashReport *report = [[[PLCrashReport alloc] initWithData: [NSData dataWithContentsOfFile: _logPath] error: &error] autorelease];
+    STAssertNotNil(report, @"Failed to decode report: %@", error);
+    for (PLCrashReportThreadInfo *threadInfo in report.threads) {
+        for (PLCrashReportStackFrameInfo *frameInfo in threadInfo.stackFrames) {
+            if (frameInfo.symbolInfo != nil)
+                STAssertNotNil(frameInfo.symbolInfo.symbolName, @"Symbol name was not resolved");
+        }
+    }
+}
+
+/* Verify that threads written with the packed thread encoding are decoded by PLCrashReport */
+- (void) testWriteReportWithPackedThreads {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGSEGV, .code = SEGV_MAPERR, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Write the report */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, false), @"Initialization failed");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_enable_symbol_names(&writer), @"Failed to enable symbol names");
+    plcrash_log_writer_set_packed_threads(&writer, true);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    /* Threads must be written using the packed encoding, with a value for each frame and register */
+    size_t crashedRegisterCount = 0;
+    size_t relativeFrames = 0;
+    for (size_t i = 0; i < crashReport->n_threads; i++) {
+        Plcrash__CrashReport__Thread *reportThread = crashReport->threads[i];
+        STAssertEquals(reportThread->n_frames, (size_t) 0, @"Frame messages were written");
+        STAssertEquals(reportThread->n_registers, (size_t) 0, @"Register messages were written");
+        STAssertTrue(reportThread->n_frame_pcs > 0, @"No frames were written");
+        STAssertEquals(reportThread->n_frame_symbol_names, reportThread->n_frame_pcs, @"Incorrect symbol name count");
+        STAssertEquals(reportThread->n_frame_symbol_offsets, reportThread->n_frame_pcs, @"Incorrect symbol offset count");
+        STAssertEquals(reportThread->n_register_names, reportThread->n_register_values, @"Incorrect register name count");
+
+        for (size_t j = 0; j < reportThread->n_frame_symbol_names; j++)
+            STAssertTrue(reportThread->frame_symbol_names[j] <= crashReport->n_symbol_names, @"Symbol name index is out of range");
+
+        /* Frames within written images must be encoded relative to the image */
+        STAssertEquals(reportThread->n_frame_images, reportThread->n_frame_pcs, @"Incorrect frame image count");
+        for (size_t j = 0; j < reportThread->n_frame_images; j++) {
+            uint32_t image_ref = reportThread->frame_images[j];
+            if (image_ref == 0)
+                continue;
+
+            relativeFrames++;
+            STAssertTrue(image_ref <= crashReport->n_binary_images, @"Image index is out of range");
+            if (image_ref <= crashReport->n_binary_images)
+                STAssertTrue(reportThread->frame_pcs[j] < crashReport->binary_images[image_ref - 1]->size, @"Frame offset is outside its image");
+        }
+
+        if (reportThread->crashed)
+            crashedRegisterCount = reportThread->n_register_values;
+    }
+    STAssertTrue(crashedRegisterCount > 0, @"No registers were written for the crashed thread");
+    STAssertTrue(relativeFrames > 0, @"No frames were written relative to their image");
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+
+    /* The frames and registers must be restored when decoded */
+    NSError *error = nil;
+    PLCrashReport *report = [[[PLCrashReport alloc] initWithData: [NSData dataWithContentsOfFile: _logPath] error: &error] autorelease];
+    STAssertNotNil(report, @"Failed to decode report: %@", error);
+    STAssertNotNil(report.crashedThread, @"No crashed thread");
+    STAssertEquals([report.crashedThread.registers count], crashedRegisterCount, @"Incorrect register count");
+
+    BOOL symbolicated = NO;
+    for (PLCrashReportThreadInfo *threadInfo in report.threads) {
+        STAssertTrue([threadInfo.stackFrames count] > 0, @"No frames were decoded");
+        for (PLCrashReportStackFrameInfo *frameInfo in threadInfo.stackFrames) {
+            if (frameInfo.symbolInfo == nil)
+                continue;
+
+            symbolicated = YES;
+            STAssertNotNil(frameInfo.symbolInfo.symbolName, @"Symbol name was not resolved");
+            STAssertNotNil([report imageForAddress: frameInfo.instructionPointer], @"Frame address was not restored");
+            STAssertTrue(frameInfo.symbolInfo.startAddress <= frameInfo.instructionPointer, @"Incorrect symbol start address");
+        }
+    }
+    STAssertTrue(symbolicated, @"No frames were symbolicated");
+}
+
+- (void) testWriteReportWithReferencedImagesOnly {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGSEGV, .code = SEGV_MAPERR, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Write the report */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_NONE, false), @"Initialization failed");
+    plcrash_log_writer_set_referenced_images_only(&writer, true);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    /* Every image is either written, or accounted for in the summary */
+    STAssertTrue(crashReport->has_omitted_image_count, @"Omitted image count was not written");
+    STAssertTrue(crashReport->has_omitted_image_hash, @"Omitted image hash was not written");
+    STAssertTrue(crashReport->n_binary_images > 0, @"No referenced images were written");
+    STAssertTrue(crashReport->omitted_image_count > 0, @"No images were omitted");
+    STAssertEquals((uint32_t) _dyld_image_count(), (uint32_t) (crashReport->n_binary_images + crashReport->omitted_image_count), @"Image count mismatch");
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+
+    /* The summary must be available when decoded */
+    NSError *error = nil;
+    PLCrashReport *report = [[[PLCrashReport alloc] initWithData: [NSData dataWithContentsOfFile: _logPath] error: &error] autorelease];
+    STAssertNotNil(report, @"Failed to decode report: %@", error);
+    STAssertEquals([report.images count] + report.omittedImageCount, (NSUInteger) _dyld_image_count(), @"Image count mismatch");
+    STAssertTrue(report.omittedImageHash != 0, @"Omitted image hash was not decoded");
+}
+
+/**
+ * Test writing and reading a report summary.
+ */
+- (void) testWriteReportSummary {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+    NSString *summaryPath = [_logPath stringByAppendingPathExtension: @"summary"];
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGSEGV, .code = SEGV_MAPERR, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Write the report */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_NONE, false), @"Initialization failed");
+    plcrash_log_writer_set_exception(&writer, [NSException exceptionWithName: @"TestException" reason: @"Testing" userInfo: nil]);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    uint64_t reportSize = [[[NSFileManager defaultManager] attributesOfItemAtPath: _logPath error: NULL] fileSize];
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write_summary(&writer, [summaryPath UTF8String], reportSize), @"Summary write failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    /* Read it back */
+    NSError *error = nil;
+    PLCrashReportSummary *summary = [[[PLCrashReportSummary alloc] initWithData: [NSData dataWithContentsOfFile: summaryPath] error: &error] autorelease];
+    [[NSFileManager defaultManager] removeItemAtPath: summaryPath error: NULL];
+
+    STAssertNotNil(summary, @"Failed to read summary: %@", error);
+    STAssertEquals(summary.signalNumber, SIGSEGV, @"Incorrect signal number");
+    STAssertEquals(summary.signalCode, SEGV_MAPERR, @"Incorrect signal code");
+    STAssertEquals(summary.reportSize, reportSize, @"Incorrect report size");
+    STAssertNotNil(summary.timestamp, @"No timestamp");
+    STAssertTrue(summary.exceptionNameHash != 0, @"No exception name hash");
+    STAssertTrue(summary.crashedThreadSignature != 0, @"No crashed thread signature");
+
+    STAssertEquals(summary.occurrenceCount, (NSUInteger) 1, @"Incorrect occurrence count");
+    STAssertEqualObjects(summary.lastOccurrenceTimestamp, summary.timestamp, @"Incorrect last occurrence timestamp");
+
+    /* A truncated summary must be rejected */
+    STAssertNil([[[PLCrashReportSummary alloc] initWithData: [NSData dataWithBytes: "plcs" length: 4] error: NULL] autorelease], @"Accepted a truncated summary");
+}
+
+/**
+ * Test collapsing a repeated crash into the pending report's summary.
+ */
+- (void) testCollapseRepeatedCrash {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+    NSString *summaryPath = [_logPath stringByAppendingPathExtension: @"summary"];
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGSEGV, .code = SEGV_MAPERR, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_NONE, false), @"Initialization failed");
+
+    /* Without a pending summary, nothing can be collapsed */
+    STAssertEquals(PLCRASH_ENOTFOUND, plcrash_log_writer_collapse_repeat(&writer, thread, &image_list, [summaryPath UTF8String], &info, &thread_state), @"Collapsed a crash without a pending summary");
+
+    /* Write the pending report and its summary */
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write_summary(&writer, [summaryPath UTF8String], 1), @"Summary write failed");
+
+    /* The same crash is collapsed; a differing signal is not */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_collapse_repeat(&writer, thread, &image_list, [summaryPath UTF8String], &info, &thread_state), @"Repeated crash was not collapsed");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_collapse_repeat(&writer, thread, &image_list, [summaryPath UTF8String], &info, &thread_state), @"Repeated crash was not collapsed");
+
+    bsd_info.code = SEGV_ACCERR;
+    STAssertEquals(PLCRASH_ENOTFOUND, plcrash_log_writer_collapse_repeat(&writer, thread, &image_list, [summaryPath UTF8String], &info, &thread_state), @"Collapsed a differing crash");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    NSError *error = nil;
+    PLCrashReportSummary *summary = [[[PLCrashReportSummary alloc] initWithData: [NSData dataWithContentsOfFile: summaryPath] error: &error] autorelease];
+    [[NSFileManager defaultManager] removeItemAtPath: summaryPath error: NULL];
+
+    STAssertNotNil(summary, @"Failed to read summary: %@", error);
+    STAssertEquals(summary.occurrenceCount, (NSUInteger) 3, @"Incorrect occurrence count");
+    STAssertEquals(summary.reportSize, (uint64_t) 1, @"The report summary was modified");
+    STAssertNotNil(summary.lastOccurrenceTimestamp, @"No last occurrence timestamp");
+}
+
+/**
+ * Verify that crashes at equal offsets within differing images are not collapsed as repeats of one another.
+ */
+- (void) testCollapseDistinguishesImages {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pl_mach_thread_self();
+    NSString *summaryPath = [_logPath stringByAppendingPathExtension: @"summary"];
+
+    STAssertTrue(_dyld_image_count() >= 2, @"At least two images are required");
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGSEGV, .code = SEGV_MAPERR, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+
+    /* Crash within the first image's header; with no frame pointer, only the initial frame is walked */
+    pl_vm_address_t offset = 0x10;
+    plcrash_async_thread_state_mach_thread_init(&thread_state, pthread_mach_thread_np(_thr_args.thread));
+    plcrash_async_thread_state_set_reg(&thread_state, PLCRASH_REG_IP, (pl_vm_address_t) _dyld_get_image_header(0) + offset);
+    plcrash_async_thread_state_set_reg(&thread_state, PLCRASH_REG_FP, 0);
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_NONE, false), @"Initialization failed");
+
+    /* Write the pending report and its summary */
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write_summary(&writer, [summaryPath UTF8String], 1), @"Summary write failed");
+
+    /* The same offset within the same image is collapsed */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_collapse_repeat(&writer, thread, &image_list, [summaryPath UTF8String], &info, &thread_state), @"Repeated crash was not collapsed");
+
+    /* The same offset within a differing image is not */
+    plcrash_async_thread_state_set_reg(&thread_state, PLCRASH_REG_IP, (pl_vm_address_t) _dyld_get_image_header(1) + offset);
+    STAssertEquals(PLCRASH_ENOTFOUND, plcrash_log_writer_collapse_repeat(&writer, thread, &image_list, [summaryPath UTF8String], &info, &thread_state), @"Collapsed a crash in a differing image");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    NSError *error = nil;
+    PLCrashReportSummary *summary = [[[PLCrashReportSummary alloc] initWithData: [NSData dataWithContentsOfFile: summaryPath] error: &error] autorelease];
+    [[NSFileManager defaultManager] removeItemAtPath: summaryPath error: NULL];
+
+    STAssertNotNil(summary, @"Failed to read summary: %@", error);
+    STAssertEquals(summary.occurrenceCount, (NSUInteger) 2, @"Incorrect occurrence count");
+}
+
+/**
+ * Test writing a report from thread snapshots, resuming the threads prior to symbolication.
+ */
+- (void) testWriteReportWithThreadSnapshots {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGSEGV, .code = SEGV_MAPERR, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Write the report */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_NONE, false), @"Initialization failed");
+    plcrash_log_writer_set_snapshot_threads(&writer, true);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    /* The snapshotted threads must be written, including the crashed thread's registers */
+    STAssertTrue(crashReport->n_threads > 0, @"No threads were written");
+
+    bool found_crashed = false;
+    for (size_t i = 0; i < crashReport->n_threads; i++) {
+        Plcrash__CrashReport__Thread *thr = crashReport->threads[i];
+        STAssertTrue(thr->n_frames > 0, @"No frames were written");
+        if (thr->crashed) {
+            found_crashed = true;
+            STAssertTrue(thr->n_registers > 0, @"No registers were written for the crashed thread");
+        }
+    }
+    STAssertTrue(found_crashed, @"The crashed thread was not written");
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+
+    /* The target thread must have been resumed */
+    struct thread_basic_info info_data;
+    mach_msg_type_number_t info_count = THREAD_BASIC_INFO_COUNT;
+    STAssertEquals(KERN_SUCCESS, thread_info(thread, THREAD_BASIC_INFO, (thread_info_t) &info_data, &info_count), @"Failed to fetch thread info");
+    STAssertEquals(info_data.suspend_count, (integer_t) 0, @"Thread was left suspended");
+}
+
+/**
+ * Snapshot reports are symbolicated after the threads have been resumed, when the image names supplied at
+ * registration may have been freed; the written image records must not depend on the caller's name storage.
+ */
+- (void) testWriteReportWithThreadSnapshotsOwnsImageNames {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    /* Register the images with transient name storage, clobbered once registered */
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++) {
+        char *name = strdup(_dyld_get_image_name(i));
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), name);
+        memset(name, 'X', strlen(name));
+        free(name);
+    }
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGSEGV, .code = SEGV_MAPERR, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, true), @"Initialization failed");
+    plcrash_log_writer_set_snapshot_threads(&writer, true);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    [self checkBinaryImages: crashReport];
+    for (size_t i = 0; i < crashReport->n_binary_images; i++) {
+        Plcrash__CrashReport__BinaryImage *image = crashReport->binary_images[i];
+        Dl_info dlinfo;
+        if (dladdr((void *) (uintptr_t) image->base_address, &dlinfo) == 0)
+            continue;
+        STAssertTrue(strcmp(image->name, dlinfo.dli_fname) == 0, @"Incorrect image name: %s", image->name);
+    }
+
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+}
+
+/**
+ * Test writing a report with thread stacks walked in parallel.
+ */
+- (void) testWriteReportWithParallelUnwind {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGSEGV, .code = SEGV_MAPERR, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Write the report */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_NONE, false), @"Initialization failed");
+    plcrash_log_writer_nasync_set_unwind_workers(&writer, 4);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    /* The walked threads must be written, including the crashed thread's registers */
+    STAssertTrue(crashReport->n_threads > 0, @"No threads were written");
+
+    bool found_crashed = false;
+    for (size_t i = 0; i < crashReport->n_threads; i++) {
+        Plcrash__CrashReport__Thread *thr = crashReport->threads[i];
+        STAssertTrue(thr->n_frames > 0, @"No frames were written");
+        if (thr->crashed) {
+            found_crashed = true;
+            STAssertTrue(thr->n_registers > 0, @"No registers were written for the crashed thread");
+        }
+    }
+    STAssertTrue(found_crashed, @"The crashed thread was not written");
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+}
+
+
+/**
+ * Test writing multiple reports with a single writer and a persistent symbol cache.
+ */
+- (void) testWriteReportWithPersistentSymbolCache {
+    plcrash_log_writer_t writer;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+    uint8_t uuids[2][16];
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGSEGV, .code = SEGV_MAPERR, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, true), @"Initialization failed");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_enable_persistent_symbol_cache(&writer), @"Failed to enable the symbol cache");
+
+    for (int i = 0; i < 2; i++) {
+        plcrash_async_file_t file;
+
+        STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_reset(&writer), @"Reset failed");
+
+        int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_TRUNC, 0644);
+        plcrash_async_file_init(&file, fd, 0);
+        STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+        plcrash_log_writer_close(&writer);
+        plcrash_async_file_flush(&file);
+        plcrash_async_file_close(&file);
+
+        /* The symbol cache must be retained after the first report */
+        STAssertTrue(writer.symbol_cache_valid, @"The persistent symbol cache was not initialized");
+
+        Plcrash__CrashReport *crashReport = [self loadReport];
+        STAssertNotNULL(crashReport, @"Failed to load report %d", i);
+        if (crashReport == NULL)
+            break;
+
+        STAssertTrue(crashReport->n_threads > 0, @"No threads were written");
+        STAssertEquals((size_t)16, crashReport->report_info->uuid.len, @"UUID is not expected 16 bytes");
+        memcpy(uuids[i], crashReport->report_info->uuid.data, sizeof(uuids[i]));
+        protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+    }
+
+    /* Each report must be assigned a unique UUID */
+    STAssertTrue(memcmp(uuids[0], uuids[1], sizeof(uuids[0])) != 0, @"Reports share a UUID");
+
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+}
+
+
+/**
+ * Test writing aggregated stack samples.
+ */
+- (void) testWriteReportWithStackSamples {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    plcrash_stack_sampler_t sampler;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    /* Sample the test thread directly */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_stack_sampler_init(&sampler, mach_task_self(), &image_list, &thread, 1, 16, NSEC_PER_MSEC), @"Sampler initialization failed");
+    for (int i = 0; i < 4; i++)
+        STAssertEquals(PLCRASH_ESUCCESS, plcrash_stack_sampler_sample(&sampler), @"Sampling failed");
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGTRAP, .code = TRAP_TRACE, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Write the report */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_NONE, true), @"Initialization failed");
+    plcrash_log_writer_set_stack_sampler(&writer, &sampler);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_stack_sampler_free(&sampler);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    /* Every sample must be accounted for by the aggregated stacks */
+    STAssertNotNULL(crashReport->stack_samples, @"No stack samples were written");
+    if (crashReport->stack_samples != NULL) {
+        Plcrash__CrashReport__StackSamples *samples = crashReport->stack_samples;
+        STAssertEquals(samples->interval, (uint64_t) NSEC_PER_MSEC, @"Incorrect interval");
+        STAssertEquals(samples->sample_count, (uint32_t) 4, @"Incorrect sample count");
+        STAssertEquals(samples->evicted_count, (uint32_t) 0, @"Unexpected evicted samples");
+        STAssertTrue(samples->n_stacks > 0, @"No stacks were written");
+
+        uint32_t total = 0;
+        for (size_t i = 0; i < samples->n_stacks; i++) {
+            STAssertTrue(samples->stacks[i]->n_pcs > 0, @"No PCs were written");
+            total += samples->stacks[i]->count;
+        }
+        STAssertEquals(total, samples->sample_count, @"Sample counts do not sum to the total sample count");
+    }
+
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+}
+
+
+/**
+ * Test writing a raw capture report, and recovering the crashed thread's frames from its captured stack memory.
+ */
+- (void) testWriteReportWithRawCapture {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGTRAP, .code = TRAP_TRACE, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Write the report; referenced-only image output must be ignored in raw capture mode */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, true), @"Initialization failed");
+    plcrash_log_writer_set_raw_capture(&writer, true);
+    plcrash_log_writer_set_referenced_images_only(&writer, true);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    /* The crashed thread is written first, with its registers and stack memory, and without frames */
+    STAssertTrue(crashReport->n_threads > 0, @"No threads were written");
+    Plcrash__CrashReport__Thread *crashed = crashReport->threads[0];
+    STAssertTrue(crashed->crashed, @"The crashed thread was not written first");
+    STAssertEquals(crashed->n_frames, (size_t) 0, @"Frames were written in raw capture mode");
+    STAssertTrue(crashed->n_registers > 0, @"No registers were written");
+    STAssertTrue(crashed->has_stack_address, @"No stack address was written");
+    STAssertTrue(crashed->has_stack_memory, @"No stack memory was written");
+    STAssertTrue(crashed->stack_memory.len > 0 && crashed->stack_memory.len <= PLCRASH_LOG_WRITER_RAW_STACK_SIZE, @"Invalid stack memory length");
+    STAssertEquals((uint32_t) _dyld_image_count(), (uint32_t) crashReport->n_binary_images, @"Not all images were written");
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+
+    /* The crashed thread's frames must be recovered when decoded */
+    NSError *error = nil;
+    PLCrashReport *report = [[[PLCrashReport alloc] initWithData: [NSData dataWithContentsOfFile: _logPath] error: &error] autorelease];
+    STAssertNotNil(report, @"Failed to decode report: %@", error);
+
+    PLCrashReportThreadInfo *crashedInfo = nil;
+    for (PLCrashReportThreadInfo *threadInfo in report.threads) {
+        if (threadInfo.crashed)
+            crashedInfo = threadInfo;
+    }
+    STAssertNotNil(crashedInfo, @"No crashed thread was decoded");
+    STAssertTrue([crashedInfo.stackFrames count] > 1, @"The crashed thread's frames were not recovered");
+
+    PLCrashReportStackFrameInfo *frame = [crashedInfo.stackFrames objectAtIndex: 0];
+    STAssertEquals(frame.instructionPointer, (uint64_t) plcrash_async_thread_state_get_reg(&thread_state, PLCRASH_REG_IP), @"Incorrect initial frame PC");
+}
+
+/* Verify that stack memory is written alongside the walked frames of the crashed thread only */
+- (void) testWriteReportWithStackCapture {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGTRAP, .code = TRAP_TRACE, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Write the report */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, true), @"Initialization failed");
+    plcrash_log_writer_set_stack_capture(&writer, 4096, false);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    /* The crashed thread includes both its frames and its stack memory, starting at the stack pointer */
+    for (size_t i = 0; i < crashReport->n_threads; i++) {
+        Plcrash__CrashReport__Thread *reportThread = crashReport->threads[i];
+        if (!reportThread->crashed) {
+            STAssertFalse(reportThread->has_stack_memory, @"Stack memory was written for a non-crashed thread");
+            continue;
+        }
+
+        STAssertTrue(reportThread->n_frames > 0, @"No frames were written");
+        STAssertTrue(reportThread->has_stack_memory, @"No stack memory was written");
+        STAssertTrue(reportThread->stack_memory.len > 0 && reportThread->stack_memory.len <= 4096, @"Invalid stack memory length");
+        STAssertEquals(reportThread->stack_address, (uint64_t) plcrash_async_thread_state_get_reg(&thread_state, PLCRASH_REG_SP), @"Incorrect stack address");
+    }
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+
+    /* The walked frames must be preferred when decoded */
+    NSError *error = nil;
+    PLCrashReport *report = [[[PLCrashReport alloc] initWithData: [NSData dataWithContentsOfFile: _logPath] error: &error] autorelease];
+    STAssertNotNil(report, @"Failed to decode report: %@", error);
+    STAssertTrue([report.crashedThread.stackFrames count] > 0, @"No frames were decoded");
+}
+
+- (void) testWriteReportWithAllThreadRegisters {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGTRAP, .code = TRAP_TRACE, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Write the report */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, true), @"Initialization failed");
+    plcrash_log_writer_set_all_thread_registers(&writer, true);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    /* Every walked thread is written with its canonical register state, and without named registers */
+    size_t reg_count = plcrash_async_thread_state_get_reg_count(&thread_state);
+    for (size_t i = 0; i < crashReport->n_threads; i++) {
+        Plcrash__CrashReport__Thread *reportThread = crashReport->threads[i];
+        STAssertEquals((size_t) 0, reportThread->n_registers, @"Named registers were written");
+        if (reportThread->n_frames == 0)
+            continue;
+
+        STAssertEquals(reg_count, reportThread->n_register_state, @"Incorrect register count");
+        if (reportThread->crashed && reportThread->n_register_state == reg_count) {
+            STAssertEquals((uint64_t) plcrash_async_thread_state_get_reg(&thread_state, PLCRASH_REG_SP), reportThread->register_state[PLCRASH_REG_SP],
+                           @"Incorrect stack pointer value");
+        }
+    }
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+
+    /* The register names are restored when decoded */
+    NSError *error = nil;
+    PLCrashReport *report = [[[PLCrashReport alloc] initWithData: [NSData dataWithContentsOfFile: _logPath] error: &error] autorelease];
+    STAssertNotNil(report, @"Failed to decode report: %@", error);
+
+    NSString *spName = [NSString stringWithUTF8String: plcrash_async_thread_state_get_reg_name(&thread_state, PLCRASH_REG_SP)];
+    for (PLCrashReportThreadInfo *threadInfo in report.threads) {
+        if ([threadInfo.stackFrames count] == 0)
+            continue;
+
+        STAssertEquals((NSUInteger) reg_count, [threadInfo.registers count], @"Incorrect decoded register count");
+        STAssertEqualObjects(spName, [[threadInfo.registers objectAtIndex: PLCRASH_REG_SP] registerName], @"Incorrect register name");
+    }
+}
+
+- (void) testWriteReportWithThreadMetadata {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+    char oldName[64];
+
+    /* Name the current thread, restoring its name once the report has been written */
+    pthread_getname_np(pthread_self(), oldName, sizeof(oldName));
+    pthread_setname_np("plcrash.test.metadata");
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGTRAP, .code = TRAP_TRACE, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Write the report */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, true), @"Initialization failed");
+    plcrash_log_writer_set_thread_metadata(&writer, PLCRASH_LOG_WRITER_THREAD_METADATA_NAME|PLCRASH_LOG_WRITER_THREAD_METADATA_QOS|PLCRASH_LOG_WRITER_THREAD_METADATA_CPU_TIME);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    pthread_setname_np(oldName);
+
+    /* Every thread is written with its identifier and CPU times; the current thread is written with its name */
+    NSError *error = nil;
+    PLCrashReport *report = [[[PLCrashReport alloc] initWithData: [NSData dataWithContentsOfFile: _logPath] error: &error] autorelease];
+    STAssertNotNil(report, @"Failed to decode report: %@", error);
+
+    BOOL foundName = NO;
+    NSMutableSet *identifiers = [NSMutableSet set];
+    for (PLCrashReportThreadInfo *threadInfo in report.threads) {
+        STAssertTrue(threadInfo.threadIdentifier != 0, @"Missing thread identifier");
+        STAssertTrue(threadInfo.hasCPUTime, @"Missing CPU time");
+        STAssertNil(threadInfo.dispatchQueueLabel, @"Dispatch queue label was written without being enabled");
+        [identifiers addObject: [NSNumber numberWithUnsignedLongLong: threadInfo.threadIdentifier]];
+
+        if ([threadInfo.name isEqualToString: @"plcrash.test.metadata"])
+            foundName = YES;
+    }
+    STAssertEquals([report.threads count], [identifiers count], @"Thread identifiers are not unique");
+    STAssertTrue(foundName, @"The named thread was not found");
+}
+
+- (void) testWriteReportWithMemoryStatistics {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGTRAP, .code = TRAP_TRACE, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Write the report */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, true), @"Initialization failed");
+    plcrash_log_writer_set_memory_statistics(&writer, true);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    /* Verify the decoded statistics */
+    NSError *error = nil;
+    PLCrashReport *report = [[[PLCrashReport alloc] initWithData: [NSData dataWithContentsOfFile: _logPath] error: &error] autorelease];
+    STAssertNotNil(report, @"Failed to decode report: %@", error);
+
+    PLCrashReportMemoryStatistics *stats = report.memoryStatistics;
+    STAssertNotNil(stats, @"Memory statistics were not written");
+    STAssertTrue(stats.physicalFootprint > 0, @"Missing physical footprint");
+    STAssertTrue(stats.residentSize > 0, @"Missing resident size");
+    STAssertTrue(stats.virtualSize >= stats.residentSize, @"Virtual size is smaller than the resident size");
+    STAssertTrue(stats.regionCount > 0, @"Missing region count");
+
+    /* Symbolication diagnostics are only written when enabled */
+    STAssertFalse(report.hasSymbolicationDiagnostics, @"Symbolication diagnostics were written without being enabled");
+
+    /* Writer diagnostics are only written when enabled */
+    STAssertNil(report.writerDiagnostics, @"Writer diagnostics were written without being enabled");
+
+    /* The largest regions are ordered by descending size */
+    STAssertTrue([stats.largestRegions count] > 0, @"No regions were written");
+    STAssertTrue([stats.largestRegions count] <= PLCRASH_LOG_WRITER_MEMORY_REGION_COUNT, @"Too many regions were written");
+    uint64_t previous = UINT64_MAX;
+    for (PLCrashReportMemoryRegion *region in stats.largestRegions) {
+        STAssertTrue(region.size <= previous, @"Regions are not ordered by size");
+        previous = region.size;
+    }
+}
+
+- (void) testWriteIncrementalReport {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    plcrash_log_writer_baseline_t *baseline = malloc(sizeof(*baseline));
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGTRAP, .code = TRAP_TRACE, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, true), @"Initialization failed");
+    plcrash_log_writer_baseline_reset(baseline);
+    plcrash_log_writer_set_baseline(&writer, baseline);
+
+    /* Write the base report, followed by an incremental report */
+    NSData *reports[2];
+    for (int i = 0; i < 2; i++) {
+        int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_TRUNC, 0644);
+        plcrash_async_file_init(&file, fd, 0);
+
+        plcrash_log_writer_reset(&writer);
+        STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+        STAssertTrue(baseline->valid, @"The base report was not recorded");
+        plcrash_log_writer_close(&writer);
+
+        plcrash_async_file_flush(&file);
+        plcrash_async_file_close(&file);
+        reports[i] = [NSData dataWithContentsOfFile: _logPath];
+    }
+
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+    free(baseline);
+
+    /* The incremental report refers to the base report, and omits the images written to the base report */
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    STAssertNotNULL(crashReport->base_report, @"Base report was not written");
+    STAssertEquals((size_t) 0, crashReport->n_binary_images, @"Images written to the base report were written again");
+    STAssertTrue(crashReport->n_threads > 0, @"The crashed thread was not written");
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+
+    NSError *error = nil;
+    PLCrashReport *base = [[[PLCrashReport alloc] initWithData: reports[0] error: &error] autorelease];
+    STAssertNotNil(base, @"Failed to decode base report: %@", error);
+    STAssertTrue(base.baseReportUUIDRef == NULL, @"The base report is not incremental");
+
+    PLCrashReport *delta = [[[PLCrashReport alloc] initWithData: reports[1] error: &error] autorelease];
+    STAssertNotNil(delta, @"Failed to decode incremental report: %@", error);
+    STAssertTrue(CFEqual(delta.baseReportUUIDRef, base.uuidRef), @"Incorrect base report UUID");
+
+    /* Merging restores the omitted threads and images */
+    PLCrashReport *merged = [[[PLCrashReport alloc] initWithData: reports[1] baseReport: base error: &error] autorelease];
+    STAssertNotNil(merged, @"Failed to merge incremental report: %@", error);
+    STAssertEquals(base.imageCount, merged.imageCount, @"Incorrect merged image count");
+    STAssertEquals([merged.threads count], merged.threadCount, @"Incorrect merged thread count");
+    STAssertNotNil(merged.crashedThread, @"Missing crashed thread");
+
+    NSUInteger crashedCount = 0;
+    for (PLCrashReportThreadInfo *threadInfo in merged.threads) {
+        if (threadInfo.crashed)
+            crashedCount++;
+    }
+    STAssertEquals((NSUInteger) 1, crashedCount, @"Incorrect number of crashed threads");
+
+    /* Merging with an unrelated report fails */
+    STAssertNil([[[PLCrashReport alloc] initWithData: reports[1] baseReport: delta error: NULL] autorelease], @"Merged with an unrelated base report");
+}
+
+- (void) testWriteReportWithWriterDiagnostics {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGTRAP, .code = TRAP_TRACE, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, false), @"Initialization failed");
+    plcrash_log_writer_set_writer_diagnostics(&writer, true);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    /* The trailing diagnostics record must be merged into the leading report info */
+    STAssertNotNULL(crashReport->report_info, @"No report info was written");
+    STAssertTrue(crashReport->report_info->has_uuid, @"The report UUID was lost when merging the diagnostics");
+    STAssertNotNULL(crashReport->report_info->writer_diagnostics, @"No writer diagnostics were written");
+    STAssertEquals(crashReport->report_info->writer_diagnostics->n_threads, crashReport->n_threads, @"Not all threads were timed");
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+
+    NSError *error = nil;
+    PLCrashReport *report = [[[PLCrashReport alloc] initWithData: [NSData dataWithContentsOfFile: _logPath] error: &error] autorelease];
+    STAssertNotNil(report, @"Failed to decode report: %@", error);
+    STAssertNotNil(report.writerDiagnostics, @"Writer diagnostics were not decoded");
+    STAssertEquals([report.writerDiagnostics.threadTimings count], [report.threads count], @"Incorrect thread timing count");
+    STAssertTrue(report.writerDiagnostics.totalTime >= report.writerDiagnostics.imageTime, @"Total time is less than the image time");
+}
+
+- (void) testWriteReportWithBudget {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGTRAP, .code = TRAP_TRACE, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Limit the report to the crashed thread, two frames, and a single symbolicated frame */
+    plcrash_log_writer_budget_t budget = { .max_threads = 1, .max_frames = 2, .max_symbolicated_frames = 1, .time_limit = 0 };
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, false), @"Initialization failed");
+    plcrash_log_writer_set_budget(&writer, &budget);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    /* Only the crashed thread may be written */
+    STAssertEquals(crashReport->n_threads, (size_t) 1, @"The thread limit was not applied");
+    Plcrash__CrashReport__Thread *crashed = crashReport->threads[0];
+    STAssertTrue(crashed->crashed, @"The crashed thread was not written");
+    STAssertTrue(crashed->n_frames > 0 && crashed->n_frames <= 2, @"The frame limit was not applied");
+
+    /* Frames beyond the symbolication limit must be written with their PC only */
+    size_t symbolicated = 0;
+    for (size_t i = 0; i < crashed->n_frames; i++) {
+        if (crashed->frames[i]->symbol != NULL)
+            symbolicated++;
+    }
+    STAssertTrue(symbolicated <= 1, @"The symbolication limit was not applied");
+
+    /* All images must still be written */
+    STAssertEquals((uint32_t) _dyld_image_count(), (uint32_t) crashReport->n_binary_images, @"Not all images were written");
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+}
+
+- (void) testWriteReportWithExpiredDeadline {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGTRAP, .code = TRAP_TRACE, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Use a deadline that expires before the first thread is walked */
+    plcrash_log_writer_budget_t budget = { .max_threads = 0, .max_frames = 0, .max_symbolicated_frames = 0, .time_limit = 1 };
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, false), @"Initialization failed");
+    plcrash_log_writer_set_budget(&writer, &budget);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    /* The crashed thread's first frame is always written, without symbols; all other threads are omitted */
+    STAssertEquals(crashReport->n_threads, (size_t) 1, @"The remaining threads were not omitted after the deadline");
+    Plcrash__CrashReport__Thread *crashed = crashReport->threads[0];
+    STAssertTrue(crashed->crashed, @"The crashed thread was not written");
+    STAssertEquals(crashed->n_frames, (size_t) 1, @"The crashed thread was not truncated after the deadline");
+    STAssertNULL(crashed->frames[0]->symbol, @"A frame was symbolicated after the deadline");
+
+    /* The report must still complete with all images */
+    STAssertEquals((uint32_t) _dyld_image_count(), (uint32_t) crashReport->n_binary_images, @"Not all images were written");
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+}
+
+- (void) testWriteReportWithSymbolicationScope {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGTRAP, .code = TRAP_TRACE, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Limit symbolication to a directory that contains none of the loaded images; the second path is a prefix of
+     * real image paths, but does not end on a path component boundary. */
+    const char *paths[] = { "/nonexistent/images/", "/usr/li" };
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, false), @"Initialization failed");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_set_symbolication_scope(&writer, paths, 2), @"Failed to set the symbolication scope");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    /* Frames outside of the scope must be written with their PC only */
+    for (size_t i = 0; i < crashReport->n_threads; i++) {
+        Plcrash__CrashReport__Thread *thr = crashReport->threads[i];
+        STAssertTrue(thr->n_frames > 0, @"No frames were written");
+        for (size_t j = 0; j < thr->n_frames; j++)
+            STAssertNULL(thr->frames[j]->symbol, @"A frame outside of the symbolication scope was symbolicated");
+    }
+
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+}
+
+- (void) testWriteReportWithSymbolicatedThreads {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGTRAP, .code = TRAP_TRACE, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Symbolicate the crashed thread only; no thread name matches the configured prefix */
+    const char *names[] = { "org.example.nonexistent" };
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, false), @"Initialization failed");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_set_symbolicated_thread_names(&writer, names, 1), @"Failed to set the thread names");
+    plcrash_log_writer_set_symbolicated_threads(&writer, PLCRASH_LOG_WRITER_SYMBOLICATE_CRASHED|PLCRASH_LOG_WRITER_SYMBOLICATE_NAMED, 0);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    /* Only the crashed thread's frames may be symbolicated */
+    bool crashed_symbolicated = false;
+    for (size_t i = 0; i < crashReport->n_threads; i++) {
+        Plcrash__CrashReport__Thread *thr = crashReport->threads[i];
+        for (size_t j = 0; j < thr->n_frames; j++) {
+            if (thr->crashed && thr->frames[j]->symbol != NULL)
+                crashed_symbolicated = true;
+            else if (!thr->crashed)
+                STAssertNULL(thr->frames[j]->symbol, @"A frame of an unselected thread was symbolicated");
+        }
+    }
+    STAssertTrue(crashed_symbolicated, @"The crashed thread was not symbolicated");
+
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+}
+
+- (void) testWriteReportWithCustomData {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGTRAP, .code = TRAP_TRACE, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    /* Populate the regions; the breadcrumb buffer wraps, discarding its oldest entry */
+    uint64_t kv_memory[PLCrashKeyValueAreaSize(4) / sizeof(uint64_t)];
+    uint64_t bc_memory[PLCrashBreadcrumbBufferSize(2) / sizeof(uint64_t)];
+    PLCrashKeyValueArea *area = PLCrashKeyValueAreaInit(kv_memory, sizeof(kv_memory));
+    PLCrashBreadcrumbBuffer *breadcrumbs = PLCrashBreadcrumbBufferInit(bc_memory, sizeof(bc_memory));
+
+    STAssertTrue(PLCrashKeyValueAreaSet(area, "user", "alice"), @"Failed to set value");
+    STAssertTrue(PLCrashKeyValueAreaSet(area, "screen", "settings"), @"Failed to set value");
+    PLCrashBreadcrumbBufferAppend(breadcrumbs, "first");
+    PLCrashBreadcrumbBufferAppend(breadcrumbs, "second");
+    PLCrashBreadcrumbBufferAppend(breadcrumbs, "third");
+
+    /* Simulate a slot that was being modified at the time of the crash */
+    STAssertTrue(PLCrashKeyValueAreaSet(area, "torn", "value"), @"Failed to set value");
+    area->slots[2].sequence++;
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_NONE, false), @"Initialization failed");
+    plcrash_log_writer_set_custom_data(&writer, area, sizeof(kv_memory), breadcrumbs, sizeof(bc_memory));
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    /* The regions must be written verbatim */
+    Plcrash__CrashReport *crashReport = [self loadReport];
+    STAssertNotNULL(crashReport, @"Failed to load report");
+    if (crashReport == NULL)
+        return;
+
+    STAssertNotNULL(crashReport->custom_data, @"Custom data was not written");
+    if (crashReport->custom_data != NULL) {
+        STAssertEquals(crashReport->custom_data->key_value_area.len, sizeof(kv_memory), @"Incorrect key/value area length");
+        STAssertTrue(memcmp(crashReport->custom_data->key_value_area.data, kv_memory, sizeof(kv_memory)) == 0, @"Key/value area was not copied verbatim");
+        STAssertEquals(crashReport->custom_data->breadcrumbs.len, sizeof(bc_memory), @"Incorrect breadcrumb buffer length");
+    }
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) crashReport, NULL);
+
+    /* Torn entries must be discarded when decoded */
+    NSError *error = nil;
+    PLCrashReport *report = [[[PLCrashReport alloc] initWithData: [NSData dataWithContentsOfFile: _logPath] error: &error] autorelease];
+    STAssertNotNil(report, @"Failed to decode report: %@", error);
+
+    NSDictionary *expected = [NSDictionary dictionaryWithObjectsAndKeys: @"alice", @"user", @"settings", @"screen", nil];
+    STAssertEqualObjects(expected, report.customData, @"Incorrect key/value pairs");
+
+    STAssertEquals((NSUInteger) 2, [report.breadcrumbs count], @"Incorrect breadcrumb count");
+    if ([report.breadcrumbs count] == 2) {
+        STAssertEqualObjects(@"second", [[report.breadcrumbs objectAtIndex: 0] message], @"Incorrect breadcrumb");
+        STAssertEqualObjects(@"third", [[report.breadcrumbs objectAtIndex: 1] message], @"Incorrect breadcrumb");
+        NSTimeInterval age = -[[[report.breadcrumbs objectAtIndex: 1] timestamp] timeIntervalSinceNow];
+        STAssertTrue(age >= 0 && age < 60, @"Incorrect breadcrumb timestamp");
+    }
+}
+
+- (void) testWriteReportWithPrioritizedThreads {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    plcrash_async_thread_state_t thread_state;
+    thread_t thread = pthread_mach_thread_np(_thr_args.thread);
+
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+        plcrash_nasync_image_list_append(&image_list, _dyld_get_image_header(i), _dyld_get_image_name(i));
+
+    plcrash_log_bsd_signal_info_t bsd_info = { .signo = SIGTRAP, .code = TRAP_TRACE, .address = (void *) 0x42 };
+    plcrash_log_signal_info_t info = { .bsd_info = &bsd_info, .mach_info = NULL };
+    plcrash_async_thread_state_mach_thread_init(&thread_state, thread);
+
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"2.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, false), @"Initialization failed");
+    plcrash_log_writer_set_prioritize_threads(&writer, true);
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_write(&writer, thread, &image_list, &file, &info, &thread_state), @"Crash log failed");
+
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    /* The complete report must decode without being marked as truncated */
+    NSError *error = nil;
+    NSData *data = [NSData dataWithContentsOfFile: _logPath];
+    PLCrashReport *report = [[[PLCrashReport alloc] initWithData: data error: &error] autorelease];
+    STAssertNotNil(report, @"Failed to decode report: %@", error);
+    STAssertFalse(report.truncated, @"Complete report was marked as truncated");
+
+    /* Simulate termination part way through the report; the crashed thread and signal must survive */
+    NSData *partial = [data subdataWithRange: NSMakeRange(0, [data length] / 2)];
+    report = [[[PLCrashReport alloc] initWithData: partial error: &error] autorelease];
+    STAssertNotNil(report, @"Failed to decode truncated report: %@", error);
+    STAssertTrue(report.truncated, @"Truncated report was not marked as truncated");
+    STAssertEquals(report.signalInfo.address, (uint64_t) 0x42, @"Incorrect signal address");
+
+    PLCrashReportThreadInfo *crashedInfo = nil;
+    for (PLCrashReportThreadInfo *threadInfo in report.threads) {
+        if (threadInfo.crashed)
+            crashedInfo = threadInfo;
+    }
+    STAssertNotNil(crashedInfo, @"The crashed thread was lost from the truncated report");
+}
+
 @end
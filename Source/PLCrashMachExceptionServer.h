@@ -79,6 +79,55 @@ typedef kern_return_t (*PLCrashMachExceptionHandlerCallback) (task_t task,
                                                               mach_msg_type_number_t code_count,
                                                               void *context);
 
+/**
+ * @internal
+ * The exception handler to which a single exception type is forwarded.
+ */
+typedef struct plcrash_mach_exception_forward_entry {
+    /** The handler's exception port, or MACH_PORT_NULL if no handler is registered for the exception type. */
+    mach_port_t port;
+
+    /** The handler's exception behavior. */
+    exception_behavior_t behavior;
+
+    /** The handler's thread state flavor. */
+    thread_state_flavor_t flavor;
+} plcrash_mach_exception_forward_entry_t;
+
+/**
+ * @internal
+ * Exception forwarding statistics.
+ */
+typedef struct plcrash_mach_exception_forward_stats {
+    /** Number of exceptions forwarded. */
+    uint64_t forwards;
+
+    /** Total time spent forwarding exceptions, in mach_absolute_time() units. */
+    uint64_t elapsed;
+
+    /** The longest time spent forwarding a single exception, in mach_absolute_time() units. */
+    uint64_t max_elapsed;
+} plcrash_mach_exception_forward_stats_t;
+
+/**
+ * @internal
+ * A dispatch table mapping each exception type directly to the handler to which it should be forwarded, precomputed
+ * from a plcrash_mach_exception_port_set_t.
+ *
+ * @warning The table's thread state buffer is reused across forwards; a table must only be used to forward
+ * exceptions from a single thread, such as the exception server's thread.
+ */
+typedef struct plcrash_mach_exception_forward_table {
+    /** Forwarding targets, indexed by exception type. */
+    plcrash_mach_exception_forward_entry_t entries[EXC_TYPES_COUNT];
+
+    /** Thread state buffer, used when forwarding to handlers that request thread state. */
+    thread_state_data_t thread_state;
+
+    /** Forwarding statistics. */
+    plcrash_mach_exception_forward_stats_t stats;
+} plcrash_mach_exception_forward_table_t;
+
 kern_return_t PLCrashMachExceptionForward (task_t task,
                                            thread_t thread,
                                            exception_type_t exception_type,
@@ -86,6 +135,15 @@ kern_return_t PLCrashMachExceptionForward (task_t task,
                                            mach_msg_type_number_t code_count,
                                            plcrash_mach_exception_port_set_t *port_state);
 
+void plcrash_mach_exception_forward_table_init (plcrash_mach_exception_forward_table_t *table, const plcrash_mach_exception_port_set_t *port_state);
+
+kern_return_t plcrash_mach_exception_forward_table_forward (plcrash_mach_exception_forward_table_t *table,
+                                                            task_t task,
+                                                            thread_t thread,
+                                                            exception_type_t exception_type,
+                                                            mach_exception_data_t code,
+                                                            mach_msg_type_number_t code_count);
+
 @interface PLCrashMachExceptionServer : NSObject {
 @private
     /** Backing server context. This structure will not be allocated until the background
@@ -98,6 +156,11 @@ kern_return_t PLCrashMachExceptionForward (task_t task,
                 context: (void *) context
                   error: (NSError **) outError;
 
+- (id) initWithCallBack: (PLCrashMachExceptionHandlerCallback) callback
+                context: (void *) context
+           highPriority: (BOOL) highPriority
+                  error: (NSError **) outError;
+
 - (mach_port_t) copySendRightForServerAndReturningError: (NSError **) outError;
 
 - (PLCrashMachExceptionPort *) exceptionPortWithMask: (exception_mask_t) mask error: (NSError **) outError;
@@ -88,9 +88,11 @@
 #import "PLCrashAsync.h"
 
 #import <pthread.h>
+#import <sched.h>
 #import <libkern/OSAtomic.h>
 
 #import <mach/mach.h>
+#import <mach/mach_time.h>
 #import <mach/exc.h>
 
 /* The msgh_id to use for thread termination messages. This value most not conflict with the MACH_NOTIFY_NO_SENDERS msgh_id, which
@@ -116,6 +118,22 @@ typedef __Reply__exception_raise_t PLReply_exception_raise_t;
 #  define PLCRASH_DEFAULT_BEHAVIOR EXCEPTION_DEFAULT
 #endif
 
+/**
+ * @internal
+ * The size of the exception server's preallocated receive buffer. This is large enough for the largest exception
+ * request we may receive -- including 64-bit codes delivered via the 32-bit request types, and the largest message
+ * trailer -- such that the buffer never needs to be reallocated after an exception has been raised.
+ */
+#define PLCRASH_EXCEPTION_REQUEST_BUFFER_SIZE round_page(sizeof(PLRequest_exception_raise_t) + (sizeof(mach_exception_data_type_t) * EXCEPTION_CODE_MAX) + MAX_TRAILER_SIZE)
+
+/**
+ * @internal
+ * The number of bytes of the exception server thread's stack that are touched when the thread starts, ensuring that
+ * the pages used by the exception callback are resident before an exception is raised. This matches the stack
+ * space reserved for the signal handler's crash dump path.
+ */
+#define PLCRASH_EXCEPTION_SERVER_PREFAULT_STACK_SIZE (64 * 1024)
+
 /**
  * @internal
  * Map an exception type to its corresponding mask value.
@@ -176,6 +194,15 @@ struct plcrash_exception_server_context {
     /** User callback context. */
     void *callback_context;
 
+    /** Preallocated receive buffer of PLCRASH_EXCEPTION_REQUEST_BUFFER_SIZE bytes. */
+    PLRequest_exception_raise_t *request;
+
+    /** The size of @a request, in bytes. */
+    size_t request_size;
+
+    /** Preallocated reply message. */
+    PLReply_exception_raise_t reply;
+
     /** Lock used to signal waiting initialization thread. */
     pthread_mutex_t lock;
     
@@ -260,6 +287,27 @@ struct plcrash_exception_server_context {
 - (id) initWithCallBack: (PLCrashMachExceptionHandlerCallback) callback
                 context: (void *) context
                   error: (NSError **) outError
+{
+    return [self initWithCallBack: callback context: context highPriority: NO error: outError];
+}
+
+/**
+ * Initialize a new Mach exception server.
+ *
+ * @param callback Callback called upon receipt of an exception. The callback will execute
+ * on the exception server's thread, distinctly from the crashed thread.
+ * @param context Context to be passed to the callback. May be NULL.
+ * @param highPriority If YES, the server thread will be run at the highest available quality of service,
+ * minimizing the latency between an exception being raised and the callback being issued.
+ * @param outError A pointer to an NSError object variable. If an error occurs initializing the exception server,
+ * this pointer will contain an error object in the NSMachErrorDomain or NSPOSIXErrorDomain indicating why the
+ * exception handler could not be registered. If no error occurs, this parameter will be left unmodified.
+ * You may specify NULL for this parameter, and no error information will be provided.
+ */
+- (id) initWithCallBack: (PLCrashMachExceptionHandlerCallback) callback
+                context: (void *) context
+           highPriority: (BOOL) highPriority
+                  error: (NSError **) outError
 {
     pthread_attr_t attr;
     pthread_t thr;
@@ -299,6 +347,20 @@ struct plcrash_exception_server_context {
         return nil;
     }
     
+    /*
+     * Preallocate the receive buffer, touching its pages so that they are resident before an exception is raised.
+     */
+    _serverContext->request_size = PLCRASH_EXCEPTION_REQUEST_BUFFER_SIZE;
+    kr = vm_allocate(mach_task_self(), (vm_address_t *) &_serverContext->request, _serverContext->request_size, VM_FLAGS_ANYWHERE);
+    if (kr != KERN_SUCCESS) {
+        plcrash_populate_mach_error(outError, kr, @"Failed to allocate exception server's receive buffer");
+
+        _serverContext->request = NULL;
+        [self release];
+        return nil;
+    }
+    memset(_serverContext->request, 0, _serverContext->request_size);
+
     /*
      * Initalize our server's port
      */
@@ -377,6 +439,26 @@ struct plcrash_exception_server_context {
         }
         
         pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+        /* Elevate the server's priority, if requested. Failure is non-fatal; the server will simply run at the
+         * default priority. */
+        if (highPriority) {
+            /* The QoS API is available as of Mac OS X 10.10 and iOS 8; the QOS_CLASS_* values are not macros, so we
+             * test for the presence of pthread/qos.h via QOS_MIN_RELATIVE_PRIORITY. */
+#ifdef QOS_MIN_RELATIVE_PRIORITY
+            if (&pthread_attr_set_qos_class_np != NULL) {
+                pthread_attr_set_qos_class_np(&attr, QOS_CLASS_USER_INTERACTIVE, 0);
+            } else
+#endif
+            {
+                struct sched_param param;
+                if (pthread_attr_getschedparam(&attr, &param) == 0) {
+                    param.sched_priority = sched_get_priority_max(SCHED_OTHER);
+                    pthread_attr_setschedparam(&attr, &param);
+                }
+            }
+        }
+
         // TODO - A custom stack should be specified, using high/low guard pages to help prevent overwriting the stack
         // by crashing code.
         // pthread_attr_setstack(&attr, sp, stacksize);
@@ -487,19 +569,18 @@ struct plcrash_exception_server_context {
  * Send a Mach exception reply for the given @a request and return the result.
  *
  * @param request The request to which a reply should be sent.
+ * @param reply The buffer in which the reply message will be constructed.
  * @param retcode The reply return code to supply.
  */
-static mach_msg_return_t exception_server_reply (PLRequest_exception_raise_t *request, kern_return_t retcode) {
-    PLReply_exception_raise_t reply;
-    
+static mach_msg_return_t exception_server_reply (PLRequest_exception_raise_t *request, PLReply_exception_raise_t *reply, kern_return_t retcode) {
     /* Initialize the reply */
-    memset(&reply, 0, sizeof(reply));
-    reply.Head.msgh_bits = MACH_MSGH_BITS(MACH_MSGH_BITS_REMOTE(request->Head.msgh_bits), 0);
-    reply.Head.msgh_local_port = MACH_PORT_NULL;
-    reply.Head.msgh_remote_port = request->Head.msgh_remote_port;
-    reply.Head.msgh_size = sizeof(reply);
-    reply.NDR = NDR_record;
-    reply.RetCode = retcode;
+    memset(reply, 0, sizeof(*reply));
+    reply->Head.msgh_bits = MACH_MSGH_BITS(MACH_MSGH_BITS_REMOTE(request->Head.msgh_bits), 0);
+    reply->Head.msgh_local_port = MACH_PORT_NULL;
+    reply->Head.msgh_remote_port = request->Head.msgh_remote_port;
+    reply->Head.msgh_size = sizeof(*reply);
+    reply->NDR = NDR_record;
+    reply->RetCode = retcode;
     
     /*
      * Mach uses reply id offsets of 100. This is rather arbitrary, and in theory could be changed
@@ -509,72 +590,35 @@ static mach_msg_return_t exception_server_reply (PLRequest_exception_raise_t *re
      * On Mac OS X, the reply_id offset may be considered implicitly defined due to mach_exc.defs and
      * exc.defs being public.
      */
-    reply.Head.msgh_id = request->Head.msgh_id + 100;
+    reply->Head.msgh_id = request->Head.msgh_id + 100;
     
     /* Dispatch the reply */
-    return mach_msg(&reply.Head, MACH_SEND_MSG, reply.Head.msgh_size, 0, MACH_PORT_NULL, MACH_MSG_TIMEOUT_NONE, MACH_PORT_NULL);
+    return mach_msg(&reply->Head, MACH_SEND_MSG, reply->Head.msgh_size, 0, MACH_PORT_NULL, MACH_MSG_TIMEOUT_NONE, MACH_PORT_NULL);
 }
 
 
 /**
- * Forward a Mach exception to the given exception to the first matching handler in @a state, if any.
+ * Forward a Mach exception to @a target.
  *
+ * @param target The handler to which the exception should be forwarded.
+ * @param thread_state A buffer to be used for thread state, if required by the handler's behavior.
  * @param task The task in which the exception occured.
- * @param thread The thread on which the exception occured. The thread will be suspended when the callback is issued, and may be resumed
- * by the callback using thread_resume().
+ * @param thread The thread on which the exception occured.
  * @param exception_type Mach exception type.
  * @param code Mach exception codes.
  * @param code_count The number of codes provided.
- * @param port_state The set of exception handlers to which the message should be forwarded.
- *
- * @return Returns KERN_SUCCESS if the exception was handled by a registered exception server, or an error
- * if the exception was not handled, or forwarding failed.
- *
- * @par In-Process Operation
- *
- * When operating in-process, handling the exception replies internally breaks external debuggers,
- * as they assume it is safe to leave our thread suspended. This results in the target thread never resuming,
- * as our thread never wakes up to reply to the message, or to handle future messages.
- *
- * The recommended solution is to simply not register a Mach exception handler in the case where a debugger
- * is already attached.
- *
- * @note This function may be called at crash-time.
  */
-kern_return_t PLCrashMachExceptionForward (task_t task,
+static kern_return_t exception_forward_to (const plcrash_mach_exception_forward_entry_t *target,
+                                           thread_state_t thread_state,
+                                           task_t task,
                                            thread_t thread,
                                            exception_type_t exception_type,
                                            mach_exception_data_t code,
-                                           mach_msg_type_number_t code_count,
-                                           plcrash_mach_exception_port_set_t *port_state)
+                                           mach_msg_type_number_t code_count)
 {
-    exception_behavior_t behavior;
-    thread_state_flavor_t flavor;
-    mach_port_t port;
-    
-    /* Find a matching handler */
-    exception_mask_t fwd_mask = exception_to_mask(exception_type);
-    bool found = false;
-    for (mach_msg_type_number_t i = 0; i < port_state->count; i++) {
-        if (!MACH_PORT_VALID(port_state->ports[i]))
-            continue;
-        
-        if ((port_state->masks[i] & fwd_mask) == 0)
-            continue;
-        
-        found = true;
-        port = port_state->ports[i];
-        behavior = port_state->behaviors[i];
-        flavor = port_state->flavors[i];
-        break;
-    }
-    
-    /* No handler found */
-    if (!found) {
-        return KERN_FAILURE;
-    }
-    
-    thread_state_data_t thread_state;
+    exception_behavior_t behavior = target->behavior;
+    thread_state_flavor_t flavor = target->flavor;
+    mach_port_t port = target->port;
     mach_msg_type_number_t thread_state_count;
     kern_return_t kr;
     
@@ -650,6 +694,150 @@ kern_return_t PLCrashMachExceptionForward (task_t task,
 }
 
 
+/**
+ * Forward a Mach exception to the given exception to the first matching handler in @a state, if any.
+ *
+ * @param task The task in which the exception occured.
+ * @param thread The thread on which the exception occured. The thread will be suspended when the callback is issued, and may be resumed
+ * by the callback using thread_resume().
+ * @param exception_type Mach exception type.
+ * @param code Mach exception codes.
+ * @param code_count The number of codes provided.
+ * @param port_state The set of exception handlers to which the message should be forwarded.
+ *
+ * @return Returns KERN_SUCCESS if the exception was handled by a registered exception server, or an error
+ * if the exception was not handled, or forwarding failed.
+ *
+ * @par In-Process Operation
+ *
+ * When operating in-process, handling the exception replies internally breaks external debuggers,
+ * as they assume it is safe to leave our thread suspended. This results in the target thread never resuming,
+ * as our thread never wakes up to reply to the message, or to handle future messages.
+ *
+ * The recommended solution is to simply not register a Mach exception handler in the case where a debugger
+ * is already attached.
+ *
+ * @note This function may be called at crash-time.
+ */
+kern_return_t PLCrashMachExceptionForward (task_t task,
+                                           thread_t thread,
+                                           exception_type_t exception_type,
+                                           mach_exception_data_t code,
+                                           mach_msg_type_number_t code_count,
+                                           plcrash_mach_exception_port_set_t *port_state)
+{
+    plcrash_mach_exception_forward_entry_t target;
+    
+    /* Find a matching handler */
+    exception_mask_t fwd_mask = exception_to_mask(exception_type);
+    bool found = false;
+    for (mach_msg_type_number_t i = 0; i < port_state->count; i++) {
+        if (!MACH_PORT_VALID(port_state->ports[i]))
+            continue;
+        
+        if ((port_state->masks[i] & fwd_mask) == 0)
+            continue;
+        
+        found = true;
+        target.port = port_state->ports[i];
+        target.behavior = port_state->behaviors[i];
+        target.flavor = port_state->flavors[i];
+        break;
+    }
+    
+    /* No handler found */
+    if (!found) {
+        return KERN_FAILURE;
+    }
+    
+    thread_state_data_t thread_state;
+    return exception_forward_to(&target, thread_state, task, thread, exception_type, code, code_count);
+}
+
+/**
+ * Initialize @a table from @a port_state, resolving the handler for each exception type in advance. For each
+ * exception type, the first valid port whose mask includes the type is used, matching the behavior of
+ * PLCrashMachExceptionForward().
+ *
+ * @param table The table to initialize.
+ * @param port_state The set of exception handlers to which exceptions should be forwarded.
+ */
+void plcrash_mach_exception_forward_table_init (plcrash_mach_exception_forward_table_t *table, const plcrash_mach_exception_port_set_t *port_state) {
+    memset(table, 0, sizeof(*table));
+
+    /* Exception type 0 is unused. Not every type below EXC_TYPES_COUNT is known to exception_to_mask(), so we
+     * rely directly on the standard mask flag assignment. */
+    for (exception_type_t type = 1; type < EXC_TYPES_COUNT; type++) {
+        exception_mask_t mask = (exception_mask_t) 1 << type;
+
+        for (mach_msg_type_number_t i = 0; i < port_state->count; i++) {
+            if (!MACH_PORT_VALID(port_state->ports[i]))
+                continue;
+
+            if ((port_state->masks[i] & mask) == 0)
+                continue;
+
+            table->entries[type].port = port_state->ports[i];
+            table->entries[type].behavior = port_state->behaviors[i];
+            table->entries[type].flavor = port_state->flavors[i];
+            break;
+        }
+    }
+}
+
+/**
+ * Forward a Mach exception to the handler registered for @a exception_type in @a table, if any, recording the time
+ * spent forwarding in the table's statistics.
+ *
+ * @param table The forwarding table.
+ * @param task The task in which the exception occured.
+ * @param thread The thread on which the exception occured.
+ * @param exception_type Mach exception type.
+ * @param code Mach exception codes.
+ * @param code_count The number of codes provided.
+ *
+ * @return Returns KERN_SUCCESS if the exception was handled by a registered exception server, or an error
+ * if the exception was not handled, or forwarding failed.
+ *
+ * @note This function may be called at crash-time.
+ */
+kern_return_t plcrash_mach_exception_forward_table_forward (plcrash_mach_exception_forward_table_t *table,
+                                                            task_t task,
+                                                            thread_t thread,
+                                                            exception_type_t exception_type,
+                                                            mach_exception_data_t code,
+                                                            mach_msg_type_number_t code_count)
+{
+    if (exception_type <= 0 || exception_type >= EXC_TYPES_COUNT)
+        return KERN_FAILURE;
+
+    const plcrash_mach_exception_forward_entry_t *target = &table->entries[exception_type];
+    if (!MACH_PORT_VALID(target->port))
+        return KERN_FAILURE;
+
+    uint64_t start = mach_absolute_time();
+    kern_return_t kr = exception_forward_to(target, table->thread_state, task, thread, exception_type, code, code_count);
+    uint64_t elapsed = mach_absolute_time() - start;
+
+    table->stats.forwards++;
+    table->stats.elapsed += elapsed;
+    if (elapsed > table->stats.max_elapsed)
+        table->stats.max_elapsed = elapsed;
+
+    return kr;
+}
+
+
+/**
+ * Touch PLCRASH_EXCEPTION_SERVER_PREFAULT_STACK_SIZE bytes of the calling thread's stack, faulting in the pages
+ * that will be used by the exception callback.
+ */
+static void __attribute__((noinline)) exception_server_prefault_stack (void) {
+    volatile uint8_t stack[PLCRASH_EXCEPTION_SERVER_PREFAULT_STACK_SIZE];
+    for (size_t i = 0; i < sizeof(stack); i += 1024)
+        stack[i] = 0;
+}
+
 /**
  * Background exception server. Handles incoming exception messages and dispatches
  * them to the registered callback.
@@ -659,27 +847,21 @@ kern_return_t PLCrashMachExceptionForward (task_t task,
  */
 static void *exception_server_thread (void *arg) {
     struct plcrash_exception_server_context *exc_context = (struct plcrash_exception_server_context *) arg;
-    PLRequest_exception_raise_t *request = NULL;
-    size_t request_size;
-    kern_return_t kr;
+    PLRequest_exception_raise_t *request = exc_context->request;
+    size_t request_size = exc_context->request_size;
     mach_msg_return_t mr;
-    
-    /* Initialize the received message with a default size */
-    request_size = round_page(sizeof(*request));
-    kr = vm_allocate(mach_task_self(), (vm_address_t *) &request, request_size, VM_FLAGS_ANYWHERE);
-    if (kr != KERN_SUCCESS) {
-        /* Shouldn't happen ... */
-        fprintf(stderr, "Unexpected error in vm_allocate(): %x\n", kr);
-        return NULL;
-    }
+
+    /* Ensure that the stack used by the exception callback is resident */
+    exception_server_prefault_stack();
     
     /* Wait for an exception message */
     while (true) {
-        /* Initialize our request message */
+        /* Initialize our request message. Messages larger than our worst-case buffer can not be exception
+         * requests; rather than growing the buffer, we let the kernel discard them. */
         request->Head.msgh_local_port = exc_context->port_set;
-        request->Head.msgh_size = request_size;
+        request->Head.msgh_size = (mach_msg_size_t) request_size;
         mr = mach_msg(&request->Head,
-                      MACH_RCV_MSG | MACH_RCV_LARGE,
+                      MACH_RCV_MSG,
                       0,
                       request->Head.msgh_size,
                       exc_context->port_set,
@@ -688,20 +870,7 @@ static void *exception_server_thread (void *arg) {
         
         /* Handle recoverable errors */
         if (mr != MACH_MSG_SUCCESS && mr == MACH_RCV_TOO_LARGE) {
-            /* Determine the new size (before dropping the buffer) */
-            request_size = round_page(request->Head.msgh_size);
-            
-            /* Drop the old receive buffer */
-            vm_deallocate(mach_task_self(), (vm_address_t) request, request_size);
-            
-            /* Re-allocate a larger receive buffer */
-            kr = vm_allocate(mach_task_self(), (vm_address_t *) &request, request_size, VM_FLAGS_ANYWHERE);
-            if (kr != KERN_SUCCESS) {
-                /* Shouldn't happen ... */
-                fprintf(stderr, "Unexpected error in vm_allocate(): 0x%x\n", kr);
-                return NULL;
-            }
-            
+            PLCF_DEBUG("Discarded oversized message on the exception server port");
             continue;
             
             /* Handle fatal errors */
@@ -752,7 +921,7 @@ static void *exception_server_thread (void *arg) {
                 PLCF_DEBUG("Unexpected message size of %" PRIu64, (uint64_t) request->Head.msgh_size);
 
                 /* Provide a negative reply */
-                mr = exception_server_reply(request, KERN_FAILURE);
+                mr = exception_server_reply(request, &exc_context->reply, KERN_FAILURE);
                 if (mr != MACH_MSG_SUCCESS)
                     PLCF_DEBUG("Unexpected failure replying to Mach exception message: 0x%x", mr);
                 
@@ -794,16 +963,13 @@ static void *exception_server_thread (void *arg) {
             /*
              * Reply to the message.
              */
-            mr = exception_server_reply(request, exc_result);
+            mr = exception_server_reply(request, &exc_context->reply, exc_result);
             if (mr != MACH_MSG_SUCCESS)
                 PLCF_DEBUG("Unexpected failure replying to Mach exception message: 0x%x", mr);
         }
     }
     
-    /* Drop the receive buffer */
-    if (request != NULL)
-        vm_deallocate(mach_task_self(), (vm_address_t) request, request_size);
-    
+    /* The receive buffer is owned by the server instance, and is released on dealloc */
     return NULL;
 }
 
@@ -853,6 +1019,9 @@ static void *exception_server_thread (void *arg) {
     if (_serverContext->port_set != MACH_PORT_NULL)
         mach_port_deallocate(mach_task_self(), _serverContext->port_set);
 
+    if (_serverContext->request != NULL)
+        vm_deallocate(mach_task_self(), (vm_address_t) _serverContext->request, _serverContext->request_size);
+
     pthread_cond_destroy(&_serverContext->server_cond);
     pthread_mutex_destroy(&_serverContext->lock);
 
@@ -167,6 +167,36 @@ static kern_return_t exception_callback (task_t task,
     STAssertEquals(crash_page[1], (uint8_t)0xFE, @"Crash callback did not run");
 }
 
+/**
+ * Test handling of an exception by a high priority server, which receives into its preallocated buffers.
+ */
+- (void) testHighPriorityServer {
+    NSError *error;
+
+    PLCrashMachExceptionServer *server = [[[PLCrashMachExceptionServer alloc] initWithCallBack: exception_callback
+                                                                                       context: NULL
+                                                                                  highPriority: YES
+                                                                                         error: &error] autorelease];
+    STAssertNotNil(server, @"Failed to initialize server");
+
+    PLCrashMachExceptionPort *port = [server exceptionPortWithMask: EXC_MASK_BAD_ACCESS error: &error];
+    STAssertNotNil(port, @"Failed to fetch server port: %@", error);
+
+    STAssertTrue([port registerForTask: mach_task_self()
+                       previousPortSet: NULL
+                                 error: &error], @"Failed to configure handler: %@", error);
+
+    /* Issue two exceptions, verifying that the receive buffer is reused */
+    for (int i = 0; i < 2; i++) {
+        crash_page[1] = 0;
+        mprotect(crash_page, sizeof(crash_page), 0);
+        crash_page[0] = 0xCA;
+
+        STAssertEquals(crash_page[0], (uint8_t)0xCA, @"Page should have been set to test value");
+        STAssertEquals(crash_page[1], (uint8_t)0xFE, @"Crash callback did not run");
+    }
+}
+
 /**
  * Test inserting/removing the mach exception server from the handler chain.
  */
@@ -260,6 +290,58 @@ static kern_return_t exception_callback (task_t task,
 #endif
 }
 
+/**
+ * Test forwarding via a precomputed forwarding table.
+ */
+- (void) testForwardTable {
+    NSError *error;
+
+    /* Set up a test server */
+    BOOL didRun = false;
+    PLCrashMachExceptionServer *server = [[[PLCrashMachExceptionServer alloc] initWithCallBack: exception_callback
+                                                                                       context: &didRun
+                                                                                         error: &error] autorelease];
+    STAssertNotNil(server, @"Failed to initialize server");
+
+    PLCrashMachExceptionPort *port = [server exceptionPortWithMask: EXC_MASK_BAD_ACCESS error: &error];
+    STAssertNotNil(port, @"Failed to fetch server port: %@", error);
+
+    STAssertTrue([port registerForTask: mach_task_self()
+                       previousPortSet: NULL
+                                 error: &error], @"Failed to configure handler: %@", error);
+
+    /* Build the table from the server's port set */
+    PLCrashMachExceptionPortSet *portSet = [PLCrashMachExceptionPort exceptionPortsForTask: mach_task_self() mask: EXC_MASK_BAD_ACCESS error: &error];
+    plcrash_mach_exception_port_set_t port_set = portSet.asyncSafeRepresentation;
+
+    plcrash_mach_exception_forward_table_t *table = malloc(sizeof(*table));
+    plcrash_mach_exception_forward_table_init(table, &port_set);
+    STAssertTrue(MACH_PORT_VALID(table->entries[EXC_BAD_ACCESS].port), @"No handler found for EXC_BAD_ACCESS");
+    STAssertFalse(MACH_PORT_VALID(table->entries[EXC_ARITHMETIC].port), @"Unexpected handler for EXC_ARITHMETIC");
+
+    /* Exceptions without a handler are not forwarded */
+    mach_exception_data_type_t codes[2];
+    codes[0] = 0x1;
+    codes[1] = 0x2;
+    kern_return_t kt = plcrash_mach_exception_forward_table_forward(table, mach_task_self(), pl_mach_thread_self(), EXC_ARITHMETIC, codes, 2);
+    STAssertNotEquals(KERN_SUCCESS, kt, @"Exception was forwarded without a registered handler");
+    STAssertEquals((uint64_t) 0, table->stats.forwards, @"Unforwarded exception was counted");
+
+    /* Forward the exception */
+    kt = plcrash_mach_exception_forward_table_forward(table, mach_task_self(), pl_mach_thread_self(), EXC_BAD_ACCESS, codes, 2);
+    STAssertEquals((uint64_t) 1, table->stats.forwards, @"Forwarded exception was not counted");
+    STAssertTrue(table->stats.max_elapsed <= table->stats.elapsed, @"Inconsistent forwarding statistics");
+
+#if (PL_MACH64_EXC_API || !PL_MACH64_EXC_CODES)
+    STAssertEquals(KERN_SUCCESS, kt, @"Callback did not return KERN_SUCCESS");
+    STAssertTrue(didRun, @"Calback was not executed");
+#else
+    STAssertNotEquals(KERN_SUCCESS, kt, @"Callback returned KERN_SUCCESS despite missing mach_exc* APIs");
+#endif
+
+    free(table);
+}
+
 /**
  * Test basic copying of the send right.
  */
@@ -54,33 +54,60 @@
 #ifdef PLCRASHREPORTER_PREFIX
 
 /* Objective-C Classes */
+#define PLCrashHelperServer                 PLNS(PLCrashHelperServer)
+#define PLCrashHostInfo                     PLNS(PLCrashHostInfo)
+#define PLCrashLiveReportScheduler          PLNS(PLCrashLiveReportScheduler)
+#define PLCrashLiveReportSession            PLNS(PLCrashLiveReportSession)
+#define PLCrashMachExceptionPort            PLNS(PLCrashMachExceptionPort)
+#define PLCrashMachExceptionPortSet         PLNS(PLCrashMachExceptionPortSet)
 #define PLCrashMachExceptionServer          PLNS(PLCrashMachExceptionServer)
+#define PLCrashProcessInfo                  PLNS(PLCrashProcessInfo)
 #define PLCrashReport                       PLNS(PLCrashReport)
 #define PLCrashReportApplicationInfo        PLNS(PLCrashReportApplicationInfo)
+#define PLCrashReportBatch                  PLNS(PLCrashReportBatch)
 #define PLCrashReportBinaryImageInfo        PLNS(PLCrashReportBinaryImageInfo)
+#define PLCrashReportBreadcrumb             PLNS(PLCrashReportBreadcrumb)
 #define PLCrashReportExceptionInfo          PLNS(PLCrashReportExceptionInfo)
+#define PLCrashReportFormatter              PLNS(PLCrashReportFormatter)
+#define PLCrashReportFrameArray             PLNS(PLCrashReportFrameArray)
+#define PLCrashReportFrameStorage           PLNS(PLCrashReportFrameStorage)
+#define PLCrashReportJSONFormatter          PLNS(PLCrashReportJSONFormatter)
 #define PLCrashReportMachExceptionInfo      PLNS(PLCrashReportMachExceptionInfo)
 #define PLCrashReportMachineInfo            PLNS(PLCrashReportMachineInfo)
+#define PLCrashReportMemoryRegion           PLNS(PLCrashReportMemoryRegion)
+#define PLCrashReportMemoryStatistics       PLNS(PLCrashReportMemoryStatistics)
 #define PLCrashReportProcessInfo            PLNS(PLCrashReportProcessInfo)
 #define PLCrashReportProcessorInfo          PLNS(PLCrashReportProcessorInfo)
 #define PLCrashReportRegisterInfo           PLNS(PLCrashReportRegisterInfo)
 #define PLCrashReportSignalInfo             PLNS(PLCrashReportSignalInfo)
 #define PLCrashReportStackFrameInfo         PLNS(PLCrashReportStackFrameInfo)
+#define PLCrashReportStackSample            PLNS(PLCrashReportStackSample)
+#define PLCrashReportStackSamples           PLNS(PLCrashReportStackSamples)
+#define PLCrashReportSummary                PLNS(PLCrashReportSummary)
+#define PLCrashReportSymbolDemangler        PLNS(PLCrashReportSymbolDemangler)
 #define PLCrashReportSymbolInfo             PLNS(PLCrashReportSymbolInfo)
+#define PLCrashReportSymbolicationDiagnostics PLNS(PLCrashReportSymbolicationDiagnostics)
 #define PLCrashReportSystemInfo             PLNS(PLCrashReportSystemInfo)
 #define PLCrashReportTextFormatter          PLNS(PLCrashReportTextFormatter)
 #define PLCrashReportThreadInfo             PLNS(PLCrashReportThreadInfo)
+#define PLCrashReportThreadTiming           PLNS(PLCrashReportThreadTiming)
+#define PLCrashReportWriterDiagnostics      PLNS(PLCrashReportWriterDiagnostics)
 #define PLCrashReporter                     PLNS(PLCrashReporter)
-#define PLCrashSignalHandler                PLNS(PLCrashSignalHandler)
-#define PLCrashHostInfo                     PLNS(PLCrashHostInfo)
-#define PLCrashMachExceptionPort            PLNS(PLCrashMachExceptionPort)
-#define PLCrashMachExceptionPortSet         PLNS(PLCrashMachExceptionPortSet)
-#define PLCrashProcessInfo                  PLNS(PLCrashProcessInfo)
 #define PLCrashReporterConfig               PLNS(PLCrashReporterConfig)
+#define PLCrashReporterStartupMetrics       PLNS(PLCrashReporterStartupMetrics)
+#define PLCrashSignalHandler                PLNS(PLCrashSignalHandler)
+#define PLCrashTaskReporter                 PLNS(PLCrashTaskReporter)
+#define PLCrashTaskReporterTarget           PLNS(PLCrashTaskReporterTarget)
 #define PLCrashUncaughtExceptionHandler     PLNS(PLCrashUncaughtExceptionHandler)
-#define PLCrashReportFormatter              PLNS(PLCrashReportFormatter)
 
 /* Public C functions */
+#define PLCrashBreadcrumbBufferAppend       PLNS(PLCrashBreadcrumbBufferAppend)
+#define PLCrashBreadcrumbBufferInit         PLNS(PLCrashBreadcrumbBufferInit)
+#define PLCrashBreadcrumbBufferSize         PLNS(PLCrashBreadcrumbBufferSize)
+#define PLCrashKeyValueAreaInit             PLNS(PLCrashKeyValueAreaInit)
+#define PLCrashKeyValueAreaRemove           PLNS(PLCrashKeyValueAreaRemove)
+#define PLCrashKeyValueAreaSet              PLNS(PLCrashKeyValueAreaSet)
+#define PLCrashKeyValueAreaSize             PLNS(PLCrashKeyValueAreaSize)
 #define PLCrashMachExceptionForward         PLNS(PLCrashMachExceptionForward)
 #define PLCrashSignalHandlerForward         PLNS(PLCrashSignalHandlerForward)
 #define plcrash_signal_handler              PLNS(plcrash_signal_handler)
@@ -138,6 +165,9 @@
 #define plcrash_async_address_apply_offset PLNS(plcrash_async_address_apply_offset)
 #define plcrash_async_allocator_alloc PLNS(plcrash_async_allocator_alloc)
 #define plcrash_async_allocator_new PLNS(plcrash_async_allocator_new)
+#define plcrash_async_arena_alloc PLNS(plcrash_async_arena_alloc)
+#define plcrash_async_arena_contains PLNS(plcrash_async_arena_contains)
+#define plcrash_async_arena_reset PLNS(plcrash_async_arena_reset)
 #define plcrash_async_byteorder_big_endian PLNS(plcrash_async_byteorder_big_endian)
 #define plcrash_async_byteorder_direct PLNS(plcrash_async_byteorder_direct)
 #define plcrash_async_byteorder_little_endian PLNS(plcrash_async_byteorder_little_endian)
@@ -159,61 +189,117 @@
 #define plcrash_async_file_close PLNS(plcrash_async_file_close)
 #define plcrash_async_file_flush PLNS(plcrash_async_file_flush)
 #define plcrash_async_file_init PLNS(plcrash_async_file_init)
+#define plcrash_async_file_init_buffer PLNS(plcrash_async_file_init_buffer)
+#define plcrash_async_file_init_vm PLNS(plcrash_async_file_init_vm)
+#define plcrash_async_file_is_patchable PLNS(plcrash_async_file_is_patchable)
+#define plcrash_async_file_nasync_init_mmap PLNS(plcrash_async_file_nasync_init_mmap)
+#define plcrash_async_file_nasync_preallocate PLNS(plcrash_async_file_nasync_preallocate)
+#define plcrash_async_file_patch PLNS(plcrash_async_file_patch)
+#define plcrash_async_file_set_buffer PLNS(plcrash_async_file_set_buffer)
+#define plcrash_async_file_set_compressor PLNS(plcrash_async_file_set_compressor)
 #define plcrash_async_file_write PLNS(plcrash_async_file_write)
 #define plcrash_async_find_symbol PLNS(plcrash_async_find_symbol)
+#define plcrash_async_find_symbols PLNS(plcrash_async_find_symbols)
 #define plcrash_async_image_containing_address PLNS(plcrash_async_image_containing_address)
+#define plcrash_async_image_cursor_init PLNS(plcrash_async_image_cursor_init)
+#define plcrash_async_image_cursor_next PLNS(plcrash_async_image_cursor_next)
+#define plcrash_async_image_has_flags PLNS(plcrash_async_image_has_flags)
+#define plcrash_async_image_list_find_named PLNS(plcrash_async_image_list_find_named)
+#define plcrash_async_image_list_has_deferred PLNS(plcrash_async_image_list_has_deferred)
 #define plcrash_async_image_list_next PLNS(plcrash_async_image_list_next)
 #define plcrash_async_image_list_set_reading PLNS(plcrash_async_image_list_set_reading)
+#define plcrash_async_image_set_flags PLNS(plcrash_async_image_set_flags)
+#define plcrash_async_lz_flush PLNS(plcrash_async_lz_flush)
+#define plcrash_async_lz_init PLNS(plcrash_async_lz_init)
+#define plcrash_async_lz_write PLNS(plcrash_async_lz_write)
 #define plcrash_async_mach_exception_get_siginfo PLNS(plcrash_async_mach_exception_get_siginfo)
 #define plcrash_async_macho_byteorder PLNS(plcrash_async_macho_byteorder)
 #define plcrash_async_macho_contains_address PLNS(plcrash_async_macho_contains_address)
 #define plcrash_async_macho_cpu_subtype PLNS(plcrash_async_macho_cpu_subtype)
 #define plcrash_async_macho_cpu_type PLNS(plcrash_async_macho_cpu_type)
 #define plcrash_async_macho_find_command PLNS(plcrash_async_macho_find_command)
+#define plcrash_async_macho_find_function_start PLNS(plcrash_async_macho_find_function_start)
 #define plcrash_async_macho_find_segment_cmd PLNS(plcrash_async_macho_find_segment_cmd)
 #define plcrash_async_macho_find_symbol_by_name PLNS(plcrash_async_macho_find_symbol_by_name)
 #define plcrash_async_macho_find_symbol_by_pc PLNS(plcrash_async_macho_find_symbol_by_pc)
+#define plcrash_async_macho_find_symbols_by_pc PLNS(plcrash_async_macho_find_symbols_by_pc)
+#define plcrash_async_macho_function_starts_size PLNS(plcrash_async_macho_function_starts_size)
+#define plcrash_async_macho_has_objc PLNS(plcrash_async_macho_has_objc)
 #define plcrash_async_macho_header PLNS(plcrash_async_macho_header)
 #define plcrash_async_macho_header_size PLNS(plcrash_async_macho_header_size)
+#define plcrash_async_macho_in_shared_cache PLNS(plcrash_async_macho_in_shared_cache)
+#define plcrash_async_macho_init_borrowed_name PLNS(plcrash_async_macho_init_borrowed_name)
 #define plcrash_async_macho_map_section PLNS(plcrash_async_macho_map_section)
 #define plcrash_async_macho_map_segment PLNS(plcrash_async_macho_map_segment)
 #define plcrash_async_macho_mapped_segment_free PLNS(plcrash_async_macho_mapped_segment_free)
 #define plcrash_async_macho_next_command PLNS(plcrash_async_macho_next_command)
 #define plcrash_async_macho_next_command_type PLNS(plcrash_async_macho_next_command_type)
+#define plcrash_async_macho_pool_map_section PLNS(plcrash_async_macho_pool_map_section)
+#define plcrash_async_macho_pool_map_segment PLNS(plcrash_async_macho_pool_map_segment)
+#define plcrash_async_macho_section_cache_free PLNS(plcrash_async_macho_section_cache_free)
+#define plcrash_async_macho_section_cache_init PLNS(plcrash_async_macho_section_cache_init)
+#define plcrash_async_macho_section_cache_map PLNS(plcrash_async_macho_section_cache_map)
+#define plcrash_async_macho_section_cache_unmap PLNS(plcrash_async_macho_section_cache_unmap)
 #define plcrash_async_macho_string_free PLNS(plcrash_async_macho_string_free)
 #define plcrash_async_macho_string_get_length PLNS(plcrash_async_macho_string_get_length)
 #define plcrash_async_macho_string_get_pointer PLNS(plcrash_async_macho_string_get_pointer)
 #define plcrash_async_macho_string_init PLNS(plcrash_async_macho_string_init)
+#define plcrash_async_macho_string_init_borrowed PLNS(plcrash_async_macho_string_init_borrowed)
+#define plcrash_async_macho_symbol_index_size PLNS(plcrash_async_macho_symbol_index_size)
+#define plcrash_async_macho_symbol_scan_count PLNS(plcrash_async_macho_symbol_scan_count)
 #define plcrash_async_macho_symtab_reader_free PLNS(plcrash_async_macho_symtab_reader_free)
 #define plcrash_async_macho_symtab_reader_init PLNS(plcrash_async_macho_symtab_reader_init)
 #define plcrash_async_macho_symtab_reader_read PLNS(plcrash_async_macho_symtab_reader_read)
 #define plcrash_async_macho_symtab_reader_symbol_name PLNS(plcrash_async_macho_symtab_reader_symbol_name)
+#define plcrash_async_macho_uuid PLNS(plcrash_async_macho_uuid)
 #define plcrash_async_memcpy PLNS(plcrash_async_memcpy)
 #define plcrash_async_memset PLNS(plcrash_async_memset)
 #define plcrash_async_mobject_base_address PLNS(plcrash_async_mobject_base_address)
 #define plcrash_async_mobject_free PLNS(plcrash_async_mobject_free)
 #define plcrash_async_mobject_init PLNS(plcrash_async_mobject_init)
+#define plcrash_async_mobject_init_buffer PLNS(plcrash_async_mobject_init_buffer)
 #define plcrash_async_mobject_length PLNS(plcrash_async_mobject_length)
+#define plcrash_async_mobject_pool_free PLNS(plcrash_async_mobject_pool_free)
+#define plcrash_async_mobject_pool_init PLNS(plcrash_async_mobject_pool_init)
+#define plcrash_async_mobject_pool_map PLNS(plcrash_async_mobject_pool_map)
+#define plcrash_async_mobject_pool_set_direct PLNS(plcrash_async_mobject_pool_set_direct)
 #define plcrash_async_mobject_read_uint16 PLNS(plcrash_async_mobject_read_uint16)
 #define plcrash_async_mobject_read_uint32 PLNS(plcrash_async_mobject_read_uint32)
 #define plcrash_async_mobject_read_uint64 PLNS(plcrash_async_mobject_read_uint64)
 #define plcrash_async_mobject_read_uint8 PLNS(plcrash_async_mobject_read_uint8)
+#define plcrash_async_mobject_region_lookup PLNS(plcrash_async_mobject_region_lookup)
 #define plcrash_async_mobject_remap_address PLNS(plcrash_async_mobject_remap_address)
+#define plcrash_async_mobject_set_read_bounds PLNS(plcrash_async_mobject_set_read_bounds)
 #define plcrash_async_mobject_task PLNS(plcrash_async_mobject_task)
+#define plcrash_async_mobject_task_memcpy PLNS(plcrash_async_mobject_task_memcpy)
 #define plcrash_async_mobject_verify_local_pointer PLNS(plcrash_async_mobject_verify_local_pointer)
 #define plcrash_async_objc_cache_free PLNS(plcrash_async_objc_cache_free)
 #define plcrash_async_objc_cache_init PLNS(plcrash_async_objc_cache_init)
+#define plcrash_async_objc_cache_set_shared_cache_image PLNS(plcrash_async_objc_cache_set_shared_cache_image)
 #define plcrash_async_objc_find_method PLNS(plcrash_async_objc_find_method)
 #define plcrash_async_objc_isa_pointer PLNS(plcrash_async_objc_isa_pointer)
+#define plcrash_async_probes_disable PLNS(plcrash_async_probes_disable)
 #define plcrash_async_read_addr PLNS(plcrash_async_read_addr)
+#define plcrash_async_report_queue_enqueue PLNS(plcrash_async_report_queue_enqueue)
+#define plcrash_async_report_queue_path PLNS(plcrash_async_report_queue_path)
+#define plcrash_async_report_queue_summary_path PLNS(plcrash_async_report_queue_summary_path)
+#define plcrash_async_scratch_allocate PLNS(plcrash_async_scratch_allocate)
+#define plcrash_async_scratch_begin PLNS(plcrash_async_scratch_begin)
+#define plcrash_async_scratch_deallocate PLNS(plcrash_async_scratch_deallocate)
+#define plcrash_async_scratch_end PLNS(plcrash_async_scratch_end)
+#define plcrash_async_shared_cache_contains_address PLNS(plcrash_async_shared_cache_contains_address)
+#define plcrash_async_shared_cache_init PLNS(plcrash_async_shared_cache_init)
 #define plcrash_async_signal_sigcode PLNS(plcrash_async_signal_sigcode)
 #define plcrash_async_signal_signame PLNS(plcrash_async_signal_signame)
 #define plcrash_async_strcmp PLNS(plcrash_async_strcmp)
 #define plcrash_async_strerror PLNS(plcrash_async_strerror)
 #define plcrash_async_strncmp PLNS(plcrash_async_strncmp)
+#define plcrash_async_strnlen PLNS(plcrash_async_strnlen)
 #define plcrash_async_symbol_cache_free PLNS(plcrash_async_symbol_cache_free)
 #define plcrash_async_symbol_cache_init PLNS(plcrash_async_symbol_cache_init)
+#define plcrash_async_symbol_cache_reset_stats PLNS(plcrash_async_symbol_cache_reset_stats)
 #define plcrash_async_task_memcpy PLNS(plcrash_async_task_memcpy)
+#define plcrash_async_task_memcpy_batch PLNS(plcrash_async_task_memcpy_batch)
 #define plcrash_async_task_read_uint16 PLNS(plcrash_async_task_read_uint16)
 #define plcrash_async_task_read_uint32 PLNS(plcrash_async_task_read_uint32)
 #define plcrash_async_task_read_uint64 PLNS(plcrash_async_task_read_uint64)
@@ -235,27 +321,127 @@
 #define plcrash_async_thread_state_map_dwarf_to_reg PLNS(plcrash_async_thread_state_map_dwarf_to_reg)
 #define plcrash_async_thread_state_map_reg_to_dwarf PLNS(plcrash_async_thread_state_map_reg_to_dwarf)
 #define plcrash_async_thread_state_mcontext_init PLNS(plcrash_async_thread_state_mcontext_init)
+#define plcrash_async_thread_state_select_reg_table PLNS(plcrash_async_thread_state_select_reg_table)
 #define plcrash_async_thread_state_set_reg PLNS(plcrash_async_thread_state_set_reg)
+#define plcrash_async_utf8_strlen PLNS(plcrash_async_utf8_strlen)
 #define plcrash_async_writen PLNS(plcrash_async_writen)
+#define plcrash_async_writevn PLNS(plcrash_async_writevn)
+#define plcrash_log_writer_baseline_reset PLNS(plcrash_log_writer_baseline_reset)
 #define plcrash_log_writer_close PLNS(plcrash_log_writer_close)
+#define plcrash_log_writer_collapse_repeat PLNS(plcrash_log_writer_collapse_repeat)
+#define plcrash_log_writer_enable_persistent_symbol_cache PLNS(plcrash_log_writer_enable_persistent_symbol_cache)
+#define plcrash_log_writer_enable_symbol_names PLNS(plcrash_log_writer_enable_symbol_names)
 #define plcrash_log_writer_free PLNS(plcrash_log_writer_free)
 #define plcrash_log_writer_init PLNS(plcrash_log_writer_init)
+#define plcrash_log_writer_nasync_encode_binary_image PLNS(plcrash_log_writer_nasync_encode_binary_image)
+#define plcrash_log_writer_nasync_refresh_host_snapshot PLNS(plcrash_log_writer_nasync_refresh_host_snapshot)
+#define plcrash_log_writer_nasync_set_target_task PLNS(plcrash_log_writer_nasync_set_target_task)
+#define plcrash_log_writer_nasync_set_unwind_workers PLNS(plcrash_log_writer_nasync_set_unwind_workers)
+#define plcrash_log_writer_reset PLNS(plcrash_log_writer_reset)
+#define plcrash_log_writer_set_all_thread_registers PLNS(plcrash_log_writer_set_all_thread_registers)
+#define plcrash_log_writer_set_baseline PLNS(plcrash_log_writer_set_baseline)
+#define plcrash_log_writer_set_budget PLNS(plcrash_log_writer_set_budget)
+#define plcrash_log_writer_set_compressor PLNS(plcrash_log_writer_set_compressor)
+#define plcrash_log_writer_set_custom_data PLNS(plcrash_log_writer_set_custom_data)
 #define plcrash_log_writer_set_exception PLNS(plcrash_log_writer_set_exception)
+#define plcrash_log_writer_set_memory_statistics PLNS(plcrash_log_writer_set_memory_statistics)
+#define plcrash_log_writer_set_packed_threads PLNS(plcrash_log_writer_set_packed_threads)
+#define plcrash_log_writer_set_prioritize_threads PLNS(plcrash_log_writer_set_prioritize_threads)
+#define plcrash_log_writer_set_raw_capture PLNS(plcrash_log_writer_set_raw_capture)
+#define plcrash_log_writer_set_referenced_images_only PLNS(plcrash_log_writer_set_referenced_images_only)
+#define plcrash_log_writer_set_snapshot_threads PLNS(plcrash_log_writer_set_snapshot_threads)
+#define plcrash_log_writer_set_stack_capture PLNS(plcrash_log_writer_set_stack_capture)
+#define plcrash_log_writer_set_stack_sampler PLNS(plcrash_log_writer_set_stack_sampler)
+#define plcrash_log_writer_set_symbolicated_thread_names PLNS(plcrash_log_writer_set_symbolicated_thread_names)
+#define plcrash_log_writer_set_symbolicated_threads PLNS(plcrash_log_writer_set_symbolicated_threads)
+#define plcrash_log_writer_set_symbolication_diagnostics PLNS(plcrash_log_writer_set_symbolication_diagnostics)
+#define plcrash_log_writer_set_symbolication_scope PLNS(plcrash_log_writer_set_symbolication_scope)
+#define plcrash_log_writer_set_thread_metadata PLNS(plcrash_log_writer_set_thread_metadata)
+#define plcrash_log_writer_set_writer_diagnostics PLNS(plcrash_log_writer_set_writer_diagnostics)
 #define plcrash_log_writer_write PLNS(plcrash_log_writer_write)
+#define plcrash_log_writer_write_summary PLNS(plcrash_log_writer_write_summary)
+#define plcrash_mach_exception_forward_table_forward PLNS(plcrash_mach_exception_forward_table_forward)
+#define plcrash_mach_exception_forward_table_init PLNS(plcrash_mach_exception_forward_table_init)
+#define plcrash_nasync_arena_free PLNS(plcrash_nasync_arena_free)
+#define plcrash_nasync_arena_init PLNS(plcrash_nasync_arena_init)
 #define plcrash_nasync_image_list_append PLNS(plcrash_nasync_image_list_append)
+#define plcrash_nasync_image_list_append_batch PLNS(plcrash_nasync_image_list_append_batch)
+#define plcrash_nasync_image_list_append_local PLNS(plcrash_nasync_image_list_append_local)
+#define plcrash_nasync_image_list_append_task_images PLNS(plcrash_nasync_image_list_append_task_images)
+#define plcrash_nasync_image_list_build_function_starts PLNS(plcrash_nasync_image_list_build_function_starts)
+#define plcrash_nasync_image_list_build_symbol_indexes PLNS(plcrash_nasync_image_list_build_symbol_indexes)
+#define plcrash_nasync_image_list_count PLNS(plcrash_nasync_image_list_count)
+#define plcrash_nasync_image_list_defer_append PLNS(plcrash_nasync_image_list_defer_append)
+#define plcrash_nasync_image_list_flush_deferred PLNS(plcrash_nasync_image_list_flush_deferred)
 #define plcrash_nasync_image_list_free PLNS(plcrash_nasync_image_list_free)
 #define plcrash_nasync_image_list_init PLNS(plcrash_nasync_image_list_init)
+#define plcrash_nasync_image_list_parse_images PLNS(plcrash_nasync_image_list_parse_images)
 #define plcrash_nasync_image_list_remove PLNS(plcrash_nasync_image_list_remove)
+#define plcrash_nasync_image_list_remove_batch PLNS(plcrash_nasync_image_list_remove_batch)
+#define plcrash_nasync_image_list_set_deferred PLNS(plcrash_nasync_image_list_set_deferred)
+#define plcrash_nasync_image_list_set_encoder PLNS(plcrash_nasync_image_list_set_encoder)
+#define plcrash_nasync_image_list_set_lazy_parsing PLNS(plcrash_nasync_image_list_set_lazy_parsing)
+#define plcrash_nasync_image_list_set_shared_cache PLNS(plcrash_nasync_image_list_set_shared_cache)
+#define plcrash_nasync_image_list_set_symbol_indexing PLNS(plcrash_nasync_image_list_set_symbol_indexing)
+#define plcrash_nasync_image_list_sync_task_images PLNS(plcrash_nasync_image_list_sync_task_images)
+#define plcrash_nasync_lz_decode PLNS(plcrash_nasync_lz_decode)
+#define plcrash_nasync_lz_decoded_length PLNS(plcrash_nasync_lz_decoded_length)
+#define plcrash_nasync_macho_build_function_starts PLNS(plcrash_nasync_macho_build_function_starts)
+#define plcrash_nasync_macho_build_symbol_index PLNS(plcrash_nasync_macho_build_symbol_index)
 #define plcrash_nasync_macho_free PLNS(plcrash_nasync_macho_free)
 #define plcrash_nasync_macho_init PLNS(plcrash_nasync_macho_init)
+#define plcrash_nasync_macho_load_symbol_index PLNS(plcrash_nasync_macho_load_symbol_index)
+#define plcrash_nasync_macho_release_load_commands PLNS(plcrash_nasync_macho_release_load_commands)
+#define plcrash_nasync_macho_write_symbol_index PLNS(plcrash_nasync_macho_write_symbol_index)
+#define plcrash_nasync_prefault PLNS(plcrash_nasync_prefault)
+#define plcrash_nasync_probes_live_begin PLNS(plcrash_nasync_probes_live_begin)
+#define plcrash_nasync_probes_live_end PLNS(plcrash_nasync_probes_live_end)
+#define plcrash_nasync_report_queue_entries PLNS(plcrash_nasync_report_queue_entries)
+#define plcrash_nasync_report_queue_free PLNS(plcrash_nasync_report_queue_free)
+#define plcrash_nasync_report_queue_init PLNS(plcrash_nasync_report_queue_init)
+#define plcrash_nasync_report_queue_purge PLNS(plcrash_nasync_report_queue_purge)
+#define plcrash_nasync_scratch_set_arena PLNS(plcrash_nasync_scratch_set_arena)
 #define plcrash_populate_error PLNS(plcrash_populate_error)
 #define plcrash_populate_mach_error PLNS(plcrash_populate_mach_error)
 #define plcrash_populate_posix_error PLNS(plcrash_populate_posix_error)
+#define plcrash_probe_live PLNS(plcrash_probe_live)
+#define plcrash_probe_log PLNS(plcrash_probe_log)
+#define plcrash_report_stream_init PLNS(plcrash_report_stream_init)
+#define plcrash_report_stream_next PLNS(plcrash_report_stream_next)
+#define plcrash_report_stream_truncated PLNS(plcrash_report_stream_truncated)
+#define plcrash_signal_address_table_contains PLNS(plcrash_signal_address_table_contains)
+#define plcrash_signal_address_table_filter PLNS(plcrash_signal_address_table_filter)
+#define plcrash_signal_address_table_init PLNS(plcrash_signal_address_table_init)
+#define plcrash_stack_sampler_free PLNS(plcrash_stack_sampler_free)
+#define plcrash_stack_sampler_init PLNS(plcrash_stack_sampler_init)
+#define plcrash_stack_sampler_lock PLNS(plcrash_stack_sampler_lock)
+#define plcrash_stack_sampler_sample PLNS(plcrash_stack_sampler_sample)
+#define plcrash_stack_sampler_start PLNS(plcrash_stack_sampler_start)
+#define plcrash_stack_sampler_stop PLNS(plcrash_stack_sampler_stop)
+#define plcrash_stack_sampler_unlock PLNS(plcrash_stack_sampler_unlock)
 #define plcrash_sysctl_int PLNS(plcrash_sysctl_int)
 #define plcrash_sysctl_string PLNS(plcrash_sysctl_string)
 #define plcrash_sysctl_valid_utf8_bytes PLNS(plcrash_sysctl_valid_utf8_bytes)
 #define plcrash_sysctl_valid_utf8_bytes_max PLNS(plcrash_sysctl_valid_utf8_bytes_max)
+#define plcrash_text_buffer_append PLNS(plcrash_text_buffer_append)
+#define plcrash_text_buffer_append_alternate_hex PLNS(plcrash_text_buffer_append_alternate_hex)
+#define plcrash_text_buffer_append_cstring PLNS(plcrash_text_buffer_append_cstring)
+#define plcrash_text_buffer_append_decimal PLNS(plcrash_text_buffer_append_decimal)
+#define plcrash_text_buffer_append_hex PLNS(plcrash_text_buffer_append_hex)
+#define plcrash_text_buffer_append_last_path_component PLNS(plcrash_text_buffer_append_last_path_component)
+#define plcrash_text_buffer_append_padding PLNS(plcrash_text_buffer_append_padding)
+#define plcrash_text_buffer_append_string PLNS(plcrash_text_buffer_append_string)
+#define plcrash_text_buffer_append_unsigned PLNS(plcrash_text_buffer_append_unsigned)
+#define plcrash_text_buffer_flush PLNS(plcrash_text_buffer_flush)
+#define plcrash_text_buffer_free PLNS(plcrash_text_buffer_free)
+#define plcrash_text_buffer_init PLNS(plcrash_text_buffer_init)
+#define plcrash_text_buffer_reserve PLNS(plcrash_text_buffer_reserve)
 #define plcrash_writer_pack PLNS(plcrash_writer_pack)
+#define plcrash_writer_pack_commit PLNS(plcrash_writer_pack_commit)
+#define plcrash_writer_pack_packed PLNS(plcrash_writer_pack_packed)
+#define plcrash_writer_pack_reserve PLNS(plcrash_writer_pack_reserve)
+#define plframe_async_dwarf_fde_index_size PLNS(plframe_async_dwarf_fde_index_size)
+#define plframe_compact_unwind_cache_free PLNS(plframe_compact_unwind_cache_free)
 #define plframe_cursor_free PLNS(plframe_cursor_free)
 #define plframe_cursor_get_reg PLNS(plframe_cursor_get_reg)
 #define plframe_cursor_get_regcount PLNS(plframe_cursor_get_regcount)
@@ -265,11 +451,23 @@
 #define plframe_cursor_next_with_readers PLNS(plframe_cursor_next_with_readers)
 #define plframe_cursor_read_compact_unwind PLNS(plframe_cursor_read_compact_unwind)
 #define plframe_cursor_read_dwarf_unwind PLNS(plframe_cursor_read_dwarf_unwind)
+#define plframe_cursor_read_dwarf_unwind_fde PLNS(plframe_cursor_read_dwarf_unwind_fde)
 #define plframe_cursor_read_frame_ptr PLNS(plframe_cursor_read_frame_ptr)
+#define plframe_cursor_set_unwind_cache PLNS(plframe_cursor_set_unwind_cache)
 #define plframe_cursor_thread_init PLNS(plframe_cursor_thread_init)
+#define plframe_dwarf_cache_free PLNS(plframe_dwarf_cache_free)
+#define plframe_nasync_dwarf_build_fde_index PLNS(plframe_nasync_dwarf_build_fde_index)
+#define plframe_nasync_dwarf_build_fde_indexes PLNS(plframe_nasync_dwarf_build_fde_indexes)
 #define plframe_strerror PLNS(plframe_strerror)
 #define plframe_test_thread_spawn PLNS(plframe_test_thread_spawn)
 #define plframe_test_thread_stop PLNS(plframe_test_thread_stop)
+#define plframe_unwind_cache_free PLNS(plframe_unwind_cache_free)
+#define plframe_unwind_cache_init PLNS(plframe_unwind_cache_init)
+#define plframe_unwind_cache_map_stack PLNS(plframe_unwind_cache_map_stack)
+#define plframe_unwind_cache_sections PLNS(plframe_unwind_cache_sections)
+#define plframe_unwind_cache_set_stack PLNS(plframe_unwind_cache_set_stack)
+#define plframe_unwind_cache_stack PLNS(plframe_unwind_cache_stack)
+#define plframe_walk_captured_stack PLNS(plframe_walk_captured_stack)
 
 #endif
 
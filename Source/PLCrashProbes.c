@@ -0,0 +1,95 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "PLCrashProbes.h"
+
+#include <libkern/OSAtomic.h>
+
+#if PLCRASH_FEATURE_PROBES
+#include <dispatch/dispatch.h>
+#endif
+
+/**
+ * @internal
+ * @ingroup plcrash_internal
+ * @defgroup plcrash_probes Live Report Probes
+ *
+ * Optional os_signpost probes covering the frame walker, symbol look-ups, memory object mappings and each section of
+ * the report writer. The probes are compiled out entirely unless PLCRASH_FEATURE_PROBES is enabled, and only fire
+ * while a live report is being written; they are never emitted from a crash handler.
+ * @{
+ */
+
+#if PLCRASH_FEATURE_PROBES
+os_log_t plcrash_probe_log = NULL;
+volatile int32_t plcrash_probe_live = 0;
+#endif
+
+/**
+ * Enable probes for the duration of a live report. Must be balanced by a call to plcrash_nasync_probes_live_end().
+ *
+ * This function is not async-safe; the probe log handle is created on first use.
+ */
+void plcrash_nasync_probes_live_begin (void) {
+#if PLCRASH_FEATURE_PROBES
+    if (__builtin_available(macOS 10.14, iOS 12.0, tvOS 12.0, *)) {
+        static dispatch_once_t onceToken;
+        dispatch_once(&onceToken, ^{
+            plcrash_probe_log = os_log_create("com.plausiblelabs.crashreporter", "probes");
+        });
+
+        OSAtomicIncrement32Barrier(&plcrash_probe_live);
+    }
+#endif
+}
+
+/**
+ * Disable the probes enabled by a prior call to plcrash_nasync_probes_live_begin().
+ */
+void plcrash_nasync_probes_live_end (void) {
+#if PLCRASH_FEATURE_PROBES
+    if (plcrash_probe_log != NULL && plcrash_probe_live > 0)
+        OSAtomicDecrement32Barrier(&plcrash_probe_live);
+#endif
+}
+
+/**
+ * Unconditionally disable all probes. This is called on entry to the crash handlers, ensuring that a crash occurring
+ * while a live report is being written does not emit probes from the crash path.
+ *
+ * This function is async-safe.
+ */
+void plcrash_async_probes_disable (void) {
+#if PLCRASH_FEATURE_PROBES
+    plcrash_probe_live = 0;
+#endif
+}
+
+/**
+ * @}
+ */
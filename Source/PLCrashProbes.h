@@ -0,0 +1,102 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PLCRASH_PROBES_H
+#define PLCRASH_PROBES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "PLCrashFeatureConfig.h"
+
+#if PLCRASH_FEATURE_PROBES
+#include <os/log.h>
+#include <os/signpost.h>
+#endif
+
+/**
+ * @internal
+ * @ingroup plcrash_probes
+ * @{
+ */
+
+#if PLCRASH_FEATURE_PROBES
+
+/** The log handle to which probe signposts are emitted, or NULL if signposts are unavailable. */
+extern os_log_t plcrash_probe_log;
+
+/** The number of live reports currently being written; probes only fire while this is non-zero. */
+extern volatile int32_t plcrash_probe_live;
+
+/* The signpost functions are weakly linked on older deployment targets; plcrash_probe_live is only ever non-zero
+ * once plcrash_probe_log has been created, which implies their availability. */
+#define PLCR_PROBE_SIGNPOST(emit, name, ...) do { \
+    if (plcrash_probe_live > 0) { \
+        _Pragma("clang diagnostic push") \
+        _Pragma("clang diagnostic ignored \"-Wunguarded-availability\"") \
+        emit(plcrash_probe_log, OS_SIGNPOST_ID_EXCLUSIVE, name, __VA_ARGS__); \
+        _Pragma("clang diagnostic pop") \
+    } \
+} while (0)
+
+/**
+ * Emit a signpost event named @a name, with the given os_log format string and arguments. The name and format must
+ * be string literals.
+ */
+#define PLCR_PROBE_EVENT(name, ...) PLCR_PROBE_SIGNPOST(os_signpost_event_emit, name, __VA_ARGS__)
+
+/** Begin a signpost interval named @a name. */
+#define PLCR_PROBE_BEGIN(name, ...) PLCR_PROBE_SIGNPOST(os_signpost_interval_begin, name, __VA_ARGS__)
+
+/** End a signpost interval named @a name. */
+#define PLCR_PROBE_END(name, ...) PLCR_PROBE_SIGNPOST(os_signpost_interval_end, name, __VA_ARGS__)
+
+#else
+
+#define PLCR_PROBE_EVENT(name, ...) do {} while (0)
+#define PLCR_PROBE_BEGIN(name, ...) do {} while (0)
+#define PLCR_PROBE_END(name, ...) do {} while (0)
+
+#endif /* PLCRASH_FEATURE_PROBES */
+
+void plcrash_nasync_probes_live_begin (void);
+void plcrash_nasync_probes_live_end (void);
+void plcrash_async_probes_disable (void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PLCRASH_PROBES_H */
@@ -30,15 +30,21 @@
 
 #import "PLCrashReportApplicationInfo.h"
 #import "PLCrashReportBinaryImageInfo.h"
+#import "PLCrashReportBreadcrumb.h"
 #import "PLCrashReportExceptionInfo.h"
 #import "PLCrashReportMachineInfo.h"
 #import "PLCrashReportMachExceptionInfo.h"
+#import "PLCrashReportMemoryStatistics.h"
 #import "PLCrashReportProcessInfo.h"
 #import "PLCrashReportProcessorInfo.h"
 #import "PLCrashReportRegisterInfo.h"
 #import "PLCrashReportSignalInfo.h"
+#import "PLCrashReportSummary.h"
 #import "PLCrashReportStackFrameInfo.h"
 #import "PLCrashReportSymbolInfo.h"
+#import "PLCrashReportSymbolicationDiagnostics.h"
+#import "PLCrashReportStackSamples.h"
+#import "PLCrashReportWriterDiagnostics.h"
 #import "PLCrashReportSystemInfo.h"
 #import "PLCrashReportThreadInfo.h"
 
@@ -53,6 +59,28 @@
  * an entirely new crash log format. */
 #define PLCRASH_REPORT_FILE_VERSION 1
 
+/**
+ * @ingroup constants
+ * Compressed crash format version byte identifier. Reports using this version are encoded
+ * identically to #PLCRASH_REPORT_FILE_VERSION reports, but the report data following the file
+ * header is LZ-compressed. */
+#define PLCRASH_REPORT_FILE_VERSION_COMPRESSED 2
+
+/**
+ * @ingroup constants
+ * Symbol name table crash format version byte identifier. Reports using this version are encoded
+ * identically to #PLCRASH_REPORT_FILE_VERSION reports, but symbols may refer to their names via the
+ * report's symbol_names table rather than including the (previously required) name inline. Readers
+ * that predate the table reject this version as unsupported. */
+#define PLCRASH_REPORT_FILE_VERSION_SYMBOL_NAMES 3
+
+/**
+ * @ingroup constants
+ * Compressed symbol name table crash format version byte identifier. Reports using this version are
+ * encoded identically to #PLCRASH_REPORT_FILE_VERSION_SYMBOL_NAMES reports, but the report data following
+ * the file header is LZ-compressed. */
+#define PLCRASH_REPORT_FILE_VERSION_SYMBOL_NAMES_COMPRESSED 4
+
 /**
  * @ingroup types
  * Crash log file header format.
@@ -74,6 +102,31 @@ struct PLCrashReportFileHeader {
 } __attribute__((packed));
 
 
+/**
+ * @ingroup enums
+ * Options controlling the decoding of a PLCrashReport.
+ */
+typedef NS_OPTIONS(NSUInteger, PLCrashReportDecodingOptions) {
+    /** Decode all report data at initialization time. */
+    PLCrashReportDecodingOptionNone = 0,
+
+    /**
+     * Defer decoding of the thread and binary image records until the PLCrashReport::threads or
+     * PLCrashReport::images properties are first accessed. Only the presence of thread and image records is
+     * validated at initialization time; if the deferred records can not be decoded, the corresponding
+     * property will return nil.
+     */
+    PLCrashReportDecodingOptionLazy = 1 << 0,
+
+    /**
+     * Store all decoded stack frames in a single contiguous buffer, sharing symbol names referenced from the
+     * report's symbol name table. PLCrashReportThreadInfo::stackFrames returns an array whose
+     * PLCrashReportStackFrameInfo instances are created on first access, substantially reducing the decoding
+     * cost and memory footprint of reports with many threads.
+     */
+    PLCrashReportDecodingOptionCompact = 1 << 1,
+};
+
 /**
  * @internal
  * Private decoder instance variables (used to hide the underlying protobuf parser).
@@ -112,11 +165,54 @@ typedef struct _PLCrashReportDecoder _PLCrashReportDecoder;
     /** Exception information (may be nil) */
     PLCrashReportExceptionInfo *_exceptionInfo;
 
+    /** Symbolication diagnostics (may be nil) */
+    PLCrashReportSymbolicationDiagnostics *_symbolicationDiagnostics;
+
+    /** Stack samples (may be nil) */
+    PLCrashReportStackSamples *_stackSamples;
+
+    /** Writer diagnostics (may be nil) */
+    PLCrashReportWriterDiagnostics *_writerDiagnostics;
+
+    /** Application-supplied key/value pairs (may be nil) */
+    NSDictionary *_customData;
+
+    /** Application-supplied breadcrumbs (PLCrashReportBreadcrumb instances; may be nil) */
+    NSArray *_breadcrumbs;
+
+    /** Memory statistics (may be nil) */
+    PLCrashReportMemoryStatistics *_memoryStatistics;
+
+    /** Number of binary images omitted from the report */
+    NSUInteger _omittedImageCount;
+
+    /** Combined hash of the omitted binary images */
+    uint64_t _omittedImageHash;
+
+    /** If YES, the report was truncated, and only its complete leading sections were decoded */
+    BOOL _truncated;
+
+    /** Crashed thread, if decoded independently of @a _threads (may be nil) */
+    PLCrashReportThreadInfo *_crashedThread;
+
+    /** Binary images sorted by base address, computed on first access (may be nil) */
+    NSArray *_sortedImages;
+
     /** Report UUID */
     CFUUIDRef _uuid;
+
+    /** The UUID of the base report of an incremental report (may be NULL) */
+    CFUUIDRef _baseReportUUID;
+
+    /** If YES, the threads and images of an incremental report have been merged with those of its base report */
+    BOOL _merged;
 }
 
 - (id) initWithData: (NSData *) encodedData error: (NSError **) outError;
+- (id) initWithData: (NSData *) encodedData options: (PLCrashReportDecodingOptions) options error: (NSError **) outError;
+- (id) initWithData: (NSData *) encodedData baseReport: (PLCrashReport *) baseReport error: (NSError **) outError;
+
++ (NSArray *) reportsWithBatchData: (NSData *) batchData options: (PLCrashReportDecodingOptions) options error: (NSError **) outError;
 
 - (PLCrashReportBinaryImageInfo *) imageForAddress: (uint64_t) address;
 
@@ -179,6 +275,40 @@ typedef struct _PLCrashReportDecoder _PLCrashReportDecoder;
  */
 @property(nonatomic, readonly) NSArray *images;
 
+/**
+ * Binary image information, sorted in ascending order by base address. The sorted list is computed once, on
+ * first access. Returns a list of PLCrashReportBinaryImageInfo instances.
+ */
+@property(nonatomic, readonly) NSArray *sortedImages;
+
+/**
+ * The number of threads in the report. This does not require decoding of the thread records.
+ */
+@property(nonatomic, readonly) NSUInteger threadCount;
+
+/**
+ * The number of binary images in the report. This does not require decoding of the image records.
+ */
+@property(nonatomic, readonly) NSUInteger imageCount;
+
+/**
+ * The thread number of the crashed thread, or -1 if no thread is marked as crashed. This does not require
+ * decoding of the thread records.
+ */
+@property(nonatomic, readonly) NSInteger crashedThreadNumber;
+
+/**
+ * The number of stack frames in the crashed thread, or 0 if no thread is marked as crashed. This does not
+ * require decoding of the thread records.
+ */
+@property(nonatomic, readonly) NSUInteger crashedThreadFrameCount;
+
+/**
+ * The crashed thread, or nil if no thread is marked as crashed. When lazy decoding is enabled, only the crashed
+ * thread's records are decoded.
+ */
+@property(nonatomic, readonly) PLCrashReportThreadInfo *crashedThread;
+
 /**
  * YES if exception information is available.
  */
@@ -190,6 +320,69 @@ typedef struct _PLCrashReportDecoder _PLCrashReportDecoder;
  */
 @property(nonatomic, readonly) PLCrashReportExceptionInfo *exceptionInfo;
 
+/**
+ * YES if symbolication diagnostics are available.
+ */
+@property(nonatomic, readonly) BOOL hasSymbolicationDiagnostics;
+
+/**
+ * Local symbolication diagnostics. Only available if the report was written with symbolication diagnostics enabled
+ * (see PLCrashReporterConfig::shouldWriteSymbolicationDiagnostics) and local symbolication was performed, otherwise
+ * nil.
+ */
+@property(nonatomic, readonly) PLCrashReportSymbolicationDiagnostics *symbolicationDiagnostics;
+
+/**
+ * Aggregated stack samples. Only available if the report was generated while stack sampling was active,
+ * otherwise nil.
+ */
+@property(nonatomic, readonly) PLCrashReportStackSamples *stackSamples;
+
+/**
+ * Crash log writer phase timing. Only available if writer diagnostics were enabled when the report was written
+ * (see PLCrashReporterConfig::shouldWriteWriterDiagnostics), otherwise nil.
+ */
+@property(nonatomic, readonly) PLCrashReportWriterDiagnostics *writerDiagnostics;
+
+/**
+ * The key/value pairs recorded in the key/value area registered via PLCrashReporter::setKeyValueArea:, as NSString
+ * keys and values. Pairs that were being modified at the time the report was written are omitted. Only available
+ * if a key/value area was registered, otherwise nil.
+ */
+@property(nonatomic, readonly) NSDictionary *customData;
+
+/**
+ * The breadcrumbs recorded in the breadcrumb buffer registered via PLCrashReporter::setBreadcrumbBuffer:, as
+ * PLCrashReportBreadcrumb instances, oldest first. Breadcrumbs that were being written at the time the report was
+ * written are omitted. Only available if a breadcrumb buffer was registered, otherwise nil.
+ */
+@property(nonatomic, readonly) NSArray *breadcrumbs;
+
+/**
+ * The process' memory statistics at the time the report was written. Only available if the report was written with
+ * memory statistics capture enabled (see PLCrashReporterConfig::shouldCaptureMemoryStatistics), otherwise nil.
+ */
+@property(nonatomic, readonly) PLCrashReportMemoryStatistics *memoryStatistics;
+
+/**
+ * The number of loaded binary images that were not referenced by any captured frame, and were omitted from
+ * the report's images. Will be 0 if all images were written.
+ */
+@property(nonatomic, readonly) NSUInteger omittedImageCount;
+
+/**
+ * The combined hash of the omitted binary images, or 0 if no images were omitted. This may be used to compare
+ * the set of images loaded by processes that generated reports with omitted images.
+ */
+@property(nonatomic, readonly) uint64_t omittedImageHash;
+
+/**
+ * YES if the report was truncated while it was being written (for example, if the process was terminated before
+ * the report was complete), and only the report sections preceding the truncation point were decoded. Reports
+ * written with crashed thread prioritization retain the crashed thread when truncated in this way.
+ */
+@property(nonatomic, readonly) BOOL truncated;
+
 /**
  * A client-generated 16-byte UUID. May be used to filter duplicate reports submitted or generated
  * by a single client. Only available in later (v1.2+) crash report format versions. If not available,
@@ -197,4 +390,12 @@ typedef struct _PLCrashReportDecoder _PLCrashReportDecoder;
  */
 @property(nonatomic, readonly) CFUUIDRef uuidRef;
 
+/**
+ * If this is an incremental live report, the UUID of the base report against which it was written; otherwise, NULL.
+ * An incremental report contains only the crashed thread, the threads whose stacks changed since the base report
+ * was written, and the binary images that were not included in the base report. Use
+ * PLCrashReport::initWithData:baseReport:error: to merge an incremental report with its base report.
+ */
+@property(nonatomic, readonly) CFUUIDRef baseReportUUIDRef;
+
 @end
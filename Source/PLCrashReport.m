@@ -30,9 +30,91 @@
 #import "CrashReporter.h"
 
 #import "crash_report.pb-c.h"
+#import "PLCrashAsyncLZ.h"
+#import "PLCrashReportFrameStorage.h"
+#import "PLCrashReportBatch.h"
+#import "PLCrashFrameWalker.h"
+
+/**
+ * @internal
+ * The minimum size of a decoding arena chunk, in bytes.
+ */
+#define PLCRASH_REPORT_ARENA_MIN_CHUNK_SIZE 4096
+
+/**
+ * @internal
+ * The expected ratio of unpacked to encoded report size, used to size the initial decoding arena chunk. Unpacked
+ * messages carry a descriptor and unknown-field header, and repeated fields an additional pointer array, so the
+ * unpacked representation of a frame or register is several times its encoded size.
+ */
+#define PLCRASH_REPORT_ARENA_EXPANSION_FACTOR 4
+
+/**
+ * @internal
+ * The maximum number of frames that will be recovered from a raw capture thread's stack memory.
+ */
+#define PLCRASH_REPORT_MAX_RAW_FRAMES 512
+
+/**
+ * @internal
+ * The maximum inflated size of a compressed report, in bytes. Reports are bounded by the crash log writer's
+ * output limits far below this; larger declared lengths are treated as invalid rather than allocated.
+ */
+#define PLCRASH_REPORT_MAX_INFLATED_LENGTH (64 * 1024 * 1024)
+
+/**
+ * @internal
+ * A decoding arena chunk.
+ */
+typedef struct plcrash_report_arena_chunk {
+    /** The previously allocated chunk, or NULL. */
+    struct plcrash_report_arena_chunk *next;
+
+    /** The size of @a data, in bytes. */
+    size_t size;
+
+    /** The number of bytes of @a data that have been allocated. */
+    size_t used;
+
+    /** Chunk data. */
+    uint8_t data[] __attribute__((aligned(16)));
+} plcrash_report_arena_chunk_t;
+
+/**
+ * @internal
+ * An address range entry in the binary image index.
+ */
+typedef struct plcrash_report_image_range {
+    /** The image's normalized base address. */
+    uint64_t base;
+
+    /** The image's normalized end address (exclusive). */
+    uint64_t end;
+
+    /** The image; retained by the report's image array. */
+    PLCrashReportBinaryImageInfo *image;
+} plcrash_report_image_range_t;
 
 struct _PLCrashReportDecoder {
     Plcrash__CrashReport *crashReport;
+
+    /** Binary image address ranges, sorted by base address, or NULL if the index has not been built. */
+    plcrash_report_image_range_t *image_index;
+
+    /** The number of entries in @a image_index. */
+    size_t image_index_count;
+
+    /** If true, thread and image records are decoded on first access. */
+    bool lazy;
+
+    /** If true, thread stack frames are decoded into contiguous PLCrashReportFrameStorage. */
+    bool compact;
+
+    /**
+     * The decoding arena, most recently allocated chunk first. All unpacked report data is allocated from the
+     * arena, and released as a whole when the decoder is freed.
+     */
+    plcrash_report_arena_chunk_t *arena;
 };
 
 @interface PLCrashReport (PrivateMethods)
@@ -46,16 +128,38 @@ struct _PLCrashReportDecoder {
 - (PLCrashReportMachineInfo *) extractMachineInfo: (Plcrash__CrashReport__MachineInfo *) machineInfo error: (NSError **) outError;
 - (PLCrashReportApplicationInfo *) extractApplicationInfo: (Plcrash__CrashReport__ApplicationInfo *) applicationInfo error: (NSError **) outError;
 - (PLCrashReportProcessInfo *) extractProcessInfo: (Plcrash__CrashReport__ProcessInfo *) processInfo error: (NSError **) outError;
+- (PLCrashReportThreadInfo *) extractThread: (Plcrash__CrashReport__Thread *) thread
+                                     storage: (PLCrashReportFrameStorage *) storage
+                                       error: (NSError **) outError;
+- (NSArray *) extractStackFrames: (Plcrash__CrashReport__Thread *) thread
+                         storage: (PLCrashReportFrameStorage *) storage
+                           error: (NSError **) outError;
+- (NSArray *) extractPackedStackFrames: (Plcrash__CrashReport__Thread *) thread
+                               storage: (PLCrashReportFrameStorage *) storage
+                                 error: (NSError **) outError;
+- (NSArray *) extractRawStackFrames: (Plcrash__CrashReport__Thread *) thread error: (NSError **) outError;
 - (NSArray *) extractThreadInfo: (Plcrash__CrashReport *) crashReport error: (NSError **) outError;
 - (NSArray *) extractImageInfo: (Plcrash__CrashReport *) crashReport error: (NSError **) outError;
 - (PLCrashReportExceptionInfo *) extractExceptionInfo: (Plcrash__CrashReport__Exception *) exceptionInfo error: (NSError **) outError;
 - (PLCrashReportSignalInfo *) extractSignalInfo: (Plcrash__CrashReport__Signal *) signalInfo error: (NSError **) outError;
 - (PLCrashReportMachExceptionInfo *) extractMachExceptionInfo: (Plcrash__CrashReport__Signal__MachException *) machExceptionInfo error: (NSError **) outError;
+- (PLCrashReportSymbolicationDiagnostics *) extractSymbolicationDiagnostics: (Plcrash__CrashReport__SymbolicationDiagnostics *) diagnostics error: (NSError **) outError;
+- (PLCrashReportStackSamples *) extractStackSamples: (Plcrash__CrashReport__StackSamples *) samples error: (NSError **) outError;
+- (PLCrashReportWriterDiagnostics *) extractWriterDiagnostics: (Plcrash__CrashReport__ReportInfo__WriterDiagnostics *) diagnostics error: (NSError **) outError;
+- (NSDictionary *) extractKeyValueArea: (ProtobufCBinaryData *) data;
+- (NSArray *) extractBreadcrumbs: (ProtobufCBinaryData *) data;
+- (PLCrashReportMemoryStatistics *) extractMemoryStatistics: (Plcrash__CrashReport__MemoryStatistics *) stats error: (NSError **) outError;
 
 @end
 
 
 static void populate_nserror (NSError **error, PLCrashReporterError code, NSString *description);
+static bool report_arena_add_chunk (_PLCrashReportDecoder *decoder, size_t size);
+static void *report_arena_alloc (void *allocator_data, size_t size);
+static void report_arena_free (void *allocator_data, void *pointer);
+static void report_arena_release (_PLCrashReportDecoder *decoder);
+static size_t report_complete_length (const uint8_t *data, size_t length);
+static size_t thread_frame_count (Plcrash__CrashReport__Thread *thread);
 
 /**
  * Provides decoding of crash logs generated by the PLCrashReporter framework.
@@ -73,11 +177,26 @@ static void populate_nserror (NSError **error, PLCrashReporterError code, NSStri
  * indicating why the crash log could not be parsed. If no error occurs, this parameter
  * will be left unmodified. You may specify NULL for this parameter, and no error information
  * will be provided.
+ */
+- (id) initWithData: (NSData *) encodedData error: (NSError **) outError {
+    return [self initWithData: encodedData options: PLCrashReportDecodingOptionNone error: outError];
+}
+
+/**
+ * Initialize with the provided crash log data and decoding options. On error, nil will be returned, and
+ * an NSError instance will be provided via @a error, if non-NULL.
+ *
+ * @param encodedData Encoded plcrash crash log.
+ * @param options The decoding options. See PLCrashReportDecodingOptions.
+ * @param outError If an error occurs, this pointer will contain an NSError object
+ * indicating why the crash log could not be parsed. If no error occurs, this parameter
+ * will be left unmodified. You may specify NULL for this parameter, and no error information
+ * will be provided.
  *
  * @par Designated Initializer
  * This method is the designated initializer for the PLCrashReport class.
  */
-- (id) initWithData: (NSData *) encodedData error: (NSError **) outError {
+- (id) initWithData: (NSData *) encodedData options: (PLCrashReportDecodingOptions) options error: (NSError **) outError {
     if ((self = [super init]) == nil) {
         // This shouldn't happen, but we have to fufill our API contract
         populate_nserror(outError, PLCrashReporterErrorUnknown, @"Could not initialize superclass");
@@ -86,8 +205,10 @@ static void populate_nserror (NSError **error, PLCrashReporterError code, NSStri
 
 
     /* Allocate the struct and attempt to parse */
-    _decoder = malloc(sizeof(_PLCrashReportDecoder));
+    _decoder = calloc(1, sizeof(_PLCrashReportDecoder));
     _decoder->crashReport = [self decodeCrashData: encodedData error: outError];
+    _decoder->lazy = (options & PLCrashReportDecodingOptionLazy) != 0;
+    _decoder->compact = (options & PLCrashReportDecodingOptionCompact) != 0;
 
     /* Check if decoding failed. If so, outError has already been populated. */
     if (_decoder->crashReport == NULL) {
@@ -111,6 +232,26 @@ static void populate_nserror (NSError **error, PLCrashReporterError code, NSStri
             memcpy(&uuid_bytes, _decoder->crashReport->report_info->uuid.data, _decoder->crashReport->report_info->uuid.len);
             _uuid = CFUUIDCreateFromUUIDBytes(NULL, uuid_bytes);
         }
+
+        /* Writer diagnostics (optional) */
+        if (_decoder->crashReport->report_info->writer_diagnostics != NULL) {
+            _writerDiagnostics = [[self extractWriterDiagnostics: _decoder->crashReport->report_info->writer_diagnostics error: outError] retain];
+            if (!_writerDiagnostics)
+                goto error;
+        }
+    }
+
+    /* Base report (optional) */
+    _baseReportUUID = NULL;
+    if (_decoder->crashReport->base_report != NULL) {
+        if (_decoder->crashReport->base_report->uuid.len != sizeof(uuid_t)) {
+            populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid, @"Base report UUID value is not a standard 16 bytes");
+            goto error;
+        }
+
+        CFUUIDBytes uuid_bytes;
+        memcpy(&uuid_bytes, _decoder->crashReport->base_report->uuid.data, _decoder->crashReport->base_report->uuid.len);
+        _baseReportUUID = CFUUIDCreateFromUUIDBytes(NULL, uuid_bytes);
     }
 
     /* Machine info */
@@ -149,15 +290,32 @@ static void populate_nserror (NSError **error, PLCrashReporterError code, NSStri
             goto error;
     }
 
-    /* Thread info */
-    _threads = [[self extractThreadInfo: _decoder->crashReport error: outError] retain];
-    if (!_threads)
-        goto error;
+    if (_decoder->lazy) {
+        /* Thread and image records are decoded on first access; only verify that they are present */
+        if (_decoder->crashReport->n_threads == 0) {
+            populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid,
+                             NSLocalizedString(@"Crash report is missing thread state information",
+                                               @"Missing thread info in crash report"));
+            goto error;
+        }
 
-    /* Image info */
-    _images = [[self extractImageInfo: _decoder->crashReport error: outError] retain];
-    if (!_images)
-        goto error;
+        if (_decoder->crashReport->n_binary_images == 0 && _decoder->crashReport->base_report == NULL) {
+            populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid,
+                             NSLocalizedString(@"Crash report is missing binary image information",
+                                               @"Missing image info in crash report"));
+            goto error;
+        }
+    } else {
+        /* Thread info */
+        _threads = [[self extractThreadInfo: _decoder->crashReport error: outError] retain];
+        if (!_threads)
+            goto error;
+
+        /* Image info */
+        _images = [[self extractImageInfo: _decoder->crashReport error: outError] retain];
+        if (!_images)
+            goto error;
+    }
 
     /* Exception info, if it is available */
     if (_decoder->crashReport->exception != NULL) {
@@ -166,6 +324,43 @@ static void populate_nserror (NSError **error, PLCrashReporterError code, NSStri
             goto error;
     }
 
+    /* Symbolication diagnostics, if available */
+    if (_decoder->crashReport->symbolication_diagnostics != NULL) {
+        _symbolicationDiagnostics = [[self extractSymbolicationDiagnostics: _decoder->crashReport->symbolication_diagnostics error: outError] retain];
+        if (!_symbolicationDiagnostics)
+            goto error;
+    }
+
+    /* Stack samples, if available */
+    if (_decoder->crashReport->stack_samples != NULL) {
+        _stackSamples = [[self extractStackSamples: _decoder->crashReport->stack_samples error: outError] retain];
+        if (!_stackSamples)
+            goto error;
+    }
+
+    /* Custom data, if available. The regions are copied verbatim from application memory at crash time; malformed
+     * regions are ignored rather than rejecting the report. */
+    if (_decoder->crashReport->custom_data != NULL) {
+        Plcrash__CrashReport__CustomData *custom = _decoder->crashReport->custom_data;
+        if (custom->has_key_value_area)
+            _customData = [[self extractKeyValueArea: &custom->key_value_area] retain];
+        if (custom->has_breadcrumbs)
+            _breadcrumbs = [[self extractBreadcrumbs: &custom->breadcrumbs] retain];
+    }
+
+    /* Memory statistics, if available */
+    if (_decoder->crashReport->memory_statistics != NULL) {
+        _memoryStatistics = [[self extractMemoryStatistics: _decoder->crashReport->memory_statistics error: outError] retain];
+        if (!_memoryStatistics)
+            goto error;
+    }
+
+    /* Omitted image summary, if available */
+    if (_decoder->crashReport->has_omitted_image_count)
+        _omittedImageCount = _decoder->crashReport->omitted_image_count;
+    if (_decoder->crashReport->has_omitted_image_hash)
+        _omittedImageHash = _decoder->crashReport->omitted_image_hash;
+
     return self;
 
 error:
@@ -173,6 +368,114 @@ error:
     return nil;
 }
 
+/**
+ * Initialize with the provided crash log data, merging an incremental report with the base report against which it
+ * was written. Threads omitted from the incremental report, as their stacks were unchanged, and binary images written
+ * to the base report, are taken from @a baseReport. On error, nil will be returned, and an NSError instance will be
+ * provided via @a error, if non-NULL.
+ *
+ * If @a encodedData is not an incremental report, it is decoded as-is, and @a baseReport is ignored.
+ *
+ * @param encodedData Encoded plcrash crash log.
+ * @param baseReport The base report, as identified by the incremental report's PLCrashReport::baseReportUUIDRef.
+ * @param outError If an error occurs, this pointer will contain an NSError object
+ * indicating why the crash log could not be parsed or merged. If no error occurs, this parameter
+ * will be left unmodified. You may specify NULL for this parameter, and no error information
+ * will be provided.
+ */
+- (id) initWithData: (NSData *) encodedData baseReport: (PLCrashReport *) baseReport error: (NSError **) outError {
+    if ((self = [self initWithData: encodedData options: PLCrashReportDecodingOptionNone error: outError]) == nil)
+        return nil;
+
+    if (_baseReportUUID == NULL)
+        return self;
+
+    if (baseReport == nil || baseReport.uuidRef == NULL || !CFEqual(_baseReportUUID, baseReport.uuidRef)) {
+        populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid, @"The base report does not match the incremental report's base report UUID");
+        [self release];
+        return nil;
+    }
+
+    /* Threads numbered beyond the incremental report's thread count no longer exist */
+    NSInteger threadCount = _decoder->crashReport->base_report->thread_count;
+    NSMutableIndexSet *written = [NSMutableIndexSet indexSet];
+    for (PLCrashReportThreadInfo *thread in _threads)
+        [written addIndex: thread.threadNumber];
+
+    NSMutableArray *threads = [NSMutableArray arrayWithArray: _threads];
+    for (PLCrashReportThreadInfo *thread in baseReport.threads) {
+        if (thread.threadNumber >= threadCount || [written containsIndex: thread.threadNumber])
+            continue;
+
+        /* The incremental report's crashed thread supersedes that of the base report */
+        if (thread.crashed) {
+            thread = [[[PLCrashReportThreadInfo alloc] initWithThreadNumber: thread.threadNumber
+                                                                stackFrames: thread.stackFrames
+                                                                    crashed: NO
+                                                                  registers: [NSArray array]
+                                                           threadIdentifier: thread.threadIdentifier
+                                                                       name: thread.name
+                                                         dispatchQueueLabel: thread.dispatchQueueLabel
+                                                                   qosClass: thread.qosClass
+                                                                 hasCPUTime: thread.hasCPUTime
+                                                                   userTime: thread.userTime
+                                                                 systemTime: thread.systemTime] autorelease];
+        }
+
+        [threads addObject: thread];
+    }
+
+    [threads sortWithOptions: NSSortStable usingComparator: ^NSComparisonResult (id lhs, id rhs) {
+        NSInteger lhsNumber = [(PLCrashReportThreadInfo *) lhs threadNumber];
+        NSInteger rhsNumber = [(PLCrashReportThreadInfo *) rhs threadNumber];
+        if (lhsNumber < rhsNumber)
+            return NSOrderedAscending;
+        else if (lhsNumber > rhsNumber)
+            return NSOrderedDescending;
+        return NSOrderedSame;
+    }];
+
+    [_threads release];
+    _threads = [threads copy];
+
+    NSArray *images = [baseReport.images arrayByAddingObjectsFromArray: _images];
+    [_images release];
+    _images = [images retain];
+
+    _merged = YES;
+    return self;
+}
+
+/**
+ * Decode all reports in a batch container, as created by PLCrashReporter::loadQueuedCrashReportBatch:compress:error:.
+ * On error, nil will be returned, and an NSError instance will be provided via @a error, if non-NULL.
+ *
+ * @param batchData The encoded batch container.
+ * @param options The options used to decode each report.
+ * @param outError If an error occurs, this pointer will contain an NSError object
+ * indicating why the batch, or one of its reports, could not be parsed. If no error occurs, this parameter
+ * will be left unmodified. You may specify NULL for this parameter, and no error information
+ * will be provided.
+ *
+ * @return Returns the decoded PLCrashReport instances, in queue order.
+ */
++ (NSArray *) reportsWithBatchData: (NSData *) batchData options: (PLCrashReportDecodingOptions) options error: (NSError **) outError {
+    PLCrashReportBatch *batch = [[[PLCrashReportBatch alloc] initWithData: batchData error: outError] autorelease];
+    if (batch == nil)
+        return nil;
+
+    NSMutableArray *reports = [NSMutableArray arrayWithCapacity: batch.count];
+    for (NSUInteger i = 0; i < batch.count; i++) {
+        PLCrashReport *report = [[[PLCrashReport alloc] initWithData: [batch reportDataAtIndex: i] options: options error: outError] autorelease];
+        if (report == nil)
+            return nil;
+
+        [reports addObject: report];
+    }
+
+    return reports;
+}
+
 - (void) dealloc {
     /* Free the data objects */
     [_systemInfo release];
@@ -184,15 +487,29 @@ error:
     [_threads release];
     [_images release];
     [_exceptionInfo release];
+    [_symbolicationDiagnostics release];
+    [_stackSamples release];
+    [_writerDiagnostics release];
+    [_customData release];
+    [_breadcrumbs release];
+    [_memoryStatistics release];
+    [_crashedThread release];
+    [_sortedImages release];
     
     if (_uuid != NULL)
         CFRelease(_uuid);
 
+    if (_baseReportUUID != NULL)
+        CFRelease(_baseReportUUID);
+
     /* Free the decoder state */
     if (_decoder != NULL) {
-        if (_decoder->crashReport != NULL) {
-            protobuf_c_message_free_unpacked((ProtobufCMessage *) _decoder->crashReport, NULL);
-        }
+        /* The unpacked report is allocated from the arena */
+        report_arena_release(_decoder);
+        _decoder->crashReport = NULL;
+
+        if (_decoder->image_index != NULL)
+            free(_decoder->image_index);
 
         free(_decoder);
         _decoder = NULL;
@@ -203,22 +520,205 @@ error:
 
 /**
  * Return the binary image containing the given address, or nil if no binary image
- * is found.
+ * is found. An address-sorted index of the report's images is built on first use.
  *
  * @param address The address to search for.
  */
 - (PLCrashReportBinaryImageInfo *) imageForAddress: (uint64_t) address {
-    for (PLCrashReportBinaryImageInfo *imageInfo in self.images) {
+    plcrash_report_image_range_t *index;
+    size_t count;
+
+    /* Build the image index on first use */
+    @synchronized (self) {
+        if (_decoder->image_index == NULL)
+            [self buildImageIndex];
+
+        index = _decoder->image_index;
+        count = _decoder->image_index_count;
+    }
+
+    /* Find the last image with a base address <= address */
+    size_t lower = 0;
+    size_t upper = count;
+    while (lower < upper) {
+        size_t mid = lower + (upper - lower) / 2;
+        if (index[mid].base <= address)
+            lower = mid + 1;
+        else
+            upper = mid;
+    }
+
+    if (lower > 0 && address < index[lower - 1].end)
+        return index[lower - 1].image;
+
+    /* Not found */
+    return nil;
+}
+
+/**
+ * @internal
+ * Comparison function used to sort the image index by base address.
+ */
+static int image_range_compare (const void *lhs, const void *rhs) {
+    const plcrash_report_image_range_t *l = lhs;
+    const plcrash_report_image_range_t *r = rhs;
+
+    if (l->base < r->base)
+        return -1;
+    else if (l->base > r->base)
+        return 1;
+    return 0;
+}
+
+/**
+ * @internal
+ * Build the address-sorted binary image index used by imageForAddress:. Must be called with the receiver's
+ * lock held.
+ */
+- (void) buildImageIndex {
+    NSArray *images = self.images;
+    NSUInteger count = [images count];
+
+    /* Allocate at least one entry, marking the index as built */
+    plcrash_report_image_range_t *index = calloc(count > 0 ? count : 1, sizeof(plcrash_report_image_range_t));
+    if (index == NULL)
+        return;
+
+    for (NSUInteger i = 0; i < count; i++) {
+        PLCrashReportBinaryImageInfo *imageInfo = [images objectAtIndex: i];
         uint64_t normalizedBaseAddress = imageInfo.imageBaseAddress;
 #if __DARWIN_OPAQUE_ARM_THREAD_STATE64
         normalizedBaseAddress &= 0x0000000fffffffff;
 #endif
-        if (normalizedBaseAddress <= address && address < (normalizedBaseAddress + imageInfo.imageSize))
-            return imageInfo;
+        index[i].base = normalizedBaseAddress;
+        index[i].end = normalizedBaseAddress + imageInfo.imageSize;
+        index[i].image = imageInfo;
     }
 
-    /* Not found */
-    return nil;
+    /* Stable ordering is not required; images do not overlap */
+    qsort(index, count, sizeof(index[0]), image_range_compare);
+
+    _decoder->image_index = index;
+    _decoder->image_index_count = count;
+}
+
+// property getter. Decodes the thread records on first access if lazy decoding is enabled.
+- (NSArray *) threads {
+    if (!_decoder->lazy)
+        return _threads;
+
+    @synchronized (self) {
+        if (_threads == nil)
+            _threads = [[self extractThreadInfo: _decoder->crashReport error: NULL] retain];
+        return [[_threads retain] autorelease];
+    }
+}
+
+// property getter. Decodes the image records on first access if lazy decoding is enabled.
+- (NSArray *) images {
+    if (!_decoder->lazy)
+        return _images;
+
+    @synchronized (self) {
+        if (_images == nil)
+            _images = [[self extractImageInfo: _decoder->crashReport error: NULL] retain];
+        return [[_images retain] autorelease];
+    }
+}
+
+/**
+ * @internal
+ * Sort PLCrashReportBinaryImageInfo instances by their base address.
+ */
+static NSInteger binary_image_address_sort (id binary1, id binary2, void *context) {
+    uint64_t addr1 = [binary1 imageBaseAddress];
+    uint64_t addr2 = [binary2 imageBaseAddress];
+
+    if (addr1 < addr2)
+        return NSOrderedAscending;
+    else if (addr1 > addr2)
+        return NSOrderedDescending;
+    else
+        return NSOrderedSame;
+}
+
+// property getter. Sorts the images on first access.
+- (NSArray *) sortedImages {
+    @synchronized (self) {
+        if (_sortedImages == nil)
+            _sortedImages = [[self.images sortedArrayUsingFunction: binary_image_address_sort context: nil] retain];
+        return [[_sortedImages retain] autorelease];
+    }
+}
+
+// property getter. Returns the number of threads, without decoding the thread records.
+- (NSUInteger) threadCount {
+    if (_merged)
+        return [_threads count];
+    return _decoder->crashReport->n_threads;
+}
+
+// property getter. Returns the number of images, without decoding the image records.
+- (NSUInteger) imageCount {
+    if (_merged)
+        return [_images count];
+    return _decoder->crashReport->n_binary_images;
+}
+
+/**
+ * @internal
+ * Return the crashed thread's record, or NULL if no thread is marked as crashed.
+ */
+- (Plcrash__CrashReport__Thread *) crashedThreadRecord {
+    for (size_t i = 0; i < _decoder->crashReport->n_threads; i++) {
+        if (_decoder->crashReport->threads[i]->crashed)
+            return _decoder->crashReport->threads[i];
+    }
+
+    return NULL;
+}
+
+// property getter. Returns the crashed thread number, without decoding the thread records.
+- (NSInteger) crashedThreadNumber {
+    Plcrash__CrashReport__Thread *thread = [self crashedThreadRecord];
+    if (thread == NULL)
+        return -1;
+    return thread->thread_number;
+}
+
+// property getter. Returns the crashed thread's frame count, without decoding the thread records.
+- (NSUInteger) crashedThreadFrameCount {
+    Plcrash__CrashReport__Thread *thread = [self crashedThreadRecord];
+    if (thread == NULL)
+        return 0;
+    return thread_frame_count(thread);
+}
+
+// property getter. Decodes only the crashed thread, unless all threads have already been decoded.
+- (PLCrashReportThreadInfo *) crashedThread {
+    @synchronized (self) {
+        if (_crashedThread != nil)
+            return [[_crashedThread retain] autorelease];
+
+        if (_threads != nil) {
+            for (PLCrashReportThreadInfo *thread in _threads) {
+                if (thread.crashed)
+                    return thread;
+            }
+            return nil;
+        }
+
+        Plcrash__CrashReport__Thread *thread = [self crashedThreadRecord];
+        if (thread == NULL)
+            return nil;
+
+        PLCrashReportFrameStorage *storage = nil;
+        if (_decoder->compact)
+            storage = [[[PLCrashReportFrameStorage alloc] initWithCapacity: thread_frame_count(thread) symbolNameCount: _decoder->crashReport->n_symbol_names] autorelease];
+
+        _crashedThread = [[self extractThread: thread storage: storage error: NULL] retain];
+        return [[_crashedThread retain] autorelease];
+    }
 }
 
 // property getter. Returns YES if machine information is available.
@@ -242,16 +742,31 @@ error:
     return NO;
 }
 
+// property getter. Returns YES if symbolication diagnostics are available.
+- (BOOL) hasSymbolicationDiagnostics {
+    if (_symbolicationDiagnostics != nil)
+        return YES;
+    return NO;
+}
+
 @synthesize systemInfo = _systemInfo;
 @synthesize machineInfo = _machineInfo;
 @synthesize applicationInfo = _applicationInfo;
 @synthesize processInfo = _processInfo;
 @synthesize signalInfo = _signalInfo;
 @synthesize machExceptionInfo = _machExceptionInfo;
-@synthesize threads = _threads;
-@synthesize images = _images;
 @synthesize exceptionInfo = _exceptionInfo;
+@synthesize symbolicationDiagnostics = _symbolicationDiagnostics;
+@synthesize stackSamples = _stackSamples;
+@synthesize customData = _customData;
+@synthesize breadcrumbs = _breadcrumbs;
+@synthesize memoryStatistics = _memoryStatistics;
+@synthesize writerDiagnostics = _writerDiagnostics;
+@synthesize omittedImageCount = _omittedImageCount;
+@synthesize omittedImageHash = _omittedImageHash;
+@synthesize truncated = _truncated;
 @synthesize uuidRef = _uuid;
+@synthesize baseReportUUIDRef = _baseReportUUID;
 
 @end
 
@@ -265,8 +780,11 @@ error:
 /**
  * Decode the crash log message.
  *
- * @warning MEMORY WARNING. The caller is responsible for deallocating th ePlcrash__CrashReport instance
- * returned by this method via protobuf_c_message_free_unpacked().
+ * The message is unpacked into the receiver's decoding arena, rather than allocating (and later freeing) each
+ * message, string and bytes field individually.
+ *
+ * @warning MEMORY WARNING. The returned Plcrash__CrashReport instance is owned by the receiver's decoding arena,
+ * and must not be deallocated via protobuf_c_message_free_unpacked().
  */
 - (Plcrash__CrashReport *) decodeCrashData: (NSData *) data error: (NSError **) outError {
     const struct PLCrashReportFileHeader *header;
@@ -290,14 +808,72 @@ error:
     }
 
     /* Check the version */
-    if(header->version != PLCRASH_REPORT_FILE_VERSION) {
+    if (header->version != PLCRASH_REPORT_FILE_VERSION && header->version != PLCRASH_REPORT_FILE_VERSION_COMPRESSED &&
+        header->version != PLCRASH_REPORT_FILE_VERSION_SYMBOL_NAMES && header->version != PLCRASH_REPORT_FILE_VERSION_SYMBOL_NAMES_COMPRESSED)
+    {
         populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid, [NSString stringWithFormat: NSLocalizedString(@"Could not decode unsupported crash report version: %d", 
                                                                                                                          @"Crash log decoding message"), header->version]);
         return NULL;
     }
 
-    Plcrash__CrashReport *crashReport = plcrash__crash_report__unpack(NULL, [data length] - sizeof(struct PLCrashReportFileHeader), header->data);
+    const uint8_t *reportData = header->data;
+    size_t reportLength = [data length] - sizeof(struct PLCrashReportFileHeader);
+
+    /* Inflate compressed reports */
+    NSMutableData *inflated = nil;
+    if (header->version == PLCRASH_REPORT_FILE_VERSION_COMPRESSED || header->version == PLCRASH_REPORT_FILE_VERSION_SYMBOL_NAMES_COMPRESSED) {
+        size_t inflatedLength;
+        if (plcrash_nasync_lz_decoded_length(reportData, reportLength, &inflatedLength) != PLCRASH_ESUCCESS ||
+            inflatedLength > PLCRASH_REPORT_MAX_INFLATED_LENGTH)
+        {
+            populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid, NSLocalizedString(@"Could not decode invalid compressed crash log",
+                                                                                                 @"Crash log decoding error message"));
+            return NULL;
+        }
+
+        inflated = [NSMutableData dataWithLength: inflatedLength];
+        if (inflated == nil) {
+            populate_nserror(outError, PLCrashReporterErrorUnknown, NSLocalizedString(@"Could not allocate memory for the compressed crash log",
+                                                                                      @"Crash log decoding error message"));
+            return NULL;
+        }
+
+        if (plcrash_nasync_lz_decode(reportData, reportLength, [inflated mutableBytes], inflatedLength) != PLCRASH_ESUCCESS) {
+            populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid, NSLocalizedString(@"Could not decode invalid compressed crash log",
+                                                                                                 @"Crash log decoding error message"));
+            return NULL;
+        }
+
+        reportData = [inflated bytes];
+        reportLength = inflatedLength;
+    }
+
+    /* Size the initial arena chunk to fit the typical unpacked report. If this fails, the arena will
+     * attempt smaller allocations as required. */
+    if (reportLength <= SIZE_MAX / PLCRASH_REPORT_ARENA_EXPANSION_FACTOR)
+        report_arena_add_chunk(_decoder, reportLength * PLCRASH_REPORT_ARENA_EXPANSION_FACTOR);
+
+    ProtobufCAllocator allocator = {
+        .alloc = report_arena_alloc,
+        .free = report_arena_free,
+        .allocator_data = _decoder
+    };
+
+    Plcrash__CrashReport *crashReport = plcrash__crash_report__unpack(&allocator, reportLength, reportData);
+
+    /* If the report was truncated mid-write, fall back on decoding its complete leading fields */
     if (crashReport == NULL) {
+        size_t completeLength = report_complete_length(reportData, reportLength);
+        if (completeLength > 0 && completeLength < reportLength) {
+            report_arena_release(_decoder);
+            crashReport = plcrash__crash_report__unpack(&allocator, completeLength, reportData);
+            if (crashReport != NULL)
+                _truncated = YES;
+        }
+    }
+
+    if (crashReport == NULL) {
+        report_arena_release(_decoder);
         populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid, NSLocalizedString(@"An unknown error occured decoding the crash report", 
                                                                                              @"Crash log decoding error message"));
         return NULL;
@@ -548,6 +1124,15 @@ error:
     if (processInfo->parent_process_name != NULL)
         parentProcessName = [NSString stringWithUTF8String: processInfo->parent_process_name];
 
+    /* Shared cache available? */
+    NSData *sharedCacheUUID = nil;
+    if (processInfo->has_shared_cache_uuid && processInfo->shared_cache_uuid.len == sizeof(uuid_t))
+        sharedCacheUUID = [NSData dataWithBytes: processInfo->shared_cache_uuid.data length: processInfo->shared_cache_uuid.len];
+
+    uint64_t sharedCacheBaseAddress = 0;
+    if (processInfo->has_shared_cache_base_address)
+        sharedCacheBaseAddress = processInfo->shared_cache_base_address;
+
     /* Required elements */
     NSUInteger processID = processInfo->process_id;
     NSUInteger parentProcessID = processInfo->parent_process_id;
@@ -559,7 +1144,9 @@ error:
                                                  processStartTime: startTime
                                                 parentProcessName: parentProcessName
                                                   parentProcessID: parentProcessID
-                                                           native: processInfo->native] autorelease];
+                                                           native: processInfo->native
+                                                  sharedCacheUUID: sharedCacheUUID
+                                           sharedCacheBaseAddress: sharedCacheBaseAddress] autorelease];
 }
 
 /**
@@ -574,7 +1161,19 @@ error:
         return nil;
     }
     
-    NSString *name = [NSString stringWithUTF8String: symbol->name];
+    /* The name may be included inline, or by reference to the report's symbol name table */
+    const char *cname = symbol->name;
+    if (cname == NULL && symbol->has_name_index && symbol->name_index < _decoder->crashReport->n_symbol_names)
+        cname = _decoder->crashReport->symbol_names[symbol->name_index];
+
+    if (cname == NULL) {
+        populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid,
+                         NSLocalizedString(@"Crash report is missing symbol name",
+                                           @"Missing symbol name in crash report"));
+        return nil;
+    }
+
+    NSString *name = [NSString stringWithUTF8String: cname];
     return [[[PLCrashReportSymbolInfo alloc] initWithSymbolName: name
                                                    startAddress: symbol->start_address
                                                      endAddress: symbol->has_end_address ? symbol->end_address : 0] autorelease];
@@ -604,24 +1203,23 @@ error:
 }
 
 /**
- * Extract thread information from the crash log. Returns nil on error, or an array of PLCrashLogThreadInfo
- * instances on success.
+ * Extract a thread's stack frames from the crash log. If @a storage is non-nil, the frames are appended to
+ * @a storage, and a PLCrashReportFrameArray is returned. Returns nil on error.
  */
-- (NSArray *) extractThreadInfo: (Plcrash__CrashReport *) crashReport error: (NSError **) outError {
-    /* There should be at least one thread */
-    if (crashReport->n_threads == 0) {
-        populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid,
-                         NSLocalizedString(@"Crash report is missing thread state information",
-                                           @"Missing thread info in crash report"));
-        return nil;
-    }
+- (NSArray *) extractStackFrames: (Plcrash__CrashReport__Thread *) thread
+                         storage: (PLCrashReportFrameStorage *) storage
+                           error: (NSError **) outError
+{
+    /* Raw capture threads include no frames; they are recovered from the captured stack memory. These frames are
+     * not symbolicated, and are not added to the compact frame storage. */
+    if (thread->n_frames == 0 && thread->n_frame_pcs == 0 && thread->has_stack_memory)
+        return [self extractRawStackFrames: thread error: outError];
 
-    /* Handle all threads */
-    NSMutableArray *threadResult = [NSMutableArray arrayWithCapacity: crashReport->n_threads];
-    for (size_t thr_idx = 0; thr_idx < crashReport->n_threads; thr_idx++) {
-        Plcrash__CrashReport__Thread *thread = crashReport->threads[thr_idx];
-        
-        /* Fetch stack frames for this thread */
+    /* Threads written with the packed thread encoding */
+    if (thread->n_frame_pcs > 0)
+        return [self extractPackedStackFrames: thread storage: storage error: outError];
+
+    if (storage == nil) {
         NSMutableArray *frames = [NSMutableArray arrayWithCapacity: thread->n_frames];
         for (size_t frame_idx = 0; frame_idx < thread->n_frames; frame_idx++) {
             Plcrash__CrashReport__Thread__StackFrame *frame = thread->frames[frame_idx];
@@ -632,30 +1230,323 @@ error:
             [frames addObject: frameInfo];
         }
 
-        /* Fetch registers for this thread */
-        NSMutableArray *registers = [NSMutableArray arrayWithCapacity: thread->n_registers];
-        for (size_t reg_idx = 0; reg_idx < thread->n_registers; reg_idx++) {
-            Plcrash__CrashReport__Thread__RegisterValue *reg = thread->registers[reg_idx];
-            PLCrashReportRegisterInfo *regInfo;
+        return frames;
+    }
+
+    NSRange range = NSMakeRange([storage count], thread->n_frames);
+    for (size_t frame_idx = 0; frame_idx < thread->n_frames; frame_idx++) {
+        Plcrash__CrashReport__Thread__StackFrame *frame = thread->frames[frame_idx];
+        if (frame == NULL) {
+            populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid,
+                             NSLocalizedString(@"Crash report is missing stack frame information",
+                                               @"Missing stack frame info in crash report"));
+            return nil;
+        }
+
+        Plcrash__CrashReport__Symbol *symbol = frame->symbol;
+        if (symbol == NULL) {
+            [storage appendFrameWithInstructionPointer: frame->pc symbolName: nil startAddress: 0 endAddress: 0];
+            continue;
+        }
+
+        /* Names referenced from the symbol name table are shared by all frames */
+        NSString *name = nil;
+        if (symbol->name != NULL) {
+            name = [NSString stringWithUTF8String: symbol->name];
+        } else if (symbol->has_name_index && symbol->name_index < _decoder->crashReport->n_symbol_names) {
+            name = [storage symbolNameAtIndex: symbol->name_index cString: _decoder->crashReport->symbol_names[symbol->name_index]];
+        }
+
+        if (name == nil) {
+            populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid,
+                             NSLocalizedString(@"Crash report is missing symbol name",
+                                               @"Missing symbol name in crash report"));
+            return nil;
+        }
+
+        [storage appendFrameWithInstructionPointer: frame->pc
+                                        symbolName: name
+                                      startAddress: symbol->start_address
+                                        endAddress: symbol->has_end_address ? symbol->end_address : 0];
+    }
+
+    return [[[PLCrashReportFrameArray alloc] initWithStorage: storage range: range] autorelease];
+}
+
+/**
+ * Extract the stack frames of a thread written with the packed thread encoding. If @a storage is non-nil, the frames
+ * are appended to @a storage, and a PLCrashReportFrameArray is returned. Returns nil on error.
+ */
+- (NSArray *) extractPackedStackFrames: (Plcrash__CrashReport__Thread *) thread
+                               storage: (PLCrashReportFrameStorage *) storage
+                                 error: (NSError **) outError
+{
+    Plcrash__CrashReport *crashReport = _decoder->crashReport;
+    NSMutableArray *frames = nil;
+    NSRange range = NSMakeRange([storage count], thread->n_frame_pcs);
+
+    if (storage == nil)
+        frames = [NSMutableArray arrayWithCapacity: thread->n_frame_pcs];
+
+    for (size_t frame_idx = 0; frame_idx < thread->n_frame_pcs; frame_idx++) {
+        uint64_t pc = thread->frame_pcs[frame_idx];
+
+        /* PCs may be written relative to the base address of a binary image, referenced by its index plus one */
+        uint32_t image_ref = 0;
+        if (frame_idx < thread->n_frame_images)
+            image_ref = thread->frame_images[frame_idx];
 
-            /* Handle missing register name (should not occur!) */
-            if (reg->name == NULL) {
-                populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid, @"Missing register name in register value");
+        if (image_ref != 0) {
+            if (image_ref > crashReport->n_binary_images) {
+                populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid,
+                                 NSLocalizedString(@"Crash report references a missing binary image",
+                                                   @"Missing binary image in crash report"));
                 return nil;
             }
 
-            regInfo = [[[PLCrashReportRegisterInfo alloc] initWithRegisterName: [NSString stringWithUTF8String: reg->name]
-                                                              registerValue: reg->value] autorelease];
+            pc += crashReport->binary_images[image_ref - 1]->base_address;
+        }
+
+        /* Symbol names are referenced by their index within the symbol name table, plus one; 0 denotes no symbol */
+        uint32_t name_ref = 0;
+        if (frame_idx < thread->n_frame_symbol_names)
+            name_ref = thread->frame_symbol_names[frame_idx];
+
+        if (name_ref > crashReport->n_symbol_names) {
+            populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid,
+                             NSLocalizedString(@"Crash report is missing symbol name",
+                                               @"Missing symbol name in crash report"));
+            return nil;
+        }
+
+        uint64_t start_address = pc;
+        if (frame_idx < thread->n_frame_symbol_offsets)
+            start_address = pc - thread->frame_symbol_offsets[frame_idx];
+
+        if (storage != nil) {
+            NSString *name = nil;
+            if (name_ref != 0)
+                name = [storage symbolNameAtIndex: name_ref - 1 cString: crashReport->symbol_names[name_ref - 1]];
+
+            [storage appendFrameWithInstructionPointer: pc
+                                            symbolName: name
+                                          startAddress: name != nil ? start_address : 0
+                                            endAddress: 0];
+            continue;
+        }
+
+        PLCrashReportSymbolInfo *symbolInfo = nil;
+        if (name_ref != 0) {
+            NSString *name = [NSString stringWithUTF8String: crashReport->symbol_names[name_ref - 1]];
+            symbolInfo = [[[PLCrashReportSymbolInfo alloc] initWithSymbolName: name startAddress: start_address endAddress: 0] autorelease];
+        }
+
+        [frames addObject: [[[PLCrashReportStackFrameInfo alloc] initWithInstructionPointer: pc symbolInfo: symbolInfo] autorelease]];
+    }
+
+    if (storage == nil)
+        return frames;
+
+    return [[[PLCrashReportFrameArray alloc] initWithStorage: storage range: range] autorelease];
+}
+
+/**
+ * Determine the CPU type of the process that wrote @a crashReport, preferring the code type of the first binary image
+ * (the main executable) over the host processor type. Returns false if no Mach CPU type is available.
+ */
+static bool report_cpu_type (Plcrash__CrashReport *crashReport, cpu_type_t *cpu_type) {
+    Plcrash__CrashReport__Processor *processor = NULL;
+
+    if (crashReport->n_binary_images > 0 && crashReport->binary_images[0]->code_type != NULL)
+        processor = crashReport->binary_images[0]->code_type;
+    else if (crashReport->machine_info != NULL)
+        processor = crashReport->machine_info->processor;
+
+    if (processor == NULL || processor->encoding != PLCRASH__CRASH_REPORT__PROCESSOR__TYPE_ENCODING__TYPE_ENCODING_MACH)
+        return false;
+
+    *cpu_type = (cpu_type_t) processor->type;
+    return true;
+}
+
+/**
+ * Recover a raw capture thread's stack frames by walking the frame pointer chain of the thread's captured stack memory,
+ * starting from the thread's captured registers. If the thread's registers can not be interpreted, an empty frame
+ * list is returned.
+ */
+- (NSArray *) extractRawStackFrames: (Plcrash__CrashReport__Thread *) thread error: (NSError **) outError {
+    plcrash_async_thread_state_t state;
+    cpu_type_t cpu_type;
+
+    if (!report_cpu_type(_decoder->crashReport, &cpu_type) || plcrash_async_thread_state_init(&state, cpu_type) != PLCRASH_ESUCCESS)
+        return [NSArray array];
+
+    /* Populate the thread state from the captured registers, by name */
+    size_t reg_count = plcrash_async_thread_state_get_reg_count(&state);
+    for (size_t reg_idx = 0; reg_idx < thread->n_registers; reg_idx++) {
+        Plcrash__CrashReport__Thread__RegisterValue *reg = thread->registers[reg_idx];
+        if (reg == NULL || reg->name == NULL)
+            continue;
+
+        for (plcrash_regnum_t i = 0; i < reg_count; i++) {
+            if (strcmp(plcrash_async_thread_state_get_reg_name(&state, i), reg->name) == 0) {
+                plcrash_async_thread_state_set_reg(&state, i, reg->value);
+                break;
+            }
+        }
+    }
+
+    if (!plcrash_async_thread_state_has_reg(&state, PLCRASH_REG_IP))
+        return [NSArray array];
+
+    /* Walk the captured stack */
+    plcrash_greg_t pcs[PLCRASH_REPORT_MAX_RAW_FRAMES];
+    size_t count = plframe_walk_captured_stack(&state, thread->has_stack_address ? thread->stack_address : 0,
+                                               thread->stack_memory.data, thread->stack_memory.len,
+                                               pcs, PLCRASH_REPORT_MAX_RAW_FRAMES);
+
+    NSMutableArray *frames = [NSMutableArray arrayWithCapacity: count];
+    for (size_t i = 0; i < count; i++) {
+        PLCrashReportStackFrameInfo *frameInfo = [[[PLCrashReportStackFrameInfo alloc] initWithInstructionPointer: pcs[i] symbolInfo: nil] autorelease];
+        [frames addObject: frameInfo];
+    }
+
+    return frames;
+}
+
+/**
+ * Extract a single thread's information from the crash log. If @a storage is non-nil, the thread's stack
+ * frames are appended to @a storage. Returns nil on error.
+ */
+- (PLCrashReportThreadInfo *) extractThread: (Plcrash__CrashReport__Thread *) thread
+                                     storage: (PLCrashReportFrameStorage *) storage
+                                       error: (NSError **) outError
+{
+    /* Fetch stack frames for this thread */
+    NSArray *frames = [self extractStackFrames: thread storage: storage error: outError];
+    if (frames == nil)
+        return nil;
+
+    /* Fetch registers for this thread */
+    NSMutableArray *registers = [NSMutableArray arrayWithCapacity: thread->n_registers + thread->n_register_values + thread->n_register_state];
+    for (size_t reg_idx = 0; reg_idx < thread->n_registers; reg_idx++) {
+        Plcrash__CrashReport__Thread__RegisterValue *reg = thread->registers[reg_idx];
+        PLCrashReportRegisterInfo *regInfo;
+
+        /* Handle missing register name (should not occur!) */
+        if (reg->name == NULL) {
+            populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid, @"Missing register name in register value");
+            return nil;
+        }
+
+        regInfo = [[[PLCrashReportRegisterInfo alloc] initWithRegisterName: [NSString stringWithUTF8String: reg->name]
+                                                          registerValue: reg->value] autorelease];
+        [registers addObject: regInfo];
+    }
+
+    /* Registers written with the packed thread encoding refer to their names by symbol name table index */
+    for (size_t reg_idx = 0; reg_idx < thread->n_register_values; reg_idx++) {
+        if (reg_idx >= thread->n_register_names || thread->register_names[reg_idx] >= _decoder->crashReport->n_symbol_names) {
+            populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid, @"Missing register name in register value");
+            return nil;
+        }
+
+        NSString *name = [NSString stringWithUTF8String: _decoder->crashReport->symbol_names[thread->register_names[reg_idx]]];
+        PLCrashReportRegisterInfo *regInfo = [[[PLCrashReportRegisterInfo alloc] initWithRegisterName: name
+                                                                                        registerValue: thread->register_values[reg_idx]] autorelease];
+        [registers addObject: regInfo];
+    }
+
+    /* Registers written with the compact register encoding are named by their canonical register number */
+    if (thread->n_register_state > 0) {
+        plcrash_async_thread_state_t state;
+        cpu_type_t cpu_type;
+
+        if (!report_cpu_type(_decoder->crashReport, &cpu_type) || plcrash_async_thread_state_init(&state, cpu_type) != PLCRASH_ESUCCESS ||
+            thread->n_register_state > plcrash_async_thread_state_get_reg_count(&state))
+        {
+            populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid, @"Register names are unavailable for the report's architecture");
+            return nil;
+        }
+
+        for (size_t reg_idx = 0; reg_idx < thread->n_register_state; reg_idx++) {
+            NSString *name = [NSString stringWithUTF8String: plcrash_async_thread_state_get_reg_name(&state, (plcrash_regnum_t) reg_idx)];
+            PLCrashReportRegisterInfo *regInfo = [[[PLCrashReportRegisterInfo alloc] initWithRegisterName: name
+                                                                                            registerValue: thread->register_state[reg_idx]] autorelease];
             [registers addObject: regInfo];
         }
+    }
+
+    /* Thread metadata is optional */
+    NSString *name = nil;
+    if (thread->name != NULL)
+        name = [NSString stringWithUTF8String: thread->name];
+
+    NSString *dispatchQueueLabel = nil;
+    if (thread->dispatch_queue != NULL)
+        dispatchQueueLabel = [NSString stringWithUTF8String: thread->dispatch_queue];
+
+    /* Create the thread info instance */
+    return [[[PLCrashReportThreadInfo alloc] initWithThreadNumber: thread->thread_number
+                                                      stackFrames: frames
+                                                          crashed: thread->crashed
+                                                        registers: registers
+                                                 threadIdentifier: thread->has_thread_id ? thread->thread_id : 0
+                                                             name: name
+                                               dispatchQueueLabel: dispatchQueueLabel
+                                                         qosClass: thread->has_qos_class ? thread->qos_class : 0
+                                                       hasCPUTime: thread->has_user_time && thread->has_system_time
+                                                         userTime: thread->user_time
+                                                       systemTime: thread->system_time] autorelease];
+}
+
+/**
+ * Extract thread information from the crash log. Returns nil on error, or an array of PLCrashLogThreadInfo
+ * instances on success.
+ */
+- (NSArray *) extractThreadInfo: (Plcrash__CrashReport *) crashReport error: (NSError **) outError {
+    /* There should be at least one thread */
+    if (crashReport->n_threads == 0) {
+        populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid,
+                         NSLocalizedString(@"Crash report is missing thread state information",
+                                           @"Missing thread info in crash report"));
+        return nil;
+    }
+
+    /* In compact mode, all threads' frames share a single storage buffer */
+    PLCrashReportFrameStorage *storage = nil;
+    if (_decoder->compact) {
+        NSUInteger frameCount = 0;
+        for (size_t thr_idx = 0; thr_idx < crashReport->n_threads; thr_idx++)
+            frameCount += thread_frame_count(crashReport->threads[thr_idx]);
+
+        storage = [[[PLCrashReportFrameStorage alloc] initWithCapacity: frameCount symbolNameCount: crashReport->n_symbol_names] autorelease];
+        if (storage == nil) {
+            populate_nserror(outError, PLCrashReporterErrorUnknown, @"Could not allocate frame storage");
+            return nil;
+        }
+    }
+
+    /* Handle all threads */
+    NSMutableArray *threadResult = [NSMutableArray arrayWithCapacity: crashReport->n_threads];
+    for (size_t thr_idx = 0; thr_idx < crashReport->n_threads; thr_idx++) {
+        PLCrashReportThreadInfo *threadInfo = [self extractThread: crashReport->threads[thr_idx] storage: storage error: outError];
+        if (threadInfo == nil)
+            return nil;
 
-        /* Create the thread info instance */
-        PLCrashReportThreadInfo *threadInfo = [[[PLCrashReportThreadInfo alloc] initWithThreadNumber: thread->thread_number
-                                                                                   stackFrames: frames 
-                                                                                       crashed: thread->crashed 
-                                                                                     registers: registers] autorelease];
         [threadResult addObject: threadInfo];
     }
+
+    /* The crashed thread is written first; return the threads in thread number order */
+    [threadResult sortWithOptions: NSSortStable usingComparator: ^NSComparisonResult (id lhs, id rhs) {
+        NSInteger lhsNumber = [(PLCrashReportThreadInfo *) lhs threadNumber];
+        NSInteger rhsNumber = [(PLCrashReportThreadInfo *) rhs threadNumber];
+        if (lhsNumber < rhsNumber)
+            return NSOrderedAscending;
+        else if (lhsNumber > rhsNumber)
+            return NSOrderedDescending;
+        return NSOrderedSame;
+    }];
     
     return threadResult;
 }
@@ -665,8 +1556,8 @@ error:
  * Extract binary image information from the crash log. Returns nil on error.
  */
 - (NSArray *) extractImageInfo: (Plcrash__CrashReport *) crashReport error: (NSError **) outError {
-    /* There should be at least one image */
-    if (crashReport->n_binary_images == 0) {
+    /* There should be at least one image, unless all images were written to the base report of an incremental report */
+    if (crashReport->n_binary_images == 0 && crashReport->base_report == NULL) {
         populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid,
                          NSLocalizedString(@"Crash report is missing binary image information",
                                            @"Missing image info in crash report"));
@@ -840,6 +1731,208 @@ error:
     return [[[PLCrashReportMachExceptionInfo alloc] initWithType: machExceptionInfo->type codes: codes] autorelease];
 }
 
+/**
+ * Extract symbolication diagnostics from the crash log. Returns nil on error.
+ */
+- (PLCrashReportSymbolicationDiagnostics *) extractSymbolicationDiagnostics: (Plcrash__CrashReport__SymbolicationDiagnostics *) diagnostics
+                                                                      error: (NSError **) outError
+{
+    /* Validate */
+    if (diagnostics == NULL) {
+        populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid,
+                         NSLocalizedString(@"Crash report is missing Symbolication Diagnostics section",
+                                           @"Missing symbolication diagnostics in crash report"));
+        return nil;
+    }
+
+    /* Times are encoded in nanoseconds */
+    return [[[PLCrashReportSymbolicationDiagnostics alloc] initWithLookupCount: diagnostics->lookups
+                                                                 cacheHitCount: diagnostics->cache_hits
+                                                                symbolsScanned: diagnostics->symbols_scanned
+                                                             objcClassesParsed: diagnostics->objc_classes_parsed
+                                                        symbolTableLookupCount: diagnostics->symbol_table_lookups
+                                                               symbolTableTime: diagnostics->symbol_table_time / (NSTimeInterval) NSEC_PER_SEC
+                                                               objcLookupCount: diagnostics->objc_lookups
+                                                                      objcTime: diagnostics->objc_time / (NSTimeInterval) NSEC_PER_SEC] autorelease];
+}
+
+/**
+ * Extract stack samples from the crash log. Returns nil on error.
+ */
+- (PLCrashReportStackSamples *) extractStackSamples: (Plcrash__CrashReport__StackSamples *) samples error: (NSError **) outError {
+    /* Validate */
+    if (samples == NULL) {
+        populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid,
+                         NSLocalizedString(@"Crash report is missing Stack Samples section",
+                                           @"Missing stack samples in crash report"));
+        return nil;
+    }
+
+    NSMutableArray *stacks = [NSMutableArray arrayWithCapacity: samples->n_stacks];
+    for (size_t i = 0; i < samples->n_stacks; i++) {
+        Plcrash__CrashReport__StackSamples__Stack *stack = samples->stacks[i];
+
+        NSMutableArray *pcs = [NSMutableArray arrayWithCapacity: stack->n_pcs];
+        for (size_t j = 0; j < stack->n_pcs; j++)
+            [pcs addObject: [NSNumber numberWithUnsignedLongLong: stack->pcs[j]]];
+
+        PLCrashReportStackSample *sample = [[[PLCrashReportStackSample alloc] initWithThreadIndex: stack->thread_index
+                                                                                       sampleCount: stack->count
+                                                                               instructionPointers: pcs] autorelease];
+        [stacks addObject: sample];
+    }
+
+    /* The interval is encoded in nanoseconds */
+    return [[[PLCrashReportStackSamples alloc] initWithInterval: samples->interval / (NSTimeInterval) NSEC_PER_SEC
+                                                    sampleCount: samples->sample_count
+                                             evictedSampleCount: samples->evicted_count
+                                                         stacks: stacks] autorelease];
+}
+
+/**
+ * Extract memory statistics from the crash log. Returns nil on error.
+ */
+- (PLCrashReportMemoryStatistics *) extractMemoryStatistics: (Plcrash__CrashReport__MemoryStatistics *) stats error: (NSError **) outError {
+    /* Validate */
+    if (stats == NULL) {
+        populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid,
+                         NSLocalizedString(@"Crash report is missing Memory Statistics section",
+                                           @"Missing memory statistics in crash report"));
+        return nil;
+    }
+
+    NSMutableArray *regions = [NSMutableArray arrayWithCapacity: stats->n_largest_regions];
+    for (size_t i = 0; i < stats->n_largest_regions; i++) {
+        Plcrash__CrashReport__MemoryStatistics__Region *region = stats->largest_regions[i];
+        [regions addObject: [[[PLCrashReportMemoryRegion alloc] initWithAddress: region->address
+                                                                           size: region->size
+                                                                     protection: region->protection
+                                                                        userTag: region->user_tag] autorelease]];
+    }
+
+    return [[[PLCrashReportMemoryStatistics alloc] initWithPhysicalFootprint: stats->phys_footprint
+                                                                residentSize: stats->resident_size
+                                                            peakResidentSize: stats->resident_size_peak
+                                                              compressedSize: stats->compressed_size
+                                                                 virtualSize: stats->virtual_size
+                                                                 regionCount: stats->region_count
+                                                              largestRegions: regions
+                                                            regionsTruncated: stats->has_regions_truncated && stats->regions_truncated] autorelease];
+}
+
+/**
+ * Extract the key/value pairs from a verbatim copy of a PLCrashKeyValueArea. Slots that were being modified when
+ * the area was copied are skipped. Returns nil if the area is malformed.
+ */
+- (NSDictionary *) extractKeyValueArea: (ProtobufCBinaryData *) data {
+    /* The bytes field may not be suitably aligned within the decoded report; work from an aligned copy */
+    NSData *aligned = [NSData dataWithBytes: data->data length: data->len];
+    const PLCrashKeyValueArea *area = (const PLCrashKeyValueArea *) [aligned bytes];
+
+    if (data->len < sizeof(*area) || area->magic != PLCRASH_KEY_VALUE_AREA_MAGIC)
+        return nil;
+
+    if (area->slot_count > (data->len - sizeof(*area)) / sizeof(area->slots[0]))
+        return nil;
+
+    NSMutableDictionary *result = [NSMutableDictionary dictionaryWithCapacity: area->slot_count];
+    for (uint32_t i = 0; i < area->slot_count; i++) {
+        const plcrash_key_value_slot_t *slot = &area->slots[i];
+
+        /* Odd sequence numbers mark a slot that was being written */
+        if ((slot->sequence & 1) != 0 || slot->key_length == 0)
+            continue;
+
+        if (slot->key_length > sizeof(slot->key) || slot->value_length > sizeof(slot->value))
+            continue;
+
+        NSString *key = [[[NSString alloc] initWithBytes: slot->key length: slot->key_length encoding: NSUTF8StringEncoding] autorelease];
+        NSString *value = [[[NSString alloc] initWithBytes: slot->value length: slot->value_length encoding: NSUTF8StringEncoding] autorelease];
+        if (key == nil || value == nil)
+            continue;
+
+        [result setObject: value forKey: key];
+    }
+
+    return result;
+}
+
+/**
+ * Extract the breadcrumbs from a verbatim copy of a PLCrashBreadcrumbBuffer, oldest first. Entries that were being
+ * written when the buffer was copied are skipped. Returns nil if the buffer is malformed.
+ */
+- (NSArray *) extractBreadcrumbs: (ProtobufCBinaryData *) data {
+    /* The bytes field may not be suitably aligned within the decoded report; work from an aligned copy */
+    NSData *aligned = [NSData dataWithBytes: data->data length: data->len];
+    const PLCrashBreadcrumbBuffer *buffer = (const PLCrashBreadcrumbBuffer *) [aligned bytes];
+
+    if (data->len < sizeof(*buffer) || buffer->magic != PLCRASH_BREADCRUMB_BUFFER_MAGIC)
+        return nil;
+
+    if (buffer->capacity == 0 || buffer->capacity > (data->len - sizeof(*buffer)) / sizeof(buffer->entries[0]))
+        return nil;
+
+    if (buffer->timebase_denom == 0)
+        return nil;
+
+    uint32_t next = (uint32_t) buffer->next;
+    uint32_t count = MIN(next, buffer->capacity);
+
+    NSMutableArray *result = [NSMutableArray arrayWithCapacity: count];
+    for (uint32_t i = next - count; i < next; i++) {
+        const plcrash_breadcrumb_entry_t *entry = &buffer->entries[i % buffer->capacity];
+
+        /* The entry is only complete if it was stamped with its own index */
+        if (entry->sequence != i + 1 || entry->length > sizeof(entry->message))
+            continue;
+
+        NSString *message = [[[NSString alloc] initWithBytes: entry->message length: entry->length encoding: NSUTF8StringEncoding] autorelease];
+        if (message == nil)
+            continue;
+
+        /* Convert the entry's mach_absolute_time() to wall clock time via the buffer's reference times */
+        int64_t elapsed = (int64_t) (entry->timestamp - buffer->reference_mach_time);
+        double elapsed_ns = (double) elapsed * buffer->timebase_numer / buffer->timebase_denom;
+        NSTimeInterval seconds = buffer->reference_time / (NSTimeInterval) USEC_PER_SEC + elapsed_ns / NSEC_PER_SEC;
+
+        NSDate *timestamp = [NSDate dateWithTimeIntervalSince1970: seconds];
+        [result addObject: [[[PLCrashReportBreadcrumb alloc] initWithTimestamp: timestamp message: message] autorelease]];
+    }
+
+    return result;
+}
+
+/**
+ * Extract writer diagnostics from the crash log. Returns nil on error.
+ */
+- (PLCrashReportWriterDiagnostics *) extractWriterDiagnostics: (Plcrash__CrashReport__ReportInfo__WriterDiagnostics *) diagnostics error: (NSError **) outError {
+    /* Validate */
+    if (diagnostics == NULL) {
+        populate_nserror(outError, PLCrashReporterErrorCrashReportInvalid,
+                         NSLocalizedString(@"Crash report is missing Writer Diagnostics section",
+                                           @"Missing writer diagnostics in crash report"));
+        return nil;
+    }
+
+    /* All times are encoded in nanoseconds */
+    NSMutableArray *timings = [NSMutableArray arrayWithCapacity: diagnostics->n_threads];
+    for (size_t i = 0; i < diagnostics->n_threads; i++) {
+        Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming *timing = diagnostics->threads[i];
+        PLCrashReportThreadTiming *info;
+
+        info = [[[PLCrashReportThreadTiming alloc] initWithThreadNumber: timing->thread_number
+                                                             frameCount: timing->frame_count
+                                                               walkTime: timing->walk_time / (NSTimeInterval) NSEC_PER_SEC
+                                                      symbolicationTime: timing->symbolication_time / (NSTimeInterval) NSEC_PER_SEC] autorelease];
+        [timings addObject: info];
+    }
+
+    return [[[PLCrashReportWriterDiagnostics alloc] initWithSuspendTime: diagnostics->suspend_time / (NSTimeInterval) NSEC_PER_SEC
+                                                          threadTimings: timings
+                                                              imageTime: diagnostics->image_time / (NSTimeInterval) NSEC_PER_SEC
+                                                              totalTime: diagnostics->total_time / (NSTimeInterval) NSEC_PER_SEC] autorelease];
+}
+
 @end
 
 /**
@@ -852,6 +1945,164 @@ error:
  * @param code The error code corresponding to this error.
  * @param description A localized error description.
  */
+/**
+ * @internal
+ * Read a base 128 varint from @a data, advancing @a offset past the encoded value.
+ *
+ * @return Returns true on success, or false if the varint is not fully contained within @a length bytes.
+ */
+static bool report_read_varint (const uint8_t *data, size_t length, size_t *offset, uint64_t *value) {
+    uint64_t result = 0;
+
+    for (unsigned int shift = 0; shift < 64 && *offset < length; shift += 7) {
+        uint8_t byte = data[(*offset)++];
+        result |= (uint64_t) (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @internal
+ * Return the length of the longest prefix of the encoded CrashReport message @a data that consists solely of
+ * complete top-level fields.
+ *
+ * @param data The encoded message.
+ * @param length The length of @a data, in bytes.
+ */
+static size_t report_complete_length (const uint8_t *data, size_t length) {
+    size_t complete = 0;
+    size_t offset = 0;
+
+    while (offset < length) {
+        uint64_t key;
+        uint64_t value;
+
+        /* Field number 0 is invalid, and marks the start of unwritten (zero-filled) output */
+        if (!report_read_varint(data, length, &offset, &key) || (key >> 3) == 0)
+            break;
+
+        switch (key & 0x7) {
+            case 0: /* varint */
+                if (!report_read_varint(data, length, &offset, &value))
+                    return complete;
+                break;
+
+            case 1: /* 64-bit */
+                if (length - offset < 8)
+                    return complete;
+                offset += 8;
+                break;
+
+            case 2: /* length-delimited */
+                if (!report_read_varint(data, length, &offset, &value) || value > length - offset)
+                    return complete;
+                offset += (size_t) value;
+                break;
+
+            case 5: /* 32-bit */
+                if (length - offset < 4)
+                    return complete;
+                offset += 4;
+                break;
+
+            default:
+                return complete;
+        }
+
+        complete = offset;
+    }
+
+    return complete;
+}
+
+/**
+ * @internal
+ * Add a new chunk of at least @a size bytes to @a decoder's decoding arena. Chunks are never smaller than the
+ * most recently added chunk, bounding the total number of chunks allocated.
+ *
+ * @return Returns true on success, or false if the chunk could not be allocated.
+ */
+static bool report_arena_add_chunk (_PLCrashReportDecoder *decoder, size_t size) {
+    size_t chunkSize = PLCRASH_REPORT_ARENA_MIN_CHUNK_SIZE;
+    if (decoder->arena != NULL && decoder->arena->size > chunkSize)
+        chunkSize = decoder->arena->size;
+    if (size > chunkSize)
+        chunkSize = size;
+
+    if (chunkSize > SIZE_MAX - sizeof(plcrash_report_arena_chunk_t))
+        return false;
+
+    plcrash_report_arena_chunk_t *chunk = malloc(sizeof(plcrash_report_arena_chunk_t) + chunkSize);
+    if (chunk == NULL)
+        return false;
+
+    chunk->next = decoder->arena;
+    chunk->size = chunkSize;
+    chunk->used = 0;
+    decoder->arena = chunk;
+    return true;
+}
+
+/**
+ * @internal
+ * ProtobufCAllocator allocation callback. Allocates @a size bytes from the decoding arena of the
+ * _PLCrashReportDecoder provided via @a allocator_data, returning NULL on failure.
+ */
+static void *report_arena_alloc (void *allocator_data, size_t size) {
+    _PLCrashReportDecoder *decoder = allocator_data;
+
+    /* Maintain the alignment of subsequent allocations */
+    if (size > SIZE_MAX - 15)
+        return NULL;
+    size = (size + 15) & ~((size_t) 15);
+
+    if (decoder->arena == NULL || decoder->arena->size - decoder->arena->used < size) {
+        if (!report_arena_add_chunk(decoder, size))
+            return NULL;
+    }
+
+    plcrash_report_arena_chunk_t *chunk = decoder->arena;
+    void *result = chunk->data + chunk->used;
+    chunk->used += size;
+    return result;
+}
+
+/**
+ * @internal
+ * ProtobufCAllocator deallocation callback. Arena allocations are released together by report_arena_release(),
+ * so this is a no-op.
+ */
+static void report_arena_free (void *allocator_data, void *pointer) {
+    /* Nothing to do */
+}
+
+/**
+ * @internal
+ * Release all arena allocations made on behalf of @a decoder.
+ */
+static void report_arena_release (_PLCrashReportDecoder *decoder) {
+    plcrash_report_arena_chunk_t *chunk = decoder->arena;
+    while (chunk != NULL) {
+        plcrash_report_arena_chunk_t *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    decoder->arena = NULL;
+}
+
+/**
+ * Return the number of stack frames written for @a thread, in either the packed or the standard thread encoding.
+ */
+static size_t thread_frame_count (Plcrash__CrashReport__Thread *thread) {
+    return thread->n_frames + thread->n_frame_pcs;
+}
+
 static void populate_nserror (NSError **error, PLCrashReporterError code, NSString *description) {
     NSDictionary *userInfo;
     
@@ -0,0 +1,140 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/**
+ * @internal
+ * Report batch container magic identifier, not NULL terminated.
+ */
+#define PLCRASH_REPORT_BATCH_MAGIC "plbatch"
+
+/**
+ * @internal
+ * Report batch container format version.
+ */
+#define PLCRASH_REPORT_BATCH_VERSION 1
+
+/**
+ * @internal
+ * Report batch container flag marking an LZ-compressed payload (see PLCrashAsyncLZ.h).
+ */
+#define PLCRASH_REPORT_BATCH_FLAG_COMPRESSED (1U << 0)
+
+/**
+ * @internal
+ * The maximum inflated payload size of a compressed batch, in bytes. Larger declared lengths are treated as invalid
+ * rather than allocated.
+ */
+#define PLCRASH_REPORT_BATCH_MAX_INFLATED_LENGTH (256 * 1024 * 1024)
+
+/**
+ * @internal
+ *
+ * Report batch container header. All integer values are little-endian. The header is followed by the payload; if
+ * PLCRASH_REPORT_BATCH_FLAG_COMPRESSED is set, the payload is LZ-compressed as a whole.
+ *
+ * The payload begins with @a count plcrash_report_batch_entry_t index entries, followed by the report and summary
+ * data referenced by the entries.
+ */
+typedef struct plcrash_report_batch_header {
+    /** Container magic identifier (#PLCRASH_REPORT_BATCH_MAGIC), not NULL terminated. */
+    char magic[7];
+
+    /** Container format version (#PLCRASH_REPORT_BATCH_VERSION). */
+    uint8_t version;
+
+    /** Container flags. */
+    uint32_t flags;
+
+    /** The number of reports in the container. */
+    uint32_t count;
+
+    /** The report queue sequence number of the first report in the container. */
+    uint64_t first_sequence;
+
+    /** The report queue sequence number of the last report in the container. */
+    uint64_t last_sequence;
+} __attribute__((packed)) plcrash_report_batch_header_t;
+
+/**
+ * @internal
+ *
+ * Report batch container index entry. All integer values are little-endian, and all offsets are relative to the
+ * start of the (uncompressed) payload.
+ */
+typedef struct plcrash_report_batch_entry {
+    /** The offset of the encoded report. */
+    uint64_t offset;
+
+    /** The length of the encoded report. */
+    uint64_t length;
+
+    /** The offset of the report's summary (see PLCrashReportSummary). */
+    uint64_t summary_offset;
+
+    /** The length of the report's summary, or 0 if the report has no summary. */
+    uint64_t summary_length;
+} __attribute__((packed)) plcrash_report_batch_entry_t;
+
+@interface PLCrashReportBatch : NSObject {
+@private
+    /** The uncompressed payload. */
+    NSData *_payload;
+
+    /** The number of reports. */
+    NSUInteger _count;
+
+    /** The queue sequence number of the first report. */
+    uint64_t _firstSequence;
+
+    /** The queue sequence number of the last report. */
+    uint64_t _lastSequence;
+}
+
++ (NSData *) encodeReports: (NSArray *) reports
+                 summaries: (NSArray *) summaries
+             firstSequence: (uint64_t) firstSequence
+              lastSequence: (uint64_t) lastSequence
+                  compress: (BOOL) compress;
+
+- (id) initWithData: (NSData *) data error: (NSError **) outError;
+
+- (NSData *) reportDataAtIndex: (NSUInteger) index;
+- (NSData *) summaryDataAtIndex: (NSUInteger) index;
+
+/** The number of reports in the batch. */
+@property(nonatomic, readonly) NSUInteger count;
+
+/** The report queue sequence number of the first report in the batch. */
+@property(nonatomic, readonly) uint64_t firstSequence;
+
+/** The report queue sequence number of the last report in the batch. */
+@property(nonatomic, readonly) uint64_t lastSequence;
+
+@end
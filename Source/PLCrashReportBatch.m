@@ -0,0 +1,255 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashReportBatch.h"
+#import "PLCrashReporterNSError.h"
+#import "PLCrashAsyncLZ.h"
+
+#import <libkern/OSByteOrder.h>
+
+/**
+ * @internal
+ *
+ * A container holding multiple encoded crash reports, and their summaries, allowing a batch of queued reports to be
+ * submitted as a single file. The container may be LZ-compressed as a whole, in which case redundancy between reports
+ * (such as shared binary image records) is also compressed.
+ */
+@implementation PLCrashReportBatch
+
+@synthesize count = _count;
+@synthesize firstSequence = _firstSequence;
+@synthesize lastSequence = _lastSequence;
+
+/* plcrash_async_lz_output_fn that appends to an NSMutableData instance */
+static bool batch_lz_output (void *ctx, const void *data, size_t len) {
+    [(NSMutableData *) ctx appendBytes: data length: len];
+    return true;
+}
+
+/**
+ * Encode a batch container.
+ *
+ * @param reports The encoded reports, as NSData instances.
+ * @param summaries The reports' summaries, as NSData instances, or NSNull for reports without a summary. This must
+ * contain one element for each element of @a reports.
+ * @param firstSequence The report queue sequence number of the first report.
+ * @param lastSequence The report queue sequence number of the last report.
+ * @param compress If YES, the container's payload will be LZ-compressed.
+ *
+ * @return Returns the encoded container, or nil if memory could not be allocated.
+ */
++ (NSData *) encodeReports: (NSArray *) reports
+                 summaries: (NSArray *) summaries
+             firstSequence: (uint64_t) firstSequence
+              lastSequence: (uint64_t) lastSequence
+                  compress: (BOOL) compress
+{
+    NSUInteger count = [reports count];
+    NSMutableData *payload = [NSMutableData dataWithLength: count * sizeof(plcrash_report_batch_entry_t)];
+
+    /* Append the reports and their summaries, filling in the index as we go */
+    for (NSUInteger i = 0; i < count; i++) {
+        NSData *report = [reports objectAtIndex: i];
+        id summary = [summaries objectAtIndex: i];
+        plcrash_report_batch_entry_t entry;
+
+        entry.offset = OSSwapHostToLittleInt64([payload length]);
+        entry.length = OSSwapHostToLittleInt64([report length]);
+        [payload appendData: report];
+
+        entry.summary_offset = OSSwapHostToLittleInt64([payload length]);
+        entry.summary_length = 0;
+        if (summary != [NSNull null]) {
+            entry.summary_length = OSSwapHostToLittleInt64([(NSData *) summary length]);
+            [payload appendData: summary];
+        }
+
+        [payload replaceBytesInRange: NSMakeRange(i * sizeof(entry), sizeof(entry)) withBytes: &entry];
+    }
+
+    /* Write the header */
+    plcrash_report_batch_header_t header;
+    memcpy(header.magic, PLCRASH_REPORT_BATCH_MAGIC, sizeof(header.magic));
+    header.version = PLCRASH_REPORT_BATCH_VERSION;
+    header.flags = OSSwapHostToLittleInt32(compress ? PLCRASH_REPORT_BATCH_FLAG_COMPRESSED : 0);
+    header.count = OSSwapHostToLittleInt32((uint32_t) count);
+    header.first_sequence = OSSwapHostToLittleInt64(firstSequence);
+    header.last_sequence = OSSwapHostToLittleInt64(lastSequence);
+
+    NSMutableData *output = [NSMutableData dataWithBytes: &header length: sizeof(header)];
+    if (!compress) {
+        [output appendData: payload];
+        return output;
+    }
+
+    /* Compress the payload. The compressor is too large to be stack allocated. */
+    plcrash_async_lz_t *lz = malloc(sizeof(*lz));
+    if (lz == NULL)
+        return nil;
+
+    plcrash_async_lz_init(lz, batch_lz_output, output);
+    bool ok = plcrash_async_lz_write(lz, [payload bytes], [payload length]) && plcrash_async_lz_flush(lz);
+    free(lz);
+
+    return ok ? output : nil;
+}
+
+/**
+ * Initialize with an encoded batch container, validating the container's index.
+ *
+ * @param data The encoded container.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error
+ * object indicating why the container could not be decoded. If no error occurs, this parameter will be left
+ * unmodified. You may specify nil for this parameter, and no error information will be provided.
+ *
+ * @return Returns nil if the container is truncated, invalid, or of an unsupported version.
+ */
+- (id) initWithData: (NSData *) data error: (NSError **) outError {
+    if ((self = [super init]) == nil)
+        return nil;
+
+    /* Validate the header */
+    plcrash_report_batch_header_t header;
+    if ([data length] < sizeof(header)) {
+        plcrash_populate_error(outError, PLCrashReporterErrorCrashReportInvalid, @"Could not decode truncated report batch", nil);
+        goto error;
+    }
+
+    memcpy(&header, [data bytes], sizeof(header));
+    uint32_t flags = OSSwapLittleToHostInt32(header.flags);
+    if (memcmp(header.magic, PLCRASH_REPORT_BATCH_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != PLCRASH_REPORT_BATCH_VERSION ||
+        (flags & ~PLCRASH_REPORT_BATCH_FLAG_COMPRESSED) != 0)
+    {
+        plcrash_populate_error(outError, PLCrashReporterErrorCrashReportInvalid, @"Could not decode invalid or unsupported report batch", nil);
+        goto error;
+    }
+
+    _count = OSSwapLittleToHostInt32(header.count);
+    _firstSequence = OSSwapLittleToHostInt64(header.first_sequence);
+    _lastSequence = OSSwapLittleToHostInt64(header.last_sequence);
+
+    /* Inflate the payload */
+    const uint8_t *payload = (const uint8_t *) [data bytes] + sizeof(header);
+    size_t payloadLength = [data length] - sizeof(header);
+    if (flags & PLCRASH_REPORT_BATCH_FLAG_COMPRESSED) {
+        size_t inflatedLength;
+        if (plcrash_nasync_lz_decoded_length(payload, payloadLength, &inflatedLength) != PLCRASH_ESUCCESS ||
+            inflatedLength > PLCRASH_REPORT_BATCH_MAX_INFLATED_LENGTH)
+        {
+            plcrash_populate_error(outError, PLCrashReporterErrorCrashReportInvalid, @"Could not decode invalid compressed report batch", nil);
+            goto error;
+        }
+
+        NSMutableData *inflated = [NSMutableData dataWithLength: inflatedLength];
+        if (inflated == nil) {
+            plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Could not allocate memory for the compressed report batch", nil);
+            goto error;
+        }
+
+        if (plcrash_nasync_lz_decode(payload, payloadLength, [inflated mutableBytes], inflatedLength) != PLCRASH_ESUCCESS) {
+            plcrash_populate_error(outError, PLCrashReporterErrorCrashReportInvalid, @"Could not decode invalid compressed report batch", nil);
+            goto error;
+        }
+
+        _payload = [inflated retain];
+    } else {
+        _payload = [[data subdataWithRange: NSMakeRange(sizeof(header), payloadLength)] retain];
+    }
+
+    /* Validate the index */
+    payloadLength = [_payload length];
+    if (_count > payloadLength / sizeof(plcrash_report_batch_entry_t)) {
+        plcrash_populate_error(outError, PLCrashReporterErrorCrashReportInvalid, @"Could not decode truncated report batch index", nil);
+        goto error;
+    }
+
+    const plcrash_report_batch_entry_t *entries = [_payload bytes];
+    for (NSUInteger i = 0; i < _count; i++) {
+        uint64_t offset = OSSwapLittleToHostInt64(entries[i].offset);
+        uint64_t length = OSSwapLittleToHostInt64(entries[i].length);
+        uint64_t summaryOffset = OSSwapLittleToHostInt64(entries[i].summary_offset);
+        uint64_t summaryLength = OSSwapLittleToHostInt64(entries[i].summary_length);
+
+        if (offset > payloadLength || length > payloadLength - offset ||
+            summaryOffset > payloadLength || summaryLength > payloadLength - summaryOffset)
+        {
+            plcrash_populate_error(outError, PLCrashReporterErrorCrashReportInvalid, @"Could not decode report batch with an invalid index entry", nil);
+            goto error;
+        }
+    }
+
+    return self;
+
+error:
+    [self release];
+    return nil;
+}
+
+- (void) dealloc {
+    [_payload release];
+    [super dealloc];
+}
+
+/* Return the index entry at @a index, converted to host byte order. */
+- (plcrash_report_batch_entry_t) entryAtIndex: (NSUInteger) index {
+    if (index >= _count)
+        [NSException raise: NSRangeException format: @"Index %lu beyond bounds [0 .. %lu]", (unsigned long) index, (unsigned long) _count];
+
+    plcrash_report_batch_entry_t entry = ((const plcrash_report_batch_entry_t *) [_payload bytes])[index];
+    entry.offset = OSSwapLittleToHostInt64(entry.offset);
+    entry.length = OSSwapLittleToHostInt64(entry.length);
+    entry.summary_offset = OSSwapLittleToHostInt64(entry.summary_offset);
+    entry.summary_length = OSSwapLittleToHostInt64(entry.summary_length);
+    return entry;
+}
+
+/**
+ * Return the encoded report at @a index.
+ *
+ * @param index The report index. An NSRangeException is raised if the index is beyond the end of the batch.
+ */
+- (NSData *) reportDataAtIndex: (NSUInteger) index {
+    plcrash_report_batch_entry_t entry = [self entryAtIndex: index];
+    return [_payload subdataWithRange: NSMakeRange((NSUInteger) entry.offset, (NSUInteger) entry.length)];
+}
+
+/**
+ * Return the summary of the report at @a index, or nil if the report has no summary.
+ *
+ * @param index The report index. An NSRangeException is raised if the index is beyond the end of the batch.
+ */
+- (NSData *) summaryDataAtIndex: (NSUInteger) index {
+    plcrash_report_batch_entry_t entry = [self entryAtIndex: index];
+    if (entry.summary_length == 0)
+        return nil;
+
+    return [_payload subdataWithRange: NSMakeRange((NSUInteger) entry.summary_offset, (NSUInteger) entry.summary_length)];
+}
+
+@end
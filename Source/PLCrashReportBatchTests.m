@@ -0,0 +1,137 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "SenTestCompat.h"
+
+#import "PLCrashReportBatch.h"
+#import "PLCrashReport.h"
+#import "PLCrashReporter.h"
+#import "PLCrashReportSummary.h"
+
+#import <libkern/OSByteOrder.h>
+
+@interface PLCrashReportBatchTests : SenTestCase @end
+
+@implementation PLCrashReportBatchTests
+
+/* Encode and decode a batch of arbitrary data, verifying the round trip. */
+- (void) roundTripWithCompression: (BOOL) compress {
+    NSMutableData *large = [NSMutableData dataWithLength: 100 * 1024];
+    memset([large mutableBytes], 'A', [large length]);
+
+    NSArray *reports = [NSArray arrayWithObjects: [NSData dataWithBytes: "first" length: 5], large, [NSData data], nil];
+    NSArray *summaries = [NSArray arrayWithObjects: [NSData dataWithBytes: "summary" length: 7], [NSNull null], [NSNull null], nil];
+
+    NSData *data = [PLCrashReportBatch encodeReports: reports summaries: summaries firstSequence: 4 lastSequence: 6 compress: compress];
+    STAssertNotNil(data, @"Failed to encode batch");
+
+    NSError *error = nil;
+    PLCrashReportBatch *batch = [[[PLCrashReportBatch alloc] initWithData: data error: &error] autorelease];
+    STAssertNotNil(batch, @"Failed to decode batch: %@", error);
+
+    STAssertEquals((NSUInteger) 3, batch.count, @"Incorrect count");
+    STAssertEquals((uint64_t) 4, batch.firstSequence, @"Incorrect first sequence");
+    STAssertEquals((uint64_t) 6, batch.lastSequence, @"Incorrect last sequence");
+
+    for (NSUInteger i = 0; i < [reports count]; i++)
+        STAssertEqualObjects([reports objectAtIndex: i], [batch reportDataAtIndex: i], @"Incorrect report %lu", (unsigned long) i);
+
+    STAssertEqualObjects([summaries objectAtIndex: 0], [batch summaryDataAtIndex: 0], @"Incorrect summary");
+    STAssertNil([batch summaryDataAtIndex: 1], @"Unexpected summary");
+
+    /* Compression applies to the batch as a whole */
+    if (compress)
+        STAssertTrue([data length] < [large length], @"Batch was not compressed");
+}
+
+- (void) testRoundTrip {
+    [self roundTripWithCompression: NO];
+}
+
+- (void) testCompressedRoundTrip {
+    [self roundTripWithCompression: YES];
+}
+
+- (void) testInvalid {
+    NSArray *reports = [NSArray arrayWithObject: [NSData dataWithBytes: "report" length: 6]];
+    NSArray *summaries = [NSArray arrayWithObject: [NSNull null]];
+    NSData *data = [PLCrashReportBatch encodeReports: reports summaries: summaries firstSequence: 1 lastSequence: 1 compress: NO];
+
+    /* Truncated */
+    NSData *truncated = [data subdataWithRange: NSMakeRange(0, [data length] - 1)];
+    STAssertNil([[[PLCrashReportBatch alloc] initWithData: truncated error: NULL] autorelease], @"Decoded a truncated batch");
+
+    /* Bad magic */
+    NSMutableData *corrupt = [[data mutableCopy] autorelease];
+    ((uint8_t *) [corrupt mutableBytes])[0] = 'x';
+    STAssertNil([[[PLCrashReportBatch alloc] initWithData: corrupt error: NULL] autorelease], @"Decoded a batch with invalid magic");
+
+    /* Index entry beyond the end of the payload */
+    corrupt = [[data mutableCopy] autorelease];
+    plcrash_report_batch_entry_t *entry = (plcrash_report_batch_entry_t *) ((uint8_t *) [corrupt mutableBytes] + sizeof(plcrash_report_batch_header_t));
+    entry->length = OSSwapHostToLittleInt64(1024);
+    STAssertNil([[[PLCrashReportBatch alloc] initWithData: corrupt error: NULL] autorelease], @"Decoded a batch with an invalid index entry");
+}
+
+- (void) testInvalidCompressedLength {
+    NSArray *reports = [NSArray arrayWithObject: [NSData dataWithBytes: "report" length: 6]];
+    NSArray *summaries = [NSArray arrayWithObject: [NSNull null]];
+    NSData *data = [PLCrashReportBatch encodeReports: reports summaries: summaries firstSequence: 1 lastSequence: 1 compress: YES];
+
+    /* Declare an implausibly large decoded length for the first LZ block */
+    NSMutableData *corrupt = [[data mutableCopy] autorelease];
+    uint32_t *blockLength = (uint32_t *) ((uint8_t *) [corrupt mutableBytes] + sizeof(plcrash_report_batch_header_t) + 4);
+    *blockLength = OSSwapHostToLittleInt32(0x7FFFFFFF);
+
+    NSError *error = nil;
+    STAssertNil([[[PLCrashReportBatch alloc] initWithData: corrupt error: &error] autorelease], @"Decoded a batch with an invalid inflated length");
+    STAssertNotNil(error, @"No error was returned");
+}
+
+- (void) testDecodeReports {
+    NSError *error = nil;
+    PLCrashReporter *reporter = [[[PLCrashReporter alloc] initWithConfiguration: [PLCrashReporterConfig defaultConfiguration]] autorelease];
+    NSData *reportData = [reporter generateLiveReportAndReturnError: &error];
+    STAssertNotNil(reportData, @"Failed to generate live report: %@", error);
+
+    NSArray *reports = [NSArray arrayWithObjects: reportData, reportData, nil];
+    NSArray *summaries = [NSArray arrayWithObjects: [NSNull null], [NSData dataWithBytes: "invalid" length: 7], nil];
+    NSData *data = [PLCrashReportBatch encodeReports: reports summaries: summaries firstSequence: 1 lastSequence: 2 compress: YES];
+
+    NSArray *decoded = [PLCrashReport reportsWithBatchData: data options: PLCrashReportDecodingOptionLazy error: &error];
+    STAssertNotNil(decoded, @"Failed to decode batch reports: %@", error);
+    STAssertEquals((NSUInteger) 2, [decoded count], @"Incorrect report count");
+    STAssertTrue([[decoded objectAtIndex: 0] isKindOfClass: [PLCrashReport class]], @"Incorrect report class");
+
+    /* Missing and invalid summaries are returned as NSNull */
+    NSArray *decodedSummaries = [PLCrashReportSummary summariesWithBatchData: data error: &error];
+    STAssertNotNil(decodedSummaries, @"Failed to decode batch summaries: %@", error);
+    STAssertEqualObjects([NSArray arrayWithObjects: [NSNull null], [NSNull null], nil], decodedSummaries, @"Incorrect summaries");
+}
+
+@end
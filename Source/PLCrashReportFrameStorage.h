@@ -0,0 +1,100 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/**
+ * @internal
+ * A single stack frame, as stored by PLCrashReportFrameStorage.
+ */
+typedef struct plcrash_report_frame {
+    /** The frame's instruction pointer. */
+    uint64_t pc;
+
+    /** The symbol start address. Only valid if @a symbol_name is non-nil. */
+    uint64_t symbol_start;
+
+    /** The symbol end address, or 0 if unknown. Only valid if @a symbol_name is non-nil. */
+    uint64_t symbol_end;
+
+    /** The symbol name, or nil if no symbol information is available. Retained by the frame storage. */
+    NSString *symbol_name;
+} plcrash_report_frame_t;
+
+@interface PLCrashReportFrameStorage : NSObject {
+@private
+    /** Stored frames. */
+    plcrash_report_frame_t *_frames;
+
+    /** Number of valid entries in @a _frames. */
+    NSUInteger _count;
+
+    /** Allocated number of entries in @a _frames. */
+    NSUInteger _capacity;
+
+    /** Interned symbol names, by report symbol name table index. Entries are nil until first used. */
+    NSString **_symbolNames;
+
+    /** Number of entries in @a _symbolNames. */
+    size_t _symbolNameCount;
+}
+
+- (id) initWithCapacity: (NSUInteger) capacity symbolNameCount: (size_t) symbolNameCount;
+
+- (NSString *) symbolNameAtIndex: (size_t) index cString: (const char *) cname;
+
+- (void) appendFrameWithInstructionPointer: (uint64_t) pc
+                                symbolName: (NSString *) symbolName
+                              startAddress: (uint64_t) startAddress
+                                endAddress: (uint64_t) endAddress;
+
+- (const plcrash_report_frame_t *) frameAtIndex: (NSUInteger) index;
+
+/** The number of stored frames. */
+@property(nonatomic, readonly) NSUInteger count;
+
+@end
+
+@interface PLCrashReportFrameArray : NSArray {
+@private
+    /** Backing frame storage. */
+    PLCrashReportFrameStorage *_storage;
+
+    /** Index of the first frame within @a _storage. */
+    NSUInteger _offset;
+
+    /** Number of frames. */
+    NSUInteger _count;
+
+    /** Lazily created PLCrashReportStackFrameInfo instances; entries are nil until first accessed. */
+    id *_objects;
+}
+
+- (id) initWithStorage: (PLCrashReportFrameStorage *) storage range: (NSRange) range;
+
+@end
@@ -0,0 +1,200 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashReportFrameStorage.h"
+#import "PLCrashReportStackFrameInfo.h"
+
+#import <libkern/OSAtomic.h>
+
+/**
+ * @internal
+ *
+ * Contiguous storage for the stack frames of a decoded crash report. Symbol names referenced from the report's
+ * symbol name table are interned, and shared by all frames that reference them.
+ */
+@implementation PLCrashReportFrameStorage
+
+/**
+ * Initialize empty frame storage.
+ *
+ * @param capacity The number of frames to be stored.
+ * @param symbolNameCount The number of entries in the report's symbol name table.
+ */
+- (id) initWithCapacity: (NSUInteger) capacity symbolNameCount: (size_t) symbolNameCount {
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _capacity = capacity;
+    _frames = calloc(capacity > 0 ? capacity : 1, sizeof(_frames[0]));
+    _symbolNameCount = symbolNameCount;
+    _symbolNames = calloc(symbolNameCount > 0 ? symbolNameCount : 1, sizeof(_symbolNames[0]));
+
+    if (_frames == NULL || _symbolNames == NULL) {
+        [self release];
+        return nil;
+    }
+
+    return self;
+}
+
+- (void) dealloc {
+    for (NSUInteger i = 0; i < _count; i++)
+        [_frames[i].symbol_name release];
+
+    for (size_t i = 0; i < _symbolNameCount; i++)
+        [_symbolNames[i] release];
+
+    free(_frames);
+    free(_symbolNames);
+    [super dealloc];
+}
+
+/**
+ * Return the interned symbol name for the report symbol name table entry at @a index, creating it from
+ * @a cname on first use.
+ *
+ * @param index The symbol name table index. Must be less than the table size provided at initialization.
+ * @param cname The NULL-terminated UTF-8 symbol name at @a index.
+ */
+- (NSString *) symbolNameAtIndex: (size_t) index cString: (const char *) cname {
+    NSParameterAssert(index < _symbolNameCount);
+
+    if (_symbolNames[index] == nil)
+        _symbolNames[index] = [[NSString alloc] initWithUTF8String: cname];
+
+    return _symbolNames[index];
+}
+
+/**
+ * Append a frame. The storage must have capacity for the frame.
+ *
+ * @param pc The frame's instruction pointer.
+ * @param symbolName The symbol name, or nil if no symbol information is available.
+ * @param startAddress The symbol start address.
+ * @param endAddress The symbol end address, or 0 if unknown.
+ */
+- (void) appendFrameWithInstructionPointer: (uint64_t) pc
+                                symbolName: (NSString *) symbolName
+                              startAddress: (uint64_t) startAddress
+                                endAddress: (uint64_t) endAddress
+{
+    NSParameterAssert(_count < _capacity);
+
+    plcrash_report_frame_t *frame = &_frames[_count++];
+    frame->pc = pc;
+    frame->symbol_start = startAddress;
+    frame->symbol_end = endAddress;
+    frame->symbol_name = [symbolName retain];
+}
+
+/**
+ * Return the frame at @a index.
+ */
+- (const plcrash_report_frame_t *) frameAtIndex: (NSUInteger) index {
+    NSParameterAssert(index < _count);
+    return &_frames[index];
+}
+
+@synthesize count = _count;
+
+@end
+
+
+/**
+ * @internal
+ *
+ * An immutable array of PLCrashReportStackFrameInfo instances backed by PLCrashReportFrameStorage. Frame
+ * instances are created on first access.
+ */
+@implementation PLCrashReportFrameArray
+
+/**
+ * Initialize with the frames in @a range of @a storage.
+ */
+- (id) initWithStorage: (PLCrashReportFrameStorage *) storage range: (NSRange) range {
+    if ((self = [super init]) == nil)
+        return nil;
+
+    NSParameterAssert(NSMaxRange(range) <= [storage count]);
+
+    _storage = [storage retain];
+    _offset = range.location;
+    _count = range.length;
+    _objects = calloc(_count > 0 ? _count : 1, sizeof(_objects[0]));
+    if (_objects == NULL) {
+        [self release];
+        return nil;
+    }
+
+    return self;
+}
+
+- (void) dealloc {
+    if (_objects != NULL) {
+        for (NSUInteger i = 0; i < _count; i++)
+            [_objects[i] release];
+        free(_objects);
+    }
+
+    [_storage release];
+    [super dealloc];
+}
+
+// from NSArray
+- (NSUInteger) count {
+    return _count;
+}
+
+// from NSArray
+- (id) objectAtIndex: (NSUInteger) index {
+    if (index >= _count)
+        [NSException raise: NSRangeException format: @"Index %lu beyond bounds [0 .. %lu]", (unsigned long) index, (unsigned long) _count];
+
+    id object = _objects[index];
+    if (object != nil)
+        return object;
+
+    /* Create the frame instance; if another thread wins the race, use its instance instead */
+    const plcrash_report_frame_t *frame = [_storage frameAtIndex: _offset + index];
+    PLCrashReportSymbolInfo *symbolInfo = nil;
+    if (frame->symbol_name != nil) {
+        symbolInfo = [[[PLCrashReportSymbolInfo alloc] initWithSymbolName: frame->symbol_name
+                                                             startAddress: frame->symbol_start
+                                                               endAddress: frame->symbol_end] autorelease];
+    }
+
+    object = [[PLCrashReportStackFrameInfo alloc] initWithInstructionPointer: frame->pc symbolInfo: symbolInfo];
+    if (!OSAtomicCompareAndSwapPtrBarrier(nil, object, (void * volatile *) &_objects[index])) {
+        [object release];
+        object = _objects[index];
+    }
+
+    return object;
+}
+
+@end
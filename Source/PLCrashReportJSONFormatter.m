@@ -0,0 +1,540 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "CrashReporter.h"
+
+#import "PLCrashReportJSONFormatter.h"
+#import "PLCrashTextBuffer.h"
+
+#import <errno.h>
+
+@interface PLCrashReportJSONFormatter (PrivateAPI)
++ (void) writeCrashReport: (PLCrashReport *) report buffer: (plcrash_text_buffer_t *) buffer;
++ (void) writeStackFrames: (NSArray *) frames buffer: (plcrash_text_buffer_t *) buffer;
+@end
+
+/**
+ * @internal
+ * Append @a string to @a buffer as a quoted JSON string, or as null if @a string is nil.
+ */
+static void json_append_string (plcrash_text_buffer_t *buffer, NSString *string) {
+    static const char hex[] = "0123456789abcdef";
+
+    if (string == nil) {
+        plcrash_text_buffer_append_cstring(buffer, "null");
+        return;
+    }
+
+    const char *utf8 = [string UTF8String];
+    const char *start = utf8;
+    const char *p;
+
+    plcrash_text_buffer_append(buffer, "\"", 1);
+    for (p = utf8; *p != '\0'; p++) {
+        unsigned char c = (unsigned char) *p;
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        /* Flush the unescaped run, and write the escape sequence */
+        plcrash_text_buffer_append(buffer, start, (size_t) (p - start));
+        start = p + 1;
+
+        switch (c) {
+            case '"':  plcrash_text_buffer_append(buffer, "\\\"", 2); break;
+            case '\\': plcrash_text_buffer_append(buffer, "\\\\", 2); break;
+            case '\n': plcrash_text_buffer_append(buffer, "\\n", 2); break;
+            case '\r': plcrash_text_buffer_append(buffer, "\\r", 2); break;
+            case '\t': plcrash_text_buffer_append(buffer, "\\t", 2); break;
+            default: {
+                char escape[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+                plcrash_text_buffer_append(buffer, escape, sizeof(escape));
+                break;
+            }
+        }
+    }
+    plcrash_text_buffer_append(buffer, start, (size_t) (p - start));
+    plcrash_text_buffer_append(buffer, "\"", 1);
+}
+
+/**
+ * @internal
+ * Append an object member key to @a buffer, preceded by a separator if @a first is false. Sets @a first to false.
+ */
+static void json_append_key (plcrash_text_buffer_t *buffer, const char *key, bool *first) {
+    if (!*first)
+        plcrash_text_buffer_append(buffer, ",", 1);
+    *first = false;
+
+    plcrash_text_buffer_append(buffer, "\"", 1);
+    plcrash_text_buffer_append_cstring(buffer, key);
+    plcrash_text_buffer_append(buffer, "\":", 2);
+}
+
+/**
+ * @internal
+ * Append @a value to @a buffer as a quoted "0x"-prefixed hexadecimal string. Addresses are written as strings,
+ * as 64-bit values may not be exactly representable by JSON readers.
+ */
+static void json_append_address (plcrash_text_buffer_t *buffer, uint64_t value) {
+    plcrash_text_buffer_append(buffer, "\"0x", 3);
+    plcrash_text_buffer_append_hex(buffer, value, 1);
+    plcrash_text_buffer_append(buffer, "\"", 1);
+}
+
+/**
+ * @internal
+ * Append @a value to @a buffer as a JSON boolean.
+ */
+static void json_append_bool (plcrash_text_buffer_t *buffer, BOOL value) {
+    plcrash_text_buffer_append_cstring(buffer, value ? "true" : "false");
+}
+
+/**
+ * @internal
+ * Append @a date to @a buffer as integral seconds since the UNIX epoch, or as null if @a date is nil.
+ */
+static void json_append_date (plcrash_text_buffer_t *buffer, NSDate *date) {
+    if (date == nil) {
+        plcrash_text_buffer_append_cstring(buffer, "null");
+        return;
+    }
+
+    plcrash_text_buffer_append_decimal(buffer, (int64_t) [date timeIntervalSince1970], 0);
+}
+
+/**
+ * @internal
+ * Append @a processor to @a buffer as a JSON object, or as null if @a processor is nil.
+ */
+static void json_append_processor (plcrash_text_buffer_t *buffer, PLCrashReportProcessorInfo *processor) {
+    if (processor == nil) {
+        plcrash_text_buffer_append_cstring(buffer, "null");
+        return;
+    }
+
+    bool first = true;
+    plcrash_text_buffer_append(buffer, "{", 1);
+    json_append_key(buffer, "type_encoding", &first);
+    plcrash_text_buffer_append_unsigned(buffer, processor.typeEncoding);
+    json_append_key(buffer, "type", &first);
+    plcrash_text_buffer_append_unsigned(buffer, processor.type);
+    json_append_key(buffer, "subtype", &first);
+    plcrash_text_buffer_append_unsigned(buffer, processor.subtype);
+    plcrash_text_buffer_append(buffer, "}", 1);
+}
+
+/**
+ * Formats PLCrashReport data as JSON.
+ *
+ * The report is written as a single UTF-8 JSON object, directly from the decoded report; no intermediate
+ * property list representation is constructed. Addresses are written as "0x"-prefixed hexadecimal strings.
+ */
+@implementation PLCrashReportJSONFormatter
+
+/**
+ * Formats the provided @a report as JSON, writing the result to @a fd. Output is streamed through a fixed-size
+ * buffer, rather than accumulating the formatted report in memory.
+ *
+ * @param report The report to format.
+ * @param fd The file descriptor to which the formatted report will be written.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error
+ * object indicating why the report could not be written. If no error occurs, this parameter will be left
+ * unmodified. You may specify nil for this parameter, and no error information will be provided.
+ *
+ * @return Returns YES on success, or NO if an error occurs.
+ */
++ (BOOL) writeCrashReport: (PLCrashReport *) report toFileDescriptor: (int) fd error: (NSError **) outError {
+    plcrash_text_buffer_t buffer;
+    if (!plcrash_text_buffer_init(&buffer, fd)) {
+        if (outError != NULL)
+            *outError = [NSError errorWithDomain: NSPOSIXErrorDomain code: ENOMEM userInfo: nil];
+        return NO;
+    }
+
+    [self writeCrashReport: report buffer: &buffer];
+    plcrash_text_buffer_flush(&buffer);
+
+    int error = buffer.error;
+    plcrash_text_buffer_free(&buffer);
+
+    if (error != 0) {
+        if (outError != NULL)
+            *outError = [NSError errorWithDomain: NSPOSIXErrorDomain code: error userInfo: nil];
+        return NO;
+    }
+
+    return YES;
+}
+
+// from PLCrashReportFormatter protocol
+- (NSData *) formatReport: (PLCrashReport *) report error: (NSError **) outError {
+    plcrash_text_buffer_t buffer;
+    if (!plcrash_text_buffer_init(&buffer, -1)) {
+        if (outError != NULL)
+            *outError = [NSError errorWithDomain: NSPOSIXErrorDomain code: ENOMEM userInfo: nil];
+        return nil;
+    }
+
+    [PLCrashReportJSONFormatter writeCrashReport: report buffer: &buffer];
+    if (buffer.error != 0) {
+        if (outError != NULL)
+            *outError = [NSError errorWithDomain: NSPOSIXErrorDomain code: buffer.error userInfo: nil];
+        plcrash_text_buffer_free(&buffer);
+        return nil;
+    }
+
+    return [NSData dataWithBytesNoCopy: buffer.data length: buffer.length freeWhenDone: YES];
+}
+
+@end
+
+
+@implementation PLCrashReportJSONFormatter (PrivateMethods)
+
+/**
+ * @internal
+ * Format the provided @a report as a JSON object, appending the result to @a buffer.
+ *
+ * @param report The report to format.
+ * @param buffer The output buffer.
+ */
++ (void) writeCrashReport: (PLCrashReport *) report buffer: (plcrash_text_buffer_t *) buffer {
+    bool first = true;
+    plcrash_text_buffer_append(buffer, "{", 1);
+
+    /* Incident identifier */
+    json_append_key(buffer, "incident", &first);
+    if (report.uuidRef != NULL) {
+        NSString *uuid = [(NSString *) CFUUIDCreateString(NULL, report.uuidRef) autorelease];
+        json_append_string(buffer, uuid);
+    } else {
+        json_append_string(buffer, nil);
+    }
+
+    /* System */
+    {
+        PLCrashReportSystemInfo *system = report.systemInfo;
+        bool sfirst = true;
+
+        json_append_key(buffer, "system", &first);
+        plcrash_text_buffer_append(buffer, "{", 1);
+        json_append_key(buffer, "operating_system", &sfirst);
+        plcrash_text_buffer_append_unsigned(buffer, system.operatingSystem);
+        json_append_key(buffer, "version", &sfirst);
+        json_append_string(buffer, system.operatingSystemVersion);
+        json_append_key(buffer, "build", &sfirst);
+        json_append_string(buffer, system.operatingSystemBuild);
+        json_append_key(buffer, "timestamp", &sfirst);
+        json_append_date(buffer, system.timestamp);
+        plcrash_text_buffer_append(buffer, "}", 1);
+    }
+
+    /* Machine */
+    if (report.hasMachineInfo) {
+        PLCrashReportMachineInfo *machine = report.machineInfo;
+        bool mfirst = true;
+
+        json_append_key(buffer, "machine", &first);
+        plcrash_text_buffer_append(buffer, "{", 1);
+        json_append_key(buffer, "model", &mfirst);
+        json_append_string(buffer, machine.modelName);
+        json_append_key(buffer, "processor", &mfirst);
+        json_append_processor(buffer, machine.processorInfo);
+        json_append_key(buffer, "processor_count", &mfirst);
+        plcrash_text_buffer_append_unsigned(buffer, machine.processorCount);
+        json_append_key(buffer, "logical_processor_count", &mfirst);
+        plcrash_text_buffer_append_unsigned(buffer, machine.logicalProcessorCount);
+        plcrash_text_buffer_append(buffer, "}", 1);
+    }
+
+    /* Application */
+    {
+        PLCrashReportApplicationInfo *application = report.applicationInfo;
+        bool afirst = true;
+
+        json_append_key(buffer, "application", &first);
+        plcrash_text_buffer_append(buffer, "{", 1);
+        json_append_key(buffer, "identifier", &afirst);
+        json_append_string(buffer, application.applicationIdentifier);
+        json_append_key(buffer, "version", &afirst);
+        json_append_string(buffer, application.applicationVersion);
+        json_append_key(buffer, "marketing_version", &afirst);
+        json_append_string(buffer, application.applicationMarketingVersion);
+        plcrash_text_buffer_append(buffer, "}", 1);
+    }
+
+    /* Process */
+    if (report.hasProcessInfo) {
+        PLCrashReportProcessInfo *process = report.processInfo;
+        bool pfirst = true;
+
+        json_append_key(buffer, "process", &first);
+        plcrash_text_buffer_append(buffer, "{", 1);
+        json_append_key(buffer, "name", &pfirst);
+        json_append_string(buffer, process.processName);
+        json_append_key(buffer, "pid", &pfirst);
+        plcrash_text_buffer_append_unsigned(buffer, process.processID);
+        json_append_key(buffer, "path", &pfirst);
+        json_append_string(buffer, process.processPath);
+        json_append_key(buffer, "start_time", &pfirst);
+        json_append_date(buffer, process.processStartTime);
+        json_append_key(buffer, "parent_name", &pfirst);
+        json_append_string(buffer, process.parentProcessName);
+        json_append_key(buffer, "parent_pid", &pfirst);
+        plcrash_text_buffer_append_unsigned(buffer, process.parentProcessID);
+        json_append_key(buffer, "native", &pfirst);
+        json_append_bool(buffer, process.native);
+        plcrash_text_buffer_append(buffer, "}", 1);
+    }
+
+    /* Signal */
+    {
+        PLCrashReportSignalInfo *signal = report.signalInfo;
+        bool sfirst = true;
+
+        json_append_key(buffer, "signal", &first);
+        plcrash_text_buffer_append(buffer, "{", 1);
+        json_append_key(buffer, "name", &sfirst);
+        json_append_string(buffer, signal.name);
+        json_append_key(buffer, "code", &sfirst);
+        json_append_string(buffer, signal.code);
+        json_append_key(buffer, "address", &sfirst);
+        json_append_address(buffer, signal.address);
+        plcrash_text_buffer_append(buffer, "}", 1);
+    }
+
+    /* Mach exception */
+    if (report.machExceptionInfo != nil) {
+        PLCrashReportMachExceptionInfo *machException = report.machExceptionInfo;
+        bool mfirst = true;
+
+        json_append_key(buffer, "mach_exception", &first);
+        plcrash_text_buffer_append(buffer, "{", 1);
+        json_append_key(buffer, "type", &mfirst);
+        plcrash_text_buffer_append_unsigned(buffer, machException.type);
+        json_append_key(buffer, "codes", &mfirst);
+        plcrash_text_buffer_append(buffer, "[", 1);
+        NSUInteger i = 0;
+        for (NSNumber *code in machException.codes) {
+            if (i++ > 0)
+                plcrash_text_buffer_append(buffer, ",", 1);
+            json_append_address(buffer, [code unsignedLongLongValue]);
+        }
+        plcrash_text_buffer_append(buffer, "]}", 2);
+    }
+
+    /* Uncaught exception */
+    if (report.hasExceptionInfo) {
+        PLCrashReportExceptionInfo *exception = report.exceptionInfo;
+        bool efirst = true;
+
+        json_append_key(buffer, "exception", &first);
+        plcrash_text_buffer_append(buffer, "{", 1);
+        json_append_key(buffer, "name", &efirst);
+        json_append_string(buffer, exception.exceptionName);
+        json_append_key(buffer, "reason", &efirst);
+        json_append_string(buffer, exception.exceptionReason);
+        if (exception.stackFrames != nil) {
+            json_append_key(buffer, "frames", &efirst);
+            [self writeStackFrames: exception.stackFrames buffer: buffer];
+        }
+        plcrash_text_buffer_append(buffer, "}", 1);
+    }
+
+    /* Threads */
+    json_append_key(buffer, "threads", &first);
+    plcrash_text_buffer_append(buffer, "[", 1);
+    {
+        NSUInteger i = 0;
+        for (PLCrashReportThreadInfo *thread in report.threads) {
+            bool tfirst = true;
+
+            if (i++ > 0)
+                plcrash_text_buffer_append(buffer, ",", 1);
+
+            plcrash_text_buffer_append(buffer, "{", 1);
+            json_append_key(buffer, "number", &tfirst);
+            plcrash_text_buffer_append_decimal(buffer, thread.threadNumber, 0);
+            json_append_key(buffer, "crashed", &tfirst);
+            json_append_bool(buffer, thread.crashed);
+            if (thread.threadIdentifier != 0) {
+                json_append_key(buffer, "id", &tfirst);
+                plcrash_text_buffer_append_unsigned(buffer, thread.threadIdentifier);
+            }
+            if (thread.name != nil) {
+                json_append_key(buffer, "name", &tfirst);
+                json_append_string(buffer, thread.name);
+            }
+            if (thread.dispatchQueueLabel != nil) {
+                json_append_key(buffer, "queue", &tfirst);
+                json_append_string(buffer, thread.dispatchQueueLabel);
+            }
+            if (thread.qosClass != 0) {
+                json_append_key(buffer, "qos_class", &tfirst);
+                plcrash_text_buffer_append_unsigned(buffer, thread.qosClass);
+            }
+            if (thread.hasCPUTime) {
+                json_append_key(buffer, "user_time_ns", &tfirst);
+                plcrash_text_buffer_append_unsigned(buffer, thread.userTime);
+                json_append_key(buffer, "system_time_ns", &tfirst);
+                plcrash_text_buffer_append_unsigned(buffer, thread.systemTime);
+            }
+            json_append_key(buffer, "frames", &tfirst);
+            [self writeStackFrames: thread.stackFrames buffer: buffer];
+
+            if (thread.crashed) {
+                bool rfirst = true;
+
+                json_append_key(buffer, "registers", &tfirst);
+                plcrash_text_buffer_append(buffer, "{", 1);
+                for (PLCrashReportRegisterInfo *reg in thread.registers) {
+                    json_append_key(buffer, [reg.registerName UTF8String], &rfirst);
+                    json_append_address(buffer, reg.registerValue);
+                }
+                plcrash_text_buffer_append(buffer, "}", 1);
+            }
+
+            plcrash_text_buffer_append(buffer, "}", 1);
+        }
+    }
+    plcrash_text_buffer_append(buffer, "]", 1);
+
+    /* Images */
+    json_append_key(buffer, "images", &first);
+    plcrash_text_buffer_append(buffer, "[", 1);
+    {
+        NSUInteger i = 0;
+        for (PLCrashReportBinaryImageInfo *image in report.images) {
+            bool ifirst = true;
+
+            if (i++ > 0)
+                plcrash_text_buffer_append(buffer, ",", 1);
+
+            plcrash_text_buffer_append(buffer, "{", 1);
+            json_append_key(buffer, "base", &ifirst);
+            json_append_address(buffer, image.imageBaseAddress);
+            json_append_key(buffer, "size", &ifirst);
+            plcrash_text_buffer_append_unsigned(buffer, image.imageSize);
+            json_append_key(buffer, "name", &ifirst);
+            json_append_string(buffer, image.imageName);
+            json_append_key(buffer, "uuid", &ifirst);
+            json_append_string(buffer, image.hasImageUUID ? image.imageUUID : nil);
+            json_append_key(buffer, "processor", &ifirst);
+            json_append_processor(buffer, image.codeType);
+            plcrash_text_buffer_append(buffer, "}", 1);
+        }
+    }
+    plcrash_text_buffer_append(buffer, "]", 1);
+
+    if (report.omittedImageCount > 0) {
+        json_append_key(buffer, "omitted_image_count", &first);
+        plcrash_text_buffer_append_unsigned(buffer, report.omittedImageCount);
+    }
+
+    /* Memory statistics */
+    if (report.memoryStatistics != nil) {
+        PLCrashReportMemoryStatistics *stats = report.memoryStatistics;
+        bool mfirst = true;
+        NSUInteger i = 0;
+
+        json_append_key(buffer, "memory", &first);
+        plcrash_text_buffer_append(buffer, "{", 1);
+        json_append_key(buffer, "phys_footprint", &mfirst);
+        plcrash_text_buffer_append_unsigned(buffer, stats.physicalFootprint);
+        json_append_key(buffer, "resident_size", &mfirst);
+        plcrash_text_buffer_append_unsigned(buffer, stats.residentSize);
+        json_append_key(buffer, "resident_size_peak", &mfirst);
+        plcrash_text_buffer_append_unsigned(buffer, stats.peakResidentSize);
+        json_append_key(buffer, "compressed_size", &mfirst);
+        plcrash_text_buffer_append_unsigned(buffer, stats.compressedSize);
+        json_append_key(buffer, "virtual_size", &mfirst);
+        plcrash_text_buffer_append_unsigned(buffer, stats.virtualSize);
+        json_append_key(buffer, "region_count", &mfirst);
+        plcrash_text_buffer_append_unsigned(buffer, stats.regionCount);
+        json_append_key(buffer, "largest_regions", &mfirst);
+        plcrash_text_buffer_append(buffer, "[", 1);
+        for (PLCrashReportMemoryRegion *region in stats.largestRegions) {
+            bool rfirst = true;
+
+            if (i++ > 0)
+                plcrash_text_buffer_append(buffer, ",", 1);
+
+            plcrash_text_buffer_append(buffer, "{", 1);
+            json_append_key(buffer, "address", &rfirst);
+            json_append_address(buffer, region.address);
+            json_append_key(buffer, "size", &rfirst);
+            plcrash_text_buffer_append_unsigned(buffer, region.size);
+            json_append_key(buffer, "protection", &rfirst);
+            plcrash_text_buffer_append_unsigned(buffer, region.protection);
+            json_append_key(buffer, "tag", &rfirst);
+            plcrash_text_buffer_append_unsigned(buffer, region.userTag);
+            plcrash_text_buffer_append(buffer, "}", 1);
+        }
+        plcrash_text_buffer_append(buffer, "]", 1);
+        json_append_key(buffer, "regions_truncated", &mfirst);
+        json_append_bool(buffer, stats.regionsTruncated);
+        plcrash_text_buffer_append(buffer, "}", 1);
+    }
+
+    plcrash_text_buffer_append(buffer, "}\n", 2);
+}
+
+/**
+ * @internal
+ * Format @a frames as a JSON array, appending the result to @a buffer.
+ *
+ * @param frames The PLCrashReportStackFrameInfo instances to format.
+ * @param buffer The output buffer.
+ */
++ (void) writeStackFrames: (NSArray *) frames buffer: (plcrash_text_buffer_t *) buffer {
+    NSUInteger i = 0;
+
+    plcrash_text_buffer_append(buffer, "[", 1);
+    for (PLCrashReportStackFrameInfo *frame in frames) {
+        bool ffirst = true;
+
+        if (i++ > 0)
+            plcrash_text_buffer_append(buffer, ",", 1);
+
+        plcrash_text_buffer_append(buffer, "{", 1);
+        json_append_key(buffer, "pc", &ffirst);
+        json_append_address(buffer, frame.instructionPointer);
+
+        if (frame.symbolInfo != nil) {
+            json_append_key(buffer, "symbol", &ffirst);
+            json_append_string(buffer, frame.symbolInfo.symbolName);
+            json_append_key(buffer, "symbol_start", &ffirst);
+            json_append_address(buffer, frame.symbolInfo.startAddress);
+        }
+
+        plcrash_text_buffer_append(buffer, "}", 1);
+    }
+    plcrash_text_buffer_append(buffer, "]", 1);
+}
+
+@end
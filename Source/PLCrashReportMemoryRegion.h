@@ -0,0 +1,60 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+@interface PLCrashReportMemoryRegion : NSObject {
+@private
+    /** The region's start address. */
+    uint64_t _address;
+
+    /** The region's size, in bytes. */
+    uint64_t _size;
+
+    /** The region's current protection. */
+    uint32_t _protection;
+
+    /** The region's VM user tag. */
+    uint32_t _userTag;
+}
+
+- (id) initWithAddress: (uint64_t) address size: (uint64_t) size protection: (uint32_t) protection userTag: (uint32_t) userTag;
+
+/** The region's start address. */
+@property(nonatomic, readonly) uint64_t address;
+
+/** The region's size, in bytes. */
+@property(nonatomic, readonly) uint64_t size;
+
+/** The region's current protection, as a set of VM_PROT_* flags. */
+@property(nonatomic, readonly) uint32_t protection;
+
+/** The region's VM user tag, as a VM_MEMORY_* value, identifying the allocator responsible for the region. */
+@property(nonatomic, readonly) uint32_t userTag;
+
+@end
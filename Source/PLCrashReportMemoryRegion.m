@@ -0,0 +1,61 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashReportMemoryRegion.h"
+
+/**
+ * A virtual memory region recorded in a crash report's memory statistics.
+ */
+@implementation PLCrashReportMemoryRegion
+
+@synthesize address = _address;
+@synthesize size = _size;
+@synthesize protection = _protection;
+@synthesize userTag = _userTag;
+
+/**
+ * Initialize a new memory region data object.
+ *
+ * @param address The region's start address.
+ * @param size The region's size, in bytes.
+ * @param protection The region's current protection.
+ * @param userTag The region's VM user tag.
+ */
+- (id) initWithAddress: (uint64_t) address size: (uint64_t) size protection: (uint32_t) protection userTag: (uint32_t) userTag {
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _address = address;
+    _size = size;
+    _protection = protection;
+    _userTag = userTag;
+
+    return self;
+}
+
+@end
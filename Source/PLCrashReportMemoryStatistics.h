@@ -0,0 +1,96 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "PLCrashReportMemoryRegion.h"
+
+@interface PLCrashReportMemoryStatistics : NSObject {
+@private
+    /** The physical memory footprint, in bytes. */
+    uint64_t _physicalFootprint;
+
+    /** The resident memory size, in bytes. */
+    uint64_t _residentSize;
+
+    /** The peak resident memory size, in bytes. */
+    uint64_t _peakResidentSize;
+
+    /** The compressed memory size, in bytes. */
+    uint64_t _compressedSize;
+
+    /** The virtual memory size, in bytes. */
+    uint64_t _virtualSize;
+
+    /** The number of VM regions. */
+    NSUInteger _regionCount;
+
+    /** The largest regions walked (PLCrashReportMemoryRegion instances). */
+    NSArray *_largestRegions;
+
+    /** YES if the region walk ended before the end of the address space. */
+    BOOL _regionsTruncated;
+}
+
+- (id) initWithPhysicalFootprint: (uint64_t) physicalFootprint
+                    residentSize: (uint64_t) residentSize
+                peakResidentSize: (uint64_t) peakResidentSize
+                  compressedSize: (uint64_t) compressedSize
+                     virtualSize: (uint64_t) virtualSize
+                     regionCount: (NSUInteger) regionCount
+                  largestRegions: (NSArray *) largestRegions
+                regionsTruncated: (BOOL) regionsTruncated;
+
+/** The process' physical memory footprint, in bytes. This is the value against which the kernel enforces the
+ * process' memory limit. */
+@property(nonatomic, readonly) uint64_t physicalFootprint;
+
+/** The process' resident memory size, in bytes. */
+@property(nonatomic, readonly) uint64_t residentSize;
+
+/** The process' peak resident memory size, in bytes. */
+@property(nonatomic, readonly) uint64_t peakResidentSize;
+
+/** The size of the process' compressed memory, in bytes. */
+@property(nonatomic, readonly) uint64_t compressedSize;
+
+/** The process' virtual memory size, in bytes. */
+@property(nonatomic, readonly) uint64_t virtualSize;
+
+/** The number of VM regions in the process' address space. */
+@property(nonatomic, readonly) NSUInteger regionCount;
+
+/** The largest VM regions found by a bounded walk of the process' address space, as PLCrashReportMemoryRegion
+ * instances, largest first. */
+@property(nonatomic, readonly) NSArray *largestRegions;
+
+/** If YES, the region walk ended before reaching the end of the address space, and largestRegions are only the
+ * largest of the regions walked. */
+@property(nonatomic, readonly) BOOL regionsTruncated;
+
+@end
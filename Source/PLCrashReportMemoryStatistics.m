@@ -0,0 +1,88 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashReportMemoryStatistics.h"
+
+/**
+ * Crash log memory statistics.
+ *
+ * Provides a snapshot of the process' memory usage, captured at the time the report was written.
+ */
+@implementation PLCrashReportMemoryStatistics
+
+@synthesize physicalFootprint = _physicalFootprint;
+@synthesize residentSize = _residentSize;
+@synthesize peakResidentSize = _peakResidentSize;
+@synthesize compressedSize = _compressedSize;
+@synthesize virtualSize = _virtualSize;
+@synthesize regionCount = _regionCount;
+@synthesize largestRegions = _largestRegions;
+@synthesize regionsTruncated = _regionsTruncated;
+
+/**
+ * Initialize a new memory statistics data object.
+ *
+ * @param physicalFootprint The physical memory footprint, in bytes.
+ * @param residentSize The resident memory size, in bytes.
+ * @param peakResidentSize The peak resident memory size, in bytes.
+ * @param compressedSize The compressed memory size, in bytes.
+ * @param virtualSize The virtual memory size, in bytes.
+ * @param regionCount The number of VM regions.
+ * @param largestRegions The largest regions walked, as PLCrashReportMemoryRegion instances, largest first.
+ * @param regionsTruncated YES if the region walk ended before reaching the end of the address space.
+ */
+- (id) initWithPhysicalFootprint: (uint64_t) physicalFootprint
+                    residentSize: (uint64_t) residentSize
+                peakResidentSize: (uint64_t) peakResidentSize
+                  compressedSize: (uint64_t) compressedSize
+                     virtualSize: (uint64_t) virtualSize
+                     regionCount: (NSUInteger) regionCount
+                  largestRegions: (NSArray *) largestRegions
+                regionsTruncated: (BOOL) regionsTruncated
+{
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _physicalFootprint = physicalFootprint;
+    _residentSize = residentSize;
+    _peakResidentSize = peakResidentSize;
+    _compressedSize = compressedSize;
+    _virtualSize = virtualSize;
+    _regionCount = regionCount;
+    _largestRegions = [largestRegions retain];
+    _regionsTruncated = regionsTruncated;
+
+    return self;
+}
+
+- (void) dealloc {
+    [_largestRegions release];
+    [super dealloc];
+}
+
+@end
@@ -53,6 +53,12 @@
     
     /** If false, the process is being run via process-level CPU emulation (such as Rosetta). */
     BOOL _native;
+
+    /** The 16 byte dyld shared cache UUID, or nil if unavailable. */
+    NSData *_sharedCacheUUID;
+
+    /** The dyld shared cache base address, or 0 if unavailable. */
+    uint64_t _sharedCacheBaseAddress;
 }
 
 - (id) initWithProcessName: (NSString *) processName
@@ -63,6 +69,16 @@
            parentProcessID: (NSUInteger) parentProcessID
                     native: (BOOL) native;
 
+- (id) initWithProcessName: (NSString *) processName
+                 processID: (NSUInteger) processID
+               processPath: (NSString *) processPath
+          processStartTime: (NSDate *) processStartTime
+         parentProcessName: (NSString *) parentProcessName
+           parentProcessID: (NSUInteger) parentProcessID
+                    native: (BOOL) native
+           sharedCacheUUID: (NSData *) sharedCacheUUID
+    sharedCacheBaseAddress: (uint64_t) sharedCacheBaseAddress;
+
 /**
  * The process name. This value may not be included in the crash report, in which case this property
  * will be nil.
@@ -100,4 +116,16 @@
 /** The process' native execution status. If false, the process is being run via process-level CPU emulation (such as Rosetta). */
 @property(nonatomic, readonly) BOOL native;
 
+/**
+ * The 16 byte UUID of the dyld shared cache mapped into the process. This value may not be included in the crash
+ * report, in which case this property will be nil.
+ */
+@property(nonatomic, readonly) NSData *sharedCacheUUID;
+
+/**
+ * The address at which the dyld shared cache was mapped. This value may not be included in the crash report, in which
+ * case this property will be 0.
+ */
+@property(nonatomic, readonly) uint64_t sharedCacheBaseAddress;
+
 @end
@@ -57,6 +57,41 @@
          parentProcessName: (NSString *) parentProcessName
            parentProcessID: (NSUInteger) parentProcessID
                     native: (BOOL) native
+{
+    return [self initWithProcessName: processName
+                           processID: processID
+                         processPath: processPath
+                    processStartTime: processStartTime
+                   parentProcessName: parentProcessName
+                     parentProcessID: parentProcessID
+                              native: native
+                     sharedCacheUUID: nil
+              sharedCacheBaseAddress: 0];
+}
+
+/**
+ * Initialize with the provided process details.
+ *
+ * @param processName Process name. May be nil.
+ * @param processID Process PID.
+ * @param processPath Full path to the process' binary. May be nil.
+ * @param processStartTime Date and time that the crashing process was started. May be nil.
+ * @param parentProcessName Parent process' name. May be nil.
+ * @param parentProcessID Parent process' PID.
+ * @param native Flag designating whether this process is native. If false, the process is being run via process-level
+ * CPU emulation (such as Rosetta).
+ * @param sharedCacheUUID The dyld shared cache UUID. May be nil.
+ * @param sharedCacheBaseAddress The dyld shared cache base address, or 0 if unknown.
+ */
+- (id) initWithProcessName: (NSString *) processName
+                 processID: (NSUInteger) processID
+               processPath: (NSString *) processPath
+          processStartTime: (NSDate *) processStartTime
+         parentProcessName: (NSString *) parentProcessName
+           parentProcessID: (NSUInteger) parentProcessID
+                    native: (BOOL) native
+           sharedCacheUUID: (NSData *) sharedCacheUUID
+    sharedCacheBaseAddress: (uint64_t) sharedCacheBaseAddress
 {
     if ((self = [super init]) == nil)
         return nil;
@@ -68,6 +103,8 @@
     _parentProcessName = [parentProcessName retain];
     _parentProcessID = parentProcessID;
     _native = native;
+    _sharedCacheUUID = [sharedCacheUUID retain];
+    _sharedCacheBaseAddress = sharedCacheBaseAddress;
 
     return self;
 }
@@ -77,6 +114,7 @@
     [_processPath release];
     [_processStartTime release];
     [_parentProcessName release];
+    [_sharedCacheUUID release];
     [super dealloc];
 }
 
@@ -87,5 +125,7 @@
 @synthesize parentProcessName = _parentProcessName;
 @synthesize parentProcessID = _parentProcessID;
 @synthesize native = _native;
+@synthesize sharedCacheUUID = _sharedCacheUUID;
+@synthesize sharedCacheBaseAddress = _sharedCacheBaseAddress;
 
 @end
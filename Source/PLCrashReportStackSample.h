@@ -0,0 +1,56 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+@interface PLCrashReportStackSample : NSObject {
+@private
+    /** Index of the sampled thread. */
+    NSUInteger _threadIndex;
+
+    /** Number of samples in which the stack was observed. */
+    NSUInteger _sampleCount;
+
+    /** The stack's PC values (NSNumber instances). */
+    NSArray *_instructionPointers;
+}
+
+- (id) initWithThreadIndex: (NSUInteger) threadIndex
+               sampleCount: (NSUInteger) sampleCount
+       instructionPointers: (NSArray *) instructionPointers;
+
+/** The index of the sampled thread, in the order in which the sampled threads were selected. */
+@property(nonatomic, readonly) NSUInteger threadIndex;
+
+/** The number of samples in which this stack was observed. */
+@property(nonatomic, readonly) NSUInteger sampleCount;
+
+/** The stack's instruction pointer values, as NSNumber instances, starting with the innermost frame. */
+@property(nonatomic, readonly) NSArray *instructionPointers;
+
+@end
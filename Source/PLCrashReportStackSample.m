@@ -0,0 +1,66 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashReportStackSample.h"
+
+/**
+ * A unique stack observed by the stack sampler, and the number of samples in which it was observed.
+ */
+@implementation PLCrashReportStackSample
+
+@synthesize threadIndex = _threadIndex;
+@synthesize sampleCount = _sampleCount;
+@synthesize instructionPointers = _instructionPointers;
+
+/**
+ * Initialize a new stack sample data object.
+ *
+ * @param threadIndex The index of the sampled thread.
+ * @param sampleCount The number of samples in which the stack was observed.
+ * @param instructionPointers The stack's instruction pointer values, as NSNumber instances.
+ */
+- (id) initWithThreadIndex: (NSUInteger) threadIndex
+               sampleCount: (NSUInteger) sampleCount
+       instructionPointers: (NSArray *) instructionPointers
+{
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _threadIndex = threadIndex;
+    _sampleCount = sampleCount;
+    _instructionPointers = [instructionPointers retain];
+
+    return self;
+}
+
+- (void) dealloc {
+    [_instructionPointers release];
+    [super dealloc];
+}
+
+@end
@@ -0,0 +1,65 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "PLCrashReportStackSample.h"
+
+@interface PLCrashReportStackSamples : NSObject {
+@private
+    /** The sampling interval. */
+    NSTimeInterval _interval;
+
+    /** Total number of samples. */
+    NSUInteger _sampleCount;
+
+    /** Number of samples whose stacks were evicted. */
+    NSUInteger _evictedSampleCount;
+
+    /** The unique sampled stacks (PLCrashReportStackSample instances). */
+    NSArray *_stacks;
+}
+
+- (id) initWithInterval: (NSTimeInterval) interval
+            sampleCount: (NSUInteger) sampleCount
+     evictedSampleCount: (NSUInteger) evictedSampleCount
+                 stacks: (NSArray *) stacks;
+
+/** The sampling interval. */
+@property(nonatomic, readonly) NSTimeInterval interval;
+
+/** The total number of stacks sampled, including those counted by evictedSampleCount. */
+@property(nonatomic, readonly) NSUInteger sampleCount;
+
+/** The number of samples whose stacks were evicted from the sample buffer, and are not included in stacks. */
+@property(nonatomic, readonly) NSUInteger evictedSampleCount;
+
+/** The unique sampled stacks, as PLCrashReportStackSample instances. */
+@property(nonatomic, readonly) NSArray *stacks;
+
+@end
@@ -0,0 +1,72 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashReportStackSamples.h"
+
+/**
+ * Crash log stack samples.
+ *
+ * Provides the aggregated stack samples captured by the stack sampler prior to a live report being generated.
+ */
+@implementation PLCrashReportStackSamples
+
+@synthesize interval = _interval;
+@synthesize sampleCount = _sampleCount;
+@synthesize evictedSampleCount = _evictedSampleCount;
+@synthesize stacks = _stacks;
+
+/**
+ * Initialize a new stack samples data object.
+ *
+ * @param interval The sampling interval.
+ * @param sampleCount The total number of stacks sampled.
+ * @param evictedSampleCount The number of samples whose stacks were evicted from the sample buffer.
+ * @param stacks The unique sampled stacks, as PLCrashReportStackSample instances.
+ */
+- (id) initWithInterval: (NSTimeInterval) interval
+            sampleCount: (NSUInteger) sampleCount
+     evictedSampleCount: (NSUInteger) evictedSampleCount
+                 stacks: (NSArray *) stacks
+{
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _interval = interval;
+    _sampleCount = sampleCount;
+    _evictedSampleCount = evictedSampleCount;
+    _stacks = [stacks retain];
+
+    return self;
+}
+
+- (void) dealloc {
+    [_stacks release];
+    [super dealloc];
+}
+
+@end
@@ -0,0 +1,203 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "PLCrashReportStream.h"
+
+/**
+ * @internal
+ * @ingroup plcrash_internal
+ * @defgroup plcrash_report_stream Streaming Report Decoder
+ *
+ * Implements a pull-style decoder over the top-level fields of an encoded crash report. Callers may
+ * visit one thread or binary image record at a time, rather than unpacking the entire report, and may
+ * read the complete fields of a truncated report.
+ * @{
+ */
+
+/**
+ * Decode a varint from @a stream's current offset.
+ *
+ * @param stream The stream to read from.
+ * @param value On success, the decoded value.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if the stream ends before the varint is
+ * terminated, or PLCRASH_EINVALID_DATA if the varint exceeds 64 bits.
+ */
+static plcrash_error_t report_stream_read_varint (plcrash_report_stream_t *stream, uint64_t *value) {
+    uint64_t result = 0;
+
+    for (unsigned int shift = 0; shift < 64; shift += 7) {
+        if (stream->offset >= stream->length)
+            return PLCRASH_ENOTFOUND;
+
+        uint8_t byte = stream->data[stream->offset++];
+        result |= (uint64_t) (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return PLCRASH_ESUCCESS;
+        }
+    }
+
+    return PLCRASH_EINVALID_DATA;
+}
+
+/**
+ * Decode a little-endian value of @a size bytes from @a stream's current offset.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_ENOTFOUND if the stream ends before the value.
+ */
+static plcrash_error_t report_stream_read_fixed (plcrash_report_stream_t *stream, size_t size, uint64_t *value) {
+    if (stream->length - stream->offset < size)
+        return PLCRASH_ENOTFOUND;
+
+    uint64_t result = 0;
+    for (size_t i = 0; i < size; i++)
+        result |= (uint64_t) stream->data[stream->offset + i] << (i * 8);
+
+    stream->offset += size;
+    *value = result;
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Initialize a report stream over the encoded CrashReport message in @a data. For crash report files, this
+ * is the data following the PLCrashReportFileHeader; compressed reports must be decoded first.
+ *
+ * @param stream The stream to initialize.
+ * @param data The encoded report message. This must remain valid for the lifetime of the stream, and of any
+ * fields read from it.
+ * @param length The length of @a data, in bytes.
+ *
+ * @note This function is async-safe.
+ */
+void plcrash_report_stream_init (plcrash_report_stream_t *stream, const void *data, size_t length) {
+    stream->data = data;
+    stream->length = length;
+    stream->offset = 0;
+    stream->truncated = false;
+}
+
+/**
+ * Read the next top-level field from @a stream.
+ *
+ * @param stream The stream to read from.
+ * @param field On success, the field that was read.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_ENOTFOUND if no further fields are available. If the
+ * stream ends within a field, PLCRASH_ENOTFOUND is returned and the stream is marked as truncated; all
+ * previously returned fields remain valid. If the field is malformed or uses an unsupported wire type,
+ * PLCRASH_EINVALID_DATA is returned, and no further fields will be returned.
+ *
+ * @note This function is async-safe.
+ */
+plcrash_error_t plcrash_report_stream_next (plcrash_report_stream_t *stream, plcrash_report_stream_field_t *field) {
+    plcrash_error_t err;
+    uint64_t tag;
+
+    if (stream->offset >= stream->length)
+        return PLCRASH_ENOTFOUND;
+
+    /* Read the field tag */
+    if ((err = report_stream_read_varint(stream, &tag)) != PLCRASH_ESUCCESS)
+        goto error;
+
+    if ((tag >> 3) == 0 || (tag >> 3) > UINT32_MAX) {
+        err = PLCRASH_EINVALID_DATA;
+        goto error;
+    }
+
+    field->number = (uint32_t) (tag >> 3);
+    field->wire_type = (plcrash_report_stream_wire_type_t) (tag & 0x7);
+    field->value = 0;
+    field->data = NULL;
+    field->length = 0;
+
+    /* Read the value */
+    switch (field->wire_type) {
+        case PLCRASH_REPORT_STREAM_WIRE_VARINT:
+            err = report_stream_read_varint(stream, &field->value);
+            break;
+
+        case PLCRASH_REPORT_STREAM_WIRE_FIXED64:
+            err = report_stream_read_fixed(stream, 8, &field->value);
+            break;
+
+        case PLCRASH_REPORT_STREAM_WIRE_FIXED32:
+            err = report_stream_read_fixed(stream, 4, &field->value);
+            break;
+
+        case PLCRASH_REPORT_STREAM_WIRE_LENGTH_DELIMITED: {
+            uint64_t length;
+            if ((err = report_stream_read_varint(stream, &length)) != PLCRASH_ESUCCESS)
+                break;
+
+            if (length > stream->length - stream->offset) {
+                err = PLCRASH_ENOTFOUND;
+                break;
+            }
+
+            field->data = stream->data + stream->offset;
+            field->length = (size_t) length;
+            stream->offset += (size_t) length;
+            break;
+        }
+
+        default:
+            /* Groups are not used by crash_report.proto */
+            err = PLCRASH_EINVALID_DATA;
+            break;
+    }
+
+    if (err != PLCRASH_ESUCCESS)
+        goto error;
+
+    return PLCRASH_ESUCCESS;
+
+error:
+    /* Stop reading at the failed field */
+    if (err == PLCRASH_ENOTFOUND)
+        stream->truncated = true;
+
+    stream->offset = stream->length;
+    return err;
+}
+
+/**
+ * Return true if @a stream ended within a field.
+ *
+ * @param stream The stream to query.
+ *
+ * @note This function is async-safe.
+ */
+bool plcrash_report_stream_truncated (plcrash_report_stream_t *stream) {
+    return stream->truncated;
+}
+
+/**
+ * @}
+ */
@@ -0,0 +1,121 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PLCRASH_REPORT_STREAM_H
+#define PLCRASH_REPORT_STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "PLCrashAsync.h"
+
+/**
+ * @internal
+ * @ingroup plcrash_report_stream
+ *
+ * Protobuf wire types that may be returned by plcrash_report_stream_next().
+ */
+typedef enum {
+    /** Varint-encoded value. The decoded value is provided via plcrash_report_stream_field_t::value. */
+    PLCRASH_REPORT_STREAM_WIRE_VARINT = 0,
+
+    /** Little-endian 64-bit value. The decoded value is provided via plcrash_report_stream_field_t::value. */
+    PLCRASH_REPORT_STREAM_WIRE_FIXED64 = 1,
+
+    /**
+     * Length-delimited value, such as an embedded message, string, or bytes field. The value is provided via
+     * plcrash_report_stream_field_t::data and plcrash_report_stream_field_t::length.
+     */
+    PLCRASH_REPORT_STREAM_WIRE_LENGTH_DELIMITED = 2,
+
+    /** Little-endian 32-bit value. The decoded value is provided via plcrash_report_stream_field_t::value. */
+    PLCRASH_REPORT_STREAM_WIRE_FIXED32 = 5,
+} plcrash_report_stream_wire_type_t;
+
+/**
+ * @internal
+ * @ingroup plcrash_report_stream
+ *
+ * A single top-level field read from a report stream.
+ */
+typedef struct plcrash_report_stream_field {
+    /** The field number, as defined in crash_report.proto (eg, 3 for CrashReport.threads). */
+    uint32_t number;
+
+    /** The field's wire type. */
+    plcrash_report_stream_wire_type_t wire_type;
+
+    /** The field's value, if the wire type is not PLCRASH_REPORT_STREAM_WIRE_LENGTH_DELIMITED. */
+    uint64_t value;
+
+    /**
+     * The field's encoded value, if the wire type is PLCRASH_REPORT_STREAM_WIRE_LENGTH_DELIMITED. This points into
+     * the stream's backing data; embedded messages may be unpacked individually using the corresponding
+     * protobuf-c unpack function (eg, plcrash__crash_report__thread__unpack()).
+     */
+    const uint8_t *data;
+
+    /** The length of @a data, in bytes. */
+    size_t length;
+} plcrash_report_stream_field_t;
+
+/**
+ * @internal
+ * @ingroup plcrash_report_stream
+ *
+ * A pull-style reader over the top-level fields of an encoded CrashReport message. No memory is allocated
+ * by the reader.
+ */
+typedef struct plcrash_report_stream {
+    /** The encoded report message. */
+    const uint8_t *data;
+
+    /** The length of @a data, in bytes. */
+    size_t length;
+
+    /** The offset of the next field to be read. */
+    size_t offset;
+
+    /** If true, the stream ended within a field. */
+    bool truncated;
+} plcrash_report_stream_t;
+
+void plcrash_report_stream_init (plcrash_report_stream_t *stream, const void *data, size_t length);
+plcrash_error_t plcrash_report_stream_next (plcrash_report_stream_t *stream, plcrash_report_stream_field_t *field);
+bool plcrash_report_stream_truncated (plcrash_report_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PLCRASH_REPORT_STREAM_H */
@@ -0,0 +1,133 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "SenTestCompat.h"
+
+#import "PLCrashReportStream.h"
+#import "PLCrashReport.h"
+#import "PLCrashReporter.h"
+
+#import "crash_report.pb-c.h"
+
+@interface PLCrashReportStreamTests : SenTestCase {
+@private
+    /** Encoded report message, excluding the file header */
+    NSData *_message;
+}
+@end
+
+@implementation PLCrashReportStreamTests
+
+- (void) setUp {
+    NSError *error = nil;
+    PLCrashReporter *reporter = [[[PLCrashReporter alloc] initWithConfiguration: [PLCrashReporterConfig defaultConfiguration]] autorelease];
+    NSData *reportData = [reporter generateLiveReportAndReturnError: &error];
+    STAssertNotNil(reportData, @"Failed to generate live report: %@", error);
+
+    const struct PLCrashReportFileHeader *header = [reportData bytes];
+    STAssertTrue([reportData length] > sizeof(*header), @"Report is truncated");
+    STAssertEquals(header->version, (uint8_t) PLCRASH_REPORT_FILE_VERSION, @"Unexpected report version");
+
+    _message = [[reportData subdataWithRange: NSMakeRange(sizeof(*header), [reportData length] - sizeof(*header))] retain];
+}
+
+- (void) tearDown {
+    [_message release];
+}
+
+/**
+ * Verify that the streamed thread and image records match the fully unpacked report.
+ */
+- (void) testStreamFields {
+    Plcrash__CrashReport *report = plcrash__crash_report__unpack(NULL, [_message length], [_message bytes]);
+    STAssertNotNULL(report, @"Failed to unpack report");
+    if (report == NULL)
+        return;
+
+    plcrash_report_stream_t stream;
+    plcrash_report_stream_field_t field;
+    size_t threadCount = 0;
+    size_t imageCount = 0;
+
+    plcrash_report_stream_init(&stream, [_message bytes], [_message length]);
+    while (plcrash_report_stream_next(&stream, &field) == PLCRASH_ESUCCESS) {
+        if (field.number == 3) {
+            STAssertEquals(field.wire_type, PLCRASH_REPORT_STREAM_WIRE_LENGTH_DELIMITED, @"Incorrect wire type");
+            Plcrash__CrashReport__Thread *thread = plcrash__crash_report__thread__unpack(NULL, field.length, field.data);
+            STAssertNotNULL(thread, @"Failed to unpack thread");
+            if (thread != NULL && threadCount < report->n_threads) {
+                STAssertEquals(thread->thread_number, report->threads[threadCount]->thread_number, @"Incorrect thread number");
+                STAssertEquals(thread->n_frames, report->threads[threadCount]->n_frames, @"Incorrect frame count");
+            }
+            protobuf_c_message_free_unpacked((ProtobufCMessage *) thread, NULL);
+            threadCount++;
+        } else if (field.number == 4) {
+            Plcrash__CrashReport__BinaryImage *image = plcrash__crash_report__binary_image__unpack(NULL, field.length, field.data);
+            STAssertNotNULL(image, @"Failed to unpack image");
+            if (image != NULL && imageCount < report->n_binary_images) {
+                STAssertEquals(image->base_address, report->binary_images[imageCount]->base_address, @"Incorrect base address");
+                STAssertEquals(strcmp(image->name, report->binary_images[imageCount]->name), 0, @"Incorrect image name");
+            }
+            protobuf_c_message_free_unpacked((ProtobufCMessage *) image, NULL);
+            imageCount++;
+        }
+    }
+
+    STAssertFalse(plcrash_report_stream_truncated(&stream), @"Complete report was marked as truncated");
+    STAssertEquals(threadCount, report->n_threads, @"Incorrect thread count");
+    STAssertEquals(imageCount, report->n_binary_images, @"Incorrect image count");
+
+    protobuf_c_message_free_unpacked((ProtobufCMessage *) report, NULL);
+}
+
+/**
+ * Verify that the complete fields of a truncated report remain readable.
+ */
+- (void) testTruncatedStream {
+    size_t length = [_message length] / 2;
+    plcrash_report_stream_t stream;
+    plcrash_report_stream_field_t field;
+    size_t fieldCount = 0;
+
+    plcrash_report_stream_init(&stream, [_message bytes], length);
+    while (plcrash_report_stream_next(&stream, &field) == PLCRASH_ESUCCESS) {
+        if (field.wire_type == PLCRASH_REPORT_STREAM_WIRE_LENGTH_DELIMITED) {
+            STAssertTrue(field.data >= (const uint8_t *) [_message bytes], @"Field precedes the stream");
+            STAssertTrue(field.data + field.length <= (const uint8_t *) [_message bytes] + length, @"Field exceeds the stream");
+        }
+        fieldCount++;
+    }
+
+    STAssertTrue(fieldCount > 0, @"No fields were read");
+    STAssertTrue(plcrash_report_stream_truncated(&stream), @"Truncated report was not marked as truncated");
+
+    /* Fully unpacking the same data fails */
+    STAssertNULL(plcrash__crash_report__unpack(NULL, length, [_message bytes]), @"Unpacked a truncated report");
+}
+
+@end
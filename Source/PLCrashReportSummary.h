@@ -0,0 +1,92 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+@interface PLCrashReportSummary : NSObject {
+@private
+    /** Date and time that the crash report was generated, or nil if unavailable. */
+    NSDate *_timestamp;
+
+    /** BSD signal number. */
+    int _signalNumber;
+
+    /** BSD signal code. */
+    int _signalCode;
+
+    /** Hash of the uncaught exception name. */
+    uint64_t _exceptionNameHash;
+
+    /** Hash of the crashed thread's top frames. */
+    uint64_t _crashedThreadSignature;
+
+    /** Report size, in bytes. */
+    uint64_t _reportSize;
+
+    /** Number of crashes recorded by the report. */
+    NSUInteger _occurrenceCount;
+
+    /** Date and time of the most recently recorded crash, or nil if unavailable. */
+    NSDate *_lastOccurrenceTimestamp;
+}
+
+- (id) initWithData: (NSData *) data error: (NSError **) outError;
+
++ (NSArray *) summariesWithBatchData: (NSData *) batchData error: (NSError **) outError;
+
+/** Date and time that the crash report was generated. This may be unavailable, and this property will be nil. */
+@property(nonatomic, readonly) NSDate *timestamp;
+
+/** The BSD signal number of the fatal signal. */
+@property(nonatomic, readonly) int signalNumber;
+
+/** The BSD signal code of the fatal signal. */
+@property(nonatomic, readonly) int signalCode;
+
+/** A hash of the uncaught exception name, or 0 if the report does not include an uncaught exception. */
+@property(nonatomic, readonly) uint64_t exceptionNameHash;
+
+/**
+ * A hash of the binary images and image-relative instruction pointers of the crashed thread's top frames. Reports
+ * with equal signatures likely share a cause.
+ */
+@property(nonatomic, readonly) uint64_t crashedThreadSignature;
+
+/** The size of the crash report, in bytes. */
+@property(nonatomic, readonly) uint64_t reportSize;
+
+/**
+ * The number of crashes recorded by the report. If enabled via PLCrashReporterConfig.shouldCollapseRepeatedCrashes,
+ * crashes that repeat the pending report's crash are counted here, rather than being written as new reports.
+ */
+@property(nonatomic, readonly) NSUInteger occurrenceCount;
+
+/** Date and time of the most recently recorded crash. This may be unavailable, and this property will be nil. */
+@property(nonatomic, readonly) NSDate *lastOccurrenceTimestamp;
+
+@end
@@ -0,0 +1,141 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashReportSummary.h"
+#import "PLCrashReporterNSError.h"
+#import "PLCrashLogWriter.h"
+#import "PLCrashReportBatch.h"
+
+/**
+ * Provides access to the fixed-layout summary written alongside a pending crash report. The summary may be
+ * read without decoding the crash report itself.
+ */
+@implementation PLCrashReportSummary
+
+/**
+ * Initialize with the summary file contents.
+ *
+ * @param data The summary data, as written by the crash reporter.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error
+ * object indicating why the summary could not be parsed. If no error occurs, this parameter will be left unmodified.
+ * You may specify nil for this parameter, and no error information will be provided.
+ *
+ * @return Returns nil if the summary is truncated, or was written by an incompatible version.
+ */
+- (id) initWithData: (NSData *) data error: (NSError **) outError {
+    if ((self = [super init]) == nil)
+        return nil;
+
+    /* Version 1 summaries lack the occurrence record, and record a single crash */
+    plcrash_log_summary_t summary;
+    if ([data length] != sizeof(summary) && [data length] != PLCRASH_LOG_SUMMARY_V1_SIZE) {
+        plcrash_populate_error(outError, PLCrashReporterErrorCrashReportInvalid, @"Could not parse truncated report summary", nil);
+        goto error;
+    }
+
+    memset(&summary, 0, sizeof(summary));
+    memcpy(&summary, [data bytes], [data length]);
+    if (summary.magic != PLCRASH_LOG_SUMMARY_MAGIC ||
+        !((summary.version == PLCRASH_LOG_SUMMARY_VERSION && [data length] == sizeof(summary)) ||
+          (summary.version == 1 && [data length] == PLCRASH_LOG_SUMMARY_V1_SIZE)))
+    {
+        plcrash_populate_error(outError, PLCrashReporterErrorCrashReportInvalid, @"Could not parse invalid or unsupported report summary", nil);
+        goto error;
+    }
+
+    if (summary.version == 1) {
+        summary.occurrence_count = 1;
+        summary.last_timestamp = summary.timestamp;
+    }
+
+    if (summary.timestamp != 0)
+        _timestamp = [[NSDate dateWithTimeIntervalSince1970: summary.timestamp] retain];
+
+    _signalNumber = summary.signo;
+    _signalCode = summary.code;
+    _exceptionNameHash = summary.exception_name_hash;
+    _crashedThreadSignature = summary.crashed_thread_signature;
+    _reportSize = summary.report_size;
+    _occurrenceCount = MAX(summary.occurrence_count, 1U);
+    if (summary.last_timestamp != 0)
+        _lastOccurrenceTimestamp = [[NSDate dateWithTimeIntervalSince1970: summary.last_timestamp] retain];
+
+    return self;
+
+error:
+    [self release];
+    return nil;
+}
+
+/**
+ * Return the summaries of all reports in a batch container, as created by
+ * PLCrashReporter::loadQueuedCrashReportBatch:compress:error:. The summaries are read from the container's index,
+ * without decoding the reports.
+ *
+ * @param batchData The encoded batch container.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error
+ * object indicating why the batch could not be parsed. If no error occurs, this parameter will be left unmodified.
+ * You may specify nil for this parameter, and no error information will be provided.
+ *
+ * @return Returns one element for each report in the batch, in queue order: a PLCrashReportSummary instance, or NSNull
+ * if the report has no valid summary. Returns nil if the batch could not be parsed.
+ */
++ (NSArray *) summariesWithBatchData: (NSData *) batchData error: (NSError **) outError {
+    PLCrashReportBatch *batch = [[[PLCrashReportBatch alloc] initWithData: batchData error: outError] autorelease];
+    if (batch == nil)
+        return nil;
+
+    NSMutableArray *summaries = [NSMutableArray arrayWithCapacity: batch.count];
+    for (NSUInteger i = 0; i < batch.count; i++) {
+        NSData *data = [batch summaryDataAtIndex: i];
+        PLCrashReportSummary *summary = nil;
+        if (data != nil)
+            summary = [[[PLCrashReportSummary alloc] initWithData: data error: NULL] autorelease];
+
+        [summaries addObject: summary != nil ? (id) summary : (id) [NSNull null]];
+    }
+
+    return summaries;
+}
+
+- (void) dealloc {
+    [_timestamp release];
+    [_lastOccurrenceTimestamp release];
+    [super dealloc];
+}
+
+@synthesize timestamp = _timestamp;
+@synthesize signalNumber = _signalNumber;
+@synthesize signalCode = _signalCode;
+@synthesize exceptionNameHash = _exceptionNameHash;
+@synthesize crashedThreadSignature = _crashedThreadSignature;
+@synthesize reportSize = _reportSize;
+@synthesize occurrenceCount = _occurrenceCount;
+@synthesize lastOccurrenceTimestamp = _lastOccurrenceTimestamp;
+
+@end
@@ -0,0 +1,49 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/**
+ * Demangles C++ and Swift symbol names for display in offline-formatted crash reports.
+ *
+ * Results are memoized, allowing a single instance to be shared across all reports in a batch; the same symbols
+ * tend to recur across reports from a given application, and each is demangled only once. Instances are
+ * thread-safe, and may be shared by concurrent formatters.
+ */
+@interface PLCrashReportSymbolDemangler : NSObject {
+@private
+    /** Lock guarding @a _cache. */
+    NSLock *_lock;
+
+    /** Map of mangled symbol names to their demangled form, or to NSNull if the symbol is not demangleable. */
+    NSMutableDictionary *_cache;
+}
+
+- (NSString *) demangledNameForSymbol: (NSString *) symbolName;
+
+@end
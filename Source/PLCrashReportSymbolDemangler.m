@@ -0,0 +1,174 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashReportSymbolDemangler.h"
+
+#import <dlfcn.h>
+#import <stdlib.h>
+#import <string.h>
+
+/* Provided by the C++ ABI runtime */
+extern char *__cxa_demangle (const char *mangled_name, char *output_buffer, size_t *length, int *status);
+
+/** Signature of the Swift runtime's demangler entry point. */
+typedef char *(*plcrash_swift_demangle_fn) (const char *mangled_name, size_t mangled_name_length, char *output_buffer, size_t *output_buffer_size, uint32_t flags);
+
+/**
+ * Return the Swift runtime's demangler, or NULL if the Swift runtime is unavailable. The runtime is not linked
+ * by PLCrashReporter; it is resolved on first use from the current process, or loaded from the system.
+ */
+static plcrash_swift_demangle_fn plcrash_swift_demangle_function (void) {
+    static dispatch_once_t onceToken;
+    static plcrash_swift_demangle_fn swift_demangle = NULL;
+
+    dispatch_once(&onceToken, ^{
+        swift_demangle = (plcrash_swift_demangle_fn) dlsym(RTLD_DEFAULT, "swift_demangle");
+        if (swift_demangle == NULL) {
+            void *handle = dlopen("/usr/lib/swift/libswiftCore.dylib", RTLD_LAZY | RTLD_LOCAL);
+            if (handle != NULL)
+                swift_demangle = (plcrash_swift_demangle_fn) dlsym(handle, "swift_demangle");
+        }
+    });
+
+    return swift_demangle;
+}
+
+/**
+ * If @a symbol (or @a symbol with a single leading underscore removed) begins with @a prefix, return
+ * the symbol starting at the prefix. Otherwise, return NULL.
+ */
+static const char *plcrash_demangle_match_prefix (const char *symbol, const char *prefix) {
+    size_t prefixLength = strlen(prefix);
+
+    if (strncmp(symbol, prefix, prefixLength) == 0)
+        return symbol;
+
+    if (symbol[0] == '_' && strncmp(symbol + 1, prefix, prefixLength) == 0)
+        return symbol + 1;
+
+    return NULL;
+}
+
+/**
+ * Demangle @a symbol, returning a malloc-allocated string that must be freed by the caller, or NULL if the
+ * symbol is not a recognized mangled C++ or Swift name.
+ */
+static char *plcrash_demangle_cstring (const char *symbol) {
+    /* Swift; current ($s), Swift 4.x ($S), embedded ($e), and pre-4.0 (_T0) manglings. Swift is checked first;
+     * '_T0' symbols would otherwise be mistaken for Itanium C++ names. */
+    static const char *swiftPrefixes[] = { "$s", "$S", "$e", "_T0" };
+    for (size_t i = 0; i < sizeof(swiftPrefixes) / sizeof(swiftPrefixes[0]); i++) {
+        const char *mangled = plcrash_demangle_match_prefix(symbol, swiftPrefixes[i]);
+        if (mangled == NULL)
+            continue;
+
+        plcrash_swift_demangle_fn swift_demangle = plcrash_swift_demangle_function();
+        if (swift_demangle == NULL)
+            return NULL;
+
+        return swift_demangle(mangled, strlen(mangled), NULL, NULL, 0);
+    }
+
+    /* Itanium C++ ABI */
+    const char *mangled = plcrash_demangle_match_prefix(symbol, "_Z");
+    if (mangled != NULL) {
+        int status = 0;
+        char *result = __cxa_demangle(mangled, NULL, NULL, &status);
+        if (status != 0) {
+            free(result);
+            return NULL;
+        }
+        return result;
+    }
+
+    return NULL;
+}
+
+/**
+ * Symbol name demangler.
+ */
+@implementation PLCrashReportSymbolDemangler
+
+/**
+ * Initialize a new demangler with an empty cache.
+ */
+- (instancetype) init {
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _lock = [[NSLock alloc] init];
+    _cache = [[NSMutableDictionary alloc] init];
+
+    return self;
+}
+
+- (void) dealloc {
+    [_lock release];
+    [_cache release];
+
+    [super dealloc];
+}
+
+/**
+ * Return the demangled form of @a symbolName, or nil if @a symbolName is not a recognized mangled C++ or Swift
+ * symbol, or could not be demangled. Swift symbols may only be demangled when the Swift runtime is available.
+ *
+ * Both leading-underscore (Mach-O) and undecorated symbol names are accepted.
+ *
+ * @param symbolName The symbol name to demangle.
+ */
+- (NSString *) demangledNameForSymbol: (NSString *) symbolName {
+    if (symbolName == nil)
+        return nil;
+
+    [_lock lock];
+    id cached = [[[_cache objectForKey: symbolName] retain] autorelease];
+    [_lock unlock];
+
+    if (cached != nil)
+        return cached == [NSNull null] ? nil : cached;
+
+    /* Demangle outside of the lock; concurrent callers may race to demangle the same symbol, which is harmless. */
+    NSString *result = nil;
+    const char *symbol = [symbolName UTF8String];
+    if (symbol != NULL) {
+        char *demangled = plcrash_demangle_cstring(symbol);
+        if (demangled != NULL) {
+            result = [NSString stringWithUTF8String: demangled];
+            free(demangled);
+        }
+    }
+
+    [_lock lock];
+    [_cache setObject: (result != nil ? (id) result : (id) [NSNull null]) forKey: symbolName];
+    [_lock unlock];
+
+    return result;
+}
+
+@end
@@ -0,0 +1,66 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "SenTestCompat.h"
+
+#import "PLCrashReportSymbolDemangler.h"
+
+@interface PLCrashReportSymbolDemanglerTests : SenTestCase @end
+
+@implementation PLCrashReportSymbolDemanglerTests
+
+- (void) testDemangleCPlusPlus {
+    PLCrashReportSymbolDemangler *demangler = [[[PLCrashReportSymbolDemangler alloc] init] autorelease];
+
+    /* Both the Mach-O underscore-prefixed and undecorated forms are accepted */
+    STAssertEqualObjects(@"foo::bar(int)", [demangler demangledNameForSymbol: @"__ZN3foo3barEi"], @"Incorrect demangled name");
+    STAssertEqualObjects(@"foo::bar(int)", [demangler demangledNameForSymbol: @"_ZN3foo3barEi"], @"Incorrect demangled name");
+}
+
+- (void) testUnmangled {
+    PLCrashReportSymbolDemangler *demangler = [[[PLCrashReportSymbolDemangler alloc] init] autorelease];
+
+    STAssertNil([demangler demangledNameForSymbol: @"_main"], @"Demangled a C symbol");
+    STAssertNil([demangler demangledNameForSymbol: @"-[NSObject description]"], @"Demangled an Objective-C symbol");
+    STAssertNil([demangler demangledNameForSymbol: @"__Zinvalid"], @"Demangled an invalid C++ symbol");
+    STAssertNil([demangler demangledNameForSymbol: nil], @"Demangled a nil symbol");
+
+    /* Cached negative results are returned consistently */
+    STAssertNil([demangler demangledNameForSymbol: @"_main"], @"Demangled a cached C symbol");
+}
+
+- (void) testCachedResult {
+    PLCrashReportSymbolDemangler *demangler = [[[PLCrashReportSymbolDemangler alloc] init] autorelease];
+
+    NSString *first = [demangler demangledNameForSymbol: @"__ZN3foo3barEi"];
+    NSString *second = [demangler demangledNameForSymbol: @"__ZN3foo3barEi"];
+    STAssertNotNil(first, @"Failed to demangle symbol");
+    STAssertTrue(first == second, @"Demangled name was not cached");
+}
+
+@end
@@ -0,0 +1,91 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+@interface PLCrashReportSymbolicationDiagnostics : NSObject {
+@private
+    /** Total number of symbol look-ups requested. */
+    NSUInteger _lookupCount;
+
+    /** Number of look-ups served from the look-up cache. */
+    NSUInteger _cacheHitCount;
+
+    /** Upper bound on the number of symbol table entries examined. */
+    uint64_t _symbolsScanned;
+
+    /** Number of Objective-C class structures parsed. */
+    NSUInteger _objcClassesParsed;
+
+    /** Number of symbol table look-ups. */
+    NSUInteger _symbolTableLookupCount;
+
+    /** Time spent in symbol table look-ups. */
+    NSTimeInterval _symbolTableTime;
+
+    /** Number of Objective-C metadata look-ups. */
+    NSUInteger _objcLookupCount;
+
+    /** Time spent in Objective-C metadata look-ups. */
+    NSTimeInterval _objcTime;
+}
+
+- (id) initWithLookupCount: (NSUInteger) lookupCount
+             cacheHitCount: (NSUInteger) cacheHitCount
+            symbolsScanned: (uint64_t) symbolsScanned
+         objcClassesParsed: (NSUInteger) objcClassesParsed
+    symbolTableLookupCount: (NSUInteger) symbolTableLookupCount
+           symbolTableTime: (NSTimeInterval) symbolTableTime
+           objcLookupCount: (NSUInteger) objcLookupCount
+                  objcTime: (NSTimeInterval) objcTime;
+
+/** Total number of symbol look-ups requested while writing the report, including those served from the look-up cache. */
+@property(nonatomic, readonly) NSUInteger lookupCount;
+
+/** Number of symbol look-ups served from the look-up cache. */
+@property(nonatomic, readonly) NSUInteger cacheHitCount;
+
+/** Upper bound on the number of symbol table entries examined by symbol table look-ups. */
+@property(nonatomic, readonly) uint64_t symbolsScanned;
+
+/** Number of Objective-C class structures parsed by Objective-C metadata look-ups. */
+@property(nonatomic, readonly) NSUInteger objcClassesParsed;
+
+/** Number of look-ups performed using the binary's symbol table. */
+@property(nonatomic, readonly) NSUInteger symbolTableLookupCount;
+
+/** Time spent performing symbol table look-ups. */
+@property(nonatomic, readonly) NSTimeInterval symbolTableTime;
+
+/** Number of look-ups performed using Objective-C metadata. */
+@property(nonatomic, readonly) NSUInteger objcLookupCount;
+
+/** Time spent performing Objective-C metadata look-ups. */
+@property(nonatomic, readonly) NSTimeInterval objcTime;
+
+@end
@@ -0,0 +1,84 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashReportSymbolicationDiagnostics.h"
+
+/**
+ * Crash log local symbolication diagnostics.
+ *
+ * Provides the cost of the local symbolication performed while the report was written, allowing the value of
+ * on-device symbolication to be weighed against its share of the crash-time budget.
+ */
+@implementation PLCrashReportSymbolicationDiagnostics
+
+@synthesize lookupCount = _lookupCount;
+@synthesize cacheHitCount = _cacheHitCount;
+@synthesize symbolsScanned = _symbolsScanned;
+@synthesize objcClassesParsed = _objcClassesParsed;
+@synthesize symbolTableLookupCount = _symbolTableLookupCount;
+@synthesize symbolTableTime = _symbolTableTime;
+@synthesize objcLookupCount = _objcLookupCount;
+@synthesize objcTime = _objcTime;
+
+/**
+ * Initialize a new symbolication diagnostics data object.
+ *
+ * @param lookupCount Total number of symbol look-ups requested, including those served from the look-up cache.
+ * @param cacheHitCount Number of symbol look-ups served from the look-up cache.
+ * @param symbolsScanned Upper bound on the number of symbol table entries examined.
+ * @param objcClassesParsed Number of Objective-C class structures parsed.
+ * @param symbolTableLookupCount Number of look-ups performed using the binary's symbol table.
+ * @param symbolTableTime Time spent performing symbol table look-ups.
+ * @param objcLookupCount Number of look-ups performed using Objective-C metadata.
+ * @param objcTime Time spent performing Objective-C metadata look-ups.
+ */
+- (id) initWithLookupCount: (NSUInteger) lookupCount
+             cacheHitCount: (NSUInteger) cacheHitCount
+            symbolsScanned: (uint64_t) symbolsScanned
+         objcClassesParsed: (NSUInteger) objcClassesParsed
+    symbolTableLookupCount: (NSUInteger) symbolTableLookupCount
+           symbolTableTime: (NSTimeInterval) symbolTableTime
+           objcLookupCount: (NSUInteger) objcLookupCount
+                  objcTime: (NSTimeInterval) objcTime
+{
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _lookupCount = lookupCount;
+    _cacheHitCount = cacheHitCount;
+    _symbolsScanned = symbolsScanned;
+    _objcClassesParsed = objcClassesParsed;
+    _symbolTableLookupCount = symbolTableLookupCount;
+    _symbolTableTime = symbolTableTime;
+    _objcLookupCount = objcLookupCount;
+    _objcTime = objcTime;
+
+    return self;
+}
+
+@end
@@ -120,6 +120,7 @@ static plcrash_error_t plcr_live_report_callback (plcrash_async_thread_state_t *
         exception = e;
     }
     plcrash_log_writer_set_exception(&writer, exception);
+    plcrash_log_writer_set_symbolication_diagnostics(&writer, true);
 
     /* Provide binary image info */
     plcrash_nasync_image_list_init(&image_list, mach_task_self());
@@ -226,6 +227,11 @@ static plcrash_error_t plcr_live_report_callback (plcrash_async_thread_state_t *
         STAssertEquals(sf.instructionPointer, [retAddr unsignedLongLongValue], @"Stack frame address is incorrect");
     }
 
+    /* Symbolication diagnostics */
+    STAssertTrue(crashLog.hasSymbolicationDiagnostics, @"No symbolication diagnostics available");
+    STAssertTrue(crashLog.symbolicationDiagnostics.lookupCount > 0, @"No symbol look-ups recorded");
+    STAssertTrue(crashLog.symbolicationDiagnostics.symbolTableTime >= 0, @"Negative symbol table time");
+
     /* Thread info */
     STAssertNotNil(crashLog.threads, @"Thread list is nil");
     STAssertNotEquals((NSUInteger)0, [crashLog.threads count], @"No thread values returned");
@@ -299,5 +305,275 @@ static plcrash_error_t plcr_live_report_callback (plcrash_async_thread_state_t *
     }
 }
 
+/**
+ * Verify that compressed reports are written with the compressed file header and transparently decoded.
+ */
+- (void) testWriteCompressedReport {
+    static plcrash_async_lz_t compressor;
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    NSError *error = nil;
+
+    /* Initialze faux crash data */
+    plcrash_log_signal_info_t info;
+    plcrash_log_bsd_signal_info_t bsd_info;
+    {
+        bsd_info.address = method_getImplementation(class_getInstanceMethod([self class], _cmd));
+        bsd_info.code = SEGV_MAPERR;
+        bsd_info.signo = SIGSEGV;
+
+        info.mach_info = NULL;
+        info.bsd_info = &bsd_info;
+    }
+
+    /* Open the output file */
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Initialize a compressing writer */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"1.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, false), @"Initialization failed");
+    plcrash_log_writer_set_compressor(&writer, &compressor);
+
+    /* Provide binary image info */
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    uint32_t image_count = _dyld_image_count();
+    for (uint32_t i = 0; i < image_count; i++) {
+        plcrash_nasync_image_list_append(&image_list, (uintptr_t) _dyld_get_image_header(i), _dyld_get_image_name(i));
+    }
+
+    /* Write the crash report */
+    struct plcr_live_report_context ctx = {
+        .writer = &writer,
+        .file = &file,
+        .images = &image_list,
+        .info = &info
+    };
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_thread_state_current(plcr_live_report_callback, &ctx), @"Writing crash log failed");
+
+    /* Close it */
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    /* Verify the header */
+    NSData *data = [NSData dataWithContentsOfFile:_logPath options:NSDataReadingMappedIfSafe error:nil];
+    STAssertTrue([data length] > sizeof(struct PLCrashReportFileHeader), @"Report is truncated");
+    const struct PLCrashReportFileHeader *header = [data bytes];
+    STAssertEquals(header->version, (uint8_t) PLCRASH_REPORT_FILE_VERSION_COMPRESSED, @"Incorrect file version");
+
+    /* Try to parse it */
+    PLCrashReport *crashLog = [[[PLCrashReport alloc] initWithData: data error: &error] autorelease];
+    STAssertNotNil(crashLog, @"Could not decode crash log: %@", error);
+
+    STAssertNotNULL(crashLog.uuidRef, @"No report UUID");
+    STAssertNotNil(crashLog.systemInfo, @"No system information available");
+    STAssertEqualStrings(@"SIGSEGV", crashLog.signalInfo.name, @"Signal is incorrect");
+    STAssertNotEquals((NSUInteger)0, [crashLog.threads count], @"No thread values returned");
+    STAssertNotEquals((NSUInteger)0, [crashLog.images count], @"Crash log should contain at least one image");
+
+    /* Truncated compressed data must be rejected */
+    NSData *truncated = [data subdataWithRange: NSMakeRange(0, [data length] - 1)];
+    STAssertNil([[[PLCrashReport alloc] initWithData: truncated error: &error] autorelease], @"Decoded a truncated compressed report");
+}
+
+/**
+ * Verify that lazily decoded reports provide the same thread and image data as eagerly decoded reports, and that
+ * the summary accessors are available without decoding the thread records.
+ */
+- (void) testLazyDecoding {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    NSError *error = nil;
+
+    /* Initialze faux crash data */
+    plcrash_log_signal_info_t info;
+    plcrash_log_bsd_signal_info_t bsd_info;
+    {
+        bsd_info.address = method_getImplementation(class_getInstanceMethod([self class], _cmd));
+        bsd_info.code = SEGV_MAPERR;
+        bsd_info.signo = SIGSEGV;
+
+        info.mach_info = NULL;
+        info.bsd_info = &bsd_info;
+    }
+
+    /* Open the output file */
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Initialize a writer */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"1.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, false), @"Initialization failed");
+
+    /* Provide binary image info */
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    uint32_t image_count = _dyld_image_count();
+    for (uint32_t i = 0; i < image_count; i++) {
+        plcrash_nasync_image_list_append(&image_list, (uintptr_t) _dyld_get_image_header(i), _dyld_get_image_name(i));
+    }
+
+    /* Write the crash report */
+    struct plcr_live_report_context ctx = {
+        .writer = &writer,
+        .file = &file,
+        .images = &image_list,
+        .info = &info
+    };
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_thread_state_current(plcr_live_report_callback, &ctx), @"Writing crash log failed");
+
+    /* Close it */
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    /* Decode the report both eagerly and lazily */
+    NSData *data = [NSData dataWithContentsOfFile: _logPath options: NSDataReadingMappedIfSafe error: nil];
+    PLCrashReport *eager = [[[PLCrashReport alloc] initWithData: data error: &error] autorelease];
+    STAssertNotNil(eager, @"Could not decode crash log: %@", error);
+
+    PLCrashReport *lazy = [[[PLCrashReport alloc] initWithData: data options: PLCrashReportDecodingOptionLazy error: &error] autorelease];
+    STAssertNotNil(lazy, @"Could not lazily decode crash log: %@", error);
+
+    /* The summary must match the decoded records */
+    STAssertEquals(lazy.threadCount, [eager.threads count], @"Incorrect thread count");
+    STAssertEquals(lazy.imageCount, [eager.images count], @"Incorrect image count");
+
+    PLCrashReportThreadInfo *crashed = lazy.crashedThread;
+    STAssertNotNil(crashed, @"No crashed thread");
+    STAssertEquals(lazy.crashedThreadNumber, crashed.threadNumber, @"Incorrect crashed thread number");
+    STAssertEquals(lazy.crashedThreadFrameCount, [crashed.stackFrames count], @"Incorrect crashed thread frame count");
+    STAssertEquals(eager.crashedThreadNumber, crashed.threadNumber, @"Incorrect eagerly decoded crashed thread number");
+
+    /* The lazily decoded records must match the eagerly decoded records */
+    STAssertEquals([lazy.threads count], [eager.threads count], @"Incorrect lazily decoded thread count");
+    for (NSUInteger i = 0; i < [lazy.threads count] && i < [eager.threads count]; i++) {
+        PLCrashReportThreadInfo *lhs = [lazy.threads objectAtIndex: i];
+        PLCrashReportThreadInfo *rhs = [eager.threads objectAtIndex: i];
+        STAssertEquals(lhs.threadNumber, rhs.threadNumber, @"Incorrect thread number");
+        STAssertEquals([lhs.stackFrames count], [rhs.stackFrames count], @"Incorrect frame count");
+    }
+
+    STAssertEquals([lazy.images count], [eager.images count], @"Incorrect lazily decoded image count");
+    for (NSUInteger i = 0; i < [lazy.images count] && i < [eager.images count]; i++) {
+        PLCrashReportBinaryImageInfo *lhs = [lazy.images objectAtIndex: i];
+        PLCrashReportBinaryImageInfo *rhs = [eager.images objectAtIndex: i];
+        STAssertEquals(lhs.imageBaseAddress, rhs.imageBaseAddress, @"Incorrect image base address");
+        STAssertEqualStrings(lhs.imageName, rhs.imageName, @"Incorrect image name");
+    }
+}
+
+/**
+ * Verify that compact decoding produces the same frames as standard decoding.
+ */
+- (void) testCompactDecoding {
+    plcrash_log_writer_t writer;
+    plcrash_async_file_t file;
+    plcrash_async_image_list_t image_list;
+    NSError *error = nil;
+
+    /* Initialze faux crash data */
+    plcrash_log_signal_info_t info;
+    plcrash_log_bsd_signal_info_t bsd_info;
+    {
+        bsd_info.address = method_getImplementation(class_getInstanceMethod([self class], _cmd));
+        bsd_info.code = SEGV_MAPERR;
+        bsd_info.signo = SIGSEGV;
+
+        info.mach_info = NULL;
+        info.bsd_info = &bsd_info;
+    }
+
+    /* Open the output file */
+    int fd = open([_logPath UTF8String], O_RDWR|O_CREAT|O_EXCL, 0644);
+    plcrash_async_file_init(&file, fd, 0);
+
+    /* Initialize a writer */
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_init(&writer, @"test.id", @"1.0", @"1.0", PLCRASH_ASYNC_SYMBOL_STRATEGY_ALL, false), @"Initialization failed");
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_log_writer_enable_symbol_names(&writer), @"Failed to enable the symbol name table");
+
+    /* Provide binary image info */
+    plcrash_nasync_image_list_init(&image_list, mach_task_self());
+    uint32_t image_count = _dyld_image_count();
+    for (uint32_t i = 0; i < image_count; i++) {
+        plcrash_nasync_image_list_append(&image_list, (uintptr_t) _dyld_get_image_header(i), _dyld_get_image_name(i));
+    }
+
+    /* Write the crash report */
+    struct plcr_live_report_context ctx = {
+        .writer = &writer,
+        .file = &file,
+        .images = &image_list,
+        .info = &info
+    };
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_thread_state_current(plcr_live_report_callback, &ctx), @"Writing crash log failed");
+
+    /* Close it */
+    plcrash_log_writer_close(&writer);
+    plcrash_log_writer_free(&writer);
+    plcrash_nasync_image_list_free(&image_list);
+
+    plcrash_async_file_flush(&file);
+    plcrash_async_file_close(&file);
+
+    /* Decode the report both normally and compactly */
+    NSData *data = [NSData dataWithContentsOfFile: _logPath options: NSDataReadingMappedIfSafe error: nil];
+    PLCrashReport *standard = [[[PLCrashReport alloc] initWithData: data error: &error] autorelease];
+    STAssertNotNil(standard, @"Could not decode crash log: %@", error);
+
+    PLCrashReport *compact = [[[PLCrashReport alloc] initWithData: data options: PLCrashReportDecodingOptionCompact error: &error] autorelease];
+    STAssertNotNil(compact, @"Could not compactly decode crash log: %@", error);
+
+    STAssertEquals([compact.threads count], [standard.threads count], @"Incorrect thread count");
+    for (NSUInteger i = 0; i < [compact.threads count] && i < [standard.threads count]; i++) {
+        NSArray *lhs = [[compact.threads objectAtIndex: i] stackFrames];
+        NSArray *rhs = [[standard.threads objectAtIndex: i] stackFrames];
+        STAssertEquals([lhs count], [rhs count], @"Incorrect frame count");
+
+        for (NSUInteger j = 0; j < [lhs count] && j < [rhs count]; j++) {
+            PLCrashReportStackFrameInfo *lframe = [lhs objectAtIndex: j];
+            PLCrashReportStackFrameInfo *rframe = [rhs objectAtIndex: j];
+            STAssertEquals(lframe.instructionPointer, rframe.instructionPointer, @"Incorrect instruction pointer");
+            STAssertEqualStrings(lframe.symbolInfo.symbolName, rframe.symbolInfo.symbolName, @"Incorrect symbol name");
+            STAssertEquals(lframe.symbolInfo.startAddress, rframe.symbolInfo.startAddress, @"Incorrect symbol address");
+
+            /* Frame instances are created once, and returned on subsequent access */
+            STAssertTrue(lframe == [lhs objectAtIndex: j], @"Frame instance was not cached");
+        }
+    }
+}
+
+/**
+ * Verify that imageForAddress: returns the image containing the given address.
+ */
+- (void) testImageForAddress {
+    NSError *error = nil;
+    PLCrashReporter *reporter = [[[PLCrashReporter alloc] initWithConfiguration: [PLCrashReporterConfig defaultConfiguration]] autorelease];
+    NSData *reportData = [reporter generateLiveReportAndReturnError: &error];
+    STAssertNotNil(reportData, @"Failed to generate live report: %@", error);
+
+    PLCrashReport *report = [[[PLCrashReport alloc] initWithData: reportData error: &error] autorelease];
+    STAssertNotNil(report, @"Could not decode crash log: %@", error);
+
+    for (PLCrashReportBinaryImageInfo *imageInfo in report.images) {
+        uint64_t base = imageInfo.imageBaseAddress;
+#if __DARWIN_OPAQUE_ARM_THREAD_STATE64
+        base &= 0x0000000fffffffff;
+#endif
+        if (imageInfo.imageSize == 0)
+            continue;
+
+        STAssertEquals([report imageForAddress: base], imageInfo, @"Incorrect image for base address of %@", imageInfo.imageName);
+        STAssertEquals([report imageForAddress: base + imageInfo.imageSize - 1], imageInfo, @"Incorrect image for end address of %@", imageInfo.imageName);
+    }
+
+    STAssertNil([report imageForAddress: 0], @"Returned an image for the NULL address");
+}
 
 @end
@@ -33,6 +33,7 @@
 #import <Foundation/Foundation.h>
 
 #import "PLCrashReportFormatter.h"
+#import "PLCrashReportSymbolDemangler.h"
 
 /**
  * Supported text output formats.
@@ -53,10 +54,28 @@ typedef enum {
 
     /** Encoding to use for string output. */
     NSStringEncoding _stringEncoding;
+
+    /** Symbol demangler, or nil if symbol names should be written as-is. */
+    PLCrashReportSymbolDemangler *_demangler;
 }
 
 + (NSString *) stringValueForCrashReport: (PLCrashReport *) report withTextFormat: (PLCrashReportTextFormat) textFormat;
 
++ (BOOL) writeCrashReport: (PLCrashReport *) report
+           withTextFormat: (PLCrashReportTextFormat) textFormat
+         toFileDescriptor: (int) fd
+                    error: (NSError **) outError;
+
++ (BOOL) writeCrashReport: (PLCrashReport *) report
+           withTextFormat: (PLCrashReportTextFormat) textFormat
+                demangler: (PLCrashReportSymbolDemangler *) demangler
+         toFileDescriptor: (int) fd
+                    error: (NSError **) outError;
+
 - (id) initWithTextFormat: (PLCrashReportTextFormat) textFormat stringEncoding: (NSStringEncoding) stringEncoding;
 
+- (id) initWithTextFormat: (PLCrashReportTextFormat) textFormat
+           stringEncoding: (NSStringEncoding) stringEncoding
+                demangler: (PLCrashReportSymbolDemangler *) demangler;
+
 @end
@@ -34,15 +34,21 @@
 #import "PLCrashReportTextFormatter.h"
 #import "PLCrashCompatConstants.h"
 
+#import "PLCrashTextBuffer.h"
+
 @interface PLCrashReportTextFormatter (PrivateAPI)
-static NSInteger binaryImageSort(id binary1, id binary2, void *context);
-+ (NSString *) formatStackFrame: (PLCrashReportStackFrameInfo *) frameInfo
-                     frameIndex: (NSUInteger) frameIndex
-                         report: (PLCrashReport *) report
-                           lp64: (BOOL) lp64;
++ (void) writeCrashReport: (PLCrashReport *) report
+               textFormat: (PLCrashReportTextFormat) textFormat
+                demangler: (PLCrashReportSymbolDemangler *) demangler
+                   buffer: (plcrash_text_buffer_t *) buffer;
++ (void) writeStackFrame: (PLCrashReportStackFrameInfo *) frameInfo
+              frameIndex: (NSUInteger) frameIndex
+                  report: (PLCrashReport *) report
+                    lp64: (BOOL) lp64
+               demangler: (PLCrashReportSymbolDemangler *) demangler
+                  buffer: (plcrash_text_buffer_t *) buffer;
 @end
 
-
 /**
  * Formats PLCrashReport data as human-readable text.
  */
@@ -59,6 +65,101 @@ static NSInteger binaryImageSort(id binary1, id binary2, void *context);
  * @return Returns the formatted result on success, or nil if an error occurs.
  */
 + (NSString *) stringValueForCrashReport: (PLCrashReport *) report withTextFormat: (PLCrashReportTextFormat) textFormat {
+    plcrash_text_buffer_t buffer;
+    if (!plcrash_text_buffer_init(&buffer, -1))
+        return nil;
+
+    [self writeCrashReport: report textFormat: textFormat demangler: nil buffer: &buffer];
+
+    NSString *result = nil;
+    if (buffer.error == 0)
+        result = [[[NSString alloc] initWithBytes: buffer.data length: buffer.length encoding: NSUTF8StringEncoding] autorelease];
+
+    plcrash_text_buffer_free(&buffer);
+    return result;
+}
+
+/**
+ * Formats the provided @a report as human-readable UTF-8 text in the given @a textFormat, writing the result
+ * to @a fd. Output is streamed through a fixed-size buffer, rather than accumulating the formatted report
+ * in memory.
+ *
+ * @param report The report to format.
+ * @param textFormat The text format to use.
+ * @param fd The file descriptor to which the formatted report will be written.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error
+ * object indicating why the report could not be written. If no error occurs, this parameter will be left
+ * unmodified. You may specify nil for this parameter, and no error information will be provided.
+ *
+ * @return Returns YES on success, or NO if an error occurs.
+ */
++ (BOOL) writeCrashReport: (PLCrashReport *) report
+           withTextFormat: (PLCrashReportTextFormat) textFormat
+         toFileDescriptor: (int) fd
+                    error: (NSError **) outError
+{
+    return [self writeCrashReport: report withTextFormat: textFormat demangler: nil toFileDescriptor: fd error: outError];
+}
+
+/**
+ * Formats the provided @a report as human-readable UTF-8 text in the given @a textFormat, writing the result
+ * to @a fd. Output is streamed through a fixed-size buffer, rather than accumulating the formatted report
+ * in memory.
+ *
+ * @param report The report to format.
+ * @param textFormat The text format to use.
+ * @param demangler The demangler to be used for symbol names, or nil to write symbol names as-is. A single
+ * demangler may be shared across reports, and across concurrent callers.
+ * @param fd The file descriptor to which the formatted report will be written.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error
+ * object indicating why the report could not be written. If no error occurs, this parameter will be left
+ * unmodified. You may specify nil for this parameter, and no error information will be provided.
+ *
+ * @return Returns YES on success, or NO if an error occurs.
+ */
++ (BOOL) writeCrashReport: (PLCrashReport *) report
+           withTextFormat: (PLCrashReportTextFormat) textFormat
+                demangler: (PLCrashReportSymbolDemangler *) demangler
+         toFileDescriptor: (int) fd
+                    error: (NSError **) outError
+{
+    plcrash_text_buffer_t buffer;
+    if (!plcrash_text_buffer_init(&buffer, fd)) {
+        if (outError != NULL)
+            *outError = [NSError errorWithDomain: NSPOSIXErrorDomain code: ENOMEM userInfo: nil];
+        return NO;
+    }
+
+    [self writeCrashReport: report textFormat: textFormat demangler: demangler buffer: &buffer];
+    plcrash_text_buffer_flush(&buffer);
+
+    int error = buffer.error;
+    plcrash_text_buffer_free(&buffer);
+
+    if (error != 0) {
+        if (outError != NULL)
+            *outError = [NSError errorWithDomain: NSPOSIXErrorDomain code: error userInfo: nil];
+        return NO;
+    }
+
+    return YES;
+}
+
+/**
+ * @internal
+ * Format the provided @a report as human-readable text in the given @a textFormat, appending the result to
+ * @a buffer.
+ *
+ * @param report The report to format.
+ * @param textFormat The text format to use.
+ * @param demangler The symbol demangler, or nil.
+ * @param buffer The output buffer.
+ */
++ (void) writeCrashReport: (PLCrashReport *) report
+               textFormat: (PLCrashReportTextFormat) textFormat
+                demangler: (PLCrashReportSymbolDemangler *) demangler
+                   buffer: (plcrash_text_buffer_t *) buffer
+{
 	NSMutableString* text = [NSMutableString string];
 	boolean_t lp64 = true; // quiesce GCC uninitialized value warning
 
@@ -272,37 +373,74 @@ static NSInteger binaryImageSort(id binary1, id binary2, void *context);
         [text appendString: @"\n"];
     }
 
+    /* Memory statistics */
+    if (report.memoryStatistics != nil) {
+        PLCrashReportMemoryStatistics *stats = report.memoryStatistics;
+
+        [text appendFormat: @"Physical Footprint:  %" PRIu64 " KB\n", stats.physicalFootprint / 1024];
+        [text appendFormat: @"Resident Size:       %" PRIu64 " KB (peak %" PRIu64 " KB)\n", stats.residentSize / 1024, stats.peakResidentSize / 1024];
+        [text appendFormat: @"Compressed Size:     %" PRIu64 " KB\n", stats.compressedSize / 1024];
+        [text appendFormat: @"Virtual Size:        %" PRIu64 " KB\n", stats.virtualSize / 1024];
+        [text appendFormat: @"VM Region Count:     %lu\n", (unsigned long) stats.regionCount];
+
+        for (PLCrashReportMemoryRegion *region in stats.largestRegions) {
+            [text appendFormat: @"    0x%" PRIx64 " - 0x%" PRIx64 " %10" PRIu64 " KB  tag %u\n",
+                region.address, region.address + region.size, region.size / 1024, region.userTag];
+        }
+
+        [text appendString: @"\n"];
+    }
+
+    /* The remaining sections are written directly to the output buffer */
+    plcrash_text_buffer_append_string(buffer, text);
+
     /* If an exception stack trace is available, output an Apple-compatible backtrace. */
     if (report.exceptionInfo != nil && report.exceptionInfo.stackFrames != nil && [report.exceptionInfo.stackFrames count] > 0) {
         PLCrashReportExceptionInfo *exception = report.exceptionInfo;
         
         /* Create the header. */
-        [text appendString: @"Last Exception Backtrace:\n"];
+        plcrash_text_buffer_append_cstring(buffer, "Last Exception Backtrace:\n");
 
         /* Write out the frames. In raw reports, Apple writes this out as a simple list of PCs. In the minimally
          * post-processed report, Apple writes this out as full frame entries. We use the latter format. */
         for (NSUInteger frame_idx = 0; frame_idx < [exception.stackFrames count]; frame_idx++) {
             PLCrashReportStackFrameInfo *frameInfo = [exception.stackFrames objectAtIndex: frame_idx];
-            [text appendString: [self formatStackFrame: frameInfo frameIndex: frame_idx report: report lp64: lp64]];
+            [self writeStackFrame: frameInfo frameIndex: frame_idx report: report lp64: lp64 demangler: demangler buffer: buffer];
         }
-        [text appendString: @"\n"];
+        plcrash_text_buffer_append_cstring(buffer, "\n");
     }
 
     /* Threads */
     PLCrashReportThreadInfo *crashed_thread = nil;
     NSInteger maxThreadNum = 0;
     for (PLCrashReportThreadInfo *thread in report.threads) {
+        /* Apple labels a thread with its dispatch queue, falling back on the thread name */
+        if (thread.dispatchQueueLabel != nil || thread.name != nil) {
+            plcrash_text_buffer_append_cstring(buffer, "Thread ");
+            plcrash_text_buffer_append_decimal(buffer, thread.threadNumber, 0);
+            plcrash_text_buffer_append_cstring(buffer, " name:  ");
+            if (thread.dispatchQueueLabel != nil) {
+                plcrash_text_buffer_append_cstring(buffer, "Dispatch queue: ");
+                plcrash_text_buffer_append_string(buffer, thread.dispatchQueueLabel);
+            } else {
+                plcrash_text_buffer_append_string(buffer, thread.name);
+            }
+            plcrash_text_buffer_append_cstring(buffer, "\n");
+        }
+
+        plcrash_text_buffer_append_cstring(buffer, "Thread ");
+        plcrash_text_buffer_append_decimal(buffer, thread.threadNumber, 0);
         if (thread.crashed) {
-            [text appendFormat: @"Thread %ld Crashed:\n", (long) thread.threadNumber];
+            plcrash_text_buffer_append_cstring(buffer, " Crashed:\n");
             crashed_thread = thread;
         } else {
-            [text appendFormat: @"Thread %ld:\n", (long) thread.threadNumber];
+            plcrash_text_buffer_append_cstring(buffer, ":\n");
         }
         for (NSUInteger frame_idx = 0; frame_idx < [thread.stackFrames count]; frame_idx++) {
             PLCrashReportStackFrameInfo *frameInfo = [thread.stackFrames objectAtIndex: frame_idx];
-            [text appendString: [self formatStackFrame: frameInfo frameIndex: frame_idx report: report lp64: lp64]];
+            [self writeStackFrame: frameInfo frameIndex: frame_idx report: report lp64: lp64 demangler: demangler buffer: buffer];
         }
-        [text appendString: @"\n"];
+        plcrash_text_buffer_append_cstring(buffer, "\n");
 
         /* Track the highest thread number */
         maxThreadNum = MAX(maxThreadNum, thread.threadNumber);
@@ -310,18 +448,14 @@ static NSInteger binaryImageSort(id binary1, id binary2, void *context);
 
     /* Registers */
     if (crashed_thread != nil) {
-        [text appendFormat: @"Thread %ld crashed with %@ Thread State:\n", (long) crashed_thread.threadNumber, codeType];
+        plcrash_text_buffer_append_cstring(buffer, "Thread ");
+        plcrash_text_buffer_append_decimal(buffer, crashed_thread.threadNumber, 0);
+        plcrash_text_buffer_append_cstring(buffer, " crashed with ");
+        plcrash_text_buffer_append_string(buffer, codeType);
+        plcrash_text_buffer_append_cstring(buffer, " Thread State:\n");
         
         int regColumn = 0;
         for (PLCrashReportRegisterInfo *reg in crashed_thread.registers) {
-            NSString *reg_fmt;
-            
-            /* Use 32-bit or 64-bit fixed width format for the register values */
-            if (lp64)
-                reg_fmt = @"%6s: 0x%016" PRIx64 " ";
-            else
-                reg_fmt = @"%6s: 0x%08" PRIx64 " ";
-            
             /* Remap register names to match Apple's crash reports */
             NSString *regName = reg.registerName;
             if (report.machineInfo != nil && report.machineInfo.processorInfo.typeEncoding == PLCrashReportProcessorTypeEncodingMach) {
@@ -333,25 +467,33 @@ static NSInteger binaryImageSort(id binary1, id binary2, void *context);
                     regName = @"ip";
                 }
             }
-            [text appendFormat: reg_fmt, [regName UTF8String], reg.registerValue];
+            /* Right-justify the name, and use a 32-bit or 64-bit fixed width format for the register values */
+            const char *regNameString = [regName UTF8String];
+            size_t regNameLength = strlen(regNameString);
+            if (regNameLength < 6)
+                plcrash_text_buffer_append_padding(buffer, 6 - regNameLength);
+            plcrash_text_buffer_append(buffer, regNameString, regNameLength);
+            plcrash_text_buffer_append_cstring(buffer, ": 0x");
+            plcrash_text_buffer_append_hex(buffer, reg.registerValue, lp64 ? 16 : 8);
+            plcrash_text_buffer_append_cstring(buffer, " ");
 
             regColumn++;
             if (regColumn == 4) {
-                [text appendString: @"\n"];
+                plcrash_text_buffer_append_cstring(buffer, "\n");
                 regColumn = 0;
             }
         }
         
         if (regColumn != 0)
-            [text appendString: @"\n"];
+            plcrash_text_buffer_append_cstring(buffer, "\n");
         
-        [text appendString: @"\n"];
+        plcrash_text_buffer_append_cstring(buffer, "\n");
     }
     
     /* Images. The iPhone crash report format sorts these in ascending order, by the base address */
-    [text appendString: @"Binary Images:\n"];
+    plcrash_text_buffer_append_cstring(buffer, "Binary Images:\n");
     uint64_t lastImageBaseAddress = 0;
-    for (PLCrashReportBinaryImageInfo *imageInfo in [report.images sortedArrayUsingFunction: binaryImageSort context: nil]) {
+    for (PLCrashReportBinaryImageInfo *imageInfo in report.sortedImages) {
         /* Remove duplicates */
         uint64_t imageBaseAddress = [imageInfo imageBaseAddress];
         if (lastImageBaseAddress == imageBaseAddress) {
@@ -367,26 +509,26 @@ static NSInteger binaryImageSort(id binary1, id binary2, void *context);
             uuid = @"???";
         
         /* Determine the architecture string */
-        NSString *archName = @"???";
+        const char *archName = "???";
         if (imageInfo.codeType != nil && imageInfo.codeType.typeEncoding == PLCrashReportProcessorTypeEncodingMach) {
             switch (imageInfo.codeType.type) {
                 case CPU_TYPE_ARM:
                     /* Apple includes subtype for ARM binaries. */
                     switch (imageInfo.codeType.subtype) {
                         case CPU_SUBTYPE_ARM_V6:
-                            archName = @"armv6";
+                            archName = "armv6";
                             break;
 
                         case CPU_SUBTYPE_ARM_V7:
-                            archName = @"armv7";
+                            archName = "armv7";
                             break;
                             
                         case CPU_SUBTYPE_ARM_V7S:
-                            archName = @"armv7s";
+                            archName = "armv7s";
                             break;
 
                         default:
-                            archName = @"arm-unknown";
+                            archName = "arm-unknown";
                             break;
                     }
                     break;
@@ -395,33 +537,33 @@ static NSInteger binaryImageSort(id binary1, id binary2, void *context);
                     /* Apple includes subtype for ARM64 binaries. */
                     switch (imageInfo.codeType.subtype) {
                         case CPU_SUBTYPE_ARM64_ALL:
-                            archName = @"arm64";
+                            archName = "arm64";
                             break;
 
                         case CPU_SUBTYPE_ARM64_V8:
-                            archName = @"armv8";
+                            archName = "armv8";
                             break;
 
                         case CPU_SUBTYPE_ARM64E:
-                            archName = @"arm64e";
+                            archName = "arm64e";
                             break;
 
                         default:
-                            archName = @"arm64-unknown";
+                            archName = "arm64-unknown";
                             break;
                     }
                     break;
                     
                 case CPU_TYPE_X86:
-                    archName = @"i386";
+                    archName = "i386";
                     break;
                     
                 case CPU_TYPE_X86_64:
-                    archName = @"x86_64";
+                    archName = "x86_64";
                     break;
 
                 case CPU_TYPE_POWERPC:
-                    archName = @"powerpc";
+                    archName = "powerpc";
                     break;
 
                 default:
@@ -431,30 +573,26 @@ static NSInteger binaryImageSort(id binary1, id binary2, void *context);
         }
 
         /* Determine if this is the main executable */
-        NSString *binaryDesignator = @" ";
+        const char *binaryDesignator = " ";
         if ([imageInfo.imageName isEqual: report.processInfo.processPath])
-            binaryDesignator = @"+";
+            binaryDesignator = "+";
         
         /* base_address - terminating_address [designator]file_name arch <uuid> file_path */
-        NSString *fmt = nil;
-        if (lp64) {
-            fmt = @"%18#" PRIx64 " - %18#" PRIx64 " %@%@ %@  <%@> %@\n";
-        } else {
-            fmt = @"%10#" PRIx64 " - %10#" PRIx64 " %@%@ %@  <%@> %@\n";
-        }
-
-        [text appendFormat: fmt,
-                            imageInfo.imageBaseAddress,
-                            imageInfo.imageBaseAddress + (MAX(1, imageInfo.imageSize) - 1), // The Apple format uses an inclusive range
-                            binaryDesignator,
-                            [imageInfo.imageName lastPathComponent],
-                            archName,
-                            uuid,
-                            imageInfo.imageName];
+        size_t addressWidth = lp64 ? 18 : 10;
+        plcrash_text_buffer_append_alternate_hex(buffer, imageInfo.imageBaseAddress, addressWidth);
+        plcrash_text_buffer_append_cstring(buffer, " - ");
+        plcrash_text_buffer_append_alternate_hex(buffer, imageInfo.imageBaseAddress + (MAX(1, imageInfo.imageSize) - 1), addressWidth); // The Apple format uses an inclusive range
+        plcrash_text_buffer_append_cstring(buffer, " ");
+        plcrash_text_buffer_append_cstring(buffer, binaryDesignator);
+        plcrash_text_buffer_append_last_path_component(buffer, imageInfo.imageName, 0);
+        plcrash_text_buffer_append_cstring(buffer, " ");
+        plcrash_text_buffer_append_cstring(buffer, archName);
+        plcrash_text_buffer_append_cstring(buffer, "  <");
+        plcrash_text_buffer_append_string(buffer, uuid);
+        plcrash_text_buffer_append_cstring(buffer, "> ");
+        plcrash_text_buffer_append_string(buffer, imageInfo.imageName);
+        plcrash_text_buffer_append_cstring(buffer, "\n");
     }
-    
-
-    return text;
 }
 
 /**
@@ -464,18 +602,55 @@ static NSInteger binaryImageSort(id binary1, id binary2, void *context);
  * @param stringEncoding Encoding to use when writing to the output stream.
  */
 - (id) initWithTextFormat: (PLCrashReportTextFormat) textFormat stringEncoding: (NSStringEncoding) stringEncoding {
+    return [self initWithTextFormat: textFormat stringEncoding: stringEncoding demangler: nil];
+}
+
+/**
+ * Initialize with the request string encoding, output format, and symbol demangler.
+ *
+ * @param textFormat Format to use for the generated text crash report.
+ * @param stringEncoding Encoding to use when writing to the output stream.
+ * @param demangler The demangler to be used for symbol names, or nil to write symbol names as-is. A single
+ * demangler may be shared by all formatters used to process a batch of reports.
+ */
+- (id) initWithTextFormat: (PLCrashReportTextFormat) textFormat
+           stringEncoding: (NSStringEncoding) stringEncoding
+                demangler: (PLCrashReportSymbolDemangler *) demangler
+{
     if ((self = [super init]) == nil)
         return nil;
     
     _textFormat = textFormat;
     _stringEncoding = stringEncoding;
+    _demangler = [demangler retain];
 
     return self;
 }
 
+- (void) dealloc {
+    [_demangler release];
+    [super dealloc];
+}
+
 // from PLCrashReportFormatter protocol
 - (NSData *) formatReport: (PLCrashReport *) report error: (NSError **) outError {
-    NSString *text = [PLCrashReportTextFormatter stringValueForCrashReport: report withTextFormat: _textFormat];
+    plcrash_text_buffer_t buffer;
+    if (!plcrash_text_buffer_init(&buffer, -1))
+        return nil;
+
+    [PLCrashReportTextFormatter writeCrashReport: report textFormat: _textFormat demangler: _demangler buffer: &buffer];
+    if (buffer.error != 0) {
+        plcrash_text_buffer_free(&buffer);
+        return nil;
+    }
+
+    /* UTF-8 output may be returned directly, without an intermediate string */
+    if (_stringEncoding == NSUTF8StringEncoding)
+        return [NSData dataWithBytesNoCopy: buffer.data length: buffer.length freeWhenDone: YES];
+
+    NSString *text = [[[NSString alloc] initWithBytes: buffer.data length: buffer.length encoding: NSUTF8StringEncoding] autorelease];
+    plcrash_text_buffer_free(&buffer);
+
     return [text dataUsingEncoding: _stringEncoding allowLossyConversion: YES];
 }
 		 
@@ -491,20 +666,20 @@ static NSInteger binaryImageSort(id binary1, id binary2, void *context);
  * @param frameIndex The frame's index
  * @param report The report from which this frame was acquired.
  * @param lp64 If YES, the report was generated by an LP64 system.
- *
- * @return Returns a formatted frame line.
+ * @param demangler The symbol demangler, or nil.
+ * @param buffer The output buffer to which the formatted frame line will be appended.
  */
-+ (NSString *) formatStackFrame: (PLCrashReportStackFrameInfo *) frameInfo
-                     frameIndex: (NSUInteger) frameIndex
-                         report: (PLCrashReport *) report
-                           lp64: (BOOL) lp64
++ (void) writeStackFrame: (PLCrashReportStackFrameInfo *) frameInfo
+              frameIndex: (NSUInteger) frameIndex
+                  report: (PLCrashReport *) report
+                    lp64: (BOOL) lp64
+               demangler: (PLCrashReportSymbolDemangler *) demangler
+                  buffer: (plcrash_text_buffer_t *) buffer
 {
     /* Base image address containing instrumention pointer, offset of the IP from that base
-     * address, and the associated image name */
+     * address, and the associated image */
     uint64_t baseAddress = 0x0;
     uint64_t pcOffset = 0x0;
-    NSString *imageName = @"\?\?\?";
-    NSString *symbolString = nil;
 
     uint64_t normalizedInstructionPointer = frameInfo.instructionPointer;
 #if __DARWIN_OPAQUE_ARM_THREAD_STATE64
@@ -513,25 +688,44 @@ static NSInteger binaryImageSort(id binary1, id binary2, void *context);
 
     PLCrashReportBinaryImageInfo *imageInfo = [report imageForAddress: normalizedInstructionPointer];
     if (imageInfo != nil) {
-        imageName = [imageInfo.imageName lastPathComponent];
         baseAddress = imageInfo.imageBaseAddress;
         pcOffset = normalizedInstructionPointer - imageInfo.imageBaseAddress;
     }
 
+    /* Frame index and image name */
+    plcrash_text_buffer_append_decimal(buffer, (int64_t) frameIndex, 4);
+    if (imageInfo != nil) {
+        plcrash_text_buffer_append_last_path_component(buffer, imageInfo.imageName, 35);
+    } else {
+        plcrash_text_buffer_append_cstring(buffer, "???");
+        plcrash_text_buffer_append_padding(buffer, 35 - 3);
+    }
+
+    /* Instruction pointer */
+    plcrash_text_buffer_append_cstring(buffer, " 0x");
+    plcrash_text_buffer_append_hex(buffer, normalizedInstructionPointer, lp64 ? 16 : 8);
+    plcrash_text_buffer_append_cstring(buffer, " ");
+
     /* If symbol info is available, the format used in Apple's reports is Sym + OffsetFromSym. Otherwise,
      * the format used is imageBaseAddress + offsetToIP */
     if (frameInfo.symbolInfo != nil) {
         NSString *symbolName = frameInfo.symbolInfo.symbolName;
+        NSString *demangledName = [demangler demangledNameForSymbol: symbolName];
+        NSUInteger symbolPrefixLength = 0;
+
+        /* Demangled names no longer carry a symbol prefix */
+        if (demangledName != nil)
+            symbolName = demangledName;
 
         /* Apple strips the _ symbol prefix in their reports. Only OS X makes use of an
          * underscore symbol prefix by default. */
-        if ([symbolName rangeOfString: @"_"].location == 0 && [symbolName length] > 1) {
+        if (demangledName == nil && [symbolName rangeOfString: @"_"].location == 0 && [symbolName length] > 1) {
             switch (report.systemInfo.operatingSystem) {
                 case PLCrashReportOperatingSystemMacOSX:
                 case PLCrashReportOperatingSystemiPhoneOS:
                 case PLCrashReportOperatingSystemAppleTVOS:
                 case PLCrashReportOperatingSystemiPhoneSimulator:
-                    symbolName = [symbolName substringFromIndex: 1];
+                    symbolPrefixLength = 1;
                     break;
 
                 default:
@@ -541,35 +735,25 @@ static NSInteger binaryImageSort(id binary1, id binary2, void *context);
         }
         
         
+        /* The stripped '_' prefix is a single UTF-8 byte */
+        if (symbolPrefixLength > 0) {
+            const char *symbolString = [symbolName UTF8String];
+            plcrash_text_buffer_append_cstring(buffer, symbolString + symbolPrefixLength);
+        } else {
+            plcrash_text_buffer_append_string(buffer, symbolName);
+        }
+
         uint64_t symOffset = normalizedInstructionPointer - frameInfo.symbolInfo.startAddress;
-        symbolString = [NSString stringWithFormat: @"%@ + %" PRId64, symbolName, symOffset];
+        plcrash_text_buffer_append_cstring(buffer, " + ");
+        plcrash_text_buffer_append_decimal(buffer, (int64_t) symOffset, 0);
     } else {
-        symbolString = [NSString stringWithFormat: @"0x%" PRIx64 " + %" PRId64, baseAddress, pcOffset];
+        plcrash_text_buffer_append_cstring(buffer, "0x");
+        plcrash_text_buffer_append_hex(buffer, baseAddress, 1);
+        plcrash_text_buffer_append_cstring(buffer, " + ");
+        plcrash_text_buffer_append_decimal(buffer, (int64_t) pcOffset, 0);
     }
 
-    /* Note that width specifiers are ignored for %@, but work for C strings.
-     * UTF-8 is not correctly handled with %s (it depends on the system encoding), but
-     * UTF-16 is supported via %S, so we use it here */
-    return [NSString stringWithFormat: @"%-4ld%-35S 0x%0*" PRIx64 " %@\n",
-            (long) frameIndex,
-            (const uint16_t *)[imageName cStringUsingEncoding: NSUTF16StringEncoding],
-            lp64 ? 16 : 8, normalizedInstructionPointer,
-            symbolString];
-}
-
-/**
- * Sort PLCrashReportBinaryImageInfo instances by their starting address.
- */
-static NSInteger binaryImageSort(id binary1, id binary2, void *context) {
-    uint64_t addr1 = [binary1 imageBaseAddress];
-    uint64_t addr2 = [binary2 imageBaseAddress];
-    
-    if (addr1 < addr2)
-        return NSOrderedAscending;
-    else if (addr1 > addr2)
-        return NSOrderedDescending;
-    else
-        return NSOrderedSame;
+    plcrash_text_buffer_append_cstring(buffer, "\n");
 }
 
 @end
@@ -44,6 +44,27 @@
 
     /** List of PLCrashReportRegister instances. Will be empty if _crashed is NO. */
     NSArray *_registers;
+
+    /** The thread's system-wide unique identifier, or 0 if unavailable. */
+    uint64_t _threadIdentifier;
+
+    /** The thread's name, or nil if unavailable. */
+    NSString *_name;
+
+    /** The label of the thread's dispatch queue, or nil if unavailable. */
+    NSString *_dispatchQueueLabel;
+
+    /** The thread's qos_class_t value, or 0 if unavailable. */
+    NSUInteger _qosClass;
+
+    /** YES if the thread's CPU times are available. */
+    BOOL _hasCPUTime;
+
+    /** The user CPU time consumed by the thread, in nanoseconds. */
+    uint64_t _userTime;
+
+    /** The system CPU time consumed by the thread, in nanoseconds. */
+    uint64_t _systemTime;
 }
 
 - (id) initWithThreadNumber: (NSInteger) threadNumber
@@ -51,6 +72,18 @@
                     crashed: (BOOL) crashed
                   registers: (NSArray *) registers;
 
+- (id) initWithThreadNumber: (NSInteger) threadNumber
+                stackFrames: (NSArray *) stackFrames
+                    crashed: (BOOL) crashed
+                  registers: (NSArray *) registers
+           threadIdentifier: (uint64_t) threadIdentifier
+                       name: (NSString *) name
+         dispatchQueueLabel: (NSString *) dispatchQueueLabel
+                   qosClass: (NSUInteger) qosClass
+                 hasCPUTime: (BOOL) hasCPUTime
+                   userTime: (uint64_t) userTime
+                 systemTime: (uint64_t) systemTime;
+
 /**
  * Application thread number.
  */
@@ -70,8 +103,44 @@
 /**
  * State of the general purpose and related registers, as a list of
  * PLCrashReportRegister instances. If this thead did not crash (crashed returns NO),
- * this list will be empty.
+ * this list will be empty, unless the report was written with registers for all threads.
  */
 @property(nonatomic, readonly) NSArray *registers;
 
+/**
+ * The thread's system-wide unique identifier, or 0 if thread metadata was not captured.
+ */
+@property(nonatomic, readonly) uint64_t threadIdentifier;
+
+/**
+ * The thread's name, or nil if the thread was unnamed or its name was not captured.
+ */
+@property(nonatomic, readonly) NSString *name;
+
+/**
+ * The label of the dispatch queue on which the thread was executing, or nil if the thread was not executing
+ * on a dispatch queue or the label was not captured.
+ */
+@property(nonatomic, readonly) NSString *dispatchQueueLabel;
+
+/**
+ * The thread's quality-of-service class, as a qos_class_t value, or 0 (QOS_CLASS_UNSPECIFIED) if unavailable.
+ */
+@property(nonatomic, readonly) NSUInteger qosClass;
+
+/**
+ * YES if the thread's CPU times were captured.
+ */
+@property(nonatomic, readonly) BOOL hasCPUTime;
+
+/**
+ * The user CPU time consumed by the thread, in nanoseconds. Only valid if hasCPUTime is YES.
+ */
+@property(nonatomic, readonly) uint64_t userTime;
+
+/**
+ * The system CPU time consumed by the thread, in nanoseconds. Only valid if hasCPUTime is YES.
+ */
+@property(nonatomic, readonly) uint64_t systemTime;
+
 @end
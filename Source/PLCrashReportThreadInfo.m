@@ -42,6 +42,46 @@
                 stackFrames: (NSArray *) stackFrames
                     crashed: (BOOL) crashed
                   registers: (NSArray *) registers
+{
+    return [self initWithThreadNumber: threadNumber
+                          stackFrames: stackFrames
+                              crashed: crashed
+                            registers: registers
+                     threadIdentifier: 0
+                                 name: nil
+                   dispatchQueueLabel: nil
+                             qosClass: 0
+                           hasCPUTime: NO
+                             userTime: 0
+                           systemTime: 0];
+}
+
+/**
+ * Initialize the crash log thread information, including the thread's captured metadata.
+ *
+ * @param threadNumber The thread number.
+ * @param stackFrames The thread's backtrace.
+ * @param crashed YES if this thread crashed.
+ * @param registers The thread's registers.
+ * @param threadIdentifier The thread's system-wide unique identifier, or 0 if unavailable.
+ * @param name The thread's name, or nil.
+ * @param dispatchQueueLabel The label of the thread's dispatch queue, or nil.
+ * @param qosClass The thread's qos_class_t value, or 0 if unavailable.
+ * @param hasCPUTime YES if @a userTime and @a systemTime are available.
+ * @param userTime The user CPU time consumed by the thread, in nanoseconds.
+ * @param systemTime The system CPU time consumed by the thread, in nanoseconds.
+ */
+- (id) initWithThreadNumber: (NSInteger) threadNumber
+                stackFrames: (NSArray *) stackFrames
+                    crashed: (BOOL) crashed
+                  registers: (NSArray *) registers
+           threadIdentifier: (uint64_t) threadIdentifier
+                       name: (NSString *) name
+         dispatchQueueLabel: (NSString *) dispatchQueueLabel
+                   qosClass: (NSUInteger) qosClass
+                 hasCPUTime: (BOOL) hasCPUTime
+                   userTime: (uint64_t) userTime
+                 systemTime: (uint64_t) systemTime
 {
     if ((self = [super init]) == nil)
         return nil;
@@ -50,6 +90,13 @@
     _stackFrames = [stackFrames retain];
     _crashed = crashed;
     _registers = [registers retain];
+    _threadIdentifier = threadIdentifier;
+    _name = [name copy];
+    _dispatchQueueLabel = [dispatchQueueLabel copy];
+    _qosClass = qosClass;
+    _hasCPUTime = hasCPUTime;
+    _userTime = userTime;
+    _systemTime = systemTime;
 
     return self;
 }
@@ -57,6 +104,8 @@
 - (void) dealloc {
     [_stackFrames release];
     [_registers release];
+    [_name release];
+    [_dispatchQueueLabel release];
     [super dealloc];
 }
 
@@ -64,6 +113,13 @@
 @synthesize stackFrames = _stackFrames;
 @synthesize crashed = _crashed;
 @synthesize registers = _registers;
+@synthesize threadIdentifier = _threadIdentifier;
+@synthesize name = _name;
+@synthesize dispatchQueueLabel = _dispatchQueueLabel;
+@synthesize qosClass = _qosClass;
+@synthesize hasCPUTime = _hasCPUTime;
+@synthesize userTime = _userTime;
+@synthesize systemTime = _systemTime;
 
 
 @end
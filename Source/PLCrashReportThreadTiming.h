@@ -0,0 +1,63 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+@interface PLCrashReportThreadTiming : NSObject {
+@private
+    /** The thread's number. */
+    NSInteger _threadNumber;
+
+    /** Number of frames walked. */
+    NSUInteger _frameCount;
+
+    /** Time spent walking the thread's stack. */
+    NSTimeInterval _walkTime;
+
+    /** Time spent symbolicating and writing the thread. */
+    NSTimeInterval _symbolicationTime;
+}
+
+- (id) initWithThreadNumber: (NSInteger) threadNumber
+                 frameCount: (NSUInteger) frameCount
+                   walkTime: (NSTimeInterval) walkTime
+          symbolicationTime: (NSTimeInterval) symbolicationTime;
+
+/** The number of the timed thread, matching PLCrashReportThreadInfo.threadNumber. */
+@property(nonatomic, readonly) NSInteger threadNumber;
+
+/** The number of frames walked. Will be 0 for threads written in raw capture mode. */
+@property(nonatomic, readonly) NSUInteger frameCount;
+
+/** Time spent walking the thread's stack. */
+@property(nonatomic, readonly) NSTimeInterval walkTime;
+
+/** Time spent symbolicating and writing the thread, including the binary images referenced by its frames. */
+@property(nonatomic, readonly) NSTimeInterval symbolicationTime;
+
+@end
@@ -0,0 +1,65 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashReportThreadTiming.h"
+
+/**
+ * The time spent writing a single thread of a crash report.
+ */
+@implementation PLCrashReportThreadTiming
+
+@synthesize threadNumber = _threadNumber;
+@synthesize frameCount = _frameCount;
+@synthesize walkTime = _walkTime;
+@synthesize symbolicationTime = _symbolicationTime;
+
+/**
+ * Initialize a new thread timing data object.
+ *
+ * @param threadNumber The thread's number.
+ * @param frameCount The number of frames walked.
+ * @param walkTime The time spent walking the thread's stack.
+ * @param symbolicationTime The time spent symbolicating and writing the thread.
+ */
+- (id) initWithThreadNumber: (NSInteger) threadNumber
+                 frameCount: (NSUInteger) frameCount
+                   walkTime: (NSTimeInterval) walkTime
+          symbolicationTime: (NSTimeInterval) symbolicationTime
+{
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _threadNumber = threadNumber;
+    _frameCount = frameCount;
+    _walkTime = walkTime;
+    _symbolicationTime = symbolicationTime;
+
+    return self;
+}
+
+@end
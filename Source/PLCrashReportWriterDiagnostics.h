@@ -0,0 +1,67 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "PLCrashReportThreadTiming.h"
+
+@interface PLCrashReportWriterDiagnostics : NSObject {
+@private
+    /** Time spent suspending all other threads. */
+    NSTimeInterval _suspendTime;
+
+    /** Per-thread timing (PLCrashReportThreadTiming instances). */
+    NSArray *_threadTimings;
+
+    /** Time spent writing unreferenced binary images. */
+    NSTimeInterval _imageTime;
+
+    /** Total time spent writing the report. */
+    NSTimeInterval _totalTime;
+}
+
+- (id) initWithSuspendTime: (NSTimeInterval) suspendTime
+             threadTimings: (NSArray *) threadTimings
+                 imageTime: (NSTimeInterval) imageTime
+                 totalTime: (NSTimeInterval) totalTime;
+
+/** Time spent suspending all threads other than the thread writing the report. */
+@property(nonatomic, readonly) NSTimeInterval suspendTime;
+
+/** The timing of each written thread, as PLCrashReportThreadTiming instances, in the order in which the threads were
+ * written. Threads beyond the writer's timing limit are omitted. */
+@property(nonatomic, readonly) NSArray *threadTimings;
+
+/** Time spent writing the binary images that were not referenced by any thread's frames. */
+@property(nonatomic, readonly) NSTimeInterval imageTime;
+
+/** Time elapsed from the start of the report until the diagnostics were written. The time spent flushing the report
+ * to disk is not included. */
+@property(nonatomic, readonly) NSTimeInterval totalTime;
+
+@end
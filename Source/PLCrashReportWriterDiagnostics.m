@@ -0,0 +1,73 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashReportWriterDiagnostics.h"
+
+/**
+ * Crash log writer diagnostics.
+ *
+ * Provides the time spent in each phase of writing the crash report, allowing the cost of the crash path to be
+ * measured on deployed devices.
+ */
+@implementation PLCrashReportWriterDiagnostics
+
+@synthesize suspendTime = _suspendTime;
+@synthesize threadTimings = _threadTimings;
+@synthesize imageTime = _imageTime;
+@synthesize totalTime = _totalTime;
+
+/**
+ * Initialize a new writer diagnostics data object.
+ *
+ * @param suspendTime The time spent suspending all other threads.
+ * @param threadTimings The timing of each written thread, as PLCrashReportThreadTiming instances.
+ * @param imageTime The time spent writing unreferenced binary images.
+ * @param totalTime The total time spent writing the report.
+ */
+- (id) initWithSuspendTime: (NSTimeInterval) suspendTime
+             threadTimings: (NSArray *) threadTimings
+                 imageTime: (NSTimeInterval) imageTime
+                 totalTime: (NSTimeInterval) totalTime
+{
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _suspendTime = suspendTime;
+    _threadTimings = [threadTimings retain];
+    _imageTime = imageTime;
+    _totalTime = totalTime;
+
+    return self;
+}
+
+- (void) dealloc {
+    [_threadTimings release];
+    [super dealloc];
+}
+
+@end
@@ -30,10 +30,16 @@
 #import <mach/mach.h>
 
 #import "PLCrashReporterConfig.h"
+#import "PLCrashReporterStartupMetrics.h"
+#import "PLCrashCustomData.h"
 #import "PLCrashMacros.h"
 
 @class PLCrashMachExceptionServer;
 @class PLCrashMachExceptionPortSet;
+@class PLCrashReportSummary;
+@class PLCrashLiveReportSession;
+@class PLCrashLiveReportScheduler;
+@class PLCrashReportThreadInfo;
 
 /**
  * @ingroup functions
@@ -50,6 +56,32 @@
  */
 typedef void (*PLCrashReporterPostCrashSignalCallback)(siginfo_t *info, ucontext_t *uap, void *context);
 
+/**
+ * @ingroup types
+ *
+ * Per-request thread filter applied to a scheduled live report (see
+ * PLCrashReporter::scheduleLiveReportWithThreadFilter:completionHandler:).
+ *
+ * @param thread A thread of the captured report.
+ *
+ * @return Return YES if @a thread should be provided to the request's completion handler.
+ */
+typedef BOOL (^PLCrashLiveReportThreadFilter)(PLCrashReportThreadInfo *thread);
+
+/**
+ * @ingroup types
+ *
+ * Completion handler of a scheduled live report (see
+ * PLCrashReporter::scheduleLiveReportWithThreadFilter:completionHandler:).
+ *
+ * @param reportData The encoded live report, shared by all requests coalesced into the same capture, or nil if the
+ * report could not be generated.
+ * @param threads The report's PLCrashReportThreadInfo instances accepted by the request's thread filter, or nil if
+ * the request did not provide a filter, or the report could not be generated or decoded.
+ * @param error If the report could not be generated or decoded, an error describing the failure; otherwise nil.
+ */
+typedef void (^PLCrashLiveReportCompletionHandler)(NSData *reportData, NSArray *threads, NSError *error);
+
 /**
  * @ingroup types
  *
@@ -109,6 +141,24 @@ typedef struct PLCrashReporterCallbacks {
 
     /** Path to the crash reporter internal data directory */
     NSString *_crashReportDirectory;
+
+    /** Timing of the enable process, or nil if the reporter has not been enabled. */
+    PLCrashReporterStartupMetrics *_startupMetrics;
+
+    /** Persistent live report writer, or nil if no live report has been generated. */
+    PLCrashLiveReportSession *_liveReportSession;
+
+    /** Scheduler coalescing concurrent live report requests, or nil if no live report has been scheduled. */
+    PLCrashLiveReportScheduler *_liveReportScheduler;
+
+    /** The active stack sampler, or NULL if stack sampling has not been started. */
+    struct plcrash_stack_sampler *_stackSampler;
+
+    /** The registered key/value area, or NULL if none. */
+    PLCrashKeyValueArea *_keyValueArea;
+
+    /** The registered breadcrumb buffer, or NULL if none. */
+    PLCrashBreadcrumbBuffer *_breadcrumbBuffer;
 }
 
 + (PLCrashReporter *) sharedReporter PLCR_DEPRECATED;
@@ -120,6 +170,8 @@ typedef struct PLCrashReporterCallbacks {
 - (NSData *) loadPendingCrashReportData;
 - (NSData *) loadPendingCrashReportDataAndReturnError: (NSError **) outError;
 
+- (PLCrashReportSummary *) loadPendingCrashReportSummaryAndReturnError: (NSError **) outError;
+
 - (NSData *) generateLiveReportWithThread: (thread_t) thread;
 - (NSData *) generateLiveReportWithThread: (thread_t) thread error: (NSError **) outError;
 - (NSData *) generateLiveReportWithThread: (thread_t) thread exception: (NSException *) exception error: (NSError **) outError;
@@ -127,13 +179,42 @@ typedef struct PLCrashReporterCallbacks {
 - (NSData *) generateLiveReport;
 - (NSData *) generateLiveReportAndReturnError: (NSError **) outError;
 - (NSData *) generateLiveReportWithException: (NSException *) exception error: (NSError **) outError;
+- (void) resetLiveReportBase;
+
+- (void) scheduleLiveReportWithThreadFilter: (PLCrashLiveReportThreadFilter) filter
+                          completionHandler: (PLCrashLiveReportCompletionHandler) completionHandler;
+
+- (BOOL) startStackSamplingWithThreads: (const thread_t *) threads
+                                 count: (NSUInteger) count
+                              interval: (NSTimeInterval) interval
+                                 error: (NSError **) outError;
+- (void) stopStackSampling;
+
+- (void) setKeyValueArea: (PLCrashKeyValueArea *) area;
+- (void) setBreadcrumbBuffer: (PLCrashBreadcrumbBuffer *) buffer;
 
 - (BOOL) purgePendingCrashReport;
 - (BOOL) purgePendingCrashReportAndReturnError: (NSError **) outError;
 
+- (NSData *) loadAndPurgePendingCrashReportAndReturnError: (NSError **) outError;
+- (BOOL) movePendingCrashReportToPath: (NSString *) path error: (NSError **) outError;
+
+- (BOOL) hasQueuedCrashReports;
+- (NSArray *) loadQueuedCrashReportDataAndReturnError: (NSError **) outError;
+- (BOOL) purgeQueuedCrashReports: (NSUInteger) count error: (NSError **) outError;
+- (NSData *) loadQueuedCrashReportBatch: (NSUInteger) maxCount compress: (BOOL) compress error: (NSError **) outError;
+- (BOOL) purgeQueuedCrashReportBatch: (NSData *) batch error: (NSError **) outError;
+
 - (BOOL) enableCrashReporter;
 - (BOOL) enableCrashReporterAndReturnError: (NSError **) outError;
 
 - (void) setCrashCallbacks: (PLCrashReporterCallbacks *) callbacks;
 
+- (NSUInteger) machExceptionForwardCount;
+- (NSTimeInterval) machExceptionForwardDuration;
+- (NSTimeInterval) maximumMachExceptionForwardDuration;
+
+/** Per-phase timing of enableCrashReporterAndReturnError:, or nil if the crash reporter has not been enabled. */
+@property(nonatomic, readonly) PLCrashReporterStartupMetrics *startupMetrics;
+
 @end
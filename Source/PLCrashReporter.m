@@ -35,20 +35,34 @@
 
 #import "PLCrashSignalHandler.h"
 #import "PLCrashMachExceptionServer.h"
+#import "PLCrashHelperServer.h"
 
 #import "PLCrashFeatureConfig.h"
 
 #import "PLCrashAsync.h"
 #import "PLCrashLogWriter.h"
+#import "PLCrashLiveReportSession.h"
+#import "PLCrashLiveReportScheduler.h"
 #import "PLCrashFrameWalker.h"
+#import "PLCrashFrameDWARFUnwind.h"
 
 #import "PLCrashAsyncMachExceptionInfo.h"
+#import "PLCrashAsyncReportQueue.h"
+#import "PLCrashReportBatch.h"
+#import "PLCrashProbes.h"
 
 #import "PLCrashReporterNSError.h"
 
 #import <fcntl.h>
+#import <unistd.h>
+#import <sys/stat.h>
 #import <dlfcn.h>
 #import <mach-o/dyld.h>
+#import <mach/mach_time.h>
+
+#if __has_feature(ptrauth_calls)
+#import <ptrauth.h>
+#endif
 
 #define NSDEBUG(msg, args...) {\
     NSLog(@"[PLCrashReporter] " msg, ## args); \
@@ -62,10 +76,34 @@ static NSString *PLCRASH_CACHE_DIR = @"com.plausiblelabs.crashreporter.data";
  * Crash Report file name. */
 static NSString *PLCRASH_LIVE_CRASHREPORT = @"live_report.plcrash";
 
+/** @internal
+ * Crash report summary file name. The summary is written once the crash report has been completely written. */
+static NSString *PLCRASH_LIVE_CRASHREPORT_SUMMARY = @"live_report.plcrash.summary";
+
+#if PLCRASH_FEATURE_MMAP_OUTPUT
+/** @internal
+ * Preallocated, memory-mapped crash report file name. The file is renamed to PLCRASH_LIVE_CRASHREPORT once a
+ * crash report has been completely written. */
+static NSString *PLCRASH_PREALLOCATED_CRASHREPORT = @"live_report.plcrash.prealloc";
+#endif /* PLCRASH_FEATURE_MMAP_OUTPUT */
+
 /** @internal
  * Directory containing crash reports queued for sending. */
 static NSString *PLCRASH_QUEUED_DIR = @"queued_reports";
 
+/** @internal
+ * Directory containing the bounded crash report queue. */
+static NSString *PLCRASH_REPORT_QUEUE_DIR = @"report_queue";
+
+PLCR_ASSERT_STATIC(report_queue_capacity, PLCrashReporterMaximumReportQueueCapacity <= PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY);
+
+/**
+ * @internal
+ *
+ * Directory containing persisted symbol indexes, keyed by image UUID.
+ */
+static NSString *PLCRASH_SYMBOL_INDEX_DIR = @"symbol_indexes";
+
 /** @internal
  * Maximum number of bytes that will be written to the crash report.
  * Used as a safety measure in case of implementation malfunction.
@@ -77,6 +115,33 @@ static NSString *PLCRASH_QUEUED_DIR = @"queued_reports";
  */
 #define MAX_REPORT_BYTES (256 * 1024)
 
+/**
+ * @internal
+ *
+ * Maximum number of unique stacks retained by the stack sampler.
+ */
+#define STACK_SAMPLE_CAPACITY 64
+
+/**
+ * @internal
+ *
+ * Maximum encoded size of the stack samples; each sampled PC requires at most 11 bytes.
+ */
+#define MAX_STACK_SAMPLE_BYTES (STACK_SAMPLE_CAPACITY * (PLCRASH_STACK_SAMPLER_MAX_FRAMES * 11 + 32))
+
+/**
+ * @internal
+ * Statically reserved crash report output buffer. Only the first PLCrashReporterConfig.outputBufferSize bytes
+ * will be used.
+ */
+static char crash_output_buffer[PLCrashReporterMaximumOutputBufferSize];
+
+/**
+ * @internal
+ * Statically reserved compressor state, used if PLCrashReporterConfig.shouldCompressReports is enabled.
+ */
+static plcrash_async_lz_t crash_compressor;
+
 /**
  * @internal
  * Fatal signals to be monitored.
@@ -105,10 +170,49 @@ typedef struct signal_handler_ctx {
     /** Path to the output file */
     const char *path;
 
+    /** Path to the report summary output file */
+    const char *summary_path;
+
+    /** Number of bytes of crash_output_buffer to be used when writing to the output file. */
+    size_t output_buffer_size;
+
+    /** The maximum size of the crash report, in bytes. Raw capture reports are permitted to exceed MAX_REPORT_BYTES
+     * by the size of their captured stack memory. */
+    size_t max_report_bytes;
+
+    /** Preallocated arena from which crash-time scratch memory is allocated. Only initialized if
+     * PLCrashReporterConfig.crashArenaSize is non-zero. */
+    plcrash_async_arena_t arena;
+
+    /** If true, a crash that repeats the pending report's crash is counted in the pending report's summary, rather
+     * than written as a new report. */
+    bool collapse_repeats;
+
+    /** If true, @a report_queue has been initialized, and completed crash reports will be added to the queue. */
+    bool report_queue_enabled;
+
+    /** The bounded crash report queue. Only initialized if PLCrashReporterConfig.reportQueueCapacity is non-zero. */
+    plcrash_async_report_queue_t report_queue;
+
+#if PLCRASH_FEATURE_MMAP_OUTPUT
+    /** Path to the preallocated output file, or NULL if unavailable. */
+    const char *prealloc_path;
+
+    /** If true, @a prealloc_file has been initialized and may be used to write the crash report. */
+    bool prealloc_available;
+
+    /** The preallocated, memory-mapped output file. */
+    plcrash_async_file_t prealloc_file;
+
+    /** If the output file could be opened and its storage reserved, but not mapped, the open file descriptor to
+     * which the crash report will be written. Otherwise, -1. */
+    int prealloc_fd;
+#endif /* PLCRASH_FEATURE_MMAP_OUTPUT */
+
 #if PLCRASH_FEATURE_MACH_EXCEPTIONS
-    /* Previously registered Mach exception ports, if any. Will be left uninitialized if PLCrashReporterSignalHandlerTypeMach
-     * is not enabled. */
-    plcrash_mach_exception_port_set_t port_set;
+    /* Forwarding table for the previously registered Mach exception ports, if any. Will be left uninitialized if
+     * PLCrashReporterSignalHandlerTypeMach is not enabled. */
+    plcrash_mach_exception_forward_table_t forward_table;
 #endif /* PLCRASH_FEATURE_MACH_EXCEPTIONS */
 } plcrashreporter_handler_ctx_t;
 
@@ -119,6 +223,83 @@ typedef struct signal_handler_ctx {
  */
 static plcrash_async_image_list_t shared_image_list;
 
+/**
+ * @internal
+ *
+ * Maximum number of bytes to be allocated for symbol indexes of images in shared_image_list, or 0 if background
+ * symbol indexing is disabled.
+ */
+static size_t symbol_index_memory_limit = 0;
+
+/**
+ * @internal
+ *
+ * Non-zero if a background symbol indexing pass has been scheduled, but has not yet started.
+ */
+static volatile int32_t symbol_index_pending = 0;
+
+/**
+ * @internal
+ *
+ * Serial background queue on which symbol indexes are built.
+ */
+static dispatch_queue_t symbol_index_queue = NULL;
+
+/**
+ * @internal
+ *
+ * Path of the directory in which symbol indexes are persisted across launches, or NULL if indexes are not persisted.
+ */
+static const char *symbol_index_cache_dir = NULL;
+
+#if PLCRASH_FEATURE_DEFERRED_IMAGE_REGISTRATION
+/**
+ * @internal
+ *
+ * Maximum number of dyld image registrations that may be deferred; once exhausted, images are registered
+ * from within the dyld callback.
+ */
+#define PLCRASH_DEFERRED_IMAGE_CAPACITY 4096
+
+/**
+ * @internal
+ *
+ * Non-zero if image registration is deferred to image_registration_queue. Cleared once the crash reporter
+ * has been enabled, after which images are registered from within the dyld callback.
+ */
+static volatile int32_t image_registration_deferred = 0;
+
+/**
+ * @internal
+ *
+ * Non-zero if a background image registration pass has been scheduled, but has not yet started.
+ */
+static volatile int32_t image_registration_pending = 0;
+
+/**
+ * @internal
+ *
+ * Serial background queue on which deferred images are registered.
+ */
+static dispatch_queue_t image_registration_queue = NULL;
+#endif /* PLCRASH_FEATURE_DEFERRED_IMAGE_REGISTRATION */
+
+#if PLCRASH_FEATURE_LAZY_IMAGE_PARSING
+/**
+ * @internal
+ *
+ * Non-zero if a background image parsing pass has been scheduled, but has not yet started.
+ */
+static volatile int32_t image_parsing_pending = 0;
+
+/**
+ * @internal
+ *
+ * Serial background queue on which lazily parsed images are parsed and pre-encoded.
+ */
+static dispatch_queue_t image_parsing_queue = NULL;
+#endif /* PLCRASH_FEATURE_LAZY_IMAGE_PARSING */
+
 
 /**
  * @internal
@@ -140,7 +321,9 @@ static PLCrashReporterCallbacks crashCallbacks = {
 };
 
 /**
- * Write a fatal crash report.
+ * @internal
+ *
+ * Write a fatal crash report to the output file. Called by plcrash_write_report().
  *
  * @param sigctx Fatal handler context.
  * @param crashed_thread The crashed thread.
@@ -149,19 +332,60 @@ static PLCrashReporterCallbacks crashCallbacks = {
  *
  * @return Returns PLCRASH_ESUCCESS on success, or an appropriate error value if the report could not be written.
  */
-static plcrash_error_t plcrash_write_report (plcrashreporter_handler_ctx_t *sigctx, thread_t crashed_thread, plcrash_async_thread_state_t *thread_state, plcrash_log_signal_info_t *siginfo) {
+static plcrash_error_t plcrash_write_report_file (plcrashreporter_handler_ctx_t *sigctx, thread_t crashed_thread, plcrash_async_thread_state_t *thread_state, plcrash_log_signal_info_t *siginfo) {
     plcrash_async_file_t file;
     plcrash_error_t err;
 
-    /* Open the output file */
-    int fd = open(sigctx->path, O_RDWR|O_CREAT|O_TRUNC, 0644);
-    if (fd < 0) {
+#if PLCRASH_FEATURE_MMAP_OUTPUT
+    /* Prefer the preallocated, memory-mapped output file. This may only be used once. */
+    if (sigctx->prealloc_available) {
+        sigctx->prealloc_available = false;
+
+        /* Write the crash log using the already-initialized writer */
+        err = plcrash_log_writer_write(&sigctx->writer, crashed_thread, &shared_image_list, &sigctx->prealloc_file, siginfo, thread_state);
+
+        /* Close the writer; this may also fail (but shouldn't) */
+        if (plcrash_log_writer_close(&sigctx->writer) != PLCRASH_ESUCCESS) {
+            PLCF_DEBUG("Failed to close the log writer");
+            plcrash_async_file_close(&sigctx->prealloc_file);
+            return PLCRASH_EINTERNAL;
+        }
+
+        /* Synchronize, truncate, and close the mapped file */
+        if (!plcrash_async_file_close(&sigctx->prealloc_file)) {
+            PLCF_DEBUG("Failed to close mapped output file");
+            return PLCRASH_EINTERNAL;
+        }
+
+        /* Move the completed report into place */
+        if (rename(sigctx->prealloc_path, sigctx->path) != 0) {
+            PLCF_DEBUG("Could not move the crash log into place: %s", strerror(errno));
+            return PLCRASH_EINTERNAL;
+        }
+
+        return err;
+    }
+#endif /* PLCRASH_FEATURE_MMAP_OUTPUT */
+
+    /* Open the output file, preferring the descriptor opened when the reporter was enabled */
+    int fd = -1;
+    const char *written_path = sigctx->path;
+#if PLCRASH_FEATURE_MMAP_OUTPUT
+    if (sigctx->prealloc_fd >= 0) {
+        fd = sigctx->prealloc_fd;
+        sigctx->prealloc_fd = -1;
+        written_path = sigctx->prealloc_path;
+    }
+#endif /* PLCRASH_FEATURE_MMAP_OUTPUT */
+
+    if (fd < 0 && (fd = open(sigctx->path, O_RDWR|O_CREAT|O_TRUNC, 0644)) < 0) {
         PLCF_DEBUG("Could not open the crashlog output file: %s", strerror(errno));
         return PLCRASH_EINTERNAL;
     }
     
     /* Initialize the output context */
-    plcrash_async_file_init(&file, fd, MAX_REPORT_BYTES);
+    plcrash_async_file_init(&file, fd, sigctx->max_report_bytes);
+    plcrash_async_file_set_buffer(&file, crash_output_buffer, sigctx->output_buffer_size);
     
     /* Write the crash log using the already-initialized writer */
     err = plcrash_log_writer_write(&sigctx->writer, crashed_thread, &shared_image_list, &file, siginfo, thread_state);
@@ -179,12 +403,67 @@ static plcrash_error_t plcrash_write_report (plcrashreporter_handler_ctx_t *sigc
         plcrash_async_file_close(&file);
         return PLCRASH_EINTERNAL;
     }
+
+    /* Release any storage reserved beyond the report written to the preopened file */
+    if (written_path != sigctx->path && ftruncate(fd, file.total_bytes) != 0)
+        PLCF_DEBUG("Could not truncate the crash log: %s", strerror(errno));
     
     if (!plcrash_async_file_close(&file)) {
         PLCF_DEBUG("Failed to close output file");
         return PLCRASH_EINTERNAL;
     }
 
+    /* Move a report written to the preopened file into place */
+    if (written_path != sigctx->path && rename(written_path, sigctx->path) != 0) {
+        PLCF_DEBUG("Could not move the crash log into place: %s", strerror(errno));
+        return PLCRASH_EINTERNAL;
+    }
+
+    return err;
+}
+
+/**
+ * Write a fatal crash report. Scratch allocations made while the report is written are served from
+ * the preallocated crash arena, if any.
+ *
+ * @param sigctx Fatal handler context.
+ * @param crashed_thread The crashed thread.
+ * @param thread_state The crashed thread's state.
+ * @param siginfo The signal information.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or an appropriate error value if the report could not be written.
+ */
+static plcrash_error_t plcrash_write_report (plcrashreporter_handler_ctx_t *sigctx, thread_t crashed_thread, plcrash_async_thread_state_t *thread_state, plcrash_log_signal_info_t *siginfo) {
+    /* If this crash repeats the crash recorded by the pending report, count it in the pending report's summary
+     * rather than writing a new report. The summary is only valid if its report is still pending. */
+    if (sigctx->collapse_repeats && access(sigctx->path, F_OK) == 0) {
+        plcrash_async_scratch_begin();
+        plcrash_error_t err = plcrash_log_writer_collapse_repeat(&sigctx->writer, crashed_thread, &shared_image_list, sigctx->summary_path, siginfo, thread_state);
+        plcrash_async_scratch_end();
+
+        if (err == PLCRASH_ESUCCESS)
+            return PLCRASH_ESUCCESS;
+    }
+
+    /* Remove any stale summary; a summary is only written once its report is complete */
+    unlink(sigctx->summary_path);
+
+    plcrash_async_scratch_begin();
+    plcrash_error_t err = plcrash_write_report_file(sigctx, crashed_thread, thread_state, siginfo);
+    plcrash_async_scratch_end();
+
+    /* Write the summary. Failure is non-fatal; readers fall back on decoding the report. */
+    if (err == PLCRASH_ESUCCESS) {
+        struct stat sb;
+        if (stat(sigctx->path, &sb) == 0) {
+            plcrash_log_writer_write_summary(&sigctx->writer, sigctx->summary_path, (uint64_t) sb.st_size);
+
+            /* Add the report to the queue. Failure is non-fatal; the report remains pending. */
+            if (sigctx->report_queue_enabled)
+                plcrash_async_report_queue_enqueue(&sigctx->report_queue, sigctx->path, sigctx->summary_path, (uint64_t) sb.st_size);
+        }
+    }
+
     return err;
 }
 
@@ -233,6 +512,9 @@ static bool signal_handler_callback (int signal, siginfo_t *info, pl_ucontext_t
     signal_info.bsd_info = &bsd_signal_info;
     signal_info.mach_info = NULL;
 
+    /* Probes are only emitted for live reports; a crash occurring while a live report is written must not emit them */
+    plcrash_async_probes_disable();
+
     /* Write the report */
     if (plcrash_write_report(sigctx, pl_mach_thread_self(), &thread_state, &signal_info) != PLCRASH_ESUCCESS)
         return false;
@@ -265,7 +547,7 @@ static kern_return_t mach_exception_callback (task_t task, thread_t thread, exce
     plcrash_error_t err;
 
     /* Let any other registered server attempt to handle the exception */
-    if (PLCrashMachExceptionForward(task, thread, exception_type, code, code_count, &sigctx->port_set) == KERN_SUCCESS)
+    if (plcrash_mach_exception_forward_table_forward(&sigctx->forward_table, task, thread, exception_type, code, code_count) == KERN_SUCCESS)
         return KERN_SUCCESS;
     
     /* Set up the BSD signal info */
@@ -286,6 +568,10 @@ static kern_return_t mach_exception_callback (task_t task, thread_t thread, exce
     mach_signal_info.code = code;
     mach_signal_info.code_count = code_count;
     signal_info.mach_info = &mach_signal_info;
+
+    /* Probes are only emitted for live reports. This is deferred until the exception was not handled by any other
+     * server, as a forwarded exception may be recovered from. */
+    plcrash_async_probes_disable();
     
     /* Write the report */
     struct mach_exception_callback_live_cb_ctx live_ctx = {
@@ -323,21 +609,175 @@ static kern_return_t mach_exception_callback (task_t task, thread_t thread, exce
 }
 #endif /* PLCRASH_FEATURE_MACH_EXCEPTIONS */
 
+/**
+ * @internal
+ *
+ * mach_absolute_time() units spent registering for dyld image notifications in +initialize.
+ */
+static uint64_t image_monitoring_time = 0;
+
+/**
+ * @internal
+ * Convert the interval between two mach_absolute_time() values to seconds.
+ */
+static NSTimeInterval plcr_absolute_interval (uint64_t start, uint64_t end) {
+    mach_timebase_info_data_t timebase;
+    if (mach_timebase_info(&timebase) != KERN_SUCCESS || timebase.denom == 0)
+        return 0;
+
+    return (NSTimeInterval) (end - start) * timebase.numer / timebase.denom / NSEC_PER_SEC;
+}
+
+/**
+ * @internal
+ * Sum the memory held by the decoded function starts and DWARF FDE tables of shared_image_list's images. Each
+ * category's builder accounts for its own existing tables; the other categories' tables must be excluded from
+ * the budget it is given.
+ */
+static void symbol_index_table_sizes (size_t *function_starts, size_t *fde_indexes) {
+    plcrash_async_image_t *image = NULL;
+
+    *function_starts = 0;
+    *fde_indexes = 0;
+
+    plcrash_async_image_list_set_reading(&shared_image_list, true);
+    while ((image = plcrash_async_image_list_next(&shared_image_list, image)) != NULL) {
+        if (image->state != PLCRASH_ASYNC_IMAGE_PARSED)
+            continue;
+
+        *function_starts += plcrash_async_macho_function_starts_size(&image->macho_image);
+#if PLCRASH_FEATURE_UNWIND_DWARF
+        *fde_indexes += plframe_async_dwarf_fde_index_size(&image->macho_image);
+#endif
+    }
+    plcrash_async_image_list_set_reading(&shared_image_list, false);
+}
+
+/**
+ * @internal
+ * Schedule a background pass over shared_image_list to build symbol indexes for any images that lack one. Requests
+ * issued while a pass is pending are coalesced. Indexes are published atomically, and may be built while the
+ * image list is in use by the crash handler.
+ */
+static void schedule_symbol_indexing (void) {
+    if (symbol_index_queue == NULL || symbol_index_memory_limit == 0)
+        return;
+
+    if (!OSAtomicCompareAndSwap32Barrier(0, 1, &symbol_index_pending))
+        return;
+
+    dispatch_async(symbol_index_queue, ^{
+        /* Clear the pending flag before indexing, so that images added during this pass trigger a new pass */
+        OSAtomicCompareAndSwap32Barrier(1, 0, &symbol_index_pending);
+        /* Symbol indexes, decoded function starts, and DWARF FDE look-up tables share a single budget, in that order
+         * of priority. Tables built by earlier passes remain allocated, and are excluded from each later budget. */
+        const size_t limit = symbol_index_memory_limit;
+        size_t function_starts_used;
+        size_t fde_used;
+        symbol_index_table_sizes(&function_starts_used, &fde_used);
+
+        size_t symbols_used = 0;
+        if (function_starts_used + fde_used < limit)
+            symbols_used = plcrash_nasync_image_list_build_symbol_indexes(&shared_image_list, limit - function_starts_used - fde_used, symbol_index_cache_dir);
+
+        if (symbols_used + fde_used < limit)
+            function_starts_used = plcrash_nasync_image_list_build_function_starts(&shared_image_list, limit - symbols_used - fde_used);
+
+#if PLCRASH_FEATURE_UNWIND_DWARF
+        if (symbols_used + function_starts_used < limit)
+            plframe_nasync_dwarf_build_fde_indexes(&shared_image_list, limit - symbols_used - function_starts_used);
+#endif
+    });
+}
+
+#if PLCRASH_FEATURE_LAZY_IMAGE_PARSING
+/**
+ * @internal
+ * Schedule a background pass over shared_image_list to parse and pre-encode any images that have not yet been
+ * parsed, followed by a symbol indexing pass. Requests issued while a pass is pending are coalesced.
+ */
+static void schedule_image_parsing (void) {
+    if (!OSAtomicCompareAndSwap32Barrier(0, 1, &image_parsing_pending))
+        return;
+
+    dispatch_async(image_parsing_queue, ^{
+        /* Clear the pending flag before parsing, so that images added during this pass trigger a new pass */
+        OSAtomicCompareAndSwap32Barrier(1, 0, &image_parsing_pending);
+        plcrash_nasync_image_list_parse_images(&shared_image_list);
+        schedule_symbol_indexing();
+    });
+}
+#endif /* PLCRASH_FEATURE_LAZY_IMAGE_PARSING */
+
+/**
+ * @internal
+ * Schedule background processing of newly registered images.
+ */
+static void schedule_image_processing (void) {
+#if PLCRASH_FEATURE_LAZY_IMAGE_PARSING
+    schedule_image_parsing();
+#else
+    schedule_symbol_indexing();
+#endif
+}
+
+#if PLCRASH_FEATURE_DEFERRED_IMAGE_REGISTRATION
+/**
+ * @internal
+ * Schedule a background pass over shared_image_list to register any deferred images. Requests issued while a
+ * pass is pending are coalesced.
+ */
+static void schedule_image_registration (void) {
+    if (!OSAtomicCompareAndSwap32Barrier(0, 1, &image_registration_pending))
+        return;
+
+    dispatch_async(image_registration_queue, ^{
+        /* Clear the pending flag before registering, so that images added during this pass trigger a new pass */
+        OSAtomicCompareAndSwap32Barrier(1, 0, &image_registration_pending);
+        plcrash_nasync_image_list_flush_deferred(&shared_image_list);
+
+        /* Process the newly registered images */
+        schedule_image_processing();
+    });
+}
+#endif /* PLCRASH_FEATURE_DEFERRED_IMAGE_REGISTRATION */
+
+/**
+ * @internal
+ * Register all deferred images with shared_image_list, blocking until registration has completed. This must
+ * be called prior to writing any report.
+ */
+static void flush_image_registration (void) {
+#if PLCRASH_FEATURE_DEFERRED_IMAGE_REGISTRATION
+    plcrash_nasync_image_list_flush_deferred(&shared_image_list);
+#endif
+}
+
 /**
  * @internal
  * dyld image add notification callback.
  */
 static void image_add_callback (const struct mach_header *mh, intptr_t vmaddr_slide) {
-    Dl_info info;
-    
-    /* Look up the image info */
-    if (dladdr(mh, &info) == 0) {
-        NSLog(@"%s: dladdr(%p, ...) failed", __FUNCTION__, mh);
+#if PLCRASH_FEATURE_DEFERRED_IMAGE_REGISTRATION
+    /* Record the image for registration in the background */
+    if (image_registration_deferred && plcrash_nasync_image_list_defer_append(&shared_image_list, (pl_vm_address_t) mh)) {
+        /* If the crash reporter was enabled concurrently, the enabling thread's flush may have missed this image */
+        OSMemoryBarrier();
+        if (image_registration_deferred) {
+            schedule_image_registration();
+        } else {
+            flush_image_registration();
+            schedule_image_processing();
+        }
         return;
     }
+#endif
+
+    /* Register the image, copying its path from dyld's image info */
+    plcrash_nasync_image_list_append_local(&shared_image_list, (pl_vm_address_t) mh);
 
-    /* Register the image */
-    plcrash_nasync_image_list_append(&shared_image_list, (pl_vm_address_t) mh, info.dli_fname);
+    /* Parse and index it in the background */
+    schedule_image_processing();
 }
 
 /**
@@ -373,6 +813,82 @@ static void uncaught_exception_handler (NSException *exception) {
     abort();
 }
 
+#if PLCRASH_FEATURE_MMAP_OUTPUT
+/**
+ * @internal
+ *
+ * Process exit handler. Removes the unused preallocated crash report output file, releasing its reserved storage.
+ */
+static void remove_preallocated_report (void) {
+    if (signal_handler_context.prealloc_available || signal_handler_context.prealloc_fd >= 0)
+        unlink(signal_handler_context.prealloc_path);
+}
+#endif /* PLCRASH_FEATURE_MMAP_OUTPUT */
+
+/**
+ * @internal
+ *
+ * The maximum span, in bytes, of crash path code that will be faulted in by prewarm_crash_path(). If the crash path
+ * entry points span a larger range (eg, within a large statically linked binary), only the pages containing the entry
+ * points are faulted in.
+ */
+#define PLCRASH_PREWARM_TEXT_SPAN_MAX (4 * 1024 * 1024)
+
+/* Return the code address of the function @a fn */
+#if __has_feature(ptrauth_calls)
+#define PLCRASH_CODE_ADDRESS(fn) ((uintptr_t) ptrauth_strip((void *) &(fn), ptrauth_key_function_pointer))
+#else
+#define PLCRASH_CODE_ADDRESS(fn) ((uintptr_t) &(fn))
+#endif
+
+/**
+ * @internal
+ *
+ * Memory pressure event source used to re-warm the crash path, or NULL if not configured.
+ */
+static dispatch_source_t prewarm_pressure_source = NULL;
+
+/**
+ * @internal
+ *
+ * Fault in the alternate signal stack, the crash-time scratch arena, the preallocated output file, and the
+ * crash path code, such that the crash path does not page fault on first use.
+ *
+ * @param lock If true, the signal stack and arena are additionally wired via mlock().
+ */
+static void prewarm_crash_path (bool lock) {
+    /* Crash-time memory */
+    [[PLCrashSignalHandler sharedHandler] prefaultSignalStack: lock];
+    plcrash_nasync_prefault(signal_handler_context.arena.base, signal_handler_context.arena.size, lock);
+#if PLCRASH_FEATURE_MMAP_OUTPUT
+    if (signal_handler_context.prealloc_available)
+        plcrash_nasync_prefault(signal_handler_context.prealloc_file.mem_buffer, signal_handler_context.prealloc_file.mem_capacity, false);
+#endif
+
+    /* Crash path code; the report writer and its callees are expected to be linked contiguously */
+    const uintptr_t entry_points[] = {
+        PLCRASH_CODE_ADDRESS(signal_handler_callback),
+        PLCRASH_CODE_ADDRESS(plcrash_log_writer_write),
+        PLCRASH_CODE_ADDRESS(plframe_cursor_next),
+        PLCRASH_CODE_ADDRESS(plcrash_async_file_write),
+    };
+    const size_t entry_count = sizeof(entry_points) / sizeof(entry_points[0]);
+
+    uintptr_t text_start = entry_points[0];
+    uintptr_t text_end = entry_points[0];
+    for (size_t i = 1; i < entry_count; i++) {
+        text_start = MIN(text_start, entry_points[i]);
+        text_end = MAX(text_end, entry_points[i]);
+    }
+
+    if (text_end - text_start <= PLCRASH_PREWARM_TEXT_SPAN_MAX) {
+        plcrash_nasync_prefault((const void *) text_start, text_end - text_start + 1, false);
+    } else {
+        for (size_t i = 0; i < entry_count; i++)
+            plcrash_nasync_prefault((const void *) entry_points[i], 1, false);
+    }
+}
+
 
 @interface PLCrashReporter (PrivateMethods)
 
@@ -384,13 +900,25 @@ static void uncaught_exception_handler (NSException *exception) {
                                                                      callback: (PLCrashMachExceptionHandlerCallback) callback
                                                                       context: (void *) context
                                                                         error: (NSError **) outError;
+- (exception_mask_t) machExceptionMask;
+#endif
+#if PLCRASH_FEATURE_OUT_OF_PROCESS_HELPER
+- (BOOL) registerWithHelperWithPreviousPortSet: (PLCrashMachExceptionPortSet **) previousPortSet error: (NSError **) outError;
 #endif
 - (plcrash_async_symbol_strategy_t) mapToAsyncSymbolicationStrategy: (PLCrashReporterSymbolicationStrategy) strategy;
+- (uint32_t) mapToWriterThreadMetadata: (PLCrashReporterThreadMetadata) metadata;
+- (uint32_t) mapToWriterSymbolicatedThreads: (PLCrashReporterSymbolicatedThreads) threads;
 
 - (BOOL) populateCrashReportDirectoryAndReturnError: (NSError **) outError;
 - (NSString *) crashReportDirectory;
 - (NSString *) queuedCrashReportDirectory;
 - (NSString *) crashReportPath;
+- (NSString *) crashReportSummaryPath;
+- (NSString *) reportQueueDirectory;
+- (plcrash_error_t) openReportQueue: (plcrash_async_report_queue_t *) queue;
+- (void) recoverPreallocatedCrashReport;
+- (PLCrashLiveReportSession *) liveReportSession;
+- (void) updateCustomData;
 
 @end
 
@@ -402,14 +930,42 @@ static void uncaught_exception_handler (NSException *exception) {
  */
 @implementation PLCrashReporter
 
+@synthesize startupMetrics = _startupMetrics;
+
 + (void) initialize {
     if (![[self class] isEqual: [PLCrashReporter class]])
         return;
 
     /* Enable dyld image monitoring */
     plcrash_nasync_image_list_init(&shared_image_list, mach_task_self());
+    plcrash_nasync_image_list_set_encoder(&shared_image_list, plcrash_log_writer_nasync_encode_binary_image);
+
+    /* Identify shared cache images, including on releases that predate their flagging by dyld */
+    plcrash_async_shared_cache_t shared_cache;
+    if (plcrash_async_shared_cache_init(&shared_cache, mach_task_self()) == PLCRASH_ESUCCESS)
+        plcrash_nasync_image_list_set_shared_cache(&shared_image_list, &shared_cache);
+
+#if PLCRASH_FEATURE_LAZY_IMAGE_PARSING
+    /* Register images without parsing them; parsing occurs on first use, or on a low-priority background queue */
+    image_parsing_queue = dispatch_queue_create("com.plausiblelabs.crashreporter.image-parsing", DISPATCH_QUEUE_SERIAL);
+    dispatch_set_target_queue(image_parsing_queue, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0));
+    plcrash_nasync_image_list_set_lazy_parsing(&shared_image_list, true);
+#endif
+
+#if PLCRASH_FEATURE_DEFERRED_IMAGE_REGISTRATION
+    /* Defer parsing of the images registered at launch to a background queue */
+    image_registration_queue = dispatch_queue_create("com.plausiblelabs.crashreporter.image-registration", DISPATCH_QUEUE_SERIAL);
+    dispatch_set_target_queue(image_registration_queue, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0));
+    plcrash_nasync_image_list_set_deferred(&shared_image_list, PLCRASH_DEFERRED_IMAGE_CAPACITY);
+    image_registration_deferred = 1;
+    OSMemoryBarrier();
+#endif
+
+    /* Registration synchronously delivers notifications for all loaded images */
+    uint64_t start = mach_absolute_time();
     _dyld_register_func_for_add_image(image_add_callback);
     _dyld_register_func_for_remove_image(image_remove_callback);
+    image_monitoring_time = mach_absolute_time() - start;
 }
 
 
@@ -492,7 +1048,29 @@ static PLCrashReporter *sharedReporter = nil;
  */
 - (NSData *) loadPendingCrashReportDataAndReturnError: (NSError **) outError {
     /* Load the (memory mapped) data */
-    return [NSData dataWithContentsOfFile: [self crashReportPath] options: NSMappedRead error: outError];
+    return [NSData dataWithContentsOfFile: [self crashReportPath] options: NSDataReadingMappedIfSafe error: outError];
+}
+
+
+/**
+ * If an application has a pending crash report, this method returns a summary of the report, read from a small
+ * fixed-layout file written alongside the report. The summary may be used to decide whether to load, submit, or
+ * purge a report without decoding it.
+ *
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer
+ * will contain an error object indicating why the summary could not be loaded. If no error occurs, this
+ * parameter will be left unmodified. You may specify nil for this parameter, and no error information will be
+ * provided.
+ *
+ * @return Returns nil if no summary is available, in which case the pending report (if any) must be decoded
+ * directly. Reports written by earlier releases, or interrupted before the summary was written, have no summary.
+ */
+- (PLCrashReportSummary *) loadPendingCrashReportSummaryAndReturnError: (NSError **) outError {
+    NSData *data = [NSData dataWithContentsOfFile: [self crashReportSummaryPath] options: 0 error: outError];
+    if (data == nil)
+        return nil;
+
+    return [[[PLCrashReportSummary alloc] initWithData: data error: outError] autorelease];
 }
 
 
@@ -512,7 +1090,365 @@ static PLCrashReporter *sharedReporter = nil;
  * @return Returns YES on success, or NO on error.
  */
 - (BOOL) purgePendingCrashReportAndReturnError: (NSError **) outError {
-    return [[NSFileManager defaultManager] removeItemAtPath: [self crashReportPath] error: outError];
+    NSFileManager *fm = [NSFileManager defaultManager];
+
+    /* The summary is advisory; remove it first, so that it never outlives its report */
+    NSString *summaryPath = [self crashReportSummaryPath];
+    if ([fm fileExistsAtPath: summaryPath] && ![fm removeItemAtPath: summaryPath error: outError])
+        return NO;
+
+    return [fm removeItemAtPath: [self crashReportPath] error: outError];
+}
+
+
+/**
+ * Load and purge a pending crash report as a single operation.
+ *
+ * The report is first claimed by renaming it out of the pending report path, after which it is no longer visible to
+ * hasPendingCrashReport, and will not be returned by a subsequent or concurrent load. The claimed report is then
+ * memory mapped and removed; the mapping remains valid for the lifetime of the returned data. This avoids copying the
+ * report into memory, and avoids the window between loadPendingCrashReportDataAndReturnError: and
+ * purgePendingCrashReportAndReturnError: in which a report may be processed twice.
+ *
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer
+ * will contain an error object indicating why the pending crash report could not be loaded. If no error occurs, this
+ * parameter will be left unmodified. You may specify nil for this parameter, and no error information will be provided.
+ *
+ * @return Returns nil if the crash report data could not be loaded, in which case the pending report (if any) is
+ * left in place.
+ */
+- (NSData *) loadAndPurgePendingCrashReportAndReturnError: (NSError **) outError {
+    NSString *claimedPath = [[self queuedCrashReportDirectory] stringByAppendingPathComponent: [[NSProcessInfo processInfo] globallyUniqueString]];
+    if (rename([[self crashReportPath] fileSystemRepresentation], [claimedPath fileSystemRepresentation]) != 0) {
+        plcrash_populate_posix_error(outError, errno, @"Failed to claim the pending crash report");
+        return nil;
+    }
+
+    NSData *data = [NSData dataWithContentsOfFile: claimedPath options: NSDataReadingMappedIfSafe error: outError];
+    if (data == nil) {
+        /* Restore the report, so that it may be retried */
+        rename([claimedPath fileSystemRepresentation], [[self crashReportPath] fileSystemRepresentation]);
+        return nil;
+    }
+
+    /* The mapping (if any) remains valid once the file is unlinked */
+    unlink([claimedPath fileSystemRepresentation]);
+
+    NSString *summaryPath = [self crashReportSummaryPath];
+    if ([[NSFileManager defaultManager] fileExistsAtPath: summaryPath])
+        [[NSFileManager defaultManager] removeItemAtPath: summaryPath error: NULL];
+
+    return data;
+}
+
+
+/**
+ * Atomically move a pending crash report to @a path, replacing any existing file at @a path. This may be used to
+ * hand off the report to an external upload queue without copying it; once moved, the report is no longer pending.
+ *
+ * @param path The destination path. This must reside on the same volume as the crash reporter's data directory.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer
+ * will contain an error object indicating why the pending crash report could not be moved. If no error occurs, this
+ * parameter will be left unmodified. You may specify nil for this parameter, and no error information will be provided.
+ *
+ * @return Returns YES on success, or NO on error.
+ */
+- (BOOL) movePendingCrashReportToPath: (NSString *) path error: (NSError **) outError {
+    if (rename([[self crashReportPath] fileSystemRepresentation], [path fileSystemRepresentation]) != 0) {
+        plcrash_populate_posix_error(outError, errno, @"Failed to move the pending crash report");
+        return NO;
+    }
+
+    /* The summary is advisory; a failure to remove it is harmless once the report is gone */
+    NSString *summaryPath = [self crashReportSummaryPath];
+    if ([[NSFileManager defaultManager] fileExistsAtPath: summaryPath])
+        [[NSFileManager defaultManager] removeItemAtPath: summaryPath error: NULL];
+
+    return YES;
+}
+
+
+/**
+ * Returns the number of Mach exceptions that have been forwarded to the previously registered exception handlers.
+ * Forwarding occurs only when using PLCrashReporterSignalHandlerTypeMach, and typically indicates the presence of a
+ * debugger, another crash reporter, or a managed runtime that handles exceptions.
+ *
+ * @note The forwarding counters are updated without synchronization by the exception server thread, and are
+ * intended for diagnostic use only.
+ */
+- (NSUInteger) machExceptionForwardCount {
+#if PLCRASH_FEATURE_MACH_EXCEPTIONS
+    return (NSUInteger) signal_handler_context.forward_table.stats.forwards;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Returns the total time spent forwarding Mach exceptions to the previously registered exception handlers, in seconds,
+ * including the time taken by those handlers to reply.
+ *
+ * @sa machExceptionForwardCount
+ */
+- (NSTimeInterval) machExceptionForwardDuration {
+#if PLCRASH_FEATURE_MACH_EXCEPTIONS
+    return plcr_absolute_interval(0, signal_handler_context.forward_table.stats.elapsed);
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Returns the longest time spent forwarding a single Mach exception to the previously registered exception handlers,
+ * in seconds.
+ *
+ * @sa machExceptionForwardCount
+ */
+- (NSTimeInterval) maximumMachExceptionForwardDuration {
+#if PLCRASH_FEATURE_MACH_EXCEPTIONS
+    return plcr_absolute_interval(0, signal_handler_context.forward_table.stats.max_elapsed);
+#else
+    return 0;
+#endif
+}
+
+
+/**
+ * Returns YES if the bounded report queue contains one or more crash reports.
+ *
+ * @sa PLCrashReporterConfig::reportQueueCapacity
+ */
+- (BOOL) hasQueuedCrashReports {
+    plcrash_async_report_queue_t queue;
+    plcrash_async_report_queue_entry_t entry;
+    uint32_t count = 1;
+
+    if ([self openReportQueue: &queue] != PLCRASH_ESUCCESS)
+        return NO;
+
+    plcrash_error_t err = plcrash_nasync_report_queue_entries(&queue, &entry, &count);
+    plcrash_nasync_report_queue_free(&queue);
+
+    return err == PLCRASH_ESUCCESS && count > 0;
+}
+
+
+/**
+ * Load all crash reports in the bounded report queue, ordered from oldest to most recent. Queued reports are retained
+ * until they are removed with purgeQueuedCrashReports:error:, allowing an upload worker to submit a batch of reports
+ * before purging them.
+ *
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer
+ * will contain an error object indicating why the queued crash reports could not be loaded. If no error occurs, this
+ * parameter will be left unmodified. You may specify nil for this parameter, and no error information will be provided.
+ *
+ * @return Returns an array of NSData instances, which will be empty if no reports are queued, or nil if the queued
+ * reports could not be loaded.
+ *
+ * @sa PLCrashReporterConfig::reportQueueCapacity
+ */
+- (NSArray *) loadQueuedCrashReportDataAndReturnError: (NSError **) outError {
+    plcrash_async_report_queue_t queue;
+    plcrash_async_report_queue_entry_t entries[PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY];
+    uint32_t count = PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY;
+    plcrash_error_t err;
+
+    if ((err = [self openReportQueue: &queue]) == PLCRASH_ENOTFOUND)
+        return [NSArray array];
+
+    if (err != PLCRASH_ESUCCESS) {
+        plcrash_populate_error(outError, PLCrashReporterErrorOperatingSystem, @"Failed to open the report queue", nil);
+        return nil;
+    }
+
+    if (plcrash_nasync_report_queue_entries(&queue, entries, &count) != PLCRASH_ESUCCESS) {
+        plcrash_nasync_report_queue_free(&queue);
+        plcrash_populate_error(outError, PLCrashReporterErrorOperatingSystem, @"Failed to read the report queue index", nil);
+        return nil;
+    }
+
+    NSMutableArray *reports = [NSMutableArray arrayWithCapacity: count];
+    for (uint32_t i = 0; i < count; i++) {
+        NSString *path = [NSString stringWithUTF8String: plcrash_async_report_queue_path(&queue, entries[i].sequence)];
+
+        /* A report may be missing if the process was terminated while it was being queued */
+        if (![[NSFileManager defaultManager] fileExistsAtPath: path])
+            continue;
+
+        NSData *data = [NSData dataWithContentsOfFile: path options: NSDataReadingMappedIfSafe error: outError];
+        if (data == nil) {
+            plcrash_nasync_report_queue_free(&queue);
+            return nil;
+        }
+
+        [reports addObject: data];
+    }
+
+    plcrash_nasync_report_queue_free(&queue);
+    return reports;
+}
+
+
+/**
+ * Remove the @a count oldest crash reports from the bounded report queue. Reports are removed in the order returned by
+ * loadQueuedCrashReportDataAndReturnError:; a batch of loaded reports may be removed once submitted by passing the
+ * number of reports in the batch.
+ *
+ * @param count The number of reports to remove. If greater than the number of queued reports, all queued reports
+ * will be removed.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer
+ * will contain an error object indicating why the queued crash reports could not be removed. If no error occurs, this
+ * parameter will be left unmodified. You may specify nil for this parameter, and no error information will be provided.
+ *
+ * @return Returns YES on success, or NO on error.
+ *
+ * @sa PLCrashReporterConfig::reportQueueCapacity
+ */
+- (BOOL) purgeQueuedCrashReports: (NSUInteger) count error: (NSError **) outError {
+    plcrash_async_report_queue_t queue;
+    plcrash_async_report_queue_entry_t entries[PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY];
+    uint32_t found = PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY;
+    plcrash_error_t err;
+
+    if (count == 0 || (err = [self openReportQueue: &queue]) == PLCRASH_ENOTFOUND)
+        return YES;
+
+    if (err != PLCRASH_ESUCCESS) {
+        plcrash_populate_error(outError, PLCrashReporterErrorOperatingSystem, @"Failed to open the report queue", nil);
+        return NO;
+    }
+
+    /* Purge through the sequence number of the last report in the batch */
+    if ((err = plcrash_nasync_report_queue_entries(&queue, entries, &found)) == PLCRASH_ESUCCESS && found > 0)
+        err = plcrash_nasync_report_queue_purge(&queue, entries[MIN(count, (NSUInteger) found) - 1].sequence);
+
+    plcrash_nasync_report_queue_free(&queue);
+
+    if (err != PLCRASH_ESUCCESS) {
+        plcrash_populate_error(outError, PLCrashReporterErrorOperatingSystem, @"Failed to remove the queued crash reports", nil);
+        return NO;
+    }
+
+    return YES;
+}
+
+
+/**
+ * Pack up to @a maxCount of the oldest crash reports in the bounded report queue, and their summaries, into a single
+ * batch container, allowing the batch to be submitted in one request. The container may be decoded with
+ * PLCrashReport::reportsWithBatchData:options:error:.
+ *
+ * Queued reports are retained until the batch is acknowledged with purgeQueuedCrashReportBatch:error:.
+ *
+ * @param maxCount The maximum number of reports to include, or 0 to include all queued reports.
+ * @param compress If YES, the container will be LZ-compressed as a whole.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer
+ * will contain an error object indicating why the batch could not be created. If no error occurs, this
+ * parameter will be left unmodified. You may specify nil for this parameter, and no error information will be provided.
+ *
+ * @return Returns the batch container, which will contain no reports if none are queued, or nil on error.
+ *
+ * @sa PLCrashReporterConfig::reportQueueCapacity
+ */
+- (NSData *) loadQueuedCrashReportBatch: (NSUInteger) maxCount compress: (BOOL) compress error: (NSError **) outError {
+    plcrash_async_report_queue_t queue;
+    plcrash_async_report_queue_entry_t entries[PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY];
+    uint32_t count = PLCRASH_ASYNC_REPORT_QUEUE_MAX_CAPACITY;
+    plcrash_error_t err;
+
+    NSMutableArray *reports = [NSMutableArray array];
+    NSMutableArray *summaries = [NSMutableArray array];
+    uint64_t firstSequence = 0;
+    uint64_t lastSequence = 0;
+
+    if ((err = [self openReportQueue: &queue]) == PLCRASH_ENOTFOUND)
+        return [PLCrashReportBatch encodeReports: reports summaries: summaries firstSequence: 0 lastSequence: 0 compress: compress];
+
+    if (err != PLCRASH_ESUCCESS) {
+        plcrash_populate_error(outError, PLCrashReporterErrorOperatingSystem, @"Failed to open the report queue", nil);
+        return nil;
+    }
+
+    if (plcrash_nasync_report_queue_entries(&queue, entries, &count) != PLCRASH_ESUCCESS) {
+        plcrash_nasync_report_queue_free(&queue);
+        plcrash_populate_error(outError, PLCrashReporterErrorOperatingSystem, @"Failed to read the report queue index", nil);
+        return nil;
+    }
+
+    if (maxCount > 0 && maxCount < count)
+        count = (uint32_t) maxCount;
+
+    for (uint32_t i = 0; i < count; i++) {
+        NSString *path = [NSString stringWithUTF8String: plcrash_async_report_queue_path(&queue, entries[i].sequence)];
+
+        /* A report may be missing if the process was terminated while it was being queued. It is still covered by
+         * the batch's sequence range, and will be purged along with the batch. */
+        if (i == 0)
+            firstSequence = entries[i].sequence;
+        lastSequence = entries[i].sequence;
+
+        if (![[NSFileManager defaultManager] fileExistsAtPath: path])
+            continue;
+
+        NSData *data = [NSData dataWithContentsOfFile: path options: NSDataReadingMappedIfSafe error: outError];
+        if (data == nil) {
+            plcrash_nasync_report_queue_free(&queue);
+            return nil;
+        }
+
+        /* Summaries are optional */
+        NSString *summaryPath = [NSString stringWithUTF8String: plcrash_async_report_queue_summary_path(&queue, entries[i].sequence)];
+        NSData *summary = [NSData dataWithContentsOfFile: summaryPath];
+
+        [reports addObject: data];
+        [summaries addObject: summary != nil ? (id) summary : (id) [NSNull null]];
+    }
+
+    plcrash_nasync_report_queue_free(&queue);
+
+    NSData *batch = [PLCrashReportBatch encodeReports: reports summaries: summaries firstSequence: firstSequence lastSequence: lastSequence compress: compress];
+    if (batch == nil)
+        plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Failed to allocate the report batch", nil);
+
+    return batch;
+}
+
+/**
+ * Acknowledge a batch created by loadQueuedCrashReportBatch:compress:error:, removing all of the batch's reports
+ * from the bounded report queue in a single pass. Reports queued after the batch was created are retained.
+ *
+ * @param batch The batch container to be acknowledged.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer
+ * will contain an error object indicating why the queued crash reports could not be removed. If no error occurs, this
+ * parameter will be left unmodified. You may specify nil for this parameter, and no error information will be provided.
+ *
+ * @return Returns YES on success, or NO on error.
+ */
+- (BOOL) purgeQueuedCrashReportBatch: (NSData *) batch error: (NSError **) outError {
+    plcrash_async_report_queue_t queue;
+    plcrash_error_t err;
+
+    PLCrashReportBatch *decoded = [[[PLCrashReportBatch alloc] initWithData: batch error: outError] autorelease];
+    if (decoded == nil)
+        return NO;
+
+    if (decoded.lastSequence == 0 || (err = [self openReportQueue: &queue]) == PLCRASH_ENOTFOUND)
+        return YES;
+
+    if (err != PLCRASH_ESUCCESS) {
+        plcrash_populate_error(outError, PLCrashReporterErrorOperatingSystem, @"Failed to open the report queue", nil);
+        return NO;
+    }
+
+    err = plcrash_nasync_report_queue_purge(&queue, decoded.lastSequence);
+    plcrash_nasync_report_queue_free(&queue);
+
+    if (err != PLCRASH_ESUCCESS) {
+        plcrash_populate_error(outError, PLCrashReporterErrorOperatingSystem, @"Failed to remove the queued crash reports", nil);
+        return NO;
+    }
+
+    return YES;
 }
 
 
@@ -578,16 +1514,185 @@ static PLCrashReporter *sharedReporter = nil;
     if (_enabled)
         [NSException raise: PLCrashReporterException format: @"The crash reporter has alread been enabled"];
 
+    uint64_t startTime = mach_absolute_time();
+
     /* Create the directory tree */
     if (![self populateCrashReportDirectoryAndReturnError: outError])
         return NO;
 
+    uint64_t directoryTime = mach_absolute_time();
+
+    /* Images must be registered before a crash report may be written; once enabled, images are registered
+     * synchronously from the dyld callback. */
+#if PLCRASH_FEATURE_DEFERRED_IMAGE_REGISTRATION
+    OSAtomicCompareAndSwap32Barrier(1, 0, &image_registration_deferred);
+#endif
+    flush_image_registration();
+
+    uint64_t registrationTime = mach_absolute_time();
+
     /* Set up the signal handler context */
     signal_handler_context.path = strdup([[self crashReportPath] UTF8String]); // NOTE: would leak if this were not a singleton struct
+    signal_handler_context.summary_path = strdup([[self crashReportSummaryPath] UTF8String]); // NOTE: would leak if this were not a singleton struct
+    signal_handler_context.output_buffer_size = MIN(_config.outputBufferSize, sizeof(crash_output_buffer));
     assert(_applicationIdentifier != nil);
     assert(_applicationVersion != nil);
     plcrash_log_writer_init(&signal_handler_context.writer, _applicationIdentifier, _applicationVersion, _applicationMarketingVersion, [self mapToAsyncSymbolicationStrategy: _config.symbolicationStrategy], false);
-    
+    if (_config.shouldCompressReports)
+        plcrash_log_writer_set_compressor(&signal_handler_context.writer, &crash_compressor);
+    if (_config.shouldUseSymbolNameTable || _config.shouldUsePackedThreadEncoding)
+        plcrash_log_writer_enable_symbol_names(&signal_handler_context.writer);
+    if (_config.shouldUsePackedThreadEncoding)
+        plcrash_log_writer_set_packed_threads(&signal_handler_context.writer, true);
+    if (_config.shouldWriteRegistersForAllThreads)
+        plcrash_log_writer_set_all_thread_registers(&signal_handler_context.writer, true);
+    if (_config.threadMetadata != PLCrashReporterThreadMetadataNone)
+        plcrash_log_writer_set_thread_metadata(&signal_handler_context.writer, [self mapToWriterThreadMetadata: _config.threadMetadata]);
+    if (_config.shouldCaptureMemoryStatistics)
+        plcrash_log_writer_set_memory_statistics(&signal_handler_context.writer, true);
+    if (_config.shouldWriteSymbolicationDiagnostics)
+        plcrash_log_writer_set_symbolication_diagnostics(&signal_handler_context.writer, true);
+    if (_config.shouldWriteWriterDiagnostics)
+        plcrash_log_writer_set_writer_diagnostics(&signal_handler_context.writer, true);
+    if (_config.shouldWriteReferencedImagesOnly)
+        plcrash_log_writer_set_referenced_images_only(&signal_handler_context.writer, true);
+
+    /* Bound the time and work spent writing the crash report */
+    {
+        plcrash_log_writer_budget_t budget;
+        budget.max_threads = (uint32_t) MIN(_config.maxCrashThreadCount, (NSUInteger) UINT32_MAX);
+        budget.max_frames = (uint32_t) MIN(_config.maxCrashFramesPerThread, (NSUInteger) UINT32_MAX);
+        budget.max_other_frames = (uint32_t) MIN(_config.maxCrashFramesPerOtherThread, (NSUInteger) UINT32_MAX);
+        budget.max_symbolicated_frames = (uint32_t) MIN(_config.maxCrashSymbolicatedFrameCount, (NSUInteger) UINT32_MAX);
+        budget.time_limit = (uint64_t) (MAX(_config.crashReportTimeLimit, 0.0) * NSEC_PER_SEC);
+        plcrash_log_writer_set_budget(&signal_handler_context.writer, &budget);
+    }
+
+    if (_config.shouldPrioritizeCrashedThread)
+        plcrash_log_writer_set_prioritize_threads(&signal_handler_context.writer, true);
+
+    signal_handler_context.collapse_repeats = _config.shouldCollapseRepeatedCrashes;
+
+    /* Limit crash-time symbolication to the configured images */
+    if ([_config.symbolicationImagePaths count] > 0) {
+        NSArray *scopePaths = _config.symbolicationImagePaths;
+        const char **paths = malloc(sizeof(*paths) * [scopePaths count]);
+        for (NSUInteger i = 0; i < [scopePaths count]; i++)
+            paths[i] = [[scopePaths objectAtIndex: i] fileSystemRepresentation];
+
+        if (plcrash_log_writer_set_symbolication_scope(&signal_handler_context.writer, paths, [scopePaths count]) != PLCRASH_ESUCCESS)
+            NSDEBUG("Could not configure the symbolication scope, all images will be symbolicated");
+        free(paths);
+    }
+
+    /* Limit crash-time symbolication to the configured threads */
+    if (_config.symbolicatedThreads != PLCrashReporterSymbolicatedThreadsAll) {
+        NSArray *threadNames = _config.symbolicatedThreadNames;
+        if ([threadNames count] > 0) {
+            const char **names = malloc(sizeof(*names) * [threadNames count]);
+            for (NSUInteger i = 0; i < [threadNames count]; i++)
+                names[i] = [[threadNames objectAtIndex: i] UTF8String];
+
+            if (plcrash_log_writer_set_symbolicated_thread_names(&signal_handler_context.writer, names, [threadNames count]) != PLCRASH_ESUCCESS)
+                NSDEBUG("Could not configure the symbolicated thread names, named threads will not be symbolicated");
+            free(names);
+        }
+
+        plcrash_log_writer_set_symbolicated_threads(&signal_handler_context.writer, [self mapToWriterSymbolicatedThreads: _config.symbolicatedThreads],
+                                                    (uint32_t) _config.symbolicatedHotThreadCount);
+    }
+
+    /* Include any key/value area and breadcrumb buffer registered prior to enabling */
+    @synchronized (self) {
+        size_t kvLength = _keyValueArea != NULL ? PLCrashKeyValueAreaSize(_keyValueArea->slot_count) : 0;
+        size_t bcLength = _breadcrumbBuffer != NULL ? PLCrashBreadcrumbBufferSize(_breadcrumbBuffer->capacity) : 0;
+        plcrash_log_writer_set_custom_data(&signal_handler_context.writer, _keyValueArea, kvLength, _breadcrumbBuffer, bcLength);
+    }
+
+    signal_handler_context.max_report_bytes = MAX_REPORT_BYTES;
+    if (_config.stackMemoryCaptureSize > 0)
+        plcrash_log_writer_set_stack_capture(&signal_handler_context.writer, _config.stackMemoryCaptureSize, _config.shouldCaptureStackMemoryForAllThreads);
+    if (_config.shouldDeferCrashUnwinding)
+        plcrash_log_writer_set_raw_capture(&signal_handler_context.writer, true);
+    if (_config.shouldDeferCrashUnwinding || _config.stackMemoryCaptureSize > 0)
+        signal_handler_context.max_report_bytes += PLCRASH_LOG_WRITER_RAW_STACK_BUDGET;
+
+    /* Reserve and prefault the crash-time scratch arena. If this fails, scratch memory is allocated at crash time. */
+    if (_config.crashArenaSize > 0) {
+        if (plcrash_nasync_arena_init(&signal_handler_context.arena, _config.crashArenaSize) == PLCRASH_ESUCCESS) {
+            plcrash_nasync_scratch_set_arena(&signal_handler_context.arena);
+        } else {
+            NSDEBUG("Could not allocate the crash arena, scratch memory will be allocated at crash time");
+        }
+    }
+
+    /* Index image symbol tables on a low-priority background queue, rather than scanning each table at crash time */
+    if ((_config.symbolicationStrategy & PLCrashReporterSymbolicationStrategySymbolTable) && _config.symbolIndexMemoryLimit > 0) {
+        dispatch_queue_t queue = dispatch_queue_create("com.plausiblelabs.crashreporter.symbol-index", DISPATCH_QUEUE_SERIAL);
+        dispatch_set_target_queue(queue, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0));
+
+        /* Indexes are persisted by image UUID, so that they need only be built once per binary */
+        NSString *indexDir = [[self crashReportDirectory] stringByAppendingPathComponent: PLCRASH_SYMBOL_INDEX_DIR];
+        NSError *indexDirError = nil;
+        if ([[NSFileManager defaultManager] createDirectoryAtPath: indexDir withIntermediateDirectories: YES attributes: nil error: &indexDirError]) {
+            symbol_index_cache_dir = strdup([indexDir fileSystemRepresentation]); // NOTE: would leak if this were not a singleton struct
+        } else {
+            NSDEBUG("Could not create symbol index directory, indexes will not be persisted: %@", indexDirError);
+        }
+
+        /* dyld callbacks may fire concurrently; the limit must be visible before the queue */
+        symbol_index_memory_limit = _config.symbolIndexMemoryLimit;
+        OSMemoryBarrier();
+        symbol_index_queue = queue;
+        schedule_symbol_indexing();
+    }
+
+    /* Open (or resize) the report queue, so that crash reports may be queued without creating the index at crash time */
+    if (_config.reportQueueCapacity > 0) {
+        NSError *queueDirError = nil;
+        if (![[NSFileManager defaultManager] createDirectoryAtPath: [self reportQueueDirectory] withIntermediateDirectories: YES attributes: nil error: &queueDirError]) {
+            NSDEBUG(@"Could not create the report queue directory, reports will not be queued: %@", queueDirError);
+        } else if (plcrash_nasync_report_queue_init(&signal_handler_context.report_queue, [[self reportQueueDirectory] fileSystemRepresentation], (uint32_t) _config.reportQueueCapacity) != PLCRASH_ESUCCESS) {
+            NSDEBUG(@"Could not open the report queue, reports will not be queued");
+        } else {
+            signal_handler_context.report_queue_enabled = true;
+        }
+    }
+
+#if PLCRASH_FEATURE_MMAP_OUTPUT
+    /* Preallocate and map the crash report output file. If this fails, we fall back on opening the report
+     * file at crash time. */
+    {
+        NSString *preallocPath = [[self crashReportDirectory] stringByAppendingPathComponent: PLCRASH_PREALLOCATED_CRASHREPORT];
+        signal_handler_context.prealloc_path = strdup([preallocPath UTF8String]); // NOTE: would leak if this were not a singleton struct
+
+        signal_handler_context.prealloc_fd = -1;
+
+        /* A process terminated after the report was written, but before it could be moved into place, leaves a marked
+         * report in the preallocated file. An empty or unmarked file does not contain a report. */
+        [self recoverPreallocatedCrashReport];
+
+        int fd = open(signal_handler_context.prealloc_path, O_RDWR|O_CREAT|O_TRUNC, 0644);
+        if (fd < 0) {
+            PLCF_DEBUG("Could not open the preallocated crash log output file: %s", strerror(errno));
+        } else if (plcrash_async_file_nasync_init_mmap(&signal_handler_context.prealloc_file, fd, signal_handler_context.max_report_bytes) == PLCRASH_ESUCCESS) {
+            signal_handler_context.prealloc_available = true;
+        } else if (ftruncate(fd, 0) == 0 && plcrash_async_file_nasync_preallocate(fd, signal_handler_context.max_report_bytes) != PLCRASH_OUTPUT_ERR) {
+            /* Mapping failed; keep the open descriptor for buffered output, avoiding the path lookup and file creation
+             * at crash time. Buffered writes do not fault, and do not require reserved storage. */
+            signal_handler_context.prealloc_fd = fd;
+        } else {
+            close(fd);
+            unlink(signal_handler_context.prealloc_path);
+        }
+
+        /* Remove the preallocated file on clean process exit */
+        if (signal_handler_context.prealloc_available || signal_handler_context.prealloc_fd >= 0)
+            atexit(remove_preallocated_report);
+    }
+#endif /* PLCRASH_FEATURE_MMAP_OUTPUT */
+
+    uint64_t preparationTime = mach_absolute_time();
     
     /* Enable the signal handler */
     switch (_config.signalHandlerType) {
@@ -606,6 +1711,18 @@ static PLCrashReporter *sharedReporter = nil;
              * EXC_CRASH. */
             if (![[PLCrashSignalHandler sharedHandler] registerHandlerForSignal: SIGABRT callback: &signal_handler_callback context: &signal_handler_context error: outError])
                 return NO;
+
+#if PLCRASH_FEATURE_OUT_OF_PROCESS_HELPER
+            /* If configured, hand the remaining exceptions to the out-of-process helper, which writes the report
+             * from outside of the crashed process; no in-process server is required. */
+            if (_config.helperServiceName != nil) {
+                if (![self registerWithHelperWithPreviousPortSet: &_previousMachPorts error: outError])
+                    return NO;
+
+                [_previousMachPorts retain];
+                break;
+            }
+#endif /* PLCRASH_FEATURE_OUT_OF_PROCESS_HELPER */
             
             /* Enable the server. */
             _machServer = [self enableMachExceptionServerWithPreviousPortSet: &_previousMachPorts
@@ -636,16 +1753,52 @@ static PLCrashReporter *sharedReporter = nil;
              * TODO: Investigate use of (async-safe) locking to close the window in which an exception would not be safely forwarded.
              * This issue also exists (and is noted with a TODO) in PLCrashSignalHandler.
              */
-            signal_handler_context.port_set = [_previousMachPorts asyncSafeRepresentation];
+            plcrash_mach_exception_port_set_t port_set = [_previousMachPorts asyncSafeRepresentation];
+            plcrash_mach_exception_forward_table_init(&signal_handler_context.forward_table, &port_set);
             break;
         }
 #endif /* PLCRASH_FEATURE_MACH_EXCEPTIONS */
     }
 
+    /* Pre-warm the crash path, and re-warm it as memory pressure changes */
+    PLCrashReporterPrewarm prewarm = _config.crashPathPrewarming;
+    if (prewarm != PLCrashReporterPrewarmNone) {
+        prewarm_crash_path((prewarm & PLCrashReporterPrewarmLock) != 0);
+
+        if ((prewarm & PLCrashReporterPrewarmOnMemoryPressure) && prewarm_pressure_source == NULL) {
+            dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_MEMORYPRESSURE, 0,
+                                                              DISPATCH_MEMORYPRESSURE_NORMAL|DISPATCH_MEMORYPRESSURE_WARN|DISPATCH_MEMORYPRESSURE_CRITICAL,
+                                                              dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0));
+            if (source != NULL) {
+                /* Wired pages need not be re-wired */
+                dispatch_source_set_event_handler(source, ^{
+                    prewarm_crash_path(false);
+                });
+                dispatch_resume(source);
+                prewarm_pressure_source = source;
+            } else {
+                NSDEBUG("Could not create a memory pressure source, the crash path will not be re-warmed");
+            }
+        }
+    }
+
     /* Set the uncaught exception handler */
     if(_config.shouldRegisterUncaughtExceptionHandler) {
       NSSetUncaughtExceptionHandler(&uncaught_exception_handler);
     }
+
+    /* Record the enable timing */
+    uint64_t endTime = mach_absolute_time();
+    size_t parsedCount;
+    size_t imageCount = plcrash_nasync_image_list_count(&shared_image_list, &parsedCount);
+    _startupMetrics = [[PLCrashReporterStartupMetrics alloc] initWithImageMonitoringDuration: plcr_absolute_interval(0, image_monitoring_time)
+                                                                   directoryCreationDuration: plcr_absolute_interval(startTime, directoryTime)
+                                                                   imageRegistrationDuration: plcr_absolute_interval(directoryTime, registrationTime)
+                                                                         preparationDuration: plcr_absolute_interval(registrationTime, preparationTime)
+                                                                 handlerRegistrationDuration: plcr_absolute_interval(preparationTime, endTime)
+                                                                               totalDuration: plcr_absolute_interval(startTime, endTime)
+                                                                                  imageCount: imageCount
+                                                                            parsedImageCount: parsedCount];
   
     /* Success */
     _enabled = YES;
@@ -679,6 +1832,26 @@ static plcrash_error_t plcr_live_report_callback (plcrash_async_thread_state_t *
     return plcrash_log_writer_write(plcr_ctx->writer, pl_mach_thread_self(), &shared_image_list, plcr_ctx->file, plcr_ctx->info, state);
 }
 
+/**
+ * @internal
+ *
+ * CFAllocator allocation callback used for live report data. Live report buffers are only ever deallocated
+ * through this allocator; allocation is not supported.
+ */
+static void *plcr_live_report_allocate (CFIndex allocSize, CFOptionFlags hint, void *info) {
+    return NULL;
+}
+
+/**
+ * @internal
+ *
+ * CFAllocator deallocation callback used for live report data. The allocator's @a info value is the
+ * vm_allocate()'d region size.
+ */
+static void plcr_live_report_deallocate (void *ptr, void *info) {
+    vm_deallocate(mach_task_self(), (vm_address_t) ptr, (vm_size_t) (uintptr_t) info);
+}
+
 
 /**
  * Generate a live crash report for a given @a thread, without triggering an actual crash condition.
@@ -716,29 +1889,32 @@ static plcrash_error_t plcr_live_report_callback (plcrash_async_thread_state_t *
  * @todo Implement in-memory, rather than requiring writing of the report to disk.
  */
 - (NSData *) generateLiveReportWithThread: (thread_t) thread exception: (NSException *) exception error: (NSError **) outError {
-    plcrash_log_writer_t writer;
+    plcrash_log_writer_t *writer;
     plcrash_async_file_t file;
     plcrash_error_t err;
 
-    /* Open the output file */
-    NSString *templateStr = [NSTemporaryDirectory() stringByAppendingPathComponent: @"live_crash_report.XXXXXX"];
-    char *path = strdup([templateStr fileSystemRepresentation]);
-    
-    int fd = mkstemp(path);
-    if (fd < 0) {
-        plcrash_populate_posix_error(outError, errno, NSLocalizedString(@"Failed to create temporary path", @"Error opening temporary output path"));
-        free(path);
-
+    /* Initialize the in-memory output context */
+    if ((err = plcrash_async_file_init_vm(&file, MAX_REPORT_BYTES + MAX_STACK_SAMPLE_BYTES)) != PLCRASH_ESUCCESS) {
+        plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Failed to allocate the live crash report buffer", nil);
         return nil;
     }
 
-    /* Initialize the output context */
-    plcrash_log_writer_init(&writer, _applicationIdentifier, _applicationVersion, _applicationMarketingVersion, [self mapToAsyncSymbolicationStrategy: _config.symbolicationStrategy], true);
-    plcrash_async_file_init(&file, fd, MAX_REPORT_BYTES);
+    /* Register any images that are still pending */
+    flush_image_registration();
+
+    /* Fetch the persistent writer; the environment data, static report sections, and symbol cache are shared
+     * by all live reports. */
+    PLCrashLiveReportSession *session = [self liveReportSession];
+    if (session == nil) {
+        plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Failed to initialize the live crash report writer", nil);
+        vm_deallocate(mach_task_self(), (vm_address_t) file.mem_buffer, file.mem_capacity);
+        return nil;
+    }
+    writer = [session beginReport];
 
     /* Provide the exception, if any */
     if (exception != nil)
-        plcrash_log_writer_set_exception(&writer, exception);
+        plcrash_log_writer_set_exception(writer, exception);
     
     /* Mock up a SIGTRAP-based signal info */
     plcrash_log_bsd_signal_info_t bsd_signal_info;
@@ -751,48 +1927,50 @@ static plcrash_error_t plcr_live_report_callback (plcrash_async_thread_state_t *
     signal_info.mach_info = NULL;
     
     /* Write the crash log using the already-initialized writer */
+    plcrash_nasync_probes_live_begin();
     if (thread == pl_mach_thread_self()) {
         struct plcr_live_report_context ctx = {
-            .writer = &writer,
+            .writer = writer,
             .file = &file,
             .info = &signal_info
         };
         err = plcrash_async_thread_state_current(plcr_live_report_callback, &ctx);
     } else {
-        err = plcrash_log_writer_write(&writer, thread, &shared_image_list, &file, &signal_info, NULL);
+        err = plcrash_log_writer_write(writer, thread, &shared_image_list, &file, &signal_info, NULL);
     }
-    plcrash_log_writer_close(&writer);
-    /* Flush the data */
-    plcrash_async_file_flush(&file);
+    plcrash_nasync_probes_live_end();
     plcrash_async_file_close(&file);
 
+    /* Finished with the writer */
+    [session endReport];
+
     /* Check for write failure */
-    NSData *data;
     if (err != PLCRASH_ESUCCESS) {
         NSLog(@"Write failed with error %s", plcrash_async_strerror(err));
-        plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Failed to write the crash report to disk", nil);
-        data = nil;
-        goto cleanup;
-    }
-
-    data = [NSData dataWithContentsOfFile: [NSString stringWithUTF8String: path]];
-    if (data == nil) {
-        /* This should only happen if our data is deleted out from under us */
-        plcrash_populate_error(outError, PLCrashReporterErrorUnknown, NSLocalizedString(@"Unable to open live crash report for reading", nil), nil);
-        goto cleanup;
+        plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Failed to write the crash report", nil);
+        vm_deallocate(mach_task_self(), (vm_address_t) file.mem_buffer, file.mem_capacity);
+        return nil;
     }
 
-cleanup:
-    /* Finished -- clean up. */
-    plcrash_log_writer_free(&writer);
+    /* Hand the report buffer to an NSData instance without copying; the region is vm_deallocate()'d when the data
+     * instance is released. */
+    CFAllocatorContext allocatorContext = {
+        .version = 0,
+        .info = (void *) (uintptr_t) file.mem_capacity,
+        .allocate = plcr_live_report_allocate,
+        .deallocate = plcr_live_report_deallocate
+    };
+    CFAllocatorRef deallocator = CFAllocatorCreate(kCFAllocatorDefault, &allocatorContext);
+    CFDataRef data = CFDataCreateWithBytesNoCopy(kCFAllocatorDefault, file.mem_buffer, (CFIndex) file.total_bytes, deallocator);
+    CFRelease(deallocator);
 
-    if (unlink(path) != 0) {
-        /* This shouldn't fail, but if it does, there's no use in returning nil */
-        NSLog(@"Failure occured deleting live crash report: %s", strerror(errno));
+    if (data == NULL) {
+        plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Failed to create the live crash report data", nil);
+        vm_deallocate(mach_task_self(), (vm_address_t) file.mem_buffer, file.mem_capacity);
+        return nil;
     }
 
-    free(path);
-    return data;
+    return [(NSData *) data autorelease];
 }
 
 
@@ -829,6 +2007,195 @@ cleanup:
     return [self generateLiveReportWithThread: pl_mach_thread_self() exception: exception error: outError];
 }
 
+/**
+ * Discard the base report of incremental live reports. The next live report will be written in full, and will
+ * become the base report of all subsequent live reports. This has no effect unless
+ * PLCrashReporterConfig::shouldWriteIncrementalLiveReports is enabled.
+ */
+- (void) resetLiveReportBase {
+    @synchronized (self) {
+        [_liveReportSession resetBaseline];
+    }
+}
+
+/**
+ * Asynchronously generate a live crash report, coalescing concurrent requests into a single capture.
+ *
+ * Each call to generateLiveReport suspends all other threads while the report is written. If several subsystems
+ * request live reports at once (for example, a hang detector and a user-triggered diagnostics action), the
+ * scheduled requests instead share one capture, and receive the same report data. Every request that arrives before
+ * a scheduled capture has started joins that capture; captures are further limited to one per
+ * PLCrashReporterConfig::minimumLiveReportInterval, and requests arriving within the interval are deferred to the
+ * next capture.
+ *
+ * The report is captured on a background queue, and the thread on which it is captured is marked as the crashed
+ * thread; callers are expected to select the threads of interest via their thread filter.
+ *
+ * @param filter A filter selecting the threads of interest to this request, or nil. If non-nil, the shared report is
+ * decoded on behalf of this request, and the accepted threads are provided to @a completionHandler.
+ * @param completionHandler The block to be invoked with the report. The block is invoked on a global concurrent
+ * queue.
+ */
+- (void) scheduleLiveReportWithThreadFilter: (PLCrashLiveReportThreadFilter) filter
+                          completionHandler: (PLCrashLiveReportCompletionHandler) completionHandler
+{
+    PLCrashLiveReportScheduler *scheduler;
+    @synchronized (self) {
+        if (_liveReportScheduler == nil) {
+            /* The scheduler is owned by the reporter; avoid a retain cycle via the capture block */
+            __block PLCrashReporter *reporter = self;
+            _liveReportScheduler = [[PLCrashLiveReportScheduler alloc] initWithMinimumInterval: _config.minimumLiveReportInterval captureBlock: ^NSData *(NSError **outError) {
+                return [reporter generateLiveReportWithThread: pl_mach_thread_self() exception: nil error: outError];
+            }];
+        }
+        scheduler = [[_liveReportScheduler retain] autorelease];
+    }
+
+    [scheduler scheduleReportWithHandler: ^(NSData *reportData, NSError *error) {
+        if (reportData == nil || filter == nil) {
+            completionHandler(reportData, nil, error);
+            return;
+        }
+
+        /* Decode the shared report for this request, and apply its filter */
+        NSError *decodeError = nil;
+        PLCrashReport *report = [[PLCrashReport alloc] initWithData: reportData error: &decodeError];
+        if (report == nil) {
+            completionHandler(reportData, nil, decodeError);
+            return;
+        }
+
+        NSMutableArray *threads = [NSMutableArray arrayWithCapacity: [report.threads count]];
+        for (PLCrashReportThreadInfo *thread in report.threads) {
+            if (filter(thread))
+                [threads addObject: thread];
+        }
+
+        completionHandler(reportData, threads, nil);
+        [report release];
+    }];
+}
+
+/**
+ * Begin periodically sampling the stacks of the given @a threads. Each sample records only the PC values of each
+ * thread's stack, and identical stacks are aggregated; no symbolication is performed. All live reports generated
+ * while sampling is active will include the aggregated stack samples, and the binary images they reference.
+ *
+ * This is intended for diagnosing hangs (for example, by sampling the main thread), at a far lower cost than
+ * repeatedly generating live reports.
+ *
+ * @param threads The threads to be sampled. The calling thread may be included, and will be sampled from the
+ * sampler's background thread.
+ * @param count The number of threads in @a threads. At most 8 threads may be sampled.
+ * @param interval The sampling interval, in seconds.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error
+ * object indicating why sampling could not be started. If no error occurs, this parameter will be left unmodified.
+ * You may specify nil for this parameter, and no error information will be provided.
+ *
+ * @return Returns YES on success, or NO if sampling could not be started. If sampling is already active,
+ * NO will be returned, and the error code will be PLCrashReporterErrorResourceBusy.
+ */
+- (BOOL) startStackSamplingWithThreads: (const thread_t *) threads
+                                 count: (NSUInteger) count
+                              interval: (NSTimeInterval) interval
+                                 error: (NSError **) outError
+{
+    @synchronized (self) {
+        if (_stackSampler != NULL) {
+            plcrash_populate_error(outError, PLCrashReporterErrorResourceBusy, @"Stack sampling has already been started", nil);
+            return NO;
+        }
+
+        if (count == 0 || count > PLCRASH_STACK_SAMPLER_MAX_THREADS) {
+            plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"An invalid number of threads was supplied for stack sampling", nil);
+            return NO;
+        }
+
+        PLCrashLiveReportSession *session = [self liveReportSession];
+        if (session == nil) {
+            plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Failed to initialize the live crash report writer", nil);
+            return NO;
+        }
+
+        /* Register any images that are still pending */
+        flush_image_registration();
+
+        plcrash_stack_sampler_t *sampler = malloc(sizeof(*sampler));
+        if (sampler == NULL) {
+            plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Failed to allocate the stack sampler", nil);
+            return NO;
+        }
+
+        uint64_t interval_ns = (uint64_t) (interval * NSEC_PER_SEC);
+        plcrash_error_t err = plcrash_stack_sampler_init(sampler, mach_task_self(), &shared_image_list, threads, (uint32_t) count, STACK_SAMPLE_CAPACITY, interval_ns);
+        if (err != PLCRASH_ESUCCESS) {
+            plcrash_populate_error(outError, PLCrashReporterErrorUnknown, [NSString stringWithFormat: @"Failed to initialize the stack sampler: %s", plcrash_async_strerror(err)], nil);
+            free(sampler);
+            return NO;
+        }
+
+        if ((err = plcrash_stack_sampler_start(sampler)) != PLCRASH_ESUCCESS) {
+            plcrash_populate_error(outError, PLCrashReporterErrorOperatingSystem, @"Failed to start the stack sampling thread", nil);
+            plcrash_stack_sampler_free(sampler);
+            free(sampler);
+            return NO;
+        }
+
+        [session setStackSampler: sampler];
+        _stackSampler = sampler;
+    }
+
+    return YES;
+}
+
+/**
+ * Stop stack sampling started via PLCrashReporter::startStackSamplingWithThreads:count:interval:error:, and discard
+ * all recorded samples. Subsequent live reports will not include stack samples.
+ */
+- (void) stopStackSampling {
+    @synchronized (self) {
+        if (_stackSampler == NULL)
+            return;
+
+        /* Wait for any in-progress live report to release the sampler */
+        [_liveReportSession setStackSampler: NULL];
+
+        plcrash_stack_sampler_free(_stackSampler);
+        free(_stackSampler);
+        _stackSampler = NULL;
+    }
+}
+
+/**
+ * Register a preallocated key/value area, the contents of which will be copied verbatim to all subsequent crash and
+ * live reports. The area may be updated at any time via PLCrashKeyValueAreaSet() and PLCrashKeyValueAreaRemove(),
+ * without further involvement of the receiver; no encoding is performed when a report is written.
+ *
+ * @param area An area initialized via PLCrashKeyValueAreaInit(), or NULL to stop including key/value data in
+ * reports. The area is not copied, and must remain valid for the lifetime of the process, or until it is replaced.
+ */
+- (void) setKeyValueArea: (PLCrashKeyValueArea *) area {
+    @synchronized (self) {
+        _keyValueArea = area;
+        [self updateCustomData];
+    }
+}
+
+/**
+ * Register a preallocated breadcrumb buffer, the contents of which will be copied verbatim to all subsequent crash
+ * and live reports. Breadcrumbs may be appended at any time via PLCrashBreadcrumbBufferAppend(), without further
+ * involvement of the receiver.
+ *
+ * @param buffer A buffer initialized via PLCrashBreadcrumbBufferInit(), or NULL to stop including breadcrumbs in
+ * reports. The buffer is not copied, and must remain valid for the lifetime of the process, or until it is replaced.
+ */
+- (void) setBreadcrumbBuffer: (PLCrashBreadcrumbBuffer *) buffer {
+    @synchronized (self) {
+        _breadcrumbBuffer = buffer;
+        [self updateCustomData];
+    }
+}
+
 /**
  * Set the callbacks that will be executed by the receiver after a crash has occured and been recorded by PLCrashReporter.
  *
@@ -884,8 +2251,8 @@ cleanup:
     if ((self = [super init]) == nil)
         return nil;
 
-    /* Save the configuration */
-    _config = [configuration retain];
+    /* Save a copy of the configuration; later changes to the caller's instance must not affect the reporter */
+    _config = [configuration copy];
     _applicationIdentifier = [applicationIdentifier retain];
     _applicationVersion = [applicationVersion retain];
     _applicationMarketingVersion = [applicationMarketingVersion retain];
@@ -939,21 +2306,10 @@ cleanup:
 #if PLCRASH_FEATURE_MACH_EXCEPTIONS
 
 /**
- * Create, register, and return a Mach exception server.
- *
- * @param[out] previousPortSet The previously registered Mach exception ports.
- * @param context The context to be provided to the callback.
- * @param outError A pointer to an NSError object variable. If an error occurs, this pointer
- * will contain an error in the PLCrashReporterErrorDomain indicating why the Crash Reporter
- * could not be enabled. If no error occurs, this parameter will be left unmodified. You may
- * specify nil for this parameter, and no error information will be provided.
+ * Return the Mach exception mask for which crash reporting exception ports are registered.
  */
-- (PLCrashMachExceptionServer *) enableMachExceptionServerWithPreviousPortSet: (PLCrashMachExceptionPortSet **) previousPortSet
-                                                                     callback: (PLCrashMachExceptionHandlerCallback) callback
-                                                                      context: (void *) context
-                                                                        error: (NSError **) outError
-{
-    /* Determine the target exception type mask. Note that unlike some other Mach exception-based
+- (exception_mask_t) machExceptionMask {
+    /* Unlike some other Mach exception-based
      * crash reporting implementations, we do not monitor EXC_RESOURCE:
      *
      * EXC_RESOURCE wasn't added until iOS 5.1 and Mac OS X 10.8, and is used for
@@ -983,17 +2339,38 @@ cleanup:
     if (hinfo != nil && hinfo.darwinVersion.major >= 13)
         exc_mask |= EXC_MASK_GUARD; /* Process accessed a guarded file descriptor. See also: https://devforums.apple.com/message/713907#713907 */
 #endif
-    
+
+    return exc_mask;
+}
+
+/**
+ * Create, register, and return a Mach exception server.
+ *
+ * @param[out] previousPortSet The previously registered Mach exception ports.
+ * @param context The context to be provided to the callback.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer
+ * will contain an error in the PLCrashReporterErrorDomain indicating why the Crash Reporter
+ * could not be enabled. If no error occurs, this parameter will be left unmodified. You may
+ * specify nil for this parameter, and no error information will be provided.
+ */
+- (PLCrashMachExceptionServer *) enableMachExceptionServerWithPreviousPortSet: (PLCrashMachExceptionPortSet **) previousPortSet
+                                                                     callback: (PLCrashMachExceptionHandlerCallback) callback
+                                                                      context: (void *) context
+                                                                        error: (NSError **) outError
+{
     /* Create the server */
     NSError *osError;
-    PLCrashMachExceptionServer *server = [[[PLCrashMachExceptionServer alloc] initWithCallBack: callback context: context error: &osError] autorelease];
+    PLCrashMachExceptionServer *server = [[[PLCrashMachExceptionServer alloc] initWithCallBack: callback
+                                                                                       context: context
+                                                                                  highPriority: _config.shouldUseHighPriorityMachExceptionServer
+                                                                                         error: &osError] autorelease];
     if (server == nil) {
         plcrash_populate_error(outError, PLCrashReporterErrorOperatingSystem, @"Failed to instantiate the Mach exception server.", osError);
         return nil;
     }
     
     /* Allocate the port */
-    PLCrashMachExceptionPort *port = [server exceptionPortWithMask: exc_mask error: &osError];
+    PLCrashMachExceptionPort *port = [server exceptionPortWithMask: [self machExceptionMask] error: &osError];
     if (port == nil) {
         plcrash_populate_error(outError, PLCrashReporterErrorOperatingSystem, @"Failed to instantiate the Mach exception port.", osError);
         return nil;
@@ -1008,9 +2385,48 @@ cleanup:
     return server;
 }
 
+#if PLCRASH_FEATURE_OUT_OF_PROCESS_HELPER
+/**
+ * Register the current task with the configured out-of-process crash reporting helper, and set the helper's
+ * exception port as the task's exception port.
+ *
+ * @param[out] previousPortSet The previously registered Mach exception ports.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer
+ * will contain an error in the PLCrashReporterErrorDomain indicating why the Crash Reporter
+ * could not be enabled. If no error occurs, this parameter will be left unmodified. You may
+ * specify nil for this parameter, and no error information will be provided.
+ */
+- (BOOL) registerWithHelperWithPreviousPortSet: (PLCrashMachExceptionPortSet **) previousPortSet error: (NSError **) outError {
+    NSError *osError;
+    PLCrashMachExceptionPort *port = [PLCrashHelperServer registerWithServiceName: _config.helperServiceName
+                                                                       reportPath: [self crashReportPath]
+                                                            applicationIdentifier: _applicationIdentifier
+                                                               applicationVersion: _applicationVersion
+                                                      applicationMarketingVersion: _applicationMarketingVersion
+                                                                   symbolStrategy: [self mapToAsyncSymbolicationStrategy: _config.symbolicationStrategy]
+                                                                             mask: [self machExceptionMask]
+                                                                            error: &osError];
+    if (port == nil) {
+        plcrash_populate_error(outError, PLCrashReporterErrorOperatingSystem, @"Failed to register with the crash reporting helper.", osError);
+        return NO;
+    }
+
+    if (![port registerForTask: mach_task_self() previousPortSet: previousPortSet error: &osError]) {
+        plcrash_populate_error(outError, PLCrashReporterErrorOperatingSystem, @"Failed to set the target task's mach exception ports.", osError);
+        return NO;
+    }
+
+    return YES;
+}
+#endif /* PLCRASH_FEATURE_OUT_OF_PROCESS_HELPER */
+
 #endif /* PLCRASH_FEATURE_MACH_EXCEPTIONS */
 
 - (void) dealloc {
+    /* The live report capture block does not retain the reporter; cancel pending captures, and wait for any capture
+     * in progress to complete before tearing down the state it references */
+    [_liveReportScheduler invalidate];
+
     [_config release];
 
 #if PLCRASH_FEATURE_MACH_EXCEPTIONS
@@ -1022,6 +2438,9 @@ cleanup:
     [_applicationIdentifier release];
     [_applicationVersion release];
     [_applicationMarketingVersion release];
+    [self stopStackSampling];
+    [_liveReportSession release];
+    [_liveReportScheduler release];
 
     [super dealloc];
 }
@@ -1046,6 +2465,54 @@ cleanup:
     return result;
 }
 
+/**
+ * Map the configuration defined thread @a metadata to the backing plcrash_log_writer_thread_metadata_flags_t
+ * representation.
+ *
+ * @param metadata The metadata value to map.
+ */
+- (uint32_t) mapToWriterThreadMetadata: (PLCrashReporterThreadMetadata) metadata {
+    uint32_t result = 0;
+
+    if (metadata & PLCrashReporterThreadMetadataName)
+        result |= PLCRASH_LOG_WRITER_THREAD_METADATA_NAME;
+
+    if (metadata & PLCrashReporterThreadMetadataDispatchQueue)
+        result |= PLCRASH_LOG_WRITER_THREAD_METADATA_DISPATCH_QUEUE;
+
+    if (metadata & PLCrashReporterThreadMetadataQoS)
+        result |= PLCRASH_LOG_WRITER_THREAD_METADATA_QOS;
+
+    if (metadata & PLCrashReporterThreadMetadataCPUTime)
+        result |= PLCRASH_LOG_WRITER_THREAD_METADATA_CPU_TIME;
+
+    return result;
+}
+
+/**
+ * Map the configuration defined symbolicated @a threads to the backing plcrash_log_writer_symbolicated_threads_t
+ * representation.
+ *
+ * @param threads The symbolicated threads value to map.
+ */
+- (uint32_t) mapToWriterSymbolicatedThreads: (PLCrashReporterSymbolicatedThreads) threads {
+    uint32_t result = 0;
+
+    if (threads & PLCrashReporterSymbolicatedThreadsCrashed)
+        result |= PLCRASH_LOG_WRITER_SYMBOLICATE_CRASHED;
+
+    if (threads & PLCrashReporterSymbolicatedThreadsMain)
+        result |= PLCRASH_LOG_WRITER_SYMBOLICATE_MAIN;
+
+    if (threads & PLCrashReporterSymbolicatedThreadsHot)
+        result |= PLCRASH_LOG_WRITER_SYMBOLICATE_HOT;
+
+    if (threads & PLCrashReporterSymbolicatedThreadsNamed)
+        result |= PLCRASH_LOG_WRITER_SYMBOLICATE_NAMED;
+
+    return result;
+}
+
 /**
  * Validate (and create if necessary) the crash reporter directory structure.
  */
@@ -1096,5 +2563,95 @@ cleanup:
 }
 
 
+/**
+ * Return the path to the live crash report's summary (which may not yet, or ever, exist).
+ */
+- (NSString *) crashReportSummaryPath {
+    return [[self crashReportDirectory] stringByAppendingPathComponent: PLCRASH_LIVE_CRASHREPORT_SUMMARY];
+}
+
+/**
+ * Return the path to the bounded crash report queue directory (which may not yet, or ever, exist).
+ */
+- (NSString *) reportQueueDirectory {
+    return [[self crashReportDirectory] stringByAppendingPathComponent: PLCRASH_REPORT_QUEUE_DIR];
+}
+
+/**
+ * Open the existing bounded crash report queue, if any.
+ *
+ * @param queue The queue to initialize. The caller is responsible for freeing the queue if PLCRASH_ESUCCESS is
+ * returned.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_ENOTFOUND if no queue exists, or an appropriate error value if
+ * the queue could not be opened.
+ */
+- (plcrash_error_t) openReportQueue: (plcrash_async_report_queue_t *) queue {
+    return plcrash_nasync_report_queue_init(queue, [[self reportQueueDirectory] fileSystemRepresentation], 0);
+}
+
+/**
+ * If the preallocated crash report output file contains a report that was not moved into place (for example, if
+ * the process was terminated while the report was being written), and no live report exists, move the report into
+ * place. An empty preallocated file, or one without the crash report file magic, does not contain a report.
+ *
+ * A preallocated file that is not moved into place is removed, releasing its reserved storage.
+ */
+- (void) recoverPreallocatedCrashReport {
+    NSString *preallocPath = [[self crashReportDirectory] stringByAppendingPathComponent: PLCRASH_PREALLOCATED_CRASHREPORT];
+    char magic[sizeof(PLCRASH_REPORT_FILE_MAGIC) - 1];
+
+    int fd = open([preallocPath fileSystemRepresentation], O_RDONLY);
+    if (fd < 0)
+        return;
+
+    ssize_t len = read(fd, magic, sizeof(magic));
+    close(fd);
+
+    if (![self hasPendingCrashReport] && len == (ssize_t) sizeof(magic) && memcmp(magic, PLCRASH_REPORT_FILE_MAGIC, sizeof(magic)) == 0) {
+        if (rename([preallocPath fileSystemRepresentation], [[self crashReportPath] fileSystemRepresentation]) == 0)
+            return;
+
+        NSDEBUG(@"Could not recover the preallocated crash report: %s", strerror(errno));
+    }
+
+    unlink([preallocPath fileSystemRepresentation]);
+}
+
+/**
+ * Return the persistent live report session, creating it if necessary.
+ *
+ * @return Returns the session, or nil if the session's writer could not be initialized.
+ */
+- (PLCrashLiveReportSession *) liveReportSession {
+    @synchronized (self) {
+        if (_liveReportSession == nil) {
+            _liveReportSession = [[PLCrashLiveReportSession alloc] initWithApplicationIdentifier: _applicationIdentifier
+                                                                                      appVersion: _applicationVersion
+                                                                             appMarketingVersion: _applicationMarketingVersion
+                                                                                  symbolStrategy: [self mapToAsyncSymbolicationStrategy: _config.symbolicationStrategy]
+                                                                                   configuration: _config];
+            [self updateCustomData];
+        }
+
+        return _liveReportSession;
+    }
+}
+
+/**
+ * Apply the registered key/value area and breadcrumb buffer to the crash report writer, if enabled, and to the
+ * live report session, if any.
+ */
+- (void) updateCustomData {
+    size_t kvLength = _keyValueArea != NULL ? PLCrashKeyValueAreaSize(_keyValueArea->slot_count) : 0;
+    size_t bcLength = _breadcrumbBuffer != NULL ? PLCrashBreadcrumbBufferSize(_breadcrumbBuffer->capacity) : 0;
+
+    if (_enabled)
+        plcrash_log_writer_set_custom_data(&signal_handler_context.writer, _keyValueArea, kvLength, _breadcrumbBuffer, bcLength);
+
+    [_liveReportSession setKeyValueArea: _keyValueArea length: kvLength breadcrumbs: _breadcrumbBuffer length: bcLength];
+}
+
+
 
 @end
@@ -139,7 +139,129 @@ typedef NS_OPTIONS(NSUInteger, PLCrashReporterSymbolicationStrategy) {
     PLCrashReporterSymbolicationStrategyAll = (PLCrashReporterSymbolicationStrategySymbolTable|PLCrashReporterSymbolicationStrategyObjC)
 };
 
-@interface PLCrashReporterConfig : NSObject {
+/**
+ * Per-thread metadata that may be captured in crash reports, in addition to each thread's backtrace.
+ *
+ * Each item is fetched from the kernel with a single call per thread, and adds only a few bytes to each thread
+ * in the report.
+ */
+typedef NS_OPTIONS(NSUInteger, PLCrashReporterThreadMetadata) {
+    /** No thread metadata. */
+    PLCrashReporterThreadMetadataNone = 0,
+
+    /** The thread's name, as set via pthread_setname_np(). */
+    PLCrashReporterThreadMetadataName = 1 << 0,
+
+    /**
+     * The label of the dispatch queue on which the thread is executing. This requires reading the queue's label from
+     * memory, as described by libdispatch's exported queue layout.
+     */
+    PLCrashReporterThreadMetadataDispatchQueue = 1 << 1,
+
+    /** The thread's quality-of-service class. */
+    PLCrashReporterThreadMetadataQoS = 1 << 2,
+
+    /** The user and system CPU time consumed by the thread. */
+    PLCrashReporterThreadMetadataCPUTime = 1 << 3,
+
+    /**
+     * Capture all available thread metadata.
+     */
+    PLCrashReporterThreadMetadataAll = (PLCrashReporterThreadMetadataName|PLCrashReporterThreadMetadataDispatchQueue|
+                                        PLCrashReporterThreadMetadataQoS|PLCrashReporterThreadMetadataCPUTime)
+};
+
+/**
+ * Crash path pre-warming options.
+ *
+ * The first crash-time access to the crash reporter's code, its alternate signal stack, and its preallocated buffers
+ * may page fault; under memory pressure, those pages may have been compressed or evicted, delaying the report at the
+ * point at which the process is least stable. Pre-warming faults these pages in when the crash reporter is enabled.
+ */
+typedef NS_OPTIONS(NSUInteger, PLCrashReporterPrewarm) {
+    /** No pre-warming is performed. */
+    PLCrashReporterPrewarmNone = 0,
+
+    /**
+     * Fault in the alternate signal stack, the crash-time scratch arena, the preallocated report output file, and the
+     * crash reporter's crash path code when the crash reporter is enabled.
+     */
+    PLCrashReporterPrewarmPages = 1 << 0,
+
+    /**
+     * Wire the alternate signal stack and the crash-time scratch arena via mlock(), preventing them from being paged
+     * out. Wiring is subject to the process' resource limits, and failure is not reported. Implies
+     * PLCrashReporterPrewarmPages.
+     */
+    PLCrashReporterPrewarmLock = 1 << 1,
+
+    /**
+     * Fault the pages in again whenever the system's memory pressure changes. Implies PLCrashReporterPrewarmPages.
+     */
+    PLCrashReporterPrewarmOnMemoryPressure = 1 << 2
+};
+
+/**
+ * The threads to which the configured symbolication strategy is applied at crash time.
+ *
+ * Local symbolication is the most expensive part of writing a thread's frames. Restricting it to the threads of
+ * interest writes the frames of all other threads with their PCs only; these may be symbolicated after the report
+ * is retrieved. If any threads are selected, only the selected threads are symbolicated.
+ */
+typedef NS_OPTIONS(NSUInteger, PLCrashReporterSymbolicatedThreads) {
+    /** All threads are symbolicated. */
+    PLCrashReporterSymbolicatedThreadsAll = 0,
+
+    /** Symbolicate the crashed thread. */
+    PLCrashReporterSymbolicatedThreadsCrashed = 1 << 0,
+
+    /** Symbolicate the main thread. */
+    PLCrashReporterSymbolicatedThreadsMain = 1 << 1,
+
+    /**
+     * Symbolicate the threads that have consumed the most CPU time (see
+     * PLCrashReporterConfig.symbolicatedHotThreadCount).
+     */
+    PLCrashReporterSymbolicatedThreadsHot = 1 << 2,
+
+    /**
+     * Symbolicate the threads whose names begin with one of the configured prefixes (see
+     * PLCrashReporterConfig.symbolicatedThreadNames).
+     */
+    PLCrashReporterSymbolicatedThreadsNamed = 1 << 3
+};
+
+/**
+ * The default crash report output buffer size, in bytes.
+ */
+#define PLCrashReporterDefaultOutputBufferSize (16 * 1024)
+
+/**
+ * The maximum supported crash report output buffer size, in bytes.
+ */
+#define PLCrashReporterMaximumOutputBufferSize (64 * 1024)
+
+/**
+ * The maximum supported report queue capacity.
+ */
+#define PLCrashReporterMaximumReportQueueCapacity 64
+
+/**
+ * The maximum supported number of symbolicated hot threads.
+ */
+#define PLCrashReporterMaximumSymbolicatedHotThreadCount 16
+
+/**
+ * The default memory limit for background-built symbol indexes, in bytes.
+ */
+#define PLCrashReporterDefaultSymbolIndexMemoryLimit (16 * 1024 * 1024)
+
+/**
+ * The default size of the preallocated crash-time scratch arena, in bytes.
+ */
+#define PLCrashReporterDefaultCrashArenaSize (1 * 1024 * 1024)
+
+@interface PLCrashReporterConfig : NSObject <NSCopying> {
 @private
     /** The configured signal handler type. */
     PLCrashReporterSignalHandlerType _signalHandlerType;
@@ -152,6 +274,105 @@ typedef NS_OPTIONS(NSUInteger, PLCrashReporterSymbolicationStrategy) {
     * Xamarin environment.
     */
   BOOL _shouldRegisterUncaughtExceptionHandler;
+
+    /** The configured crash report output buffer size, in bytes. */
+    NSUInteger _outputBufferSize;
+
+    /** Flag indicating if crash reports should be compressed when written. */
+    BOOL _shouldCompressReports;
+
+    /** The maximum memory to be used for symbol indexes, in bytes. */
+    NSUInteger _symbolIndexMemoryLimit;
+
+    /** Flag indicating if symbol names should be written to a report-level name table. */
+    BOOL _shouldUseSymbolNameTable;
+
+    /** The size of the preallocated crash-time scratch arena, in bytes. */
+    NSUInteger _crashArenaSize;
+
+    /** Flag indicating if only the binary images referenced by the report's frames should be written. */
+    BOOL _shouldWriteReferencedImagesOnly;
+
+    /** Flag indicating if live reports should resume threads before symbolicating and writing the report. */
+    BOOL _shouldSnapshotLiveReportThreads;
+
+    /** If YES, crash reports capture raw thread state and stack memory, deferring unwinding and symbolication. */
+    BOOL _shouldDeferCrashUnwinding;
+
+    /** Maximum number of threads written to crash reports, or 0 for no limit. */
+    NSUInteger _maxCrashThreadCount;
+
+    /** Maximum number of frames walked per thread, or 0 for the default limit. */
+    NSUInteger _maxCrashFramesPerThread;
+
+    /** Maximum number of symbolicated frames per crash report, or 0 for no limit. */
+    NSUInteger _maxCrashSymbolicatedFrameCount;
+
+    /** Crash report time budget, in seconds, or 0 for no limit. */
+    NSTimeInterval _crashReportTimeLimit;
+
+    /** If YES, the crashed and main threads are written and flushed ahead of all other threads. */
+    BOOL _shouldPrioritizeCrashedThread;
+
+    /** Maximum number of frames walked per non-crashed, non-main thread, or 0 for no additional limit. */
+    NSUInteger _maxCrashFramesPerOtherThread;
+
+    /** Number of crash reports retained in the bounded report queue, or 0 if the queue is disabled. */
+    NSUInteger _reportQueueCapacity;
+
+    /** If true, the Mach exception server thread runs at an elevated priority. */
+    BOOL _shouldUseHighPriorityMachExceptionServer;
+
+    /** Flag indicating if threads should be written using the packed thread encoding. */
+    BOOL _shouldUsePackedThreadEncoding;
+
+    /** The number of bytes of stack memory written with the crashed thread, or 0 to disable stack memory capture. */
+    NSUInteger _stackMemoryCaptureSize;
+
+    /** Flag indicating if stack memory should be written for all threads, rather than only the crashed thread. */
+    BOOL _shouldCaptureStackMemoryForAllThreads;
+
+    /** Flag indicating if live reports following the first should be written incrementally, against the first. */
+    BOOL _shouldWriteIncrementalLiveReports;
+
+    /** Flag indicating if registers should be written for all threads, using the compact register encoding. */
+    BOOL _shouldWriteRegistersForAllThreads;
+
+    /** The Mach bootstrap service name of the out-of-process crash reporting helper, or nil. */
+    NSString *_helperServiceName;
+
+    /** Image paths to which crash-time symbolication is limited, or nil to symbolicate all images. */
+    NSArray *_symbolicationImagePaths;
+
+    /** If true, crashes that repeat the pending report's crash are counted in its summary, rather than written. */
+    BOOL _shouldCollapseRepeatedCrashes;
+
+    /** The per-thread metadata to be captured in crash reports. */
+    PLCrashReporterThreadMetadata _threadMetadata;
+
+    /** Flag indicating if the process' memory statistics should be written to crash reports. */
+    BOOL _shouldCaptureMemoryStatistics;
+
+    /** Flag indicating if symbolication diagnostics should be written to crash reports. */
+    BOOL _shouldWriteSymbolicationDiagnostics;
+
+    /** Flag indicating if the report writer's own crash path timing should be written to crash reports. */
+    BOOL _shouldWriteWriterDiagnostics;
+
+    /** Crash path pre-warming options. */
+    PLCrashReporterPrewarm _crashPathPrewarming;
+
+    /** The threads to which the symbolication strategy is applied at crash time. */
+    PLCrashReporterSymbolicatedThreads _symbolicatedThreads;
+
+    /** The number of threads with the highest CPU time to be symbolicated. */
+    NSUInteger _symbolicatedHotThreadCount;
+
+    /** The name prefixes of the threads to be symbolicated. */
+    NSArray * _symbolicatedThreadNames;
+
+    /** The minimum interval between the captures of scheduled live reports, in seconds. */
+    NSTimeInterval _minimumLiveReportInterval;
 }
 
 + (instancetype) defaultConfiguration;
@@ -174,5 +395,267 @@ typedef NS_OPTIONS(NSUInteger, PLCrashReporterSymbolicationStrategy) {
 /** Should PLCrashReporter regiser an uncaught exception handler? This is entended to be used in Xamarin apps */
 @property(nonatomic, readonly) BOOL shouldRegisterUncaughtExceptionHandler;
 
+/**
+ * The size, in bytes, of the buffer used when writing crash reports to disk. Larger buffers reduce the number
+ * of write(2) calls issued at crash time. The buffer is statically reserved; values larger than
+ * PLCrashReporterMaximumOutputBufferSize will be clamped. Defaults to PLCrashReporterDefaultOutputBufferSize.
+ */
+@property(nonatomic) NSUInteger outputBufferSize;
+
+/**
+ * If YES, crash reports will be LZ-compressed as they are written, reducing their on-disk and upload size.
+ * Compressed reports use the #PLCRASH_REPORT_FILE_VERSION_COMPRESSED file format, and are transparently
+ * decoded by PLCrashReport.
+ */
+@property(nonatomic) BOOL shouldCompressReports;
+
+/**
+ * The maximum number of bytes to be allocated for address-sorted symbol indexes. When symbol table symbolication
+ * is enabled, indexes are built on a low-priority background queue as images are loaded, reducing the cost of
+ * symbol lookups at crash time. Images that do not fit within the limit are symbolicated by scanning their
+ * symbol tables. A value of 0 disables background indexing. Defaults to PLCrashReporterDefaultSymbolIndexMemoryLimit.
+ */
+@property(nonatomic) NSUInteger symbolIndexMemoryLimit;
+
+/**
+ * If YES, each unique symbol name is written once to a report-level table, and frames refer to their symbol
+ * names by index. This reduces the size of symbolicated reports, but the resulting reports can not be decoded
+ * by PLCrashReport implementations that predate the symbol name table.
+ */
+@property(nonatomic) BOOL shouldUseSymbolNameTable;
+
+/**
+ * The size, in bytes, of the scratch arena reserved when the crash reporter is enabled. Caches and tables
+ * allocated while writing a crash report are served from the arena's prefaulted pages, avoiding VM allocation
+ * at crash time; allocations that do not fit fall back on the VM allocator. A value of 0 disables the arena.
+ * Defaults to PLCrashReporterDefaultCrashArenaSize.
+ */
+@property(nonatomic) NSUInteger crashArenaSize;
+
+/**
+ * If YES, only the binary images that contain a captured frame's instruction pointer are written to crash
+ * reports. All other loaded images are summarized by PLCrashReport.omittedImageCount and
+ * PLCrashReport.omittedImageHash, substantially reducing the size of reports from processes with many loaded
+ * images. Addresses that do not fall within a captured frame can not be attributed to an omitted image.
+ */
+@property(nonatomic) BOOL shouldWriteReferencedImagesOnly;
+
+/**
+ * If YES, live reports suspend the process' threads only while their stacks are walked. The threads are resumed
+ * before symbolication and serialization, reducing the time the process is frozen when live reports are taken
+ * from a running application (eg, by a hang detector). As the process continues running while the report is
+ * written, images loaded or unloaded during that time may be reported inconsistently. Crash reports are not
+ * affected.
+ */
+@property(nonatomic) BOOL shouldSnapshotLiveReportThreads;
+
+/**
+ * If YES, crash reports are written in raw capture mode: each thread's registers and a bounded copy of its stack
+ * memory are written along with all loaded binary images, and no stack walking or symbolication is performed in the
+ * crashed process. The threads' frames are recovered when the report is decoded by PLCrashReport, using the frame
+ * pointer chain found in the captured stack memory; the recovered frames are not symbolicated. Live reports are not
+ * affected.
+ */
+@property(nonatomic) BOOL shouldDeferCrashUnwinding;
+
+/**
+ * The maximum number of threads written to a crash report, or 0 if all threads should be written. The crashed
+ * thread is always written first; the remaining threads are written in order until the limit is reached.
+ */
+@property(nonatomic) NSUInteger maxCrashThreadCount;
+
+/**
+ * The maximum number of frames walked for each thread of a crash report, or 0 to use the writer's default limit of
+ * 512 frames. Values larger than the default limit will be clamped.
+ */
+@property(nonatomic) NSUInteger maxCrashFramesPerThread;
+
+/**
+ * The maximum number of frames symbolicated across all threads of a crash report, or 0 if all frames should be
+ * symbolicated. Frames beyond the limit are written with their instruction pointer only, and may be symbolicated
+ * once the report has been retrieved.
+ */
+@property(nonatomic) NSUInteger maxCrashSymbolicatedFrameCount;
+
+/**
+ * The time budget for writing a crash report, in seconds, or 0 for no limit. Once the deadline has passed, stack
+ * walking and symbolication stop: the thread being walked is truncated, further frames are written with their
+ * instruction pointer only, and any remaining threads are omitted. The binary images are always written, so that the
+ * report completes, and remains usable, shortly after the deadline.
+ */
+@property(nonatomic) NSTimeInterval crashReportTimeLimit;
+
+/**
+ * If YES, crash reports are written with the crashed thread prioritized: the signal is written ahead of all threads,
+ * the crashed thread is followed immediately by the main thread, and the report is flushed to disk once the crashed
+ * thread and its referenced images have been written. If the process is terminated while the remaining threads are
+ * being written, the truncated report can still be decoded, and PLCrashReport.truncated will be YES.
+ */
+@property(nonatomic) BOOL shouldPrioritizeCrashedThread;
+
+/**
+ * The maximum number of frames walked for each thread of a crash report other than the crashed and main threads, or
+ * 0 to apply only the maxCrashFramesPerThread limit. This bounds the time and space spent on idle worker threads
+ * without truncating the stacks that matter most.
+ */
+@property(nonatomic) NSUInteger maxCrashFramesPerOtherThread;
+
+/**
+ * The number of crash reports retained in the bounded report queue, or 0 if the queue is disabled. When enabled,
+ * each crash report is also added to the queue as it is written; once the queue is full, the oldest queued report is
+ * replaced. Queued reports are retrieved and removed in batches with PLCrashReporter::loadQueuedCrashReportDataAndReturnError:
+ * and PLCrashReporter::purgeQueuedCrashReports:error:, independently of the pending crash report. Values larger
+ * than PLCrashReporterMaximumReportQueueCapacity will be clamped.
+ */
+@property(nonatomic) NSUInteger reportQueueCapacity;
+
+/**
+ * If YES, the Mach exception server thread runs at the highest available quality of service (user-interactive,
+ * where supported), minimizing the delay between an exception being raised and the crash report being captured while
+ * other threads continue to run. Only applies when using PLCrashReporterSignalHandlerTypeMach. Defaults to YES.
+ */
+@property(nonatomic) BOOL shouldUseHighPriorityMachExceptionServer;
+
+/**
+ * If YES, each thread's frames and registers are written as packed arrays, with frame symbol and register names
+ * written to the report-level symbol name table; this implies shouldUseSymbolNameTable. This reduces the size
+ * and write time of reports, but the resulting reports can not be decoded by PLCrashReport implementations that
+ * predate the packed thread encoding.
+ */
+@property(nonatomic) BOOL shouldUsePackedThreadEncoding;
+
+/**
+ * The number of bytes of stack memory, starting at the stack pointer, written with the crashed thread (and, if
+ * shouldCaptureStackMemoryForAllThreads is YES, all other threads). The captured memory allows the threads to be
+ * unwound again when the report is processed, including where unwinding failed on the device. The total stack
+ * memory written to a single report is bounded. If 0, stack memory is only written for reports using deferred
+ * unwinding.
+ *
+ * Stack memory is not captured for live reports that resume their threads before output.
+ */
+@property(nonatomic) NSUInteger stackMemoryCaptureSize;
+
+/**
+ * If YES, and stackMemoryCaptureSize is non-zero, stack memory is written for all threads, rather than only the
+ * crashed thread.
+ */
+@property(nonatomic) BOOL shouldCaptureStackMemoryForAllThreads;
+
+/**
+ * If YES, the first live report is written in full, and becomes the base report of all subsequent live reports.
+ * Each subsequent live report refers to the base report by UUID, and includes only the crashed thread, the threads
+ * whose stacks have changed since the base report, and the binary images loaded since the base report. Use
+ * PLCrashReport::initWithData:baseReport:error: to decode an incremental report, and
+ * PLCrashReporter::resetLiveReportBase to begin a new base report. Crash reports are not affected.
+ */
+@property(nonatomic) BOOL shouldWriteIncrementalLiveReports;
+
+/**
+ * If YES, the registers of every thread are written to crash reports, rather than only those of the crashed thread.
+ * To bound the size cost, registers are written as a single packed array of values in canonical register order,
+ * without register names; the names are restored from the report's architecture when the report is decoded.
+ * This may be used to diagnose deadlocks, where the state of threads other than the crashed thread is of interest.
+ */
+@property(nonatomic) BOOL shouldWriteRegistersForAllThreads;
+
+/**
+ * The Mach bootstrap service name of an out-of-process crash reporting helper (see PLCrashHelperServer), or nil.
+ *
+ * If non-nil, and the Mach signal handler type is used, crash reports are written by the helper process rather than
+ * by the crashing process. The crashing process registers its task port with the helper once, when the reporter is
+ * enabled; on a crash, the crashing thread only blocks on the exception reply while the helper captures the report.
+ * This is only supported on Mac OS X.
+ */
+@property(nonatomic, copy) NSString *helperServiceName;
+
+/**
+ * The paths of the images to be symbolicated at crash time, or nil if all images are symbolicated. An image is
+ * symbolicated if its path is equal to, or is contained within, one of these paths. Limiting symbolication to the
+ * application's own images bounds the crash-time cost of symbolication; frames in other images are written with
+ * their PCs only, and may be symbolicated after the report is retrieved.
+ */
+@property(nonatomic, copy) NSArray *symbolicationImagePaths;
+
+/**
+ * If YES, a crash that repeats the crash recorded by the pending crash report is counted in the pending report's
+ * summary, rather than written as a new report. Before writing a report, the crash reporter walks only the top frames
+ * of the crashed thread, and compares their signature, the signal, and the uncaught exception name against the
+ * pending report's summary; if all match, only the summary's occurrence count and timestamp are updated
+ * (see PLCrashReportSummary.occurrenceCount). This bounds the cost of an application that crashes repeatedly at
+ * launch, before its pending report can be processed.
+ *
+ * This requires that the pending report's summary be available, and is ignored for reports written by an
+ * out-of-process crash reporting helper.
+ */
+@property(nonatomic) BOOL shouldCollapseRepeatedCrashes;
+
+/**
+ * The per-thread metadata captured in crash reports, in addition to each thread's backtrace (see
+ * PLCrashReporterThreadMetadata). Thread identifiers are always written when any metadata is enabled.
+ * Defaults to PLCrashReporterThreadMetadataNone.
+ */
+@property(nonatomic) PLCrashReporterThreadMetadata threadMetadata;
+
+/**
+ * If YES, crash reports include a snapshot of the process' memory statistics: the physical footprint, resident and
+ * compressed sizes, and VM region count, along with the largest VM regions found by a bounded walk of the address
+ * space (see PLCrashReportMemoryStatistics). This may be used to identify crashes caused by memory pressure. The
+ * statistics are fetched with a single task_info() call, plus one call per region walked.
+ */
+@property(nonatomic) BOOL shouldCaptureMemoryStatistics;
+
+/**
+ * If YES, crash reports include the symbol look-up statistics gathered during local symbolication
+ * (see PLCrashReportSymbolicationDiagnostics). This is intended for diagnosing the cost of the configured
+ * symbolication strategy, and has no effect unless a local symbolication strategy is enabled. Defaults to NO.
+ */
+@property(nonatomic) BOOL shouldWriteSymbolicationDiagnostics;
+
+/**
+ * If YES, crash reports include the crash path timing of the report writer (see PLCrashReportWriterDiagnostics):
+ * the time spent suspending threads, walking and symbolicating each thread, and writing binary images. This is
+ * intended for diagnosing the cost of the crash reporter's configuration, and adds a second report info record to
+ * each report. Defaults to NO.
+ */
+@property(nonatomic) BOOL shouldWriteWriterDiagnostics;
+
+/**
+ * The options controlling pre-warming of the crash path's code and memory when the crash reporter is enabled.
+ *
+ * @sa PLCrashReporterPrewarm
+ */
+@property(nonatomic) PLCrashReporterPrewarm crashPathPrewarming;
+
+/**
+ * The threads to which the configured symbolicationStrategy is applied at crash time (see
+ * PLCrashReporterSymbolicatedThreads). Frames of all other threads are written with their PCs only, and may be
+ * symbolicated after the report is retrieved; the crash-time cost of symbolication then scales with the number of
+ * selected threads, rather than the total thread count. Defaults to PLCrashReporterSymbolicatedThreadsAll.
+ */
+@property(nonatomic) PLCrashReporterSymbolicatedThreads symbolicatedThreads;
+
+/**
+ * The number of threads with the highest CPU time to be symbolicated, if PLCrashReporterSymbolicatedThreadsHot is
+ * selected. CPU times are fetched with a THREAD_BASIC_INFO thread_info() call per thread. Values larger than
+ * PLCrashReporterMaximumSymbolicatedHotThreadCount are clamped.
+ */
+@property(nonatomic) NSUInteger symbolicatedHotThreadCount;
+
+/**
+ * The name prefixes of the threads to be symbolicated, if PLCrashReporterSymbolicatedThreadsNamed is selected. A
+ * thread is selected if its pthread name begins with one of these strings. Thread names are fetched with a
+ * THREAD_EXTENDED_INFO thread_info() call per thread.
+ */
+@property(nonatomic, copy) NSArray * symbolicatedThreadNames;
+
+/**
+ * The minimum interval between the captures of live reports requested via
+ * PLCrashReporter::scheduleLiveReportWithThreadFilter:completionHandler:, in seconds. Requests arriving within the
+ * interval are deferred, and coalesced into a single capture, bounding the cost of a storm of requests to one capture
+ * per interval. Defaults to 0, in which case only requests that arrive before a pending capture has started are
+ * coalesced.
+ */
+@property(nonatomic) NSTimeInterval minimumLiveReportInterval;
+
 @end
 
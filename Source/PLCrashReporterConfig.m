@@ -31,13 +31,49 @@
 /**
  * Crash Reporter Configuration.
  *
- * Supports configuring the behavior of PLCrashReporter instances.
+ * Supports configuring the behavior of PLCrashReporter instances. The signal handler type, symbolication strategy,
+ * and uncaught exception handler registration are supplied at initialization; all other options default as
+ * documented, and may be set via their properties prior to initializing a PLCrashReporter with the configuration.
+ * The crash reporter copies its configuration, and is unaffected by later changes.
  */
 @implementation PLCrashReporterConfig
 
 @synthesize signalHandlerType = _signalHandlerType;
 @synthesize symbolicationStrategy = _symbolicationStrategy;
 @synthesize shouldRegisterUncaughtExceptionHandler = _shouldRegisterUncaughtExceptionHandler;
+@synthesize outputBufferSize = _outputBufferSize;
+@synthesize shouldCompressReports = _shouldCompressReports;
+@synthesize symbolIndexMemoryLimit = _symbolIndexMemoryLimit;
+@synthesize shouldUseSymbolNameTable = _shouldUseSymbolNameTable;
+@synthesize crashArenaSize = _crashArenaSize;
+@synthesize shouldWriteReferencedImagesOnly = _shouldWriteReferencedImagesOnly;
+@synthesize shouldSnapshotLiveReportThreads = _shouldSnapshotLiveReportThreads;
+@synthesize shouldDeferCrashUnwinding = _shouldDeferCrashUnwinding;
+@synthesize maxCrashThreadCount = _maxCrashThreadCount;
+@synthesize maxCrashFramesPerThread = _maxCrashFramesPerThread;
+@synthesize maxCrashSymbolicatedFrameCount = _maxCrashSymbolicatedFrameCount;
+@synthesize crashReportTimeLimit = _crashReportTimeLimit;
+@synthesize shouldPrioritizeCrashedThread = _shouldPrioritizeCrashedThread;
+@synthesize maxCrashFramesPerOtherThread = _maxCrashFramesPerOtherThread;
+@synthesize reportQueueCapacity = _reportQueueCapacity;
+@synthesize shouldUseHighPriorityMachExceptionServer = _shouldUseHighPriorityMachExceptionServer;
+@synthesize shouldUsePackedThreadEncoding = _shouldUsePackedThreadEncoding;
+@synthesize stackMemoryCaptureSize = _stackMemoryCaptureSize;
+@synthesize shouldCaptureStackMemoryForAllThreads = _shouldCaptureStackMemoryForAllThreads;
+@synthesize shouldWriteIncrementalLiveReports = _shouldWriteIncrementalLiveReports;
+@synthesize shouldWriteRegistersForAllThreads = _shouldWriteRegistersForAllThreads;
+@synthesize helperServiceName = _helperServiceName;
+@synthesize symbolicationImagePaths = _symbolicationImagePaths;
+@synthesize shouldCollapseRepeatedCrashes = _shouldCollapseRepeatedCrashes;
+@synthesize threadMetadata = _threadMetadata;
+@synthesize shouldCaptureMemoryStatistics = _shouldCaptureMemoryStatistics;
+@synthesize shouldWriteSymbolicationDiagnostics = _shouldWriteSymbolicationDiagnostics;
+@synthesize shouldWriteWriterDiagnostics = _shouldWriteWriterDiagnostics;
+@synthesize crashPathPrewarming = _crashPathPrewarming;
+@synthesize symbolicatedThreads = _symbolicatedThreads;
+@synthesize symbolicatedHotThreadCount = _symbolicatedHotThreadCount;
+@synthesize symbolicatedThreadNames = _symbolicatedThreadNames;
+@synthesize minimumLiveReportInterval = _minimumLiveReportInterval;
 
 /**
  * Return the default local configuration.
@@ -67,7 +103,7 @@
 }
 
 /**
- * Initialize a new PLCrashReporterConfig instance.
+ * Initialize a new PLCrashReporterConfig instance. All other options are set to their defaults.
  *
  * @param signalHandlerType The requested signal handler type.
  * @param symbolicationStrategy A local symbolication strategy.
@@ -83,8 +119,84 @@
   _signalHandlerType = signalHandlerType;
   _symbolicationStrategy = symbolicationStrategy;
   _shouldRegisterUncaughtExceptionHandler = shouldRegisterUncaughtExceptionHandler;
+  _outputBufferSize = PLCrashReporterDefaultOutputBufferSize;
+  _symbolIndexMemoryLimit = PLCrashReporterDefaultSymbolIndexMemoryLimit;
+  _crashArenaSize = PLCrashReporterDefaultCrashArenaSize;
+  _shouldUseHighPriorityMachExceptionServer = YES;
+  _threadMetadata = PLCrashReporterThreadMetadataNone;
+  _crashPathPrewarming = PLCrashReporterPrewarmNone;
+  _symbolicatedThreads = PLCrashReporterSymbolicatedThreadsAll;
   
   return self;
 }
 
+/**
+ * Return a copy of the receiver's options.
+ */
+- (id) copyWithZone: (NSZone *) zone {
+    PLCrashReporterConfig *copy = [[[self class] allocWithZone: zone] initWithSignalHandlerType: _signalHandlerType
+                                                                          symbolicationStrategy: _symbolicationStrategy
+                                                         shouldRegisterUncaughtExceptionHandler: _shouldRegisterUncaughtExceptionHandler];
+    if (copy == nil)
+        return nil;
+
+    copy->_outputBufferSize = _outputBufferSize;
+    copy->_shouldCompressReports = _shouldCompressReports;
+    copy->_symbolIndexMemoryLimit = _symbolIndexMemoryLimit;
+    copy->_shouldUseSymbolNameTable = _shouldUseSymbolNameTable;
+    copy->_crashArenaSize = _crashArenaSize;
+    copy->_shouldWriteReferencedImagesOnly = _shouldWriteReferencedImagesOnly;
+    copy->_shouldSnapshotLiveReportThreads = _shouldSnapshotLiveReportThreads;
+    copy->_shouldDeferCrashUnwinding = _shouldDeferCrashUnwinding;
+    copy->_maxCrashThreadCount = _maxCrashThreadCount;
+    copy->_maxCrashFramesPerThread = _maxCrashFramesPerThread;
+    copy->_maxCrashSymbolicatedFrameCount = _maxCrashSymbolicatedFrameCount;
+    copy->_crashReportTimeLimit = _crashReportTimeLimit;
+    copy->_shouldPrioritizeCrashedThread = _shouldPrioritizeCrashedThread;
+    copy->_maxCrashFramesPerOtherThread = _maxCrashFramesPerOtherThread;
+    copy->_reportQueueCapacity = _reportQueueCapacity;
+    copy->_shouldUseHighPriorityMachExceptionServer = _shouldUseHighPriorityMachExceptionServer;
+    copy->_shouldUsePackedThreadEncoding = _shouldUsePackedThreadEncoding;
+    copy->_stackMemoryCaptureSize = _stackMemoryCaptureSize;
+    copy->_shouldCaptureStackMemoryForAllThreads = _shouldCaptureStackMemoryForAllThreads;
+    copy->_shouldWriteIncrementalLiveReports = _shouldWriteIncrementalLiveReports;
+    copy->_shouldWriteRegistersForAllThreads = _shouldWriteRegistersForAllThreads;
+    copy->_helperServiceName = [_helperServiceName copy];
+    copy->_symbolicationImagePaths = [_symbolicationImagePaths copy];
+    copy->_shouldCollapseRepeatedCrashes = _shouldCollapseRepeatedCrashes;
+    copy->_threadMetadata = _threadMetadata;
+    copy->_shouldCaptureMemoryStatistics = _shouldCaptureMemoryStatistics;
+    copy->_shouldWriteSymbolicationDiagnostics = _shouldWriteSymbolicationDiagnostics;
+    copy->_shouldWriteWriterDiagnostics = _shouldWriteWriterDiagnostics;
+    copy->_crashPathPrewarming = _crashPathPrewarming;
+    copy->_symbolicatedThreads = _symbolicatedThreads;
+    copy->_symbolicatedHotThreadCount = _symbolicatedHotThreadCount;
+    copy->_symbolicatedThreadNames = [_symbolicatedThreadNames copy];
+    copy->_minimumLiveReportInterval = _minimumLiveReportInterval;
+
+    return copy;
+}
+
+/* Values larger than PLCrashReporterMaximumOutputBufferSize are clamped */
+- (void) setOutputBufferSize: (NSUInteger) outputBufferSize {
+    _outputBufferSize = MIN(outputBufferSize, (NSUInteger) PLCrashReporterMaximumOutputBufferSize);
+}
+
+/* Values larger than PLCrashReporterMaximumReportQueueCapacity are clamped */
+- (void) setReportQueueCapacity: (NSUInteger) reportQueueCapacity {
+    _reportQueueCapacity = MIN(reportQueueCapacity, (NSUInteger) PLCrashReporterMaximumReportQueueCapacity);
+}
+
+/* Values larger than PLCrashReporterMaximumSymbolicatedHotThreadCount are clamped */
+- (void) setSymbolicatedHotThreadCount: (NSUInteger) symbolicatedHotThreadCount {
+    _symbolicatedHotThreadCount = MIN(symbolicatedHotThreadCount, (NSUInteger) PLCrashReporterMaximumSymbolicatedHotThreadCount);
+}
+
+- (void) dealloc {
+    [_helperServiceName release];
+    [_symbolicationImagePaths release];
+    [_symbolicatedThreadNames release];
+    [super dealloc];
+}
+
 @end
@@ -0,0 +1,101 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/**
+ * Timing of the phases of PLCrashReporter::enableCrashReporterAndReturnError:.
+ *
+ * Durations are measured in seconds. An instance is available via PLCrashReporter::startupMetrics once the
+ * crash reporter has been enabled, and may be used to enforce startup budgets.
+ */
+@interface PLCrashReporterStartupMetrics : NSObject {
+@private
+    /** Duration of dyld image monitoring registration. */
+    NSTimeInterval _imageMonitoringDuration;
+
+    /** Duration of crash report directory creation. */
+    NSTimeInterval _directoryCreationDuration;
+
+    /** Duration of deferred image registration. */
+    NSTimeInterval _imageRegistrationDuration;
+
+    /** Duration of crash-time resource preparation. */
+    NSTimeInterval _preparationDuration;
+
+    /** Duration of crash handler registration. */
+    NSTimeInterval _handlerRegistrationDuration;
+
+    /** Total duration of enabling the crash reporter. */
+    NSTimeInterval _totalDuration;
+
+    /** Number of registered images. */
+    NSUInteger _imageCount;
+
+    /** Number of parsed images. */
+    NSUInteger _parsedImageCount;
+}
+
+- (instancetype) initWithImageMonitoringDuration: (NSTimeInterval) imageMonitoringDuration
+                       directoryCreationDuration: (NSTimeInterval) directoryCreationDuration
+                       imageRegistrationDuration: (NSTimeInterval) imageRegistrationDuration
+                             preparationDuration: (NSTimeInterval) preparationDuration
+                     handlerRegistrationDuration: (NSTimeInterval) handlerRegistrationDuration
+                                   totalDuration: (NSTimeInterval) totalDuration
+                                      imageCount: (NSUInteger) imageCount
+                                parsedImageCount: (NSUInteger) parsedImageCount;
+
+/**
+ * Time spent registering for dyld image notifications when the PLCrashReporter class was initialized,
+ * including the notifications delivered for all images loaded at the time of registration. This is not included
+ * in @a totalDuration.
+ */
+@property(nonatomic, readonly) NSTimeInterval imageMonitoringDuration;
+
+/** Time spent creating the crash report directory. */
+@property(nonatomic, readonly) NSTimeInterval directoryCreationDuration;
+
+/** Time spent registering images whose registration was deferred. */
+@property(nonatomic, readonly) NSTimeInterval imageRegistrationDuration;
+
+/** Time spent initializing the report writer, crash arena, and preallocated report file. */
+@property(nonatomic, readonly) NSTimeInterval preparationDuration;
+
+/** Time spent registering signal handlers, the Mach exception server, and the uncaught exception handler. */
+@property(nonatomic, readonly) NSTimeInterval handlerRegistrationDuration;
+
+/** Total time spent enabling the crash reporter. */
+@property(nonatomic, readonly) NSTimeInterval totalDuration;
+
+/** The number of images registered once the crash reporter was enabled. */
+@property(nonatomic, readonly) NSUInteger imageCount;
+
+/** The number of registered images that had been parsed once the crash reporter was enabled. */
+@property(nonatomic, readonly) NSUInteger parsedImageCount;
+
+@end
@@ -0,0 +1,90 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashReporterStartupMetrics.h"
+
+/**
+ * Crash Reporter Startup Metrics.
+ *
+ * Reports the cost of enabling a PLCrashReporter instance.
+ */
+@implementation PLCrashReporterStartupMetrics
+
+@synthesize imageMonitoringDuration = _imageMonitoringDuration;
+@synthesize directoryCreationDuration = _directoryCreationDuration;
+@synthesize imageRegistrationDuration = _imageRegistrationDuration;
+@synthesize preparationDuration = _preparationDuration;
+@synthesize handlerRegistrationDuration = _handlerRegistrationDuration;
+@synthesize totalDuration = _totalDuration;
+@synthesize imageCount = _imageCount;
+@synthesize parsedImageCount = _parsedImageCount;
+
+/**
+ * Initialize a new PLCrashReporterStartupMetrics instance.
+ *
+ * @param imageMonitoringDuration Time spent registering for dyld image notifications.
+ * @param directoryCreationDuration Time spent creating the crash report directory.
+ * @param imageRegistrationDuration Time spent registering deferred images.
+ * @param preparationDuration Time spent preparing crash-time resources.
+ * @param handlerRegistrationDuration Time spent registering crash handlers.
+ * @param totalDuration Total time spent enabling the crash reporter.
+ * @param imageCount The number of registered images.
+ * @param parsedImageCount The number of parsed images.
+ */
+- (instancetype) initWithImageMonitoringDuration: (NSTimeInterval) imageMonitoringDuration
+                       directoryCreationDuration: (NSTimeInterval) directoryCreationDuration
+                       imageRegistrationDuration: (NSTimeInterval) imageRegistrationDuration
+                             preparationDuration: (NSTimeInterval) preparationDuration
+                     handlerRegistrationDuration: (NSTimeInterval) handlerRegistrationDuration
+                                   totalDuration: (NSTimeInterval) totalDuration
+                                      imageCount: (NSUInteger) imageCount
+                                parsedImageCount: (NSUInteger) parsedImageCount
+{
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _imageMonitoringDuration = imageMonitoringDuration;
+    _directoryCreationDuration = directoryCreationDuration;
+    _imageRegistrationDuration = imageRegistrationDuration;
+    _preparationDuration = preparationDuration;
+    _handlerRegistrationDuration = handlerRegistrationDuration;
+    _totalDuration = totalDuration;
+    _imageCount = imageCount;
+    _parsedImageCount = parsedImageCount;
+
+    return self;
+}
+
+/* Describe the metrics, for logging by CI */
+- (NSString *) description {
+    return [NSString stringWithFormat: @"<%@: monitoring=%.6fs directory=%.6fs registration=%.6fs preparation=%.6fs handlers=%.6fs total=%.6fs images=%lu parsed=%lu>",
+            [self class], _imageMonitoringDuration, _directoryCreationDuration, _imageRegistrationDuration, _preparationDuration,
+            _handlerRegistrationDuration, _totalDuration, (unsigned long) _imageCount, (unsigned long) _parsedImageCount];
+}
+
+@end
@@ -89,4 +89,60 @@
     STAssertEqualStrings([[report signalInfo] code], @"TRAP_TRACE", @"Incorrect signal code");
 }
 
+/**
+ * Options are set via the configuration's properties; the reporter must copy its configuration, such that later
+ * changes do not affect it.
+ */
+- (void) testConfigurationProperties {
+    PLCrashReporterConfig *config = [PLCrashReporterConfig defaultConfiguration];
+    STAssertEquals((NSUInteger) PLCrashReporterDefaultOutputBufferSize, config.outputBufferSize, @"Incorrect default");
+    STAssertTrue(config.shouldUseHighPriorityMachExceptionServer, @"Incorrect default");
+    STAssertEquals(PLCrashReporterSymbolicatedThreadsAll, config.symbolicatedThreads, @"Incorrect default");
+
+    /* Out-of-range values are clamped */
+    config.outputBufferSize = PLCrashReporterMaximumOutputBufferSize * 2;
+    STAssertEquals((NSUInteger) PLCrashReporterMaximumOutputBufferSize, config.outputBufferSize, @"Value was not clamped");
+
+    config.shouldCompressReports = YES;
+    config.symbolicationImagePaths = [NSArray arrayWithObject: [[NSBundle mainBundle] bundlePath]];
+
+    PLCrashReporterConfig *copy = [[config copy] autorelease];
+    STAssertTrue(copy.shouldCompressReports, @"Option was not copied");
+    STAssertEqualObjects(config.symbolicationImagePaths, copy.symbolicationImagePaths, @"Option was not copied");
+    STAssertEquals(config.outputBufferSize, copy.outputBufferSize, @"Option was not copied");
+
+    config.shouldCompressReports = NO;
+    STAssertTrue(copy.shouldCompressReports, @"Copy was modified by a change to the original");
+}
+
+/**
+ * Releasing the reporter with a scheduled live report pending must either complete or cancel the request, and must
+ * not leave a capture that references the deallocated reporter.
+ */
+- (void) testReleaseWithScheduledLiveReport {
+    dispatch_semaphore_t done = dispatch_semaphore_create(0);
+    __block NSUInteger completed = 0;
+    __block NSUInteger cancelled = 0;
+
+    PLCrashReporter *reporter = [[PLCrashReporter alloc] initWithConfiguration: [PLCrashReporterConfig defaultConfiguration]];
+    for (NSUInteger i = 0; i < 2; i++) {
+        [reporter scheduleLiveReportWithThreadFilter: nil completionHandler: ^(NSData *reportData, NSArray *threads, NSError *error) {
+            @synchronized (self) {
+                if (reportData != nil)
+                    completed++;
+                else
+                    cancelled++;
+            }
+            dispatch_semaphore_signal(done);
+        }];
+    }
+    [reporter release];
+
+    for (NSUInteger i = 0; i < 2; i++)
+        STAssertTrue(dispatch_semaphore_wait(done, dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_SEC)) == 0, @"A completion handler was not invoked");
+    STAssertEquals((NSUInteger) 2, completed + cancelled, @"Incorrect handler count");
+
+    dispatch_release(done);
+}
+
 @end
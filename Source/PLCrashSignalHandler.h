@@ -48,8 +48,53 @@ typedef struct PLCrashSignalHandlerCallback PLCrashSignalHandlerCallback;
  */
 typedef bool (*PLCrashSignalHandlerCallbackFunc)(int signo, siginfo_t *info, ucontext_t *uap, void *context, PLCrashSignalHandlerCallback *next);
 
+/**
+ * @internal
+ * Signal handler pre-filter function. Filters are executed before any registered callbacks, and may be used to
+ * cheaply claim expected faults (eg, faults within JIT or guard regions) without entering the crash handling path.
+ *
+ * @param signo The received signal.
+ * @param info The signal info. The fault address, if any, is available via info->si_addr.
+ * @param uap The signal thread context.
+ * @param context The previously specified context for this filter.
+ *
+ * @return Return true if the signal was handled and execution should continue, false if the signal should be
+ * passed to the next filter, and then to the registered callbacks.
+ *
+ * @warning Filters execute within the signal handler, and must be async-safe.
+ */
+typedef bool (*PLCrashSignalHandlerFilterFunc)(int signo, siginfo_t *info, ucontext_t *uap, void *context);
+
+/**
+ * @internal
+ * A single address range, used by plcrash_signal_address_table_t.
+ */
+typedef struct plcrash_signal_address_range {
+    /** The base address of the range. */
+    uintptr_t base;
+
+    /** The length of the range, in bytes. */
+    size_t length;
+} plcrash_signal_address_range_t;
+
+/**
+ * @internal
+ * A sorted, immutable table of non-overlapping address ranges that may be searched from a signal handler.
+ */
+typedef struct plcrash_signal_address_table {
+    /** The ranges, sorted by base address. */
+    plcrash_signal_address_range_t *ranges;
+
+    /** The number of entries in @a ranges. */
+    size_t count;
+} plcrash_signal_address_table_t;
+
 void plcrash_signal_handler (int signo, siginfo_t *info, void *uapVoid);
 
+void plcrash_signal_address_table_init (plcrash_signal_address_table_t *table, plcrash_signal_address_range_t *ranges, size_t count);
+bool plcrash_signal_address_table_contains (const plcrash_signal_address_table_t *table, uintptr_t address);
+bool plcrash_signal_address_table_filter (int signo, siginfo_t *info, ucontext_t *uap, void *context);
+
 bool PLCrashSignalHandlerForward (PLCrashSignalHandlerCallback *next, int signal, siginfo_t *info, ucontext_t *uap);
 
 @interface PLCrashSignalHandler : NSObject {
@@ -68,6 +113,13 @@ bool PLCrashSignalHandlerForward (PLCrashSignalHandlerCallback *next, int signal
                           context: (void *) context
                             error: (NSError **) outError;
 
+- (BOOL) registerFilterForSignal: (int) signo
+                          filter: (PLCrashSignalHandlerFilterFunc) filter
+                         context: (void *) context
+                           error: (NSError **) outError;
+
+- (void) prefaultSignalStack: (BOOL) lock;
+
 @end
 
 PLCR_C_END_DECLS
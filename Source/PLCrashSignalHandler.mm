@@ -32,12 +32,24 @@
 #import "PLCrashFrameWalker.h"
 #import "PLCrashReporterNSError.h"
 
-#import "PLCrashAsyncLinkedList.hpp"
-
 #import <signal.h>
 #import <unistd.h>
+#import <libkern/OSAtomic.h>
 
-using namespace plcrash::async;
+/**
+ * @internal
+ *
+ * Maximum number of callbacks that may be registered for a single signal, including the pass-through callback
+ * that executes the signal's previously registered action.
+ */
+#define PLCRASH_SIGNAL_HANDLER_MAX_CALLBACKS 8
+
+/**
+ * @internal
+ *
+ * Maximum number of pre-filters that may be registered for a single signal.
+ */
+#define PLCRASH_SIGNAL_HANDLER_MAX_FILTERS 4
 
 /**
  * @internal
@@ -52,6 +64,19 @@ struct plcrash_signal_user_callback {
     void *context;
 };
 
+/**
+ * @internal
+ *
+ * Manages the internal state for a user-registered pre-filter and context.
+ */
+struct plcrash_signal_user_filter {
+    /** Signal handler pre-filter function. */
+    PLCrashSignalHandlerFilterFunc filter;
+
+    /** Pre-filter context. */
+    void *context;
+};
+
 /**
  * @internal
  *
@@ -72,16 +97,30 @@ struct PLCrashSignalHandlerCallback {
 /**
  * @internal
  *
- * A registered POSIX signal handler action. This is used to represent previously
- * registered signal handlers that have been replaced by the PLCrashSignalHandler's
- * global signal handler.
+ * The registered callbacks and previously registered POSIX signal handler action of a single signal. Entries are
+ * only ever appended, with the registration lock held; an entry is written before the count that publishes it is
+ * incremented, allowing the signal handler to walk the published entries without locking or pointer chasing.
  */
-struct plcrash_signal_handler_action {
-    /** Signal type. */
-    int signo;
-    
-    /** Signal handler action. */
-    struct sigaction action;
+struct plcrash_signal_slot {
+    /** Number of published entries in @a callbacks. */
+    volatile uint32_t callback_count;
+
+    /** Registered callbacks, in registration order. The first entry is the pass-through callback that executes
+     * @a previous_action, and is thus the last to be dispatched. */
+    plcrash_signal_user_callback callbacks[PLCRASH_SIGNAL_HANDLER_MAX_CALLBACKS];
+
+    /** Number of published entries in @a filters. */
+    volatile uint32_t filter_count;
+
+    /** Registered pre-filters, in registration order. Filters are dispatched in registration order, before any
+     * entry in @a callbacks. */
+    plcrash_signal_user_filter filters[PLCRASH_SIGNAL_HANDLER_MAX_FILTERS];
+
+    /** If true, @a previous_action has been saved, and the signal handler has been registered. */
+    volatile bool has_previous_action;
+
+    /** The signal handler action replaced by PLCrashSignalHandler's global signal handler. */
+    struct sigaction previous_action;
 };
 
 /**
@@ -90,98 +129,125 @@ struct plcrash_signal_handler_action {
  */
 static struct {
     /** @internal
-     * Registered callbacks. */
-    async_list<plcrash_signal_user_callback> callbacks;
-    
-    /** @internal
-     * Originaly registered signal handlers. This list should only be mutated in
-     * -[PLCrashSignalHandler registerHandlerWithSignal:error:] with the appropriate locks held. */
-    async_list<plcrash_signal_handler_action> previous_actions;
+     * Per-signal callbacks and previous actions, indexed by signal number. Entries should only be mutated with
+     * registration_lock held. */
+    plcrash_signal_slot slots[NSIG];
 } shared_handler_context;
 
+/** @internal
+ * Lock that must be held while registering signal handlers or callbacks. */
+static pthread_mutex_t registration_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Publish @a callback as the newest entry of @a slot. Must be called with registration_lock held. Returns false
+ * if the slot is full.
+ */
+static bool slot_append (plcrash_signal_slot *slot, plcrash_signal_user_callback callback) {
+    uint32_t count = slot->callback_count;
+    if (count == PLCRASH_SIGNAL_HANDLER_MAX_CALLBACKS)
+        return false;
+
+    /* The entry must be visible before the count that publishes it */
+    slot->callbacks[count] = callback;
+    OSMemoryBarrier();
+    slot->callback_count = count + 1;
+
+    return true;
+}
+
+/*
+ * Publish @a filter as the newest pre-filter of @a slot. Must be called with registration_lock held. Returns false
+ * if the slot's filters are full.
+ */
+static bool slot_append_filter (plcrash_signal_slot *slot, plcrash_signal_user_filter filter) {
+    uint32_t count = slot->filter_count;
+    if (count == PLCRASH_SIGNAL_HANDLER_MAX_FILTERS)
+        return false;
+
+    /* The entry must be visible before the count that publishes it */
+    slot->filters[count] = filter;
+    OSMemoryBarrier();
+    slot->filter_count = count + 1;
+
+    return true;
+}
+
 /*
- * Finds and executes the first matching signal handler in the shared previous_actions list; this is used
+ * Executes the previously registered signal handler action saved for @a signo, if any; this is used
  * to support executing process-wide POSIX signal handlers that were previously registered before being replaced by
  * PLCrashSignalHandler::registerHandlerForSignal:.
  */
 static bool previous_action_callback (int signo, siginfo_t *info, ucontext_t *uap, void *context, PLCrashSignalHandlerCallback *nextHandler) {
-    bool handled = false;
-
     /* Let any additional handler execute */
     if (PLCrashSignalHandlerForward(nextHandler, signo, info, uap))
         return true;
 
-    shared_handler_context.previous_actions.set_reading(true); {
-        /* Find the first matching handler */
-        async_list<plcrash_signal_handler_action>::node *next = NULL;
-        while ((next = shared_handler_context.previous_actions.next(next)) != NULL) {
-            /* Skip non-matching entries */
-            if (next->value().signo != signo)
-                continue;
-
-            /* Found a match */
-            // TODO - Should we handle the other flags, eg, SA_RESETHAND, SA_ONSTACK? */
-            if (next->value().action.sa_flags & SA_SIGINFO) {
-                next->value().action.sa_sigaction(signo, info, (void *) uap);
-                handled = true;
-            } else {
-                void (*next_handler)(int) = next->value().action.sa_handler;
-                if (next_handler == SIG_IGN) {
-                    /* Ignored */
-                    handled = true;
-
-                } else if (next_handler == SIG_DFL) {
-                    /* Default handler should be run, be we have no mechanism to pass through to
-                     * the default handler; mark the signal as unhandled. */
-                    handled = false;
-
-                } else {
-                    /* Handler registered, execute it */
-                    next_handler(signo);
-                    handled = true;
-                }
-            }
-            
-            /* Handler was found; iteration done */
-            break;
-        }
-    } shared_handler_context.previous_actions.set_reading(false);
+    if (signo <= 0 || signo >= NSIG)
+        return false;
+
+    plcrash_signal_slot *slot = &shared_handler_context.slots[signo];
+    if (!slot->has_previous_action)
+        return false;
+
+    OSMemoryBarrier();
+    const struct sigaction *action = &slot->previous_action;
+
+    // TODO - Should we handle the other flags, eg, SA_RESETHAND, SA_ONSTACK? */
+    if (action->sa_flags & SA_SIGINFO) {
+        action->sa_sigaction(signo, info, (void *) uap);
+        return true;
+    }
+
+    void (*next_handler)(int) = action->sa_handler;
+    if (next_handler == SIG_IGN) {
+        /* Ignored */
+        return true;
 
-    return handled;
+    } else if (next_handler == SIG_DFL) {
+        /* Default handler should be run, be we have no mechanism to pass through to
+         * the default handler; mark the signal as unhandled. */
+        return false;
+    }
+
+    /* Handler registered, execute it */
+    next_handler(signo);
+    return true;
 }
 
 /*
- * Recursively iterates the actual callbacks registered in our shared_handler_context. To begin iteration,
- * provide a value of NULL for 'context'.
+ * Iterates the callbacks registered for @a signo in our shared_handler_context, from the most recently registered to
+ * the first. To begin iteration, provide a value of NULL for 'context'; otherwise, 'context' is the number of
+ * callbacks that remain to be dispatched.
  */
 static bool internal_callback_iterator (int signo, siginfo_t *info, ucontext_t *uap, void *context) {
-    /* Call the next handler in the chain. If this is the last handler in the chain, pass it the original signal
-     * handlers. */
-    bool handled = false;
-    shared_handler_context.callbacks.set_reading(true); {
-        async_list<plcrash_signal_user_callback>::node *prev = (async_list<plcrash_signal_user_callback>::node *) context;
-        async_list<plcrash_signal_user_callback>::node *current = shared_handler_context.callbacks.next(prev);
-
-        /* Check for end-of-list */
-        if (current == NULL) {
-            shared_handler_context.callbacks.set_reading(false);
-            return false;
-        }
-        
-        /* Check if any additional handlers are registered. If so, provide the next handler as the forwarding target. */
-        if (shared_handler_context.callbacks.next(current) != NULL) {
-            PLCrashSignalHandlerCallback next_handler = {
-                .callback = internal_callback_iterator,
-                .context = current
-            };
-            handled = current->value().callback(signo, info, uap, current->value().context, &next_handler);
-        } else {
-            /* Otherwise, we've hit the final handler in the list. */
-            handled = current->value().callback(signo, info, uap, current->value().context, NULL);
-        }
-    } shared_handler_context.callbacks.set_reading(false);
+    if (signo <= 0 || signo >= NSIG)
+        return false;
+
+    /* Snapshot the published entries */
+    plcrash_signal_slot *slot = &shared_handler_context.slots[signo];
+    uint32_t remaining = slot->callback_count;
+    OSMemoryBarrier();
+
+    if (context != NULL)
+        remaining = MIN(remaining, (uint32_t) (uintptr_t) context);
+
+    /* Check for end-of-list */
+    if (remaining == 0)
+        return false;
+
+    /* Call the next handler in the chain. If additional handlers are registered, provide the next handler as the
+     * forwarding target. */
+    const plcrash_signal_user_callback *current = &slot->callbacks[remaining - 1];
+    if (remaining > 1) {
+        PLCrashSignalHandlerCallback next_handler = {
+            .callback = internal_callback_iterator,
+            .context = (void *) (uintptr_t) (remaining - 1)
+        };
+        return current->callback(signo, info, uap, current->context, &next_handler);
+    }
 
-    return handled;
+    /* Otherwise, we've hit the final handler in the list. */
+    return current->callback(signo, info, uap, current->context, NULL);
 };
 
 /** 
@@ -195,6 +261,19 @@ static bool internal_callback_iterator (int signo, siginfo_t *info, ucontext_t *
  * @param uapVoid A ucontext_t pointer argument.
  */
 void plcrash_signal_handler (int signo, siginfo_t *info, void *uapVoid) {
+    /* Give the pre-filters a chance to claim the signal before entering the crash handling path */
+    if (signo > 0 && signo < NSIG) {
+        plcrash_signal_slot *slot = &shared_handler_context.slots[signo];
+        uint32_t filter_count = slot->filter_count;
+        OSMemoryBarrier();
+
+        for (uint32_t i = 0; i < filter_count; i++) {
+            const plcrash_signal_user_filter *f = &slot->filters[i];
+            if (f->filter(signo, info, (ucontext_t *) uapVoid, f->context))
+                return;
+        }
+    }
+
     /* Start iteration; we currently re-raise the signal if not handled by callbacks; this should be revisited
      * in the future, as the signal may not be raised on the expected thread.
      */
@@ -223,6 +302,75 @@ bool PLCrashSignalHandlerForward (PLCrashSignalHandlerCallback *next, int sig, s
     return next->callback(sig, info, uap, next->context);
 }
 
+/* qsort() comparator for plcrash_signal_address_range_t */
+static int address_range_compare (const void *a, const void *b) {
+    uintptr_t lhs = ((const plcrash_signal_address_range_t *) a)->base;
+    uintptr_t rhs = ((const plcrash_signal_address_range_t *) b)->base;
+
+    if (lhs < rhs)
+        return -1;
+    else if (lhs > rhs)
+        return 1;
+    return 0;
+}
+
+/**
+ * Initialize @a table with the given @a ranges, sorting them in place by base address. The ranges must not overlap,
+ * and must not be modified while the table is in use.
+ *
+ * @param table The table to initialize.
+ * @param ranges The address ranges to be included in the table. The table borrows this array.
+ * @param count The number of entries in @a ranges.
+ *
+ * @warning This function is not async-safe, and must be called prior to registering the table with
+ * -[PLCrashSignalHandler registerFilterForSignal:filter:context:error:].
+ */
+void plcrash_signal_address_table_init (plcrash_signal_address_table_t *table, plcrash_signal_address_range_t *ranges, size_t count) {
+    qsort(ranges, count, sizeof(ranges[0]), address_range_compare);
+    table->ranges = ranges;
+    table->count = count;
+}
+
+/**
+ * Return true if @a address falls within any of the ranges in @a table.
+ *
+ * @param table The table to search.
+ * @param address The address to look up.
+ *
+ * @note This function is async-safe.
+ */
+bool plcrash_signal_address_table_contains (const plcrash_signal_address_table_t *table, uintptr_t address) {
+    /* Binary search for the last range with a base address <= address */
+    size_t lower = 0;
+    size_t upper = table->count;
+    while (lower < upper) {
+        size_t mid = lower + (upper - lower) / 2;
+        if (table->ranges[mid].base <= address)
+            lower = mid + 1;
+        else
+            upper = mid;
+    }
+
+    if (lower == 0)
+        return false;
+
+    const plcrash_signal_address_range_t *range = &table->ranges[lower - 1];
+    return address - range->base < range->length;
+}
+
+/**
+ * A pre-filter that claims any signal whose fault address falls within the plcrash_signal_address_table_t
+ * provided as @a context. Suitable for use with -[PLCrashSignalHandler registerFilterForSignal:filter:context:error:].
+ *
+ * @note This function is async-safe.
+ */
+bool plcrash_signal_address_table_filter (int signo, siginfo_t *info, ucontext_t *uap, void *context) {
+    if (info == NULL)
+        return false;
+
+    return plcrash_signal_address_table_contains((const plcrash_signal_address_table_t *) context, (uintptr_t) info->si_addr);
+}
+
 /***
  * @internal
  *
@@ -258,19 +406,15 @@ static PLCrashSignalHandler *sharedHandler;
  * and should be avoided in production code.
  */
 + (void) resetHandlers {
-    /* Reset all saved signal handlers */
-    shared_handler_context.previous_actions.set_reading(true); {
-        async_list<plcrash_signal_handler_action>::node *next = NULL;
-        while ((next = shared_handler_context.previous_actions.next(next)) != NULL)
-            shared_handler_context.previous_actions.nasync_remove_node(next);
-    } shared_handler_context.previous_actions.set_reading(false);
-
-    /* Reset all callbacks */
-    shared_handler_context.callbacks.set_reading(true); {
-        async_list<plcrash_signal_user_callback>::node *next = NULL;
-        while ((next = shared_handler_context.callbacks.next(next)) != NULL)
-            shared_handler_context.callbacks.nasync_remove_node(next);
-    } shared_handler_context.callbacks.set_reading(false);
+    pthread_mutex_lock(&registration_lock); {
+        /* Reset all callbacks and saved signal handlers */
+        for (int signo = 0; signo < NSIG; signo++) {
+            shared_handler_context.slots[signo].callback_count = 0;
+            shared_handler_context.slots[signo].filter_count = 0;
+            shared_handler_context.slots[signo].has_previous_action = false;
+        }
+        OSMemoryBarrier();
+    } pthread_mutex_unlock(&registration_lock);
 }
 
 /**
@@ -310,8 +454,14 @@ static PLCrashSignalHandler *sharedHandler;
  * registered. If no error occurs, this parameter will be left unmodified.
  */
 - (BOOL) registerHandlerWithSignal: (int) signo error: (NSError **) outError {
-    static pthread_mutex_t registerHandlers = PTHREAD_MUTEX_INITIALIZER;
-    pthread_mutex_lock(&registerHandlers); {
+    if (signo <= 0 || signo >= NSIG) {
+        plcrash_populate_posix_error(outError, EINVAL, @"Invalid signal number");
+        return NO;
+    }
+
+    plcrash_signal_slot *slot = &shared_handler_context.slots[signo];
+
+    pthread_mutex_lock(&registration_lock); {
         static BOOL singleShotInitialization = NO;
 
         /* Perform operations that only need to be done once per process.
@@ -331,34 +481,15 @@ static PLCrashSignalHandler *sharedHandler;
             if (sigaltstack(&_sigstk, 0) < 0) {
                 /* This should only fail if we supply invalid arguments to sigaltstack() */
                 plcrash_populate_posix_error(outError, errno, @"Could not initialize alternative signal stack");
+                pthread_mutex_unlock(&registration_lock);
                 return NO;
             }
 #endif
-            /*
-             * Add the pass-through sigaction callback as the last element in the callback list.
-             */
-            plcrash_signal_user_callback sa = {
-                .callback = previous_action_callback,
-                .context = NULL
-            };
-            shared_handler_context.callbacks.nasync_append(sa);
+            singleShotInitialization = YES;
         }
-        
-        /* Check whether the signal already has a registered handler. */
-        BOOL isRegistered = NO;
-        shared_handler_context.previous_actions.set_reading(true); {
-            /* Find the first matching handler */
-            async_list<plcrash_signal_handler_action>::node *next = NULL;
-            while ((next = shared_handler_context.previous_actions.next(next)) != NULL) {
-                if (next->value().signo == signo) {
-                    isRegistered = YES;
-                    break;
-                }
-            }
-        } shared_handler_context.previous_actions.set_reading(false);
 
-        /* Register handler for the requested signal */
-        if (!isRegistered) {
+        /* Register handler for the requested signal, if not already registered */
+        if (!slot->has_previous_action) {
             struct sigaction sa;
             struct sigaction sa_prev;
             
@@ -368,10 +499,23 @@ static PLCrashSignalHandler *sharedHandler;
             sigemptyset(&sa.sa_mask);
             sa.sa_sigaction = &plcrash_signal_handler;
             
+            /*
+             * Add the pass-through sigaction callback as the first element of the signal's callbacks, to be
+             * dispatched last.
+             */
+            if (slot->callback_count == 0) {
+                plcrash_signal_user_callback passthrough = {
+                    .callback = previous_action_callback,
+                    .context = NULL
+                };
+                slot_append(slot, passthrough);
+            }
+
             /* Set new sigaction */
             if (sigaction(signo, &sa, &sa_prev) != 0) {
                 int err = errno;
                 plcrash_populate_posix_error(outError, err, @"Failed to register signal handler");
+                pthread_mutex_unlock(&registration_lock);
                 return NO;
             }
             
@@ -382,13 +526,11 @@ static PLCrashSignalHandler *sharedHandler;
              * TODO - Investigate use of async-safe locking to avoid this condition. See also:
              * The PLCrashReporter class's enabling of Mach exceptions.
              */
-            plcrash_signal_handler_action act = {
-                .signo = signo,
-                .action = sa_prev
-            };
-            shared_handler_context.previous_actions.nasync_append(act);
+            slot->previous_action = sa_prev;
+            OSMemoryBarrier();
+            slot->has_previous_action = true;
         }
-    } pthread_mutex_unlock(&registerHandlers);
+    } pthread_mutex_unlock(&registration_lock);
     
     return YES;
 }
@@ -405,6 +547,10 @@ static PLCrashSignalHandler *sharedHandler;
  * the signal handlers could not be registered. If no error occurs, this parameter will be left unmodified. You may specify
  * NULL for this parameter, and no error information will be provided.
  *
+ * Callbacks are only dispatched for the signal for which they were registered. At most
+ * PLCRASH_SIGNAL_HANDLER_MAX_CALLBACKS - 1 callbacks may be registered for any one signal; once the limit is reached,
+ * NO will be returned with a PLCrashReporterErrorResourceBusy error.
+ *
  * @warning Once registered, a callback may not be deregistered. This restriction may be removed in a future release.
  * @warning Callers must ensure that the PLCrashSignalHandler instance is not released and deallocated while callbacks remain active; in
  * a future release, this may result in the callbacks also being deregistered.
@@ -418,14 +564,78 @@ static PLCrashSignalHandler *sharedHandler;
     if (![self registerHandlerWithSignal: signo error: outError])
         return NO;
     
-    /* Add the new callback to the shared state list. */
+    /* Add the new callback to the signal's callbacks; it will be dispatched ahead of all previously registered
+     * callbacks. */
     plcrash_signal_user_callback reg = {
         .callback = callback,
         .context = context
     };
-    shared_handler_context.callbacks.nasync_prepend(reg);
-    
+
+    pthread_mutex_lock(&registration_lock);
+    bool added = slot_append(&shared_handler_context.slots[signo], reg);
+    pthread_mutex_unlock(&registration_lock);
+
+    if (!added) {
+        plcrash_populate_error(outError, PLCrashReporterErrorResourceBusy, @"The maximum number of callbacks has been registered for this signal", nil);
+        return NO;
+    }
+
     return YES;
 }
 
+/**
+ * Register a new pre-filter @a filter for @a signo. Pre-filters are dispatched in registration order, before any
+ * registered callbacks; if a filter returns true, the signal is considered handled and no further filters or
+ * callbacks are dispatched. This allows faults that are expected by the process -- such as those used for control
+ * flow by runtimes that rely on SIGSEGV or SIGBUS -- to be claimed without entering the crash reporting path.
+ *
+ * @param signo The signal for which the filter should be registered.
+ * @param filter The filter to be executed upon receipt of a signal. The filter will execute on the faulting thread,
+ * and must be async-safe.
+ * @param context Context to be passed to the filter. May be NULL.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error object indicating why
+ * the filter could not be registered. If no error occurs, this parameter will be left unmodified. You may specify
+ * NULL for this parameter, and no error information will be provided.
+ *
+ * At most PLCRASH_SIGNAL_HANDLER_MAX_FILTERS filters may be registered for any one signal; once the limit is reached,
+ * NO will be returned with a PLCrashReporterErrorResourceBusy error.
+ *
+ * @warning Once registered, a filter may not be deregistered.
+ */
+- (BOOL) registerFilterForSignal: (int) signo
+                          filter: (PLCrashSignalHandlerFilterFunc) filter
+                         context: (void *) context
+                           error: (NSError **) outError
+{
+    /* Register the actual signal handler, if necessary */
+    if (![self registerHandlerWithSignal: signo error: outError])
+        return NO;
+
+    plcrash_signal_user_filter reg = {
+        .filter = filter,
+        .context = context
+    };
+
+    pthread_mutex_lock(&registration_lock);
+    bool added = slot_append_filter(&shared_handler_context.slots[signo], reg);
+    pthread_mutex_unlock(&registration_lock);
+
+    if (!added) {
+        plcrash_populate_error(outError, PLCrashReporterErrorResourceBusy, @"The maximum number of filters has been registered for this signal", nil);
+        return NO;
+    }
+
+    return YES;
+}
+
+/**
+ * Fault in the pages of the alternate signal stack, so that a signal delivered on the stack does not incur page
+ * faults at crash time.
+ *
+ * @param lock If true, the stack is additionally wired via mlock().
+ */
+- (void) prefaultSignalStack: (BOOL) lock {
+    plcrash_nasync_prefault(_sigstk.ss_sp, _sigstk.ss_size, lock);
+}
+
 @end
@@ -30,6 +30,7 @@
 
 #import "PLCrashSignalHandler.h"
 #import "PLCrashProcessInfo.h"
+#import "CrashReporter.h"
 
 #import <sys/mman.h>
 #import <mach/mach.h>
@@ -167,4 +168,140 @@ static void sa_handler_cb (int signo) {
 }
 
 
+
+static bool forward_crash_cb (int signal, siginfo_t *siginfo, ucontext_t *uap, void *context, PLCrashSignalHandlerCallback *next) {
+    return PLCrashSignalHandlerForward(next, signal, siginfo, uap);
+}
+
+/**
+ * Verify that callbacks are only dispatched for the signal for which they were registered.
+ */
+- (void) testPerSignalDispatch {
+    NSError *error;
+
+    /* Register a standard POSIX handler for SIGSEGV */
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_flags = SA_SIGINFO;
+    sa.sa_sigaction = sa_action_cb;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGSEGV, &sa, NULL);
+
+    /* Register our recording callback for SIGBUS, and a forwarding callback for SIGSEGV */
+    STAssertTrue([[PLCrashSignalHandler sharedHandler] registerHandlerForSignal: SIGBUS
+                                                                       callback: &noop_crash_cb
+                                                                        context: NULL
+                                                                          error: &error], @"Could not register signal handler: %@", error);
+    STAssertTrue([[PLCrashSignalHandler sharedHandler] registerHandlerForSignal: SIGSEGV
+                                                                       callback: &forward_crash_cb
+                                                                        context: NULL
+                                                                          error: &error], @"Could not register signal handler: %@", error);
+
+    /* Only the SIGSEGV chain should run */
+    siginfo_t si;
+    ucontext_t uc;
+    plcrash_signal_handler(SIGSEGV, &si, &uc);
+
+    STAssertEquals(crash_page[0], (uint8_t)0, @"SIGBUS callback ran for SIGSEGV");
+    STAssertEquals(crash_page[1], (uint8_t)0xFB, @"Signal handler did not run");
+}
+
+static bool order_crash_cb (int signal, siginfo_t *siginfo, ucontext_t *uap, void *context, PLCrashSignalHandlerCallback *next) {
+    /* Record our position in the dispatch order */
+    crash_page[0]++;
+    crash_page[(uintptr_t) context] = crash_page[0];
+    return PLCrashSignalHandlerForward(next, signal, siginfo, uap);
+}
+
+/**
+ * Verify that callbacks are dispatched from the most recently registered to the first, followed by the previously
+ * registered signal handler.
+ */
+- (void) testCallbackOrder {
+    NSError *error;
+
+    /* Register a standard POSIX handler */
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_flags = SA_SIGINFO;
+    sa.sa_sigaction = sa_action_cb;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGSEGV, &sa, NULL);
+
+    /* Register our callbacks; each records its position at the crash_page index given by its context */
+    for (uintptr_t i = 2; i < 5; i++) {
+        STAssertTrue([[PLCrashSignalHandler sharedHandler] registerHandlerForSignal: SIGSEGV
+                                                                           callback: &order_crash_cb
+                                                                            context: (void *) i
+                                                                              error: &error], @"Could not register signal handler: %@", error);
+    }
+
+    siginfo_t si;
+    ucontext_t uc;
+    plcrash_signal_handler(SIGSEGV, &si, &uc);
+
+    STAssertEquals(crash_page[4], (uint8_t)1, @"Last registered callback was not dispatched first");
+    STAssertEquals(crash_page[3], (uint8_t)2, @"Second registered callback was not dispatched second");
+    STAssertEquals(crash_page[2], (uint8_t)3, @"First registered callback was not dispatched last");
+    STAssertEquals(crash_page[1], (uint8_t)0xFB, @"Signal handler did not run");
+}
+
+/**
+ * Verify that registration fails once the per-signal callback limit is reached.
+ */
+- (void) testCallbackLimit {
+    NSError *error = nil;
+    NSUInteger registered = 0;
+
+    while ([[PLCrashSignalHandler sharedHandler] registerHandlerForSignal: SIGBUS callback: &crash_callback context: NULL error: &error])
+        registered++;
+
+    STAssertTrue(registered > 0, @"No callbacks were registered");
+    STAssertEquals((NSInteger) PLCrashReporterErrorResourceBusy, [error code], @"Unexpected error: %@", error);
+}
+
+/**
+ * Verify that a claiming pre-filter prevents dispatch to the registered callbacks.
+ */
+- (void) testFilterClaimsSignal {
+    NSError *error;
+
+    plcrash_signal_address_range_t ranges[] = {
+        { (uintptr_t) crash_page + PAGE_SIZE, PAGE_SIZE },
+        { (uintptr_t) crash_page, 16 }
+    };
+    plcrash_signal_address_table_t table;
+    plcrash_signal_address_table_init(&table, ranges, sizeof(ranges) / sizeof(ranges[0]));
+
+    STAssertTrue(plcrash_signal_address_table_contains(&table, (uintptr_t) crash_page + 15), @"Address not found");
+    STAssertFalse(plcrash_signal_address_table_contains(&table, (uintptr_t) crash_page + 16), @"Address outside of ranges was found");
+    STAssertTrue(plcrash_signal_address_table_contains(&table, (uintptr_t) crash_page + PAGE_SIZE), @"Address not found");
+    STAssertFalse(plcrash_signal_address_table_contains(&table, (uintptr_t) crash_page - 1), @"Address outside of ranges was found");
+
+    /* Our callback forwards to the previous action; ensure that it ignores the signal */
+    signal(SIGBUS, SIG_IGN);
+
+    STAssertTrue([[PLCrashSignalHandler sharedHandler] registerHandlerForSignal: SIGBUS
+                                                                       callback: &noop_crash_cb
+                                                                        context: NULL
+                                                                          error: &error], @"Could not register signal handler: %@", error);
+    STAssertTrue([[PLCrashSignalHandler sharedHandler] registerFilterForSignal: SIGBUS
+                                                                        filter: &plcrash_signal_address_table_filter
+                                                                       context: &table
+                                                                         error: &error], @"Could not register signal filter: %@", error);
+
+    /* A fault within the table is claimed by the filter */
+    siginfo_t si;
+    ucontext_t uc;
+    memset(&si, 0, sizeof(si));
+    si.si_addr = crash_page + 8;
+    plcrash_signal_handler(SIGBUS, &si, &uc);
+    STAssertEquals(crash_page[0], (uint8_t)0, @"Crash callback ran for a claimed fault");
+
+    /* A fault outside the table is passed on to the callbacks */
+    si.si_addr = crash_page + 32;
+    plcrash_signal_handler(SIGBUS, &si, &uc);
+    STAssertEquals(crash_page[0], (uint8_t)0xFA, @"Crash callback did not run");
+}
+
 @end
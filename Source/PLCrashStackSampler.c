@@ -0,0 +1,332 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "PLCrashStackSampler.h"
+
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <inttypes.h>
+
+/**
+ * @internal
+ * @ingroup plcrash_stack_sampler
+ * @{
+ */
+
+/**
+ * Initialize a new stack sampler. The sampler does not begin sampling until plcrash_stack_sampler_start() is called;
+ * samples may also be taken directly via plcrash_stack_sampler_sample().
+ *
+ * @param sampler The sampler to initialize.
+ * @param task The task containing the sampled threads.
+ * @param image_list The image list to be used to walk the sampled stacks. This is a borrowed reference, and must
+ * remain valid for the lifetime of the sampler.
+ * @param threads The threads to be sampled. A send right will be acquired for each thread.
+ * @param thread_count The number of threads in @a threads. Must be no greater than PLCRASH_STACK_SAMPLER_MAX_THREADS.
+ * @param capacity The maximum number of unique stacks to be retained.
+ * @param interval The sampling interval, in nanoseconds.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, PLCRASH_EINVAL if the arguments are invalid, or PLCRASH_ENOMEM if
+ * the sample buffer could not be allocated.
+ *
+ * @warning This function is not async-safe.
+ */
+plcrash_error_t plcrash_stack_sampler_init (plcrash_stack_sampler_t *sampler,
+                                            task_t task,
+                                            plcrash_async_image_list_t *image_list,
+                                            const thread_t *threads,
+                                            uint32_t thread_count,
+                                            uint32_t capacity,
+                                            uint64_t interval)
+{
+    if (thread_count == 0 || thread_count > PLCRASH_STACK_SAMPLER_MAX_THREADS || capacity == 0 || interval == 0)
+        return PLCRASH_EINVAL;
+
+    memset(sampler, 0, sizeof(*sampler));
+
+    /* The buffer is allocated with vm_allocate() rather than malloc(), as it may be large */
+    vm_address_t addr;
+    kern_return_t kt = vm_allocate(mach_task_self(), &addr, round_page(capacity * sizeof(plcrash_stack_sample_t)), VM_FLAGS_ANYWHERE);
+    if (kt != KERN_SUCCESS)
+        return PLCRASH_ENOMEM;
+
+    sampler->samples = (plcrash_stack_sample_t *) addr;
+    sampler->capacity = capacity;
+    sampler->task = task;
+    sampler->image_list = image_list;
+    sampler->interval = interval;
+
+    for (uint32_t i = 0; i < thread_count; i++) {
+        if (mach_port_mod_refs(mach_task_self(), threads[i], MACH_PORT_RIGHT_SEND, 1) != KERN_SUCCESS) {
+            PLCF_DEBUG("Failed to acquire a reference to sampled thread %" PRIu32, i);
+            sampler->threads[i] = MACH_PORT_NULL;
+            continue;
+        }
+
+        sampler->threads[i] = threads[i];
+    }
+    sampler->thread_count = thread_count;
+
+    pthread_mutex_init(&sampler->lock, NULL);
+
+    plframe_unwind_cache_init(&sampler->unwind_cache);
+    sampler->unwind_cache_generation = image_list->removal_generation;
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * @internal
+ *
+ * Compute the hash of a sampled stack.
+ */
+static uint64_t plcrash_stack_sampler_hash (uint32_t thread_index, const pl_vm_address_t *pcs, uint32_t frame_count) {
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (size_t j = 0; j < sizeof(thread_index); j++) {
+        hash ^= (uint8_t) (thread_index >> (j * 8));
+        hash *= 1099511628211ULL;
+    }
+
+    for (uint32_t i = 0; i < frame_count; i++) {
+        uint64_t pc = pcs[i];
+        for (size_t j = 0; j < sizeof(pc); j++) {
+            hash ^= (uint8_t) (pc >> (j * 8));
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return hash;
+}
+
+/**
+ * @internal
+ *
+ * Record a sampled stack, incrementing the count of a matching entry if the stack has already been observed.
+ * The caller must hold the sampler's lock.
+ */
+static void plcrash_stack_sampler_record (plcrash_stack_sampler_t *sampler, uint32_t thread_index, const pl_vm_address_t *pcs, uint32_t frame_count) {
+    uint64_t hash = plcrash_stack_sampler_hash(thread_index, pcs, frame_count);
+
+    sampler->total_samples++;
+
+    /* Deduplicate by hash, verifying the match against the recorded PCs */
+    for (uint32_t i = 0; i < sampler->count; i++) {
+        plcrash_stack_sample_t *sample = &sampler->samples[i];
+        if (sample->hash != hash || sample->thread_index != thread_index || sample->frame_count != frame_count)
+            continue;
+
+        if (memcmp(sample->pcs, pcs, frame_count * sizeof(pcs[0])) != 0)
+            continue;
+
+        sample->count++;
+        return;
+    }
+
+    /* Replace the oldest entry once the buffer is full */
+    plcrash_stack_sample_t *sample = &sampler->samples[sampler->next];
+    if (sampler->count == sampler->capacity) {
+        sampler->evicted_samples += sample->count;
+    } else {
+        sampler->count++;
+    }
+    sampler->next = (sampler->next + 1) % sampler->capacity;
+
+    sample->hash = hash;
+    sample->thread_index = thread_index;
+    sample->count = 1;
+    sample->frame_count = frame_count;
+    memcpy(sample->pcs, pcs, frame_count * sizeof(pcs[0]));
+}
+
+/**
+ * Take a single sample of each of the sampler's threads. Each thread is suspended only for the duration of its
+ * stack walk; symbols are not resolved.
+ *
+ * @param sampler The sampler.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success.
+ *
+ * @warning This function is not async-safe, and must not be called concurrently with itself. The calling thread
+ * is never sampled.
+ */
+plcrash_error_t plcrash_stack_sampler_sample (plcrash_stack_sampler_t *sampler) {
+    pl_vm_address_t pcs[PLCRASH_STACK_SAMPLER_MAX_FRAMES];
+
+    /* Cached unwind data refers to image mappings; it must be discarded once any image has been removed. */
+    uint32_t generation = sampler->image_list->removal_generation;
+    if (generation != sampler->unwind_cache_generation) {
+        plframe_unwind_cache_free(&sampler->unwind_cache);
+        plframe_unwind_cache_init(&sampler->unwind_cache);
+        sampler->unwind_cache_generation = generation;
+    }
+
+    for (uint32_t i = 0; i < sampler->thread_count; i++) {
+        thread_t thread = sampler->threads[i];
+        uint32_t frame_count = 0;
+
+        if (thread == MACH_PORT_NULL || thread == pl_mach_thread_self())
+            continue;
+
+        if (thread_suspend(thread) != KERN_SUCCESS)
+            continue;
+
+        /* Walk the stack, recording only the PC values */
+        plcrash_async_thread_state_t thread_state;
+        plframe_cursor_t cursor;
+        if (plcrash_async_thread_state_mach_thread_init(&thread_state, thread) == PLCRASH_ESUCCESS) {
+            if (plframe_cursor_init(&cursor, sampler->task, &thread_state, sampler->image_list) == PLFRAME_ESUCCESS) {
+                plframe_cursor_set_unwind_cache(&cursor, &sampler->unwind_cache);
+
+                while (frame_count < PLCRASH_STACK_SAMPLER_MAX_FRAMES && plframe_cursor_next(&cursor) == PLFRAME_ESUCCESS) {
+                    plcrash_greg_t pc = 0;
+                    if (plframe_cursor_get_reg(&cursor, PLCRASH_REG_IP, &pc) != PLFRAME_ESUCCESS)
+                        break;
+
+                    pcs[frame_count++] = (pl_vm_address_t) pc;
+                }
+            }
+
+            plframe_cursor_free(&cursor);
+        }
+
+        thread_resume(thread);
+
+        if (frame_count == 0)
+            continue;
+
+        pthread_mutex_lock(&sampler->lock);
+        plcrash_stack_sampler_record(sampler, i, pcs, frame_count);
+        pthread_mutex_unlock(&sampler->lock);
+    }
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * @internal
+ *
+ * Sampling thread entry point.
+ */
+static void *plcrash_stack_sampler_thread (void *ctx) {
+    plcrash_stack_sampler_t *sampler = ctx;
+    struct timespec interval = {
+        .tv_sec = (time_t) (sampler->interval / NSEC_PER_SEC),
+        .tv_nsec = (long) (sampler->interval % NSEC_PER_SEC)
+    };
+
+    while (sampler->running) {
+        plcrash_stack_sampler_sample(sampler);
+
+        struct timespec remaining = interval;
+        while (nanosleep(&remaining, &remaining) != 0 && errno == EINTR && sampler->running);
+    }
+
+    return NULL;
+}
+
+/**
+ * Start periodic sampling on a new background thread.
+ *
+ * @param sampler The sampler.
+ *
+ * @return Returns PLCRASH_ESUCCESS on success, or PLCRASH_EINTERNAL if the sampling thread could not be started.
+ *
+ * @warning This function is not async-safe.
+ */
+plcrash_error_t plcrash_stack_sampler_start (plcrash_stack_sampler_t *sampler) {
+    if (sampler->running)
+        return PLCRASH_ESUCCESS;
+
+    sampler->running = true;
+    if (pthread_create(&sampler->thread, NULL, plcrash_stack_sampler_thread, sampler) != 0) {
+        sampler->running = false;
+        return PLCRASH_EINTERNAL;
+    }
+
+    return PLCRASH_ESUCCESS;
+}
+
+/**
+ * Stop periodic sampling, waiting for the sampling thread to exit. Recorded samples are retained.
+ *
+ * @param sampler The sampler.
+ *
+ * @warning This function is not async-safe.
+ */
+void plcrash_stack_sampler_stop (plcrash_stack_sampler_t *sampler) {
+    if (!sampler->running)
+        return;
+
+    sampler->running = false;
+    pthread_join(sampler->thread, NULL);
+}
+
+/**
+ * Acquire the sampler's lock, preventing modification of the recorded samples until plcrash_stack_sampler_unlock()
+ * is called.
+ *
+ * @param sampler The sampler.
+ */
+void plcrash_stack_sampler_lock (plcrash_stack_sampler_t *sampler) {
+    pthread_mutex_lock(&sampler->lock);
+}
+
+/**
+ * Release a lock acquired via plcrash_stack_sampler_lock().
+ *
+ * @param sampler The sampler.
+ */
+void plcrash_stack_sampler_unlock (plcrash_stack_sampler_t *sampler) {
+    pthread_mutex_unlock(&sampler->lock);
+}
+
+/**
+ * Stop sampling, and free all sampler resources.
+ *
+ * @param sampler The sampler.
+ *
+ * @warning This function is not async-safe.
+ */
+void plcrash_stack_sampler_free (plcrash_stack_sampler_t *sampler) {
+    plcrash_stack_sampler_stop(sampler);
+
+    for (uint32_t i = 0; i < sampler->thread_count; i++) {
+        if (sampler->threads[i] != MACH_PORT_NULL)
+            mach_port_deallocate(mach_task_self(), sampler->threads[i]);
+    }
+
+    plframe_unwind_cache_free(&sampler->unwind_cache);
+    pthread_mutex_destroy(&sampler->lock);
+    vm_deallocate(mach_task_self(), (vm_address_t) sampler->samples, round_page(sampler->capacity * sizeof(plcrash_stack_sample_t)));
+}
+
+/**
+ * @} plcrash_stack_sampler
+ */
@@ -0,0 +1,161 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PLCRASH_STACK_SAMPLER_H
+#define PLCRASH_STACK_SAMPLER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <mach/mach.h>
+
+#include "PLCrashAsync.h"
+#include "PLCrashAsyncImageList.h"
+#include "PLCrashFrameWalker.h"
+
+/**
+ * @internal
+ * @defgroup plcrash_stack_sampler Stack Sampling
+ * @ingroup plcrash_internal
+ *
+ * Low-overhead periodic capture of the PC values of selected threads.
+ *
+ * @{
+ */
+
+/** The maximum number of threads that may be sampled by a single sampler. */
+#define PLCRASH_STACK_SAMPLER_MAX_THREADS 8
+
+/** The maximum number of frames recorded for a sampled stack; deeper stacks are truncated. */
+#define PLCRASH_STACK_SAMPLER_MAX_FRAMES 128
+
+/**
+ * A unique sampled stack, and the number of samples in which it was observed.
+ */
+typedef struct plcrash_stack_sample {
+    /** FNV-1a hash of the thread index and the stack's PC values. */
+    uint64_t hash;
+
+    /** The index of the sampled thread, in the order the threads were supplied to plcrash_stack_sampler_init(). */
+    uint32_t thread_index;
+
+    /** The number of samples in which this stack was observed. */
+    uint32_t count;
+
+    /** The number of valid entries in @a pcs. */
+    uint32_t frame_count;
+
+    /** The stack's PC values, starting with the innermost frame. */
+    pl_vm_address_t pcs[PLCRASH_STACK_SAMPLER_MAX_FRAMES];
+} plcrash_stack_sample_t;
+
+/**
+ * A periodic stack sampler. Samples are aggregated by stack into a fixed-size ring buffer; once the buffer
+ * is full, each newly observed stack replaces the oldest entry.
+ */
+typedef struct plcrash_stack_sampler {
+    /** The target task. */
+    task_t task;
+
+    /** The image list used to walk the sampled stacks. */
+    plcrash_async_image_list_t *image_list;
+
+    /** The sampled threads. A send right is held for each thread. */
+    thread_t threads[PLCRASH_STACK_SAMPLER_MAX_THREADS];
+
+    /** The number of valid entries in @a threads. */
+    uint32_t thread_count;
+
+    /** The sampling interval, in nanoseconds. */
+    uint64_t interval;
+
+    /** Lock guarding the sample buffer and counters. */
+    pthread_mutex_t lock;
+
+    /** The sample ring buffer. */
+    plcrash_stack_sample_t *samples;
+
+    /** The number of entries allocated in @a samples. */
+    uint32_t capacity;
+
+    /** The number of valid entries in @a samples. */
+    uint32_t count;
+
+    /** The index of the entry to be replaced by the next newly observed stack. */
+    uint32_t next;
+
+    /** The total number of stacks sampled, including those evicted from the buffer. */
+    uint32_t total_samples;
+
+    /** The number of samples whose stacks have been evicted from the buffer. */
+    uint32_t evicted_samples;
+
+    /** Unwind data cache shared by all samples; discarded when an image is removed from @a image_list. */
+    plframe_unwind_cache_t unwind_cache;
+
+    /** The image list's removal generation at the time @a unwind_cache was initialized. */
+    uint32_t unwind_cache_generation;
+
+    /** The sampling thread. Only valid if @a running is true. */
+    pthread_t thread;
+
+    /** True if the sampling thread is running. */
+    volatile bool running;
+} plcrash_stack_sampler_t;
+
+plcrash_error_t plcrash_stack_sampler_init (plcrash_stack_sampler_t *sampler,
+                                            task_t task,
+                                            plcrash_async_image_list_t *image_list,
+                                            const thread_t *threads,
+                                            uint32_t thread_count,
+                                            uint32_t capacity,
+                                            uint64_t interval);
+
+plcrash_error_t plcrash_stack_sampler_sample (plcrash_stack_sampler_t *sampler);
+
+plcrash_error_t plcrash_stack_sampler_start (plcrash_stack_sampler_t *sampler);
+void plcrash_stack_sampler_stop (plcrash_stack_sampler_t *sampler);
+
+void plcrash_stack_sampler_lock (plcrash_stack_sampler_t *sampler);
+void plcrash_stack_sampler_unlock (plcrash_stack_sampler_t *sampler);
+
+void plcrash_stack_sampler_free (plcrash_stack_sampler_t *sampler);
+
+/**
+ * @} plcrash_stack_sampler
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PLCRASH_STACK_SAMPLER_H */
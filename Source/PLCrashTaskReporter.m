@@ -0,0 +1,318 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashTaskReporter.h"
+
+#import "CrashReporter.h"
+#import "PLCrashLiveReportSession.h"
+#import "PLCrashAsyncImageList.h"
+#import "PLCrashProcessInfo.h"
+#import "PLCrashReporterNSError.h"
+
+#if !TARGET_OS_IPHONE
+#import <libproc.h>
+#endif
+
+/** @internal Maximum size of a task report, in bytes. */
+#define PLCRASH_TASK_REPORT_MAX_BYTES (1024 * 1024)
+
+/** @internal The maximum number of attempts made to read a task's images while dyld is modifying them. */
+#define PLCRASH_TASK_REPORT_IMAGE_LIST_ATTEMPTS 3
+
+/**
+ * @internal
+ *
+ * Report state retained for a single target task across reports: the report writer, its persistent symbol cache,
+ * and the task's image list, including any symbol indexes built for its images.
+ */
+@interface PLCrashTaskReporterTarget : NSObject {
+@private
+    /** The target task. */
+    task_t _task;
+
+    /** The report session, targeting @a _task. */
+    PLCrashLiveReportSession *_session;
+
+    /** The target task's images. Guarded by the session's writer. */
+    plcrash_async_image_list_t _imageList;
+
+    /** If true, the writer's shared cache has been provided to @a _imageList. */
+    BOOL _hasSharedCache;
+}
+
+- (instancetype) initWithTask: (task_t) task configuration: (PLCrashReporterConfig *) config error: (NSError **) outError;
+- (NSData *) generateReportAndReturnError: (NSError **) outError;
+
+@end
+
+/**
+ * @internal
+ *
+ * Map the configuration's symbolication strategy to the writer's strategy.
+ */
+static plcrash_async_symbol_strategy_t plcrash_task_reporter_symbol_strategy (PLCrashReporterSymbolicationStrategy strategy) {
+    plcrash_async_symbol_strategy_t result = PLCRASH_ASYNC_SYMBOL_STRATEGY_NONE;
+
+    if (strategy & PLCrashReporterSymbolicationStrategySymbolTable)
+        result |= PLCRASH_ASYNC_SYMBOL_STRATEGY_SYMBOL_TABLE;
+
+    if (strategy & PLCrashReporterSymbolicationStrategyObjC)
+        result |= PLCRASH_ASYNC_SYMBOL_STRATEGY_OBJC;
+
+    return result;
+}
+
+@implementation PLCrashTaskReporterTarget
+
+/**
+ * Initialize a new target.
+ *
+ * @param task The target task.
+ * @param config The configuration from which the report options are derived.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error
+ * object indicating why the target could not be initialized. You may specify nil for this parameter.
+ */
+- (instancetype) initWithTask: (task_t) task configuration: (PLCrashReporterConfig *) config error: (NSError **) outError {
+    kern_return_t kr;
+    pid_t pid;
+
+    if ((self = [super init]) == nil)
+        return nil;
+
+    if ((kr = pid_for_task(task, &pid)) != KERN_SUCCESS) {
+        plcrash_populate_mach_error(outError, kr, @"Could not determine the target task's process ID");
+        [self release];
+        return nil;
+    }
+
+    /* Identify the application by its bundle, if any, or otherwise by its process name */
+    NSString *applicationIdentifier = [[[[PLCrashProcessInfo alloc] initWithProcessID: pid] autorelease] processName];
+    NSString *applicationVersion = @"";
+    NSString *applicationMarketingVersion = nil;
+#if !TARGET_OS_IPHONE
+    char process_path[PROC_PIDPATHINFO_MAXSIZE];
+    if (proc_pidpath(pid, process_path, sizeof(process_path)) > 0) {
+        NSString *path = [NSString stringWithUTF8String: process_path];
+        while ([path length] > 1 && ![[path pathExtension] isEqualToString: @"app"])
+            path = [path stringByDeletingLastPathComponent];
+
+        NSBundle *bundle = [[path pathExtension] isEqualToString: @"app"] ? [NSBundle bundleWithPath: path] : nil;
+        if (bundle.bundleIdentifier != nil) {
+            applicationIdentifier = bundle.bundleIdentifier;
+            if ([bundle objectForInfoDictionaryKey: (NSString *) kCFBundleVersionKey] != nil)
+                applicationVersion = [bundle objectForInfoDictionaryKey: (NSString *) kCFBundleVersionKey];
+            applicationMarketingVersion = [bundle objectForInfoDictionaryKey: @"CFBundleShortVersionString"];
+        }
+    }
+#endif
+    if (applicationIdentifier == nil)
+        applicationIdentifier = [NSString stringWithFormat: @"%d", pid];
+
+    _session = [[PLCrashLiveReportSession alloc] initWithApplicationIdentifier: applicationIdentifier
+                                                                    appVersion: applicationVersion
+                                                           appMarketingVersion: applicationMarketingVersion
+                                                                symbolStrategy: plcrash_task_reporter_symbol_strategy(config.symbolicationStrategy)
+                                                                 configuration: config];
+    if (_session == nil || ![_session setTargetTask: task]) {
+        plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Failed to initialize the task report writer", nil);
+        [self release];
+        return nil;
+    }
+
+    mach_port_mod_refs(mach_task_self(), task, MACH_PORT_RIGHT_SEND, 1);
+    _task = task;
+
+    /* Symbol indexes are built once per image, and retained for as long as the image remains loaded */
+    plcrash_nasync_image_list_init(&_imageList, _task);
+    if (config.symbolicationStrategy & PLCrashReporterSymbolicationStrategySymbolTable)
+        plcrash_nasync_image_list_set_symbol_indexing(&_imageList, true);
+
+    return self;
+}
+
+- (void) dealloc {
+    if (_task != MACH_PORT_NULL) {
+        plcrash_nasync_image_list_free(&_imageList);
+        mach_port_deallocate(mach_task_self(), _task);
+    }
+
+    [_session release];
+    [super dealloc];
+}
+
+/**
+ * Generate a report for the target task.
+ *
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error
+ * object indicating why the report could not be generated. You may specify nil for this parameter.
+ */
+- (NSData *) generateReportAndReturnError: (NSError **) outError {
+    plcrash_async_file_t file;
+    plcrash_error_t err;
+
+    if ((err = plcrash_async_file_init_vm(&file, PLCRASH_TASK_REPORT_MAX_BYTES)) != PLCRASH_ESUCCESS) {
+        plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Failed to allocate the task report buffer", nil);
+        return nil;
+    }
+
+    plcrash_log_writer_t *writer = [_session beginReport];
+
+    if (!_hasSharedCache && writer->process_info.has_shared_cache) {
+        plcrash_nasync_image_list_set_shared_cache(&_imageList, &writer->process_info.shared_cache);
+        _hasSharedCache = YES;
+    }
+
+    /* Bring the image list up to date; only images loaded since the previous report are parsed */
+    for (int i = 0; i < PLCRASH_TASK_REPORT_IMAGE_LIST_ATTEMPTS; i++) {
+        if ((err = plcrash_nasync_image_list_sync_task_images(&_imageList)) != PLCRASH_EINTERNAL)
+            break;
+    }
+
+    if (err != PLCRASH_ESUCCESS) {
+        [_session endReport];
+        plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Failed to read the task's images", nil);
+        vm_deallocate(mach_task_self(), (vm_address_t) file.mem_buffer, file.mem_capacity);
+        return nil;
+    }
+
+    /* Mock up a SIGTRAP-based signal info, as per live reports; the main thread is marked as the crashed thread */
+    plcrash_log_bsd_signal_info_t bsd_signal_info;
+    plcrash_log_signal_info_t signal_info;
+    bsd_signal_info.signo = SIGTRAP;
+    bsd_signal_info.code = TRAP_TRACE;
+    bsd_signal_info.address = NULL;
+
+    signal_info.bsd_info = &bsd_signal_info;
+    signal_info.mach_info = NULL;
+
+    err = plcrash_log_writer_write(writer, writer->main_thread, &_imageList, &file, &signal_info, NULL);
+    plcrash_async_file_close(&file);
+    [_session endReport];
+
+    if (err != PLCRASH_ESUCCESS) {
+        plcrash_populate_error(outError, PLCrashReporterErrorUnknown, @"Failed to write the task report", nil);
+        vm_deallocate(mach_task_self(), (vm_address_t) file.mem_buffer, file.mem_capacity);
+        return nil;
+    }
+
+    NSData *data = [NSData dataWithBytes: file.mem_buffer length: (NSUInteger) file.total_bytes];
+    vm_deallocate(mach_task_self(), (vm_address_t) file.mem_buffer, file.mem_capacity);
+    return data;
+}
+
+@end
+
+/**
+ * Generates standard crash reports for other tasks, given their task ports, without interrupting the tasks beyond
+ * the suspension of their threads while their stacks are walked.
+ *
+ * The report writer, symbol cache, and image list of each task -- including any symbol indexes built for the
+ * task's images -- are retained across reports, allowing a monitor to cheaply sample many long-lived processes.
+ * Once a task is no longer monitored, or has terminated, its retained state should be released via
+ * PLCrashTaskReporter::removeTask:.
+ *
+ * Acquiring another task's port generally requires the task_for_pid() entitlement, or a port sent by the target
+ * itself. The target task must share the current task's pointer width.
+ *
+ * Reports for different tasks may be generated concurrently; reports for a single task are serialized.
+ */
+@implementation PLCrashTaskReporter
+
+/**
+ * Initialize a new task reporter.
+ *
+ * The configuration's symbolication strategy, and its live report options -- such as snapshotting threads,
+ * writing referenced images only, and incremental reports -- apply to all task reports. The signal handler type
+ * and other crash handling options are ignored.
+ *
+ * @param config The configuration to be used by this reporter instance.
+ */
+- (instancetype) initWithConfiguration: (PLCrashReporterConfig *) config {
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _config = [config copy];
+    _targets = [[NSMutableDictionary alloc] init];
+    _lock = [[NSLock alloc] init];
+
+    return self;
+}
+
+- (void) dealloc {
+    [_config release];
+    [_targets release];
+    [_lock release];
+
+    [super dealloc];
+}
+
+/**
+ * Generate a report for @a task. The task's main thread is marked as the crashed thread.
+ *
+ * @param task The task for which a report will be generated.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error
+ * object indicating why the report could not be generated. If no error occurs, this parameter will be left
+ * unmodified. You may specify nil for this parameter, and no error information will be provided.
+ *
+ * @return Returns the report data, or nil if the report could not be generated.
+ */
+- (NSData *) generateReportForTask: (task_t) task error: (NSError **) outError {
+    NSNumber *key = [NSNumber numberWithUnsignedInt: task];
+
+    /* Fetch or create the task's target */
+    [_lock lock];
+    PLCrashTaskReporterTarget *target = [[_targets objectForKey: key] retain];
+    if (target == nil) {
+        target = [[PLCrashTaskReporterTarget alloc] initWithTask: task configuration: _config error: outError];
+        if (target != nil)
+            [_targets setObject: target forKey: key];
+    }
+    [_lock unlock];
+
+    if (target == nil)
+        return nil;
+
+    NSData *data = [target generateReportAndReturnError: outError];
+    [target release];
+
+    return data;
+}
+
+/**
+ * Release all state retained for @a task, including the reporter's reference to the task's port. This has no effect
+ * if no report has been generated for @a task.
+ *
+ * @param task A task for which reports were previously generated.
+ */
+- (void) removeTask: (task_t) task {
+    [_lock lock];
+    [_targets removeObjectForKey: [NSNumber numberWithUnsignedInt: task]];
+    [_lock unlock];
+}
+
+@end
@@ -0,0 +1,85 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PLCRASH_TEXT_BUFFER_H
+#define PLCRASH_TEXT_BUFFER_H
+
+#import <Foundation/Foundation.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @internal
+ * @ingroup plcrash_text_buffer
+ *
+ * Size of the output buffer used when writing formatted reports to a file descriptor, and the initial size of
+ * the output buffer used when formatting to memory.
+ */
+#define PLCRASH_TEXT_BUFFER_SIZE (64 * 1024)
+
+/**
+ * @internal
+ * @ingroup plcrash_text_buffer
+ *
+ * UTF-8 text output buffer. If a file descriptor is provided, the buffer is flushed to it as it fills;
+ * otherwise, the buffer grows as required.
+ */
+typedef struct plcrash_text_buffer {
+    /** Buffered output. */
+    uint8_t *data;
+
+    /** Number of bytes of buffered output. */
+    size_t length;
+
+    /** Size of @a data, in bytes. */
+    size_t capacity;
+
+    /** The output file descriptor, or -1 if output is to be accumulated in memory. */
+    int fd;
+
+    /** The errno value of the first failed write or allocation, or 0. All output is discarded after a failure. */
+    int error;
+} plcrash_text_buffer_t;
+
+bool plcrash_text_buffer_init (plcrash_text_buffer_t *buffer, int fd);
+void plcrash_text_buffer_free (plcrash_text_buffer_t *buffer);
+bool plcrash_text_buffer_flush (plcrash_text_buffer_t *buffer);
+bool plcrash_text_buffer_reserve (plcrash_text_buffer_t *buffer, size_t needed);
+
+void plcrash_text_buffer_append (plcrash_text_buffer_t *buffer, const void *bytes, size_t length);
+void plcrash_text_buffer_append_cstring (plcrash_text_buffer_t *buffer, const char *cstring);
+void plcrash_text_buffer_append_padding (plcrash_text_buffer_t *buffer, size_t count);
+void plcrash_text_buffer_append_string (plcrash_text_buffer_t *buffer, NSString *string);
+void plcrash_text_buffer_append_hex (plcrash_text_buffer_t *buffer, uint64_t value, unsigned int minDigits);
+void plcrash_text_buffer_append_alternate_hex (plcrash_text_buffer_t *buffer, uint64_t value, size_t width);
+void plcrash_text_buffer_append_decimal (plcrash_text_buffer_t *buffer, int64_t value, size_t width);
+void plcrash_text_buffer_append_unsigned (plcrash_text_buffer_t *buffer, uint64_t value);
+void plcrash_text_buffer_append_last_path_component (plcrash_text_buffer_t *buffer, NSString *path, size_t width);
+
+#endif /* PLCRASH_TEXT_BUFFER_H */
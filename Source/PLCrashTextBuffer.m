@@ -0,0 +1,367 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashTextBuffer.h"
+
+#import <errno.h>
+#import <unistd.h>
+
+/**
+ * @internal
+ * @ingroup plcrash_internal
+ * @defgroup plcrash_text_buffer Formatted Text Output
+ *
+ * Implements the UTF-8 output buffer and hand-rolled number formatting shared by the report formatters.
+ * @{
+ */
+
+/**
+ * @internal
+ * Initialize @a buffer. If @a fd is not -1, output will be written to @a fd.
+ *
+ * @return Returns true on success, or false if the buffer could not be allocated.
+ */
+bool plcrash_text_buffer_init (plcrash_text_buffer_t *buffer, int fd) {
+    buffer->data = malloc(PLCRASH_TEXT_BUFFER_SIZE);
+    buffer->length = 0;
+    buffer->capacity = PLCRASH_TEXT_BUFFER_SIZE;
+    buffer->fd = fd;
+    buffer->error = 0;
+
+    return buffer->data != NULL;
+}
+
+/**
+ * @internal
+ * Free all resources associated with @a buffer. Any unflushed output is discarded.
+ */
+void plcrash_text_buffer_free (plcrash_text_buffer_t *buffer) {
+    free(buffer->data);
+    buffer->data = NULL;
+}
+
+/**
+ * @internal
+ * Write all buffered output to the buffer's file descriptor. Has no effect if output is accumulated in memory.
+ *
+ * @return Returns true on success, or false if a write error occurred.
+ */
+bool plcrash_text_buffer_flush (plcrash_text_buffer_t *buffer) {
+    if (buffer->fd == -1 || buffer->error != 0)
+        return buffer->error == 0;
+
+    size_t written = 0;
+    while (written < buffer->length) {
+        ssize_t result = write(buffer->fd, buffer->data + written, buffer->length - written);
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+
+            buffer->error = errno;
+            return false;
+        }
+
+        written += (size_t) result;
+    }
+
+    buffer->length = 0;
+    return true;
+}
+
+/**
+ * @internal
+ * Ensure that at least @a needed bytes are available in @a buffer, flushing or growing the buffer as required.
+ *
+ * @return Returns true on success, or false if the space could not be made available.
+ */
+bool plcrash_text_buffer_reserve (plcrash_text_buffer_t *buffer, size_t needed) {
+    if (buffer->error != 0)
+        return false;
+
+    if (buffer->capacity - buffer->length >= needed)
+        return true;
+
+    /* Flush to the file descriptor, if any */
+    if (buffer->fd != -1) {
+        if (!plcrash_text_buffer_flush(buffer))
+            return false;
+
+        if (buffer->capacity >= needed)
+            return true;
+    }
+
+    /* Grow the buffer */
+    size_t capacity = buffer->capacity;
+    while (capacity - buffer->length < needed) {
+        if (capacity > SIZE_MAX / 2) {
+            buffer->error = ENOMEM;
+            return false;
+        }
+        capacity *= 2;
+    }
+
+    uint8_t *data = realloc(buffer->data, capacity);
+    if (data == NULL) {
+        buffer->error = ENOMEM;
+        return false;
+    }
+
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return true;
+}
+
+/**
+ * @internal
+ * Append @a length bytes from @a bytes to @a buffer.
+ */
+void plcrash_text_buffer_append (plcrash_text_buffer_t *buffer, const void *bytes, size_t length) {
+    if (!plcrash_text_buffer_reserve(buffer, length))
+        return;
+
+    memcpy(buffer->data + buffer->length, bytes, length);
+    buffer->length += length;
+}
+
+/**
+ * @internal
+ * Append the NUL-terminated string @a cstring to @a buffer.
+ */
+void plcrash_text_buffer_append_cstring (plcrash_text_buffer_t *buffer, const char *cstring) {
+    plcrash_text_buffer_append(buffer, cstring, strlen(cstring));
+}
+
+/**
+ * @internal
+ * Append @a count space characters to @a buffer.
+ */
+void plcrash_text_buffer_append_padding (plcrash_text_buffer_t *buffer, size_t count) {
+    if (!plcrash_text_buffer_reserve(buffer, count))
+        return;
+
+    memset(buffer->data + buffer->length, ' ', count);
+    buffer->length += count;
+}
+
+/**
+ * @internal
+ * Append the UTF-8 representation of @a string to @a buffer, or "(null)" if @a string is nil.
+ */
+void plcrash_text_buffer_append_string (plcrash_text_buffer_t *buffer, NSString *string) {
+    if (string == nil) {
+        plcrash_text_buffer_append_cstring(buffer, "(null)");
+        return;
+    }
+
+    /* Use the string's backing store directly, if possible */
+    const char *cstring = CFStringGetCStringPtr((CFStringRef) string, kCFStringEncodingUTF8);
+    if (cstring != NULL) {
+        plcrash_text_buffer_append_cstring(buffer, cstring);
+        return;
+    }
+
+    NSUInteger maxLength = [string maximumLengthOfBytesUsingEncoding: NSUTF8StringEncoding];
+    if (!plcrash_text_buffer_reserve(buffer, maxLength))
+        return;
+
+    NSUInteger usedLength = 0;
+    [string getBytes: buffer->data + buffer->length
+           maxLength: maxLength
+          usedLength: &usedLength
+            encoding: NSUTF8StringEncoding
+             options: 0
+               range: NSMakeRange(0, [string length])
+      remainingRange: NULL];
+    buffer->length += usedLength;
+}
+
+/**
+ * @internal
+ * Format @a value as lowercase hexadecimal, zero-padded to at least @a minDigits digits.
+ *
+ * @param dest The destination buffer; must be at least 16 bytes.
+ *
+ * @return Returns the number of bytes written. The output is not NUL-terminated.
+ */
+static size_t text_format_hex (char *dest, uint64_t value, unsigned int minDigits) {
+    static const char digits[] = "0123456789abcdef";
+    char tmp[16];
+    size_t count = 0;
+
+    do {
+        tmp[count++] = digits[value & 0xF];
+        value >>= 4;
+    } while (value != 0);
+
+    while (count < minDigits && count < sizeof(tmp))
+        tmp[count++] = '0';
+
+    for (size_t i = 0; i < count; i++)
+        dest[i] = tmp[count - i - 1];
+
+    return count;
+}
+
+/**
+ * @internal
+ * Format @a value as a signed decimal.
+ *
+ * @param dest The destination buffer; must be at least 20 bytes.
+ *
+ * @return Returns the number of bytes written. The output is not NUL-terminated.
+ */
+static size_t text_format_decimal (char *dest, int64_t value) {
+    char tmp[20];
+    size_t count = 0;
+
+    /* Negate via unsigned arithmetic, so that INT64_MIN is handled */
+    uint64_t magnitude = value < 0 ? (uint64_t) 0 - (uint64_t) value : (uint64_t) value;
+    do {
+        tmp[count++] = '0' + (char) (magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    size_t length = 0;
+    if (value < 0)
+        dest[length++] = '-';
+
+    for (size_t i = 0; i < count; i++)
+        dest[length++] = tmp[count - i - 1];
+
+    return length;
+}
+
+/**
+ * @internal
+ * Append @a value to @a buffer as lowercase hexadecimal, zero-padded to at least @a minDigits digits.
+ */
+void plcrash_text_buffer_append_hex (plcrash_text_buffer_t *buffer, uint64_t value, unsigned int minDigits) {
+    char tmp[16];
+    plcrash_text_buffer_append(buffer, tmp, text_format_hex(tmp, value, minDigits));
+}
+
+/**
+ * @internal
+ * Append @a value to @a buffer in the printf "%#*llx" format: prefixed with "0x" if non-zero, and right-justified
+ * to @a width characters.
+ */
+void plcrash_text_buffer_append_alternate_hex (plcrash_text_buffer_t *buffer, uint64_t value, size_t width) {
+    char tmp[18];
+    size_t length = 0;
+
+    if (value != 0) {
+        tmp[length++] = '0';
+        tmp[length++] = 'x';
+    }
+    length += text_format_hex(tmp + length, value, 1);
+
+    if (length < width)
+        plcrash_text_buffer_append_padding(buffer, width - length);
+    plcrash_text_buffer_append(buffer, tmp, length);
+}
+
+/**
+ * @internal
+ * Append @a value to @a buffer as a signed decimal, left-justified to @a width characters.
+ */
+void plcrash_text_buffer_append_decimal (plcrash_text_buffer_t *buffer, int64_t value, size_t width) {
+    char tmp[20];
+    size_t length = text_format_decimal(tmp, value);
+
+    plcrash_text_buffer_append(buffer, tmp, length);
+    if (length < width)
+        plcrash_text_buffer_append_padding(buffer, width - length);
+}
+
+/**
+ * @internal
+ * Append @a value to @a buffer as an unsigned decimal.
+ */
+void plcrash_text_buffer_append_unsigned (plcrash_text_buffer_t *buffer, uint64_t value) {
+    char tmp[20];
+    size_t count = 0;
+
+    do {
+        tmp[count++] = '0' + (char) (value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    if (!plcrash_text_buffer_reserve(buffer, count))
+        return;
+
+    for (size_t i = 0; i < count; i++)
+        buffer->data[buffer->length++] = (uint8_t) tmp[count - i - 1];
+}
+
+/**
+ * @internal
+ * Append the last path component of @a path to @a buffer, left-justified to @a width UTF-16 code units. This
+ * matches the output of -[NSString lastPathComponent] without allocating a new string.
+ */
+void plcrash_text_buffer_append_last_path_component (plcrash_text_buffer_t *buffer, NSString *path, size_t width) {
+    const char *cstring = CFStringGetCStringPtr((CFStringRef) path, kCFStringEncodingUTF8);
+    if (cstring == NULL) {
+        /* Fall back on the string APIs */
+        NSString *component = [path lastPathComponent];
+        plcrash_text_buffer_append_string(buffer, component);
+        if ([component length] < width)
+            plcrash_text_buffer_append_padding(buffer, width - [component length]);
+        return;
+    }
+
+    /* Find the component, ignoring any trailing separators */
+    size_t end = strlen(cstring);
+    while (end > 1 && cstring[end - 1] == '/')
+        end--;
+
+    size_t start = end;
+    while (start > 0 && cstring[start - 1] != '/')
+        start--;
+
+    /* A path consisting only of separators is its own last component */
+    if (start == end && end > 0)
+        start--;
+
+    /* Count UTF-16 code units; four-byte UTF-8 sequences require a surrogate pair */
+    size_t units = 0;
+    for (size_t i = start; i < end; i++) {
+        uint8_t c = (uint8_t) cstring[i];
+        if ((c & 0xC0) != 0x80)
+            units++;
+        if (c >= 0xF0)
+            units++;
+    }
+
+    plcrash_text_buffer_append(buffer, cstring + start, end - start);
+    if (units < width)
+        plcrash_text_buffer_append_padding(buffer, width - units);
+}
+
+/**
+ * @}
+ */
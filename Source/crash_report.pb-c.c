@@ -85,12 +85,66 @@ void   plcrash__crash_report__machine_info__init
   static const Plcrash__CrashReport__MachineInfo init_value = PLCRASH__CRASH_REPORT__MACHINE_INFO__INIT;
   *message = init_value;
 }
+void   plcrash__crash_report__report_info__writer_diagnostics__thread_timing__init
+                     (Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming         *message)
+{
+  static const Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming init_value = PLCRASH__CRASH_REPORT__REPORT_INFO__WRITER_DIAGNOSTICS__THREAD_TIMING__INIT;
+  *message = init_value;
+}
+void   plcrash__crash_report__report_info__writer_diagnostics__init
+                     (Plcrash__CrashReport__ReportInfo__WriterDiagnostics         *message)
+{
+  static const Plcrash__CrashReport__ReportInfo__WriterDiagnostics init_value = PLCRASH__CRASH_REPORT__REPORT_INFO__WRITER_DIAGNOSTICS__INIT;
+  *message = init_value;
+}
 void   plcrash__crash_report__report_info__init
                      (Plcrash__CrashReport__ReportInfo         *message)
 {
   static const Plcrash__CrashReport__ReportInfo init_value = PLCRASH__CRASH_REPORT__REPORT_INFO__INIT;
   *message = init_value;
 }
+void   plcrash__crash_report__symbolication_diagnostics__init
+                     (Plcrash__CrashReport__SymbolicationDiagnostics         *message)
+{
+  static const Plcrash__CrashReport__SymbolicationDiagnostics init_value = PLCRASH__CRASH_REPORT__SYMBOLICATION_DIAGNOSTICS__INIT;
+  *message = init_value;
+}
+void   plcrash__crash_report__stack_samples__stack__init
+                     (Plcrash__CrashReport__StackSamples__Stack         *message)
+{
+  static const Plcrash__CrashReport__StackSamples__Stack init_value = PLCRASH__CRASH_REPORT__STACK_SAMPLES__STACK__INIT;
+  *message = init_value;
+}
+void   plcrash__crash_report__stack_samples__init
+                     (Plcrash__CrashReport__StackSamples         *message)
+{
+  static const Plcrash__CrashReport__StackSamples init_value = PLCRASH__CRASH_REPORT__STACK_SAMPLES__INIT;
+  *message = init_value;
+}
+void   plcrash__crash_report__base_report__init
+                     (Plcrash__CrashReport__BaseReport         *message)
+{
+  static const Plcrash__CrashReport__BaseReport init_value = PLCRASH__CRASH_REPORT__BASE_REPORT__INIT;
+  *message = init_value;
+}
+void   plcrash__crash_report__custom_data__init
+                     (Plcrash__CrashReport__CustomData         *message)
+{
+  static const Plcrash__CrashReport__CustomData init_value = PLCRASH__CRASH_REPORT__CUSTOM_DATA__INIT;
+  *message = init_value;
+}
+void   plcrash__crash_report__memory_statistics__region__init
+                     (Plcrash__CrashReport__MemoryStatistics__Region         *message)
+{
+  static const Plcrash__CrashReport__MemoryStatistics__Region init_value = PLCRASH__CRASH_REPORT__MEMORY_STATISTICS__REGION__INIT;
+  *message = init_value;
+}
+void   plcrash__crash_report__memory_statistics__init
+                     (Plcrash__CrashReport__MemoryStatistics         *message)
+{
+  static const Plcrash__CrashReport__MemoryStatistics init_value = PLCRASH__CRASH_REPORT__MEMORY_STATISTICS__INIT;
+  *message = init_value;
+}
 void   plcrash__crash_report__init
                      (Plcrash__CrashReport         *message)
 {
@@ -419,12 +473,12 @@ const ProtobufCMessageDescriptor plcrash__crash_report__application_info__descri
   (ProtobufCMessageInit) plcrash__crash_report__application_info__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-static const ProtobufCFieldDescriptor plcrash__crash_report__symbol__field_descriptors[3] =
+static const ProtobufCFieldDescriptor plcrash__crash_report__symbol__field_descriptors[4] =
 {
   {
     "name",
     1,
-    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_LABEL_OPTIONAL,
     PROTOBUF_C_TYPE_STRING,
     0,   /* quantifier_offset */
     offsetof(Plcrash__CrashReport__Symbol, name),
@@ -457,16 +511,29 @@ static const ProtobufCFieldDescriptor plcrash__crash_report__symbol__field_descr
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
+  {
+    "name_index",
+    4,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(Plcrash__CrashReport__Symbol, has_name_index),
+    offsetof(Plcrash__CrashReport__Symbol, name_index),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
 };
 static const unsigned plcrash__crash_report__symbol__field_indices_by_name[] = {
   2,   /* field[2] = end_address */
   0,   /* field[0] = name */
+  3,   /* field[3] = name_index */
   1,   /* field[1] = start_address */
 };
 static const ProtobufCIntRange plcrash__crash_report__symbol__number_ranges[1 + 1] =
 {
   { 1, 0 },
-  { 0, 3 }
+  { 0, 4 }
 };
 const ProtobufCMessageDescriptor plcrash__crash_report__symbol__descriptor =
 {
@@ -476,7 +543,7 @@ const ProtobufCMessageDescriptor plcrash__crash_report__symbol__descriptor =
   "Plcrash__CrashReport__Symbol",
   "plcrash",
   sizeof(Plcrash__CrashReport__Symbol),
-  3,
+  4,
   plcrash__crash_report__symbol__field_descriptors,
   plcrash__crash_report__symbol__field_indices_by_name,
   1,  plcrash__crash_report__symbol__number_ranges,
@@ -586,7 +653,7 @@ const ProtobufCMessageDescriptor plcrash__crash_report__thread__register_value__
   (ProtobufCMessageInit) plcrash__crash_report__thread__register_value__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-static const ProtobufCFieldDescriptor plcrash__crash_report__thread__field_descriptors[4] =
+static const ProtobufCFieldDescriptor plcrash__crash_report__thread__field_descriptors[19] =
 {
   {
     "thread_number",
@@ -636,17 +703,212 @@ static const ProtobufCFieldDescriptor plcrash__crash_report__thread__field_descr
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
+  {
+    "stack_address",
+    5,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Plcrash__CrashReport__Thread, has_stack_address),
+    offsetof(Plcrash__CrashReport__Thread, stack_address),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "stack_memory",
+    6,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BYTES,
+    offsetof(Plcrash__CrashReport__Thread, has_stack_memory),
+    offsetof(Plcrash__CrashReport__Thread, stack_memory),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "frame_pcs",
+    7,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Plcrash__CrashReport__Thread, n_frame_pcs),
+    offsetof(Plcrash__CrashReport__Thread, frame_pcs),
+    NULL,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_PACKED,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "frame_symbol_names",
+    8,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(Plcrash__CrashReport__Thread, n_frame_symbol_names),
+    offsetof(Plcrash__CrashReport__Thread, frame_symbol_names),
+    NULL,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_PACKED,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "frame_symbol_offsets",
+    9,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Plcrash__CrashReport__Thread, n_frame_symbol_offsets),
+    offsetof(Plcrash__CrashReport__Thread, frame_symbol_offsets),
+    NULL,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_PACKED,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "register_values",
+    10,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Plcrash__CrashReport__Thread, n_register_values),
+    offsetof(Plcrash__CrashReport__Thread, register_values),
+    NULL,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_PACKED,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "register_names",
+    11,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(Plcrash__CrashReport__Thread, n_register_names),
+    offsetof(Plcrash__CrashReport__Thread, register_names),
+    NULL,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_PACKED,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "frame_images",
+    12,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(Plcrash__CrashReport__Thread, n_frame_images),
+    offsetof(Plcrash__CrashReport__Thread, frame_images),
+    NULL,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_PACKED,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "register_state",
+    13,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Plcrash__CrashReport__Thread, n_register_state),
+    offsetof(Plcrash__CrashReport__Thread, register_state),
+    NULL,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_PACKED,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "name",
+    14,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_STRING,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__Thread, name),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "dispatch_queue",
+    15,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_STRING,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__Thread, dispatch_queue),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "qos_class",
+    16,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(Plcrash__CrashReport__Thread, has_qos_class),
+    offsetof(Plcrash__CrashReport__Thread, qos_class),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "user_time",
+    17,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Plcrash__CrashReport__Thread, has_user_time),
+    offsetof(Plcrash__CrashReport__Thread, user_time),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "system_time",
+    18,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Plcrash__CrashReport__Thread, has_system_time),
+    offsetof(Plcrash__CrashReport__Thread, system_time),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "thread_id",
+    19,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Plcrash__CrashReport__Thread, has_thread_id),
+    offsetof(Plcrash__CrashReport__Thread, thread_id),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
 };
 static const unsigned plcrash__crash_report__thread__field_indices_by_name[] = {
   2,   /* field[2] = crashed */
+  14,   /* field[14] = dispatch_queue */
+  11,   /* field[11] = frame_images */
+  6,   /* field[6] = frame_pcs */
+  7,   /* field[7] = frame_symbol_names */
+  8,   /* field[8] = frame_symbol_offsets */
   1,   /* field[1] = frames */
+  13,   /* field[13] = name */
+  15,   /* field[15] = qos_class */
+  10,   /* field[10] = register_names */
+  12,   /* field[12] = register_state */
+  9,   /* field[9] = register_values */
   3,   /* field[3] = registers */
+  4,   /* field[4] = stack_address */
+  5,   /* field[5] = stack_memory */
+  17,   /* field[17] = system_time */
+  18,   /* field[18] = thread_id */
   0,   /* field[0] = thread_number */
+  16,   /* field[16] = user_time */
 };
 static const ProtobufCIntRange plcrash__crash_report__thread__number_ranges[1 + 1] =
 {
   { 1, 0 },
-  { 0, 4 }
+  { 0, 19 }
 };
 const ProtobufCMessageDescriptor plcrash__crash_report__thread__descriptor =
 {
@@ -656,7 +918,7 @@ const ProtobufCMessageDescriptor plcrash__crash_report__thread__descriptor =
   "Plcrash__CrashReport__Thread",
   "plcrash",
   sizeof(Plcrash__CrashReport__Thread),
-  4,
+  19,
   plcrash__crash_report__thread__field_descriptors,
   plcrash__crash_report__thread__field_indices_by_name,
   1,  plcrash__crash_report__thread__number_ranges,
@@ -945,7 +1207,7 @@ const ProtobufCMessageDescriptor plcrash__crash_report__signal__descriptor =
   (ProtobufCMessageInit) plcrash__crash_report__signal__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-static const ProtobufCFieldDescriptor plcrash__crash_report__process_info__field_descriptors[7] =
+static const ProtobufCFieldDescriptor plcrash__crash_report__process_info__field_descriptors[9] =
 {
   {
     "process_name",
@@ -1031,6 +1293,30 @@ static const ProtobufCFieldDescriptor plcrash__crash_report__process_info__field
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
+  {
+    "shared_cache_uuid",
+    8,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BYTES,
+    offsetof(Plcrash__CrashReport__ProcessInfo, has_shared_cache_uuid),
+    offsetof(Plcrash__CrashReport__ProcessInfo, shared_cache_uuid),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "shared_cache_base_address",
+    9,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Plcrash__CrashReport__ProcessInfo, has_shared_cache_base_address),
+    offsetof(Plcrash__CrashReport__ProcessInfo, shared_cache_base_address),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
 };
 static const unsigned plcrash__crash_report__process_info__field_indices_by_name[] = {
   5,   /* field[5] = native */
@@ -1039,12 +1325,14 @@ static const unsigned plcrash__crash_report__process_info__field_indices_by_name
   1,   /* field[1] = process_id */
   0,   /* field[0] = process_name */
   2,   /* field[2] = process_path */
+  8,   /* field[8] = shared_cache_base_address */
+  7,   /* field[7] = shared_cache_uuid */
   6,   /* field[6] = start_time */
 };
 static const ProtobufCIntRange plcrash__crash_report__process_info__number_ranges[1 + 1] =
 {
   { 1, 0 },
-  { 0, 7 }
+  { 0, 9 }
 };
 const ProtobufCMessageDescriptor plcrash__crash_report__process_info__descriptor =
 {
@@ -1054,7 +1342,7 @@ const ProtobufCMessageDescriptor plcrash__crash_report__process_info__descriptor
   "Plcrash__CrashReport__ProcessInfo",
   "plcrash",
   sizeof(Plcrash__CrashReport__ProcessInfo),
-  7,
+  9,
   plcrash__crash_report__process_info__field_descriptors,
   plcrash__crash_report__process_info__field_indices_by_name,
   1,  plcrash__crash_report__process_info__number_ranges,
@@ -1138,91 +1426,836 @@ const ProtobufCMessageDescriptor plcrash__crash_report__machine_info__descriptor
   (ProtobufCMessageInit) plcrash__crash_report__machine_info__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-static const ProtobufCFieldDescriptor plcrash__crash_report__report_info__field_descriptors[2] =
+static const ProtobufCFieldDescriptor plcrash__crash_report__report_info__writer_diagnostics__thread_timing__field_descriptors[4] =
 {
   {
-    "user_requested",
+    "thread_number",
     1,
     PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_BOOL,
+    PROTOBUF_C_TYPE_UINT32,
     0,   /* quantifier_offset */
-    offsetof(Plcrash__CrashReport__ReportInfo, user_requested),
+    offsetof(Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming, thread_number),
     NULL,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
   {
-    "uuid",
+    "frame_count",
     2,
-    PROTOBUF_C_LABEL_OPTIONAL,
-    PROTOBUF_C_TYPE_BYTES,
-    offsetof(Plcrash__CrashReport__ReportInfo, has_uuid),
-    offsetof(Plcrash__CrashReport__ReportInfo, uuid),
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming, frame_count),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "walk_time",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming, walk_time),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "symbolication_time",
+    4,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming, symbolication_time),
     NULL,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
 };
-static const unsigned plcrash__crash_report__report_info__field_indices_by_name[] = {
-  0,   /* field[0] = user_requested */
-  1,   /* field[1] = uuid */
+static const unsigned plcrash__crash_report__report_info__writer_diagnostics__thread_timing__field_indices_by_name[] = {
+  1,   /* field[1] = frame_count */
+  3,   /* field[3] = symbolication_time */
+  0,   /* field[0] = thread_number */
+  2,   /* field[2] = walk_time */
 };
-static const ProtobufCIntRange plcrash__crash_report__report_info__number_ranges[1 + 1] =
+static const ProtobufCIntRange plcrash__crash_report__report_info__writer_diagnostics__thread_timing__number_ranges[1 + 1] =
 {
   { 1, 0 },
-  { 0, 2 }
+  { 0, 4 }
 };
-const ProtobufCMessageDescriptor plcrash__crash_report__report_info__descriptor =
+const ProtobufCMessageDescriptor plcrash__crash_report__report_info__writer_diagnostics__thread_timing__descriptor =
 {
   PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "plcrash.CrashReport.ReportInfo",
-  "ReportInfo",
-  "Plcrash__CrashReport__ReportInfo",
+  "plcrash.CrashReport.ReportInfo.WriterDiagnostics.ThreadTiming",
+  "ThreadTiming",
+  "Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming",
   "plcrash",
-  sizeof(Plcrash__CrashReport__ReportInfo),
-  2,
-  plcrash__crash_report__report_info__field_descriptors,
-  plcrash__crash_report__report_info__field_indices_by_name,
-  1,  plcrash__crash_report__report_info__number_ranges,
-  (ProtobufCMessageInit) plcrash__crash_report__report_info__init,
+  sizeof(Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming),
+  4,
+  plcrash__crash_report__report_info__writer_diagnostics__thread_timing__field_descriptors,
+  plcrash__crash_report__report_info__writer_diagnostics__thread_timing__field_indices_by_name,
+  1,  plcrash__crash_report__report_info__writer_diagnostics__thread_timing__number_ranges,
+  (ProtobufCMessageInit) plcrash__crash_report__report_info__writer_diagnostics__thread_timing__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-static const ProtobufCFieldDescriptor plcrash__crash_report__field_descriptors[9] =
+static const ProtobufCFieldDescriptor plcrash__crash_report__report_info__writer_diagnostics__field_descriptors[4] =
 {
   {
-    "system_info",
+    "suspend_time",
     1,
     PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_MESSAGE,
+    PROTOBUF_C_TYPE_UINT64,
     0,   /* quantifier_offset */
-    offsetof(Plcrash__CrashReport, system_info),
-    &plcrash__crash_report__system_info__descriptor,
+    offsetof(Plcrash__CrashReport__ReportInfo__WriterDiagnostics, suspend_time),
+    NULL,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
   {
-    "application_info",
+    "threads",
     2,
-    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_LABEL_REPEATED,
     PROTOBUF_C_TYPE_MESSAGE,
-    0,   /* quantifier_offset */
-    offsetof(Plcrash__CrashReport, application_info),
-    &plcrash__crash_report__application_info__descriptor,
+    offsetof(Plcrash__CrashReport__ReportInfo__WriterDiagnostics, n_threads),
+    offsetof(Plcrash__CrashReport__ReportInfo__WriterDiagnostics, threads),
+    &plcrash__crash_report__report_info__writer_diagnostics__thread_timing__descriptor,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
   {
-    "threads",
+    "image_time",
     3,
-    PROTOBUF_C_LABEL_REPEATED,
-    PROTOBUF_C_TYPE_MESSAGE,
-    offsetof(Plcrash__CrashReport, n_threads),
-    offsetof(Plcrash__CrashReport, threads),
-    &plcrash__crash_report__thread__descriptor,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__ReportInfo__WriterDiagnostics, image_time),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "total_time",
+    4,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__ReportInfo__WriterDiagnostics, total_time),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned plcrash__crash_report__report_info__writer_diagnostics__field_indices_by_name[] = {
+  2,   /* field[2] = image_time */
+  0,   /* field[0] = suspend_time */
+  1,   /* field[1] = threads */
+  3,   /* field[3] = total_time */
+};
+static const ProtobufCIntRange plcrash__crash_report__report_info__writer_diagnostics__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 4 }
+};
+const ProtobufCMessageDescriptor plcrash__crash_report__report_info__writer_diagnostics__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "plcrash.CrashReport.ReportInfo.WriterDiagnostics",
+  "WriterDiagnostics",
+  "Plcrash__CrashReport__ReportInfo__WriterDiagnostics",
+  "plcrash",
+  sizeof(Plcrash__CrashReport__ReportInfo__WriterDiagnostics),
+  4,
+  plcrash__crash_report__report_info__writer_diagnostics__field_descriptors,
+  plcrash__crash_report__report_info__writer_diagnostics__field_indices_by_name,
+  1,  plcrash__crash_report__report_info__writer_diagnostics__number_ranges,
+  (ProtobufCMessageInit) plcrash__crash_report__report_info__writer_diagnostics__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor plcrash__crash_report__report_info__field_descriptors[3] =
+{
+  {
+    "user_requested",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_BOOL,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__ReportInfo, user_requested),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "uuid",
+    2,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BYTES,
+    offsetof(Plcrash__CrashReport__ReportInfo, has_uuid),
+    offsetof(Plcrash__CrashReport__ReportInfo, uuid),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "writer_diagnostics",
+    3,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__ReportInfo, writer_diagnostics),
+    &plcrash__crash_report__report_info__writer_diagnostics__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned plcrash__crash_report__report_info__field_indices_by_name[] = {
+  0,   /* field[0] = user_requested */
+  1,   /* field[1] = uuid */
+  2,   /* field[2] = writer_diagnostics */
+};
+static const ProtobufCIntRange plcrash__crash_report__report_info__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 3 }
+};
+const ProtobufCMessageDescriptor plcrash__crash_report__report_info__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "plcrash.CrashReport.ReportInfo",
+  "ReportInfo",
+  "Plcrash__CrashReport__ReportInfo",
+  "plcrash",
+  sizeof(Plcrash__CrashReport__ReportInfo),
+  3,
+  plcrash__crash_report__report_info__field_descriptors,
+  plcrash__crash_report__report_info__field_indices_by_name,
+  1,  plcrash__crash_report__report_info__number_ranges,
+  (ProtobufCMessageInit) plcrash__crash_report__report_info__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor plcrash__crash_report__symbolication_diagnostics__field_descriptors[8] =
+{
+  {
+    "lookups",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__SymbolicationDiagnostics, lookups),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "cache_hits",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__SymbolicationDiagnostics, cache_hits),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "symbols_scanned",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__SymbolicationDiagnostics, symbols_scanned),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "objc_classes_parsed",
+    4,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__SymbolicationDiagnostics, objc_classes_parsed),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "symbol_table_lookups",
+    5,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__SymbolicationDiagnostics, symbol_table_lookups),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "symbol_table_time",
+    6,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__SymbolicationDiagnostics, symbol_table_time),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "objc_lookups",
+    7,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__SymbolicationDiagnostics, objc_lookups),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "objc_time",
+    8,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__SymbolicationDiagnostics, objc_time),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned plcrash__crash_report__symbolication_diagnostics__field_indices_by_name[] = {
+  1,   /* field[1] = cache_hits */
+  0,   /* field[0] = lookups */
+  3,   /* field[3] = objc_classes_parsed */
+  6,   /* field[6] = objc_lookups */
+  7,   /* field[7] = objc_time */
+  4,   /* field[4] = symbol_table_lookups */
+  5,   /* field[5] = symbol_table_time */
+  2,   /* field[2] = symbols_scanned */
+};
+static const ProtobufCIntRange plcrash__crash_report__symbolication_diagnostics__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 8 }
+};
+const ProtobufCMessageDescriptor plcrash__crash_report__symbolication_diagnostics__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "plcrash.CrashReport.SymbolicationDiagnostics",
+  "SymbolicationDiagnostics",
+  "Plcrash__CrashReport__SymbolicationDiagnostics",
+  "plcrash",
+  sizeof(Plcrash__CrashReport__SymbolicationDiagnostics),
+  8,
+  plcrash__crash_report__symbolication_diagnostics__field_descriptors,
+  plcrash__crash_report__symbolication_diagnostics__field_indices_by_name,
+  1,  plcrash__crash_report__symbolication_diagnostics__number_ranges,
+  (ProtobufCMessageInit) plcrash__crash_report__symbolication_diagnostics__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor plcrash__crash_report__stack_samples__stack__field_descriptors[3] =
+{
+  {
+    "thread_index",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__StackSamples__Stack, thread_index),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "count",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__StackSamples__Stack, count),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "pcs",
+    3,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Plcrash__CrashReport__StackSamples__Stack, n_pcs),
+    offsetof(Plcrash__CrashReport__StackSamples__Stack, pcs),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned plcrash__crash_report__stack_samples__stack__field_indices_by_name[] = {
+  1,   /* field[1] = count */
+  2,   /* field[2] = pcs */
+  0,   /* field[0] = thread_index */
+};
+static const ProtobufCIntRange plcrash__crash_report__stack_samples__stack__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 3 }
+};
+const ProtobufCMessageDescriptor plcrash__crash_report__stack_samples__stack__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "plcrash.CrashReport.StackSamples.Stack",
+  "Stack",
+  "Plcrash__CrashReport__StackSamples__Stack",
+  "plcrash",
+  sizeof(Plcrash__CrashReport__StackSamples__Stack),
+  3,
+  plcrash__crash_report__stack_samples__stack__field_descriptors,
+  plcrash__crash_report__stack_samples__stack__field_indices_by_name,
+  1,  plcrash__crash_report__stack_samples__stack__number_ranges,
+  (ProtobufCMessageInit) plcrash__crash_report__stack_samples__stack__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor plcrash__crash_report__stack_samples__field_descriptors[4] =
+{
+  {
+    "interval",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__StackSamples, interval),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "sample_count",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__StackSamples, sample_count),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "evicted_count",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__StackSamples, evicted_count),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "stacks",
+    4,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(Plcrash__CrashReport__StackSamples, n_stacks),
+    offsetof(Plcrash__CrashReport__StackSamples, stacks),
+    &plcrash__crash_report__stack_samples__stack__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned plcrash__crash_report__stack_samples__field_indices_by_name[] = {
+  2,   /* field[2] = evicted_count */
+  0,   /* field[0] = interval */
+  1,   /* field[1] = sample_count */
+  3,   /* field[3] = stacks */
+};
+static const ProtobufCIntRange plcrash__crash_report__stack_samples__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 4 }
+};
+const ProtobufCMessageDescriptor plcrash__crash_report__stack_samples__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "plcrash.CrashReport.StackSamples",
+  "StackSamples",
+  "Plcrash__CrashReport__StackSamples",
+  "plcrash",
+  sizeof(Plcrash__CrashReport__StackSamples),
+  4,
+  plcrash__crash_report__stack_samples__field_descriptors,
+  plcrash__crash_report__stack_samples__field_indices_by_name,
+  1,  plcrash__crash_report__stack_samples__number_ranges,
+  (ProtobufCMessageInit) plcrash__crash_report__stack_samples__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor plcrash__crash_report__base_report__field_descriptors[2] =
+{
+  {
+    "uuid",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_BYTES,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__BaseReport, uuid),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "thread_count",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__BaseReport, thread_count),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned plcrash__crash_report__base_report__field_indices_by_name[] = {
+  1,   /* field[1] = thread_count */
+  0,   /* field[0] = uuid */
+};
+static const ProtobufCIntRange plcrash__crash_report__base_report__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 2 }
+};
+const ProtobufCMessageDescriptor plcrash__crash_report__base_report__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "plcrash.CrashReport.BaseReport",
+  "BaseReport",
+  "Plcrash__CrashReport__BaseReport",
+  "plcrash",
+  sizeof(Plcrash__CrashReport__BaseReport),
+  2,
+  plcrash__crash_report__base_report__field_descriptors,
+  plcrash__crash_report__base_report__field_indices_by_name,
+  1,  plcrash__crash_report__base_report__number_ranges,
+  (ProtobufCMessageInit) plcrash__crash_report__base_report__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor plcrash__crash_report__custom_data__field_descriptors[2] =
+{
+  {
+    "key_value_area",
+    1,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BYTES,
+    offsetof(Plcrash__CrashReport__CustomData, has_key_value_area),
+    offsetof(Plcrash__CrashReport__CustomData, key_value_area),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "breadcrumbs",
+    2,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BYTES,
+    offsetof(Plcrash__CrashReport__CustomData, has_breadcrumbs),
+    offsetof(Plcrash__CrashReport__CustomData, breadcrumbs),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned plcrash__crash_report__custom_data__field_indices_by_name[] = {
+  1,   /* field[1] = breadcrumbs */
+  0,   /* field[0] = key_value_area */
+};
+static const ProtobufCIntRange plcrash__crash_report__custom_data__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 2 }
+};
+const ProtobufCMessageDescriptor plcrash__crash_report__custom_data__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "plcrash.CrashReport.CustomData",
+  "CustomData",
+  "Plcrash__CrashReport__CustomData",
+  "plcrash",
+  sizeof(Plcrash__CrashReport__CustomData),
+  2,
+  plcrash__crash_report__custom_data__field_descriptors,
+  plcrash__crash_report__custom_data__field_indices_by_name,
+  1,  plcrash__crash_report__custom_data__number_ranges,
+  (ProtobufCMessageInit) plcrash__crash_report__custom_data__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor plcrash__crash_report__memory_statistics__region__field_descriptors[4] =
+{
+  {
+    "address",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__MemoryStatistics__Region, address),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "size",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__MemoryStatistics__Region, size),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "protection",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__MemoryStatistics__Region, protection),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "user_tag",
+    4,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__MemoryStatistics__Region, user_tag),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned plcrash__crash_report__memory_statistics__region__field_indices_by_name[] = {
+  0,   /* field[0] = address */
+  2,   /* field[2] = protection */
+  1,   /* field[1] = size */
+  3,   /* field[3] = user_tag */
+};
+static const ProtobufCIntRange plcrash__crash_report__memory_statistics__region__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 4 }
+};
+const ProtobufCMessageDescriptor plcrash__crash_report__memory_statistics__region__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "plcrash.CrashReport.MemoryStatistics.Region",
+  "Region",
+  "Plcrash__CrashReport__MemoryStatistics__Region",
+  "plcrash",
+  sizeof(Plcrash__CrashReport__MemoryStatistics__Region),
+  4,
+  plcrash__crash_report__memory_statistics__region__field_descriptors,
+  plcrash__crash_report__memory_statistics__region__field_indices_by_name,
+  1,  plcrash__crash_report__memory_statistics__region__number_ranges,
+  (ProtobufCMessageInit) plcrash__crash_report__memory_statistics__region__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor plcrash__crash_report__memory_statistics__field_descriptors[8] =
+{
+  {
+    "phys_footprint",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__MemoryStatistics, phys_footprint),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "resident_size",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__MemoryStatistics, resident_size),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "resident_size_peak",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__MemoryStatistics, resident_size_peak),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "compressed_size",
+    4,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__MemoryStatistics, compressed_size),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "virtual_size",
+    5,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__MemoryStatistics, virtual_size),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "region_count",
+    6,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport__MemoryStatistics, region_count),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "largest_regions",
+    7,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(Plcrash__CrashReport__MemoryStatistics, n_largest_regions),
+    offsetof(Plcrash__CrashReport__MemoryStatistics, largest_regions),
+    &plcrash__crash_report__memory_statistics__region__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "regions_truncated",
+    8,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BOOL,
+    offsetof(Plcrash__CrashReport__MemoryStatistics, has_regions_truncated),
+    offsetof(Plcrash__CrashReport__MemoryStatistics, regions_truncated),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned plcrash__crash_report__memory_statistics__field_indices_by_name[] = {
+  3,   /* field[3] = compressed_size */
+  6,   /* field[6] = largest_regions */
+  0,   /* field[0] = phys_footprint */
+  5,   /* field[5] = region_count */
+  7,   /* field[7] = regions_truncated */
+  1,   /* field[1] = resident_size */
+  2,   /* field[2] = resident_size_peak */
+  4,   /* field[4] = virtual_size */
+};
+static const ProtobufCIntRange plcrash__crash_report__memory_statistics__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 8 }
+};
+const ProtobufCMessageDescriptor plcrash__crash_report__memory_statistics__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "plcrash.CrashReport.MemoryStatistics",
+  "MemoryStatistics",
+  "Plcrash__CrashReport__MemoryStatistics",
+  "plcrash",
+  sizeof(Plcrash__CrashReport__MemoryStatistics),
+  8,
+  plcrash__crash_report__memory_statistics__field_descriptors,
+  plcrash__crash_report__memory_statistics__field_indices_by_name,
+  1,  plcrash__crash_report__memory_statistics__number_ranges,
+  (ProtobufCMessageInit) plcrash__crash_report__memory_statistics__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor plcrash__crash_report__field_descriptors[17] =
+{
+  {
+    "system_info",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport, system_info),
+    &plcrash__crash_report__system_info__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "application_info",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport, application_info),
+    &plcrash__crash_report__application_info__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "threads",
+    3,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(Plcrash__CrashReport, n_threads),
+    offsetof(Plcrash__CrashReport, threads),
+    &plcrash__crash_report__thread__descriptor,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
@@ -1299,22 +2332,126 @@ static const ProtobufCFieldDescriptor plcrash__crash_report__field_descriptors[9
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
+  {
+    "symbol_names",
+    10,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_STRING,
+    offsetof(Plcrash__CrashReport, n_symbol_names),
+    offsetof(Plcrash__CrashReport, symbol_names),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "symbolication_diagnostics",
+    11,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport, symbolication_diagnostics),
+    &plcrash__crash_report__symbolication_diagnostics__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "omitted_image_count",
+    12,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(Plcrash__CrashReport, has_omitted_image_count),
+    offsetof(Plcrash__CrashReport, omitted_image_count),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "omitted_image_hash",
+    13,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Plcrash__CrashReport, has_omitted_image_hash),
+    offsetof(Plcrash__CrashReport, omitted_image_hash),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "stack_samples",
+    14,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport, stack_samples),
+    &plcrash__crash_report__stack_samples__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "base_report",
+    15,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport, base_report),
+    &plcrash__crash_report__base_report__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "custom_data",
+    16,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport, custom_data),
+    &plcrash__crash_report__custom_data__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "memory_statistics",
+    17,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(Plcrash__CrashReport, memory_statistics),
+    &plcrash__crash_report__memory_statistics__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
 };
 static const unsigned plcrash__crash_report__field_indices_by_name[] = {
   1,   /* field[1] = application_info */
+  14,   /* field[14] = base_report */
   3,   /* field[3] = binary_images */
+  15,   /* field[15] = custom_data */
   4,   /* field[4] = exception */
   7,   /* field[7] = machine_info */
+  16,   /* field[16] = memory_statistics */
+  11,   /* field[11] = omitted_image_count */
+  12,   /* field[12] = omitted_image_hash */
   6,   /* field[6] = process_info */
   8,   /* field[8] = report_info */
   5,   /* field[5] = signal */
+  13,   /* field[13] = stack_samples */
+  9,   /* field[9] = symbol_names */
+  10,   /* field[10] = symbolication_diagnostics */
   0,   /* field[0] = system_info */
   2,   /* field[2] = threads */
 };
 static const ProtobufCIntRange plcrash__crash_report__number_ranges[1 + 1] =
 {
   { 1, 0 },
-  { 0, 9 }
+  { 0, 17 }
 };
 const ProtobufCMessageDescriptor plcrash__crash_report__descriptor =
 {
@@ -1324,7 +2461,7 @@ const ProtobufCMessageDescriptor plcrash__crash_report__descriptor =
   "Plcrash__CrashReport",
   "plcrash",
   sizeof(Plcrash__CrashReport),
-  9,
+  17,
   plcrash__crash_report__field_descriptors,
   plcrash__crash_report__field_indices_by_name,
   1,  plcrash__crash_report__number_ranges,
@@ -30,6 +30,15 @@ typedef struct _Plcrash__CrashReport__Signal__MachException Plcrash__CrashReport
 typedef struct _Plcrash__CrashReport__ProcessInfo Plcrash__CrashReport__ProcessInfo;
 typedef struct _Plcrash__CrashReport__MachineInfo Plcrash__CrashReport__MachineInfo;
 typedef struct _Plcrash__CrashReport__ReportInfo Plcrash__CrashReport__ReportInfo;
+typedef struct _Plcrash__CrashReport__ReportInfo__WriterDiagnostics Plcrash__CrashReport__ReportInfo__WriterDiagnostics;
+typedef struct _Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming;
+typedef struct _Plcrash__CrashReport__SymbolicationDiagnostics Plcrash__CrashReport__SymbolicationDiagnostics;
+typedef struct _Plcrash__CrashReport__StackSamples Plcrash__CrashReport__StackSamples;
+typedef struct _Plcrash__CrashReport__StackSamples__Stack Plcrash__CrashReport__StackSamples__Stack;
+typedef struct _Plcrash__CrashReport__BaseReport Plcrash__CrashReport__BaseReport;
+typedef struct _Plcrash__CrashReport__CustomData Plcrash__CrashReport__CustomData;
+typedef struct _Plcrash__CrashReport__MemoryStatistics Plcrash__CrashReport__MemoryStatistics;
+typedef struct _Plcrash__CrashReport__MemoryStatistics__Region Plcrash__CrashReport__MemoryStatistics__Region;
 
 
 /* --- enums --- */
@@ -205,7 +214,8 @@ struct  _Plcrash__CrashReport__Symbol
 {
   ProtobufCMessage base;
   /*
-   * The symbol name 
+   * The symbol name. Either this field or name_index must be included. This field was required prior to
+   * the introduction of name_index; readers that predate name_index will reject symbols that omit it. 
    */
   char *name;
   /*
@@ -219,10 +229,16 @@ struct  _Plcrash__CrashReport__Symbol
    */
   protobuf_c_boolean has_end_address;
   uint64_t end_address;
+  /*
+   * The index of the symbol name within the report's symbol_names table. If included, the name field
+   * will be omitted. 
+   */
+  protobuf_c_boolean has_name_index;
+  uint32_t name_index;
 };
 #define PLCRASH__CRASH_REPORT__SYMBOL__INIT \
  { PROTOBUF_C_MESSAGE_INIT (&plcrash__crash_report__symbol__descriptor) \
-    , NULL, 0, 0, 0 }
+    , NULL, 0, 0, 0, 0, 0 }
 
 
 /*
@@ -298,10 +314,92 @@ struct  _Plcrash__CrashReport__Thread
    */
   size_t n_registers;
   Plcrash__CrashReport__Thread__RegisterValue **registers;
+  /*
+   * The address of the first byte of stack_memory. Included only in raw capture reports. 
+   */
+  protobuf_c_boolean has_stack_address;
+  uint64_t stack_address;
+  /*
+   * A bounded copy of the thread's stack memory, starting at the thread's stack pointer. Raw capture reports
+   * omit the frames list; the backtrace is recovered from the registers and this stack memory when the
+   * report is decoded. 
+   */
+  protobuf_c_boolean has_stack_memory;
+  ProtobufCBinaryData stack_memory;
+  /*
+   * Backtrace frame PCs. If the corresponding frame_images entry is non-zero, the PC is written as an offset
+   * from the base address of the referenced image. 
+   */
+  size_t n_frame_pcs;
+  uint64_t *frame_pcs;
+  /*
+   * For each entry in frame_pcs, 0 if the frame has no symbol information, or one greater than the index of
+   * the frame symbol's name within the symbol_names table. 
+   */
+  size_t n_frame_symbol_names;
+  uint32_t *frame_symbol_names;
+  /*
+   * For each entry in frame_pcs, the offset of the PC from the frame symbol's start address. Undefined if
+   * the frame has no symbol information. 
+   */
+  size_t n_frame_symbol_offsets;
+  uint64_t *frame_symbol_offsets;
+  /*
+   * Register values. 
+   */
+  size_t n_register_values;
+  uint64_t *register_values;
+  /*
+   * For each entry in register_values, the index of the register's name within the symbol_names table. 
+   */
+  size_t n_register_names;
+  uint32_t *register_names;
+  /*
+   * For each entry in frame_pcs, 0 if the PC is absolute, or one greater than the index within binary_images
+   * of the image containing the frame's PC. 
+   */
+  size_t n_frame_images;
+  uint32_t *frame_images;
+  /*
+   * Register values, in the canonical register order of the report's architecture (as defined by
+   * plcrash_regnum_t), without register names. Written in place of registers or register_values for all threads
+   * when compact register encoding is enabled. Register names are derived from the architecture of the report's
+   * binary images when the report is decoded. 
+   */
+  size_t n_register_state;
+  uint64_t *register_state;
+  /*
+   * The thread's pthread name. 
+   */
+  char *name;
+  /*
+   * The label of the dispatch queue the thread was executing, if any. 
+   */
+  char *dispatch_queue;
+  /*
+   * The thread's QoS class, as a qos_class_t value. 
+   */
+  protobuf_c_boolean has_qos_class;
+  uint32_t qos_class;
+  /*
+   * The thread's total user CPU time, in nanoseconds. 
+   */
+  protobuf_c_boolean has_user_time;
+  uint64_t user_time;
+  /*
+   * The thread's total system CPU time, in nanoseconds. 
+   */
+  protobuf_c_boolean has_system_time;
+  uint64_t system_time;
+  /*
+   * The thread's system-wide unique identifier, as returned by pthread_threadid_np(). 
+   */
+  protobuf_c_boolean has_thread_id;
+  uint64_t thread_id;
 };
 #define PLCRASH__CRASH_REPORT__THREAD__INIT \
  { PROTOBUF_C_MESSAGE_INIT (&plcrash__crash_report__thread__descriptor) \
-    , 0, 0,NULL, 0, 0,NULL }
+    , 0, 0,NULL, 0, 0,NULL, 0,0, 0,{0,NULL}, 0,NULL, 0,NULL, 0,NULL, 0,NULL, 0,NULL, 0,NULL, 0,NULL, NULL, NULL, 0,0, 0,0, 0,0, 0,0 }
 
 
 /*
@@ -458,10 +556,21 @@ struct  _Plcrash__CrashReport__ProcessInfo
    */
   protobuf_c_boolean has_start_time;
   uint64_t start_time;
+  /*
+   * The UUID of the dyld shared cache mapped into the process, if any. Images loaded from the shared cache
+   * share this cache; the field may be omitted if the shared cache can not be determined. 
+   */
+  protobuf_c_boolean has_shared_cache_uuid;
+  ProtobufCBinaryData shared_cache_uuid;
+  /*
+   * The address at which the dyld shared cache is mapped. May be omitted if unavailable. 
+   */
+  protobuf_c_boolean has_shared_cache_base_address;
+  uint64_t shared_cache_base_address;
 };
 #define PLCRASH__CRASH_REPORT__PROCESS_INFO__INIT \
  { PROTOBUF_C_MESSAGE_INIT (&plcrash__crash_report__process_info__descriptor) \
-    , NULL, 0, NULL, NULL, 0, 0, 0, 0 }
+    , NULL, 0, NULL, NULL, 0, 0, 0, 0, 0, {0,NULL}, 0, 0 }
 
 
 /*
@@ -496,6 +605,65 @@ struct  _Plcrash__CrashReport__MachineInfo
     , NULL, NULL, 0, 0 }
 
 
+/*
+ * The timing of a single thread 
+ */
+struct  _Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming
+{
+  ProtobufCMessage base;
+  /*
+   ** The thread's number. 
+   */
+  uint32_t thread_number;
+  /*
+   ** Number of frames walked. 
+   */
+  uint32_t frame_count;
+  /*
+   ** Time spent walking the thread's stack, in nanoseconds. 
+   */
+  uint64_t walk_time;
+  /*
+   ** Time spent symbolicating and writing the thread, including its referenced images, in nanoseconds. 
+   */
+  uint64_t symbolication_time;
+};
+#define PLCRASH__CRASH_REPORT__REPORT_INFO__WRITER_DIAGNOSTICS__THREAD_TIMING__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&plcrash__crash_report__report_info__writer_diagnostics__thread_timing__descriptor) \
+    , 0, 0, 0, 0 }
+
+
+/*
+ * Crash path timing of the report writer 
+ */
+struct  _Plcrash__CrashReport__ReportInfo__WriterDiagnostics
+{
+  ProtobufCMessage base;
+  /*
+   ** Time spent suspending all other threads, in nanoseconds. 
+   */
+  uint64_t suspend_time;
+  /*
+   ** The timing of each written thread, in the order in which the threads were written. Threads beyond
+   * the writer's timing limit are omitted. 
+   */
+  size_t n_threads;
+  Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming **threads;
+  /*
+   ** Time spent writing the binary images not referenced by any thread, in nanoseconds. 
+   */
+  uint64_t image_time;
+  /*
+   ** Time elapsed from the start of the report until the diagnostics were written, in nanoseconds. The final
+   * flush of the report to disk is not included. 
+   */
+  uint64_t total_time;
+};
+#define PLCRASH__CRASH_REPORT__REPORT_INFO__WRITER_DIAGNOSTICS__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&plcrash__crash_report__report_info__writer_diagnostics__descriptor) \
+    , 0, 0,NULL, 0, 0 }
+
+
 /*
  * Report format information
  */
@@ -512,10 +680,235 @@ struct  _Plcrash__CrashReport__ReportInfo
    */
   protobuf_c_boolean has_uuid;
   ProtobufCBinaryData uuid;
+  /*
+   ** Crash path timing. As the timing is not known until the report has been written, this is emitted in a
+   * second ReportInfo record at the end of the report, which is merged with the first as per the standard
+   * protobuf message merging rules. 
+   */
+  Plcrash__CrashReport__ReportInfo__WriterDiagnostics *writer_diagnostics;
 };
 #define PLCRASH__CRASH_REPORT__REPORT_INFO__INIT \
  { PROTOBUF_C_MESSAGE_INIT (&plcrash__crash_report__report_info__descriptor) \
-    , 0, 0, {0,NULL} }
+    , 0, 0, {0,NULL}, NULL }
+
+
+/*
+ * Local symbolication diagnostics 
+ */
+struct  _Plcrash__CrashReport__SymbolicationDiagnostics
+{
+  ProtobufCMessage base;
+  /*
+   ** Total number of symbol look-ups requested, including those served from the look-up cache. 
+   */
+  uint32_t lookups;
+  /*
+   ** Number of symbol look-ups served from the look-up cache. 
+   */
+  uint32_t cache_hits;
+  /*
+   ** Upper bound on the number of symbol table entries examined. 
+   */
+  uint64_t symbols_scanned;
+  /*
+   ** Number of Objective-C class structures parsed. 
+   */
+  uint32_t objc_classes_parsed;
+  /*
+   ** Number of look-ups performed using the binary's symbol table. 
+   */
+  uint32_t symbol_table_lookups;
+  /*
+   ** Time spent in symbol table look-ups, in nanoseconds. 
+   */
+  uint64_t symbol_table_time;
+  /*
+   ** Number of look-ups performed using Objective-C metadata. 
+   */
+  uint32_t objc_lookups;
+  /*
+   ** Time spent in Objective-C metadata look-ups, in nanoseconds. 
+   */
+  uint64_t objc_time;
+};
+#define PLCRASH__CRASH_REPORT__SYMBOLICATION_DIAGNOSTICS__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&plcrash__crash_report__symbolication_diagnostics__descriptor) \
+    , 0, 0, 0, 0, 0, 0, 0, 0 }
+
+
+/*
+ * A unique sampled stack 
+ */
+struct  _Plcrash__CrashReport__StackSamples__Stack
+{
+  ProtobufCMessage base;
+  /*
+   ** Index of the sampled thread, in the order in which the sampled threads were selected. 
+   */
+  uint32_t thread_index;
+  /*
+   ** Number of samples in which this stack was observed. 
+   */
+  uint32_t count;
+  /*
+   ** The stack's PC values, starting with the innermost frame. 
+   */
+  size_t n_pcs;
+  uint64_t *pcs;
+};
+#define PLCRASH__CRASH_REPORT__STACK_SAMPLES__STACK__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&plcrash__crash_report__stack_samples__stack__descriptor) \
+    , 0, 0, 0,NULL }
+
+
+/*
+ * Aggregated periodic stack samples 
+ */
+struct  _Plcrash__CrashReport__StackSamples
+{
+  ProtobufCMessage base;
+  /*
+   ** The sampling interval, in nanoseconds. 
+   */
+  uint64_t interval;
+  /*
+   ** Total number of stacks sampled, including those counted by evicted_count. 
+   */
+  uint32_t sample_count;
+  /*
+   ** Number of samples whose stacks were evicted from the sample buffer, and are not included in stacks. 
+   */
+  uint32_t evicted_count;
+  /*
+   ** The unique sampled stacks. 
+   */
+  size_t n_stacks;
+  Plcrash__CrashReport__StackSamples__Stack **stacks;
+};
+#define PLCRASH__CRASH_REPORT__STACK_SAMPLES__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&plcrash__crash_report__stack_samples__descriptor) \
+    , 0, 0, 0, 0,NULL }
+
+
+/*
+ * The base report of an incremental live report 
+ */
+struct  _Plcrash__CrashReport__BaseReport
+{
+  ProtobufCMessage base;
+  /*
+   ** The UUID of the base report, as written to its report_info. 
+   */
+  ProtobufCBinaryData uuid;
+  /*
+   ** The number of threads in the process at the time this report was written. Threads numbered below
+   * thread_count that are not included in this report were unchanged since the base report, and are to be
+   * taken from the base report. 
+   */
+  uint32_t thread_count;
+};
+#define PLCRASH__CRASH_REPORT__BASE_REPORT__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&plcrash__crash_report__base_report__descriptor) \
+    , {0,NULL}, 0 }
+
+
+/*
+ * Application-supplied data, copied verbatim from the memory regions registered with the crash reporter. The
+ * regions are written in their in-memory layout (see PLCrashCustomData.h), in the byte order of the host that
+ * wrote the report. 
+ */
+struct  _Plcrash__CrashReport__CustomData
+{
+  ProtobufCMessage base;
+  /*
+   ** The contents of the registered key/value area. 
+   */
+  protobuf_c_boolean has_key_value_area;
+  ProtobufCBinaryData key_value_area;
+  /*
+   ** The contents of the registered breadcrumb buffer. 
+   */
+  protobuf_c_boolean has_breadcrumbs;
+  ProtobufCBinaryData breadcrumbs;
+};
+#define PLCRASH__CRASH_REPORT__CUSTOM_DATA__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&plcrash__crash_report__custom_data__descriptor) \
+    , 0,{0,NULL}, 0,{0,NULL} }
+
+
+/*
+ * A virtual memory region 
+ */
+struct  _Plcrash__CrashReport__MemoryStatistics__Region
+{
+  ProtobufCMessage base;
+  /*
+   ** The region's start address. 
+   */
+  uint64_t address;
+  /*
+   ** The region's size, in bytes. 
+   */
+  uint64_t size;
+  /*
+   ** The region's current protection (VM_PROT_* flags). 
+   */
+  uint32_t protection;
+  /*
+   ** The region's VM user tag (VM_MEMORY_* value), identifying the region's allocator. 
+   */
+  uint32_t user_tag;
+};
+#define PLCRASH__CRASH_REPORT__MEMORY_STATISTICS__REGION__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&plcrash__crash_report__memory_statistics__region__descriptor) \
+    , 0, 0, 0, 0 }
+
+
+/*
+ * Process memory statistics, captured at the time the report was written 
+ */
+struct  _Plcrash__CrashReport__MemoryStatistics
+{
+  ProtobufCMessage base;
+  /*
+   ** The task's physical memory footprint, in bytes. This is the value used by the kernel's memory limits. 
+   */
+  uint64_t phys_footprint;
+  /*
+   ** The task's resident memory size, in bytes. 
+   */
+  uint64_t resident_size;
+  /*
+   ** The task's peak resident memory size, in bytes. 
+   */
+  uint64_t resident_size_peak;
+  /*
+   ** The size of the task's compressed memory, in bytes. 
+   */
+  uint64_t compressed_size;
+  /*
+   ** The task's virtual memory size, in bytes. 
+   */
+  uint64_t virtual_size;
+  /*
+   ** The number of VM regions in the task's address space. 
+   */
+  uint32_t region_count;
+  /*
+   ** The largest regions found by a bounded walk of the task's address space, largest first. 
+   */
+  size_t n_largest_regions;
+  Plcrash__CrashReport__MemoryStatistics__Region **largest_regions;
+  /*
+   ** If true, the region walk ended before reaching the end of the address space, and largest_regions are
+   * only the largest of the regions walked. 
+   */
+  protobuf_c_boolean has_regions_truncated;
+  protobuf_c_boolean regions_truncated;
+};
+#define PLCRASH__CRASH_REPORT__MEMORY_STATISTICS__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&plcrash__crash_report__memory_statistics__descriptor) \
+    , 0, 0, 0, 0, 0, 0, 0,NULL, 0,0 }
 
 
 /*
@@ -560,10 +953,49 @@ struct  _Plcrash__CrashReport
    * Report format information. Required for all v1.1+ crash reports. 
    */
   Plcrash__CrashReport__ReportInfo *report_info;
+  /*
+   * Symbol names referenced by Symbol.name_index. Each unique name is included once, allowing symbols that are
+   * repeated across frames and threads to be encoded by index. 
+   */
+  size_t n_symbol_names;
+  char **symbol_names;
+  /*
+   * Local symbolication cost. Only included if local symbolication was performed. 
+   */
+  Plcrash__CrashReport__SymbolicationDiagnostics *symbolication_diagnostics;
+  /*
+   * The number of loaded binary images omitted from binary_images. Only included if the report was written with
+   * only the images referenced by its threads' frames. 
+   */
+  protobuf_c_boolean has_omitted_image_count;
+  uint32_t omitted_image_count;
+  /*
+   * An order-independent hash of the omitted images, computed as the 64-bit sum of the FNV-1a hash of each image's
+   * little-endian 64-bit base address followed by its path. Included along with omitted_image_count. 
+   */
+  protobuf_c_boolean has_omitted_image_hash;
+  uint64_t omitted_image_hash;
+  /*
+   * Stack samples captured prior to a live report. Only included if stack sampling was enabled. 
+   */
+  Plcrash__CrashReport__StackSamples *stack_samples;
+  /*
+   * If present, this is an incremental report, containing only the crashed thread, the threads whose stacks have
+   * changed since the base report was written, and the binary images that were not written to the base report. 
+   */
+  Plcrash__CrashReport__BaseReport *base_report;
+  /*
+   * Application-supplied data. Only included if a key/value area or breadcrumb buffer was registered. 
+   */
+  Plcrash__CrashReport__CustomData *custom_data;
+  /*
+   * Process memory statistics. Only included if memory statistics capture was enabled. 
+   */
+  Plcrash__CrashReport__MemoryStatistics *memory_statistics;
 };
 #define PLCRASH__CRASH_REPORT__INIT \
  { PROTOBUF_C_MESSAGE_INIT (&plcrash__crash_report__descriptor) \
-    , NULL, NULL, 0,NULL, 0,NULL, NULL, NULL, NULL, NULL, NULL }
+    , NULL, NULL, 0,NULL, 0,NULL, NULL, NULL, NULL, NULL, NULL, 0,NULL, NULL, 0, 0, 0, 0, NULL, NULL, NULL, NULL }
 
 
 /* Plcrash__CrashReport__Processor methods */
@@ -605,9 +1037,36 @@ void   plcrash__crash_report__process_info__init
 /* Plcrash__CrashReport__MachineInfo methods */
 void   plcrash__crash_report__machine_info__init
                      (Plcrash__CrashReport__MachineInfo         *message);
+/* Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming methods */
+void   plcrash__crash_report__report_info__writer_diagnostics__thread_timing__init
+                     (Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming         *message);
+/* Plcrash__CrashReport__ReportInfo__WriterDiagnostics methods */
+void   plcrash__crash_report__report_info__writer_diagnostics__init
+                     (Plcrash__CrashReport__ReportInfo__WriterDiagnostics         *message);
 /* Plcrash__CrashReport__ReportInfo methods */
 void   plcrash__crash_report__report_info__init
                      (Plcrash__CrashReport__ReportInfo         *message);
+/* Plcrash__CrashReport__SymbolicationDiagnostics methods */
+void   plcrash__crash_report__symbolication_diagnostics__init
+                     (Plcrash__CrashReport__SymbolicationDiagnostics         *message);
+/* Plcrash__CrashReport__StackSamples__Stack methods */
+void   plcrash__crash_report__stack_samples__stack__init
+                     (Plcrash__CrashReport__StackSamples__Stack         *message);
+/* Plcrash__CrashReport__StackSamples methods */
+void   plcrash__crash_report__stack_samples__init
+                     (Plcrash__CrashReport__StackSamples         *message);
+/* Plcrash__CrashReport__BaseReport methods */
+void   plcrash__crash_report__base_report__init
+                     (Plcrash__CrashReport__BaseReport         *message);
+/* Plcrash__CrashReport__CustomData methods */
+void   plcrash__crash_report__custom_data__init
+                     (Plcrash__CrashReport__CustomData         *message);
+/* Plcrash__CrashReport__MemoryStatistics__Region methods */
+void   plcrash__crash_report__memory_statistics__region__init
+                     (Plcrash__CrashReport__MemoryStatistics__Region         *message);
+/* Plcrash__CrashReport__MemoryStatistics methods */
+void   plcrash__crash_report__memory_statistics__init
+                     (Plcrash__CrashReport__MemoryStatistics         *message);
 /* Plcrash__CrashReport methods */
 void   plcrash__crash_report__init
                      (Plcrash__CrashReport         *message);
@@ -668,9 +1127,36 @@ typedef void (*Plcrash__CrashReport__ProcessInfo_Closure)
 typedef void (*Plcrash__CrashReport__MachineInfo_Closure)
                  (const Plcrash__CrashReport__MachineInfo *message,
                   void *closure_data);
+typedef void (*Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming_Closure)
+                 (const Plcrash__CrashReport__ReportInfo__WriterDiagnostics__ThreadTiming *message,
+                  void *closure_data);
+typedef void (*Plcrash__CrashReport__ReportInfo__WriterDiagnostics_Closure)
+                 (const Plcrash__CrashReport__ReportInfo__WriterDiagnostics *message,
+                  void *closure_data);
 typedef void (*Plcrash__CrashReport__ReportInfo_Closure)
                  (const Plcrash__CrashReport__ReportInfo *message,
                   void *closure_data);
+typedef void (*Plcrash__CrashReport__SymbolicationDiagnostics_Closure)
+                 (const Plcrash__CrashReport__SymbolicationDiagnostics *message,
+                  void *closure_data);
+typedef void (*Plcrash__CrashReport__StackSamples__Stack_Closure)
+                 (const Plcrash__CrashReport__StackSamples__Stack *message,
+                  void *closure_data);
+typedef void (*Plcrash__CrashReport__StackSamples_Closure)
+                 (const Plcrash__CrashReport__StackSamples *message,
+                  void *closure_data);
+typedef void (*Plcrash__CrashReport__BaseReport_Closure)
+                 (const Plcrash__CrashReport__BaseReport *message,
+                  void *closure_data);
+typedef void (*Plcrash__CrashReport__CustomData_Closure)
+                 (const Plcrash__CrashReport__CustomData *message,
+                  void *closure_data);
+typedef void (*Plcrash__CrashReport__MemoryStatistics__Region_Closure)
+                 (const Plcrash__CrashReport__MemoryStatistics__Region *message,
+                  void *closure_data);
+typedef void (*Plcrash__CrashReport__MemoryStatistics_Closure)
+                 (const Plcrash__CrashReport__MemoryStatistics *message,
+                  void *closure_data);
 typedef void (*Plcrash__CrashReport_Closure)
                  (const Plcrash__CrashReport *message,
                   void *closure_data);
@@ -698,6 +1184,15 @@ extern const ProtobufCMessageDescriptor plcrash__crash_report__signal__mach_exce
 extern const ProtobufCMessageDescriptor plcrash__crash_report__process_info__descriptor;
 extern const ProtobufCMessageDescriptor plcrash__crash_report__machine_info__descriptor;
 extern const ProtobufCMessageDescriptor plcrash__crash_report__report_info__descriptor;
+extern const ProtobufCMessageDescriptor plcrash__crash_report__report_info__writer_diagnostics__descriptor;
+extern const ProtobufCMessageDescriptor plcrash__crash_report__report_info__writer_diagnostics__thread_timing__descriptor;
+extern const ProtobufCMessageDescriptor plcrash__crash_report__symbolication_diagnostics__descriptor;
+extern const ProtobufCMessageDescriptor plcrash__crash_report__stack_samples__descriptor;
+extern const ProtobufCMessageDescriptor plcrash__crash_report__stack_samples__stack__descriptor;
+extern const ProtobufCMessageDescriptor plcrash__crash_report__base_report__descriptor;
+extern const ProtobufCMessageDescriptor plcrash__crash_report__custom_data__descriptor;
+extern const ProtobufCMessageDescriptor plcrash__crash_report__memory_statistics__descriptor;
+extern const ProtobufCMessageDescriptor plcrash__crash_report__memory_statistics__region__descriptor;
 
 PROTOBUF_C__END_DECLS
 
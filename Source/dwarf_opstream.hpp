@@ -112,13 +112,13 @@ template <typename V> inline bool dwarf_opstream::read_intU (V *result) {
     
     switch (sizeof(V)) {
         case 2:
-            *result = _byteorder->swap16(*result);
+            *result = plcrash_async_swap16(_byteorder, *result);
             break;
         case 4:
-            *result = _byteorder->swap32(*result);
+            *result = plcrash_async_swap32(_byteorder, *result);
             break;
         case 8:
-            *result = _byteorder->swap64(*result);
+            *result = plcrash_async_swap64(_byteorder, *result);
             break;
         default:
             break;
@@ -167,19 +167,19 @@ inline bool dwarf_opstream::read_uintmax64 (uint8_t data_size, uint64_t *result)
  */
 inline bool dwarf_opstream::read_uleb128 (uint64_t *result) {
     plcrash_error_t err;
-    pl_vm_off_t offset = ((uint8_t *)_p - (uint8_t *)_instr);
     pl_vm_size_t lebsize;
 
-    if ((err = plcrash_async_dwarf_read_uleb128(_mobj, _start, offset, result, &lebsize)) != PLCRASH_ESUCCESS) {
-        PLCF_DEBUG("Read of ULEB128 value failed with %u", err);
+    if (_p < _instr)
         return false;
-    }
 
-    /* Advance the position */
-    if (!skip(lebsize)) {
-        PLCF_DEBUG("ULEB128 value extends past end of opstream");
+    /* The full opstream range was mapped by init(); decode directly from the local mapping */
+    if ((err = plcrash_async_dwarf_decode_uleb128((const uint8_t *) _p, (const uint8_t *) _instr_max, result, &lebsize)) != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("Read of ULEB128 value failed with %u", err);
         return false;
     }
+
+    /* Advance the position; the decoder has already verified that the value falls within the opstream */
+    _p = ((uint8_t *)_p) + lebsize;
     return true;
 }
 
@@ -193,19 +193,19 @@ inline bool dwarf_opstream::read_uleb128 (uint64_t *result) {
  */
 inline bool dwarf_opstream::read_sleb128 (int64_t *result) {
     plcrash_error_t err;
-    pl_vm_off_t offset = ((uint8_t *)_p - (uint8_t *)_instr);
     pl_vm_size_t lebsize;
-    
-    if ((err = plcrash_async_dwarf_read_sleb128(_mobj, _start, offset, result, &lebsize)) != PLCRASH_ESUCCESS) {
-        PLCF_DEBUG("Read of ULEB128 value failed with %u", err);
+
+    if (_p < _instr)
         return false;
-    }
-    
-    /* Advance the position */
-    if (!skip(lebsize)) {
-        PLCF_DEBUG("SLEB128 value extends past end of opstream");
+
+    /* The full opstream range was mapped by init(); decode directly from the local mapping */
+    if ((err = plcrash_async_dwarf_decode_sleb128((const uint8_t *) _p, (const uint8_t *) _instr_max, result, &lebsize)) != PLCRASH_ESUCCESS) {
+        PLCF_DEBUG("Read of SLEB128 value failed with %u", err);
         return false;
     }
+
+    /* Advance the position; the decoder has already verified that the value falls within the opstream */
+    _p = ((uint8_t *)_p) + lebsize;
     return true;
 }
 
@@ -133,6 +133,34 @@ using namespace plcrash::async;
     plcrash_async_mobject_free(&mobj);
 }
 
+/**
+ * Test multi-byte LEB128 reads from an opcode stream, including values that do not terminate within the stream.
+ */
+- (void) testReadMultiByteLEB128 {
+    plcrash_async_mobject_t mobj;
+    uint8_t opcodes[] = { 0xe5, 0x8e, 0x26, 0xc0, 0xbb, 0x78, 0x80 };
+    
+    STAssertEquals(PLCRASH_ESUCCESS, plcrash_async_mobject_init(&mobj, mach_task_self(), (pl_vm_address_t)&opcodes, sizeof(opcodes), true), @"Failed to initialize mobj");
+    
+    dwarf_opstream stream;
+    STAssertEquals(PLCRASH_ESUCCESS, stream.init(&mobj, plcrash_async_byteorder_big_endian(), (pl_vm_address_t)&opcodes, 0, sizeof(opcodes)), @"Failed to initialize opcode stream");
+    
+    uint64_t uval;
+    STAssertTrue(stream.read_uleb128(&uval), @"Failed to read");
+    STAssertEquals(uval, (uint64_t)624485, @"Incorrect value read");
+    STAssertEquals(stream.get_position(), (uintptr_t)3, @"Incorrect position");
+
+    int64_t sval;
+    STAssertTrue(stream.read_sleb128(&sval), @"Failed to read");
+    STAssertEquals(sval, (int64_t)-123456, @"Incorrect value read");
+
+    /* The final value is truncated by the end of the stream */
+    STAssertFalse(stream.read_uleb128(&uval), @"Read a truncated value");
+    STAssertEquals(stream.get_position(), (uintptr_t)6, @"Position advanced on a failed read");
+    
+    plcrash_async_mobject_free(&mobj);
+}
+
 /**
  * Test pointer read from an opcode stream.
  */
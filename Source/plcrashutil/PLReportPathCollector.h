@@ -0,0 +1,56 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+@interface PLReportPathCollector : NSObject {
+@private
+    /** Collected report paths, in collection order. */
+    NSMutableArray *_reportPaths;
+
+    /** Output names, parallel to @a _reportPaths. */
+    NSMutableArray *_outputNames;
+
+    /** Lowercased output names that have been assigned, used to detect collisions on case-insensitive volumes. */
+    NSMutableSet *_assignedNames;
+}
+
+- (BOOL) addPath: (NSString *) path;
+
+- (NSString *) outputPathForReportAtIndex: (NSUInteger) index directory: (NSString *) directory extension: (NSString *) extension;
+
+/** The collected report paths. */
+@property(nonatomic, readonly) NSArray *reportPaths;
+
+/**
+ * The unique, extensionless output name of each report in @a reportPaths. Reports found within an input directory
+ * are named by their path relative to that directory; colliding names are made unique with a numeric suffix.
+ */
+@property(nonatomic, readonly) NSArray *outputNames;
+
+@end
@@ -0,0 +1,128 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLReportPathCollector.h"
+
+/**
+ * Collects the report files at a set of input paths, assigning each report a unique output name. Output names
+ * retain the report's path relative to its input directory, so that reports with the same file name in different
+ * directories are not written to the same output file.
+ */
+@implementation PLReportPathCollector
+
+@synthesize reportPaths = _reportPaths;
+@synthesize outputNames = _outputNames;
+
+- (instancetype) init {
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _reportPaths = [[NSMutableArray alloc] init];
+    _outputNames = [[NSMutableArray alloc] init];
+    _assignedNames = [[NSMutableSet alloc] init];
+
+    return self;
+}
+
+- (void) dealloc {
+    [_reportPaths release];
+    [_outputNames release];
+    [_assignedNames release];
+
+    [super dealloc];
+}
+
+/**
+ * Add the report at @a path, assigning it a unique output name derived from @a name.
+ */
+- (void) addReport: (NSString *) path name: (NSString *) name {
+    NSString *base = [name stringByDeletingPathExtension];
+    NSString *unique = base;
+    for (NSUInteger n = 1; [_assignedNames containsObject: [unique lowercaseString]]; n++)
+        unique = [NSString stringWithFormat: @"%@-%lu", base, (unsigned long) n];
+
+    [_assignedNames addObject: [unique lowercaseString]];
+    [_reportPaths addObject: path];
+    [_outputNames addObject: unique];
+}
+
+/**
+ * Add the report file at @a path. If @a path is a directory, it is searched recursively for .plcrash files.
+ *
+ * @param path The report file or directory.
+ *
+ * @return Returns NO if @a path does not exist.
+ */
+- (BOOL) addPath: (NSString *) path {
+    NSFileManager *fm = [NSFileManager defaultManager];
+    BOOL isDirectory;
+
+    if (![fm fileExistsAtPath: path isDirectory: &isDirectory])
+        return NO;
+
+    if (!isDirectory) {
+        [self addReport: path name: [path lastPathComponent]];
+        return YES;
+    }
+
+    /* Sort the directory contents, so that the numeric suffixes assigned to colliding names are deterministic */
+    NSMutableArray *files = [NSMutableArray array];
+    for (NSString *file in [fm enumeratorAtPath: path]) {
+        if ([[file pathExtension] isEqualToString: @"plcrash"])
+            [files addObject: file];
+    }
+    [files sortUsingSelector: @selector(compare:)];
+
+    for (NSString *file in files)
+        [self addReport: [path stringByAppendingPathComponent: file] name: file];
+
+    return YES;
+}
+
+/**
+ * Return the output path for the report at @a index within @a directory, creating any intermediate directories
+ * required by the report's relative output name.
+ *
+ * @param index The index of the report within @a reportPaths.
+ * @param directory The output directory.
+ * @param extension The output file extension.
+ *
+ * @return Returns the output path, or nil if an intermediate directory could not be created.
+ */
+- (NSString *) outputPathForReportAtIndex: (NSUInteger) index directory: (NSString *) directory extension: (NSString *) extension {
+    NSString *name = [[_outputNames objectAtIndex: index] stringByAppendingPathExtension: extension];
+    NSString *path = [directory stringByAppendingPathComponent: name];
+
+    NSString *parent = [path stringByDeletingLastPathComponent];
+    if (![[NSFileManager defaultManager] createDirectoryAtPath: parent withIntermediateDirectories: YES attributes: nil error: NULL])
+        return nil;
+
+    return path;
+}
+
+@end
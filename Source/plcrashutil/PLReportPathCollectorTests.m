@@ -0,0 +1,107 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "SenTestCompat.h"
+
+#import "PLReportPathCollector.h"
+
+@interface PLReportPathCollectorTests : SenTestCase {
+@private
+    /** Fixture directory */
+    NSString *_directory;
+}
+@end
+
+@implementation PLReportPathCollectorTests
+
+- (void) setUp {
+    _directory = [[NSTemporaryDirectory() stringByAppendingPathComponent: [[NSProcessInfo processInfo] globallyUniqueString]] retain];
+    STAssertTrue([[NSFileManager defaultManager] createDirectoryAtPath: _directory withIntermediateDirectories: YES attributes: nil error: NULL], @"Could not create fixture directory");
+}
+
+- (void) tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath: _directory error: NULL];
+    [_directory release];
+}
+
+/**
+ * Write an empty fixture file at @a relativePath within the fixture directory, returning its path.
+ */
+- (NSString *) writeFixture: (NSString *) relativePath {
+    NSString *path = [_directory stringByAppendingPathComponent: relativePath];
+    STAssertTrue([[NSFileManager defaultManager] createDirectoryAtPath: [path stringByDeletingLastPathComponent] withIntermediateDirectories: YES attributes: nil error: NULL], @"Could not create fixture directory");
+    STAssertTrue([[NSData data] writeToFile: path atomically: NO], @"Could not write fixture");
+    return path;
+}
+
+/**
+ * Verify that reports with the same file name in different input directories are assigned distinct output names,
+ * preserving their path relative to the input directory.
+ */
+- (void) testOutputNamesAreUnique {
+    [self writeFixture: @"one/crash.plcrash"];
+    [self writeFixture: @"one/nested/crash.plcrash"];
+    [self writeFixture: @"one/ignored.txt"];
+    [self writeFixture: @"two/crash.plcrash"];
+    [self writeFixture: @"two/CRASH.data"];
+    NSString *file = [self writeFixture: @"three/crash.plcrash"];
+
+    PLReportPathCollector *collector = [[[PLReportPathCollector alloc] init] autorelease];
+    STAssertTrue([collector addPath: [_directory stringByAppendingPathComponent: @"one"]], @"Failed to add directory");
+    STAssertTrue([collector addPath: [_directory stringByAppendingPathComponent: @"two"]], @"Failed to add directory");
+    STAssertTrue([collector addPath: file], @"Failed to add file");
+    STAssertTrue([collector addPath: [_directory stringByAppendingPathComponent: @"two/CRASH.data"]], @"Failed to add file");
+    STAssertFalse([collector addPath: [_directory stringByAppendingPathComponent: @"missing"]], @"Added a missing path");
+
+    STAssertEquals([collector.reportPaths count], (NSUInteger) 5, @"Incorrect report count");
+    STAssertEquals([collector.outputNames count], [collector.reportPaths count], @"Output names do not match reports");
+
+    /* Names are compared case-insensitively, as the output directory may reside on a case-insensitive volume */
+    NSMutableSet *names = [NSMutableSet set];
+    for (NSString *name in collector.outputNames)
+        [names addObject: [name lowercaseString]];
+    STAssertEquals([names count], [collector.outputNames count], @"Output names collide: %@", collector.outputNames);
+
+    STAssertTrue([collector.outputNames containsObject: @"nested/crash"], @"Relative path was not preserved: %@", collector.outputNames);
+
+    /* Every report must be written to a distinct file within the output directory */
+    NSString *outputDir = [_directory stringByAppendingPathComponent: @"output"];
+    NSMutableSet *outputPaths = [NSMutableSet set];
+    for (NSUInteger i = 0; i < [collector.reportPaths count]; i++) {
+        NSString *outputPath = [collector outputPathForReportAtIndex: i directory: outputDir extension: @"crash"];
+        STAssertNotNil(outputPath, @"Could not create output directory");
+        STAssertTrue([outputPath hasPrefix: outputDir], @"Output path %@ is outside of the output directory", outputPath);
+
+        BOOL isDirectory;
+        STAssertTrue([[NSFileManager defaultManager] fileExistsAtPath: [outputPath stringByDeletingLastPathComponent] isDirectory: &isDirectory] && isDirectory, @"Intermediate directory was not created");
+        [outputPaths addObject: [outputPath lowercaseString]];
+    }
+    STAssertEquals([outputPaths count], [collector.reportPaths count], @"Output paths collide");
+}
+
+@end
@@ -0,0 +1,58 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "PLSymbolTable.h"
+
+@interface PLSymbolStore : NSObject {
+@private
+    /** Maps lowercase hex UUID strings to the symbol file location, as a two element [path, offset] array. */
+    NSDictionary *_locations;
+
+    /** Loaded symbol tables (or NSNull, if loading failed), keyed by UUID. Guarded by @a _lock. */
+    NSMutableDictionary *_tables;
+
+    /** Lock guarding @a _tables, and the table statistics. */
+    NSLock *_lock;
+
+    /** Number of symbol tables that have been loaded. */
+    NSUInteger _loadedCount;
+}
+
+- (instancetype) initWithPaths: (NSArray *) paths;
+
+- (PLSymbolTable *) symbolTableForUUID: (NSString *) uuid;
+
+/** The number of images, by UUID, for which symbol files were found. */
+@property(nonatomic, readonly) NSUInteger imageCount;
+
+/** The number of symbol tables that have been loaded. */
+@property(nonatomic, readonly) NSUInteger loadedCount;
+
+@end
@@ -0,0 +1,231 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLSymbolStore.h"
+
+#import <mach-o/loader.h>
+#import <mach-o/fat.h>
+#import <libkern/OSByteOrder.h>
+
+/**
+ * @internal
+ *
+ * Return the lowercase hex representation of @a uuid, matching PLCrashReportBinaryImageInfo.imageUUID.
+ */
+static NSString *uuid_string (const uint8_t uuid[16]) {
+    NSMutableString *result = [NSMutableString stringWithCapacity: 32];
+    for (size_t i = 0; i < 16; i++)
+        [result appendFormat: @"%02x", uuid[i]];
+
+    return result;
+}
+
+/**
+ * @internal
+ *
+ * Return the LC_UUID of the thin Mach-O image at @a offset within @a data, or nil if the image is not a supported
+ * Mach-O file.
+ */
+static NSString *image_uuid (NSData *data, uint64_t offset) {
+    const uint8_t *base = [data bytes];
+    uint64_t length = [data length];
+    if (offset > length || length - offset < sizeof(struct mach_header_64))
+        return nil;
+
+    const struct mach_header *header = (const struct mach_header *) (base + offset);
+    size_t header_size;
+    if (header->magic == MH_MAGIC)
+        header_size = sizeof(struct mach_header);
+    else if (header->magic == MH_MAGIC_64)
+        header_size = sizeof(struct mach_header_64);
+    else
+        return nil;
+
+    if (header->sizeofcmds > length - offset - header_size)
+        return nil;
+
+    const uint8_t *cmd_ptr = base + offset + header_size;
+    const uint8_t *cmd_end = cmd_ptr + header->sizeofcmds;
+    for (uint32_t i = 0; i < header->ncmds; i++) {
+        const struct load_command *cmd = (const struct load_command *) cmd_ptr;
+        if ((size_t) (cmd_end - cmd_ptr) < sizeof(*cmd) || cmd->cmdsize < sizeof(*cmd) || cmd->cmdsize > (size_t) (cmd_end - cmd_ptr))
+            return nil;
+
+        if (cmd->cmd == LC_UUID && cmd->cmdsize >= sizeof(struct uuid_command))
+            return uuid_string(((const struct uuid_command *) cmd)->uuid);
+
+        cmd_ptr += cmd->cmdsize;
+    }
+
+    return nil;
+}
+
+/**
+ * Indexes a set of symbol files (dSYM bundles, or unstripped Mach-O binaries) by image UUID. Symbol tables are
+ * loaded and memory-mapped on first use, and a single table is shared by all threads.
+ *
+ * Instances are thread-safe.
+ */
+@implementation PLSymbolStore
+
+/**
+ * Enumerate the Mach-O slices of the file at @a path, recording each slice's location in @a locations.
+ */
+static void index_file (NSString *path, NSMutableDictionary *locations) {
+    NSData *data = [NSData dataWithContentsOfFile: path options: NSDataReadingMappedAlways error: NULL];
+    if (data == nil || [data length] < sizeof(uint32_t))
+        return;
+
+    NSMutableArray *offsets = [NSMutableArray array];
+    uint32_t magic = *(const uint32_t *) [data bytes];
+
+    if (OSSwapBigToHostInt32(magic) == FAT_MAGIC && [data length] >= sizeof(struct fat_header)) {
+        /* Fat headers are always big-endian */
+        const struct fat_header *fat = [data bytes];
+        uint32_t nfat = OSSwapBigToHostInt32(fat->nfat_arch);
+        if (nfat > ([data length] - sizeof(*fat)) / sizeof(struct fat_arch))
+            return;
+
+        const struct fat_arch *archs = (const struct fat_arch *) (fat + 1);
+        for (uint32_t i = 0; i < nfat; i++)
+            [offsets addObject: [NSNumber numberWithUnsignedLongLong: OSSwapBigToHostInt32(archs[i].offset)]];
+    } else {
+        [offsets addObject: [NSNumber numberWithUnsignedLongLong: 0]];
+    }
+
+    for (NSNumber *offset in offsets) {
+        NSString *uuid = image_uuid(data, [offset unsignedLongLongValue]);
+        if (uuid != nil && [locations objectForKey: uuid] == nil)
+            [locations setObject: [NSArray arrayWithObjects: path, offset, nil] forKey: uuid];
+    }
+}
+
+/**
+ * Initialize a new symbol store.
+ *
+ * @param paths The symbol files and/or directories to be indexed. Directories are searched recursively.
+ */
+- (instancetype) initWithPaths: (NSArray *) paths {
+    if ((self = [super init]) == nil)
+        return nil;
+
+    NSFileManager *fm = [NSFileManager defaultManager];
+    NSMutableDictionary *locations = [NSMutableDictionary dictionary];
+
+    for (NSString *path in paths) {
+        BOOL isDirectory;
+        if (![fm fileExistsAtPath: path isDirectory: &isDirectory])
+            continue;
+
+        if (!isDirectory) {
+            index_file(path, locations);
+            continue;
+        }
+
+        NSDirectoryEnumerator *files = [fm enumeratorAtPath: path];
+        for (NSString *file in files) {
+            NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+            if ([[[files fileAttributes] fileType] isEqualToString: NSFileTypeRegular])
+                index_file([path stringByAppendingPathComponent: file], locations);
+            [pool drain];
+        }
+    }
+
+    _locations = [locations copy];
+    _tables = [[NSMutableDictionary alloc] init];
+    _lock = [[NSLock alloc] init];
+
+    return self;
+}
+
+- (void) dealloc {
+    [_locations release];
+    [_tables release];
+    [_lock release];
+    [super dealloc];
+}
+
+- (NSUInteger) imageCount {
+    return [_locations count];
+}
+
+- (NSUInteger) loadedCount {
+    [_lock lock];
+    NSUInteger count = _loadedCount;
+    [_lock unlock];
+    return count;
+}
+
+/**
+ * Return the symbol table for the image with the given @a uuid, or nil if no symbols are available.
+ *
+ * @param uuid The image's UUID, as returned by PLCrashReportBinaryImageInfo.imageUUID.
+ */
+- (PLSymbolTable *) symbolTableForUUID: (NSString *) uuid {
+    if (uuid == nil)
+        return nil;
+
+    uuid = [uuid lowercaseString];
+    NSArray *location = [_locations objectForKey: uuid];
+    if (location == nil)
+        return nil;
+
+    /* Check for an already loaded table */
+    [_lock lock];
+    id table = [[[_tables objectForKey: uuid] retain] autorelease];
+    [_lock unlock];
+
+    if (table != nil)
+        return (table == [NSNull null]) ? nil : table;
+
+    /* Load the table without holding the lock, so that other images may be loaded concurrently. Should two threads
+     * race to load the same table, the first to finish wins. */
+    NSString *path = [location objectAtIndex: 0];
+    uint64_t offset = [[location objectAtIndex: 1] unsignedLongLongValue];
+    NSData *data = [NSData dataWithContentsOfFile: path options: NSDataReadingMappedAlways error: NULL];
+
+    id loaded = nil;
+    if (data != nil)
+        loaded = [[[PLSymbolTable alloc] initWithData: data offset: offset error: NULL] autorelease];
+    if (loaded == nil)
+        loaded = [NSNull null];
+
+    [_lock lock];
+    table = [[[_tables objectForKey: uuid] retain] autorelease];
+    if (table == nil) {
+        [_tables setObject: loaded forKey: uuid];
+        if (loaded != [NSNull null])
+            _loadedCount++;
+        table = loaded;
+    }
+    [_lock unlock];
+
+    return (table == [NSNull null]) ? nil : table;
+}
+
+@end
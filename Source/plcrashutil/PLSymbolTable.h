@@ -0,0 +1,78 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/**
+ * @internal
+ *
+ * A single symbol table entry.
+ */
+typedef struct pl_symbol_table_entry {
+    /** The symbol's on-disk address. */
+    uint64_t address;
+
+    /** Offset of the symbol's NULL-terminated name within the string table. */
+    uint32_t name_offset;
+} pl_symbol_table_entry_t;
+
+@interface PLSymbolTable : NSObject {
+@private
+    /** The mapped symbol file. */
+    NSData *_data;
+
+    /** The string table, within @a _data. */
+    const char *_strings;
+
+    /** Size of @a _strings, in bytes. */
+    uint32_t _stringsSize;
+
+    /** Address-sorted symbol entries. */
+    pl_symbol_table_entry_t *_entries;
+
+    /** Number of entries in @a _entries. */
+    size_t _count;
+
+    /** The on-disk address of the image's __TEXT segment. */
+    uint64_t _textAddress;
+
+    /** The size of the image's __TEXT segment. */
+    uint64_t _textSize;
+}
+
+- (instancetype) initWithData: (NSData *) data offset: (uint64_t) offset error: (NSError **) outError;
+
+- (NSString *) symbolForAddress: (uint64_t) address startAddress: (uint64_t *) startAddress;
+
+/** The on-disk address of the image's __TEXT segment. Image-relative addresses must be rebased against this value. */
+@property(nonatomic, readonly) uint64_t textAddress;
+
+/** The number of symbols in the table. */
+@property(nonatomic, readonly) size_t count;
+
+@end
@@ -0,0 +1,255 @@
+/*
+ * Author: Landon Fuller <landonf@plausiblelabs.com>
+ *
+ * Copyright (c) 2008-2015 Plausible Labs Cooperative, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLSymbolTable.h"
+
+#import <mach-o/loader.h>
+#import <mach-o/nlist.h>
+
+/**
+ * @internal
+ *
+ * Populate @a outError with a corrupt file error.
+ */
+static void populate_corrupt_error (NSError **outError, NSString *description) {
+    if (outError == NULL)
+        return;
+
+    NSDictionary *userInfo = [NSDictionary dictionaryWithObject: description forKey: NSLocalizedDescriptionKey];
+    *outError = [NSError errorWithDomain: NSCocoaErrorDomain code: NSFileReadCorruptFileError userInfo: userInfo];
+}
+
+/**
+ * @internal
+ *
+ * Sort entries by address, ascending.
+ */
+static int entry_compare (const void *a, const void *b) {
+    const pl_symbol_table_entry_t *lhs = a;
+    const pl_symbol_table_entry_t *rhs = b;
+
+    if (lhs->address < rhs->address)
+        return -1;
+    else if (lhs->address > rhs->address)
+        return 1;
+
+    return 0;
+}
+
+/**
+ * An immutable, address-sorted symbol table read from a single Mach-O image. The symbol and string tables are
+ * referenced directly from the mapped file; once initialized, instances may be shared across threads.
+ */
+@implementation PLSymbolTable
+
+@synthesize textAddress = _textAddress;
+@synthesize count = _count;
+
+/**
+ * Initialize a new symbol table.
+ *
+ * @param data The mapped symbol file.
+ * @param offset The offset of the Mach-O image within @a data; this will be non-zero for fat binaries.
+ * @param outError A pointer to an NSError object variable. If an error occurs, this pointer will contain an error
+ * object indicating why the symbol table could not be read. If no error occurs, this parameter will be left unmodified.
+ * You may specify nil for this parameter, and no error information will be provided.
+ */
+- (instancetype) initWithData: (NSData *) data offset: (uint64_t) offset error: (NSError **) outError {
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _data = [data retain];
+
+    const uint8_t *base = [data bytes];
+    uint64_t length = [data length];
+    if (offset > length || length - offset < sizeof(struct mach_header)) {
+        populate_corrupt_error(outError, @"Mach-O header is truncated");
+        [self release];
+        return nil;
+    }
+
+    const uint8_t *image = base + offset;
+    uint64_t image_length = length - offset;
+
+    /* Parse the header */
+    const struct mach_header *header = (const struct mach_header *) image;
+    size_t header_size;
+    bool m64;
+    switch (header->magic) {
+        case MH_MAGIC:
+            header_size = sizeof(struct mach_header);
+            m64 = false;
+            break;
+        case MH_MAGIC_64:
+            header_size = sizeof(struct mach_header_64);
+            m64 = true;
+            break;
+        default:
+            populate_corrupt_error(outError, @"Unsupported Mach-O magic");
+            [self release];
+            return nil;
+    }
+
+    if (header->sizeofcmds > image_length - header_size) {
+        populate_corrupt_error(outError, @"Mach-O load commands are truncated");
+        [self release];
+        return nil;
+    }
+
+    /* Find the symbol table and __TEXT segment */
+    const struct symtab_command *symtab = NULL;
+    const uint8_t *cmd_ptr = image + header_size;
+    const uint8_t *cmd_end = cmd_ptr + header->sizeofcmds;
+    for (uint32_t i = 0; i < header->ncmds; i++) {
+        const struct load_command *cmd = (const struct load_command *) cmd_ptr;
+        if ((size_t) (cmd_end - cmd_ptr) < sizeof(*cmd) || cmd->cmdsize < sizeof(*cmd) || cmd->cmdsize > (size_t) (cmd_end - cmd_ptr))
+            break;
+
+        if (cmd->cmd == LC_SYMTAB && cmd->cmdsize >= sizeof(struct symtab_command)) {
+            symtab = (const struct symtab_command *) cmd;
+        } else if (cmd->cmd == LC_SEGMENT_64 && cmd->cmdsize >= sizeof(struct segment_command_64)) {
+            const struct segment_command_64 *seg = (const struct segment_command_64 *) cmd;
+            if (strncmp(seg->segname, SEG_TEXT, sizeof(seg->segname)) == 0) {
+                _textAddress = seg->vmaddr;
+                _textSize = seg->vmsize;
+            }
+        } else if (cmd->cmd == LC_SEGMENT && cmd->cmdsize >= sizeof(struct segment_command)) {
+            const struct segment_command *seg = (const struct segment_command *) cmd;
+            if (strncmp(seg->segname, SEG_TEXT, sizeof(seg->segname)) == 0) {
+                _textAddress = seg->vmaddr;
+                _textSize = seg->vmsize;
+            }
+        }
+
+        cmd_ptr += cmd->cmdsize;
+    }
+
+    if (symtab == NULL) {
+        populate_corrupt_error(outError, @"Mach-O image does not contain a symbol table");
+        [self release];
+        return nil;
+    }
+
+    /* Validate the table bounds */
+    size_t nlist_size = m64 ? sizeof(struct nlist_64) : sizeof(struct nlist);
+    if (symtab->stroff > image_length || symtab->strsize > image_length - symtab->stroff ||
+        symtab->symoff > image_length || (uint64_t) symtab->nsyms * nlist_size > image_length - symtab->symoff)
+    {
+        populate_corrupt_error(outError, @"Mach-O symbol table is truncated");
+        [self release];
+        return nil;
+    }
+
+    _strings = (const char *) image + symtab->stroff;
+    _stringsSize = symtab->strsize;
+
+    /* Collect the defined, non-debugging symbols */
+    _entries = malloc(sizeof(_entries[0]) * (symtab->nsyms > 0 ? symtab->nsyms : 1));
+    if (_entries == NULL) {
+        [self release];
+        return nil;
+    }
+
+    const uint8_t *nlist_ptr = image + symtab->symoff;
+    for (uint32_t i = 0; i < symtab->nsyms; i++, nlist_ptr += nlist_size) {
+        uint8_t n_type;
+        uint32_t n_strx;
+        uint64_t n_value;
+
+        if (m64) {
+            const struct nlist_64 *nl = (const struct nlist_64 *) nlist_ptr;
+            n_type = nl->n_type;
+            n_strx = nl->n_un.n_strx;
+            n_value = nl->n_value;
+        } else {
+            const struct nlist *nl = (const struct nlist *) nlist_ptr;
+            n_type = nl->n_type;
+            n_strx = nl->n_un.n_strx;
+            n_value = nl->n_value;
+        }
+
+        if ((n_type & N_STAB) != 0 || (n_type & N_TYPE) != N_SECT)
+            continue;
+
+        if (n_strx == 0 || n_strx >= _stringsSize)
+            continue;
+
+        _entries[_count].address = n_value;
+        _entries[_count].name_offset = n_strx;
+        _count++;
+    }
+
+    /* The table is shared read-only across threads once sorted */
+    qsort(_entries, _count, sizeof(_entries[0]), entry_compare);
+
+    return self;
+}
+
+- (void) dealloc {
+    if (_entries != NULL)
+        free(_entries);
+
+    [_data release];
+    [super dealloc];
+}
+
+/**
+ * Return the name of the symbol containing @a address, or nil if no symbol is found.
+ *
+ * @param address The on-disk address to look up.
+ * @param startAddress On success, the on-disk start address of the symbol. May be NULL.
+ */
+- (NSString *) symbolForAddress: (uint64_t) address startAddress: (uint64_t *) startAddress {
+    if (_textSize != 0 && (address < _textAddress || address - _textAddress >= _textSize))
+        return nil;
+
+    /* Find the last symbol at or before the address */
+    size_t lower = 0;
+    size_t upper = _count;
+    while (lower < upper) {
+        size_t mid = lower + (upper - lower) / 2;
+        if (_entries[mid].address <= address)
+            lower = mid + 1;
+        else
+            upper = mid;
+    }
+
+    if (lower == 0)
+        return nil;
+
+    const pl_symbol_table_entry_t *entry = &_entries[lower - 1];
+    size_t maxlen = _stringsSize - entry->name_offset;
+    const char *name = _strings + entry->name_offset;
+
+    if (startAddress != NULL)
+        *startAddress = entry->address;
+
+    return [[[NSString alloc] initWithBytes: name length: strnlen(name, maxlen) encoding: NSUTF8StringEncoding] autorelease];
+}
+
+@end
@@ -29,9 +29,17 @@
 #import <Foundation/Foundation.h>
 #import <CrashReporter/CrashReporter.h>
 
+#import "PLReportPathCollector.h"
+#import "PLSymbolStore.h"
+
 #import <stdlib.h>
 #import <stdio.h>
 #import <getopt.h>
+#import <fcntl.h>
+#import <unistd.h>
+#import <errno.h>
+#import <inttypes.h>
+#import <libkern/OSAtomic.h>
 
 /*
  * Print command line usage.
@@ -39,34 +47,166 @@
 static void print_usage () {
     fprintf(stderr, "Usage: plcrashutil <command> <options>\n"
                     "Commands:\n"
-                    "  convert --format=<format> <file>\n"
-                    "      Covert a plcrash file to the given format.\n\n"
+                    "  convert --format=<format> [--jobs=<count>] [--output=<dir>] [--demangle] <report path> ...\n"
+                    "      Covert plcrash files to the given format. Report paths may be files, or directories\n"
+                    "      containing .plcrash files. Multiple reports are converted in parallel by the given\n"
+                    "      number of workers. Results are written to the output directory if specified, or to\n"
+                    "      stdout otherwise. If --demangle is specified, C++ and Swift symbol names in text output\n"
+                    "      are demangled.\n\n"
                     "      Supported formats:\n"
                     "        ios - Standard Apple iOS-compatible text crash log\n"
-                    "        iphone - Synonym for 'iOS'.\n");
+                    "        iphone - Synonym for 'iOS'.\n"
+                    "        json - One JSON object per report\n\n"
+                    "  symbolicate --symbols=<path> [--format=<format>] [--jobs=<count>] [--output=<dir>] [--demangle] <report path> ...\n"
+                    "      Symbolicate plcrash files in parallel, using the dSYM bundles and Mach-O binaries found\n"
+                    "      at the given symbol paths. Report paths may be files, or directories containing .plcrash\n"
+                    "      files. --symbols may be specified multiple times. Results are written to the output\n"
+                    "      directory if specified, preserving each report's path relative to its input directory,\n"
+                    "      or to stdout otherwise. If --demangle is specified, C++ and Swift symbol names are\n"
+                    "      demangled.\n\n"
+                    "      Supported formats:\n"
+                    "        text - Symbolicated text backtraces (default)\n"
+                    "        json - One JSON object per report\n\n"
+                    "  bucket [--frames=<count>] [--jobs=<count>] <report path> ...\n"
+                    "      Group plcrash files by crash signature, computed from the signal, exception name, and\n"
+                    "      the crashed thread's top frames (default 5) as image UUID and offset. Report paths may\n"
+                    "      be files, or directories containing .plcrash files. Writes one line per signature to\n"
+                    "      stdout, largest bucket first: <count> <signature>\n");
+}
+
+/*
+ * Conversion statistics, updated atomically by all workers.
+ */
+struct convert_stats {
+    /** Number of reports converted. */
+    volatile int64_t reports;
+
+    /** Number of reports that could not be read, decoded, or written. */
+    volatile int64_t failed;
+
+    /** Number of input bytes read. */
+    volatile int64_t input_bytes;
+};
+
+/*
+ * Write all of @a data to @a fd.
+ */
+static BOOL write_fully (int fd, NSData *data) {
+    const uint8_t *bytes = [data bytes];
+    size_t remaining = [data length];
+
+    while (remaining > 0) {
+        ssize_t written = write(fd, bytes, remaining);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return NO;
+        }
+
+        bytes += written;
+        remaining -= (size_t) written;
+    }
+
+    return YES;
 }
 
+/*
+ * Convert a single report, writing the formatted result to @a fd. If @a json is YES, the report is written as JSON;
+ * otherwise, it is written in @a textFormat, demangling symbol names with @a demangler if non-nil. If @a outputLock is
+ * non-nil, the report is formatted in memory, and written to @a fd while holding the lock.
+ */
+static BOOL convert_report (NSString *path, BOOL json, PLCrashReportTextFormat textFormat, PLCrashReportSymbolDemangler *demangler, int fd, NSLock *outputLock, struct convert_stats *stats) {
+    NSError *error;
+    NSData *data = [NSData dataWithContentsOfFile: path options: NSDataReadingMappedIfSafe error: &error];
+    if (data == nil) {
+        fprintf(stderr, "Could not read %s: %s\n", [path UTF8String], [[error localizedDescription] UTF8String]);
+        return NO;
+    }
+    OSAtomicAdd64((int64_t) [data length], &stats->input_bytes);
+
+    PLCrashReport *crashLog = [[[PLCrashReport alloc] initWithData: data error: &error] autorelease];
+    if (crashLog == nil) {
+        fprintf(stderr, "Could not decode %s: %s\n", [path UTF8String], [[error localizedDescription] UTF8String]);
+        return NO;
+    }
+
+    /* Format in memory, and write while holding the output lock */
+    if (outputLock != nil) {
+        id<PLCrashReportFormatter> formatter;
+        if (json)
+            formatter = [[[PLCrashReportJSONFormatter alloc] init] autorelease];
+        else
+            formatter = [[[PLCrashReportTextFormatter alloc] initWithTextFormat: textFormat stringEncoding: NSUTF8StringEncoding demangler: demangler] autorelease];
+
+        NSData *output = [formatter formatReport: crashLog error: &error];
+        if (output == nil) {
+            fprintf(stderr, "Could not format %s\n", [path UTF8String]);
+            return NO;
+        }
+
+        [outputLock lock];
+        BOOL written = write_fully(fd, output);
+        [outputLock unlock];
+
+        if (!written) {
+            fprintf(stderr, "Could not write output for %s: %s\n", [path UTF8String], strerror(errno));
+            return NO;
+        }
+
+        return YES;
+    }
+
+    /* Otherwise, stream the output directly */
+    BOOL written;
+    if (json)
+        written = [PLCrashReportJSONFormatter writeCrashReport: crashLog toFileDescriptor: fd error: &error];
+    else
+        written = [PLCrashReportTextFormatter writeCrashReport: crashLog withTextFormat: textFormat demangler: demangler toFileDescriptor: fd error: &error];
+
+    if (!written) {
+        fprintf(stderr, "Could not write output for %s: %s\n", [path UTF8String], [[error localizedDescription] UTF8String]);
+        return NO;
+    }
+
+    return YES;
+}
+
+static PLReportPathCollector *collect_report_paths (int argc, char *argv[]);
+
 /*
  * Run a conversion.
  */
 static int convert_command (int argc, char *argv[]) {
     const char *format = "iphone";
-    const char *input_file;
-    FILE *output = stdout;
+    const char *output_dir = NULL;
+    long jobs = 1;
+    BOOL demangle = NO;
 
     /* options descriptor */
     static struct option longopts[] = {
         { "format",     required_argument,      NULL,          'f' },
+        { "jobs",       required_argument,      NULL,          'j' },
+        { "output",     required_argument,      NULL,          'o' },
+        { "demangle",   no_argument,            NULL,          'd' },
         { NULL,         0,                      NULL,           0 }
     };    
 
     /* Read the options */
-    char ch;
-    while ((ch = getopt_long(argc, argv, "f:", longopts, NULL)) != -1) {
+    int ch;
+    while ((ch = getopt_long(argc, argv, "f:j:o:d", longopts, NULL)) != -1) {
         switch (ch) {
             case 'f':
                 format = optarg;
                 break;
+            case 'j':
+                jobs = strtol(optarg, NULL, 10);
+                break;
+            case 'o':
+                output_dir = optarg;
+                break;
+            case 'd':
+                demangle = YES;
+                break;
             default:
                 print_usage();
                 return 1;
@@ -80,40 +220,601 @@ static int convert_command (int argc, char *argv[]) {
         fprintf(stderr, "No input file supplied\n");
         print_usage();
         return 1;
-    } else {
-        input_file = argv[0];
     }
     
-    /* Verify that the format is supported. Only one is actually supported currently */
-    PLCrashReportTextFormat textFormat;
-    if (strcasecmp(format, "iphone") == 0 || strcasecmp(format, "ios")) {
+    /* Verify that the format is supported */
+    PLCrashReportTextFormat textFormat = PLCrashReportTextFormatiOS;
+    BOOL json = NO;
+    if (strcasecmp(format, "iphone") == 0 || strcasecmp(format, "ios") == 0) {
         textFormat = PLCrashReportTextFormatiOS;
+    } else if (strcasecmp(format, "json") == 0) {
+        json = YES;
     } else {
         fprintf(stderr, "Unsupported format requested\n");
         print_usage();
         return 1;
     }
 
-    /* Try reading the file in */
-    NSError *error;
-    NSData *data = [NSData dataWithContentsOfFile: [NSString stringWithUTF8String: input_file] 
-                                          options: NSMappedRead error: &error];
-    if (data == nil) {
-        fprintf(stderr, "Could not read input file: %s\n", [[error localizedDescription] UTF8String]);
+    if (jobs < 1)
+        jobs = 1;
+
+    NSString *outputDir = nil;
+    if (output_dir != NULL) {
+        outputDir = [NSString stringWithUTF8String: output_dir];
+        NSError *error;
+        if (![[NSFileManager defaultManager] createDirectoryAtPath: outputDir withIntermediateDirectories: YES attributes: nil error: &error]) {
+            fprintf(stderr, "Could not create output directory: %s\n", [[error localizedDescription] UTF8String]);
+            return 1;
+        }
+    }
+
+    /* A single demangler is shared by all workers, so that each distinct symbol is demangled only once per batch */
+    PLCrashReportSymbolDemangler *demangler = nil;
+    if (demangle)
+        demangler = [[[PLCrashReportSymbolDemangler alloc] init] autorelease];
+
+    PLReportPathCollector *collector = collect_report_paths(argc, argv);
+    NSArray *reportPaths = collector.reportPaths;
+    struct convert_stats stats = { 0, 0, 0 };
+    struct convert_stats *statsPtr = &stats;
+
+    if ([reportPaths count] == 0) {
+        fprintf(stderr, "No reports found\n");
         return 1;
     }
-    
-    /* Decode it */
-    PLCrashReport *crashLog = [[PLCrashReport alloc] initWithData: data error: &error];
-    if (crashLog == nil) {
-        fprintf(stderr, "Could not decode crash log: %s\n", [[error localizedDescription] UTF8String]);
+
+    /* A single report written to stdout requires no coordination */
+    if (outputDir == nil && [reportPaths count] == 1) {
+        if (!convert_report([reportPaths objectAtIndex: 0], json, textFormat, demangler, STDOUT_FILENO, nil, statsPtr))
+            return 1;
+        return 0;
+    }
+
+    /* Convert the reports across all workers; each worker pulls the next unclaimed report, and writes to its own
+     * output file. Without an output directory, each formatted report is written to stdout while holding the
+     * output lock, preventing interleaved output. */
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    __block volatile int64_t next = 0;
+    int64_t count = [reportPaths count];
+    NSLock *outputLock = [[[NSLock alloc] init] autorelease];
+
+    dispatch_apply(jobs, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t worker) {
+        int64_t i;
+        while ((i = OSAtomicIncrement64(&next) - 1) < count) {
+            NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+            NSString *path = [reportPaths objectAtIndex: i];
+            BOOL success;
+
+            if (outputDir != nil) {
+                NSString *outputPath = [collector outputPathForReportAtIndex: (NSUInteger) i directory: outputDir extension: json ? @"json" : @"crash"];
+                int fd = -1;
+                if (outputPath == nil) {
+                    fprintf(stderr, "Could not create output directory for %s\n", [path UTF8String]);
+                    success = NO;
+                } else if ((fd = open([outputPath fileSystemRepresentation], O_WRONLY|O_CREAT|O_TRUNC, 0644)) < 0) {
+                    fprintf(stderr, "Could not open %s: %s\n", [outputPath UTF8String], strerror(errno));
+                    success = NO;
+                } else {
+                    success = convert_report(path, json, textFormat, demangler, fd, nil, statsPtr);
+                    if (close(fd) != 0)
+                        success = NO;
+                }
+            } else {
+                success = convert_report(path, json, textFormat, demangler, STDOUT_FILENO, outputLock, statsPtr);
+            }
+
+            if (success)
+                OSAtomicIncrement64(&statsPtr->reports);
+            else
+                OSAtomicIncrement64(&statsPtr->failed);
+
+            [pool drain];
+        }
+    });
+
+    /* Report throughput */
+    CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+    if (elapsed <= 0)
+        elapsed = 1e-9;
+
+    fprintf(stderr, "Converted %" PRId64 " reports (%" PRId64 " failed) in %.3fs using %ld workers: %.1f reports/s, %.1f MB/s\n",
+            stats.reports, stats.failed, elapsed, jobs, stats.reports / elapsed, stats.input_bytes / elapsed / (1024.0 * 1024.0));
+
+    return stats.failed == 0 ? 0 : 1;
+}
+
+/*
+ * Symbolication statistics, updated atomically by all workers.
+ */
+struct symbolicate_stats {
+    /** Number of reports symbolicated. */
+    volatile int64_t reports;
+
+    /** Number of reports that could not be read or decoded. */
+    volatile int64_t failed;
+
+    /** Number of stack frames processed. */
+    volatile int64_t frames;
+
+    /** Number of stack frames symbolicated from the symbol store. */
+    volatile int64_t symbolicated;
+};
+
+/*
+ * Symbolicate a single stack frame, returning a dictionary describing the frame. If @a demangler is non-nil, the
+ * frame's symbol name is demangled.
+ */
+static NSDictionary *symbolicate_frame (PLCrashReport *report, PLSymbolStore *store, PLCrashReportSymbolDemangler *demangler, PLCrashReportStackFrameInfo *frameInfo, struct symbolicate_stats *stats) {
+    NSMutableDictionary *frame = [NSMutableDictionary dictionaryWithCapacity: 4];
+    uint64_t pc = frameInfo.instructionPointer;
+    [frame setObject: [NSNumber numberWithUnsignedLongLong: pc] forKey: @"pc"];
+
+    OSAtomicIncrement64(&stats->frames);
+
+    PLCrashReportBinaryImageInfo *imageInfo = [report imageForAddress: pc];
+    if (imageInfo == nil)
+        return frame;
+
+    [frame setObject: [imageInfo.imageName lastPathComponent] forKey: @"image"];
+
+    /* Prefer the symbol store; fall back on any client-side symbol information */
+    PLSymbolTable *table = imageInfo.hasImageUUID ? [store symbolTableForUUID: imageInfo.imageUUID] : nil;
+    if (table != nil) {
+        uint64_t address = pc - imageInfo.imageBaseAddress + table.textAddress;
+        uint64_t start;
+        NSString *symbol = [table symbolForAddress: address startAddress: &start];
+        if (symbol != nil) {
+            NSString *demangled = [demangler demangledNameForSymbol: symbol];
+            [frame setObject: (demangled != nil ? demangled : symbol) forKey: @"symbol"];
+            [frame setObject: [NSNumber numberWithUnsignedLongLong: address - start] forKey: @"offset"];
+            OSAtomicIncrement64(&stats->symbolicated);
+            return frame;
+        }
+    }
+
+    if (frameInfo.symbolInfo != nil) {
+        NSString *demangled = [demangler demangledNameForSymbol: frameInfo.symbolInfo.symbolName];
+        [frame setObject: (demangled != nil ? demangled : frameInfo.symbolInfo.symbolName) forKey: @"symbol"];
+        [frame setObject: [NSNumber numberWithUnsignedLongLong: pc - frameInfo.symbolInfo.startAddress] forKey: @"offset"];
+    } else {
+        [frame setObject: [NSNumber numberWithUnsignedLongLong: pc - imageInfo.imageBaseAddress] forKey: @"offset"];
+    }
+
+    return frame;
+}
+
+/*
+ * Symbolicate an array of PLCrashReportStackFrameInfo instances.
+ */
+static NSArray *symbolicate_frames (PLCrashReport *report, PLSymbolStore *store, PLCrashReportSymbolDemangler *demangler, NSArray *frames, struct symbolicate_stats *stats) {
+    NSMutableArray *result = [NSMutableArray arrayWithCapacity: [frames count]];
+    for (PLCrashReportStackFrameInfo *frameInfo in frames)
+        [result addObject: symbolicate_frame(report, store, demangler, frameInfo, stats)];
+
+    return result;
+}
+
+/*
+ * Symbolicate a decoded report, returning a dictionary suitable for JSON serialization.
+ */
+static NSDictionary *symbolicate_report (NSString *path, PLCrashReport *report, PLSymbolStore *store, PLCrashReportSymbolDemangler *demangler, struct symbolicate_stats *stats) {
+    NSMutableDictionary *result = [NSMutableDictionary dictionary];
+    [result setObject: [path lastPathComponent] forKey: @"file"];
+
+    if (report.uuidRef != NULL)
+        [result setObject: [(NSString *) CFUUIDCreateString(NULL, report.uuidRef) autorelease] forKey: @"incident"];
+
+    [result setObject: [NSDictionary dictionaryWithObjectsAndKeys:
+                        report.applicationInfo.applicationIdentifier, @"identifier",
+                        report.applicationInfo.applicationVersion, @"version", nil] forKey: @"application"];
+
+    [result setObject: [NSDictionary dictionaryWithObjectsAndKeys:
+                        report.signalInfo.name, @"name",
+                        report.signalInfo.code, @"code",
+                        [NSNumber numberWithUnsignedLongLong: report.signalInfo.address], @"address", nil] forKey: @"signal"];
+
+    if (report.hasExceptionInfo) {
+        NSMutableDictionary *exception = [NSMutableDictionary dictionary];
+        [exception setObject: report.exceptionInfo.exceptionName forKey: @"name"];
+        [exception setObject: report.exceptionInfo.exceptionReason forKey: @"reason"];
+        if (report.exceptionInfo.stackFrames != nil)
+            [exception setObject: symbolicate_frames(report, store, demangler, report.exceptionInfo.stackFrames, stats) forKey: @"frames"];
+        [result setObject: exception forKey: @"exception"];
+    }
+
+    NSMutableArray *threads = [NSMutableArray arrayWithCapacity: [report.threads count]];
+    for (PLCrashReportThreadInfo *thread in report.threads) {
+        [threads addObject: [NSDictionary dictionaryWithObjectsAndKeys:
+                             [NSNumber numberWithInteger: thread.threadNumber], @"number",
+                             [NSNumber numberWithBool: thread.crashed], @"crashed",
+                             symbolicate_frames(report, store, demangler, thread.stackFrames, stats), @"frames", nil]];
+    }
+    [result setObject: threads forKey: @"threads"];
+
+    return result;
+}
+
+/*
+ * Append the text representation of symbolicated frames to @a text.
+ */
+static void format_frames_text (NSMutableString *text, NSArray *frames) {
+    NSUInteger index = 0;
+    for (NSDictionary *frame in frames) {
+        NSString *image = [frame objectForKey: @"image"];
+        NSString *symbol = [frame objectForKey: @"symbol"];
+        uint64_t offset = [[frame objectForKey: @"offset"] unsignedLongLongValue];
+
+        [text appendFormat: @"%-4lu%-35s 0x%016" PRIx64 " ", (unsigned long) index++, image != nil ? [image UTF8String] : "???", [[frame objectForKey: @"pc"] unsignedLongLongValue]];
+        if (symbol != nil)
+            [text appendFormat: @"%@ + %" PRIu64 "\n", symbol, offset];
+        else
+            [text appendFormat: @"%@ + %" PRIu64 "\n", image != nil ? [image lastPathComponent] : @"???", offset];
+    }
+}
+
+/*
+ * Format a symbolicated report as text.
+ */
+static NSString *format_report_text (NSDictionary *result) {
+    NSMutableString *text = [NSMutableString string];
+    NSDictionary *application = [result objectForKey: @"application"];
+    NSDictionary *signal = [result objectForKey: @"signal"];
+
+    [text appendFormat: @"Report:              %@\n", [result objectForKey: @"file"]];
+    if ([result objectForKey: @"incident"] != nil)
+        [text appendFormat: @"Incident Identifier: %@\n", [result objectForKey: @"incident"]];
+    [text appendFormat: @"Identifier:          %@\n", [application objectForKey: @"identifier"]];
+    [text appendFormat: @"Version:             %@\n", [application objectForKey: @"version"]];
+    [text appendFormat: @"Exception Type:      %@ (%@) at 0x%" PRIx64 "\n\n", [signal objectForKey: @"name"], [signal objectForKey: @"code"], [[signal objectForKey: @"address"] unsignedLongLongValue]];
+
+    NSDictionary *exception = [result objectForKey: @"exception"];
+    if (exception != nil) {
+        [text appendFormat: @"Application Specific Information:\n*** Terminating app due to uncaught exception '%@', reason: '%@'\n\n",
+         [exception objectForKey: @"name"], [exception objectForKey: @"reason"]];
+
+        if ([exception objectForKey: @"frames"] != nil) {
+            [text appendString: @"Last Exception Backtrace:\n"];
+            format_frames_text(text, [exception objectForKey: @"frames"]);
+            [text appendString: @"\n"];
+        }
+    }
+
+    for (NSDictionary *thread in [result objectForKey: @"threads"]) {
+        if ([[thread objectForKey: @"crashed"] boolValue])
+            [text appendFormat: @"Thread %ld Crashed:\n", (long) [[thread objectForKey: @"number"] integerValue]];
+        else
+            [text appendFormat: @"Thread %ld:\n", (long) [[thread objectForKey: @"number"] integerValue]];
+
+        format_frames_text(text, [thread objectForKey: @"frames"]);
+        [text appendString: @"\n"];
+    }
+
+    return text;
+}
+
+/*
+ * Collect the report files at the given paths. Directories are searched recursively for .plcrash files.
+ */
+static PLReportPathCollector *collect_report_paths (int argc, char *argv[]) {
+    NSFileManager *fm = [NSFileManager defaultManager];
+    PLReportPathCollector *result = [[[PLReportPathCollector alloc] init] autorelease];
+
+    for (int i = 0; i < argc; i++) {
+        NSString *path = [fm stringWithFileSystemRepresentation: argv[i] length: strlen(argv[i])];
+        if (![result addPath: path])
+            fprintf(stderr, "No such file or directory: %s\n", argv[i]);
+    }
+
+    return result;
+}
+
+/*
+ * Run a batch symbolication.
+ */
+static int symbolicate_command (int argc, char *argv[]) {
+    NSMutableArray *symbolPaths = [NSMutableArray array];
+    const char *format = "text";
+    const char *output_dir = NULL;
+    long jobs = [[NSProcessInfo processInfo] activeProcessorCount];
+    BOOL demangle = NO;
+
+    /* options descriptor */
+    static struct option longopts[] = {
+        { "symbols",    required_argument,      NULL,          's' },
+        { "format",     required_argument,      NULL,          'f' },
+        { "jobs",       required_argument,      NULL,          'j' },
+        { "output",     required_argument,      NULL,          'o' },
+        { "demangle",   no_argument,            NULL,          'd' },
+        { NULL,         0,                      NULL,           0 }
+    };
+
+    /* Read the options */
+    int ch;
+    while ((ch = getopt_long(argc, argv, "s:f:j:o:d", longopts, NULL)) != -1) {
+        switch (ch) {
+            case 's':
+                [symbolPaths addObject: [NSString stringWithUTF8String: optarg]];
+                break;
+            case 'f':
+                format = optarg;
+                break;
+            case 'j':
+                jobs = strtol(optarg, NULL, 10);
+                break;
+            case 'o':
+                output_dir = optarg;
+                break;
+            case 'd':
+                demangle = YES;
+                break;
+            default:
+                print_usage();
+                return 1;
+        }
+    }
+    argc -= optind;
+    argv += optind;
+
+    if (argc < 1) {
+        fprintf(stderr, "No report path supplied\n");
+        print_usage();
+        return 1;
+    }
+
+    if ([symbolPaths count] == 0) {
+        fprintf(stderr, "No symbol path supplied\n");
+        print_usage();
+        return 1;
+    }
+
+    BOOL json;
+    if (strcasecmp(format, "text") == 0) {
+        json = NO;
+    } else if (strcasecmp(format, "json") == 0) {
+        json = YES;
+    } else {
+        fprintf(stderr, "Unsupported format requested\n");
+        print_usage();
+        return 1;
+    }
+
+    if (jobs < 1)
+        jobs = 1;
+
+    NSString *outputDir = nil;
+    if (output_dir != NULL) {
+        outputDir = [NSString stringWithUTF8String: output_dir];
+        NSError *error;
+        if (![[NSFileManager defaultManager] createDirectoryAtPath: outputDir withIntermediateDirectories: YES attributes: nil error: &error]) {
+            fprintf(stderr, "Could not create output directory: %s\n", [[error localizedDescription] UTF8String]);
+            return 1;
+        }
+    }
+
+    /* Index the symbol store and collect the reports */
+    CFAbsoluteTime indexStart = CFAbsoluteTimeGetCurrent();
+    PLSymbolStore *store = [[[PLSymbolStore alloc] initWithPaths: symbolPaths] autorelease];
+    PLCrashReportSymbolDemangler *demangler = demangle ? [[[PLCrashReportSymbolDemangler alloc] init] autorelease] : nil;
+    PLReportPathCollector *collector = collect_report_paths(argc, argv);
+    NSArray *reportPaths = collector.reportPaths;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+
+    /* Symbolicate the reports across all workers; each worker pulls the next unclaimed report. Output to stdout is
+     * serialized through a single queue. */
+    struct symbolicate_stats stats = { 0, 0, 0, 0 };
+    struct symbolicate_stats *statsPtr = &stats;
+    __block volatile int64_t next = 0;
+    int64_t count = [reportPaths count];
+    dispatch_queue_t outputQueue = dispatch_queue_create("coop.plausible.plcrashutil.output", DISPATCH_QUEUE_SERIAL);
+
+    dispatch_apply(jobs, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t worker) {
+        int64_t i;
+        while ((i = OSAtomicIncrement64(&next) - 1) < count) {
+            NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+            NSString *path = [reportPaths objectAtIndex: i];
+            NSError *error;
+
+            NSData *data = [NSData dataWithContentsOfFile: path options: NSDataReadingMappedIfSafe error: &error];
+            PLCrashReport *report = nil;
+            if (data != nil)
+                report = [[[PLCrashReport alloc] initWithData: data error: &error] autorelease];
+
+            if (report == nil) {
+                OSAtomicIncrement64(&statsPtr->failed);
+                fprintf(stderr, "Could not decode %s: %s\n", [path UTF8String], [[error localizedDescription] UTF8String]);
+                [pool drain];
+                continue;
+            }
+
+            NSDictionary *result = symbolicate_report(path, report, store, demangler, statsPtr);
+            NSData *output;
+            if (json) {
+                NSMutableData *encoded = [[[NSJSONSerialization dataWithJSONObject: result options: 0 error: NULL] mutableCopy] autorelease];
+                [encoded appendBytes: "\n" length: 1];
+                output = encoded;
+            } else {
+                output = [format_report_text(result) dataUsingEncoding: NSUTF8StringEncoding];
+            }
+
+            if (outputDir != nil) {
+                NSString *outputPath = [collector outputPathForReportAtIndex: (NSUInteger) i directory: outputDir extension: json ? @"json" : @"crash"];
+                if (outputPath == nil || ![output writeToFile: outputPath atomically: YES])
+                    fprintf(stderr, "Could not write output for %s\n", [path UTF8String]);
+            } else {
+                [output retain];
+                dispatch_async(outputQueue, ^{
+                    fwrite([output bytes], 1, [output length], stdout);
+                    [output release];
+                });
+            }
+
+            OSAtomicIncrement64(&statsPtr->reports);
+            [pool drain];
+        }
+    });
+
+    /* Wait for any pending output */
+    dispatch_sync(outputQueue, ^{ fflush(stdout); });
+    dispatch_release(outputQueue);
+
+    /* Report throughput */
+    CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+    if (elapsed <= 0)
+        elapsed = 1e-9;
+
+    fprintf(stderr, "Indexed %lu images in %.3fs\n", (unsigned long) store.imageCount, start - indexStart);
+    fprintf(stderr, "Symbolicated %" PRId64 " reports (%" PRId64 " failed) in %.3fs using %ld workers: %.1f reports/s\n",
+            stats.reports, stats.failed, elapsed, jobs, stats.reports / elapsed);
+    fprintf(stderr, "Frames: %" PRId64 " total, %" PRId64 " symbolicated (%.1f frames/s); %lu symbol tables loaded\n",
+            stats.frames, stats.symbolicated, stats.frames / elapsed, (unsigned long) store.loadedCount);
+
+    return stats.failed == 0 ? 0 : 1;
+}
+
+/*
+ * Compute the bucketing signature for a report, from the signal, exception name, and the crashed thread's top
+ * @a frameCount frames. Frames are normalized to their image UUID and offset, so that signatures are stable across
+ * differing load addresses.
+ */
+static NSString *bucket_signature (PLCrashReport *report, NSUInteger frameCount) {
+    NSMutableString *signature = [NSMutableString string];
+
+    [signature appendString: report.signalInfo.name];
+    [signature appendString: @" "];
+    [signature appendString: report.hasExceptionInfo ? report.exceptionInfo.exceptionName : @"-"];
+
+    /* Only the crashed thread is decoded in lazily decoded reports */
+    PLCrashReportThreadInfo *thread = report.crashedThread;
+    NSArray *frames = thread.stackFrames;
+    for (NSUInteger i = 0; i < frameCount && i < [frames count]; i++) {
+        PLCrashReportStackFrameInfo *frameInfo = [frames objectAtIndex: i];
+        uint64_t pc = frameInfo.instructionPointer;
+#if __DARWIN_OPAQUE_ARM_THREAD_STATE64
+        pc &= 0x0000000fffffffff;
+#endif
+
+        PLCrashReportBinaryImageInfo *imageInfo = [report imageForAddress: pc];
+        if (imageInfo == nil) {
+            [signature appendFormat: @" ???+0x%" PRIx64, pc];
+        } else {
+            NSString *image = imageInfo.hasImageUUID ? imageInfo.imageUUID : [imageInfo.imageName lastPathComponent];
+            [signature appendFormat: @" %@+0x%" PRIx64, image, pc - imageInfo.imageBaseAddress];
+        }
+    }
+
+    return signature;
+}
+
+/*
+ * Run a crash signature bucketing pass.
+ */
+static int bucket_command (int argc, char *argv[]) {
+    long frameCount = 5;
+    long jobs = [[NSProcessInfo processInfo] activeProcessorCount];
+
+    /* options descriptor */
+    static struct option longopts[] = {
+        { "frames",     required_argument,      NULL,          'n' },
+        { "jobs",       required_argument,      NULL,          'j' },
+        { NULL,         0,                      NULL,           0 }
+    };
+
+    /* Read the options */
+    int ch;
+    while ((ch = getopt_long(argc, argv, "n:j:", longopts, NULL)) != -1) {
+        switch (ch) {
+            case 'n':
+                frameCount = strtol(optarg, NULL, 10);
+                break;
+            case 'j':
+                jobs = strtol(optarg, NULL, 10);
+                break;
+            default:
+                print_usage();
+                return 1;
+        }
+    }
+    argc -= optind;
+    argv += optind;
+
+    if (argc < 1) {
+        fprintf(stderr, "No report path supplied\n");
+        print_usage();
         return 1;
     }
 
-    /* Format the report */
-    NSString* report = [PLCrashReportTextFormatter stringValueForCrashReport: crashLog withTextFormat: textFormat];
-    fprintf(output, "%s", [report UTF8String]);     
-    return 0;
+    if (frameCount < 1)
+        frameCount = 1;
+
+    if (jobs < 1)
+        jobs = 1;
+
+    /* Compute signatures across all workers; each worker pulls the next unclaimed report, and counts signatures
+     * locally. The per-worker counts are merged once the worker completes. */
+    NSArray *reportPaths = collect_report_paths(argc, argv).reportPaths;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    __block volatile int64_t next = 0;
+    __block volatile int64_t failed = 0;
+    int64_t count = [reportPaths count];
+    NSCountedSet *buckets = [NSCountedSet set];
+
+    dispatch_apply(jobs, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t worker) {
+        NSCountedSet *local = [[NSCountedSet alloc] init];
+        int64_t i;
+
+        while ((i = OSAtomicIncrement64(&next) - 1) < count) {
+            NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+            NSString *path = [reportPaths objectAtIndex: i];
+            NSError *error;
+
+            NSData *data = [NSData dataWithContentsOfFile: path options: NSDataReadingMappedIfSafe error: &error];
+            PLCrashReport *report = nil;
+            if (data != nil)
+                report = [[[PLCrashReport alloc] initWithData: data options: PLCrashReportDecodingOptionLazy error: &error] autorelease];
+
+            if (report == nil) {
+                OSAtomicIncrement64(&failed);
+                fprintf(stderr, "Could not decode %s: %s\n", [path UTF8String], [[error localizedDescription] UTF8String]);
+            } else {
+                [local addObject: bucket_signature(report, (NSUInteger) frameCount)];
+            }
+
+            [pool drain];
+        }
+
+        @synchronized (buckets) {
+            for (NSString *signature in local) {
+                for (NSUInteger n = [local countForObject: signature]; n > 0; n--)
+                    [buckets addObject: signature];
+            }
+        }
+        [local release];
+    });
+
+    /* Emit the buckets, largest first */
+    NSArray *signatures = [[buckets allObjects] sortedArrayUsingComparator: ^NSComparisonResult (id lhs, id rhs) {
+        NSUInteger lhsCount = [buckets countForObject: lhs];
+        NSUInteger rhsCount = [buckets countForObject: rhs];
+        if (lhsCount > rhsCount)
+            return NSOrderedAscending;
+        else if (lhsCount < rhsCount)
+            return NSOrderedDescending;
+        return [lhs compare: rhs];
+    }];
+
+    for (NSString *signature in signatures)
+        fprintf(stdout, "%lu\t%s\n", (unsigned long) [buckets countForObject: signature], [signature UTF8String]);
+    fflush(stdout);
+
+    /* Report throughput */
+    CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+    if (elapsed <= 0)
+        elapsed = 1e-9;
+
+    fprintf(stderr, "Bucketed %" PRId64 " reports (%" PRId64 " failed) into %lu signatures in %.3fs using %ld workers: %.1f reports/s\n",
+            count - failed, failed, (unsigned long) [signatures count], elapsed, jobs, (count - failed) / elapsed);
+
+    return failed == 0 ? 0 : 1;
 }
 
 int main (int argc, char *argv[]) {
@@ -128,6 +829,10 @@ int main (int argc, char *argv[]) {
     /* Convert command */
     if (strcmp(argv[1], "convert") == 0) {
         ret = convert_command(argc - 2, argv + 2);
+    } else if (strcmp(argv[1], "symbolicate") == 0) {
+        ret = symbolicate_command(argc - 2, argv + 2);
+    } else if (strcmp(argv[1], "bucket") == 0) {
+        ret = bucket_command(argc - 2, argv + 2);
     } else {
         print_usage();
         ret = 1;
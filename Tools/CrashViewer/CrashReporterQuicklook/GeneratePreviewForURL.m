@@ -2,10 +2,75 @@
 #include <CoreServices/CoreServices.h>
 #include <QuickLook/QuickLook.h>
 #import <CrashReporter/CrashReporter.h>
+#import <CrashReporter/PLCrashReportSummary.h>
 
 OSStatus GeneratePreviewForURL (void *thisInterface, QLPreviewRequestRef preview, CFURLRef url, CFStringRef contentTypeUTI, CFDictionaryRef options);
 void CancelPreviewGeneration (void *thisInterface, QLPreviewRequestRef preview);
 
+/** The maximum number of crashed thread frames included in a preview. */
+#define PREVIEW_MAX_FRAMES 128
+
+/**
+ * Format a preview of @a report, using @a summary if available. Only the report's header records and the crashed
+ * thread are read; no Objective-C objects are constructed for the remaining thread and binary image records.
+ */
+static NSString *FormatPreview (PLCrashReport *report, PLCrashReportSummary *summary)
+{
+    NSMutableString *text = [NSMutableString string];
+
+    /* Header */
+    if (report.hasProcessInfo)
+        [text appendFormat: @"Process:         %@ [%lu]\n", report.processInfo.processName, (unsigned long) report.processInfo.processID];
+    [text appendFormat: @"Identifier:      %@\n", report.applicationInfo.applicationIdentifier];
+    [text appendFormat: @"Version:         %@\n", report.applicationInfo.applicationVersion];
+    [text appendFormat: @"OS Version:      %@ (%@)\n", report.systemInfo.operatingSystemVersion, report.systemInfo.operatingSystemBuild];
+    if (report.systemInfo.timestamp != nil)
+        [text appendFormat: @"Date/Time:       %@\n", report.systemInfo.timestamp];
+    if (summary != nil && summary.occurrenceCount > 1) {
+        [text appendFormat: @"Occurrences:     %lu", (unsigned long) summary.occurrenceCount];
+        if (summary.lastOccurrenceTimestamp != nil)
+            [text appendFormat: @" (last %@)", summary.lastOccurrenceTimestamp];
+        [text appendString: @"\n"];
+    }
+    [text appendString: @"\n"];
+
+    /* Exception */
+    [text appendFormat: @"Exception Type:  %@\n", report.signalInfo.name];
+    [text appendFormat: @"Exception Codes: %@ at 0x%llx\n", report.signalInfo.code, report.signalInfo.address];
+    if (report.hasExceptionInfo)
+        [text appendFormat: @"Exception:       %@: %@\n", report.exceptionInfo.exceptionName, report.exceptionInfo.exceptionReason];
+
+    NSInteger crashedThreadNumber = report.crashedThreadNumber;
+    if (crashedThreadNumber >= 0)
+        [text appendFormat: @"Crashed Thread:  %ld\n", (long) crashedThreadNumber];
+    [text appendString: @"\n"];
+
+    /* Crashed thread. Frames are listed without their images, which would require decoding all image records. */
+    PLCrashReportThreadInfo *thread = report.crashedThread;
+    if (thread != nil) {
+        [text appendFormat: @"Thread %ld Crashed:\n", (long) thread.threadNumber];
+
+        NSArray *frames = thread.stackFrames;
+        NSUInteger count = MIN(frames.count, (NSUInteger) PREVIEW_MAX_FRAMES);
+        for (NSUInteger i = 0; i < count; i++) {
+            PLCrashReportStackFrameInfo *frame = frames[i];
+            [text appendFormat: @"%-4lu0x%016llx", (unsigned long) i, frame.instructionPointer];
+            if (frame.symbolInfo != nil)
+                [text appendFormat: @" %@ + %llu", frame.symbolInfo.symbolName, frame.instructionPointer - frame.symbolInfo.startAddress];
+            [text appendString: @"\n"];
+        }
+
+        if (frames.count > count)
+            [text appendFormat: @"... %lu more frames\n", (unsigned long) (frames.count - count)];
+        [text appendString: @"\n"];
+    }
+
+    [text appendFormat: @"%lu threads, %lu binary images. Open the report to view all threads and images.\n",
+     (unsigned long) report.threadCount, (unsigned long) report.imageCount];
+
+    return text;
+}
+
 /* -----------------------------------------------------------------------------
    Generate a preview for file
 
@@ -15,16 +80,35 @@ void CancelPreviewGeneration (void *thisInterface, QLPreviewRequestRef preview);
 OSStatus GeneratePreviewForURL (void *thisInterface, QLPreviewRequestRef preview, CFURLRef url, CFStringRef contentTypeUTI, CFDictionaryRef options)
 {
     @autoreleasepool {
-        NSData *data = [NSData dataWithContentsOfURL: (__bridge NSURL *)url];
+        NSData *data = [NSData dataWithContentsOfURL: (__bridge NSURL *)url options: NSDataReadingMappedIfSafe error: NULL];
         if (!data)
             return noErr;
-        
-        PLCrashReport *report = [[PLCrashReport alloc] initWithData: data error: NULL];
-        if (!report)
+
+        if (QLPreviewRequestIsCancelled(preview))
+            return noErr;
+
+        /*
+         * The underlying protobuf message is still unpacked in full, so the decoding cost grows with the size of the
+         * report. Lazy decoding only skips building the Objective-C thread and image objects; of those, only the
+         * crashed thread is constructed below.
+         */
+        PLCrashReport *report = [[PLCrashReport alloc] initWithData: data
+                                                            options: PLCrashReportDecodingOptionLazy | PLCrashReportDecodingOptionCompact
+                                                              error: NULL];
+        if (report == nil)
+            return noErr;
+
+        if (QLPreviewRequestIsCancelled(preview))
             return noErr;
-        
-        NSString *text = [PLCrashReportTextFormatter stringValueForCrashReport: report
-                                                                withTextFormat: PLCrashReportTextFormatiOS];
+
+        /* Use the summary written alongside the report, if any */
+        PLCrashReportSummary *summary = nil;
+        NSURL *summaryURL = [(__bridge NSURL *)url URLByAppendingPathExtension: @"summary"];
+        NSData *summaryData = [NSData dataWithContentsOfURL: summaryURL];
+        if (summaryData != nil)
+            summary = [[PLCrashReportSummary alloc] initWithData: summaryData error: NULL];
+
+        NSString *text = FormatPreview(report, summary);
         NSData *utf8Data = [text dataUsingEncoding: NSUTF8StringEncoding];
         QLPreviewRequestSetDataRepresentation(preview, (__bridge CFDataRef)utf8Data, kUTTypePlainText, NULL);
     }
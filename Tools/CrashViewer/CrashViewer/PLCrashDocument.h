@@ -27,7 +27,11 @@
  */
 
 #import <Cocoa/Cocoa.h>
+#import <CrashReporter/CrashReporter.h>
 
 @interface PLCrashDocument : NSDocument
 @property(nonatomic, copy) NSString *reportText;
+@property(nonatomic, retain) PLCrashReport *report;
+
+- (void) formatReportTextWithCompletionHandler: (void (^)(NSString *text))handler;
 @end
@@ -36,6 +36,12 @@
 
 @implementation PLCrashDocument
 
+/* Reports are decoded on a background thread, rather than blocking the main thread while large reports are opened. */
++ (BOOL) canConcurrentlyReadDocumentsOfType: (NSString *)typeName
+{
+    return YES;
+}
+
 - (void)makeWindowControllers
 {
     PLCrashWindowController *controller = [[PLCrashWindowController alloc] initWithWindowNibName: @"PLCrashWindow"];
@@ -46,13 +52,14 @@
 - (BOOL) readFromData: (NSData *)data ofType: (NSString *)typeName error: (__autoreleasing NSError **)outError
 {
     if ([typeName isEqual: @"PLCrash"]) {
-        PLCrashReport *report = [[PLCrashReport alloc] initWithData: data error: outError];
+        /* Thread and image records are decoded once displayed, and the report is only formatted as text when required */
+        PLCrashReport *report = [[PLCrashReport alloc] initWithData: data
+                                                            options: PLCrashReportDecodingOptionLazy | PLCrashReportDecodingOptionCompact
+                                                              error: outError];
         if (!report)
             return NO;
 
-        NSString *text = [PLCrashReportTextFormatter stringValueForCrashReport: report
-                                                                withTextFormat: PLCrashReportTextFormatiOS];
-        self.reportText = text;
+        self.report = report;
         return YES;
     } else if ([typeName isEqual: @"com.apple.crashreport"] || [typeName isEqual: @"public.plain-text"]) {
         NSString *text = [[NSString alloc] initWithData: data encoding: NSUTF8StringEncoding];
@@ -62,4 +69,27 @@
     return NO;
 }
 
+/**
+ * Asynchronously formats the report as text on a background queue, calling @a handler on the main queue with the
+ * result. The formatted text is retained, and returned directly by subsequent calls.
+ */
+- (void) formatReportTextWithCompletionHandler: (void (^)(NSString *text))handler
+{
+    NSString *text = self.reportText;
+    PLCrashReport *report = self.report;
+    if (text != nil || report == nil) {
+        handler(text);
+        return;
+    }
+
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        NSString *formatted = [PLCrashReportTextFormatter stringValueForCrashReport: report
+                                                                     withTextFormat: PLCrashReportTextFormatiOS];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            self.reportText = formatted;
+            handler(formatted);
+        });
+    });
+}
+
 @end
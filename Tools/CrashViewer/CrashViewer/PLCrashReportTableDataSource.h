@@ -0,0 +1,47 @@
+/*
+ * Author: Joe Ranieri <joe@alacatialabs.com>
+ *
+ * Copyright (c) 2015 Plausible Labs Cooperative, Inc.
+ * Copyright (c) Xojo, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <CrashReporter/CrashReporter.h>
+
+@interface PLCrashReportTableDataSource : NSObject <NSTableViewDataSource> {
+    PLCrashReport *_report;
+    NSArray *_threads;
+    NSArray *_images;
+    NSMutableData *_rows;
+    NSCache *_formattedRows;
+    BOOL _lp64;
+    BOOL _stripSymbolPrefix;
+}
+
+- (id) initWithReport: (PLCrashReport *)report;
+
+@property(nonatomic, readonly) NSUInteger rowCount;
+
+@end
@@ -0,0 +1,221 @@
+/*
+ * Author: Joe Ranieri <joe@alacatialabs.com>
+ *
+ * Copyright (c) 2015 Plausible Labs Cooperative, Inc.
+ * Copyright (c) Xojo, Inc.
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "PLCrashReportTableDataSource.h"
+
+/** Row types displayed by PLCrashReportTableDataSource. */
+typedef NS_ENUM(uint32_t, PLCrashReportRowType) {
+    /** A blank separator row. */
+    PLCrashReportRowTypeBlank = 0,
+
+    /** A thread's title; the row's thread index identifies the thread. */
+    PLCrashReportRowTypeThread,
+
+    /** A stack frame; the row's thread and item indexes identify the frame. */
+    PLCrashReportRowTypeFrame,
+
+    /** The binary image list title. */
+    PLCrashReportRowTypeImagesTitle,
+
+    /** A binary image; the row's item index identifies the image. */
+    PLCrashReportRowTypeImage
+};
+
+/** A single table row. Rows are indexed when the data source is created, and only formatted once displayed. */
+typedef struct PLCrashReportRow {
+    PLCrashReportRowType type;
+    uint32_t thread;
+    uint32_t item;
+} PLCrashReportRow;
+
+/**
+ * Provides the threads and binary images of a crash report as rows of a single-column table. The rows are indexed
+ * at initialization, which may be done on a background queue; the text of each row is formatted only when the table
+ * requests it, so only visible rows are ever formatted.
+ */
+@implementation PLCrashReportTableDataSource
+
+/**
+ * Index the threads and binary images of @a report. This decodes any lazily decoded thread and image records,
+ * and should be called off the main thread for large reports.
+ */
+- (id) initWithReport: (PLCrashReport *)report
+{
+    if ((self = [super init]) == nil)
+        return nil;
+
+    _report = report;
+    _threads = report.threads;
+    _images = report.sortedImages;
+    _rows = [[NSMutableData alloc] init];
+    _formattedRows = [[NSCache alloc] init];
+    _formattedRows.countLimit = 1024;
+
+    /* Determine the pointer width and symbol prefix rules used when formatting frames */
+    PLCrashReportProcessorInfo *processor = report.systemInfo.processorInfo;
+    _lp64 = processor.typeEncoding == PLCrashReportProcessorTypeEncodingMach && (processor.type & CPU_ARCH_ABI64) != 0;
+
+    switch (report.systemInfo.operatingSystem) {
+        case PLCrashReportOperatingSystemMacOSX:
+        case PLCrashReportOperatingSystemiPhoneOS:
+        case PLCrashReportOperatingSystemAppleTVOS:
+        case PLCrashReportOperatingSystemiPhoneSimulator:
+            _stripSymbolPrefix = YES;
+            break;
+        default:
+            _stripSymbolPrefix = NO;
+            break;
+    }
+
+    /* Index the thread and image rows */
+    [_threads enumerateObjectsUsingBlock: ^(PLCrashReportThreadInfo *thread, NSUInteger idx, BOOL *stop) {
+        [self appendRowWithType: PLCrashReportRowTypeThread thread: idx item: 0];
+        NSUInteger frameCount = thread.stackFrames.count;
+        for (NSUInteger i = 0; i < frameCount; i++)
+            [self appendRowWithType: PLCrashReportRowTypeFrame thread: idx item: i];
+        [self appendRowWithType: PLCrashReportRowTypeBlank thread: 0 item: 0];
+    }];
+
+    [self appendRowWithType: PLCrashReportRowTypeImagesTitle thread: 0 item: 0];
+    for (NSUInteger i = 0; i < _images.count; i++)
+        [self appendRowWithType: PLCrashReportRowTypeImage thread: 0 item: i];
+
+    return self;
+}
+
+- (void) appendRowWithType: (PLCrashReportRowType)type thread: (NSUInteger)thread item: (NSUInteger)item
+{
+    PLCrashReportRow row = { .type = type, .thread = (uint32_t) thread, .item = (uint32_t) item };
+    [_rows appendBytes: &row length: sizeof(row)];
+}
+
+- (NSUInteger) rowCount
+{
+    return _rows.length / sizeof(PLCrashReportRow);
+}
+
+/** Format the title of @a thread. */
+- (NSString *) titleForThread: (PLCrashReportThreadInfo *)thread
+{
+    NSMutableString *title = [NSMutableString stringWithFormat: @"Thread %ld", (long) thread.threadNumber];
+    if (thread.crashed)
+        [title appendString: @" Crashed"];
+    [title appendString: @":"];
+
+    if (thread.name.length > 0)
+        [title appendFormat: @" %@", thread.name];
+    if (thread.dispatchQueueLabel.length > 0)
+        [title appendFormat: @"  Dispatch queue: %@", thread.dispatchQueueLabel];
+
+    return title;
+}
+
+/** Format @a frame, at @a frameIndex within its thread. This uses the same layout as PLCrashReportTextFormatter. */
+- (NSString *) textForFrame: (PLCrashReportStackFrameInfo *)frame index: (NSUInteger)frameIndex
+{
+    uint64_t pc = frame.instructionPointer;
+    PLCrashReportBinaryImageInfo *image = [_report imageForAddress: pc];
+    NSString *imageName = image != nil ? image.imageName.lastPathComponent : @"???";
+
+    NSString *symbol;
+    if (frame.symbolInfo != nil) {
+        NSString *symbolName = frame.symbolInfo.symbolName;
+        if (_stripSymbolPrefix && symbolName.length > 1 && [symbolName characterAtIndex: 0] == '_')
+            symbolName = [symbolName substringFromIndex: 1];
+
+        symbol = [NSString stringWithFormat: @"%@ + %llu", symbolName, pc - frame.symbolInfo.startAddress];
+    } else if (image != nil) {
+        symbol = [NSString stringWithFormat: @"0x%llx + %llu", image.imageBaseAddress, pc - image.imageBaseAddress];
+    } else {
+        symbol = @"";
+    }
+
+    return [NSString stringWithFormat: @"%-4lu%-35s 0x%0*llx %@", (unsigned long) frameIndex, imageName.UTF8String,
+            _lp64 ? 16 : 8, pc, symbol];
+}
+
+/** Format @a image as a binary image list entry. */
+- (NSString *) textForImage: (PLCrashReportBinaryImageInfo *)image
+{
+    NSString *uuid = image.hasImageUUID ? image.imageUUID : @"???";
+    uint64_t end = image.imageBaseAddress + (image.imageSize > 0 ? image.imageSize - 1 : 0);
+
+    return [NSString stringWithFormat: @"%#18llx - %#18llx %@ <%@> %@", image.imageBaseAddress, end,
+            image.imageName.lastPathComponent, uuid, image.imageName];
+}
+
+- (NSString *) textForRow: (const PLCrashReportRow *)row
+{
+    switch (row->type) {
+        case PLCrashReportRowTypeBlank:
+            return @"";
+
+        case PLCrashReportRowTypeThread:
+            return [self titleForThread: _threads[row->thread]];
+
+        case PLCrashReportRowTypeFrame: {
+            PLCrashReportThreadInfo *thread = _threads[row->thread];
+            return [self textForFrame: thread.stackFrames[row->item] index: row->item];
+        }
+
+        case PLCrashReportRowTypeImagesTitle:
+            return @"Binary Images:";
+
+        case PLCrashReportRowTypeImage:
+            return [self textForImage: _images[row->item]];
+    }
+
+    return @"";
+}
+
+#pragma mark NSTableViewDataSource
+
+- (NSInteger) numberOfRowsInTableView: (NSTableView *)tableView
+{
+    return (NSInteger) self.rowCount;
+}
+
+- (id) tableView: (NSTableView *)tableView objectValueForTableColumn: (NSTableColumn *)tableColumn row: (NSInteger)row
+{
+    if (row < 0 || (NSUInteger) row >= self.rowCount)
+        return nil;
+
+    /* Rows are formatted on demand as they're scrolled into view, and cached while visible */
+    NSNumber *key = @(row);
+    NSString *text = [_formattedRows objectForKey: key];
+    if (text == nil) {
+        const PLCrashReportRow *rows = _rows.bytes;
+        text = [self textForRow: &rows[row]];
+        [_formattedRows setObject: text forKey: key];
+    }
+
+    return text;
+}
+
+@end
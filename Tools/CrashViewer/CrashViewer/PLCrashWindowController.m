@@ -30,6 +30,7 @@
 #import "PLAsyncTask.h"
 #import "PLCrashDocument.h"
 #import "PLProgressIndicatorController.h"
+#import "PLCrashReportTableDataSource.h"
 
 @interface PLCrashWindowController ()
 /** The currently executing symbolication task, if any. */
@@ -44,6 +45,12 @@
 /** The text view displaying the crash log. */
 @property(nonatomic, assign) IBOutlet NSTextView *textView;
 
+/** The table displaying the threads and images of a decoded report, if any. */
+@property(nonatomic, retain) NSTableView *tableView;
+
+/** The table's data source; the rows are indexed on a background queue once the window has loaded. */
+@property(nonatomic, retain) PLCrashReportTableDataSource *tableDataSource;
+
 /** Is the window in the process of closing? */
 @property(nonatomic) BOOL closing;
 
@@ -64,14 +71,109 @@
     [super windowDidLoad];
 
     self.textView.font = [NSFont fontWithName: @"Menlo" size: 12];
-    self.textView.string = [self.document reportText];
+
+    PLCrashReport *report = [self.document report];
+    if (report != nil) {
+        [self showReportTable: report];
+    } else {
+        self.textView.string = [self.document reportText];
+    }
 
     if (self.symbolicationCommand.length) {
         [self addProgressIndicator];
-        [self startSymbolicatingCrash: [self.document reportText]];
+        [self.document formatReportTextWithCompletionHandler: ^(NSString *text) {
+            if (self.closing) {
+                [self removeProgressIndicator];
+                return;
+            }
+            [self startSymbolicatingCrash: text];
+        }];
     }
 }
 
+/**
+ * Displays the threads and images of @a report in a table, in place of the text view. Only the visible rows of the
+ * table are formatted; the rows themselves are indexed on a background queue, decoding the report's thread and image
+ * records off the main thread.
+ */
+- (void) showReportTable: (PLCrashReport *)report
+{
+    NSScrollView *textScrollView = self.textView.enclosingScrollView;
+    NSFont *font = self.textView.font;
+
+    NSTableColumn *column = [[NSTableColumn alloc] initWithIdentifier: @"text"];
+    column.editable = NO;
+    column.width = NSWidth(textScrollView.bounds);
+    column.resizingMask = NSTableColumnAutoresizingMask;
+    [column.dataCell setFont: font];
+    [column.dataCell setLineBreakMode: NSLineBreakByClipping];
+
+    NSTableView *tableView = [[NSTableView alloc] initWithFrame: textScrollView.bounds];
+    [tableView addTableColumn: column];
+    tableView.headerView = nil;
+    tableView.allowsMultipleSelection = YES;
+    tableView.columnAutoresizingStyle = NSTableViewUniformColumnAutoresizingStyle;
+    tableView.rowHeight = ceil(font.ascender - font.descender + font.leading) + 2;
+    tableView.intercellSpacing = NSMakeSize(0, 0);
+
+    NSScrollView *scrollView = [[NSScrollView alloc] initWithFrame: textScrollView.frame];
+    scrollView.autoresizingMask = NSViewWidthSizable | NSViewHeightSizable;
+    scrollView.hasVerticalScroller = YES;
+    scrollView.borderType = NSNoBorder;
+    scrollView.documentView = tableView;
+
+    [textScrollView.superview addSubview: scrollView positioned: NSWindowAbove relativeTo: textScrollView];
+    textScrollView.hidden = YES;
+    self.tableView = tableView;
+
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        PLCrashReportTableDataSource *dataSource = [[PLCrashReportTableDataSource alloc] initWithReport: report];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (self.closing)
+                return;
+
+            self.tableDataSource = dataSource;
+            self.tableView.dataSource = dataSource;
+            [self.tableView reloadData];
+        });
+    });
+}
+
+/** Replaces the report table, if any, with the text view, displaying @a text. */
+- (void) showText: (NSString *)text
+{
+    if (self.tableView != nil) {
+        self.textView.enclosingScrollView.hidden = NO;
+        [self.tableView.enclosingScrollView removeFromSuperview];
+        self.tableView.dataSource = nil;
+        self.tableView = nil;
+        self.tableDataSource = nil;
+    }
+
+    self.textView.string = text;
+}
+
+/** Copies the text of the selected table rows. */
+- (void) copy: (id)sender
+{
+    NSTableView *tableView = self.tableView;
+    NSMutableArray *lines = [NSMutableArray array];
+    [tableView.selectedRowIndexes enumerateIndexesUsingBlock: ^(NSUInteger row, BOOL *stop) {
+        [lines addObject: [self.tableDataSource tableView: tableView objectValueForTableColumn: nil row: (NSInteger) row]];
+    }];
+
+    NSPasteboard *pasteboard = [NSPasteboard generalPasteboard];
+    [pasteboard clearContents];
+    [pasteboard writeObjects: @[[lines componentsJoinedByString: @"\n"]]];
+}
+
+- (BOOL) validateMenuItem: (NSMenuItem *)menuItem
+{
+    if (menuItem.action == @selector(copy:))
+        return self.tableView.selectedRowIndexes.count > 0;
+    return YES;
+}
+
 - (void) windowWillClose: (NSNotification *)notification
 {
     self.closing = YES;
@@ -109,7 +211,7 @@
                 return;
 
             if (task.terminationStatus == 0) {
-                self.textView.string = stdoutText;
+                [self showText: stdoutText];
             } else if (stderrText.length) {
                 [self displaySymbolicationError: stderrText];
             } else {